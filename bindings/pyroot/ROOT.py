@@ -105,7 +105,7 @@ if 'cppyy' in sys.builtin_module_names:
    PYPY_CPPYY_COMPATIBILITY_FIXME = True
 
    import warnings
-   warnings.warn( "adding no-ops for: SetMemoryPolicy, SetSignalPolicy, MakeNullPointer" )
+   warnings.warn( "adding no-ops for: SetMemoryPolicy, SetSignalPolicy, SetGILPolicy, MakeNullPointer" )
 
  # enable compatibility features (TODO: either breakup libPyROOT or provide
  # equivalents in pypy/cppyy)
@@ -121,6 +121,12 @@ if 'cppyy' in sys.builtin_module_names:
    _root.kSignalFast     = 128
    _root.kSignalSafe     = 256
 
+   def _SetGILPolicy( self, policy ):
+      pass
+   _root.__class__.SetGILPolicy = _SetGILPolicy; del _SetGILPolicy
+   _root.kGILHold        =   0
+   _root.kGILRelease     =  64
+
    def _MakeNullPointer( self, klass = None ):
       pass
    _root.__class__.MakeNullPointer = _MakeNullPointer; del _MakeNullPointer
@@ -208,6 +214,7 @@ _orig_ehook = sys.excepthook
 ## for setting memory and speed policies; not exported
 _memPolicyAPI = [ 'SetMemoryPolicy', 'SetOwnership', 'kMemoryHeuristics', 'kMemoryStrict' ]
 _sigPolicyAPI = [ 'SetSignalPolicy', 'kSignalFast', 'kSignalSafe' ]
+_gilPolicyAPI = [ 'SetGILPolicy', 'kGILHold', 'kGILRelease' ]
 
 
 ### helpers ---------------------------------------------------------------------
@@ -238,6 +245,34 @@ def _TTree__iter__( self ):
 
 _root.CreateScopeProxy( "TTree" ).__iter__    = _TTree__iter__
 
+def _TBranch__AsArray( self, first = 0, last = -1 ):
+   data, fmt, nvalues = self._ReadBulk( first, last )
+   try:
+      import numpy
+   except ImportError:
+      view = memoryview( data )
+      if hasattr( view, 'cast' ):            # p3 only; p2 returns the raw bytes
+         view = view.cast( fmt )
+      return view
+
+   array = numpy.frombuffer( data, dtype = numpy.dtype( fmt ) )
+   if 1 < nvalues:
+      array = array.reshape( ( -1, nvalues ) )
+   return array
+
+def _TTree__AsMatrix( self, columns, first = 0, last = -1 ):
+   import numpy
+   arrays = []
+   for name in columns:
+      branch = self.GetBranch( name )
+      if not branch:
+         raise AttributeError( "TTree has no branch %s" % name )
+      arrays.append( _TBranch__AsArray( branch, first, last ) )
+   return numpy.column_stack( arrays )
+
+_root.CreateScopeProxy( "TBranch" ).AsArray   = _TBranch__AsArray
+_root.CreateScopeProxy( "TTree" ).AsMatrix    = _TTree__AsMatrix
+
 
 ### RINT command emulation ------------------------------------------------------
 def _excepthook( exctype, value, traceb ):
@@ -585,7 +620,7 @@ class ModuleFacade( types.ModuleType ):
             self.PyGUIThread.start()
 
     # store already available ROOT objects to prevent spurious lookups
-      for name in self.module.__pseudo__all__ + _memPolicyAPI + _sigPolicyAPI:
+      for name in self.module.__pseudo__all__ + _memPolicyAPI + _sigPolicyAPI + _gilPolicyAPI:
          self.__dict__[ name ] = getattr( _root, name )
 
     # the macro NULL is not available from Cling globals, but might be useful
@@ -585,7 +585,7 @@ namespace {
       ctxt.fFlags |= (mflags & TCallContext::kUseStrict);
       ctxt.fFlags |= (mflags & TCallContext::kManageSmartPtr);
       if ( ! ctxt.fFlags ) ctxt.fFlags |= TCallContext::sMemoryPolicy;
-      ctxt.fFlags |= (mflags & TCallContext::kReleaseGIL);
+      ctxt.fFlags |= ((mflags | TCallContext::sGILPolicy) & TCallContext::kReleaseGIL);
 
    // simple case
       if ( nMethods == 1 ) {
@@ -34,11 +34,13 @@
 
 #include "TTree.h"
 #include "TBranch.h"
+#include "TBufferFile.h"
 #include "TBranchElement.h"
 #include "TBranchObject.h"
 #include "TLeaf.h"
 #include "TLeafElement.h"
 #include "TLeafObject.h"
+#include "TMath.h"
 #include "TStreamerElement.h"
 #include "TStreamerInfo.h"
 
@@ -1746,10 +1748,98 @@ namespace PyROOT {      // workaround for Intel icc on Linux
       }
    };
 
+//- TBranch behavior ----------------------------------------------------------
+   PyObject* TBranchReadBulk( ObjectProxy* self, PyObject* args )
+   {
+   // read the entries [first, last] of a branch with a single leaf of fixed length and
+   // fundamental type into one bytearray, basket by basket through GetBulkEntries; the
+   // result is a tuple (bytearray, struct format, number of values per entry), to be
+   // viewed with memoryview or numpy.frombuffer w/o further copies
+      Long64_t first = 0, last = -1;
+      if ( ! PyArg_ParseTuple( args, const_cast< char* >( "|LL:_ReadBulk" ), &first, &last ) )
+         return 0;
+
+      TBranch* branch =
+         (TBranch*)OP2TCLASS(self)->DynamicCast( TBranch::Class(), self->GetObject() );
+      if ( ! branch ) {
+         PyErr_SetString( PyExc_ReferenceError, "attempt to access a null-pointer" );
+         return 0;
+      }
+
+      TLeaf* leaf = branch->GetListOfLeaves()->GetEntriesFast() == 1 ?
+         (TLeaf*)branch->GetListOfLeaves()->UncheckedAt( 0 ) : 0;
+      const char* format = 0;
+      if ( leaf && ! leaf->GetLeafCount() ) {
+         static const char* types[][2] = {
+            { "Char_t",  "b" }, { "UChar_t",  "B" }, { "Short_t",   "h" }, { "UShort_t", "H" },
+            { "Int_t",   "i" }, { "UInt_t",   "I" }, { "Long64_t",  "q" }, { "ULong64_t", "Q" },
+            { "Float_t", "f" }, { "Double_t", "d" }, { "Bool_t",    "?" } };
+         const char* tname = leaf->GetTypeName();
+         for ( unsigned int i = 0; i < sizeof(types)/sizeof(types[0]); ++i ) {
+            if ( strcmp( tname, types[i][0] ) == 0 ) {
+               format = types[i][1];
+               break;
+            }
+         }
+      }
+      if ( ! format ) {
+         PyErr_Format( PyExc_TypeError,
+            "branch %s does not hold a fixed number of values of a fundamental type", branch->GetName() );
+         return 0;
+      }
+
+      Long64_t nentries = branch->GetEntries();
+      if ( last < 0 || nentries <= last )
+         last = nentries - 1;
+      if ( first < 0 )
+         first = 0;
+      Long64_t nwanted = first <= last ? last - first + 1 : 0;
+      Long64_t entrysize = leaf->GetLenStatic() * leaf->GetLenType();
+
+      PyObject* pyarray = PyByteArray_FromStringAndSize( 0, (Py_ssize_t)(nwanted * entrysize) );
+      if ( ! pyarray )
+         return 0;
+      char* data = PyByteArray_AS_STRING( pyarray );
+
+   // the baskets entirely within the range are converted directly into the result,
+   // only a partial last basket goes through a scratch buffer
+      TBufferFile scratch( TBuffer::kRead, 0 );
+      Long64_t entry = first;
+      while ( entry <= last ) {
+         Int_t ibasket = TMath::BinarySearch(
+            branch->GetWriteBasket() + 1, branch->GetBasketEntry(), entry );
+         Long64_t basketend = ( ibasket < 0 || ibasket == branch->GetWriteBasket() ) ?
+            branch->GetEntryNumber() : branch->GetBasketEntry()[ ibasket + 1 ];
+         char* dest = data + ( entry - first ) * entrysize;
+
+         Int_t nread = 0;
+         if ( basketend <= last + 1 ) {
+            TBufferFile view( TBuffer::kRead, Int_t( ( basketend - entry ) * entrysize ), dest, kFALSE );
+            nread = branch->GetBulkEntries( entry, view );
+         } else {
+            nread = branch->GetBulkEntries( entry, scratch );
+            if ( 0 < nread ) {
+               nread = Int_t( last + 1 - entry );
+               memcpy( dest, scratch.Buffer(), nread * entrysize );
+            }
+         }
+
+         if ( nread <= 0 ) {
+            Py_DECREF( pyarray );
+            PyErr_Format( PyExc_IOError, "failed to read entry %lld of branch %s", entry, branch->GetName() );
+            return 0;
+         }
+         entry += nread;
+      }
+
+      return Py_BuildValue( const_cast< char* >( "(Nsi)" ), pyarray, format, leaf->GetLenStatic() );
+   }
+
 //- TMinuit behavior ----------------------------------------------------------
    void TMinuitPyCallback( void* vpyfunc, Long_t /* npar */,
          Int_t& a0, Double_t* a1, Double_t& a2, Double_t* a3, Int_t a4 ) {
    // a void* was passed to keep the interface on builtin types only
+      PyGILRAII thePyGILRAII;
       PyObject* pyfunc = (PyObject*)vpyfunc;
 
    // prepare arguments
@@ -1779,6 +1869,7 @@ namespace PyROOT {      // workaround for Intel icc on Linux
 //- TFN behavior --------------------------------------------------------------
    double TFNPyCallback( void* vpyfunc, Long_t npar, double* a0, double* a1 ) {
    // a void* was passed to keep the interface on builtin types only
+      PyGILRAII thePyGILRAII;
       PyObject* pyfunc = (PyObject*)vpyfunc;
 
    // prepare arguments and call
@@ -2109,6 +2200,7 @@ namespace {
    void FitterPyCallback( int& npar, double* gin, double& f, double* u, int flag )
    {
    // Cling-callable callback for Fit::Fitter derived objects.
+      PyGILRAII thePyGILRAII;
       PyObject* result = 0;
 
    // prepare arguments
@@ -2569,6 +2661,13 @@ Bool_t PyROOT::Pythonize( PyObject* pyclass, const std::string& name )
 
    }
 
+   else if ( name == "TBranch" ) {
+   // bulk read of the branch content, for the array views of ROOT.py
+      Utility::AddToClass( pyclass, "_ReadBulk", (PyCFunction) TBranchReadBulk, METH_VARARGS );
+
+      return kTRUE;
+   }
+
    else if ( name == "TChain" ) {
    // allow SetBranchAddress to take object directly, w/o needing AddressOf()
       MethodProxy* original =
@@ -664,6 +664,26 @@ namespace {
       return 0;
    }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set the global GIL policy, which determines whether the GIL is released for
+/// the duration of all C++ calls, or only of those of methods marked '_threaded'.
+
+   PyObject* SetGILPolicy( PyObject*, PyObject* args )
+   {
+      PyObject* policy = 0;
+      if ( ! PyArg_ParseTuple( args, const_cast< char* >( "O!" ), &PyInt_Type, &policy ) )
+         return 0;
+
+      Long_t l = PyInt_AS_LONG( policy );
+      if ( TCallContext::SetGILPolicy( (TCallContext::ECallFlags)l ) ) {
+         Py_INCREF( Py_None );
+         return Py_None;
+      }
+
+      PyErr_Format( PyExc_ValueError, "Unknown policy %ld", l );
+      return 0;
+   }
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set the ownership (True is python-owns) for the given object.
 
@@ -777,6 +797,8 @@ static PyMethodDef gPyROOTMethods[] = {
      METH_VARARGS, (char*) "Determines object ownership model" },
    { (char*) "SetSignalPolicy", (PyCFunction)SetSignalPolicy,
      METH_VARARGS, (char*) "Trap signals in safe mode to prevent interpreter abort" },
+   { (char*) "SetGILPolicy", (PyCFunction)SetGILPolicy,
+     METH_VARARGS, (char*) "Determines whether the GIL is released during C++ calls" },
    { (char*) "SetOwnership", (PyCFunction)SetOwnership,
      METH_VARARGS, (char*) "Modify held C++ object ownership" },
    { (char*) "AddSmartPtrType", (PyCFunction)AddSmartPtrType,
@@ -923,6 +945,10 @@ extern "C" void initlibPyROOT()
       PyInt_FromLong( (int)TCallContext::kFast ) );
    PyModule_AddObject( gRootModule, (char*)"kSignalSafe",
       PyInt_FromLong( (int)TCallContext::kSafe ) );
+   PyModule_AddObject( gRootModule, (char*)"kGILHold",
+      PyInt_FromLong( (int)TCallContext::kNone ) );
+   PyModule_AddObject( gRootModule, (char*)"kGILRelease",
+      PyInt_FromLong( (int)TCallContext::kReleaseGIL ) );
 
 // setup ROOT
    PyROOT::InitRoot();
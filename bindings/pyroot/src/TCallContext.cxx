@@ -9,6 +9,7 @@ namespace PyROOT {
    TCallContext::ECallFlags TCallContext::sMemoryPolicy = TCallContext::kUseHeuristics;
 // this is just a data holder for linking; actual value is set in RootModule.cxx
    TCallContext::ECallFlags TCallContext::sSignalPolicy = TCallContext::kSafe;
+   TCallContext::ECallFlags TCallContext::sGILPolicy    = TCallContext::kNone;
 
 } // namespace PyROOT
 
@@ -39,3 +40,16 @@ Bool_t PyROOT::TCallContext::SetSignalPolicy( ECallFlags e )
    return kFALSE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set the global GIL policy, which determines whether the GIL is released
+/// during all C++ calls (kReleaseGIL) or only during those of the methods that
+/// have their '_threaded' flag set (kNone).
+
+Bool_t PyROOT::TCallContext::SetGILPolicy( ECallFlags e )
+{
+   if ( kNone == e || e == kReleaseGIL ) {
+      sGILPolicy = e;
+      return kTRUE;
+   }
+   return kFALSE;
+}
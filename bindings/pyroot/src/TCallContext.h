@@ -53,6 +53,10 @@ namespace PyROOT {
       static ECallFlags sSignalPolicy;
       static Bool_t SetSignalPolicy( ECallFlags e );
 
+   // GIL handling, for the methods that do not set kReleaseGIL themselves
+      static ECallFlags sGILPolicy;
+      static Bool_t SetGILPolicy( ECallFlags e );
+
    // payload
       std::vector< TParameter > fArgs;
       UInt_t fFlags;
@@ -4,6 +4,7 @@
 #include "PyROOT.h"
 #include "TPyDispatcher.h"
 #include "RootWrapper.h"
+#include "Utility.h"
 
 // ROOT
 #include "TClass.h"
@@ -63,6 +64,7 @@ TPyDispatcher& TPyDispatcher::operator=( const TPyDispatcher& other )
 /// Destructor. Reference counting for the held python object is in effect.
 
 TPyDispatcher::~TPyDispatcher() {
+   PyROOT::PyGILRAII thePyGILRAII;
    Py_XDECREF( fCallable );
 }
 
@@ -73,6 +75,7 @@ PyObject* TPyDispatcher::DispatchVA( const char* format, ... )
 // Dispatch the arguments to the held callable python object, using format to
 // interpret the types of the arguments. Note that format is in python style,
 // not in C printf style. See: https://docs.python.org/2/c-api/arg.html .
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* args = 0;
 
    if ( format ) {
@@ -111,6 +114,7 @@ PyObject* TPyDispatcher::DispatchVA( const char* format, ... )
 
 PyObject* TPyDispatcher::DispatchVA1( const char* clname, void* obj, const char* format, ... )
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* pyobj = PyROOT::BindCppObject( obj, Cppyy::GetScope( clname ), kFALSE /* isRef */ );
    if ( ! pyobj ) {
       PyErr_Print();
@@ -168,6 +172,7 @@ PyObject* TPyDispatcher::DispatchVA1( const char* clname, void* obj, const char*
 
 PyObject* TPyDispatcher::Dispatch( TPad* selpad, TObject* selected, Int_t event )
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* args = PyTuple_New( 3 );
    PyTuple_SET_ITEM( args, 0, PyROOT::BindCppObject( selpad, Cppyy::GetScope( "TPad" ) ) );
    PyTuple_SET_ITEM( args, 1, PyROOT::BindCppObject( selected, Cppyy::GetScope( "TObject" ) ) );
@@ -188,6 +193,7 @@ PyObject* TPyDispatcher::Dispatch( TPad* selpad, TObject* selected, Int_t event
 
 PyObject* TPyDispatcher::Dispatch( Int_t event, Int_t x, Int_t y, TObject* selected )
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* args = PyTuple_New( 4 );
    PyTuple_SET_ITEM( args, 0, PyInt_FromLong( event ) );
    PyTuple_SET_ITEM( args, 1, PyInt_FromLong( x ) );
@@ -209,6 +215,7 @@ PyObject* TPyDispatcher::Dispatch( Int_t event, Int_t x, Int_t y, TObject* selec
 
 PyObject* TPyDispatcher::Dispatch( TVirtualPad* pad, TObject* obj, Int_t event )
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* args = PyTuple_New( 3 );
    PyTuple_SET_ITEM( args, 0, PyROOT::BindCppObject( pad, Cppyy::GetScope( "TVirtualPad" ) ) );
    PyTuple_SET_ITEM( args, 1, PyROOT::BindCppObject( obj, Cppyy::GetScope( "TObject" ) ) );
@@ -229,6 +236,7 @@ PyObject* TPyDispatcher::Dispatch( TVirtualPad* pad, TObject* obj, Int_t event )
 
 PyObject* TPyDispatcher::Dispatch( TGListTreeItem* item, TDNDData* data )
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* args = PyTuple_New( 2 );
    PyTuple_SET_ITEM( args, 0, PyROOT::BindCppObject( item, Cppyy::GetScope( "TGListTreeItem" ) ) );
    PyTuple_SET_ITEM( args, 1, PyROOT::BindCppObject( data, Cppyy::GetScope( "TDNDData" ) ) );
@@ -248,6 +256,7 @@ PyObject* TPyDispatcher::Dispatch( TGListTreeItem* item, TDNDData* data )
 
 PyObject* TPyDispatcher::Dispatch( const char* name, const TList* attr )
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* args = PyTuple_New( 2 );
    PyTuple_SET_ITEM( args, 0, PyBytes_FromString( name ) );
    PyTuple_SET_ITEM( args, 1, PyROOT::BindCppObject( (void*)attr, Cppyy::GetScope( "TList" ) ) );
@@ -267,6 +276,7 @@ PyObject* TPyDispatcher::Dispatch( const char* name, const TList* attr )
 
 PyObject* TPyDispatcher::Dispatch( TSlave* slave, TProofProgressInfo* pi )
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* args = PyTuple_New( 2 );
    PyTuple_SET_ITEM( args, 0, PyROOT::BindCppObject( slave, Cppyy::GetScope( "TSlave" ) ) );
    PyTuple_SET_ITEM( args, 1, PyROOT::BindCppObject( pi, Cppyy::GetScope( "TProofProgressInfo" ) ) );
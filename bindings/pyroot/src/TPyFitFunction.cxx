@@ -6,6 +6,7 @@
 #include "ObjectProxy.h"
 #include "MethodProxy.h"
 #include "TPyBufferFactory.h"
+#include "Utility.h"
 
 // Standard
 #include <stdexcept>
@@ -83,6 +84,7 @@ TPyMultiGenFunction::TPyMultiGenFunction( PyObject* self ) : fPySelf( 0 )
 
 TPyMultiGenFunction::~TPyMultiGenFunction()
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    if ( fPySelf == Py_None ) {
       Py_DECREF( fPySelf );
    }
@@ -93,6 +95,7 @@ TPyMultiGenFunction::~TPyMultiGenFunction()
 unsigned int TPyMultiGenFunction::NDim() const
 {
 // Simply forward the call to python self.
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* pyresult = DispatchCall( fPySelf, "NDim" );
 
    if ( ! pyresult ) {
@@ -111,6 +114,7 @@ unsigned int TPyMultiGenFunction::NDim() const
 
 double TPyMultiGenFunction::DoEval( const double* x ) const
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* xbuf = PyROOT::TPyBufferFactory::Instance()->PyBuffer_FromMemory( (Double_t*)x );
    PyObject* pyresult = DispatchCall( fPySelf, "DoEval", NULL, xbuf );
    Py_DECREF( xbuf );
@@ -146,6 +150,7 @@ TPyMultiGradFunction::TPyMultiGradFunction( PyObject* self )
 
 TPyMultiGradFunction::~TPyMultiGradFunction()
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    if ( fPySelf == Py_None ) {
       Py_DECREF( fPySelf );
    }
@@ -156,6 +161,7 @@ TPyMultiGradFunction::~TPyMultiGradFunction()
 unsigned int TPyMultiGradFunction::NDim() const
 {
 // Simply forward the call to python self.
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* pyresult = DispatchCall( fPySelf, "NDim" );
 
    if ( ! pyresult ) {
@@ -174,6 +180,7 @@ unsigned int TPyMultiGradFunction::NDim() const
 
 double TPyMultiGradFunction::DoEval( const double* x ) const
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* xbuf = PyROOT::TPyBufferFactory::Instance()->PyBuffer_FromMemory( (Double_t*)x );
    PyObject* pyresult = DispatchCall( fPySelf, "DoEval", NULL, xbuf );
    Py_DECREF( xbuf );
@@ -193,6 +200,7 @@ double TPyMultiGradFunction::DoEval( const double* x ) const
 /// Simply forward the call to python self.
 
 void TPyMultiGradFunction::Gradient( const double* x, double* grad ) const {
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* pymethod = GetOverriddenPyMethod( fPySelf, "Gradient" );
 
    if ( pymethod ) {
@@ -218,6 +226,7 @@ void TPyMultiGradFunction::Gradient( const double* x, double* grad ) const {
 
 void TPyMultiGradFunction::FdF( const double* x, double& f, double* df ) const
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* pymethod = GetOverriddenPyMethod( fPySelf, "FdF" );
 
    if ( pymethod ) {
@@ -249,6 +258,7 @@ void TPyMultiGradFunction::FdF( const double* x, double& f, double* df ) const
 
 double TPyMultiGradFunction::DoDerivative( const double * x, unsigned int icoord ) const
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* xbuf = PyROOT::TPyBufferFactory::Instance()->PyBuffer_FromMemory( (Double_t*)x );
    PyObject* pycoord = PyLong_FromLong( icoord );
 
@@ -7,6 +7,7 @@
 #include "MethodProxy.h"
 #include "RootWrapper.h"
 #include "TMemoryRegulator.h"
+#include "Utility.h"
 
 //- ROOT
 #include "TPython.h"
@@ -212,6 +213,7 @@ TPySelector::TPySelector( TTree*, PyObject* self ) : fChain( 0 ), fPySelf( 0 )
 
 TPySelector::~TPySelector()
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    if ( fPySelf == Py_None ) {
       Py_DECREF( fPySelf );
    }
@@ -222,6 +224,7 @@ TPySelector::~TPySelector()
 Int_t TPySelector::Version() const {
 // Return version number of this selector. First forward; if not overridden, then
 // yield an obvious "undefined" number,
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* result = const_cast< TPySelector* >( this )->CallSelf( "Version" );
    if ( result && result != Py_None ) {
       Int_t ires = (Int_t)PyLong_AsLong( result );
@@ -247,6 +250,7 @@ Int_t TPySelector::GetEntry( Long64_t entry, Int_t getall )
 
 void TPySelector::Init( TTree* tree )
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    if ( ! tree )
       return;
 
@@ -269,6 +273,7 @@ void TPySelector::Init( TTree* tree )
 
 Bool_t TPySelector::Notify()
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* result = CallSelf( "Notify" );
 
    if ( ! result )
@@ -287,6 +292,7 @@ Bool_t TPySelector::Notify()
 
 void TPySelector::Begin( TTree* )
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    SetupPySelf();
 
 // As per the generated code: the tree argument is deprecated (on PROOF 0 is
@@ -305,6 +311,7 @@ void TPySelector::Begin( TTree* )
 
 void TPySelector::SlaveBegin( TTree* tree )
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    SetupPySelf();
    Init( tree );
 
@@ -328,6 +335,7 @@ void TPySelector::SlaveBegin( TTree* tree )
 
 Bool_t TPySelector::Process( Long64_t entry )
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    if ( ! fPySelf || fPySelf == Py_None ) {
    // would like to set a python error, but can't risk that in case of a
    // configuration problem, as it would be absorbed ...
@@ -354,6 +362,7 @@ Bool_t TPySelector::Process( Long64_t entry )
 
 void TPySelector::SlaveTerminate()
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* result = CallSelf( "SlaveTerminate" );
 
    if ( ! result )
@@ -367,6 +376,7 @@ void TPySelector::SlaveTerminate()
 
 void TPySelector::Terminate()
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    PyObject* result = CallSelf( "Terminate" );
 
    if ( ! result )
@@ -380,6 +390,7 @@ void TPySelector::Terminate()
 
 void TPySelector::Abort( const char* why, EAbort what )
 {
+   PyROOT::PyGILRAII thePyGILRAII;
    if ( ! why && PyErr_Occurred() ) {
       PyObject *pytype = 0, *pyvalue = 0, *pytrace = 0;
       PyErr_Fetch( &pytype, &pyvalue, &pytrace );
@@ -5,6 +5,7 @@
 # FFTW_LIBRARIES, the libraries to link against to use fftw3
 # FFTW_FOUND.  If false, you cannot build anything that requires fftw3.
 # FFTW_LIBRARY, where to find the libfftw3 library.
+# FFTW_THREADS_LIBRARY, where to find the libfftw3_threads library, if any.
 
 set(FFTW_FOUND 0)
 if(FFTW_LIBRARY AND FFTW_INCLUDE_DIR)
@@ -29,14 +30,29 @@ find_library(FFTW_LIBRARY NAMES fftw3 fftw3-3 PATHS
   DOC "Specify the fttw3 library here."
 )
 
+get_filename_component(_fftw_libdir "${FFTW_LIBRARY}" PATH)
+find_library(FFTW_THREADS_LIBRARY NAMES fftw3_threads PATHS
+  ${_fftw_libdir}
+  $ENV{FFTW_DIR}/lib
+  $ENV{FFTW3} $ENV{FFTW3}/lib $ENV{FFTW3}/threads/.libs
+  DOC "Specify the fttw3_threads library here (optional)."
+)
+
 if(FFTW_INCLUDE_DIR AND FFTW_LIBRARY)
   set(FFTW_FOUND 1 )
   if(NOT FFTW_FIND_QUIETLY)
      message(STATUS "Found fftw3 includes at ${FFTW_INCLUDE_DIR}")
      message(STATUS "Found fftw3 library at ${FFTW_LIBRARY}")
+     if(FFTW_THREADS_LIBRARY)
+       message(STATUS "Found fftw3_threads library at ${FFTW_THREADS_LIBRARY}")
+     endif()
   endif()
 endif()
 
-set(FFTW_LIBRARIES ${FFTW_LIBRARY})
+if(FFTW_THREADS_LIBRARY)
+  set(FFTW_LIBRARIES ${FFTW_THREADS_LIBRARY} ${FFTW_LIBRARY})
+else()
+  set(FFTW_LIBRARIES ${FFTW_LIBRARY})
+endif()
 
-mark_as_advanced(FFTW_FOUND FFTW_LIBRARY FFTW_INCLUDE_DIR)
+mark_as_advanced(FFTW_FOUND FFTW_LIBRARY FFTW_THREADS_LIBRARY FFTW_INCLUDE_DIR)
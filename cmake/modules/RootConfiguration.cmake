@@ -437,6 +437,11 @@ if(imt)
 else()
   set(useimt undef)
 endif()
+if(trace)
+  set(usetrace define)
+else()
+  set(usetrace undef)
+endif()
 if(CMAKE_USE_PTHREADS_INIT)
   set(haspthread define)
 else()
@@ -222,6 +222,35 @@ if(builtin_lzma)
 endif()
 
 
+#---Check for LZ4--------------------------------------------------------------------
+if(lz4)
+  message(STATUS "Looking for LZ4")
+  find_package(LZ4)
+  if(NOT LZ4_FOUND)
+    if(fail-on-missing)
+      message(FATAL_ERROR "LZ4 not found and it is required ('fail-on-missing' enabled).")
+    else()
+      message(STATUS "LZ4 not found. Switching off lz4 option")
+      set(lz4 OFF CACHE BOOL "" FORCE)
+    endif()
+  endif()
+endif()
+
+#---Check for ZSTD-------------------------------------------------------------------
+if(zstd)
+  message(STATUS "Looking for ZSTD")
+  find_package(ZSTD)
+  if(NOT ZSTD_FOUND)
+    if(fail-on-missing)
+      message(FATAL_ERROR "ZSTD not found and it is required ('fail-on-missing' enabled).")
+    else()
+      message(STATUS "ZSTD not found. Switching off zstd option")
+      set(zstd OFF CACHE BOOL "" FORCE)
+    endif()
+  endif()
+endif()
+
+
 #---Check for X11 which is mandatory lib on Unix--------------------------------------
 if(x11)
   message(STATUS "Looking for X11")
@@ -758,13 +787,14 @@ if(builtin_fftw3)
     FFTW3
     URL ${repository_tarfiles}/fftw-${FFTW_VERSION}.tar.gz
     INSTALL_DIR ${CMAKE_BINARY_DIR}
-    CONFIGURE_COMMAND ./configure --prefix=<INSTALL_DIR>
+    CONFIGURE_COMMAND ./configure --prefix=<INSTALL_DIR> --enable-threads
     BUILD_COMMAND make CFLAGS=-fPIC
     LOG_DOWNLOAD 1 LOG_CONFIGURE 1 LOG_BUILD 1 LOG_INSTALL 1
     BUILD_IN_SOURCE 1
   )
   set(FFTW_INCLUDE_DIR ${CMAKE_BINARY_DIR}/include)
-  set(FFTW_LIBRARIES ${CMAKE_BINARY_DIR}/lib/libfftw3.a)
+  set(FFTW_THREADS_LIBRARY ${CMAKE_BINARY_DIR}/lib/libfftw3_threads.a)
+  set(FFTW_LIBRARIES ${FFTW_THREADS_LIBRARY} ${CMAKE_BINARY_DIR}/lib/libfftw3.a)
   set(fftw3 ON CACHE BOOL "" FORCE)
 endif()
 
@@ -1314,6 +1344,34 @@ if(tmva)
   find_package(BLAS QUIET)
 endif()
 
+#---Check for BLAS and LAPACK for Minuit2---------------------------------------------
+if(minuit2 AND minuit2_blas)
+  message(STATUS "Looking for BLAS and LAPACK for Minuit2")
+  find_package(LAPACK)
+  if(NOT LAPACK_FOUND)
+    if(fail-on-missing)
+      message(FATAL_ERROR "BLAS or LAPACK not found and option 'minuit2_blas' is required")
+    else()
+      message(STATUS "BLAS or LAPACK not found. Switching OFF 'minuit2_blas' option")
+      set(minuit2_blas OFF CACHE BOOL "" FORCE)
+    endif()
+  endif()
+endif()
+
+#---Check for LAPACK for the matrix package-------------------------------------------
+if(matrix_lapack)
+  message(STATUS "Looking for LAPACK for the matrix package")
+  find_package(LAPACK)
+  if(NOT LAPACK_FOUND)
+    if(fail-on-missing)
+      message(FATAL_ERROR "LAPACK not found and option 'matrix_lapack' is required")
+    else()
+      message(STATUS "LAPACK not found. Switching OFF 'matrix_lapack' option")
+      set(matrix_lapack OFF CACHE BOOL "" FORCE)
+    endif()
+  endif()
+endif()
+
 #---Report non implemented options---------------------------------------------------
 foreach(opt afs glite sapdb srp)
   if(${opt})
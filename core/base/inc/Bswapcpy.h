@@ -16,14 +16,17 @@
 //                                                                      //
 // Initial version: Apr 22, 2000                                        //
 //                                                                      //
-// A set of inline byte swapping routines for arrays.                   //
+// A set of byte swapping routines for arrays.                          //
 //                                                                      //
-// The bswapcpy16() and bswapcpy32() routines are used for packing      //
-// arrays of basic types into a buffer in a byte swapped order. Use     //
-// of asm and the `bswap' opcode (available on i486 and up) reduces     //
-// byte swapping overhead on linux.                                     //
+// The bswapcpy16(), bswapcpy32() and bswapcpy64() routines are used    //
+// for packing arrays of basic types into a buffer in a byte swapped    //
+// order (and for unpacking them). The implementation is selected at    //
+// run time according to the instruction sets supported by the CPU      //
+// (AVX2 or SSSE3 on x86, NEON on ARM), with a portable fallback.       //
 //                                                                      //
-// Use of routines is similar to that of memcpy.                        //
+// Use of routines is similar to that of memcpy. The source and the     //
+// destination must either be identical (in place swapping) or not      //
+// overlap at all; there are no alignment requirements.                 //
 //                                                                      //
 // ATTENTION:                                                           //
 //                                                                      //
@@ -32,6 +35,7 @@
 //                                                                      //
 // For arrays of short type (2 bytes in size) use bswapcpy16().         //
 // For arrays of of 4-byte types (int, float) use bswapcpy32().         //
+// For arrays of of 8-byte types (long long, double) use bswapcpy64().  //
 //                                                                      //
 //                                                                      //
 // Author: Alexandre V. Vaniachine <AVVaniachine@lbl.gov>               //
@@ -42,40 +46,19 @@
 #include <sys/types.h>
 #endif
 
-extern inline void * bswapcpy16(void * to, const void * from, size_t n)
-{
-int d0, d1, d2, d3;
-__asm__ __volatile__(
-        "cld\n"
-        "1:\tlodsw\n\t"
-        "rorw $8, %%ax\n\t"
-        "stosw\n\t"
-        "loop 1b\n\t"
-        :"=&c" (d0), "=&D" (d1), "=&S" (d2), "=&a" (d3)
-        :"0" (n), "1" ((long) to),"2" ((long) from)
-        :"memory");
-return (to);
-}
+void *bswapcpy16(void *to, const void *from, size_t n);
+void *bswapcpy32(void *to, const void *from, size_t n);
+void *bswapcpy64(void *to, const void *from, size_t n);
 
-extern inline void * bswapcpy32(void * to, const void * from, size_t n)
-{
-int d0, d1, d2, d3;
-__asm__ __volatile__(
-        "cld\n"
-        "1:\tlodsl\n\t"
-#if !defined __i486__ && !defined __pentium__ && !defined __pentiumpro__ && \
-    !defined __pentium4__ && !defined __x86_64__
-        "rorw $8, %%ax\n\t"
-        "rorl $16, %%eax\n\t"
-        "rorw $8, %%ax\n\t"
-#else
-        "bswap %%eax\n\t"
-#endif
-        "stosl\n\t"
-        "loop 1b\n\t"
-        :"=&c" (d0), "=&D" (d1), "=&S" (d2), "=&a" (d3)
-        :"0" (n), "1" ((long) to),"2" ((long) from)
-        :"memory");
-return (to);
+namespace ROOT {
+namespace Internal {
+   /// Name of the byte swapping kernel selected for this CPU
+   /// ("avx2", "ssse3", "neon" or "scalar").
+   const char *GetBswapcpyKernel();
+   /// Force the portable implementation (kTRUE) or the best one (kFALSE);
+   /// meant for testing and benchmarking.
+   void SetBswapcpyScalar(bool scalar);
 }
+}
+
 #endif
@@ -58,7 +58,6 @@
 #pragma link C++ global gErrorAbortLevel;
 #pragma link C++ global gPrintViaErrorHandler;
 #pragma link C++ global gStyle;
-#pragma link C++ global gVirtualPS;
 #pragma link C++ global gRootDir;
 #pragma link C++ global gProgName;
 #pragma link C++ global gProgPath;
@@ -0,0 +1,71 @@
+// @(#)root/base:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TLockStats
+#define ROOT_TLockStats
+
+#include "Rtypes.h"
+
+#include <string>
+#include <vector>
+
+namespace ROOT {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Statistics of the acquisitions of the locks (TMutex, and thus the
+/// TVirtualMutex used with R__LOCKGUARD, and TRWSpinLock), per lock and per
+/// call site.
+///
+/// They are recorded only if the environment variable ROOT_LOCK_STATS was
+/// set (to anything but 0) when the program started, and printed at exit;
+/// otherwise locking only costs the test of IsEnabled(). For each lock and
+/// each site acquiring it the statistics give the number of acquisitions,
+/// how many had to wait for another thread, the time spent waiting and the
+/// time the other threads waited while the lock was held by this site.
+/// The call site is the file and line of R__LOCKGUARD, "unknown" for a
+/// direct call to TVirtualMutex::Lock, "ReadLock" or "WriteLock" for a
+/// TRWSpinLock; the locks are identified by the name given with SetName, else
+/// by their address.
+class TLockStats {
+public:
+   /// Statistics of a call site of a lock.
+   struct Entry_t {
+      std::string fLock;       ///< Name of the lock
+      std::string fSite;       ///< Call site
+      ULong64_t   fAcquired;   ///< Number of acquisitions
+      ULong64_t   fContended;  ///< Number of acquisitions which had to wait for another thread
+      Long64_t    fWaitNs;     ///< Time spent waiting (ns)
+      Long64_t    fMaxWaitNs;  ///< Longest wait (ns)
+      ULong64_t   fBlocking;   ///< Number of waits of other threads while this site held the lock
+      Long64_t    fBlockingNs; ///< Time other threads waited while this site held the lock (ns)
+   };
+
+   static Bool_t IsEnabled() { return fgEnabled; }
+
+   static void     SetName(const void *lock, const char *name);
+   static void     SetSite(const char *site);
+   static const char *TakeSite();
+   static Long64_t Now();
+   static void     Record(const void *lock, const char *site, Bool_t contended, Long64_t waitNs, const char *holder);
+
+   static std::vector<Entry_t> GetEntries();
+   static void     Print();
+   static void     Reset();
+
+private:
+   static Bool_t fgEnabled; // True if ROOT_LOCK_STATS is set
+};
+
+} // End of namespace Internal
+} // End of namespace ROOT
+
+#endif // ROOT_TLockStats
@@ -0,0 +1,61 @@
+// @(#)root/base:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TObjectPool
+#define ROOT_TObjectPool
+
+#include "Rtypes.h"
+
+#include <cstddef>
+
+namespace ROOT {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// A per-thread cache of the memory of the objects allocated by
+/// TObject::operator new (through TStorage::ObjectAlloc).
+///
+/// The pool is enabled by setting the environment variable ROOT_OBJECT_POOL
+/// (to anything but 0) before the process starts; it cannot be switched on
+/// or off later since the memory it hands out must go back to it. The blocks
+/// of up to GetMaxObjectSize() bytes are grouped in size classes of 16 bytes:
+/// a block released by a thread is reused by the next object of the same
+/// class allocated on that thread, without going through the allocator nor
+/// taking any lock. Each thread keeps at most GetMaxCachedBytes() bytes of
+/// free blocks; beyond this the blocks are deleted.
+class TObjectPool {
+public:
+   /// Statistics of the pool of a thread.
+   struct Stats_t {
+      ULong64_t fAcquired;    ///< Number of blocks requested
+      ULong64_t fReused;      ///< Number of requests served by a cached block
+      ULong64_t fReleased;    ///< Number of blocks given back
+      ULong64_t fDropped;     ///< Number of blocks given back but deleted (cache full, too large)
+      Long64_t  fCachedBytes; ///< Bytes currently cached
+      Long64_t  fHighWater;   ///< Maximum of fCachedBytes
+   };
+
+   static Bool_t   IsEnabled();
+   static void    *Acquire(size_t size);
+   static void     Release(void *ptr);
+
+   static void     Clear();
+   static size_t   GetMaxObjectSize();
+   static Long64_t GetMaxCachedBytes();
+   static void     SetMaxCachedBytes(Long64_t bytes);
+   static Stats_t  GetStats();
+   static void     Print();
+};
+
+} // End of namespace Internal
+} // End of namespace ROOT
+
+#endif // ROOT_TObjectPool
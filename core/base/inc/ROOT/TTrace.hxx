@@ -0,0 +1,80 @@
+// @(#)root/base:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TTrace
+#define ROOT_TTrace
+
+#include "RConfigure.h" // R__USE_TRACE
+#include "Rtypes.h"
+
+namespace ROOT {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Trace of the time spent in the zones of the hot paths (R__TRACE_ZONE), per
+/// thread, written in the JSON trace format of Chrome (chrome://tracing,
+/// Perfetto).
+///
+/// The zones are compiled only if ROOT was configured with -Dtrace=ON
+/// (R__USE_TRACE); otherwise R__TRACE_ZONE expands to nothing. Even then
+/// they are recorded only if the environment variable ROOT_TRACE was set
+/// when the program started, to the name of the file written at exit ("1"
+/// for root_trace.json), or after Enable(); otherwise a zone only costs the
+/// test of IsEnabled().
+class TTrace {
+public:
+   static Bool_t IsEnabled() { return fgEnabled; }
+   static void   Enable(Bool_t enable = kTRUE);
+
+   static Long64_t Now();
+   static void     Record(const char *name, const char *category, Long64_t beginNs, Long64_t endNs);
+
+   static Bool_t Write(const char *filename);
+   static void   Reset();
+
+private:
+   static Bool_t fgEnabled; // True if the zones are recorded
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// A zone of the trace, from its construction to its destruction; name and
+/// category must be string literals, they are kept as pointers.
+class TTraceZone {
+   const char *fName;
+   const char *fCategory;
+   Long64_t    fBeginNs; // -1 if the trace was disabled at the start of the zone
+
+public:
+   TTraceZone(const char *name, const char *category)
+      : fName(name), fCategory(category), fBeginNs(TTrace::IsEnabled() ? TTrace::Now() : -1)
+   {
+   }
+   ~TTraceZone()
+   {
+      if (fBeginNs >= 0)
+         TTrace::Record(fName, fCategory, fBeginNs, TTrace::Now());
+   }
+};
+
+} // End of namespace Internal
+} // End of namespace ROOT
+
+#define R__TRACE_CONCAT_IMPL(a, b) a##b
+#define R__TRACE_CONCAT(a, b) R__TRACE_CONCAT_IMPL(a, b)
+
+#ifdef R__USE_TRACE
+#define R__TRACE_ZONE(name, category) \
+   ::ROOT::Internal::TTraceZone R__TRACE_CONCAT(R__traceZone, __LINE__)(name, category)
+#else
+#define R__TRACE_ZONE(name, category)
+#endif
+
+#endif // ROOT_TTrace
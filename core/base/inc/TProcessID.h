@@ -36,6 +36,8 @@ class TExMap;
 
 namespace ROOT {
    namespace Internal {
+      class TProcessIDObjects;
+
      /**
       * \class ROOT::Internal::TAtomicPointer
       * \brief Helper class to manage atomic pointers.
@@ -80,11 +82,12 @@ protected:
    std::atomic_int    fCount;                           //!Reference count to this object (from TFile)
    ROOT::Internal::TAtomicPointer<TObjArray*> fObjects; //!Array pointing to the referenced objects
    std::atomic_flag   fLock;                            //!Spin lock for initialization of fObjects
+   std::atomic<ROOT::Internal::TProcessIDObjects*> fTable; //!Lock-free copy of fObjects, read by GetObjectWithID
 
-   static TProcessID *fgPID;      //Pointer to current session ProcessID
+   static std::atomic<TProcessID*> fgPID;    //Pointer to current session ProcessID
    static TObjArray  *fgPIDs;     //Table of ProcessIDs
    static TExMap     *fgObjPIDs;  //Table pointer to pids
-   static UInt_t      fgNumber;   //Referenced objects count
+   static std::atomic<UInt_t> fgNumber;      //Referenced objects count
 
 public:
    TProcessID();
@@ -89,6 +89,10 @@ namespace Internal {
       TParTreeProcessingRAII()  { EnableParTreeProcessing();  }
       ~TParTreeProcessingRAII() { DisableParTreeProcessing(); }
    };
+
+   // Startup profile, enabled by the environment variable ROOT_STARTUP_PROFILE
+   Bool_t IsStartupProfileEnabled();
+   void MarkStartupPhase(const char *phase, Long64_t count = 0);
 } } // End ROOT::Internal
 
 namespace ROOT {
@@ -25,6 +25,7 @@
 #ifndef ROOT_TObject
 #include "TObject.h"
 #endif
+#include "ROOT/TLockStats.hxx"
 
 class TVirtualMutex;
 
@@ -63,6 +64,8 @@ public:
 // when guard goes out of scope the mutex is unlocked in the TLockGuard //
 // destructor. The exception mechanism takes care of calling the dtors  //
 // of local objects so it is exception safe.                            //
+// The call site (given by R__LOCKGUARD) is used by the lock statistics //
+// (see ROOT::Internal::TLockStats).                                    //
 //                                                                      //
 //////////////////////////////////////////////////////////////////////////
 
@@ -75,8 +78,14 @@ private:
    TLockGuard& operator=(const TLockGuard&);  // not implemented
 
 public:
-   TLockGuard(TVirtualMutex *mutex)
-     : fMutex(mutex) { if (fMutex) fMutex->Lock(); }
+   TLockGuard(TVirtualMutex *mutex, const char *site = 0)
+     : fMutex(mutex) {
+      if (fMutex) {
+         if (R__unlikely(ROOT::Internal::TLockStats::IsEnabled()))
+            ROOT::Internal::TLockStats::SetSite(site);
+         fMutex->Lock();
+      }
+   }
    Int_t UnLock() {
       if (!fMutex) return 0;
       auto tmp = fMutex;
@@ -91,7 +100,11 @@ public:
 // Zero overhead macros in case not compiled with thread support
 #if defined (_REENTRANT) || defined (WIN32)
 
-#define R__LOCKGUARD(mutex) TLockGuard _R__UNIQUE_(R__guard)(mutex)
+// "file:line" of the use of the macro, for the lock statistics
+#define _R__LOCKSITE_LINE_(line) _QUOTE_(line)
+#define _R__LOCKSITE_ __FILE__ ":" _R__LOCKSITE_LINE_(__LINE__)
+
+#define R__LOCKGUARD(mutex) TLockGuard _R__UNIQUE_(R__guard)(mutex, _R__LOCKSITE_)
 #define R__LOCKGUARD2(mutex)                             \
    if (gGlobalMutex && !mutex) {                         \
       gGlobalMutex->Lock();                              \
@@ -100,7 +113,7 @@ public:
       gGlobalMutex->UnLock();                            \
    }                                                     \
    R__LOCKGUARD(mutex)
-#define R__LOCKGUARD_NAMED(name,mutex) TLockGuard _NAME2_(R__guard,name)(mutex)
+#define R__LOCKGUARD_NAMED(name,mutex) TLockGuard _NAME2_(R__guard,name)(mutex, _R__LOCKSITE_)
 #define R__LOCKGUARD_UNLOCK(name) _NAME2_(R__guard,name).UnLock()
 #else
 #define R__LOCKGUARD(mutex)  if (mutex) { }
@@ -84,10 +84,11 @@ public:
    virtual void  SetType(Int_t /*type*/ = -111) { }
    virtual Int_t GetType() const { return 111; }
 
+   static TVirtualPS *&PS();
+
    ClassDef(TVirtualPS,0)  //Abstract interface to a PostScript driver
 };
 
-
-R__EXTERN TVirtualPS  *gVirtualPS;
+#define gVirtualPS (TVirtualPS::PS())
 
 #endif
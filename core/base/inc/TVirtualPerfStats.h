@@ -65,6 +65,15 @@ public:
 
    virtual void UnzipEvent(TObject *tree, Long64_t pos, Double_t start, Int_t complen, Int_t objlen) = 0;
 
+   virtual void BasketReadEvent(TObject * /* branch */, Int_t /* len */, Double_t /* start */, Bool_t /* cachemiss */) {}
+
+   virtual void BasketUnzipEvent(TObject * /* branch */, Double_t /* start */, Int_t /* complen */, Int_t /* objlen */) {}
+
+   virtual void EntryReadEvent(TObject * /* branch */, Int_t /* nbytes */, Double_t /* start */) {}
+
+   virtual void BasketSizeEvent(TObject * /* tree */, TObject * /* branch */, Long64_t /* entry */,
+                                Int_t /* oldsize */, Int_t /* newsize */, Double_t /* compress */) {}
+
    virtual void RateEvent(Double_t proctime, Double_t deltatime,
                           Long64_t eventsprocessed, Long64_t bytesRead) = 0;
 
@@ -0,0 +1,330 @@
+// @(#)root/base:$Id$
+// Author: ROOT I/O team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// Bswapcpy                                                             //
+//                                                                      //
+// Byte swapping copy of arrays of 2, 4 and 8 byte words. The vector    //
+// kernels shuffle the bytes of 16 (SSSE3, NEON) or 32 (AVX2) bytes at  //
+// once; the remaining elements are handled by the portable loop. The   //
+// x86 kernels are compiled with the target attribute and chosen at     //
+// run time, so that the library still runs on CPUs without them.       //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include "Bswapcpy.h"
+
+#include <atomic>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    ((defined(__clang__) && (__clang_major__ > 3 || (__clang_major__ == 3 && __clang_minor__ >= 8))) || \
+     (!defined(__clang__) && !defined(__INTEL_COMPILER) && defined(__GNUC__) && \
+      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define R__BSWAPCPY_X86
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__) || (defined(__ARM_NEON) && defined(__arm__))
+#define R__BSWAPCPY_NEON
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+typedef void (*BswapKernel_t)(char *to, const char *from, size_t n);
+
+struct BswapKernels {
+   const char    *fName;
+   BswapKernel_t  f16;
+   BswapKernel_t  f32;
+   BswapKernel_t  f64;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Portable kernels, also used for the tails of the vector kernels.
+
+inline unsigned short Swap16(unsigned short x)
+{
+   return (unsigned short)(((x >> 8) & 0xff) | ((x & 0xff) << 8));
+}
+
+inline unsigned int Swap32(unsigned int x)
+{
+#if defined(__GNUC__)
+   return __builtin_bswap32(x);
+#else
+   return ((x & 0xff000000) >> 24) | ((x & 0x00ff0000) >>  8) |
+          ((x & 0x0000ff00) <<  8) | ((x & 0x000000ff) << 24);
+#endif
+}
+
+inline unsigned long long Swap64(unsigned long long x)
+{
+#if defined(__GNUC__)
+   return __builtin_bswap64(x);
+#else
+   return ((unsigned long long)Swap32((unsigned int)x) << 32) | Swap32((unsigned int)(x >> 32));
+#endif
+}
+
+void BswapScalar16(char *to, const char *from, size_t n)
+{
+   for (size_t i = 0; i < n; ++i) {
+      unsigned short x;
+      memcpy(&x, from + 2*i, 2);
+      x = Swap16(x);
+      memcpy(to + 2*i, &x, 2);
+   }
+}
+
+void BswapScalar32(char *to, const char *from, size_t n)
+{
+   for (size_t i = 0; i < n; ++i) {
+      unsigned int x;
+      memcpy(&x, from + 4*i, 4);
+      x = Swap32(x);
+      memcpy(to + 4*i, &x, 4);
+   }
+}
+
+void BswapScalar64(char *to, const char *from, size_t n)
+{
+   for (size_t i = 0; i < n; ++i) {
+      unsigned long long x;
+      memcpy(&x, from + 8*i, 8);
+      x = Swap64(x);
+      memcpy(to + 8*i, &x, 8);
+   }
+}
+
+const BswapKernels gScalarKernels = { "scalar", BswapScalar16, BswapScalar32, BswapScalar64 };
+
+#ifdef R__BSWAPCPY_X86
+
+////////////////////////////////////////////////////////////////////////////////
+/// SSSE3 kernels: one pshufb per 16 bytes.
+
+__attribute__((target("ssse3")))
+inline void BswapSSSE3(char *to, const char *from, size_t nbytes, __m128i mask)
+{
+   size_t i = 0;
+   for (; i + 64 <= nbytes; i += 64) {
+      __m128i a = _mm_loadu_si128((const __m128i*)(from + i));
+      __m128i b = _mm_loadu_si128((const __m128i*)(from + i + 16));
+      __m128i c = _mm_loadu_si128((const __m128i*)(from + i + 32));
+      __m128i d = _mm_loadu_si128((const __m128i*)(from + i + 48));
+      _mm_storeu_si128((__m128i*)(to + i),      _mm_shuffle_epi8(a, mask));
+      _mm_storeu_si128((__m128i*)(to + i + 16), _mm_shuffle_epi8(b, mask));
+      _mm_storeu_si128((__m128i*)(to + i + 32), _mm_shuffle_epi8(c, mask));
+      _mm_storeu_si128((__m128i*)(to + i + 48), _mm_shuffle_epi8(d, mask));
+   }
+   for (; i + 16 <= nbytes; i += 16) {
+      __m128i a = _mm_loadu_si128((const __m128i*)(from + i));
+      _mm_storeu_si128((__m128i*)(to + i), _mm_shuffle_epi8(a, mask));
+   }
+}
+
+__attribute__((target("ssse3")))
+void BswapSSSE3_16(char *to, const char *from, size_t n)
+{
+   const __m128i mask = _mm_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+   size_t nvec = n & ~size_t(7);
+   BswapSSSE3(to, from, 2*nvec, mask);
+   BswapScalar16(to + 2*nvec, from + 2*nvec, n - nvec);
+}
+
+__attribute__((target("ssse3")))
+void BswapSSSE3_32(char *to, const char *from, size_t n)
+{
+   const __m128i mask = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+   size_t nvec = n & ~size_t(3);
+   BswapSSSE3(to, from, 4*nvec, mask);
+   BswapScalar32(to + 4*nvec, from + 4*nvec, n - nvec);
+}
+
+__attribute__((target("ssse3")))
+void BswapSSSE3_64(char *to, const char *from, size_t n)
+{
+   const __m128i mask = _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+   size_t nvec = n & ~size_t(1);
+   BswapSSSE3(to, from, 8*nvec, mask);
+   BswapScalar64(to + 8*nvec, from + 8*nvec, n - nvec);
+}
+
+const BswapKernels gSSSE3Kernels = { "ssse3", BswapSSSE3_16, BswapSSSE3_32, BswapSSSE3_64 };
+
+////////////////////////////////////////////////////////////////////////////////
+/// AVX2 kernels: vpshufb works within each 128 bit lane, so the same mask
+/// is used in both lanes.
+
+__attribute__((target("avx2")))
+inline void BswapAVX2(char *to, const char *from, size_t nbytes, __m256i mask)
+{
+   size_t i = 0;
+   for (; i + 128 <= nbytes; i += 128) {
+      __m256i a = _mm256_loadu_si256((const __m256i*)(from + i));
+      __m256i b = _mm256_loadu_si256((const __m256i*)(from + i + 32));
+      __m256i c = _mm256_loadu_si256((const __m256i*)(from + i + 64));
+      __m256i d = _mm256_loadu_si256((const __m256i*)(from + i + 96));
+      _mm256_storeu_si256((__m256i*)(to + i),      _mm256_shuffle_epi8(a, mask));
+      _mm256_storeu_si256((__m256i*)(to + i + 32), _mm256_shuffle_epi8(b, mask));
+      _mm256_storeu_si256((__m256i*)(to + i + 64), _mm256_shuffle_epi8(c, mask));
+      _mm256_storeu_si256((__m256i*)(to + i + 96), _mm256_shuffle_epi8(d, mask));
+   }
+   for (; i + 32 <= nbytes; i += 32) {
+      __m256i a = _mm256_loadu_si256((const __m256i*)(from + i));
+      _mm256_storeu_si256((__m256i*)(to + i), _mm256_shuffle_epi8(a, mask));
+   }
+}
+
+__attribute__((target("avx2")))
+void BswapAVX2_16(char *to, const char *from, size_t n)
+{
+   const __m256i mask = _mm256_set_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+                                        14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+   size_t nvec = n & ~size_t(15);
+   BswapAVX2(to, from, 2*nvec, mask);
+   BswapSSSE3_16(to + 2*nvec, from + 2*nvec, n - nvec);
+}
+
+__attribute__((target("avx2")))
+void BswapAVX2_32(char *to, const char *from, size_t n)
+{
+   const __m256i mask = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                                        12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+   size_t nvec = n & ~size_t(7);
+   BswapAVX2(to, from, 4*nvec, mask);
+   BswapSSSE3_32(to + 4*nvec, from + 4*nvec, n - nvec);
+}
+
+__attribute__((target("avx2")))
+void BswapAVX2_64(char *to, const char *from, size_t n)
+{
+   const __m256i mask = _mm256_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7,
+                                        8, 9, 10, 11, 12, 13, 14, 15, 0, 1, 2, 3, 4, 5, 6, 7);
+   size_t nvec = n & ~size_t(3);
+   BswapAVX2(to, from, 8*nvec, mask);
+   BswapSSSE3_64(to + 8*nvec, from + 8*nvec, n - nvec);
+}
+
+const BswapKernels gAVX2Kernels = { "avx2", BswapAVX2_16, BswapAVX2_32, BswapAVX2_64 };
+
+#endif // R__BSWAPCPY_X86
+
+#ifdef R__BSWAPCPY_NEON
+
+////////////////////////////////////////////////////////////////////////////////
+/// NEON kernels: vrev16/32/64 reverse the bytes within each element.
+
+void BswapNEON16(char *to, const char *from, size_t n)
+{
+   size_t nvec = n & ~size_t(7);
+   for (size_t i = 0; i < 2*nvec; i += 16)
+      vst1q_u8((uint8_t*)(to + i), vrev16q_u8(vld1q_u8((const uint8_t*)(from + i))));
+   BswapScalar16(to + 2*nvec, from + 2*nvec, n - nvec);
+}
+
+void BswapNEON32(char *to, const char *from, size_t n)
+{
+   size_t nvec = n & ~size_t(3);
+   for (size_t i = 0; i < 4*nvec; i += 16)
+      vst1q_u8((uint8_t*)(to + i), vrev32q_u8(vld1q_u8((const uint8_t*)(from + i))));
+   BswapScalar32(to + 4*nvec, from + 4*nvec, n - nvec);
+}
+
+void BswapNEON64(char *to, const char *from, size_t n)
+{
+   size_t nvec = n & ~size_t(1);
+   for (size_t i = 0; i < 8*nvec; i += 16)
+      vst1q_u8((uint8_t*)(to + i), vrev64q_u8(vld1q_u8((const uint8_t*)(from + i))));
+   BswapScalar64(to + 8*nvec, from + 8*nvec, n - nvec);
+}
+
+const BswapKernels gNEONKernels = { "neon", BswapNEON16, BswapNEON32, BswapNEON64 };
+
+#endif // R__BSWAPCPY_NEON
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the best set of kernels supported by this CPU.
+
+const BswapKernels *SelectBestKernels()
+{
+#if defined(R__BSWAPCPY_X86)
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx2")) return &gAVX2Kernels;
+   if (__builtin_cpu_supports("ssse3")) return &gSSSE3Kernels;
+#elif defined(R__BSWAPCPY_NEON)
+   return &gNEONKernels;
+#endif
+   return &gScalarKernels;
+}
+
+const BswapKernels *GetBestKernels()
+{
+   static const BswapKernels *best = SelectBestKernels();
+   return best;
+}
+
+std::atomic<bool> gForceScalar(false);
+
+inline const BswapKernels *GetKernels()
+{
+   if (gForceScalar.load(std::memory_order_relaxed)) return &gScalarKernels;
+   return GetBestKernels();
+}
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy n 2-byte words from `from` to `to`, swapping their bytes.
+
+void *bswapcpy16(void *to, const void *from, size_t n)
+{
+   GetKernels()->f16((char*)to, (const char*)from, n);
+   return to;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy n 4-byte words from `from` to `to`, swapping their bytes.
+
+void *bswapcpy32(void *to, const void *from, size_t n)
+{
+   GetKernels()->f32((char*)to, (const char*)from, n);
+   return to;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy n 8-byte words from `from` to `to`, swapping their bytes.
+
+void *bswapcpy64(void *to, const void *from, size_t n)
+{
+   GetKernels()->f64((char*)to, (const char*)from, n);
+   return to;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the name of the kernels currently used by bswapcpy16/32/64.
+
+const char *ROOT::Internal::GetBswapcpyKernel()
+{
+   return GetKernels()->fName;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Use the portable kernels (scalar == true) instead of the best ones
+/// available on this CPU.
+
+void ROOT::Internal::SetBswapcpyScalar(bool scalar)
+{
+   gForceScalar = scalar;
+}
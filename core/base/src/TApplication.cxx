@@ -203,8 +203,9 @@ TApplication::TApplication(const char *appClassName, Int_t *argc, char **argv,
       Int_t buffersize = gEnv->GetValue("Root.TMemStat.buffersize", 100000);
       Int_t maxcalls   = gEnv->GetValue("Root.TMemStat.maxcalls", 5000000);
       const char *ssystem = gEnv->GetValue("Root.TMemStat.system","gnubuiltin");
+      Long64_t sampling = gEnv->GetValue("Root.TMemStat.sampling", 0);
       if (maxcalls > 0) {
-         gROOT->ProcessLine(Form("new TMemStat(\"%s\",%d,%d);",ssystem,buffersize,maxcalls));
+         gROOT->ProcessLine(Form("new TMemStat(\"%s sampling=%lld\",%d,%d);",ssystem,sampling,buffersize,maxcalls));
       }
    }
 
@@ -0,0 +1,378 @@
+// @(#)root/base:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class ROOT::Internal::TLockStats
+\ingroup Base
+
+Statistics of the contention of the locks, enabled by the environment
+variable ROOT_LOCK_STATS.
+
+With implicit multi-threading the threads are often serialized by a few
+global locks (gROOTMutex/gInterpreterMutex, gGlobalMutex, TFile::fgRwLock,
+...). When the statistics are enabled, TMutex::Lock first tries to take the
+mutex: if it is held by another thread, the time until it gets it is
+recorded for the call site of the acquisition, and also for the call site
+of the thread holding the mutex, which shows which critical sections make
+the others wait. TLockGuard (R__LOCKGUARD) gives the call sites; TThread
+names the global mutexes.
+
+Each thread counts in a table of its own, protected by a mutex which is
+only contended when the statistics are read. The table of a thread is
+added to the totals when the thread ends. The statistics are printed at the
+end of the program, and can be read or printed at any time.
+*/
+
+#include "ROOT/TLockStats.hxx"
+
+#include "ThreadLocalStorage.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <utility>
+
+namespace {
+
+struct TLockStatsCounts {
+   ULong64_t fAcquired = 0;
+   ULong64_t fContended = 0;
+   Long64_t  fWaitNs = 0;
+   Long64_t  fMaxWaitNs = 0;
+   ULong64_t fBlocking = 0;
+   Long64_t  fBlockingNs = 0;
+
+   void Add(const TLockStatsCounts &other)
+   {
+      fAcquired += other.fAcquired;
+      fContended += other.fContended;
+      fWaitNs += other.fWaitNs;
+      fMaxWaitNs = std::max(fMaxWaitNs, other.fMaxWaitNs);
+      fBlocking += other.fBlocking;
+      fBlockingNs += other.fBlockingNs;
+   }
+};
+
+// Counts per lock and call site
+using TLockStatsTable = std::map<std::pair<const void *, const char *>, TLockStatsCounts>;
+
+void AddTable(TLockStatsTable &to, const TLockStatsTable &from)
+{
+   for (auto &entry : from)
+      to[entry.first].Add(entry.second);
+}
+
+struct TLockStatsThreadTable {
+   std::mutex fMutex;
+   TLockStatsTable fTable;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// The tables of the running threads, the totals of the threads which ended
+/// and the names of the locks. It is never deleted: locks are taken during
+/// the destruction of the static objects.
+
+struct TLockStatsRegistry {
+   std::mutex fMutex;
+   std::vector<TLockStatsThreadTable *> fThreads;
+   TLockStatsTable fEnded;
+   std::map<const void *, std::string> fNames;
+
+   static TLockStatsRegistry &Get()
+   {
+      static TLockStatsRegistry *registry = new TLockStatsRegistry;
+      return *registry;
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// The table of a thread, registered on the first acquisition of a lock by
+/// the thread and added to the totals when it ends; the locks taken after
+/// this are counted directly in the totals.
+
+struct TLockStatsSlot {
+   TLockStatsThreadTable *fTable;
+
+   TLockStatsSlot() : fTable(new TLockStatsThreadTable)
+   {
+      TLockStatsRegistry &registry = TLockStatsRegistry::Get();
+      std::lock_guard<std::mutex> lg(registry.fMutex);
+      registry.fThreads.push_back(fTable);
+   }
+   ~TLockStatsSlot()
+   {
+      TLockStatsRegistry &registry = TLockStatsRegistry::Get();
+      std::lock_guard<std::mutex> lg(registry.fMutex);
+      registry.fThreads.erase(std::find(registry.fThreads.begin(), registry.fThreads.end(), fTable));
+      AddTable(registry.fEnded, fTable->fTable);
+      delete fTable;
+      fTable = nullptr;
+   }
+};
+
+TLockStatsSlot &GetSlot()
+{
+   TTHREAD_TLS_DECL(TLockStatsSlot, slot);
+   return slot;
+}
+
+const char *&GetSiteRef()
+{
+   TTHREAD_TLS(const char *) site = nullptr;
+   return site;
+}
+
+Bool_t &GetInRecordRef()
+{
+   TTHREAD_TLS(Bool_t) inRecord = kFALSE;
+   return inRecord;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the statistics of all the threads, merged.
+
+TLockStatsTable MergeTables()
+{
+   TLockStatsRegistry &registry = TLockStatsRegistry::Get();
+   std::lock_guard<std::mutex> lg(registry.fMutex);
+   TLockStatsTable all = registry.fEnded;
+   for (auto thread : registry.fThreads) {
+      std::lock_guard<std::mutex> tlg(thread->fMutex);
+      AddTable(all, thread->fTable);
+   }
+   return all;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the name of a lock: the one given with SetName, else its address.
+
+std::string LockName(const void *lock)
+{
+   TLockStatsRegistry &registry = TLockStatsRegistry::Get();
+   {
+      std::lock_guard<std::mutex> lg(registry.fMutex);
+      auto name = registry.fNames.find(lock);
+      if (name != registry.fNames.end())
+         return name->second;
+   }
+   char address[32];
+   snprintf(address, sizeof(address), "%p", lock);
+   return address;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a call site without the directories of its file.
+
+std::string SiteName(const char *site)
+{
+   if (!site)
+      return "unknown";
+   const char *base = strrchr(site, '/');
+   return base ? base + 1 : site;
+}
+
+void PrintAtExit()
+{
+   ROOT::Internal::TLockStats::Print();
+}
+
+Bool_t ReadEnabled()
+{
+   const char *env = ::getenv("ROOT_LOCK_STATS");
+   if (!env || !*env || !strcmp(env, "0"))
+      return kFALSE;
+   atexit(PrintAtExit);
+   return kTRUE;
+}
+
+} // anonymous namespace
+
+namespace ROOT {
+namespace Internal {
+
+Bool_t TLockStats::fgEnabled = ReadEnabled();
+
+////////////////////////////////////////////////////////////////////////////////
+/// Give a name to a lock (e.g. the name of the global variable pointing to
+/// it), used when printing its statistics.
+
+void TLockStats::SetName(const void *lock, const char *name)
+{
+   if (!fgEnabled || !lock)
+      return;
+   TLockStatsRegistry &registry = TLockStatsRegistry::Get();
+   std::lock_guard<std::mutex> lg(registry.fMutex);
+   registry.fNames[lock] = name;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the call site of the next acquisition of a lock by the calling
+/// thread; site must be a string literal (see R__LOCKGUARD).
+
+void TLockStats::SetSite(const char *site)
+{
+   GetSiteRef() = site;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the call site set by SetSite, and forget it.
+
+const char *TLockStats::TakeSite()
+{
+   const char *&ref = GetSiteRef();
+   const char *site = ref;
+   ref = nullptr;
+   return site;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a monotonic time in nanoseconds, to measure the waits.
+
+Long64_t TLockStats::Now()
+{
+   using namespace std::chrono;
+   return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record an acquisition of lock from site. If contended, the lock was held
+/// by another thread and the calling thread waited waitNs nanoseconds; the
+/// wait is also counted for the call site holder of that thread, if known.
+
+void TLockStats::Record(const void *lock, const char *site, Bool_t contended, Long64_t waitNs, const char *holder)
+{
+   // A lock taken while recording (e.g. by the custom operator new of libNew)
+   // is not recorded: the table of the thread is locked.
+   Bool_t &inRecord = GetInRecordRef();
+   if (inRecord)
+      return;
+   struct TInRecord {
+      Bool_t &fFlag;
+      TInRecord(Bool_t &flag) : fFlag(flag) { fFlag = kTRUE; }
+      ~TInRecord() { fFlag = kFALSE; }
+   } guard(inRecord);
+
+   TLockStatsSlot &slot = GetSlot();
+   std::unique_lock<std::mutex> lg;
+   TLockStatsTable *table;
+   if (slot.fTable) {
+      lg = std::unique_lock<std::mutex>(slot.fTable->fMutex);
+      table = &slot.fTable->fTable;
+   } else {
+      TLockStatsRegistry &registry = TLockStatsRegistry::Get();
+      lg = std::unique_lock<std::mutex>(registry.fMutex);
+      table = &registry.fEnded;
+   }
+
+   TLockStatsCounts &counts = (*table)[std::make_pair(lock, site)];
+   ++counts.fAcquired;
+   if (!contended)
+      return;
+   ++counts.fContended;
+   counts.fWaitNs += waitNs;
+   counts.fMaxWaitNs = std::max(counts.fMaxWaitNs, waitNs);
+   if (holder) {
+      TLockStatsCounts &holderCounts = (*table)[std::make_pair(lock, holder)];
+      ++holderCounts.fBlocking;
+      holderCounts.fBlockingNs += waitNs;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the statistics of all the threads, per lock and call site, sorted
+/// by lock and decreasing wait.
+
+std::vector<TLockStats::Entry_t> TLockStats::GetEntries()
+{
+   TLockStatsTable all = MergeTables();
+
+   // Total wait per lock, to put the most contended locks first
+   std::map<const void *, Long64_t> lockWait;
+   for (auto &entry : all)
+      lockWait[entry.first.first] += entry.second.fWaitNs;
+
+   std::vector<std::pair<const void *, Entry_t>> entries;
+   for (auto &entry : all) {
+      const TLockStatsCounts &c = entry.second;
+      entries.push_back({entry.first.first,
+                         {LockName(entry.first.first), SiteName(entry.first.second), c.fAcquired, c.fContended,
+                          c.fWaitNs, c.fMaxWaitNs, c.fBlocking, c.fBlockingNs}});
+   }
+   std::stable_sort(entries.begin(), entries.end(), [&lockWait](const std::pair<const void *, Entry_t> &a,
+                                                                 const std::pair<const void *, Entry_t> &b) {
+      if (a.first != b.first) {
+         Long64_t waitA = lockWait[a.first], waitB = lockWait[b.first];
+         return waitA != waitB ? waitA > waitB : a.first < b.first;
+      }
+      return a.second.fWaitNs + a.second.fBlockingNs > b.second.fWaitNs + b.second.fBlockingNs;
+   });
+
+   std::vector<Entry_t> result;
+   result.reserve(entries.size());
+   for (auto &entry : entries)
+      result.push_back(std::move(entry.second));
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the statistics of the locks: for each lock its totals, then one
+/// line per call site. "held [ms]" is the time the other threads waited
+/// while the site held the lock.
+
+void TLockStats::Print()
+{
+   std::vector<Entry_t> entries = GetEntries();
+   printf("TLockStats: %s\n", fgEnabled ? "lock statistics" : "disabled (set ROOT_LOCK_STATS to enable)");
+   if (entries.empty())
+      return;
+   printf("%-40s %12s %12s %12s %12s %12s\n", "lock / call site", "acquired", "contended", "wait [ms]",
+          "max [us]", "held [ms]");
+   size_t i = 0;
+   while (i < entries.size()) {
+      size_t end = i;
+      Entry_t total = entries[i];
+      total.fAcquired = total.fContended = total.fBlocking = 0;
+      total.fWaitNs = total.fMaxWaitNs = total.fBlockingNs = 0;
+      for (; end < entries.size() && entries[end].fLock == total.fLock; ++end) {
+         total.fAcquired += entries[end].fAcquired;
+         total.fContended += entries[end].fContended;
+         total.fWaitNs += entries[end].fWaitNs;
+         total.fMaxWaitNs = std::max(total.fMaxWaitNs, entries[end].fMaxWaitNs);
+      }
+      printf("%-40s %12llu %12llu %12.3f %12.1f\n", total.fLock.c_str(), total.fAcquired, total.fContended,
+             1.e-6 * total.fWaitNs, 1.e-3 * total.fMaxWaitNs);
+      for (; i < end; ++i) {
+         const Entry_t &e = entries[i];
+         printf("   %-37s %12llu %12llu %12.3f %12.1f %12.3f\n", e.fSite.c_str(), e.fAcquired, e.fContended,
+                1.e-6 * e.fWaitNs, 1.e-3 * e.fMaxWaitNs, 1.e-6 * e.fBlockingNs);
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reset the statistics of all the threads.
+
+void TLockStats::Reset()
+{
+   TLockStatsRegistry &registry = TLockStatsRegistry::Get();
+   std::lock_guard<std::mutex> lg(registry.fMutex);
+   registry.fEnded.clear();
+   for (auto thread : registry.fThreads) {
+      std::lock_guard<std::mutex> tlg(thread->fMutex);
+      thread->fTable.clear();
+   }
+}
+
+} // End of namespace Internal
+} // End of namespace ROOT
@@ -0,0 +1,259 @@
+// @(#)root/base:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class ROOT::Internal::TObjectPool
+\ingroup Base
+
+Per-thread pool of the memory of the objects allocated by TObject::operator
+new.
+
+Each event of an analysis creates and deletes many small objects (elements
+of TClonesArray, TObjString, TLorentzVector, ...); with implicit
+multi-threading the threads then contend in the system allocator. When the
+pool is enabled (environment variable ROOT_OBJECT_POOL), TStorage::ObjectAlloc
+and TStorage::ObjectDealloc take the memory from this pool instead: the
+blocks are kept by the thread deleting the object, in size classes of 16
+bytes, and handed out again to the next object of the same class allocated
+by that thread.
+
+Every block handed out starts with a header of 16 bytes, which keeps the
+alignment of the objects, giving the size class of the block (0 for the
+blocks taken directly from the system allocator: objects larger than
+GetMaxObjectSize(), or when the custom new and delete of libNew are used).
+A free block is chained to the next free block of its class through its
+first bytes after the header.
+*/
+
+#include "ROOT/TObjectPool.hxx"
+
+#include "TError.h"
+#include "TStorage.h"
+#include "ThreadLocalStorage.h"
+
+#include <atomic>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+const Int_t    kNClasses   = 64;         // Classes of 16, 32, ..., 1024 bytes
+const size_t   kGranule    = 16;         // Size step between two classes
+const size_t   kHeaderSize = 16;         // Size of the header of the blocks
+const UInt_t   kUsedMagic  = 0x0b7ec715; // Header of a block given to an object
+const UInt_t   kFreeMagic  = 0x0b7ef4ee; // Header of a block in a cache
+
+std::atomic<Long64_t> gMaxCachedBytes(8*1024*1024);
+
+struct TObjectPoolHeader {
+   UInt_t fMagic;   // kUsedMagic or kFreeMagic
+   Int_t  fClass;   // Size class of the block, 0 if not from the pool
+};
+
+struct TObjectPoolBlock {
+   TObjectPoolHeader fHeader;
+   TObjectPoolBlock *fNext;   // Next free block of the same class
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Size of the objects held by the blocks of class k (k > 0).
+
+inline size_t ClassSize(Int_t k)
+{
+   return k * kGranule;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// The free blocks of a thread; they are deleted when the thread ends. The
+/// blocks released afterwards (e.g. by the destructors of the static objects
+/// at the end of the main thread) are deleted directly.
+
+struct TObjectPoolSlot {
+   TObjectPoolBlock *fFree[kNClasses + 1];
+   ROOT::Internal::TObjectPool::Stats_t fStats;
+   Bool_t fClosed;
+
+   TObjectPoolSlot() : fClosed(kFALSE)
+   {
+      memset(fFree, 0, sizeof(fFree));
+      memset(&fStats, 0, sizeof(fStats));
+   }
+   ~TObjectPoolSlot()
+   {
+      Clear();
+      fClosed = kTRUE;
+   }
+
+   void Clear()
+   {
+      for (Int_t k = 1; k <= kNClasses; ++k) {
+         while (TObjectPoolBlock *block = fFree[k]) {
+            fFree[k] = block->fNext;
+            ::operator delete(block);
+         }
+      }
+      fStats.fCachedBytes = 0;
+   }
+};
+
+TObjectPoolSlot &GetSlot()
+{
+   TTHREAD_TLS_DECL(TObjectPoolSlot, slot);
+   return slot;
+}
+
+} // anonymous namespace
+
+namespace ROOT {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the environment variable ROOT_OBJECT_POOL was set (and
+/// not to 0) when the first object was allocated.
+
+Bool_t TObjectPool::IsEnabled()
+{
+   static const Bool_t enabled = [] {
+      const char *env = ::getenv("ROOT_OBJECT_POOL");
+      return env && *env && strcmp(env, "0");
+   }();
+   return enabled;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a block of at least size bytes, to be given back with Release.
+
+void *TObjectPool::Acquire(size_t size)
+{
+   Int_t k = size ? Int_t((size + kGranule - 1) / kGranule) : 1;
+   if (k > kNClasses || TStorage::HasCustomNewDelete()) {
+      TObjectPoolHeader *header = (TObjectPoolHeader *)::operator new(size + kHeaderSize);
+      header->fMagic = kUsedMagic;
+      header->fClass = 0;
+      return (char *)header + kHeaderSize;
+   }
+
+   TObjectPoolSlot &slot = GetSlot();
+   TObjectPoolBlock *block = 0;
+   if (!slot.fClosed) {
+      ++slot.fStats.fAcquired;
+      block = slot.fFree[k];
+      if (block) {
+         slot.fFree[k] = block->fNext;
+         slot.fStats.fCachedBytes -= ClassSize(k);
+         ++slot.fStats.fReused;
+      }
+   }
+   if (!block) block = (TObjectPoolBlock *)::operator new(ClassSize(k) + kHeaderSize);
+   block->fHeader.fMagic = kUsedMagic;
+   block->fHeader.fClass = k;
+   return (char *)block + kHeaderSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Give back to the pool of the calling thread a block returned by Acquire
+/// (possibly in another thread). The block is deleted if it does not come
+/// from the pool or if the cache of the thread is full.
+
+void TObjectPool::Release(void *ptr)
+{
+   if (!ptr) return;
+   TObjectPoolBlock *block = (TObjectPoolBlock *)((char *)ptr - kHeaderSize);
+   if (block->fHeader.fMagic != kUsedMagic) {
+      if (block->fHeader.fMagic == kFreeMagic) {
+         ::Error("TObjectPool::Release", "object at %p deleted twice", ptr);
+         return;
+      }
+      // Not allocated by Acquire: the caller mixed the allocation functions.
+      ::operator delete(ptr);
+      return;
+   }
+   Int_t k = block->fHeader.fClass;
+   if (k <= 0 || k > kNClasses || TStorage::HasCustomNewDelete()) {
+      ::operator delete(block);
+      return;
+   }
+
+   TObjectPoolSlot &slot = GetSlot();
+   if (slot.fClosed) {
+      ::operator delete(block);
+      return;
+   }
+   ++slot.fStats.fReleased;
+   if (slot.fStats.fCachedBytes + (Long64_t)ClassSize(k) > gMaxCachedBytes) {
+      ++slot.fStats.fDropped;
+      ::operator delete(block);
+      return;
+   }
+   block->fHeader.fMagic = kFreeMagic;
+   block->fNext = slot.fFree[k];
+   slot.fFree[k] = block;
+   slot.fStats.fCachedBytes += ClassSize(k);
+   if (slot.fStats.fCachedBytes > slot.fStats.fHighWater) slot.fStats.fHighWater = slot.fStats.fCachedBytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete the free blocks of the calling thread.
+
+void TObjectPool::Clear()
+{
+   GetSlot().Clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the size of the largest objects whose memory is cached.
+
+size_t TObjectPool::GetMaxObjectSize()
+{
+   return ClassSize(kNClasses);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the maximum number of bytes of free blocks kept by each thread.
+
+Long64_t TObjectPool::GetMaxCachedBytes()
+{
+   return gMaxCachedBytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the maximum number of bytes of free blocks kept by each thread
+/// (8 MB by default). 0 disables the reuse of the blocks.
+
+void TObjectPool::SetMaxCachedBytes(Long64_t bytes)
+{
+   gMaxCachedBytes = bytes < 0 ? 0 : bytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the statistics of the pool of the calling thread.
+
+TObjectPool::Stats_t TObjectPool::GetStats()
+{
+   return GetSlot().fStats;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the statistics of the pool of the calling thread.
+
+void TObjectPool::Print()
+{
+   const Stats_t &s = GetSlot().fStats;
+   printf("TObjectPool: %s, %llu blocks acquired, %llu reused (%.1f%%), %llu released, %llu dropped\n",
+          IsEnabled() ? "enabled" : "disabled", s.fAcquired, s.fReused,
+          s.fAcquired ? 100. * s.fReused / s.fAcquired : 0., s.fReleased, s.fDropped);
+   printf("TObjectPool: %lld bytes cached, high water %lld bytes, limit %lld bytes\n",
+          s.fCachedBytes, s.fHighWater, (Long64_t)gMaxCachedBytes);
+}
+
+} // End of namespace Internal
+} // End of namespace ROOT
@@ -39,6 +39,13 @@ its own fUniqueID to find the pointer to the referenced object.
 See TProcessID::GetObjectWithID and PutObjectWithID.
 
 When a referenced object is deleted, its slot in fObjects is set to null.
+
+GetObjectWithID and IsValid, called by each TRef::GetObject, take no lock:
+the referenced objects are also kept in a table of atomic pointers which is
+never reallocated, and the valid TProcessIDs in a lock-free hash set. The
+object numbers are assigned by each thread from a block of numbers it
+reserves, so that threads which reference new objects concurrently do not
+contend on the counter.
 //
 See also TProcessUUID: a specialized TProcessID to manage the single list
 of TUUIDs.
@@ -50,10 +57,13 @@ of TUUIDs.
 #include "TExMap.h"
 #include "TVirtualMutex.h"
 #include "TError.h"
+#include "ThreadLocalStorage.h"
+
+#include <memory>
 
 TObjArray  *TProcessID::fgPIDs   = 0; //pointer to the list of TProcessID
-TProcessID *TProcessID::fgPID    = 0; //pointer to the TProcessID of the current session
-UInt_t      TProcessID::fgNumber = 0; //Current referenced object instance count
+std::atomic<TProcessID*> TProcessID::fgPID{nullptr}; //pointer to the TProcessID of the current session
+std::atomic<UInt_t>      TProcessID::fgNumber{0};    //Current referenced object instance count
 TExMap     *TProcessID::fgObjPIDs= 0; //Table (pointer,pids)
 ClassImp(TProcessID)
 
@@ -65,6 +75,198 @@ static inline ULong_t Void_Hash(const void *ptr)
    return TString::Hash(&ptr, sizeof(void*));
 }
 
+namespace ROOT {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// The referenced objects of a TProcessID by object number, in chunks of
+/// atomic pointers allocated on first use and never moved, so that they can
+/// be read while other threads add objects.
+
+class TProcessIDObjects {
+   enum { kChunkBits = 12, kChunkSize = 1 << kChunkBits, kNchunks = (1 << 24) >> kChunkBits };
+   typedef std::atomic<TObject*> Slot_t;
+
+   std::atomic<Slot_t*> fChunks[kNchunks];
+
+public:
+   TProcessIDObjects()
+   {
+      for (Int_t i = 0; i < kNchunks; ++i)
+         fChunks[i].store(nullptr, std::memory_order_relaxed);
+   }
+
+   ~TProcessIDObjects()
+   {
+      for (Int_t i = 0; i < kNchunks; ++i)
+         delete [] fChunks[i].load(std::memory_order_relaxed);
+   }
+
+   TObject *Get(UInt_t uid) const
+   {
+      Slot_t *chunk = fChunks[uid >> kChunkBits].load(std::memory_order_acquire);
+      return chunk ? chunk[uid & (kChunkSize - 1)].load(std::memory_order_acquire) : nullptr;
+   }
+
+   void Set(UInt_t uid, TObject *obj)
+   {
+      std::atomic<Slot_t*> &entry = fChunks[uid >> kChunkBits];
+      Slot_t *chunk = entry.load(std::memory_order_acquire);
+      if (!chunk) {
+         if (!obj) return;
+         Slot_t *newchunk = new Slot_t[kChunkSize];
+         for (Int_t i = 0; i < kChunkSize; ++i)
+            newchunk[i].store(nullptr, std::memory_order_relaxed);
+         if (entry.compare_exchange_strong(chunk, newchunk, std::memory_order_acq_rel)) {
+            chunk = newchunk;
+         } else {
+            delete [] newchunk; // another thread allocated it meanwhile
+         }
+      }
+      chunk[uid & (kChunkSize - 1)].store(obj, std::memory_order_release);
+   }
+
+   void Clear()
+   {
+      for (Int_t i = 0; i < kNchunks; ++i) {
+         if (Slot_t *chunk = fChunks[i].load(std::memory_order_acquire)) {
+            for (Int_t j = 0; j < kChunkSize; ++j)
+               chunk[j].store(nullptr, std::memory_order_relaxed);
+         }
+      }
+   }
+};
+
+} // End of namespace Internal
+} // End of namespace ROOT
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set of the TProcessIDs in fgPIDs, for IsValid. It is modified under
+/// gROOTMutex and read without lock: a table which grows is replaced by a
+/// copy, and the replaced tables are kept for the readers still using them.
+
+class TProcessIDSet {
+   struct TTable {
+      UInt_t                                   fSize; // power of 2
+      std::unique_ptr<std::atomic<const void*>[]> fSlots;
+      TTable                                  *fPrevious;
+
+      TTable(UInt_t size, TTable *previous) : fSize(size), fSlots(new std::atomic<const void*>[size]), fPrevious(previous)
+      {
+         for (UInt_t i = 0; i < size; ++i)
+            fSlots[i].store(nullptr, std::memory_order_relaxed);
+      }
+   };
+
+   std::atomic<TTable*> fTable{nullptr};
+   UInt_t               fUsed = 0;  // slots which are not null, removed ones included
+   UInt_t               fLive = 0;  // slots holding a TProcessID
+
+   static const void *Removed() { return reinterpret_cast<const void*>(1); }
+
+   static UInt_t Hash(const void *ptr)
+   {
+      ULong64_t h = reinterpret_cast<ULong64_t>(ptr) >> 4;
+      return (UInt_t)((h * 0x9E3779B97F4A7C15ULL) >> 32);
+   }
+
+   void Rehash(UInt_t size)
+   {
+      TTable *old = fTable.load(std::memory_order_relaxed);
+      TTable *table = new TTable(size, old);
+      fUsed = 0;
+      if (old) {
+         for (UInt_t i = 0; i < old->fSize; ++i) {
+            const void *ptr = old->fSlots[i].load(std::memory_order_relaxed);
+            if (ptr && ptr != Removed()) {
+               UInt_t j = Hash(ptr) & (size - 1);
+               while (table->fSlots[j].load(std::memory_order_relaxed)) j = (j + 1) & (size - 1);
+               table->fSlots[j].store(ptr, std::memory_order_relaxed);
+               ++fUsed;
+            }
+         }
+      }
+      fTable.store(table, std::memory_order_release);
+   }
+
+public:
+   void Insert(const void *ptr)
+   {
+      TTable *table = fTable.load(std::memory_order_relaxed);
+      if (!table || 2 * (fUsed + 1) > table->fSize) {
+         UInt_t size = 16;
+         while (size < 4 * (fLive + 1)) size *= 2;
+         Rehash(size);
+         table = fTable.load(std::memory_order_relaxed);
+      }
+      UInt_t i = Hash(ptr) & (table->fSize - 1);
+      while (table->fSlots[i].load(std::memory_order_relaxed)) i = (i + 1) & (table->fSize - 1);
+      table->fSlots[i].store(ptr, std::memory_order_release);
+      ++fUsed;
+      ++fLive;
+   }
+
+   void Remove(const void *ptr)
+   {
+      TTable *table = fTable.load(std::memory_order_relaxed);
+      if (!table) return;
+      for (UInt_t i = Hash(ptr) & (table->fSize - 1); ; i = (i + 1) & (table->fSize - 1)) {
+         const void *slot = table->fSlots[i].load(std::memory_order_relaxed);
+         if (!slot) return;
+         if (slot == ptr) {
+            table->fSlots[i].store(Removed(), std::memory_order_release);
+            --fLive;
+            return;
+         }
+      }
+   }
+
+   Bool_t Contains(const void *ptr) const
+   {
+      const TTable *table = fTable.load(std::memory_order_acquire);
+      if (!table) return kFALSE;
+      for (UInt_t i = Hash(ptr) & (table->fSize - 1), n = 0; n < table->fSize; i = (i + 1) & (table->fSize - 1), ++n) {
+         const void *slot = table->fSlots[i].load(std::memory_order_acquire);
+         if (!slot) return kFALSE;
+         if (slot == ptr) return kTRUE;
+      }
+      return kFALSE;
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// The set of valid TProcessIDs; it is never deleted, TProcessIDs may be
+/// deleted during the destruction of the static objects.
+
+TProcessIDSet &GetValidPIDs()
+{
+   static TProcessIDSet *set = new TProcessIDSet;
+   return *set;
+}
+
+// Number of object numbers reserved at once by a thread.
+const UInt_t kUIDBlock = 256;
+
+////////////////////////////////////////////////////////////////////////////////
+/// The block of object numbers reserved by a thread, [fFirst, fEnd] of fPID.
+
+struct TUIDBlock {
+   TProcessID *fPID  = nullptr;
+   UInt_t      fFirst = 0;
+   UInt_t      fNext  = 0; // next number to assign
+   UInt_t      fEnd   = 0;
+};
+
+TUIDBlock &GetUIDBlock()
+{
+   TTHREAD_TLS_DECL(TUIDBlock, block);
+   return block;
+}
+
+} // unnamed namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Default constructor.
 
@@ -81,6 +283,7 @@ TProcessID::TProcessID()
 
    fCount = 0;
    fObjects = 0;
+   fTable = nullptr;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -90,7 +293,10 @@ TProcessID::~TProcessID()
 {
    delete fObjects;
    fObjects = 0;
+   delete fTable.load();
+   fTable = nullptr;
    R__LOCKGUARD2(gROOTMutex);
+   GetValidPIDs().Remove(this);
    fgPIDs->Remove(this);
 }
 
@@ -120,6 +326,7 @@ TProcessID *TProcessID::AddProcessID()
    pid->IncrementCount();
 
    fgPIDs->Add(pid);
+   GetValidPIDs().Insert(pid);
    // if (apid == 0) for(int incr=0; incr < 65533; ++incr) fgPIDs->Add(0); // NOTE: DEBUGGING ONLY MUST BE REMOVED!
    char name[20];
    snprintf(name,20,"ProcessID%d",apid);
@@ -135,38 +342,54 @@ TProcessID *TProcessID::AddProcessID()
 /// static function returning the ID assigned to obj
 /// If the object is not yet referenced, its kIsReferenced bit is set
 /// and its fUniqueID set to the current number of referenced objects so far.
+///
+/// Each thread takes the numbers from a block of kUIDBlock numbers that it
+/// reserves in fgNumber, so the numbers assigned by a thread are
+/// consecutive and those of different threads never collide.
 
 UInt_t TProcessID::AssignID(TObject *obj)
 {
-   R__LOCKGUARD2(gROOTMutex);
-
+   TProcessID *pid = fgPID;
    UInt_t uid = obj->GetUniqueID() & 0xffffff;
-   if (obj == fgPID->GetObjectWithID(uid)) return uid;
+   if (obj == pid->GetObjectWithID(uid)) return uid;
    if (obj->TestBit(kIsReferenced)) {
-      fgPID->PutObjectWithID(obj,uid);
+      pid->PutObjectWithID(obj,uid);
       return uid;
    }
-   if (fgNumber >= 16777215) {
-      // This process id is 'full', we need to use a new one.
-      fgPID = AddProcessID();
-      fgNumber = 0;
-      for(Int_t i = 0; i < fgPIDs->GetLast()+1; ++i) {
-         TProcessID *pid = (TProcessID*)fgPIDs->At(i);
-         if (pid && pid->fObjects && pid->fObjects->GetEntries() == 0) {
-            pid->Clear();
+   TUIDBlock &block = GetUIDBlock();
+   if (block.fPID != pid || block.fNext > block.fEnd) {
+      UInt_t first;
+      while (1) {
+         pid = fgPID;
+         first = fgNumber.fetch_add(kUIDBlock) + 1;
+         if (fgPID != pid) continue; // the numbers were reset for a new pid
+         if (first + kUIDBlock - 1 <= 16777215) break;
+         R__LOCKGUARD2(gROOTMutex);
+         if (fgPID == pid) {
+            // This process id is 'full', we need to use a new one.
+            fgPID = AddProcessID();
+            fgNumber = 0;
+            for(Int_t i = 0; i < fgPIDs->GetLast()+1; ++i) {
+               TProcessID *p = (TProcessID*)fgPIDs->At(i);
+               if (p && p->fObjects && p->fObjects->GetEntries() == 0) {
+                  p->Clear();
+               }
+            }
          }
       }
+      block.fPID = pid;
+      block.fFirst = block.fNext = first;
+      block.fEnd = first + kUIDBlock - 1;
    }
-   fgNumber++;
    obj->SetBit(kIsReferenced);
-   uid = fgNumber;
-   // if (fgNumber<10) fgNumber = 16777213; // NOTE: DEBUGGING ONLY MUST BE REMOVED!
-   if ( fgPID->GetUniqueID() < 255 ) {
-      obj->SetUniqueID( (uid & 0xffffff) + (fgPID->GetUniqueID()<<24) );
+   uid = block.fNext++;
+   if ( pid->GetUniqueID() < 255 ) {
+      obj->SetUniqueID( (uid & 0xffffff) + (pid->GetUniqueID()<<24) );
    } else {
       obj->SetUniqueID( (uid & 0xffffff) + 0xff000000 /* 255 << 24 */ );
    }
-   fgPID->PutObjectWithID(obj,uid);
+   R__LOCKGUARD2(gROOTMutex);
+   pid->PutObjectWithID(obj,uid);
    return uid;
 }
 
@@ -189,7 +412,7 @@ void TProcessID::Cleanup()
 {
    R__LOCKGUARD2(gROOTMutex);
 
-   fgPIDs->Delete();
+   fgPIDs->Delete();   // each TProcessID removes itself from the valid ones
    gROOT->GetListOfCleanups()->Remove(fgPIDs);
    delete fgPIDs;
    fgPIDs = 0;
@@ -213,6 +436,8 @@ void TProcessID::Clear(Option_t *)
       }
    }
    delete fObjects; fObjects = 0;
+   // The table is emptied rather than deleted: it may still be read.
+   if (ROOT::Internal::TProcessIDObjects *table = fTable.load()) table->Clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -290,9 +515,15 @@ Int_t TProcessID::IncrementCount()
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the current referenced object count
 /// fgNumber is incremented every time a new object is referenced
+///
+/// Since each thread reserves blocks of numbers, this is the number of the
+/// last object referenced by the calling thread if it did reference one in
+/// the current block, the count of all the threads otherwise.
 
 UInt_t TProcessID::GetObjectCount()
 {
+   const TUIDBlock &block = GetUIDBlock();
+   if (block.fPID && block.fPID == fgPID && block.fNext > block.fFirst) return block.fNext - 1;
    return fgNumber;
 }
 
@@ -303,6 +534,10 @@ TObject *TProcessID::GetObjectWithID(UInt_t uidd)
 {
    Int_t uid = uidd & 0xffffff;  //take only the 24 lower bits
 
+   // The objects put with PutObjectWithID are found without lock in fTable;
+   // those of a TProcessUUID are only in fObjects.
+   if (ROOT::Internal::TProcessIDObjects *table = fTable.load(std::memory_order_acquire))
+      return table->Get(uid);
    if (fObjects==0 || uid >= fObjects->GetSize()) return 0;
    return fObjects->UncheckedAt(uid);
 }
@@ -329,10 +564,8 @@ TObjArray *TProcessID::GetPIDs()
 
 Bool_t TProcessID::IsValid(TProcessID *pid)
 {
-   R__LOCKGUARD2(gROOTMutex);
-
    if (fgPIDs==0) return kFALSE;
-   if (fgPIDs->IndexOf(pid) >= 0) return kTRUE;
+   if (GetValidPIDs().Contains(pid)) return kTRUE;
    if (pid == (TProcessID*)gROOT->GetUUIDs())  return kTRUE;
    return kFALSE;
 }
@@ -349,6 +582,15 @@ void TProcessID::PutObjectWithID(TObject *obj, UInt_t uid)
 
    if (!fObjects) fObjects = new TObjArray(100);
    fObjects->AddAtAndExpand(obj,uid);
+   ROOT::Internal::TProcessIDObjects *table = fTable.load(std::memory_order_acquire);
+   if (!table) {
+      ROOT::Internal::TProcessIDObjects *newtable = new ROOT::Internal::TProcessIDObjects;
+      if (fTable.compare_exchange_strong(table, newtable, std::memory_order_acq_rel))
+         table = newtable;
+      else
+         delete newtable;
+   }
+   table->Set(uid, obj);
 
    obj->SetBit(kMustCleanup);
    if ( (obj->GetUniqueID()&0xff000000)==0xff000000 ) {
@@ -381,6 +623,8 @@ void TProcessID::RecursiveRemove(TObject *obj)
          fgObjPIDs->Remove(hash,(Long64_t)obj);
       }
       (*fObjects)[uid] = 0; // Avoid recalculation of fLast (compared to ->RemoveAt(uid))
+      if (ROOT::Internal::TProcessIDObjects *table = fTable.load(std::memory_order_acquire))
+         table->Set(uid, 0);
    }
 }
 
@@ -388,8 +632,15 @@ void TProcessID::RecursiveRemove(TObject *obj)
 ////////////////////////////////////////////////////////////////////////////////
 /// static function to set the current referenced object count
 /// fgNumber is incremented every time a new object is referenced
+///
+/// The block of numbers of the calling thread is dropped, so that its next
+/// referenced object gets number+1. The numbers of the objects referenced
+/// meanwhile by other threads may then be assigned again: resetting the
+/// count, as done at the end of each event by some event models, is only
+/// safe when a single thread references objects.
 
 void TProcessID::SetObjectCount(UInt_t number)
 {
+   GetUIDBlock().fPID = nullptr;
    fgNumber = number;
 }
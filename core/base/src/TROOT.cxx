@@ -74,6 +74,8 @@ of a main program creating an interactive version is shown below:
 
 #include <string>
 #include <map>
+#include <chrono>
+#include <mutex>
 #include <stdlib.h>
 #ifdef WIN32
 #include <io.h>
@@ -481,6 +483,86 @@ namespace Internal {
 #endif
    }
 
+   namespace {
+      struct StartupPhase_t {
+         char     fName[64];   // Name of the phase
+         Double_t fSeconds;    // Time spent in the phase
+         Long64_t fCount;      // Number of items processed (e.g. files read)
+         Int_t    fCalls;      // Number of times the phase was marked
+      };
+      const Int_t kMaxStartupPhases = 64;
+      StartupPhase_t gStartupPhases[kMaxStartupPhases];
+      Int_t gNStartupPhases = 0;
+      std::chrono::steady_clock::time_point gStartupLastMark;
+
+      void PrintStartupProfile()
+      {
+         Double_t total = 0;
+         fprintf(stderr, "ROOT startup profile:\n");
+         fprintf(stderr, "   %-48s %10s %8s %8s\n", "phase", "ms", "calls", "count");
+         for (Int_t i = 0; i < gNStartupPhases; ++i) {
+            const StartupPhase_t &p = gStartupPhases[i];
+            fprintf(stderr, "   %-48s %10.2f %8d %8lld\n", p.fName, 1000. * p.fSeconds, p.fCalls, p.fCount);
+            total += p.fSeconds;
+         }
+         fprintf(stderr, "   %-48s %10.2f\n", "total", 1000. * total);
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Returns true if the environment variable ROOT_STARTUP_PROFILE is set
+   /// (and not to 0): the time spent in the phases of the startup of ROOT is
+   /// then printed at the end of the process.
+   Bool_t IsStartupProfileEnabled()
+   {
+      static const Bool_t enabled = [] {
+         const char *env = ::getenv("ROOT_STARTUP_PROFILE");
+         return env && *env && strcmp(env, "0");
+      }();
+      return enabled;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Attributes to the given phase of the startup the time elapsed since
+   /// the previous call, and count items to its count. The times of the
+   /// successive calls for the same phase are summed. With phase 0 the time
+   /// elapsed is not attributed, this is used at the beginning of an
+   /// operation which is not part of a longer one (e.g. the constructor of
+   /// TROOT or the reading of the rootmap files). Does nothing unless
+   /// IsStartupProfileEnabled().
+   void MarkStartupPhase(const char *phase, Long64_t count)
+   {
+      if (!IsStartupProfileEnabled()) return;
+
+      // Not gROOTMutex: the phases are also marked with gInterpreterMutex held.
+      static std::mutex mutex;
+      std::lock_guard<std::mutex> lock(mutex);
+      auto now = std::chrono::steady_clock::now();
+      static Bool_t started = kFALSE;
+      if (!started) {
+         started = kTRUE;
+         gStartupLastMark = now;
+         atexit(PrintStartupProfile);
+      }
+      Double_t seconds = std::chrono::duration<Double_t>(now - gStartupLastMark).count();
+      gStartupLastMark = now;
+      if (!phase) return;
+
+      Int_t i = 0;
+      while (i < gNStartupPhases && strcmp(gStartupPhases[i].fName, phase)) ++i;
+      if (i == gNStartupPhases) {
+         if (gNStartupPhases == kMaxStartupPhases) return;
+         StartupPhase_t &p = gStartupPhases[gNStartupPhases++];
+         strlcpy(p.fName, phase, sizeof(p.fName));
+         p.fSeconds = 0;
+         p.fCount   = 0;
+         p.fCalls   = 0;
+      }
+      gStartupPhases[i].fSeconds += seconds;
+      gStartupPhases[i].fCount   += count;
+      gStartupPhases[i].fCalls++;
+   }
+
 } // end of Internal sub namespace
 // back to ROOT namespace
 
@@ -627,6 +709,8 @@ TROOT::TROOT(const char *name, const char *title, VoidFuncPtr_t *initfunc)
    ROOT::Internal::gROOTLocal = this;
    gDirectory = 0;
 
+   ROOT::Internal::MarkStartupPhase(0);
+
    // initialize gClassTable is not already done
    if (!gClassTable) new TClassTable;
 
@@ -642,6 +726,7 @@ TROOT::TROOT(const char *name, const char *title, VoidFuncPtr_t *initfunc)
 
    // Initialize Operating System interface
    InitSystem();
+   ROOT::Internal::MarkStartupPhase("TROOT::InitSystem (gSystem, gEnv)");
 
    TDirectory::Build();
 
@@ -670,6 +755,7 @@ TROOT::TROOT(const char *name, const char *title, VoidFuncPtr_t *initfunc)
    // usedToIdentifyRootClingByDlSym is available when TROOT is part of
    // rootcling.
    if (!dlsym(RTLD_DEFAULT, "usedToIdentifyRootClingByDlSym")) {
+      ROOT::Internal::MarkStartupPhase("TROOT::TROOT");
       // initialize plugin manager early
       fPluginManager->LoadHandlersFromEnv(gEnv);
 #if defined(R__MACOSX) && (TARGET_OS_IPHONE || TARGET_IPHONE_SIMULATOR)
@@ -678,6 +764,7 @@ TROOT::TROOT(const char *name, const char *title, VoidFuncPtr_t *initfunc)
          fPluginManager->LoadHandlersFromEnv(&plugins);
       }
 #endif
+      ROOT::Internal::MarkStartupPhase("TPluginManager::LoadHandlersFromEnv");
    }
 
    TSystemDirectory *workdir = new TSystemDirectory("workdir", gSystem->WorkingDirectory());
@@ -805,6 +892,8 @@ TROOT::TROOT(const char *name, const char *title, VoidFuncPtr_t *initfunc)
    atexit(CleanUpROOTAtExit);
 
    ROOT::Internal::gGetROOT = &ROOT::Internal::GetROOT2;
+
+   ROOT::Internal::MarkStartupPhase("TROOT::TROOT");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1857,6 +1946,8 @@ void TROOT::InitThreads()
 
 void TROOT::InitInterpreter()
 {
+   ROOT::Internal::MarkStartupPhase(0);
+
    // usedToIdentifyRootClingByDlSym is available when TROOT is part of
    // rootcling.
    if (!dlsym(RTLD_DEFAULT, "usedToIdentifyRootClingByDlSym")
@@ -1901,6 +1992,7 @@ void TROOT::InitInterpreter()
    } else {
       gInterpreterLib = RTLD_DEFAULT;
    }
+   ROOT::Internal::MarkStartupPhase("TROOT::InitInterpreter: load libCling");
    CreateInterpreter_t *CreateInterpreter = (CreateInterpreter_t*) dlsym(gInterpreterLib, "CreateInterpreter");
    if (!CreateInterpreter) {
       TString err = dlerror();
@@ -1918,6 +2010,7 @@ void TROOT::InitInterpreter()
    }
 
    fInterpreter = CreateInterpreter(gInterpreterLib);
+   ROOT::Internal::MarkStartupPhase("TCling::TCling");
 
    fCleanups->Add(fInterpreter);
    fInterpreter->SetBit(kMustCleanup);
@@ -1938,17 +2031,22 @@ void TROOT::InitInterpreter()
                                    li->fFwdNargsToKeepColl,
                                    li->fClassesHeaders);
    }
+   ROOT::Internal::MarkStartupPhase("TCling::RegisterModule (linked dictionaries)",
+                                    GetModuleHeaderInfoBuffer().size());
    GetModuleHeaderInfoBuffer().clear();
 
    fInterpreter->Initialize();
+   ROOT::Internal::MarkStartupPhase("TCling::Initialize");
 
    // Read the rules before enabling the auto loading to not inadvertently
    // load the libraries for the classes concerned even-though the user is
    // *not* using them.
    TClass::ReadRules(); // Read the default customization rules ...
+   ROOT::Internal::MarkStartupPhase("TClass::ReadRules");
 
    // Enable autoloading
    fInterpreter->EnableAutoLoading();
+   ROOT::Internal::MarkStartupPhase("TCling::EnableAutoLoading");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -38,6 +38,7 @@ and statistics gathering in the system.
 #include "TString.h"
 #include "TVirtualMutex.h"
 #include "TInterpreter.h"
+#include "ROOT/TObjectPool.hxx"
 
 #if !defined(R__NOSTATS)
 #   define MEM_DEBUG
@@ -319,10 +320,12 @@ Int_t *TStorage::ReAllocInt(Int_t *ovp, size_t size, size_t oldsize)
 /// TStorage::FilledByObjectAlloc() to find out if the just created object is on
 /// the heap.  This technique is necessary as there is one stack per thread
 /// and we can not rely on comparison with the current stack memory position.
+/// The memory comes from ROOT::Internal::TObjectPool if it is enabled.
 
 void *TStorage::ObjectAlloc(size_t sz)
 {
-   void* space =  ::operator new(sz);
+   void* space = ROOT::Internal::TObjectPool::IsEnabled() ? ROOT::Internal::TObjectPool::Acquire(sz)
+                                                          : ::operator new(sz);
    memset(space, kObjectAllocMemValue, sz);
    return space;
 }
@@ -334,7 +337,8 @@ void *TStorage::ObjectAlloc(size_t sz)
 
 void *TStorage::ObjectAllocArray(size_t sz)
 {
-   void* space =  ::operator new(sz);
+   void* space = ROOT::Internal::TObjectPool::IsEnabled() ? ROOT::Internal::TObjectPool::Acquire(sz)
+                                                          : ::operator new(sz);
    return space;
 }
 
@@ -353,8 +357,10 @@ void *TStorage::ObjectAlloc(size_t , void *vp)
 
 void TStorage::ObjectDealloc(void *vp)
 {
-
-   ::operator delete(vp);
+   if (ROOT::Internal::TObjectPool::IsEnabled())
+      ROOT::Internal::TObjectPool::Release(vp);
+   else
+      ::operator delete(vp);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -372,7 +378,10 @@ void TStorage::ObjectDealloc(void *vp, void *ptr)
 
 void TStorage::ObjectDealloc(void *vp, size_t size)
 {
-   ::operator delete(vp, size);
+   if (ROOT::Internal::TObjectPool::IsEnabled())
+      ROOT::Internal::TObjectPool::Release(vp);
+   else
+      ::operator delete(vp, size);
 }
 #endif
 
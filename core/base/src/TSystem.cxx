@@ -2393,6 +2393,28 @@ int TSystem::SendRaw(int, const void *, int, int)
    return -1;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Send the nbuffers buffers one after the other, as if they were a single
+/// buffer, without copying them into one (scatter-gather). Use opt as for
+/// SendRaw(). Returns the total number of bytes sent, or the error code of
+/// SendRaw(). This default implementation calls SendRaw() for each buffer.
+
+int TSystem::SendRawBuffers(int sock, const void *const *buffers, const int *lengths, int nbuffers, int opt)
+{
+   int nsent = 0;
+   for (int i = 0; i < nbuffers; ++i) {
+      if (lengths[i] <= 0)
+         continue;
+      int n = SendRaw(sock, buffers[i], lengths[i], opt);
+      if (n <= 0)
+         return n;
+      nsent += n;
+      if (n < lengths[i])
+         break;   // kDontBlock: the socket cannot take more
+   }
+   return nsent;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Receive a buffer headed by a length indicator.
 
@@ -0,0 +1,228 @@
+// @(#)root/base:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class ROOT::Internal::TTrace
+\ingroup Base
+
+Trace of the zones of the hot paths, written in the JSON trace format of
+Chrome, which chrome://tracing and the Perfetto UI display as one time line
+per thread.
+
+The zones (R__TRACE_ZONE) are placed in TTree::GetEntry, the decompression
+of the baskets, TTreeCache::FillBuffer, the merging of TFileMerger, the
+tasks of TThreadExecutor and TTaskGroup, the iterations of Minuit2 and the
+evaluations of the RooFit likelihoods. They are compiled only when ROOT is
+configured with -Dtrace=ON, and recorded only when the environment variable
+ROOT_TRACE is set, to the name of the file to write at exit ("1" for
+root_trace.json), or after Enable().
+
+Each thread records the zones it ends in a ring buffer of its own, of
+ROOT_TRACE_EVENTS events (65536 by default): when it is full the oldest
+zones are overwritten. The buffer is protected by a mutex which is only
+contended while the trace is written. The buffers of the threads which
+ended are kept until the trace is written.
+*/
+
+#include "ROOT/TTrace.hxx"
+
+#include "ThreadLocalStorage.h"
+
+#include <chrono>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#ifdef WIN32
+#include <process.h>
+#define R__TRACE_GETPID _getpid
+#else
+#include <unistd.h>
+#define R__TRACE_GETPID getpid
+#endif
+
+namespace {
+
+struct TTraceEvent {
+   const char *fName;
+   const char *fCategory;
+   Long64_t    fBeginNs;
+   Long64_t    fEndNs;
+};
+
+struct TTraceRing {
+   std::mutex               fMutex;
+   std::vector<TTraceEvent> fEvents; // ring buffer
+   ULong64_t                fNext = 0;   // number of events recorded
+   Int_t                    fThread = 0; // index of the thread in the trace
+
+   void Record(const TTraceEvent &event)
+   {
+      std::lock_guard<std::mutex> lg(fMutex);
+      fEvents[fNext % fEvents.size()] = event;
+      ++fNext;
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// The ring buffers of all the threads. It is never deleted: zones may end
+/// during the destruction of the static objects.
+
+struct TTraceRegistry {
+   std::mutex                fMutex;
+   std::vector<TTraceRing *> fRings;
+   size_t                    fRingSize;
+   std::chrono::steady_clock::time_point fStart = std::chrono::steady_clock::now();
+
+   TTraceRegistry()
+   {
+      const char *env = ::getenv("ROOT_TRACE_EVENTS");
+      long size = env ? atol(env) : 0;
+      fRingSize = size > 0 ? size : 65536;
+   }
+
+   static TTraceRegistry &Get()
+   {
+      static TTraceRegistry *registry = new TTraceRegistry;
+      return *registry;
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// The ring buffer of the calling thread, registered when the thread ends
+/// its first zone.
+
+TTraceRing &GetRing()
+{
+   TTHREAD_TLS(TTraceRing *) ring = nullptr;
+   if (!ring) {
+      TTraceRegistry &registry = TTraceRegistry::Get();
+      TTraceRing *newring = new TTraceRing;
+      newring->fEvents.resize(registry.fRingSize);
+      std::lock_guard<std::mutex> lg(registry.fMutex);
+      newring->fThread = registry.fRings.size();
+      registry.fRings.push_back(newring);
+      ring = newring;
+   }
+   return *ring;
+}
+
+const char *&GetAtExitFileRef()
+{
+   static const char *filename = nullptr;
+   return filename;
+}
+
+void WriteAtExit()
+{
+   ROOT::Internal::TTrace::Write(GetAtExitFileRef());
+}
+
+Bool_t ReadEnabled()
+{
+   const char *env = ::getenv("ROOT_TRACE");
+   if (!env || !*env || (env[0] == '0' && !env[1]))
+      return kFALSE;
+   GetAtExitFileRef() = (env[0] == '1' && !env[1]) ? "root_trace.json" : env;
+   TTraceRegistry::Get(); // the time origin
+   atexit(WriteAtExit);
+   return kTRUE;
+}
+
+} // unnamed namespace
+
+namespace ROOT {
+namespace Internal {
+
+Bool_t TTrace::fgEnabled = ReadEnabled();
+
+////////////////////////////////////////////////////////////////////////////////
+/// Start or stop recording the zones.
+
+void TTrace::Enable(Bool_t enable)
+{
+   TTraceRegistry::Get();
+   fgEnabled = enable;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Time in ns since the start of the trace.
+
+Long64_t TTrace::Now()
+{
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                               TTraceRegistry::Get().fStart)
+      .count();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record a zone of the calling thread; name and category must stay valid
+/// until the trace is written.
+
+void TTrace::Record(const char *name, const char *category, Long64_t beginNs, Long64_t endNs)
+{
+   GetRing().Record(TTraceEvent{name, category, beginNs, endNs});
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the zones recorded by all the threads to filename, as a list of
+/// complete events ("ph":"X") with one thread per ring buffer. Returns false
+/// if the file cannot be written.
+
+Bool_t TTrace::Write(const char *filename)
+{
+   if (!filename)
+      return kFALSE;
+   FILE *out = fopen(filename, "w");
+   if (!out) {
+      fprintf(stderr, "TTrace: cannot write the trace to %s\n", filename);
+      return kFALSE;
+   }
+
+   const int pid = R__TRACE_GETPID();
+   Bool_t first = kTRUE;
+   fprintf(out, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+   TTraceRegistry &registry = TTraceRegistry::Get();
+   std::lock_guard<std::mutex> lg(registry.fMutex);
+   for (TTraceRing *ring : registry.fRings) {
+      std::lock_guard<std::mutex> lgring(ring->fMutex);
+      fprintf(out, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"thread %d\"}}",
+              first ? "" : ",", pid, ring->fThread, ring->fThread);
+      first = kFALSE;
+      const ULong64_t size = ring->fEvents.size();
+      const ULong64_t begin = ring->fNext > size ? ring->fNext - size : 0;
+      for (ULong64_t i = begin; i < ring->fNext; ++i) {
+         const TTraceEvent &event = ring->fEvents[i % size];
+         fprintf(out, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%d,\"tid\":%d}",
+                 event.fName, event.fCategory, 1e-3 * event.fBeginNs, 1e-3 * (event.fEndNs - event.fBeginNs), pid,
+                 ring->fThread);
+      }
+   }
+   fprintf(out, "\n]}\n");
+   fclose(out);
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Forget the zones recorded so far.
+
+void TTrace::Reset()
+{
+   TTraceRegistry &registry = TTraceRegistry::Get();
+   std::lock_guard<std::mutex> lg(registry.fMutex);
+   for (TTraceRing *ring : registry.fRings) {
+      std::lock_guard<std::mutex> lgring(ring->fMutex);
+      ring->fNext = 0;
+   }
+}
+
+} // End of namespace Internal
+} // End of namespace ROOT
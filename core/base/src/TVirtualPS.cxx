@@ -18,11 +18,25 @@ TVirtualPS is an abstract interface to Postscript, PDF, SVG. TeX etc... drivers
 
 #include "Riostream.h"
 #include "TVirtualPS.h"
-
-TVirtualPS *gVirtualPS = 0;
+#include "TThreadSlots.h"
 
 const Int_t  kMaxBuffer = 250;
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the current PostScript, PDF, SVG or image driver of the calling
+/// thread. Like gPad, this is a thread local once the thread safety is
+/// enabled, so that different threads can print different canvases at the
+/// same time.
+
+TVirtualPS *&TVirtualPS::PS()
+{
+   static TVirtualPS *currentPS = 0;
+   if (!gThreadTsd)
+      return currentPS;
+   else
+      return *(TVirtualPS**)(*gThreadTsd)(&currentPS,ROOT::kVirtualPSThreadSlot);
+}
+
 ClassImp(TVirtualPS)
 
 
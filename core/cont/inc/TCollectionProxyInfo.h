@@ -425,6 +425,23 @@ namespace Detail {
       }
    };
 
+   /** @class ROOT::Detail::TCollectionProxyInfo::Reserve
+    *
+    * Small helper to reserve the space for the elements about to be
+    * inserted in the containers which support it (unordered_set,
+    * unordered_map etc.); a no-op for the others.
+    */
+   template <class T> struct Reserve {
+      template <class C> static auto reserve(C &c, size_t n, int) -> decltype(c.reserve(n), void()) {
+         c.reserve(n);
+      }
+      template <class C> static void reserve(C &, size_t, long) {
+      }
+      static void apply(T &c, size_t n) {
+         reserve(c, n, 0);
+      }
+   };
+
    /** @class ROOT::Detail::TCollectionProxyInfo::Insert
     *
     * Small helper to encapsulate all necessary data accesses for
@@ -445,8 +462,11 @@ namespace Detail {
       static void* feed(void *from, void *to, size_t size)  {
          PCont_t  c = PCont_t(to);
          PValue_t m = PValue_t(from);
+         Reserve<Cont_t>::apply(*c, c->size() + size);
+         // The elements were collected from a container of the same kind,
+         // hence come sorted for the ordered ones: insert them at the end.
          for (size_t i=0; i<size; ++i, ++m)
-            c->insert(*m);
+            c->insert(c->end(), *m);
          return 0;
       }
       static void resize(void* /* obj */, size_t )  {
@@ -477,8 +497,11 @@ namespace Detail {
       static void* feed(void *from, void *to, size_t size)  {
          PCont_t  c = PCont_t(to);
          PValue_t m = PValue_t(from);
+         Reserve<Cont_t>::apply(*c, c->size() + size);
+         // The elements were collected from a container of the same kind,
+         // hence come sorted for the ordered ones: insert them at the end.
          for (size_t i=0; i<size; ++i, ++m)
-            c->insert(*m);
+            c->insert(c->end(), *m);
          return 0;
       }
       static void resize(void* /* obj */, size_t )  {
@@ -20,7 +20,9 @@
 // THashTable implements a hash table to store TObject's. The hash      //
 // value is calculated using the value returned by the TObject's        //
 // Hash() function. Each class inheriting from TObject can override     //
-// Hash() as it sees fit.                                               //
+// Hash() as it sees fit. The table uses open addressing: the objects   //
+// are stored in the slots themselves, lists are only used for the      //
+// objects sharing the same hash value.                                 //
 //                                                                      //
 //////////////////////////////////////////////////////////////////////////
 
@@ -41,14 +43,30 @@ class THashTable : public TCollection {
 friend class  THashTableIter;
 
 private:
-   TList     **fCont;          //Hash table (table of lists)
+   // A slot holds the objects of one hash value: a single one in fObject,
+   // several ones (or on request of GetListForObject) in fList. A slot
+   // without objects is free if fHash is 0, else it is a removed entry
+   // which does not stop the probing.
+   struct Slot_t {
+      ULong_t     fHash;       //Hash value of the objects of the slot
+      TObject    *fObject;     //Object, if alone with this hash value
+      TList      *fList;       //Objects with this hash value otherwise
+   };
+
+   Slot_t     *fCont;          //!Hash table (table of slots), allocated on first use
    Int_t       fEntries;       //Number of objects in table
-   Int_t       fUsedSlots;     //Number of used slots
-   Int_t       fRehashLevel;   //Average collision rate which triggers rehash
-
-   Int_t       GetHashValue(const TObject *obj) const;
-   Int_t       GetHashValue(TString &s) const { return s.Hash() % fSize; }
-   Int_t       GetHashValue(const char *str) const { return ::Hash(str) % fSize; }
+   Int_t       fUsedSlots;     //Number of used slots (i.e. of different hash values)
+   Int_t       fRemovedSlots;  //Number of removed entries
+   Int_t       fRehashLevel;   //Kept for backward compatibility, the table always grows as needed
+
+   static Bool_t IsEmpty(const Slot_t &slot) { return !slot.fObject && !slot.fList; }
+   Slot_t     *GetSlot(ULong_t hash) const;
+   static TList *MakeList(Slot_t &slot);
+   void        Insert(TObject *obj, ULong_t hash, const TObject *before = 0);
+   void        EraseSlot(Slot_t &slot);
+   void        Reserve(Int_t nentries);
+   void        Resize(Int_t nslots);
+   static Int_t SlotsFor(Int_t nentries);
 
    THashTable(const THashTable&);             // not implemented
    THashTable& operator=(const THashTable&);  // not implemented
@@ -88,12 +106,6 @@ inline Float_t THashTable::AverageCollisions() const
       return 0.0;
 }
 
-inline Int_t THashTable::GetHashValue(const TObject *obj) const
-{
-   Int_t i = Int_t(obj->Hash() % fSize);  // need intermediary i for Linux g++
-   return i;
-}
-
 
 //////////////////////////////////////////////////////////////////////////
 //                                                                      //
@@ -109,9 +121,10 @@ private:
    const THashTable *fTable;       //hash table being iterated
    Int_t             fCursor;      //current position in table
    TListIter        *fListCursor;  //current position in collision list
+   TObject          *fCurrent;     //current object
    Bool_t            fDirection;   //iteration direction
 
-   THashTableIter() : fTable(0), fCursor(0), fListCursor(0), fDirection(kIterForward) { }
+   THashTableIter() : fTable(0), fCursor(0), fListCursor(0), fCurrent(0), fDirection(kIterForward) { }
    Int_t             NextSlot();
 
 public:
@@ -351,6 +351,7 @@ void TClassTable::Add(const char *cname, Version_t id,  const std::type_info &in
    fgIdMap->Add(info.name(),r);
 
    fgSorted = kFALSE;
+   TClassEdit::ResetNameCache();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -390,6 +391,7 @@ void TClassTable::Add(TProtoClass *proto)
    r->fProto= proto;
 
    fgSorted = kFALSE;
+   TClassEdit::ResetNameCache();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -413,6 +415,7 @@ void TClassTable::AddAlternate(const char *normName, const char *alternate)
    }
 
    fgAlternate[slot] = new TClassAlt(alternate,normName,fgAlternate[slot]);
+   TClassEdit::ResetNameCache();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -446,6 +449,8 @@ void TClassTable::Remove(const char *cname)
 {
    if (!gClassTable || !fgTable) return;
 
+   TClassEdit::ResetNameCache();
+
    UInt_t slot = ROOT::ClassTableHash(cname,fgSize);
 
    TClassRec *r;
@@ -146,7 +146,7 @@ static inline void R__ReleaseMemory(TClass *cl, TObject *obj)
       if (TObject::GetObjectStat() && gObjectTable) {
          gObjectTable->RemoveQuietly(obj);
       }
-      ::operator delete(obj);
+      TStorage::ObjectDealloc(obj);
    }
 }
 
@@ -159,9 +159,12 @@ Long64_t &TExMap::operator()(ULong64_t hash, Long64_t key)
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Delete all entries stored in the TExMap.
+/// Nothing needs to be cleared when the map is already empty (this is the
+/// common case of the buffer maps reset for every entry of a TTree).
 
 void TExMap::Delete(Option_t *)
 {
+   if (fTally == 0) return;
    memset(fTable,0,sizeof(Assoc_t)*fSize);
    fTally = 0;
 }
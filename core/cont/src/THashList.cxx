@@ -26,14 +26,11 @@ can override Hash() as it sees fit.
 ClassImp(THashList)
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Create a THashList object. Capacity is the initial hashtable capacity
-/// (i.e. number of slots), by default kInitHashTableCapacity = 17, and
-/// rehash is the value at which a rehash will be triggered. I.e. when the
-/// average size of the linked lists at a slot becomes longer than rehash
-/// then the hashtable will be resized and refilled to reduce the collision
-/// rate to about 1. The higher the collision rate, i.e. the longer the
-/// linked lists, the longer lookup will take. If rehash=0 the table will
-/// NOT automatically be rehashed. Use Rehash() for manual rehashing.
+/// Create a THashList object. Capacity is the number of objects the
+/// hashtable can hold before it is resized, by default
+/// kInitHashTableCapacity = 17. The hashtable is resized automatically
+/// when needed; rehash is not used anymore and is kept for backward
+/// compatibility (see THashTable::THashTable()).
 ///
 /// WARNING !!!
 /// If the name of an object in the HashList is modified, The hashlist
@@ -152,9 +149,8 @@ void THashList::AddAt(TObject *obj, Int_t idx)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Return the average collision rate. The higher the number the longer
-/// the linked lists in the hashtable, the slower the lookup. If the number
-/// is high, or lookup noticeably too slow, perform a Rehash().
+/// Return the average number of objects per hash value in the hashtable,
+/// i.e. the average number of objects having the same name.
 
 Float_t THashList::AverageCollisions() const
 {
@@ -267,12 +263,10 @@ void THashList::RecursiveRemove(TObject *obj)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Rehash the hashlist. If the collision rate becomes too high (i.e.
-/// the average size of the linked lists become too long) then lookup
-/// efficiency decreases since relatively long lists have to be searched
-/// every time. To improve performance rehash the hashtable. This resizes
-/// the table to newCapacity slots and refills the table. Use
-/// AverageCollisions() to check if you need to rehash.
+/// Rehash the hashlist. This recomputes the hash values of the objects,
+/// which is needed when they have changed (e.g. when the name of an object
+/// has been modified), and resizes the hashtable to hold at least
+/// newCapacity objects.
 
 void THashList::Rehash(Int_t newCapacity)
 {
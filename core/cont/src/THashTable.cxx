@@ -19,6 +19,15 @@ Hash() as it sees fit.
 THashTable does not preserve the insertion order of the objects.
 If the insertion order is important AND fast retrieval is needed
 use THashList instead.
+
+The table uses open addressing with linear probing: each slot of
+the table holds the hash value and the object stored under it, so
+that a lookup reads consecutive slots of one array instead of
+following the links of a list, and adding an object does not
+allocate memory. Only when several objects have the same hash
+value (e.g. the cycles of a key in a TDirectory) they are kept in
+a TList in their slot. The table is resized whenever it becomes
+three quarters full; the slots are allocated on the first insertion.
 */
 
 #include "THashTable.h"
@@ -26,18 +35,37 @@ use THashList instead.
 #include "TList.h"
 #include "TError.h"
 
+#include <string.h>
+#include <vector>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the first slot to probe for hash in a table of nslots slots (a
+/// power of two). The bits of the hash are mixed since the hash values of
+/// many classes (e.g. the addresses returned by TObject::Hash()) differ
+/// mostly in their upper bits.
+
+inline Int_t HomeSlot(ULong_t hash, Int_t nslots)
+{
+   ULong64_t h = hash;
+   h ^= h >> 33;
+   h *= 0xff51afd7ed558ccdULL;
+   h ^= h >> 33;
+   return Int_t(h & (nslots - 1));
+}
+
+} // anonymous namespace
+
 ClassImp(THashTable)
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Create a THashTable object. Capacity is the initial hashtable capacity
-/// (i.e. number of slots), by default kInitHashTableCapacity = 17, and
-/// rehashlevel is the value at which a rehash will be triggered. I.e. when
-/// the average size of the linked lists at a slot becomes longer than
-/// rehashlevel then the hashtable will be resized and refilled to reduce
-/// the collision rate to about 1. The higher the collision rate, i.e. the
-/// longer the linked lists, the longer lookup will take. If rehashlevel=0
-/// the table will NOT automatically be rehashed. Use Rehash() for manual
-/// rehashing.
+/// Create a THashTable object. Capacity is the number of objects the
+/// table can hold before it is resized, by default kInitHashTableCapacity
+/// = 17. Rehashlevel is not used anymore: the table is resized
+/// automatically whenever it is three quarters full. It is kept, with
+/// Set/GetRehashLevel(), for backward compatibility. Use Rehash() when the
+/// hash values of the objects have changed.
 
 THashTable::THashTable(Int_t capacity, Int_t rehashlevel)
 {
@@ -47,12 +75,12 @@ THashTable::THashTable(Int_t capacity, Int_t rehashlevel)
    } else if (capacity == 0)
       capacity = TCollection::kInitHashTableCapacity;
 
-   fSize = (Int_t)TMath::NextPrime(TMath::Max(capacity,(int)TCollection::kInitHashTableCapacity));
-   fCont = new TList* [fSize];
-   memset(fCont, 0, fSize*sizeof(TList*));
+   fSize = SlotsFor(capacity);
+   fCont = 0;
 
-   fEntries   = 0;
-   fUsedSlots = 0;
+   fEntries      = 0;
+   fUsedSlots    = 0;
+   fRemovedSlots = 0;
    if (rehashlevel < 2) rehashlevel = 0;
    fRehashLevel = rehashlevel;
 }
@@ -69,6 +97,145 @@ THashTable::~THashTable()
    fSize = 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of slots of a table holding nentries hash values: the
+/// smallest power of two, at least 8, which is at most three quarters full.
+
+Int_t THashTable::SlotsFor(Int_t nentries)
+{
+   Int_t nslots = 8;
+   while (nslots < (1 << 30) && 3 * (Long64_t)nslots < 4 * (Long64_t)nentries)
+      nslots <<= 1;
+   return nslots;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the slot holding the objects of the given hash value, 0 if there
+/// is none.
+
+THashTable::Slot_t *THashTable::GetSlot(ULong_t hash) const
+{
+   if (!fCont) return 0;
+
+   Int_t mask = fSize - 1;
+   for (Int_t i = HomeSlot(hash, fSize); ; i = (i + 1) & mask) {
+      Slot_t &slot = fCont[i];
+      if (IsEmpty(slot)) {
+         if (!slot.fHash) return 0;
+      } else if (slot.fHash == hash)
+         return &slot;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Make the slot keep its objects in a TList.
+
+TList *THashTable::MakeList(Slot_t &slot)
+{
+   if (!slot.fList) {
+      slot.fList = new TList;
+      slot.fList->Add(slot.fObject);
+      slot.fObject = 0;
+   }
+   return slot.fList;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Store obj under the given hash value. If before is not 0, it has the
+/// same hash value and obj is added in front of it in the list of the slot.
+
+void THashTable::Insert(TObject *obj, ULong_t hash, const TObject *before)
+{
+   // Keep a free slot to stop the probing; when the table is full of
+   // removed entries it is rebuilt with the same size.
+   if (!fCont || 4 * (fUsedSlots + fRemovedSlots + 1) > 3 * fSize)
+      Resize(TMath::Max(fSize, SlotsFor(2 * (fUsedSlots + 1))));
+
+   Int_t mask = fSize - 1;
+   Slot_t *removed = 0;
+   for (Int_t i = HomeSlot(hash, fSize); ; i = (i + 1) & mask) {
+      Slot_t &slot = fCont[i];
+      if (IsEmpty(slot)) {
+         if (slot.fHash) {
+            if (!removed) removed = &slot;
+            continue;
+         }
+         Slot_t &dest = removed ? *removed : slot;
+         if (removed) fRemovedSlots--;
+         dest.fHash   = hash;
+         dest.fObject = obj;
+         dest.fList   = 0;
+         fUsedSlots++;
+         break;
+      }
+      if (slot.fHash == hash) {
+         if (before)
+            MakeList(slot)->AddBefore(before, obj);
+         else
+            MakeList(slot)->Add(obj);
+         break;
+      }
+   }
+   fEntries++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Mark the slot, whose objects have been removed, as free or, if it is
+/// part of a probing sequence, as removed.
+
+void THashTable::EraseSlot(Slot_t &slot)
+{
+   Int_t next = (Int_t(&slot - fCont) + 1) & (fSize - 1);
+   slot.fObject = 0;
+   slot.fList   = 0;
+   fUsedSlots--;
+   if (IsEmpty(fCont[next]) && !fCont[next].fHash) {
+      slot.fHash = 0;
+   } else {
+      slot.fHash = 1;
+      fRemovedSlots++;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Make room for nentries more objects.
+
+void THashTable::Reserve(Int_t nentries)
+{
+   Int_t nslots = SlotsFor(fUsedSlots + nentries);
+   if (nslots > fSize) {
+      if (fCont)
+         Resize(nslots);
+      else
+         fSize = nslots;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Move the slots in a new table of nslots slots (a power of two), which
+/// drops the removed entries. The hash values are not recomputed.
+
+void THashTable::Resize(Int_t nslots)
+{
+   Slot_t *old   = fCont;
+   Int_t oldsize = fSize;
+
+   fCont = new Slot_t[nslots];
+   memset(fCont, 0, nslots*sizeof(Slot_t));
+   fSize         = nslots;
+   fRemovedSlots = 0;
+   if (!old) return;
+
+   Int_t mask = nslots - 1;
+   for (Int_t j = 0; j < oldsize; j++) {
+      if (IsEmpty(old[j])) continue;
+      Int_t i = HomeSlot(old[j].fHash, nslots);
+      while (!IsEmpty(fCont[i])) i = (i + 1) & mask;
+      fCont[i] = old[j];
+   }
+   delete [] old;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Add object to the hash table. Its position in the table will be
 /// determined by the value returned by its Hash() function.
@@ -77,42 +244,21 @@ void THashTable::Add(TObject *obj)
 {
    if (IsArgNull("Add", obj)) return;
 
-   Int_t slot = GetHashValue(obj);
-   if (!fCont[slot]) {
-      fCont[slot] = new TList;
-      fUsedSlots++;
-   }
-   fCont[slot]->Add(obj);
-   fEntries++;
-
-   if (fRehashLevel && AverageCollisions() > fRehashLevel)
-      Rehash(fEntries);
+   Insert(obj, obj->Hash());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Add object to the hash table. Its position in the table will be
 /// determined by the value returned by its Hash() function.
-/// If and only if 'before' is in the same bucket as obj, obj is added
-/// in front of 'before' within the bucket's list.
+/// If and only if 'before' has the same hash value as obj, obj is added
+/// in front of 'before' within the list of objects of this hash value.
 
 void THashTable::AddBefore(const TObject *before, TObject *obj)
 {
    if (IsArgNull("Add", obj)) return;
 
-   Int_t slot = GetHashValue(obj);
-   if (!fCont[slot]) {
-      fCont[slot] = new TList;
-      fUsedSlots++;
-   }
-   if (before && GetHashValue(before) == slot) {
-      fCont[slot]->AddBefore(before,obj);
-   } else {
-      fCont[slot]->Add(obj);
-   }
-   fEntries++;
-
-   if (fRehashLevel && AverageCollisions() > fRehashLevel)
-      Rehash(fEntries);
+   ULong_t hash = obj->Hash();
+   Insert(obj, hash, (before && before->Hash() == hash) ? before : 0);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -121,25 +267,10 @@ void THashTable::AddBefore(const TObject *before, TObject *obj)
 
 void THashTable::AddAll(const TCollection *col)
 {
-   // Hashing after AddAll can be much more expensive than
-   // hashing before, as we need to add more elements.
-   // We assume an ideal hash, i.e. fUsedSlots==fSize.
-   Int_t sumEntries=fEntries+col->GetEntries();
-   Bool_t rehashBefore=fRehashLevel && (sumEntries > fSize*fRehashLevel);
-   if (rehashBefore)
-      Rehash(sumEntries);
-
-   // prevent Add from Rehashing
-   Int_t saveRehashLevel=fRehashLevel;
-   fRehashLevel=0;
+   // Resize once for all the objects rather than while adding them.
+   Reserve(col->GetEntries());
 
    TCollection::AddAll(col);
-
-   fRehashLevel=saveRehashLevel;
-   // If we didn't Rehash before, we might have to do it
-   // now, due to a non-perfect hash function.
-   if (!rehashBefore && fRehashLevel && AverageCollisions() > fRehashLevel)
-      Rehash(fEntries);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -148,44 +279,66 @@ void THashTable::AddAll(const TCollection *col)
 
 void THashTable::Clear(Option_t *option)
 {
-   for (int i = 0; i < fSize; i++) {
-      // option "nodelete" is passed when Clear is called from
-      // THashList::Clear() or THashList::Delete() or Rehash().
-      if (fCont[i]) {
-         if (IsOwner())
-            fCont[i]->SetOwner();
-         fCont[i]->Clear(option);
+   // option "nodelete" is passed when Clear is called from
+   // THashList::Clear() or THashList::Delete() or Rehash().
+   Bool_t nodel = option ? (!strcmp(option, "nodelete") ? kTRUE : kFALSE) : kFALSE;
+
+   // The objects to delete are collected first, so that the table is
+   // already empty when they are deleted.
+   TList *objects = 0;
+   for (int i = 0; fCont && i < fSize; i++) {
+      Slot_t &slot = fCont[i];
+      if (!nodel && !IsEmpty(slot)) {
+         TIter next(slot.fList);
+         TObject *obj = slot.fList ? next() : slot.fObject;
+         while (obj) {
+            if (IsOwner() || (obj->IsOnHeap() && obj->TestBit(kCanDelete))) {
+               if (!objects) objects = new TList;
+               objects->Add(obj);
+            }
+            obj = slot.fList ? next() : 0;
+         }
       }
-      SafeDelete(fCont[i]);
+      delete slot.fList;
    }
+   if (fCont) memset(fCont, 0, fSize*sizeof(Slot_t));
+
+   fEntries      = 0;
+   fUsedSlots    = 0;
+   fRemovedSlots = 0;
 
-   fEntries   = 0;
-   fUsedSlots = 0;
+   if (objects) {
+      if (IsOwner())
+         objects->SetOwner();
+      objects->Clear(option);
+      delete objects;
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns the number of collisions for an object with a certain name
-/// (i.e. number of objects in same slot in the hash table, i.e. length
-/// of linked list).
+/// (i.e. number of objects with the same hash value in the hash table).
 
 Int_t THashTable::Collisions(const char *name) const
 {
-   Int_t slot = GetHashValue(name);
-   if (fCont[slot]) return fCont[slot]->GetSize();
-   return 0;
+   if (!name) return 0;
+
+   Slot_t *slot = GetSlot(::Hash(name));
+   if (!slot) return 0;
+   return slot->fList ? slot->fList->GetSize() : 1;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns the number of collisions for an object (i.e. number of objects
-/// in same slot in the hash table, i.e. length of linked list).
+/// with the same hash value in the hash table).
 
 Int_t THashTable::Collisions(TObject *obj) const
 {
    if (IsArgNull("Collisions", obj)) return 0;
 
-   Int_t slot = GetHashValue(obj);
-   if (fCont[slot]) return fCont[slot]->GetSize();
-   return 0;
+   Slot_t *slot = GetSlot(obj->Hash());
+   if (!slot) return 0;
+   return slot->fList ? slot->fList->GetSize() : 1;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -193,14 +346,22 @@ Int_t THashTable::Collisions(TObject *obj) const
 
 void THashTable::Delete(Option_t *)
 {
-   for (int i = 0; i < fSize; i++)
-      if (fCont[i]) {
-         fCont[i]->Delete();
-         SafeDelete(fCont[i]);
-      }
+   TList objects;
+   for (int i = 0; fCont && i < fSize; i++) {
+      Slot_t &slot = fCont[i];
+      if (slot.fList) {
+         objects.AddAll(slot.fList);
+         delete slot.fList;
+      } else if (slot.fObject)
+         objects.Add(slot.fObject);
+   }
+   if (fCont) memset(fCont, 0, fSize*sizeof(Slot_t));
 
-   fEntries   = 0;
-   fUsedSlots = 0;
+   fEntries      = 0;
+   fUsedSlots    = 0;
+   fRemovedSlots = 0;
+
+   objects.Delete();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -209,9 +370,14 @@ void THashTable::Delete(Option_t *)
 
 TObject *THashTable::FindObject(const char *name) const
 {
-   Int_t slot = GetHashValue(name);
-   if (fCont[slot]) return fCont[slot]->FindObject(name);
-   return 0;
+   if (!name) return 0;
+
+   Slot_t *slot = GetSlot(::Hash(name));
+   if (!slot) return 0;
+   if (slot->fList) return slot->fList->FindObject(name);
+
+   const char *objname = slot->fObject->GetName();
+   return (objname && !strcmp(name, objname)) ? slot->fObject : 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -221,30 +387,37 @@ TObject *THashTable::FindObject(const TObject *obj) const
 {
    if (IsArgNull("FindObject", obj)) return 0;
 
-   Int_t slot = GetHashValue(obj);
-   if (fCont[slot]) return fCont[slot]->FindObject(obj);
-   return 0;
+   Slot_t *slot = GetSlot(obj->Hash());
+   if (!slot) return 0;
+   if (slot->fList) return slot->fList->FindObject(obj);
+   return slot->fObject->IsEqual(obj) ? slot->fObject : 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Return the TList corresponding to object's name based hash value.
+/// Return the TList of the objects having the same hash value as name.
 /// One can iterate this list "manually" to find, e.g. objects with
-/// the same name.
+/// the same name. The list is created by the first call for this hash
+/// value and stays valid until all these objects are removed.
 
 const TList *THashTable::GetListForObject(const char *name) const
 {
-   return fCont[GetHashValue(name)];
+   if (!name) return 0;
+
+   Slot_t *slot = GetSlot(::Hash(name));
+   return slot ? MakeList(*slot) : 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Return the TList corresponding to object's hash value.
+/// Return the TList of the objects having the same hash value as obj.
 /// One can iterate this list "manually" to find, e.g. identical
-/// objects.
+/// objects. See GetListForObject(const char*) for its lifetime.
 
 const TList *THashTable::GetListForObject(const TObject *obj) const
 {
    if (IsArgNull("GetListForObject", obj)) return 0;
-   return fCont[GetHashValue(obj)];
+
+   Slot_t *slot = GetSlot(obj->Hash());
+   return slot ? MakeList(*slot) : 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -254,9 +427,10 @@ TObject **THashTable::GetObjectRef(const TObject *obj) const
 {
    if (IsArgNull("GetObjectRef", obj)) return 0;
 
-   Int_t slot = GetHashValue(obj);
-   if (fCont[slot]) return fCont[slot]->GetObjectRef(obj);
-   return 0;
+   Slot_t *slot = GetSlot(obj->Hash());
+   if (!slot) return 0;
+   if (slot->fList) return slot->fList->GetObjectRef(obj);
+   return slot->fObject->IsEqual(obj) ? &slot->fObject : 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -268,45 +442,36 @@ TIterator *THashTable::MakeIterator(Bool_t dir) const
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Rehash the hashtable. If the collision rate becomes too high (i.e.
-/// the average size of the linked lists become too long) then lookup
-/// efficiency decreases since relatively long lists have to be searched
-/// every time. To improve performance rehash the hashtable. This resizes
-/// the table to newCapacity slots and refills the table. Use
-/// AverageCollisions() to check if you need to rehash. Set checkObjValidity
-/// to kFALSE if you know that all objects in the table are still valid
-/// (i.e. have not been deleted from the system in the meanwhile).
+/// Rehash the hashtable. The hash values of the objects are recomputed,
+/// which is needed when they have changed since the objects were added
+/// (e.g. when their name has been modified), and the table is resized to
+/// hold at least newCapacity objects. Set checkObjValidity to kFALSE if
+/// you know that all objects in the table are still valid (i.e. have not
+/// been deleted from the system in the meanwhile).
 
 void THashTable::Rehash(Int_t newCapacity, Bool_t checkObjValidity)
 {
-   THashTable *ht = new THashTable(newCapacity);
+   std::vector<TObject*> objects;
+   objects.reserve(fEntries);
 
    TIter next(this);
    TObject *obj;
 
    if (checkObjValidity && TObject::GetObjectStat() && gObjectTable) {
       while ((obj = next()))
-         if (gObjectTable->PtrIsValid(obj)) ht->Add(obj);
+         if (gObjectTable->PtrIsValid(obj)) objects.push_back(obj);
    } else {
       while ((obj = next()))
-         ht->Add(obj);
+         objects.push_back(obj);
    }
 
    Clear("nodelete");
    delete [] fCont;
-   fCont = ht->fCont;
-   ht->fCont = 0;
-
-   fSize      = ht->fSize;     // idem
-   fEntries   = ht->fEntries;
-   fUsedSlots = ht->fUsedSlots;
-
-   // this should not happen, but it will prevent an endless loop
-   // in case of a very bad hash function
-   if (fRehashLevel && AverageCollisions() > fRehashLevel)
-      fRehashLevel = (int)AverageCollisions() + 1;
+   fCont = 0;
+   fSize = SlotsFor(TMath::Max(newCapacity, (Int_t)objects.size()));
 
-   delete ht;
+   for (auto o : objects)
+      Insert(o, o->Hash());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -314,19 +479,24 @@ void THashTable::Rehash(Int_t newCapacity, Bool_t checkObjValidity)
 
 TObject *THashTable::Remove(TObject *obj)
 {
-   Int_t slot = GetHashValue(obj);
-   if (fCont[slot]) {
-      TObject *ob = fCont[slot]->Remove(obj);
-      if (ob) {
-         fEntries--;
-         if (fCont[slot]->GetSize() == 0) {
-            SafeDelete(fCont[slot]);
-            fUsedSlots--;
-         }
-         return ob;
+   if (!obj) return 0;
+
+   Slot_t *slot = GetSlot(obj->Hash());
+   if (!slot) return 0;
+
+   TObject *ob = 0;
+   if (slot->fList) {
+      ob = slot->fList->Remove(obj);
+      if (ob && slot->fList->GetSize() == 0) {
+         delete slot->fList;
+         EraseSlot(*slot);
       }
+   } else if (slot->fObject->TestBit(kNotDeleted) && slot->fObject->IsEqual(obj)) {
+      ob = slot->fObject;
+      EraseSlot(*slot);
    }
-   return 0;
+   if (ob) fEntries--;
+   return ob;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -334,17 +504,22 @@ TObject *THashTable::Remove(TObject *obj)
 
 TObject *THashTable::RemoveSlow(TObject *obj)
 {
-   for (int i = 0; i < fSize; i++) {
-      if (fCont[i]) {
-         TObject *ob = fCont[i]->Remove(obj);
-         if (ob) {
-            fEntries--;
-            if (fCont[i]->GetSize() == 0) {
-               SafeDelete(fCont[i]);
-               fUsedSlots--;
-            }
-            return ob;
+   for (int i = 0; fCont && i < fSize; i++) {
+      Slot_t &slot = fCont[i];
+      TObject *ob = 0;
+      if (slot.fList) {
+         ob = slot.fList->Remove(obj);
+         if (ob && slot.fList->GetSize() == 0) {
+            delete slot.fList;
+            EraseSlot(slot);
          }
+      } else if (slot.fObject && slot.fObject->TestBit(kNotDeleted) && slot.fObject->IsEqual(obj)) {
+         ob = slot.fObject;
+         EraseSlot(slot);
+      }
+      if (ob) {
+         fEntries--;
+         return ob;
       }
    }
    return 0;
@@ -365,6 +540,7 @@ THashTableIter::THashTableIter(const THashTable *ht, Bool_t dir)
    fTable      = ht;
    fDirection  = dir;
    fListCursor = 0;
+   fCurrent    = 0;
    Reset();
 }
 
@@ -376,6 +552,7 @@ THashTableIter::THashTableIter(const THashTableIter &iter) : TIterator(iter)
    fTable      = iter.fTable;
    fDirection  = iter.fDirection;
    fCursor     = iter.fCursor;
+   fCurrent    = iter.fCurrent;
    fListCursor = 0;
    if (iter.fListCursor) {
       fListCursor = (TListIter *)iter.fListCursor->GetCollection()->MakeIterator();
@@ -394,6 +571,8 @@ TIterator &THashTableIter::operator=(const TIterator &rhs)
       fTable     = rhs1.fTable;
       fDirection = rhs1.fDirection;
       fCursor    = rhs1.fCursor;
+      fCurrent   = rhs1.fCurrent;
+      SafeDelete(fListCursor);
       if (rhs1.fListCursor) {
          fListCursor = (TListIter *)rhs1.fListCursor->GetCollection()->MakeIterator();
          if (fListCursor)
@@ -412,6 +591,8 @@ THashTableIter &THashTableIter::operator=(const THashTableIter &rhs)
       fTable     = rhs.fTable;
       fDirection = rhs.fDirection;
       fCursor    = rhs.fCursor;
+      fCurrent   = rhs.fCurrent;
+      SafeDelete(fListCursor);
       if (rhs.fListCursor) {
          fListCursor = (TListIter *)rhs.fListCursor->GetCollection()->MakeIterator();
          if (fListCursor)
@@ -435,33 +616,40 @@ THashTableIter::~THashTableIter()
 TObject *THashTableIter::Next()
 {
    while (kTRUE) {
-      if (!fListCursor) {
-         int slot = NextSlot();
-         if (slot == -1) return 0;
-         fListCursor = new TListIter(fTable->fCont[slot], fDirection);
+      if (fListCursor) {
+         fCurrent = fListCursor->Next();
+         if (fCurrent) return fCurrent;
+         SafeDelete(fListCursor);
       }
 
-      TObject *obj = fListCursor->Next();
-      if (obj) return obj;
-
-      SafeDelete(fListCursor);
+      int slot = NextSlot();
+      if (slot == -1) {
+         fCurrent = 0;
+         return 0;
+      }
+      if (fTable->fCont[slot].fList)
+         fListCursor = new TListIter(fTable->fCont[slot].fList, fDirection);
+      else
+         return fCurrent = fTable->fCont[slot].fObject;
    }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Returns index of next slot in table containing list to be iterated.
+/// Returns index of next slot in table containing objects to be iterated.
 
 Int_t THashTableIter::NextSlot()
 {
+   if (!fTable->fCont) return -1;
+
    if (fDirection == kIterForward) {
-      for ( ; fCursor < fTable->Capacity() && fTable->fCont[fCursor] == 0;
+      for ( ; fCursor < fTable->Capacity() && THashTable::IsEmpty(fTable->fCont[fCursor]);
               fCursor++) { }
 
       if (fCursor < fTable->Capacity())
          return fCursor++;
 
    } else {
-      for ( ; fCursor >= 0 && fTable->fCont[fCursor] == 0;
+      for ( ; fCursor >= 0 && THashTable::IsEmpty(fTable->fCont[fCursor]);
               fCursor--) { }
 
       if (fCursor >= 0)
@@ -481,6 +669,7 @@ void THashTableIter::Reset()
    else
       fCursor = fTable->Capacity() - 1;
    SafeDelete(fListCursor);
+   fCurrent = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -490,7 +679,7 @@ Bool_t THashTableIter::operator!=(const TIterator &aIter) const
 {
    if (aIter.IsA() == THashTableIter::Class()) {
       const THashTableIter &iter(dynamic_cast<const THashTableIter &>(aIter));
-      return (fListCursor != iter.fListCursor);
+      return (fCurrent != iter.fCurrent);
    }
    return false; // for base class we don't implement a comparison
 }
@@ -500,7 +689,7 @@ Bool_t THashTableIter::operator!=(const TIterator &aIter) const
 
 Bool_t THashTableIter::operator!=(const THashTableIter &aIter) const
 {
-   return (fListCursor != aIter.fListCursor);
+   return (fCurrent != aIter.fCurrent);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -508,5 +697,5 @@ Bool_t THashTableIter::operator!=(const THashTableIter &aIter) const
 
 TObject *THashTableIter::operator*() const
 {
-   return (fListCursor ? fListCursor->operator*() : nullptr);
+   return fCurrent;
 }
@@ -0,0 +1,108 @@
+// @(#)root/lz4:$Id$
+// Author: ROOT I/O team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ZipLZ4.h"
+#include <stdio.h>
+
+#ifdef R__HAS_LZ4
+#include "lz4.h"
+#include "lz4hc.h"
+#endif
+
+static const int kHeaderSize = 9;
+
+/* Below this level the fast LZ4 compressor is used, above it LZ4 HC. */
+static const int kMinHCLevel = 4;
+
+void R__zipLZ4(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep)
+{
+#ifdef R__HAS_LZ4
+   int out_size;                  /* compressed size */
+   unsigned in_size = (unsigned) (*srcsize);
+   int capacity = *tgtsize - kHeaderSize;
+
+   *irep = 0;
+
+   if (capacity <= 0) {
+      return;
+   }
+
+   if (*srcsize > 0xffffff || *srcsize < 0) {
+      return;
+   }
+
+   if (cxlevel > 9) cxlevel = 9;
+
+   if (cxlevel >= kMinHCLevel) {
+      /* map ROOT levels 4..9 onto the LZ4 HC levels 4..12 */
+      int hclevel = kMinHCLevel + (cxlevel - kMinHCLevel) * 8 / 5;
+      out_size = LZ4_compress_HC(src, &tgt[kHeaderSize], *srcsize, capacity, hclevel);
+   } else {
+      out_size = LZ4_compress_default(src, &tgt[kHeaderSize], *srcsize, capacity);
+   }
+   if (out_size <= 0) {
+      /* No need to print an error message. We simply abandon the compression
+         the buffer cannot be compressed or compressed buffer would be larger than original buffer
+      */
+      return;
+   }
+
+   tgt[0] = 'L';  /* Signature of LZ4 */
+   tgt[1] = '4';
+   tgt[2] = 1;    /* format version */
+
+   tgt[3] = (char)(out_size & 0xff);
+   tgt[4] = (char)((out_size >> 8) & 0xff);
+   tgt[5] = (char)((out_size >> 16) & 0xff);
+
+   tgt[6] = (char)(in_size & 0xff);         /* decompressed size */
+   tgt[7] = (char)((in_size >> 8) & 0xff);
+   tgt[8] = (char)((in_size >> 16) & 0xff);
+
+   *irep = out_size + kHeaderSize;
+#else
+   (void)cxlevel; (void)srcsize; (void)src; (void)tgtsize; (void)tgt;
+   /* Without LZ4 support the buffer is simply left uncompressed. */
+   *irep = 0;
+#endif
+}
+
+void R__unzipLZ4(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep)
+{
+#ifdef R__HAS_LZ4
+   int returnStatus;
+
+   *irep = 0;
+
+   if (src[2] != 1) {
+      fprintf(stderr,
+              "R__unzipLZ4: unsupported LZ4 format version %d\n",
+              src[2]);
+      return;
+   }
+
+   returnStatus = LZ4_decompress_safe((const char *)(&src[kHeaderSize]), (char *)tgt,
+                                      *srcsize - kHeaderSize, *tgtsize);
+   if (returnStatus < 0) {
+      fprintf(stderr,
+              "R__unzipLZ4: error %d in LZ4_decompress_safe\n",
+              returnStatus);
+      return;
+   }
+
+   *irep = returnStatus;
+#else
+   (void)srcsize; (void)src; (void)tgtsize; (void)tgt;
+   fprintf(stderr,
+           "R__unzipLZ4: buffer is LZ4 compressed but ROOT was built without LZ4 support\n");
+   *irep = 0;
+#endif
+}
@@ -89,6 +89,7 @@ a 'using namespace std;' has been applied to and with:
 #include <assert.h>
 #include <vector>
 #include <memory>
+#include <atomic>
 
 #ifdef WIN32
 #include <io.h>
@@ -240,6 +241,91 @@ TClass::ENewType &TClass__GetCallingNew() {
    return fgCallingNew;
 }
 
+namespace {
+
+// Incremented, under gInterpreterMutex, whenever a TClass is added to or
+// removed from the list of classes: this invalidates the per-thread caches
+// of the lookups of TClass::GetClass.
+std::atomic<UInt_t> gClassLookupGeneration(0);
+
+////////////////////////////////////////////////////////////////////////////////
+/// Per-thread cache of the TClass found by TClass::GetClass, by name and by
+/// type_info, so that the lookup of a known class does not take
+/// gInterpreterMutex. Only the classes found under their own (normalized)
+/// name and already loaded are cached, i.e. the ones GetClass returns
+/// without further work. The entries are only used while the generation
+/// of the list of classes is the one at which they were added.
+
+struct TClassLookupCache {
+   enum { kSize = 128 };            // Number of entries, a power of two
+
+   UInt_t                 fGeneration;
+   UInt_t                 fHash[kSize];
+   TClass                *fByName[kSize];
+   const std::type_info  *fType[kSize];
+   TClass                *fByType[kSize];
+
+   TClassLookupCache() : fGeneration(0) { Reset(); }
+
+   void Reset()
+   {
+      memset(fByName, 0, sizeof(fByName));
+      memset(fByType, 0, sizeof(fByType));
+   }
+
+   void Validate()
+   {
+      UInt_t generation = gClassLookupGeneration.load(std::memory_order_acquire);
+      if (generation != fGeneration) {
+         Reset();
+         fGeneration = generation;
+      }
+   }
+
+   static Int_t TypeSlot(const std::type_info &type) { return Int_t((((ULong_t)&type) >> 4) & (kSize - 1)); }
+
+   TClass *Find(const char *name, UInt_t hash)
+   {
+      Validate();
+      Int_t i = hash & (kSize - 1);
+      if (fByName[i] && fHash[i] == hash && !strcmp(fByName[i]->GetName(), name)) return fByName[i];
+      return 0;
+   }
+
+   TClass *Find(const std::type_info &type)
+   {
+      Validate();
+      Int_t i = TypeSlot(type);
+      return (fByType[i] && fType[i] == &type) ? fByType[i] : 0;
+   }
+
+   // To be called with gInterpreterMutex held.
+   void Insert(UInt_t hash, TClass *cl)
+   {
+      Validate();
+      Int_t i = hash & (kSize - 1);
+      fHash[i]   = hash;
+      fByName[i] = cl;
+   }
+
+   // To be called with gInterpreterMutex held.
+   void Insert(const std::type_info &type, TClass *cl)
+   {
+      Validate();
+      Int_t i = TypeSlot(type);
+      fType[i]   = &type;
+      fByType[i] = cl;
+   }
+};
+
+TClassLookupCache &GetClassLookupCache()
+{
+   TTHREAD_TLS_DECL(TClassLookupCache, cache);
+   return cache;
+}
+
+} // anonymous namespace
+
 struct ObjRepoValue {
    ObjRepoValue(const TClass *what, Version_t version) : fClass(what),fVersion(version) {}
    const TClass *fClass;
@@ -463,6 +549,7 @@ void TClass::AddClass(TClass *cl)
    if (!cl) return;
 
    R__LOCKGUARD2(gInterpreterMutex);
+   gClassLookupGeneration++;
    gROOT->GetListOfClasses()->Add(cl);
    if (cl->GetTypeInfo()) {
       GetIdMap()->Add(cl->GetTypeInfo()->name(),cl);
@@ -489,6 +576,7 @@ void TClass::RemoveClass(TClass *oldcl)
    if (!oldcl) return;
 
    R__LOCKGUARD2(gInterpreterMutex);
+   gClassLookupGeneration++;
    gROOT->GetListOfClasses()->Remove(oldcl);
    if (oldcl->GetTypeInfo()) {
       GetIdMap()->Remove(oldcl->GetTypeInfo()->name());
@@ -2889,6 +2977,11 @@ TClass *TClass::GetClass(const char *name, Bool_t load, Bool_t silent)
    if (strncmp(name,"class ",6)==0) name += 6;
    if (strncmp(name,"struct ",7)==0) name += 7;
 
+   // Lock-free lookup of the classes already returned to this thread.
+   TClassLookupCache &cache = GetClassLookupCache();
+   UInt_t hash = ::Hash(name);
+   if (TClass *cached = cache.Find(name, hash)) return cached;
+
    R__LOCKGUARD(gInterpreterMutex);
 
    if (!gROOT->GetListOfClasses())  return 0;
@@ -2898,7 +2991,10 @@ TClass *TClass::GetClass(const char *name, Bool_t load, Bool_t silent)
    // Early return to release the lock without having to execute the
    // long-ish normalization.
    if (cl) {
-      if (cl->IsLoaded() || cl->TestBit(kUnloading)) return cl;
+      if (cl->IsLoaded() || cl->TestBit(kUnloading)) {
+         cache.Insert(hash, cl);
+         return cl;
+      }
 
       // We could speed-up some of the search by adding (the equivalent of)
       //
@@ -3064,6 +3160,10 @@ TClass *TClass::GetClass(const char *name, Bool_t load, Bool_t silent)
 
 TClass *TClass::GetClass(const std::type_info& typeinfo, Bool_t load, Bool_t /* silent */)
 {
+   // Lock-free lookup of the classes already returned to this thread.
+   TClassLookupCache &cache = GetClassLookupCache();
+   if (TClass *cached = cache.Find(typeinfo)) return cached;
+
    //protect access to TROOT::GetListOfClasses
    R__LOCKGUARD2(gInterpreterMutex);
 
@@ -3072,7 +3172,10 @@ TClass *TClass::GetClass(const std::type_info& typeinfo, Bool_t load, Bool_t /*
    TClass* cl = GetIdMap()->Find(typeinfo.name());
 
    if (cl) {
-      if (cl->IsLoaded()) return cl;
+      if (cl->IsLoaded()) {
+         cache.Insert(typeinfo, cl);
+         return cl;
+      }
       //we may pass here in case of a dummy class created by TVirtualStreamerInfo
       load = kTRUE;
    } else {
@@ -1048,6 +1048,7 @@ TCling::TCling(const char *name, const char *title)
    // rootcling also uses TCling for generating the dictionary ROOT files.
    bool fromRootCling = dlsym(RTLD_DEFAULT, "usedToIdentifyRootClingByDlSym");
 
+   ROOT::Internal::MarkStartupPhase(0);
    llvm::install_fatal_error_handler(&exceptionErrorHandler);
 
    fTemporaries = new std::vector<cling::Value>();
@@ -1109,6 +1110,7 @@ TCling::TCling(const char *name, const char *title)
    fInterpreter = new cling::Interpreter(interpArgs.size(),
                                          &(interpArgs[0]),
                                          llvmResourceDir.c_str());
+   ROOT::Internal::MarkStartupPhase("cling::Interpreter (PCH)");
 
    if (!fromRootCling) {
       fInterpreter->installLazyFunctionCreator(llvmLazyFunctionCreator);
@@ -1149,6 +1151,9 @@ TCling::TCling(const char *name, const char *title)
    fNormalizedCtxt = new ROOT::TMetaUtils::TNormalizedCtxt(fInterpreter->getLookupHelper());
    fLookupHelper = new ROOT::TMetaUtils::TClingLookupHelper(*fInterpreter, *fNormalizedCtxt, TClingLookupHelper__ExistingTypeCheck, TClingLookupHelper__AutoParse);
    TClassEdit::Init(fLookupHelper);
+   // The normalized names can be memoized: the cache is reset whenever
+   // declarations are added to or removed from the interpreter.
+   TClassEdit::EnableNameCache();
 
    // Initialize the cling interpreter interface.
    fMore      = 0;
@@ -2951,6 +2956,7 @@ Bool_t TCling::HandleNewTransaction(const cling::Transaction &T)
       || T.macros_begin() != T.macros_end()
       || ((!T.getFirstDecl().isNull()) && ((*T.getFirstDecl().begin()) != T.getWrapperFD()))) {
       fTransactionCount++;
+      TClassEdit::ResetNameCache();
       return true;
    }
    return false;
@@ -4605,21 +4611,46 @@ const char* TCling::TypeName(const char* typeDesc)
 
 int TCling::ReadRootmapFile(const char *rootmapfile, TUniqueString *uniqueString)
 {
-   // For "class ", "namespace ", "typedef ", "header ", "enum ", "var " respectively
-   const std::map<char, unsigned int> keyLenMap = {{'c',6},{'n',10},{'t',8},{'h',7},{'e',5},{'v',4}};
-
    if (rootmapfile && *rootmapfile) {
 
       // Add content of a specific rootmap file
       if (fRootmapFiles->FindObject(rootmapfile)) return -1;
-      std::ifstream file(rootmapfile);
+
+      // Read the whole file at once and split it in lines in memory: at
+      // startup all the rootmap files of the dynamic path are parsed.
+      std::string content;
+      {
+         std::ifstream file(rootmapfile, std::ios::in | std::ios::binary);
+         if (file) {
+            file.seekg(0, std::ios::end);
+            std::streamoff size = file.tellg();
+            if (size > 0) {
+               content.resize(size);
+               file.seekg(0, std::ios::beg);
+               file.read(&content[0], size);
+               content.resize(file.gcount());
+            }
+         }
+      }
+      size_t pos = 0;
+      auto nextLine = [&content, &pos](std::string &l) {
+         if (pos >= content.size()) {
+            l.clear();
+            return false;
+         }
+         size_t eol = content.find('\n', pos);
+         if (eol == std::string::npos) eol = content.size();
+         l.assign(content, pos, eol - pos);
+         pos = eol + 1;
+         return true;
+      };
+
       std::string line; line.reserve(200);
-      std::string lib_name; line.reserve(100);
+      std::string lib_name; lib_name.reserve(100);
       bool newFormat=false;
-      while (getline(file, line, '\n')) {
+      while (nextLine(line)) {
          if (!newFormat &&
              (strstr(line.c_str(),"Library.")!=nullptr || strstr(line.c_str(),"Declare.")!=nullptr)) {
-            file.close();
             return -3; // old format
          }
          newFormat=true;
@@ -4627,9 +4658,9 @@ int TCling::ReadRootmapFile(const char *rootmapfile, TUniqueString *uniqueString
          if (line.compare(0, 9, "{ decls }") == 0) {
             // forward declarations
 
-            while (getline(file, line, '\n')) {
+            while (nextLine(line)) {
                if (line[0] == '[') break;
-               uniqueString->Append(line);
+               if (uniqueString) uniqueString->Append(line);
             }
          }
          const char firstChar=line[0];
@@ -4657,9 +4688,18 @@ int TCling::ReadRootmapFile(const char *rootmapfile, TUniqueString *uniqueString
             }
          }
          else {
-            auto keyLenIt = keyLenMap.find(firstChar);
-            if (keyLenIt == keyLenMap.end()) continue;
-            unsigned int keyLen = keyLenIt->second;
+            // For "class ", "namespace ", "typedef ", "header ", "enum ", "var " respectively
+            unsigned int keyLen = 0;
+            switch (firstChar) {
+               case 'c': keyLen = 6; break;
+               case 'n': keyLen = 10; break;
+               case 't': keyLen = 8; break;
+               case 'h': keyLen = 7; break;
+               case 'e': keyLen = 5; break;
+               case 'v': keyLen = 4; break;
+               default: continue;
+            }
+            if (line.size() < keyLen) continue;
             // Do not make a copy, just start after the key
             const char *keyname = line.c_str()+keyLen;
             if (gDebug > 6)
@@ -4690,7 +4730,6 @@ int TCling::ReadRootmapFile(const char *rootmapfile, TUniqueString *uniqueString
             }
          }
       }
-      file.close();
    }
 
    return 0;
@@ -4788,6 +4827,8 @@ namespace {
 Int_t TCling::LoadLibraryMap(const char* rootmapfile)
 {
    R__LOCKGUARD(gInterpreterMutex);
+   ROOT::Internal::MarkStartupPhase(0);
+   Int_t nfiles = fRootmapFiles ? fRootmapFiles->GetEntriesFast() : 0;
    // open the [system].rootmap files
    if (!fMapfile) {
       fMapfile = new TEnv();
@@ -4941,6 +4982,9 @@ Int_t TCling::LoadLibraryMap(const char* rootmapfile)
       }
    }
 
+   ROOT::Internal::MarkStartupPhase("TCling::LoadLibraryMap: read rootmap files",
+                                    fRootmapFiles->GetEntriesFast() - nfiles);
+
    // Process the forward declarations collected
    cling::Transaction* T = nullptr;
    auto compRes= fInterpreter->declare(uniqueString.Data(), &T);
@@ -4963,6 +5007,7 @@ Int_t TCling::LoadLibraryMap(const char* rootmapfile)
          }
       }
    }
+   ROOT::Internal::MarkStartupPhase("TCling::LoadLibraryMap: rootmap forward declarations");
 
    // clear duplicates
 
@@ -6041,6 +6086,7 @@ void TCling::UpdateListsOnUnloaded(const cling::Transaction &T)
 // we need to make sure the next request for the same autoparse will be
 // honored.
 void TCling::TransactionRollback(const cling::Transaction &T) {
+   TClassEdit::ResetNameCache();
    auto const &triter = fTransactionHeadersMap.find(&T);
    if (triter != fTransactionHeadersMap.end()) {
       std::size_t normNameHash = triter->second;
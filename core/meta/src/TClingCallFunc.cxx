@@ -1437,12 +1437,172 @@ public:
    } u;
 };
 
+namespace {
+   // Conversions of the arguments and of the return value which are
+   // decided once per function by TClingCallFunc::cache_call_info(),
+   // instead of at each call from the declaration of the function.
+   enum EValueKind {
+      kVKNone,       // Not cached, converted from the declaration.
+      kVKVoid,
+      kVKBool,
+      kVKUChar,
+      kVKSChar,
+      kVKWCharU,
+      kVKWCharS,
+      kVKUShort,
+      kVKShort,
+      kVKUInt,
+      kVKInt,
+      kVKULong,
+      kVKLong,
+      kVKULongLong,
+      kVKLongLong,
+      kVKFloat,
+      kVKDouble,
+      kVKLongDouble,
+      kVKNullPtr,    // Argument only.
+      kVKPointer,    // Argument only: pointer, array or member pointer.
+      kVKAddress,    // Argument only: reference or record, passed by address.
+      kVKEnum        // Argument only, passed as int.
+   };
+
+   EValueKind builtin_kind(const BuiltinType *BT)
+   {
+      switch (BT->getKind()) {
+         case BuiltinType::Void:       return kVKVoid;
+         case BuiltinType::Bool:       return kVKBool;
+         case BuiltinType::Char_U:
+         case BuiltinType::UChar:      return kVKUChar;
+         case BuiltinType::WChar_U:    return kVKWCharU;
+         case BuiltinType::UShort:     return kVKUShort;
+         case BuiltinType::UInt:       return kVKUInt;
+         case BuiltinType::ULong:      return kVKULong;
+         case BuiltinType::ULongLong:  return kVKULongLong;
+         case BuiltinType::Char_S:
+         case BuiltinType::SChar:      return kVKSChar;
+         case BuiltinType::WChar_S:    return kVKWCharS;
+         case BuiltinType::Short:      return kVKShort;
+         case BuiltinType::Int:        return kVKInt;
+         case BuiltinType::Long:       return kVKLong;
+         case BuiltinType::LongLong:   return kVKLongLong;
+         case BuiltinType::Float:      return kVKFloat;
+         case BuiltinType::Double:     return kVKDouble;
+         case BuiltinType::LongDouble: return kVKLongDouble;
+         case BuiltinType::NullPtr:    return kVKNullPtr;
+         default:
+            // char16_t, char32_t, 128 bit integers, half: left to exec()
+            // which reports them.
+            return kVKNone;
+      }
+   }
+
+   EValueKind arg_kind(QualType QT)
+   {
+      QT = QT.getCanonicalType();
+      if (const BuiltinType *BT = dyn_cast<BuiltinType>(&*QT)) {
+         EValueKind kind = builtin_kind(BT);
+         return kind == kVKVoid ? kVKNone : kind;
+      }
+      if (QT->isReferenceType() || QT->isRecordType())
+         return kVKAddress;
+      if (QT->isPointerType() || QT->isArrayType() || QT->isMemberPointerType())
+         return kVKPointer;
+      if (isa<EnumType>(&*QT))
+         return kVKEnum;
+      return kVKNone;
+   }
+
+   EValueKind return_kind(QualType QT)
+   {
+      QT = QT.getCanonicalType();
+      if (const BuiltinType *BT = dyn_cast<BuiltinType>(&*QT)) {
+         EValueKind kind = builtin_kind(BT);
+         return kind == kVKNullPtr ? kVKNone : kind;
+      }
+      return kVKNone;
+   }
+
+   // Store an argument as exec() does for a parameter of the given kind.
+   void to_holder(unsigned char kind, const cling::Value &val, ValHolder &vh)
+   {
+      switch (kind) {
+         case kVKBool:       vh.u.b = (bool) sv_to_ulong_long(val); break;
+         case kVKUChar:      vh.u.uc = (unsigned char) sv_to_ulong_long(val); break;
+         case kVKSChar:      vh.u.sc = (signed char) sv_to_long_long(val); break;
+         case kVKWCharU:     vh.u.wc = (wchar_t) sv_to_ulong_long(val); break;
+         case kVKWCharS:     vh.u.wc = (wchar_t) sv_to_long_long(val); break;
+         case kVKUShort:     vh.u.us = (unsigned short) sv_to_ulong_long(val); break;
+         case kVKShort:      vh.u.s = (short) sv_to_long_long(val); break;
+         case kVKUInt:       vh.u.ui = (unsigned int) sv_to_ulong_long(val); break;
+         case kVKInt:        vh.u.i = (int) sv_to_long_long(val); break;
+         case kVKULong:      vh.u.ul = (unsigned long) sv_to_ulong_long(val); break;
+         case kVKLong:       vh.u.l = (long) sv_to_long_long(val); break;
+         case kVKULongLong:  vh.u.ull = (unsigned long long) sv_to_ulong_long(val); break;
+         case kVKLongLong:   vh.u.ll = (long long) sv_to_long_long(val); break;
+         case kVKFloat:      vh.u.flt = sv_to<float>(val); break;
+         case kVKDouble:     vh.u.dbl = sv_to<double>(val); break;
+         case kVKLongDouble: vh.u.ldbl = sv_to<long double>(val); break;
+         case kVKNullPtr:    vh.u.vp = val.getPtr(); break;
+         case kVKPointer:    vh.u.vp = (void *) sv_to_ulong_long(val); break;
+         case kVKEnum:       vh.u.i = (int) sv_to_long_long(val); break;
+      }
+   }
+
+   // Convert a returned value as exec_with_valref_return() followed by
+   // sv_to() do for a return type of the given kind.
+   template <typename T>
+   T from_holder(unsigned char kind, const ValHolder &vh)
+   {
+      switch (kind) {
+         case kVKBool:       return (T) (unsigned long long) vh.u.b;
+         case kVKUChar:      return (T) (unsigned long long) vh.u.c;
+         case kVKSChar:      return (T) (long long) vh.u.sc;
+         case kVKWCharU:
+         case kVKWCharS:     return (T) vh.u.wc;
+         case kVKUShort:     return (T) (unsigned long long) vh.u.us;
+         case kVKShort:      return (T) (long long) vh.u.s;
+         case kVKUInt:       return (T) (unsigned long long) vh.u.ui;
+         case kVKInt:        return (T) (long long) vh.u.i;
+         case kVKULong:      return (T) (unsigned long long) vh.u.ul;
+         case kVKLong:       return (T) (long long) vh.u.l;
+         case kVKULongLong:  return (T) vh.u.ull;
+         case kVKLongLong:   return (T) vh.u.ll;
+         case kVKFloat:      return (T) vh.u.flt;
+         case kVKDouble:     return (T) vh.u.dbl;
+         case kVKLongDouble: return (T) vh.u.ldbl;
+         default:            return (T) 0;
+      }
+   }
+} // unnamed namespace.
+
 void TClingCallFunc::exec(void *address, void *ret) const
 {
    SmallVector<ValHolder, 8> vh_ary;
    SmallVector<void *, 8> vp_ary;
 
    unsigned num_args = fArgVals.size();
+   if (fWrapper && num_args <= fArgKinds.size() && num_args >= fMinRequiredArgs
+       && (address || !fNeedsObject)) {
+      //
+      //  The conversions of the parameters were cached with the
+      //  wrapper, only the values are converted.
+      //
+      vh_ary.resize(num_args);
+      vp_ary.resize(num_args);
+      {
+         R__LOCKGUARD(gInterpreterMutex);
+         for (unsigned i = 0U; i < num_args; ++i) {
+            if (fArgKinds[i] == kVKAddress) {
+               vp_ary[i] = (void *) sv_to_ulong_long(fArgVals[i]);
+            } else {
+               to_holder(fArgKinds[i], fArgVals[i], vh_ary[i]);
+               vp_ary[i] = &vh_ary[i];
+            }
+         }
+      }
+      (*fWrapper)(address, (int)num_args, vp_ary.data(), ret);
+      return;
+   }
    {
       R__LOCKGUARD(gInterpreterMutex);
 
@@ -2031,6 +2191,12 @@ T TClingCallFunc::ExecT(void *address)
             "Called with no wrapper, not implemented!");
       return 0;
    }
+   if (fReturnKind != kVKNone) {
+      // Builtin return type, no need for a cling::Value.
+      ValHolder vh;
+      exec(address, fReturnKind == kVKVoid ? 0 : &vh);
+      return from_holder<T>(fReturnKind, vh);
+   }
    cling::Value ret;
    exec_with_valref_return(address, &ret);
    if (!ret.isValid()) {
@@ -2181,10 +2347,35 @@ void *TClingCallFunc::InterfaceMethod()
       } else {
          fWrapper = make_wrapper();
       }
+      cache_call_info();
    }
    return (void *)fWrapper;
 }
 
+void TClingCallFunc::cache_call_info()
+{
+   // Cache what the calls need to know about the current function, so that
+   // exec() and ExecT() do not inspect its declaration at each call.
+   // Called with the interpreter lock held, when the wrapper is set.
+   const FunctionDecl *FD = fMethod->GetMethodDecl();
+   const CXXMethodDecl *MD = dyn_cast<CXXMethodDecl>(FD);
+   fNeedsObject = MD && !MD->isStatic() && !isa<CXXConstructorDecl>(MD);
+   fMinRequiredArgs = FD->getMinRequiredArguments();
+
+   // Only the leading parameters with a cached conversion, calls with more
+   // arguments take the full path of exec().
+   fArgKinds.clear();
+   for (unsigned i = 0U, e = FD->getNumParams(); i < e; ++i) {
+      EValueKind kind = arg_kind(FD->getParamDecl(i)->getType());
+      if (kind == kVKNone)
+         break;
+      fArgKinds.push_back(kind);
+   }
+
+   fReturnIsRecordType = FD->getReturnType().getCanonicalType()->isRecordType();
+   fReturnKind = isa<CXXConstructorDecl>(FD) ? kVKNone : return_kind(FD->getReturnType());
+}
+
 bool TClingCallFunc::IsValid() const
 {
    if (!fMethod) {
@@ -2210,8 +2401,7 @@ TInterpreter::CallFuncIFacePtr_t TClingCallFunc::IFacePtr()
       } else {
          fWrapper = make_wrapper();
       }
-
-      fReturnIsRecordType = decl->getReturnType().getCanonicalType()->isRecordType();
+      cache_call_info();
    }
    return TInterpreter::CallFuncIFacePtr_t(fWrapper);
 }
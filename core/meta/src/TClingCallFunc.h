@@ -70,6 +70,14 @@ private:
    /// If true, do not limit number of function arguments to declared number.
    bool fIgnoreExtraArgs : 1;
    bool fReturnIsRecordType : 1;
+   /// The current function is a non-static member function.
+   bool fNeedsObject : 1;
+   /// Minimum number of arguments of the current function.
+   unsigned fMinRequiredArgs;
+   /// Conversions of the leading parameters and of the return value of
+   /// the current function, valid together with fWrapper.
+   llvm::SmallVector<unsigned char, 8> fArgKinds;
+   unsigned char fReturnKind;
 
 private:
    void* compile_wrapper(const std::string& wrapper_name,
@@ -98,6 +106,7 @@ private:
                                    std::ostringstream& buf, int indent_level);
 
    tcling_callfunc_Wrapper_t make_wrapper();
+   void cache_call_info();
 
    tcling_callfunc_ctor_Wrapper_t
    make_ctor_wrapper(const TClingClassInfo* info);
@@ -130,14 +139,15 @@ public:
    }
 
    explicit TClingCallFunc(cling::Interpreter *interp, const ROOT::TMetaUtils::TNormalizedCtxt &normCtxt)
-      : fInterp(interp), fNormCtxt(normCtxt), fWrapper(0), fIgnoreExtraArgs(false), fReturnIsRecordType(false)
+      : fInterp(interp), fNormCtxt(normCtxt), fWrapper(0), fIgnoreExtraArgs(false), fReturnIsRecordType(false),
+        fNeedsObject(false), fMinRequiredArgs(0), fReturnKind(0)
    {
       fMethod = new TClingMethodInfo(interp);
    }
 
    explicit TClingCallFunc(TClingMethodInfo &minfo, const ROOT::TMetaUtils::TNormalizedCtxt &normCtxt)
    : fInterp(minfo.GetInterpreter()), fNormCtxt(normCtxt), fWrapper(0), fIgnoreExtraArgs(false),
-     fReturnIsRecordType(false)
+     fReturnIsRecordType(false), fNeedsObject(false), fMinRequiredArgs(0), fReturnKind(0)
 
    {
       fMethod = new TClingMethodInfo(minfo);
@@ -145,7 +155,9 @@ public:
 
    TClingCallFunc(const TClingCallFunc &rhs)
       : fInterp(rhs.fInterp), fNormCtxt(rhs.fNormCtxt), fWrapper(rhs.fWrapper), fArgVals(rhs.fArgVals),
-        fIgnoreExtraArgs(rhs.fIgnoreExtraArgs), fReturnIsRecordType(rhs.fReturnIsRecordType)
+        fIgnoreExtraArgs(rhs.fIgnoreExtraArgs), fReturnIsRecordType(rhs.fReturnIsRecordType),
+        fNeedsObject(rhs.fNeedsObject), fMinRequiredArgs(rhs.fMinRequiredArgs), fArgKinds(rhs.fArgKinds),
+        fReturnKind(rhs.fReturnKind)
    {
       fMethod = new TClingMethodInfo(*rhs.fMethod);
    }
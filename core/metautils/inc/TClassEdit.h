@@ -152,6 +152,8 @@ namespace TClassEdit {
    };
 
    void        Init(TClassEdit::TInterpreterLookupHelper *helper);
+   void        EnableNameCache(bool enable = true);
+   void        ResetNameCache();
 
    std::string CleanType (const char *typeDesc,int mode = 0,const char **tail=0);
    bool        IsDefAlloc(const char *alloc, const char *classname);
@@ -14,9 +14,81 @@
 #include <memory>
 #include "RStringView.h"
 #include <algorithm>
+#include <atomic>
+#include "ThreadLocalStorage.h"
 
 namespace {
    static TClassEdit::TInterpreterLookupHelper *gInterpreterHelper = 0;
+
+   // The results of GetNormalizedName and ShortType are only memoized once
+   // enabled, when the lookup helper depends on the state of the interpreter
+   // (see EnableNameCache), and they are only used during the generation in
+   // which they were computed (see ResetNameCache).
+   std::atomic<bool>         gNameCacheEnabled(false);
+   std::atomic<unsigned int> gNameCacheGeneration(0);
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Per-thread memo of the results of TClassEdit::GetNormalizedName and
+   /// TClassEdit::ShortType, so that a lookup needs no lock. This is a direct
+   /// mapped table, bounded to kSize entries: a name replaces the previous
+   /// one of its slot.
+
+   struct TNameCache {
+      enum { kSize = 256 };             // Number of entries, a power of two
+      enum { kNormalizedName = -1 };    // Mode of the GetNormalizedName entries
+
+      struct TEntry {
+         bool         fValid;
+         int          fMode;
+         unsigned int fGeneration;
+         std::string  fName;
+         std::string  fResult;
+
+         TEntry() : fValid(false), fMode(0), fGeneration(0) {}
+      };
+
+      TEntry fEntries[kSize];
+
+      static unsigned int Hash(std::string_view name, int mode)
+      {
+         // FNV-1a
+         unsigned int hash = 2166136261u ^ (unsigned int)mode;
+         for (size_t i = 0; i < name.length(); ++i) {
+            hash ^= (unsigned char)name[i];
+            hash *= 16777619u;
+         }
+         return hash;
+      }
+
+      bool Find(std::string_view name, int mode, unsigned int generation, std::string &result) const
+      {
+         const TEntry &entry = fEntries[Hash(name, mode) & (kSize - 1)];
+         if (!entry.fValid || entry.fGeneration != generation || entry.fMode != mode || entry.fName != name)
+            return false;
+         result = entry.fResult;
+         return true;
+      }
+
+      void Insert(std::string &&name, int mode, unsigned int generation, const std::string &result)
+      {
+         TEntry &entry = fEntries[Hash(name, mode) & (kSize - 1)];
+         entry.fValid      = true;
+         entry.fMode       = mode;
+         entry.fGeneration = generation;
+         entry.fName       = std::move(name);
+         entry.fResult     = result;
+      }
+   };
+
+   // Return the cache of the calling thread, or 0 if the results may not be
+   // memoized.
+   TNameCache *GetNameCache()
+   {
+      if (gInterpreterHelper && !gNameCacheEnabled.load(std::memory_order_relaxed))
+         return 0;
+      TTHREAD_TLS_DECL(TNameCache, cache);
+      return &cache;
+   }
 }
 
 namespace std {} using namespace std;
@@ -119,6 +191,29 @@ TClassEdit::EComplexType TClassEdit::GetComplexType(const char* clName)
 void TClassEdit::Init(TClassEdit::TInterpreterLookupHelper *helper)
 {
    gInterpreterHelper = helper;
+   ResetNameCache();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Memoize the results of GetNormalizedName and ShortType even though the
+/// lookup helper is set. Whoever enables it must call ResetNameCache each
+/// time the answers of the helper may change, e.g. when declarations are
+/// added to or removed from the interpreter. Without a lookup helper the
+/// results only depend on the names and are always memoized.
+
+void TClassEdit::EnableNameCache(bool enable)
+{
+   gNameCacheEnabled = enable;
+   ResetNameCache();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Invalidate the memoized results of GetNormalizedName and ShortType of
+/// all the threads.
+
+void TClassEdit::ResetNameCache()
+{
+   gNameCacheGeneration.fetch_add(1, std::memory_order_acq_rel);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -787,7 +882,15 @@ bool TClassEdit::IsDefHash(const char *hashname, const char *classname)
 
 void TClassEdit::GetNormalizedName(std::string &norm_name, std::string_view name)
 {
-   norm_name = std::string(name); // NOTE: Is that the shortest version?
+   // The generation is read before the computation, which might change the
+   // state of the interpreter (e.g. autoparsing).
+   TNameCache *cache = GetNameCache();
+   unsigned int generation = gNameCacheGeneration.load(std::memory_order_acquire);
+   if (cache && cache->Find(name, TNameCache::kNormalizedName, generation, norm_name))
+      return;
+   std::string key(name);
+
+   norm_name = key; // NOTE: Is that the shortest version?
 
    // Remove the std:: and default template argument and insert the Long64_t and change basic_string to string.
    TClassEdit::TSplitType splitname(norm_name.c_str(),(TClassEdit::EModType)(TClassEdit::kLong64 | TClassEdit::kDropStd | TClassEdit::kDropStlDefault | TClassEdit::kKeepOuterConst));
@@ -809,6 +912,9 @@ void TClassEdit::GetNormalizedName(std::string &norm_name, std::string_view name
          if (!typeresult.empty()) norm_name = typeresult;
       }
    }
+
+   if (cache)
+      cache->Insert(std::move(key), TNameCache::kNormalizedName, generation, norm_name);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1198,8 +1304,16 @@ string TClassEdit::ShortType(const char *typeDesc, int mode)
 
    // get list of all arguments
    if (typeDesc) {
+      TNameCache *cache = GetNameCache();
+      unsigned int generation = gNameCacheGeneration.load(std::memory_order_acquire);
+      if (cache && cache->Find(typeDesc, mode, generation, answer))
+         return answer;
+
       TSplitType arglist(typeDesc, (EModType) mode);
       arglist.ShortType(answer, mode);
+
+      if (cache)
+         cache->Insert(typeDesc, mode, generation, answer);
    }
 
    return answer;
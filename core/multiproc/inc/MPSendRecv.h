@@ -38,6 +38,13 @@ using MPCodeBufPair = std::pair<unsigned, std::unique_ptr<TBufferFile>>;
 // to send a code and an object of any non-pointer type.
 int MPSend(TSocket *s, unsigned code);
 
+// Send a code and an object already serialized in objBuf, through the
+// socket or through a shared memory segment (see MPSetSharedMemoryThreshold).
+int MPSendBuffer(TSocket *s, unsigned code, const TBufferFile &objBuf);
+
+void MPSetSharedMemoryThreshold(ULong_t bytes);
+ULong_t MPGetSharedMemoryThreshold();
+
 template<class T, typename std::enable_if<std::is_class<T>::value>::type * = nullptr>
 int MPSend(TSocket *s, unsigned code, T obj);
 
@@ -97,11 +104,7 @@ int MPSend(TSocket *s, unsigned code, T obj)
    }
    TBufferFile objBuf(TBuffer::kWrite);
    objBuf.WriteObjectAny(&obj, c);
-   TBufferFile wBuf(TBuffer::kWrite);
-   wBuf.WriteUInt(code);
-   wBuf.WriteULong(objBuf.Length());
-   wBuf.WriteBuf(objBuf.Buffer(), objBuf.Length());
-   return s->SendRaw(wBuf.Buffer(), wBuf.Length());
+   return MPSendBuffer(s, code, objBuf);
 }
 
 /// \cond
@@ -137,13 +140,7 @@ int MPSend(TSocket *s, unsigned code, T obj)
    if(obj != nullptr)
       objBuf.WriteObjectAny(obj, obj->IsA());
 
-   //write everything together in a buffer
-   TBufferFile wBuf(TBuffer::kWrite);
-   wBuf.WriteUInt(code);
-   wBuf.WriteULong(objBuf.Length());
-   if(objBuf.Length())
-      wBuf.WriteBuf(objBuf.Buffer(), objBuf.Length());
-   return s->SendRaw(wBuf.Buffer(), wBuf.Length());
+   return MPSendBuffer(s, code, objBuf);
 }
 
 /// \endcond
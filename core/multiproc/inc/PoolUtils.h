@@ -36,12 +36,15 @@ namespace PoolCode {
       kSendResult,      ///< Ask for a kFuncResult/kProcResult
       /* TPool::Process */
       kProcFile,        ///< Tell a TPoolProcessor which tree to process. The object sent is a TreeInfo
-      kProcRange,       ///< Tell a TPoolProcessor which tree and entries range to process. The object sent is a TreeRangeInfo
-      kProcTree,        ///< Tell a TPoolProcessor to process the tree that was passed to it at construction time
+      kProcRange,       ///< Tell a TPoolProcessor which tree and entries range to process. The object sent is the index of a TMPPacket
+      kProcTree,        ///< Tell a TPoolProcessor to process the tree that was passed to it at construction time. The object sent is the index of a TMPPacket
       kProcSelector,    ///< Tell a TPoolProcessor to process the tree using the selector passed to it at construction time
       kProcResult,      ///< The message contains the result of the processing of a TTree
       kProcEnded,       ///< Tell the client we are done processing (i.e. we have reached the target number of entries to process)
       kProcError,       ///< Tell the client there was an error while processing
+      /* TPoolServer */
+      kExecTask,        ///< Execute the task contained in the message (see TPoolServer)
+      kProcPacket,      ///< Process a range of entries of a file with the selector named in the message (see TPoolServer)
    };
 
 }
@@ -22,8 +22,10 @@
 #include "TFileInfo.h"
 #include "THashList.h"
 #include "TMPClient.h"
+#include "TMPPacketizer.h"
 #include "ROOT/TExecutor.hxx"
 #include "TPoolProcessor.h"
+#include "TPoolServer.h"
 #include "TPoolWorker.h"
 #include "TSelector.h"
 #include "TTreeReader.h"
@@ -31,7 +33,8 @@
 #include <numeric> //std::iota
 #include <string>
 #include <type_traits> //std::result_of, std::enable_if
-#include <functional> //std::reference_wrapper
+#include <functional> //std::reference_wrapper, std::function
+#include <utility> //std::pair
 #include <vector>
 
 namespace ROOT {
@@ -71,18 +74,27 @@ public:
 
    void SetNWorkers(unsigned n) { TMPClient::SetNWorkers(n); }
    unsigned GetNWorkers() const { return TMPClient::GetNWorkers(); }
+   /// Results of at least bytes bytes are sent back by the workers through
+   /// POSIX shared memory instead of the sockets (0, the default, never).
+   /// This is a global setting, see MPSetSharedMemoryThreshold().
+   void SetSharedMemoryThreshold(ULong_t bytes) { MPSetSharedMemoryThreshold(bytes); }
+   ULong_t GetSharedMemoryThreshold() const { return MPGetSharedMemoryThreshold(); }
+   void SetPersistentWorkers(bool on = true);
+   bool GetPersistentWorkers() const { return fPersistent; }
+   void StopWorkers();
 
    template<class T, class R> T Reduce(const std::vector<T> &objs, R redfunc);
    using TExecutor<TProcessExecutor>::Reduce;
 
 private:
-   template<class T> void Collect(std::vector<T> &reslist);
+   template<class T> void Collect(std::vector<T> &reslist, bool activate = true);
    template<class T> void HandlePoolCode(MPCodeBufPair &msg, TSocket *sender, std::vector<T> &reslist);
 
    void FixLists(std::vector<TObject*> &lists);
    void Reset();
    void ReplyToFuncResult(TSocket *s);
    void ReplyToIdle(TSocket *s);
+   bool StartPackets(TMPWorker &worker, const std::vector<TMPPacket> &packets, unsigned code);
 
    unsigned fNProcessed; ///< number of arguments already passed to the workers
    unsigned fNToProcess; ///< total number of arguments to pass to the workers
@@ -94,11 +106,35 @@ private:
       kNoTask,   ///< no task is being executed
       kMap,          ///< a Map method with no arguments is being executed
       kMapWithArg,   ///< a Map method with arguments is being executed
-      kProcByRange,   ///< a ProcTree method is being executed and each worker will process a certain range of each file
+      kProcByRange,   ///< a ProcTree method is being executed and each worker will process certain ranges of the files
       kProcByFile,    ///< a ProcTree method is being executed and each worker will process a different file
+      kProcTreeByRange, ///< a ProcTree method is being executed on a tree and each worker will process a certain range of it
    };
 
    ETask fTaskType = ETask::kNoTask; ///< the kind of task that is being executed, if any
+
+   // persistent workers, see SetPersistentWorkers
+   using SendTask_t = std::function<bool(TSocket *, unsigned)>;
+   template<class F> static const void *CodeOf(F *func) { return (const void *)(Long_t)func; }
+   template<class F> static const void *CodeOf(const F &) { return nullptr; }
+   bool IsForked(const void *code) const;
+   bool StartServers(const void *code1, const void *code2 = nullptr);
+   template<class T> void RunOnServers(ETask task, unsigned nTasks, SendTask_t sendTask, std::vector<T> &reslist);
+   template<class F, class T> bool MapOnServers(F func, unsigned nTimes, std::vector<T> &reslist, std::true_type);
+   template<class F, class T> bool MapOnServers(F, unsigned, std::vector<T> &, std::false_type) { return false; }
+   template<class F, class A, class T> bool MapOnServers(F func, std::vector<A> &args, std::vector<T> &reslist, std::true_type);
+   template<class F, class A, class T> bool MapOnServers(F, std::vector<A> &, std::vector<T> &, std::false_type) { return false; }
+   template<class F> bool ProcOnServers(F procFunc, const std::vector<std::string> &fileNames, const std::string &treeName,
+                                        const std::vector<TMPPacket> &packets, std::vector<TObject *> &reslist, std::true_type);
+   template<class F> bool ProcOnServers(F, const std::vector<std::string> &, const std::string &,
+                                        const std::vector<TMPPacket> &, std::vector<TObject *> &, std::false_type) { return false; }
+   bool ProcOnServers(TSelector &selector, const std::vector<std::string> &fileNames, const std::string &treeName,
+                      const std::vector<TMPPacket> &packets, std::vector<TObject *> &reslist);
+
+   bool fPersistent = false; ///< true if the workers persist across calls, see SetPersistentWorkers
+   bool fServersUp = false; ///< true if the current workers are persistent TPoolServers
+   SendTask_t fSendTask; ///< function sending the next task of the call in progress to a TPoolServer, if any
+   std::vector<std::pair<ULong_t, ULong_t>> fServerCode; ///< address ranges of the code loaded when the TPoolServers were forked
 };
 
 
@@ -113,6 +149,15 @@ template<class F, class Cond>
 auto TProcessExecutor::Map(F func, unsigned nTimes) -> std::vector<typename std::result_of<F()>::type>
 {
    using retType = decltype(func());
+   if (fPersistent) {
+      std::vector<retType> reslist;
+      reslist.reserve(nTimes);
+      if (MapOnServers(func, nTimes, reslist, std::integral_constant<bool, TPoolServer::IsSendable<F>::value>()))
+         return reslist;
+      //func cannot be sent to the persistent workers, fork as usual
+      StopWorkers();
+   }
+
    //prepare environment
    Reset();
    fTaskType = ETask::kMap;
@@ -155,6 +200,16 @@ auto TProcessExecutor::Map(F func, std::vector<T> &args) -> std::vector<typename
 {
    //check whether func is callable
    using retType = decltype(func(args.front()));
+   if (fPersistent) {
+      std::vector<retType> reslist;
+      reslist.reserve(args.size());
+      using sendable = std::integral_constant<bool, TPoolServer::IsSendable<F>::value && (std::is_arithmetic<T>::value || std::is_class<T>::value)>;
+      if (MapOnServers(func, args, reslist, sendable()))
+         return reslist;
+      //func or args cannot be sent to the persistent workers, fork as usual
+      StopWorkers();
+   }
+
    //prepare environment
    Reset();
    fTaskType = ETask::kMapWithArg;
@@ -219,45 +274,30 @@ auto TProcessExecutor::ProcTree(const std::vector<std::string>& fileNames, F pro
    Reset();
    unsigned nWorkers = GetNWorkers();
 
-   //fork
-   TPoolProcessor<F> worker(procFunc, fileNames, treeName, nWorkers, nToProcess);
-   bool ok = Fork(worker);
-   if(!ok) {
-      Error("TProcessExecutor::ProcTree", "[E][C] Could not fork. Aborting operation.");
-      return nullptr;
-   }
-
-   if(fileNames.size() < nWorkers) {
-      //TTree entry granularity. For each file, we divide entries equally between workers
-      fTaskType = ETask::kProcByRange;
-      //Tell workers to start processing entries
-      fNToProcess = nWorkers*fileNames.size(); //this is the total number of ranges that will be processed by all workers cumulatively
-      std::vector<unsigned> args(nWorkers);
-      std::iota(args.begin(), args.end(), 0);
-      fNProcessed = Broadcast(PoolCode::kProcRange, args);
-      if(fNProcessed < nWorkers)
-         Error("TProcessExecutor::ProcTree", "[E][C] There was an error while sending tasks to workers. Some entries might not be processed.");
-   } else {
-      //file granularity. each worker processes one whole file as a single task
-      fTaskType = ETask::kProcByFile;
-      fNToProcess = fileNames.size();
-      std::vector<unsigned> args(nWorkers);
-      std::iota(args.begin(), args.end(), 0);
-      fNProcessed = Broadcast(PoolCode::kProcFile, args);
-      if(fNProcessed < nWorkers)
-         Error("TProcessExecutor::ProcTree", "[E][C] There was an error while sending tasks to workers. Some entries might not be processed.");
-   }
+   //split the entries in packets, to be handed out to the workers as they get idle
+   std::vector<TMPPacket> packets = TMPPacketizer::MakePackets(fileNames, treeName, nWorkers, nToProcess);
 
-   //collect results, distribute new tasks
+   //run on the persistent workers if possible, or fork and tell workers to
+   //start processing entries
    std::vector<TObject*> reslist;
-   Collect(reslist);
+   bool onServers = fPersistent && ProcOnServers(procFunc, fileNames, treeName, packets, reslist,
+                                                 std::integral_constant<bool, TPoolServer::IsSendable<F>::value>());
+   if (!onServers) {
+      TPoolProcessor<F> worker(procFunc, fileNames, treeName, nWorkers, 0);
+      if (!StartPackets(worker, packets, PoolCode::kProcRange))
+         return nullptr;
+
+      //collect results, distribute new tasks
+      Collect(reslist);
+   }
 
    //merge
    PoolUtils::ReduceObjects<TObject *> redfunc;
    auto res = redfunc(reslist);
 
    //clean-up and return
-   ReapWorkers();
+   if (!onServers)
+      ReapWorkers();
    fTaskType = ETask::kNoTask;
    return static_cast<retType>(res);
 }
@@ -306,24 +346,13 @@ auto TProcessExecutor::ProcTree(TTree& tree, F procFunc, ULong64_t nToProcess) -
    Reset();
    unsigned nWorkers = GetNWorkers();
 
-   //fork
-   TPoolProcessor<F> worker(procFunc, &tree, nWorkers, nToProcess);
-   bool ok = Fork(worker);
-   if(!ok) {
-      Error("TProcessExecutor::ProcTree", "[E][C] Could not fork. Aborting operation.");
-      return nullptr;
-   }
-
-   //divide entries equally between workers
-   fTaskType = ETask::kProcByRange;
+   //split the entries in packets, to be handed out to the workers as they get idle
+   std::vector<TMPPacket> packets = TMPPacketizer::MakePackets(tree, nWorkers, nToProcess);
 
-   //tell workers to start processing entries
-   fNToProcess = nWorkers; //this is the total number of ranges that will be processed by all workers cumulatively
-   std::vector<unsigned> args(nWorkers);
-   std::iota(args.begin(), args.end(), 0);
-   fNProcessed = Broadcast(PoolCode::kProcTree, args);
-   if(fNProcessed < nWorkers)
-      Error("TProcessExecutor::ProcTree", "[E][C] There was an error while sending tasks to workers. Some entries might not be processed.");
+   //fork and tell workers to start processing entries
+   TPoolProcessor<F> worker(procFunc, &tree, nWorkers, 0);
+   if (!StartPackets(worker, packets, PoolCode::kProcTree))
+      return nullptr;
 
    //collect results, distribute new tasks
    std::vector<TObject*> reslist;
@@ -353,7 +382,10 @@ void TProcessExecutor::HandlePoolCode(MPCodeBufPair &msg, TSocket *s, std::vecto
    } else if(code == PoolCode::kProcResult) {
       if(msg.second != nullptr)
          reslist.push_back(std::move(ReadBuffer<T>(msg.second.get())));
-      MPSend(s, MPCode::kShutdownOrder);
+      if (fServersUp)
+         DeActivate(s); //the worker is done for now
+      else
+         MPSend(s, MPCode::kShutdownOrder);
    } else if(code == PoolCode::kProcError) {
       const char *str = ReadBuffer<const char*>(msg.second.get());
       Error("TProcessExecutor::HandlePoolCode", "[E][C] a worker encountered an error: %s\n"
@@ -370,11 +402,14 @@ void TProcessExecutor::HandlePoolCode(MPCodeBufPair &msg, TSocket *s, std::vecto
 /// Listen for messages sent by the workers and call the appropriate handler function.
 /// TProcessExecutor::HandlePoolCode is called on messages with a code < 1000 and
 /// TMPClient::HandleMPCode is called on messages with a code >= 1000.
+/// If activate is false, only the workers whose sockets are already active
+/// are listened to.
 template<class T>
-void TProcessExecutor::Collect(std::vector<T> &reslist)
+void TProcessExecutor::Collect(std::vector<T> &reslist, bool activate)
 {
    TMonitor &mon = GetMonitor();
-   mon.ActivateAll();
+   if (activate)
+      mon.ActivateAll();
    while (mon.GetActive() > 0) {
       TSocket *s = mon.Select();
       MPCodeBufPair msg = MPRecv(s);
@@ -388,6 +423,94 @@ void TProcessExecutor::Collect(std::vector<T> &reslist)
    }
 }
 
+//////////////////////////////////////////////////////////////////////////
+/// Execute nTasks tasks on the persistent workers: each task is sent by
+/// sendTask, with its index, to a worker asking for work. The workers that
+/// are not given a first task stay deactivated during the call.
+template<class T>
+void TProcessExecutor::RunOnServers(ETask task, unsigned nTasks, SendTask_t sendTask, std::vector<T> &reslist)
+{
+   Reset();
+   fTaskType = task;
+   fNToProcess = nTasks;
+   fSendTask = sendTask;
+
+   TMonitor &mon = GetMonitor();
+   mon.ActivateAll();
+   std::unique_ptr<TList> lp(mon.GetListOfActives());
+   for (auto s : *lp) {
+      if (fNProcessed < fNToProcess && fSendTask((TSocket *)s, fNProcessed))
+         ++fNProcessed;
+      else
+         mon.DeActivate((TSocket *)s);
+   }
+   Collect(reslist, false);
+
+   fSendTask = nullptr;
+   fTaskType = ETask::kNoTask;
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Execute func nTimes on the persistent workers. Returns false if it
+/// cannot be executed by them, see SetPersistentWorkers.
+template<class F, class T>
+bool TProcessExecutor::MapOnServers(F func, unsigned nTimes, std::vector<T> &reslist, std::true_type)
+{
+   TPoolServer::Runner_t runner = &TPoolServer::RunFunc<F>;
+   if (!StartServers(CodeOf(runner), CodeOf(func)))
+      return false;
+   RunOnServers(ETask::kMap, nTimes, [&](TSocket *s, unsigned) {
+      TBufferFile buf(TBuffer::kWrite);
+      TPoolServer::WriteFunc(buf, runner, func);
+      return MPSendBuffer(s, PoolCode::kExecTask, buf) > 0;
+   }, reslist);
+   return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Execute func on each element of args on the persistent workers, each
+/// argument being sent with its task. Returns false if it cannot be
+/// executed by them, see SetPersistentWorkers.
+template<class F, class A, class T>
+bool TProcessExecutor::MapOnServers(F func, std::vector<A> &args, std::vector<T> &reslist, std::true_type)
+{
+   if (!args.empty()) {
+      TBufferFile test(TBuffer::kWrite);
+      if (!TPoolServer::WriteArg(test, args.front()))
+         return false;
+   }
+   TPoolServer::Runner_t runner = &TPoolServer::RunFuncWithArg<F, A>;
+   if (!StartServers(CodeOf(runner), CodeOf(func)))
+      return false;
+   RunOnServers(ETask::kMapWithArg, args.size(), [&](TSocket *s, unsigned n) {
+      TBufferFile buf(TBuffer::kWrite);
+      TPoolServer::WriteFunc(buf, runner, func);
+      TPoolServer::WriteArg(buf, args[n]);
+      return MPSendBuffer(s, PoolCode::kExecTask, buf) > 0;
+   }, reslist);
+   return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Process the packets of entries with procFunc on the persistent workers.
+/// Returns false if it cannot be executed by them, see SetPersistentWorkers.
+template<class F>
+bool TProcessExecutor::ProcOnServers(F procFunc, const std::vector<std::string> &fileNames, const std::string &treeName,
+                                     const std::vector<TMPPacket> &packets, std::vector<TObject *> &reslist, std::true_type)
+{
+   TPoolServer::Runner_t runner = &TPoolServer::RunProc<F>;
+   if (!StartServers(CodeOf(runner), CodeOf(procFunc)))
+      return false;
+   RunOnServers(ETask::kProcByRange, packets.size(), [&](TSocket *s, unsigned n) {
+      TBufferFile buf(TBuffer::kWrite);
+      TPoolServer::WriteFunc(buf, runner, procFunc);
+      const TMPPacket &packet = packets[n];
+      TPoolServer::WritePacket(buf, fileNames[packet.fFileN], treeName, packet.fStart, packet.fEnd);
+      return MPSendBuffer(s, PoolCode::kExecTask, buf) > 0;
+   }, reslist);
+   return true;
+}
+
 } // ROOT namespace
 
 #endif
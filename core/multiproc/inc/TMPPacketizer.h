@@ -0,0 +1,46 @@
+/* @(#)root/multiproc:$Id$ */
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TMPPacketizer
+#define ROOT_TMPPacketizer
+
+#include "Rtypes.h"
+#include <string>
+#include <vector>
+
+class TTree;
+
+//////////////////////////////////////////////////////////////////////////
+/// A range of entries of a tree, processed by a worker as one task.
+struct TMPPacket {
+   unsigned fFileN;  ///< index of the file in the list of files to process (0 for a tree passed as argument)
+   Long64_t fStart;  ///< first entry of the range
+   Long64_t fEnd;    ///< entry after the last one of the range, -1 for all the entries of the file
+};
+
+//////////////////////////////////////////////////////////////////////////
+/// Split the entries to be processed by TProcessExecutor::ProcTree into
+/// packets. The packets are computed by the client before forking, so that
+/// all the workers know them; the client then only sends the index of the
+/// next packet to each worker asking for work.
+class TMPPacketizer {
+public:
+   static std::vector<TMPPacket> MakePackets(const std::vector<std::string> &fileNames, const std::string &treeName,
+                                             unsigned nWorkers, ULong64_t nToProcess, bool byFile = false);
+   static std::vector<TMPPacket> MakePackets(TTree &tree, unsigned nWorkers, ULong64_t nToProcess);
+
+private:
+   static std::vector<Long64_t> GetClusterBoundaries(TTree &tree, Long64_t nEntries);
+   static void AddPackets(std::vector<TMPPacket> &packets, unsigned fileN, const std::vector<Long64_t> &boundaries,
+                          ULong64_t &nRemaining, unsigned nWorkers);
+};
+
+#endif
@@ -15,6 +15,7 @@
 #include "MPCode.h"
 #include "MPSendRecv.h" //MPCodeBufPair
 #include "PoolUtils.h"
+#include "TMPPacketizer.h"
 #include "TFile.h"
 #include "TKey.h"
 #include "TSysEvtHandler.h" //TFileHandler
@@ -45,6 +46,8 @@ public:
    TSocket *GetSocket() { return fS.get(); }
    pid_t GetPid() { return fPid; }
    unsigned GetNWorker() const { return fNWorker; }
+   /// Set the packets of entries whose indices are sent by the client
+   void SetPackets(const std::vector<TMPPacket> &packets) { fPackets = packets; }
 
 protected:
    std::string fId; ///< identifier string in the form W<nwrk>|P<proc id>
@@ -55,9 +58,11 @@ protected:
    unsigned fNWorkers; ///< the number of workers spawned
    ULong64_t fMaxNEntries; ///< the maximum number of entries to be processed by this worker
    ULong64_t fProcessedEntries; ///< the number of entries processed by this worker so far
+   std::vector<TMPPacket> fPackets; ///< the packets of entries to be processed by all workers (see TMPPacketizer)
 
    void   CloseFile();
    TFile *OpenFile(const std::string& fileName);
+   TTree *OpenTree(const std::string& fileName);
    TTree *RetrieveTree(TFile *fp);
    void   SendError(const std::string& errmsg, unsigned int code = MPCode::kError);
    void   Setup();
@@ -69,6 +74,8 @@ private:
    std::unique_ptr<TSocket> fS; ///< This worker's socket. The unique_ptr makes sure resources are released.
    pid_t fPid; ///< the PID of the process in which this worker is running
    unsigned fNWorker; ///< the ordinal number of this worker (0 to nWorkers-1)
+   std::string fFileName; ///< the name of the file opened by OpenTree
+   TTree *fFileTree; ///< the tree retrieved from it
 
 
    // TTree cache handling
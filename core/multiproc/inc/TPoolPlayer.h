@@ -39,6 +39,8 @@ class TPoolPlayer : public TMPWorker {
    private:
    void ProcTree(MPCodeBufPair& msg); ///< Run fSelector->Process over the tree entries, send back result
    void ProcDataSet(unsigned int code, MPCodeBufPair& msg); ///< Run fSelector->Process over a data set
+   const TMPPacket *GetPacket(MPCodeBufPair& msg); ///< Retrieve the packet of entries to process
+   void Process(TTree *tree, Long64_t start, Long64_t finish); ///< Run fSelector->Process over a range of entries
 
    TSelector &fSelector; ///< pointer to the selector to be used to process the tree. It is null if we are not using a TSelector.
    std::vector<std::string> fFileNames; ///< the files to be processed by all workers
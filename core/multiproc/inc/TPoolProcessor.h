@@ -135,74 +135,57 @@ void TPoolProcessor<F>::Init(int fd, unsigned workerN) {
 template<class F>
 void TPoolProcessor<F>::Process(unsigned code, MPCodeBufPair& msg)
 {
-   //evaluate the index of the file to process in fFileNames
-   //(we actually don't need the parameter if code == kProcTree)
+   //evaluate the file and the entries range to process: a whole file for
+   //kProcFile, a packet of entries (see TMPPacketizer) otherwise
    unsigned fileN = 0;
-   unsigned nProcessed = 0;
+   Long64_t start = 0;
+   Long64_t finish = -1;
    if (code == PoolCode::kProcRange || code == PoolCode::kProcTree) {
       if (code == PoolCode::kProcTree && !fTree) {
          // This must be defined
          Error("TPoolProcessor::Process", "[S]: Process:kProcTree fTree undefined!\n");
          return;
       }
-      //retrieve the total number of entries ranges processed so far by TPool
-      nProcessed = ReadBuffer<unsigned>(msg.second.get());
-      //evaluate the file and the entries range to process
-      fileN = nProcessed / fNWorkers;
+      //retrieve the index of the packet to process
+      unsigned packetN = ReadBuffer<unsigned>(msg.second.get());
+      if (packetN >= fPackets.size()) {
+         std::string reply = "S" + std::to_string(GetNWorker());
+         reply += ": no packet of entries with index " + std::to_string(packetN);
+         MPSend(GetSocket(), PoolCode::kProcError, reply.data());
+         return;
+      }
+      const TMPPacket &packet = fPackets[packetN];
+      fileN = packet.fFileN;
+      start = packet.fStart;
+      finish = packet.fEnd;
    } else {
-      //evaluate the file and the entries range to process
       fileN = ReadBuffer<unsigned>(msg.second.get());
    }
 
-   std::unique_ptr<TFile> fp;
    TTree *tree = nullptr;
-   if (code != PoolCode::kProcTree ||
-      (code == PoolCode::kProcTree && fTree->GetCurrentFile())) {
-      //open file
-     if (code == PoolCode::kProcTree && fTree->GetCurrentFile()) {
-         // Single tree from file: we need to reopen, because file descriptor gets invalidated across Fork
-         fp.reset(OpenFile(fTree->GetCurrentFile()->GetName()));
-      } else {
-         fp.reset(OpenFile(fFileNames[fileN]));
-      }
-      if (fp == nullptr) {
-         //errors are handled inside OpenFile
-         return;
-      }
-
-      //retrieve the TTree with the specified name from file
-      //we are not the owner of the TTree object, the file is!
-      tree = RetrieveTree(fp.get());
-      if(tree == nullptr) {
-         //errors are handled inside RetrieveTree
-         return;
-      }
-   } else {
+   if (code == PoolCode::kProcTree && !fTree->GetCurrentFile()) {
       // Tree in memory: OK
       tree = fTree;
+      // Setup the cache, if required
+      SetupTreeCache(tree);
+   } else {
+      //open the file, or keep it open if the previous packet was in the same
+      //file, and retrieve the tree: we are not the owner of the TTree object,
+      //the file is!
+      //A single tree from a file must be reopened, because the file
+      //descriptor gets invalidated across Fork
+      if (code == PoolCode::kProcTree)
+         tree = OpenTree(fTree->GetCurrentFile()->GetName());
+      else
+         tree = OpenTree(fFileNames[fileN]);
+      if (tree == nullptr) {
+         //errors are handled inside OpenTree
+         return;
+      }
    }
 
-   // Setup the cache, if required
-   SetupTreeCache(tree);
-
-   //create entries range
-   Long64_t start = 0;
-   Long64_t finish = 0;
-   if (code == PoolCode::kProcRange || code == PoolCode::kProcTree) {
-      //example: for 21 entries, 4 workers we want ranges 0-5, 5-10, 10-15, 15-21
-      //and this worker must take the rangeN-th range
-      unsigned nEntries = tree->GetEntries();
-      unsigned nBunch = nEntries / fNWorkers;
-      unsigned rangeN = nProcessed % fNWorkers;
-      start = rangeN*nBunch;
-      if(rangeN < (fNWorkers-1))
-         finish = (rangeN+1)*nBunch;
-      else
-         finish = nEntries;
-   } else {
-      start = 0;
+   if (finish < 0)
       finish = tree->GetEntries();
-   }
 
    //check if we are going to reach the max of entries
    //change finish accordingly
@@ -237,7 +220,7 @@ void TPoolProcessor<F>::Process(unsigned code, MPCodeBufPair& msg)
       fReducedResult = res;
    }
 
-   if(fMaxNEntries == fProcessedEntries)
+   if(fMaxNEntries && fMaxNEntries == fProcessedEntries)
       //we are done forever
       MPSend(GetSocket(), PoolCode::kProcResult, fReducedResult);
    else
@@ -0,0 +1,200 @@
+/* @(#)root/multiproc:$Id$ */
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TPoolServer
+#define ROOT_TPoolServer
+
+#include "MPCode.h"
+#include "MPSendRecv.h"
+#include "PoolUtils.h"
+#include "TBufferFile.h"
+#include "TClass.h"
+#include "TMPWorker.h"
+#include "TPoolProcessor.h" //DetachRes
+#include "TTreeReader.h"
+#include <map>
+#include <string>
+#include <type_traits>
+
+class TSelector;
+
+//////////////////////////////////////////////////////////////////////////
+///
+/// \class TPoolServer
+///
+/// The worker of a TProcessExecutor whose workers persist across calls
+/// (see TProcessExecutor::SetPersistentWorkers). Contrary to TPoolWorker,
+/// TPoolProcessor and TPoolPlayer, which are built with the task to execute
+/// before forking, a TPoolServer is forked once and receives each task in
+/// the message that asks for its execution:
+/// * PoolCode::kExecTask: the message holds the address of a runner, i.e.
+/// an instantiation of one of the Run* static methods for the type of the
+/// function to execute, followed by the bytes of the function object and by
+/// the arguments of the runner. The address is valid in the server since it
+/// is a fork of the client: the client only sends tasks whose runner is in a
+/// library loaded before forking, and functions that can be copied bytewise.
+/// * PoolCode::kProcPacket: the message holds the name of a TSelector, and
+/// the file, tree and range of entries to process with it.
+///
+/// The state of a server is kept from one task to the next: the selectors
+/// are created once per name, and the last file opened stays open, with its
+/// tree and TTreeCache, until a tree from another file is processed.
+///
+//////////////////////////////////////////////////////////////////////////
+
+class TPoolServer : public TMPWorker {
+public:
+   /// Signature of the functions executing a task sent with PoolCode::kExecTask
+   using Runner_t = void (*)(TPoolServer &server, TBufferFile &buf);
+
+   TPoolServer();
+   ~TPoolServer();
+
+   void HandleInput(MPCodeBufPair &msg); ///< Execute instructions received from a TProcessExecutor client
+
+   TTree *OpenTree(const std::string &fileName, const std::string &treeName);
+   TObject *GetResult() const { return fResult; }
+   void SetResult(TObject *res) { fResult = res; }
+
+   template<class F> static void WriteFunc(TBufferFile &buf, Runner_t runner, const F &func);
+   template<class F> static F ReadFunc(TBufferFile &buf);
+   template<class T, typename std::enable_if<std::is_class<T>::value>::type * = nullptr>
+   static bool WriteArg(TBufferFile &buf, const T &arg);
+   template<class T, typename std::enable_if<std::is_arithmetic<T>::value>::type * = nullptr>
+   static bool WriteArg(TBufferFile &buf, const T &arg);
+
+   template<class F> static void RunFunc(TPoolServer &server, TBufferFile &buf);
+   template<class F, class T> static void RunFuncWithArg(TPoolServer &server, TBufferFile &buf);
+   template<class F> static void RunProc(TPoolServer &server, TBufferFile &buf);
+
+   static void WritePacket(TBufferFile &buf, const std::string &fileName, const std::string &treeName, Long64_t start, Long64_t finish);
+   bool ReadPacket(TBufferFile &buf, TTree *&tree, Long64_t &start, Long64_t &finish);
+
+   /// True if the function objects of type F can be sent to a server, i.e.
+   /// if they can be copied bytewise
+   template<class F> struct IsSendable {
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ < 5
+      static constexpr bool value = __has_trivial_copy(F) && __has_trivial_destructor(F);
+#else
+      static constexpr bool value = std::is_trivially_copyable<F>::value;
+#endif
+   };
+
+private:
+   void ExecTask(MPCodeBufPair &msg);
+   void ProcPacket(MPCodeBufPair &msg);
+   void SendResult();
+
+   std::map<std::string, TSelector *> fSelectors; ///< the selectors created so far, by name
+   TSelector *fSelector; ///< the selector of the processing in progress, if any
+   TObject *fResult; ///< the result of the processing in progress, merged over the packets
+};
+
+
+/************ TEMPLATE METHODS IMPLEMENTATION ******************/
+
+//////////////////////////////////////////////////////////////////////////
+/// Write in buf the address of runner and the bytes of func, which must
+/// be sendable (see IsSendable).
+template<class F>
+void TPoolServer::WriteFunc(TBufferFile &buf, Runner_t runner, const F &func)
+{
+   static_assert(IsSendable<F>::value, "the function object must be trivially copyable to be sent to a TPoolServer");
+   buf.WriteULong64((ULong64_t)(Long_t)runner);
+   buf.WriteFastArray(reinterpret_cast<const Char_t *>(&func), sizeof(F));
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Read from buf the bytes of a function object written by WriteFunc, after
+/// the address of the runner.
+template<class F>
+F TPoolServer::ReadFunc(TBufferFile &buf)
+{
+   typename std::aligned_storage<sizeof(F), alignof(F)>::type storage;
+   buf.ReadFastArray(reinterpret_cast<Char_t *>(&storage), sizeof(F));
+   return *reinterpret_cast<F *>(&storage);
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Write in buf an argument of class type, as MPSend does. Returns false
+/// if it has no dictionary.
+template<class T, typename std::enable_if<std::is_class<T>::value>::type *>
+bool TPoolServer::WriteArg(TBufferFile &buf, const T &arg)
+{
+   TClass *c = TClass::GetClass(typeid(T));
+   if (!c)
+      return false;
+   buf.WriteObjectAny(&arg, c);
+   return true;
+}
+
+/// \cond
+template<class T, typename std::enable_if<std::is_arithmetic<T>::value>::type *>
+bool TPoolServer::WriteArg(TBufferFile &buf, const T &arg)
+{
+   buf << arg;
+   return true;
+}
+/// \endcond
+
+//////////////////////////////////////////////////////////////////////////
+/// Runner of a function without arguments: execute it and send back its
+/// result.
+template<class F>
+void TPoolServer::RunFunc(TPoolServer &server, TBufferFile &buf)
+{
+   F func = ReadFunc<F>(buf);
+   MPSend(server.GetSocket(), PoolCode::kFuncResult, func());
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Runner of a function with an argument of type T, which follows the
+/// function object in the message: execute it and send back its result.
+template<class F, class T>
+void TPoolServer::RunFuncWithArg(TPoolServer &server, TBufferFile &buf)
+{
+   F func = ReadFunc<F>(buf);
+   T arg = ReadBuffer<T>(&buf);
+   MPSend(server.GetSocket(), PoolCode::kFuncResult, func(arg));
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Runner of a function processing a TTreeReader, as in
+/// TProcessExecutor::ProcTree, on the packet of entries which follows the
+/// function object in the message. The result is merged with those of the
+/// previous packets, and sent back when the client asks for it.
+template<class F>
+void TPoolServer::RunProc(TPoolServer &server, TBufferFile &buf)
+{
+   F func = ReadFunc<F>(buf);
+   TTree *tree = nullptr;
+   Long64_t start = 0;
+   Long64_t finish = -1;
+   if (!server.ReadPacket(buf, tree, start, finish))
+      return; //errors are handled inside ReadPacket
+
+   TTreeReader reader(tree);
+   if (reader.SetEntriesRange(start, finish) != TTreeReader::kEntryValid) {
+      server.SendError("could not set TTreeReader to range " + std::to_string(start) + " " + std::to_string(finish), PoolCode::kProcError);
+      return;
+   }
+   auto res = func(reader);
+   DetachRes(res);
+   if (server.GetResult()) {
+      PoolUtils::ReduceObjects<TObject *> redfunc;
+      server.SetResult(redfunc({res, server.GetResult()}));
+   } else {
+      server.SetResult(res);
+   }
+   MPSend(server.GetSocket(), PoolCode::kIdling);
+}
+
+#endif
@@ -12,7 +12,71 @@
 #include "MPSendRecv.h"
 #include "TBufferFile.h"
 #include "MPCode.h"
+#include <atomic>
 #include <memory> //unique_ptr
+#include <stdio.h> //snprintf
+#include <string.h> //memcpy
+#include <fcntl.h> //O_* constants
+#include <sys/mman.h> //shm_open, mmap
+#include <unistd.h> //ftruncate, getpid
+
+namespace {
+
+/// Size sent in place of the size of the object when the object is in a
+/// shared memory segment; the size and the name of the segment follow.
+const ULong_t kMPSharedMemoryMarker = (ULong_t)-1;
+/// Size of the (null-padded) name of a shared memory segment in a message.
+const Int_t kMPSharedMemoryNameSize = 64;
+
+/// Objects of at least this size are sent through shared memory, 0 if never.
+std::atomic<ULong_t> gMPSharedMemoryThreshold(0);
+
+//////////////////////////////////////////////////////////////////////////
+/// Create a shared memory segment holding the len bytes of buf, whose
+/// name is written to name. Return false if the segment cannot be created.
+bool WriteSharedMemory(const char *buf, ULong_t len, char *name)
+{
+   static std::atomic<unsigned> counter(0);
+   snprintf(name, kMPSharedMemoryNameSize, "/ROOT_MP_%d_%u", (int)getpid(), counter++);
+   int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+   if (fd < 0)
+      return false;
+   bool ok = false;
+   if (ftruncate(fd, len) == 0) {
+      void *addr = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      if (addr != MAP_FAILED) {
+         memcpy(addr, buf, len);
+         munmap(addr, len);
+         ok = true;
+      }
+   }
+   close(fd);
+   if (!ok)
+      shm_unlink(name);
+   return ok;
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Copy the len bytes of the shared memory segment name into a new buffer
+/// and remove the segment. Return nullptr if the segment cannot be read.
+char *ReadSharedMemory(const char *name, ULong_t len)
+{
+   int fd = shm_open(name, O_RDONLY, 0);
+   if (fd < 0)
+      return nullptr;
+   char *buf = nullptr;
+   void *addr = mmap(nullptr, len, PROT_READ, MAP_SHARED, fd, 0);
+   if (addr != MAP_FAILED) {
+      buf = new char[len];
+      memcpy(buf, addr, len);
+      munmap(addr, len);
+   }
+   close(fd);
+   shm_unlink(name);
+   return buf;
+}
+
+} // anonymous namespace
 
 //////////////////////////////////////////////////////////////////////////
 /// Send a message with the specified code on the specified socket.
@@ -38,6 +102,66 @@ int MPSend(TSocket *s, unsigned code)
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+/// Send a message with a code and an object serialized in objBuf to
+/// socket s, to be received with MPRecv().
+/// The header of the message and the object are sent one after the other,
+/// without copying the object in a buffer holding the whole message. If
+/// the object is at least as large as MPGetSharedMemoryThreshold(), it is
+/// instead copied to a POSIX shared memory segment and only the name of
+/// the segment goes through the socket; the receiver removes the segment.
+/// \param s a pointer to a valid TSocket. No validity checks are performed\n
+/// \param code the code to be sent
+/// \param objBuf the serialized object, possibly empty
+/// \return the number of bytes sent through the socket, as per TSocket::SendRaw
+int MPSendBuffer(TSocket *s, unsigned code, const TBufferFile &objBuf)
+{
+   ULong_t len = objBuf.Length();
+   TBufferFile wBuf(TBuffer::kWrite);
+   wBuf.WriteUInt(code);
+
+   ULong_t threshold = gMPSharedMemoryThreshold;
+   if (len && threshold && len >= threshold) {
+      char name[kMPSharedMemoryNameSize] = {0};
+      if (WriteSharedMemory(objBuf.Buffer(), len, name)) {
+         wBuf.WriteULong(kMPSharedMemoryMarker);
+         wBuf.WriteULong(len);
+         wBuf.WriteFastArray(name, kMPSharedMemoryNameSize);
+         return s->SendRaw(wBuf.Buffer(), wBuf.Length());
+      }
+      // otherwise go through the socket
+   }
+
+   wBuf.WriteULong(len);
+   int nBytes = s->SendRaw(wBuf.Buffer(), wBuf.Length());
+   if (nBytes > 0 && len) {
+      int nObjBytes = s->SendRaw(objBuf.Buffer(), len);
+      nBytes = nObjBytes < 0 ? nObjBytes : nBytes + nObjBytes;
+   }
+   return nBytes;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+/// Send the objects of at least bytes bytes through POSIX shared memory
+/// segments instead of the sockets (see MPSendBuffer()). With 0, the
+/// default, the objects always go through the sockets. The setting is
+/// global to the process and is inherited by the workers forked afterwards.
+void MPSetSharedMemoryThreshold(ULong_t bytes)
+{
+   gMPSharedMemoryThreshold = bytes;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+/// Return the size from which the objects are sent through shared memory,
+/// 0 if they always go through the sockets.
+ULong_t MPGetSharedMemoryThreshold()
+{
+   return gMPSharedMemoryThreshold;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 /// Receive message from a socket.
 /// This standalone function can be used to read a message that
@@ -76,7 +200,24 @@ MPCodeBufPair MPRecv(TSocket *s)
 
    //receive object if needed
    std::unique_ptr<TBufferFile> objBuf; //defaults to nullptr
-   if (classBufSize != 0) {
+   if (classBufSize == kMPSharedMemoryMarker) {
+      //the object is in a shared memory segment, receive its size and name
+      const Int_t descSize = 8 + kMPSharedMemoryNameSize;
+      rawbuf = new char[descSize];
+      s->RecvRaw(rawbuf, descSize);
+      bufReader.SetBuffer(rawbuf, descSize, false);
+      char name[kMPSharedMemoryNameSize];
+      bufReader.ReadULong(classBufSize);
+      bufReader.ReadFastArray(name, kMPSharedMemoryNameSize);
+      delete [] rawbuf;
+      name[kMPSharedMemoryNameSize - 1] = 0;
+      char *classBuf = ReadSharedMemory(name, classBufSize);
+      if (!classBuf) {
+         Error("MPRecv", "[E] Could not read shared memory segment %s\n", name);
+         return std::make_pair(MPCode::kRecvError, nullptr);
+      }
+      objBuf.reset(new TBufferFile(TBuffer::kRead, classBufSize, classBuf, true)); //the buffer is deleted by TBuffer's dtor
+   } else if (classBufSize != 0) {
       char *classBuf = new char[classBufSize];
       s->RecvRaw(classBuf, classBufSize);
       objBuf.reset(new TBufferFile(TBuffer::kRead, classBufSize, classBuf, true)); //the buffer is deleted by TBuffer's dtor
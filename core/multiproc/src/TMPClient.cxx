@@ -11,11 +11,13 @@
 
 #include "MPCode.h"
 #include "TGuiFactory.h" //gGuiFactory
+#include "TEnv.h" //gEnv
 #include "TError.h" //gErrorIgnoreLevel
 #include "TMPClient.h"
 #include "TMPWorker.h"
 #include "TROOT.h" //gROOT
 #include "TSocket.h"
+#include "TStreamerInfo.h" //CompileAll
 #include "TSystem.h" //gSystem
 #include "TVirtualX.h" //gVirtualX
 #include <errno.h> //errno, used by socketpair
@@ -124,11 +126,18 @@ namespace ROOT {
 /// own class inheriting from TMPWorker. Behaviour can be customized
 /// overriding TMPWorker::HandleInput.
 /// \endparblock
+/// The StreamerInfos already known but not compiled yet are compiled before
+/// forking (see TStreamerInfo::CompileAll), so that the children share their
+/// actions sequences; this is disabled by setting the rootrc variable
+/// MultiProc.CompileStreamerInfo to 0.
 /// \return true if Fork succeeded, false otherwise
 bool TMPClient::Fork(TMPWorker &server)
 {
    std::string basePath = "/tmp/ROOTMP-";
 
+   if (gEnv->GetValue("MultiProc.CompileStreamerInfo", 1))
+      TStreamerInfo::CompileAll();
+
    //fork as many times as needed and save pids
    pid_t pid = 1; //must be positive to handle the case in which fNWorkers is 0
    int sockets[2]; //sockets file descriptors
@@ -0,0 +1,163 @@
+/* @(#)root/multiproc:$Id$ */
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "TMPPacketizer.h"
+#include "TFile.h"
+#include "TKey.h"
+#include "TTree.h"
+#include <algorithm> //std::lower_bound
+#include <memory> //unique_ptr
+#include <string.h> //strcmp
+
+//////////////////////////////////////////////////////////////////////////
+///
+/// \class TMPPacketizer
+///
+/// The packets are ranges of entries aligned on the clusters of the trees,
+/// so that no basket is read by two workers, and never span two files.
+/// Their size decreases as the processing goes on: each packet holds a
+/// fraction 1/(2*nWorkers) of the entries which remain to be processed when
+/// it is handed out. The first packets are large, keeping the overhead of
+/// the messages and of the tree cache small, and the last ones are small,
+/// so that all the workers end at about the same time even if the entries
+/// of some files are slower to process than others (as TPacketizerAdaptive
+/// does for PROOF). Since a packet only depends on the entries remaining,
+/// the sequence of packets can be computed in advance; the workers still
+/// get them dynamically, one at a time, whenever they are idle.
+///
+/// The number of entries and the clusters of each file are read by the
+/// client, which opens every file once before forking. A file which cannot
+/// be opened gives a single packet covering the whole file: the worker
+/// processing it reports the error. There is always at least one packet (if
+/// there is at least one file), so that a result is produced even when
+/// there are no entries.
+///
+//////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+//////////////////////////////////////////////////////////////////////////
+/// Retrieve the tree with the given name, or the first tree if the name is
+/// empty (as TMPWorker::RetrieveTree does).
+TTree *GetTree(TFile &f, const std::string &treeName)
+{
+   if (!treeName.empty())
+      return dynamic_cast<TTree *>(f.Get(treeName.c_str()));
+   TTree *tree = nullptr;
+   if (f.GetListOfKeys()) {
+      for (auto k : *f.GetListOfKeys()) {
+         TKey *key = static_cast<TKey *>(k);
+         if (!strcmp(key->GetClassName(), "TTree") || !strcmp(key->GetClassName(), "TNtuple"))
+            tree = static_cast<TTree *>(f.Get(key->GetName()));
+      }
+   }
+   return tree;
+}
+
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Make the packets of the trees named treeName in the files fileNames.
+/// At most nToProcess entries are processed (all of them if 0), taken from
+/// the first files. If byFile is true, each file is a single packet.
+std::vector<TMPPacket> TMPPacketizer::MakePackets(const std::vector<std::string> &fileNames,
+                                                  const std::string &treeName, unsigned nWorkers,
+                                                  ULong64_t nToProcess, bool byFile)
+{
+   // Look up the entries and the clusters of each file: -1 if unknown
+   unsigned nFiles = fileNames.size();
+   std::vector<Long64_t> nEntries(nFiles, -1);
+   std::vector<std::vector<Long64_t>> boundaries(nFiles);
+   ULong64_t nTotal = 0;
+   for (unsigned i = 0; i < nFiles; ++i) {
+      if (nToProcess && nTotal >= nToProcess) {
+         nFiles = i;
+         break;
+      }
+      std::unique_ptr<TFile> f(TFile::Open(fileNames[i].c_str()));
+      if (!f || f->IsZombie())
+         continue;
+      TTree *tree = GetTree(*f, treeName);
+      if (!tree)
+         continue;
+      Long64_t n = tree->GetEntries();
+      if (nToProcess && nTotal + n > nToProcess)
+         n = nToProcess - nTotal;
+      nEntries[i] = n;
+      nTotal += n;
+      if (byFile)
+         boundaries[i] = {0, n};
+      else
+         boundaries[i] = GetClusterBoundaries(*tree, n);
+   }
+
+   std::vector<TMPPacket> packets;
+   for (unsigned i = 0; i < nFiles; ++i) {
+      if (nEntries[i] < 0)
+         packets.push_back({i, 0, -1});
+      else
+         AddPackets(packets, i, boundaries[i], nTotal, byFile ? 1 : nWorkers);
+   }
+   if (packets.empty() && !fileNames.empty())
+      packets.push_back({0, 0, -1});
+   return packets;
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Make the packets of the first nToProcess entries of tree (all of them if
+/// 0).
+std::vector<TMPPacket> TMPPacketizer::MakePackets(TTree &tree, unsigned nWorkers, ULong64_t nToProcess)
+{
+   ULong64_t nTotal = tree.GetEntries();
+   if (nToProcess && nToProcess < nTotal)
+      nTotal = nToProcess;
+
+   std::vector<TMPPacket> packets;
+   AddPackets(packets, 0, GetClusterBoundaries(tree, nTotal), nTotal, nWorkers);
+   if (packets.empty())
+      packets.push_back({0, 0, -1});
+   return packets;
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Return the first entries of the clusters of the first nEntries entries
+/// of tree, followed by nEntries.
+std::vector<Long64_t> TMPPacketizer::GetClusterBoundaries(TTree &tree, Long64_t nEntries)
+{
+   std::vector<Long64_t> boundaries;
+   auto clusterIter = tree.GetClusterIterator(0);
+   Long64_t start;
+   while ((start = clusterIter.Next()) < nEntries)
+      boundaries.push_back(start);
+   boundaries.push_back(nEntries);
+   return boundaries;
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Add to packets the packets of file fileN, whose clusters start at the
+/// given boundaries. nRemaining, the number of entries of this file and of
+/// the following ones still to be put in packets, is updated.
+void TMPPacketizer::AddPackets(std::vector<TMPPacket> &packets, unsigned fileN,
+                               const std::vector<Long64_t> &boundaries, ULong64_t &nRemaining, unsigned nWorkers)
+{
+   const Long64_t nEntries = boundaries.back();
+   Long64_t start = 0;
+   while (start < nEntries) {
+      Long64_t size = nRemaining / (2 * nWorkers);
+      if (size < 1)
+         size = 1;
+      // end at the first cluster boundary at or after start + size
+      Long64_t end = *std::lower_bound(boundaries.begin(), boundaries.end(), std::min(start + size, nEntries));
+      packets.push_back({fileN, start, end});
+      nRemaining -= end - start;
+      start = end;
+   }
+}
@@ -56,7 +56,7 @@
 TMPWorker::TMPWorker()
           : fFileNames(), fTreeName(), fTree(nullptr), fFile(nullptr),
             fNWorkers(0), fMaxNEntries(0),
-            fProcessedEntries(0), fS(), fPid(0), fNWorker(0),
+            fProcessedEntries(0), fS(), fPid(0), fNWorker(0), fFileTree(nullptr),
             fTreeCache(0), fTreeCacheIsLearning(kFALSE),
             fUseTreeCache(kTRUE), fCacheSize(-1)
 {
@@ -68,7 +68,7 @@ TMPWorker::TMPWorker(const std::vector<std::string>& fileNames,
                      unsigned nWorkers, ULong64_t maxEntries)
           : fFileNames(fileNames), fTreeName(treeName), fTree(nullptr), fFile(nullptr),
             fNWorkers(nWorkers), fMaxNEntries(maxEntries),
-            fProcessedEntries(0), fS(), fPid(0), fNWorker(0),
+            fProcessedEntries(0), fS(), fPid(0), fNWorker(0), fFileTree(nullptr),
             fTreeCache(0), fTreeCacheIsLearning(kFALSE),
             fUseTreeCache(kTRUE), fCacheSize(-1)
 {
@@ -78,7 +78,7 @@ TMPWorker::TMPWorker(const std::vector<std::string>& fileNames,
 TMPWorker::TMPWorker(TTree *tree, unsigned nWorkers, ULong64_t maxEntries)
           : fFileNames(), fTreeName(), fTree(tree), fFile(nullptr),
             fNWorkers(nWorkers), fMaxNEntries(maxEntries),
-            fProcessedEntries(0), fS(), fPid(0), fNWorker(0),
+            fProcessedEntries(0), fS(), fPid(0), fNWorker(0), fFileTree(nullptr),
             fTreeCache(0), fTreeCacheIsLearning(kFALSE),
             fUseTreeCache(kTRUE), fCacheSize(-1)
 {
@@ -174,9 +174,12 @@ void TMPWorker::CloseFile()
    // Avoid destroying the cache; must be placed before deleting the trees
    if (fFile) {
       if (fTree) fFile->SetCacheRead(0, fTree);
+      if (fFileTree) fFile->SetCacheRead(0, fFileTree);
       delete fFile ;
       fFile = 0;
    }
+   fFileName.clear();
+   fFileTree = nullptr;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -198,6 +201,36 @@ TFile *TMPWorker::OpenFile(const std::string& fileName)
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+/// Return the tree to be processed in file fileName. The file stays open
+/// (as fFile) until a tree from another file is asked for, so that the
+/// packets of entries of a file processed in a row do not open it again.
+
+TTree *TMPWorker::OpenTree(const std::string& fileName)
+{
+   if (fFile && fFileTree && fileName == fFileName)
+      return fFileTree;
+
+   CloseFile();
+   fFile = OpenFile(fileName);
+   if (fFile == nullptr) {
+      //errors are handled inside OpenFile
+      return nullptr;
+   }
+   fFileTree = RetrieveTree(fFile);
+   if (fFileTree == nullptr) {
+      //errors are handled inside RetrieveTree
+      CloseFile();
+      return nullptr;
+   }
+   fFileName = fileName;
+
+   // Setup the cache, if required
+   SetupTreeCache(fFileTree);
+   return fFileTree;
+}
+
+
 //////////////////////////////////////////////////////////////////////////
 /// Retrieve a tree from an open file.
 
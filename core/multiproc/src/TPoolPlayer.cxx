@@ -30,90 +30,37 @@ void TPoolPlayer::HandleInput(MPCodeBufPair& msg)
 
 void TPoolPlayer::ProcDataSet(unsigned int code, MPCodeBufPair& msg)
 {
-   //evaluate the index of the file to process in fFileNames
-   //(we actually don't need the parameter if code == kProcTree)
+   //evaluate the file and the entries range to process: a whole file for
+   //kProcFile, a packet of entries (see TMPPacketizer) for kProcRange
    unsigned fileN = 0;
-   unsigned nProcessed = 0;
+   Long64_t start = 0;
+   Long64_t finish = -1;
 
    if (code == PoolCode::kProcRange) {
-      //retrieve the total number of entries ranges processed so far by TPool
-      nProcessed = ReadBuffer<unsigned>(msg.second.get());
-      //evaluate the file and the entries range to process
-      fileN = nProcessed / fNWorkers;
+      //retrieve the index of the packet to process
+      const TMPPacket *packet = GetPacket(msg);
+      if (packet == nullptr)
+         return;
+      fileN = packet->fFileN;
+      start = packet->fStart;
+      finish = packet->fEnd;
    } else {
-      //evaluate the file and the entries range to process
       fileN = ReadBuffer<unsigned>(msg.second.get());
    }
 
-   // Open the file
-   fFile = OpenFile(fFileNames[fileN]);
-   if (fFile == nullptr) {
-      //errors are handled inside OpenFile
-      std::string errmsg = "unable to open file " + fFileNames[fileN];
-      SendError(errmsg);
-      return;
-   }
-
-   //retrieve the TTree with the specified name from file
-   //we are not the owner of the TTree object, the file is!
-   TTree *tree = RetrieveTree(fFile);
+   //open the file, or keep it open if the previous packet was in the same
+   //file, and retrieve the tree: we are not the owner of the TTree object,
+   //the file is!
+   TTree *tree = OpenTree(fFileNames[fileN]);
    if (tree == nullptr) {
-      //errors are handled inside RetrieveTree
-      std::string errmsg = "unable to retrieve tree from open file " + fFileNames[fileN];
-      SendError(errmsg);
+      //errors are handled inside OpenTree
       return;
    }
-   if (tree != fTree) {
-      // Setup the cache, if required
-      SetupTreeCache(tree);
-   }
-   // Store as reference
-   fTree = tree;
 
-
-   //create entries range
-   Long64_t start = 0;
-   Long64_t finish = 0;
-   if (code == PoolCode::kProcRange) {
-      //example: for 21 entries, 4 workers we want ranges 0-5, 5-10, 10-15, 15-21
-      //and this worker must take the rangeN-th range
-      unsigned nEntries = tree->GetEntries();
-      unsigned nBunch = nEntries / fNWorkers;
-      if(nEntries % fNWorkers) nBunch++;
-      unsigned rangeN = nProcessed % fNWorkers;
-      start = rangeN*nBunch + 1;
-      if(rangeN < (fNWorkers-1))
-         finish = (rangeN+1)*nBunch;
-      else
-         finish = nEntries;
-   } else {
-      start = 0;
+   if (finish < 0)
       finish = tree->GetEntries();
-   }
-
-   //check if we are going to reach the max of entries
-   //change finish accordingly
-   if (fMaxNEntries)
-      if (fProcessedEntries + finish - start > fMaxNEntries)
-         finish = start + fMaxNEntries - fProcessedEntries;
-
-   if(fFirstEntry){
-     fSelector.SlaveBegin(nullptr);
-     fFirstEntry = false;
-   }
-
-   fSelector.Init(tree);
-   fSelector.Notify();
-   for(Long64_t entry = start; entry<finish; ++entry) {
-      fSelector.Process(entry);
-   }
 
-   //update the number of processed entries
-   fProcessedEntries += finish - start;
-
-   MPSend(GetSocket(), PoolCode::kIdling);
-
-   return;
+   Process(tree, start, finish);
 }
 
 void TPoolPlayer::ProcTree(MPCodeBufPair& msg)
@@ -126,53 +73,52 @@ void TPoolPlayer::ProcTree(MPCodeBufPair& msg)
       return;
    }
 
-   //evaluate the index of the file to process in fFileNames
-   //(we actually don't need the parameter if code == kProcTree)
-   unsigned nProcessed = 0;
-   //retrieve the total number of entries ranges processed so far by TPool
-   nProcessed = ReadBuffer<unsigned>(msg.second.get());
-
-   //create entries range
-   Long64_t start = 0;
-   Long64_t finish = 0;
-   //example: for 21 entries, 4 workers we want ranges 0-5, 5-10, 10-15, 15-21
-   //and this worker must take the rangeN-th range
-   unsigned nEntries = fTree->GetEntries();
-   unsigned nBunch = nEntries / fNWorkers;
-   unsigned rangeN = nProcessed % fNWorkers;
-   start = rangeN*nBunch + 1;
-   if(rangeN < (fNWorkers-1))
-      finish = (rangeN+1)*nBunch;
-   else
-      finish = nEntries;
-
-   //check if we are going to reach the max of entries
-   //change finish accordingly
-   if (fMaxNEntries)
-      if (fProcessedEntries + finish - start > fMaxNEntries)
-         finish = start + fMaxNEntries - fProcessedEntries;
+   //retrieve the index of the packet to process
+   const TMPPacket *packet = GetPacket(msg);
+   if (packet == nullptr)
+      return;
 
    //process tree
    TTree *tree = fTree;
-   CloseFile(); // May not be needed
    if (fTree->GetCurrentFile()) {
       // We need to reopen the file locally (TODO: to understand and fix this)
-      if ((fFile = TFile::Open(fTree->GetCurrentFile()->GetName())) && !fFile->IsZombie()) {
-         if (!(tree = (TTree *) fFile->Get(fTree->GetName()))) {
-            std::string errmsg = "unable to retrieve tree from open file " +
-                                 std::string(fTree->GetCurrentFile()->GetName());
-            SendError(errmsg);
-         }
-         fTree = tree;
-      } else {
-         //errors are handled inside OpenFile
-         std::string errmsg = "unable to open file " + std::string(fTree->GetCurrentFile()->GetName());
-         SendError(errmsg);
+      // It stays open for the next packets
+      tree = OpenTree(fTree->GetCurrentFile()->GetName());
+      if (tree == nullptr) {
+         //errors are handled inside OpenTree
+         return;
       }
+   } else {
+      // Setup the cache, if required
+      SetupTreeCache(tree);
    }
 
-   // Setup the cache, if required
-   SetupTreeCache(fTree);
+   Process(tree, packet->fStart, packet->fEnd < 0 ? tree->GetEntries() : packet->fEnd);
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Return the packet whose index is in msg, or null (after sending an
+/// error to the client) if there is no such packet.
+const TMPPacket *TPoolPlayer::GetPacket(MPCodeBufPair& msg)
+{
+   unsigned packetN = ReadBuffer<unsigned>(msg.second.get());
+   if (packetN >= fPackets.size()) {
+      SendError("no packet of entries with index " + std::to_string(packetN), PoolCode::kProcError);
+      return nullptr;
+   }
+   return &fPackets[packetN];
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Run fSelector->Process over the entries [start, finish) of tree and tell
+/// the client that we are idle.
+void TPoolPlayer::Process(TTree *tree, Long64_t start, Long64_t finish)
+{
+   //check if we are going to reach the max of entries
+   //change finish accordingly
+   if (fMaxNEntries)
+      if (fProcessedEntries + finish - start > fMaxNEntries)
+         finish = start + fMaxNEntries - fProcessedEntries;
 
    if(fFirstEntry){
      fSelector.SlaveBegin(nullptr);
@@ -181,7 +127,6 @@ void TPoolPlayer::ProcTree(MPCodeBufPair& msg)
 
    fSelector.Init(tree);
    fSelector.Notify();
-
    for(Long64_t entry = start; entry<finish; ++entry) {
       fSelector.Process(entry);
    }
@@ -190,6 +135,4 @@ void TPoolPlayer::ProcTree(MPCodeBufPair& msg)
    fProcessedEntries += finish - start;
 
    MPSend(GetSocket(), PoolCode::kIdling);
-
-   return;
 }
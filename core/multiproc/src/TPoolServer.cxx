@@ -0,0 +1,170 @@
+/* @(#)root/multiproc:$Id$ */
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "TPoolServer.h"
+#include "TList.h"
+#include "TSelector.h"
+
+//////////////////////////////////////////////////////////////////////////
+/// Class constructor. As for the other workers, the members that depend
+/// on the forked process are set by TMPWorker::Init.
+TPoolServer::TPoolServer() : TMPWorker(), fSelectors(), fSelector(nullptr), fResult(nullptr)
+{
+}
+
+TPoolServer::~TPoolServer()
+{
+   for (auto &sel : fSelectors)
+      delete sel.second;
+   delete fResult;
+}
+
+void TPoolServer::HandleInput(MPCodeBufPair &msg)
+{
+   unsigned code = msg.first;
+
+   if (code == PoolCode::kExecTask) {
+      ExecTask(msg);
+   } else if (code == PoolCode::kProcPacket) {
+      ProcPacket(msg);
+   } else if (code == PoolCode::kSendResult) {
+      SendResult();
+   } else {
+      //unknown code received
+      SendError("unknown code received: " + std::to_string(code));
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Return the tree treeName of file fileName, keeping the file open as
+/// TMPWorker::OpenTree does if the previous task processed the same tree.
+TTree *TPoolServer::OpenTree(const std::string &fileName, const std::string &treeName)
+{
+   if (treeName != fTreeName) {
+      CloseFile();
+      fTreeName = treeName;
+   }
+   return TMPWorker::OpenTree(fileName);
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Write in buf the description of a packet of entries, to be read by
+/// ReadPacket. A negative finish stands for the end of the tree.
+void TPoolServer::WritePacket(TBufferFile &buf, const std::string &fileName, const std::string &treeName, Long64_t start, Long64_t finish)
+{
+   buf.WriteStdString(&fileName);
+   buf.WriteStdString(&treeName);
+   buf.WriteLong64(start);
+   buf.WriteLong64(finish);
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Read from buf the description of a packet of entries and open its tree.
+/// Returns false, after sending an error to the client, if the tree cannot
+/// be opened.
+bool TPoolServer::ReadPacket(TBufferFile &buf, TTree *&tree, Long64_t &start, Long64_t &finish)
+{
+   std::string fileName, treeName;
+   buf.ReadStdString(&fileName);
+   buf.ReadStdString(&treeName);
+   buf.ReadLong64(start);
+   buf.ReadLong64(finish);
+
+   //we are not the owner of the TTree object, the file is!
+   tree = OpenTree(fileName, treeName);
+   if (tree == nullptr) {
+      //errors are handled inside OpenTree
+      return false;
+   }
+   if (finish < 0)
+      finish = tree->GetEntries();
+   return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Execute the task of a kExecTask message by calling its runner.
+void TPoolServer::ExecTask(MPCodeBufPair &msg)
+{
+   if (!msg.second) {
+      SendError("empty task received", PoolCode::kProcError);
+      return;
+   }
+   ULong64_t address = 0;
+   msg.second->ReadULong64(address);
+   Runner_t runner = (Runner_t)(Long_t)address;
+   runner(*this, *msg.second);
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Process a packet of entries with the selector named in the message.
+/// The first packet of a processing also holds the input list of the
+/// selector, which is then initialized with SlaveBegin.
+void TPoolServer::ProcPacket(MPCodeBufPair &msg)
+{
+   TBufferFile &buf = *msg.second;
+   std::string name;
+   buf.ReadStdString(&name);
+   UChar_t first = 0;
+   buf.ReadUChar(first);
+
+   if (first) {
+      TSelector *&sel = fSelectors[name];
+      if (!sel)
+         sel = TSelector::GetSelector(name.c_str());
+      if (!sel) {
+         fSelectors.erase(name);
+         SendError("could not create selector " + name, PoolCode::kProcError);
+         return;
+      }
+      TList *input = (TList *)buf.ReadObjectAny(TList::Class());
+      delete sel->GetInputList();
+      sel->SetInputList(input);
+      sel->GetOutputList()->Delete();
+      fSelector = sel;
+      fSelector->SlaveBegin(nullptr);
+   }
+   if (!fSelector) {
+      SendError("no selector to process the entries with", PoolCode::kProcError);
+      return;
+   }
+
+   TTree *tree = nullptr;
+   Long64_t start = 0;
+   Long64_t finish = -1;
+   if (!ReadPacket(buf, tree, start, finish))
+      return; //errors are handled inside ReadPacket
+
+   fSelector->Init(tree);
+   fSelector->Notify();
+   for (Long64_t entry = start; entry < finish; ++entry)
+      fSelector->Process(entry);
+
+   MPSend(GetSocket(), PoolCode::kIdling);
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Send the result of the processing in progress, and forget it: the
+/// server is then ready for the next call of the client.
+void TPoolServer::SendResult()
+{
+   if (fSelector) {
+      fSelector->SlaveTerminate();
+      MPSend(GetSocket(), PoolCode::kProcResult, fSelector->GetOutputList());
+      fSelector->GetOutputList()->Delete();
+      fSelector = nullptr;
+   } else if (fResult) {
+      MPSend(GetSocket(), PoolCode::kProcResult, fResult);
+      delete fResult;
+      fResult = nullptr;
+   } else {
+      MPSend(GetSocket(), PoolCode::kProcResult);
+   }
+}
@@ -12,6 +12,13 @@
 #include "TEnv.h"
 #include "ROOT/TProcessExecutor.hxx"
 #include "TPoolPlayer.h"
+#include <set>
+#if defined(__APPLE__)
+#include <dlfcn.h> //dladdr
+#include <mach-o/dyld.h> //_dyld_get_image_header
+#elif defined(__linux__)
+#include <link.h> //dl_iterate_phdr
+#endif
 
 //////////////////////////////////////////////////////////////////////////
 ///
@@ -82,6 +89,34 @@
 /// root[] TProcessExecutor pool; auto hist = pool.MapReduce(CreateAndFillHists, 10, PoolUtils::ReduceObjects);
 /// ~~~
 ///
+/// ###Persistent workers
+/// By default each call forks the workers, which exit at the end of the
+/// call. After SetPersistentWorkers(), the workers are forked by the first
+/// call and wait for the tasks of the next calls (see TPoolServer), which
+/// saves the cost of forking on each call and keeps the state of each
+/// worker: the files opened by ProcTree stay open with their TTreeCache, and
+/// the static variables of the executed functions keep their value.
+/// Since the workers are a copy of the session at the time of the first call,
+/// only tasks whose code was loaded at that time can be sent to them:
+/// * Map and ProcTree with a function compiled in a library or an executable,
+/// and a function object that can be copied bytewise (e.g. a lambda
+/// capturing values, but no std::function). The function object is copied
+/// to the workers at each call: **it must not refer to objects created after
+/// the first call, e.g. to local variables captured by reference**;
+/// * Map with arguments of arithmetic types or of classes with a dictionary,
+/// which are streamed to the workers;
+/// * ProcTree with a TSelector whose class has a compiled dictionary: the
+/// workers create their own instance of the selector class, and get a copy
+/// of the input list of selector.
+/// The other calls stop the persistent workers and fork new ones as usual.
+/// StopWorkers() stops them explicitly, e.g. to take into account the changes
+/// of the session since the first call.
+///
+/// ~~~{.cpp}
+/// root[] TProcessExecutor pool; pool.SetPersistentWorkers();
+/// root[] for (int i = 0; i < 100; ++i) results[i] = pool.Map([i](int a) { return a + i; }, {1, 2, 3});
+/// ~~~
+///
 //////////////////////////////////////////////////////////////////////////
 
 namespace ROOT {
@@ -103,25 +138,13 @@ TList* TProcessExecutor::ProcTree(TTree& tree, TSelector& selector, ULong64_t nT
    unsigned nWorkers = GetNWorkers();
    selector.Begin(nullptr);
 
-   //fork
-   TPoolPlayer worker(selector, &tree, nWorkers, nToProcess/nWorkers);
-   bool ok = Fork(worker);
-   if(!ok) {
-      Error("TProcessExecutor::ProcTree", "[E][C] Could not fork. Aborting operation");
-      return nullptr;
-   }
+   //split the entries in packets, to be handed out to the workers as they get idle
+   std::vector<TMPPacket> packets = TMPPacketizer::MakePackets(tree, nWorkers, nToProcess);
 
-   //divide entries equally between workers
-   fTaskType = ETask::kProcByRange;
-
-   //tell workers to start processing entries
-   fNToProcess = nWorkers; //this is the total number of ranges that will be processed by all workers cumulatively
-   std::vector<unsigned> args(nWorkers);
-   std::iota(args.begin(), args.end(), 0);
-   fNProcessed = Broadcast(PoolCode::kProcTree, args);
-   if (fNProcessed < nWorkers)
-      Error("TProcessExecutor::ProcTree", "[E][C] There was an error while sending tasks to workers."
-                                   " Some entries might not be processed.");
+   //fork and tell workers to start processing entries
+   TPoolPlayer worker(selector, &tree, nWorkers, 0);
+   if (!StartPackets(worker, packets, PoolCode::kProcTree))
+      return nullptr;
 
    //collect results, distribute new tasks
    std::vector<TObject*> outLists;
@@ -158,55 +181,23 @@ TList* TProcessExecutor::ProcTree(const std::vector<std::string>& fileNames, TSe
    unsigned nWorkers = GetNWorkers();
    selector.Begin(nullptr);
 
-   //fork
-   TPoolPlayer worker(selector, fileNames, treeName, nWorkers, nToProcess);
-   bool ok = Fork(worker);
-   if (!ok) {
-      Error("TProcessExecutor::ProcTree", "[E][C] Could not fork. Aborting operation");
-      return nullptr;
-   }
-
+   //split the entries in packets, to be handed out to the workers as they get idle
+   //(with MultiProc.TestProcByFile, each file is a single packet)
    Int_t procByFile = gEnv->GetValue("MultiProc.TestProcByFile", 0);
+   std::vector<TMPPacket> packets = TMPPacketizer::MakePackets(fileNames, treeName, nWorkers, nToProcess, procByFile);
 
-   if (procByFile) {
-      if (fileNames.size() < nWorkers) {
-         // TTree entry granularity: for each file, we divide entries equally between workers
-         fTaskType = ETask::kProcByRange;
-         // Tell workers to start processing entries
-         fNToProcess = nWorkers*fileNames.size(); //this is the total number of ranges that will be processed by all workers cumulatively
-         std::vector<unsigned> args(nWorkers);
-         std::iota(args.begin(), args.end(), 0);
-         fNProcessed = Broadcast(PoolCode::kProcRange, args);
-         if (fNProcessed < nWorkers)
-            Error("TProcessExecutor::ProcTree", "[E][C] There was an error while sending tasks to workers."
-                                         " Some entries might not be processed");
-      } else {
-         // File granularity: each worker processes one whole file as a single task
-         fTaskType = ETask::kProcByFile;
-         fNToProcess = fileNames.size();
-         std::vector<unsigned> args(nWorkers);
-         std::iota(args.begin(), args.end(), 0);
-         fNProcessed = Broadcast(PoolCode::kProcFile, args);
-         if (fNProcessed < nWorkers)
-            Error("TProcessExecutor::ProcTree", "[E][C] There was an error while sending tasks to workers."
-                                         " Some entries might not be processed.");
-      }
-   } else {
-      // TTree entry granularity: for each file, we divide entries equally between workers
-      fTaskType = ETask::kProcByRange;
-      // Tell workers to start processing entries
-      fNToProcess = nWorkers*fileNames.size(); //this is the total number of ranges that will be processed by all workers cumulatively
-      std::vector<unsigned> args(nWorkers);
-      std::iota(args.begin(), args.end(), 0);
-      fNProcessed = Broadcast(PoolCode::kProcRange, args);
-      if (fNProcessed < nWorkers)
-         Error("TProcessExecutor::ProcTree", "[E][C] There was an error while sending tasks to workers."
-                                      " Some entries might not be processed.");
-   }
-
-   // collect results, distribute new tasks
+   //run on the persistent workers if possible, or fork and tell workers to
+   //start processing entries
    std::vector<TObject*> outLists;
-   Collect(outLists);
+   bool onServers = fPersistent && ProcOnServers(selector, fileNames, treeName, packets, outLists);
+   if (!onServers) {
+      TPoolPlayer worker(selector, fileNames, treeName, nWorkers, 0);
+      if (!StartPackets(worker, packets, PoolCode::kProcRange))
+         return nullptr;
+
+      // collect results, distribute new tasks
+      Collect(outLists);
+   }
 
    // The first element must be a TList instead of a TSelector List, to avoid duplicate problems with merging
    FixLists(outLists);
@@ -224,7 +215,8 @@ TList* TProcessExecutor::ProcTree(const std::vector<std::string>& fileNames, TSe
    selector.Terminate();
 
    //clean-up and return
-   ReapWorkers();
+   if (!onServers)
+      ReapWorkers();
    fTaskType = ETask::kNoTask;
    return outList;
 
@@ -279,6 +271,41 @@ void TProcessExecutor::FixLists(std::vector<TObject*> &lists) {
    delete oldlist;
 }
 
+//////////////////////////////////////////////////////////////////////////
+/// Fork the workers of a ProcTree method, at most one per packet of
+/// entries, and send them the first packets; code is kProcRange for a list
+/// of files and kProcTree for a tree passed as argument. The other packets
+/// are sent by ReplyToIdle to the workers done with their packet, so that
+/// the fastest workers process more entries.
+bool TProcessExecutor::StartPackets(TMPWorker &worker, const std::vector<TMPPacket> &packets, unsigned code)
+{
+   //the persistent workers, if any, cannot run this
+   StopWorkers();
+   worker.SetPackets(packets);
+
+   //fork min(packets.size(), fNWorkers) times
+   unsigned oldNWorkers = GetNWorkers();
+   if (packets.size() < oldNWorkers)
+      SetNWorkers(packets.size());
+   unsigned nWorkers = GetNWorkers();
+   bool ok = Fork(worker);
+   SetNWorkers(oldNWorkers);
+   if (!ok) {
+      Error("TProcessExecutor::ProcTree", "[E][C] Could not fork. Aborting operation.");
+      return false;
+   }
+
+   fTaskType = code == PoolCode::kProcTree ? ETask::kProcTreeByRange : ETask::kProcByRange;
+   fNToProcess = packets.size(); //this is the total number of packets that will be processed by all workers cumulatively
+   std::vector<unsigned> args(nWorkers);
+   std::iota(args.begin(), args.end(), 0);
+   fNProcessed = Broadcast(code, args);
+   if (fNProcessed < nWorkers)
+      Error("TProcessExecutor::ProcTree", "[E][C] There was an error while sending tasks to workers."
+                                   " Some entries might not be processed.");
+   return true;
+}
+
 //////////////////////////////////////////////////////////////////////////
 /// Reset TProcessExecutor's state.
 void TProcessExecutor::Reset()
@@ -297,12 +324,19 @@ void TProcessExecutor::ReplyToFuncResult(TSocket *s)
 {
    if (fNProcessed < fNToProcess) {
       //this cannot be a "greedy worker" task
-      if (fTaskType == ETask::kMap)
+      if (fSendTask) {
+         if (!fSendTask(s, fNProcessed)) {
+            DeActivate(s);
+            return;
+         }
+      } else if (fTaskType == ETask::kMap)
          MPSend(s, PoolCode::kExecFunc);
       else if (fTaskType == ETask::kMapWithArg)
          MPSend(s, PoolCode::kExecFuncWithArg, fNProcessed);
       ++fNProcessed;
-   } else //whatever the task is, we are done
+   } else if (fServersUp) //whatever the task is, we are done for now
+      DeActivate(s);
+   else //whatever the task is, we are done
       MPSend(s, MPCode::kShutdownOrder);
 }
 
@@ -315,7 +349,12 @@ void TProcessExecutor::ReplyToIdle(TSocket *s)
 {
    if (fNProcessed < fNToProcess) {
       //we are executing a "greedy worker" task
-      if (fTaskType == ETask::kMapWithArg)
+      if (fSendTask) {
+         if (!fSendTask(s, fNProcessed)) {
+            MPSend(s, PoolCode::kSendResult);
+            return;
+         }
+      } else if (fTaskType == ETask::kMapWithArg)
          MPSend(s, PoolCode::kExecFuncWithArg, fNProcessed);
       else if (fTaskType == ETask::kMap)
          MPSend(s, PoolCode::kExecFunc);
@@ -323,9 +362,140 @@ void TProcessExecutor::ReplyToIdle(TSocket *s)
          MPSend(s, PoolCode::kProcRange, fNProcessed);
       else if (fTaskType == ETask::kProcByFile)
          MPSend(s, PoolCode::kProcFile, fNProcessed);
+      else if (fTaskType == ETask::kProcTreeByRange)
+         MPSend(s, PoolCode::kProcTree, fNProcessed);
       ++fNProcessed;
    } else
       MPSend(s, PoolCode::kSendResult);
 }
 
+//////////////////////////////////////////////////////////////////////////
+/// Keep the workers alive across calls if on is true, see the class
+/// description. Turning it off stops the persistent workers.
+void TProcessExecutor::SetPersistentWorkers(bool on)
+{
+   fPersistent = on;
+   if (!on)
+      StopWorkers();
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Stop the persistent workers, if any: the next call forks new ones.
+void TProcessExecutor::StopWorkers()
+{
+   if (!fServersUp)
+      return;
+   fServersUp = false;
+   fServerCode.clear();
+
+   Broadcast(MPCode::kShutdownOrder);
+   TMonitor &mon = GetMonitor();
+   mon.ActivateAll();
+   while (mon.GetActive() > 0) {
+      TSocket *s = mon.Select();
+      MPCodeBufPair msg = MPRecv(s);
+      if (msg.first == MPCode::kRecvError)
+         Remove(s);
+      else if (msg.first >= 1000)
+         HandleMPCode(msg, s); //removes the socket on kShutdownNotice
+   }
+   ReapWorkers();
+}
+
+#if defined(__linux__)
+namespace {
+   int AddCodeRanges(struct dl_phdr_info *info, size_t, void *data)
+   {
+      auto ranges = static_cast<std::vector<std::pair<ULong_t, ULong_t>> *>(data);
+      for (int i = 0; i < info->dlpi_phnum; ++i) {
+         const auto &phdr = info->dlpi_phdr[i];
+         if (phdr.p_type == PT_LOAD && (phdr.p_flags & PF_X)) {
+            ULong_t start = info->dlpi_addr + phdr.p_vaddr;
+            ranges->push_back(std::make_pair(start, start + phdr.p_memsz));
+         }
+      }
+      return 0;
+   }
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+/// True if code belongs to a library or executable that was loaded when
+/// the persistent workers were forked, i.e. if it can be called by them.
+/// Code compiled by the interpreter is not.
+bool TProcessExecutor::IsForked(const void *code) const
+{
+   ULong_t address = (ULong_t)code;
+#if defined(__APPLE__)
+   Dl_info info;
+   if (!dladdr(code, &info))
+      return false;
+   address = (ULong_t)info.dli_fbase;
+#endif
+   for (const auto &range : fServerCode) {
+      if (address >= range.first && address < range.second)
+         return true;
+   }
+   return false;
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Fork the persistent workers if they are not running, or if their number
+/// changed, and check that they can execute code1 and code2 (if not null).
+/// Returns false if they cannot, or if they could not be forked.
+bool TProcessExecutor::StartServers(const void *code1, const void *code2)
+{
+   TMonitor &mon = GetMonitor();
+   if (!fServersUp || (unsigned)(mon.GetActive() + mon.GetDeActive()) != GetNWorkers()) {
+      StopWorkers();
+      fServerCode.clear();
+#if defined(__APPLE__)
+      for (uint32_t i = 0; i < _dyld_image_count(); ++i) {
+         ULong_t header = (ULong_t)_dyld_get_image_header(i);
+         fServerCode.push_back(std::make_pair(header, header + 1));
+      }
+#elif defined(__linux__)
+      dl_iterate_phdr(AddCodeRanges, &fServerCode);
+#endif
+      if (fServerCode.empty())
+         return false;
+
+      TPoolServer server;
+      if (!Fork(server)) {
+         Error("TProcessExecutor::StartServers", "[E][C] Could not fork. Aborting operation.");
+         ReapWorkers();
+         return false;
+      }
+      fServersUp = true;
+   }
+   return IsForked(code1) && (!code2 || IsForked(code2));
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Process the packets of entries with selector on the persistent workers,
+/// each creating its own instance of the selector class. Returns false if
+/// the class has no compiled dictionary loaded when the workers were forked.
+bool TProcessExecutor::ProcOnServers(TSelector &selector, const std::vector<std::string> &fileNames, const std::string &treeName,
+                                     const std::vector<TMPPacket> &packets, std::vector<TObject *> &reslist)
+{
+   TClass *cl = selector.IsA();
+   if (!cl || !cl->GetNew() || !StartServers((const void *)(Long_t)cl->GetNew()))
+      return false;
+
+   std::string name = cl->GetName();
+   std::set<TSocket *> started;
+   RunOnServers(ETask::kProcByRange, packets.size(), [&](TSocket *s, unsigned n) {
+      TBufferFile buf(TBuffer::kWrite);
+      buf.WriteStdString(&name);
+      bool first = started.insert(s).second;
+      buf.WriteUChar(first);
+      if (first)
+         buf.WriteObjectAny(selector.GetInputList(), TList::Class());
+      const TMPPacket &packet = packets[n];
+      TPoolServer::WritePacket(buf, fileNames[packet.fFileN], treeName, packet.fStart, packet.fEnd);
+      return MPSendBuffer(s, PoolCode::kProcPacket, buf) > 0;
+   }, reslist);
+   return true;
+}
+
 } // namespace ROOT
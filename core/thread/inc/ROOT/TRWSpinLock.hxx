@@ -14,6 +14,7 @@
 #define ROOT_TRWSpinLock
 
 #include "TSpinMutex.hxx"
+#include "ROOT/TLockStats.hxx"
 
 #include <atomic>
 #include <condition_variable>
@@ -33,6 +34,7 @@ namespace ROOT {
       ////////////////////////////////////////////////////////////////////////
       /// Regular constructor.
       TRWSpinLock() : fReaders(0), fReaderReservation(0), fWriterReservation(0), fWriter(false) {}
+      explicit TRWSpinLock(const char *name);
 
       void ReadLock();
       void ReadUnLock();
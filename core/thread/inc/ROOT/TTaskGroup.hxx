@@ -0,0 +1,75 @@
+// @(#)root/thread:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TTaskGroup
+#define ROOT_TTaskGroup
+
+#include "RConfigure.h"
+
+// exclude in case ROOT does not have IMT support
+#ifndef R__USE_IMT
+// No need to error out for dictionaries.
+# if !defined(__ROOTCLING__) && !defined(G__DICTIONARY)
+#  error "Cannot use ROOT::TTaskGroup without defining R__USE_IMT."
+# endif
+#else
+
+#include <functional>
+#include <memory>
+
+namespace tbb { class task_group; }
+
+namespace ROOT {
+
+   /**
+    * \class ROOT::TTaskGroup
+    * \brief A group of tasks run asynchronously by the threads of implicit multi-threading.
+    * \ingroup Multicore
+    * Run() submits a task and returns immediately; Wait() blocks until all
+    * the tasks of the group are done, the calling thread helping to run
+    * them. The tasks run in the pool of threads of implicit
+    * multi-threading, so that they share its threads (as many as given to
+    * ROOT::EnableImplicitMT) with the other parallel operations of ROOT.
+    * If implicit multi-threading is not enabled when the group is created,
+    * the tasks are run sequentially, by Run() itself.
+    * For example, to write the output of an event while the next one is
+    * processed:
+    * ~~~ {.cpp}
+    * ROOT::EnableImplicitMT();
+    * ROOT::TTaskGroup tg;
+    * for (auto &file : files) {
+    *    tg.Wait();    // the previous output is written
+    *    Process(file, output);
+    *    tg.Run([&output]() { output.Write(); });
+    * }
+    * tg.Wait();
+    * ~~~
+    */
+   class TTaskGroup {
+   public:
+      TTaskGroup();
+      TTaskGroup(const TTaskGroup &) = delete;
+      TTaskGroup &operator=(const TTaskGroup &) = delete;
+      ~TTaskGroup();
+
+      void Run(const std::function<void(void)> &closure);
+      void Wait();
+      void Cancel();
+      bool IsAsynchronous() const { return fTaskGroup != nullptr; }
+
+   private:
+      std::unique_ptr<tbb::task_group> fTaskGroup; ///< The TBB task group, null if the tasks run sequentially
+   };
+
+} // namespace ROOT
+
+#endif   // R__USE_IMT
+#endif   // ROOT_TTaskGroup
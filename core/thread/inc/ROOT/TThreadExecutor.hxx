@@ -70,7 +70,25 @@ public:
    auto MapReduce(F func, std::vector<T> &args, R redfunc, unsigned nChunks) -> typename std::result_of<F(T)>::type;
    // /// \endcond
    using TExecutor<TThreadExecutor>::MapReduce;
-   
+
+   // Foreach
+   // like Map, but the results of func, if any, are discarded and no vector is allocated
+   template<class F>
+   void Foreach(F func, unsigned nTimes);
+   template<class F, class INTEGER>
+   void Foreach(F func, ROOT::TSeq<INTEGER> args);
+   /// \cond
+   template<class F, class T>
+   void Foreach(F func, std::initializer_list<T> args);
+   template<class F, class T>
+   void Foreach(F func, std::vector<T> &args);
+   /// \endcond
+
+   void     SetGrainSize(unsigned grainSize);
+   unsigned GetGrainSize() const { return fGrainSize; }
+   void     SetTaskArena(unsigned concurrency);
+   unsigned GetTaskArenaConcurrency() const;
+
   template<class T, class BINARYOP> auto Reduce(const std::vector<T> &objs, BINARYOP redfunc) -> decltype(redfunc(objs.front(), objs.front()));
   template<class T, class R> auto Reduce(const std::vector<T> &objs, R redfunc) -> decltype(redfunc(objs));
   using TExecutor<TThreadExecutor>::Reduce;
@@ -87,6 +105,9 @@ protected:
    auto Map(F func, std::initializer_list<T> args, R redfunc, unsigned nChunks) -> std::vector<typename std::result_of<F(T)>::type>;
 
 private:
+    class TTaskArena;
+
+    void   Execute(const std::function<void()> &f);
     void   ParallelFor(unsigned start, unsigned end, unsigned step, const std::function<void(unsigned int i)> &f);
     double ParallelReduce(const std::vector<double> &objs, const std::function<double(double a, double b)> &redfunc);
     float  ParallelReduce(const std::vector<float> &objs, const std::function<float(float a, float b)> &redfunc);
@@ -94,6 +115,8 @@ private:
     auto SeqReduce(const std::vector<T> &objs, R redfunc) -> decltype(redfunc(objs));
 
     std::unique_ptr<tbb::task_scheduler_init> fInitTBB;
+    std::unique_ptr<TTaskArena> fArena;    ///< Task arena of the executor, if any (see SetTaskArena)
+    unsigned fGrainSize = 0;               ///< Number of iterations per task, 0 to let TBB choose
 };
 
 /************ TEMPLATE METHODS IMPLEMENTATION ******************/
@@ -180,6 +203,42 @@ auto TThreadExecutor::Map(F func, ROOT::TSeq<INTEGER> args, R redfunc, unsigned
 }
 
 
+//////////////////////////////////////////////////////////////////////////
+/// Execute func (with no arguments) nTimes in parallel, discarding the
+/// results. This can be called from within a task of this or of another
+/// executor, or of implicit multi-threading: the nested loop shares the
+/// threads of the enclosing one.
+template<class F>
+void TThreadExecutor::Foreach(F func, unsigned nTimes)
+{
+   ParallelFor(0U, nTimes, 1, [&](unsigned int) { func(); });
+}
+
+//////////////////////////////////////////////////////////////////////////
+/// Execute func in parallel, taking an element of the sequence as argument,
+/// discarding the results.
+template<class F, class INTEGER>
+void TThreadExecutor::Foreach(F func, ROOT::TSeq<INTEGER> args)
+{
+   ParallelFor(*args.begin(), *args.end(), args.step(), [&](unsigned int i) { func(i); });
+}
+
+/// \cond
+template<class F, class T>
+void TThreadExecutor::Foreach(F func, std::initializer_list<T> args)
+{
+   std::vector<T> vargs(std::move(args));
+   Foreach(func, vargs);
+}
+
+template<class F, class T>
+void TThreadExecutor::Foreach(F func, std::vector<T> &args)
+{
+   unsigned int nToProcess = args.size();
+   ParallelFor(0U, nToProcess, 1, [&](unsigned int i) { func(args[i]); });
+}
+/// \endcond
+
 // tell doxygen to ignore this (\endcond closes the statement)
 /// \cond
 
@@ -12,19 +12,19 @@
 #ifndef ROOT_TThreadedObject
 #define ROOT_TThreadedObject
 
+#include "RConfigure.h"
 #include "TList.h"
 #include "TError.h"
 
 #include <functional>
-#include <map>
 #include <memory>
-#include <mutex>
 #include <string>
-#include <thread>
 #include <vector>
 
-#include "ROOT/TSpinMutex.hxx"
 #include "TROOT.h"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 
 namespace ROOT {
 
@@ -38,6 +38,10 @@ namespace ROOT {
             return fgTThreadedObjectIndex++;
          }
 
+         /// Get the processing slot of the calling thread, the same for all
+         /// the TThreadedObject instances (see TThreadedObject::Get).
+         unsigned GetThisThreadSlot();
+
          /// Return a copy of the object or a "Clone" if the copy constructor is not implemented.
          template<class T, bool isCopyConstructible = std::is_copy_constructible<T>::value>
          struct Cloner {
@@ -152,12 +156,12 @@ namespace ROOT {
          return fObjPointers[i];
       }
 
-      /// Access the pointer corresponding to the current slot. This method is
-      /// not adequate for being called inside tight loops as it implies a
-      /// lookup in a mapping between the threadIDs and the slot indices.
-      /// A good practice consists in copying the pointer onto the stack and
-      /// proceed with the loop as shown in this work item (psudo-code) which
-      /// will be sent to different threads:
+      /// Access the pointer corresponding to the current slot. Each thread is
+      /// given its slot once, for all the instances, the lookup is then a
+      /// read of thread-local storage. Still, copying a std::shared_ptr is
+      /// not free: a good practice consists in copying the pointer onto the
+      /// stack and proceed with the loop as shown in this work item
+      /// (psudo-code) which will be sent to different threads:
       /// ~~~{.cpp}
       /// auto workItem = [](){
       ///    auto objPtr = tthreadedObject.Get();
@@ -181,6 +185,10 @@ namespace ROOT {
       /// Merge all the thread private objects. Can be called once: it does not
       /// create any new object but destroys the present bookkeping collapsing
       /// all objects into the one at slot 0.
+      /// The objects are merged pairwise, in a tree of log2(n) levels: the
+      /// merge function is called with a target and a vector holding it and
+      /// the object to merge into it. With implicit multi-threading enabled,
+      /// the merges of a level run in parallel.
       std::shared_ptr<T> Merge(TThreadedObjectUtils::MergeFunctionType<T> mergeFunction = TThreadedObjectUtils::MergeTObjects<T>)
       {
          // We do not return if we already merged.
@@ -188,7 +196,14 @@ namespace ROOT {
             Warning("TThreadedObject::Merge", "This object was already merged. Returning the previous result.");
             return fObjPointers[0];
          }
-         mergeFunction(fObjPointers[0], fObjPointers);
+         std::vector<std::shared_ptr<T>> objs;
+         for (auto &obj : fObjPointers) {
+            if (obj) objs.emplace_back(obj);
+         }
+         if (!objs.empty()) {
+            MergeTree(objs, mergeFunction);
+            fObjPointers[0] = objs[0];
+         }
          fIsMerged = true;
          return fObjPointers[0];
       }
@@ -213,24 +228,35 @@ namespace ROOT {
       std::unique_ptr<T> fModel;                         ///< Use to store a "model" of the object
       std::vector<std::shared_ptr<T>> fObjPointers;      ///< A pointer per thread is kept.
       std::vector<TDirectory*> fDirectories;             ///< A TDirectory per thread is kept.
-      std::map<std::thread::id, unsigned> fThrIDSlotMap; ///< A mapping between the thread IDs and the slots
-      unsigned fCurrMaxSlotIndex = 0;                    ///< The maximum slot index
       bool fIsMerged = false;                            ///< Remember if the objects have been merged already
-      ROOT::TSpinMutex fThrIDSlotMutex;                  ///< Mutex to protect the ID-slot map access
 
-      /// Get the slot number for this threadID.
+      /// Get the slot number for this thread.
       unsigned GetThisSlotNumber()
       {
-         const auto thisThreadID = std::this_thread::get_id();
-         unsigned thisIndex;
-         {
-            std::lock_guard<ROOT::TSpinMutex> lg(fThrIDSlotMutex);
-            auto thisSlotNumIt = fThrIDSlotMap.find(thisThreadID);
-            if (thisSlotNumIt != fThrIDSlotMap.end()) return thisSlotNumIt->second;
-            thisIndex = fCurrMaxSlotIndex++;
-            fThrIDSlotMap[thisThreadID] = thisIndex;
+         return Internal::TThreadedObjectUtils::GetThisThreadSlot();
+      }
+
+      /// Merge objs[i + stride] into objs[i] for i multiple of 2 * stride,
+      /// doubling stride until everything is merged into objs[0].
+      static void MergeTree(std::vector<std::shared_ptr<T>> &objs, TThreadedObjectUtils::MergeFunctionType<T> &mergeFunction)
+      {
+         const unsigned n = objs.size();
+         for (unsigned stride = 1; stride < n; stride *= 2) {
+            const unsigned npairs = (n - stride + 2 * stride - 1) / (2 * stride);
+            auto mergePair = [&objs, &mergeFunction, stride](unsigned pair) {
+               const unsigned i = 2 * stride * pair;
+               std::vector<std::shared_ptr<T>> two{objs[i], objs[i + stride]};
+               mergeFunction(objs[i], two);
+            };
+#ifdef R__USE_IMT
+            if (ROOT::IsImplicitMTEnabled() && npairs > 1) {
+               ROOT::TThreadExecutor pool;
+               pool.Foreach(mergePair, ROOT::TSeqU(npairs));
+               continue;
+            }
+#endif
+            for (unsigned pair = 0; pair < npairs; ++pair) mergePair(pair);
          }
-         return thisIndex;
       }
 
    };
@@ -30,6 +30,8 @@
 #include "TMutexImp.h"
 #endif
 
+#include <atomic>
+
 
 class TMutex : public TVirtualMutex {
 
@@ -38,10 +40,13 @@ friend class TThread;
 
 private:
    TMutexImp  *fMutexImp;   // pointer to mutex implementation
+   std::atomic<const char*> fHolderSite; //! call site of the holder, with lock statistics
 
    TMutex(const TMutex&);              // not implemented
    TMutex& operator=(const TMutex&);   // not implemented
 
+   Int_t  LockAndRecord();
+
 public:
    TMutex(Bool_t recursive = kFALSE);
    virtual ~TMutex() { delete fMutexImp; }
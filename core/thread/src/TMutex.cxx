@@ -31,7 +31,7 @@ ClassImp(TMutex)
 /// Create a mutex lock. The actual mutex implementation will be
 /// provided via the TThreadFactory.
 
-TMutex::TMutex(Bool_t recursive)
+TMutex::TMutex(Bool_t recursive) : fHolderSite(nullptr)
 {
    fMutexImp = gThreadFactory->CreateMutexImp(recursive);
 
@@ -45,11 +45,41 @@ TMutex::TMutex(Bool_t recursive)
 
 Int_t TMutex::Lock()
 {
+   if (R__unlikely(ROOT::Internal::TLockStats::IsEnabled()))
+      return LockAndRecord();
+
    Int_t iret = fMutexImp->Lock();
 
    return iret;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Lock the mutex and record the acquisition in the lock statistics. If
+/// another thread holds the mutex, the wait is counted for the call site of
+/// this acquisition and for the one of the holder.
+
+Int_t TMutex::LockAndRecord()
+{
+   using ROOT::Internal::TLockStats;
+   const char *site = TLockStats::TakeSite();
+
+   Int_t iret = fMutexImp->TryLock();
+   Bool_t contended = (iret != 0);
+   const char *holder = nullptr;
+   Long64_t waitNs = 0;
+   if (contended) {
+      holder = fHolderSite;
+      Long64_t start = TLockStats::Now();
+      iret = fMutexImp->Lock();
+      waitNs = TLockStats::Now() - start;
+   }
+   if (iret == 0) {
+      fHolderSite = site;
+      TLockStats::Record(this, site, contended, waitNs, holder);
+   }
+   return iret;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Try to lock mutex. Returns 0 when no error, EDEADLK when mutex was
 /// already locked by this thread and this mutex is not reentrant.
@@ -58,6 +88,11 @@ Int_t TMutex::TryLock()
 {
    Int_t iret = fMutexImp->TryLock();
 
+   if (R__unlikely(ROOT::Internal::TLockStats::IsEnabled()) && iret == 0) {
+      fHolderSite = ROOT::Internal::TLockStats::TakeSite();
+      ROOT::Internal::TLockStats::Record(this, fHolderSite, kFALSE, 0, nullptr);
+   }
+
    return iret;
 }
 
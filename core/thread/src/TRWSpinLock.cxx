@@ -30,6 +30,16 @@ thus preventing starvation.
 
 using namespace ROOT;
 
+using ROOT::Internal::TLockStats;
+
+////////////////////////////////////////////////////////////////////////////
+/// Constructor naming the lock in the lock statistics (see
+/// ROOT::Internal::TLockStats).
+TRWSpinLock::TRWSpinLock(const char *name) : TRWSpinLock()
+{
+   TLockStats::SetName(this, name);
+}
+
 ////////////////////////////////////////////////////////////////////////////
 /// Acquire the lock in read mode.
 void TRWSpinLock::ReadLock()
@@ -39,7 +49,11 @@ void TRWSpinLock::ReadLock()
       // There is no writer, go freely to the critical section
       ++fReaders;
       --fReaderReservation;
+      if (R__unlikely(TLockStats::IsEnabled()))
+         TLockStats::Record(this, "ReadLock", kFALSE, 0, nullptr);
    } else {
+      Long64_t start = TLockStats::IsEnabled() ? TLockStats::Now() : 0;
+
       // A writer claimed the RW lock, we will need to wait on the
       // internal lock
       --fReaderReservation;
@@ -53,6 +67,9 @@ void TRWSpinLock::ReadLock()
       ++fReaders;
 
       lock.unlock();
+
+      if (R__unlikely(TLockStats::IsEnabled()))
+         TLockStats::Record(this, "ReadLock", kTRUE, TLockStats::Now() - start, "WriteLock");
    }
 }
 
@@ -76,6 +93,11 @@ void TRWSpinLock::ReadUnLock()
 /// Acquire the lock in write mode.
 void TRWSpinLock::WriteLock()
 {
+   const Bool_t stats = TLockStats::IsEnabled();
+   const Bool_t contended = stats && (fWriter || fReaders);
+   const char *holder = fWriter ? "WriteLock" : "ReadLock";
+   const Long64_t start = stats ? TLockStats::Now() : 0;
+
    ++fWriterReservation;
 
    std::unique_lock<ROOT::TSpinMutex> lock(fMutex);
@@ -95,6 +117,10 @@ void TRWSpinLock::WriteLock()
    --fWriterReservation;
 
    lock.unlock();
+
+   if (R__unlikely(stats))
+      TLockStats::Record(this, "WriteLock", contended, contended ? TLockStats::Now() - start : 0,
+                         contended ? holder : nullptr);
 }
 
 //////////////////////////////////////////////////////////////////////////
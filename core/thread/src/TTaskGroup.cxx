@@ -0,0 +1,81 @@
+// @(#)root/thread:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/TTaskGroup.hxx"
+#include "ROOT/TTrace.hxx"
+#include "TROOT.h"
+
+#include "tbb/task_group.h"
+
+namespace ROOT {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create an empty group. Its tasks run asynchronously if implicit
+/// multi-threading is enabled at this point, sequentially otherwise.
+
+TTaskGroup::TTaskGroup()
+{
+   if (ROOT::IsImplicitMTEnabled())
+      fTaskGroup.reset(new tbb::task_group);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for the tasks which are still running.
+
+TTaskGroup::~TTaskGroup()
+{
+   Wait();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Submit closure to the pool of threads and return immediately; if the
+/// group runs its tasks sequentially, closure is called and Run returns
+/// when it is done.
+
+void TTaskGroup::Run(const std::function<void(void)> &closure)
+{
+#ifdef R__USE_TRACE
+   if (fTaskGroup && ROOT::Internal::TTrace::IsEnabled()) {
+      fTaskGroup->run([closure]() {
+         R__TRACE_ZONE("TTaskGroup::Run", "imt");
+         closure();
+      });
+      return;
+   }
+#endif
+   if (fTaskGroup)
+      fTaskGroup->run(closure);
+   else
+      closure();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Block until all the tasks of the group are done or cancelled. The group
+/// can then be used again for new tasks. An exception thrown by a task is
+/// thrown again here.
+
+void TTaskGroup::Wait()
+{
+   if (fTaskGroup)
+      fTaskGroup->wait();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Cancel the tasks of the group which have not started yet; the running
+/// ones still run to their end. Wait() must still be called.
+
+void TTaskGroup::Cancel()
+{
+   if (fTaskGroup)
+      fTaskGroup->cancel();
+}
+
+} // namespace ROOT
@@ -345,6 +345,8 @@ void TThread::Init()
      }
      gROOTMutex = gInterpreterMutex;
    }
+   ROOT::Internal::TLockStats::SetName(gGlobalMutex, "gGlobalMutex");
+   ROOT::Internal::TLockStats::SetName(gInterpreterMutex, "gInterpreterMutex (gROOTMutex)");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
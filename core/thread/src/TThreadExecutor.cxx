@@ -1,7 +1,17 @@
 #include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TTrace.hxx"
 #include "tbb/tbb.h"
+#include "tbb/task_arena.h"
 
 namespace ROOT{
+  /// The task arena of an executor bound to a given concurrency.
+  class TThreadExecutor::TTaskArena {
+  public:
+    explicit TTaskArena(unsigned concurrency): fConcurrency(concurrency), fArena(concurrency) {}
+    unsigned fConcurrency;
+    tbb::task_arena fArena;
+  };
+
   TThreadExecutor::TThreadExecutor():fInitTBB(new tbb::task_scheduler_init()){
   }
 
@@ -9,24 +19,91 @@ namespace ROOT{
   }
 
   TThreadExecutor::~TThreadExecutor() {
+    fArena.reset();
     fInitTBB->terminate();
   }
 
+  //////////////////////////////////////////////////////////////////////////
+  /// Set the number of iterations of Map and Foreach run by each task. With
+  /// 0 (the default) TBB partitions the iterations itself, according to the
+  /// load of the threads; a fixed grain size is better when the iterations
+  /// are very short, or of very different durations.
+  void TThreadExecutor::SetGrainSize(unsigned grainSize){
+    fGrainSize = grainSize;
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  /// Run the parallel operations of this executor in a task arena of their
+  /// own, using at most concurrency threads (including the calling one),
+  /// whatever the number of threads of implicit multi-threading or of the
+  /// other executors. With 0, the operations run again in the arena of the
+  /// calling thread.
+  void TThreadExecutor::SetTaskArena(unsigned concurrency){
+    if (concurrency)
+      fArena.reset(new TTaskArena(concurrency));
+    else
+      fArena.reset();
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  /// Return the concurrency of the task arena of this executor, 0 if it has
+  /// none.
+  unsigned TThreadExecutor::GetTaskArenaConcurrency() const{
+    return fArena ? fArena->fConcurrency : 0;
+  }
+
+  //////////////////////////////////////////////////////////////////////////
+  /// Run f, which spawns the tasks of an operation, in the arena of the
+  /// executor. The thread waiting for the tasks of f only runs these tasks
+  /// (with a TBB version providing task isolation): when the operation is
+  /// nested in a task which holds a lock, the thread cannot start another
+  /// task of the enclosing operation, which could wait for the same lock.
+  void TThreadExecutor::Execute(const std::function<void()> &f){
+#if TBB_INTERFACE_VERSION >= 10000
+    auto run = [&f]() { tbb::this_task_arena::isolate(f); };
+#else
+    const std::function<void()> &run = f;
+#endif
+    if (fArena)
+      fArena->fArena.execute(run);
+    else
+      run();
+  }
+
   void TThreadExecutor::ParallelFor(unsigned int start, unsigned int end, unsigned step, const std::function<void(unsigned int i)> &f){
-    tbb::parallel_for(start, end, step, f);
+    if (start >= end || !step) return;
+    const unsigned n = (end - start + step - 1) / step;
+    auto body = [&](const tbb::blocked_range<unsigned> &r) {
+      R__TRACE_ZONE("TThreadExecutor::ParallelFor", "imt");
+      for (unsigned k = r.begin(); k != r.end(); ++k) f(start + k * step);
+    };
+    Execute([&]() {
+      if (fGrainSize)
+        tbb::parallel_for(tbb::blocked_range<unsigned>(0, n, fGrainSize), body, tbb::simple_partitioner());
+      else
+        tbb::parallel_for(tbb::blocked_range<unsigned>(0, n), body, tbb::auto_partitioner());
+    });
   }
 
   double TThreadExecutor::ParallelReduce(const std::vector<double> &objs, const std::function<double(double a, double b)> &redfunc){
-   return tbb::parallel_reduce(tbb::blocked_range<decltype(objs.begin())>(objs.begin(), objs.end()), double{},
+   double result{};
+   Execute([&]() {
+      result = tbb::parallel_reduce(tbb::blocked_range<decltype(objs.begin())>(objs.begin(), objs.end()), double{},
                               [redfunc](tbb::blocked_range<decltype(objs.begin())> const & range, double init) {
                               return std::accumulate(range.begin(), range.end(), init, redfunc);
                               }, redfunc);
+   });
+   return result;
   }
 
   float TThreadExecutor::ParallelReduce(const std::vector<float> &objs, const std::function<float(float a, float b)> &redfunc){
-   return tbb::parallel_reduce(tbb::blocked_range<decltype(objs.begin())>(objs.begin(), objs.end()), float{},
+   float result{};
+   Execute([&]() {
+      result = tbb::parallel_reduce(tbb::blocked_range<decltype(objs.begin())>(objs.begin(), objs.end()), float{},
                               [redfunc](tbb::blocked_range<decltype(objs.begin())> const & range, float init) {
                               return std::accumulate(range.begin(), range.end(), init, redfunc);
                               }, redfunc);
+   });
+   return result;
   }
-}
\ No newline at end of file
+}
@@ -0,0 +1,77 @@
+// @(#)root/thread:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ROOT/TThreadedObject.hxx"
+#include "ThreadLocalStorage.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// The slots given to the threads, and the ones given back by the threads
+/// which ended. It is never deleted: threads can end during the destruction
+/// of the static objects.
+
+struct TThreadSlotPool {
+   std::mutex fMutex;
+   std::vector<unsigned> fFree;   // Slots given back, to be reused
+   unsigned fNext = 0;            // Smallest slot never given
+
+   static TThreadSlotPool &Get()
+   {
+      static TThreadSlotPool *pool = new TThreadSlotPool;
+      return *pool;
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// The slot of a thread, taken when the thread asks for it for the first
+/// time and given back when it ends, so that the slots stay smaller than
+/// the number of threads alive.
+
+struct TThreadSlot {
+   unsigned fIndex;
+
+   TThreadSlot()
+   {
+      TThreadSlotPool &pool = TThreadSlotPool::Get();
+      std::lock_guard<std::mutex> lg(pool.fMutex);
+      if (pool.fFree.empty()) {
+         fIndex = pool.fNext++;
+      } else {
+         auto smallest = std::min_element(pool.fFree.begin(), pool.fFree.end());
+         fIndex = *smallest;
+         pool.fFree.erase(smallest);
+      }
+   }
+   ~TThreadSlot()
+   {
+      TThreadSlotPool &pool = TThreadSlotPool::Get();
+      std::lock_guard<std::mutex> lg(pool.fMutex);
+      pool.fFree.push_back(fIndex);
+   }
+};
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the slot of the calling thread, shared by all the TThreadedObject
+/// instances. It is assigned once per thread: after the first call, this is
+/// a read of thread-local storage. The slot of a thread which ended is given
+/// to the next new thread.
+
+unsigned ROOT::Internal::TThreadedObjectUtils::GetThisThreadSlot()
+{
+   TTHREAD_TLS_DECL(TThreadSlot, slot);
+   return slot.fIndex;
+}
@@ -33,10 +33,14 @@
 
 typedef void (*SigHandler_t)(ESignals);
 
+class TFdPoller;
+struct pollfd;
 
 class TUnixSystem : public TSystem {
 
 private:
+   TFdPoller     *fPoller;    //!epoll or kqueue waiting for the file handlers
+
    void FillWithCwd(char *cwd) const;
 
 protected:
@@ -54,6 +58,7 @@ protected:
    static int          UnixSetitimer(Long_t ms);
    static int          UnixSelect(Int_t nfds, TFdSet *readready, TFdSet *writeready,
                                   Long_t timeout);
+   static int          UnixPoll(struct pollfd *fds, Int_t nfds, Long_t timeout);
    static void         UnixSignal(ESignals sig, SigHandler_t h);
    static const char  *UnixSigname(ESignals sig);
    static void         UnixSigAlarmInterruptsSyscalls(Bool_t set);
@@ -208,6 +213,7 @@ public:
    void              CloseConnection(int sock, Bool_t force = kFALSE);
    int               RecvRaw(int sock, void *buffer, int length, int flag);
    int               SendRaw(int sock, const void *buffer, int length, int flag);
+   int               SendRawBuffers(int sock, const void *const *buffers, const int *lengths, int nbuffers, int flag);
    int               RecvBuf(int sock, void *buffer, int length);
    int               SendBuf(int sock, const void *buffer, int length);
    int               SetSockOpt(int sock, int option, int val);
@@ -37,6 +37,7 @@
 #include "TVirtualMutex.h"
 #include "TObjArray.h"
 #include <map>
+#include <vector>
 #include <algorithm>
 #include <atomic>
 
@@ -100,6 +101,19 @@
 #include <sys/time.h>
 #include <sys/file.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <poll.h>
+#include <limits.h>
+#if defined(R__LINUX)
+#   include <sys/epoll.h>
+#   define R__HAS_EPOLL
+#elif defined(R__MACOSX) || defined(R__FBSD) || defined(R__OBSD)
+#   include <sys/event.h>
+#   define R__HAS_KQUEUE
+#endif
+#ifndef IOV_MAX
+#define IOV_MAX 16
+#endif
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #if defined(R__AIX)
@@ -363,42 +377,265 @@ const Int_t kFDSETSIZE = 256;                 // upto 256 file descriptors
 #endif
 
 
+// The set grows as needed: it can hold file descriptors >= kFDSETSIZE,
+// which are only waited for with the TFdPoller (or with select() on Linux).
 class TFdSet {
 private:
-   ULong_t fds_bits[HOWMANY(kFDSETSIZE, kNFDBITS)];
+   std::vector<ULong_t> fds_bits;
+   void   Grow(Int_t n) { fds_bits.resize(HOWMANY(n+1, kNFDBITS), 0); }
 public:
-   TFdSet() { memset(fds_bits, 0, sizeof(fds_bits)); }
-   TFdSet(const TFdSet &org) { memcpy(fds_bits, org.fds_bits, sizeof(org.fds_bits)); }
-   TFdSet &operator=(const TFdSet &rhs) { if (this != &rhs) { memcpy(fds_bits, rhs.fds_bits, sizeof(rhs.fds_bits));} return *this; }
-   void   Zero() { memset(fds_bits, 0, sizeof(fds_bits)); }
+   TFdSet() : fds_bits(HOWMANY(kFDSETSIZE, kNFDBITS), 0) { }
+   void   Zero() { std::fill(fds_bits.begin(), fds_bits.end(), 0); }
    void   Set(Int_t n)
    {
-      if (n >= 0 && n < kFDSETSIZE) {
+      if (n >= 0) {
+         if (n >= GetSize()) Grow(n);
          fds_bits[n/kNFDBITS] |= (1UL << (n % kNFDBITS));
       } else {
-         ::Fatal("TFdSet::Set","fd (%d) out of range [0..%d]", n, kFDSETSIZE-1);
+         ::Fatal("TFdSet::Set","fd (%d) out of range", n);
       }
    }
    void   Clr(Int_t n)
    {
-      if (n >= 0 && n < kFDSETSIZE) {
-         fds_bits[n/kNFDBITS] &= ~(1UL << (n % kNFDBITS));
+      if (n >= 0) {
+         if (n < GetSize())
+            fds_bits[n/kNFDBITS] &= ~(1UL << (n % kNFDBITS));
       } else {
-         ::Fatal("TFdSet::Clr","fd (%d) out of range [0..%d]", n, kFDSETSIZE-1);
+         ::Fatal("TFdSet::Clr","fd (%d) out of range", n);
       }
    }
    Int_t  IsSet(Int_t n)
    {
-      if (n >= 0 && n < kFDSETSIZE) {
-         return (fds_bits[n/kNFDBITS] & (1UL << (n % kNFDBITS))) != 0;
+      if (n >= 0) {
+         return n < GetSize() && (fds_bits[n/kNFDBITS] & (1UL << (n % kNFDBITS))) != 0;
       } else {
-         ::Fatal("TFdSet::IsSet","fd (%d) out of range [0..%d]", n, kFDSETSIZE-1);
+         ::Fatal("TFdSet::IsSet","fd (%d) out of range", n);
          return 0;
       }
    }
-   ULong_t *GetBits() { return (ULong_t *)fds_bits; }
+   Int_t  GetSize() const { return fds_bits.size() * kNFDBITS; }  // number of fds the set can hold
+   void   Reserve(Int_t n) { if (n > GetSize()) Grow(n-1); }
+   ULong_t *GetBits() { return fds_bits.data(); }
+};
+
+//------------------- Unix TFdPoller -------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for the file descriptors of the system file handlers with epoll
+/// (Linux) or kqueue (MacOS X, BSD) instead of select(). The interests are
+/// kept by the kernel and only updated when a file handler is added or
+/// removed, so the cost of a wait does not grow with the number of file
+/// descriptors, and their values are not limited to FD_SETSIZE. A file
+/// descriptor which cannot be polled (e.g. a regular file) is always
+/// ready, as with select(). IsValid() is false if neither epoll nor kqueue
+/// is available: the event loop then uses select().
+
+class TFdPoller {
+private:
+   int               fPollFd;       // epoll or kqueue descriptor
+   pid_t             fPid;          // process owning fPollFd, recreated in forked children
+   TFdSet           *fReadmask;     // files that should be checked for read events
+   TFdSet           *fWritemask;    // files that should be checked for write events
+   std::vector<int>  fAlwaysReady;  // files which cannot be polled
+
+   TFdPoller(const TFdPoller &);             // not implemented
+   TFdPoller &operator=(const TFdPoller &);  // not implemented
+
+   void   Open();
+   void   Close();
+   void   Register(int fd, Bool_t read, Bool_t write);
+
+public:
+   TFdPoller(TFdSet *readmask, TFdSet *writemask);
+   ~TFdPoller() { Close(); }
+   Bool_t IsValid() const { return fPollFd >= 0; }
+   void   Update(int fd);
+   int    Wait(TFdSet *readready, TFdSet *writeready, Long_t timeout);
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// Create the poller of the file descriptors set in readmask and writemask.
+
+TFdPoller::TFdPoller(TFdSet *readmask, TFdSet *writemask)
+   : fPollFd(-1), fPid(0), fReadmask(readmask), fWritemask(writemask)
+{
+   Open();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the epoll or kqueue descriptor and register the file descriptors
+/// of the masks.
+
+void TFdPoller::Open()
+{
+#if defined(R__HAS_EPOLL)
+   fPollFd = epoll_create1(EPOLL_CLOEXEC);
+#elif defined(R__HAS_KQUEUE)
+   fPollFd = kqueue();
+   if (fPollFd >= 0)
+      fcntl(fPollFd, F_SETFD, FD_CLOEXEC);
+#endif
+   fPid = getpid();
+   fAlwaysReady.clear();
+   if (fPollFd < 0)
+      return;
+   Int_t n = TMath::Max(fReadmask->GetSize(), fWritemask->GetSize());
+   for (int fd = 0; fd < n; ++fd)
+      if (fReadmask->IsSet(fd) || fWritemask->IsSet(fd))
+         Update(fd);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Close the epoll or kqueue descriptor.
+
+void TFdPoller::Close()
+{
+#if defined(R__HAS_KQUEUE)
+   // a kqueue is not inherited by fork(): the descriptor number in a child
+   // may have been reused for another file
+   if (fPid != getpid()) {
+      fPollFd = -1;
+      return;
+   }
+#endif
+   if (fPollFd >= 0)
+      close(fPollFd);
+   fPollFd = -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Register the interests of the file descriptor fd, none to remove it.
+
+void TFdPoller::Register(int fd, Bool_t read, Bool_t write)
+{
+   Bool_t polled = kTRUE;
+#if defined(R__HAS_EPOLL)
+   struct epoll_event ev;
+   memset(&ev, 0, sizeof(ev));
+   ev.events  = (read ? EPOLLIN : 0) | (write ? EPOLLOUT : 0);
+   ev.data.fd = fd;
+   if (!read && !write) {
+      // fails if fd was closed, which removed it already
+      epoll_ctl(fPollFd, EPOLL_CTL_DEL, fd, &ev);
+   } else if (epoll_ctl(fPollFd, EPOLL_CTL_MOD, fd, &ev) == -1) {
+      if (errno != ENOENT || epoll_ctl(fPollFd, EPOLL_CTL_ADD, fd, &ev) == -1)
+         polled = kFALSE;
+   }
+#elif defined(R__HAS_KQUEUE)
+   struct kevent ev;
+   EV_SET(&ev, fd, EVFILT_READ, read ? EV_ADD : EV_DELETE, 0, 0, 0);
+   if (kevent(fPollFd, &ev, 1, 0, 0, 0) == -1 && read)
+      polled = kFALSE;
+   EV_SET(&ev, fd, EVFILT_WRITE, write ? EV_ADD : EV_DELETE, 0, 0, 0);
+   if (kevent(fPollFd, &ev, 1, 0, 0, 0) == -1 && write)
+      polled = kFALSE;
+#endif
+   if (!polled && (read || write))
+      fAlwaysReady.push_back(fd);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Update the interests of the file descriptor fd from the masks.
+
+void TFdPoller::Update(int fd)
+{
+   if (fPid != getpid()) {
+      // the epoll descriptor is shared with the parent process: do not
+      // modify its interests
+      Close();
+      Open();
+      return;
+   }
+   if (fPollFd < 0)
+      return;
+   fAlwaysReady.erase(std::remove(fAlwaysReady.begin(), fAlwaysReady.end(), fd), fAlwaysReady.end());
+   Register(fd, fReadmask->IsSet(fd), fWritemask->IsSet(fd));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for events on the file descriptors of the masks or for timeout
+/// (in milliseconds) to occur, and set the ready ones in readready and
+/// writeready. Returns as TUnixSystem::UnixSelect(). In case of an error
+/// other than EINTR the poller becomes invalid.
+
+int TFdPoller::Wait(TFdSet *readready, TFdSet *writeready, Long_t timeout)
+{
+   if (fPid != getpid()) {
+      Close();
+      Open();
+   }
+
+   readready->Zero();
+   writeready->Zero();
+
+   int nready = 0;
+   for (int fd : fAlwaysReady) {
+      if (fReadmask->IsSet(fd)) {
+         readready->Set(fd);
+         nready++;
+      }
+      if (fWritemask->IsSet(fd)) {
+         writeready->Set(fd);
+         nready++;
+      }
+   }
+   if (nready > 0)
+      timeout = 0;
+
+   const int kMaxEvents = 256;
+   int n;
+#if defined(R__HAS_EPOLL)
+   struct epoll_event ev[kMaxEvents];
+   n = epoll_wait(fPollFd, ev, kMaxEvents, timeout >= 0 ? (int)TMath::Min(timeout, (Long_t)INT_MAX) : -1);
+#elif defined(R__HAS_KQUEUE)
+   struct kevent ev[kMaxEvents];
+   struct timespec ts, *pts = 0;
+   if (timeout >= 0) {
+      ts.tv_sec  = timeout / 1000;
+      ts.tv_nsec = (timeout % 1000) * 1000000;
+      pts = &ts;
+   }
+   n = kevent(fPollFd, 0, 0, ev, kMaxEvents, pts);
+#else
+   n = 0;
+#endif
+   if (n == -1) {
+      if (nready > 0)
+         return nready;
+      if (TSystem::GetErrno() == EINTR) {
+         TSystem::ResetErrno();  // errno is not self reseting
+         return -2;
+      }
+      ::SysError("TFdPoller::Wait", "cannot wait for events, using select() from now on");
+      Close();
+      return -1;
+   }
+
+   for (int i = 0; i < n; ++i) {
+#if defined(R__HAS_EPOLL)
+      int fd = ev[i].data.fd;
+      Bool_t read  = (ev[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0;
+      Bool_t write = (ev[i].events & (EPOLLOUT | EPOLLHUP | EPOLLERR)) != 0;
+#elif defined(R__HAS_KQUEUE)
+      int fd = (int) ev[i].ident;
+      Bool_t read  = ev[i].filter == EVFILT_READ;
+      Bool_t write = ev[i].filter == EVFILT_WRITE;
+#else
+      int fd = -1;
+      Bool_t read = kFALSE, write = kFALSE;
+#endif
+      if (read && fReadmask->IsSet(fd) && !readready->IsSet(fd)) {
+         readready->Set(fd);
+         nready++;
+      }
+      if (write && fWritemask->IsSet(fd) && !writeready->IsSet(fd)) {
+         writeready->Set(fd);
+         nready++;
+      }
+   }
+   return nready;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Unix signal handler.
 
@@ -562,7 +799,7 @@ ClassImp(TUnixSystem)
 
 ////////////////////////////////////////////////////////////////////////////////
 
-TUnixSystem::TUnixSystem() : TSystem("Unix", "Unix System")
+TUnixSystem::TUnixSystem() : TSystem("Unix", "Unix System"), fPoller(0)
 { }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -572,6 +809,7 @@ TUnixSystem::~TUnixSystem()
 {
    UnixResetSignals();
 
+   delete fPoller;
    delete fReadmask;
    delete fWritemask;
    delete fReadready;
@@ -592,6 +830,7 @@ Bool_t TUnixSystem::Init()
    fReadready  = new TFdSet;
    fWriteready = new TFdSet;
    fSignals    = new TFdSet;
+   fPoller     = new TFdPoller(fReadmask, fWritemask);
 
    //--- install default handlers
    UnixSignal(kSigChild,                 SigHandler);
@@ -761,6 +1000,8 @@ void TUnixSystem::AddFileHandler(TFileHandler *h)
          fWritemask->Set(fd);
          fMaxwfd = TMath::Max(fMaxwfd, fd);
       }
+      if (fPoller && fd >= 0)
+         fPoller->Update(fd);
    }
 }
 
@@ -793,6 +1034,8 @@ TFileHandler *TUnixSystem::RemoveFileHandler(TFileHandler *h)
             fMaxwfd = TMath::Max(fMaxwfd, fd);
          }
       }
+      if (fPoller && oh->GetFd() >= 0)
+         fPoller->Update(oh->GetFd());
    }
    return oh;
 }
@@ -1108,10 +1351,6 @@ void TUnixSystem::DispatchOneEvent(Bool_t pendingOnly)
          pollOnce = kFALSE;
       }
 
-      // nothing ready, so setup select call
-      *fReadready  = *fReadmask;
-      *fWriteready = *fWritemask;
-
       int mxfd = TMath::Max(fMaxrfd, fMaxwfd);
       mxfd++;
 
@@ -1119,6 +1358,17 @@ void TUnixSystem::DispatchOneEvent(Bool_t pendingOnly)
       if (mxfd == 0 && nextto == -1)
          return;
 
+      // nothing ready, so wait with epoll or kqueue if available
+      if (fPoller && fPoller->IsValid()) {
+         fNfd = fPoller->Wait(fReadready, fWriteready, nextto);
+         if (fNfd != -1)
+            continue;
+      }
+
+      // else setup select call
+      *fReadready  = *fReadmask;
+      *fWriteready = *fWritemask;
+
       fNfd = UnixSelect(mxfd, fReadready, fWriteready, nextto);
       if (fNfd < 0 && fNfd != -2) {
          int fd, rc;
@@ -1170,36 +1420,37 @@ Int_t TUnixSystem::Select(TList *act, Long_t to)
 {
    Int_t rc = -4;
 
-   TFdSet rd, wr;
-   Int_t mxfd = -1;
+   std::vector<struct pollfd> fds;
    TIter next(act);
    TFileHandler *h = 0;
    while ((h = (TFileHandler *) next())) {
       Int_t fd = h->GetFd();
       if (fd > -1) {
-         if (h->HasReadInterest()) {
-            rd.Set(fd);
-            mxfd = TMath::Max(mxfd, fd);
-         }
-         if (h->HasWriteInterest()) {
-            wr.Set(fd);
-            mxfd = TMath::Max(mxfd, fd);
-         }
+         struct pollfd p = { fd, 0, 0 };
+         if (h->HasReadInterest())
+            p.events |= POLLIN;
+         if (h->HasWriteInterest())
+            p.events |= POLLOUT;
+         if (p.events)
+            fds.push_back(p);
          h->ResetReadyMask();
       }
    }
-   if (mxfd > -1)
-      rc = UnixSelect(mxfd+1, &rd, &wr, to);
+   if (!fds.empty())
+      rc = UnixPoll(fds.data(), fds.size(), to);
 
-   // Set readiness bits
+   // Set readiness bits, the handlers being in the same order as fds
    if (rc > 0) {
+      size_t i = 0;
       next.Reset();
       while ((h = (TFileHandler *) next())) {
-         Int_t fd = h->GetFd();
-         if (rd.IsSet(fd))
+         if (h->GetFd() < 0 || !(h->HasReadInterest() || h->HasWriteInterest()))
+            continue;
+         if (fds[i].revents & POLLIN)
             h->SetReadReady();
-         if (wr.IsSet(fd))
+         if (fds[i].revents & POLLOUT)
             h->SetWriteReady();
+         i++;
       }
    }
 
@@ -1218,27 +1469,24 @@ Int_t TUnixSystem::Select(TFileHandler *h, Long_t to)
 {
    Int_t rc = -4;
 
-   TFdSet rd, wr;
-   Int_t mxfd = -1;
-   Int_t fd = -1;
+   struct pollfd p = { -1, 0, 0 };
    if (h) {
-      fd = h->GetFd();
-      if (fd > -1) {
+      p.fd = h->GetFd();
+      if (p.fd > -1) {
          if (h->HasReadInterest())
-            rd.Set(fd);
+            p.events |= POLLIN;
          if (h->HasWriteInterest())
-            wr.Set(fd);
+            p.events |= POLLOUT;
          h->ResetReadyMask();
-         mxfd = fd;
-         rc = UnixSelect(mxfd+1, &rd, &wr, to);
+         rc = UnixPoll(&p, 1, to);
       }
    }
 
    // Fill output lists, if required
    if (rc > 0) {
-      if (rd.IsSet(fd))
+      if (p.revents & POLLIN)
          h->SetReadReady();
-      if (wr.IsSet(fd))
+      if (p.revents & POLLOUT)
          h->SetWriteReady();
    }
 
@@ -3425,6 +3673,70 @@ int TUnixSystem::SendRaw(int sock, const void *buf, int length, int opt)
    return n;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Send the nbuffers buffers one after the other, as if they were a single
+/// buffer, with sendmsg(): the buffers are not copied into one and are sent
+/// with as few system calls as possible. Use opt as for SendRaw(), whose
+/// return codes are also returned in case of error; otherwise returns the
+/// total number of bytes sent.
+
+int TUnixSystem::SendRawBuffers(int sock, const void *const *buffers, const int *lengths, int nbuffers, int opt)
+{
+   if (sock < 0) return -1;
+
+   if (opt == kDontBlock)
+      return TSystem::SendRawBuffers(sock, buffers, lengths, nbuffers, opt);
+
+   int flag = (opt == kOob) ? MSG_OOB : 0;
+
+   std::vector<struct iovec> iov;
+   iov.reserve(nbuffers);
+   for (int i = 0; i < nbuffers; ++i) {
+      if (lengths[i] > 0) {
+         struct iovec v;
+         v.iov_base = const_cast<void *>(buffers[i]);
+         v.iov_len  = lengths[i];
+         iov.push_back(v);
+      }
+   }
+
+   int nsent = 0;
+   size_t first = 0;
+   while (first < iov.size()) {
+      struct msghdr msg;
+      memset(&msg, 0, sizeof(msg));
+      msg.msg_iov    = &iov[first];
+      msg.msg_iovlen = std::min<size_t>(iov.size() - first, IOV_MAX);
+      ssize_t n = sendmsg(sock, &msg, flag);
+      if (n <= 0) {
+         if (n == 0)
+            break;
+         if (GetErrno() == EWOULDBLOCK)
+            return -4;
+         if (GetErrno() != EINTR) {
+            ::SysError("TUnixSystem::SendRawBuffers", "sendmsg");
+            Error("SendRawBuffers", "cannot send buffers");
+         }
+         if (GetErrno() == EPIPE || GetErrno() == ECONNRESET)
+            return -5;
+         return -1;
+      }
+      nsent += n;
+      // skip what was sent, the last buffer may have been sent in part
+      while (n > 0) {
+         if ((size_t)n >= iov[first].iov_len) {
+            n -= iov[first].iov_len;
+            ++first;
+         } else {
+            iov[first].iov_base = (char *)iov[first].iov_base + n;
+            iov[first].iov_len -= n;
+            n = 0;
+         }
+      }
+   }
+   return nsent;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set socket option.
 
@@ -3891,6 +4203,8 @@ int TUnixSystem::UnixSelect(Int_t nfds, TFdSet *readready, TFdSet *writeready,
 {
    int retcode;
 
+   if (readready)  readready->Reserve(nfds);
+   if (writeready) writeready->Reserve(nfds);
    fd_set *rd = (readready)  ? (fd_set*)readready->GetBits()  : 0;
    fd_set *wr = (writeready) ? (fd_set*)writeready->GetBits() : 0;
 
@@ -3915,6 +4229,46 @@ int TUnixSystem::UnixSelect(Int_t nfds, TFdSet *readready, TFdSet *writeready,
    return retcode;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for events on the nfds file descriptors of fds, with poll(), which
+/// unlike select() does not limit their values, or for timeout (in
+/// milliseconds) to occur. On return the revents of each file descriptor
+/// only have POLLIN and POLLOUT set, if it is ready for reading or writing
+/// (including in case of hang up or error). Returns the number of ready
+/// descriptors (counted once for reading and once for writing, as
+/// select()), or 0 in case of timeout, or < 0 in case of an error, with -2
+/// being EINTR and -3 EBADF. In case of EINTR the errno has been reset and
+/// the method can be called again.
+
+int TUnixSystem::UnixPoll(struct pollfd *fds, Int_t nfds, Long_t timeout)
+{
+   int retcode = poll(fds, nfds, timeout >= 0 ? (int)TMath::Min(timeout, (Long_t)INT_MAX) : -1);
+   if (retcode == -1) {
+      if (GetErrno() == EINTR) {
+         ResetErrno();  // errno is not self reseting
+         return -2;
+      }
+      return -1;
+   }
+
+   int nready = 0;
+   for (Int_t i = 0; i < nfds; ++i) {
+      if (fds[i].revents & POLLNVAL)
+         return -3;
+      short ready = 0;
+      if ((fds[i].events & POLLIN) && (fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+         ready |= POLLIN;
+         nready++;
+      }
+      if ((fds[i].events & POLLOUT) && (fds[i].revents & (POLLOUT | POLLHUP | POLLERR))) {
+         ready |= POLLOUT;
+         nready++;
+      }
+      fds[i].revents = ready;
+   }
+   return nready;
+}
+
 //---- directories -------------------------------------------------------------
 
 ////////////////////////////////////////////////////////////////////////////////
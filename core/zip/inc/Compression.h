@@ -28,6 +28,15 @@ namespace ROOT {
    // and memory when compressing.  LZMA memory usage is particularly
    // high for compression levels 8 and 9.
    //
+   // LZ4 trades compression factor for a very fast decompression
+   // and is well suited for data which is read many times.
+   // Levels 1 to 3 use the fast LZ4 compressor, higher levels
+   // the slower LZ4 HC compressor which produces the same format.
+   // ZSTD (Zstandard) gives a compression factor similar to ZLIB
+   // with a significantly faster decompression.
+   // Both require the external libraries be found when ROOT is
+   // configured; otherwise buffers are written uncompressed.
+   //
    // The current algorithms support level 1 to 9. The higher
    // the level the greater the compression and more CPU time
    // and memory resources used during compression. Level 0
@@ -36,6 +45,8 @@ namespace ROOT {
                                 kZLIB,
                                 kLZMA,
                                 kOldCompressionAlgo,
+                                kLZ4,
+                                kZSTD,
                                 // if adding new algorithm types,
                                 // keep this enum value last
                                 kUndefinedCompressionAlgorithm
@@ -12,6 +12,8 @@
 #ifndef ROOT_RZip
 #define ROOT_RZip
 
+#include <stddef.h>
+
 extern "C" unsigned long R__crc32(unsigned long crc, const unsigned char* buf, unsigned int len);
 
 extern "C" unsigned long R__memcompress(char *tgt, unsigned long tgtsize, char *src, unsigned long srcsize);
@@ -24,6 +26,16 @@ extern "C" void R__unzip(int *srcsize, unsigned char *src, int *tgtsize, unsigne
 
 extern "C" int R__unzip_header(int *srcsize, unsigned char *src, int *tgtsize);
 
+// Zstd dictionaries for the compression of small buffers, see core/zstd/src/ZipZSTDDict.cxx
+
+extern "C" unsigned R__ZSTDTrainDictionary(const char *samples, const size_t *sizes, unsigned nsamples, char *dict, int *dictsize);
+
+extern "C" unsigned R__ZSTDAddDictionary(const char *dict, int dictsize);
+
+extern "C" const char *R__ZSTDGetDictionary(unsigned dictID, int *dictsize);
+
+extern "C" void R__zipZSTDDict(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep, unsigned dictID);
+
 enum { kMAXZIPBUF = 0xffffff };
 
 #endif
@@ -16,6 +16,8 @@
 #include "Compression.h"
 #include "RConfigure.h"
 #include "ZipLZMA.h"
+#include "ZipLZ4.h"
+#include "ZipZSTD.h"
 
 #include <stdio.h>
 #include <assert.h>
@@ -290,6 +292,8 @@ struct bits_internal_state {
    R__ZipMode = 2 : LZMA compression algorithm is used
    R__ZipMode = 0 or 3 : a very old compression algorithm is used
    (the very old algorithm is supported for backward compatibility)
+   R__ZipMode = 4 : LZ4 compression algorithm is used
+   R__ZipMode = 5 : ZSTD compression algorithm is used
    The LZMA algorithm requires the external XZ package be installed when linking
    is done. LZMA typically has significantly higher compression factors, but takes
    more CPU time and memory resources while compressing.
@@ -567,6 +571,8 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
      /*                      1 = zlib */
      /*                      2 = lzma */
      /*                      3 = old */
+     /*                      4 = lz4 */
+     /*                      5 = zstd */
 {
   int err;
   int method   = Z_DEFLATED;
@@ -586,6 +592,18 @@ void R__zipMultipleAlgorithm(int cxlevel, int *srcsize, char *src, int *tgtsize,
     return;
   }
 
+  // The LZ4 compression algorithm
+  if (compressionAlgorithm == kLZ4) {
+    R__zipLZ4(cxlevel, srcsize, src, tgtsize, tgt, irep);
+    return;
+  }
+
+  // The Zstandard compression algorithm
+  if (compressionAlgorithm == kZSTD) {
+    R__zipZSTD(cxlevel, srcsize, src, tgtsize, tgt, irep);
+    return;
+  }
+
   // The very old algorithm for backward compatibility
   // 0 for selecting with R__ZipMode in a backward compatible way
   // 3 for selecting in other cases
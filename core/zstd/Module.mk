@@ -0,0 +1,47 @@
+# Module.mk for zstd module
+# Copyright (c) 2016 Rene Brun and Fons Rademakers
+#
+# The classic build does not look for the external libzstd, the
+# ZipZSTD wrapper is compiled without it and leaves buffers uncompressed.
+# Use the CMake build to enable the ZSTD compression algorithm.
+
+MODNAME      := zstd
+MODDIR       := $(ROOT_SRCDIR)/core/$(MODNAME)
+MODDIRS      := $(MODDIR)/src
+MODDIRI      := $(MODDIR)/inc
+
+ZSTDDIR       := $(MODDIR)
+ZSTDDIRS      := $(ZSTDDIR)/src
+ZSTDDIRI      := $(ZSTDDIR)/inc
+
+##### ZipZSTD, part of libCore #####
+ZSTDH         := $(MODDIRI)/ZipZSTD.h
+ZSTDS         := $(MODDIRS)/ZipZSTD.c
+ZSTDDICTS     := $(MODDIRS)/ZipZSTDDict.cxx
+ZSTDO         := $(call stripsrc,$(ZSTDS:.c=.o) $(ZSTDDICTS:.cxx=.o))
+
+ZSTDDEP       := $(ZSTDO:.o=.d)
+
+# used in the main Makefile
+ALLHDRS      += $(patsubst $(MODDIRI)/%.h,include/%.h,$(ZSTDH))
+
+# include all dependency files
+INCLUDEFILES += $(ZSTDDEP)
+
+##### local rules #####
+.PHONY:         all-$(MODNAME) clean-$(MODNAME) distclean-$(MODNAME)
+
+include/%.h:    $(ZSTDDIRI)/%.h
+		cp $< $@
+
+all-$(MODNAME): $(ZSTDO)
+
+clean-$(MODNAME):
+		@rm -f $(ZSTDO)
+
+clean::         clean-$(MODNAME)
+
+distclean-$(MODNAME): clean-$(MODNAME)
+		@rm -f $(ZSTDDEP)
+
+distclean::     distclean-$(MODNAME)
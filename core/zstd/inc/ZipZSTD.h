@@ -0,0 +1,38 @@
+// @(#)root/zstd:$Id$
+// Author: ROOT I/O team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void R__zipZSTD(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep);
+
+void R__unzipZSTD(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep);
+
+/* Compression with the trained dictionaries (format version 2), see ZipZSTDDict.cxx */
+
+unsigned R__ZSTDTrainDictionary(const char *samples, const size_t *sizes, unsigned nsamples, char *dict, int *dictsize);
+
+unsigned R__ZSTDAddDictionary(const char *dict, int dictsize);
+
+int R__ZSTDHasDictionary(unsigned dictID);
+
+const char *R__ZSTDGetDictionary(unsigned dictID, int *dictsize);
+
+void R__zipZSTDDict(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep, unsigned dictID);
+
+void R__unzipZSTDDict(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep);
+
+#ifdef __cplusplus
+}
+#endif
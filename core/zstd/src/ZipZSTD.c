@@ -0,0 +1,103 @@
+// @(#)root/zstd:$Id$
+// Author: ROOT I/O team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "ZipZSTD.h"
+#include <stdio.h>
+
+#ifdef R__HAS_ZSTD
+#include "zstd.h"
+#endif
+
+static const int kHeaderSize = 9;
+
+void R__zipZSTD(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep)
+{
+#ifdef R__HAS_ZSTD
+   size_t out_size;               /* compressed size */
+   unsigned in_size = (unsigned) (*srcsize);
+   int capacity = *tgtsize - kHeaderSize;
+
+   *irep = 0;
+
+   if (capacity <= 0) {
+      return;
+   }
+
+   if (*srcsize > 0xffffff || *srcsize < 0) {
+      return;
+   }
+
+   if (cxlevel > ZSTD_maxCLevel()) cxlevel = ZSTD_maxCLevel();
+
+   out_size = ZSTD_compress(&tgt[kHeaderSize], (size_t)capacity, src, (size_t)(*srcsize), cxlevel);
+   if (ZSTD_isError(out_size) || out_size > 0xffffff) {
+      /* No need to print an error message. We simply abandon the compression
+         the buffer cannot be compressed or compressed buffer would be larger than original buffer
+      */
+      return;
+   }
+
+   tgt[0] = 'Z';  /* Signature of Zstandard */
+   tgt[1] = 'S';
+   tgt[2] = 1;    /* format version */
+
+   tgt[3] = (char)(out_size & 0xff);
+   tgt[4] = (char)((out_size >> 8) & 0xff);
+   tgt[5] = (char)((out_size >> 16) & 0xff);
+
+   tgt[6] = (char)(in_size & 0xff);         /* decompressed size */
+   tgt[7] = (char)((in_size >> 8) & 0xff);
+   tgt[8] = (char)((in_size >> 16) & 0xff);
+
+   *irep = (int)out_size + kHeaderSize;
+#else
+   (void)cxlevel; (void)srcsize; (void)src; (void)tgtsize; (void)tgt;
+   /* Without Zstd support the buffer is simply left uncompressed. */
+   *irep = 0;
+#endif
+}
+
+void R__unzipZSTD(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep)
+{
+#ifdef R__HAS_ZSTD
+   size_t returnStatus;
+
+   *irep = 0;
+
+   if (src[2] == 2) {
+      /* Compressed with a trained dictionary */
+      R__unzipZSTDDict(srcsize, src, tgtsize, tgt, irep);
+      return;
+   }
+   if (src[2] != 1) {
+      fprintf(stderr,
+              "R__unzipZSTD: unsupported Zstd format version %d\n",
+              src[2]);
+      return;
+   }
+
+   returnStatus = ZSTD_decompress(tgt, (size_t)(*tgtsize),
+                                  &src[kHeaderSize], (size_t)(*srcsize - kHeaderSize));
+   if (ZSTD_isError(returnStatus)) {
+      fprintf(stderr,
+              "R__unzipZSTD: error in ZSTD_decompress: %s\n",
+              ZSTD_getErrorName(returnStatus));
+      return;
+   }
+
+   *irep = (int)returnStatus;
+#else
+   (void)srcsize; (void)src; (void)tgtsize; (void)tgt;
+   fprintf(stderr,
+           "R__unzipZSTD: buffer is Zstd compressed but ROOT was built without Zstd support\n");
+   *irep = 0;
+#endif
+}
@@ -0,0 +1,256 @@
+// @(#)root/zstd:$Id$
+// Author: ROOT I/O team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+// Zstd compression of small buffers with trained dictionaries.
+//
+// A buffer compressed with a dictionary has the usual 9 bytes header with
+// the format version 2; the Zstd frame holds the id of the dictionary. The
+// dictionaries are registered once per process (R__ZSTDAddDictionary), by
+// the writer when it trains them and by TFile when it opens a file which
+// stores some (see TCompressionDictionaries); they are never unregistered,
+// since the same dictionary may be used by several files. Their ids are
+// derived by Zstd from their content.
+
+#include "ZipZSTD.h"
+
+#include <stdio.h>
+
+#ifdef R__HAS_ZSTD
+#include "zstd.h"
+#include "zdict.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int kHeaderSize = 9;
+
+struct TDictionary {
+   std::string                fContent;
+   ZSTD_DDict                *fDDict = nullptr;
+   std::map<int, ZSTD_CDict*> fCDicts;  // per compression level, created on first use
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// The registered dictionaries and a pool of compression and decompression
+/// contexts. It is never deleted: buffers may be compressed during the
+/// destruction of the static objects.
+
+struct TDictionaryRegistry {
+   std::mutex                         fMutex;
+   std::map<unsigned, TDictionary*>   fDictionaries;
+   std::vector<ZSTD_CCtx*>            fCCtxs;
+   std::vector<ZSTD_DCtx*>            fDCtxs;
+
+   static TDictionaryRegistry &Get()
+   {
+      static TDictionaryRegistry *registry = new TDictionaryRegistry;
+      return *registry;
+   }
+};
+
+} // unnamed namespace
+
+extern "C" unsigned R__ZSTDTrainDictionary(const char *samples, const size_t *sizes, unsigned nsamples, char *dict, int *dictsize)
+{
+   if (!samples || !sizes || !nsamples || !dict || *dictsize <= 0) {
+      *dictsize = 0;
+      return 0;
+   }
+   size_t size = ZDICT_trainFromBuffer(dict, (size_t)(*dictsize), samples, sizes, nsamples);
+   if (ZDICT_isError(size)) {
+      /* Not enough or too regular samples: the buffers are compressed without dictionary. */
+      *dictsize = 0;
+      return 0;
+   }
+   *dictsize = (int)size;
+   return ZDICT_getDictID(dict, size);
+}
+
+extern "C" unsigned R__ZSTDAddDictionary(const char *dict, int dictsize)
+{
+   if (!dict || dictsize <= 0) return 0;
+   unsigned id = ZDICT_getDictID(dict, (size_t)dictsize);
+   if (!id) return 0;
+   TDictionaryRegistry &registry = TDictionaryRegistry::Get();
+   std::lock_guard<std::mutex> lock(registry.fMutex);
+   if (registry.fDictionaries.count(id)) return id;
+   TDictionary *entry = new TDictionary;
+   entry->fContent.assign(dict, (size_t)dictsize);
+   entry->fDDict = ZSTD_createDDict(entry->fContent.data(), entry->fContent.size());
+   if (!entry->fDDict) {
+      delete entry;
+      return 0;
+   }
+   registry.fDictionaries[id] = entry;
+   return id;
+}
+
+extern "C" int R__ZSTDHasDictionary(unsigned dictID)
+{
+   TDictionaryRegistry &registry = TDictionaryRegistry::Get();
+   std::lock_guard<std::mutex> lock(registry.fMutex);
+   return registry.fDictionaries.count(dictID) != 0;
+}
+
+extern "C" const char *R__ZSTDGetDictionary(unsigned dictID, int *dictsize)
+{
+   TDictionaryRegistry &registry = TDictionaryRegistry::Get();
+   std::lock_guard<std::mutex> lock(registry.fMutex);
+   auto found = registry.fDictionaries.find(dictID);
+   if (found == registry.fDictionaries.end()) {
+      *dictsize = 0;
+      return 0;
+   }
+   // The content is never released, see TDictionaryRegistry.
+   *dictsize = (int)found->second->fContent.size();
+   return found->second->fContent.data();
+}
+
+extern "C" void R__zipZSTDDict(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep, unsigned dictID)
+{
+   *irep = 0;
+   int capacity = *tgtsize - kHeaderSize;
+   if (capacity <= 0 || *srcsize > 0xffffff || *srcsize < 0) {
+      return;
+   }
+   if (cxlevel > ZSTD_maxCLevel()) cxlevel = ZSTD_maxCLevel();
+
+   TDictionaryRegistry &registry = TDictionaryRegistry::Get();
+   ZSTD_CDict *cdict = nullptr;
+   ZSTD_CCtx *cctx = nullptr;
+   {
+      std::lock_guard<std::mutex> lock(registry.fMutex);
+      auto found = registry.fDictionaries.find(dictID);
+      if (found != registry.fDictionaries.end()) {
+         TDictionary *entry = found->second;
+         ZSTD_CDict *&levelDict = entry->fCDicts[cxlevel];
+         if (!levelDict) {
+            levelDict = ZSTD_createCDict(entry->fContent.data(), entry->fContent.size(), cxlevel);
+         }
+         cdict = levelDict;
+      }
+      if (cdict && !registry.fCCtxs.empty()) {
+         cctx = registry.fCCtxs.back();
+         registry.fCCtxs.pop_back();
+      }
+   }
+   if (!cdict) {
+      R__zipZSTD(cxlevel, srcsize, src, tgtsize, tgt, irep);
+      return;
+   }
+   if (!cctx) cctx = ZSTD_createCCtx();
+   if (!cctx) return;
+
+   size_t out_size = ZSTD_compress_usingCDict(cctx, &tgt[kHeaderSize], (size_t)capacity, src, (size_t)(*srcsize), cdict);
+   {
+      std::lock_guard<std::mutex> lock(registry.fMutex);
+      registry.fCCtxs.push_back(cctx);
+   }
+   if (ZSTD_isError(out_size) || out_size > 0xffffff) {
+      return;
+   }
+
+   unsigned in_size = (unsigned)(*srcsize);
+   tgt[0] = 'Z';  /* Signature of Zstandard */
+   tgt[1] = 'S';
+   tgt[2] = 2;    /* format version: frame compressed with a dictionary */
+
+   tgt[3] = (char)(out_size & 0xff);
+   tgt[4] = (char)((out_size >> 8) & 0xff);
+   tgt[5] = (char)((out_size >> 16) & 0xff);
+
+   tgt[6] = (char)(in_size & 0xff);         /* decompressed size */
+   tgt[7] = (char)((in_size >> 8) & 0xff);
+   tgt[8] = (char)((in_size >> 16) & 0xff);
+
+   *irep = (int)out_size + kHeaderSize;
+}
+
+extern "C" void R__unzipZSTDDict(int *srcsize, unsigned char *src, int *tgtsize, unsigned char *tgt, int *irep)
+{
+   *irep = 0;
+   size_t framesize = (size_t)(*srcsize - kHeaderSize);
+   unsigned id = ZSTD_getDictID_fromFrame(&src[kHeaderSize], framesize);
+
+   TDictionaryRegistry &registry = TDictionaryRegistry::Get();
+   ZSTD_DDict *ddict = nullptr;
+   ZSTD_DCtx *dctx = nullptr;
+   {
+      std::lock_guard<std::mutex> lock(registry.fMutex);
+      auto found = registry.fDictionaries.find(id);
+      if (found != registry.fDictionaries.end()) {
+         ddict = found->second->fDDict;
+      }
+      if (ddict && !registry.fDCtxs.empty()) {
+         dctx = registry.fDCtxs.back();
+         registry.fDCtxs.pop_back();
+      }
+   }
+   if (!ddict) {
+      fprintf(stderr, "R__unzipZSTD: the Zstd dictionary %u of the buffer is not loaded\n", id);
+      return;
+   }
+   if (!dctx) dctx = ZSTD_createDCtx();
+   if (!dctx) return;
+
+   size_t returnStatus = ZSTD_decompress_usingDDict(dctx, tgt, (size_t)(*tgtsize), &src[kHeaderSize], framesize, ddict);
+   {
+      std::lock_guard<std::mutex> lock(registry.fMutex);
+      registry.fDCtxs.push_back(dctx);
+   }
+   if (ZSTD_isError(returnStatus)) {
+      fprintf(stderr, "R__unzipZSTD: error in ZSTD_decompress_usingDDict: %s\n", ZSTD_getErrorName(returnStatus));
+      return;
+   }
+   *irep = (int)returnStatus;
+}
+
+#else
+
+extern "C" unsigned R__ZSTDTrainDictionary(const char *, const size_t *, unsigned, char *, int *dictsize)
+{
+   *dictsize = 0;
+   return 0;
+}
+
+extern "C" unsigned R__ZSTDAddDictionary(const char *, int)
+{
+   return 0;
+}
+
+extern "C" int R__ZSTDHasDictionary(unsigned)
+{
+   return 0;
+}
+
+extern "C" const char *R__ZSTDGetDictionary(unsigned, int *dictsize)
+{
+   *dictsize = 0;
+   return 0;
+}
+
+extern "C" void R__zipZSTDDict(int cxlevel, int *srcsize, char *src, int *tgtsize, char *tgt, int *irep, unsigned)
+{
+   R__zipZSTD(cxlevel, srcsize, src, tgtsize, tgt, irep);
+}
+
+extern "C" void R__unzipZSTDDict(int *, unsigned char *, int *, unsigned char *, int *irep)
+{
+   fprintf(stderr,
+           "R__unzipZSTD: buffer is Zstd compressed but ROOT was built without Zstd support\n");
+   *irep = 0;
+}
+
+#endif
@@ -217,6 +217,28 @@
    // This is part of the JSON-R code, found on
    // https://github.com/graniteds/jsonr
    // Only unref part was used, arrays are not accounted as objects
+   // restore array written by TBufferJSON in compact form (compact >= 10),
+   // all elements not listed in the blocks "p","v" ("n" for repeated value) are 0
+   JSROOT.JSONR_decode_arr = function(value) {
+      var arr = new Array(value.len), k, i, p, v, n, sfx;
+      for (i = 0; i < value.len; ++i) arr[i] = 0;
+      for (k = 0; ; ++k) {
+         sfx = k ? k.toString() : "";
+         p = value["p" + sfx];
+         if (p === undefined) break;
+         v = value["v" + sfx];
+         n = value["n" + sfx];
+         if (n !== undefined) {
+            for (i = 0; i < n; ++i) arr[p+i] = v;
+         } else if (typeof v === 'object') {
+            for (i = 0; i < v.length; ++i) arr[p+i] = v[i];
+         } else {
+            arr[p] = v;
+         }
+      }
+      return arr;
+   }
+
    JSROOT.JSONR_unref_obj = function(value, dy) {
       var i, fld, proto = Object.prototype.toString.apply(value);
 
@@ -227,8 +249,12 @@
                 if ((fld.length > 5) && (fld.indexOf("$ref:") === 0))
                    value[i] = this.JSONR_unref_str(fld, dy);
              } else
-             if ((typeof fld === 'object') && (fld !== null))
-                this.JSONR_unref_obj(fld, dy);
+             if ((typeof fld === 'object') && (fld !== null)) {
+                if ('$arr' in fld)
+                   value[i] = this.JSONR_decode_arr(fld);
+                else
+                   this.JSONR_unref_obj(fld, dy);
+             }
           }
           return;
       }
@@ -251,8 +277,12 @@
             if ((fld.length > 5) && (fld.indexOf("$ref:") === 0))
                value[i] = this.JSONR_unref_str(fld, dy);
          } else
-         if ((typeof fld === 'object') && (fld !== null))
-            this.JSONR_unref_obj(fld, dy);
+         if ((typeof fld === 'object') && (fld !== null)) {
+            if ('$arr' in fld)
+               value[i] = this.JSONR_decode_arr(fld);
+            else
+               this.JSONR_unref_obj(fld, dy);
+         }
       }
 
       return value;
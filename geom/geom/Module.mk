@@ -22,7 +22,7 @@ GEOMDH       := $(GEOMDS:.cxx=.h)
 GEOMH1       := TGeoAtt.h TGeoStateInfo.h TGeoBoolNode.h \
                 TGeoMedium.h TGeoMaterial.h \
                 TGeoMatrix.h TGeoVolume.h TGeoNode.h \
-                TGeoVoxelFinder.h TGeoShape.h TGeoBBox.h \
+                TGeoVoxelFinder.h TGeoBVHFinder.h TGeoShape.h TGeoBBox.h \
                 TGeoPara.h TGeoTube.h TGeoTorus.h TGeoSphere.h \
                 TGeoEltu.h TGeoHype.h TGeoCone.h TGeoPcon.h \
                 TGeoPgon.h TGeoArb8.h TGeoTrd1.h TGeoTrd2.h \
@@ -48,7 +48,8 @@ public:
    enum EGeoOptimizationAtt {
       kUseBoundingBox   = BIT(16),           // use bounding box for tracking
       kUseVoxels        = BIT(17),           // compute and use voxels
-      kUseGsord         = BIT(18)            // use slicing in G3 style
+      kUseGsord         = BIT(18),           // use slicing in G3 style
+      kUseBVH           = BIT(21)            // use a bounding volume hierarchy instead of voxels
    };                          // tracking optimization attributes
    enum EGeoSavePrimitiveAtt {
       kSavePrimitiveAtt = BIT(19),
@@ -0,0 +1,62 @@
+// @(#)root/geom:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TGeoBVHFinder
+#define ROOT_TGeoBVHFinder
+
+#ifndef ROOT_TGeoVoxelFinder
+#include "TGeoVoxelFinder.h"
+#endif
+
+class TGeoBVHFinder : public TGeoVoxelFinder
+{
+public:
+enum {
+   kMaxDepth    = 64,     // maximum depth of the hierarchy
+   kMaxLeaf     = 4,      // number of daughters below which a node is not split
+   kMaxCompared = 1000    // maximum number of daughters for which the voxels are built and timed
+};
+
+protected:
+   Int_t             fNnodes;         // number of nodes of the hierarchy
+   Int_t             fNnodeBoxes;     // length of the array of node boxes
+   Int_t             fNprims;         // length of the array of daughter indices
+   Bool_t            fUseVoxels;      // the voxels measured faster and are used instead
+   Double_t         *fNodeBoxes;      //[fNnodeBoxes] xmin, xmax, ymin, ymax, zmin, zmax of each node
+   Int_t            *fNodeFirst;      //[fNnodes] first child for nodes, first daughter for leaves
+   Int_t            *fNodeCount;      //[fNnodes] number of daughters of leaves, 0 for nodes
+   Int_t            *fPrims;          //[fNprims] daughter indices ordered by leaf
+
+   TGeoBVHFinder(const TGeoBVHFinder&);
+   TGeoBVHFinder& operator=(const TGeoBVHFinder&);
+
+   void                BuildBVH();
+   void                ClearBVH();
+   void                ClearVoxels();
+   Bool_t              CrossesBox(const Double_t *box, const Double_t *point, TGeoStateInfo &td,
+                                  Double_t step, Double_t &snext) const;
+   Bool_t              MeasureVoxels();
+public :
+   TGeoBVHFinder();
+   TGeoBVHFinder(TGeoVolume *vol);
+   virtual ~TGeoBVHFinder();
+
+   virtual Int_t      *GetCheckList(const Double_t *point, Int_t &nelem, TGeoStateInfo &td);
+   Int_t               GetNnodes() const {return fNnodes;}
+   virtual Int_t      *GetNextVoxel(const Double_t *point, const Double_t *dir, Int_t &ncheck, TGeoStateInfo &td);
+   Bool_t              IsUsingVoxels() const {return fUseVoxels;}
+   virtual void        Print(Option_t *option="") const;
+   virtual void        SortCrossedVoxels(const Double_t *point, const Double_t *dir, TGeoStateInfo &td);
+   virtual void        Voxelize(Option_t *option="");
+
+   ClassDef(TGeoBVHFinder, 1)                // bounding volume hierarchy finder class
+};
+
+#endif
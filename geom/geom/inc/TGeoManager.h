@@ -43,6 +43,7 @@ protected:
    static Int_t          fgMaxLevel;        //! Maximum level in geometry
    static Int_t          fgMaxDaughters;    //! Maximum number of daughters
    static Int_t          fgMaxXtruVert;     //! Maximum number of Xtru vertices
+   static Int_t          fgBVHThreshold;    //! Minimum number of daughters of volumes using a BVH
 
    TGeoManager(const TGeoManager&);
    TGeoManager& operator=(const TGeoManager&);
@@ -103,6 +104,8 @@ private :
    static ThreadsMap_t  *fgThreadId;        //! Thread id's map
    static Int_t          fgNumThreads;      //! Number of registered threads
    static Bool_t         fgLockNavigators;   //! Lock existing navigators
+   static Int_t          fgNavigatorsTags;  //! Last tag given to the navigators of a manager
+   Int_t                 fNavigatorsTag;    //! Tag of the navigator arrays, validating the per-thread caches
    TGeoNavigator        *fCurrentNavigator; //! current navigator
    TGeoVolume           *fCurrentVolume;    //! current volume
    TGeoVolume           *fTopVolume;        //! top level volume in geometry
@@ -429,6 +432,8 @@ public:
    static Int_t           GetMaxDaughters();
    static Int_t           GetMaxLevels();
    static Int_t           GetMaxXtruVert();
+   static Int_t           GetBVHThreshold();
+   static void            SetBVHThreshold(Int_t ndaughters);
    Int_t                  GetMaxThreads() const {return fMaxThreads-1;}
    void                   SetMaxThreads(Int_t nthreads);
    void                   SetMultiThread(Bool_t flag=kTRUE) {fMultiThread = flag;}
@@ -164,6 +164,7 @@ public:
    Bool_t          IsSelected() const  {return TObject::TestBit(kVolumeSelected);}
    Bool_t          IsCylVoxels() const {return TObject::TestBit(kVoxelsCyl);}
    Bool_t          IsXYZVoxels() const {return TObject::TestBit(kVoxelsXYZ);}
+   Bool_t          IsUsingBVH() const {return TGeoAtt::TestAttBit(kUseBVH);}
    Bool_t          IsTopVolume() const;
    Bool_t          IsValid() const {return fShape->IsValid();}
    virtual Bool_t  IsVisible() const {return TGeoAtt::IsVisible();}
@@ -230,6 +231,7 @@ public:
    void            SetNodes(TObjArray *nodes) {fNodes = nodes; TObject::SetBit(kVolumeImportNodes);}
    void            SetOverlappingCandidate(Bool_t flag) {TObject::SetBit(kVolumeOC,flag);}
    void            SetShape(const TGeoShape *shape);
+   void            SetUseBVH(Bool_t flag=kTRUE) {TGeoAtt::SetAttBit(kUseBVH, flag);}
    void            SetTransparency(Char_t transparency=0) {if (fMedium) fMedium->GetMaterial()->SetTransparency(transparency);} // *MENU*
    void            SetField(TObject *field)          {fField = field;}
    void            SetOption(const char *option);
@@ -1052,7 +1052,18 @@ void TGeoBBox::FillBuffer3D(TBuffer3D & buffer, Int_t reqSections, Bool_t localF
 
 void TGeoBBox::Contains_v(const Double_t *points, Bool_t *inside, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+   if (IsA() != TGeoBBox::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+      return;
+   }
+   const Double_t dx = fDX, dy = fDY, dz = fDZ;
+   const Double_t ox = fOrigin[0], oy = fOrigin[1], oz = fOrigin[2];
+   for (Int_t i=0; i<vecsize; i++) {
+      const Double_t *point = &points[3*i];
+      inside[i] = !((TMath::Abs(point[0]-ox) > dx) | (TMath::Abs(point[1]-oy) > dy) |
+                    (TMath::Abs(point[2]-oz) > dz));
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1070,7 +1081,12 @@ void TGeoBBox::ComputeNormal_v(const Double_t *points, const Double_t *dirs, Dou
 
 void TGeoBBox::DistFromInside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoBBox::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoBBox::DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1078,7 +1094,12 @@ void TGeoBBox::DistFromInside_v(const Double_t *points, const Double_t *dirs, Do
 
 void TGeoBBox::DistFromOutside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoBBox::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoBBox::DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1088,5 +1109,20 @@ void TGeoBBox::DistFromOutside_v(const Double_t *points, const Double_t *dirs, D
 
 void TGeoBBox::Safety_v(const Double_t *points, const Bool_t *inside, Double_t *safe, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+   if (IsA() != TGeoBBox::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+      return;
+   }
+   const Double_t dx = fDX, dy = fDY, dz = fDZ;
+   const Double_t ox = fOrigin[0], oy = fOrigin[1], oz = fOrigin[2];
+   for (Int_t i=0; i<vecsize; i++) {
+      const Double_t *point = &points[3*i];
+      Double_t ax = TMath::Abs(point[0]-ox);
+      Double_t ay = TMath::Abs(point[1]-oy);
+      Double_t az = TMath::Abs(point[2]-oz);
+      Double_t safin  = TMath::Min(TMath::Min(dx-ax, dy-ay), dz-az);
+      Double_t safout = TMath::Max(TMath::Max(-dx+ax, -dy+ay), -dz+az);
+      safe[i] = inside[i] ? safin : safout;
+   }
 }
@@ -0,0 +1,612 @@
+// @(#)root/geom:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TGeoBVHFinder
+\ingroup Geometry_classes
+
+Finder class using a bounding volume hierarchy of the daughters of a volume.
+
+The voxels of TGeoVoxelFinder slice the volume along each axis at all the
+boundaries of the bounding boxes of the daughters. For volumes having
+many daughters in an irregular layout, the number of slices and the
+lists of candidates per slice grow quickly, and so do the time and the
+memory needed by the voxelization. TGeoBVHFinder instead groups the
+bounding boxes of the daughters in a binary tree of boxes, built with the
+surface area heuristic and stored in flat arrays. The tree is used:
+
+  - by GetCheckList() to find the daughters whose bounding box contains a
+    point, as needed by TGeoNavigator::FindNode();
+  - by SortCrossedVoxels() and GetNextVoxel() to find the daughters whose
+    bounding box is crossed by a ray before the current step, as needed
+    by TGeoNavigator::FindNextDaughterBoundary(). The tree is traversed
+    front to back and the nodes beyond the current step are skipped.
+
+For volumes with less than kMaxCompared daughters the voxels are built as
+well; both structures are timed on random points of the volume and only
+the faster one is kept. The candidates returned for a point are sorted
+by daughter index, as the ones of the voxels.
+
+A volume uses this finder if TGeoVolume::SetUseBVH() was called, or if it
+has at least TGeoManager::GetBVHThreshold() daughters.
+*/
+
+#include "TGeoBVHFinder.h"
+
+#include "TMath.h"
+#include "TRandom3.h"
+#include "TGeoBBox.h"
+#include "TGeoNode.h"
+#include "TGeoVolume.h"
+#include "TGeoManager.h"
+#include "TGeoStateInfo.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+ClassImp(TGeoBVHFinder)
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Builder of the hierarchy. The boxes of the daughters are given as in
+/// TGeoVoxelFinder (dx, dy, dz, ox, oy, oz) and the boxes of the nodes are
+/// stored as (xmin, xmax, ymin, ymax, zmin, zmax).
+
+struct TGeoBVHBuilder {
+   enum { kNbins = 16 };
+   const Double_t        *fBoxes;       // boxes of the daughters
+   Double_t               fTolerance;   // margin added to the boxes of the daughters
+   std::vector<Int_t>     fPrims;       // daughter indices, reordered by leaf
+   std::vector<Double_t>  fNodeBoxes;   // boxes of the nodes
+   std::vector<Int_t>     fFirst;       // first child or first daughter of the nodes
+   std::vector<Int_t>     fCount;       // number of daughters of the leaves
+
+   void     AddNode();
+   void     Build(Int_t inode, Int_t first, Int_t n, Int_t depth);
+   Double_t Centroid(Int_t prim, Int_t axis) const {return fBoxes[6*prim+3+axis];}
+   void     Extend(Double_t *box, Int_t prim) const;
+   static Double_t HalfArea(const Double_t *box);
+   static void     Reset(Double_t *box);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Append an empty node.
+
+void TGeoBVHBuilder::AddNode()
+{
+   fNodeBoxes.resize(fNodeBoxes.size()+6);
+   fFirst.push_back(0);
+   fCount.push_back(0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Extend a node box to contain the box of daughter prim.
+
+void TGeoBVHBuilder::Extend(Double_t *box, Int_t prim) const
+{
+   const Double_t *b = &fBoxes[6*prim];
+   for (Int_t i=0; i<3; i++) {
+      box[2*i]   = TMath::Min(box[2*i],   b[i+3]-b[i]-fTolerance);
+      box[2*i+1] = TMath::Max(box[2*i+1], b[i+3]+b[i]+fTolerance);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Half of the surface area of a node box.
+
+Double_t TGeoBVHBuilder::HalfArea(const Double_t *box)
+{
+   Double_t dx = box[1]-box[0];
+   Double_t dy = box[3]-box[2];
+   Double_t dz = box[5]-box[4];
+   if (dx<0 || dy<0 || dz<0) return 0.;
+   return dx*dy+dy*dz+dz*dx;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Make a node box empty.
+
+void TGeoBVHBuilder::Reset(Double_t *box)
+{
+   for (Int_t i=0; i<3; i++) {
+      box[2*i]   =  TGeoShape::Big();
+      box[2*i+1] = -TGeoShape::Big();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Build node inode from the n daughters fPrims[first ... first+n-1]. The
+/// split minimizes the surface area heuristic over kNbins bins of the box
+/// centres on each axis.
+
+void TGeoBVHBuilder::Build(Int_t inode, Int_t first, Int_t n, Int_t depth)
+{
+   Double_t box[6];
+   Reset(box);
+   Double_t cmin[3], cmax[3];
+   Int_t i, j;
+   for (j=0; j<3; j++) {
+      cmin[j] =  TGeoShape::Big();
+      cmax[j] = -TGeoShape::Big();
+   }
+   for (i=first; i<first+n; i++) {
+      Extend(box, fPrims[i]);
+      for (j=0; j<3; j++) {
+         cmin[j] = TMath::Min(cmin[j], Centroid(fPrims[i], j));
+         cmax[j] = TMath::Max(cmax[j], Centroid(fPrims[i], j));
+      }
+   }
+   memcpy(&fNodeBoxes[6*inode], box, 6*sizeof(Double_t));
+   fFirst[inode] = first;
+   fCount[inode] = n;
+   if (n <= TGeoBVHFinder::kMaxLeaf || depth >= TGeoBVHFinder::kMaxDepth) return;
+
+   // find the best split among the bins of each axis
+   Double_t area = HalfArea(box);
+   if (area <= 0) area = 1.;
+   Double_t bestcost = TGeoShape::Big();
+   Int_t bestaxis = -1;
+   Int_t bestbin = 0;
+   Int_t nbin[kNbins];
+   Double_t binbox[kNbins][6];
+   Double_t rightcost[kNbins];
+   for (j=0; j<3; j++) {
+      Double_t extent = cmax[j]-cmin[j];
+      if (extent <= 0) continue;
+      for (i=0; i<kNbins; i++) {
+         nbin[i] = 0;
+         Reset(binbox[i]);
+      }
+      for (i=first; i<first+n; i++) {
+         Int_t ibin = Int_t(kNbins*(Centroid(fPrims[i], j)-cmin[j])/extent);
+         if (ibin >= kNbins) ibin = kNbins-1;
+         nbin[ibin]++;
+         Extend(binbox[ibin], fPrims[i]);
+      }
+      // cost of the right side for a split before bin i
+      Double_t acc[6];
+      Reset(acc);
+      Int_t nacc = 0;
+      for (i=kNbins-1; i>0; i--) {
+         nacc += nbin[i];
+         for (Int_t k=0; k<3; k++) {
+            acc[2*k]   = TMath::Min(acc[2*k],   binbox[i][2*k]);
+            acc[2*k+1] = TMath::Max(acc[2*k+1], binbox[i][2*k+1]);
+         }
+         rightcost[i] = nacc*HalfArea(acc);
+      }
+      Reset(acc);
+      nacc = 0;
+      for (i=1; i<kNbins; i++) {
+         nacc += nbin[i-1];
+         for (Int_t k=0; k<3; k++) {
+            acc[2*k]   = TMath::Min(acc[2*k],   binbox[i-1][2*k]);
+            acc[2*k+1] = TMath::Max(acc[2*k+1], binbox[i-1][2*k+1]);
+         }
+         if (nacc==0 || nacc==n) continue;
+         Double_t cost = 1. + (nacc*HalfArea(acc) + rightcost[i])/area;
+         if (cost < bestcost) {
+            bestcost = cost;
+            bestaxis = j;
+            bestbin = i;
+         }
+      }
+   }
+
+   Int_t nleft = n/2;
+   if (bestaxis >= 0) {
+      // keep a leaf if no split is cheaper than checking all its daughters
+      if (bestcost >= n && n <= 4*TGeoBVHFinder::kMaxLeaf) return;
+      Double_t extent = cmax[bestaxis]-cmin[bestaxis];
+      Int_t ileft = first;
+      Int_t iright = first+n-1;
+      while (ileft <= iright) {
+         Int_t ibin = Int_t(kNbins*(Centroid(fPrims[ileft], bestaxis)-cmin[bestaxis])/extent);
+         if (ibin >= kNbins) ibin = kNbins-1;
+         if (ibin < bestbin) {
+            ileft++;
+         } else {
+            std::swap(fPrims[ileft], fPrims[iright]);
+            iright--;
+         }
+      }
+      nleft = ileft-first;
+   } else if (n <= 4*TGeoBVHFinder::kMaxLeaf) {
+      // all box centres coincide
+      return;
+   }
+
+   Int_t left = fFirst.size();
+   AddNode();
+   AddNode();
+   fFirst[inode] = left;
+   fCount[inode] = 0;
+   Build(left, first, nleft, depth+1);
+   Build(left+1, first+nleft, n-nleft, depth+1);
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Default constructor
+
+TGeoBVHFinder::TGeoBVHFinder()
+              :TGeoVoxelFinder(),
+               fNnodes(0),
+               fNnodeBoxes(0),
+               fNprims(0),
+               fUseVoxels(kFALSE),
+               fNodeBoxes(0),
+               fNodeFirst(0),
+               fNodeCount(0),
+               fPrims(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor for a given volume
+
+TGeoBVHFinder::TGeoBVHFinder(TGeoVolume *vol)
+              :TGeoVoxelFinder(vol),
+               fNnodes(0),
+               fNnodeBoxes(0),
+               fNprims(0),
+               fUseVoxels(kFALSE),
+               fNodeBoxes(0),
+               fNodeFirst(0),
+               fNodeCount(0),
+               fPrims(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///copy constructor
+
+TGeoBVHFinder::TGeoBVHFinder(const TGeoBVHFinder& vf) :
+  TGeoVoxelFinder(vf),
+  fNnodes(vf.fNnodes),
+  fNnodeBoxes(vf.fNnodeBoxes),
+  fNprims(vf.fNprims),
+  fUseVoxels(vf.fUseVoxels),
+  fNodeBoxes(vf.fNodeBoxes),
+  fNodeFirst(vf.fNodeFirst),
+  fNodeCount(vf.fNodeCount),
+  fPrims(vf.fPrims)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///assignment operator
+
+TGeoBVHFinder& TGeoBVHFinder::operator=(const TGeoBVHFinder& vf)
+{
+   if(this!=&vf) {
+      TGeoVoxelFinder::operator=(vf);
+      fNnodes=vf.fNnodes;
+      fNnodeBoxes=vf.fNnodeBoxes;
+      fNprims=vf.fNprims;
+      fUseVoxels=vf.fUseVoxels;
+      fNodeBoxes=vf.fNodeBoxes;
+      fNodeFirst=vf.fNodeFirst;
+      fNodeCount=vf.fNodeCount;
+      fPrims=vf.fPrims;
+   }
+   return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor
+
+TGeoBVHFinder::~TGeoBVHFinder()
+{
+   ClearBVH();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Build the hierarchy from the bounding boxes of the daughters.
+
+void TGeoBVHFinder::BuildBVH()
+{
+   ClearBVH();
+   Int_t nd = fVolume->GetNdaughters();
+   if (!nd || !fBoxes) return;
+   TGeoBVHBuilder builder;
+   builder.fBoxes = fBoxes;
+   builder.fTolerance = TGeoShape::Tolerance();
+   builder.fPrims.resize(nd);
+   for (Int_t id=0; id<nd; id++) builder.fPrims[id] = id;
+   builder.fNodeBoxes.reserve(12*nd);
+   builder.fFirst.reserve(2*nd);
+   builder.fCount.reserve(2*nd);
+   builder.AddNode();
+   builder.Build(0, 0, nd, 0);
+
+   fNnodes = builder.fFirst.size();
+   fNnodeBoxes = 6*fNnodes;
+   fNprims = nd;
+   fNodeBoxes = new Double_t[fNnodeBoxes];
+   fNodeFirst = new Int_t[fNnodes];
+   fNodeCount = new Int_t[fNnodes];
+   fPrims = new Int_t[fNprims];
+   memcpy(fNodeBoxes, &builder.fNodeBoxes[0], fNnodeBoxes*sizeof(Double_t));
+   memcpy(fNodeFirst, &builder.fFirst[0], fNnodes*sizeof(Int_t));
+   memcpy(fNodeCount, &builder.fCount[0], fNnodes*sizeof(Int_t));
+   memcpy(fPrims, &builder.fPrims[0], fNprims*sizeof(Int_t));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete the hierarchy.
+
+void TGeoBVHFinder::ClearBVH()
+{
+   delete [] fNodeBoxes;
+   delete [] fNodeFirst;
+   delete [] fNodeCount;
+   delete [] fPrims;
+   fNodeBoxes = 0;
+   fNodeFirst = 0;
+   fNodeCount = 0;
+   fPrims = 0;
+   fNnodes = fNnodeBoxes = fNprims = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete the slices of the voxels, keeping the bounding boxes of the daughters.
+
+void TGeoBVHFinder::ClearVoxels()
+{
+   delete [] fXb;      fXb = 0;
+   delete [] fYb;      fYb = 0;
+   delete [] fZb;      fZb = 0;
+   delete [] fOBx;     fOBx = 0;
+   delete [] fOBy;     fOBy = 0;
+   delete [] fOBz;     fOBz = 0;
+   delete [] fOEx;     fOEx = 0;
+   delete [] fOEy;     fOEy = 0;
+   delete [] fOEz;     fOEz = 0;
+   delete [] fExtraX;  fExtraX = 0;
+   delete [] fExtraY;  fExtraY = 0;
+   delete [] fExtraZ;  fExtraZ = 0;
+   delete [] fNsliceX; fNsliceX = 0;
+   delete [] fNsliceY; fNsliceY = 0;
+   delete [] fNsliceZ; fNsliceZ = 0;
+   delete [] fIndcX;   fIndcX = 0;
+   delete [] fIndcY;   fIndcY = 0;
+   delete [] fIndcZ;   fIndcZ = 0;
+   fIbx = fIby = fIbz = 0;
+   fNox = fNoy = fNoz = 0;
+   fNex = fNey = fNez = 0;
+   fNx = fNy = fNz = 0;
+   memset(fPriority, 0, 3*sizeof(Int_t));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Check if the ray starting at point, with the inverse direction stored in
+/// td by SortCrossedVoxels(), crosses a box (xmin, xmax, ... zmax) before
+/// step. The distance to enter the box (0 if inside) is returned in snext.
+
+Bool_t TGeoBVHFinder::CrossesBox(const Double_t *box, const Double_t *point, TGeoStateInfo &td,
+                                 Double_t step, Double_t &snext) const
+{
+   Double_t tmin = 0.;
+   Double_t tmax = step;
+   for (Int_t i=0; i<3; i++) {
+      if (!td.fVoxInc[i]) {
+         if (point[i]<box[2*i] || point[i]>box[2*i+1]) return kFALSE;
+         continue;
+      }
+      Double_t t1 = (box[2*i]-point[i])*td.fVoxInvdir[i];
+      Double_t t2 = (box[2*i+1]-point[i])*td.fVoxInvdir[i];
+      if (t1 > t2) std::swap(t1, t2);
+      if (t1 > tmin) tmin = t1;
+      if (t2 < tmax) tmax = t2;
+      if (tmin > tmax) return kFALSE;
+   }
+   snext = tmin;
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Time the voxels and the hierarchy on random points of the volume and
+/// return true if the voxels are faster.
+
+Bool_t TGeoBVHFinder::MeasureVoxels()
+{
+   const Int_t npoints = 4096;
+   TGeoBBox *box = (TGeoBBox*)fVolume->GetShape();
+   const Double_t *orig = box->GetOrigin();
+   Double_t dd[3] = {box->GetDX(), box->GetDY(), box->GetDZ()};
+   std::vector<Double_t> points(3*npoints);
+   TRandom3 rnd(4357);
+   for (Int_t i=0; i<3*npoints; i++) points[i] = orig[i%3] + dd[i%3]*rnd.Uniform(-1., 1.);
+   TGeoStateInfo td(fVolume->GetNdaughters());
+   Int_t ncheck;
+   Double_t tvoxels = TGeoShape::Big();
+   Double_t tbvh = TGeoShape::Big();
+   for (Int_t irep=0; irep<3; irep++) {
+      auto t0 = std::chrono::steady_clock::now();
+      for (Int_t i=0; i<npoints; i++) TGeoVoxelFinder::GetCheckList(&points[3*i], ncheck, td);
+      auto t1 = std::chrono::steady_clock::now();
+      for (Int_t i=0; i<npoints; i++) TGeoBVHFinder::GetCheckList(&points[3*i], ncheck, td);
+      auto t2 = std::chrono::steady_clock::now();
+      tvoxels = TMath::Min(tvoxels, std::chrono::duration<Double_t>(t1-t0).count());
+      tbvh = TMath::Min(tbvh, std::chrono::duration<Double_t>(t2-t1).count());
+   }
+   return (tvoxels < tbvh);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// get the list of daughter indices for which point is inside their bbox
+
+Int_t *TGeoBVHFinder::GetCheckList(const Double_t *point, Int_t &nelem, TGeoStateInfo &td)
+{
+   if (NeedRebuild()) {
+      Voxelize();
+      fVolume->FindOverlaps();
+   }
+   if (fUseVoxels) return TGeoVoxelFinder::GetCheckList(point, nelem, td);
+   nelem = 0;
+   td.fVoxNcandidates = 0;
+   if (!fNnodes) return 0;
+   Double_t tol = TGeoShape::Tolerance();
+   Int_t stack[kMaxDepth+2];
+   Int_t nstack = 0;
+   stack[nstack++] = 0;
+   while (nstack) {
+      Int_t inode = stack[--nstack];
+      const Double_t *box = &fNodeBoxes[6*inode];
+      if (point[0]<box[0] || point[0]>box[1] ||
+          point[1]<box[2] || point[1]>box[3] ||
+          point[2]<box[4] || point[2]>box[5]) continue;
+      if (!fNodeCount[inode]) {
+         stack[nstack++] = fNodeFirst[inode]+1;
+         stack[nstack++] = fNodeFirst[inode];
+         continue;
+      }
+      for (Int_t i=fNodeFirst[inode]; i<fNodeFirst[inode]+fNodeCount[inode]; i++) {
+         Int_t ist = 6*fPrims[i];
+         if (TMath::Abs(point[0]-fBoxes[ist+3]) > fBoxes[ist]+tol) continue;
+         if (TMath::Abs(point[1]-fBoxes[ist+4]) > fBoxes[ist+1]+tol) continue;
+         if (TMath::Abs(point[2]-fBoxes[ist+5]) > fBoxes[ist+2]+tol) continue;
+         td.fVoxCheckList[nelem++] = fPrims[i];
+      }
+   }
+   if (!nelem) return 0;
+   std::sort(td.fVoxCheckList, td.fVoxCheckList+nelem);
+   td.fVoxNcandidates = nelem;
+   return td.fVoxCheckList;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Prepare the traversal of the hierarchy by a ray. The nodes still to be
+/// visited are stacked at the end of td.fVoxCheckList, the candidates of a
+/// leaf are returned at its beginning: the daughters of the pending nodes
+/// and of the current leaf being distinct, both fit in the list.
+
+void TGeoBVHFinder::SortCrossedVoxels(const Double_t *point, const Double_t *dir, TGeoStateInfo &td)
+{
+   if (NeedRebuild()) {
+      Voxelize();
+      fVolume->FindOverlaps();
+   }
+   if (fUseVoxels) {
+      TGeoVoxelFinder::SortCrossedVoxels(point, dir, td);
+      return;
+   }
+   td.fVoxCurrent = 0;
+   td.fVoxNcandidates = 0;
+   for (Int_t i=0; i<3; i++) {
+      td.fVoxInc[i] = 0;
+      td.fVoxInvdir[i] = TGeoShape::Big();
+      if (TMath::Abs(dir[i])<1E-10) continue;
+      td.fVoxInc[i] = (dir[i]>0)?1:-1;
+      td.fVoxInvdir[i] = 1./dir[i];
+   }
+   if (!fNnodes) return;
+   Int_t nd = fVolume->GetNdaughters();
+   td.fVoxCheckList[nd-1] = 0;
+   td.fVoxNcandidates = 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// get the list of daughters of the next leaf crossed by the ray before the
+/// current step, most often the nearest one
+
+Int_t *TGeoBVHFinder::GetNextVoxel(const Double_t *point, const Double_t *dir, Int_t &ncheck, TGeoStateInfo &td)
+{
+   if (fUseVoxels) return TGeoVoxelFinder::GetNextVoxel(point, dir, ncheck, td);
+   ncheck = 0;
+   Int_t *stack = td.fVoxCheckList + fVolume->GetNdaughters() - 1;
+   Double_t step = gGeoManager->GetStep();
+   Double_t tol = TGeoShape::Tolerance();
+   Double_t snext, sleft, sright;
+   Double_t pbox[6];
+   while (td.fVoxNcandidates) {
+      Int_t inode = *(stack - (--td.fVoxNcandidates));
+      if (!CrossesBox(&fNodeBoxes[6*inode], point, td, step, snext)) continue;
+      if (fNodeCount[inode]) {
+         for (Int_t i=fNodeFirst[inode]; i<fNodeFirst[inode]+fNodeCount[inode]; i++) {
+            Int_t ist = 6*fPrims[i];
+            for (Int_t j=0; j<3; j++) {
+               pbox[2*j]   = fBoxes[ist+j+3]-fBoxes[ist+j]-tol;
+               pbox[2*j+1] = fBoxes[ist+j+3]+fBoxes[ist+j]+tol;
+            }
+            if (CrossesBox(pbox, point, td, step, snext)) td.fVoxCheckList[ncheck++] = fPrims[i];
+         }
+         if (ncheck) return td.fVoxCheckList;
+         continue;
+      }
+      // push the farther child first, so that the nearer one is visited next
+      Int_t left = fNodeFirst[inode];
+      Bool_t hleft = CrossesBox(&fNodeBoxes[6*left], point, td, step, sleft);
+      Bool_t hright = CrossesBox(&fNodeBoxes[6*(left+1)], point, td, step, sright);
+      if (hleft && hright) {
+         if (sleft <= sright) {
+            *(stack - td.fVoxNcandidates++) = left+1;
+            *(stack - td.fVoxNcandidates++) = left;
+         } else {
+            *(stack - td.fVoxNcandidates++) = left;
+            *(stack - td.fVoxNcandidates++) = left+1;
+         }
+      } else if (hleft) {
+         *(stack - td.fVoxNcandidates++) = left;
+      } else if (hright) {
+         *(stack - td.fVoxNcandidates++) = left+1;
+      }
+   }
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the hierarchy, or the voxels if they are used.
+
+void TGeoBVHFinder::Print(Option_t *option) const
+{
+   if (fUseVoxels) {
+      printf("BVH of volume %s: the voxels measured faster\n", fVolume->GetName());
+      TGeoVoxelFinder::Print(option);
+      return;
+   }
+   Int_t nleaves = 0;
+   for (Int_t i=0; i<fNnodes; i++) if (fNodeCount[i]) nleaves++;
+   printf("BVH of volume %s: %d daughters, %d nodes, %d leaves\n",
+          fVolume->GetName(), fNprims, fNnodes, nleaves);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Build the hierarchy of the attached volume. For volumes with less than
+/// kMaxCompared daughters the voxels are built too and kept instead of the
+/// hierarchy if they measure faster.
+
+void TGeoBVHFinder::Voxelize(Option_t *option)
+{
+   ClearBVH();
+   fUseVoxels = kFALSE;
+   Int_t nd = fVolume->GetNdaughters();
+   Bool_t compare = (nd < kMaxCompared);
+   if (compare) {
+      TGeoVoxelFinder::Voxelize(option);
+   } else {
+      ClearVoxels();
+      if (fVolume->IsAssembly()) fVolume->GetShape()->ComputeBBox();
+      for (Int_t i=0; i<nd; i++) {
+         TGeoVolume *vd = fVolume->GetNode(i)->GetVolume();
+         if (vd->IsAssembly()) vd->GetShape()->ComputeBBox();
+      }
+      BuildVoxelLimits();
+   }
+   BuildBVH();
+   SetNeedRebuild(kFALSE);
+   if (!compare || !fNnodes) return;
+   fUseVoxels = MeasureVoxels();
+   if (fUseVoxels) ClearBVH();
+   else            ClearVoxels();
+}
@@ -1153,7 +1153,12 @@ const TBuffer3D & TGeoCone::GetBuffer3D(Int_t reqSections, Bool_t localFrame) co
 
 void TGeoCone::Contains_v(const Double_t *points, Bool_t *inside, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+   if (IsA() != TGeoCone::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) inside[i] = TGeoCone::Contains(&points[3*i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1171,7 +1176,12 @@ void TGeoCone::ComputeNormal_v(const Double_t *points, const Double_t *dirs, Dou
 
 void TGeoCone::DistFromInside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoCone::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoCone::DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1179,7 +1189,12 @@ void TGeoCone::DistFromInside_v(const Double_t *points, const Double_t *dirs, Do
 
 void TGeoCone::DistFromOutside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoCone::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoCone::DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1189,7 +1204,12 @@ void TGeoCone::DistFromOutside_v(const Double_t *points, const Double_t *dirs, D
 
 void TGeoCone::Safety_v(const Double_t *points, const Bool_t *inside, Double_t *safe, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+   if (IsA() != TGeoCone::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) safe[i] = TGeoCone::Safety(&points[3*i], inside[i]);
 }
 
 ClassImp(TGeoConeSeg)
@@ -2447,7 +2467,12 @@ Bool_t TGeoConeSeg::GetPointsOnSegments(Int_t npoints, Double_t *array) const
 
 void TGeoConeSeg::Contains_v(const Double_t *points, Bool_t *inside, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+   if (IsA() != TGeoConeSeg::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) inside[i] = TGeoConeSeg::Contains(&points[3*i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2465,7 +2490,12 @@ void TGeoConeSeg::ComputeNormal_v(const Double_t *points, const Double_t *dirs,
 
 void TGeoConeSeg::DistFromInside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoConeSeg::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoConeSeg::DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2473,7 +2503,12 @@ void TGeoConeSeg::DistFromInside_v(const Double_t *points, const Double_t *dirs,
 
 void TGeoConeSeg::DistFromOutside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoConeSeg::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoConeSeg::DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2483,5 +2518,10 @@ void TGeoConeSeg::DistFromOutside_v(const Double_t *points, const Double_t *dirs
 
 void TGeoConeSeg::Safety_v(const Double_t *points, const Bool_t *inside, Double_t *safe, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+   if (IsA() != TGeoConeSeg::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) safe[i] = TGeoConeSeg::Safety(&points[3*i], inside[i]);
 }
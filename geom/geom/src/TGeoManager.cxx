@@ -235,6 +235,7 @@ in order to enhance rays.
 */
 
 #include <stdlib.h>
+#include <vector>
 
 #include "Riostream.h"
 
@@ -282,6 +283,11 @@ in order to enhance rays.
 #include "TMath.h"
 #include "TEnv.h"
 #include "TGeoParallelWorld.h"
+#include "ROOT/TSeq.hxx"
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 
 // statics and globals
 
@@ -295,7 +301,9 @@ Int_t  TGeoManager::fgVerboseLevel = 1;
 Int_t  TGeoManager::fgMaxLevel = 1;
 Int_t  TGeoManager::fgMaxDaughters = 1;
 Int_t  TGeoManager::fgMaxXtruVert = 1;
+Int_t  TGeoManager::fgBVHThreshold = 0;
 Int_t  TGeoManager::fgNumThreads   = 0;
+Int_t  TGeoManager::fgNavigatorsTags = 0;
 TGeoManager::ThreadsMap_t *TGeoManager::fgThreadId = 0;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -370,6 +378,7 @@ TGeoManager::TGeoManager()
       fMultiThread = kFALSE;
       fRaytraceMode = 0;
       fMaxThreads = 0;
+      fNavigatorsTag = ++fgNavigatorsTags;
       fUsePWNav = kFALSE;
       fParallelWorld = 0;
       ClearThreadsMap();
@@ -472,6 +481,7 @@ void TGeoManager::Init()
    fMultiThread = kFALSE;
    fRaytraceMode = 0;
    fMaxThreads = 0;
+   fNavigatorsTag = ++fgNavigatorsTags;
    fUsePWNav = kFALSE;
    fParallelWorld = 0;
    ClearThreadsMap();
@@ -552,6 +562,7 @@ TGeoManager::TGeoManager(const TGeoManager& gm) :
 {
    for(Int_t i=0; i<1024; i++)
       fPdgId[i]=gm.fPdgId[i];
+   fNavigatorsTag = ++fgNavigatorsTags;
    if (!fgThreadId) fgThreadId = new TGeoManager::ThreadsMap_t;
    ClearThreadsMap();
 }
@@ -631,6 +642,7 @@ TGeoManager& TGeoManager::operator=(const TGeoManager& gm)
       fMultiThread = kFALSE;
       fRaytraceMode = 0;
       fMaxThreads = 0;
+      fNavigatorsTag = ++fgNavigatorsTags;
       fUsePWNav = kFALSE;
       fParallelWorld = 0;
       ClearThreadsMap();
@@ -802,7 +814,9 @@ Int_t TGeoManager::AddVolume(TGeoVolume *volume)
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Add a navigator in the list of navigators. If it is the first one make it
-/// current navigator.
+/// current navigator. In multi-threaded mode, the thread data of the geometry
+/// objects is extended when the calling thread is the first one beyond the
+/// number of threads declared with SetMaxThreads.
 
 TGeoNavigator *TGeoManager::AddNavigator()
 {
@@ -821,26 +835,39 @@ TGeoNavigator *TGeoManager::AddNavigator()
    }
    TGeoNavigator *nav = array->AddNavigator();
    if (fClosed) nav->GetCache()->BuildInfoBranch();
-   if (fMultiThread) TThread::UnLock();
+   if (fMultiThread) {
+      Int_t tid = ThreadId();
+      if (tid >= fMaxThreads) {
+         fMaxThreads = TMath::Max(tid+1, 2*fMaxThreads);
+         CreateThreadData();
+      }
+      TThread::UnLock();
+   }
    return nav;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns current navigator for the calling thread.
+///
+/// In multi-threaded mode the navigator array of the thread is looked up once
+/// under lock and then kept in a thread-local slot, so that the lookup does
+/// not lock nor search the map of navigators. The slot is valid while the
+/// manager and the tag of its navigator arrays are the same, the tag being
+/// changed whenever navigator arrays are deleted.
 
 TGeoNavigator *TGeoManager::GetCurrentNavigator() const
 {
-   TTHREAD_TLS(TGeoNavigator*) tnav = 0;
    if (!fMultiThread) return fCurrentNavigator;
-   TGeoNavigator *nav = tnav; // TTHREAD_TLS_GET(TGeoNavigator*,tnav);
-   if (nav) return nav;
-   Long_t threadId = TThread::SelfId();
-   NavigatorsMap_t::const_iterator it = fNavigators.find(threadId);
-   if (it == fNavigators.end()) return 0;
-   TGeoNavigatorArray *array = it->second;
-   nav = array->GetCurrentNavigator();
-   tnav = nav; // TTHREAD_TLS_SET(TGeoNavigator*,tnav,nav);
-   return nav;
+   TTHREAD_TLS(const TGeoManager*) tmanager = 0;
+   TTHREAD_TLS(Int_t) ttag = 0;
+   TTHREAD_TLS(TGeoNavigatorArray*) tarray = 0;
+   if (tmanager == this && ttag == fNavigatorsTag) return tarray->GetCurrentNavigator();
+   TGeoNavigatorArray *array = GetListOfNavigators();
+   if (!array) return 0;
+   tmanager = this;
+   ttag = fNavigatorsTag;
+   tarray = array;
+   return array->GetCurrentNavigator();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -848,10 +875,11 @@ TGeoNavigator *TGeoManager::GetCurrentNavigator() const
 
 TGeoNavigatorArray *TGeoManager::GetListOfNavigators() const
 {
+   if (fMultiThread) TThread::Lock();
    Long_t threadId = fMultiThread ? TThread::SelfId() : 0;
    NavigatorsMap_t::const_iterator it = fNavigators.find(threadId);
-   if (it == fNavigators.end()) return 0;
-   TGeoNavigatorArray *array = it->second;
+   TGeoNavigatorArray *array = (it == fNavigators.end()) ? 0 : it->second;
+   if (fMultiThread) TThread::UnLock();
    return array;
 }
 
@@ -860,16 +888,14 @@ TGeoNavigatorArray *TGeoManager::GetListOfNavigators() const
 
 Bool_t TGeoManager::SetCurrentNavigator(Int_t index)
 {
-   Long_t threadId = fMultiThread ? TThread::SelfId() : 0;
-   NavigatorsMap_t::const_iterator it = fNavigators.find(threadId);
-   if (it == fNavigators.end()) {
-      Error("SetCurrentNavigator", "No navigator defined for thread %ld\n", threadId);
+   TGeoNavigatorArray *array = GetListOfNavigators();
+   if (!array) {
+      Error("SetCurrentNavigator", "No navigator defined for thread %ld\n", fMultiThread ? TThread::SelfId() : 0L);
       return kFALSE;
    }
-   TGeoNavigatorArray *array = it->second;
    TGeoNavigator *nav = array->SetCurrentNavigator(index);
    if (!nav) {
-      Error("SetCurrentNavigator", "Navigator %d not existing for thread %ld\n", index, threadId);
+      Error("SetCurrentNavigator", "Navigator %d not existing for thread %ld\n", index, fMultiThread ? TThread::SelfId() : 0L);
       return kFALSE;
    }
    if (!fMultiThread) fCurrentNavigator = nav;
@@ -897,6 +923,7 @@ void TGeoManager::ClearNavigators()
       if (arr) delete arr;
    }
    fNavigators.clear();
+   fNavigatorsTag = ++fgNavigatorsTags;
    if (fMultiThread) TThread::UnLock();
 }
 
@@ -912,7 +939,10 @@ void TGeoManager::RemoveNavigator(const TGeoNavigator *nav)
       if (arr) {
          if ((TGeoNavigator*)arr->Remove((TObject*)nav)) {
             delete nav;
-            if (!arr->GetEntries()) fNavigators.erase(it);
+            if (!arr->GetEntries()) {
+               fNavigators.erase(it);
+               fNavigatorsTag = ++fgNavigatorsTags;
+            }
             if (fMultiThread) TThread::UnLock();
             return;
          }
@@ -923,7 +953,10 @@ void TGeoManager::RemoveNavigator(const TGeoNavigator *nav)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Set maximum number of threads for navigation.
+/// Switch to multi-threaded navigation, reserving thread data for nthreads
+/// threads. The number of threads is not a limit: the thread data is extended
+/// when further threads add their navigator. Declaring the expected number
+/// avoids extending it while other threads navigate.
 
 void TGeoManager::SetMaxThreads(Int_t nthreads)
 {
@@ -945,6 +978,7 @@ void TGeoManager::SetMaxThreads(Int_t nthreads)
       ClearThreadsMap();
       ClearThreadData();
    }
+   fNavigatorsTag = ++fgNavigatorsTags;
    fMaxThreads = nthreads+1;
    if (fMaxThreads>0) {
       fMultiThread = kTRUE;
@@ -1968,6 +2002,27 @@ Int_t TGeoManager::GetMaxXtruVert()
    return fgMaxXtruVert;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the minimum number of daughters of the volumes voxelized with a
+/// bounding volume hierarchy (static function). 0 if disabled.
+
+Int_t TGeoManager::GetBVHThreshold()
+{
+   return fgBVHThreshold;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Voxelize the volumes having at least NDAUGHTERS daughters with a bounding
+/// volume hierarchy (TGeoBVHFinder) instead of voxels (static function). The
+/// hierarchy can also be requested for a given volume with
+/// TGeoVolume::SetUseBVH(). A value of 0 (default) disables the threshold.
+/// Applies to the volumes voxelized afterwards, e.g. by CloseGeometry().
+
+void TGeoManager::SetBVHThreshold(Int_t ndaughters)
+{
+   fgBVHThreshold = ndaughters;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns number of threads that were set to use geometry.
 
@@ -2891,21 +2946,45 @@ void TGeoManager::RestoreMasterVolume()
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Voxelize all non-divided volumes.
+///
+/// When the implicit multi-threading is enabled, the volumes are voxelized
+/// and checked for overlapping daughters by a pool of threads. Assemblies,
+/// volumes having assembly daughters (whose bounding boxes are recomputed)
+/// and volumes sharing the nodes of another volume are processed serially
+/// afterwards. The voxels of a geometry exported with option "v" are read
+/// back from the file and not rebuilt.
 
 void TGeoManager::Voxelize(Option_t *option)
 {
    TGeoVolume *vol;
-//   TGeoVoxelFinder *vox = 0;
    if (!fStreamVoxels && fgVerboseLevel>0) Info("Voxelize","Voxelizing...");
-//   Int_t nentries = fVolumes->GetSize();
-   TIter next(fVolumes);
-   while ((vol = (TGeoVolume*)next())) {
+   Int_t nvolumes = fVolumes->GetEntriesFast();
+   std::vector<TGeoVolume*> parallel;
+   std::vector<TGeoVolume*> serial;
+   for (Int_t i=0; i<nvolumes; i++) {
+      vol = (TGeoVolume*)fVolumes->At(i);
+      if (!vol) continue;
       if (!fIsGeomReading) vol->SortNodes();
-      if (!fStreamVoxels) {
-         vol->Voxelize(option);
-      }
-      if (!fIsGeomReading) vol->FindOverlaps();
+      Bool_t shared = vol->IsAssembly() || vol->TestBit(TGeoVolume::kVolumeImportNodes);
+      Int_t nd = vol->GetNdaughters();
+      for (Int_t id=0; id<nd && !shared; id++) shared = vol->GetNode(id)->GetVolume()->IsAssembly();
+      if (shared) serial.push_back(vol);
+      else        parallel.push_back(vol);
+   }
+   Bool_t findOverlaps = !fIsGeomReading;
+   auto voxelize = [&](TGeoVolume *v) {
+      if (!fStreamVoxels) v->Voxelize(option);
+      if (findOverlaps) v->FindOverlaps();
+   };
+#ifdef R__USE_IMT
+   if (!fStreamVoxels && parallel.size()>1 && ROOT::IsImplicitMTEnabled()) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach([&](UInt_t i) { voxelize(parallel[i]); }, ROOT::TSeqU(parallel.size()));
+      parallel.clear();
    }
+#endif
+   for (auto v : parallel) voxelize(v);
+   for (auto v : serial) voxelize(v);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -3700,7 +3779,9 @@ void TGeoManager::ExecuteEvent(Int_t event, Int_t px, Int_t py)
 ///  - Case 1: root file or root/xml file
 ///    if filename end with ".root". The key will be named name
 ///    By default the geometry is saved without the voxelisation info.
-///    Use option 'v" to save the voxelisation info.
+///    Use option 'v" to save the voxelisation info, including the bounding
+///    volume hierarchies, which are then not rebuilt when closing the
+///    geometry read back from the file.
 ///    if filename end with ".xml" a root/xml file is produced.
 ///
 ///  - Case 2: C++ script
@@ -43,6 +43,8 @@ gGeoManager->SetCurrentNavigator(0);
 #include "TGeoParallelWorld.h"
 #include "TGeoPhysicalNode.h"
 
+#include <vector>
+
 static Double_t gTolerance = TGeoShape::Tolerance();
 const char *kGeoOutsidePath = " ";
 const Int_t kN3 = 3*sizeof(Double_t);
@@ -1214,6 +1216,132 @@ TGeoNode *TGeoNavigator::FindNextDaughterBoundary(Double_t *point, Double_t *dir
    return nodefound;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Compute for a basket of NTRACKS tracks located in the current volume the
+/// distance to the next boundary within STEPMAX, as FindNextBoundary() does for
+/// the current point. The points (x,y,z) and directions of track i are given in
+/// the master frame as points[3*i+0..2] and dirs[3*i+0..2], and its maximum
+/// step as stepmax[i]. For each track, the step, the safety, the next node
+/// (as returned by FindNextBoundary()) and optionally the index of the crossed
+/// daughter (as GetNextDaughterIndex()) are returned in the output arrays.
+///
+/// For the tracks of a basket the shapes of the current volume and of its
+/// daughters are queried once for all tracks, through their vectorized
+/// DistFromInside_v, DistFromOutside_v and Safety_v methods. The daughters are
+/// all checked, without using the voxels of the volume. If the current volume
+/// is divided, is an assembly, has assembly or overlapping daughters, if the
+/// navigator is in an overlapping node or outside the geometry, or if parallel
+/// navigation or volume activity is enabled, the tracks are processed one by
+/// one with FindNextBoundary(). In both cases the current point, direction
+/// and path of the navigator are not changed.
+
+void TGeoNavigator::FindNextBoundary_v(Int_t ntracks, const Double_t *points, const Double_t *dirs, const Double_t *stepmax,
+                                       Double_t *steps, Double_t *safeties, TGeoNode **nextnodes, Int_t *idaughters)
+{
+   if (ntracks <= 0) return;
+   TGeoVolume *vol = fCurrentNode->GetVolume();
+   Int_t nd = vol->GetNdaughters();
+   Bool_t vectorized = !fIsOutside && !fNmany && !vol->IsAssembly() && !vol->GetFinder() &&
+                       !fGeometry->IsParallelWorldNav() && !fGeometry->IsActivityEnabled();
+   for (Int_t id=0; id<nd && vectorized; id++) {
+      TGeoNode *daughter = vol->GetNode(id);
+      if (daughter->IsOverlapping() || daughter->GetVolume()->IsAssembly()) vectorized = kFALSE;
+   }
+
+   if (!vectorized) {
+      // process the tracks one by one, restoring the state after each track
+      Double_t point[3], dir[3];
+      memcpy(point, fPoint, kN3);
+      memcpy(dir, fDirection, kN3);
+      for (Int_t i=0; i<ntracks; i++) {
+         PushPath();
+         SetCurrentPoint(&points[3*i]);
+         SetCurrentDirection(&dirs[3*i]);
+         nextnodes[i] = FindNextBoundary(stepmax[i]);
+         steps[i] = fStep;
+         if (safeties) safeties[i] = fSafety;
+         if (idaughters) idaughters[i] = fNextDaughterIndex;
+         PopPath();
+      }
+      SetCurrentPoint(point);
+      SetCurrentDirection(dir);
+      return;
+   }
+
+   // points and directions in the local frame of the current volume
+   std::vector<Double_t> lpoints(3*ntracks), ldirs(3*ntracks);
+   for (Int_t i=0; i<ntracks; i++) {
+      fGlobalMatrix->MasterToLocal(&points[3*i], &lpoints[3*i]);
+      fGlobalMatrix->MasterToLocalVect(&dirs[3*i], &ldirs[3*i]);
+   }
+
+   // safety: distance to the boundary of the volume and to its daughters
+   std::vector<Double_t> safe(ntracks), dsafe(ntracks), dpoints(3*ntracks), ddirs(3*ntracks);
+   Bool_t *inside = new Bool_t[ntracks];
+   for (Int_t i=0; i<ntracks; i++) inside[i] = kTRUE;
+   vol->GetShape()->Safety_v(&lpoints[0], inside, &safe[0], ntracks);
+   for (Int_t i=0; i<ntracks; i++) inside[i] = kFALSE;
+   for (Int_t id=0; id<nd; id++) {
+      TGeoNode *daughter = vol->GetNode(id);
+      for (Int_t i=0; i<ntracks; i++) daughter->MasterToLocal(&lpoints[3*i], &dpoints[3*i]);
+      daughter->GetVolume()->GetShape()->Safety_v(&dpoints[0], inside, &dsafe[0], ntracks);
+      for (Int_t i=0; i<ntracks; i++) safe[i] = TMath::Min(safe[i], dsafe[i]);
+   }
+   delete [] inside;
+
+   // tracks whose step is within the safe region stay in the volume, the
+   // others are compacted in the local buffers
+   std::vector<Int_t> active;
+   active.reserve(ntracks);
+   for (Int_t i=0; i<ntracks; i++) {
+      safe[i] = TMath::Abs(safe[i]);
+      if (safe[i] < gTolerance) safe[i] = 0;
+      if (safeties) safeties[i] = safe[i];
+      if (idaughters) idaughters[i] = -2;
+      steps[i] = (stepmax[i] < 1E29) ? TMath::Abs(stepmax[i]) : TGeoShape::Big();
+      nextnodes[i] = fCurrentNode;
+      if (stepmax[i] < 1E29 && steps[i]+gTolerance < safe[i]) continue;
+      if (i != (Int_t)active.size()) {
+         memcpy(&lpoints[3*active.size()], &lpoints[3*i], kN3);
+         memcpy(&ldirs[3*active.size()], &ldirs[3*i], kN3);
+      }
+      active.push_back(i);
+   }
+   Int_t nactive = active.size();
+   if (!nactive) return;
+
+   // distance to exit the current volume
+   std::vector<Double_t> step(nactive), snext(nactive);
+   for (Int_t j=0; j<nactive; j++) step[j] = steps[active[j]];
+   vol->GetShape()->DistFromInside_v(&lpoints[0], &ldirs[0], &snext[0], nactive, &step[0]);
+   for (Int_t j=0; j<nactive; j++) {
+      Int_t i = active[j];
+      if (snext[j] < step[j]-gTolerance) {
+         step[j] = snext[j];
+         if (idaughters) idaughters[i] = -1;
+      }
+      nextnodes[i] = (step[j]<1E20) ? fCurrentNode : 0;
+   }
+
+   // distance to enter the daughters, checked in their order in the volume
+   for (Int_t id=0; id<nd; id++) {
+      TGeoNode *daughter = vol->GetNode(id);
+      for (Int_t j=0; j<nactive; j++) {
+         daughter->MasterToLocal(&lpoints[3*j], &dpoints[3*j]);
+         daughter->MasterToLocalVect(&ldirs[3*j], &ddirs[3*j]);
+      }
+      daughter->GetVolume()->GetShape()->DistFromOutside_v(&dpoints[0], &ddirs[0], &snext[0], nactive, &step[0]);
+      for (Int_t j=0; j<nactive; j++) {
+         if (snext[j] < step[j]-gTolerance) {
+            step[j] = snext[j];
+            nextnodes[active[j]] = daughter;
+            if (idaughters) idaughters[active[j]] = id;
+         }
+      }
+   }
+   for (Int_t j=0; j<nactive; j++) steps[active[j]] = step[j];
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Compute distance to next boundary within STEPMAX. If no boundary is found,
 /// propagate current point along current direction with fStep=STEPMAX. Otherwise
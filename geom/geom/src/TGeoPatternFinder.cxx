@@ -114,13 +114,15 @@ void TGeoPatternFinder::ClearThreadData() const
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Create thread data for n threads max.
+/// Create thread data for n threads max. The data of existing threads is kept.
 
 void TGeoPatternFinder::CreateThreadData(Int_t nthreads)
 {
    TThread::Lock();
-   fThreadData.resize(nthreads);
-   fThreadSize = nthreads;
+   if (nthreads > fThreadSize) {
+      fThreadData.resize(nthreads);
+      fThreadSize = nthreads;
+   }
    for (Int_t tid=0; tid<nthreads; tid++) {
       if (fThreadData[tid] == 0) {
          fThreadData[tid] = new ThreadData_t;
@@ -1394,7 +1394,12 @@ void TGeoPcon::Streamer(TBuffer &R__b)
 
 void TGeoPcon::Contains_v(const Double_t *points, Bool_t *inside, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+   if (IsA() != TGeoPcon::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) inside[i] = TGeoPcon::Contains(&points[3*i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1412,7 +1417,12 @@ void TGeoPcon::ComputeNormal_v(const Double_t *points, const Double_t *dirs, Dou
 
 void TGeoPcon::DistFromInside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoPcon::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoPcon::DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1420,7 +1430,12 @@ void TGeoPcon::DistFromInside_v(const Double_t *points, const Double_t *dirs, Do
 
 void TGeoPcon::DistFromOutside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoPcon::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoPcon::DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1430,5 +1445,10 @@ void TGeoPcon::DistFromOutside_v(const Double_t *points, const Double_t *dirs, D
 
 void TGeoPcon::Safety_v(const Double_t *points, const Bool_t *inside, Double_t *safe, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+   if (IsA() != TGeoPcon::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) safe[i] = TGeoPcon::Safety(&points[3*i], inside[i]);
 }
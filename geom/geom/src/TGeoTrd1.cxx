@@ -736,7 +736,12 @@ void TGeoTrd1::Sizeof3D() const
 
 void TGeoTrd1::Contains_v(const Double_t *points, Bool_t *inside, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+   if (IsA() != TGeoTrd1::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) inside[i] = TGeoTrd1::Contains(&points[3*i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -754,7 +759,12 @@ void TGeoTrd1::ComputeNormal_v(const Double_t *points, const Double_t *dirs, Dou
 
 void TGeoTrd1::DistFromInside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoTrd1::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoTrd1::DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -762,7 +772,12 @@ void TGeoTrd1::DistFromInside_v(const Double_t *points, const Double_t *dirs, Do
 
 void TGeoTrd1::DistFromOutside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoTrd1::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoTrd1::DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -772,5 +787,10 @@ void TGeoTrd1::DistFromOutside_v(const Double_t *points, const Double_t *dirs, D
 
 void TGeoTrd1::Safety_v(const Double_t *points, const Bool_t *inside, Double_t *safe, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+   if (IsA() != TGeoTrd1::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) safe[i] = TGeoTrd1::Safety(&points[3*i], inside[i]);
 }
@@ -769,7 +769,12 @@ void TGeoTrd2::Sizeof3D() const
 
 void TGeoTrd2::Contains_v(const Double_t *points, Bool_t *inside, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+   if (IsA() != TGeoTrd2::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) inside[i] = TGeoTrd2::Contains(&points[3*i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -787,7 +792,12 @@ void TGeoTrd2::ComputeNormal_v(const Double_t *points, const Double_t *dirs, Dou
 
 void TGeoTrd2::DistFromInside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoTrd2::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoTrd2::DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -795,7 +805,12 @@ void TGeoTrd2::DistFromInside_v(const Double_t *points, const Double_t *dirs, Do
 
 void TGeoTrd2::DistFromOutside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoTrd2::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoTrd2::DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -805,5 +820,10 @@ void TGeoTrd2::DistFromOutside_v(const Double_t *points, const Double_t *dirs, D
 
 void TGeoTrd2::Safety_v(const Double_t *points, const Bool_t *inside, Double_t *safe, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+   if (IsA() != TGeoTrd2::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) safe[i] = TGeoTrd2::Safety(&points[3*i], inside[i]);
 }
@@ -1181,7 +1181,18 @@ const TBuffer3D & TGeoTube::GetBuffer3D(Int_t reqSections, Bool_t localFrame) co
 
 void TGeoTube::Contains_v(const Double_t *points, Bool_t *inside, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+   if (IsA() != TGeoTube::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+      return;
+   }
+   const Double_t dz = fDz;
+   const Double_t rmin2 = fRmin*fRmin, rmax2 = fRmax*fRmax;
+   for (Int_t i=0; i<vecsize; i++) {
+      const Double_t *point = &points[3*i];
+      Double_t r2 = point[0]*point[0]+point[1]*point[1];
+      inside[i] = !((TMath::Abs(point[2]) > dz) | (r2 < rmin2) | (r2 > rmax2));
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1199,7 +1210,12 @@ void TGeoTube::ComputeNormal_v(const Double_t *points, const Double_t *dirs, Dou
 
 void TGeoTube::DistFromInside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoTube::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoTube::DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1207,7 +1223,12 @@ void TGeoTube::DistFromInside_v(const Double_t *points, const Double_t *dirs, Do
 
 void TGeoTube::DistFromOutside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoTube::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoTube::DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1217,7 +1238,27 @@ void TGeoTube::DistFromOutside_v(const Double_t *points, const Double_t *dirs, D
 
 void TGeoTube::Safety_v(const Double_t *points, const Bool_t *inside, Double_t *safe, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+   if (IsA() != TGeoTube::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+      return;
+   }
+   const Double_t dz = fDz, rmin = fRmin, rmax = fRmax;
+   const Bool_t hasrmin = (fRmin>1E-10);
+   for (Int_t i=0; i<vecsize; i++) {
+      const Double_t *point = &points[3*i];
+      Double_t r  = TMath::Sqrt(point[0]*point[0]+point[1]*point[1]);
+      Double_t az = TMath::Abs(point[2]);
+      Double_t safin  = dz-az;
+      Double_t safout = -dz+az;
+      if (hasrmin) {
+         safin  = TMath::Min(safin, r-rmin);
+         safout = TMath::Max(safout, -r+rmin);
+      }
+      safin  = TMath::Min(safin, rmax-r);
+      safout = TMath::Max(safout, -rmax+r);
+      safe[i] = inside[i] ? safin : safout;
+   }
 }
 
 ClassImp(TGeoTubeSeg)
@@ -2419,7 +2460,12 @@ const TBuffer3D & TGeoTubeSeg::GetBuffer3D(Int_t reqSections, Bool_t localFrame)
 
 void TGeoTubeSeg::Contains_v(const Double_t *points, Bool_t *inside, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+   if (IsA() != TGeoTubeSeg::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) inside[i] = Contains(&points[3*i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) inside[i] = TGeoTubeSeg::Contains(&points[3*i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2437,7 +2483,12 @@ void TGeoTubeSeg::ComputeNormal_v(const Double_t *points, const Double_t *dirs,
 
 void TGeoTubeSeg::DistFromInside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoTubeSeg::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoTubeSeg::DistFromInside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2445,7 +2496,12 @@ void TGeoTubeSeg::DistFromInside_v(const Double_t *points, const Double_t *dirs,
 
 void TGeoTubeSeg::DistFromOutside_v(const Double_t *points, const Double_t *dirs, Double_t *dists, Int_t vecsize, Double_t* step) const
 {
-   for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+   if (IsA() != TGeoTubeSeg::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) dists[i] = DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) dists[i] = TGeoTubeSeg::DistFromOutside(&points[3*i], &dirs[3*i], 3, step[i]);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2455,7 +2511,12 @@ void TGeoTubeSeg::DistFromOutside_v(const Double_t *points, const Double_t *dirs
 
 void TGeoTubeSeg::Safety_v(const Double_t *points, const Bool_t *inside, Double_t *safe, Int_t vecsize) const
 {
-   for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+   if (IsA() != TGeoTubeSeg::Class()) {
+      // derived shapes may override the scalar method only
+      for (Int_t i=0; i<vecsize; i++) safe[i] = Safety(&points[3*i], inside[i]);
+      return;
+   }
+   for (Int_t i=0; i<vecsize; i++) safe[i] = TGeoTubeSeg::Safety(&points[3*i], inside[i]);
 }
 
 ClassImp(TGeoCtub)
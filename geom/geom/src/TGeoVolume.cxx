@@ -400,6 +400,7 @@ volumes (or volume assemblies) as content.
 #include "TGeoScaledShape.h"
 #include "TGeoCompositeShape.h"
 #include "TGeoVoxelFinder.h"
+#include "TGeoBVHFinder.h"
 #include "TGeoExtension.h"
 
 ClassImp(TGeoVolume)
@@ -1795,7 +1796,8 @@ TGeoVolume *TGeoVolume::CloneVolume() const
    // copy voxels
    TGeoVoxelFinder *voxels = 0;
    if (fVoxels) {
-      voxels = new TGeoVoxelFinder(vol);
+      if (fVoxels->InheritsFrom(TGeoBVHFinder::Class())) voxels = new TGeoBVHFinder(vol);
+      else                                               voxels = new TGeoVoxelFinder(vol);
       vol->SetVoxelFinder(voxels);
    }
    // copy option, uid
@@ -2370,7 +2372,9 @@ void TGeoVolume::Voxelize(Option_t *option)
       fVoxels = 0;
    }
    // Create the voxels structure
-   fVoxels = new TGeoVoxelFinder(this);
+   Int_t nbvh = TGeoManager::GetBVHThreshold();
+   if (IsUsingBVH() || (nbvh>0 && nd>=nbvh)) fVoxels = new TGeoBVHFinder(this);
+   else                                        fVoxels = new TGeoVoxelFinder(this);
    fVoxels->Voxelize(option);
    if (fVoxels) {
       if (fVoxels->IsInvalid()) {
@@ -2827,8 +2831,10 @@ void TGeoVolumeAssembly::CreateThreadData(Int_t nthreads)
 {
    TThread::Lock();
    // Create assembly thread data here
-   fThreadData.resize(nthreads);
-   fThreadSize = nthreads;
+   if (nthreads > fThreadSize) {
+      fThreadData.resize(nthreads);
+      fThreadSize = nthreads;
+   }
    for (Int_t tid=0; tid<nthreads; tid++) {
       if (fThreadData[tid] == 0) {
          fThreadData[tid] = new ThreadData_t;
@@ -2947,7 +2953,8 @@ TGeoVolume *TGeoVolumeAssembly::CloneVolume() const
    // copy voxels
    TGeoVoxelFinder *voxels = 0;
    if (fVoxels) {
-      voxels = new TGeoVoxelFinder(vol);
+      if (fVoxels->InheritsFrom(TGeoBVHFinder::Class())) voxels = new TGeoBVHFinder(vol);
+      else                                               voxels = new TGeoVoxelFinder(vol);
       vol->SetVoxelFinder(voxels);
    }
    // copy option, uid
@@ -3031,7 +3038,8 @@ TGeoVolumeAssembly *TGeoVolumeAssembly::MakeAssemblyFromVolume(TGeoVolume *volor
    // copy voxels
    TGeoVoxelFinder *voxels = 0;
    if (volorig->GetVoxels()) {
-      voxels = new TGeoVoxelFinder(vol);
+      if (volorig->GetVoxels()->InheritsFrom(TGeoBVHFinder::Class())) voxels = new TGeoBVHFinder(vol);
+      else                                                            voxels = new TGeoVoxelFinder(vol);
       vol->SetVoxelFinder(voxels);
    }
    // copy option, uid
@@ -86,6 +86,8 @@ ROOT tutorials: `$ROOTSYS/tutorials/image/`
 #include "TText.h"
 #include "RConfigure.h"
 #include "TVirtualPadPainter.h"
+#include "TVirtualMutex.h"
+#include "ThreadLocalStorage.h"
 
 #ifndef WIN32
 #ifndef R__HAS_COCOA
@@ -678,9 +680,9 @@ void TASImage::WriteImage(const char *file, EImageFileTypes type)
    EImageQuality quality = GetImageQuality();
    MapQuality(quality, aquality);
 
-   static TString fname;
-   fname = file;
-   static ASImageExportParams parms;
+   TString fname = file;
+   ASImageExportParams parms;
+   memset(&parms, 0, sizeof(parms));
    ASImage *im = fScaledImage ? fScaledImage->fImage : fImage;
 
    switch (type) {
@@ -2190,7 +2192,9 @@ void TASImage::GetZoomPosition(UInt_t &x, UInt_t &y, UInt_t &w, UInt_t &h) const
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Static function to initialize the ASVisual.
+/// Static function to initialize the ASVisual. The visual is shared by all
+/// images; it is created under lock, so that images can be painted by several
+/// threads.
 
 Bool_t TASImage::InitVisual()
 {
@@ -2199,6 +2203,13 @@ Bool_t TASImage::InitVisual()
    Bool_t inbatch = fgVisual && (fgVisual->dpy == (void*)1); // was in batch
    Bool_t noX = gROOT->IsBatch() || gVirtualX->InheritsFrom("TGWin32");
 
+   if (fgVisual && fgVisual->dpy && !(inbatch && !noX)) { // already initialized
+      return kTRUE;
+   }
+
+   R__LOCKGUARD(gROOTMutex);
+   inbatch = fgVisual && (fgVisual->dpy == (void*)1);
+
    // was in batch, but switched to gui
    if (inbatch && !noX) {
       destroy_asvisual(fgVisual, kFALSE);
@@ -2611,7 +2622,8 @@ void TASImage::DrawText(Int_t x, Int_t y, const char *text, Int_t size,
    }
 
    if (!gFontManager) {
-      gFontManager = create_font_manager(fgVisual->dpy, 0, 0);
+      R__LOCKGUARD(gROOTMutex);
+      if (!gFontManager) gFontManager = create_font_manager(fgVisual->dpy, 0, 0);
    }
 
    if (!gFontManager) {
@@ -5472,10 +5484,10 @@ void TASImage::DrawFillArea(UInt_t count, TPoint *ptsIn, const char *col,
    Bool_t del = kTRUE;
 
    static const UInt_t gEdgeTableEntryCacheSize = 200;
-   static EdgeTableEntry gEdgeTableEntryCache[gEdgeTableEntryCacheSize];
+   TTHREAD_TLS_ARRAY(EdgeTableEntry, gEdgeTableEntryCacheSize, gEdgeTableEntryCache);
 
    if (count < gEdgeTableEntryCacheSize) {
-      pETEs = (EdgeTableEntry*)&gEdgeTableEntryCache;
+      pETEs = gEdgeTableEntryCache;
       del = kFALSE;
    } else {
       pETEs = new EdgeTableEntry[count];
@@ -5649,7 +5661,10 @@ static void destroy_asdraw_context32( ASDrawContext *ctx )
 }
 
 static const UInt_t kBrushCacheSize = 20;
-static CARD32 gBrushCache[kBrushCacheSize*kBrushCacheSize];
+namespace {
+   // brushes of the wide lines, per thread as several threads may paint images
+   TTHREAD_TLS_ARRAY(CARD32, kBrushCacheSize*kBrushCacheSize, gBrushCache);
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Draw wide line.
@@ -5703,7 +5718,7 @@ void TASImage::DrawWideLine(UInt_t x1, UInt_t y1, UInt_t x2, UInt_t y2,
 
 void TASImage::DrawGlyph(void *bitmap, UInt_t color, Int_t bx, Int_t by)
 {
-   static UInt_t col[5];
+   UInt_t col[5];
    Int_t x, y, yy, y0, xx;
    Bool_t has_alpha = (color & 0xff000000) != 0xff000000;
 
@@ -5799,6 +5814,8 @@ void TASImage::DrawText(TText *text, Int_t x, Int_t y)
       BeginPaint();
    }
 
+   R__LOCKGUARD2(gTTFMutex);
+
    if (!TTF::IsInitialized()) TTF::Init();
 
    // set text font
@@ -5912,7 +5929,7 @@ void TASImage::DrawText(TText *text, Int_t x, Int_t y)
    TTF::TTGlyph *glyph = TTF::GetGlyphs();
 
    for (int n = 0; n < TTF::GetNumGlyphs(); n++, glyph++) {
-      if (FT_Glyph_To_Bitmap(&glyph->fImage, ft_render_mode_normal, 0, 1 )) continue;
+      if (!TTF::RenderGlyph(glyph, kTRUE)) continue;
 
       FT_BitmapGlyph bitmap = (FT_BitmapGlyph)glyph->fImage;
       FT_Bitmap *source = &bitmap->bitmap;
@@ -5930,6 +5947,7 @@ void TASImage::DrawText(TText *text, Int_t x, Int_t y)
 void TASImage::DrawTextTTF(Int_t x, Int_t y, const char *text, Int_t size,
                            UInt_t color, const char *font_name, Float_t angle)
 {
+   R__LOCKGUARD2(gTTFMutex);
    if (!TTF::IsInitialized()) TTF::Init();
 
    TTF::SetTextFont(font_name);
@@ -5946,7 +5964,7 @@ void TASImage::DrawTextTTF(Int_t x, Int_t y, const char *text, Int_t size,
    Int_t h    = TTF::GetBox().yMax + Yoff;
 
    for (int n = 0; n < TTF::GetNumGlyphs(); n++, glyph++) {
-      if (FT_Glyph_To_Bitmap(&glyph->fImage, ft_render_mode_normal, 0, 1 )) continue;
+      if (!TTF::RenderGlyph(glyph, kTRUE)) continue;
 
       FT_BitmapGlyph bitmap = (FT_BitmapGlyph)glyph->fImage;
       FT_Bitmap *source = &bitmap->bitmap;
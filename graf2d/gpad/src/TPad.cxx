@@ -4492,7 +4492,10 @@ void TPad::Print(const char *filenam, Option_t *option)
 
    //==============Save pad/canvas as a SVG file================================
    if (strstr(opt,"svg")) {
-      gVirtualPS = (TVirtualPS*)gROOT->GetListOfSpecials()->FindObject(psname);
+      {
+         R__LOCKGUARD(gROOTMutex);
+         gVirtualPS = (TVirtualPS*)gROOT->GetListOfSpecials()->FindObject(psname);
+      }
 
       Bool_t noScreen = kFALSE;
       if (!GetCanvas()->IsBatch() && GetCanvas()->GetCanvasID() == -1) {
@@ -4532,7 +4535,10 @@ void TPad::Print(const char *filenam, Option_t *option)
 
    //==============Save pad/canvas as a TeX file================================
    if (strstr(opt,"tex")) {
-      gVirtualPS = (TVirtualPS*)gROOT->GetListOfSpecials()->FindObject(psname);
+      {
+         R__LOCKGUARD(gROOTMutex);
+         gVirtualPS = (TVirtualPS*)gROOT->GetListOfSpecials()->FindObject(psname);
+      }
 
       Bool_t noScreen = kFALSE;
       if (!GetCanvas()->IsBatch() && GetCanvas()->GetCanvasID() == -1) {
@@ -4586,7 +4592,10 @@ void TPad::Print(const char *filenam, Option_t *option)
       copenb  = psname.EndsWith("["); if (copenb)  psname[psname.Length()-1] = 0;
       ccloseb = psname.EndsWith("]"); if (ccloseb) psname[psname.Length()-1] = 0;
    }
-   gVirtualPS = (TVirtualPS*)gROOT->GetListOfSpecials()->FindObject(psname);
+   {
+      R__LOCKGUARD(gROOTMutex);
+      gVirtualPS = (TVirtualPS*)gROOT->GetListOfSpecials()->FindObject(psname);
+   }
    if (gVirtualPS) {mustOpen = kFALSE; mustClose = kFALSE;}
    if (copen  || copenb)  mustClose = kFALSE;
    if (cclose || ccloseb) mustClose = kTRUE;
@@ -4648,11 +4657,17 @@ void TPad::Print(const char *filenam, Option_t *option)
       if (noScreen) GetCanvas()->SetBatch(kFALSE);
 
       if (mustClose) {
-         gROOT->GetListOfSpecials()->Remove(gVirtualPS);
+         {
+            R__LOCKGUARD(gROOTMutex);
+            gROOT->GetListOfSpecials()->Remove(gVirtualPS);
+         }
          delete gVirtualPS;
          gVirtualPS = psave;
       } else {
-         gROOT->GetListOfSpecials()->Add(gVirtualPS);
+         {
+            R__LOCKGUARD(gROOTMutex);
+            gROOT->GetListOfSpecials()->Add(gVirtualPS);
+         }
          gVirtualPS = 0;
       }
 
@@ -4676,7 +4691,10 @@ void TPad::Print(const char *filenam, Option_t *option)
       if (mustClose) {
          if (cclose) Info("Print", "Current canvas added to %s file %s and file closed", opt.Data(), psname.Data());
          else        Info("Print", "%s file %s has been closed", opt.Data(), psname.Data());
-         gROOT->GetListOfSpecials()->Remove(gVirtualPS);
+         {
+            R__LOCKGUARD(gROOTMutex);
+            gROOT->GetListOfSpecials()->Remove(gVirtualPS);
+         }
          delete gVirtualPS;
          gVirtualPS = 0;
       } else {
@@ -98,6 +98,7 @@ public:
    static void    LayoutGlyphs();
    static void    PrepareString(const char *string);
    static void    PrepareString(const wchar_t *string);
+   static Bool_t  RenderGlyph(TTGlyph *glyph, Bool_t smoothing);
    static void    SetRotationMatrix(Float_t angle);
 
 public:
@@ -130,4 +131,10 @@ public:
    ClassDef(TTF,0)  //Interface to TTF font handling
 };
 
+class TVirtualMutex;
+
+// Serializes the sequences of calls to the static TTF state (font, size,
+// prepared string and glyphs) made by concurrently painting threads
+R__EXTERN TVirtualMutex *gTTFMutex;
+
 #endif
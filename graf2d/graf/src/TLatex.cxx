@@ -17,9 +17,45 @@
 #include "TMath.h"
 #include "TVirtualPad.h"
 #include "TVirtualPS.h"
+#include "TVirtualX.h"
+#include "TVirtualMutex.h"
+#include "TTF.h"
+
+#include <map>
+#include <string>
+#include <vector>
 
 const Double_t kPI = TMath::Pi();
 
+namespace {
+
+// Maximum number of formula layouts kept by TLatex::FirstParse; the cache
+// is emptied when it is full.
+const size_t kMaxCachedLayouts = 1000;
+
+/// Result of the first parsing of a formula: its size and the sizes of its
+/// zones, saved by TLatex::Savefs.
+struct TLatexLayout {
+   Double_t              fWidth;
+   Double_t              fOver;
+   Double_t              fUnder;
+   std::vector<Double_t> fTabSize; // width, over and under of each zone
+};
+
+std::map<std::string, TLatexLayout> gLatexLayouts;
+TVirtualMutex *gLatexLayoutsMutex = 0;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Append the bytes of value to the key of a layout.
+
+template <typename T>
+void AppendToKey(std::string &key, const T &value)
+{
+   key.append((const char *)&value, sizeof(T));
+}
+
+} // anonymous namespace
+
 ClassImp(TLatex)
 
 /** \class TLatex
@@ -2476,7 +2512,66 @@ TLatex::TLatexFormSize TLatex::FirstParse(Double_t angle, Double_t size, const C
    Short_t halign = fTextAlign/10;
    Short_t valign = fTextAlign - 10*halign;
 
-   TLatexFormSize fs = Anal1(spec,text,strlen(text));
+   // The layout only depends on the text, its attributes, the pad size and
+   // the font rendering; it is kept for the next parsings of the same text.
+   std::string key;
+   AppendToKey(key, spec.fAngle);
+   AppendToKey(key, spec.fSize);
+   AppendToKey(key, spec.fFont);
+   AppendToKey(key, fFactorSize);
+   AppendToKey(key, fFactorPos);
+   AppendToKey(key, fLimitFactorSize);
+   AppendToKey(key, fItalic);
+   AppendToKey(key, gPad->GetWw());
+   AppendToKey(key, gPad->GetWh());
+   AppendToKey(key, gPad->GetAbsWNDC());
+   AppendToKey(key, gPad->GetAbsHNDC());
+   AppendToKey(key, gVirtualX);
+   AppendToKey(key, TTF::GetKerning());
+   AppendToKey(key, TTF::GetHinting());
+   key += text;
+
+   TLatexFormSize fs;
+   Bool_t found = kFALSE;
+   {
+      R__LOCKGUARD2(gLatexLayoutsMutex);
+      std::map<std::string, TLatexLayout>::const_iterator it = gLatexLayouts.find(key);
+      if (it != gLatexLayouts.end()) {
+         const TLatexLayout &layout = it->second;
+         Int_t n = layout.fTabSize.size()/3;
+         if (n >= fTabMax) {
+            delete [] fTabSize;
+            fTabMax  = n+100;
+            fTabSize = new FormSize_t[fTabMax];
+         }
+         for (fPos = 0; fPos < n; fPos++) {
+            fTabSize[fPos].fWidth = layout.fTabSize[3*fPos];
+            fTabSize[fPos].fOver  = layout.fTabSize[3*fPos+1];
+            fTabSize[fPos].fUnder = layout.fTabSize[3*fPos+2];
+         }
+         fs.Set(layout.fWidth, layout.fOver, layout.fUnder);
+         found = kTRUE;
+      }
+   }
+
+   if (!found) {
+      fs = Anal1(spec,text,strlen(text));
+      if (fError == 0) {
+         TLatexLayout layout;
+         layout.fWidth = fs.Width();
+         layout.fOver  = fs.Over();
+         layout.fUnder = fs.Under();
+         layout.fTabSize.resize(3*fPos);
+         for (Int_t i = 0; i < fPos; i++) {
+            layout.fTabSize[3*i]   = fTabSize[i].fWidth;
+            layout.fTabSize[3*i+1] = fTabSize[i].fOver;
+            layout.fTabSize[3*i+2] = fTabSize[i].fUnder;
+         }
+         R__LOCKGUARD2(gLatexLayoutsMutex);
+         if (gLatexLayouts.size() >= kMaxCachedLayouts) gLatexLayouts.clear();
+         gLatexLayouts[key] = layout;
+      }
+   }
 
    SetTextSize(size);
    SetTextAngle(angle);
@@ -26,12 +26,109 @@ Interface to the freetype 2 library.
 #include "TEnv.h"
 #include "TMath.h"
 #include "TError.h"
+#include "TVirtualMutex.h"
+
+#include <map>
 
 // to scale fonts to the same size as the old TT version
 const Float_t kScale = 0.93376068;
 
+namespace {
+
+// Maximum number of glyph images kept by each of the caches below; a full
+// cache is emptied before adding a new glyph to it.
+const size_t kMaxCachedGlyphs = 2048;
+
+/// Glyph of a font at a given size, loaded with given flags.
+struct TTGlyphKey {
+   Int_t    fFont;
+   FT_Fixed fScaleX, fScaleY;
+   UInt_t   fIndex;
+   UInt_t   fFlags;
+
+   bool operator<(const TTGlyphKey &k) const
+   {
+      if (fFont != k.fFont) return fFont < k.fFont;
+      if (fScaleX != k.fScaleX) return fScaleX < k.fScaleX;
+      if (fScaleY != k.fScaleY) return fScaleY < k.fScaleY;
+      if (fIndex != k.fIndex) return fIndex < k.fIndex;
+      return fFlags < k.fFlags;
+   }
+};
+
+/// Untransformed image and metrics of a loaded glyph.
+struct TTGlyphOutline {
+   FT_Glyph fImage;
+   FT_Pos   fAdvanceX;
+   FT_Pos   fBearingY;
+};
+
+/// Glyph rendered, with or without anti-aliasing, with a rotation matrix and
+/// the fractional part (in 1/64 of pixels) of its position.
+struct TTBitmapKey {
+   TTGlyphKey fGlyph;
+   Bool_t     fSmoothing;
+   FT_Fixed   fXX, fXY, fYX, fYY;
+   Int_t      fFracX, fFracY;
+
+   bool operator<(const TTBitmapKey &k) const
+   {
+      if (fGlyph < k.fGlyph) return true;
+      if (k.fGlyph < fGlyph) return false;
+      if (fSmoothing != k.fSmoothing) return fSmoothing < k.fSmoothing;
+      if (fXX != k.fXX) return fXX < k.fXX;
+      if (fXY != k.fXY) return fXY < k.fXY;
+      if (fYX != k.fYX) return fYX < k.fYX;
+      if (fYY != k.fYY) return fYY < k.fYY;
+      if (fFracX != k.fFracX) return fFracX < k.fFracX;
+      return fFracY < k.fFracY;
+   }
+};
+
+std::map<TTGlyphKey, TTGlyphOutline> gGlyphCache;   // loaded glyphs
+std::map<TTBitmapKey, FT_Glyph>      gBitmapCache;  // rendered glyphs, at the origin
+
+////////////////////////////////////////////////////////////////////////////////
+/// Free the glyph images of the caches.
+
+void ClearGlyphCaches()
+{
+   for (auto &g : gGlyphCache) FT_Done_Glyph(g.second.fImage);
+   gGlyphCache.clear();
+   for (auto &b : gBitmapCache) FT_Done_Glyph(b.second);
+   gBitmapCache.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the glyph of the given index in a face, at its current size,
+/// loading it into the cache if needed. Returns 0 if the glyph cannot be
+/// loaded.
+
+const TTGlyphOutline *LoadGlyph(FT_Face face, Int_t font, UInt_t index, FT_UInt load_flags)
+{
+   TTGlyphKey key = { font, face->size->metrics.x_scale, face->size->metrics.y_scale, index, load_flags };
+   auto it = gGlyphCache.find(key);
+   if (it != gGlyphCache.end()) return &it->second;
+
+   if (FT_Load_Glyph(face, index, load_flags)) return 0;
+   TTGlyphOutline outline;
+   if (FT_Get_Glyph(face->glyph, &outline.fImage)) return 0;
+   outline.fAdvanceX = face->glyph->advance.x;
+   outline.fBearingY = face->glyph->metrics.horiBearingY;
+
+   if (gGlyphCache.size() >= kMaxCachedGlyphs) {
+      for (auto &g : gGlyphCache) FT_Done_Glyph(g.second.fImage);
+      gGlyphCache.clear();
+   }
+   return &gGlyphCache.insert(std::make_pair(key, outline)).first->second;
+}
+
+} // anonymous namespace
+
 TTF gCleanupTTF; // Allows to call "Cleanup" at the end of the session
 
+TVirtualMutex *gTTFMutex = 0;
+
 Bool_t         TTF::fgInit           = kFALSE;
 Bool_t         TTF::fgSmoothing      = kTRUE;
 Bool_t         TTF::fgKerning        = kTRUE;
@@ -85,6 +182,7 @@ void TTF::Cleanup()
 {
    if (!fgInit) return;
 
+   ClearGlyphCaches();
    for (int i = 0; i < fgFontCount; i++) {
       delete [] fgFontName[i];
       FT_Done_Face(fgFace[i]);
@@ -215,18 +313,18 @@ void TTF::LayoutGlyphs()
 
       // clear existing image if there is one
       if (glyph->fImage) FT_Done_Glyph(glyph->fImage);
+      glyph->fImage = 0;
 
-      // load the glyph image (in its native format)
-      if (FT_Load_Glyph(fgFace[fgCurFontIdx], glyph->fIndex, load_flags))
-         continue;
-
-      // extract the glyph image
-      if (FT_Get_Glyph (fgFace[fgCurFontIdx]->glyph, &glyph->fImage))
+      // copy the glyph image (in its native format) from the cache, where
+      // it is loaded the first time
+      const TTGlyphOutline *outline = LoadGlyph(fgFace[fgCurFontIdx], fgCurFontIdx,
+                                                glyph->fIndex, load_flags);
+      if (!outline || FT_Glyph_Copy(outline->fImage, &glyph->fImage))
          continue;
 
       glyph->fPos = origin;
-      fgWidth    += fgFace[fgCurFontIdx]->glyph->advance.x;
-      fgAscent    = TMath::Max((Int_t)(fgFace[fgCurFontIdx]->glyph->metrics.horiBearingY), fgAscent);
+      fgWidth    += outline->fAdvanceX;
+      fgAscent    = TMath::Max((Int_t)(outline->fBearingY), fgAscent);
 
       // transform the glyphs
       FT_Vector_Transform(&glyph->fPos, fgRotMatrix);
@@ -243,6 +341,64 @@ void TTF::LayoutGlyphs()
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Replace the image of a glyph laid out by LayoutGlyphs by its bitmap, as
+/// FT_Glyph_To_Bitmap, anti-aliased if smoothing is true. The bitmaps are
+/// kept in a cache, the rendering of a glyph only depending, up to a
+/// translation by whole pixels, on the font, its size, the rotation and the
+/// fractional part of the glyph position.
+/// Returns false if the glyph cannot be rendered.
+
+Bool_t TTF::RenderGlyph(TTGlyph *glyph, Bool_t smoothing)
+{
+   if (!glyph->fImage) return kFALSE;
+   FT_Render_Mode mode = smoothing ? ft_render_mode_normal : ft_render_mode_mono;
+   if (glyph->fImage->format != FT_GLYPH_FORMAT_OUTLINE)
+      return FT_Glyph_To_Bitmap(&glyph->fImage, mode, 0, 1) == 0;
+
+   FT_Face face = fgFace[fgCurFontIdx];
+   FT_UInt load_flags = FT_LOAD_DEFAULT;
+   if (!fgHinting) load_flags |= FT_LOAD_NO_HINTING;
+   TTBitmapKey key;
+   key.fGlyph.fFont   = fgCurFontIdx;
+   key.fGlyph.fScaleX = face->size->metrics.x_scale;
+   key.fGlyph.fScaleY = face->size->metrics.y_scale;
+   key.fGlyph.fIndex  = glyph->fIndex;
+   key.fGlyph.fFlags  = load_flags;
+   key.fSmoothing = smoothing;
+   key.fXX = fgRotMatrix ? fgRotMatrix->xx : 0x10000;
+   key.fXY = fgRotMatrix ? fgRotMatrix->xy : 0;
+   key.fYX = fgRotMatrix ? fgRotMatrix->yx : 0;
+   key.fYY = fgRotMatrix ? fgRotMatrix->yy : 0x10000;
+   key.fFracX = glyph->fPos.x & 63;
+   key.fFracY = glyph->fPos.y & 63;
+   FT_Pos dx = glyph->fPos.x >> 6;
+   FT_Pos dy = glyph->fPos.y >> 6;
+
+   auto it = gBitmapCache.find(key);
+   if (it != gBitmapCache.end()) {
+      FT_Glyph bitmap;
+      if (FT_Glyph_Copy(it->second, &bitmap)) return kFALSE;
+      FT_Done_Glyph(glyph->fImage);
+      glyph->fImage = bitmap;
+   } else {
+      if (FT_Glyph_To_Bitmap(&glyph->fImage, mode, 0, 1)) return kFALSE;
+      FT_Glyph bitmap;
+      if (FT_Glyph_Copy(glyph->fImage, &bitmap)) return kTRUE;
+      ((FT_BitmapGlyph)bitmap)->left -= dx;
+      ((FT_BitmapGlyph)bitmap)->top  -= dy;
+      if (gBitmapCache.size() >= kMaxCachedGlyphs) {
+         for (auto &b : gBitmapCache) FT_Done_Glyph(b.second);
+         gBitmapCache.clear();
+      }
+      gBitmapCache[key] = bitmap;
+      return kTRUE;
+   }
+   ((FT_BitmapGlyph)glyph->fImage)->left += dx;
+   ((FT_BitmapGlyph)glyph->fImage)->top  += dy;
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Put the characters in "string" in the "glyphs" array.
 
@@ -21,6 +21,7 @@
 #include "TMath.h"
 #include "TPoint.h"
 #include "TClass.h"
+#include "TVirtualMutex.h"
 #include <wchar.h>
 #include <cstdlib>
 
@@ -503,6 +504,7 @@ void TText::GetBoundingBox(UInt_t &w, UInt_t &h, Bool_t angle)
       h = y2-y1;
    } else {
       if ((gVirtualX->HasTTFonts() && TTF::IsInitialized()) || gPad->IsBatch()) {
+         R__LOCKGUARD2(gTTFMutex);
          TTF::GetTextExtent(w, h, (char*)GetTitle());
       } else {
          const Font_t oldFont = gVirtualX->GetTextFont();
@@ -529,6 +531,7 @@ void TText::GetTextAscentDescent(UInt_t &a, UInt_t &d, const char *text) const
    else          tsize = fTextSize*hh;
 
    if (gVirtualX->HasTTFonts() || gPad->IsBatch()) {
+      R__LOCKGUARD2(gTTFMutex);
       TTF::SetTextFont(fTextFont);
       TTF::SetTextSize(tsize);
       a = TTF::GetBox().yMax;
@@ -564,6 +567,7 @@ void TText::GetTextAscentDescent(UInt_t &a, UInt_t &d, const wchar_t *text) cons
    else          tsize = fTextSize*hh;
 
    if (gVirtualX->HasTTFonts() || gPad->IsBatch() || gVirtualX->InheritsFrom("TGCocoa")) {
+      R__LOCKGUARD2(gTTFMutex);
       TTF::SetTextFont(fTextFont);
       TTF::SetTextSize(tsize);
       a = TTF::GetBox().yMax;
@@ -593,6 +597,7 @@ void TText::GetTextExtent(UInt_t &w, UInt_t &h, const char *text) const
    else          tsize = fTextSize*hh;
 
    if (gVirtualX->HasTTFonts() || gPad->IsBatch()) {
+      R__LOCKGUARD2(gTTFMutex);
       TTF::SetTextFont(fTextFont);
       TTF::SetTextSize(tsize);
       TTF::GetTextExtent(w, h, (char*)text);
@@ -621,6 +626,7 @@ void TText::GetTextAdvance(UInt_t &a, const char *text, const Bool_t kern) const
    else          tsize = fTextSize*hh;
 
    if (gVirtualX->HasTTFonts() || gPad->IsBatch()) {
+      R__LOCKGUARD2(gTTFMutex);
       Bool_t kernsave = TTF::GetKerning();
       TTF::SetKerning(kern);
       TTF::SetTextFont(fTextFont);
@@ -656,6 +662,7 @@ void TText::GetTextExtent(UInt_t &w, UInt_t &h, const wchar_t *text) const
    else          tsize = fTextSize*hh;
 
    if (gVirtualX->HasTTFonts() || gPad->IsBatch() || gVirtualX->InheritsFrom("TGCocoa")) {
+      R__LOCKGUARD2(gTTFMutex);
       TTF::SetTextFont(fTextFont);
       TTF::SetTextSize(tsize);
       TTF::GetTextExtent(w, h, (wchar_t*)text);
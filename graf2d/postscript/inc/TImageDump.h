@@ -25,6 +25,15 @@ class TImageDump : public TVirtualPS {
 protected:
    TImage           *fImage;     ///< Image
    Int_t             fType;      ///< PostScript workstation type
+   UInt_t           *fCellArrayColors; ///< Colors of the cell array being filled
+   Int_t             fCellArrayN;      ///< Number of cells of the cell array
+   Int_t             fCellArrayW;      ///< Width of the cell array
+   Int_t             fCellArrayH;      ///< Height of the cell array
+   Int_t             fCellArrayX1;     ///< Pixel limits of the cell array
+   Int_t             fCellArrayX2;
+   Int_t             fCellArrayY1;
+   Int_t             fCellArrayY2;
+   Int_t             fCellArrayIdx;    ///< Index of the next cell to fill
 
    Int_t  XtoPixel(Double_t x);
    Int_t  YtoPixel(Double_t y);
@@ -28,6 +28,7 @@
 
 
 class TPoints;
+struct z_stream_s;
 
 class TPDF : public TVirtualPS {
 
@@ -51,9 +52,12 @@ protected:
    Bool_t             fPageNotEmpty;    ///< True if the current page is not empty
    Bool_t             fCompress;        ///< True when fBuffer must be compressed
    Bool_t             fRange;           ///< True when a range has been defined
+   z_stream_s        *fZStream;         ///< Deflate stream of the current page content
 
    static Int_t       fgLineJoin;       ///< Appearance of joining lines
 
+   void     DeflateBuffer(Bool_t finish);
+
 public:
    TPDF();
    TPDF(const char *filename, Int_t type=-111);
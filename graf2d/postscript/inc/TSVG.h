@@ -16,6 +16,7 @@
 #ifndef ROOT_TVirtualPS
 #include "TVirtualPS.h"
 #endif
+#include <vector>
 
 class TPoints;
 
@@ -28,6 +29,13 @@ protected:
    Bool_t       fBoundingBox;     ///< True when the SVG header is printed
    Bool_t       fRange;           ///< True when a range has been defined
    Double_t     fYsizeSVG;        ///< Page's Y size in SVG units
+   Int_t        fCellArrayW;      ///< Number of cells along X of the current cell array
+   Int_t        fCellArrayH;      ///< Number of cells along Y of the current cell array
+   Double_t     fCellArrayX;      ///< Left edge of the current cell array in SVG units
+   Double_t     fCellArrayY;      ///< Top edge of the current cell array in SVG units
+   Double_t     fCellArrayWidth;  ///< Width of the current cell array in SVG units
+   Double_t     fCellArrayHeight; ///< Height of the current cell array in SVG units
+   std::vector<UChar_t> fCellArrayRGB; ///< RGB values of the cells of the current cell array
 
 public:
    TSVG();
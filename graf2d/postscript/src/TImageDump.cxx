@@ -51,7 +51,9 @@ ClassImp(TImageDump)
 ////////////////////////////////////////////////////////////////////////////////
 /// Default constructor
 
-TImageDump::TImageDump() : TVirtualPS()
+TImageDump::TImageDump() : TVirtualPS(),
+   fCellArrayColors(0), fCellArrayN(0), fCellArrayW(0), fCellArrayH(0),
+   fCellArrayX1(0), fCellArrayX2(0), fCellArrayY1(0), fCellArrayY2(0), fCellArrayIdx(0)
 {
    fStream    = 0;
    fImage     = 0;
@@ -70,7 +72,9 @@ TImageDump::TImageDump() : TVirtualPS()
 ///  - 112 - Landscape
 ///  - 114 - preview, keep in memory (do not write on delete)
 
-TImageDump::TImageDump(const char *fname, Int_t wtype) : TVirtualPS(fname, wtype)
+TImageDump::TImageDump(const char *fname, Int_t wtype) : TVirtualPS(fname, wtype),
+   fCellArrayColors(0), fCellArrayN(0), fCellArrayW(0), fCellArrayH(0),
+   fCellArrayX1(0), fCellArrayX2(0), fCellArrayY1(0), fCellArrayY2(0), fCellArrayIdx(0)
 {
    Open(fname, wtype);
    gVirtualPS = this;
@@ -97,6 +101,7 @@ TImageDump::~TImageDump()
 
    delete fImage;
    fImage = 0;
+   delete [] fCellArrayColors;
 
    gVirtualPS = 0;
 }
@@ -126,7 +131,7 @@ void TImageDump::DrawBox(Double_t x1, Double_t y1, Double_t x2, Double_t  y2)
 
    fImage->BeginPaint();
 
-   static Double_t x[4], y[4];
+   Double_t x[4], y[4];
    Int_t ix1 = x1 < x2 ? XtoPixel(x1) : XtoPixel(x2);
    Int_t ix2 = x1 < x2 ? XtoPixel(x2) : XtoPixel(x1);
    Int_t iy1 = y1 < y2 ? YtoPixel(y1) : YtoPixel(y2);
@@ -292,7 +297,7 @@ void TImageDump::DrawPolyMarker(Int_t n, Double_t *xw, Double_t *yw)
    fImage->BeginPaint();
 
    Int_t ms = TMath::Abs(fMarkerStyle);
-   static TPoint pt[20];
+   TPoint pt[20];
 
    if (ms > 7 && ms <= 19) ms = 20;
    if (ms == 4) ms = 24;
@@ -465,15 +470,15 @@ void TImageDump::DrawPS(Int_t nn, Double_t *x, Double_t *y)
    fasi = fFillStyle%1000;
 
    Short_t px1, py1, px2, py2;
-   static const UInt_t gCachePtSize = 200;
-   static TPoint gPointCache[gCachePtSize];
+   const UInt_t kCachePtSize = 200;
+   TPoint pointCache[kCachePtSize];
    Bool_t del = kTRUE;
 
 
    // SetLineStyle
    Int_t ndashes = 0;
    char *dash = 0;
-   static char dashList[10];
+   char dashList[10];
    Int_t dashLength = 0;
    Int_t dashSize = 0;
 
@@ -548,8 +553,8 @@ void TImageDump::DrawPS(Int_t nn, Double_t *x, Double_t *y)
    }
 
    TPoint *pt = 0;
-   if (n+1 < gCachePtSize) {
-      pt = (TPoint*)&gPointCache;
+   if (n+1 < kCachePtSize) {
+      pt = (TPoint*)&pointCache;
       del = kFALSE;
    } else {
       pt = new TPoint[n+1];
@@ -698,15 +703,6 @@ void TImageDump::Text(Double_t x, Double_t y, const wchar_t *chars)
 
 
 ////////////////////////// CellArray code ////////////////////////////////////
-static UInt_t *gCellArrayColors = 0;
-static Int_t   gCellArrayN = 0;
-static Int_t   gCellArrayW = 0;
-static Int_t   gCellArrayH = 0;
-static Int_t   gCellArrayX1 = 0;
-static Int_t   gCellArrayX2 = 0;
-static Int_t   gCellArrayY1 = 0;
-static Int_t   gCellArrayY2 = 0;
-static Int_t   gCellArrayIdx = 0;
 
 ////////////////////////////////////////////////////////////////////////////////
 ///cell array begin
@@ -718,23 +714,23 @@ void TImageDump::CellArrayBegin(Int_t w, Int_t h, Double_t x1, Double_t x2,
       return;
    }
 
-   if (gCellArrayColors) {
-      delete [] gCellArrayColors;
+   if (fCellArrayColors) {
+      delete [] fCellArrayColors;
    }
 
    fImage->BeginPaint();
 
-   gCellArrayN = w * h;
-   gCellArrayW = w;
-   gCellArrayH = h;
-   gCellArrayColors = new UInt_t[gCellArrayN];
+   fCellArrayN = w * h;
+   fCellArrayW = w;
+   fCellArrayH = h;
+   fCellArrayColors = new UInt_t[fCellArrayN];
 
-   gCellArrayX1 = x1 < x2 ? XtoPixel(x1) : XtoPixel(x2);
-   gCellArrayX2 = x1 > x2 ? XtoPixel(x2) : XtoPixel(x1);
-   gCellArrayY1 = y1 < y2 ? YtoPixel(y1) : YtoPixel(y2);
-   gCellArrayY2 = y1 < y2 ? YtoPixel(y2) : YtoPixel(y1);
+   fCellArrayX1 = x1 < x2 ? XtoPixel(x1) : XtoPixel(x2);
+   fCellArrayX2 = x1 > x2 ? XtoPixel(x2) : XtoPixel(x1);
+   fCellArrayY1 = y1 < y2 ? YtoPixel(y1) : YtoPixel(y2);
+   fCellArrayY2 = y1 < y2 ? YtoPixel(y2) : YtoPixel(y1);
 
-   gCellArrayIdx = 0;
+   fCellArrayIdx = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -742,12 +738,12 @@ void TImageDump::CellArrayBegin(Int_t w, Int_t h, Double_t x1, Double_t x2,
 
 void TImageDump::CellArrayFill(Int_t r, Int_t g, Int_t b)
 {
-   if (gCellArrayIdx >= gCellArrayN) return;
+   if (fCellArrayIdx >= fCellArrayN) return;
 
    fImage->BeginPaint();
 
-   gCellArrayColors[gCellArrayIdx] = ((r & 0xFF) << 16) + ((g & 0xFF) << 8) + (b & 0xFF);
-   gCellArrayIdx++;
+   fCellArrayColors[fCellArrayIdx] = ((r & 0xFF) << 16) + ((g & 0xFF) << 8) + (b & 0xFF);
+   fCellArrayIdx++;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -755,25 +751,25 @@ void TImageDump::CellArrayFill(Int_t r, Int_t g, Int_t b)
 
 void TImageDump::CellArrayEnd()
 {
-   if (!fImage || !gCellArrayColors || !gCellArrayW || !gCellArrayH) {
+   if (!fImage || !fCellArrayColors || !fCellArrayW || !fCellArrayH) {
       return;
    }
 
    fImage->BeginPaint();
 
-   fImage->DrawCellArray(gCellArrayX1, gCellArrayX2, gCellArrayY1, gCellArrayY2,
-                         gCellArrayW, gCellArrayH, gCellArrayColors);
-
-   delete [] gCellArrayColors;
-   gCellArrayColors = 0;
-   gCellArrayN = 0;
-   gCellArrayW = 0;
-   gCellArrayH = 0;
-   gCellArrayX1 = 0;
-   gCellArrayX2 = 0;
-   gCellArrayY1 = 0;
-   gCellArrayY2 = 0;
-   gCellArrayIdx = 0;
+   fImage->DrawCellArray(fCellArrayX1, fCellArrayX2, fCellArrayY1, fCellArrayY2,
+                         fCellArrayW, fCellArrayH, fCellArrayColors);
+
+   delete [] fCellArrayColors;
+   fCellArrayColors = 0;
+   fCellArrayN = 0;
+   fCellArrayW = 0;
+   fCellArrayH = 0;
+   fCellArrayX1 = 0;
+   fCellArrayX2 = 0;
+   fCellArrayY1 = 0;
+   fCellArrayY2 = 0;
+   fCellArrayIdx = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -93,6 +93,9 @@ const Int_t kObjFirstPage        = 51; // First page object
 // Number of fonts
 const Int_t kNumberOfFonts = 15;
 
+// Size of the page content kept in memory before it is compressed and written
+const Int_t kCompressChunk = 65536;
+
 Int_t TPDF::fgLineJoin = 0;
 
 ClassImp(TPDF)
@@ -122,6 +125,7 @@ TPDF::TPDF() : TVirtualPS()
    fNbObj           = 0;
    fNbPage          = 0;
    fRange           = kFALSE;
+   fZStream         = 0;
    SetTitle("PDF");
 }
 
@@ -154,6 +158,7 @@ TPDF::TPDF(const char *fname, Int_t wtype) : TVirtualPS(fname, wtype)
    fNbObj           = 0;
    fNbPage          = 0;
    fRange           = kFALSE;
+   fZStream         = 0;
    SetTitle("PDF");
    Open(fname, wtype);
 }
@@ -165,24 +170,53 @@ TPDF::~TPDF()
 {
    Close();
 
+   if (fZStream) {
+      deflateEnd(fZStream);
+      delete fZStream;
+   }
    if (fObjPos) delete [] fObjPos;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Begin the Cell Array painting
+///
+/// The cell array is written in the page content as one inline RGB image
+/// of W x H cells. The first cell, [x1,x2] along X, is the top left one and
+/// its top edge is at y1; all the cells have the height |y2-y1|. The cells
+/// are then given row by row by CellArrayFill.
 
-void TPDF::CellArrayBegin(Int_t, Int_t, Double_t, Double_t, Double_t,
-                          Double_t)
+void TPDF::CellArrayBegin(Int_t w, Int_t h, Double_t x1, Double_t x2,
+                          Double_t y1, Double_t y2)
 {
-   Warning("TPDF::CellArrayBegin", "not yet implemented");
+   Double_t xl = XtoPDF(x1);
+   Double_t xr = XtoPDF(x1+w*(x2-x1));
+   Double_t yt = YtoPDF(y1);
+   Double_t yb = YtoPDF(y1-h*TMath::Abs(y2-y1));
+
+   PrintStr(" q");
+   WriteReal(xr-xl);
+   PrintFast(4," 0 0");
+   WriteReal(yt-yb);
+   WriteReal(xl);
+   WriteReal(yb);
+   PrintFast(3," cm");
+   PrintFast(6," BI /W");
+   WriteInteger(w);
+   PrintFast(3," /H");
+   WriteInteger(h);
+   PrintFast(20," /BPC 8 /CS /RGB ID ");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Paint the Cell Array
 
-void TPDF::CellArrayFill(Int_t, Int_t, Int_t)
+void TPDF::CellArrayFill(Int_t r, Int_t g, Int_t b)
 {
-   Warning("TPDF::CellArrayFill", "not yet implemented");
+   char rgb[3];
+   rgb[0] = (char)r;
+   rgb[1] = (char)g;
+   rgb[2] = (char)b;
+   PrintFast(3, rgb);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -190,7 +224,7 @@ void TPDF::CellArrayFill(Int_t, Int_t, Int_t)
 
 void TPDF::CellArrayEnd()
 {
-   Warning("TPDF::CellArrayEnd", "not yet implemented");
+   PrintFast(5," EI Q");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1876,6 +1910,7 @@ void TPDF::PrintStr(const char *str)
       }
       strcpy(fBuffer + fLenBuffer, str);
       fLenBuffer += len;
+      if (fLenBuffer >= kCompressChunk) DeflateBuffer(kFALSE);
       return;
    }
 
@@ -1893,8 +1928,9 @@ void TPDF::PrintFast(Int_t len, const char *str)
          fBuffer  = TStorage::ReAllocChar(fBuffer, 2*fSizBuffer, fSizBuffer);
          fSizBuffer = 2*fSizBuffer;
       }
-      strcpy(fBuffer + fLenBuffer, str);
+      memcpy(fBuffer + fLenBuffer, str, len);
       fLenBuffer += len;
+      if (fLenBuffer >= kCompressChunk) DeflateBuffer(kFALSE);
       return;
    }
 
@@ -2437,43 +2473,63 @@ Double_t TPDF::YtoPDF(Double_t y)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Write the buffer in a compressed way
+/// Compress the content of fBuffer and write it in the current page stream.
+///
+/// The page content is deflated by chunks of kCompressChunk bytes as it is
+/// produced, so that the memory used does not depend on the size of the page.
+/// When finish is true the stream is terminated.
 
-void TPDF::WriteCompressedBuffer()
+void TPDF::DeflateBuffer(Bool_t finish)
 {
-   z_stream stream;
    int err;
-   char *out = new char[2*fLenBuffer];
-
-   stream.next_in   = (Bytef*)fBuffer;
-   stream.avail_in  = (uInt)fLenBuffer;
-   stream.next_out  = (Bytef*)out;
-   stream.avail_out = (uInt)2*fLenBuffer;
-   stream.zalloc    = (alloc_func)0;
-   stream.zfree     = (free_func)0;
-   stream.opaque    = (voidpf)0;
-
-   err = deflateInit(&stream, Z_DEFAULT_COMPRESSION);
-   if (err != Z_OK) {
-      Error("WriteCompressedBuffer", "error in deflateInit (zlib)");
-      return;
+
+   if (!fZStream) {
+      fZStream = new z_stream;
+      fZStream->zalloc = (alloc_func)0;
+      fZStream->zfree  = (free_func)0;
+      fZStream->opaque = (voidpf)0;
+      err = deflateInit(fZStream, Z_DEFAULT_COMPRESSION);
+      if (err != Z_OK) {
+         Error("DeflateBuffer", "error in deflateInit (zlib)");
+         delete fZStream;
+         fZStream   = 0;
+         fLenBuffer = 0;
+         return;
+      }
    }
 
-   err = deflate(&stream, Z_FINISH);
-   if (err != Z_STREAM_END) {
-      deflateEnd(&stream);
-      Error("WriteCompressedBuffer", "error in deflate (zlib)");
-      return;
+   char out[16384];
+   fZStream->next_in  = (Bytef*)fBuffer;
+   fZStream->avail_in = (uInt)fLenBuffer;
+   do {
+      fZStream->next_out  = (Bytef*)out;
+      fZStream->avail_out = (uInt)sizeof(out);
+      err = deflate(fZStream, finish ? Z_FINISH : Z_NO_FLUSH);
+      if (err == Z_STREAM_ERROR) {
+         Error("DeflateBuffer", "error in deflate (zlib)");
+         break;
+      }
+      Int_t nout = sizeof(out) - fZStream->avail_out;
+      fStream->write(out, nout);
+      fNByte += nout;
+   } while (fZStream->avail_out == 0);
+   fLenBuffer = 0;
+
+   if (finish) {
+      deflateEnd(fZStream);
+      delete fZStream;
+      fZStream = 0;
    }
+}
 
-   err = deflateEnd(&stream);
+////////////////////////////////////////////////////////////////////////////////
+/// Write the end of the compressed page stream
 
-   fStream->write(out, stream.total_out);
+void TPDF::WriteCompressedBuffer()
+{
+   DeflateBuffer(kTRUE);
 
-   fNByte += stream.total_out;
    fStream->write("\n",1); fNByte++;
-   fLenBuffer = 0;
-   delete [] out;
    fCompress = kFALSE;
 }
 
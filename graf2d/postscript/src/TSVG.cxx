@@ -28,6 +28,8 @@
 #include "TObjString.h"
 #include "TObjArray.h"
 #include "TClass.h"
+#include "TBase64.h"
+#include "zlib.h"
 
 ClassImp(TSVG)
 
@@ -84,6 +86,12 @@ TSVG::TSVG() : TVirtualPS()
    fXsize       = 0.;
    fYsize       = 0.;
    fYsizeSVG    = 0;
+   fCellArrayW  = 0;
+   fCellArrayH  = 0;
+   fCellArrayX  = 0;
+   fCellArrayY  = 0;
+   fCellArrayWidth  = 0;
+   fCellArrayHeight = 0;
    SetTitle("SVG");
 }
 
@@ -99,6 +107,12 @@ TSVG::TSVG() : TVirtualPS()
 TSVG::TSVG(const char *fname, Int_t wtype) : TVirtualPS(fname, wtype)
 {
    fStream = 0;
+   fCellArrayW  = 0;
+   fCellArrayH  = 0;
+   fCellArrayX  = 0;
+   fCellArrayY  = 0;
+   fCellArrayWidth  = 0;
+   fCellArrayHeight = 0;
    SetTitle("SVG");
    Open(fname, wtype);
 }
@@ -1214,7 +1228,8 @@ void TSVG::NewPage()
       PrintStr("\" viewBox=\"0 0");
       WriteReal(CMtoSVG(fXsize));
       WriteReal(fYsizeSVG);
-      PrintStr("\" xmlns=\"http://www.w3.org/2000/svg\">");
+      PrintStr("\" xmlns=\"http://www.w3.org/2000/svg\"");
+      PrintStr(" xmlns:xlink=\"http://www.w3.org/1999/xlink\">");
       PrintStr("@");
       Initialize();
       fBoundingBox  = kTRUE;
@@ -1648,19 +1663,57 @@ Double_t TSVG::YtoSVG(Double_t y)
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Begin the Cell Array painting
+///
+/// The cell array is written as one PNG image of W x H cells embedded in the
+/// SVG file. The first cell, [x1,x2] along X, is the top left one and its top
+/// edge is at y1; all the cells have the height |y2-y1|. The cells are then
+/// given row by row by CellArrayFill.
 
-void TSVG::CellArrayBegin(Int_t, Int_t, Double_t, Double_t, Double_t,
-                          Double_t)
+void TSVG::CellArrayBegin(Int_t w, Int_t h, Double_t x1, Double_t x2,
+                          Double_t y1, Double_t y2)
 {
-   Warning("TSVG::CellArrayBegin", "not yet implemented");
+   fCellArrayW      = w;
+   fCellArrayH      = h;
+   fCellArrayX      = XtoSVG(x1);
+   fCellArrayY      = YtoSVG(y1);
+   fCellArrayWidth  = XtoSVG(x1+w*(x2-x1)) - fCellArrayX;
+   fCellArrayHeight = YtoSVG(y1-h*TMath::Abs(y2-y1)) - fCellArrayY;
+   fCellArrayRGB.clear();
+   fCellArrayRGB.reserve(3*w*h);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Paint the Cell Array
 
-void TSVG::CellArrayFill(Int_t, Int_t, Int_t)
+void TSVG::CellArrayFill(Int_t r, Int_t g, Int_t b)
 {
-   Warning("TSVG::CellArrayFill", "not yet implemented");
+   fCellArrayRGB.push_back((UChar_t)r);
+   fCellArrayRGB.push_back((UChar_t)g);
+   fCellArrayRGB.push_back((UChar_t)b);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Append a chunk to a PNG image
+
+static void AppendPNGChunk(std::string &png, const char *type, const UChar_t *data, UInt_t len)
+{
+   UChar_t word[4];
+   word[0] = (len >> 24) & 0xff;
+   word[1] = (len >> 16) & 0xff;
+   word[2] = (len >> 8) & 0xff;
+   word[3] = len & 0xff;
+   png.append((const char*)word, 4);
+   png.append(type, 4);
+   if (len) png.append((const char*)data, len);
+
+   uLong crc = crc32(0L, Z_NULL, 0);
+   crc = crc32(crc, (const Bytef*)type, 4);
+   if (len) crc = crc32(crc, (const Bytef*)data, len);
+   word[0] = (crc >> 24) & 0xff;
+   word[1] = (crc >> 16) & 0xff;
+   word[2] = (crc >> 8) & 0xff;
+   word[3] = crc & 0xff;
+   png.append((const char*)word, 4);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1668,7 +1721,64 @@ void TSVG::CellArrayFill(Int_t, Int_t, Int_t)
 
 void TSVG::CellArrayEnd()
 {
-   Warning("TSVG::CellArrayEnd", "not yet implemented");
+   Int_t w = fCellArrayW;
+   Int_t h = fCellArrayH;
+   if (w <= 0 || h <= 0 || (Int_t)fCellArrayRGB.size() != 3*w*h) {
+      Error("CellArrayEnd", "the cell array has %d values instead of %d",
+            (Int_t)fCellArrayRGB.size()/3, w*h);
+      fCellArrayRGB.clear();
+      return;
+   }
+
+   // PNG scan lines, each one starting with the filter type 0 (none)
+   std::vector<UChar_t> raw((3*w+1)*h);
+   for (Int_t j=0; j<h; j++) {
+      raw[j*(3*w+1)] = 0;
+      memcpy(&raw[j*(3*w+1)+1], &fCellArrayRGB[3*j*w], 3*w);
+   }
+   fCellArrayRGB.clear();
+
+   uLongf nz = compressBound(raw.size());
+   std::vector<UChar_t> zdata(nz);
+   if (compress2(&zdata[0], &nz, &raw[0], raw.size(), Z_DEFAULT_COMPRESSION) != Z_OK) {
+      Error("CellArrayEnd", "error in compress2 (zlib)");
+      return;
+   }
+
+   UChar_t ihdr[13];
+   ihdr[0]  = (w >> 24) & 0xff;
+   ihdr[1]  = (w >> 16) & 0xff;
+   ihdr[2]  = (w >> 8) & 0xff;
+   ihdr[3]  = w & 0xff;
+   ihdr[4]  = (h >> 24) & 0xff;
+   ihdr[5]  = (h >> 16) & 0xff;
+   ihdr[6]  = (h >> 8) & 0xff;
+   ihdr[7]  = h & 0xff;
+   ihdr[8]  = 8; // bit depth
+   ihdr[9]  = 2; // RGB
+   ihdr[10] = 0; // deflate
+   ihdr[11] = 0; // adaptive filtering
+   ihdr[12] = 0; // no interlace
+
+   std::string png("\211PNG\r\n\032\n", 8);
+   AppendPNGChunk(png, "IHDR", ihdr, 13);
+   AppendPNGChunk(png, "IDAT", &zdata[0], nz);
+   AppendPNGChunk(png, "IEND", 0, 0);
+   TString data = TBase64::Encode(png.data(), png.size());
+
+   PrintStr("@");
+   PrintFast(10,"<image x=\"");
+   WriteReal(fCellArrayX, kFALSE);
+   PrintFast(5,"\" y=\"");
+   WriteReal(fCellArrayY, kFALSE);
+   PrintFast(9,"\" width=\"");
+   WriteReal(fCellArrayWidth, kFALSE);
+   PrintFast(10,"\" height=\"");
+   WriteReal(fCellArrayHeight, kFALSE);
+   PrintStr("\" preserveAspectRatio=\"none\" image-rendering=\"optimizeSpeed\"");
+   PrintStr(" xlink:href=\"data:image/png;base64,");
+   PrintRaw(data.Length(), data.Data());
+   PrintFast(3,"\"/>");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
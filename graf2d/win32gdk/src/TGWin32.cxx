@@ -1514,10 +1514,7 @@ void TGWin32::RenderString(Int_t x, Int_t y, ETextMode mode)
    // paint the glyphs in the XImage
    glyph = TTF::GetGlyphs();
    for (int n = 0; n < TTF::GetNumGlyphs(); n++, glyph++) {
-      if (FT_Glyph_To_Bitmap(&glyph->fImage,
-                             TTF::GetSmoothing() ? ft_render_mode_normal
-                                              : ft_render_mode_mono,
-                             0, 1 )) continue;
+      if (!TTF::RenderGlyph(glyph, TTF::GetSmoothing())) continue;
       FT_BitmapGlyph bitmap = (FT_BitmapGlyph)glyph->fImage;
       FT_Bitmap*     source = &bitmap->bitmap;
       Int_t          bx, by;
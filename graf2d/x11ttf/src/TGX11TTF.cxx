@@ -529,10 +529,7 @@ void TGX11TTF::RenderString(Int_t x, Int_t y, ETextMode mode)
    // paint the glyphs in the XImage
    glyph = TTF::fgGlyphs;
    for (int n = 0; n < TTF::fgNumGlyphs; n++, glyph++) {
-      if (FT_Glyph_To_Bitmap(&glyph->fImage,
-                             TTF::fgSmoothing ? ft_render_mode_normal
-                                              : ft_render_mode_mono,
-                             0, 1 )) continue;
+      if (!TTF::RenderGlyph(glyph, TTF::fgSmoothing)) continue;
       FT_BitmapGlyph bitmap = (FT_BitmapGlyph)glyph->fImage;
       FT_Bitmap*     source = &bitmap->bitmap;
       Int_t          bx, by;
@@ -19,6 +19,7 @@
 #pragma link C++ class TEveTrackEditor+;
 #pragma link C++ class TEveTrackList+;
 #pragma link C++ class TEveTrackListEditor+;
+#pragma link C++ class TEveTrackListGL+;
 #pragma link C++ class TEveTrackProjected+;
 #pragma link C++ class TEveTrackProjectedGL+;
 #pragma link C++ class TEveTrackListProjected+;
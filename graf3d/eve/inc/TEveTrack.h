@@ -22,6 +22,8 @@
 
 #include "TPolyMarker3D.h"
 #include "TMarker.h"
+#include "TAtt3D.h"
+#include "TAttBBox.h"
 
 class TEveTrackPropagator;
 class TEveTrackList;
@@ -118,6 +120,8 @@ public:
 
    //-------------------------------------------------------------------
 
+   virtual void AddStamp(UChar_t bits);
+
    virtual void SecSelected(TEveTrack*); // *SIGNAL*
 
    virtual const TGPicture* GetListTreeIcon(Bool_t open=kFALSE);
@@ -136,9 +140,12 @@ public:
 
 class TEveTrackList : public TEveElementList,
                       public TAttMarker,
-                      public TAttLine
+                      public TAttLine,
+                      public TAtt3D,
+                      public TAttBBox
 {
    friend class TEveTrackListEditor;
+   friend class TEveTrackListGL;
 
 private:
    TEveTrackList(const TEveTrackList&);            // Not implemented
@@ -151,6 +158,7 @@ protected:
 
    Bool_t               fRnrLine;    // Render track as line.
    Bool_t               fRnrPoints;  // Render track as points.
+   Bool_t               fRnrBatched; // Render all tracks with a single GL object, TEveTrackListGL.
 
    Double_t             fMinPt;      // Minimum track pTfor display selection.
    Double_t             fMaxPt;      // Maximum track pTfor display selection.
@@ -202,6 +210,9 @@ public:
    void   SetRnrPoints(Bool_t r, TEveElement* el);
    Bool_t GetRnrPoints() const { return fRnrPoints; }
 
+   void   SetRnrBatched(Bool_t b);
+   Bool_t GetRnrBatched() const { return fRnrBatched; }
+
    void SelectByPt(Double_t min_pt, Double_t max_pt);
    void SelectByPt(Double_t min_pt, Double_t max_pt, TEveElement* el);
    void SelectByP (Double_t min_p,  Double_t max_p);
@@ -219,6 +230,10 @@ public:
    TEveTrack* FindTrackByLabel(Int_t label); // *MENU*
    TEveTrack* FindTrackByIndex(Int_t index); // *MENU*
 
+   virtual void ComputeBBox();
+   virtual void Paint(Option_t* option="");
+   virtual void PadPaint(Option_t* option);
+
    virtual void CopyVizParams(const TEveElement* el);
    virtual void WriteVizParams(std::ostream& out, const TString& var);
 
@@ -0,0 +1,43 @@
+// @(#)root/eve:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TEveTrackListGL
+#define ROOT_TEveTrackListGL
+
+#include "TGLObject.h"
+
+class TEveTrackList;
+
+class TEveTrackListGL : public TGLObject
+{
+private:
+   TEveTrackListGL(const TEveTrackListGL&);            // Not implemented
+   TEveTrackListGL& operator=(const TEveTrackListGL&); // Not implemented
+
+protected:
+   TEveTrackList* fM; // Model object.
+
+public:
+   TEveTrackListGL();
+   virtual ~TEveTrackListGL() {}
+
+   virtual Bool_t SetModel(TObject* obj, const Option_t* opt=0);
+   virtual void   SetBBox();
+   virtual void   DirectDraw(TGLRnrCtx& rnrCtx) const;
+
+   virtual Bool_t IgnoreSizeForOfInterest() const { return kTRUE; }
+
+   virtual Bool_t SupportsSecondarySelect() const { return kTRUE; }
+   virtual void   ProcessSelection(TGLRnrCtx& rnrCtx, TGLSelectRecord& rec);
+
+   ClassDef(TEveTrackListGL, 0); // GL-renderer drawing all tracks of a TEveTrackList at once.
+};
+
+#endif
@@ -20,6 +20,7 @@ class TEveTrackProjected : public TEveTrack,
                            public TEveProjected
 {
    friend class TEveTrackProjectedGL;
+   friend class TEveTrackListGL;
 
 private:
    TEveTrackProjected(const TEveTrackProjected&);            // Not implemented
@@ -541,6 +541,23 @@ void TEveTrack::PrintPathMarks()
 
 //------------------------------------------------------------------------------
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add change-stamp bits. Parent track-lists that render their tracks
+/// in one batch (see TEveTrackList::SetRnrBatched()) are stamped as
+/// well as they have to rebuild their GL representation.
+
+void TEveTrack::AddStamp(UChar_t bits)
+{
+   TEveLine::AddStamp(bits);
+
+   for (List_i p=BeginParents(); p!=EndParents(); ++p)
+   {
+      TEveTrackList* tl = dynamic_cast<TEveTrackList*>(*p);
+      if (tl && tl->GetRnrBatched())
+         tl->AddStamp(kCBObjProps | (bits & kCBTransBBox));
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Emits "SecSelected(TEveTrack*)" signal.
 /// Called from TEveTrackGL on secondary-selection.
@@ -554,6 +571,15 @@ void TEveTrack::SecSelected(TEveTrack* track)
 \ingroup TEve
 A list of tracks supporting change of common attributes and
 selection based on track parameters.
+
+With SetRnrBatched(kTRUE) the list itself is published to GL instead
+of its tracks and TEveTrackListGL draws all visible tracks from a
+single display-list. This is much faster for lists with many tracks
+but the tracks share the line and marker attributes of the list,
+only their colors are kept. Path-marks and the first vertex are not
+drawn and a track can not be selected or highlighted on its own;
+secondary selection of a track still emits TEveTrack::SecSelected().
+Children that are not tracks are painted as usual.
 */
 
 ClassImp(TEveTrackList);
@@ -571,6 +597,7 @@ TEveTrackList::TEveTrackList(TEveTrackPropagator* prop) :
    fRecurse(kTRUE),
    fRnrLine(kTRUE),
    fRnrPoints(kFALSE),
+   fRnrBatched(kFALSE),
 
    fMinPt (0), fMaxPt (0), fLimPt (0),
    fMinP  (0), fMaxP  (0), fLimP  (0)
@@ -597,6 +624,7 @@ TEveTrackList::TEveTrackList(const char* name, TEveTrackPropagator* prop) :
    fRecurse(kTRUE),
    fRnrLine(kTRUE),
    fRnrPoints(kFALSE),
+   fRnrBatched(kFALSE),
 
    fMinPt (0), fMaxPt (0), fLimPt (0),
    fMinP  (0), fMaxP  (0), fLimP  (0)
@@ -989,6 +1017,16 @@ void TEveTrackList::SetMarkerSize(Size_t size, TEveElement* el)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set batched rendering of tracks, see class description.
+
+void TEveTrackList::SetRnrBatched(Bool_t b)
+{
+   if (fRnrBatched == b) return;
+   fRnrBatched = b;
+   StampVisibility();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Select visibility of tracks by transverse momentum.
 /// If data-member fRecurse is set, the selection is applied
@@ -1125,6 +1163,63 @@ TEveTrack* TEveTrackList::FindTrackByIndex(Int_t index)
    return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Compute bounding-box of all tracks, needed for batched rendering.
+
+void TEveTrackList::ComputeBBox()
+{
+   Int_t n = 0;
+   BBoxInit();
+   for (List_i i=BeginChildren(); i!=EndChildren(); ++i)
+   {
+      TEveTrack* track = dynamic_cast<TEveTrack*>(*i);
+      if (track && track->Size() > 0)
+      {
+         const Float_t* b = track->AssertBBox();
+         BBoxCheckPoint(b[0], b[2], b[4]);
+         BBoxCheckPoint(b[1], b[3], b[5]);
+         ++n;
+      }
+   }
+   if (n == 0)
+      BBoxZero();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Paint the list as a single object when rendering is batched.
+
+void TEveTrackList::Paint(Option_t* /*option*/)
+{
+   if (fRnrBatched)
+      PaintStandard(this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Paint the list and its children. When rendering is batched the
+/// tracks are drawn by the list itself and only the other children
+/// are painted.
+
+void TEveTrackList::PadPaint(Option_t* option)
+{
+   if ( ! fRnrBatched)
+   {
+      TEveElementList::PadPaint(option);
+      return;
+   }
+
+   if (GetRnrSelf() && GetRnrChildren())
+      Paint(option);
+
+   if (GetRnrChildren())
+   {
+      for (List_i i=BeginChildren(); i!=EndChildren(); ++i)
+      {
+         if (dynamic_cast<TEveTrack*>(*i) == 0)
+            (*i)->PadPaint(option);
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Copy visualization parameters from element el.
 
@@ -1138,6 +1233,7 @@ void TEveTrackList::CopyVizParams(const TEveElement* el)
       fRecurse = m->fRecurse;
       fRnrLine = m->fRnrLine;
       fRnrPoints = m->fRnrPoints;
+      fRnrBatched = m->fRnrBatched;
       fMinPt   = m->fMinPt;
       fMaxPt   = m->fMaxPt;
       fLimPt   = m->fLimPt;
@@ -1162,6 +1258,7 @@ void TEveTrackList::WriteVizParams(std::ostream& out, const TString& var)
    out << t << "SetRecurse("   << ToString(fRecurse)   << ");\n";
    out << t << "SetRnrLine("   << ToString(fRnrLine)   << ");\n";
    out << t << "SetRnrPoints(" << ToString(fRnrPoints) << ");\n";
+   out << t << "SetRnrBatched(" << ToString(fRnrBatched) << ");\n";
    // These setters are not available -- need proper AND/OR mode.
    // out << t << "SetMinPt(" << fMinPt << ");\n";
    // out << t << "SetMaxPt(" << fMaxPt << ");\n";
@@ -0,0 +1,146 @@
+// @(#)root/eve:$Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2017, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "TEveTrackListGL.h"
+#include "TEveTrack.h"
+#include "TEveTrackProjected.h"
+
+#include "TGLIncludes.h"
+#include "TGLRnrCtx.h"
+#include "TGLSelectRecord.h"
+
+/** \class TEveTrackListGL
+\ingroup TEve
+GL-renderer drawing all tracks of a TEveTrackList at once, used when
+the list is set to batched rendering, see TEveTrackList::SetRnrBatched().
+
+The lines of all visible tracks are drawn from vertex arrays between a
+single setup of the line attributes of the list, so the whole list is
+captured in one display-list. During secondary selection each track
+gets its own GL name, its index among the children of the list.
+*/
+
+ClassImp(TEveTrackListGL);
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor.
+
+TEveTrackListGL::TEveTrackListGL() : TGLObject(), fM(0)
+{
+   fMultiColor = kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set model object.
+
+Bool_t TEveTrackListGL::SetModel(TObject* obj, const Option_t* /*opt*/)
+{
+   fM = SetModelDynCast<TEveTrackList>(obj);
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Setup bounding box information, the tracks might have changed.
+
+void TEveTrackListGL::SetBBox()
+{
+   fM->ResetBBox();
+   SetAxisAlignedBBox(fM->AssertBBox());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Render the tracks with GL.
+
+void TEveTrackListGL::DirectDraw(TGLRnrCtx& rnrCtx) const
+{
+   TEveTrackList& tl = *fM;
+
+   if (rnrCtx.SecSelection()) glPushName(0);
+
+   if (tl.GetRnrLine())
+   {
+      TGLUtil::BeginAttLine(tl, tl.GetMainTransparency(),
+                            rnrCtx.GetPickRadius(), rnrCtx.Selection());
+      glEnableClientState(GL_VERTEX_ARRAY);
+
+      UInt_t idx = 0;
+      for (TEveElement::List_i i=tl.BeginChildren(); i!=tl.EndChildren(); ++i, ++idx)
+      {
+         TEveTrack* track = dynamic_cast<TEveTrack*>(*i);
+         if (track == 0 || ! track->GetRnrSelf() || ! track->GetRnrLine() || track->Size() < 2)
+            continue;
+
+         if (rnrCtx.SecSelection()) glLoadName(idx);
+         TGLUtil::ColorTransparency(track->GetLineColor(), track->GetMainTransparency());
+         glVertexPointer(3, GL_FLOAT, 0, track->GetP());
+
+         TEveTrackProjected* ptrack = dynamic_cast<TEveTrackProjected*>(track);
+         if (ptrack && ! ptrack->fBreakPoints.empty())
+         {
+            Int_t start = 0;
+            for (std::vector<Int_t>::iterator bpi = ptrack->fBreakPoints.begin();
+                 bpi != ptrack->fBreakPoints.end(); ++bpi)
+            {
+               glDrawArrays(GL_LINE_STRIP, start, *bpi - start);
+               start = *bpi;
+            }
+         }
+         else
+         {
+            glDrawArrays(GL_LINE_STRIP, 0, track->Size());
+         }
+      }
+
+      glDisableClientState(GL_VERTEX_ARRAY);
+      TGLUtil::EndAttLine(rnrCtx.GetPickRadius(), rnrCtx.Selection());
+   }
+
+   if (tl.GetRnrPoints())
+   {
+      UInt_t idx = 0;
+      for (TEveElement::List_i i=tl.BeginChildren(); i!=tl.EndChildren(); ++i, ++idx)
+      {
+         TEveTrack* track = dynamic_cast<TEveTrack*>(*i);
+         if (track == 0 || ! track->GetRnrSelf() || ! track->GetRnrPoints() || track->Size() < 1)
+            continue;
+
+         if (rnrCtx.SecSelection()) glLoadName(idx);
+         TGLUtil::ColorTransparency(track->GetMarkerColor(), track->GetMainTransparency());
+         TGLUtil::LockColor(); // Keep the color of the track.
+         TGLUtil::RenderPolyMarkers(tl, 0, track->GetP(), track->Size(),
+                                    rnrCtx.GetPickRadius(),
+                                    rnrCtx.Selection());
+         TGLUtil::UnlockColor();
+      }
+   }
+
+   if (rnrCtx.SecSelection()) glPopName();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Processes secondary selection from TGLViewer.
+/// Calls SecSelected(track) of the picked track which emits a signal,
+/// as TEveTrackGL does for tracks rendered on their own.
+
+void TEveTrackListGL::ProcessSelection(TGLRnrCtx& /*rnrCtx*/, TGLSelectRecord& rec)
+{
+   if (rec.GetN() < 2) return;
+
+   Int_t idx = rec.GetItem(1);
+   for (TEveElement::List_i i=fM->BeginChildren(); i!=fM->EndChildren(); ++i, --idx)
+   {
+      if (idx == 0)
+      {
+         TEveTrack* track = dynamic_cast<TEveTrack*>(*i);
+         if (track) track->SecSelected(track);
+         return;
+      }
+   }
+}
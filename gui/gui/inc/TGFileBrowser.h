@@ -22,6 +22,7 @@
 
 #include <list>
 #include <map>
+#include <set>
 
 class TGCanvas;
 class TGListTree;
@@ -77,7 +78,15 @@ protected:
    mFiltered_t        fFilteredItems;     // List of filtered list-tree items.
    TString            fFilterStr;         // Filter expression string
 
+   TGListTreeItem    *fNamesLevel;        //! List tree level whose children names are in fNames
+   TGListTreeItem    *fNamesFirst;        //! First child of fNamesLevel when fNames was updated
+   TGListTreeItem    *fNamesLast;         //! Last child of fNamesLevel when fNames was updated
+   std::set<TString>  fNames;             //! Names of the children of fNamesLevel
+   std::set<void*>    fKeyObjs;           //! Keys already listed under the current directory
+
    void CreateBrowser();
+   void ChildAdded(TGListTreeItem *item);
+   Bool_t HasChild(TGListTreeItem *parent, const char *name);
 
 public:
    TGFileBrowser(const TGWindow *p, TBrowser* b=0, UInt_t w=200, UInt_t h=400);
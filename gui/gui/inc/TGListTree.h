@@ -259,6 +259,7 @@ protected:
    Bool_t           fUserControlled; // let user decides what is the behaviour on events
    Bool_t           fEventHandled;   // flag used from user code to bypass standard event handling
    UInt_t           fLastEventState; // modifier state of the last keyboard event
+   Bool_t           fVirtualized;    // measure only the items in the visible region
 
    EColorMarkupMode fColorMode;      // if/how to render item's main color
    ECheckMode       fCheckMode;      // how to propagate check properties through the tree
@@ -395,6 +396,8 @@ public:
    void  HighlightItem(TGListTreeItem *item, Bool_t state, Bool_t draw);
    void  HighlightChildren(TGListTreeItem *item, Bool_t state, Bool_t draw);
    void  DisableOpen(Bool_t disable = kTRUE) { fDisableOpen = disable;}
+   void  SetVirtualized(Bool_t on = kTRUE) { fVirtualized = on; }
+   Bool_t IsVirtualized() const { return fVirtualized; }
    void  GetChecked(TList *checked);
    void  GetCheckedChildren(TList *checked, TGListTreeItem *item);
    void  CheckAllChildren(TGListTreeItem *item, Bool_t state);
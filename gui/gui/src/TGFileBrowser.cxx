@@ -100,6 +100,18 @@ public:
 
 ClassImp(TGFileBrowser)
 
+////////////////////////////////////////////////////////////////////////////////
+/// Insert in objs the user data of item and of all its descendants.
+
+static void CollectUserData(TGListTreeItem *item, std::set<void*> &objs)
+{
+   for (; item; item = item->GetNextSibling()) {
+      if (item->GetUserData())
+         objs.insert(item->GetUserData());
+      CollectUserData(item->GetFirstChild(), objs);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// TGFileBrowser constructor.
 
@@ -176,6 +188,7 @@ void TGFileBrowser::CreateBrowser()
             kLHintsExpandX, 2, 2, 2, 2));
    fCanvas   = new TGCanvas(this, 100, 100);
    fListTree = new TGListTree(fCanvas, kHorizontalFrame);
+   fListTree->SetVirtualized();
    AddFrame(fCanvas, new TGLayoutHints(kLHintsLeft | kLHintsTop |
                 kLHintsExpandX | kLHintsExpandY));
    fListTree->Connect("DoubleClicked(TGListTreeItem *, Int_t)",
@@ -219,6 +232,9 @@ void TGFileBrowser::CreateBrowser()
    fNKeys       = 0;
    fCnt         = 0;
    fFilterStr   = "*";
+   fNamesLevel  = 0;
+   fNamesFirst  = 0;
+   fNamesLast   = 0;
 
    TString gv = gEnv->GetValue("Browser.GroupView", "1000");
    Int_t igv = atoi(gv.Data());
@@ -367,9 +383,10 @@ void TGFileBrowser::Add(TObject *obj, const char *name, Int_t check)
       GetObjPicture(&pic, obj);
       if (!name) name = obj->GetName();
       if (check > -1) {
-         if (!fListTree->FindChildByName(fListLevel, name)) {
+         if (!HasChild(fListLevel, name)) {
             TGListTreeItem *item = fListTree->AddItem(fListLevel, name, obj,
                                                       pic, pic, kTRUE);
+            ChildAdded(item);
             if ((pic != fFileIcon) && (pic != fCachedPic))
                fClient->FreePicture(pic);
             if (item) fListTree->CheckItem(item, (Bool_t)check);
@@ -408,8 +425,9 @@ void TGFileBrowser::Add(TObject *obj, const char *name, Int_t check)
             }
          }
          else {
-            if (!fListTree->FindChildByName(fListLevel, name)) {
+            if (!HasChild(fListLevel, name)) {
                TGListTreeItem *item = fListTree->AddItem(fListLevel, name, obj, pic, pic);
+               ChildAdded(item);
                if ((pic != fFileIcon) && (pic != fCachedPic))
                   fClient->FreePicture(pic);
                if (item && obj && obj->InheritsFrom("TObject"))
@@ -465,6 +483,7 @@ void TGFileBrowser::BrowseObj(TObject *obj)
 {
    if (fNewBrowser)
       fNewBrowser->SetActBrowser(this);
+   fNamesLevel = 0;
    if (obj != gROOT) {
       if (!fListTree->FindItemByObj(fListTree->GetFirstItem(), obj)) {
          fListLevel = 0;
@@ -782,7 +801,6 @@ void TGFileBrowser::AddFSDirectory(const char *entry, const char *path,
 void TGFileBrowser::AddKey(TGListTreeItem *itm, TObject *obj, const char *name)
 {
    // Int_t from, to;
-   TGListTreeItem *where;
    static TGListTreeItem *olditem = itm;
    static TGListTreeItem *item = itm;
    const TGPicture *pic;
@@ -791,16 +809,15 @@ void TGFileBrowser::AddKey(TGListTreeItem *itm, TObject *obj, const char *name)
 
    if ((fCnt == 0) || (olditem != itm)) {
       olditem = item = itm;
+      // the keys already listed, to skip them without searching the
+      // whole level for each key
+      fKeyObjs.clear();
+      if (fNKeys > fGroupSize)
+         CollectUserData(itm->GetFirstChild(), fKeyObjs);
    }
    if (!name) name = obj->GetName();
-   if (fNKeys > fGroupSize) {
-      where = itm->GetFirstChild();
-      while (where) {
-         if (fListTree->FindItemByObj(where, obj))
-            return;
-         where = where->GetNextSibling();
-      }
-   }
+   if ((fNKeys > fGroupSize) && !fKeyObjs.insert(obj).second)
+      return;
    if ((fNKeys > fGroupSize) && (fCnt % fGroupSize == 0)) {
       if (item != itm) {
          TString newname = TString::Format("%s-%s", item->GetText(), name);
@@ -814,8 +831,9 @@ void TGFileBrowser::AddKey(TGListTreeItem *itm, TObject *obj, const char *name)
       item->Rename(newname.Data());
    }
    GetObjPicture(&pic, obj);
-   if (!fListTree->FindChildByName(item, name)) {
+   if (!HasChild(item, name)) {
       TGListTreeItem *it = fListTree->AddItem(item, name, obj, pic, pic);
+      ChildAdded(it);
       if (pic && (pic != fFileIcon) && (pic != fCachedPic))
          fClient->FreePicture(pic);
       it->SetDNDSource(kTRUE);
@@ -824,6 +842,44 @@ void TGFileBrowser::AddKey(TGListTreeItem *itm, TObject *obj, const char *name)
    fCnt++;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Returns kTRUE if parent has a child called name. The names of the
+/// children of the last level looked up are kept, so that adding the n
+/// items of a level does not compare each of them with all the others;
+/// they are collected again when the first or last child of the level
+/// changed since the last call of ChildAdded().
+
+Bool_t TGFileBrowser::HasChild(TGListTreeItem *parent, const char *name)
+{
+   if (!parent)
+      return fListTree->FindChildByName(0, name) != 0;
+   if ((parent != fNamesLevel) || (parent->GetFirstChild() != fNamesFirst) ||
+       (parent->GetLastChild() != fNamesLast)) {
+      fNames.clear();
+      TGListTreeItem *child = parent->GetFirstChild();
+      while (child) {
+         fNames.insert(child->GetText());
+         child = child->GetNextSibling();
+      }
+      fNamesLevel = parent;
+      fNamesFirst = parent->GetFirstChild();
+      fNamesLast  = parent->GetLastChild();
+   }
+   return fNames.find(name) != fNames.end();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Keeps the names used by HasChild() up to date after item was added.
+
+void TGFileBrowser::ChildAdded(TGListTreeItem *item)
+{
+   if (!item || !fNamesLevel || (item->GetParent() != fNamesLevel))
+      return;
+   fNames.insert(item->GetText());
+   fNamesFirst = fNamesLevel->GetFirstChild();
+   fNamesLast  = fNamesLevel->GetLastChild();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Apply filter selected in combo box to the file tree view.
 
@@ -1227,6 +1283,7 @@ void TGFileBrowser::DoubleClicked(TGListTreeItem *item, Int_t /*btn*/)
       fNewBrowser->SetActBrowser(this);
    TCursorSwitcher switcher(this, fListTree);
    fListLevel = item;
+   fNamesLevel = 0;
    CheckSorted(item, kTRUE);
    CheckFiltered(item, kTRUE);
    CheckRemote(item);
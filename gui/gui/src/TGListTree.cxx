@@ -35,6 +35,11 @@
 // kC_LISTTREE, kCT_ITEMCLICK, which button, location (y<<16|x).        //
 // kC_LISTTREE, kCT_ITEMDBLCLICK, which button, location (y<<16|x).     //
 //                                                                      //
+// With SetVirtualized(), only the items in the visible region are      //
+// measured when the list tree is drawn, which keeps scrolling fast     //
+// through levels with a very large number of items; the width of the   //
+// list tree then only grows with the widths of the items shown.        //
+//                                                                      //
 //////////////////////////////////////////////////////////////////////////
 
 #include <stdlib.h>
@@ -351,6 +356,7 @@ TGListTree::TGListTree(TGWindow *p, UInt_t w, UInt_t h, UInt_t options,
    fDisableOpen = kFALSE;
    fBdown       = kFALSE;
    fUserControlled = kFALSE;
+   fVirtualized = kFALSE;
    fEventHandled   = kFALSE;
    fExposeTop = fExposeBottom = 0;
    fDropItem = 0;
@@ -414,6 +420,7 @@ TGListTree::TGListTree(TGCanvas *p,UInt_t options,ULong_t back) :
    fDisableOpen = kFALSE;
    fBdown       = kFALSE;
    fUserControlled = kFALSE;
+   fVirtualized = kFALSE;
    fEventHandled   = kFALSE;
    fExposeTop = fExposeBottom = 0;
    fDropItem = 0;
@@ -1414,7 +1421,10 @@ void TGListTree::Draw(Handle_t id, Int_t yevent, Int_t hevent)
    fExposeBottom = yevent + hevent + FontHeight();
    old_width  = fDefw;
    old_height = fDefh;
-   fDefw = fDefh = 1;
+   // In virtualized mode only the exposed items are measured, so the width
+   // is kept from the previous draws instead of shrinking to theirs
+   if (!fVirtualized) fDefw = 1;
+   fDefh = 1;
 
    TGPosition pos = GetPagePosition();
    x = 2-pos.fX;
@@ -1578,6 +1588,13 @@ void TGListTree::DrawItem(Handle_t id, TGListTreeItem *item, Int_t x, Int_t y,
          pic1->Draw(id, fDrawGC, xpic1, ypicp);
       if (pic2)
          pic2->Draw(id, fDrawGC, xpic2, ypicp);
+   } else if (fVirtualized) {
+      // Not exposed: skip measuring the text, which costs much more than
+      // the geometry when the tree holds many items
+      *xroot = xbranch;
+      *retwidth  = item->GetPicWidth();
+      *retheight = height;
+      return;
    }
 
    *xroot = xbranch;
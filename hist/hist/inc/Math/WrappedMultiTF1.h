@@ -141,6 +141,11 @@ private:
       return fFunc->EvalPar(x,p);
    }
 
+   /// evaluate the function at many points at once
+   void DoEvalParN (unsigned int n, const double * x, unsigned int stride, const double * p, double * f) const {
+      fFunc->EvalParN(n, x, stride, p, f);
+   }
+
    /// evaluate function using the cached parameter values (of TF1)
    /// re-implement for better efficiency
    double DoEval (const double* x) const { 
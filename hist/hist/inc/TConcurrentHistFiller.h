@@ -0,0 +1,73 @@
+// @(#)root/hist:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TConcurrentHistFiller
+#define ROOT_TConcurrentHistFiller
+
+#include "TH1.h"
+
+#include <atomic>
+
+class TAxis;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a TH1D, TH2D or TH3D from several threads at the same time, without
+/// lock and without a copy of the histogram per thread.
+///
+/// The bins of the histogram are incremented in place with atomic operations;
+/// the number of entries and the statistics are summed in a few counters
+/// shared by groups of threads, and added to the histogram by Flush(). After
+/// Flush(), when no thread is filling, the histogram is a normal histogram
+/// which can be drawn, fitted or written.
+class TConcurrentHistFiller {
+public:
+   explicit TConcurrentHistFiller(TH1 &h);
+   ~TConcurrentHistFiller();
+
+   Int_t Fill(Double_t x, Double_t w = 1.);
+   Int_t Fill(Double_t x, Double_t y, Double_t w);
+   Int_t Fill(Double_t x, Double_t y, Double_t z, Double_t w);
+
+   void  Flush();
+   TH1  *GetHist() const { return fHist; }
+
+private:
+   enum {
+      kNShards  = 64,           // number of groups of threads sharing statistics counters
+      kEntries  = TH1::kNstat,  // index of the number of entries in a group of counters
+      kNCounters = 16           // counters of a group: the statistics, the entries and a padding to 128 bytes
+   };
+
+   struct Shard_t {
+      std::atomic<Double_t> fCounters[kNCounters];
+   };
+
+   TConcurrentHistFiller(const TConcurrentHistFiller &);            // Not implemented
+   TConcurrentHistFiller &operator=(const TConcurrentHistFiller &); // Not implemented
+
+   Int_t    AddToBin(Int_t bin, Double_t w);
+   Shard_t &GetShard();
+
+   TH1         *fHist;           ///< Histogram being filled
+   Double_t    *fArray;          ///< Array of the bin contents of fHist, 0 if it cannot be filled
+   Double_t    *fSumw2;          ///< Array of the sums of the squares of the weights, 0 if not stored
+   const TAxis *fXaxis;          ///< Axes of fHist
+   const TAxis *fYaxis;
+   const TAxis *fZaxis;
+   Int_t        fDimension;      ///< Dimension of fHist
+   Int_t        fNx;             ///< Number of bins of the axes, without under- and overflow
+   Int_t        fNy;
+   Int_t        fNz;
+   Bool_t       fStatOverflows;  ///< Whether the under- and overflows are used in the statistics (see TH1::StatOverflows)
+   Shard_t      fShards[kNShards];
+};
+
+#endif
@@ -43,6 +43,7 @@
 #endif
 
 class TF1;
+class TF1IntegralCache;
 class TH1;
 class TAxis;
 class TMethodCall;
@@ -187,6 +188,7 @@ protected:
    ROOT::Math::ParamFunctor fFunctor;   //! Functor object to wrap any C++ callable object
    TFormula    *fFormula;    //Pointer to TFormula in case when user define formula
    TF1Parameters *fParams;   //Pointer to Function parameters object (exusts only for not-formula functions)
+   TF1IntegralCache *fIntegralCache = nullptr; //!Tables of GetRandom kept for other parameter values
 
    static std::atomic<Bool_t> fgAbsValue;  //use absolute value of function when computing integral
    static Bool_t fgRejectPoint;  //True if point must be rejected in a fit
@@ -199,6 +201,10 @@ protected:
 
    void IntegrateForNormalization();
 
+   Bool_t MakeRandomTable(Bool_t logScale);
+   void   ComputeBinIntegrals(const std::vector<Double_t> &xx, Bool_t logbin, std::vector<Double_t> &binIntegral,
+                              std::vector<Double_t> &halfIntegral);
+
    virtual Double_t GetMinMaxNDim(Double_t * x , Bool_t findmax, Double_t epsilon = 0, Int_t maxiter = 0) const;
    virtual void GetRange(Double_t * xmin, Double_t * xmax) const;
    virtual TH1 *DoCreateHistogram(Double_t xmin, Double_t xmax, Bool_t recreate = kFALSE);
@@ -329,6 +335,8 @@ public:
    virtual void     DrawF1(Double_t xmin, Double_t xmax, Option_t *option="");
    virtual Double_t Eval(Double_t x, Double_t y=0, Double_t z=0, Double_t t=0) const;
    virtual Double_t EvalPar(const Double_t *x, const Double_t *params=0);
+   virtual void     EvalParN(Int_t n, const Double_t *x, Int_t stride, const Double_t *params, Double_t *result);
+   void             EvalParSoA(Int_t n, const Double_t *x, const Double_t *params, Double_t *result);
    virtual Double_t operator()(Double_t x, Double_t y=0, Double_t z = 0, Double_t t = 0) const;
    virtual Double_t operator()(const Double_t *x, const Double_t *params=0);
    virtual void     ExecuteEvent(Int_t event, Int_t px, Int_t py);
@@ -380,6 +388,8 @@ public:
    virtual Int_t    GetQuantiles(Int_t nprobSum, Double_t *q, const Double_t *probSum);
    virtual Double_t GetRandom();
    virtual Double_t GetRandom(Double_t xmin, Double_t xmax);
+   void             GetRandomArray(Int_t n, Double_t *x);
+   Int_t            GetIntegralCacheSize() const;
    virtual void     GetRange(Double_t &xmin, Double_t &xmax) const;
    virtual void     GetRange(Double_t &xmin, Double_t &ymin, Double_t &xmax, Double_t &ymax) const;
    virtual void     GetRange(Double_t &xmin, Double_t &ymin, Double_t &zmin, Double_t &xmax, Double_t &ymax, Double_t &zmax) const;
@@ -428,6 +438,7 @@ public:
    virtual void     SetNumberFitPoints(Int_t npfits) {fNpfits = npfits;}
    virtual void     SetNormalized(Bool_t flag) { fNormalized = flag; Update(); }
    virtual void     SetNpx(Int_t npx=100); // *MENU*
+   void             SetIntegralCacheSize(Int_t n);
    virtual void     SetParameter(Int_t param, Double_t value) {
       (fFormula) ? fFormula->SetParameter(param,value) : fParams->SetParameter(param,value);
       Update();
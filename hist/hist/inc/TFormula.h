@@ -28,6 +28,7 @@
 #include <vector>
 #include <list>
 #include <map>
+#include <atomic>
 
 class TFormulaFunction
 {
@@ -96,16 +97,26 @@ private:
    std::vector<Double_t>  fClingVariables;       //!  cached variables
    std::vector<Double_t>  fClingParameters;      //  parameter values
    Bool_t            fReadyToExecute;       //! trasient to force initialization
-   Bool_t            fClingInitialized;  //!  transient to force re-initialization
+   mutable Bool_t    fClingInitialized;  //!  transient to force re-initialization
    Bool_t            fAllParametersSetted;    // flag to control if all parameters are setted
    TMethodCall*      fMethod;        //! pointer to methocall
    TString           fClingName;     //! unique name passed to Cling to define the function ( double clingName(double*x, double*p) )
 
-   TInterpreter::CallFuncIFacePtr_t::Generic_t fFuncPtr;   //!  function pointer
+   mutable TInterpreter::CallFuncIFacePtr_t::Generic_t fFuncPtr;   //!  function pointer
    void *   fLambdaPtr;                                    //!  pointer to the lambda function
+   mutable std::atomic<TInterpreter::CallFuncIFacePtr_t::Generic_t> fBatchFuncPtr{nullptr}; //! function pointer of the batch evaluation
+   mutable std::atomic<Bool_t> fBatchPrepared{false};     //! true once the batch function has been looked for
+   mutable Bool_t    fClingPending = false; //! true if the function waits for CompileDeferred (see SetDeferredCompilation)
+
+   static Bool_t     fgDeferred;            //  true if the compilation of the new formulas is deferred
+   static TString    fgCacheDirectory;      //  directory of the libraries of compiled formulas
 
    void     InputFormulaIntoCling();
+   Bool_t   ResolveDeferred() const;
    Bool_t   PrepareEvalMethod();
+   Bool_t   PrepareBatchMethod() const;
+   void     ResetBatchMethod();
+   void     DoEvalParN(Int_t n, const Double_t *x, Int_t pointStride, Int_t coordStride, const Double_t *params, Double_t *result) const;
    void     FillDefaults();
    void     HandlePolN(TString &formula);
    void     HandleParametrizedFunctions(TString &formula);
@@ -169,6 +180,8 @@ public:
    Double_t       Eval(Double_t x, Double_t y , Double_t z) const;
    Double_t       Eval(Double_t x, Double_t y , Double_t z , Double_t t ) const;
    Double_t       EvalPar(const Double_t *x, const Double_t *params=0) const;
+   void           EvalParN(Int_t n, const Double_t *x, Int_t stride, const Double_t *params, Double_t *result) const;
+   void           EvalParSoA(Int_t n, const Double_t *x, const Double_t *params, Double_t *result) const;
    TString        GetExpFormula(Option_t *option="") const;
    const TObject *GetLinearPart(Int_t i) const;
    Int_t          GetNdim() const {return fNdim;}
@@ -183,7 +196,7 @@ public:
    Double_t       GetVariable(const char *name) const;
    Int_t          GetVarNumber(const char *name) const;
    TString        GetVarName(Int_t ivar) const;
-   Bool_t         IsValid() const { return fReadyToExecute && fClingInitialized; }
+   Bool_t         IsValid() const { return fReadyToExecute && (fClingInitialized || fClingPending); }
    Bool_t         IsLinear() const { return TestBit(kLinear); }
    void           Print(Option_t *option = "") const;
    void           SetName(const char* name);
@@ -202,6 +215,12 @@ public:
    void           SetVariable(const TString &name, Double_t value);
    void           SetVariables(const std::pair<TString,Double_t> *vars, const Int_t size);
 
+   static void    SetDeferredCompilation(Bool_t on = kTRUE);
+   static Bool_t  IsDeferredCompilation() { return fgDeferred; }
+   static Int_t   CompileDeferred();
+   static void    SetCacheDirectory(const char *dir);
+   static const char *GetCacheDirectory();
+
    ClassDef(TFormula,10)
 };
 #endif
@@ -144,6 +144,7 @@ public:
    virtual Double_t      GetZmaxE() const {return GetZmax();};
    virtual Double_t      GetZminE() const {return GetZmin();};
    Double_t              Interpolate(Double_t x, Double_t y);
+   void                  Interpolate(Int_t n, const Double_t *x, const Double_t *y, Double_t *z);
    void                  Paint(Option_t *option="");
    TH1                  *Project(Option_t *option="x") const; // *MENU*
    Int_t                 RemovePoint(Int_t ipoint); // *MENU*
@@ -0,0 +1,52 @@
+// @(#)root/hist:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TGraphInterpolator
+#define ROOT_TGraphInterpolator
+
+#include "Rtypes.h"
+
+#include <vector>
+
+class TGraph;
+class TSpline3;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Interpolate a TGraph many times, as TGraph::Eval(x, 0, option), with the
+/// points sorted once and, for option "S", the spline built once.
+///
+/// The interval of the previous point is tried first, so that evaluating
+/// increasing or close values of x is faster than a binary search. The
+/// interpolator keeps a copy of the points: it must be created again if the
+/// graph changes. As it keeps this interval, an interpolator must not be used
+/// by several threads at the same time.
+class TGraphInterpolator {
+public:
+   explicit TGraphInterpolator(const TGraph &g, Option_t *option = "");
+   ~TGraphInterpolator();
+
+   Double_t Eval(Double_t x);
+   void     Eval(Int_t n, const Double_t *x, Double_t *y);
+   Int_t    GetN() const { return fX.size(); }
+
+private:
+   TGraphInterpolator(const TGraphInterpolator &);            // Not implemented
+   TGraphInterpolator &operator=(const TGraphInterpolator &); // Not implemented
+
+   Int_t FindInterval(Double_t x);
+
+   std::vector<Double_t> fX;      ///< Abscissas of the points, sorted
+   std::vector<Double_t> fY;      ///< Ordinates of the points
+   TSpline3             *fSpline; ///< Spline through the points for option "S", 0 otherwise
+   Int_t                 fLast;   ///< Interval found for the previous point
+};
+
+#endif
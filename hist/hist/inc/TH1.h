@@ -98,6 +98,7 @@ public:
    };
 
    friend class TH1Merger;
+   friend class TConcurrentHistFiller;
 
 protected:
     Int_t         fNcells;          ///< number of bins(1D), cells (2D) +U/Overflows
@@ -157,7 +158,11 @@ protected:
    virtual Double_t DoIntegral(Int_t ix1, Int_t ix2, Int_t iy1, Int_t iy2, Int_t iz1, Int_t iz2, Double_t & err,
                                Option_t * opt, Bool_t doerr = kFALSE) const;
 
+   enum {
+      kNFillChunk  = 256 // number of entries of which FillN finds the bins at once
+   };
    virtual void     DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride=1);
+   void             DoFillNSumw2(Int_t ntimes, const Double_t *w, Int_t stride);
 
    static bool CheckAxisLimits(const TAxis* a1, const TAxis* a2);
    static bool CheckBinLimits(const TAxis* a1, const TAxis* a2);
@@ -35,6 +35,8 @@ class TProfile;
 
 class TH2 : public TH1 {
 
+   friend class TConcurrentHistFiller;
+
 protected:
    Double_t     fScalefactor;     //Scale factor
    Double_t     fTsumwy;          //Total Sum of weight*Y
@@ -64,6 +64,7 @@ class TList;
 class TGraph;
 class TMultiGraph;
 class TPad;
+class TH2PolyQuadTree;
 
 class TH2Poly : public TH2 {
 
@@ -108,6 +109,7 @@ public:
    Double_t     GetMinimum() const;
    Double_t     GetMinimum(Double_t minval) const;
    Bool_t       GetNewBinAdded() const{return fNewBinAdded;}
+   Bool_t       GetUseQuadTree() const{return fUseQuadTree;}
    Int_t        GetNumberOfBins() const{return fNcells;}
    void         Honeycomb(Double_t xstart, Double_t ystart, Double_t a, Int_t k, Int_t s);   // Bins the histogram using a honeycomb structure
    Double_t     Integral(Option_t* option = "") const;
@@ -124,6 +126,7 @@ public:
    void         SetBinContentChanged(Bool_t flag){fBinContentChanged = flag;}
    void         SetFloat(Bool_t flag = true);
    void         SetNewBinAdded(Bool_t flag){fNewBinAdded = flag;}
+   void         SetUseQuadTree(Bool_t flag = kTRUE);
 
 protected:
    TList   *fBins;              //List of bins. The list owns the contained objects
@@ -138,8 +141,11 @@ protected:
    Bool_t   fFloat;             //When set to kTRUE, allows the histogram to expand if a bin outside the limits is added.
    Bool_t   fNewBinAdded;       //!For the 3D Painter
    Bool_t   fBinContentChanged; //!For the 3D Painter
+   Bool_t   fUseQuadTree;       //!When set to kTRUE, Fill() and FindBin() look up the bins in a quadtree
+   TH2PolyQuadTree *fQuadTree;  //!Quadtree of the bins, built by the first Fill() or FindBin() after AddBin()
 
    void   AddBinToPartition(TH2PolyBin *bin);  // Adds the input bin into the partition matrix
+   TH2PolyBin *FindPolyBin(Double_t x, Double_t y); // Returns the bin containing (x,y), inside the histogram limits
    void   Initialize(Double_t xlow, Double_t xup, Double_t ylow, Double_t yup, Int_t n, Int_t m);
    Bool_t IsIntersecting(TH2PolyBin *bin, Double_t xclipl, Double_t xclipr, Double_t yclipb, Double_t yclipt);
    Bool_t IsIntersectingPolygon(Int_t bn, Double_t *x, Double_t *y, Double_t xclipl, Double_t xclipr, Double_t yclipb, Double_t yclipt);
@@ -34,6 +34,8 @@ class TProfile2D;
 
 class TH3 : public TH1, public TAtt3D {
 
+   friend class TConcurrentHistFiller;
+
 protected:
    Double_t     fTsumwy;          //Total Sum of weight*Y
    Double_t     fTsumwy2;         //Total Sum of weight*Y*Y
@@ -84,6 +86,8 @@ public:
    virtual Int_t    Fill(Double_t x, const char *namey, const char *namez, Double_t w);
    virtual Int_t    Fill(Double_t x, const char *namey, Double_t z, Double_t w);
    virtual Int_t    Fill(Double_t x, Double_t y, const char *namez, Double_t w);
+   using TH1::FillN;
+   virtual void     FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride=1);
 
    virtual void     FillRandom(const char *fname, Int_t ntimes=5000);
    virtual void     FillRandom(TH1 *h, Int_t ntimes=5000);
@@ -30,6 +30,8 @@
 #include "THnSparse_Internal.h"
 #endif
 
+#include <vector>
+
 // needed only for template instantiations of THnSparseT:
 #ifndef ROOT_TArrayF
 #include "TArrayF.h"
@@ -54,8 +56,7 @@ class THnSparse: public THnBase {
    Int_t      fChunkSize;    // number of entries for each chunk
    Long64_t   fFilledBins;   // number of filled bins
    TObjArray  fBinContent;   // array of THnSparseArrayChunk
-   TExMap     fBins;         //! filled bins
-   TExMap     fBinsContinued;//! filled bins for non-unique hashes, containing pairs of (bin index 0, bin index 1)
+   std::vector<ULong64_t> fBinTable; //! open-addressing table of the filled bins: pairs of (hash, bin index + 1)
    THnSparseCompactBinCoord *fCompactCoord; //! compact coordinate
 
    THnSparse(const THnSparse&); // Not implemented
@@ -74,8 +75,12 @@ class THnSparse: public THnBase {
    THnSparseArrayChunk* AddChunk();
    void Reserve(Long64_t nbins);
    void FillExMap();
+   Long64_t FindBinIndex(ULong64_t hash, const Char_t* buf, ULong64_t& slot) const;
+   void AddBinIndex(ULong64_t hash, Long64_t idx);
+   void ResizeBinTable(Long64_t nbins);
    virtual TArray* GenerateArray() const = 0;
    Long64_t GetBinIndexForCurrentBin(Bool_t allocate);
+   Long64_t GetBinIndex(ULong64_t hash, const Char_t* buf, Bool_t allocate);
    void FillBin(Long64_t bin, Double_t w) {
       // Increment the bin content of "bin" by "w",
       // return the bin index.
@@ -114,6 +119,8 @@ class THnSparse: public THnBase {
    Long64_t GetBin(const Double_t* x, Bool_t allocate = kTRUE);
    Long64_t GetBin(const char* name[], Bool_t allocate = kTRUE);
 
+   void FillN(Int_t nEntries, const Double_t* x, const Double_t* w = 0);
+
    void SetBinContent(const Int_t* idx, Double_t v) {
       // Forwards to THnBase::SetBinContent().
       // Non-virtual, CINT-compatible replacement of a using declaration.
@@ -100,6 +100,7 @@ public:
    void SetUseBinsNEvents(UInt_t nEvents);
    void SetTuneFactor(Double_t rho);
    void SetRange(Double_t xMin, Double_t xMax); // By default computed from the data
+   void SetEvaluationGrid(UInt_t nGrid); // Interpolate the density from nGrid points computed once, 0 for the exact evaluation
 
    virtual void Draw(const Option_t* option = "");
 
@@ -108,6 +109,7 @@ public:
 
    Double_t GetValue(Double_t x) const { return (*this)(x); }
    Double_t GetError(Double_t x) const;
+   Double_t GetGridError(UInt_t npx = 100, Double_t xMin = 1.0, Double_t xMax = 0.0) const;
 
    Double_t GetBias(Double_t x) const;
    Double_t GetMean() const;
@@ -187,6 +189,11 @@ private:
 
    std::vector<Bool_t> fSettedOptions; // User input options flag
 
+   UInt_t fNGrid;                // Number of points of the evaluation grid, 0 if not used
+   std::vector<Double_t> fGrid;  //! Density at the points of the evaluation grid, empty until computed
+   Double_t fGridXMin;           //! First point of the evaluation grid
+   Double_t fGridStep;           //! Distance between the points of the evaluation grid
+
    struct KernelIntegrand;
    friend struct KernelIntegrand;
 
@@ -235,6 +242,7 @@ private:
    void SetSigma(Double_t R);
    void SetKernel();
    void SetKernelFunction(KernelFunction_Ptr kernfunc = 0);
+   void SetGrid();
    void SetOptions(const Option_t* option, Double_t rho);
    void CheckOptions(Bool_t isUserDefinedKernel = kFALSE);
    void GetOptions(std::string optionType, std::string option);
@@ -252,7 +260,7 @@ private:
    TF1* GetPDFUpperConfidenceInterval(Double_t confidenceLevel = 0.95, UInt_t npx = 100, Double_t xMin = 1.0, Double_t xMax = 0.0);
    TF1* GetPDFLowerConfidenceInterval(Double_t confidenceLevel = 0.95, UInt_t npx = 100, Double_t xMin = 1.0, Double_t xMax = 0.0);
 
-   ClassDef(TKDE, 2) // One dimensional semi-parametric Kernel Density Estimation
+   ClassDef(TKDE, 3) // One dimensional semi-parametric Kernel Density Estimation
 
 };
 
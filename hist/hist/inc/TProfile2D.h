@@ -107,6 +107,8 @@ public:
    virtual Int_t     Fill(const char *namex, Double_t y, Double_t z);
    virtual Int_t     Fill(const char *namex, const char *namey, Double_t z);
    virtual Int_t     Fill(Double_t x, Double_t y, Double_t z, Double_t w);
+   using TH2::FillN;
+   virtual void      FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride=1);
    virtual Double_t  GetBinContent(Int_t bin) const;
    virtual Double_t  GetBinContent(Int_t binx, Int_t biny) const {return GetBinContent(GetBin(binx,biny));}
    virtual Double_t  GetBinContent(Int_t binx, Int_t biny, Int_t) const {return GetBinContent(GetBin(binx,biny));}
@@ -109,6 +109,8 @@ public:
    virtual void      ExtendAxis(Double_t x, TAxis *axis);
    virtual Int_t     Fill(Double_t x, Double_t y, Double_t z, Double_t t);
    virtual Int_t     Fill(Double_t x, Double_t y, Double_t z, Double_t t, Double_t w);
+   using TH3::FillN;
+   virtual void      FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *t, const Double_t *w, Int_t stride=1);
    virtual Double_t  GetBinContent(Int_t bin) const;
    virtual Double_t  GetBinContent(Int_t,Int_t) const
                      { MayNotUse("GetBinContent(Int_t, Int_t"); return -1; }
@@ -99,6 +99,7 @@
 class TUnfold : public TObject {
  private:
    void InitTUnfold(void);     // initialize all data members
+   void ClearCache(void);      // clear the products independent of tau
  public:
    enum EConstraint {
       kEConstraintNone =0, // use no extra constraint
@@ -143,6 +144,9 @@ class TUnfold : public TObject {
    TMatrixDSparse *fDXDY;       // Result: derivative dx/dy
    TMatrixDSparse *fEinv;       // Result: matrix E^(-1)
    TMatrixDSparse *fE;          // Result: matrix E
+   TMatrixDSparse *fAtVyyInv;   //! Cache: A# Vyy^-1, independent of tau
+   TMatrixDSparse *fAtVyyInvA;  //! Cache: A# Vyy^-1 A, independent of tau
+   TMatrixDSparse *fLsquared;   //! Cache: L# L, independent of tau
  protected:
    TUnfold(void);              // for derived classes
    // Int_t IsNotSymmetric(TMatrixDSparse const &m) const;
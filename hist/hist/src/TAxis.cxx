@@ -420,6 +420,51 @@ Int_t TAxis::FindFixBin(Double_t x) const
    return bin;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Find the bin numbers of the n abscissas x[0], x[stride], ... x[(n-1)*stride]
+/// and store them in bins[0] ... bins[n-1].
+///
+/// The bins are the ones returned by TAxis::FindFixBin, but the loop has no
+/// branch, so that the compiler can vectorize it: the bin of a fix bin axis
+/// is computed from the same expression, and the bin of a variable bin axis
+/// by a binary search with a fixed number of steps.
+
+void TAxis::FindFixBinN(Int_t n, const Double_t *x, Int_t *bins, Int_t stride) const
+{
+   const Int_t nbins = fNbins;
+   const Double_t xmin = fXmin;
+   const Double_t xmax = fXmax;
+   if (!fXbins.fN) {        //*-* fix bins
+      const Double_t range = xmax - xmin;
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t xi = x[i*stride];
+         const Bool_t under = xi < xmin;
+         const Bool_t inside = !under && xi < xmax;   // NaN is an overflow
+         const Double_t t = inside ? nbins*(xi-xmin)/range : 0;
+         const Int_t bin = 1 + Int_t(t);
+         bins[i] = inside ? bin : (under ? 0 : nbins+1);
+      }
+   } else {                  //*-* variable bin sizes
+      const Double_t *edges = fXbins.fArray;
+      const Int_t nedges = fXbins.fN;
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t xi = x[i*stride];
+         const Bool_t under = xi < xmin;
+         const Bool_t inside = !under && xi < xmax;
+         // last edge lower or equal to xi, as TMath::BinarySearch
+         const Double_t *base = edges;
+         Int_t len = nedges;
+         while (len > 1) {
+            const Int_t half = len/2;
+            base = (base[half] <= xi) ? base + half : base;
+            len -= half;
+         }
+         const Int_t bin = 1 + Int_t(base - edges);
+         bins[i] = inside ? bin : (under ? 0 : nbins+1);
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return label for bin
 
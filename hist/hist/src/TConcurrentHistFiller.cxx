@@ -0,0 +1,243 @@
+// @(#)root/hist:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TConcurrentHistFiller
+Fill a histogram with double precision bins (TH1D, TH2D, TH3D) from
+several threads at the same time.
+
+A TThreadedObject<TH3D> needs a copy of the histogram per thread, which
+for large 2-D and 3-D histograms and many threads takes more memory than
+the data; a lock around TH1::Fill serializes the threads. The filler
+instead increments the bins of the histogram itself with lock-free atomic
+operations. The number of entries and the statistics (sum of the weights,
+of the weights times x, ...) are accumulated in kNShards groups of atomic
+counters, each thread using always the same group, and are added to the
+histogram by Flush():
+~~~{.cpp}
+   TH2D h("h", "h", 1000, -5, 5, 1000, -5, 5);
+   TConcurrentHistFiller filler(h);
+   ROOT::TThreadExecutor pool;
+   pool.Foreach([&](int i) { ... filler.Fill(x, y, 1.); }, events);
+   filler.Flush();
+   h.Draw("colz");
+~~~
+When the histogram is created the filler
+ - empties its buffer, if any,
+ - forbids the extension of its axes, which cannot be done while other
+   threads fill the bins.
+
+To fill the histogram with weights, TH1::Sumw2() must be called before
+creating the filler, as the array of the sums of the squares of the
+weights cannot be created while filling; otherwise, as for a histogram
+with the bit TH1::kIsNotW, this array is not filled. Flush() must be
+called when no thread is filling, before using the histogram; the
+destructor calls it. Until then, the bins can be read but the number of
+entries and the statistics are the ones of the last Flush(). The
+histogram must not be filled directly or modified while the filler is
+used.
+
+The histograms with another type of bins, and the profiles, are not
+supported: the filler then fills nothing and returns -1.
+*/
+
+#include "TConcurrentHistFiller.h"
+
+#include "TArrayD.h"
+#include "TAxis.h"
+#include "TH2.h"
+#include "TH3.h"
+#include "ThreadLocalStorage.h"
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add w to the double at address a, atomically.
+
+inline void AtomicAdd(std::atomic<Double_t> &a, Double_t w)
+{
+   Double_t old = a.load(std::memory_order_relaxed);
+   while (!a.compare_exchange_weak(old, old + w, std::memory_order_relaxed)) { }
+}
+
+inline void AtomicAdd(Double_t *a, Double_t w)
+{
+   AtomicAdd(*reinterpret_cast<std::atomic<Double_t>*>(a), w);
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Prepare to fill h, which must be a TH1D, TH2D or TH3D, concurrently.
+
+TConcurrentHistFiller::TConcurrentHistFiller(TH1 &h) :
+   fHist(&h), fArray(0), fSumw2(0), fXaxis(h.GetXaxis()), fYaxis(h.GetYaxis()), fZaxis(h.GetZaxis()),
+   fDimension(h.GetDimension()), fNx(h.GetNbinsX()), fNy(h.GetNbinsY()), fNz(h.GetNbinsZ()),
+   fStatOverflows(TH1::fgStatOverflows)
+{
+   for (Int_t i = 0; i < kNShards; ++i)
+      for (Int_t j = 0; j < kNCounters; ++j)
+         fShards[i].fCounters[j].store(0., std::memory_order_relaxed);
+
+   TArrayD *array = dynamic_cast<TArrayD*>(&h);
+   if (!array || h.InheritsFrom("TProfile") || h.InheritsFrom("TProfile2D") || h.InheritsFrom("TProfile3D")) {
+      h.Error("TConcurrentHistFiller", "class %s not supported: only TH1D, TH2D and TH3D can be filled concurrently",
+              h.ClassName());
+      return;
+   }
+
+   h.BufferEmpty(1);
+   h.SetCanExtend(TH1::kNoAxis);
+   fArray = array->GetArray();
+   if (h.GetSumw2N())
+      fSumw2 = h.GetSumw2()->GetArray();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor: flush the statistics into the histogram.
+
+TConcurrentHistFiller::~TConcurrentHistFiller()
+{
+   Flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the group of counters of the calling thread. The threads take the
+/// groups in turn, the first time they fill a histogram.
+
+TConcurrentHistFiller::Shard_t &TConcurrentHistFiller::GetShard()
+{
+   static std::atomic<UInt_t> gNextShard(0);
+   TTHREAD_TLS(Int_t) shard = -1;
+   if (shard < 0)
+      shard = gNextShard.fetch_add(1, std::memory_order_relaxed) % kNShards;
+   return fShards[shard];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add w to the content of bin, and w*w to its sum of squares of weights.
+
+Int_t TConcurrentHistFiller::AddToBin(Int_t bin, Double_t w)
+{
+   AtomicAdd(fArray + bin, w);
+   if (fSumw2)
+      AtomicAdd(fSumw2 + bin, w*w);
+   return bin;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Increment the bin of x of a 1-D histogram by w, as TH1::Fill(x, w).
+/// Return the bin, or -1 if it is an underflow or an overflow not included
+/// in the statistics or if the histogram is not 1-D.
+
+Int_t TConcurrentHistFiller::Fill(Double_t x, Double_t w)
+{
+   if (!fArray || fDimension != 1) return -1;
+
+   Int_t bin = AddToBin(fXaxis->FindFixBin(x), w);
+   std::atomic<Double_t> *c = GetShard().fCounters;
+   AtomicAdd(c[kEntries], 1.);
+   if (!fStatOverflows && (bin == 0 || bin > fNx)) return -1;
+   AtomicAdd(c[0], w);
+   AtomicAdd(c[1], w*w);
+   AtomicAdd(c[2], w*x);
+   AtomicAdd(c[3], w*x*x);
+   return bin;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Increment the bin of x, y of a 2-D histogram by w, as TH2::Fill(x, y, w).
+/// The weight must be given, also when it is 1.
+
+Int_t TConcurrentHistFiller::Fill(Double_t x, Double_t y, Double_t w)
+{
+   if (!fArray || fDimension != 2) return -1;
+
+   Int_t binx = fXaxis->FindFixBin(x);
+   Int_t biny = fYaxis->FindFixBin(y);
+   Int_t bin = AddToBin(biny*(fNx+2) + binx, w);
+   std::atomic<Double_t> *c = GetShard().fCounters;
+   AtomicAdd(c[kEntries], 1.);
+   if (!fStatOverflows && (binx == 0 || binx > fNx || biny == 0 || biny > fNy)) return -1;
+   AtomicAdd(c[0], w);
+   AtomicAdd(c[1], w*w);
+   AtomicAdd(c[2], w*x);
+   AtomicAdd(c[3], w*x*x);
+   AtomicAdd(c[4], w*y);
+   AtomicAdd(c[5], w*y*y);
+   AtomicAdd(c[6], w*x*y);
+   return bin;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Increment the bin of x, y, z of a 3-D histogram by w, as
+/// TH3::Fill(x, y, z, w).
+
+Int_t TConcurrentHistFiller::Fill(Double_t x, Double_t y, Double_t z, Double_t w)
+{
+   if (!fArray || fDimension != 3) return -1;
+
+   Int_t binx = fXaxis->FindFixBin(x);
+   Int_t biny = fYaxis->FindFixBin(y);
+   Int_t binz = fZaxis->FindFixBin(z);
+   Int_t bin = AddToBin(binx + (fNx+2)*(biny + (fNy+2)*binz), w);
+   std::atomic<Double_t> *c = GetShard().fCounters;
+   AtomicAdd(c[kEntries], 1.);
+   if (!fStatOverflows && (binx == 0 || binx > fNx || biny == 0 || biny > fNy || binz == 0 || binz > fNz))
+      return -1;
+   AtomicAdd(c[0], w);
+   AtomicAdd(c[1], w*w);
+   AtomicAdd(c[2], w*x);
+   AtomicAdd(c[3], w*x*x);
+   AtomicAdd(c[4], w*y);
+   AtomicAdd(c[5], w*y*y);
+   AtomicAdd(c[6], w*x*y);
+   AtomicAdd(c[7], w*z);
+   AtomicAdd(c[8], w*z*z);
+   AtomicAdd(c[9], w*x*z);
+   AtomicAdd(c[10], w*y*z);
+   return bin;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the number of entries and the statistics accumulated since the last
+/// call to the ones of the histogram. Must be called when no thread is
+/// filling the histogram.
+
+void TConcurrentHistFiller::Flush()
+{
+   if (!fArray) return;
+
+   Double_t sum[kNCounters] = {0};
+   for (Int_t i = 0; i < kNShards; ++i)
+      for (Int_t j = 0; j < kNCounters; ++j)
+         sum[j] += fShards[i].fCounters[j].exchange(0., std::memory_order_relaxed);
+
+   fHist->fEntries += sum[kEntries];
+   fHist->fTsumw   += sum[0];
+   fHist->fTsumw2  += sum[1];
+   fHist->fTsumwx  += sum[2];
+   fHist->fTsumwx2 += sum[3];
+   if (fDimension == 2) {
+      TH2 *h2 = static_cast<TH2*>(fHist);
+      h2->fTsumwy  += sum[4];
+      h2->fTsumwy2 += sum[5];
+      h2->fTsumwxy += sum[6];
+   } else if (fDimension == 3) {
+      TH3 *h3 = static_cast<TH3*>(fHist);
+      h3->fTsumwy  += sum[4];
+      h3->fTsumwy2 += sum[5];
+      h3->fTsumwxy += sum[6];
+      h3->fTsumwz  += sum[7];
+      h3->fTsumwz2 += sum[8];
+      h3->fTsumwxz += sum[9];
+      h3->fTsumwyz += sum[10];
+   }
+}
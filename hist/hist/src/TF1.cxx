@@ -49,6 +49,13 @@
 
 #include "AnalyticalIntegrals.h"
 
+#include <algorithm>
+#include <list>
+
+#ifdef R__USE_IMT
+#include "tbb/parallel_for.h"
+#endif
+
 //#include <iostream>
 
 std::atomic<Bool_t> TF1::fgAbsValue(kFALSE);
@@ -56,6 +63,31 @@ Bool_t TF1::fgRejectPoint = kFALSE;
 std::atomic<Bool_t> TF1::fgAddToGlobList(kTRUE);
 static Double_t gErrorTF1 = 0;
 
+////////////////////////////////////////////////////////////////////////////////
+/// Integral tables of GetRandom kept for other values of the parameters of a
+/// TF1 (see TF1::SetIntegralCacheSize).
+
+class TF1IntegralCache {
+public:
+   struct Table_t {
+      std::vector<Double_t> fParams;   // parameters of the function
+      Double_t              fXmin;     // range and number of bins of the tables
+      Double_t              fXmax;
+      Int_t                 fNpx;
+      std::vector<Double_t> fIntegral; // tables, as TF1::fIntegral, fAlpha, fBeta and fGamma
+      std::vector<Double_t> fAlpha;
+      std::vector<Double_t> fBeta;
+      std::vector<Double_t> fGamma;
+   };
+
+   explicit TF1IntegralCache(Int_t size) : fSize(size), fHasCurrent(kFALSE) {}
+
+   Int_t              fSize;        // maximum number of tables kept
+   std::list<Table_t> fTables;      // tables kept, the most recently used first
+   Table_t            fCurrent;     // parameters, range and bins of the tables of the function
+   Bool_t             fHasCurrent;  // whether fCurrent describes the tables of the function
+};
+
 ClassImp(TF1)
 
 // class wrapping evaluation of TF1(x) - y0
@@ -715,6 +747,7 @@ TF1::~TF1()
 
    if (fFormula) delete fFormula;
    if (fParams) delete fParams;
+   delete fIntegralCache;
 }
 
 
@@ -794,6 +827,8 @@ void TF1::Copy(TObject &obj) const
    ((TF1&)obj).fNormalized = fNormalized;
    ((TF1&)obj).fNormIntegral = fNormIntegral;
    ((TF1&)obj).fFormula   = 0;
+   ((TF1&)obj).SetIntegralCacheSize(0);
+   ((TF1&)obj).SetIntegralCacheSize(GetIntegralCacheSize());
 
    if (fFormula) assert(fFormula->GetNpar() == fNpar);
 
@@ -1256,6 +1291,59 @@ Double_t TF1::EvalPar(const Double_t *x, const Double_t *params)
    return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the function at the n points whose coordinates start at x,
+/// x + stride, x + 2*stride, ..., and store the values in result.
+///
+/// The parameters are params, or the ones of the function if params is null,
+/// as for EvalPar(). A function defined by a formula evaluates all the points
+/// with a single call to TFormula::EvalParN(); the other ones call EvalPar()
+/// for each point.
+
+void TF1::EvalParN(Int_t n, const Double_t *x, Int_t stride, const Double_t *params, Double_t *result)
+{
+   if (fType == 0) {
+      assert(fFormula);
+      fFormula->EvalParN(n, x, stride, params, result);
+      if (fNormalized && fNormIntegral != 0) {
+         for (Int_t i = 0; i < n; ++i) result[i] /= fNormIntegral;
+      }
+      return;
+   }
+   for (Int_t i = 0; i < n; ++i) {
+      if (fMethodCall) InitArgs(x + i*stride, params);  // needed for interpreted functions
+      result[i] = EvalPar(x + i*stride, params);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the function at n points given as a structure of arrays, the
+/// coordinate k of the point i being x[k*n + i], and store the values in
+/// result. See EvalParN().
+
+void TF1::EvalParSoA(Int_t n, const Double_t *x, const Double_t *params, Double_t *result)
+{
+   Int_t ndim = GetNdim();
+   if (ndim <= 1) {
+      EvalParN(n, x, 1, params, result);
+      return;
+   }
+   if (fType == 0) {
+      assert(fFormula);
+      fFormula->EvalParSoA(n, x, params, result);
+      if (fNormalized && fNormIntegral != 0) {
+         for (Int_t i = 0; i < n; ++i) result[i] /= fNormIntegral;
+      }
+      return;
+   }
+   std::vector<Double_t> point(ndim);
+   for (Int_t i = 0; i < n; ++i) {
+      for (Int_t k = 0; k < ndim; ++k) point[k] = x[k*n + i];
+      if (fMethodCall) InitArgs(point.data(), params);  // needed for interpreted functions
+      result[i] = EvalPar(point.data(), params);
+   }
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Execute action corresponding to one event.
@@ -1774,6 +1862,149 @@ Int_t TF1::GetQuantiles(Int_t nprobSum, Double_t *q, const Double_t *probSum)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Build the tables used by GetRandom, if they do not exist yet: the integral
+/// of the function binned on fNpx bins and, for each bin, the coefficients of
+/// the parabola approximating the integral. If logScale is true and the ratio
+/// fXmax/fXmin > fNpx, the bins are in log scale in x.
+///
+/// The tables are taken from the cache if it has been enabled with
+/// SetIntegralCacheSize() and holds tables for the current parameters, range and
+/// number of bins. Return false if the integral of the function is zero.
+
+Bool_t TF1::MakeRandomTable(Bool_t logScale)
+{
+   if (!fIntegral.empty()) return kTRUE;
+
+   Double_t *params = GetParameters();
+   UInt_t nalpha = (logScale) ? fNpx+1 : fNpx;
+   if (fIntegralCache) {
+      auto &tables = fIntegralCache->fTables;
+      for (auto it = tables.begin(); it != tables.end(); ++it) {
+         if (it->fNpx == fNpx && it->fXmin == fXmin && it->fXmax == fXmax && it->fAlpha.size() == nalpha &&
+             std::equal(it->fParams.begin(), it->fParams.end(), params)) {
+            TF1IntegralCache::Table_t &current = fIntegralCache->fCurrent;
+            current = std::move(*it);
+            tables.erase(it);
+            fIntegral.swap(current.fIntegral);
+            fAlpha.swap(current.fAlpha);
+            fBeta.swap(current.fBeta);
+            fGamma.swap(current.fGamma);
+            fIntegralCache->fHasCurrent = kTRUE;
+            return kTRUE;
+         }
+      }
+   }
+
+   fIntegral.assign(fNpx+1, 0);
+   fAlpha.assign(nalpha, 0);
+   fBeta.resize(fNpx);
+   fGamma.resize(fNpx);
+   Int_t i;
+   Bool_t logbin = kFALSE;
+   Double_t xmin = fXmin;
+   Double_t xmax = fXmax;
+   if (logScale && xmin > 0 && xmax/xmin> fNpx) {
+      logbin =  kTRUE;
+      fAlpha[fNpx] = 1;
+      xmin = TMath::Log10(fXmin);
+      xmax = TMath::Log10(fXmax);
+   }
+   Double_t dx = (xmax-xmin)/fNpx;
+
+   std::vector<Double_t> xx(fNpx+1);
+   for (i=0;i<fNpx;i++) {
+      xx[i] = xmin +i*dx;
+   }
+   xx[fNpx] = xmax;
+   std::vector<Double_t> binIntegral(fNpx);
+   std::vector<Double_t> halfIntegral(fNpx);
+   ComputeBinIntegrals(xx, logbin, binIntegral, halfIntegral);
+
+   Int_t intNegative = 0;
+   for (i=0;i<fNpx;i++) {
+      Double_t integ = binIntegral[i];
+      if (integ < 0) {intNegative++; integ = -integ;}
+      fIntegral[i+1] = fIntegral[i] + integ;
+   }
+   if (intNegative > 0) {
+      Warning("GetRandom","function:%s has %d negative values: abs assumed",GetName(),intNegative);
+   }
+   if (fIntegral[fNpx] == 0) {
+      Error("GetRandom","Integral of function is zero");
+      fIntegral.clear();
+      fAlpha.clear();
+      fBeta.clear();
+      fGamma.clear();
+      return kFALSE;
+   }
+   Double_t total = fIntegral[fNpx];
+   for (i=1;i<=fNpx;i++) {  // normalize integral to 1
+      fIntegral[i] /= total;
+   }
+   //the integral r for each bin is approximated by a parabola
+   //  x = alpha + beta*r +gamma*r**2
+   // compute the coefficients alpha, beta, gamma for each bin
+   Double_t x0,r1,r2,r3;
+   for (i=0;i<fNpx;i++) {
+      x0 = xx[i];
+      r2 = fIntegral[i+1] - fIntegral[i];
+      r1 = halfIntegral[i]/total;
+      r3 = 2*r2 - 4*r1;
+      if (TMath::Abs(r3) > 1e-8) fGamma[i] = r3/(dx*dx);
+      else           fGamma[i] = 0;
+      fBeta[i]  = r2/dx - fGamma[i]*dx;
+      fAlpha[i] = x0;
+      fGamma[i] *= 2;
+   }
+
+   if (fIntegralCache) {
+      TF1IntegralCache::Table_t &current = fIntegralCache->fCurrent;
+      current.fParams.assign(params, params + fNpar);
+      current.fXmin = fXmin;
+      current.fXmax = fXmax;
+      current.fNpx = fNpx;
+      fIntegralCache->fHasCurrent = kTRUE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute the integrals of the function in the bins [xx[i],xx[i+1]] and in
+/// their first halves (the bin edges are 10^xx[i] if logbin is true).
+///
+/// With the implicit multi-threading enabled (see ROOT::EnableImplicitMT()), the
+/// bins of a function defined by a formula are integrated in parallel; the
+/// other functions (interpreted functions, functors) may not be thread safe and
+/// are always integrated sequentially.
+
+void TF1::ComputeBinIntegrals(const std::vector<Double_t> &xx, Bool_t logbin, std::vector<Double_t> &binIntegral,
+                              std::vector<Double_t> &halfIntegral)
+{
+   auto integrate = [&](Int_t i) {
+      Double_t a = xx[i];
+      Double_t b = xx[i+1];
+      Double_t c = 0.5*(a+b);
+      if (logbin) {
+         a = TMath::Power(10,a);
+         b = TMath::Power(10,b);
+         c = TMath::Power(10,c);
+      }
+      binIntegral[i]  = Integral(a,b);
+      halfIntegral[i] = Integral(a,c);
+   };
+   Int_t n = binIntegral.size();
+#ifdef R__USE_IMT
+   if (fType == 0 && n > 1 && ROOT::IsImplicitMTEnabled()) {
+      // the first bin is integrated alone, to set up the integrator (e.g. load its plugin)
+      integrate(0);
+      tbb::parallel_for(1, n, integrate);
+      return;
+   }
+#endif
+   for (Int_t i = 0; i < n; ++i) integrate(i);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return a random number following this function shape
 ///
@@ -1789,80 +2020,15 @@ Int_t TF1::GetQuantiles(Int_t nprobSum, Double_t *q, const Double_t *probSum)
 ///
 /// If the ratio fXmax/fXmin > fNpx the integral is tabulated in log scale in x
 /// The parabolic approximation is very good as soon as the number of bins is greater than 50.
+///
+/// The table is computed again after each change of the parameters, unless the
+/// tables for a few values of the parameters are kept with SetIntegralCacheSize().
+/// To generate many numbers at once, GetRandomArray() is faster.
 
 Double_t TF1::GetRandom()
 {
    //  Check if integral array must be build
-   if (fIntegral.size() == 0) {
-      // fIntegral = new Double_t[fNpx+1];
-      // fAlpha    = new Double_t[fNpx+1];
-      // fBeta     = new Double_t[fNpx];
-      // fGamma    = new Double_t[fNpx];
-      fIntegral.resize(fNpx+1);
-      fAlpha.resize(fNpx+1);
-      fBeta.resize(fNpx);
-      fGamma.resize(fNpx);
-      fIntegral[0] = 0;
-      fAlpha[fNpx] = 0;
-      Double_t integ;
-      Int_t intNegative = 0;
-      Int_t i;
-      Bool_t logbin = kFALSE;
-      Double_t dx;
-      Double_t xmin = fXmin;
-      Double_t xmax = fXmax;
-      if (xmin > 0 && xmax/xmin> fNpx) {
-         logbin =  kTRUE;
-         fAlpha[fNpx] = 1;
-         xmin = TMath::Log10(fXmin);
-         xmax = TMath::Log10(fXmax);
-      }
-      dx = (xmax-xmin)/fNpx;
-
-      Double_t *xx = new Double_t[fNpx+1];
-      for (i=0;i<fNpx;i++) {
-            xx[i] = xmin +i*dx;
-      }
-      xx[fNpx] = xmax;
-      for (i=0;i<fNpx;i++) {
-         if (logbin) {
-            integ = Integral(TMath::Power(10,xx[i]), TMath::Power(10,xx[i+1]));
-         } else {
-            integ = Integral(xx[i],xx[i+1]);
-         }
-         if (integ < 0) {intNegative++; integ = -integ;}
-         fIntegral[i+1] = fIntegral[i] + integ;
-      }
-      if (intNegative > 0) {
-         Warning("GetRandom","function:%s has %d negative values: abs assumed",GetName(),intNegative);
-      }
-      if (fIntegral[fNpx] == 0) {
-         delete [] xx;
-         Error("GetRandom","Integral of function is zero");
-         return 0;
-      }
-      Double_t total = fIntegral[fNpx];
-      for (i=1;i<=fNpx;i++) {  // normalize integral to 1
-         fIntegral[i] /= total;
-      }
-      //the integral r for each bin is approximated by a parabola
-      //  x = alpha + beta*r +gamma*r**2
-      // compute the coefficients alpha, beta, gamma for each bin
-      Double_t x0,r1,r2,r3;
-      for (i=0;i<fNpx;i++) {
-         x0 = xx[i];
-         r2 = fIntegral[i+1] - fIntegral[i];
-         if (logbin) r1 = Integral(TMath::Power(10,x0),TMath::Power(10,x0+0.5*dx))/total;
-         else        r1 = Integral(x0,x0+0.5*dx)/total;
-         r3 = 2*r2 - 4*r1;
-         if (TMath::Abs(r3) > 1e-8) fGamma[i] = r3/(dx*dx);
-         else           fGamma[i] = 0;
-         fBeta[i]  = r2/dx - fGamma[i]*dx;
-         fAlpha[i] = x0;
-         fGamma[i] *= 2;
-      }
-      delete [] xx;
-   }
+   if (!MakeRandomTable(kTRUE)) return 0;
 
    // return random number
    Double_t r  = gRandom->Rndm();
@@ -1875,11 +2041,43 @@ Double_t TF1::GetRandom()
    else
       yy = rr/fBeta[bin];
    Double_t x = fAlpha[bin] + yy;
-   if (fAlpha[fNpx] > 0) return TMath::Power(10,x);
+   if (fAlpha.size() > (UInt_t)fNpx && fAlpha[fNpx] > 0) return TMath::Power(10,x);
    return x;
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill x with n random numbers following this function shape, as n calls to
+/// GetRandom(). The uniform random numbers are generated at once with
+/// TRandom::RndmArray and transformed in a single loop over the integral table.
+
+void TF1::GetRandomArray(Int_t n, Double_t *x)
+{
+   if (n <= 0) return;
+   if (!MakeRandomTable(kTRUE)) {
+      std::fill(x, x+n, 0.);
+      return;
+   }
+
+   gRandom->RndmArray(n, x);
+   const Double_t *integral = fIntegral.data();
+   const Double_t *alpha = fAlpha.data();
+   const Double_t *beta  = fBeta.data();
+   const Double_t *gamma = fGamma.data();
+   Bool_t logbin = (fAlpha.size() > (UInt_t)fNpx && fAlpha[fNpx] > 0);
+   for (Int_t i = 0; i < n; ++i) {
+      Int_t bin  = TMath::BinarySearch(fNpx,integral,x[i]);
+      Double_t rr = x[i] - integral[bin];
+      Double_t yy;
+      if (gamma[bin] != 0)
+         yy = (-beta[bin] + TMath::Sqrt(beta[bin]*beta[bin]+2*gamma[bin]*rr))/gamma[bin];
+      else
+         yy = rr/beta[bin];
+      x[i] = (logbin) ? TMath::Power(10, alpha[bin] + yy) : alpha[bin] + yy;
+   }
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return a random number following this function shape in [xmin,xmax]
 ///
@@ -1906,52 +2104,7 @@ Double_t TF1::GetRandom()
 Double_t TF1::GetRandom(Double_t xmin, Double_t xmax)
 {
    //  Check if integral array must be build
-   if (fIntegral.size() == 0) {
-      // fIntegral = new Double_t[fNpx+1];
-      // fAlpha    = new Double_t[fNpx+1];
-      // fBeta     = new Double_t[fNpx];
-      // fGamma    = new Double_t[fNpx];
-      fIntegral.resize(fNpx+1);
-      fAlpha.resize(fNpx);
-      fBeta.resize(fNpx);
-      fGamma.resize(fNpx);
-
-      Double_t dx = (fXmax-fXmin)/fNpx;
-      Double_t integ;
-      Int_t intNegative = 0;
-      Int_t i;
-      for (i=0;i<fNpx;i++) {
-         integ = Integral(Double_t(fXmin+i*dx), Double_t(fXmin+i*dx+dx));
-         if (integ < 0) {intNegative++; integ = -integ;}
-         fIntegral[i+1] = fIntegral[i] + integ;
-      }
-      if (intNegative > 0) {
-         Warning("GetRandom","function:%s has %d negative values: abs assumed",GetName(),intNegative);
-      }
-      if (fIntegral[fNpx] == 0) {
-         Error("GetRandom","Integral of function is zero");
-         return 0;
-      }
-      Double_t total = fIntegral[fNpx];
-      for (i=1;i<=fNpx;i++) {  // normalize integral to 1
-         fIntegral[i] /= total;
-      }
-      //the integral r for each bin is approximated by a parabola
-      //  x = alpha + beta*r +gamma*r**2
-      // compute the coefficients alpha, beta, gamma for each bin
-      Double_t x0,r1,r2,r3;
-      for (i=0;i<fNpx;i++) {
-         x0 = fXmin+i*dx;
-         r2 = fIntegral[i+1] - fIntegral[i];
-         r1 = Integral(x0,x0+0.5*dx)/total;
-         r3 = 2*r2 - 4*r1;
-         if (TMath::Abs(r3) > 1e-8) fGamma[i] = r3/(dx*dx);
-         else           fGamma[i] = 0;
-         fBeta[i]  = r2/dx - fGamma[i]*dx;
-         fAlpha[i] = x0;
-         fGamma[i] *= 2;
-      }
-   }
+   if (!MakeRandomTable(kFALSE)) return 0;
 
    // return random number
    Double_t dx   = (fXmax-fXmin)/fNpx;
@@ -1978,6 +2131,15 @@ Double_t TF1::GetRandom(Double_t xmin, Double_t xmax)
    return x;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of integral tables of GetRandom kept for other values of
+/// the parameters (see SetIntegralCacheSize).
+
+Int_t TF1::GetIntegralCacheSize() const
+{
+   return (fIntegralCache) ? fIntegralCache->fSize : 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return range of a generic N-D function.
 
@@ -2823,11 +2985,14 @@ TH1 *  TF1::DoCreateHistogram(Double_t xmin, Double_t  xmax, Bool_t recreate)
    histogram->GetYaxis()->SetTitle(ytitle.Data());
    Double_t *parameters = GetParameters();
 
+   // evaluate all the bin centers at once
+   std::vector<Double_t> xcenters(fNpx);
+   std::vector<Double_t> values(fNpx);
+   for (i=1;i<=fNpx;i++) xcenters[i-1] = histogram->GetBinCenter(i);
+   xv[0] = xcenters[0];
    InitArgs(xv,parameters);
-   for (i=1;i<=fNpx;i++) {
-      xv[0] = histogram->GetBinCenter(i);
-      histogram->SetBinContent(i,EvalPar(xv,parameters));
-   }
+   EvalParN(fNpx, xcenters.data(), 1, parameters, values.data());
+   for (i=1;i<=fNpx;i++) histogram->SetBinContent(i,values[i-1]);
 
    // Copy Function attributes to histogram attributes.
    histogram->SetBit(TH1::kNoStats);
@@ -3163,6 +3328,30 @@ void TF1::SetNpx(Int_t npx)
    }
    Update();
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Keep the integral tables computed by GetRandom for the last n values of the
+/// parameters (and of the range and number of points), instead of computing
+/// them again when the parameters come back to one of these values. This speeds
+/// up the generation of toys alternating between a few sets of parameters.
+/// The function must depend only on its parameters: the tables are not
+/// recomputed when it changes in another way. n = 0 (the default) disables the
+/// cache and deletes the tables kept.
+
+void TF1::SetIntegralCacheSize(Int_t n)
+{
+   if (n <= 0) {
+      delete fIntegralCache;
+      fIntegralCache = nullptr;
+      return;
+   }
+   if (!fIntegralCache) {
+      fIntegralCache = new TF1IntegralCache(n);
+      return;
+   }
+   fIntegralCache->fSize = n;
+   while ((Int_t)fIntegralCache->fTables.size() > n) fIntegralCache->fTables.pop_back();
+}
 ////////////////////////////////////////////////////////////////////////////////
 /// Set name of parameter number ipar
 
@@ -3374,11 +3563,23 @@ void TF1::Update()
    delete fHistogram;
    fHistogram = 0;
    if (!fIntegral.empty()) {
+      if (fIntegralCache && fIntegralCache->fHasCurrent) {
+         // keep the tables for the previous parameters
+         TF1IntegralCache::Table_t &current = fIntegralCache->fCurrent;
+         current.fIntegral.swap(fIntegral);
+         current.fAlpha.swap(fAlpha);
+         current.fBeta.swap(fBeta);
+         current.fGamma.swap(fGamma);
+         fIntegralCache->fTables.push_front(std::move(current));
+         while ((Int_t)fIntegralCache->fTables.size() > fIntegralCache->fSize) fIntegralCache->fTables.pop_back();
+         current = TF1IntegralCache::Table_t();
+      }
       fIntegral.clear();
       fAlpha.clear();
       fBeta.clear();
       fGamma.clear();
    }
+   if (fIntegralCache) fIntegralCache->fHasCurrent = kFALSE;
    if (fNormalized) {
        // need to compute the integral of the not-normalized function
        fNormalized = false;
@@ -163,6 +163,14 @@ Double_t TF12::EvalPar(const Double_t *x, const Double_t *params)
    return fF2->EvalPar(xx,params);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate this function at the n points x[0], x[stride], ... (see EvalPar)
+
+void TF12::EvalParN(Int_t n, const Double_t *x, Int_t stride, const Double_t *params, Double_t *result)
+{
+   for (Int_t i = 0; i < n; ++i) result[i] = EvalPar(x + i*stride, params);
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Save primitive as a C++ statement(s) on output stream out
@@ -23,7 +23,12 @@
 #include "TError.h"
 #include "TInterpreter.h"
 #include "TFormula.h"
+#include "TEnv.h"
+#include "TMD5.h"
+#include "TSystem.h"
+#include <algorithm>
 #include <cassert>
+#include <fstream>
 #include <iostream>
 #include <unordered_map>
 #include <functional>
@@ -136,6 +141,163 @@ static const TString gNamePrefix = "TFormula__";
 // static map of function pointers and expressions
 //static std::unordered_map<std::string,  TInterpreter::CallFuncIFacePtr_t::Generic_t> gClingFunctions = std::unordered_map<TString,  TInterpreter::CallFuncIFacePtr_t::Generic_t>();
 static std::unordered_map<std::string,  void *> gClingFunctions = std::unordered_map<std::string,  void * >();
+// static map of the functions evaluating arrays of points (see TFormula::EvalParN)
+static std::unordered_map<std::string,  void *> gClingBatchFunctions = std::unordered_map<std::string,  void * >();
+
+// a formula waiting for TFormula::CompileDeferred
+struct TFormulaDeferred {
+   TString     fName;         // the cling name of the function
+   std::string fExpression;   // the expression, key of gClingFunctions
+   TString     fArguments;    // the arguments of the function
+   TString     fCode;         // the definition of the function for Cling
+};
+// the formulas waiting for TFormula::CompileDeferred by cling name, and the
+// expressions of all the deferred formulas by cling name
+static std::unordered_map<std::string, TFormulaDeferred> gDeferredFormulas;
+static std::unordered_map<std::string, std::string> gDeferredExpressions;
+// the libraries of the cache directory by digest of the formulas they hold
+static std::unordered_map<std::string, std::string> gCachedLibraries;
+static bool gCacheIndexRead = false;
+static bool gCacheDirectorySet = false;
+
+Bool_t TFormula::fgDeferred = kFALSE;
+TString TFormula::fgCacheDirectory;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Digest identifying the function of arguments returning expression in the
+/// libraries of the cache directory.
+
+static TString FormulaDigest(const std::string &expression, const TString &arguments)
+{
+   std::string function = std::string(arguments.Data()) + ":" + expression;
+   TMD5 md5;
+   md5.Update((const UChar_t *)function.data(), function.size());
+   md5.Final();
+   return md5.AsString();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Code of a function named wrapperName calling the function named funcName,
+/// with the signature of the wrappers generated by Cling (see
+/// TInterpreter::CallFuncIFacePtr_t) so that TFormula::DoEval can call it.
+
+static TString WrapperCode(const TString &wrapperName, const TString &funcName, const TString &arguments)
+{
+   TString callArguments;
+   if (arguments.Contains("*x")) callArguments = "*(Double_t **)args[0]";
+   if (arguments.Contains("*p")) callArguments += ", *(Double_t **)args[1]";
+   return TString::Format("extern \"C\" void %s(void *, int, void **args, void *ret)"
+                          " { *(Double_t *)ret = %s(%s); }\n",
+                          wrapperName.Data(), funcName.Data(), callArguments.Data());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the index files of the cache directory dir, which list the digests
+/// of the formulas compiled in each library: TFormula_<digest>.list holds the
+/// path of the library, then one digest per line.
+
+static void ReadCacheIndex(const TString &dir)
+{
+   if (gCacheIndexRead) return;
+   gCacheIndexRead = true;
+   void *dirp = gSystem->OpenDirectory(dir);
+   if (!dirp) return;
+   while (const char *entry = gSystem->GetDirEntry(dirp)) {
+      TString name(entry);
+      if (!name.BeginsWith("TFormula_") || !name.EndsWith(".list")) continue;
+      std::ifstream in(TString::Format("%s/%s", dir.Data(), entry).Data());
+      std::string library, digest;
+      if (!std::getline(in, library)) continue;
+      while (in >> digest) gCachedLibraries[digest] = library;
+   }
+   gSystem->FreeDirectory(dirp);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the function returning expression found in the libraries of the
+/// cache directory (see TFormula::SetCacheDirectory), or null, loading its
+/// library if needed. It has the signature of the wrappers of Cling.
+
+static void *FindCachedFunction(const std::string &expression, const TString &arguments)
+{
+   TString dir = TFormula::GetCacheDirectory();
+   if (dir.IsNull()) return nullptr;
+   ReadCacheIndex(dir);
+   TString digest = FormulaDigest(expression, arguments);
+   auto libit = gCachedLibraries.find(digest.Data());
+   if (libit == gCachedLibraries.end()) return nullptr;
+   TString library = libit->second.c_str();
+   void *func = nullptr;
+   if (gSystem->Load(library) >= 0)
+      func = (void *)gSystem->DynFindSymbol(library, TString::Format("TFormula__lib%s", digest.Data()));
+   // do not try again with an unusable library
+   if (!func) gCachedLibraries.erase(digest.Data());
+   return func;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compile with ACLiC, in a library of the cache directory dir, the deferred
+/// formulas of batch whose function is not set in funcs yet, and set their
+/// functions. The functions are hidden from rootcling, so that loading the
+/// library does not parse them again. They cannot use the functions only
+/// known to the interpreter: the whole library is then given up, and the
+/// formulas compiled with Cling.
+
+static void CompileCachedLibrary(const TString &dir, const std::vector<TFormulaDeferred> &batch, std::vector<void *> &funcs)
+{
+   std::vector<size_t> missing;
+   for (size_t i = 0; i < batch.size(); ++i) {
+      if (!funcs[i]) missing.push_back(i);
+   }
+   if (missing.empty()) return;
+
+   TString code = "// Formulas compiled by TFormula::CompileDeferred\n"
+                  "#include \"TMath.h\"\n#include \"Math/PdfFuncMathCore.h\"\n#include \"Math/ChebyshevPol.h\"\n"
+                  "#if !defined(__CLING__)\n";
+   std::vector<TString> digests;
+   for (size_t i : missing) {
+      TString digest = FormulaDigest(batch[i].fExpression, batch[i].fArguments);
+      TString funcName = "TFormula__f" + digest;
+      code += TString::Format("static Double_t %s(%s){ return %s ; }\n", funcName.Data(), batch[i].fArguments.Data(),
+                              batch[i].fExpression.c_str());
+      code += WrapperCode("TFormula__lib" + digest, funcName, batch[i].fArguments);
+      digests.push_back(digest);
+   }
+   code += "#endif\n";
+
+   TString base = "TFormula_" + FormulaDigest(code.Data(), "library");
+   TString source = dir + "/" + base + ".C";
+   {
+      std::ofstream out(source.Data());
+      out << code.Data();
+      if (!out) {
+         Warning("TFormula::CompileDeferred", "cannot write %s, the formulas are compiled with Cling", source.Data());
+         return;
+      }
+   }
+   // 'c': only compile, the library is loaded with its symbols by FindCachedFunction
+   if (!gSystem->CompileMacro(source, "kOc", "", dir)) {
+      Warning("TFormula::CompileDeferred", "cannot compile %s, the formulas are compiled with Cling", source.Data());
+      return;
+   }
+   TString library = TString::Format("%s/%s_C.%s", dir.Data(), base.Data(), gSystem->GetSoExt());
+
+   // the index is renamed once complete, not to be read partially by another process
+   TString index = dir + "/" + base + ".list";
+   TString tmpIndex = TString::Format("%s.%d", index.Data(), gSystem->GetPid());
+   {
+      std::ofstream out(tmpIndex.Data());
+      out << library.Data() << '\n';
+      for (const TString &digest : digests) out << digest.Data() << '\n';
+   }
+   gSystem->Rename(tmpIndex, index);
+
+   for (size_t k = 0; k < missing.size(); ++k) {
+      gCachedLibraries[digests[k].Data()] = library.Data();
+      const TFormulaDeferred &deferred = batch[missing[k]];
+      funcs[missing[k]] = FindCachedFunction(deferred.fExpression, deferred.fArguments);
+   }
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 Bool_t TFormula::IsOperator(const char c)
@@ -561,6 +723,7 @@ void TFormula::Copy(TObject &obj) const
    fnew.fClingInput = fClingInput;
    fnew.fReadyToExecute = fReadyToExecute;
    fnew.fClingInitialized = fClingInitialized;
+   fnew.fClingPending = fClingPending;
    fnew.fAllParametersSetted = fAllParametersSetted;
    fnew.fClingName = fClingName;
 
@@ -585,6 +748,8 @@ void TFormula::Copy(TObject &obj) const
    }
 
    fnew.fFuncPtr = fFuncPtr;
+   fnew.fBatchFuncPtr.store(fBatchFuncPtr.load() );
+   fnew.fBatchPrepared.store(fBatchPrepared.load() );
 
 }
 
@@ -608,7 +773,9 @@ void TFormula::Clear(Option_t * )
    fClingParameters.clear();
    fReadyToExecute = false;
    fClingInitialized = false;
+   fClingPending = false;
    fAllParametersSetted = false;
+   ResetBatchMethod();
    fFuncs.clear();
    fVars.clear();
    fParams.clear();
@@ -694,6 +861,150 @@ void TFormula::InputFormulaIntoCling()
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set the function of a formula waiting for CompileDeferred, compiling
+/// the deferred formulas if it is not done yet. Returns false if it could
+/// not be compiled.
+
+Bool_t TFormula::ResolveDeferred() const
+{
+   R__LOCKGUARD2(gROOTMutex);
+   if (!fClingPending) return fClingInitialized;
+   std::string name = fClingName.Data();
+   if (gDeferredFormulas.count(name)) CompileDeferred();
+   auto funcit = gClingFunctions.find(gDeferredExpressions[name]);
+   if (funcit != gClingFunctions.end() ) {
+      fFuncPtr = (  TInterpreter::CallFuncIFacePtr_t::Generic_t) funcit->second;
+      fClingInitialized = true;
+   }
+   fClingPending = false;
+   return fClingInitialized;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Defer the compilation of the formulas created from now on, if on is
+/// true, until CompileDeferred() is called or until they are evaluated.
+///
+/// Each formula otherwise triggers its own compilation with Cling, which
+/// makes the creation of thousands of formulas (e.g. the TF1 of per-channel
+/// calibrations) last minutes. Turning it off compiles the deferred formulas.
+///
+/// ~~~ {.cpp}
+/// TFormula::SetDeferredCompilation();
+/// for (int i = 0; i < nChannels; ++i) calib[i] = new TF1(TString::Format("f%d", i), expressions[i]);
+/// TFormula::CompileDeferred();
+/// ~~~
+///
+/// The formulas cannot report an error of compilation when they are
+/// created: IsValid() is then true, until CompileDeferred fails to compile
+/// them.
+
+void TFormula::SetDeferredCompilation(Bool_t on)
+{
+   R__LOCKGUARD2(gROOTMutex);
+   fgDeferred = on;
+   if (!on) CompileDeferred();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compile all the formulas waiting for compilation (see
+/// SetDeferredCompilation) in a single transaction of Cling, or load them
+/// from the libraries of the cache directory (see SetCacheDirectory).
+/// Returns the number of formulas compiled.
+
+Int_t TFormula::CompileDeferred()
+{
+   R__LOCKGUARD2(gROOTMutex);
+   if (gDeferredFormulas.empty()) return 0;
+   std::vector<TFormulaDeferred> batch;
+   batch.reserve(gDeferredFormulas.size());
+   for (auto &deferred : gDeferredFormulas) batch.push_back(deferred.second);
+   gDeferredFormulas.clear();
+
+   std::vector<void *> funcs(batch.size(), nullptr);
+   TString dir = GetCacheDirectory();
+   if (!dir.IsNull()) {
+      // the formulas compiled by another process, or by this one before
+      for (size_t i = 0; i < batch.size(); ++i) funcs[i] = FindCachedFunction(batch[i].fExpression, batch[i].fArguments);
+      CompileCachedLibrary(dir, batch, funcs);
+   }
+
+   // compile the remaining formulas with Cling, the addresses of their
+   // wrappers being returned by a single call
+   std::vector<size_t> missing;
+   TString code, registration;
+   for (size_t i = 0; i < batch.size(); ++i) {
+      if (funcs[i]) continue;
+      const TString &name = batch[i].fName;
+      code += batch[i].fCode + "\n" + WrapperCode(name + "__wrapper", name, batch[i].fArguments);
+      registration += TString::Format(" f[%zu] = (void *)&%s__wrapper;", missing.size(), name.Data());
+      missing.push_back(i);
+   }
+   if (!missing.empty()) {
+      auto hasher = gClingFunctions.hash_function();
+      TString registerName = TString::Format("%s__register%zu", gNamePrefix.Data(), hasher(code.Data()) );
+      code += TString::Format("extern \"C\" void %s(void **f) {%s }\n", registerName.Data(), registration.Data());
+      std::vector<void *> ptrs(missing.size(), nullptr);
+      if (gCling->Declare(code)) {
+         gCling->Calc(TString::Format("%s((void **)%p)", registerName.Data(), (void *)ptrs.data()));
+      } else {
+         // an invalid formula fails the whole transaction, declare them one by one
+         for (size_t k = 0; k < missing.size(); ++k) {
+            const TFormulaDeferred &deferred = batch[missing[k]];
+            const TString &name = deferred.fName;
+            if (gCling->Declare(deferred.fCode + "\n" + WrapperCode(name + "__wrapper", name, deferred.fArguments)))
+               ptrs[k] = (void *)gCling->Calc(TString::Format("(Long_t)&%s__wrapper", name.Data()));
+         }
+      }
+      for (size_t k = 0; k < missing.size(); ++k) funcs[missing[k]] = ptrs[k];
+   }
+
+   Int_t ncompiled = 0;
+   for (size_t i = 0; i < batch.size(); ++i) {
+      if (funcs[i]) {
+         gClingFunctions.insert( std::make_pair(batch[i].fExpression, funcs[i]) );
+         ++ncompiled;
+      } else {
+         ::Error("TFormula::CompileDeferred", "cannot compile the formula %s", batch[i].fExpression.c_str());
+      }
+   }
+   return ncompiled;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the directory of the libraries of compiled formulas, created if
+/// needed. Empty (the default, unless `Hist.Formula.CacheDirectory` is set
+/// in the .rootrc) disables the cache.
+///
+/// CompileDeferred() compiles the new formulas in a library of this
+/// directory with ACLiC, which takes longer than compiling them with Cling
+/// but only once: the following processes load the formulas from the
+/// library, whatever their mode of compilation. The formulas are
+/// identified by a digest of their expression, so the libraries of a
+/// directory can be shared by the jobs using the same formulas (with the
+/// same ROOT version).
+
+void TFormula::SetCacheDirectory(const char *dir)
+{
+   R__LOCKGUARD2(gROOTMutex);
+   fgCacheDirectory = dir ? dir : "";
+   gCacheDirectorySet = true;
+   gCacheIndexRead = false;
+   gCachedLibraries.clear();
+   if (!fgCacheDirectory.IsNull() && gSystem->AccessPathName(fgCacheDirectory))
+      gSystem->mkdir(fgCacheDirectory, kTRUE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the directory of the libraries of compiled formulas, see
+/// SetCacheDirectory().
+
+const char *TFormula::GetCacheDirectory()
+{
+   if (!gCacheDirectorySet) SetCacheDirectory(gEnv->GetValue("Hist.Formula.CacheDirectory", ""));
+   return fgCacheDirectory.Data();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///    Fill structures with default variables, constants and function shortcuts
 
@@ -1804,6 +2115,7 @@ void TFormula::ProcessFormula(TString &formula)
    if(!fReadyToExecute)
    {
       fReadyToExecute = true;
+      fClingPending = false;
       Bool_t hasVariables = (fNdim > 0);
       Bool_t hasParameters = (fNpar > 0);
       if(!hasParameters)
@@ -1844,12 +2156,20 @@ void TFormula::ProcessFormula(TString &formula)
             fClingInitialized = true;
             inputIntoCling = false;
          }
+         // else look for it in the libraries of compiled formulas
+         else if (void * cached = FindCachedFunction(inputFormula, argumentsPrototype)) {
+            fFuncPtr = (  TInterpreter::CallFuncIFacePtr_t::Generic_t) cached;
+            gClingFunctions.insert ( std::make_pair ( inputFormula, cached) );
+            fClingInitialized = true;
+            inputIntoCling = false;
+         }
 
          // set the cling name using hash of the static formulae map
          auto hasher = gClingFunctions.hash_function();
          fClingName = TString::Format("%s__id%zu",gNamePrefix.Data(), hasher(inputFormula) );
 
          fClingInput = TString::Format("Double_t %s(%s){ return %s ; }", fClingName.Data(),argumentsPrototype.Data(),inputFormula.c_str());
+         ResetBatchMethod();
 
          // this is not needed (maybe can be re-added in case of recompilation of identical expressions
          // // check in case of a change if need to re-initialize
@@ -1861,7 +2181,17 @@ void TFormula::ProcessFormula(TString &formula)
          // }
 
 
-         if(inputIntoCling) {
+         if(inputIntoCling && fgDeferred) {
+            // wait for CompileDeferred, which compiles all the new formulas at once
+            TFormulaDeferred &deferred = gDeferredFormulas[fClingName.Data()];
+            deferred.fName = fClingName;
+            deferred.fExpression = inputFormula;
+            deferred.fArguments = argumentsPrototype;
+            deferred.fCode = fClingInput;
+            gDeferredExpressions[fClingName.Data()] = inputFormula;
+            fClingPending = true;
+         }
+         else if(inputIntoCling) {
             InputFormulaIntoCling();
             if (fClingInitialized) {
                // if Cling has been succesfully initialized
@@ -2627,6 +2957,7 @@ Double_t TFormula::DoEval(const double * x, const double * params) const
       double * p = (params) ? const_cast<double*>(params) : const_cast<double*>(fClingParameters.data());
       return fptr(v, p);
    }
+   if (fClingPending) ResolveDeferred();
    // this is needed when reading from a file
    if (!fClingInitialized) {
       Error("Eval","Formula is invalid or not properly initialized - try calling TFormula::Compile");
@@ -2654,6 +2985,139 @@ Double_t TFormula::DoEval(const double * x, const double * params) const
    return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the formula at the n points x, x + stride, x + 2*stride, ... for the
+/// parameters params (the ones of the formula if null), and store the values in
+/// result.
+///
+/// The first time it is needed, a function evaluating the expression over an
+/// array of points is compiled with Cling (once for each expression, as for the
+/// function evaluating one point), so that all the points are evaluated in a
+/// single loop which the compiler can inline and vectorize. For formulas defined
+/// by a lambda expression, or if this function cannot be compiled, the points
+/// are evaluated one after the other.
+
+void TFormula::EvalParN(Int_t n, const Double_t *x, Int_t stride, const Double_t *params, Double_t *result) const
+{
+   DoEvalParN(n, x, stride, 1, params, result);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the formula at n points given as a structure of arrays: the
+/// coordinate k of the point i is x[k*n + i]. See EvalParN().
+
+void TFormula::EvalParSoA(Int_t n, const Double_t *x, const Double_t *params, Double_t *result) const
+{
+   DoEvalParN(n, x, 1, n, params, result);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the formula at the n points whose coordinate k of the point i is
+/// x[i*pointStride + k*coordStride].
+
+void TFormula::DoEvalParN(Int_t n, const Double_t *x, Int_t pointStride, Int_t coordStride, const Double_t *params,
+                          Double_t *result) const
+{
+   if (n <= 0) return;
+   if (fClingPending) ResolveDeferred();
+   Bool_t isLambda = fLambdaPtr && TestBit(TFormula::kLambda);
+   double * pars = (params) ? const_cast<double*>(params) : const_cast<double*>(fClingParameters.data());
+
+   if (fReadyToExecute && fClingInitialized && !isLambda && PrepareBatchMethod()) {
+      const double * vars = x;
+      void* args[6];
+      args[0] = &n;
+      args[1] = &vars;
+      args[2] = &pointStride;
+      args[3] = &coordStride;
+      args[4] = &pars;
+      args[5] = &result;
+      (*fBatchFuncPtr.load(std::memory_order_relaxed))(0, 6, args, nullptr);
+      return;
+   }
+
+   // evaluate point by point, copying the coordinates if they are not contiguous
+   std::vector<double> point( (coordStride != 1) ? std::max(fNdim, 1) : 0);
+   auto getPoint = [&](Int_t i) {
+      if (point.empty()) return const_cast<double*>(x + i*pointStride);
+      for (unsigned int k = 0; k < point.size(); ++k) point[k] = x[i*pointStride + k*coordStride];
+      return point.data();
+   };
+   if (!fReadyToExecute || (!fClingInitialized && !isLambda)) {
+      // let DoEval report the error
+      for (Int_t i = 0; i < n; ++i) result[i] = DoEval(getPoint(i), params);
+      return;
+   }
+   if (isLambda) {
+      std::function<double(double *, double *)> & fptr = * ( (std::function<double(double *, double *)> *) fLambdaPtr);
+      for (Int_t i = 0; i < n; ++i) result[i] = fptr(getPoint(i), pars);
+      return;
+   }
+   void* args[2];
+   double * vars;
+   args[0] = &vars;
+   args[1] = &pars;
+   Int_t nargs = (fNpar <= 0) ? 1 : 2;
+   for (Int_t i = 0; i < n; ++i) {
+      vars = getPoint(i);
+      (*fFuncPtr)(0, nargs, args, &result[i]);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Look for the function evaluating the expression over an array of points,
+/// and compile it with Cling if it does not exist yet. Return false if it
+/// cannot be compiled.
+
+Bool_t TFormula::PrepareBatchMethod() const
+{
+   if (fBatchPrepared.load(std::memory_order_acquire))
+      return fBatchFuncPtr.load(std::memory_order_relaxed) != nullptr;
+
+   R__LOCKGUARD2(gROOTMutex);
+   if (!fBatchPrepared.load(std::memory_order_relaxed)) {
+      std::string expression = GetExpFormula("CLING").Data();
+      void * funcPtr = nullptr;
+      auto funcit = gClingBatchFunctions.find(expression);
+      if (funcit != gClingBatchFunctions.end() ) {
+         funcPtr = funcit->second;
+      }
+      else {
+         // the loop variables have names which cannot clash with the ones used in the expression
+         auto hasher = gClingBatchFunctions.hash_function();
+         TString batchName = TString::Format("%s__batch%zu",gNamePrefix.Data(), hasher(expression) );
+         Int_t ndim = std::max(fNdim, 1);
+         TString batchInput =
+            TString::Format("void %s(Int_t n__, const Double_t *x__, Int_t pointStride__, Int_t coordStride__, Double_t *p, Double_t *r__)"
+                            "{ for (Int_t i__ = 0; i__ < n__; ++i__) { Double_t x[%d];"
+                            " for (Int_t k__ = 0; k__ < %d; ++k__) x[k__] = x__[i__*pointStride__ + k__*coordStride__];"
+                            " r__[i__] = %s ; } }",
+                            batchName.Data(), ndim, ndim, expression.c_str());
+         if (gCling->Declare(batchInput)) {
+            TMethodCall method;
+            method.InitWithPrototype(batchName,"Int_t,const Double_t*,Int_t,Int_t,Double_t*,Double_t*");
+            if (method.IsValid())
+               funcPtr = (void*) gCling->CallFunc_IFacePtr(method.GetCallFunc()).fGeneric;
+         }
+         // a failure is also stored, not to try again
+         gClingBatchFunctions.insert( std::make_pair(expression, funcPtr) );
+      }
+      fBatchFuncPtr.store( (TInterpreter::CallFuncIFacePtr_t::Generic_t) funcPtr, std::memory_order_relaxed);
+      fBatchPrepared.store(true, std::memory_order_release);
+   }
+   return fBatchFuncPtr.load(std::memory_order_relaxed) != nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Forget the function evaluating an array of points, after a change of the
+/// expression.
+
+void TFormula::ResetBatchMethod()
+{
+   fBatchFuncPtr.store(nullptr, std::memory_order_relaxed);
+   fBatchPrepared.store(false, std::memory_order_relaxed);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the expression formula.
 ///
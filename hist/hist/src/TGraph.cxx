@@ -859,6 +859,9 @@ void TGraph::DrawPanel()
 ///   and the interpolated value from the spline is returned.
 ///   the internally created spline is deleted on return.
 ///  -if spline is specified, it is used to return the interpolated value.
+///
+/// To interpolate the graph at many points, TGraphInterpolator sorts the
+/// points and builds the spline only once.
 
 Double_t TGraph::Eval(Double_t x, TSpline *spline, Option_t *option) const
 {
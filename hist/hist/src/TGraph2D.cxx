@@ -1294,6 +1294,24 @@ Double_t TGraph2D::Interpolate(Double_t x, Double_t y)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Store in z[i] the value interpolated at (x[i],y[i]), for i < n, as
+/// Interpolate(x[i],y[i]). With the Delaunay triangles of TGraphDelaunay2D,
+/// the triangle of a point is tried first for the next one, which is faster
+/// for close points.
+
+void TGraph2D::Interpolate(Int_t n, const Double_t *x, const Double_t *y, Double_t *z)
+{
+   if (n <= 0) return;
+   z[0] = Interpolate(x[0], y[0]);
+   if (fDelaunay && fDelaunay->IsA() == TGraphDelaunay2D::Class()) {
+      ((TGraphDelaunay2D*)fDelaunay)->ComputeZ(n-1, x+1, y+1, z+1);
+      return;
+   }
+   for (Int_t i = 1; i < n; ++i) z[i] = Interpolate(x[i], y[i]);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Paints this 2D graph with its current attributes
 
@@ -1519,6 +1537,8 @@ void TGraph2D::Set(Int_t n)
    if (n == fNpoints) return;
    if (n >  fNpoints) SetPoint(n, 0, 0, 0);
    fNpoints = n;
+   if (fDelaunay && fDelaunay->IsA() == TGraphDelaunay2D::Class())
+      ((TGraphDelaunay2D*)fDelaunay)->SetInputPoints();
 }
 
 
@@ -1686,12 +1706,15 @@ void TGraph2D::SetNpy(Int_t npy)
 ////////////////////////////////////////////////////////////////////////////////
 /// Sets point number n.
 /// If n is greater than the current size, the arrays are automatically
-/// extended.
+/// extended. The points added after an interpolation are inserted in its
+/// Delaunay triangles (TGraphDelaunay2D), without finding them all again.
 
 void TGraph2D::SetPoint(Int_t n, Double_t x, Double_t y, Double_t z)
 {
    if (n < 0) return;
 
+   Int_t npoints = fNpoints;
+
    if (!fX || !fY || !fZ || n >= fSize) {
       // re-allocate the object
       Int_t newN = TMath::Max(2 * fSize, n + 1);
@@ -1722,6 +1745,12 @@ void TGraph2D::SetPoint(Int_t n, Double_t x, Double_t y, Double_t z)
    fY[n]    = y;
    fZ[n]    = z;
    fNpoints = TMath::Max(fNpoints, n + 1);
+
+   // the triangles point to the arrays, which may have been re-allocated
+   if (fDelaunay && fDelaunay->IsA() == TGraphDelaunay2D::Class()) {
+      if (n >= npoints) ((TGraphDelaunay2D*)fDelaunay)->AddPoints();
+      else              ((TGraphDelaunay2D*)fDelaunay)->SetInputPoints();
+   }
 }
 
 
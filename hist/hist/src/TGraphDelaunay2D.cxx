@@ -54,3 +54,24 @@ TGraphDelaunay2D::TGraphDelaunay2D(TGraph2D *g ) :
 
 {}
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add to the Delaunay triangles the points appended to the graph, inserting each
+/// of them in the triangles around it when they have been found and it lies inside
+/// of their convex hull.
+
+void TGraphDelaunay2D::AddPoints()
+{
+   if (!fGraph2D) return;
+   fDelaunay.AddPoints(fGraph2D->GetN(), fGraph2D->GetX(), fGraph2D->GetY(), fGraph2D->GetZ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Take the points of the graph again, after they have been changed; the Delaunay
+/// triangles are found again at the next interpolation.
+
+void TGraphDelaunay2D::SetInputPoints()
+{
+   if (!fGraph2D) return;
+   fDelaunay.SetInputPoints(fGraph2D->GetN(), fGraph2D->GetX(), fGraph2D->GetY(), fGraph2D->GetZ(),
+                            fGraph2D->GetXmin(), fGraph2D->GetXmax(), fGraph2D->GetYmin(), fGraph2D->GetYmax());
+}
@@ -0,0 +1,120 @@
+// @(#)root/hist:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TGraphInterpolator
+Interpolate the points of a TGraph at many abscissas.
+
+TGraph::Eval searches the two points around x at each call (with a binary
+search only if the bit TGraph::kIsSortedX is set) and, with the option "S",
+builds a new TSpline3 at each call. The interpolator sorts the points and
+builds the spline once:
+~~~{.cpp}
+   TGraphInterpolator interp(*calibration, "S");
+   for (auto &hit : hits) hit.fEnergy = interp.Eval(hit.fAdc);
+~~~
+The values are the ones given by TGraph::Eval(x, 0, option): a linear
+interpolation between the points around x, or a linear extrapolation from
+the first or last two points, or the value of the spline for the option "S".
+*/
+
+#include "TGraphInterpolator.h"
+
+#include "TGraph.h"
+#include "TMath.h"
+#include "TSpline.h"
+#include "TString.h"
+
+#include <algorithm>
+#include <numeric>
+
+////////////////////////////////////////////////////////////////////////////////
+/// Prepare to interpolate the points of g; with option "S" a TSpline3 through
+/// the points is used, as in TGraph::Eval.
+
+TGraphInterpolator::TGraphInterpolator(const TGraph &g, Option_t *option) : fSpline(0), fLast(-1)
+{
+   Int_t n = g.GetN();
+   const Double_t *x = g.GetX();
+   const Double_t *y = g.GetY();
+
+   // points must be sorted, keeping the order of the points with the same abscissa
+   std::vector<Int_t> index(n);
+   std::iota(index.begin(), index.end(), 0);
+   if (!g.TestBit(TGraph::kIsSortedX))
+      std::stable_sort(index.begin(), index.end(), [x](Int_t i, Int_t j) { return x[i] < x[j]; });
+   fX.resize(n);
+   fY.resize(n);
+   for (Int_t i = 0; i < n; ++i) {
+      fX[i] = x[index[i]];
+      fY[i] = y[index[i]];
+   }
+
+   TString opt = option;
+   opt.ToLower();
+   if (opt.Contains("s") && n > 1)
+      fSpline = new TSpline3("", fX.data(), fY.data(), n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+TGraphInterpolator::~TGraphInterpolator()
+{
+   delete fSpline;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the index of the last point whose abscissa is lower than or equal
+/// to x (the first one of a series of equal abscissas), or -1, as
+/// TMath::BinarySearch. The interval of the previous call and the next one are
+/// tried before the binary search.
+
+Int_t TGraphInterpolator::FindInterval(Double_t x)
+{
+   Int_t n = fX.size();
+   Int_t i = fLast;
+   if (i >= 0 && i < n-1 && fX[i] < x && x < fX[i+1]) return i;
+   ++i;
+   if (i >= 0 && i < n-1 && fX[i] < x && x < fX[i+1]) return fLast = i;
+   fLast = TMath::BinarySearch(n, fX.data(), x);
+   return fLast;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the value interpolated at x, as TGraph::Eval(x, 0, option).
+
+Double_t TGraphInterpolator::Eval(Double_t x)
+{
+   Int_t n = fX.size();
+   if (n == 0) return 0;
+   if (n == 1) return fY[0];
+   if (fSpline) return fSpline->Eval(x);
+
+   Int_t low = FindInterval(x);
+   if (low == -1)  {
+      // use first two points for doing an extrapolation
+      low = 0;
+   }
+   if (fX[low] == x) return fY[low];
+   if (low == n-1) low--; // for extrapolating
+   Int_t up = low+1;
+
+   if (fX[low] == fX[up]) return fY[low];
+   return fY[up] + (x - fX[up]) * (fY[low] - fY[up]) / (fX[low] - fX[up]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Store in y[i] the value interpolated at x[i], for i < n.
+
+void TGraphInterpolator::Eval(Int_t n, const Double_t *x, Double_t *y)
+{
+   for (Int_t i = 0; i < n; ++i) y[i] = Eval(x[i]);
+}
@@ -3239,7 +3239,7 @@ void TH1::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride
       }
       // fill the remaining entries if the buffer has been deleted
       if (i < ntimes && fBuffer==0)
-         DoFillN((ntimes-i)/stride,&x[i],&w[i],stride);
+         DoFillN((ntimes-i)/stride,&x[i],w ? &w[i] : 0,stride);
       return;
    }
    // call internal method
@@ -3249,6 +3249,11 @@ void TH1::FillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride
 ////////////////////////////////////////////////////////////////////////////////
 /// Internal method to fill histogram content from a vector
 /// called directly by TH1::BufferEmpty
+///
+/// The bins of the entries are found kNFillChunk at a time by
+/// TAxis::FindFixBinN, and the statistics are summed over all the entries
+/// before being added to the ones of the histogram. An axis which can be
+/// extended needs the entries to be filled one by one, as by TH1::Fill.
 
 void TH1::DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stride)
 {
@@ -3257,22 +3262,76 @@ void TH1::DoFillN(Int_t ntimes, const Double_t *x, const Double_t *w, Int_t stri
    fEntries += ntimes;
    Double_t ww = 1;
    Int_t nbins   = fXaxis.GetNbins();
+   if (fXaxis.CanExtend() && !fXaxis.IsAlphanumeric()) {
+      ntimes *= stride;
+      for (i=0;i<ntimes;i+=stride) {
+         bin =fXaxis.FindBin(x[i]);
+         if (bin <0) continue;
+         if (w) ww = w[i];
+         if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin, ww);
+         if (bin == 0 || bin > nbins) {
+            if (!fgStatOverflows) continue;
+         }
+         Double_t z= ww;
+         fTsumw   += z;
+         fTsumw2  += z*z;
+         fTsumwx  += z*x[i];
+         fTsumwx2 += z*x[i]*x[i];
+      }
+      return;
+   }
+
+   DoFillNSumw2(ntimes, w, stride);
+   const Bool_t statOverflows = fgStatOverflows;
+   Double_t sumw = 0, sumw2 = 0, sumwx = 0, sumwx2 = 0;
+   Int_t bins[kNFillChunk];
+   for (Int_t first = 0; first < ntimes; first += kNFillChunk) {
+      const Int_t n = TMath::Min(ntimes - first, (Int_t) kNFillChunk);
+      const Double_t *xc = x + first*stride;
+      const Double_t *wc = w ? w + first*stride : 0;
+      fXaxis.FindFixBinN(n, xc, bins, stride);
+      for (i = 0; i < n; ++i) {
+         if (wc) ww = wc[i*stride];
+         AddBinContent(bins[i], ww);
+      }
+      if (fSumw2.fN) {
+         for (i = 0; i < n; ++i) {
+            if (wc) ww = wc[i*stride];
+            fSumw2.fArray[bins[i]] += ww*ww;
+         }
+      }
+      for (i = 0; i < n; ++i) {
+         const Bool_t use = statOverflows || (bins[i] > 0 && bins[i] <= nbins);
+         const Double_t z  = use ? (wc ? wc[i*stride] : 1.) : 0;
+         const Double_t xi = use ? xc[i*stride] : 0;   // an overflow may be infinite
+         sumw   += z;
+         sumw2  += z*z;
+         sumwx  += z*xi;
+         sumwx2 += z*xi*xi;
+      }
+   }
+   fTsumw   += sumw;
+   fTsumw2  += sumw2;
+   fTsumwx  += sumwx;
+   fTsumwx2 += sumwx2;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Trigger the storage of the sum of squares of weights, as the Fill
+/// methods do, if one of the ntimes weights w[0], w[stride], ... is not 1.
+/// Called by FillN before filling the bins.
+
+void TH1::DoFillNSumw2(Int_t ntimes, const Double_t *w, Int_t stride)
+{
+   if (!w || fSumw2.fN || TestBit(TH1::kIsNotW)) return;
    ntimes *= stride;
-   for (i=0;i<ntimes;i+=stride) {
-      bin =fXaxis.FindBin(x[i]);
-      if (bin <0) continue;
-      if (w) ww = w[i];
-      if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
-      if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
-      AddBinContent(bin, ww);
-      if (bin == 0 || bin > nbins) {
-         if (!fgStatOverflows) continue;
+   for (Int_t i = 0; i < ntimes; i += stride) {
+      if (w[i] != 1.0) {
+         Sumw2();
+         return;
       }
-      Double_t z= ww;
-      fTsumw   += z;
-      fTsumw2  += z*z;
-      fTsumwx  += z*x[i];
-      fTsumwx2 += z*x[i]*x[i];
    }
 }
 
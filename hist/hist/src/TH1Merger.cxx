@@ -8,7 +8,96 @@
 #include "TError.h"
 #include "THashList.h"
 #include "TClass.h"
+#include "TROOT.h"
+#include "TArrayD.h"
+#include "TArrayF.h"
 #include <iostream>
+#include <type_traits>
+#include <vector>
+
+#ifdef R__USE_IMT
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
+namespace {
+
+// Minimal number of bins times histograms for the arrays to be added in parallel
+const Long64_t kMinParallelMerge = 1 << 22;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add to dst the arrays of srcs, for the bins [first, last). The loop over
+/// the bins of each array is vectorized by the compiler.
+
+template <typename T, typename U>
+void AddArrays(T *dst, const std::vector<const U *> &srcs, Int_t first, Int_t last)
+{
+   for (const U *src : srcs)
+      for (Int_t i = first; i < last; ++i)
+         dst[i] += src[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Call f on ranges of bins covering [0, ncells), in parallel with the
+/// implicit multi-threading if there are enough bins and histograms.
+
+template <typename F>
+void ForEachBinRange(Int_t ncells, Long64_t nhists, const F &f)
+{
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled() && ncells * nhists >= kMinParallelMerge) {
+      tbb::parallel_for(tbb::blocked_range<Int_t>(0, ncells, 16384),
+                        [&f](const tbb::blocked_range<Int_t> &r) { f(r.begin(), r.end()); });
+      return;
+   }
+#else
+   (void) nhists;
+#endif
+   f(0, ncells);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the contents of hists, whose arrays are of type T, to the array of
+/// h0. The sums of the squares of the weights are added to the ones of h0 if
+/// it has them, the contents being used for the histograms without them.
+/// Return false, without adding anything, if the histograms are not all of
+/// the class of h0, or their arrays not of type T or not of the same size.
+
+template <typename T>
+Bool_t AddArraysOf(TH1 *h0, const std::vector<TH1 *> &hists)
+{
+   T *dst = dynamic_cast<T *>(h0);
+   if (!dst) return kFALSE;
+   typedef typename std::remove_pointer<decltype(dst->fArray)>::type Elem_t;
+   std::vector<const Elem_t *> contents;
+   std::vector<const Double_t *> sumw2;
+   std::vector<const Elem_t *> sumw2FromContents;
+   const Bool_t errors = h0->GetSumw2N() > 0;
+   for (TH1 *h : hists) {
+      const T *src = dynamic_cast<const T *>(h);
+      if (!src || h->IsA() != h0->IsA() || src->GetSize() != dst->GetSize() || (h->GetSumw2N() && h->GetSumw2N() != dst->GetSize()))
+         return kFALSE;
+      contents.push_back(src->fArray);
+      if (!errors) continue;
+      if (h->GetSumw2N())
+         sumw2.push_back(h->GetSumw2()->fArray);
+      else
+         sumw2FromContents.push_back(src->fArray);
+   }
+
+   Elem_t *dstContent = dst->fArray;
+   Double_t *dstSumw2 = errors ? h0->GetSumw2()->fArray : 0;
+   ForEachBinRange(dst->GetSize(), hists.size(), [&](Int_t first, Int_t last) {
+      AddArrays(dstContent, contents, first, last);
+      if (dstSumw2) {
+         AddArrays(dstSumw2, sumw2, first, last);
+         AddArrays(dstSumw2, sumw2FromContents, first, last);
+      }
+   });
+   return kTRUE;
+}
+
+}
 
 
 Bool_t TH1Merger::AxesHaveLimits(const TH1 * h) {
@@ -420,6 +509,7 @@ Bool_t TH1Merger::SameAxesMerge() {
    fH0->GetStats(totstats);
    Double_t nentries = fH0->GetEntries();
    
+   std::vector<TH1*> hists;
    TIter next(&fInputList); 
    while (TH1* hist=(TH1*)next()) {
       // process only if the histogram has limits; otherwise it was processed before
@@ -436,18 +526,24 @@ Bool_t TH1Merger::SameAxesMerge() {
       for (Int_t i=0; i<TH1::kNstat; i++)
          totstats[i] += stats[i];
       nentries += hist->GetEntries();
+      hists.push_back(hist);
+   }
 
-         //Int_t nx = hist->GetXaxis()->GetNbins();
+   // add the bin arrays directly if they are all of double or all of float,
+   // for which it gives the same result as AddBinContent
+   if (!AddArraysOf<TArrayD>(fH0, hists) && !AddArraysOf<TArrayF>(fH0, hists)) {
+      for (TH1 *hist : hists) {
          // loop on bins of the histogram and do the merge
-      for (Int_t ibin = 0; ibin < hist->fNcells; ibin++) {
+         for (Int_t ibin = 0; ibin < hist->fNcells; ibin++) {
 
-         Double_t cu = hist->RetrieveBinContent(ibin);
-         Double_t e1sq = TMath::Abs(cu);
-         if (fH0->fSumw2.fN) e1sq= hist->GetBinErrorSqUnchecked(ibin);
+            Double_t cu = hist->RetrieveBinContent(ibin);
+            Double_t e1sq = TMath::Abs(cu);
+            if (fH0->fSumw2.fN) e1sq= hist->GetBinErrorSqUnchecked(ibin);
 
-         fH0->AddBinContent(ibin,cu);
-         if (fH0->fSumw2.fN) fH0->fSumw2.fArray[ibin] += e1sq;
+            fH0->AddBinContent(ibin,cu);
+            if (fH0->fSumw2.fN) fH0->fSumw2.fArray[ibin] += e1sq;
 
+         }
       }
    }
    //copy merged stats
@@ -552,31 +552,82 @@ void TH2::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double
    }
 
    Double_t ww = 1;
-   for (i=ifirst;i<ntimes;i+=stride) {
-      fEntries++;
-      binx = fXaxis.FindBin(x[i]);
-      biny = fYaxis.FindBin(y[i]);
-      if (binx <0 || biny <0) continue;
-      bin  = biny*(fXaxis.GetNbins()+2) + binx;
-      if (w) ww = w[i];
-      if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
-      if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
-      AddBinContent(bin,ww);
-      if (binx == 0 || binx > fXaxis.GetNbins()) {
-         if (!fgStatOverflows) continue;
+   if ((fXaxis.CanExtend() && !fXaxis.IsAlphanumeric()) || (fYaxis.CanExtend() && !fYaxis.IsAlphanumeric())) {
+      for (i=ifirst;i<ntimes;i+=stride) {
+         fEntries++;
+         binx = fXaxis.FindBin(x[i]);
+         biny = fYaxis.FindBin(y[i]);
+         if (binx <0 || biny <0) continue;
+         bin  = biny*(fXaxis.GetNbins()+2) + binx;
+         if (w) ww = w[i];
+         if (!fSumw2.fN && ww != 1.0 && !TestBit(TH1::kIsNotW))  Sumw2();
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin,ww);
+         if (binx == 0 || binx > fXaxis.GetNbins()) {
+            if (!fgStatOverflows) continue;
+         }
+         if (biny == 0 || biny > fYaxis.GetNbins()) {
+            if (!fgStatOverflows) continue;
+         }
+         Double_t z= ww; //(ww > 0 ? ww : -ww);
+         fTsumw   += z;
+         fTsumw2  += z*z;
+         fTsumwx  += z*x[i];
+         fTsumwx2 += z*x[i]*x[i];
+         fTsumwy  += z*y[i];
+         fTsumwy2 += z*y[i]*y[i];
+         fTsumwxy += z*x[i]*y[i];
+      }
+      return;
+   }
+
+   // find the bins kNFillChunk entries at a time, as TH1::DoFillN
+   x += ifirst;
+   y += ifirst;
+   if (w) w += ifirst;
+   Int_t nentries = (ntimes - ifirst + stride - 1)/stride;
+   fEntries += nentries;
+   DoFillNSumw2(nentries, w, stride);
+   const Int_t nx = fXaxis.GetNbins();
+   const Int_t ny = fYaxis.GetNbins();
+   const Bool_t statOverflows = fgStatOverflows;
+   Double_t sumw = 0, sumw2 = 0, sumwx = 0, sumwx2 = 0, sumwy = 0, sumwy2 = 0, sumwxy = 0;
+   Int_t binsx[kNFillChunk], binsy[kNFillChunk];
+   for (Int_t first = 0; first < nentries; first += kNFillChunk) {
+      const Int_t n = TMath::Min(nentries - first, (Int_t) kNFillChunk);
+      const Double_t *xc = x + first*stride;
+      const Double_t *yc = y + first*stride;
+      const Double_t *wc = w ? w + first*stride : 0;
+      fXaxis.FindFixBinN(n, xc, binsx, stride);
+      fYaxis.FindFixBinN(n, yc, binsy, stride);
+      for (i = 0; i < n; ++i) {
+         if (wc) ww = wc[i*stride];
+         bin = binsy[i]*(nx+2) + binsx[i];
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin,ww);
       }
-      if (biny == 0 || biny > fYaxis.GetNbins()) {
-         if (!fgStatOverflows) continue;
+      for (i = 0; i < n; ++i) {
+         const Bool_t use = statOverflows ||
+                            (binsx[i] > 0 && binsx[i] <= nx && binsy[i] > 0 && binsy[i] <= ny);
+         const Double_t z  = use ? (wc ? wc[i*stride] : 1.) : 0;
+         const Double_t xi = use ? xc[i*stride] : 0;
+         const Double_t yi = use ? yc[i*stride] : 0;
+         sumw   += z;
+         sumw2  += z*z;
+         sumwx  += z*xi;
+         sumwx2 += z*xi*xi;
+         sumwy  += z*yi;
+         sumwy2 += z*yi*yi;
+         sumwxy += z*xi*yi;
       }
-      Double_t z= ww; //(ww > 0 ? ww : -ww);
-      fTsumw   += z;
-      fTsumw2  += z*z;
-      fTsumwx  += z*x[i];
-      fTsumwx2 += z*x[i]*x[i];
-      fTsumwy  += z*y[i];
-      fTsumwy2 += z*y[i]*y[i];
-      fTsumwxy += z*x[i]*y[i];
    }
+   fTsumw   += sumw;
+   fTsumw2  += sumw2;
+   fTsumwx  += sumwx;
+   fTsumwx2 += sumwx2;
+   fTsumwy  += sumwy;
+   fTsumwy2 += sumwy2;
+   fTsumwxy += sumwxy;
 }
 
 
@@ -17,6 +17,8 @@
 #include "TList.h"
 #include "TMath.h"
 
+#include <vector>
+
 ClassImp(TH2Poly)
 
 /** \class TH2Poly
@@ -133,8 +135,133 @@ filling, it also adds a constant time delay into the code. When `Fill()`
 is to be called many times, it is more efficient to divide the histogram into
 a large number cells. However, if the histogram is to be filled only a few
 times, it is better to divide into a small number of cells.
+
+The bins are only tested with `IsInside()` if the point is inside their
+bounding box. When many bins share the same cells, for instance for a map
+with thousands of small regions next to large ones, a fixed grid remains
+slow where the bins are dense. `SetUseQuadTree()` makes `Fill()` and
+`FindBin()` use instead a quadtree of the bounding boxes of the bins, whose
+nodes are split until they intersect at most a few bins: the time of a
+lookup then hardly depends on the number of bins. The quadtree is built by
+the first `Fill()` or `FindBin()` following the addition of bins, and is not
+saved with the histogram. `FillN()` fills the histogram with arrays of
+coordinates.
 */
 
+////////////////////////////////////////////////////////////////////////////////
+/// Quadtree of the bounding boxes of the bins of a TH2Poly.
+///
+/// A node is split in four quadrants while it intersects more than kLeafSize
+/// bins, up to kMaxDepth levels; a bin intersecting several quadrants is in
+/// each of them. The leaves keep the bins in the order of the histogram, so
+/// that a point is assigned to the same bin as with the partition cells.
+
+class TH2PolyQuadTree {
+public:
+   TH2PolyQuadTree(TList *bins, Double_t xmin, Double_t xmax, Double_t ymin, Double_t ymax);
+   TH2PolyBin *FindBin(Double_t x, Double_t y) const;
+
+private:
+   enum { kLeafSize = 8, kMaxDepth = 12 };
+
+   struct Entry_t {
+      Double_t    fXmin, fXmax, fYmin, fYmax; // Bounding box of the bin
+      TH2PolyBin *fBin;
+   };
+   struct Node_t {
+      Double_t fXmid, fYmid;   // Center of the node
+      Int_t    fChildren;      // Index of the first of the four children, -1 for a leaf
+      Int_t    fFirst, fLast;  // Range of the entries of a leaf in fEntries
+   };
+
+   void Build(Int_t node, Double_t xmin, Double_t xmax, Double_t ymin, Double_t ymax,
+              const std::vector<Entry_t> &entries, Int_t depth);
+
+   std::vector<Node_t>  fNodes;
+   std::vector<Entry_t> fEntries;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Build the quadtree of the bins inside the rectangle of the histogram.
+
+TH2PolyQuadTree::TH2PolyQuadTree(TList *bins, Double_t xmin, Double_t xmax, Double_t ymin, Double_t ymax)
+{
+   std::vector<Entry_t> entries;
+   TIter next(bins);
+   TObject *obj;
+   while ((obj = next())) {
+      TH2PolyBin *bin = (TH2PolyBin*) obj;
+      Entry_t e = {bin->GetXMin(), bin->GetXMax(), bin->GetYMin(), bin->GetYMax(), bin};
+      entries.push_back(e);
+   }
+   fNodes.resize(1);
+   Build(0, xmin, xmax, ymin, ymax, entries, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Make node, covering the given rectangle, a leaf holding entries or split
+/// it in four children.
+
+void TH2PolyQuadTree::Build(Int_t node, Double_t xmin, Double_t xmax, Double_t ymin, Double_t ymax,
+                            const std::vector<Entry_t> &entries, Int_t depth)
+{
+   Double_t xmid = 0.5*(xmin + xmax);
+   Double_t ymid = 0.5*(ymin + ymax);
+   fNodes[node].fXmid = xmid;
+   fNodes[node].fYmid = ymid;
+   fNodes[node].fChildren = -1;
+
+   // The quadrants are numbered (x >= xmid) + 2*(y >= ymid)
+   std::vector<Entry_t> sub[4];
+   Bool_t split = kFALSE;
+   if ((Int_t)entries.size() > kLeafSize && depth < kMaxDepth) {
+      for (UInt_t i = 0; i < entries.size(); i++) {
+         const Entry_t &e = entries[i];
+         if (e.fXmin <= xmid && e.fYmin <= ymid) sub[0].push_back(e);
+         if (e.fXmax >= xmid && e.fYmin <= ymid) sub[1].push_back(e);
+         if (e.fXmin <= xmid && e.fYmax >= ymid) sub[2].push_back(e);
+         if (e.fXmax >= xmid && e.fYmax >= ymid) sub[3].push_back(e);
+      }
+      // Splitting is useless if every bin intersects all the quadrants
+      for (Int_t q = 0; q < 4; q++) {
+         if (sub[q].size() < entries.size()) split = kTRUE;
+      }
+   }
+
+   if (!split) {
+      fNodes[node].fFirst = fEntries.size();
+      fEntries.insert(fEntries.end(), entries.begin(), entries.end());
+      fNodes[node].fLast = fEntries.size();
+      return;
+   }
+
+   Int_t children = fNodes.size();
+   fNodes[node].fChildren = children;
+   fNodes.resize(children + 4);
+   Build(children,     xmin, xmid, ymin, ymid, sub[0], depth + 1);
+   Build(children + 1, xmid, xmax, ymin, ymid, sub[1], depth + 1);
+   Build(children + 2, xmin, xmid, ymid, ymax, sub[2], depth + 1);
+   Build(children + 3, xmid, xmax, ymid, ymax, sub[3], depth + 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Returns the first bin containing (x,y), 0 if none.
+
+TH2PolyBin *TH2PolyQuadTree::FindBin(Double_t x, Double_t y) const
+{
+   Int_t node = 0;
+   while (fNodes[node].fChildren >= 0) {
+      const Node_t &n = fNodes[node];
+      node = n.fChildren + (x >= n.fXmid) + 2*(y >= n.fYmid);
+   }
+   for (Int_t i = fNodes[node].fFirst; i < fNodes[node].fLast; i++) {
+      const Entry_t &e = fEntries[i];
+      if (x < e.fXmin || x > e.fXmax || y < e.fYmin || y > e.fYmax) continue;
+      if (e.fBin->IsInside(x,y)) return e.fBin;
+   }
+   return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Default Constructor. No boundaries specified.
 
@@ -180,6 +307,7 @@ TH2Poly::~TH2Poly()
    delete[] fCells;
    delete[] fIsEmpty;
    delete[] fCompletelyInside;
+   delete fQuadTree;
    // delete at the end the bin List since it owns the objects
    delete fBins;
 }
@@ -230,6 +358,10 @@ Int_t TH2Poly::AddBin(TObject *poly)
    fBins->Add((TObject*) bin);
    SetNewBinAdded(kTRUE);
 
+   // The quadtree is rebuilt when needed
+   delete fQuadTree;
+   fQuadTree = 0;
+
    // Adds the bin to the partition matrix
    AddBinToPartition(bin);
 
@@ -474,7 +606,9 @@ TObject* TH2Poly::Clone(const char* newname) const
    // Until this is implemented, revert to the much slower default version
    // (and possibly non-thread safe).
 
-   return TNamed::Clone(newname);
+   TH2Poly *hnew = (TH2Poly*)TNamed::Clone(newname);
+   if (hnew) hnew->SetUseQuadTree(fUseQuadTree);
+   return hnew;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -546,6 +680,29 @@ Int_t TH2Poly::FindBin(Double_t x, Double_t y, Double_t)
    else if (x > fXaxis.GetXmin()) overflow += -1;
    if (overflow != -5) return overflow;
 
+   TH2PolyBin *bin = FindPolyBin(x, y);
+   if (bin) return bin->GetBinNumber();
+
+   // If the search has not returned a bin, the point must be on "the sea"
+   return -5;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Returns the first bin containing (x,y), or 0 if (x,y) is in "the sea".
+/// (x,y) must be inside the limits of the histogram. Uses the quadtree if
+/// SetUseQuadTree() was called, the partition cells otherwise.
+
+TH2PolyBin *TH2Poly::FindPolyBin(Double_t x, Double_t y)
+{
+   if (fUseQuadTree) {
+      if (!fBins) return 0;
+      if (!fQuadTree) {
+         fQuadTree = new TH2PolyQuadTree(fBins, fXaxis.GetXmin(), fXaxis.GetXmax(),
+                                         fYaxis.GetXmin(), fYaxis.GetXmax());
+      }
+      return fQuadTree->FindBin(x, y);
+   }
+
    // Finds the cell (x,y) coordinates belong to
    Int_t n = (Int_t)(floor((x-fXaxis.GetXmin())/fStepX));
    Int_t m = (Int_t)(floor((y-fYaxis.GetXmin())/fStepY));
@@ -556,21 +713,38 @@ Int_t TH2Poly::FindBin(Double_t x, Double_t y, Double_t)
    if (n<0)       n = 0;
    if (m<0)       m = 0;
 
-   if (fIsEmpty[n+fCellX*m]) return -5;
+   if (fIsEmpty[n+fCellX*m]) return 0;
 
    TH2PolyBin *bin;
 
    TIter next(&fCells[n+fCellX*m]);
    TObject *obj;
 
-   // Search for the bin in the cell
+   // Search for the bin in the cell, testing first its bounding box
    while ((obj=next())) {
       bin  = (TH2PolyBin*)obj;
-      if (bin->IsInside(x,y)) return bin->GetBinNumber();
+      if (x < bin->GetXMin() || x > bin->GetXMax() ||
+          y < bin->GetYMin() || y > bin->GetYMax()) continue;
+      if (bin->IsInside(x,y)) return bin;
    }
 
-   // If the search has not returned a bin, the point must be on "the sea"
-   return -5;
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// When flag is kTRUE, Fill() and FindBin() find the bins with a quadtree of
+/// their bounding boxes instead of the partition cells. This is faster when
+/// the histogram has many bins, or bins of very different sizes. The
+/// quadtree is transient: it is built by the first Fill() or FindBin()
+/// following the addition of bins, and is not written with the histogram.
+
+void TH2Poly::SetUseQuadTree(Bool_t flag)
+{
+   fUseQuadTree = flag;
+   if (!flag) {
+      delete fQuadTree;
+      fQuadTree = 0;
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -600,50 +774,27 @@ Int_t TH2Poly::Fill(Double_t x, Double_t y, Double_t w)
       return overflow;
    }
 
-   // Finds the cell (x,y) coordinates belong to
-   Int_t n = (Int_t)(floor((x-fXaxis.GetXmin())/fStepX));
-   Int_t m = (Int_t)(floor((y-fYaxis.GetXmin())/fStepY));
-
-   // Make sure the array indices are correct.
-   if (n>=fCellX) n = fCellX-1;
-   if (m>=fCellY) m = fCellY-1;
-   if (n<0)       n = 0;
-   if (m<0)       m = 0;
-
-   if (fIsEmpty[n+fCellX*m]) {
+   TH2PolyBin *bin = FindPolyBin(x, y);
+   if (!bin) {
       fOverflow[4]++;
       return -5;
    }
 
-   TH2PolyBin *bin;
-   Int_t bi;
-
-   TIter next(&fCells[n+fCellX*m]);
-   TObject *obj;
-
-   while ((obj=next())) {
-      bin  = (TH2PolyBin*)obj;
-      bi = bin->GetBinNumber()-1;
-      if (bin->IsInside(x,y)) {
-         bin->Fill(w);
-
-         // Statistics
-         fTsumw   = fTsumw + w;
-         fTsumwx  = fTsumwx + w*x;
-         fTsumwx2 = fTsumwx2 + w*x*x;
-         fTsumwy  = fTsumwy + w*y;
-         fTsumwy2 = fTsumwy2 + w*y*y;
-         if (fSumw2.fN) fSumw2.fArray[bi] += w*w;
-         fEntries++;
+   Int_t bi = bin->GetBinNumber()-1;
+   bin->Fill(w);
 
-         SetBinContentChanged(kTRUE);
+   // Statistics
+   fTsumw   = fTsumw + w;
+   fTsumwx  = fTsumwx + w*x;
+   fTsumwx2 = fTsumwx2 + w*x*x;
+   fTsumwy  = fTsumwy + w*y;
+   fTsumwy2 = fTsumwy2 + w*y*y;
+   if (fSumw2.fN) fSumw2.fArray[bi] += w*w;
+   fEntries++;
 
-         return bin->GetBinNumber();
-      }
-   }
+   SetBinContentChanged(kTRUE);
 
-   fOverflow[4]++;
-   return -5;
+   return bin->GetBinNumber();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -677,14 +828,15 @@ Int_t TH2Poly::Fill(const char* name, Double_t w)
 ///                      (array size must be ntimes*stride)
 /// \param [in] x:       array of x values to be histogrammed
 /// \param [in] y:       array of y values to be histogrammed
-/// \param [in] w:       array of weights
+/// \param [in] w:       array of weights, or 0 to fill with weight 1
 /// \param [in] stride:  step size through arrays x, y and w
 
 void TH2Poly::FillN(Int_t ntimes, const Double_t* x, const Double_t* y,
                                const Double_t* w, Int_t stride)
 {
+   ntimes *= stride;
    for (int i = 0; i < ntimes; i += stride) {
-      Fill(x[i], y[i], w[i]);
+      Fill(x[i], y[i], w ? w[i] : 1.);
    }
 }
 
@@ -967,6 +1119,9 @@ void TH2Poly::Initialize(Double_t xlow, Double_t xup,
    // 3D Painter flags
    SetNewBinAdded(kFALSE);
    SetBinContentChanged(kFALSE);
+
+   fUseQuadTree = kFALSE;
+   fQuadTree    = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
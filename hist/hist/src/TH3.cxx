@@ -641,6 +641,115 @@ Int_t TH3::Fill(Double_t x, Double_t y, const char *namez, Double_t w)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a 3-D histogram with an array of values and weights.
+///
+///  - ntimes:  number of entries in arrays x, y, z and w (array size must be ntimes*stride)
+///  - x:       array of x values to be histogrammed
+///  - y:       array of y values to be histogrammed
+///  - z:       array of z values to be histogrammed
+///  - w:       array of weights
+///  - stride:  step size through arrays x, y, z and w
+///
+///   - If the weight is not equal to 1, the storage of the sum of squares of
+///     weights is automatically triggered and the sum of the squares of weights is incremented
+///     by w[i]^2 in the bin corresponding to x[i],y[i],z[i].
+///   - If w is NULL each entry is assumed a weight=1
+///
+/// The bins are found kNFillChunk entries at a time, as in TH1::DoFillN,
+/// unless an axis can be extended.
+
+void TH3::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *w, Int_t stride)
+{
+   Int_t bin, i;
+   ntimes *= stride;
+   Int_t ifirst = 0;
+
+   //If a buffer is activated, fill buffer
+   if (fBuffer) {
+      for (i=0;i<ntimes;i+=stride) {
+         if (!fBuffer) break; // buffer can be deleted in BufferFill when is empty
+         BufferFill(x[i], y[i], z[i], w ? w[i] : 1.);
+      }
+      // fill the remaining entries if the buffer has been deleted
+      if (i < ntimes && fBuffer==0)
+         ifirst = i;
+      else
+         return;
+   }
+
+   if ((fXaxis.CanExtend() && !fXaxis.IsAlphanumeric()) || (fYaxis.CanExtend() && !fYaxis.IsAlphanumeric()) ||
+       (fZaxis.CanExtend() && !fZaxis.IsAlphanumeric())) {
+      for (i=ifirst;i<ntimes;i+=stride)
+         Fill(x[i], y[i], z[i], w ? w[i] : 1.);
+      return;
+   }
+
+   x += ifirst;
+   y += ifirst;
+   z += ifirst;
+   if (w) w += ifirst;
+   Int_t nentries = (ntimes - ifirst + stride - 1)/stride;
+   fEntries += nentries;
+   DoFillNSumw2(nentries, w, stride);
+   const Int_t nx = fXaxis.GetNbins();
+   const Int_t ny = fYaxis.GetNbins();
+   const Int_t nz = fZaxis.GetNbins();
+   const Bool_t statOverflows = fgStatOverflows;
+   Double_t sumw = 0, sumw2 = 0, sumwx = 0, sumwx2 = 0, sumwy = 0, sumwy2 = 0, sumwxy = 0;
+   Double_t sumwz = 0, sumwz2 = 0, sumwxz = 0, sumwyz = 0;
+   Double_t ww = 1;
+   Int_t binsx[kNFillChunk], binsy[kNFillChunk], binsz[kNFillChunk];
+   for (Int_t first = 0; first < nentries; first += kNFillChunk) {
+      const Int_t n = TMath::Min(nentries - first, (Int_t) kNFillChunk);
+      const Double_t *xc = x + first*stride;
+      const Double_t *yc = y + first*stride;
+      const Double_t *zc = z + first*stride;
+      const Double_t *wc = w ? w + first*stride : 0;
+      fXaxis.FindFixBinN(n, xc, binsx, stride);
+      fYaxis.FindFixBinN(n, yc, binsy, stride);
+      fZaxis.FindFixBinN(n, zc, binsz, stride);
+      for (i = 0; i < n; ++i) {
+         if (wc) ww = wc[i*stride];
+         bin = binsx[i] + (nx+2)*(binsy[i] + (ny+2)*binsz[i]);
+         if (fSumw2.fN) fSumw2.fArray[bin] += ww*ww;
+         AddBinContent(bin,ww);
+      }
+      for (i = 0; i < n; ++i) {
+         const Bool_t use = statOverflows ||
+                            (binsx[i] > 0 && binsx[i] <= nx && binsy[i] > 0 && binsy[i] <= ny &&
+                             binsz[i] > 0 && binsz[i] <= nz);
+         const Double_t v  = use ? (wc ? wc[i*stride] : 1.) : 0;
+         const Double_t xi = use ? xc[i*stride] : 0;
+         const Double_t yi = use ? yc[i*stride] : 0;
+         const Double_t zi = use ? zc[i*stride] : 0;
+         sumw   += v;
+         sumw2  += v*v;
+         sumwx  += v*xi;
+         sumwx2 += v*xi*xi;
+         sumwy  += v*yi;
+         sumwy2 += v*yi*yi;
+         sumwxy += v*xi*yi;
+         sumwz  += v*zi;
+         sumwz2 += v*zi*zi;
+         sumwxz += v*xi*zi;
+         sumwyz += v*yi*zi;
+      }
+   }
+   fTsumw   += sumw;
+   fTsumw2  += sumw2;
+   fTsumwx  += sumwx;
+   fTsumwx2 += sumwx2;
+   fTsumwy  += sumwy;
+   fTsumwy2 += sumwy2;
+   fTsumwxy += sumwxy;
+   fTsumwz  += sumwz;
+   fTsumwz2 += sumwz2;
+   fTsumwxz += sumwxz;
+   fTsumwyz += sumwyz;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill histogram following distribution in function fname.
 ///
@@ -319,9 +319,9 @@ ULong64_t THnSparseCoordCompression::GetHashFromBuffer(const Char_t* buf) const
 {
    // Bins are addressed in two different modes, depending
    // on whether the compact bin index fits into a Long64_t or not.
-   // If it does, we can use it as a "perfect hash" for the TExMap.
+   // If it does, we can use it as a "perfect hash" for fBinTable.
    // If not we build a hash from the compact bin index, and use that
-   // as the TExMap's hash.
+   // as the hash of fBinTable.
 
    if (fCoordBufferSize <= 8) {
       // fits into a Long64_t
@@ -571,14 +571,16 @@ Translation from an n-dimensional bin coordinate to the linear index within
 the chunks is done by GetBin(). It creates a hash from the compacted bin
 coordinates (the hash of a bin coordinate is the compacted coordinate itself
 if it takes less than 8 bytes, the size of a Long64_t.
-This hash is used to lookup the linear index in the TExMap member fBins;
-the coordinates of the entry fBins points to is compared to the coordinates
-passed to GetBin(). If they do not match, these two coordinates have the same
-hash - which is extremely unlikely but (for the case where the compact bin
-coordinates are larger than 4 bytes) possible. In this case, fBinsContinued
-contains a chain of linear indexes with the same hash. Iterating through this
-chain and comparing each bin coordinates with the one passed to GetBin() will
-retrieve the matching bin.
+This hash is used to lookup the linear index in the open-addressing hash
+table fBinTable, which holds pairs of (hash, linear index + 1) and is kept
+at most half full: the slot of a hash is derived from its bits, and the
+following slots are probed until the hash is found or an empty slot is
+reached. The hash and the index of a bin are stored next to each other, so
+that a lookup usually reads a single cache line, and the chunks are only
+accessed to compare the coordinates when the hashes match but the compact
+coordinates are larger than 8 bytes: two coordinates have then the same
+hash - which is extremely unlikely but possible - and probing continues to
+the next slot holding the same hash.
 */
 
 
@@ -650,8 +652,89 @@ void THnSparse::InitStorage(Int_t* nbins, Int_t chunkSize)
    fCompactCoord = new THnSparseCompactBinCoord(fNdimensions, nbins);
 }
 
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Spread the bits of a hash of THnSparseCoordCompression (the compact
+/// coordinate itself if it fits in 8 bytes) over all the bits, so that the
+/// low bits can be used as the slot of fBinTable.
+
+inline ULong64_t MixHash(ULong64_t h)
+{
+   h ^= h >> 33;
+   h *= 0xff51afd7ed558ccdULL;
+   h ^= h >> 33;
+   return h;
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the index of the bin with the given hash and compact coordinate
+/// buffer, or -1 if it is not filled; slot is set to the slot of fBinTable
+/// holding the bin, or else to the empty slot where it can be added.
+/// fBinTable must not be empty.
+
+Long64_t THnSparse::FindBinIndex(ULong64_t hash, const Char_t* buf, ULong64_t& slot) const
+{
+   const ULong64_t mask = fBinTable.size() / 2 - 1;
+   const ULong64_t* table = &fBinTable[0];
+   slot = MixHash(hash) & mask;
+   while (table[2 * slot + 1]) {
+      if (table[2 * slot] == hash) {
+         // fBinTable stores index + 1, 0 is an empty slot
+         Long64_t idx = (Long64_t) table[2 * slot + 1] - 1;
+         if (GetChunk(idx / fChunkSize)->Matches(idx % fChunkSize, buf))
+            return idx;
+      }
+      slot = (slot + 1) & mask;
+   }
+   return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the bin of linear index idx with the given hash to fBinTable, which
+/// must not contain it yet.
+
+void THnSparse::AddBinIndex(ULong64_t hash, Long64_t idx)
+{
+   if (fBinTable.size() < (ULong64_t) 4 * (idx + 1))
+      ResizeBinTable(idx + 1);
+   const ULong64_t mask = fBinTable.size() / 2 - 1;
+   ULong64_t slot = MixHash(hash) & mask;
+   while (fBinTable[2 * slot + 1])
+      slot = (slot + 1) & mask;
+   fBinTable[2 * slot] = hash;
+   fBinTable[2 * slot + 1] = idx + 1;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
-///We have been streamed; set up fBins
+/// Resize fBinTable to hold at least nbins bins while being at most half full,
+/// by a power of 2 larger than the current size, and move the bins in it.
+
+void THnSparse::ResizeBinTable(Long64_t nbins)
+{
+   ULong64_t nslots = fBinTable.size() / 2;
+   if (nslots < 1024) nslots = 1024;
+   while (nslots < (ULong64_t) 2 * nbins)
+      nslots *= 2;
+   if (nslots == fBinTable.size() / 2) return;
+
+   std::vector<ULong64_t> old(2 * nslots, 0);
+   old.swap(fBinTable);
+   const ULong64_t mask = nslots - 1;
+   for (size_t i = 0; i < old.size(); i += 2) {
+      if (!old[i + 1]) continue;
+      ULong64_t slot = MixHash(old[i]) & mask;
+      while (fBinTable[2 * slot + 1])
+         slot = (slot + 1) & mask;
+      fBinTable[2 * slot] = old[i];
+      fBinTable[2 * slot + 1] = old[i + 1];
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///We have been streamed; set up fBinTable
 
 void THnSparse::FillExMap()
 {
@@ -659,28 +742,15 @@ void THnSparse::FillExMap()
    THnSparseArrayChunk* chunk = 0;
    THnSparseCoordCompression compactCoord(*GetCompactCoord());
    Long64_t idx = 0;
-   if (2 * GetNbins() > fBins.Capacity())
-      fBins.Expand(3 * GetNbins());
+   fBinTable.clear();
+   ResizeBinTable(GetNbins());
    while ((chunk = (THnSparseArrayChunk*) iChunk())) {
       const Int_t chunkSize = chunk->GetEntries();
       Char_t* buf = chunk->fCoordinates;
       const Int_t singleCoordSize = chunk->fSingleCoordinateSize;
       const Char_t* endbuf = buf + singleCoordSize * chunkSize;
-      for (; buf < endbuf; buf += singleCoordSize, ++idx) {
-         Long64_t hash = compactCoord.GetHashFromBuffer(buf);
-         Long64_t linidx = fBins.GetValue(hash);
-         if (linidx) {
-            Long64_t nextidx = linidx;
-            while (nextidx) {
-               // must be a collision, so go to fBinsContinued.
-               linidx = nextidx;
-               nextidx = fBinsContinued.GetValue(linidx);
-            }
-            fBinsContinued.Add(linidx, idx + 1);
-         } else {
-            fBins.Add(hash, idx + 1);
-         }
-      }
+      for (; buf < endbuf; buf += singleCoordSize, ++idx)
+         AddBinIndex(compactCoord.GetHashFromBuffer(buf), idx);
    }
 }
 
@@ -688,12 +758,10 @@ void THnSparse::FillExMap()
 /// Initialize storage for nbins
 
 void THnSparse::Reserve(Long64_t nbins) {
-   if (!fBins.GetSize() && fBinContent.GetSize()) {
+   if (fBinTable.empty() && GetNbins()) {
       FillExMap();
    }
-   if (2 * nbins > fBins.Capacity()) {
-      fBins.Expand(3 * nbins);
-   }
+   ResizeBinTable(nbins);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -712,6 +780,52 @@ Long64_t THnSparse::GetBin(const Double_t* x, Bool_t allocate /* = kTRUE */)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the nEntries points of x, which holds the GetNdimensions()
+/// coordinates of each point one after the other, with the weights w (1 if
+/// w is 0), as Fill(x + i * GetNdimensions(), w[i]) for each point.
+///
+/// The points are processed in blocks: the compact coordinates and the
+/// hashes of all the points of a block are computed first, and the slots of
+/// fBinTable where their lookup starts are prefetched, so that the memory
+/// accesses of the lookups of a block overlap instead of waiting for each
+/// other; this is what limits the filling of a histogram with many filled
+/// bins.
+
+void THnSparse::FillN(Int_t nEntries, const Double_t* x, const Double_t* w /*= 0*/)
+{
+   const Int_t kBlock = 16;
+   THnSparseCompactBinCoord* cc = GetCompactCoord();
+   const Int_t bufSize = cc->GetBufferSize();
+   std::vector<Char_t> bufs(kBlock * bufSize);
+   ULong64_t hashes[kBlock];
+   if (fBinTable.empty())
+      Reserve(GetNbins());
+
+   for (Int_t first = 0; first < nEntries; first += kBlock) {
+      const Int_t n = TMath::Min(kBlock, nEntries - first);
+      const ULong64_t mask = fBinTable.size() / 2 - 1;
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t* xi = x + (Long64_t)(first + i) * fNdimensions;
+         Int_t *coord = cc->GetCoord();
+         for (Int_t d = 0; d < fNdimensions; ++d)
+            coord[d] = GetAxis(d)->FindBin(xi[d]);
+         cc->UpdateCoord();
+         hashes[i] = cc->GetHash();
+         memcpy(&bufs[i * bufSize], cc->GetBuffer(), bufSize);
+#if defined(__GNUC__)
+         __builtin_prefetch(&fBinTable[2 * (MixHash(hashes[i]) & mask)]);
+#endif
+      }
+      for (Int_t i = 0; i < n; ++i) {
+         const Double_t* xi = x + (Long64_t)(first + i) * fNdimensions;
+         const Double_t wi = w ? w[first + i] : 1.;
+         UpdateXStat(xi, wi);
+         FillBin(GetBinIndex(hashes[i], &bufs[i * bufSize], kTRUE), wi);
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Get the bin index for the n dimensional tuple addressed by "name",
 /// allocate one if it doesn't exist yet and "allocate" is true.
@@ -790,22 +904,25 @@ Double_t THnSparse::GetBinError2(Long64_t linidx) const {
 Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
 {
    THnSparseCompactBinCoord* cc = GetCompactCoord();
-   ULong64_t hash = cc->GetHash();
-   if (fBinContent.GetSize() && !fBins.GetSize())
-      FillExMap();
-   Long64_t linidx = (Long64_t) fBins.GetValue(hash);
-   while (linidx) {
-      // fBins stores index + 1!
-      THnSparseArrayChunk* chunk = GetChunk((linidx - 1)/ fChunkSize);
-      if (chunk->Matches((linidx - 1) % fChunkSize, cc->GetBuffer()))
-         return linidx - 1; // we store idx+1, 0 is "TExMap: not found"
+   return GetBinIndex(cc->GetHash(), cc->GetBuffer(), allocate);
+}
 
-      Long64_t nextlinidx = fBinsContinued.GetValue(linidx);
-      if (!nextlinidx) break;
+////////////////////////////////////////////////////////////////////////////////
+/// Return the index of the bin with the given hash and compact coordinate
+/// buffer. If it doesn't exist then return -1, or allocate a new bin if
+/// allocate is set
 
-      linidx = nextlinidx;
+Long64_t THnSparse::GetBinIndex(ULong64_t hash, const Char_t* buf, Bool_t allocate)
+{
+   if (fBinTable.empty()) {
+      if (GetNbins())
+         FillExMap();
+      else
+         ResizeBinTable(1);
    }
-   if (!allocate) return -1;
+   ULong64_t slot = 0;
+   Long64_t linidx = FindBinIndex(hash, buf, slot);
+   if (linidx >= 0 || !allocate) return linidx;
 
    ++fFilledBins;
 
@@ -816,19 +933,16 @@ Long64_t THnSparse::GetBinIndexForCurrentBin(Bool_t allocate)
       chunk = AddChunk();
       newidx = 0;
    }
-   chunk->AddBin(newidx, cc->GetBuffer());
+   chunk->AddBin(newidx, buf);
 
-   // store translation between hash and bin
+   // store translation between hash and bin, in the empty slot found above
+   // unless the table must grow
    newidx += (fBinContent.GetEntriesFast() - 1) * fChunkSize;
-   if (!linidx) {
-      // fBins didn't find it
-      if (2 * GetNbins() > fBins.Capacity())
-         fBins.Expand(3 * GetNbins());
-      fBins.Add(hash, newidx + 1);
+   if (fBinTable.size() < (ULong64_t) 4 * (newidx + 1)) {
+      AddBinIndex(hash, newidx);
    } else {
-      // fBins contains one, but it's the wrong one;
-      // add entry to fBinsContinued.
-      fBinsContinued.Add(linidx, newidx + 1);
+      fBinTable[2 * slot] = hash;
+      fBinTable[2 * slot + 1] = newidx + 1;
    }
    return newidx;
 }
@@ -881,7 +995,7 @@ Double_t THnSparse::GetSparseFractionMem() const {
 
    Double_t size = 0.;
    size += fBinContent.GetEntries() * (GetChunkSize() * sizePerChunkElement + sizeof(THnSparseArrayChunk));
-   size += + 3 * sizeof(Long64_t) * fBins.GetSize() /* TExMap */;
+   size += sizeof(ULong64_t) * fBinTable.size() /* fBinTable */;
 
    Double_t nbinsTotal = 1.;
    for (Int_t d = 0; d < fNdimensions; ++d)
@@ -963,8 +1077,7 @@ void THnSparse::Sumw2()
 void THnSparse::Reset(Option_t *option /*= ""*/)
 {
    fFilledBins = 0;
-   fBins.Delete();
-   fBinsContinued.Clear();
+   std::vector<ULong64_t>().swap(fBinTable);
    fBinContent.Delete();
    ResetBase(option);
 }
@@ -22,6 +22,14 @@
  
  The algorithm is briefly described in (4). A binned version is also implemented to address the 
  performance issue due to its data size dependance.
+
+ Evaluating the estimate costs a sum over all the events (or bins). When it is evaluated at many
+ points, for drawing or integrating it, SetEvaluationGrid(nGrid) computes the density once at nGrid
+ equidistant points covering the data and the kernels, and interpolates linearly between them. With
+ a fixed bandwidth the grid is obtained by binning the data linearly on the grid and convolving them
+ with the kernel through TVirtualFFT (a direct convolution is used if no FFT library is available);
+ with adaptive bandwidths it is computed point by point. GetGridError() compares the interpolated
+ density with the exact one.
  */
 
 
@@ -41,6 +49,7 @@
 #include "TF1.h"
 #include "TH1.h"
 #include "TCanvas.h"
+#include "TVirtualFFT.h"
 #include "TKDE.h"
 
 
@@ -142,6 +151,9 @@ void TKDE::Instantiate(KernelFunction_Ptr kernfunc, UInt_t events, const Double_
    fCanonicalBandwidths = std::vector<Double_t>(kTotalKernels, 0.0);
    fKernelSigmas2 = std::vector<Double_t>(kTotalKernels, -1.0);
    fSettedOptions = std::vector<Bool_t>(4, kFALSE);
+   fNGrid = 0;
+   fGridXMin = 0;
+   fGridStep = 0;
    SetOptions(option, rho);
    CheckOptions(kTRUE);
    SetMirror();
@@ -401,6 +413,19 @@ void TKDE::SetTuneFactor(Double_t rho) {
    SetKernel();
 }
 
+void TKDE::SetEvaluationGrid(UInt_t nGrid) {
+   // Sets the number of points of the grid from which the density is interpolated.
+   // The grid is computed at the first evaluation, and again whenever the kernel changes.
+   // The density outside the grid, and for nGrid = 0 (the default) everywhere, is computed
+   // exactly by summing the kernels of all events (or bins).
+   if (nGrid == 1) {
+      Warning("SetEvaluationGrid", "The grid needs at least 2 points - use the exact evaluation");
+      nGrid = 0;
+   }
+   fNGrid = nGrid;
+   fGrid.clear();
+}
+
 void TKDE::SetRange(Double_t xMin, Double_t xMax) {
    // Sets minimum range value and maximum range value
    if (xMin >= xMax) {
@@ -541,6 +566,7 @@ void TKDE::SetSigma(Double_t R) {
 
 void TKDE::SetKernel() {
    // Sets the kernel density estimator
+   fGrid.clear();
    UInt_t n = fData.size();
    if (n == 0) return;
    // Optimal bandwidth (Silverman's rule of thumb with assumed Gaussian density)
@@ -669,9 +695,139 @@ Double_t TKDE::operator()(const Double_t* x, const Double_t*) const {
 Double_t TKDE::operator()(Double_t x) const {
    // The class's unary function: returns the kernel density estimate
    if (fNewData) (const_cast<TKDE*>(this))->InitFromNewData();
+   if (fNGrid) {
+      if (fGrid.empty()) (const_cast<TKDE*>(this))->SetGrid();
+      Double_t t = (x - fGridXMin) / fGridStep;
+      if (t >= 0 && t < fGrid.size() - 1) {
+         UInt_t j = UInt_t(t);
+         t -= j;
+         return (1. - t) * fGrid[j] + t * fGrid[j + 1];
+      }
+   }
    return (*fKernel)(x);
 }
 
+void TKDE::SetGrid() {
+   // Computes the density at the fNGrid points of the evaluation grid. The grid covers the
+   // events (or bins), their images for the asymmetric mirroring, and the range of their kernels,
+   // which are assumed to vanish beyond 9 bandwidths (1 for the kernels with a finite support).
+   fGrid.clear();
+   UInt_t n = fData.size();
+   if (!fKernel || n == 0 || fNGrid < 2) return;
+   Bool_t useBins = (fBinCount.size() == n);
+   Double_t nSum = (useBins) ? fSumOfCounts : fNEvents;
+
+   // Kernel centres and counts, the images of the asymmetric mirroring being subtracted
+   std::vector<Double_t> centres;
+   std::vector<Double_t> counts;
+   for (UInt_t i = 0; i < n; ++i) {
+      Double_t binCount = (useBins) ? fBinCount[i] : 1.0;
+      centres.push_back(fData[i]);
+      counts.push_back(binCount);
+      if (fAsymLeft) {
+         centres.push_back(2. * fXMin - fData[i]);
+         counts.push_back(-binCount);
+      }
+      if (fAsymRight) {
+         centres.push_back(2. * fXMax - fData[i]);
+         counts.push_back(-binCount);
+      }
+   }
+   const std::vector<Double_t> &weights = fKernel->GetAdaptiveWeights();
+   Double_t maxWeight = *std::max_element(weights.begin(), weights.end());
+   Double_t support = (fKernelType == kEpanechnikov || fKernelType == kBiweight || fKernelType == kCosineArch) ? 1. : 9.;
+   Double_t xmin = *std::min_element(centres.begin(), centres.end()) - support * maxWeight;
+   Double_t xmax = *std::max_element(centres.begin(), centres.end()) + support * maxWeight;
+   if (!(xmax > xmin)) return;
+
+   fGridXMin = xmin;
+   fGridStep = (xmax - xmin) / (fNGrid - 1);
+   std::vector<Double_t> grid(fNGrid, 0.0);
+
+   if (fIteration == kAdaptive) {
+      // The bandwidth depends on the event: no convolution
+      for (UInt_t j = 0; j < fNGrid; ++j)
+         grid[j] = (*fKernel)(xmin + j * fGridStep);
+      fGrid.swap(grid);
+      return;
+   }
+
+   // Linear binning of the kernel centres on the grid
+   std::vector<Double_t> gridCounts(fNGrid, 0.0);
+   for (UInt_t i = 0; i < centres.size(); ++i) {
+      Double_t t = (centres[i] - xmin) / fGridStep;
+      Int_t j = std::min(std::max(Int_t(t), 0), Int_t(fNGrid) - 2);
+      t -= j;
+      gridCounts[j] += (1. - t) * counts[i];
+      gridCounts[j + 1] += t * counts[i];
+   }
+
+   // Kernel sampled on the grid, from -nk to nk steps
+   Double_t weight = fKernel->GetFixedWeight();
+   Int_t nk = std::min(Int_t(std::ceil(support * weight / fGridStep)), Int_t(fNGrid) - 1);
+   std::vector<Double_t> kernel(2 * nk + 1);
+   for (Int_t k = -nk; k <= nk; ++k)
+      kernel[k + nk] = (*fKernelFunction)(k * fGridStep / weight) / weight;
+
+   // Convolution through FFT, of length at least fNGrid + nk to avoid the wrap around
+   Int_t nfft = 1;
+   while (nfft < Int_t(fNGrid) + nk) nfft *= 2;
+   TVirtualFFT *fftCounts = TVirtualFFT::FFT(1, &nfft, "R2C K");
+   TVirtualFFT *fftKernel = fftCounts ? TVirtualFFT::FFT(1, &nfft, "R2C K") : 0;
+   TVirtualFFT *fftInverse = fftKernel ? TVirtualFFT::FFT(1, &nfft, "C2R K") : 0;
+   if (fftInverse) {
+      for (Int_t i = 0; i < nfft; ++i) {
+         fftCounts->SetPoint(i, i < Int_t(fNGrid) ? gridCounts[i] : 0.);
+         Int_t k = (i <= nk) ? i : i - nfft; // kernel index, stored circularly
+         fftKernel->SetPoint(i, (k >= -nk) ? kernel[k + nk] : 0.);
+      }
+      fftCounts->Transform();
+      fftKernel->Transform();
+      Double_t re1, im1, re2, im2;
+      for (Int_t i = 0; i <= nfft / 2; ++i) {
+         fftCounts->GetPointComplex(i, re1, im1);
+         fftKernel->GetPointComplex(i, re2, im2);
+         fftInverse->SetPoint(i, re1 * re2 - im1 * im2, re1 * im2 + re2 * im1);
+      }
+      fftInverse->Transform();
+      for (UInt_t j = 0; j < fNGrid; ++j)
+         grid[j] = fftInverse->GetPointReal(j) / nfft;
+   } else {
+      Warning("SetGrid", "Cannot use FFT, probably FFTW package is not available. Switch to direct convolution");
+      for (Int_t j = 0; j < Int_t(fNGrid); ++j) {
+         Int_t kmin = std::max(-nk, j - Int_t(fNGrid) + 1);
+         Int_t kmax = std::min(nk, j);
+         for (Int_t k = kmin; k <= kmax; ++k)
+            grid[j] += gridCounts[j - k] * kernel[k + nk];
+      }
+   }
+   delete fftCounts;
+   delete fftKernel;
+   delete fftInverse;
+
+   for (UInt_t j = 0; j < fNGrid; ++j)
+      grid[j] /= nSum;
+   fGrid.swap(grid);
+}
+
+Double_t TKDE::GetGridError(UInt_t npx, Double_t xMin, Double_t xMax) const {
+   // Returns the largest difference between the density interpolated from the evaluation grid
+   // and the exact density, at npx + 1 points between xMin and xMax (the data range by default),
+   // relative to the largest exact density at these points. Returns 0 without evaluation grid.
+   if (fNewData) (const_cast<TKDE*>(this))->InitFromNewData();
+   if (!fNGrid || !fKernel || !npx) return 0.;
+   if (xMin >= xMax) { xMin = fXMin; xMax = fXMax; }
+   Double_t maxDiff = 0.;
+   Double_t maxValue = 0.;
+   for (UInt_t i = 0; i <= npx; ++i) {
+      Double_t x = xMin + i * (xMax - xMin) / npx;
+      Double_t exact = (*fKernel)(x);
+      maxDiff = std::max(maxDiff, std::abs((*this)(x) - exact));
+      maxValue = std::max(maxValue, std::abs(exact));
+   }
+   return (maxValue > 0) ? maxDiff / maxValue : maxDiff;
+}
+
 Double_t TKDE::GetMean() const {
    // return the mean of the data
    if (fNewData) (const_cast<TKDE*>(this))->InitFromNewData();
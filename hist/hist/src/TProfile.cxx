@@ -748,7 +748,15 @@ Int_t TProfile::Fill(const char *namex, Double_t y, Double_t w)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Fill a Profile histogram with weights.
+/// Fill a Profile histogram with the ntimes entries x[0], x[stride], ...
+/// of values y[0], y[stride], ... and weights w[0], w[stride], ... (1 if w
+/// is null).
+///
+/// Unless the axis can be extended, the bins of the entries are found in
+/// blocks and the statistics summed once for all the entries, see
+/// TProfileHelper::FillN. With the implicit multi-threading enabled a large
+/// number of entries is filled in parallel, each task summing its entries
+/// into its own arrays of bin sums.
 
 void TProfile::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *w, Int_t stride)
 {
@@ -770,6 +778,20 @@ void TProfile::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const D
          return;
    }
 
+   if (!fXaxis.CanExtend() || fXaxis.IsAlphanumeric()) {
+      const Double_t *xs[1] = { x + ifirst };
+      Double_t stats[TProfileHelper::kNFillStats] = {0};
+      TProfileHelper::FillN(this, (ntimes-ifirst)/stride, xs, y + ifirst, w ? w + ifirst : 0, stride,
+                            fYmin, fYmax, stats);
+      fTsumw   += stats[TProfileHelper::kSumw];
+      fTsumw2  += stats[TProfileHelper::kSumw2];
+      fTsumwx  += stats[TProfileHelper::kSumwx];
+      fTsumwx2 += stats[TProfileHelper::kSumwx2];
+      fTsumwy  += stats[TProfileHelper::kSumwv];
+      fTsumwy2 += stats[TProfileHelper::kSumwv2];
+      return;
+   }
+
    for (i=ifirst;i<ntimes;i+=stride) {
       if (fYmin != fYmax) {
          if (y[i] <fYmin || y[i]> fYmax || TMath::IsNaN(y[i])) continue;
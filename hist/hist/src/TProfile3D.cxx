@@ -639,7 +639,7 @@ Int_t TProfile3D::Fill(Double_t x, Double_t y, Double_t z, Double_t t, Double_t
    Int_t bin,binx,biny,binz;
 
    if (fTmin != fTmax) {
-      if (t <fTmin || z> fTmax || TMath::IsNaN(t) ) return -1;
+      if (t <fTmin || t> fTmax || TMath::IsNaN(t) ) return -1;
    }
 
    Double_t u= w; // (w > 0 ? w : -w);
@@ -679,6 +679,61 @@ Int_t TProfile3D::Fill(Double_t x, Double_t y, Double_t z, Double_t t, Double_t
    return bin;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a Profile3D histogram with the ntimes entries (x[0],y[0],z[0]),
+/// (x[stride],y[stride],z[stride]), ... of values t[0], t[stride], ... and
+/// weights w[0], w[stride], ... (1 if w is null).
+///
+/// Unless one of the axes can be extended, the bins of the entries are found
+/// in blocks and the statistics summed once for all the entries, see
+/// TProfileHelper::FillN. With the implicit multi-threading enabled a large
+/// number of entries is filled in parallel, each task summing its entries
+/// into its own arrays of bin sums.
+
+void TProfile3D::FillN(Int_t ntimes, const Double_t *x, const Double_t *y, const Double_t *z, const Double_t *t,
+                       const Double_t *w, Int_t stride)
+{
+   Int_t i;
+   ntimes *= stride;
+   Int_t ifirst = 0;
+   //If a buffer is activated, fill buffer
+   if (fBuffer) {
+      for (i=0;i<ntimes;i+=stride) {
+         if (!fBuffer) break; // buffer can be deleted in BufferFill when is empty
+         BufferFill(x[i],y[i],z[i],t[i],w ? w[i] : 1.);
+      }
+      // fill the remaining entries if the buffer has been deleted
+      if (i < ntimes && fBuffer==0)
+         ifirst = i;  // start from i
+      else
+         return;
+   }
+
+   if ((fXaxis.CanExtend() && !fXaxis.IsAlphanumeric()) || (fYaxis.CanExtend() && !fYaxis.IsAlphanumeric()) ||
+       (fZaxis.CanExtend() && !fZaxis.IsAlphanumeric())) {
+      for (i=ifirst;i<ntimes;i+=stride) Fill(x[i],y[i],z[i],t[i],w ? w[i] : 1.);
+      return;
+   }
+
+   const Double_t *xs[3] = { x + ifirst, y + ifirst, z + ifirst };
+   Double_t stats[TProfileHelper::kNFillStats] = {0};
+   TProfileHelper::FillN(this, (ntimes-ifirst)/stride, xs, t + ifirst, w ? w + ifirst : 0, stride,
+                         fTmin, fTmax, stats);
+   fTsumw   += stats[TProfileHelper::kSumw];
+   fTsumw2  += stats[TProfileHelper::kSumw2];
+   fTsumwx  += stats[TProfileHelper::kSumwx];
+   fTsumwx2 += stats[TProfileHelper::kSumwx2];
+   fTsumwy  += stats[TProfileHelper::kSumwy];
+   fTsumwy2 += stats[TProfileHelper::kSumwy2];
+   fTsumwxy += stats[TProfileHelper::kSumwxy];
+   fTsumwz  += stats[TProfileHelper::kSumwz];
+   fTsumwz2 += stats[TProfileHelper::kSumwz2];
+   fTsumwxz += stats[TProfileHelper::kSumwxz];
+   fTsumwyz += stats[TProfileHelper::kSumwyz];
+   fTsumwt  += stats[TProfileHelper::kSumwv];
+   fTsumwt2 += stats[TProfileHelper::kSumwv2];
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return bin content of a Profile3D histogram.
 
@@ -27,15 +27,33 @@
 #include "THashList.h"
 #include "TMath.h"
 
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
+#include <vector>
+
 class TProfileHelper {
 
 public:
+   // statistics summed by FillN, v being the profiled value
+   enum EFillStats {
+      kSumw, kSumw2, kSumwx, kSumwx2, kSumwy, kSumwy2, kSumwxy,
+      kSumwz, kSumwz2, kSumwxz, kSumwyz, kSumwv, kSumwv2, kNFillStats
+   };
+
    template <typename T>
    static Bool_t Add(T* p, const TH1 *h1,  const TH1 *h2, Double_t c1, Double_t c2=1);
 
    template <typename T>
    static void BuildArray(T* p);
 
+   template <typename T>
+   static void FillN(T* p, Int_t ntimes, const Double_t * const *x, const Double_t *v, const Double_t *w, Int_t stride,
+                     Double_t vmin, Double_t vmax, Double_t *stats);
+
    template <typename T>
    static Double_t GetBinEffectiveEntries(T* p, Int_t bin);
 
@@ -138,6 +156,132 @@ void TProfileHelper::BuildArray(T* p) {
    if (TH1::GetDefaultSumw2() || p->fBinSumw2.fN > 0 ) p->fBinSumw2.Set(p->fNcells);
 }
 
+template <typename T>
+void TProfileHelper::FillN(T* p, Int_t ntimes, const Double_t * const *x, const Double_t *v, const Double_t *w,
+                           Int_t stride, Double_t vmin, Double_t vmax, Double_t *stats)
+{
+   // Fill the profile p with ntimes entries of coordinates x[0][i*stride], ...
+   // x[dim-1][i*stride], profiled value v[i*stride] and weight w[i*stride]
+   // (1 if w is null), the entries of value outside [vmin,vmax] being skipped
+   // if vmin != vmax. The axes must not be extendable. The statistics are
+   // added to stats, of kNFillStats elements, and are left to the caller to
+   // add to the ones of p.
+   //
+   // The bins of kNFillChunk entries are found at once with TAxis::FindFixBinN,
+   // and the sums of each bin are kept in separate arrays. With the implicit
+   // multi-threading enabled a large number of entries is split into tasks,
+   // each of them summing a fixed range of entries into its own arrays, which
+   // are then added to the ones of p in the order of the tasks. The number of
+   // tasks only depends on the number of entries and of cells, so that the
+   // result does not depend on the number of threads.
+
+   if (ntimes <= 0) return;
+   const Int_t dim = p->GetDimension();
+   const TAxis *axes[3] = { &p->fXaxis, &p->fYaxis, &p->fZaxis };
+   const Int_t nx = p->fXaxis.GetNbins();
+   const Int_t ny = dim > 1 ? p->fYaxis.GetNbins() : 0;
+   const Int_t nz = dim > 2 ? p->fZaxis.GetNbins() : 0;
+   const Bool_t cut = vmin != vmax;
+   const Bool_t statOverflows = p->fgStatOverflows;
+
+   // must be called before accumulating the entries
+   if (w && !p->fBinSumw2.fN && !p->TestBit(TH1::kIsNotW)) {
+      for (Long64_t i = 0; i < (Long64_t)ntimes*stride; i += stride) {
+         if (cut && (v[i] < vmin || v[i] > vmax || TMath::IsNaN(v[i]))) continue;
+         if (w[i] != 1.0) {
+            p->Sumw2();
+            break;
+         }
+      }
+   }
+   const Bool_t binSumw2 = p->fBinSumw2.fN > 0;
+
+   auto fill = [&](Int_t first, Int_t last, Double_t *cont, Double_t *sumw2, Double_t *entries, Double_t *wsumw2,
+                   Double_t *st, Long64_t &nentries) {
+      Int_t bins[3][T::kNFillChunk];
+      for (Int_t d = dim; d < 3; ++d)
+         for (Int_t i = 0; i < T::kNFillChunk; ++i) bins[d][i] = 0;
+      for (Int_t c = first; c < last; c += T::kNFillChunk) {
+         const Int_t n = TMath::Min(last - c, (Int_t) T::kNFillChunk);
+         for (Int_t d = 0; d < dim; ++d)
+            axes[d]->FindFixBinN(n, x[d] + (Long64_t)c*stride, bins[d], stride);
+         for (Int_t i = 0; i < n; ++i) {
+            const Long64_t k = (Long64_t)(c + i)*stride;
+            const Double_t vi = v[k];
+            if (cut && (vi < vmin || vi > vmax || TMath::IsNaN(vi))) continue;
+            const Double_t u = w ? w[k] : 1;
+            const Int_t bin = bins[0][i] + (nx+2)*(bins[1][i] + (ny+2)*bins[2][i]);
+            nentries++;
+            cont[bin]    += u*vi;
+            sumw2[bin]   += u*vi*vi;
+            entries[bin] += u;
+            if (binSumw2) wsumw2[bin] += u*u;
+            if (!statOverflows) {
+               if (bins[0][i] == 0 || bins[0][i] > nx) continue;
+               if (dim > 1 && (bins[1][i] == 0 || bins[1][i] > ny)) continue;
+               if (dim > 2 && (bins[2][i] == 0 || bins[2][i] > nz)) continue;
+            }
+            const Double_t xi = x[0][k];
+            st[kSumw]   += u;
+            st[kSumw2]  += u*u;
+            st[kSumwx]  += u*xi;
+            st[kSumwx2] += u*xi*xi;
+            if (dim > 1) {
+               const Double_t yi = x[1][k];
+               st[kSumwy]  += u*yi;
+               st[kSumwy2] += u*yi*yi;
+               st[kSumwxy] += u*xi*yi;
+               if (dim > 2) {
+                  const Double_t zi = x[2][k];
+                  st[kSumwz]  += u*zi;
+                  st[kSumwz2] += u*zi*zi;
+                  st[kSumwxz] += u*xi*zi;
+                  st[kSumwyz] += u*yi*zi;
+               }
+            }
+            st[kSumwv]  += u*vi;
+            st[kSumwv2] += u*vi*vi;
+         }
+      }
+   };
+
+#ifdef R__USE_IMT
+   const Int_t ncells = p->fNcells;
+   const Int_t kMaxFillTasks = 16;
+   const Int_t ntasks = TMath::Min(kMaxFillTasks, ntimes / TMath::Max(1 << 16, 4*ncells));
+   if (ROOT::IsImplicitMTEnabled() && ntasks > 1) {
+      const Int_t step = (ntimes + ntasks - 1) / ntasks;
+      std::vector<Double_t> sums((size_t)ntasks*4*ncells, 0.);
+      std::vector<Double_t> taskStats((size_t)ntasks*kNFillStats, 0.);
+      std::vector<Long64_t> taskEntries(ntasks, 0);
+      tbb::parallel_for(0, ntasks, [&](Int_t t) {
+         Double_t *s = &sums[(size_t)t*4*ncells];
+         fill(t*step, TMath::Min(ntimes, (t+1)*step), s, s + ncells, s + 2*ncells, s + 3*ncells,
+              &taskStats[(size_t)t*kNFillStats], taskEntries[t]);
+      });
+      Double_t *arrays[4] = { p->fArray, p->fSumw2.fArray, p->fBinEntries.fArray, p->fBinSumw2.fArray };
+      const Int_t narrays = binSumw2 ? 4 : 3;
+      tbb::parallel_for(tbb::blocked_range<Int_t>(0, ncells, 16384), [&](const tbb::blocked_range<Int_t> &r) {
+         for (Int_t t = 0; t < ntasks; ++t) {
+            for (Int_t a = 0; a < narrays; ++a) {
+               const Double_t *s = &sums[((size_t)t*4 + a)*ncells];
+               for (Int_t bin = r.begin(); bin < r.end(); ++bin) arrays[a][bin] += s[bin];
+            }
+         }
+      });
+      for (Int_t t = 0; t < ntasks; ++t) {
+         for (Int_t j = 0; j < kNFillStats; ++j) stats[j] += taskStats[(size_t)t*kNFillStats + j];
+         p->fEntries += taskEntries[t];
+      }
+      return;
+   }
+#endif
+
+   Long64_t nentries = 0;
+   fill(0, ntimes, p->fArray, p->fSumw2.fArray, p->fBinEntries.fArray, p->fBinSumw2.fArray, stats, nentries);
+   p->fEntries += nentries;
+}
+
 
 template <typename T>
 Double_t TProfileHelper::GetBinEffectiveEntries(T* p, Int_t bin)
@@ -271,6 +271,12 @@
 #include <map>
 #include <vector>
 
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
 // this option saves the spline of the L curve curvature to a file
 // named splinec.ps for debugging
 
@@ -283,6 +289,73 @@
 #include <TCanvas.h>
 #endif
 
+namespace {
+
+// minimal number of multiplications of a matrix operation for it to be
+// run in parallel with the implicit multi-threading
+const Double_t kMinParallelWork = 1.E5;
+
+template<class F>
+void ForEachRange(Int_t first,Int_t last,Int_t grain,Double_t work,const F &f)
+{
+   // call f on ranges of indices covering [first,last), in parallel with
+   // the implicit multi-threading if the operation is large enough.
+   // The ranges are independent, so that the result does not depend on
+   // the number of threads
+#ifdef R__USE_IMT
+   if(ROOT::IsImplicitMTEnabled() && (last-first>grain) &&
+      (work>=kMinParallelWork)) {
+      tbb::parallel_for(tbb::blocked_range<Int_t>(first,last,grain),
+                        [&f](const tbb::blocked_range<Int_t> &r)
+                        { f(r.begin(),r.end()); });
+      return;
+   }
+#else
+   (void) grain;
+   (void) work;
+#endif
+   if(first<last) f(first,last);
+}
+
+// the non-zero elements of a sparse matrix, row by row, filled by
+// independent ranges of rows
+struct SparseRows_t {
+   std::vector<std::vector<Int_t> > fCols;
+   std::vector<std::vector<Double_t> > fData;
+   SparseRows_t(Int_t nrow) : fCols(nrow),fData(nrow) { }
+   void Add(Int_t row,Int_t col,Double_t data) {
+      fCols[row].push_back(col);
+      fData[row].push_back(data);
+   }
+   TMatrixDSparse *CreateMatrix(Int_t nrow,Int_t ncol) {
+      // pack the elements into a new matrix of dimension nrow*ncol
+      TMatrixDSparse *r=new TMatrixDSparse(nrow,ncol);
+      Int_t n=0;
+      for(Int_t row=0;row<nrow;row++) n += fCols[row].size();
+      if(n>0) {
+         Int_t *r_rows=new Int_t[n];
+         Int_t *r_cols=new Int_t[n];
+         Double_t *r_data=new Double_t[n];
+         n=0;
+         for(Int_t row=0;row<nrow;row++) {
+            for(size_t k=0;k<fCols[row].size();k++) {
+               r_rows[n]=row;
+               r_cols[n]=fCols[row][k];
+               r_data[n]=fData[row][k];
+               n++;
+            }
+         }
+         r->SetMatrixArray(n,r_rows,r_cols,r_data);
+         delete[] r_rows;
+         delete[] r_cols;
+         delete[] r_data;
+      }
+      return r;
+   }
+};
+
+}
+
 ClassImp(TUnfold)
 //______________________________________________________________________________
 
@@ -326,6 +399,9 @@ void TUnfold::InitTUnfold(void)
    fEinv = 0;
    fE = 0;
    fVxxInv = 0;
+   fAtVyyInv = 0;
+   fAtVyyInvA = 0;
+   fLsquared = 0;
    fEpsMatrix=1.E-13;
    fIgnoredBins=0;
 }
@@ -342,6 +418,15 @@ void TUnfold::DeleteMatrix(TMatrixDSparse **m)
    *m=0;
 }
 
+void TUnfold::ClearCache(void)
+{
+   // delete the products of the input matrices which do not depend on tau,
+   // to be called when fA, fL or fVyyInv change
+   DeleteMatrix(&fAtVyyInv);
+   DeleteMatrix(&fAtVyyInvA);
+   DeleteMatrix(&fLsquared);
+}
+
 void TUnfold::ClearResults(void)
 {
    // delete old results (if any)
@@ -423,14 +508,18 @@ Double_t TUnfold::DoUnfold(void)
    //              T
    //            fA fV  = mAt_V
    //
-   TMatrixDSparse *AtVyyinv=MultiplyMSparseTranspMSparse(fA,fVyyInv);
+   // this matrix and the other products which do not depend on tau
+   // are kept for the next calls, e.g. when scanning tau
+   if(!fAtVyyInv) fAtVyyInv=MultiplyMSparseTranspMSparse(fA,fVyyInv);
+   const TMatrixDSparse *AtVyyinv=fAtVyyInv;
    //
    // get
    //       T
    //     fA fVyyinv fY + fTauSquared fBiasScale Lsquared fX0 = rhs
    //
    TMatrixDSparse *rhs=MultiplyMSparseM(AtVyyinv,fY);
-   TMatrixDSparse *lSquared=MultiplyMSparseTranspMSparse(fL,fL);
+   if(!fLsquared) fLsquared=MultiplyMSparseTranspMSparse(fL,fL);
+   const TMatrixDSparse *lSquared=fLsquared;
    if (fBiasScale != 0.0) {
       TMatrixDSparse *rhs2=MultiplyMSparseM(lSquared,fX0);
       AddMSparse(rhs, fTauSquared * fBiasScale ,rhs2);
@@ -441,7 +530,8 @@ Double_t TUnfold::DoUnfold(void)
    // get matrix
    //              T
    //           (fA fV)fA + fTauSquared*fLsquared  = fEinv
-   fEinv=MultiplyMSparseMSparse(AtVyyinv,fA);
+   if(!fAtVyyInvA) fAtVyyInvA=MultiplyMSparseMSparse(AtVyyinv,fA);
+   fEinv=new TMatrixDSparse(*fAtVyyInvA);
    AddMSparse(fEinv,fTauSquared,lSquared);
 
    //
@@ -547,8 +637,6 @@ Double_t TUnfold::DoUnfold(void)
       DeleteMatrix(&corr);
    }
 
-   DeleteMatrix(&AtVyyinv);
-
    //
    // get error matrix on x
    //   fDXDY * Vyy * fDXDY#
@@ -611,7 +699,6 @@ Double_t TUnfold::DoUnfold(void)
    DeleteMatrix(&epsilon);
 
    DeleteMatrix(&LsquaredDx);
-   DeleteMatrix(&lSquared);
 
    // calculate/store matrices defining the derivatives dx/dA
    fDXDAM[0]=new TMatrixDSparse(*fE);
@@ -721,58 +808,45 @@ TMatrixDSparse *TUnfold::MultiplyMSparseMSparse(const TMatrixDSparse *a,
             a->GetNcols(),b->GetNrows());
    }
 
-   TMatrixDSparse *r=new TMatrixDSparse(a->GetNrows(),b->GetNcols());
    const Int_t *a_rows=a->GetRowIndexArray();
    const Int_t *a_cols=a->GetColIndexArray();
    const Double_t *a_data=a->GetMatrixArray();
    const Int_t *b_rows=b->GetRowIndexArray();
    const Int_t *b_cols=b->GetColIndexArray();
    const Double_t *b_data=b->GetMatrixArray();
-   // maximum size of the output matrix
-   int nMax=0;
-   for (Int_t irow = 0; irow < a->GetNrows(); irow++) {
-      if(a_rows[irow+1]>a_rows[irow]) nMax += b->GetNcols();
-   }
-   if((nMax>0)&&(a_cols)&&(b_cols)) {
-      Int_t *r_rows=new Int_t[nMax];
-      Int_t *r_cols=new Int_t[nMax];
-      Double_t *r_data=new Double_t[nMax];
-      Double_t *row_data=new Double_t[b->GetNcols()];
-      Int_t n=0;
-      for (Int_t irow = 0; irow < a->GetNrows(); irow++) {
-         if(a_rows[irow+1]<=a_rows[irow]) continue;
-         // clear row data
-         for(Int_t icol=0;icol<b->GetNcols();icol++) {
-            row_data[icol]=0.0;
-         }
-         // loop over a-columns in this a-row
-         for(Int_t ia=a_rows[irow];ia<a_rows[irow+1];ia++) {
-            Int_t k=a_cols[ia];
-            // loop over b-columns in b-row k
-            for(Int_t ib=b_rows[k];ib<b_rows[k+1];ib++) {
-               row_data[b_cols[ib]] += a_data[ia]*b_data[ib];
+   Int_t b_ncol=b->GetNcols();
+   // the rows of the output matrix are calculated independently
+   SparseRows_t rows(a->GetNrows());
+   if(a_cols && b_cols) {
+      Double_t work=(Double_t)a->GetNrows()*b_ncol+(Double_t)a_rows[a->GetNrows()]*
+         b_rows[b->GetNrows()]/TMath::Max(b->GetNrows(),1);
+      ForEachRange(0,a->GetNrows(),1,work,[&](Int_t first,Int_t last) {
+         std::vector<Double_t> row_data(b_ncol);
+         for (Int_t irow = first; irow < last; irow++) {
+            if(a_rows[irow+1]<=a_rows[irow]) continue;
+            // clear row data
+            for(Int_t icol=0;icol<b_ncol;icol++) {
+               row_data[icol]=0.0;
             }
-         }
-         // store nonzero elements
-         for(Int_t icol=0;icol<b->GetNcols();icol++) {
-            if(row_data[icol] != 0.0) {
-               r_rows[n]=irow;
-               r_cols[n]=icol;
-               r_data[n]=row_data[icol];
-               n++;
+            // loop over a-columns in this a-row
+            for(Int_t ia=a_rows[irow];ia<a_rows[irow+1];ia++) {
+               Int_t k=a_cols[ia];
+               // loop over b-columns in b-row k
+               for(Int_t ib=b_rows[k];ib<b_rows[k+1];ib++) {
+                  row_data[b_cols[ib]] += a_data[ia]*b_data[ib];
+               }
+            }
+            // store nonzero elements
+            for(Int_t icol=0;icol<b_ncol;icol++) {
+               if(row_data[icol] != 0.0) {
+                  rows.Add(irow,icol,row_data[icol]);
+               }
             }
          }
-      }
-      if(n>0) {
-         r->SetMatrixArray(n,r_rows,r_cols,r_data);
-      }
-      delete[] r_rows;
-      delete[] r_cols;
-      delete[] r_data;
-      delete[] row_data;
+      });
    }
 
-   return r;
+   return rows.CreateMatrix(a->GetNrows(),b_ncol);
 }
 
 
@@ -791,68 +865,66 @@ TMatrixDSparse *TUnfold::MultiplyMSparseTranspMSparse
             a->GetNrows(),b->GetNrows());
    }
 
-   TMatrixDSparse *r=new TMatrixDSparse(a->GetNcols(),b->GetNcols());
    const Int_t *a_rows=a->GetRowIndexArray();
    const Int_t *a_cols=a->GetColIndexArray();
    const Double_t *a_data=a->GetMatrixArray();
    const Int_t *b_rows=b->GetRowIndexArray();
    const Int_t *b_cols=b->GetColIndexArray();
    const Double_t *b_data=b->GetMatrixArray();
-   // maximum size of the output matrix
-
-   // matrix multiplication
-   typedef std::map<Int_t,Double_t> MMatrixRow_t;
-   typedef std::map<Int_t, MMatrixRow_t > MMatrix_t;
-   MMatrix_t matrix;
-
-   for(Int_t iRowAB=0;iRowAB<a->GetNrows();iRowAB++) {
-      for(Int_t ia=a_rows[iRowAB];ia<a_rows[iRowAB+1];ia++) {
-         for(Int_t ib=b_rows[iRowAB];ib<b_rows[iRowAB+1];ib++) {
-            // this creates a new row if necessary
-            MMatrixRow_t &row=matrix[a_cols[ia]];
-            MMatrixRow_t::iterator icol=row.find(b_cols[ib]);
-            if(icol!=row.end()) {
-               // update existing row
-               (*icol).second += a_data[ia]*b_data[ib];
-            } else {
-               // create new row
-               row[b_cols[ib]] = a_data[ia]*b_data[ib];
+   Int_t a_ncol=a->GetNcols();
+   Int_t b_ncol=b->GetNcols();
+
+   // transpose a: for each column of a, its rows in increasing order
+   // such that the products are summed in the same order as
+   // when looping over the rows of a and b
+   Int_t a_nel=a_rows[a->GetNrows()];
+   std::vector<Int_t> at_rows(a_ncol+1,0);
+   std::vector<Int_t> at_cols(a_nel);
+   std::vector<Double_t> at_data(a_nel);
+   for(Int_t ia=0;ia<a_nel;ia++) {
+      at_rows[a_cols[ia]+1]++;
+   }
+   for(Int_t i=0;i<a_ncol;i++) {
+      at_rows[i+1] += at_rows[i];
+   }
+   {
+      std::vector<Int_t> at_next(at_rows.begin(),at_rows.end()-1);
+      for(Int_t iRowAB=0;iRowAB<a->GetNrows();iRowAB++) {
+         for(Int_t ia=a_rows[iRowAB];ia<a_rows[iRowAB+1];ia++) {
+            Int_t iat=at_next[a_cols[ia]]++;
+            at_cols[iat]=iRowAB;
+            at_data[iat]=a_data[ia];
+         }
+      }
+   }
+
+   // matrix multiplication, the rows of the output matrix are calculated
+   // independently
+   SparseRows_t rows(a_ncol);
+   Double_t work=(Double_t)a_ncol*b_ncol+(Double_t)a_nel*
+      b_rows[b->GetNrows()]/TMath::Max(b->GetNrows(),1);
+   ForEachRange(0,a_ncol,1,work,[&](Int_t first,Int_t last) {
+      std::vector<Double_t> row_data(b_ncol);
+      for(Int_t irow=first;irow<last;irow++) {
+         if(at_rows[irow+1]<=at_rows[irow]) continue;
+         for(Int_t icol=0;icol<b_ncol;icol++) {
+            row_data[icol]=0.0;
+         }
+         for(Int_t iat=at_rows[irow];iat<at_rows[irow+1];iat++) {
+            Int_t iRowAB=at_cols[iat];
+            for(Int_t ib=b_rows[iRowAB];ib<b_rows[iRowAB+1];ib++) {
+               row_data[b_cols[ib]] += at_data[iat]*b_data[ib];
             }
          }
-      }
-   }
-
-   Int_t n=0;
-   for(MMatrix_t::const_iterator irow=matrix.begin();
-       irow!=matrix.end();irow++) {
-      n += (*irow).second.size();
-   }
-   if(n>0) {
-      // pack matrix into arrays
-      Int_t *r_rows=new Int_t[n];
-      Int_t *r_cols=new Int_t[n];
-      Double_t *r_data=new Double_t[n];
-      n=0;
-      for(MMatrix_t::const_iterator irow=matrix.begin();
-          irow!=matrix.end();irow++) {
-         for(MMatrixRow_t::const_iterator icol=(*irow).second.begin();
-             icol!=(*irow).second.end();icol++) {
-            r_rows[n]=(*irow).first;
-            r_cols[n]=(*icol).first;
-            r_data[n]=(*icol).second;
-            n++;
+         for(Int_t icol=0;icol<b_ncol;icol++) {
+            if(row_data[icol] != 0.0) {
+               rows.Add(irow,icol,row_data[icol]);
+            }
          }
       }
-      // pack arrays into TMatrixDSparse
-      if(n>0) {
-         r->SetMatrixArray(n,r_rows,r_cols,r_data);
-      }
-      delete[] r_rows;
-      delete[] r_cols;
-      delete[] r_data;
-   }
+   });
 
-   return r;
+   return rows.CreateMatrix(a_ncol,b_ncol);
 }
 
 TMatrixDSparse *TUnfold::MultiplyMSparseM(const TMatrixDSparse *a,
@@ -868,43 +940,26 @@ TMatrixDSparse *TUnfold::MultiplyMSparseM(const TMatrixDSparse *a,
             a->GetNcols(),b->GetNrows());
    }
 
-   TMatrixDSparse *r=new TMatrixDSparse(a->GetNrows(),b->GetNcols());
    const Int_t *a_rows=a->GetRowIndexArray();
    const Int_t *a_cols=a->GetColIndexArray();
    const Double_t *a_data=a->GetMatrixArray();
-   // maximum size of the output matrix
-   int nMax=0;
-   for (Int_t irow = 0; irow < a->GetNrows(); irow++) {
-      if(a_rows[irow+1]-a_rows[irow]>0) nMax += b->GetNcols();
-   }
-   if(nMax>0) {
-      Int_t *r_rows=new Int_t[nMax];
-      Int_t *r_cols=new Int_t[nMax];
-      Double_t *r_data=new Double_t[nMax];
-
-      Int_t n=0;
-      // fill matrix r
-      for (Int_t irow = 0; irow < a->GetNrows(); irow++) {
+   // the rows of the output matrix are calculated independently
+   SparseRows_t rows(a->GetNrows());
+   Double_t work=(Double_t)a_rows[a->GetNrows()]*b->GetNcols();
+   ForEachRange(0,a->GetNrows(),1,work,[&](Int_t first,Int_t last) {
+      for (Int_t irow = first; irow < last; irow++) {
          if(a_rows[irow+1]-a_rows[irow]<=0) continue;
          for(Int_t icol=0;icol<b->GetNcols();icol++) {
-            r_rows[n]=irow;
-            r_cols[n]=icol;
-            r_data[n]=0.0;
+            Double_t r_data=0.0;
             for(Int_t i=a_rows[irow];i<a_rows[irow+1];i++) {
                Int_t j=a_cols[i];
-               r_data[n] += a_data[i]*(*b)(j,icol);
+               r_data += a_data[i]*(*b)(j,icol);
             }
-            if(r_data[n]!=0.0) n++;
+            if(r_data!=0.0) rows.Add(irow,icol,r_data);
          }
       }
-      if(n>0) {
-         r->SetMatrixArray(n,r_rows,r_cols,r_data);
-      }
-      delete[] r_rows;
-      delete[] r_cols;
-      delete[] r_data;
-   }
-   return r;
+   });
+   return rows.CreateMatrix(a->GetNrows(),b->GetNcols());
 }
 
 TMatrixDSparse *TUnfold::MultiplyMSparseMSparseTranspVector
@@ -929,17 +984,9 @@ TMatrixDSparse *TUnfold::MultiplyMSparseMSparseTranspVector
    const Int_t *rows_m1=m1->GetRowIndexArray();
    const Int_t *cols_m1=m1->GetColIndexArray();
    const Double_t *data_m1=m1->GetMatrixArray();
-   Int_t num_m1=0;
-   for(Int_t i=0;i<m1->GetNrows();i++) {
-      if(rows_m1[i]<rows_m1[i+1]) num_m1++;
-   }
    const Int_t *rows_m2=m2->GetRowIndexArray();
    const Int_t *cols_m2=m2->GetColIndexArray();
    const Double_t *data_m2=m2->GetMatrixArray();
-   Int_t num_m2=0;
-   for(Int_t j=0;j<m2->GetNrows();j++) {
-      if(rows_m2[j]<rows_m2[j+1]) num_m2++;
-   }
    const TMatrixDSparse *v_sparse=dynamic_cast<const TMatrixDSparse *>(v);
    const Int_t *v_rows=0;
    const Double_t *v_data=0;
@@ -947,55 +994,48 @@ TMatrixDSparse *TUnfold::MultiplyMSparseMSparseTranspVector
       v_rows=v_sparse->GetRowIndexArray();
       v_data=v_sparse->GetMatrixArray();
    }
-   Int_t num_r=num_m1*num_m2+1;
-   Int_t *row_r=new Int_t[num_r];
-   Int_t *col_r=new Int_t[num_r];
-   Double_t *data_r=new Double_t[num_r];
-   num_r=0;
-   for(Int_t i=0;i<m1->GetNrows();i++) {
-      for(Int_t j=0;j<m2->GetNrows();j++) {
-         data_r[num_r]=0.0;
-         Int_t index_m1=rows_m1[i];
-         Int_t index_m2=rows_m2[j];
-         while((index_m1<rows_m1[i+1])&&(index_m2<rows_m2[j+1])) {
-            Int_t k1=cols_m1[index_m1];
-            Int_t k2=cols_m2[index_m2];
-            if(k1<k2) {
-               index_m1++;
-            } else if(k1>k2) {
-               index_m2++;
-            } else {
-               if(v_sparse) {
-                  Int_t v_index=v_rows[k1];
-                  if(v_index<v_rows[k1+1]) {
-                     data_r[num_r] += data_m1[index_m1] * data_m2[index_m2]
-                     * v_data[v_index];
+   // the rows of the output matrix are calculated independently
+   SparseRows_t rows(m1->GetNrows());
+   Double_t work=(Double_t)rows_m1[m1->GetNrows()]*m2->GetNrows()+
+      (Double_t)rows_m2[m2->GetNrows()]*m1->GetNrows();
+   ForEachRange(0,m1->GetNrows(),1,work,[&](Int_t first,Int_t last) {
+      for(Int_t i=first;i<last;i++) {
+         if(rows_m1[i]>=rows_m1[i+1]) continue;
+         for(Int_t j=0;j<m2->GetNrows();j++) {
+            Double_t data_r=0.0;
+            Int_t index_m1=rows_m1[i];
+            Int_t index_m2=rows_m2[j];
+            while((index_m1<rows_m1[i+1])&&(index_m2<rows_m2[j+1])) {
+               Int_t k1=cols_m1[index_m1];
+               Int_t k2=cols_m2[index_m2];
+               if(k1<k2) {
+                  index_m1++;
+               } else if(k1>k2) {
+                  index_m2++;
+               } else {
+                  if(v_sparse) {
+                     Int_t v_index=v_rows[k1];
+                     if(v_index<v_rows[k1+1]) {
+                        data_r += data_m1[index_m1] * data_m2[index_m2]
+                        * v_data[v_index];
+                     } else {
+                        data_r =0.0;
+                     }
+                  } else if(v) {
+                     data_r += data_m1[index_m1] * data_m2[index_m2]
+                     * (*v)(k1,0);
                   } else {
-                     data_r[num_r] =0.0;
+                     data_r += data_m1[index_m1] * data_m2[index_m2];
                   }
-               } else if(v) {
-                  data_r[num_r] += data_m1[index_m1] * data_m2[index_m2]
-                  * (*v)(k1,0);
-               } else {
-                  data_r[num_r] += data_m1[index_m1] * data_m2[index_m2];
+                  index_m1++;
+                  index_m2++;
                }
-               index_m1++;
-               index_m2++;
             }
-         }
-         if(data_r[num_r] !=0.0) {
-            row_r[num_r]=i;
-            col_r[num_r]=j;
-            num_r++;
+            if(data_r !=0.0) rows.Add(i,j,data_r);
          }
       }
-   }
-   TMatrixDSparse *r=CreateSparseMatrix(m1->GetNrows(),m2->GetNrows(),
-                                        num_r,row_r,col_r,data_r);
-   delete[] row_r;
-   delete[] col_r;
-   delete[] data_r;
-   return r;
+   });
+   return rows.CreateMatrix(m1->GetNrows(),m2->GetNrows());
 }
 
 void TUnfold::AddMSparse(TMatrixDSparse *dest,Double_t f,
@@ -1408,16 +1448,30 @@ TMatrixDSparse *TUnfold::InvertMSparseSymmPos
          const Int_t *f_cols=F->GetColIndexArray();
          const Double_t *f_data=F->GetMatrixArray();
          // cholesky-type decomposition of F
+         //
+         // the rows of c are stored contiguously, c(j,k) being
+         // c_data[j*nF+k]. The elements c(j,k) with k<first[j] are zero
+         // in F and stay zero in c, so they are skipped in the sums
          TMatrixD c(nF,nF);
+         Double_t *c_data=c.GetMatrixArray();
+         std::vector<Int_t> first(nF);
+         for(Int_t j=0;j<nF;j++) first[j]=j;
+         for(Int_t i=0;i<nF;i++) {
+            for(Int_t indexF=f_rows[i];indexF<f_rows[i+1];indexF++) {
+               Int_t j=f_cols[indexF];
+               if((j>=i)&&(i<first[j])) first[j]=i;
+            }
+         }
          Int_t nErrorF=0;
          for(Int_t i=0;i<nF;i++) {
             for(Int_t indexF=f_rows[i];indexF<f_rows[i+1];indexF++) {
-               if(f_cols[indexF]>=i) c(f_cols[indexF],i)=f_data[indexF];
+               if(f_cols[indexF]>=i) c_data[f_cols[indexF]*nF+i]=f_data[indexF];
             }
             // calculate diagonal element
-            Double_t c_ii=c(i,i);
-            for(Int_t j=0;j<i;j++) {
-               Double_t c_ij=c(i,j);
+            const Double_t *c_i=c_data+i*nF;
+            Double_t c_ii=c_i[i];
+            for(Int_t j=first[i];j<i;j++) {
+               Double_t c_ij=c_i[j];
                c_ii -= c_ij*c_ij;
             }
             if(c_ii<=0.0) {
@@ -1425,15 +1479,20 @@ TMatrixDSparse *TUnfold::InvertMSparseSymmPos
                break;
             }
             c_ii=TMath::Sqrt(c_ii);
-            c(i,i)=c_ii;
-            // off-diagonal elements
-            for(Int_t j=i+1;j<nF;j++) {
-               Double_t c_ji=c(j,i);
-               for(Int_t k=0;k<i;k++) {
-                  c_ji -= c(i,k)*c(j,k);
+            c_data[i*nF+i]=c_ii;
+            // off-diagonal elements, independent of each other
+            ForEachRange(i+1,nF,16,(Double_t)(nF-i)*(i-first[i]),
+                         [&](Int_t jFirst,Int_t jLast) {
+               for(Int_t j=jFirst;j<jLast;j++) {
+                  if(first[j]>i) continue;
+                  Double_t *c_j=c_data+j*nF;
+                  Double_t c_ji=c_j[i];
+                  for(Int_t k=TMath::Max(first[i],first[j]);k<i;k++) {
+                     c_ji -= c_i[k]*c_j[k];
+                  }
+                  c_j[i] = c_ji/c_ii;
                }
-               c(j,i) = c_ji/c_ii;
-            }
+            });
          }
          // check condition of dInv
          if(!nErrorF) {
@@ -1450,20 +1509,28 @@ TMatrixDSparse *TUnfold::InvertMSparseSymmPos
          }
          if(!nErrorF) {
             // here: F = c c#
-            // construct inverse of c
-            TMatrixD cinv(nF,nF);
+            // construct inverse of c, column by column. The columns are
+            // independent and stored contiguously, as the rows of cinvT
+            TMatrixD cinvT(nF,nF);
+            Double_t *cinvT_data=cinvT.GetMatrixArray();
             for(Int_t i=0;i<nF;i++) {
-               cinv(i,i)=1./c(i,i);
+               cinvT_data[i*nF+i]=1./c_data[i*nF+i];
             }
-            for(Int_t i=0;i<nF;i++) {
-               for(Int_t j=i+1;j<nF;j++) {
-                  Double_t tmp=-c(j,i)*cinv(i,i);
-                  for(Int_t k=i+1;k<j;k++) {
-                     tmp -= cinv(k,i)*c(j,k);
+            ForEachRange(0,nF,1,(Double_t)nF*nF*nF/6.,
+                         [&](Int_t iFirst,Int_t iLast) {
+               for(Int_t i=iFirst;i<iLast;i++) {
+                  Double_t *cinv_i=cinvT_data+i*nF;
+                  for(Int_t j=i+1;j<nF;j++) {
+                     const Double_t *c_j=c_data+j*nF;
+                     Double_t tmp=-c_j[i]*cinv_i[i];
+                     for(Int_t k=TMath::Max(i+1,first[j]);k<j;k++) {
+                        tmp -= cinv_i[k]*c_j[k];
+                     }
+                     cinv_i[j]=tmp*cinvT_data[j*nF+j];
                   }
-                  cinv(j,i)=tmp*cinv(j,j);
                }
-            }
+            });
+            TMatrixD cinv(TMatrixD::kTransposed,cinvT);
             TMatrixDSparse cInvSparse(cinv);
             Finv=MultiplyMSparseTranspMSparse
             (&cInvSparse,&cInvSparse);
@@ -1956,6 +2023,7 @@ TUnfold::~TUnfold(void)
    DeleteMatrix(&fX0);
 
    ClearResults();
+   ClearCache();
 }
 
 void TUnfold::SetBias(const TH1 *bias)
@@ -2059,6 +2127,7 @@ Bool_t TUnfold::AddRegularisationCondition
    if(r) {
       DeleteMatrix(&fL);
       fL=CreateSparseMatrix(rowMax+1,GetNx(),nF,l_row,l_col,l_data);
+      ClearCache();
    }
    delete [] l_row;
    delete [] l_col;
@@ -2227,6 +2296,7 @@ Int_t TUnfold::SetInput(const TH1 *input, Double_t scaleBias,
    //   + see ClearResults
 
    DeleteMatrix(&fVyyInv);
+   ClearCache();
    fNdf=0;
 
    fBiasScale = scaleBias;
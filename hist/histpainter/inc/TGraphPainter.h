@@ -37,6 +37,7 @@ public:
    virtual ~TGraphPainter();
 
    void           ComputeLogs(Int_t npoints, Int_t opt);
+   Int_t          DecimatePolyLine(Int_t npoints, Double_t *x, Double_t *y);
    virtual Int_t  DistancetoPrimitiveHelper(TGraph *theGraph, Int_t px, Int_t py);
    virtual void   DrawPanelHelper(TGraph *theGraph);
    virtual void   ExecuteEventHelper(TGraph *theGraph, Int_t event, Int_t px, Int_t py);
@@ -54,10 +55,12 @@ public:
    void           PaintStats(TGraph *theGraph, TF1 *fit);
    void           Smooth(TGraph *theGraph, Int_t npoints, Double_t *x, Double_t *y, Int_t drawtype);
    static void    SetMaxPointsPerLine(Int_t maxp=50);
+   static void    SetMinPointsToDecimate(Int_t minp=100000);
 
 protected:
 
    static Int_t   fgMaxPointsPerLine;  //Number of points per chunks' line when drawing a graph.
+   static Int_t   fgMinPointsToDecimate; //Number of points from which lines are decimated to the pad's pixels.
 
    ClassDef(TGraphPainter,0)  // TGraph painter
 };
@@ -34,6 +34,7 @@
 
 Double_t *gxwork, *gywork, *gxworkl, *gyworkl;
 Int_t TGraphPainter::fgMaxPointsPerLine = 50;
+Int_t TGraphPainter::fgMinPointsToDecimate = 100000;
 
 ClassImp(TGraphPainter);
 
@@ -505,6 +506,48 @@ void TGraphPainter::ComputeLogs(Int_t npoints, Int_t opt)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Decimate in place the polyline of npoints pad coordinates x, y to the
+/// pixels of the current pad, if it has at least `fgMinPointsToDecimate`
+/// points.
+///
+/// Consecutive points in the same pixel column are replaced by the first
+/// point, the lowest and the highest point, in their order, and the last one.
+/// The line painted with these at most four points per column covers the same
+/// pixels as the full line, while the number of points sent to the pad, and
+/// written to PS, PDF or SVG files, is at most four times the pad's width
+/// in pixels. As the columns are computed at each painting, zooming restores
+/// the points of the zoomed range. Returns the number of points kept.
+
+Int_t TGraphPainter::DecimatePolyLine(Int_t npoints, Double_t *x, Double_t *y)
+{
+   if (fgMinPointsToDecimate <= 0 || npoints < fgMinPointsToDecimate) return npoints;
+   Int_t nkept = 0;
+   Int_t last  = -1;
+   Int_t i     = 0;
+   while (i < npoints) {
+      Int_t column = gPad->XtoPixel(x[i]);
+      Int_t first  = i;
+      Int_t imin   = i;
+      Int_t imax   = i;
+      for (i++; i<npoints; i++) {
+         if (gPad->XtoPixel(x[i]) != column) break;
+         if (y[i] < y[imin]) imin = i;
+         if (y[i] > y[imax]) imax = i;
+      }
+      // the kept points are in increasing order and never behind nkept
+      Int_t keep[4] = {first, TMath::Min(imin,imax), TMath::Max(imin,imax), i-1};
+      for (Int_t k=0; k<4; k++) {
+         if (keep[k] == last) continue;
+         last       = keep[k];
+         x[nkept]   = x[last];
+         y[nkept++] = y[last];
+      }
+   }
+   return nkept;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Compute distance from point px,py to a graph.
 ///
@@ -1156,16 +1199,18 @@ void TGraphPainter::PaintGraph(TGraph *theGraph, Int_t npoints, const Double_t *
                   gPad->PaintFillArea(npt,gyworkl,gxworkl);
                   if (bord) gPad->PaintPolyLine(npt,gyworkl,gxworkl);
                } else {
-                  if (TMath::Abs(theGraph->GetLineWidth())>99) PaintPolyLineHatches(theGraph, npt, gyworkl, gxworkl);
-                  gPad->PaintPolyLine(npt,gyworkl,gxworkl);
+                  Int_t ndec = DecimatePolyLine(npt, gyworkl, gxworkl);
+                  if (TMath::Abs(theGraph->GetLineWidth())>99) PaintPolyLineHatches(theGraph, ndec, gyworkl, gxworkl);
+                  gPad->PaintPolyLine(ndec,gyworkl,gxworkl);
                }
             } else {
                if (optionFill) {
                   gPad->PaintFillArea(npt,gxworkl,gyworkl);
                   if (bord) gPad->PaintPolyLine(npt,gxworkl,gyworkl);
                } else {
-                  if (TMath::Abs(theGraph->GetLineWidth())>99) PaintPolyLineHatches(theGraph, npt, gxworkl, gyworkl);
-                  gPad->PaintPolyLine(npt,gxworkl,gyworkl);
+                  Int_t ndec = DecimatePolyLine(npt, gxworkl, gyworkl);
+                  if (TMath::Abs(theGraph->GetLineWidth())>99) PaintPolyLineHatches(theGraph, ndec, gxworkl, gyworkl);
+                  gPad->PaintPolyLine(ndec,gxworkl,gyworkl);
                }
             }
             gxwork[0] = gxwork[npt-1];  gywork[0] = gywork[npt-1];
@@ -3991,3 +4036,17 @@ void TGraphPainter::SetMaxPointsPerLine(Int_t maxp)
    fgMaxPointsPerLine = maxp;
    if (maxp < 50) fgMaxPointsPerLine = 50;
 }
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Static function to set `fgMinPointsToDecimate` for graph painting. Graphs
+/// painted with a line of at least `fgMinPointsToDecimate` points are decimated
+/// to at most four points per pixel column of the pad, see DecimatePolyLine.
+/// This makes the painting of graphs with millions of points fast and keeps
+/// the size of PS, PDF or SVG files small. A value of 0 paints all the points:
+/// `TGraphPainter::SetMinPointsToDecimate(0)`.
+
+void TGraphPainter::SetMinPointsToDecimate(Int_t minp)
+{
+   fgMinPointsToDecimate = minp;
+}
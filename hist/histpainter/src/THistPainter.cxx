@@ -64,6 +64,7 @@
 #include "TPoint.h"
 #include "TImage.h"
 #include "TCandle.h"
+#include "TVirtualPS.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 /*! \class THistPainter
@@ -1106,6 +1107,14 @@ For the most part, the COL2 and COLZ2 options are a drop in replacement to the C
 and COLZ options. There is one major difference and that concerns the treatment of
 bins with zero content. The COL2 and COLZ2 options color these bins the color of zero.
 
+With the COL option itself, a histogram with linear axes and fixed bins which has
+more bins in the frame than the frame has pixels is painted on the screen as one
+image of the frame: each pixel takes the color of the bin at its center and the
+bins which are not painted stay transparent. The painting time then depends on
+the size of the pad only, which keeps the zooming of very large maps interactive.
+When the pad is printed in a PDF or SVG file, such histograms are written as one
+image with one cell per bin.
+
 
 ### <a name="HP140"></a> The CANDLE option
 
@@ -2786,6 +2795,7 @@ const Int_t kNMAX = 2000;
 
 const Int_t kMAXCONTOUR  = 104;
 const UInt_t kCannotRotate = BIT(11);
+const Int_t kMinCellArrayBins = 10000;
 
 static TString gStringEntries;
 static TString gStringMean;
@@ -5240,7 +5250,7 @@ void THistPainter::PaintColorLevelsFast(Option_t*)
 /// [Control function to draw a 2D histogram as a color plot.](#HP14)
 void THistPainter::PaintColorLevels(Option_t*)
 {
-   Double_t z, zc, xk, xstep, yk, ystep, xlow, xup, ylow, yup;
+   Double_t xk, xstep, yk, ystep, xlow, xup, ylow, yup;
 
    Double_t zmin = fH->GetMinimum();
    Double_t zmax = fH->GetMaximum();
@@ -5300,9 +5310,154 @@ void THistPainter::PaintColorLevels(Option_t*)
    if (fH->TestBit(TH1::kUserContour) == 0) fH->SetContour(ndiv);
    Double_t scale = ndivz/dz;
 
-   Int_t color;
+   // A dense map printed in a PDF or SVG file is written as one image with
+   // one cell per bin, instead of one box per bin. The bins which are not
+   // painted get the colour of the frame.
+   Int_t nxcells = Hparam.xlast - Hparam.xfirst + 1;
+   Int_t nycells = Hparam.ylast - Hparam.yfirst + 1;
+   TVirtualPS *ps = 0;
+   std::vector<Int_t> cells;
+   if (gVirtualPS && (gVirtualPS->InheritsFrom("TPDF") || gVirtualPS->InheritsFrom("TSVG")) &&
+       nxcells*nycells >= kMinCellArrayBins && Hoption.System == kCARTESIAN &&
+       !Hoption.Logx && !Hoption.Logy && !Hoption.Same &&
+       fXaxis->GetXbins()->fN == 0 && fYaxis->GetXbins()->fN == 0) {
+      Double_t epsx = 1e-6*(gPad->GetUxmax() - gPad->GetUxmin());
+      Double_t epsy = 1e-6*(gPad->GetUymax() - gPad->GetUymin());
+      Int_t bkgcolor = -1;
+      if (gPad->GetFrameFillStyle() == 1001) {
+         bkgcolor = gPad->GetFrameFillColor();
+      } else if (gPad->GetFrameFillStyle() == 0 && gPad->GetFillStyle() == 1001) {
+         bkgcolor = gPad->GetFillColor();
+      }
+      if (bkgcolor >= 0 &&
+          fXaxis->GetBinLowEdge(Hparam.xfirst) >= gPad->GetUxmin() - epsx &&
+          fXaxis->GetBinUpEdge(Hparam.xlast)   <= gPad->GetUxmax() + epsx &&
+          fYaxis->GetBinLowEdge(Hparam.yfirst) >= gPad->GetUymin() - epsy &&
+          fYaxis->GetBinUpEdge(Hparam.ylast)   <= gPad->GetUymax() + epsy) {
+         cells.assign(nxcells*nycells, bkgcolor);
+         ps = gVirtualPS;
+         gVirtualPS = 0;
+      }
+   }
+
+   // Index in the palette of the colour of a bin, -1 if it is not painted
    TProfile2D* prof2d = dynamic_cast<TProfile2D*>(fH);
-   for (Int_t j=Hparam.yfirst; j<=Hparam.ylast;j++) {
+   auto binColor = [&](Int_t bin) -> Int_t {
+      Double_t z = fH->GetBinContent(bin);
+      // if fH is a profile histogram do not draw empty bins
+      if (prof2d) {
+         const Double_t binEntries = prof2d->GetBinEntries(bin);
+         if (binEntries == 0)
+            return -1;
+      } else {
+         // don't draw the empty bins for non-profile histograms
+         // with positive content
+         if (z == 0) {
+            if (zmin >= 0 || Hoption.Logz) return -1;
+            if (Hoption.Color == 2) return -1;
+         }
+      }
+
+      if (Hoption.Logz) {
+         if (z > 0) z = TMath::Log10(z);
+         else       z = zmin;
+      }
+      if (z < zmin && !Hoption.Zero) return -1;
+
+      Int_t color;
+      if (fH->TestBit(TH1::kUserContour)) {
+         Double_t zc = fH->GetContourLevelPad(0);
+         if (z < zc) return -1;
+         color = -1;
+         for (Int_t k=0; k<ndiv; k++) {
+            zc = fH->GetContourLevelPad(k);
+            if (z < zc) {
+               continue;
+            } else {
+               color++;
+            }
+         }
+      } else {
+         color = Int_t(0.01+(z-zmin)*scale);
+      }
+
+      Int_t theColor = Int_t((color+0.99)*Float_t(ncolors)/Float_t(ndivz));
+      if (theColor > ncolors-1) theColor = ncolors-1;
+      return theColor;
+   };
+
+   // On the screen, a map with more bins than pixels in the frame is painted
+   // as one image of the frame, each pixel taking the colour of the bin at its
+   // centre, so that the painting time depends on the size of the pad and not
+   // on the number of bins.
+   Bool_t pixels = kFALSE;
+   if (!gPad->IsBatch() && (!gVirtualPS || ps) && Hoption.System == kCARTESIAN &&
+       !Hoption.Logx && !Hoption.Logy &&
+       fXaxis->GetXbins()->fN == 0 && fYaxis->GetXbins()->fN == 0) {
+      Double_t uxmin = gPad->GetUxmin();
+      Double_t uxmax = gPad->GetUxmax();
+      Double_t uymin = gPad->GetUymin();
+      Double_t uymax = gPad->GetUymax();
+      Int_t px0 = gPad->XtoPixel(uxmin);
+      Int_t px1 = gPad->XtoPixel(uxmax);
+      Int_t py0 = gPad->YtoPixel(uymin);
+      Int_t py1 = gPad->YtoPixel(uymax);
+      Int_t nXPixels = px1-px0;
+      Int_t nYPixels = py0-py1; // y=0 is at the top of the screen
+      if (nXPixels > 0 && nYPixels > 0 &&
+          Double_t(nxcells)*nycells > Double_t(nXPixels)*nYPixels) {
+         pixels = kTRUE;
+
+         // bins at the centres of the columns and of the rows of pixels
+         std::vector<Int_t> xbins(nXPixels), ybins(nYPixels);
+         for (Int_t px=0; px<nXPixels; px++) {
+            Int_t i = fXaxis->FindFixBin(uxmin + (px+0.5)*(uxmax-uxmin)/nXPixels);
+            xbins[px] = (i >= Hparam.xfirst && i <= Hparam.xlast) ? i : -1;
+         }
+         for (Int_t py=0; py<nYPixels; py++) {
+            Int_t j = fYaxis->FindFixBin(uymin + (py+0.5)*(uymax-uymin)/nYPixels);
+            ybins[py] = (j >= Hparam.yfirst && j <= Hparam.ylast) ? j : -1;
+         }
+
+         std::vector<UChar_t> rgba(4*ncolors);
+         for (Int_t k=0; k<ncolors; k++) {
+            TColor *c = gROOT->GetColor(gStyle->GetColorPalette(k));
+            rgba[4*k]   = c ? UChar_t(255*c->GetRed()+0.5)   : 255;
+            rgba[4*k+1] = c ? UChar_t(255*c->GetGreen()+0.5) : 255;
+            rgba[4*k+2] = c ? UChar_t(255*c->GetBlue()+0.5)  : 255;
+            rgba[4*k+3] = c ? UChar_t(255*c->GetAlpha()+0.5) : 255;
+         }
+
+         // the first row of the buffer is the bottom one, transparent pixels
+         // for the bins which are not painted
+         std::vector<UChar_t> buffer(4*nXPixels*nYPixels, 0);
+         for (Int_t py=0; py<nYPixels; py++) {
+            Int_t j = ybins[py];
+            if (j < 0) continue;
+            UChar_t *row = &buffer[4*py*nXPixels];
+            for (Int_t px=0; px<nXPixels; px++) {
+               Int_t i = xbins[px];
+               if (i < 0) continue;
+               if (!IsInside(fXaxis->GetBinCenter(i), fYaxis->GetBinCenter(j))) continue;
+               Int_t theColor = binColor(j*(fXaxis->GetNbins()+2) + i);
+               if (theColor < 0) continue;
+               memcpy(row + 4*px, &rgba[4*theColor], 4);
+            }
+         }
+
+         TImage *image = TImage::Create();
+         if (image) {
+            image->FromGLBuffer(&buffer[0], nXPixels, nYPixels);
+            Window_t wid = static_cast<Window_t>(gVirtualX->GetWindowID(gPad->GetPixmapID()));
+            image->PaintImage(wid, px0, py1, 0, 0, nXPixels, nYPixels);
+            delete image;
+         } else {
+            pixels = kFALSE;
+         }
+      }
+   }
+
+   for (Int_t j=Hparam.yfirst; j<=Hparam.ylast && (!pixels || ps); j++) {
       yk    = fYaxis->GetBinLowEdge(j);
       ystep = fYaxis->GetBinWidth(j);
       for (Int_t i=Hparam.xfirst; i<=Hparam.xlast;i++) {
@@ -5311,26 +5466,8 @@ void THistPainter::PaintColorLevels(Option_t*)
          xstep = fXaxis->GetBinWidth(i);
          if (Hoption.System == kPOLAR && xk<0) xk= 2*TMath::Pi()+xk;
          if (!IsInside(xk+0.5*xstep,yk+0.5*ystep)) continue;
-         z     = fH->GetBinContent(bin);
-         // if fH is a profile histogram do not draw empty bins
-         if (prof2d) {
-            const Double_t binEntries = prof2d->GetBinEntries(bin);
-            if (binEntries == 0)
-               continue;
-         } else {
-            // don't draw the empty bins for non-profile histograms
-            // with positive content
-            if (z == 0) {
-               if (zmin >= 0 || Hoption.Logz) continue;
-               if (Hoption.Color == 2) continue;
-            }
-         }
-
-         if (Hoption.Logz) {
-            if (z > 0) z = TMath::Log10(z);
-            else       z = zmin;
-         }
-         if (z < zmin && !Hoption.Zero) continue;
+         Int_t theColor = binColor(bin);
+         if (theColor < 0) continue;
          xup  = xk + xstep;
          xlow = xk;
          if (Hoption.Logx) {
@@ -5358,24 +5495,10 @@ void THistPainter::PaintColorLevels(Option_t*)
             if (yup  > gPad->GetUymax()) yup  = gPad->GetUymax();
          }
 
-         if (fH->TestBit(TH1::kUserContour)) {
-            zc = fH->GetContourLevelPad(0);
-            if (z < zc) continue;
-            color = -1;
-            for (Int_t k=0; k<ndiv; k++) {
-               zc = fH->GetContourLevelPad(k);
-               if (z < zc) {
-                  continue;
-               } else {
-                  color++;
-               }
-            }
-         } else {
-            color = Int_t(0.01+(z-zmin)*scale);
+         if (ps) {
+            cells[(Hparam.ylast-j)*nxcells + i-Hparam.xfirst] = gStyle->GetColorPalette(theColor);
+            if (gPad->IsBatch() || pixels) continue;
          }
-
-         Int_t theColor = Int_t((color+0.99)*Float_t(ncolors)/Float_t(ndivz));
-         if (theColor > ncolors-1) theColor = ncolors-1;
          fH->SetFillColor(gStyle->GetColorPalette(theColor));
          fH->TAttFill::Modify();
          if (Hoption.System != kPOLAR) {
@@ -5388,6 +5511,26 @@ void THistPainter::PaintColorLevels(Option_t*)
       }
    }
 
+   if (ps) {
+      gVirtualPS = ps;
+      Double_t x1 = fXaxis->GetBinLowEdge(Hparam.xfirst);
+      Double_t y1 = fYaxis->GetBinUpEdge(Hparam.ylast);
+      gVirtualPS->CellArrayBegin(nxcells, nycells, x1, x1+fXaxis->GetBinWidth(Hparam.xfirst),
+                                 y1, y1+fYaxis->GetBinWidth(Hparam.ylast));
+      Int_t lastcolor = -1, r = 0, g = 0, b = 0;
+      for (Int_t k=0; k<nxcells*nycells; k++) {
+         if (cells[k] != lastcolor) {
+            lastcolor = cells[k];
+            TColor *c = gROOT->GetColor(lastcolor);
+            r = c ? Int_t(255*c->GetRed()+0.5)   : 255;
+            g = c ? Int_t(255*c->GetGreen()+0.5) : 255;
+            b = c ? Int_t(255*c->GetBlue()+0.5)  : 255;
+         }
+         gVirtualPS->CellArrayFill(r, g, b);
+      }
+      gVirtualPS->CellArrayEnd();
+   }
+
    if (Hoption.Zscale) PaintPalette();
 
    fH->SetFillStyle(fillsav);
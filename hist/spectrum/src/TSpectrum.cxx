@@ -7,6 +7,12 @@
 #include "TList.h"
 #include "TH1.h"
 #include "TMath.h"
+#include "TSpectrumFFT.h"
+#include "TROOT.h"
+#include "ROOT/TSeq.hxx"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 
 /** \class TSpectrum
     \ingroup Spectrum
@@ -2440,24 +2446,39 @@ Int_t TSpectrum::SearchHighRes(Double_t *source,Double_t *destVector, int ssize,
 //initialization of resulting vector
    for(i = 0; i < size_ext; i++)
       working_space[i] = 1;
+//for wide responses, the sums of the iterations are computed by FFT
+   TSpectrumFFT *fft = 0;
+   std::vector<Double_t> correlation;
+   if(TSpectrumFFT::IsFaster(size_ext, 1, lh_gold - 1, 0)){
+      fft = new TSpectrumFFT(size_ext, 1, working_space + size_ext, lh_gold - 1, 0);
+      correlation.resize(size_ext);
+   }
 //START OF ITERATIONS
    for(lindex = 0; lindex < deconIterations; lindex++){
+      if(fft)
+         fft->Correlate(working_space, &correlation[0]);
       for(i = 0; i < size_ext; i++){
          if(TMath::Abs(working_space[2 * size_ext + i]) > 0.00001 && TMath::Abs(working_space[i]) > 0.00001){
-            lda=0;
-            jmin = lh_gold - 1;
-            if(jmin > i)
-               jmin = i;
-
-            jmin = -jmin;
-            jmax = lh_gold - 1;
-            if(jmax > (size_ext - 1 - i))
-               jmax=size_ext-1-i;
-
-            for(j = jmin; j <= jmax; j++){
-               ldb = working_space[j + lh_gold - 1 + size_ext];
-               ldc = working_space[i + j];
-               lda = lda + ldb * ldc;
+            if(fft){
+               //the sum is at least its central term, all terms being positive
+               lda = TMath::Max(correlation[i], working_space[lh_gold - 1 + size_ext] * working_space[i]);
+            }
+            else{
+               lda=0;
+               jmin = lh_gold - 1;
+               if(jmin > i)
+                  jmin = i;
+
+               jmin = -jmin;
+               jmax = lh_gold - 1;
+               if(jmax > (size_ext - 1 - i))
+                  jmax=size_ext-1-i;
+
+               for(j = jmin; j <= jmax; j++){
+                  ldb = working_space[j + lh_gold - 1 + size_ext];
+                  ldc = working_space[i + j];
+                  lda = lda + ldb * ldc;
+               }
             }
             ldb = working_space[2 * size_ext + i];
             if(lda != 0)
@@ -2475,6 +2496,7 @@ Int_t TSpectrum::SearchHighRes(Double_t *source,Double_t *destVector, int ssize,
          working_space[i] = working_space[3 * size_ext + i];
       }
    }
+   delete fft;
 //shift resulting spectrum
    for(i=0;i<size_ext;i++){
       lda = working_space[i];
@@ -2557,6 +2579,36 @@ Int_t TSpectrum::SearchHighRes(Double_t *source,Double_t *destVector, int ssize,
    return fNPeaks;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Searches the peaks of nspectra spectra of ssize channels at once: calls
+/// spectra[k]->SearchHighRes(source[k], destVector[k], ...) with the other
+/// arguments for each k, in parallel when the implicit multi-threading is
+/// enabled. The spectra[k] must be different objects, holding the peaks of
+/// each spectrum once done.
+///
+/// As in all the calls of SearchHighRes, the convolutions of the iterations
+/// of the deconvolution are computed with fast Fourier transforms when
+/// this takes fewer operations than the direct sums, i.e. for wide peaks.
+
+void TSpectrum::SearchHighRes(TSpectrum **spectra, Int_t nspectra, Double_t **source, Double_t **destVector,
+                              Int_t ssize, Double_t sigma, Double_t threshold, bool backgroundRemove,
+                              Int_t deconIterations, bool markov, Int_t averWindow)
+{
+   auto search = [&](Int_t k) {
+      spectra[k]->SearchHighRes(source[k], destVector[k], ssize, sigma, threshold, backgroundRemove,
+                                deconIterations, markov, averWindow);
+   };
+#ifdef R__USE_IMT
+   if (nspectra > 1 && ROOT::IsImplicitMTEnabled()) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(search, ROOT::TSeqI(nspectra));
+      return;
+   }
+#endif
+   for (Int_t k = 0; k < nspectra; k++)
+      search(k);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Old name of SearcHighRes introduced for back compatibility.
 /// This function will be removed after the June 2006 release
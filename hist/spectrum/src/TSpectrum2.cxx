@@ -44,6 +44,12 @@
 #include "TList.h"
 #include "TH1.h"
 #include "TMath.h"
+#include "TSpectrumFFT.h"
+#include "TROOT.h"
+#include "ROOT/TSeq.hxx"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 #define PEAK_WINDOW 1024
 
 Int_t TSpectrum2::fgIterations    = 3;
@@ -2059,38 +2065,65 @@ Int_t TSpectrum2::SearchHighRes(Double_t **source, Double_t **dest, Int_t ssizex
          working_space[i1][i2 + 2 * ssizey_ext] = 0;
       }
    }
+   //for wide responses, the sums of the iterations are computed by FFT
+   TSpectrumFFT *fft = 0;
+   std::vector<Double_t> values, correlation;
+   if(TSpectrumFFT::IsFaster(ssizex_ext, ssizey_ext, lhx - 1, lhy - 1)){
+      std::vector<Double_t> kernel((2 * lhx - 1) * (2 * lhy - 1));
+      for(j1 = -(lhx - 1); j1 <= lhx - 1; j1++){
+         k = (j1 + ssizex_ext) / ssizex_ext;
+         for(j2 = -(lhy - 1); j2 <= lhy - 1; j2++)
+            kernel[(j1 + lhx - 1) * (2 * lhy - 1) + j2 + lhy - 1] = working_space[(j1 + ssizex_ext) % ssizex_ext][j2 + ssizey_ext + 10 * ssizey_ext + k * 2 * ssizey_ext];
+      }
+      fft = new TSpectrumFFT(ssizex_ext, ssizey_ext, &kernel[0], lhx - 1, lhy - 1);
+      values.resize(ssizex_ext * ssizey_ext);
+      correlation.resize(ssizex_ext * ssizey_ext);
+   }
    //START OF ITERATIONS
    for(lindex = 0; lindex < deconIterations; lindex++){
+      if(fft){
+         for(i1 = 0; i1 < ssizex_ext; i1++){
+            for(i2 = 0; i2 < ssizey_ext; i2++)
+               values[i1 * ssizey_ext + i2] = working_space[i1][i2 + ssizey_ext];
+         }
+         fft->Correlate(&values[0], &correlation[0]);
+      }
       for(i2 = 0; i2 < ssizey_ext; i2++){
          for(i1 = 0; i1 < ssizex_ext; i1++){
             lda = working_space[i1][i2 + ssizey_ext];
             ldc = working_space[i1][i2 + 14 * ssizey_ext];
             if(lda > 0.000001 && ldc > 0.000001){
-               ldb=0;
-               j2min=i2;
-               if(j2min > lhy - 1)
-                  j2min = lhy - 1;
-
-               j2min = -j2min;
-               j2max = ssizey_ext - i2 - 1;
-               if(j2max > lhy - 1)
-                  j2max = lhy - 1;
-
-               j1min = i1;
-               if(j1min > lhx - 1)
-                  j1min = lhx - 1;
-
-               j1min = -j1min;
-               j1max = ssizex_ext - i1 - 1;
-               if(j1max > lhx - 1)
-                  j1max = lhx - 1;
-
-               for(j2 = j2min; j2 <= j2max; j2++){
-                  for(j1 = j1min; j1 <= j1max; j1++){
-                     k = (j1 + ssizex_ext) / ssizex_ext;
-                     ldc = working_space[(j1 + ssizex_ext) % ssizex_ext][j2 + ssizey_ext + 10 * ssizey_ext + k * 2 * ssizey_ext];
-                     lda = working_space[i1 + j1][i2 + j2 + ssizey_ext];
-                     ldb = ldb + lda * ldc;
+               if(fft){
+                  //the sum is at least its central term, all terms being positive
+                  ldb = TMath::Max(correlation[i1 * ssizey_ext + i2], working_space[0][13 * ssizey_ext] * lda);
+               }
+               else{
+                  ldb=0;
+                  j2min=i2;
+                  if(j2min > lhy - 1)
+                     j2min = lhy - 1;
+
+                  j2min = -j2min;
+                  j2max = ssizey_ext - i2 - 1;
+                  if(j2max > lhy - 1)
+                     j2max = lhy - 1;
+
+                  j1min = i1;
+                  if(j1min > lhx - 1)
+                     j1min = lhx - 1;
+
+                  j1min = -j1min;
+                  j1max = ssizex_ext - i1 - 1;
+                  if(j1max > lhx - 1)
+                     j1max = lhx - 1;
+
+                  for(j2 = j2min; j2 <= j2max; j2++){
+                     for(j1 = j1min; j1 <= j1max; j1++){
+                        k = (j1 + ssizex_ext) / ssizex_ext;
+                        ldc = working_space[(j1 + ssizex_ext) % ssizex_ext][j2 + ssizey_ext + 10 * ssizey_ext + k * 2 * ssizey_ext];
+                        lda = working_space[i1 + j1][i2 + j2 + ssizey_ext];
+                        ldb = ldb + lda * ldc;
+                     }
                   }
                }
                lda = working_space[i1][i2 + ssizey_ext];
@@ -2110,6 +2143,7 @@ Int_t TSpectrum2::SearchHighRes(Double_t **source, Double_t **dest, Int_t ssizex
             working_space[i1][i2 + ssizey_ext] = working_space[i1][i2 + 2 * ssizey_ext];
       }
    }
+   delete fft;
    //looking for maximum
    maximum=0;
    for(i = 0; i < ssizex_ext; i++){
@@ -2201,6 +2235,36 @@ Int_t TSpectrum2::SearchHighRes(Double_t **source, Double_t **dest, Int_t ssizex
    return fNPeaks;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Searches the peaks of nspectra 2-D spectra of ssizex*ssizey channels at
+/// once: calls spectra[k]->SearchHighRes(source[k], dest[k], ...) with the
+/// other arguments for each k, in parallel when the implicit
+/// multi-threading is enabled. The spectra[k] must be different objects,
+/// holding the peaks of each spectrum once done.
+///
+/// As in all the calls of SearchHighRes, the convolutions of the iterations
+/// of the deconvolution are computed with fast Fourier transforms when
+/// this takes fewer operations than the direct sums, i.e. for wide peaks.
+
+void TSpectrum2::SearchHighRes(TSpectrum2 **spectra, Int_t nspectra, Double_t ***source, Double_t ***dest,
+                               Int_t ssizex, Int_t ssizey, Double_t sigma, Double_t threshold,
+                               Bool_t backgroundRemove, Int_t deconIterations, Bool_t markov, Int_t averWindow)
+{
+   auto search = [&](Int_t k) {
+      spectra[k]->SearchHighRes(source[k], dest[k], ssizex, ssizey, sigma, threshold, backgroundRemove,
+                                deconIterations, markov, averWindow);
+   };
+#ifdef R__USE_IMT
+   if (nspectra > 1 && ROOT::IsImplicitMTEnabled()) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(search, ROOT::TSeqI(nspectra));
+      return;
+   }
+#endif
+   for (Int_t k = 0; k < nspectra; k++)
+      search(k);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// static function (called by TH1), interface to TSpectrum2::Search
 
@@ -0,0 +1,163 @@
+// @(#)root/spectrum:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//
+// TSpectrumFFT
+//
+// The correlation is computed as the circular convolution of the data,
+// padded with zeros to transforms of sizes large enough for the kernel
+// not to wrap around, with the reflected kernel. The transforms are
+// radix-2 complex transforms, the transform of the kernel being
+// computed once for all the iterations.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "TSpectrumFFT.h"
+#include "TMath.h"
+
+#include <utility>
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor for data of nx*ny channels (ny=1 for 1-D data). The kernel
+/// holds (2*kx+1)*(2*ky+1) values, the one of (j1,j2) for -kx<=j1<=kx and
+/// -ky<=j2<=ky being at kernel[(j1+kx)*(2*ky+1)+j2+ky].
+
+TSpectrumFFT::TSpectrumFFT(Int_t nx, Int_t ny, const Double_t *kernel, Int_t kx, Int_t ky)
+   : fNx(nx), fNy(ny), fMx(GetTransformSize(nx + kx)), fMy(GetTransformSize(ny + ky))
+{
+   MakeTwiddles(fMx, fTwiddlesX);
+   MakeTwiddles(fMy, fTwiddlesY);
+
+   // The correlation with the kernel is the convolution with the reflected
+   // kernel; its normalization is done here once for all.
+   Double_t norm = 1. / ((Double_t)fMx * fMy);
+   fKernel.assign((size_t)fMx * fMy, Complex_t(0, 0));
+   for (Int_t j1 = -kx; j1 <= kx; j1++) {
+      Int_t r = (fMx - j1) % fMx;
+      for (Int_t j2 = -ky; j2 <= ky; j2++) {
+         Int_t c = (fMy - j2) % fMy;
+         fKernel[(size_t)r * fMy + c] = norm * kernel[(j1 + kx) * (2 * ky + 1) + j2 + ky];
+      }
+   }
+   Transform2D(fKernel, kFALSE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fills result with the correlation of x with the kernel. Both arrays
+/// hold nx*ny channels, the one of (i1,i2) being at [i1*ny+i2].
+
+void TSpectrumFFT::Correlate(const Double_t *x, Double_t *result)
+{
+   fWork.assign((size_t)fMx * fMy, Complex_t(0, 0));
+   for (Int_t i1 = 0; i1 < fNx; i1++) {
+      for (Int_t i2 = 0; i2 < fNy; i2++)
+         fWork[(size_t)i1 * fMy + i2] = x[i1 * fNy + i2];
+   }
+   Transform2D(fWork, kFALSE);
+   for (size_t i = 0; i < fWork.size(); i++)
+      fWork[i] *= fKernel[i];
+   Transform2D(fWork, kTRUE);
+   for (Int_t i1 = 0; i1 < fNx; i1++) {
+      for (Int_t i2 = 0; i2 < fNy; i2++)
+         result[i1 * fNy + i2] = fWork[(size_t)i1 * fMy + i2].real();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Returns true if computing the correlation with the transforms takes
+/// fewer operations than the direct sum, according to a rough count of
+/// 2 operations per term of the sum and 5*m*log2(m) per transform of m
+/// channels.
+
+Bool_t TSpectrumFFT::IsFaster(Int_t nx, Int_t ny, Int_t kx, Int_t ky)
+{
+   Double_t direct = 2. * nx * ny * (2. * kx + 1) * (2. * ky + 1);
+   Double_t m = (Double_t)GetTransformSize(nx + kx) * GetTransformSize(ny + ky);
+   Double_t fft = 2 * 5 * m * TMath::Log2(m) + 6 * m;
+   return direct > fft;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Returns the smallest power of 2 greater than or equal to n.
+
+Int_t TSpectrumFFT::GetTransformSize(Int_t n)
+{
+   Int_t m = 1;
+   while (m < n)
+      m <<= 1;
+   return m;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fills twiddles with the n/2 first roots of unity of order n.
+
+void TSpectrumFFT::MakeTwiddles(Int_t n, std::vector<Complex_t> &twiddles)
+{
+   twiddles.resize(n / 2);
+   for (Int_t k = 0; k < n / 2; k++)
+      twiddles[k] = std::polar(1., -2 * TMath::Pi() * k / n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// In place transform of the n (a power of 2) values of data, without
+/// normalization.
+
+void TSpectrumFFT::Transform(Complex_t *data, Int_t n, const std::vector<Complex_t> &twiddles, Bool_t inverse)
+{
+   if (n < 2) return;
+   for (Int_t i = 1, j = 0; i < n; i++) {
+      Int_t bit = n >> 1;
+      for (; j & bit; bit >>= 1)
+         j ^= bit;
+      j ^= bit;
+      if (i < j)
+         std::swap(data[i], data[j]);
+   }
+   for (Int_t len = 2; len <= n; len <<= 1) {
+      Int_t half = len / 2, step = n / len;
+      for (Int_t i = 0; i < n; i += len) {
+         for (Int_t k = 0; k < half; k++) {
+            Complex_t w = inverse ? std::conj(twiddles[k * step]) : twiddles[k * step];
+            Complex_t u = data[i + k];
+            Complex_t v = data[i + k + half] * w;
+            data[i + k] = u + v;
+            data[i + k + half] = u - v;
+         }
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// In place transform of the fMx*fMy values of data, row by row then
+/// column by column.
+
+void TSpectrumFFT::Transform2D(std::vector<Complex_t> &data, Bool_t inverse)
+{
+   if (fMy > 1) {
+      for (Int_t r = 0; r < fMx; r++)
+         Transform(&data[(size_t)r * fMy], fMy, fTwiddlesY, inverse);
+   }
+   if (fMx > 1) {
+      if (fMy == 1) {
+         Transform(&data[0], fMx, fTwiddlesX, inverse);
+         return;
+      }
+      fColumn.resize(fMx);
+      for (Int_t c = 0; c < fMy; c++) {
+         for (Int_t r = 0; r < fMx; r++)
+            fColumn[r] = data[(size_t)r * fMy + c];
+         Transform(&fColumn[0], fMx, fTwiddlesX, inverse);
+         for (Int_t r = 0; r < fMx; r++)
+            data[(size_t)r * fMy + c] = fColumn[r];
+      }
+   }
+}
@@ -0,0 +1,71 @@
+// @(#)root/spectrum:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TSpectrumFFT
+#define ROOT_TSpectrumFFT
+
+//////////////////////////////////////////////////////////////////////////
+//
+// TSpectrumFFT
+//
+// Internal helper of the Gold deconvolution of TSpectrum::SearchHighRes
+// and TSpectrum2::SearchHighRes. It computes, with fast Fourier
+// transforms, the correlation of a 1-D or 2-D array with a fixed kernel,
+// the data being zero outside of the array:
+//
+//    result(i1,i2) = sum kernel(j1,j2) * x(i1+j1,i2+j2)
+//
+// for -kx <= j1 <= kx and -ky <= j2 <= ky. This is what each iteration of
+// the deconvolution computes, in O(n*m) operations for n channels and a
+// kernel of m channels, while the transforms take O(n*log(n)).
+//
+// This class is not part of the dictionary.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_Rtypes
+#include "Rtypes.h"
+#endif
+
+#include <complex>
+#include <vector>
+
+class TSpectrumFFT {
+public:
+   TSpectrumFFT(Int_t nx, Int_t ny, const Double_t *kernel, Int_t kx, Int_t ky);
+
+   void Correlate(const Double_t *x, Double_t *result);
+
+   static Bool_t IsFaster(Int_t nx, Int_t ny, Int_t kx, Int_t ky);
+
+private:
+   typedef std::complex<Double_t> Complex_t;
+
+   TSpectrumFFT(const TSpectrumFFT &);            // Not implemented
+   TSpectrumFFT &operator=(const TSpectrumFFT &); // Not implemented
+
+   static Int_t GetTransformSize(Int_t n);
+   static void  MakeTwiddles(Int_t n, std::vector<Complex_t> &twiddles);
+   static void  Transform(Complex_t *data, Int_t n, const std::vector<Complex_t> &twiddles, Bool_t inverse);
+   void         Transform2D(std::vector<Complex_t> &data, Bool_t inverse);
+
+   Int_t                  fNx;       // first dimension of the data
+   Int_t                  fNy;       // second dimension of the data (1 for 1-D)
+   Int_t                  fMx;       // first dimension of the transforms, a power of 2
+   Int_t                  fMy;       // second dimension of the transforms, a power of 2 (1 for 1-D)
+   std::vector<Complex_t> fTwiddlesX;// roots of unity of order fMx
+   std::vector<Complex_t> fTwiddlesY;// roots of unity of order fMy
+   std::vector<Complex_t> fKernel;   // transform of the reflected kernel
+   std::vector<Complex_t> fWork;     // transform of the data
+   std::vector<Complex_t> fColumn;   // one column of the 2-D transforms
+};
+
+#endif
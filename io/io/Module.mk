@@ -18,7 +18,8 @@ IODS         := $(call stripsrc,$(MODDIRS)/G__RIO.cxx)
 IODO         := $(IODS:.cxx=.o)
 IODH         := $(IODS:.cxx=.h)
 
-IOH          := $(filter-out $(MODDIRI)/LinkDef%,$(wildcard $(MODDIRI)/*.h))
+IOH          := $(filter-out $(MODDIRI)/LinkDef%,$(wildcard $(MODDIRI)/*.h)) \
+                $(MODDIRI)/ROOT/TBufferMerger.hxx
 IOS          := $(filter-out $(MODDIRS)/G__%,$(wildcard $(MODDIRS)/*.cxx))
 IOO          := $(call stripsrc,$(IOS:.cxx=.o))
 
@@ -28,19 +29,27 @@ IOLIB        := $(LPATH)/libRIO.$(SOEXT)
 IOMAP        := $(IOLIB:.$(SOEXT)=.rootmap)
 
 # used in the main Makefile
-ALLHDRS      += $(patsubst $(MODDIRI)/%.h,include/%.h,$(IOH))
+ALLHDRS      += $(patsubst $(MODDIRI)/%,include/%,$(IOH))
 ALLLIBS      += $(IOLIB)
 ALLMAPS      += $(IOMAP)
 
 # include all dependency files
 INCLUDEFILES += $(IODEP)
 
+ifneq ($(BUILTINZLIB),yes)
+IOLIBEXTRA   += $(ZLIBLIBDIR) $(ZLIBCLILIB)
+endif
+
 ##### local rules #####
 .PHONY:         all-$(MODNAME) clean-$(MODNAME) distclean-$(MODNAME)
 
 include/%.h:    $(IODIRI)/%.h
 		cp $< $@
 
+include/%.hxx:  $(IODIRI)/%.hxx
+		mkdir -p include/ROOT
+		cp $< $@
+
 $(IOLIB):       $(IOO) $(IODO) $(ORDER_) $(MAINLIBS) $(IOLIBDEP)
 		@$(MAKELIB) $(PLATFORM) $(LD) "$(LDFLAGS)" \
 		   "$(SOFLAGS)" libRIO.$(SOEXT) $@ "$(IOO) $(IODO)" \
@@ -16,6 +16,7 @@
 
 #pragma link C++ class TBufferFile;
 #pragma link C++ class TBufferJSON;
+#pragma link C++ class TCompressionDictionaries+;
 #pragma link C++ class TDirectoryFile-;
 #pragma link C++ class TFile-;
 #pragma link C++ class TFileCacheRead+;
@@ -27,6 +28,8 @@
 #pragma link C++ class TMapFile;
 #pragma link C++ class TMapRec;
 #pragma link C++ class TMemFile;
+#pragma link C++ class ROOT::Experimental::TBufferMerger-;
+#pragma link C++ class ROOT::Experimental::TBufferMergerFile;
 #pragma link C++ class TArchiveFile+;
 #pragma link C++ class TArchiveMember+;
 #pragma link C++ class TZIPFile+;
@@ -0,0 +1,143 @@
+// @(#)root/io:$Id$
+// Author: ROOT I/O team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TBufferMerger
+#define ROOT_TBufferMerger
+
+#include "TMemFile.h"
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+
+class TBufferFile;
+
+namespace ROOT {
+namespace Experimental {
+
+class TBufferMergerFile;
+
+/**
+ * \class TBufferMerger TBufferMerger.hxx
+ * \ingroup IO
+ *
+ * TBufferMerger is a class to facilitate writing data in
+ * parallel from multiple threads, while writing to a single
+ * output file. Its purpose is similar to TParallelMergingFile,
+ * but instead of using processes that connect to a network
+ * socket, TBufferMerger uses threads that each write to a
+ * TBufferMergerFile, which in turn push data into a queue
+ * managed by the TBufferMerger. A background thread takes the
+ * buffers from the queue and merges them into the output file
+ * with TFileMerger in incremental mode.
+ */
+
+class TBufferMerger {
+public:
+   /** Constructor
+    * @param name Output file name
+    * @param option Output file creation options
+    * @param compress Output file compression level
+    */
+   TBufferMerger(const char *name, Option_t *option = "RECREATE", Int_t compress = 1);
+
+   /** Destructor. Waits until all the queued buffers are merged and
+    *  the output file is written. */
+   virtual ~TBufferMerger();
+
+   /** Returns a TBufferMergerFile to which data can be written.
+    *  At the end, all TBufferMergerFiles get merged into the output file.
+    *  The user is responsible to "cd" into the file to associate objects
+    *  such as histograms or trees to it.
+    *  Each thread must use its own TBufferMergerFile; no lock is taken
+    *  while filling it.
+    */
+   std::shared_ptr<TBufferMergerFile> GetFile();
+
+   /** Returns the number of buffers currently waiting to be merged. */
+   size_t GetQueueSize() const;
+
+   /** Register a user callback function to be called after a buffer
+    *  has been merged into the output file. The callback is run on the
+    *  merging thread. */
+   void RegisterCallback(const std::function<void(void)> &f);
+
+   friend class TBufferMergerFile;
+
+private:
+   TBufferMerger(const TBufferMerger &) = delete;
+   TBufferMerger &operator=(const TBufferMerger &) = delete;
+
+   void Push(TBufferFile *buffer);
+   void WriteOutputFile();
+
+   const std::string fName;                     ///< Name of the output file
+   const std::string fOption;                   ///< Creation option of the output file
+   const Int_t fCompress;                       ///< Compression settings of the output file
+   mutable std::mutex fQueueMutex;              ///< Mutex used to lock fQueue and fCallback
+   std::condition_variable fDataAvailable;      ///< Condition variable used to wait for data
+   std::queue<TBufferFile *> fQueue;            ///< Queue to which data is pushed and merged
+   std::function<void(void)> fCallback;         ///< Callback for when data is removed from queue
+   std::unique_ptr<std::thread> fMergingThread; ///< Worker thread that writes to disk, started last
+};
+
+/**
+ * \class TBufferMergerFile TBufferMerger.hxx
+ * \ingroup IO
+ *
+ * A TBufferMergerFile is similar to a TMemFile, but when data
+ * is written to it, it is appended to the TBufferMerger queue.
+ * The TBufferMerger object then merges the data into the output
+ * file, and the TBufferMergerFile is reset (see TMemFile::ResetAfterMerge)
+ * so that the worker can keep filling it.
+ * TBufferMergerFile objects can only be created by TBufferMerger::GetFile().
+ */
+
+class TBufferMergerFile : public TMemFile {
+private:
+   TBufferMerger &fMerger; ///< TBufferMerger this file is attached to
+
+   /** Constructor. Can only be called by TBufferMerger.
+    * @param m Merger this file is attached to. */
+   TBufferMergerFile(TBufferMerger &m);
+
+   TBufferMergerFile() = delete;
+   TBufferMergerFile(const TBufferMergerFile &) = delete;
+   TBufferMergerFile &operator=(const TBufferMergerFile &) = delete;
+
+   friend class TBufferMerger;
+
+public:
+   /** Destructor */
+   ~TBufferMergerFile();
+
+   using TMemFile::Write;
+
+   /** Write data into a TBufferFile and append it to TBufferMerger.
+    * @param name Name
+    * @param opt  Options
+    * @param bufsize Buffer size
+    * This function must be called before the TBufferMergerFile gets destroyed,
+    * or no data is appended to the TBufferMerger.
+    */
+   virtual Int_t Write(const char *name = nullptr, Int_t opt = 0, Int_t bufsize = 0) override;
+
+   ClassDefOverride(TBufferMergerFile, 0);
+};
+
+} // namespace Experimental
+} // namespace ROOT
+
+#endif
@@ -0,0 +1,70 @@
+// @(#)root/io:$Id$
+// Author: ROOT I/O team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TBufferPool
+#define ROOT_TBufferPool
+
+#ifndef ROOT_TBuffer
+#include "TBuffer.h"
+#endif
+
+#include <cstddef>
+
+namespace ROOT {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// A per-thread cache of the memory blocks used to read the records of the
+/// files (compressed and uncompressed baskets, keys).
+///
+/// The blocks are grouped in size classes (four per power of two, from 1 kB
+/// to 224 MB): a block released by a thread is reused by the next request
+/// of the same class on that thread, without going through the allocator
+/// nor taking any lock. Each thread keeps at most GetMaxCachedBytes() bytes
+/// of free blocks; beyond this the blocks are deleted.
+///
+/// The blocks are allocated with new[], so that a block which is not given
+/// back to the pool can always be deleted with delete[]: a TBuffer using a
+/// block of the pool (see CreateBuffer) can be deleted as any other one,
+/// DeleteBuffer and ReleaseBuffer only give the memory back to the pool.
+class TBufferPool {
+public:
+   /// Statistics of the pool of a thread.
+   struct Stats_t {
+      ULong64_t fAcquired;    ///< Number of blocks requested
+      ULong64_t fReused;      ///< Number of requests served by a cached block
+      ULong64_t fReleased;    ///< Number of blocks given back
+      ULong64_t fDropped;     ///< Number of blocks given back but deleted (cache full, too large)
+      Long64_t  fCachedBytes; ///< Bytes currently cached
+      Long64_t  fHighWater;   ///< Maximum of fCachedBytes
+   };
+
+   static char    *Acquire(Int_t size);
+   static void     Release(char *block, Int_t size);
+   static char    *ReAlloc(char *block, size_t size, size_t oldsize);
+
+   static TBuffer *CreateBuffer(TBuffer::EMode mode, Int_t size);
+   static void     AdoptBlock(TBuffer &buffer, char *block, Int_t size);
+   static Bool_t   IsPooled(const TBuffer &buffer);
+   static void     ReleaseBuffer(TBuffer &buffer);
+   static void     DeleteBuffer(TBuffer *buffer);
+
+   static void     Clear();
+   static Long64_t GetMaxCachedBytes();
+   static void     SetMaxCachedBytes(Long64_t bytes);
+   static Stats_t  GetStats();
+   static void     Print();
+};
+
+} // End of namespace Internal
+} // End of namespace ROOT
+
+#endif // ROOT_TBufferPool
@@ -23,6 +23,7 @@
 #endif
 
 #include <map>
+#include <iosfwd>
 
 class TVirtualStreamerInfo;
 class TStreamerInfo;
@@ -31,6 +32,7 @@ class TObjArray;
 class TMemberStreamer;
 class TDataMember;
 class TJSONStackObj;
+class TJSONOutput;
 
 
 class TBufferJSON : public TBuffer {
@@ -46,6 +48,9 @@ public:
    static TString   ConvertToJSON(const void *obj, const TClass *cl, Int_t compact = 0, const char *member_name = 0);
    static TString   ConvertToJSON(const void *obj, TDataMember *member, Int_t compact = 0, Int_t arraylen = -1);
 
+   static Long64_t  StreamToJSON(TString &out, const void *obj, const TClass *cl, Int_t compact = 0, const char *member_name = 0);
+   static Long64_t  StreamToJSON(std::ostream &out, const void *obj, const TClass *cl, Int_t compact = 0, const char *member_name = 0);
+
    static Int_t     ExportToFile(const char* filename, const TObject *obj, const char* option = 0);
    static Int_t     ExportToFile(const char* filename, const void *obj, const TClass *cl, const char* option = 0);
 
@@ -453,7 +458,13 @@ protected:
 
    void              JsonStreamCollection(TCollection *obj, const TClass *objClass);
 
+   template <typename T>
+   void              JsonWriteArrayContent(const T *vname, Int_t arrsize);
+
    void              AppendOutput(const char *line0, const char *line1 = 0);
+   void              FlushOutput();
+
+   static Long64_t   StreamToJSON(TJSONOutput &out, const void *obj, const TClass *cl, Int_t compact, const char *member_name);
 
    TString                   fOutBuffer;    //!  main output buffer for json code
    TString                  *fOutput;       //!  current output buffer for json code
@@ -463,6 +474,9 @@ protected:
    TObjArray                 fStack;        //!  stack of streamer infos
    Bool_t                    fExpectedChain; //!   flag to resolve situation when several elements of same basic type stored as FastArray
    Int_t                     fCompact;       //!  0 - no any compression, 1 - no spaces in the begin, 2 - no new lines, 3 - no spaces at all
+   Int_t                     fArrayCompact;  //!  0 - plain arrays, 1 - zeros suppressed, 2 - zeros and repeated values suppressed
+   TJSONOutput              *fStreamOutput;  //!  destination of the complete chunks of json code, 0 if all code is kept in fOutBuffer
+   Long64_t                  fStreamed;      //!  number of bytes already given to fStreamOutput
    TString                   fSemicolon;     //!  depending from compression level, " : " or ":"
    TString                   fArraySepar;    //!  depending from compression level, ", " or ","
    TString                   fNumericLocale; //!  stored value of setlocale(LC_NUMERIC), which should be recovered at the end
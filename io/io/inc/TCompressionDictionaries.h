@@ -0,0 +1,56 @@
+// @(#)root/io:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TCompressionDictionaries
+#define ROOT_TCompressionDictionaries
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TCompressionDictionaries                                             //
+//                                                                      //
+// Zstd dictionaries used to compress the small buffers of a file,      //
+// stored in the file so that it can be read back.                      //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TObject
+#include "TObject.h"
+#endif
+
+#include <string>
+#include <vector>
+
+class TDirectory;
+
+class TCompressionDictionaries : public TObject {
+
+protected:
+   std::vector<UInt_t>      fIDs;      ///<  Ids of the dictionaries, as found in the compressed frames
+   std::vector<std::string> fContents; ///<  Content of the dictionaries
+
+public:
+   TCompressionDictionaries();
+   virtual ~TCompressionDictionaries();
+
+   Bool_t         Add(UInt_t id);
+   Bool_t         Contains(UInt_t id) const;
+   Int_t          GetSize() const { return fIDs.size(); }
+   Int_t          Register() const;
+
+   static const char *GetKeyName() { return "CompressionDictionaries"; }
+   static Int_t   Load(TDirectory *file);
+   static Int_t   Save(TDirectory *file, const std::vector<UInt_t> &ids);
+   static Int_t   Copy(TDirectory *from, TDirectory *to);
+
+   ClassDef(TCompressionDictionaries,1);  //Zstd dictionaries of the buffers of a file
+};
+
+#endif
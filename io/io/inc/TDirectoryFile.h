@@ -30,6 +30,12 @@ class TBrowser;
 class TKey;
 class TFile;
 
+namespace ROOT {
+namespace Internal {
+class TDirectoryFileLazyKeys;
+}
+}
+
 class TDirectoryFile : public TDirectory {
 
 protected:
@@ -45,9 +51,15 @@ protected:
    Long64_t    fSeekKeys;        ///< Location of Keys record on file
    TFile      *fFile;            ///< Pointer to current file in memory
    TList      *fKeys;            ///< Pointer to keys list in memory
+   ROOT::Internal::TDirectoryFileLazyKeys *fLazyKeys; ///<! Keys record not (fully) read yet, see ReadKeysLazy
 
    virtual void         CleanTargets();
    void Init(TClass *cl = 0);
+   void  LoadKeys(const char *name) const;
+   void  LoadAllKeys() const;
+   void  ReadKeysLazy();
+   void  ReadAllConcurrently();
+   Int_t WriteAllConcurrently(Int_t opt, Int_t bufsize);
 
 private:
    TDirectoryFile(const TDirectoryFile &directory);  //Directories cannot be copied
@@ -88,10 +100,10 @@ public:
    const TDatime      &GetCreationDate() const { return fDatimeC; }
    virtual TFile      *GetFile() const { return fFile; }
    virtual TKey       *GetKey(const char *name, Short_t cycle=9999) const;
-   virtual TList      *GetListOfKeys() const { return fKeys; }
+   virtual TList      *GetListOfKeys() const { if (fLazyKeys) LoadAllKeys(); return fKeys; }
    const TDatime      &GetModificationDate() const { return fDatimeM; }
    virtual Int_t       GetNbytesKeys() const { return fNbytesKeys; }
-   virtual Int_t       GetNkeys() const { return fKeys->GetSize(); }
+   virtual Int_t       GetNkeys() const { return GetListOfKeys()->GetSize(); }
    virtual Long64_t    GetSeekDir() const { return fSeekDir; }
    virtual Long64_t    GetSeekParent() const { return fSeekParent; }
    virtual Long64_t    GetSeekKeys() const { return fSeekKeys; }
@@ -46,6 +46,7 @@ class TFileCacheWrite;
 class TProcessID;
 class TStopwatch;
 class TFilePrefetch;
+class TMD5;
 
 class TFile : public TDirectoryFile {
   friend class TDirectoryFile;
@@ -91,12 +92,17 @@ protected:
    TMap            *fCacheReadMap;   ///<!Pointer to the read cache (if any)
    TFileCacheWrite *fCacheWrite;     ///<!Pointer to the write cache (if any)
    Long64_t         fArchiveOffset;  ///<!Offset at which file starts in archive
+   char            *fMapped;         ///<!Start of the memory mapping of the file (option mmap=1), 0 if not mapped
+   Long64_t         fMappedSize;     ///<!Size of the memory mapping of the file
    Bool_t           fIsArchive : 1;  ///<!True if this is a pure archive file
    Bool_t           fNoAnchorInName : 1; ///<!True if we don't want to force the anchor to be appended to the file name
    Bool_t           fIsRootFile : 1; ///<!True is this is a ROOT file, raw file otherwise
    Bool_t           fInitDone : 1;   ///<!True if the file has been initialized
    Bool_t           fMustFlush : 1;  ///<!True if the file buffers must be flushed
    Bool_t           fIsPcmFile : 1;  ///<!True if the file is a ROOT pcm file.
+   Bool_t           fLazyInit : 1;   ///<!True if the keys and the StreamerInfo are read on demand (option lazy=1)
+   Bool_t           fReadingInfo;    ///<!True while the StreamerInfo record is read on demand
+   std::atomic<Bool_t> fInfoPending; ///<!True if the StreamerInfo record is still to be read (option lazy=1)
    TFileOpenHandle *fAsyncHandle;    ///<!For proper automatic cleanup
    EAsyncOpenStatus fAsyncOpenStatus; ///<!Status of an asynchronous open request
    TUrl             fUrl;            ///<!URL of file
@@ -124,8 +130,14 @@ protected:
    static Bool_t    fgReadInfo;              ///<if true (default) ReadStreamerInfo is called when opening a file
    virtual EAsyncOpenStatus GetAsyncOpenStatus() { return fAsyncOpenStatus; }
    virtual void  Init(Bool_t create);
+   void          CountProcessIDs();
    Bool_t        FlushWriteCache();
    Int_t         ReadBufferViaCache(char *buf, Int_t len);
+   void          ReadStreamerInfoOnDemand();
+   Bool_t        ReadBufferMapped(char *buf, Long64_t pos, Int_t len);
+   Bool_t        ReadBuffersVectored(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf);
+   void          MapFile();
+   void          UnmapFile();
    Int_t         WriteBufferViaCache(const char *buf, Int_t len);
 
    // Creating projects
@@ -152,6 +164,8 @@ private:
    void operator=(const TFile &);
 
    static void   CpProgress(Long64_t bytesread, Long64_t size, TStopwatch &watch);
+   Bool_t        CpChunks(TFile *dfile, Bool_t progressbar, UInt_t buffersize, Int_t nchunks,
+                          TMD5 *md5, TStopwatch &watch);
    static TFile *OpenFromCache(const char *name, Option_t * = "",
                                const char *ftitle = "", Int_t compress = 1,
                                Int_t netopt = 0);
@@ -174,9 +188,11 @@ public:
    TFile();
    TFile(const char *fname, Option_t *option="", const char *ftitle="", Int_t compress=1);
    virtual ~TFile();
+   virtual Bool_t      CanWriteAsync() const;
    virtual void        Close(Option_t *option=""); // *MENU*
    virtual void        Copy(TObject &) const { MayNotUse("Copy(TObject &)"); }
-   virtual Bool_t      Cp(const char *dst, Bool_t progressbar = kTRUE,UInt_t buffersize = 1000000);
+   virtual Bool_t      Cp(const char *dst, Bool_t progressbar = kTRUE,UInt_t buffersize = 1000000,
+                          Int_t nchunks = 1, TMD5 *md5 = 0);
    virtual TKey*       CreateKey(TDirectory* mother, const TObject* obj, const char* name, Int_t bufsize);
    virtual TKey*       CreateKey(TDirectory* mother, const void* obj, const TClass* cl,
                                  const char* name, Int_t bufsize);
@@ -205,7 +221,7 @@ public:
    TObjArray          *GetListOfProcessIDs() const {return fProcessIDs;}
    TList              *GetListOfFree() const { return fFree; }
    virtual Int_t       GetNfree() const { return fFree->GetSize(); }
-   virtual Int_t       GetNProcessIDs() const { return fNProcessIDs; }
+   virtual Int_t       GetNProcessIDs() const;
    Option_t           *GetOption() const { return fOption.Data(); }
    virtual Long64_t    GetBytesRead() const { return fBytesRead; }
    virtual Long64_t    GetBytesReadExtra() const { return fBytesReadExtra; }
@@ -226,6 +242,8 @@ public:
    virtual void        IncrementProcessIDs() { fNProcessIDs++; }
    virtual Bool_t      IsArchive() const { return fIsArchive; }
            Bool_t      IsBinary() const { return TestBit(kBinaryFile); }
+           Bool_t      IsLazyInit() const { return fLazyInit; }
+           Bool_t      IsMapped() const { return fMapped != 0; }
            Bool_t      IsRaw() const { return !fIsRootFile; }
    virtual Bool_t      IsOpen() const;
    virtual void        ls(Option_t *option="") const;
@@ -244,6 +262,7 @@ public:
    virtual void        ReadFree();
    virtual TProcessID *ReadProcessID(UShort_t pidf);
    virtual void        ReadStreamerInfo();
+           void        ReadPendingStreamerInfo() { if (fInfoPending) ReadStreamerInfoOnDemand(); }
    virtual Int_t       Recover();
    virtual Int_t       ReOpen(Option_t *mode);
    virtual void        Seek(Long64_t offset, ERelativeTo pos = kBeg);
@@ -260,6 +279,7 @@ public:
    virtual Int_t       Sizeof() const;
    void                SumBuffer(Int_t bufsize);
    virtual Bool_t      WriteBuffer(const char *buf, Int_t len);
+   virtual Bool_t      WriteBufferAt(const char *buf, Long64_t pos, Int_t len);
    virtual Int_t       Write(const char *name=0, Int_t opt=0, Int_t bufsiz=0);
    virtual Int_t       Write(const char *name=0, Int_t opt=0, Int_t bufsiz=0) const;
    virtual void        WriteFree();
@@ -302,7 +322,7 @@ public:
    static const char  *GetCacheFileDir();
    static Bool_t       ShrinkCacheFileDir(Long64_t shrinkSize, Long_t cleanupInteval = 0);
    static Bool_t       Cp(const char *src, const char *dst, Bool_t progressbar = kTRUE,
-                          UInt_t buffersize = 1000000);
+                          UInt_t buffersize = 1000000, Int_t nchunks = 1, TMD5 *md5 = 0);
 
    static UInt_t       SetOpenTimeout(UInt_t timeout);  // in ms
    static UInt_t       GetOpenTimeout(); // in ms
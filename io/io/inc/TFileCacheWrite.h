@@ -18,6 +18,12 @@
 
 class TFile;
 
+namespace ROOT {
+namespace Internal {
+class TFileCacheWriteAsync;
+}
+}
+
 class TFileCacheWrite : public TObject {
 
 protected:
@@ -27,6 +33,11 @@ protected:
    TFile        *fFile;           ///< Pointer to file
    char         *fBuffer;         ///< [fBufferSize] buffer of contiguous prefetched blocks
    Bool_t        fRecursive;      ///< flag to avoid recursive calls
+   Bool_t        fAsyncWriting;   ///<! Write the full buffers in a background thread
+   ROOT::Internal::TFileCacheWriteAsync *fAsync; ///<! Background writer, 0 if not started
+
+   Bool_t        FlushAsync();
+   Bool_t        WaitAsync();
 
 private:
    TFileCacheWrite(const TFileCacheWrite &);            //cannot be copied
@@ -38,9 +49,11 @@ public:
    virtual ~TFileCacheWrite();
    virtual Bool_t      Flush();
    virtual Int_t       GetBytesInCache() const { return fNtot; }
+   virtual Bool_t      IsAsyncWriting() const { return fAsyncWriting; }
    virtual void        Print(Option_t *option="") const;
    virtual Int_t       ReadBuffer(char *buf, Long64_t pos, Int_t len);
    virtual Int_t       WriteBuffer(const char *buf, Long64_t pos, Int_t len);
+   virtual void        SetAsyncWriting(Bool_t async = kTRUE);
    virtual void        SetFile(TFile *file);
 
    ClassDef(TFileCacheWrite,1)  //TFile cache when writing
@@ -19,10 +19,12 @@ class TGenCollectionStreamer : public TGenCollectionProxy {
 protected:
    void ReadMapHelper(StreamHelper *i, Value *v, Bool_t vsn3,  TBuffer &b);
    void ReadMap(int nElements, TBuffer &b, const TClass *onfileClass);
+   Bool_t ReadMapFundamental(int nElements, TBuffer &b, char *temp);
    void ReadPairFromMap(int nElements, TBuffer &b);
    void ReadObjects(int nElements, TBuffer &b, const TClass *onfileClass);
    void ReadPrimitives(int nElements, TBuffer &b, const TClass *onfileClass);
    void WriteMap(int nElements, TBuffer &b);
+   Bool_t WriteMapFundamental(int nElements, TBuffer &b);
    void WriteObjects(int nElements, TBuffer &b);
    void WritePrimitives(int nElements, TBuffer &b);
 
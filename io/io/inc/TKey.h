@@ -31,11 +31,16 @@ class TKey : public TNamed {
 
 private:
    enum EStatusBits {
-      kIsDirectoryFile = BIT(14)
+      kIsDirectoryFile  = BIT(14),
+      kBufferPrefetched = BIT(16)   ///< The object record is already in fBufferRef (see TDirectoryFile::ReadAll)
    };
    TKey(const TKey&);            // TKey objects are not copiable.
    TKey& operator=(const TKey&); // TKey objects are not copiable.
 
+   TKey(const TObject *obj, const char *name, Int_t bufsize, TDirectory* motherDir, Bool_t delayCompression);
+
+   friend class TDirectoryFile;
+
 protected:
    Int_t       fVersion;     ///< Key version identifier
    Int_t       fNbytes;      ///< Number of bytes for the object on file
@@ -57,6 +62,10 @@ protected:
            void     Build(TDirectory* motherDir, const char* classname, Long64_t filepos);
    virtual void     Reset(); // Currently only for the use of TBasket.
    virtual Int_t    WriteFileKeepBuffer(TFile *f = 0);
+           Int_t    CompressBuffer();
+           void     FinalizeBuffer(Int_t nzip);
+           Bool_t   ReadObjBuffer();
+           Bool_t   UnzipObjBuffer();
 
 
  public:
@@ -108,6 +108,8 @@ public:
    Bool_t        cd(const char *path = 0);
 
    void          Add(const TObject *obj, const char *name = "");
+   Double_t     *AddShared(const TObject *obj, const char *name = "");
+   Double_t     *GetSharedBins(const char *name, Int_t *nbins = 0);
    void          Update(TObject *obj = 0);
    TObject      *Remove(TObject *obj) { return Remove(obj, kTRUE); }
    TObject      *Remove(const char *name) { return Remove(name, kTRUE); }
@@ -117,6 +119,7 @@ public:
    static TMapFile *Create(const char *name, Option_t *option="READ", Int_t size=kDefaultMapSize, const char *title="");
    static TMapFile *WhichMapFile(void *addr);
    static void      SetMapAddress(Long_t addr);
+   static void      AtomicAdd(Double_t *bin, Double_t w);
 
    ClassDef(TMapFile,0)  // Memory mapped directory structure
 };
@@ -143,6 +146,8 @@ private:
    TObject         *fObject;     ///< Pointer to original object
    void            *fBuffer;     ///< Buffer containing object of class name
    Int_t            fBufSize;    ///< Buffer size
+   Double_t        *fBins;       ///< Shared content of the array of the object (see TMapFile::AddShared)
+   Int_t            fNbins;      ///< Number of elements of fBins
    TMapRec         *fNext;       ///< Next MapRec in list
 
    TMapRec(const TMapRec&);            // Not implemented.
@@ -155,6 +160,8 @@ public:
    const char   *GetClassName(Long_t offset = 0) const { return (char *)((Long_t) fClassName + offset); }
    void         *GetBuffer(Long_t offset = 0) const { return (void *)((Long_t) fBuffer + offset); }
    Int_t         GetBufSize() const { return fBufSize; }
+   Double_t     *GetBins(Long_t offset = 0) const { return fBins ? (Double_t *)((Long_t) fBins + offset) : 0; }
+   Int_t         GetNbins() const { return fNbins; }
    TObject      *GetObject() const;
    TMapRec      *GetNext(Long_t offset = 0) const { return (TMapRec *)((Long_t) fNext + offset); }
 };
@@ -16,8 +16,21 @@
 #include "TFile.h"
 #endif
 
+#include <vector>
+
 class TMemFile : public TFile {
 
+public:
+   /// A region of memory: the external buffer read by a TMemFile (see
+   /// TMemFile(const char*, const ZeroCopyView_t&)), or one of the blocks of
+   /// a TMemFile (see GetBlockViews()).
+   struct ZeroCopyView_t {
+      const char *fStart; ///< First byte of the region
+      Long64_t    fSize;  ///< Number of bytes of the region
+
+      ZeroCopyView_t(const char *start, Long64_t size) : fStart(start), fSize(size) {}
+   };
+
 private:
    struct TMemBlock {
    private:
@@ -40,6 +53,7 @@ private:
    Long64_t     fSysOffset;   ///< Seek offset in file
    TMemBlock   *fBlockSeek;   ///< Pointer to the block we seeked to.
    Long64_t     fBlockOffset; ///< Seek offset within the block
+   Bool_t       fIsOwnedByROOT; ///< kFALSE if fBlockList holds an external buffer, which is neither written nor deleted
 
    static Long64_t fgDefaultBlockSize;
 
@@ -61,12 +75,15 @@ private:
 public:
    TMemFile(const char *name, Option_t *option="", const char *ftitle="", Int_t compress=1);
    TMemFile(const char *name, char *buffer, Long64_t size, Option_t *option="", const char *ftitle="", Int_t compress=1);
+   TMemFile(const char *name, const ZeroCopyView_t &datarange, const char *ftitle="");
    TMemFile(const TMemFile &orig);
    virtual ~TMemFile();
 
    virtual Long64_t CopyTo(void *to, Long64_t maxsize) const;
    virtual void     CopyTo(TBuffer &tobuf) const;
    virtual Long64_t GetSize() const;
+   std::vector<ZeroCopyView_t> GetBlockViews() const;
+   Bool_t IsExternalBuffer() const { return !fIsOwnedByROOT; }
 
    void ResetAfterMerge(TFileMergeInfo *);
    void ResetErrno() const;
@@ -285,6 +285,7 @@ public:
    virtual TClassStreamer *GenExplicitClassStreamer( const ::ROOT::Detail::TCollectionProxyInfo &info, TClass *cl );
 
    static TStreamerElement   *GetCurrentElement();
+   static Int_t        CompileAll(const char *classes = "*");
 
 public:
    // For access by the StreamerInfoActions.
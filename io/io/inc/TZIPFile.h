@@ -16,6 +16,9 @@
 #include "TArchiveFile.h"
 #endif
 
+#include <string>
+#include <vector>
+
 class TZIPMember;
 
 
@@ -130,6 +133,8 @@ protected:
       kDEFLATED            = 8             ///< Stored using deflate
    };
 
+   struct TWriter; ///< Writer of the archives created by MakeArchive()
+
    TZIPFile(const TZIPFile&); // Not implemented
    TZIPFile& operator=(const TZIPFile&); // Not implemented
 
@@ -143,6 +148,8 @@ public:
 
    void          Print(Option_t *option = "") const;
 
+   static Int_t  MakeArchive(const char *archive, const std::vector<std::string> &files, Option_t *option = "");
+
    ClassDef(TZIPFile,1)  //A ZIP archive file
 };
 
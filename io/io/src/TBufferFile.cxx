@@ -40,8 +40,8 @@ The concrete implementation of TBuffer for writing/reading to/from a ROOT file o
 #include "TArrayC.h"
 #include "TROOT.h"
 
-#if (defined(__linux) || defined(__APPLE__)) && defined(__i386__) && \
-     defined(__GNUC__)
+// The array byte swapping routines pick vectorized kernels at run time.
+#ifdef R__BYTESWAP
 #define USE_BSWAPCPY
 #endif
 
@@ -889,8 +889,13 @@ Int_t TBufferFile::ReadArray(Long64_t *&ll)
    if (!ll) ll = new Long64_t[n];
 
 #ifdef R__BYTESWAP
+# ifdef USE_BSWAPCPY
+   bswapcpy64(ll, fBufCur, n);
+   fBufCur += l;
+# else
    for (int i = 0; i < n; i++)
       frombuf(fBufCur, &ll[i]);
+# endif
 #else
    memcpy(ll, fBufCur, l);
    fBufCur += l;
@@ -950,8 +955,13 @@ Int_t TBufferFile::ReadArray(Double_t *&d)
    if (!d) d = new Double_t[n];
 
 #ifdef R__BYTESWAP
+# ifdef USE_BSWAPCPY
+   bswapcpy64(d, fBufCur, n);
+   fBufCur += l;
+# else
    for (int i = 0; i < n; i++)
       frombuf(fBufCur, &d[i]);
+# endif
 #else
    memcpy(d, fBufCur, l);
    fBufCur += l;
@@ -1159,8 +1169,13 @@ Int_t TBufferFile::ReadStaticArray(Long64_t *ll)
    if (!ll) return 0;
 
 #ifdef R__BYTESWAP
+# ifdef USE_BSWAPCPY
+   bswapcpy64(ll, fBufCur, n);
+   fBufCur += l;
+# else
    for (int i = 0; i < n; i++)
       frombuf(fBufCur, &ll[i]);
+# endif
 #else
    memcpy(ll, fBufCur, l);
    fBufCur += l;
@@ -1218,8 +1233,13 @@ Int_t TBufferFile::ReadStaticArray(Double_t *d)
    if (!d) return 0;
 
 #ifdef R__BYTESWAP
+# ifdef USE_BSWAPCPY
+   bswapcpy64(d, fBufCur, n);
+   fBufCur += l;
+# else
    for (int i = 0; i < n; i++)
       frombuf(fBufCur, &d[i]);
+# endif
 #else
    memcpy(d, fBufCur, l);
    fBufCur += l;
@@ -1396,8 +1416,13 @@ void TBufferFile::ReadFastArray(Long64_t *ll, Int_t n)
    if (l <= 0 || l > fBufSize) return;
 
 #ifdef R__BYTESWAP
+# ifdef USE_BSWAPCPY
+   bswapcpy64(ll, fBufCur, n);
+   fBufCur += l;
+# else
    for (int i = 0; i < n; i++)
       frombuf(fBufCur, &ll[i]);
+# endif
 #else
    memcpy(ll, fBufCur, l);
    fBufCur += l;
@@ -1435,8 +1460,13 @@ void TBufferFile::ReadFastArray(Double_t *d, Int_t n)
    if (l <= 0 || l > fBufSize) return;
 
 #ifdef R__BYTESWAP
+# ifdef USE_BSWAPCPY
+   bswapcpy64(d, fBufCur, n);
+   fBufCur += l;
+# else
    for (int i = 0; i < n; i++)
       frombuf(fBufCur, &d[i]);
+# endif
 #else
    memcpy(d, fBufCur, l);
    fBufCur += l;
@@ -1867,8 +1897,13 @@ void TBufferFile::WriteArray(const Long64_t *ll, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
+# ifdef USE_BSWAPCPY
+   bswapcpy64(fBufCur, ll, n);
+   fBufCur += l;
+# else
    for (int i = 0; i < n; i++)
       tobuf(fBufCur, ll[i]);
+# endif
 #else
    memcpy(fBufCur, ll, l);
    fBufCur += l;
@@ -1922,8 +1957,13 @@ void TBufferFile::WriteArray(const Double_t *d, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
+# ifdef USE_BSWAPCPY
+   bswapcpy64(fBufCur, d, n);
+   fBufCur += l;
+# else
    for (int i = 0; i < n; i++)
       tobuf(fBufCur, d[i]);
+# endif
 #else
    memcpy(fBufCur, d, l);
    fBufCur += l;
@@ -2111,8 +2151,13 @@ void TBufferFile::WriteFastArray(const Long64_t *ll, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
+# ifdef USE_BSWAPCPY
+   bswapcpy64(fBufCur, ll, n);
+   fBufCur += l;
+# else
    for (int i = 0; i < n; i++)
       tobuf(fBufCur, ll[i]);
+# endif
 #else
    memcpy(fBufCur, ll, l);
    fBufCur += l;
@@ -2154,8 +2199,13 @@ void TBufferFile::WriteFastArray(const Double_t *d, Int_t n)
    if (fBufCur + l > fBufMax) AutoExpand(fBufSize+l);
 
 #ifdef R__BYTESWAP
+# ifdef USE_BSWAPCPY
+   bswapcpy64(fBufCur, d, n);
+   fBufCur += l;
+# else
    for (int i = 0; i < n; i++)
       tobuf(fBufCur, d[i]);
+# endif
 #else
    memcpy(fBufCur, d, l);
    fBufCur += l;
@@ -28,10 +28,24 @@
 //    h1->FillRandom("gaus",10000);
 //    TString json = TBufferJSON::ConvertToJSON(h1);
 //
+// Large objects can be written with TBufferJSON::StreamToJSON, which gives
+// the JSON code by chunks to a std::ostream or appends it to a TString
+// instead of building it in a temporary string first.
+//
+// With the compact levels 10 and 20 (added to the spaces compression level
+// 0-3, e.g. 23) the numeric arrays are written as objects like
+//
+//    {"$arr":"Float64","len":100,"p":5,"v":[1,2,3],"p1":50,"v1":7,"n1":20}
+//
+// where all the elements not listed are 0: "v" gives the values starting at
+// index "p" and, for level 20, "n" repetitions of the value "v" start at
+// index "p". JSROOT restores the plain arrays when parsing the JSON code.
+//
 //________________________________________________________________________
 
 
 #include "TBufferJSON.h"
+#include "TBufferFile.h"
 
 #include <typeinfo>
 #include <string>
@@ -75,6 +89,30 @@
 
 ClassImp(TBufferJSON)
 
+namespace {
+
+const Int_t kJsonStreamChunk = 65536;  // Size of the chunks given to the output in streaming mode
+const Int_t kJsonMinCompressed = 10;   // Minimal length of the arrays written in compact form
+const Int_t kJsonMinZeros = 8;         // Minimal number of zeros ending a block of values
+const Int_t kJsonMinRepeated = 6;      // Minimal number of repetitions written as one value
+
+// Type of the arrays written in compact form, as named by JSROOT.
+const char *JsonArrayTypeName(const Char_t *) { return "Int8"; }
+const char *JsonArrayTypeName(const UChar_t *) { return "Uint8"; }
+const char *JsonArrayTypeName(const Short_t *) { return "Int16"; }
+const char *JsonArrayTypeName(const UShort_t *) { return "Uint16"; }
+const char *JsonArrayTypeName(const Int_t *) { return "Int32"; }
+const char *JsonArrayTypeName(const UInt_t *) { return "Uint32"; }
+const char *JsonArrayTypeName(const Long_t *) { return "Int64"; }
+const char *JsonArrayTypeName(const ULong_t *) { return "Uint64"; }
+const char *JsonArrayTypeName(const Long64_t *) { return "Int64"; }
+const char *JsonArrayTypeName(const ULong64_t *) { return "Uint64"; }
+const char *JsonArrayTypeName(const Float_t *) { return "Float32"; }
+const char *JsonArrayTypeName(const Double_t *) { return "Float64"; }
+const char *JsonArrayTypeName(const Bool_t *) { return 0; }
+
+} // anonymous namespace
+
 
 const char *TBufferJSON::fgFloatFmt = "%e";
 const char *TBufferJSON::fgDoubleFmt = "%.14e";
@@ -222,6 +260,30 @@ public:
 };
 
 
+// TJSONOutput receives the JSON code produced in streaming mode,
+// see TBufferJSON::StreamToJSON.
+
+class TJSONOutput {
+public:
+   virtual ~TJSONOutput() {}
+   virtual void Write(const char *data, Int_t len) = 0;
+};
+
+class TJSONStringOutput : public TJSONOutput {
+   TString &fOut;
+public:
+   TJSONStringOutput(TString &out) : fOut(out) {}
+   virtual void Write(const char *data, Int_t len) { fOut.Append(data, len); }
+};
+
+class TJSONStreamOutput : public TJSONOutput {
+   std::ostream &fOut;
+public:
+   TJSONStreamOutput(std::ostream &out) : fOut(out) {}
+   virtual void Write(const char *data, Int_t len) { fOut.write(data, len); }
+};
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Creates buffer object to serialize data into json.
 
@@ -235,6 +297,9 @@ TBufferJSON::TBufferJSON() :
    fStack(),
    fExpectedChain(kFALSE),
    fCompact(0),
+   fArrayCompact(0),
+   fStreamOutput(0),
+   fStreamed(0),
    fSemicolon(" : "),
    fArraySepar(", "),
    fNumericLocale()
@@ -243,7 +308,7 @@ TBufferJSON::TBufferJSON() :
 
    SetParent(0);
    SetBit(kCannotHandleMemberWiseStreaming);
-   //SetBit(kTextBasedStreaming);
+   SetBit(TBufferFile::kTextBasedStreaming);
 
    fOutBuffer.Capacity(10000);
    fValue.Capacity(1000);
@@ -294,10 +359,14 @@ TString TBufferJSON::ConvertToJSON(const TObject *obj, Int_t compact, const char
 ///   1 - exclude spaces in the begin
 ///   2 - remove newlines
 ///   3 - exclude spaces as much as possible
+/// Adding 10 to the level writes the numeric arrays with their zeros
+/// suppressed, 20 also suppresses the repeated values (see class description)
 
 void TBufferJSON::SetCompact(int level)
 {
-   fCompact = level;
+   fCompact = level % 10;
+   fArrayCompact = level / 10;
+   if (fArrayCompact > 2) fArrayCompact = 2;
    fSemicolon = fCompact > 2 ? ":" : " : ";
    fArraySepar = fCompact > 2 ? "," : ", ";
 }
@@ -311,6 +380,7 @@ void TBufferJSON::SetCompact(int level)
 ///   1 - exclude spaces in the begin
 ///   2 - remove newlines
 ///   3 - exclude spaces as much as possible
+/// plus 10 or 20 for the compact form of the arrays (see SetCompact)
 /// When member_name specified, converts only this data member
 
 TString TBufferJSON::ConvertToJSON(const void *obj, const TClass *cl,
@@ -374,6 +444,61 @@ TString TBufferJSON::ConvertToJSON(const void *ptr, TDataMember *member,
    return buf.JsonWriteMember(ptr, member, mcl, arraylen);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Converts object into JSON code appended to out
+/// Same as ConvertToJSON, but the code is appended by chunks while the
+/// object is converted instead of being first built in a temporary string.
+/// Returns number of bytes appended
+
+Long64_t TBufferJSON::StreamToJSON(TString &out, const void *obj, const TClass *cl,
+                                   Int_t compact, const char *member_name)
+{
+   TJSONStringOutput output(out);
+   return StreamToJSON(output, obj, cl, compact, member_name);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Converts object into JSON code written to out by chunks while the object
+/// is converted, see ConvertToJSON for the arguments
+/// Returns number of bytes written
+
+Long64_t TBufferJSON::StreamToJSON(std::ostream &out, const void *obj, const TClass *cl,
+                                   Int_t compact, const char *member_name)
+{
+   TJSONStreamOutput output(out);
+   return StreamToJSON(output, obj, cl, compact, member_name);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Converts object into JSON code given by chunks to out
+
+Long64_t TBufferJSON::StreamToJSON(TJSONOutput &out, const void *obj, const TClass *cl,
+                                   Int_t compact, const char *member_name)
+{
+   if ((member_name!=0) && (obj!=0)) {
+      // a single data member is not expected to be large
+      TString json = ConvertToJSON(obj, cl, compact, member_name);
+      out.Write(json.Data(), json.Length());
+      return json.Length();
+   }
+
+   TBufferJSON buf;
+
+   buf.SetCompact(compact);
+   buf.fStreamOutput = &out;
+
+   buf.JsonWriteObject(obj, cl);
+
+   // as in ConvertToJSON, the code of some special classes remains in the value
+   if ((buf.fStreamed == 0) && (buf.fOutBuffer.Length() == 0)) {
+      out.Write(buf.fValue.Data(), buf.fValue.Length());
+      return buf.fValue.Length();
+   }
+
+   buf.FlushOutput();
+   return buf.fStreamed;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Convert object into JSON and store in text file
 /// Returns size of the produce file
@@ -386,13 +511,15 @@ Int_t TBufferJSON::ExportToFile(const char* filename, const TObject *obj, const
    Int_t compact = 0;
    if (option && (*option >= '0') && (*option <='3')) compact = TString(option,1).Atoi();
 
-   TString json = TBufferJSON::ConvertToJSON(obj, compact);
+   TClass *clActual = TObject::Class()->GetActualClass(obj);
+   if (!clActual) clActual = TObject::Class();
+   void *ptr = (void *) ((Long_t) obj - clActual->GetBaseClassOffset(TObject::Class()));
 
    std::ofstream ofs (filename);
-   ofs << json.Data();
+   Long64_t len = TBufferJSON::StreamToJSON(ofs, ptr, clActual, compact);
    ofs.close();
 
-   return json.Length();
+   return len;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -406,13 +533,11 @@ Int_t TBufferJSON::ExportToFile(const char* filename, const void *obj, const TCl
    Int_t compact = 0;
    if (option && (*option >= '0') && (*option <='3')) compact = TString(option,1).Atoi();
 
-   TString json = TBufferJSON::ConvertToJSON(obj, cl, compact);
-
    std::ofstream ofs (filename);
-   ofs << json.Data();
+   Long64_t len = TBufferJSON::StreamToJSON(ofs, obj, cl, compact);
    ofs.close();
 
-   return json.Length();
+   return len;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -800,6 +925,22 @@ void TBufferJSON::AppendOutput(const char *line0, const char *line1)
          fOutput->Append(line1);
       }
    }
+
+   // only the main output is complete code, the other buffers are used as values
+   if (fStreamOutput && (fOutput == &fOutBuffer) && (fOutBuffer.Length() >= kJsonStreamChunk))
+      FlushOutput();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Give the content of the main output buffer to the stream output
+
+void TBufferJSON::FlushOutput()
+{
+   if (!fStreamOutput || (fOutBuffer.Length() == 0)) return;
+
+   fStreamOutput->Write(fOutBuffer.Data(), fOutBuffer.Length());
+   fStreamed += fOutBuffer.Length();
+   fOutBuffer.Clear();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2219,14 +2360,102 @@ void TBufferJSON::ReadFastArray(void ** /*startp*/, const TClass * /*cl*/,
 
 #define TJSONWriteArrayContent(vname, arrsize)        \
    {                                                     \
-      fValue.Append("["); /* fJsonrCnt++; */             \
-      for (Int_t indx=0;indx<arrsize;indx++) {           \
-         if (indx>0) fValue.Append(fArraySepar.Data());  \
-         JsonWriteBasic(vname[indx]);                    \
-      }                                                  \
-      fValue.Append("]");                                \
+      JsonWriteArrayContent(vname, arrsize);             \
+   }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the content of an array to the value, in compact form (zeros and
+/// optionally repeated values suppressed, see class description) if it was
+/// requested with SetCompact
+
+template <typename T>
+void TBufferJSON::JsonWriteArrayContent(const T *vname, Int_t arrsize)
+{
+   const char *typname = JsonArrayTypeName(vname);
+
+   if ((fArrayCompact == 0) || (typname == 0) || (arrsize < kJsonMinCompressed)) {
+      fValue.Append("["); /* fJsonrCnt++; */
+      for (Int_t indx=0;indx<arrsize;indx++) {
+         if (indx>0) fValue.Append(fArraySepar.Data());
+         JsonWriteBasic(vname[indx]);
+      }
+      fValue.Append("]");
+      return;
+   }
+
+   fValue.Append("{\"$arr\"");
+   fValue.Append(fSemicolon);
+   fValue.Append("\"");
+   fValue.Append(typname);
+   fValue.Append("\"");
+   fValue.Append(fArraySepar);
+   fValue.Append("\"len\"");
+   fValue.Append(fSemicolon);
+   JsonWriteBasic(arrsize);
+
+   TString suffix;
+   Int_t nblock = 0;
+   Int_t p = 0;
+   while (p < arrsize) {
+      if (vname[p] == 0) { ++p; continue; }
+
+      Int_t q = p + 1;
+      while ((q < arrsize) && (vname[q] == vname[p])) ++q;
+
+      if (nblock > 0) suffix.Form("%d", nblock);
+      nblock++;
+
+      fValue.Append(fArraySepar);
+      fValue.Append("\"p");
+      fValue.Append(suffix);
+      fValue.Append("\"");
+      fValue.Append(fSemicolon);
+      JsonWriteBasic(p);
+      fValue.Append(fArraySepar);
+      fValue.Append("\"v");
+      fValue.Append(suffix);
+      fValue.Append("\"");
+      fValue.Append(fSemicolon);
+
+      if ((fArrayCompact > 1) && (q - p >= kJsonMinRepeated)) {
+         // repeated value
+         JsonWriteBasic(vname[p]);
+         fValue.Append(fArraySepar);
+         fValue.Append("\"n");
+         fValue.Append(suffix);
+         fValue.Append("\"");
+         fValue.Append(fSemicolon);
+         JsonWriteBasic(q - p);
+         p = q;
+         continue;
+      }
+
+      // values up to enough zeros or repetitions, without the zeros at the end
+      Int_t r = q, last = q;
+      while (r < arrsize) {
+         Int_t s = r + 1;
+         while ((s < arrsize) && (vname[s] == vname[r])) ++s;
+         if (vname[r] == 0) {
+            if (s - r >= kJsonMinZeros) break;
+         } else {
+            if ((fArrayCompact > 1) && (s - r >= kJsonMinRepeated)) break;
+            last = s;
+         }
+         r = s;
+      }
+
+      fValue.Append("[");
+      for (Int_t indx = p; indx < last; indx++) {
+         if (indx > p) fValue.Append(fArraySepar.Data());
+         JsonWriteBasic(vname[indx]);
+      }
+      fValue.Append("]");
+      p = last;
    }
 
+   fValue.Append("}");
+}
+
 // macro to write array, which include size
 #define TBufferJSON_WriteArray(vname)                 \
    {                                                     \
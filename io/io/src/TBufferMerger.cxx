@@ -0,0 +1,195 @@
+// @(#)root/io:$Id$
+// Author: ROOT I/O team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class ROOT::Experimental::TBufferMerger
+\ingroup IO
+
+Merge the output of several threads into a single file.
+
+Typical usage:
+~~~{.cpp}
+ROOT::EnableThreadSafety();
+ROOT::Experimental::TBufferMerger merger("output.root");
+
+auto work = [&merger]() {
+   auto f = merger.GetFile();
+   TTree t("t", "t");
+   ... fill the tree ...
+   f->Write(); // queue the content for merging, the tree is then reset
+};
+~~~
+Each call to TBufferMergerFile::Write serializes the content of the
+memory file into a buffer which is queued. A single background thread
+opens the output file and merges the queued buffers one by one with
+TFileMerger in incremental mode. The worker threads never wait for the
+output file to be written, they only take a lock to push the buffer.
+*/
+
+#include "ROOT/TBufferMerger.hxx"
+
+#include "TBufferFile.h"
+#include "TError.h"
+#include "TFileMerger.h"
+#include "TROOT.h"
+#include "TVirtualMutex.h"
+
+namespace ROOT {
+namespace Experimental {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor. The output file is opened by the merging thread, which is
+/// started right away.
+
+TBufferMerger::TBufferMerger(const char *name, Option_t *option, Int_t compress)
+   : fName(name), fOption(option), fCompress(compress),
+     fMergingThread(new std::thread([&]() { this->WriteOutputFile(); }))
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor. Signal the merging thread that no more data is coming
+/// (by queueing a null buffer) and wait for it to finish.
+
+TBufferMerger::~TBufferMerger()
+{
+   Push(nullptr);
+   fMergingThread->join();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a new TBufferMergerFile attached to this merger.
+
+std::shared_ptr<TBufferMergerFile> TBufferMerger::GetFile()
+{
+   R__LOCKGUARD(gROOTMutex);
+   std::shared_ptr<TBufferMergerFile> f(new TBufferMergerFile(*this));
+   gROOT->GetListOfFiles()->Remove(f.get());
+   return f;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of buffers waiting to be merged.
+
+size_t TBufferMerger::GetQueueSize() const
+{
+   std::lock_guard<std::mutex> lock(fQueueMutex);
+   return fQueue.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the function called by the merging thread after each merge.
+
+void TBufferMerger::RegisterCallback(const std::function<void(void)> &f)
+{
+   std::lock_guard<std::mutex> lock(fQueueMutex);
+   fCallback = f;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Queue a buffer for merging. The merger takes ownership of the buffer.
+
+void TBufferMerger::Push(TBufferFile *buffer)
+{
+   {
+      std::lock_guard<std::mutex> lock(fQueueMutex);
+      fQueue.push(buffer);
+   }
+   fDataAvailable.notify_one();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Body of the merging thread: wait for buffers and merge them into the
+/// output file until a null buffer is received.
+
+void TBufferMerger::WriteOutputFile()
+{
+   std::unique_ptr<TBufferFile> buffer;
+   std::function<void(void)> callback;
+   TFileMerger merger(kFALSE);
+
+   {
+      R__LOCKGUARD(gROOTMutex);
+      TDirectory::TContext ctxt;
+      if (!merger.OutputFile(fName.c_str(), fOption.c_str(), fCompress)) {
+         Error("TBufferMerger", "cannot open the output file %s", fName.c_str());
+      }
+   }
+
+   while (true) {
+      std::unique_lock<std::mutex> lock(fQueueMutex);
+      fDataAvailable.wait(lock, [this]() { return !this->fQueue.empty(); });
+
+      buffer.reset(fQueue.front());
+      fQueue.pop();
+      callback = fCallback;
+      lock.unlock();
+
+      if (!buffer)
+         break;
+
+      Long64_t length;
+      buffer->SetReadMode();
+      buffer->SetBufferOffset();
+      buffer->ReadLong64(length);
+
+      {
+         R__LOCKGUARD(gROOTMutex);
+         TDirectory::TContext ctxt;
+         TMemFile *memfile = new TMemFile(fName.c_str(), buffer->Buffer() + buffer->Length(), length, "READ");
+         buffer->SetBufferOffset(buffer->Length() + length);
+         merger.AddAdoptFile(memfile, kFALSE);
+         merger.PartialMerge(TFileMerger::kAllIncremental);
+      }
+
+      if (callback)
+         callback();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor, only used by TBufferMerger::GetFile.
+
+TBufferMergerFile::TBufferMergerFile(TBufferMerger &m)
+   : TMemFile(m.fName.c_str(), "recreate", "", m.fCompress), fMerger(m)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+TBufferMergerFile::~TBufferMergerFile()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the objects of this file in memory, copy the memory image in a
+/// buffer queued to the TBufferMerger and reset the resetable objects (like
+/// TTree) so that the file can be filled again.
+
+Int_t TBufferMergerFile::Write(const char *name, Int_t opt, Int_t bufsize)
+{
+   Int_t nbytes = TMemFile::Write(name, opt, bufsize);
+
+   if (nbytes) {
+      TBufferFile *buffer = new TBufferFile(TBuffer::kWrite, GetSize() + sizeof(Long64_t));
+      buffer->WriteLong64(GetSize());
+      CopyTo(*buffer);
+
+      fMerger.Push(buffer);
+      ResetAfterMerge(0);
+   }
+   return nbytes;
+}
+
+} // namespace Experimental
+} // namespace ROOT
+
+ClassImp(ROOT::Experimental::TBufferMergerFile)
@@ -0,0 +1,274 @@
+// @(#)root/io:$Id$
+// Author: ROOT I/O team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class ROOT::Internal::TBufferPool
+\ingroup IO
+
+Per-thread pool of the memory blocks used to read the records of the files.
+
+With implicit multi-threading, many tasks read and uncompress baskets at the
+same time; each basket needs a buffer for its compressed record and one for
+its content, of sizes varying from basket to basket. Allocating them with
+new[] and delete[] makes the threads contend in the allocator. The blocks
+of this pool are kept by the thread releasing them, in size classes, and
+handed out again to the next request of the same class of that thread.
+
+The class of a block is computed from its size: a block of class k has room
+for ClassSize(k) plus kSlack bytes. Since a TBuffer in write mode reports
+kSlack more bytes than in read mode to its reallocation function, a block is
+given back to the class of its size minus kSlack, which is never larger than
+the class it was allocated for.
+*/
+
+#include "ROOT/TBufferPool.hxx"
+
+#include "TBufferFile.h"
+#include "ThreadLocalStorage.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+const Int_t kNClasses = 72;        // Four classes per power of two, from 1 kB to 224 MB
+const Int_t kSlack    = 8;         // Extra bytes of each block, see TBuffer kExtraSpace
+
+std::atomic<Long64_t> gMaxCachedBytes(32*1024*1024);
+
+////////////////////////////////////////////////////////////////////////////////
+/// Size of the blocks of class i.
+
+inline size_t ClassSize(Int_t i)
+{
+   return size_t(4 + (i & 3)) << (8 + (i >> 2));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Smallest class whose blocks hold size bytes, -1 if there is none.
+
+inline Int_t ClassOf(size_t size)
+{
+   if (size <= 1024) return 0;
+   size_t n = size - 1;
+   Int_t e = 10;
+   while (n >> (e + 1)) ++e;
+   Int_t i = 4 * (e - 10) + Int_t((n >> (e - 2)) & 3) + 1;
+   return i < kNClasses ? i : -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// The free blocks of a thread; they are deleted when the thread ends.
+
+struct TBufferPoolSlot {
+   std::vector<char*> fFree[kNClasses];
+   ROOT::Internal::TBufferPool::Stats_t fStats;
+
+   TBufferPoolSlot() { memset(&fStats, 0, sizeof(fStats)); }
+   ~TBufferPoolSlot() { Clear(); }
+
+   void Clear()
+   {
+      for (Int_t i = 0; i < kNClasses; ++i) {
+         for (auto block : fFree[i]) delete [] block;
+         fFree[i].clear();
+      }
+      fStats.fCachedBytes = 0;
+   }
+};
+
+TBufferPoolSlot &GetSlot()
+{
+   TTHREAD_TLS_DECL(TBufferPoolSlot, slot);
+   return slot;
+}
+
+} // anonymous namespace
+
+namespace ROOT {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a block of at least size bytes, to be given back with
+/// Release(block, size) or deleted with delete[].
+
+char *TBufferPool::Acquire(Int_t size)
+{
+   TBufferPoolSlot &slot = GetSlot();
+   ++slot.fStats.fAcquired;
+   Int_t k = ClassOf(size > 0 ? size : 1);
+   if (k < 0) return new char[size + kSlack];
+
+   std::vector<char*> &free = slot.fFree[k];
+   if (!free.empty()) {
+      char *block = free.back();
+      free.pop_back();
+      slot.fStats.fCachedBytes -= ClassSize(k);
+      ++slot.fStats.fReused;
+      return block;
+   }
+   return new char[ClassSize(k) + kSlack];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Give back to the pool of the calling thread a block returned by Acquire
+/// (possibly by another thread) for size bytes, or resized by ReAlloc to
+/// size bytes. The block is deleted if the cache of the thread is full.
+
+void TBufferPool::Release(char *block, Int_t size)
+{
+   if (!block) return;
+   TBufferPoolSlot &slot = GetSlot();
+   ++slot.fStats.fReleased;
+   Int_t k = size > kSlack ? ClassOf(size - kSlack) : 0;
+   if (k < 0 || slot.fStats.fCachedBytes + (Long64_t)ClassSize(k) > gMaxCachedBytes) {
+      ++slot.fStats.fDropped;
+      delete [] block;
+      return;
+   }
+   slot.fFree[k].push_back(block);
+   slot.fStats.fCachedBytes += ClassSize(k);
+   if (slot.fStats.fCachedBytes > slot.fStats.fHighWater) slot.fStats.fHighWater = slot.fStats.fCachedBytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reallocation function (see TBuffer::SetReAllocFunc) of the buffers using
+/// the blocks of the pool. The block is kept if it is large enough and not
+/// more than twice too large. As TStorage::ReAllocChar, the new bytes are
+/// zeroed.
+
+char *TBufferPool::ReAlloc(char *block, size_t size, size_t oldsize)
+{
+   if (block && oldsize) {
+      Int_t k = oldsize > (size_t)kSlack ? ClassOf(oldsize - kSlack) : 0;
+      if (k >= 0) {
+         size_t capacity = ClassSize(k) + kSlack;
+         if (size <= capacity && 2 * size > capacity) {
+            if (size > oldsize) memset(block + oldsize, 0, size - oldsize);
+            return block;
+         }
+      }
+   }
+   char *newblock = Acquire(size);
+   if (block && oldsize) {
+      size_t ncopy = size < oldsize ? size : oldsize;
+      memcpy(newblock, block, ncopy);
+      if (size > ncopy) memset(newblock + ncopy, 0, size - ncopy);
+      Release(block, oldsize);
+   } else {
+      memset(newblock, 0, size);
+      // The size of the previous block is not known, it cannot be reused.
+      delete [] block;
+   }
+   return newblock;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a TBufferFile of size bytes, whose memory comes from the pool and
+/// goes back to it when the TBufferFile is expanded or given to
+/// DeleteBuffer.
+
+TBuffer *TBufferPool::CreateBuffer(TBuffer::EMode mode, Int_t size)
+{
+   if (size < TBuffer::kMinimalSize) size = TBuffer::kMinimalSize;
+   Int_t blocksize = (mode & TBuffer::kWrite) ? size + kSlack : size;
+   return new TBufferFile(mode, blocksize, Acquire(blocksize), kTRUE, &TBufferPool::ReAlloc);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Make buffer use block, of size bytes, returned by Acquire. The previous
+/// memory of buffer is given back to the pool if it came from it.
+
+void TBufferPool::AdoptBlock(TBuffer &buffer, char *block, Int_t size)
+{
+   ReleaseBuffer(buffer);
+   buffer.SetBuffer(block, size, kTRUE, &TBufferPool::ReAlloc);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the memory of buffer is owned by it and comes from the pool.
+
+Bool_t TBufferPool::IsPooled(const TBuffer &buffer)
+{
+   return buffer.TestBit(TBuffer::kIsOwner) && buffer.GetReAllocFunc() == &TBufferPool::ReAlloc && buffer.Buffer();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Give the memory of buffer back to the pool, if it came from it. The
+/// buffer is then left without memory and must be given a new one (with
+/// SetBuffer or AdoptBlock) before being used again.
+
+void TBufferPool::ReleaseBuffer(TBuffer &buffer)
+{
+   if (!IsPooled(buffer)) return;
+   Int_t size = buffer.BufferSize() + (buffer.IsWriting() ? kSlack : 0);
+   Release(buffer.Buffer(), size);
+   buffer.DetachBuffer();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete buffer, giving its memory back to the pool if it came from it.
+
+void TBufferPool::DeleteBuffer(TBuffer *buffer)
+{
+   if (!buffer) return;
+   ReleaseBuffer(*buffer);
+   delete buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete the free blocks of the calling thread.
+
+void TBufferPool::Clear()
+{
+   GetSlot().Clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the maximum number of bytes of free blocks kept by each thread.
+
+Long64_t TBufferPool::GetMaxCachedBytes()
+{
+   return gMaxCachedBytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the maximum number of bytes of free blocks kept by each thread
+/// (32 MB by default). 0 disables the reuse of the blocks.
+
+void TBufferPool::SetMaxCachedBytes(Long64_t bytes)
+{
+   gMaxCachedBytes = bytes < 0 ? 0 : bytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the statistics of the pool of the calling thread.
+
+TBufferPool::Stats_t TBufferPool::GetStats()
+{
+   return GetSlot().fStats;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the statistics of the pool of the calling thread.
+
+void TBufferPool::Print()
+{
+   const Stats_t &s = GetSlot().fStats;
+   printf("TBufferPool: %llu blocks acquired, %llu reused (%.1f%%), %llu released, %llu dropped\n",
+          s.fAcquired, s.fReused, s.fAcquired ? 100. * s.fReused / s.fAcquired : 0., s.fReleased, s.fDropped);
+   printf("TBufferPool: %lld bytes cached, high water %lld bytes, limit %lld bytes\n",
+          s.fCachedBytes, s.fHighWater, (Long64_t)gMaxCachedBytes);
+}
+
+} // End of namespace Internal
+} // End of namespace ROOT
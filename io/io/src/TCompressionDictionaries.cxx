@@ -0,0 +1,161 @@
+// @(#)root/io:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TCompressionDictionaries
+\ingroup IO
+
+Zstd dictionaries used to compress the small buffers of a file.
+
+A TTree whose branches are compressed with Zstd trains one dictionary per
+branch on the small baskets of its first cluster (see
+TTree::SetAutoFlush); the following baskets of the branch are compressed
+with it, which gains much on buffers of a few kilobytes where Zstd
+otherwise has no history to refer to. Such a buffer can only be
+decompressed with the same dictionary, so the dictionaries are written in
+the top directory of the file, under the key `CompressionDictionaries`:
+a record holds the dictionaries of the branches and a new cycle is written
+when new dictionaries are trained (e.g. by another tree).
+
+When a file is opened (see TFile::Init), all the records are read and their
+dictionaries registered for the process. A dictionary is identified by an
+id computed from its content, stored in each compressed frame, so the same
+dictionary may be used by several files.
+*/
+
+#include "TCompressionDictionaries.h"
+
+#include "TDirectory.h"
+#include "TKey.h"
+#include "RZip.h"
+
+#include <algorithm>
+
+ClassImp(TCompressionDictionaries)
+
+////////////////////////////////////////////////////////////////////////////////
+/// Default constructor.
+
+TCompressionDictionaries::TCompressionDictionaries()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+TCompressionDictionaries::~TCompressionDictionaries()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the registered dictionary id to this record. Returns false if it is
+/// not registered in this process.
+
+Bool_t TCompressionDictionaries::Add(UInt_t id)
+{
+   if (Contains(id)) return kTRUE;
+   int size = 0;
+   const char *content = R__ZSTDGetDictionary(id, &size);
+   if (!content) return kFALSE;
+   fIDs.push_back(id);
+   fContents.push_back(std::string(content, size));
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// True if the dictionary id is in this record.
+
+Bool_t TCompressionDictionaries::Contains(UInt_t id) const
+{
+   return std::find(fIDs.begin(), fIDs.end(), id) != fIDs.end();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Register the dictionaries of this record for the decompression of the
+/// buffers. Returns the number of dictionaries registered.
+
+Int_t TCompressionDictionaries::Register() const
+{
+   Int_t nregistered = 0;
+   for (size_t i = 0; i < fIDs.size() && i < fContents.size(); ++i) {
+      UInt_t id = R__ZSTDAddDictionary(fContents[i].data(), fContents[i].size());
+      if (id == fIDs[i]) {
+         ++nregistered;
+      } else {
+         Error("Register", "the content of the dictionary %u is corrupted", fIDs[i]);
+      }
+   }
+   return nregistered;
+}
+
+namespace {
+   // Call action for each record of file, the most recent first.
+   template <typename Action>
+   void ForEachRecord(TDirectory *file, Action action)
+   {
+      if (!file) return;
+      const char *name = TCompressionDictionaries::GetKeyName();
+      Short_t cycle = 9999;
+      TKey *key;
+      while (cycle > 0 && (key = file->GetKey(name, cycle))) {
+         cycle = key->GetCycle() - 1;
+         TCompressionDictionaries *dicts = (TCompressionDictionaries*)key->ReadObjectAny(TCompressionDictionaries::Class());
+         if (dicts) action(*dicts);
+         delete dicts;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Register the dictionaries stored in file. Returns the number of
+/// dictionaries registered.
+
+Int_t TCompressionDictionaries::Load(TDirectory *file)
+{
+   Int_t nregistered = 0;
+   ForEachRecord(file, [&nregistered](const TCompressionDictionaries &dicts) {
+      nregistered += dicts.Register();
+   });
+   return nregistered;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write in file, which must be writable, a record with the dictionaries
+/// ids not yet stored there. Returns the number of dictionaries written.
+
+Int_t TCompressionDictionaries::Save(TDirectory *file, const std::vector<UInt_t> &ids)
+{
+   if (!file || !file->IsWritable() || ids.empty()) return 0;
+   TCompressionDictionaries stored;
+   ForEachRecord(file, [&stored](const TCompressionDictionaries &dicts) {
+      stored.fIDs.insert(stored.fIDs.end(), dicts.fIDs.begin(), dicts.fIDs.end());
+   });
+   TCompressionDictionaries record;
+   for (UInt_t id : ids) {
+      if (id && !stored.Contains(id)) record.Add(id);
+   }
+   if (!record.GetSize()) return 0;
+   file->WriteTObject(&record, GetKeyName());
+   return record.GetSize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write in to the dictionaries of from, e.g. when baskets are copied
+/// without being decompressed. Returns the number of dictionaries written.
+
+Int_t TCompressionDictionaries::Copy(TDirectory *from, TDirectory *to)
+{
+   std::vector<UInt_t> ids;
+   ForEachRecord(from, [&ids](const TCompressionDictionaries &dicts) {
+      dicts.Register();
+      ids.insert(ids.end(), dicts.fIDs.begin(), dicts.fIDs.end());
+   });
+   return Save(to, ids);
+}
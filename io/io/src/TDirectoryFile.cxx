@@ -47,12 +47,145 @@ End_Macro
 #include "TProcessUUID.h"
 #include "TVirtualMutex.h"
 #include "TEmulatedCollectionProxy.h"
+#include "TMethod.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+#endif
 
 const UInt_t kIsBigFile = BIT(16);
 const Int_t  kMaxLen = 2048;
 
 ClassImp(TDirectoryFile)
 
+namespace ROOT {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// The keys record of a directory whose keys are read on demand (see
+/// TDirectoryFile::ReadKeysLazy). The record is read and indexed by name
+/// on the first lookup; a TKey is only created for the names looked up,
+/// or for all the entries when the full list of keys is requested.
+
+class TDirectoryFileLazyKeys {
+public:
+   TKey                *fHeader;   ///< Key of the keys record, holding its buffer
+   Bool_t               fIndexed;  ///< True once the record has been read and indexed
+   std::vector<char*>   fEntries;  ///< Start of each key in the record, in file order
+   std::vector<TKey*>   fKeys;     ///< TKey created for each entry, 0 if not yet created
+   std::unordered_map<std::string, std::vector<Int_t> > fIndex; ///< Entries of each key name
+
+   TDirectoryFileLazyKeys() : fHeader(0), fIndexed(kFALSE) {}
+   ~TDirectoryFileLazyKeys() { delete fHeader; }
+
+   void  Index(TDirectoryFile *dir);
+   TKey *Create(TDirectoryFile *dir, Int_t entry);
+};
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Skip a string written by TString::FillBuffer, return its characters in
+/// name (if not null). Return false if the string goes past end.
+
+Bool_t SkipKeyString(char *&buffer, const char *end, std::string *name)
+{
+   if (buffer >= end) return kFALSE;
+   UChar_t nwh;
+   Int_t   nchars;
+   frombuf(buffer, &nwh);
+   if (nwh == 255) {
+      if (buffer + 4 > end) return kFALSE;
+      frombuf(buffer, &nchars);
+   } else {
+      nchars = nwh;
+   }
+   if (nchars < 0 || buffer + nchars > end) return kFALSE;
+   if (name) name->assign(buffer, nchars);
+   buffer += nchars;
+   return kTRUE;
+}
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the keys record of dir and index its entries by name. Only the
+/// name of each entry is decoded, the fixed part of the key header being
+/// skipped (see TKey::ReadKeyBuffer for the layout).
+
+void TDirectoryFileLazyKeys::Index(TDirectoryFile *dir)
+{
+   fIndexed = kTRUE;
+   if (dir->GetSeekKeys() <= 0 || dir->GetNbytesKeys() <= 0) return;
+
+   fHeader = new TKey(dir->GetSeekKeys(), dir->GetNbytesKeys(), dir);
+   if (!fHeader->ReadFile()) return;
+   char *buffer = fHeader->GetBuffer();
+   const char *end = buffer + dir->GetNbytesKeys();
+   fHeader->ReadKeyBuffer(buffer);
+
+   Int_t nkeys = 0;
+   frombuf(buffer, &nkeys);
+   if (nkeys > 0) {
+      fEntries.reserve(nkeys);
+      fIndex.reserve(nkeys);
+   }
+   std::string name;
+   for (Int_t i = 0; i < nkeys; i++) {
+      char *entry = buffer;
+      // nbytes, version, objlen, datime, keylen, cycle
+      if (buffer + 18 > end) {
+         dir->Error("ReadKeys","reading illegal key, exiting after %d keys",i);
+         break;
+      }
+      buffer += 4;
+      Version_t version;
+      frombuf(buffer, &version);
+      buffer += 12;
+      // seekkey, seekpdir
+      buffer += version > 1000 ? 16 : 8;
+      if (!SkipKeyString(buffer, end, 0) || !SkipKeyString(buffer, end, &name) || !SkipKeyString(buffer, end, 0)) {
+         dir->Error("ReadKeys","reading illegal key, exiting after %d keys",i);
+         break;
+      }
+      fIndex[name].push_back((Int_t)fEntries.size());
+      fEntries.push_back(entry);
+   }
+   fKeys.assign(fEntries.size(), (TKey*)0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the TKey of the given entry, 0 if the entry is not valid.
+
+TKey *TDirectoryFileLazyKeys::Create(TDirectoryFile *dir, Int_t entry)
+{
+   char *buffer = fEntries[entry];
+   if (!buffer) return 0;
+   fEntries[entry] = 0;
+
+   Long64_t fsize = dir->GetFile()->GetSize();
+   TKey *key = new TKey(dir);
+   key->ReadKeyBuffer(buffer);
+   if (key->GetSeekKey() < 64 || key->GetSeekKey() > fsize ||
+       key->GetSeekPdir() < 64 || key->GetSeekPdir() > fsize) {
+      dir->Error("ReadKeys","reading illegal key %s",key->GetName());
+      delete key;
+      return 0;
+   }
+   fKeys[entry] = key;
+   return key;
+}
+
+} // End of namespace Internal
+} // End of namespace ROOT
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Default Constructor
@@ -60,7 +193,7 @@ ClassImp(TDirectoryFile)
 TDirectoryFile::TDirectoryFile() : TDirectory()
    , fModified(kFALSE), fWritable(kFALSE), fNbytesKeys(0), fNbytesName(0)
    , fBufferSize(0), fSeekDir(0), fSeekParent(0), fSeekKeys(0)
-   , fFile(0), fKeys(0)
+   , fFile(0), fKeys(0), fLazyKeys(0)
 {
 }
 
@@ -80,7 +213,7 @@ TDirectoryFile::TDirectoryFile(const char *name, const char *title, Option_t *cl
            : TDirectory()
    , fModified(kFALSE), fWritable(kFALSE), fNbytesKeys(0), fNbytesName(0)
    , fBufferSize(0), fSeekDir(0), fSeekParent(0), fSeekKeys(0)
-   , fFile(0), fKeys(0)
+   , fFile(0), fKeys(0), fLazyKeys(0)
 {
    fName = name;
    fTitle = title;
@@ -168,7 +301,7 @@ void TDirectoryFile::Init(TClass *cl)
 TDirectoryFile::TDirectoryFile(const TDirectoryFile & directory) : TDirectory(directory)
    , fModified(kFALSE), fWritable(kFALSE), fNbytesKeys(0), fNbytesName(0)
    , fBufferSize(0), fSeekDir(0), fSeekParent(0), fSeekKeys(0)
-   , fFile(0), fKeys(0)
+   , fFile(0), fKeys(0), fLazyKeys(0)
 {
    ((TDirectoryFile&)directory).Copy(*this);
 }
@@ -178,6 +311,7 @@ TDirectoryFile::TDirectoryFile(const TDirectoryFile & directory) : TDirectory(di
 
 TDirectoryFile::~TDirectoryFile()
 {
+   SafeDelete(fLazyKeys);
    if (fKeys) {
       fKeys->Delete("slow");
       SafeDelete(fKeys);
@@ -228,6 +362,7 @@ Int_t TDirectoryFile::AppendKey(TKey *key)
 {
    fModified = kTRUE;
 
+   if (fLazyKeys) LoadAllKeys();
    key->SetMotherDir(this);
 
    // This is a fast hash lookup in case the key does not already exist
@@ -262,7 +397,7 @@ void TDirectoryFile::Browse(TBrowser *b)
       TObject *obj = 0;
       TIter nextin(fList);
       TKey *key = 0, *keyo = 0;
-      TIter next(fKeys);
+      TIter next(GetListOfKeys());
 
       cd();
 
@@ -559,6 +694,7 @@ void TDirectoryFile::Close(Option_t *)
    }
 
    // Delete keys from key list (but don't delete the list header)
+   SafeDelete(fLazyKeys);
    if (fKeys) {
       fKeys->Delete("slow");
    }
@@ -921,8 +1057,10 @@ TObject *TDirectoryFile::Get(const char *namecycle)
 
 //*-*---------------------Case of Key---------------------
 //                        ===========
+   // Only the keys sharing the hash of namobj need to be compared.
+   if (fLazyKeys) LoadKeys(namobj);
    TKey *key;
-   TIter nextkey(GetListOfKeys());
+   TIter nextkey(((THashList *)fKeys)->GetListForObject(namobj));
    while ((key = (TKey *) nextkey())) {
       if (strcmp(namobj,key->GetName()) == 0) {
          if ((cycle == 9999) || (cycle == key->GetCycle())) {
@@ -1035,8 +1173,9 @@ void *TDirectoryFile::GetObjectChecked(const char *namecycle, const TClass* expe
 //*-*---------------------Case of Key---------------------
 //                        ===========
    void *idcur = 0;
+   if (fLazyKeys) LoadKeys(namobj);
    TKey *key;
-   TIter nextkey(GetListOfKeys());
+   TIter nextkey(((THashList *)fKeys)->GetListForObject(namobj));
    while ((key = (TKey *) nextkey())) {
       if (strcmp(namobj,key->GetName()) == 0) {
          if ((cycle == 9999) || (cycle == key->GetCycle())) {
@@ -1070,8 +1209,10 @@ Int_t TDirectoryFile::GetBufferSize() const
 
 TKey *TDirectoryFile::GetKey(const char *name, Short_t cycle) const
 {
+   if (fLazyKeys) LoadKeys(name);
+
    // TIter::TIter() already checks for null pointers
-   TIter next( ((THashList *)(GetListOfKeys()))->GetListForObject(name) );
+   TIter next( ((THashList *)fKeys)->GetListForObject(name) );
 
    TKey *key;
    while (( key = (TKey *)next() )) {
@@ -1255,6 +1396,8 @@ void TDirectoryFile::ReadAll(Option_t* opt)
 
          if ((dir!=0) && (strcmp(opt,"dirs*")==0)) dir->ReadAll("dirs*");
       }
+   else if (ROOT::IsImplicitMTEnabled())
+      ReadAllConcurrently();
    else
       while ((key = (TKey *) next())) {
          TObject *thing = GetList()->FindObject(key->GetName());
@@ -1263,6 +1406,129 @@ void TDirectoryFile::ReadAll(Option_t* opt)
       }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read all objects of this directory into memory, uncompressing the
+/// objects concurrently when implicit multi-threading is enabled.
+///
+/// The keys are processed in batches: the records of the objects of a
+/// batch are read from the file in order, uncompressed in parallel and
+/// finally streamed in order, exactly as done by ReadAll() sequentially.
+/// Streaming is kept sequential since it registers the StreamerInfos and
+/// the objects in the directory.
+
+void TDirectoryFile::ReadAllConcurrently()
+{
+   const UInt_t   kMaxBatchKeys  = 256;              // Keys read ahead at once
+   const Long64_t kMaxBatchBytes = 64*1024*1024;     // Uncompressed bytes read ahead at once
+
+#ifdef R__USE_IMT
+   ROOT::TThreadExecutor pool;
+#endif
+   std::vector<TKey*> keys;
+   std::vector<TKey*> prefetched;
+   Long64_t batchBytes = 0;
+   TKey *key;
+   TIter next(GetListOfKeys());
+   do {
+      key = (TKey *) next();
+      if (key) {
+         keys.push_back(key);
+         batchBytes += key->GetObjlen();
+         if (keys.size() < kMaxBatchKeys && batchBytes < kMaxBatchBytes) continue;
+      }
+
+      prefetched.clear();
+      for (auto k : keys) {
+         TClass *cl = TClass::GetClass(k->GetClassName());
+         if (cl && cl->IsTObject() && k->ReadObjBuffer()) prefetched.push_back(k);
+      }
+      if (!prefetched.empty()) {
+         auto unzip = [&prefetched](UInt_t i) { return (Int_t)prefetched[i]->UnzipObjBuffer(); };
+#ifdef R__USE_IMT
+         std::vector<Int_t> unzipped = pool.Map(unzip, ROOT::TSeqU(prefetched.size()));
+#else
+         std::vector<Int_t> unzipped(prefetched.size());
+         for (UInt_t i = 0; i < prefetched.size(); ++i) unzipped[i] = unzip(i);
+#endif
+         for (UInt_t i = 0; i < prefetched.size(); ++i) {
+            if (unzipped[i]) prefetched[i]->SetBit(TKey::kBufferPrefetched);
+         }
+      }
+
+      for (auto k : keys) {
+         TObject *thing = GetList()->FindObject(k->GetName());
+         if (thing) { delete thing; }
+         k->ReadObj();
+      }
+      keys.clear();
+      batchBytes = 0;
+   } while (key);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the keys named name which are still pending in the keys record
+/// of a directory read lazily (see ReadKeysLazy). The keys are added in
+/// their order on file, highest cycle first.
+
+void TDirectoryFile::LoadKeys(const char *name) const
+{
+   if (!fLazyKeys) return;
+   TDirectoryFile *self = const_cast<TDirectoryFile*>(this);
+   if (!fLazyKeys->fIndexed) fLazyKeys->Index(self);
+
+   auto iter = fLazyKeys->fIndex.find(name);
+   if (iter == fLazyKeys->fIndex.end()) return;
+   for (Int_t entry : iter->second) {
+      TKey *key = fLazyKeys->Create(self, entry);
+      if (key) fKeys->Add(key);
+   }
+   fLazyKeys->fIndex.erase(iter);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create all the keys still pending in the keys record of a directory
+/// read lazily (see ReadKeysLazy). The list of keys is then in the same
+/// order as if it had been read by ReadKeys, and the directory is no
+/// longer lazy.
+
+void TDirectoryFile::LoadAllKeys() const
+{
+   if (!fLazyKeys) return;
+   TDirectoryFile *self = const_cast<TDirectoryFile*>(this);
+   ROOT::Internal::TDirectoryFileLazyKeys *lazy = fLazyKeys;
+   // Detach first: the list of keys may be requested while creating them.
+   self->fLazyKeys = 0;
+   if (!lazy->fIndexed) lazy->Index(self);
+
+   for (Int_t entry = 0, n = lazy->fEntries.size(); entry < n; ++entry) {
+      lazy->Create(self, entry);
+   }
+   // The keys already looked up were added first, restore the file order.
+   fKeys->Clear("nodelete");
+   for (TKey *key : lazy->fKeys) {
+      if (key) fKeys->Add(key);
+   }
+   delete lazy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Prepare the directory to read its keys on demand.
+///
+/// Nothing is read from the file: the keys record is read on the first
+/// lookup (Get, GetKey, ...) and a TKey is only created for the names
+/// looked up, which reduces the time to open a file with many keys when
+/// only a few objects are read. The whole list of keys is created when it
+/// is requested (GetListOfKeys, GetNkeys, ls, writing, ...).
+/// This is used for the files opened with the option lazy=1 (see the
+/// TFile constructor).
+
+void TDirectoryFile::ReadKeysLazy()
+{
+   SafeDelete(fLazyKeys);
+   fKeys->Delete();
+   if (fSeekKeys > 0) fLazyKeys = new ROOT::Internal::TDirectoryFileLazyKeys;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read the linked list of keys.
 ///
@@ -1296,6 +1562,14 @@ Int_t TDirectoryFile::ReadKeys(Bool_t forceRead)
    if (!fFile->IsBinary())
       return fFile->DirReadKeys(this);
 
+   if (fLazyKeys) {
+      if (!forceRead) {
+         LoadAllKeys();
+         return fKeys->GetSize();
+      }
+      SafeDelete(fLazyKeys);
+   }
+
    TDirectory::TContext ctxt(this);
 
    char *buffer;
@@ -1412,6 +1686,7 @@ void TDirectoryFile::ResetAfterMerge(TFileMergeInfo *info)
    fSeekParent = 0; // updated by Init
    fSeekKeys = 0;   // updated by Init
    // Does not change: fFile
+   if (fLazyKeys) LoadKeys(fName);
    TKey *key = (TKey*)fKeys->FindObject(fName);
    TClass *cl = IsA();
    if (key) {
@@ -1419,6 +1694,7 @@ void TDirectoryFile::ResetAfterMerge(TFileMergeInfo *info)
    }
    // NOTE: We should check that the content is really mergeable and in
    // the in-mmeory list, before deleting the keys.
+   SafeDelete(fLazyKeys);
    if (fKeys) {
       fKeys->Delete("slow");
    }
@@ -1682,7 +1958,10 @@ void TDirectoryFile::Streamer(TBuffer &b)
       }
       R__LOCKGUARD2(gROOTMutex);
       gROOT->GetUUIDs()->AddUUID(fUUID,this);
-      if (fSeekKeys) ReadKeys();
+      if (fSeekKeys) {
+         if (fFile && fFile->IsLazyInit()) ReadKeysLazy();
+         else                              ReadKeys();
+      }
    } else {
       if (fFile && !fFile->IsBinary()) {
          b.WriteVersion(TDirectoryFile::Class());
@@ -1741,14 +2020,138 @@ Int_t TDirectoryFile::Write(const char *, Int_t opt, Int_t bufsize)
    if (!IsWritable()) return 0;
    TDirectory::TContext ctxt(this);
 
-   // Loop on all objects (including subdirs)
+   Int_t nbytes = 0;
+   if (ROOT::IsImplicitMTEnabled() && fFile && fFile->GetCompressionLevel() > 0) {
+      nbytes = WriteAllConcurrently(opt, bufsize);
+   } else {
+      // Loop on all objects (including subdirs)
+      TIter next(fList);
+      TObject *obj;
+      while ((obj=next())) {
+         nbytes += obj->Write(0,opt,bufsize);
+      }
+   }
+   SaveSelf(kTRUE);   // force save itself
+
+   return nbytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write all objects in memory to disk, compressing the objects
+/// concurrently when implicit multi-threading is enabled.
+///
+/// The objects written via TObject::Write are processed in batches: they
+/// are streamed in order, their buffers are compressed in parallel and
+/// their keys are finally created and written in order, as done by
+/// WriteTObject. The other objects (subdirectories, trees, collections...)
+/// are written in turn via their own Write. Return the number of bytes
+/// written.
+
+Int_t TDirectoryFile::WriteAllConcurrently(Int_t opt, Int_t bufsize)
+{
+   const Long64_t kMaxBatchBytes = 64*1024*1024;     // Uncompressed bytes held in memory at once
+
+   // Files storing their keys differently (XML, SQL) write sequentially.
+   TMethod *createKey = fFile->IsA()->GetMethodAllAny("CreateKey");
+   Bool_t defaultKeys = createKey && createKey->GetClass() == TFile::Class();
+
+   std::map<TClass*, Bool_t> concurrentClass;
+   auto canCompressConcurrently = [&](TObject *obj) {
+      if (!defaultKeys) return kFALSE;
+      const char *oname = obj->GetName();
+      Int_t nch = strlen(oname);
+      if (nch && oname[nch-1] == ' ') return kFALSE;
+      TClass *cl = obj->IsA();
+      auto iter = concurrentClass.find(cl);
+      if (iter != concurrentClass.end()) return iter->second;
+      TMethod *write = cl->GetMethodAllAny("Write");
+      Bool_t ok = !cl->InheritsFrom(TDirectory::Class()) && write && write->GetClass() == TObject::Class();
+      concurrentClass[cl] = ok;
+      return ok;
+   };
+
+#ifdef R__USE_IMT
+   ROOT::TThreadExecutor pool;
+#endif
+   std::vector<TKey*> keys;
+   std::vector<TKey*> oldkeys;
+   Long64_t batchBytes = 0;
+   Int_t nbytes = 0;
+
+   auto flush = [&]() {
+      if (keys.empty()) return;
+      auto compress = [&keys](UInt_t i) { return keys[i]->CompressBuffer(); };
+#ifdef R__USE_IMT
+      std::vector<Int_t> nzip = pool.Map(compress, ROOT::TSeqU(keys.size()));
+#else
+      std::vector<Int_t> nzip(keys.size());
+      for (UInt_t i = 0; i < keys.size(); ++i) nzip[i] = compress(i);
+#endif
+      for (UInt_t i = 0; i < keys.size(); ++i) {
+         TKey *key = keys[i];
+         if (fFile->TestBit(TFile::kWriteError)) {
+            if (nzip[i] > 0) { delete [] key->fBuffer; key->fBuffer = 0; }
+            fKeys->Remove(key);
+            delete key;
+            continue;
+         }
+         key->FinalizeBuffer(nzip[i]);
+         if (!key->GetSeekKey()) {
+            fKeys->Remove(key);
+            delete key;
+            continue;
+         }
+         fFile->SumBuffer(key->GetObjlen());
+         Int_t n = key->WriteFile(0);
+         if (fFile->TestBit(TFile::kWriteError)) continue;
+         nbytes += n;
+         if (oldkeys[i]) {
+            oldkeys[i]->Delete();
+            delete oldkeys[i];
+         }
+      }
+      if (bufsize) fFile->SetBufferSize(bufsize);
+      keys.clear();
+      oldkeys.clear();
+      batchBytes = 0;
+   };
+
    TIter next(fList);
    TObject *obj;
-   Int_t nbytes = 0;
    while ((obj=next())) {
-      nbytes += obj->Write(0,opt,bufsize);
+      if (!canCompressConcurrently(obj)) {
+         flush();
+         nbytes += obj->Write(0,opt,bufsize);
+         continue;
+      }
+      if (fFile->TestBit(TFile::kWriteError)) break;
+
+      const char *oname = obj->GetName();
+      TKey *oldkey = 0;
+      if (opt & (kOverwrite | kWriteDelete)) {
+         // A previous key of the batch must be on file before being replaced.
+         oldkey = GetKey(oname);
+         if (oldkey && std::find(keys.begin(), keys.end(), oldkey) != keys.end()) flush();
+      }
+      if (opt & kOverwrite) {
+         //One must use GetKey. FindObject would return the lowest cycle of the key!
+         oldkey = GetKey(oname);
+         if (oldkey) {
+            oldkey->Delete();
+            delete oldkey;
+         }
+         oldkey = 0;
+      } else if (opt & kWriteDelete) {
+         oldkey = GetKey(oname);
+      }
+      Int_t bsize = bufsize > 0 ? bufsize : GetBufferSize();
+      TKey *key = new TKey(obj, oname, bsize, this, kTRUE);
+      keys.push_back(key);
+      oldkeys.push_back(oldkey);
+      batchBytes += key->GetObjlen();
+      if (batchBytes >= kMaxBatchBytes) flush();
    }
-   SaveSelf(kTRUE);   // force save itself
+   flush();
 
    return nbytes;
 }
@@ -2077,6 +2480,9 @@ void TDirectoryFile::WriteKeys()
       return;
    }
 
+   // The old keys structure is about to be freed, read what is left of it.
+   if (fLazyKeys) LoadAllKeys();
+
 //*-* Delete the old keys structure if it exists
    if (fSeekKeys != 0) {
       f->MakeFree(fSeekKeys, fSeekKeys + fNbytesKeys -1);
@@ -84,6 +84,9 @@ The structure of a directory is shown in TDirectoryFile::TDirectoryFile
 #include <sys/stat.h>
 #ifndef WIN32
 #   include <unistd.h>
+#   include <sys/mman.h>
+#   include <sys/uio.h>
+#   include <limits.h>
 #else
 #   define ssize_t int
 #   include <io.h>
@@ -99,6 +102,7 @@ The structure of a directory is shown in TDirectoryFile::TDirectoryFile
 #include "TClass.h"
 #include "TClassEdit.h"
 #include "TClassTable.h"
+#include "TCompressionDictionaries.h"
 #include "TDatime.h"
 #include "TError.h"
 #include "TFile.h"
@@ -123,11 +127,14 @@ The structure of a directory is shown in TDirectoryFile::TDirectoryFile
 #include "TVirtualMonitoring.h"
 #include "TVirtualMutex.h"
 #include "TMathBase.h"
+#include "TMD5.h"
 #include "TObjString.h"
 #include "TStopwatch.h"
 #include "compiledata.h"
 #include <cmath>
+#include <future>
 #include <set>
+#include <vector>
 #include "TSchemaRule.h"
 #include "TSchemaRuleSet.h"
 #include "TThreadSlots.h"
@@ -148,7 +155,7 @@ Bool_t   TFile::fgCacheFileDisconnected = kTRUE;
 UInt_t   TFile::fgOpenTimeout = TFile::kEternalTimeout;
 Bool_t   TFile::fgOnlyStaged = 0;
 #ifdef R__USE_IMT
-ROOT::TRWSpinLock TFile::fgRwLock;
+ROOT::TRWSpinLock TFile::fgRwLock("TFile::fgRwLock");
 #endif
 
 const Int_t kBEGIN = 100;
@@ -187,6 +194,8 @@ TFile::TFile() : TDirectoryFile(), fInfoCache(0)
    fCacheReadMap    = new TMap();
    fCacheWrite      = 0;
    fArchiveOffset   = 0;
+   fMapped          = 0;
+   fMappedSize      = 0;
    fReadCalls       = 0;
    fInfoCache       = 0;
    fOpenPhases      = 0;
@@ -196,6 +205,9 @@ TFile::TFile() : TDirectoryFile(), fInfoCache(0)
    fInitDone        = kFALSE;
    fMustFlush       = kTRUE;
    fIsPcmFile       = kFALSE;
+   fLazyInit        = kFALSE;
+   fReadingInfo     = kFALSE;
+   fInfoPending     = kFALSE;
    fAsyncHandle     = 0;
    fAsyncOpenStatus = kAOSNotAsync;
    SetBit(kBinaryFile, kTRUE);
@@ -262,6 +274,26 @@ TFile::TFile() : TDirectoryFile(), fInfoCache(0)
 ///
 /// This is convenient because the many remote file access plugins allow
 /// easy access to/from the many different mass storage systems.
+/// A local file opened in READ mode can be memory mapped with:
+///
+///     file.root?mmap=1
+///
+/// The reads are then served from the page cache without system calls and
+/// the vectored reads of the TTreeCache only become hints to the kernel
+/// (the cache does not keep its own copy of the data). If the mapping
+/// fails, the file is read in the normal way.
+/// A file opened in READ mode with:
+///
+///     file.root?lazy=1
+///
+/// (or with "TFile.LazyInit: 1" in the system.rootrc file) reads its keys
+/// and its StreamerInfo on demand: the keys record of a directory is read
+/// and indexed by name on the first lookup and only the keys looked up are
+/// created (see TDirectoryFile::ReadKeysLazy), the StreamerInfo record is
+/// read before the first object is read from the file. This reduces the
+/// time to open a file with many keys or classes when only a few objects are
+/// read from it. In this mode a file with an empty list of keys is not
+/// recovered when it is opened.
 /// The title of the file (ftitle) will be shown by the ROOT browsers.
 /// A ROOT file (like a Unix file system) may contain objects and
 /// directories. There are no restrictions for the number of levels
@@ -297,6 +329,9 @@ TFile::TFile() : TDirectoryFile(), fInfoCache(0)
 /// will build an integer which will set the compression to use
 /// the LZMA algorithm and compression level 1.  These are defined
 /// in the header file <em>Compression.h</em>.
+/// ROOT::kLZ4 favours decompression speed, ROOT::kZSTD gives ratios
+/// close to ZLIB with a faster decompression; both are only available
+/// if ROOT was built with the corresponding external library.
 /// Note that the compression settings may be changed at any time.
 /// The new compression settings will only apply to branches created
 /// or attached after the setting is changed and other objects written
@@ -389,6 +424,11 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
    fArchiveOffset = 0;
    fIsArchive     = kFALSE;
    fArchive       = 0;
+   fMapped        = 0;
+   fMappedSize    = 0;
+   fLazyInit      = kFALSE;
+   fReadingInfo   = kFALSE;
+   fInfoPending   = kFALSE;
    if (fIsRootFile && !fIsPcmFile && fOption != "NEW" && fOption != "CREATE"
        && fOption != "RECREATE") {
       // If !gPluginMgr then we are at startup and cannot handle plugins
@@ -514,6 +554,10 @@ TFile::TFile(const char *fname1, Option_t *option, const char *ftitle, Int_t com
          goto zombie;
       }
       fWritable = kFALSE;
+
+      // if option contains mmap=1 serve the reads from a memory mapping
+      if (strstr(fUrl.GetOptions(), "mmap=1"))
+         MapFile();
    }
 
    Init(create);
@@ -792,7 +836,13 @@ void TFile::Init(Bool_t create)
       Bool_t tryrecover = (gEnv->GetValue("TFile.Recover", 1) == 1) ? kTRUE : kFALSE;
 
       //*-* -------------Read keys of the top directory
-      if (fSeekKeys > fBEGIN && fEND <= size) {
+      fLazyInit = !fWritable && (strstr(fUrl.GetOptions(), "lazy=1") ||
+                                 gEnv->GetValue("TFile.LazyInit", 0) == 1);
+      if (fSeekKeys > fBEGIN && fEND <= size && fLazyInit) {
+         //keys read on first lookup, see TDirectoryFile::ReadKeysLazy
+         ReadKeysLazy();
+         gDirectory = this;
+      } else if (fSeekKeys > fBEGIN && fEND <= size) {
          //normal case. Recover only if file has no keys
          TDirectoryFile::ReadKeys(kFALSE);
          gDirectory = this;
@@ -850,7 +900,10 @@ void TFile::Init(Bool_t create)
       if (lenIndex < 5000) lenIndex = 5000;
       fClassIndex = new TArrayC(lenIndex);
       if (fgReadInfo) {
-         if (fSeekInfo > fBEGIN) {
+         if (fSeekInfo > fBEGIN && fLazyInit) {
+            // read before the first object, see ReadPendingStreamerInfo
+            fInfoPending = kTRUE;
+         } else if (fSeekInfo > fBEGIN) {
             ReadStreamerInfo();
             if (IsZombie()) {
                R__LOCKGUARD2(gROOTMutex);
@@ -859,7 +912,7 @@ void TFile::Init(Bool_t create)
             }
          } else if (fVersion != gROOT->GetVersionInt() && fVersion > 30000) {
             // Don't complain about missing streamer info for empty files.
-            if (fKeys->GetSize()) {
+            if (GetNkeys()) {
                Warning("Init","no StreamerInfo found in %s therefore preventing schema evolution when reading this file.",GetName());
             }
          }
@@ -868,12 +921,23 @@ void TFile::Init(Bool_t create)
 
    // Count number of TProcessIDs in this file
    {
-      TIter next(fKeys);
-      TKey *key;
-      while ((key = (TKey*)next())) {
-         if (!strcmp(key->GetClassName(),"TProcessID")) fNProcessIDs++;
+      if (fLazyInit) {
+         // counted when needed, see GetNProcessIDs
+         fNProcessIDs = -1;
+      } else {
+         TIter next(fKeys);
+         TKey *key;
+         while ((key = (TKey*)next())) {
+            if (!strcmp(key->GetClassName(),"TProcessID")) fNProcessIDs++;
+         }
       }
-      fProcessIDs = new TObjArray(fNProcessIDs+1);
+      fProcessIDs = new TObjArray((fNProcessIDs < 0 ? 0 : fNProcessIDs) + 1);
+   }
+
+   // Register the Zstd dictionaries of the small buffers, read with the
+   // StreamerInfo record when it is pending (see ReadStreamerInfoOnDemand)
+   if (!fInfoPending) {
+      TCompressionDictionaries::Load(this);
    }
    return;
 
@@ -910,6 +974,7 @@ void TFile::Close(Option_t *option)
 
    if (fIsArchive || !fIsRootFile) {
       FlushWriteCache();
+      UnmapFile();
       SysClose(fD);
       fD = -1;
 
@@ -965,6 +1030,7 @@ void TFile::Close(Option_t *option)
    }
 
    if (IsOpen()) {
+      UnmapFile();
       SysClose(fD);
       fD = -1;
    }
@@ -1558,6 +1624,10 @@ Bool_t TFile::ReadBuffer(char *buf, Long64_t pos, Int_t len)
       Double_t start = 0;
       if (gPerfStats != 0) start = TTimeStamp();
 
+      // A mapped file is already in memory, no need to look into the cache
+      if (ReadBufferMapped(buf, pos + fArchiveOffset, len))
+         return kFALSE;
+
       if ((st = ReadBufferViaCache(buf, len))) {
          if (st == 2)
             return kTRUE;
@@ -1565,6 +1635,10 @@ Bool_t TFile::ReadBuffer(char *buf, Long64_t pos, Int_t len)
       }
 
       Seek(pos);
+      if (fMapped) {
+         // Not in the mapping, the file descriptor must be at the offset
+         SysSeek(fD, fOffset, SEEK_SET);
+      }
       ssize_t siz;
 
       while ((siz = SysRead(fD, buf, len)) < 0 && GetErrno() == EINTR)
@@ -1602,6 +1676,10 @@ Bool_t TFile::ReadBuffer(char *buf, Int_t len)
 {
    if (IsOpen()) {
 
+      // A mapped file is already in memory, no need to look into the cache
+      if (ReadBufferMapped(buf, fOffset, len))
+         return kFALSE;
+
       Int_t st;
       if ((st = ReadBufferViaCache(buf, len))) {
          if (st == 2)
@@ -1609,6 +1687,11 @@ Bool_t TFile::ReadBuffer(char *buf, Int_t len)
          return kFALSE;
       }
 
+      if (fMapped) {
+         // Not in the mapping, the file descriptor must be at the offset
+         SysSeek(fD, fOffset, SEEK_SET);
+      }
+
       ssize_t siz;
       Double_t start = 0;
 
@@ -1665,6 +1748,29 @@ Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
    Bool_t result = kTRUE;
    TFileCacheRead *old = fCacheRead;
    fCacheRead = 0;
+
+   // Memory mapped file: no need for the read-ahead buffer
+   if (fMapped) {
+      for (Int_t j = 0; j < nbuf; j++) {
+         result = ReadBuffer(&buf[k], pos[j], len[j]);
+         if (result) break;
+         k += len[j];
+      }
+      fCacheRead = old;
+      return result;
+   }
+
+#if defined(R__LINUX) && !defined(R__WINGCC)
+   // Local file: read each run of nearby blocks with a single system call,
+   // directly into the destination buffer.
+   // Derived classes may override the Sys* functions, hence the test.
+   if (IsA() == TFile::Class()) {
+      result = ReadBuffersVectored(buf, pos, len, nbuf);
+      fCacheRead = old;
+      return result;
+   }
+#endif
+
    Long64_t curbegin = pos[0];
    Long64_t cur;
    char *buf2 = 0;
@@ -1711,6 +1817,185 @@ Bool_t TFile::ReadBuffers(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
    return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read len bytes at the physical position pos (i.e. including the archive
+/// offset) from the memory mapping of the file, and move the file offset
+/// after them.
+///
+/// Returns kFALSE if the file is not mapped or if the range is not covered
+/// by the mapping (e.g. the file grew after it was opened): nothing is done
+/// and the caller has to read through the file descriptor.
+
+Bool_t TFile::ReadBufferMapped(char *buf, Long64_t pos, Int_t len)
+{
+   if (!fMapped || pos < 0 || len < 0 || pos + len > fMappedSize)
+      return kFALSE;
+
+   Double_t start = 0;
+   if (gPerfStats != 0) start = TTimeStamp();
+
+   memcpy(buf, fMapped + pos, len);
+   fOffset = pos + len;
+
+   fBytesRead  += len;
+   fgBytesRead += len;
+   fReadCalls++;
+   fgReadCalls++;
+
+   if (gMonitoringWriter)
+      gMonitoringWriter->SendFileReadProgress(this);
+   if (gPerfStats != 0) {
+      gPerfStats->FileReadEvent(this, len, start);
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Memory map the whole file, opened in read mode (see the mmap=1 option of
+/// the constructor). In case of failure a warning is printed and the file
+/// is read through its file descriptor.
+
+void TFile::MapFile()
+{
+#ifndef WIN32
+   if (fD < 0 || fMapped)
+      return;
+
+   Long_t id, flags, modtime;
+   Long64_t size;
+   if (SysStat(fD, &id, &size, &flags, &modtime) || size <= 0)
+      return;
+
+   void *addr = mmap(0, size, PROT_READ, MAP_SHARED, fD, 0);
+   if (addr == MAP_FAILED) {
+      Warning("MapFile", "cannot memory map file %s (errno: %d), reading it normally",
+              GetName(), GetErrno());
+      return;
+   }
+   fMapped = (char *) addr;
+   fMappedSize = size;
+#else
+   Warning("MapFile", "memory mapped files are not supported on this platform");
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove the memory mapping of the file, if any.
+
+void TFile::UnmapFile()
+{
+#ifndef WIN32
+   if (fMapped)
+      munmap(fMapped, fMappedSize);
+#endif
+   fMapped = 0;
+   fMappedSize = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read the nbuf blocks described in arrays pos and len with vectored reads
+/// (preadv). The blocks must be sorted by position.
+///
+/// Consecutive blocks separated by less than fgReadaheadSize bytes are read
+/// with a single call: their data goes directly to buf and the gaps between
+/// them go to a scratch buffer (and are accounted as extra bytes read).
+/// Only used for local files on Linux.
+/// Returns kTRUE in case of failure.
+
+Bool_t TFile::ReadBuffersVectored(char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
+{
+#if defined(R__LINUX) && !defined(R__WINGCC)
+#ifdef IOV_MAX
+   const size_t maxiov = IOV_MAX;
+#else
+   const size_t maxiov = 1024;
+#endif
+   std::vector<struct iovec> iov;
+   iov.reserve(nbuf < (Int_t)maxiov ? 2*nbuf : maxiov);
+   char *gap = 0;
+   Long64_t gapsize = 0;
+   Bool_t result = kFALSE;
+
+   Long64_t k = 0;
+   Int_t i = 0;
+   while (i < nbuf && !result) {
+      // Collect a run of blocks
+      iov.clear();
+      Int_t first = i;
+      Long64_t runbegin = pos[i];
+      Long64_t cur = runbegin;
+      Long64_t nbytes = 0;
+      Long64_t extra = 0;
+      while (i < nbuf && iov.size() + 2 <= maxiov) {
+         Long64_t hole = pos[i] - cur;
+         // Overlapping or far away blocks start a new run
+         if (hole < 0 || hole > fgReadaheadSize) break;
+         if (hole > 0) {
+            if (hole > gapsize) {
+               delete [] gap;
+               gap = new char[hole];
+               gapsize = hole;
+            }
+            struct iovec v = { gap, (size_t)hole };
+            iov.push_back(v);
+            extra += hole;
+         }
+         struct iovec v = { &buf[k + nbytes], (size_t)len[i] };
+         iov.push_back(v);
+         nbytes += len[i];
+         cur = pos[i] + len[i];
+         i++;
+      }
+
+      Double_t start = 0;
+      if (gPerfStats != 0) start = TTimeStamp();
+
+      ssize_t siz;
+#if defined(R__SEEK64)
+      while ((siz = ::preadv64(fD, iov.data(), iov.size(), runbegin + fArchiveOffset)) < 0 &&
+             GetErrno() == EINTR)
+#else
+      while ((siz = ::preadv(fD, iov.data(), iov.size(), runbegin + fArchiveOffset)) < 0 &&
+             GetErrno() == EINTR)
+#endif
+         ResetErrno();
+
+      if (siz < 0) {
+         SysError("ReadBuffers", "error reading from file %s", GetName());
+         result = kTRUE;
+      } else if (siz != nbytes + extra) {
+         // Short read, retry this run block by block
+         for (Int_t j = first; j < i && !result; j++) {
+            Seek(pos[j]);
+            result = ReadBuffer(&buf[k], len[j]);
+            k += len[j];
+         }
+         continue;
+      } else {
+         fBytesRead      += nbytes;
+         fgBytesRead     += nbytes;
+         fBytesReadExtra += extra;
+         fReadCalls++;
+         fgReadCalls++;
+
+         if (gMonitoringWriter)
+            gMonitoringWriter->SendFileReadProgress(this);
+         if (gPerfStats != 0) {
+            gPerfStats->FileReadEvent(this, siz, start);
+         }
+      }
+      k += nbytes;
+   }
+
+   delete [] gap;
+   return result;
+#else
+   Error("ReadBuffersVectored", "vectored reads are not supported on this platform");
+   (void)buf; (void)pos; (void)len; (void)nbuf;
+   return kTRUE;
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read buffer via cache.
 ///
@@ -1774,6 +2059,35 @@ void TFile::ReadFree()
    delete headerfree;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the number of TProcessID written to this file.
+
+Int_t TFile::GetNProcessIDs() const
+{
+   if (fNProcessIDs < 0) const_cast<TFile*>(this)->CountProcessIDs();
+   return fNProcessIDs;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Count the TProcessID of a file opened with the option lazy=1. They are
+/// written with the names ProcessID0, ProcessID1, ..., only these keys are
+/// created.
+
+void TFile::CountProcessIDs()
+{
+   R__LOCKGUARD2(gROOTMutex);
+   if (fNProcessIDs >= 0) return;
+   Int_t npids = 0;
+   char pidname[32];
+   while (1) {
+      snprintf(pidname,32,"ProcessID%d",npids);
+      TKey *key = GetKey(pidname);
+      if (!key || strcmp(key->GetClassName(),"TProcessID")) break;
+      npids++;
+   }
+   fNProcessIDs = npids;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// The TProcessID with number pidf is read from this file.
 ///
@@ -2048,8 +2362,17 @@ Int_t TFile::ReOpen(Option_t *mode)
    } else {
       // switch to UPDATE mode
 
+      // what is still on file must be known before writing to it
+      if (fLazyInit) {
+         ReadPendingStreamerInfo();
+         GetNProcessIDs();
+         GetListOfKeys();
+         fLazyInit = kFALSE;
+      }
+
       // close readonly file
       if (IsOpen()) {
+         UnmapFile();
          SysClose(fD);
          fD = -1;
       }
@@ -2120,6 +2443,15 @@ void TFile::Seek(Long64_t offset, ERelativeTo pos)
          break;
    }
    Long64_t retpos;
+   if (fMapped) {
+      // The reads are served from the mapping, only the offset matters
+      if (whence == SEEK_CUR)
+         offset += fOffset;
+      else if (whence == SEEK_END)
+         offset += fMappedSize;
+      fOffset = offset;
+      return;
+   }
    if ((retpos = SysSeek(fD, offset, whence)) < 0)
       SysError("Seek", "cannot seek to position %lld in file %s, retpos=%lld",
                offset, GetName(), retpos);
@@ -2343,6 +2675,63 @@ Bool_t TFile::WriteBuffer(const char *buf, Int_t len)
    return kTRUE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Write len bytes of buf at position pos, without using nor changing the
+/// current offset of the file and bypassing the write cache. When
+/// CanWriteAsync() returns true, this may be called by a thread while
+/// another one uses the file: the background writer of TFileCacheWrite
+/// relies on it. Returns kTRUE in case of failure.
+
+Bool_t TFile::WriteBufferAt(const char *buf, Long64_t pos, Int_t len)
+{
+   if (!IsOpen() || !fWritable)
+      return kTRUE;
+
+#ifndef R__WIN32
+   if (CanWriteAsync()) {
+      ssize_t siz;
+      while ((siz = ::pwrite(fD, buf, len, pos + fArchiveOffset)) < 0 && GetErrno() == EINTR)
+         ResetErrno();
+      if (siz < 0) {
+         SetBit(kWriteError);
+         SysError("WriteBufferAt", "error writing to file %s (%ld)", GetName(), (Long_t)siz);
+         return kTRUE;
+      }
+      if (siz != len) {
+         SetBit(kWriteError);
+         Error("WriteBufferAt", "error writing all requested bytes to file %s, wrote %ld of %d",
+               GetName(), (Long_t)siz, len);
+         return kTRUE;
+      }
+      fBytesWrite  += siz;
+      fgBytesWrite += siz;
+      return kFALSE;
+   }
+#endif
+
+   // Not thread safe: go through the current offset and the write cache.
+   Long64_t offset = fOffset;
+   Seek(pos);
+   Bool_t status = WriteBuffer(buf, len);
+   fOffset = offset;
+   return status;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if WriteBufferAt() can be called concurrently with the other
+/// operations on this file. This is the case for the local files (but on
+/// Windows), using positional writes; the other classes have to override
+/// both functions.
+
+Bool_t TFile::CanWriteAsync() const
+{
+#ifndef R__WIN32
+   return IsA() == TFile::Class() && fD >= 0 && !fMapped;
+#else
+   return kFALSE;
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Write buffer via cache. Returns 0 if cache is not active, 1 in case
 /// write via cache was successful, 2 in case write via cache failed.
@@ -3392,6 +3781,23 @@ Int_t TFile::MakeProjectParProofInf(const char *pack, const char *proofinf)
    return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read the StreamerInfo record of a file opened with the option lazy=1,
+/// if it has not been read yet. This is called (via ReadPendingStreamerInfo)
+/// before an object is read from the file.
+
+void TFile::ReadStreamerInfoOnDemand()
+{
+   R__LOCKGUARD2(gROOTMutex);
+   // The StreamerInfo record is itself read through a TKey.
+   if (!fInfoPending || fReadingInfo) return;
+   fReadingInfo = kTRUE;
+   ReadStreamerInfo();
+   fReadingInfo = kFALSE;
+   fInfoPending = kFALSE;
+   TCompressionDictionaries::Load(this);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read the list of StreamerInfo from this file.
 ///
@@ -4761,11 +5167,92 @@ void TFile::CpProgress(Long64_t bytesread, Long64_t size, TStopwatch &watch)
    watch.Continue();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Copy this file to dfile, nchunks consecutive chunks of buffersize bytes
+/// at a time: the chunks are requested together with ReadBuffers(), which
+/// fetches them concurrently with the protocols supporting vector reads,
+/// and are written at their offset in dfile while the next ones are read.
+/// At most 2*nchunks*buffersize bytes are buffered. If md5 is not null it
+/// is updated with the bytes copied. Returns kTRUE in case of success.
+
+Bool_t TFile::CpChunks(TFile *dfile, Bool_t progressbar, UInt_t buffersize, Int_t nchunks,
+                       TMD5 *md5, TStopwatch &watch)
+{
+   const Long64_t filesize = GetSize();
+   const Long64_t poolsize = (Long64_t)nchunks * buffersize;
+   std::vector<char> pool[2];
+   pool[0].resize(poolsize);
+   pool[1].resize(poolsize);
+   std::vector<Long64_t> pos(nchunks);
+   std::vector<Int_t> len(nchunks);
+
+   // Writes the n bytes of buf at offset in dfile.
+   auto write = [dfile](const char *buf, Long64_t offset, Long64_t n) {
+      dfile->Seek(offset, TFile::kBeg);
+      Long64_t w0 = dfile->GetBytesWritten();
+      if (dfile->WriteBuffer(buf, (Int_t)n) || (dfile->GetBytesWritten() - w0 != n)) {
+         ::Error("TFile::Cp", "cannot write %lld bytes at offset %lld of destination file %s",
+                 n, offset, dfile->GetName());
+         return kFALSE;
+      }
+      return kTRUE;
+   };
+
+   std::future<Bool_t> pending; // write of the previous batch
+   Bool_t success = kTRUE;
+   Int_t cur = 0;
+   Long64_t totalread = 0;
+   while (success && totalread < filesize) {
+      if (progressbar) CpProgress(totalread, filesize, watch);
+
+      Int_t nbuf = 0;
+      Long64_t batch = 0;
+      while (nbuf < nchunks && totalread + batch < filesize) {
+         pos[nbuf] = totalread + batch;
+         len[nbuf] = (Int_t)TMath::Min((Long64_t)buffersize, filesize - pos[nbuf]);
+         batch += len[nbuf];
+         ++nbuf;
+      }
+      if (ReadBuffers(&pool[cur][0], &pos[0], &len[0], nbuf)) {
+         ::Error("TFile::Cp", "cannot read %lld bytes at offset %lld from source file %s",
+                 batch, totalread, GetName());
+         success = kFALSE;
+         break;
+      }
+      if (md5) md5->Update((const UChar_t *)&pool[cur][0], (UInt_t)batch);
+
+      if (pending.valid() && !pending.get()) {
+         success = kFALSE;
+         break;
+      }
+      pending = std::async(std::launch::async, write, &pool[cur][0], totalread, batch);
+      totalread += batch;
+      cur = 1 - cur;
+   }
+   if (pending.valid() && !pending.get())
+      success = kFALSE;
+
+   if (success && progressbar) {
+      CpProgress(totalread, filesize, watch);
+      fprintf(stderr, "\n");
+   }
+   return success;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Allows to copy this file to the dst URL. Returns kTRUE in case of success,
 /// kFALSE otherwise.
+///
+/// If nchunks is larger than 1, nchunks chunks of buffersize bytes are
+/// read at a time with a vector read (concurrently for the remote protocols
+/// supporting it, like root:// and http://), while the previous ones are
+/// written to the destination. This hides the latency of remote files, at
+/// the cost of 2*nchunks*buffersize bytes of memory.
+///
+/// If md5 is not null, it is updated with the content of the file as it is
+/// copied; the checksum is available after calling md5->Final().
 
-Bool_t TFile::Cp(const char *dst, Bool_t progressbar, UInt_t buffersize)
+Bool_t TFile::Cp(const char *dst, Bool_t progressbar, UInt_t buffersize, Int_t nchunks, TMD5 *md5)
 {
    Bool_t rmdestiferror = kFALSE;
    TStopwatch watch;
@@ -4820,6 +5307,12 @@ Bool_t TFile::Cp(const char *dst, Bool_t progressbar, UInt_t buffersize)
    sfile->Seek(0);
    dfile->Seek(0);
 
+   if (nchunks > 1 && sfile->GetSize() > (Long64_t)buffersize) {
+      watch.Start();
+      success = sfile->CpChunks(dfile, progressbar, buffersize, nchunks, md5, watch);
+      goto copyout;
+   }
+
    copybuffer = new char[buffersize];
    if (!copybuffer) {
       ::Error("TFile::Cp", "cannot allocate the copy buffer");
@@ -4870,6 +5363,7 @@ Bool_t TFile::Cp(const char *dst, Bool_t progressbar, UInt_t buffersize)
          ::Error("TFile::Cp", "cannot write %lld bytes to destination file %s", read, dst);
          goto copyout;
       }
+      if (md5) md5->Update((const UChar_t *)copybuffer, (UInt_t)read);
       totalread += read;
    } while (read == (Long64_t)buffersize);
 
@@ -4897,10 +5391,10 @@ copyout:
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Allows to copy file from src to dst URL. Returns kTRUE in case of success,
-/// kFALSE otherwise.
+/// kFALSE otherwise. See TFile::Cp(const char *dst, ...) for nchunks and md5.
 
 Bool_t TFile::Cp(const char *src, const char *dst, Bool_t progressbar,
-                 UInt_t buffersize)
+                 UInt_t buffersize, Int_t nchunks, TMD5 *md5)
 {
    TUrl sURL(src, kTRUE);
 
@@ -4926,7 +5420,7 @@ Bool_t TFile::Cp(const char *src, const char *dst, Bool_t progressbar,
    if (!(sfile = TFile::Open(sURL.GetUrl(), "READ"))) {
       ::Error("TFile::Cp", "cannot open source file %s", src);
    } else {
-      success = sfile->Cp(dst, progressbar, buffersize);
+      success = sfile->Cp(dst, progressbar, buffersize, nchunks, md5);
    }
 
    if (sfile) sfile->Close();
@@ -4971,8 +5465,24 @@ Bool_t TFile::ReadBufferAsync(Long64_t offset, Int_t len)
    return (result != 0);
 }
 #else
-Bool_t TFile::ReadBufferAsync(Long64_t, Int_t)
+Bool_t TFile::ReadBufferAsync(Long64_t offset, Int_t len)
 {
+#ifndef WIN32
+   // For a memory mapped file we only tell the kernel which pages are going
+   // to be read, the data is then read directly from the mapping.
+   if (fMapped) {
+      if (len == 0)
+         return kFALSE; // ROOT uses zero to probe readahead capabilities
+      Long64_t begin = offset + fArchiveOffset;
+      Long64_t end = TMath::Min(begin + len, fMappedSize);
+      if (begin < 0 || begin >= end)
+         return kTRUE;
+      static const Long64_t pagesize = sysconf(_SC_PAGESIZE);
+      begin -= begin % pagesize;
+      return (madvise(fMapped + begin, end - begin, MADV_WILLNEED) != 0);
+   }
+#endif
+
    // Not supported yet on non Linux systems.
 
    return kTRUE;
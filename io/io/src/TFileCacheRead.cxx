@@ -135,13 +135,21 @@ TFileCacheRead::TFileCacheRead(TFile *file, Int_t buffersize, TObject *tree)
    fPrefetchedBlocks = 0;
 
    //initialise the prefetch object and set the cache directory
-   // start the thread only if the file is not local
+   // start the thread only if the file is not local, or if it is a local
+   // file whose vectored reads do not touch the file offset (see
+   // TFile::ReadBuffersVectored), so that they can run in the prefetching
+   // thread while the main thread reads other records.
    fEnablePrefetching = gEnv->GetValue("TFile.AsyncPrefetching", 0);
 
-   if (fEnablePrefetching && strcmp(file->GetEndpointUrl()->GetProtocol(), "file")){
+   Bool_t remote = file && strcmp(file->GetEndpointUrl()->GetProtocol(), "file");
+   Bool_t concurrentLocal = kFALSE;
+#if defined(R__LINUX) && !defined(R__WINGCC)
+   concurrentLocal = file && file->IsA() == TFile::Class() && !file->IsMapped();
+#endif
+   if (fEnablePrefetching && (remote || concurrentLocal)){
       SetEnablePrefetchingImpl(true);
    }
-   else { //disable the async pref for local files
+   else { //disable the async pref for the other local files
       SetEnablePrefetchingImpl(false);
    }
 
@@ -803,6 +811,10 @@ void TFileCacheRead::SetEnablePrefetchingImpl(Bool_t setPrefetching)
    }
    else {
       fAsyncReading = gEnv->GetValue("TFile.AsyncReading", 0);
+      // A memory mapped file does not need a local copy of the data: the
+      // vectored reads just become hints to the kernel
+      if (fFile && fFile->IsMapped())
+         fAsyncReading = kTRUE;
       if (fAsyncReading) {
          // Check if asynchronous reading is supported by this TFile specialization
          fAsyncReading = kFALSE;
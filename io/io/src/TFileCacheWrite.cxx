@@ -23,12 +23,155 @@ TXNetFile and TWebFile (via TFile::WriteBuffers()).
 
 The write cache is automatically created when writing a remote file
 (created in TFile::Open()).
+
+If asynchronous writing is enabled (SetAsyncWriting() or the rootrc
+variable TFile.AsyncWriting) and the file supports it (see
+TFile::CanWriteAsync()), the cache is double buffered: when a buffer is
+full, it is handed to a background thread which writes it while the other
+one is filled. Only one buffer is written at a time: if the previous one is
+still being written when the current one is full, the filling thread waits.
+The errors of the background writes are reported by the next call to
+WriteBuffer() or Flush().
 */
 
 
+#include "TEnv.h"
 #include "TFile.h"
 #include "TFileCacheWrite.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <string.h>
+#include <thread>
+#include <utility>
+
+namespace ROOT {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Background writer of a TFileCacheWrite: writes one buffer at a time with
+/// TFile::WriteBufferAt(), while the cache fills the other one.
+
+class TFileCacheWriteAsync {
+private:
+   std::thread             fThread;   // Writing thread
+   std::mutex              fMutex;    // Protect the members below
+   std::condition_variable fCond;     // Signal a new buffer or the end of a write
+   TFile                  *fFile;     // File of the buffer being written
+   char                   *fBuffer;   // Buffer being written
+   Long64_t                fSeek;     // Position of fBuffer in the file
+   Int_t                   fNtot;     // Number of bytes of fBuffer to write, 0 if idle
+   Bool_t                  fError;    // A write failed since the last TakeError()
+   Bool_t                  fStop;     // The thread must end
+
+   void Run();
+
+public:
+   TFileCacheWriteAsync(Int_t buffersize);
+   ~TFileCacheWriteAsync();
+
+   void   Post(TFile *file, char *&buffer, Long64_t seek, Int_t ntot);
+   Bool_t Read(char *buf, Long64_t pos, Int_t len);
+   Bool_t TakeError();
+   void   Wait();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+TFileCacheWriteAsync::TFileCacheWriteAsync(Int_t buffersize)
+   : fFile(0), fBuffer(new char[buffersize]), fSeek(0), fNtot(0), fError(kFALSE), fStop(kFALSE)
+{
+   fThread = std::thread(&TFileCacheWriteAsync::Run, this);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the pending buffer, if any, and stop the thread.
+
+TFileCacheWriteAsync::~TFileCacheWriteAsync()
+{
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fStop = kTRUE;
+   }
+   fCond.notify_all();
+   fThread.join();
+   delete [] fBuffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Body of the writing thread.
+
+void TFileCacheWriteAsync::Run()
+{
+   std::unique_lock<std::mutex> lock(fMutex);
+   while (1) {
+      fCond.wait(lock, [this] { return fStop || fNtot > 0; });
+      if (!fNtot)
+         return;
+      TFile *file = fFile;
+      const char *buffer = fBuffer;
+      Long64_t seek = fSeek;
+      Int_t ntot = fNtot;
+      lock.unlock();
+      Bool_t status = file->WriteBufferAt(buffer, seek, ntot);
+      lock.lock();
+      if (status) fError = kTRUE;
+      fNtot = 0;
+      fCond.notify_all();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Start writing the ntot bytes of buffer at seek in file. The thread must
+/// be idle (see Wait()); buffer is exchanged with the one previously written.
+
+void TFileCacheWriteAsync::Post(TFile *file, char *&buffer, Long64_t seek, Int_t ntot)
+{
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      std::swap(buffer, fBuffer);
+      fFile = file;
+      fSeek = seek;
+      fNtot = ntot;
+   }
+   fCond.notify_all();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the len bytes at pos from the buffer being written, if they are all
+/// in it. Returns kTRUE if they were.
+
+Bool_t TFileCacheWriteAsync::Read(char *buf, Long64_t pos, Int_t len)
+{
+   std::lock_guard<std::mutex> lock(fMutex);
+   if (!fNtot || pos < fSeek || pos + len > fSeek + fNtot) return kFALSE;
+   memcpy(buf, fBuffer + pos - fSeek, len);
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return kTRUE if a write failed since the previous call.
+
+Bool_t TFileCacheWriteAsync::TakeError()
+{
+   std::lock_guard<std::mutex> lock(fMutex);
+   Bool_t error = fError;
+   fError = kFALSE;
+   return error;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for the end of the write in progress.
+
+void TFileCacheWriteAsync::Wait()
+{
+   std::unique_lock<std::mutex> lock(fMutex);
+   fCond.wait(lock, [this] { return fNtot == 0; });
+}
+
+} // namespace Internal
+} // namespace ROOT
+
 ClassImp(TFileCacheWrite)
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -42,6 +185,8 @@ TFileCacheWrite::TFileCacheWrite() : TObject()
    fFile        = 0;
    fBuffer      = 0;
    fRecursive   = kFALSE;
+   fAsyncWriting = kFALSE;
+   fAsync       = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -60,6 +205,8 @@ TFileCacheWrite::TFileCacheWrite(TFile *file, Int_t buffersize)
    fFile        = file;
    fRecursive   = kFALSE;
    fBuffer      = new char[fBufferSize];
+   fAsyncWriting = gEnv->GetValue("TFile.AsyncWriting", 0);
+   fAsync       = 0;
    if (file) file->SetCacheWrite(this);
    if (gDebug > 0) Info("TFileCacheWrite","Creating a write cache with buffersize=%d bytes",buffersize);
 }
@@ -69,25 +216,58 @@ TFileCacheWrite::TFileCacheWrite(TFile *file, Int_t buffersize)
 
 TFileCacheWrite::~TFileCacheWrite()
 {
+   delete fAsync;
    delete [] fBuffer;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Flush the current write buffer to the file.
+/// Flush the current write buffer to the file. In asynchronous mode, wait
+/// first for the end of the background write. When the function returns,
+/// all the data given to the cache has been written.
 /// Returns kTRUE in case of error.
 
 Bool_t TFileCacheWrite::Flush()
 {
-   if (!fNtot) return kFALSE;
+   Bool_t asyncStatus = WaitAsync();
+   if (!fNtot) return asyncStatus;
    fFile->Seek(fSeekStart);
    //printf("Flushing buffer at fSeekStart=%lld, fNtot=%d\n",fSeekStart,fNtot);
    fRecursive = kTRUE;
    Bool_t status = fFile->WriteBuffer(fBuffer, fNtot);
    fRecursive = kFALSE;
    fNtot = 0;
+   return status || asyncStatus;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Hand the current write buffer to the background writer, after the end of
+/// the previous background write, and go on with the other buffer. Falls
+/// back to Flush() if asynchronous writing is not enabled or not supported
+/// by the file. Returns kTRUE in case of error, including of the previous
+/// background write.
+
+Bool_t TFileCacheWrite::FlushAsync()
+{
+   if (!fAsyncWriting || !fFile->CanWriteAsync()) return Flush();
+   if (!fNtot) return kFALSE;
+   if (!fAsync) fAsync = new ROOT::Internal::TFileCacheWriteAsync(fBufferSize);
+   Bool_t status = WaitAsync();
+   fAsync->Post(fFile, fBuffer, fSeekStart, fNtot);
+   fNtot = 0;
    return status;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for the end of the background write, if any. Returns kTRUE if a
+/// background write failed since the previous call.
+
+Bool_t TFileCacheWrite::WaitAsync()
+{
+   if (!fAsync) return kFALSE;
+   fAsync->Wait();
+   return fAsync->TakeError();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Print class internal structure.
 
@@ -96,6 +276,7 @@ void TFileCacheWrite::Print(Option_t *option) const
    TString opt = option;
    printf("Write cache for file %s\n",fFile->GetName());
    printf("Size of write cache: %d bytes to be written at %lld\n",fNtot,fSeekStart);
+   printf("Asynchronous writing: %s\n", fAsyncWriting ? "enabled" : "disabled");
    opt.ToLower();
 }
 
@@ -107,7 +288,14 @@ void TFileCacheWrite::Print(Option_t *option) const
 
 Int_t TFileCacheWrite::ReadBuffer(char *buf, Long64_t pos, Int_t len)
 {
-   if (pos < fSeekStart || pos+len > fSeekStart+fNtot) return -1;
+   if (pos < fSeekStart || pos+len > fSeekStart+fNtot) {
+      if (!fAsync) return -1;
+      if (fAsync->Read(buf, pos, len)) return 0;
+      // The data may be partly in the buffer being written: let the
+      // caller read the file once it is written.
+      fAsync->Wait();
+      return -1;
+   }
    memcpy(buf,fBuffer+pos-fSeekStart,len);
    return 0;
 }
@@ -126,12 +314,13 @@ Int_t TFileCacheWrite::WriteBuffer(const char *buf, Long64_t pos, Int_t len)
 
    if (fSeekStart + fNtot != pos) {
       //we must flush the current cache
-      if (Flush()) return -1; //failure
+      if (FlushAsync()) return -1; //failure
    }
    if (fNtot + len >= fBufferSize) {
-      if (Flush()) return -1; //failure
+      if (FlushAsync()) return -1; //failure
       if (len >= fBufferSize) {
          //buffer larger than the cache itself: direct write to file
+         if (WaitAsync()) return -1; //failure
          fRecursive = kTRUE;
          if (fFile->WriteBuffer(buf,len)) return -1;  // failure
          fRecursive = kFALSE;
@@ -151,5 +340,22 @@ Int_t TFileCacheWrite::WriteBuffer(const char *buf, Long64_t pos, Int_t len)
 
 void TFileCacheWrite::SetFile(TFile *file)
 {
+   WaitAsync();
    fFile = file;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// Enable or disable the writing of the full buffers by a background thread
+/// (see the class description). When disabling it, wait for the end of the
+/// background write in progress.
+
+void TFileCacheWrite::SetAsyncWriting(Bool_t async)
+{
+   if (!async && fAsync) {
+      if (WaitAsync())
+         Error("SetAsyncWriting", "a background write to %s failed", fFile ? fFile->GetName() : "");
+      delete fAsync;
+      fAsync = 0;
+   }
+   fAsyncWriting = async;
+}
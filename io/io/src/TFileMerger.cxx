@@ -39,6 +39,7 @@ to be merged, like the standalone hadd program.
 #include "TClassRef.h"
 #include "TROOT.h"
 #include "TMemFile.h"
+#include "ROOT/TTrace.hxx"
 
 #ifdef WIN32
 // For _getmaxstdio
@@ -324,6 +325,31 @@ Bool_t TFileMerger::OutputFile(const char *outputfile, const char *mode /* = "RE
    return res;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Use an already opened file, e.g. a TMemFile, as the merger output file.
+/// The merger takes its ownership.
+
+Bool_t TFileMerger::OutputFile(std::unique_ptr<TFile> outputfile)
+{
+   if (!outputfile || outputfile->IsZombie()) {
+      Error("OutputFile", "cannot use the MERGER output file %s", outputfile ? outputfile->GetName() : "");
+      return kFALSE;
+   }
+   if (!outputfile->IsWritable()) {
+      Error("OutputFile", "the MERGER output file %s is not writable", outputfile->GetName());
+      return kFALSE;
+   }
+   fExplicitCompLevel = kFALSE;
+
+   TFile *oldfile = fOutputFile;
+   fOutputFile = 0; // This avoids the complaint from RecursiveRemove about the file being deleted which is here spurrious. (see RecursiveRemove).
+   SafeDelete(oldfile);
+
+   fOutputFilename = outputfile->GetName();
+   fOutputFile = outputfile.release();
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Print list of files being merged.
 
@@ -352,6 +378,7 @@ Bool_t TFileMerger::Merge(Bool_t)
 
 Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t type /* = kRegular | kAll */)
 {
+   R__TRACE_ZONE("TFileMerger::MergeRecursive", "io");
    Bool_t status = kTRUE;
    Bool_t onlyListed = kFALSE;
    if (fPrintLevel > 0) {
@@ -379,8 +406,13 @@ Bool_t TFileMerger::MergeRecursive(TDirectory *target, TList *sourcelist, Int_t
 
    TFileMergeInfo info(target);
    info.fOptions = fMergeOptions;
-   if (fFastMethod && ((type&kKeepCompression) || !fCompressionChange) ) {
-      info.fOptions.Append(" fast");
+   if (fFastMethod) {
+      if ((type&kKeepCompression) || !fCompressionChange) {
+         info.fOptions.Append(" fast");
+      } else {
+         // Copy the baskets without unstreaming them, but with the output compression.
+         info.fOptions.Append(" fast recompress");
+      }
    }
 
    TFile      *current_file;
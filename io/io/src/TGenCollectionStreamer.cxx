@@ -30,6 +30,8 @@ size(), clear(), resize(). resize() may be a void operation.
 #include "TStreamerElement.h"
 #include "Riostream.h"
 #include "TVirtualCollectionIterators.h"
+#include "TBufferFile.h"
+#include "Bytes.h"
 
 TGenCollectionStreamer::TGenCollectionStreamer(const TGenCollectionStreamer& copy)
       : TGenCollectionProxy(copy), fReadBufferFunc(&TGenCollectionStreamer::ReadBufferDefault)
@@ -740,6 +742,112 @@ To readOneValue(TBuffer &b, int readtype) {
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the size on file of a key or value of a map if it is of a
+/// fundamental type stored as in memory (up to the endianess), 0 otherwise.
+
+static Int_t GetPlainSize(const TGenCollectionProxy::Value *v)
+{
+   if (v->fCase != kIsFundamental && v->fCase != kIsEnum) return 0;
+   switch (int(v->fKind)) {
+      case kBool_t:
+      case EDataType(TGenCollectionProxy::kBOOL_t):
+      case kChar_t:
+      case kUChar_t:
+         return 1;
+      case kShort_t:
+      case kUShort_t:
+         return 2;
+      case kInt_t:
+      case kUInt_t:
+      case kFloat_t:
+         return 4;
+      case kDouble_t:
+      case kLong64_t:
+      case kULong64_t:
+         return 8;
+      default:
+         return 0;
+   }
+}
+
+static inline void CopyFromBuffer(char *&from, char *to, Int_t size)
+{
+   switch (size) {
+      case 1: frombuf(from, (UChar_t*)to);   break;
+      case 2: frombuf(from, (UShort_t*)to);  break;
+      case 4: frombuf(from, (UInt_t*)to);    break;
+      case 8: frombuf(from, (ULong64_t*)to); break;
+   }
+}
+
+static inline void CopyToBuffer(char *&to, const char *from, Int_t size)
+{
+   switch (size) {
+      case 1: tobuf(to, *(const UChar_t*)from);   break;
+      case 2: tobuf(to, *(const UShort_t*)from);  break;
+      case 4: tobuf(to, *(const UInt_t*)from);    break;
+      case 8: tobuf(to, *(const ULong64_t*)from); break;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read at once the keys and values of a map of fundamental types into the
+/// pairs constructed at temp. Returns false, without reading anything, if
+/// the map does not qualify or the buffer is a text based one.
+
+Bool_t TGenCollectionStreamer::ReadMapFundamental(int nElements, TBuffer &b, char *temp)
+{
+   Int_t keySize = GetPlainSize(fKey);
+   Int_t valSize = GetPlainSize(fVal);
+   if (!keySize || !valSize || b.TestBit(TBufferFile::kTextBasedStreaming)) return kFALSE;
+
+   Int_t nbytes = (keySize + valSize) * nElements;
+   if (b.Length() + nbytes > b.BufferSize()) return kFALSE;
+   char *from = b.Buffer() + b.Length();
+   for (int idx = 0; idx < nElements; ++idx) {
+      char *addr = temp + fValDiff * idx;
+      CopyFromBuffer(from, addr, keySize);
+      CopyFromBuffer(from, addr + fValOffset, valSize);
+   }
+   b.SetBufferOffset(b.Length() + nbytes);
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write at once the keys and values of a map of fundamental types, collected
+/// in a contiguous array of pairs. Returns false, without writing anything, if
+/// the map does not qualify or the buffer is a text based one.
+
+Bool_t TGenCollectionStreamer::WriteMapFundamental(int nElements, TBuffer &b)
+{
+   Int_t keySize = GetPlainSize(fKey);
+   Int_t valSize = GetPlainSize(fVal);
+   if (!keySize || !valSize || b.TestBit(TBufferFile::kTextBasedStreaming)) return kFALSE;
+
+   size_t len = fValDiff * nElements;
+   char   buffer[8192];
+   void*  memory = 0;
+   char  *itm = (char*)(fEnv->fStart = (len < sizeof(buffer) ? buffer : memory =::operator new(len)));
+   fCollect(fEnv->fObject,itm);
+
+   Int_t nbytes = (keySize + valSize) * nElements;
+   Int_t start = b.Length();
+   b.AutoExpand(start + nbytes);
+   char *to = b.Buffer() + start;
+   for (int idx = 0; idx < nElements; ++idx) {
+      const char *addr = itm + fValDiff * idx;
+      CopyToBuffer(to, addr, keySize);
+      CopyToBuffer(to, addr + fValOffset, valSize);
+   }
+   b.SetBufferOffset(start + nbytes);
+
+   if (memory) {
+      ::operator delete(memory);
+   }
+   return kTRUE;
+}
+
 void TGenCollectionStreamer::ReadMap(int nElements, TBuffer &b, const TClass *onFileClass)
 {
    // Map input streamer.
@@ -762,7 +870,8 @@ void TGenCollectionStreamer::ReadMap(int nElements, TBuffer &b, const TClass *on
       onFileValueKind[0] = ((TStreamerElement*)sourceInfo->GetElements()->At(0))->GetType();
       onFileValueKind[1] = ((TStreamerElement*)sourceInfo->GetElements()->At(1))->GetType();
    }
-   for (int loop, idx = 0; idx < nElements; ++idx)  {
+   Bool_t done = !onFileClass && ReadMapFundamental(nElements, b, temp);
+   for (int loop, idx = 0; !done && idx < nElements; ++idx)  {
       addr = temp + fValDiff * idx;
       v = fKey;
       for (loop = 0; loop < 2; loop++)  {
@@ -1053,6 +1162,8 @@ void TGenCollectionStreamer::WriteMap(int nElements, TBuffer &b)
    StreamHelper* i;
    Value  *v;
 
+   if (WriteMapFundamental(nElements, b)) return;
+
    for (int loop, idx = 0; idx < nElements; ++idx)  {
       char* addr = (char*)TGenCollectionProxy::At(idx);
       v = fKey;
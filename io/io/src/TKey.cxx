@@ -56,6 +56,7 @@
 #include "TFile.h"
 #include "TKey.h"
 #include "TBufferFile.h"
+#include "ROOT/TBufferPool.hxx"
 #include "TFree.h"
 #include "TBrowser.h"
 #include "Bytes.h"
@@ -226,6 +227,19 @@ TKey::TKey(const TString &name, const TString &title, const TClass *cl, Int_t nb
 ///  by the regular expression parser (see TRegexp).
 
 TKey::TKey(const TObject *obj, const char *name, Int_t bufsize, TDirectory* motherDir)
+     : TKey(obj, name, bufsize, motherDir, kFALSE)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a TKey object for a TObject* and fill output buffer.
+///
+/// If delayCompression is true, the object is only streamed: the caller
+/// is responsible for calling FinalizeBuffer(CompressBuffer()) before
+/// writing the key. Used by TDirectoryFile::Write to compress the objects
+/// of a directory concurrently.
+
+TKey::TKey(const TObject *obj, const char *name, Int_t bufsize, TDirectory* motherDir, Bool_t delayCompression)
      : TNamed(name, obj->GetTitle())
 {
    R__ASSERT(obj);
@@ -240,7 +254,7 @@ TKey::TKey(const TObject *obj, const char *name, Int_t bufsize, TDirectory* moth
 
    Build(motherDir, obj->ClassName(), -1);
 
-   Int_t lbuf, nout, noutot, bufmax, nzip;
+   Int_t lbuf;
    fBufferRef = new TBufferFile(TBuffer::kWrite, bufsize);
    fBufferRef->SetParent(GetFile());
    fCycle     = fMotherDir->AppendKey(this);
@@ -252,43 +266,7 @@ TKey::TKey(const TObject *obj, const char *name, Int_t bufsize, TDirectory* moth
    lbuf       = fBufferRef->Length();
    fObjlen    = lbuf - fKeylen;
 
-   Int_t cxlevel = GetFile() ? GetFile()->GetCompressionLevel() : 0;
-   Int_t cxAlgorithm = GetFile() ? GetFile()->GetCompressionAlgorithm() : 0;
-   if (cxlevel > 0 && fObjlen > 256) {
-      Int_t nbuffers = 1 + (fObjlen - 1)/kMAXZIPBUF;
-      Int_t buflen = TMath::Max(512,fKeylen + fObjlen + 9*nbuffers + 28); //add 28 bytes in case object is placed in a deleted gap
-      fBuffer = new char[buflen];
-      char *objbuf = fBufferRef->Buffer() + fKeylen;
-      char *bufcur = &fBuffer[fKeylen];
-      noutot = 0;
-      nzip   = 0;
-      for (Int_t i = 0; i < nbuffers; ++i) {
-         if (i == nbuffers - 1) bufmax = fObjlen - nzip;
-         else               bufmax = kMAXZIPBUF;
-         R__zipMultipleAlgorithm(cxlevel, &bufmax, objbuf, &bufmax, bufcur, &nout, cxAlgorithm);
-         if (nout == 0 || nout >= fObjlen) { //this happens when the buffer cannot be compressed
-            fBuffer = fBufferRef->Buffer();
-            Create(fObjlen);
-            fBufferRef->SetBufferOffset(0);
-            Streamer(*fBufferRef);         //write key itself again
-            return;
-         }
-         bufcur += nout;
-         noutot += nout;
-         objbuf += kMAXZIPBUF;
-         nzip   += kMAXZIPBUF;
-      }
-      Create(noutot);
-      fBufferRef->SetBufferOffset(0);
-      Streamer(*fBufferRef);         //write key itself again
-      memcpy(fBuffer,fBufferRef->Buffer(),fKeylen);
-      delete fBufferRef; fBufferRef = 0;
-   } else {
-      fBuffer = fBufferRef->Buffer();
-      Create(fObjlen);
-      fBufferRef->SetBufferOffset(0);
-      Streamer(*fBufferRef);         //write key itself again
-   }
+   if (!delayCompression) FinalizeBuffer(CompressBuffer());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -336,44 +314,68 @@ TKey::TKey(const void *obj, const TClass *cl, const char *name, Int_t bufsize, T
    Streamer(*fBufferRef);         //write key itself
    fKeylen    = fBufferRef->Length();
 
-   Int_t lbuf, nout, noutot, bufmax, nzip;
+   Int_t lbuf;
 
    fBufferRef->MapObject(actualStart,clActual);         //register obj in map in case of self reference
    clActual->Streamer((void*)actualStart, *fBufferRef); //write object
    lbuf       = fBufferRef->Length();
    fObjlen    = lbuf - fKeylen;
 
+   FinalizeBuffer(CompressBuffer());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compress the object streamed in fBufferRef into a newly allocated fBuffer.
+///
+/// Return the compressed size of the object or 0 if the object must be
+/// stored uncompressed (no compression requested, object too small or
+/// not compressible). Only the buffers of this key are modified, hence
+/// the keys of several objects can be compressed concurrently.
+
+Int_t TKey::CompressBuffer()
+{
    Int_t cxlevel = GetFile() ? GetFile()->GetCompressionLevel() : 0;
    Int_t cxAlgorithm = GetFile() ? GetFile()->GetCompressionAlgorithm() : 0;
-   if (cxlevel > 0 && fObjlen > 256) {
-      Int_t nbuffers = 1 + (fObjlen - 1)/kMAXZIPBUF;
-      Int_t buflen = TMath::Max(512,fKeylen + fObjlen + 9*nbuffers + 28); //add 28 bytes in case object is placed in a deleted gap
-      fBuffer = new char[buflen];
-      char *objbuf = fBufferRef->Buffer() + fKeylen;
-      char *bufcur = &fBuffer[fKeylen];
-      noutot = 0;
-      nzip   = 0;
-      for (Int_t i = 0; i < nbuffers; ++i) {
-         if (i == nbuffers - 1) bufmax = fObjlen - nzip;
-         else               bufmax = kMAXZIPBUF;
-         R__zipMultipleAlgorithm(cxlevel, &bufmax, objbuf, &bufmax, bufcur, &nout, cxAlgorithm);
-         if (nout == 0 || nout >= fObjlen) { //this happens when the buffer cannot be compressed
-            fBuffer = fBufferRef->Buffer();
-            Create(fObjlen);
-            fBufferRef->SetBufferOffset(0);
-            Streamer(*fBufferRef);         //write key itself again
-            return;
-         }
-         bufcur += nout;
-         noutot += nout;
-         objbuf += kMAXZIPBUF;
-         nzip   += kMAXZIPBUF;
+   if (cxlevel <= 0 || fObjlen <= 256) return 0;
+
+   Int_t nout, bufmax;
+   Int_t nbuffers = 1 + (fObjlen - 1)/kMAXZIPBUF;
+   Int_t buflen = TMath::Max(512,fKeylen + fObjlen + 9*nbuffers + 28); //add 28 bytes in case object is placed in a deleted gap
+   char *zipbuf = new char[buflen];
+   char *objbuf = fBufferRef->Buffer() + fKeylen;
+   char *bufcur = &zipbuf[fKeylen];
+   Int_t noutot = 0;
+   Int_t nzip   = 0;
+   for (Int_t i = 0; i < nbuffers; ++i) {
+      if (i == nbuffers - 1) bufmax = fObjlen - nzip;
+      else               bufmax = kMAXZIPBUF;
+      R__zipMultipleAlgorithm(cxlevel, &bufmax, objbuf, &bufmax, bufcur, &nout, cxAlgorithm);
+      if (nout == 0 || nout >= fObjlen) { //this happens when the buffer cannot be compressed
+         delete [] zipbuf;
+         return 0;
       }
-      Create(noutot);
+      bufcur += nout;
+      noutot += nout;
+      objbuf += kMAXZIPBUF;
+      nzip   += kMAXZIPBUF;
+   }
+   fBuffer = zipbuf;
+   return noutot;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Reserve the space in the file for the object buffer prepared by
+/// CompressBuffer, nzip being its return value, and write the final
+/// key header in front of the object.
+
+void TKey::FinalizeBuffer(Int_t nzip)
+{
+   if (nzip > 0) {
+      Create(nzip);
       fBufferRef->SetBufferOffset(0);
       Streamer(*fBufferRef);         //write key itself again
       memcpy(fBuffer,fBufferRef->Buffer(),fKeylen);
-      delete fBufferRef; fBufferRef = 0;
+      ROOT::Internal::TBufferPool::DeleteBuffer(fBufferRef); fBufferRef = 0;
    } else {
       fBuffer = fBufferRef->Buffer();
       Create(fObjlen);
@@ -517,7 +519,7 @@ void TKey::Create(Int_t nbytes, TFile* externFile)
 TKey::~TKey()
 {
    //   delete [] fBuffer; fBuffer = 0;
-   //   delete fBufferRef; fBufferRef = 0;
+   //   ROOT::Internal::TBufferPool::DeleteBuffer(fBufferRef); fBufferRef = 0;
 
    DeleteBuffer();
 }
@@ -543,7 +545,7 @@ void TKey::Delete(Option_t *option)
 void TKey::DeleteBuffer()
 {
    if (fBufferRef) {
-      delete fBufferRef;
+      ROOT::Internal::TBufferPool::DeleteBuffer(fBufferRef);
       fBufferRef = 0;
    } else {
       // We only need to delete fBuffer if fBufferRef is zero because
@@ -726,6 +728,7 @@ void TKey::Print(Option_t *) const
 
 TObject *TKey::ReadObj()
 {
+   if (GetFile()) GetFile()->ReadPendingStreamerInfo();
    TClass *cl = TClass::GetClass(fClassName.Data());
    if (!cl) {
       Error("ReadObj", "Unknown class %s", fClassName.Data());
@@ -736,35 +739,11 @@ TObject *TKey::ReadObj()
       return (TObject*)ReadObjectAny(0);
    }
 
-   fBufferRef = new TBufferFile(TBuffer::kRead, fObjlen+fKeylen);
-   if (!fBufferRef) {
-      Error("ReadObj", "Cannot allocate buffer: fObjlen = %d", fObjlen);
+   if (TestBit(kBufferPrefetched)) {
+      ResetBit(kBufferPrefetched);
+   } else if (!ReadObjBuffer()) {
       return 0;
    }
-   if (GetFile()==0) return 0;
-   fBufferRef->SetParent(GetFile());
-   fBufferRef->SetPidOffset(fPidOffset);
-
-   if (fObjlen > fNbytes-fKeylen) {
-      fBuffer = new char[fNbytes];
-      if( !ReadFile() )                    //Read object structure from file
-      {
-        delete fBufferRef;
-        delete [] fBuffer;
-        fBufferRef = 0;
-        fBuffer = 0;
-        return 0;
-      }
-      memcpy(fBufferRef->Buffer(),fBuffer,fKeylen);
-   } else {
-      fBuffer = fBufferRef->Buffer();
-      if( !ReadFile() ) {                   //Read object structure from file
-         delete fBufferRef;
-         fBufferRef = 0;
-         fBuffer = 0;
-         return 0;
-      }
-   }
 
    // get version of key
    fBufferRef->SetBufferOffset(sizeof(fNbytes));
@@ -791,36 +770,15 @@ TObject *TKey::ReadObj()
    if (kvers > 1)
       fBufferRef->MapObject(pobj,cl);  //register obj in map to handle self reference
 
-   if (fObjlen > fNbytes-fKeylen) {
-      char *objbuf = fBufferRef->Buffer() + fKeylen;
-      UChar_t *bufcur = (UChar_t *)&fBuffer[fKeylen];
-      Int_t nin, nout = 0, nbuf;
-      Int_t noutot = 0;
-      while (1) {
-         Int_t hc = R__unzip_header(&nin, bufcur, &nbuf);
-         if (hc!=0) break;
-         R__unzip(&nin, bufcur, &nbuf, (unsigned char*) objbuf, &nout);
-         if (!nout) break;
-         noutot += nout;
-         if (noutot >= fObjlen) break;
-         bufcur += nin;
-         objbuf += nout;
-      }
-      if (nout) {
-         tobj->Streamer(*fBufferRef); //does not work with example 2 above
-         delete [] fBuffer;
-      } else {
-         delete [] fBuffer;
-         // Even-though we have a TObject, if the class is emulated the virtual
-         // table may not be 'right', so let's go via the TClass.
-         cl->Destructor(pobj);
-         pobj = 0;
-         tobj = 0;
-         goto CLEAR;
-      }
-   } else {
-      tobj->Streamer(*fBufferRef);
+   if (!UnzipObjBuffer()) {
+      // Even-though we have a TObject, if the class is emulated the virtual
+      // table may not be 'right', so let's go via the TClass.
+      cl->Destructor(pobj);
+      pobj = 0;
+      tobj = 0;
+      goto CLEAR;
    }
+   tobj->Streamer(*fBufferRef); //does not work with example 2 above
 
    if (gROOT->GetForceStyle()) tobj->UseCurrentStyle();
 
@@ -841,13 +799,87 @@ TObject *TKey::ReadObj()
    }
 
 CLEAR:
-   delete fBufferRef;
+   ROOT::Internal::TBufferPool::DeleteBuffer(fBufferRef);
    fBufferRef = 0;
    fBuffer    = 0;
 
    return tobj;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read the record of the object from the file into fBufferRef, or into
+/// fBuffer if the object is compressed (see UnzipObjBuffer).
+///
+/// Return kFALSE in case of error, in which case both buffers are released.
+
+Bool_t TKey::ReadObjBuffer()
+{
+   if (GetFile()==0) return kFALSE;
+   fBufferRef = ROOT::Internal::TBufferPool::CreateBuffer(TBuffer::kRead, fObjlen+fKeylen);
+   fBufferRef->SetParent(GetFile());
+   fBufferRef->SetPidOffset(fPidOffset);
+
+   if (fObjlen > fNbytes-fKeylen) {
+      fBuffer = ROOT::Internal::TBufferPool::Acquire(fNbytes);
+      if( !ReadFile() )                    //Read object structure from file
+      {
+        ROOT::Internal::TBufferPool::DeleteBuffer(fBufferRef);
+        ROOT::Internal::TBufferPool::Release(fBuffer, fNbytes);
+        fBufferRef = 0;
+        fBuffer = 0;
+        return kFALSE;
+      }
+      memcpy(fBufferRef->Buffer(),fBuffer,fKeylen);
+   } else {
+      fBuffer = fBufferRef->Buffer();
+      if( !ReadFile() ) {                   //Read object structure from file
+         ROOT::Internal::TBufferPool::DeleteBuffer(fBufferRef);
+         fBufferRef = 0;
+         fBuffer = 0;
+         return kFALSE;
+      }
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Uncompress the object record read by ReadObjBuffer into fBufferRef.
+///
+/// Nothing is done if the object is not compressed or already uncompressed.
+/// Only the buffers of this key are modified, hence the records of several
+/// keys can be uncompressed concurrently. Return kFALSE in case of error,
+/// in which case both buffers are released.
+
+Bool_t TKey::UnzipObjBuffer()
+{
+   if (!fBufferRef) return kFALSE;
+   if (fBuffer == fBufferRef->Buffer()) return kTRUE;
+
+   char *objbuf = fBufferRef->Buffer() + fKeylen;
+   UChar_t *bufcur = (UChar_t *)&fBuffer[fKeylen];
+   Int_t nin, nout = 0, nbuf;
+   Int_t noutot = 0;
+   while (1) {
+      Int_t hc = R__unzip_header(&nin, bufcur, &nbuf);
+      if (hc!=0) break;
+      R__unzip(&nin, bufcur, &nbuf, (unsigned char*) objbuf, &nout);
+      if (!nout) break;
+      noutot += nout;
+      if (noutot >= fObjlen) break;
+      bufcur += nin;
+      objbuf += nout;
+   }
+   ROOT::Internal::TBufferPool::Release(fBuffer, fNbytes);
+   if (!nout) {
+      ROOT::Internal::TBufferPool::DeleteBuffer(fBufferRef);
+      fBufferRef = 0;
+      fBuffer    = 0;
+      return kFALSE;
+   }
+   fBuffer = fBufferRef->Buffer();
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// To read a TObject* from bufferRead.
 ///
@@ -868,6 +900,7 @@ CLEAR:
 
 TObject *TKey::ReadObjWithBuffer(char *bufferRead)
 {
+   if (GetFile()) GetFile()->ReadPendingStreamerInfo();
 
    TClass *cl = TClass::GetClass(fClassName.Data());
    if (!cl) {
@@ -879,7 +912,7 @@ TObject *TKey::ReadObjWithBuffer(char *bufferRead)
       return (TObject*)ReadObjectAny(0);
    }
 
-   fBufferRef = new TBufferFile(TBuffer::kRead, fObjlen+fKeylen);
+   fBufferRef = ROOT::Internal::TBufferPool::CreateBuffer(TBuffer::kRead, fObjlen+fKeylen);
    if (!fBufferRef) {
       Error("ReadObjWithBuffer", "Cannot allocate buffer: fObjlen = %d", fObjlen);
       return 0;
@@ -970,7 +1003,7 @@ TObject *TKey::ReadObjWithBuffer(char *bufferRead)
    }
 
 CLEAR:
-   delete fBufferRef;
+   ROOT::Internal::TBufferPool::DeleteBuffer(fBufferRef);
    fBufferRef = 0;
    fBuffer    = 0;
 
@@ -1004,7 +1037,8 @@ CLEAR:
 
 void *TKey::ReadObjectAny(const TClass* expectedClass)
 {
-   fBufferRef = new TBufferFile(TBuffer::kRead, fObjlen+fKeylen);
+   if (GetFile()) GetFile()->ReadPendingStreamerInfo();
+   fBufferRef = ROOT::Internal::TBufferPool::CreateBuffer(TBuffer::kRead, fObjlen+fKeylen);
    if (!fBufferRef) {
       Error("ReadObj", "Cannot allocate buffer: fObjlen = %d", fObjlen);
       return 0;
@@ -1014,7 +1048,7 @@ void *TKey::ReadObjectAny(const TClass* expectedClass)
    fBufferRef->SetPidOffset(fPidOffset);
 
    if (fObjlen > fNbytes-fKeylen) {
-      fBuffer = new char[fNbytes];
+      fBuffer = ROOT::Internal::TBufferPool::Acquire(fNbytes);
       ReadFile();                    //Read object structure from file
       memcpy(fBufferRef->Buffer(),fBuffer,fKeylen);
    } else {
@@ -1086,9 +1120,9 @@ void *TKey::ReadObjectAny(const TClass* expectedClass)
       }
       if (nout) {
          cl->Streamer((void*)pobj, *fBufferRef, clOnfile);    //read object
-         delete [] fBuffer;
+         ROOT::Internal::TBufferPool::Release(fBuffer, fNbytes);
       } else {
-         delete [] fBuffer;
+         ROOT::Internal::TBufferPool::Release(fBuffer, fNbytes);
          cl->Destructor(pobj);
          pobj = 0;
          goto CLEAR;
@@ -1126,7 +1160,7 @@ void *TKey::ReadObjectAny(const TClass* expectedClass)
    }
 
    CLEAR:
-   delete fBufferRef;
+   ROOT::Internal::TBufferPool::DeleteBuffer(fBufferRef);
    fBufferRef = 0;
    fBuffer    = 0;
 
@@ -1143,8 +1177,9 @@ void *TKey::ReadObjectAny(const TClass* expectedClass)
 Int_t TKey::Read(TObject *obj)
 {
    if (!obj || (GetFile()==0)) return 0;
+   GetFile()->ReadPendingStreamerInfo();
 
-   fBufferRef = new TBufferFile(TBuffer::kRead, fObjlen+fKeylen);
+   fBufferRef = ROOT::Internal::TBufferPool::CreateBuffer(TBuffer::kRead, fObjlen+fKeylen);
    fBufferRef->SetParent(GetFile());
    fBufferRef->SetPidOffset(fPidOffset);
 
@@ -1152,7 +1187,7 @@ Int_t TKey::Read(TObject *obj)
       fBufferRef->MapObject(obj);  //register obj in map to handle self reference
 
    if (fObjlen > fNbytes-fKeylen) {
-      fBuffer = new char[fNbytes];
+      fBuffer = ROOT::Internal::TBufferPool::Acquire(fNbytes);
       ReadFile();                    //Read object structure from file
       memcpy(fBufferRef->Buffer(),fBuffer,fKeylen);
    } else {
@@ -1176,7 +1211,7 @@ Int_t TKey::Read(TObject *obj)
          objbuf += nout;
       }
       if (nout) obj->Streamer(*fBufferRef);
-      delete [] fBuffer;
+      ROOT::Internal::TBufferPool::Release(fBuffer, fNbytes);
    } else {
       obj->Streamer(*fBufferRef);
    }
@@ -1189,7 +1224,7 @@ Int_t TKey::Read(TObject *obj)
       }
    }
 
-   delete fBufferRef;
+   ROOT::Internal::TBufferPool::DeleteBuffer(fBufferRef);
    fBufferRef = 0;
    fBuffer    = 0;
    return fNbytes;
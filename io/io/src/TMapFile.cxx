@@ -53,6 +53,24 @@ classes don't provide these copy ctor's, especially not when objects
 contain collections, etc. 2) is too limiting or dangerous (calling
 accidentally a virtual function will segv). So since we have a
 robust Streamer mechanism I opted for 3).
+
+For objects whose content is an array, like the histograms with fixed
+binning (a TH1D is a TArrayD), the streaming on each update can be avoided
+with AddShared(). The elements of the array are then kept in the shared
+memory as doubles and are incremented in place by the producers with the
+atomic AtomicAdd(), without taking the semaphore. Other producers which
+open the file in UPDATE mode get the same array with GetSharedBins().
+Get() returns the object of the last Update(), with the current content
+of the shared array: the consumers do not block the producers, each
+element is read atomically but the elements updated while Get() copies
+them can be either before or after the update.
+~~~{.cpp}
+   TMapFile *mfile = TMapFile::Create("hsimple.map", "RECREATE", 1000000);
+   TH1D *h = new TH1D("h", "h", 100, -4, 4);
+   Double_t *bins = mfile->AddShared(h);
+   ...
+   TMapFile::AtomicAdd(bins + h->FindBin(x), 1.);
+~~~
 **/
 
 
@@ -96,6 +114,8 @@ robust Streamer mechanism I opted for 3).
 #include "TClass.h"
 #include "TBufferFile.h"
 #include "TVirtualMutex.h"
+#include "TArray.h"
+#include <atomic>
 #include <cmath>
 
 #if defined(R__UNIX) && !defined(R__MACOSX) && !defined(R__WINGCC)
@@ -136,6 +156,8 @@ TMapRec::TMapRec(const char *name, const TObject *obj, Int_t size, void *buf)
    fObject    = (TObject*)obj;
    fBuffer    = buf;
    fBufSize   = size;
+   fBins      = 0;
+   fNbins     = 0;
    fNext      = 0;
 }
 
@@ -146,6 +168,7 @@ TMapRec::~TMapRec()
 {
    delete [] fName;
    delete [] fClassName;
+   delete [] fBins;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -632,6 +655,102 @@ void TMapFile::Update(TObject *obj)
    ReleaseSemaphore();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add an object whose content is an array (it inherits from TArrayD,
+/// TArrayF, ..., like the histograms) and keep the elements of this array
+/// directly in shared memory.
+///
+/// The object is added as with Add() and streamed once as with Update(),
+/// the returned array of doubles, in shared memory, is initialized with
+/// the elements of the array of the object. The producers increment it
+/// with AtomicAdd(); Get() fills the array of the returned object with it.
+/// The array of obj itself is not changed afterwards: the other data
+/// members of the object returned by Get() (for a histogram, the number
+/// of entries and the statistics) are the ones of the last Update(obj).
+/// The array is deleted when the object is removed, which must not happen
+/// while it is updated. Returns 0 in case of error.
+
+Double_t *TMapFile::AddShared(const TObject *obj, const char *name)
+{
+   if (!fWritable || !fMmallocDesc || !obj) return 0;
+
+   const TArray *array = dynamic_cast<const TArray*>(obj);
+   if (!array || array->GetSize() <= 0) {
+      Error("AddShared", "object %s of class %s has no array to share", obj->GetName(), obj->ClassName());
+      return 0;
+   }
+
+   Add(obj, name);
+
+   AcquireSemaphore();
+
+   Double_t *bins = 0;
+   TMapRec *mr = fFirst;
+   while (mr) {
+      if (mr->fObject == obj) {
+         gMmallocDesc = fMmallocDesc;
+         Int_t n = array->GetSize();
+         bins = new Double_t[n];
+         for (Int_t i = 0; i < n; ++i)
+            bins[i] = array->GetAt(i);
+         delete [] mr->fBins;
+         mr->fBins  = bins;
+         mr->fNbins = n;
+         gMmallocDesc = 0;
+         break;
+      }
+      mr = mr->fNext;
+   }
+
+   ReleaseSemaphore();
+
+   Update(const_cast<TObject*>(obj));
+
+   return bins;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the array in shared memory of the object added with AddShared()
+/// under the given name, and set nbins (if not 0) to its number of elements.
+///
+/// In a producer opening the file in UPDATE mode, the elements can be
+/// incremented with AtomicAdd(). Returns 0 if there is no such array.
+
+Double_t *TMapFile::GetSharedBins(const char *name, Int_t *nbins)
+{
+   if (!fMmallocDesc || !name) return 0;
+
+   AcquireSemaphore();
+
+   Double_t *bins = 0;
+   TMapRec *mr = GetFirst();
+   while (OrgAddress(mr)) {
+      if (!strcmp(mr->GetName(fOffset), name)) {
+         bins = mr->GetBins(fOffset);
+         if (nbins) *nbins = bins ? mr->fNbins : 0;
+         break;
+      }
+      mr = mr->GetNext(fOffset);
+   }
+
+   ReleaseSemaphore();
+
+   return bins;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add atomically w to an element of an array returned by AddShared() or
+/// GetSharedBins(). This can be called concurrently by several threads and
+/// processes, as the atomic operations on doubles are lock-free on the
+/// supported platforms.
+
+void TMapFile::AtomicAdd(Double_t *bin, Double_t w)
+{
+   std::atomic<Double_t> *a = reinterpret_cast<std::atomic<Double_t>*>(bin);
+   Double_t old = a->load(std::memory_order_relaxed);
+   while (!a->compare_exchange_weak(old, old + w, std::memory_order_relaxed)) { }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Remove object from shared memory.
 ///
@@ -770,6 +889,14 @@ TObject *TMapFile::Get(const char *name, TObject *delObj)
          b->DetachBuffer();
          delete b;
          fGetting = 0;
+
+         // current content of the shared array, see AddShared()
+         TArray *array = mr->fBins ? dynamic_cast<TArray*>(obj) : 0;
+         if (array && array->GetSize() == mr->fNbins) {
+            std::atomic<Double_t> *bins = reinterpret_cast<std::atomic<Double_t>*>(mr->GetBins(fOffset));
+            for (Int_t i = 0; i < mr->fNbins; ++i)
+               array->SetAt(bins[i].load(std::memory_order_relaxed), i);
+         }
          goto release;
       }
       mr = mr->GetNext(fOffset);
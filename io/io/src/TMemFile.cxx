@@ -15,6 +15,24 @@
 
 A TMemFile is like a normal TFile except that it reads and writes
 only from memory.
+
+A file received in an existing memory region, e.g. from the network or in
+shared memory, can be read in place, without copying it, with
+~~~{.cpp}
+   TMemFile f("received.root", TMemFile::ZeroCopyView_t(data, size));
+~~~
+The region must stay valid and unchanged as long as the TMemFile exists;
+the file is read-only.
+
+Conversely, the content of a TMemFile which has been written (see
+TFile::Write()) can be sent without copying it, block by block, with
+GetBlockViews(), e.g. with writev() on POSIX systems:
+~~~{.cpp}
+   std::vector<iovec> iov;
+   for (auto &view : file.GetBlockViews())
+      iov.push_back({(void *)view.fStart, (size_t)view.fSize});
+   writev(fd, iov.data(), iov.size());
+~~~
 */
 
 #include "TMemFile.h"
@@ -82,7 +100,7 @@ void TMemFile::TMemBlock::CreateNext(Long64_t size)
 TMemFile::TMemFile(const char *path, Option_t *option,
                    const char *ftitle, Int_t compress) :
    TFile(path, "WEB", ftitle, compress),
-   fSize(-1), fSysOffset(0), fBlockSeek(&fBlockList), fBlockOffset(0)
+   fSize(-1), fSysOffset(0), fBlockSeek(&fBlockList), fBlockOffset(0), fIsOwnedByROOT(kTRUE)
 {
    fOption = option;
    fOption.ToUpper();
@@ -135,7 +153,7 @@ zombie:
 TMemFile::TMemFile(const char *path, char *buffer, Long64_t size, Option_t *option,
                    const char *ftitle, Int_t compress):
    TFile(path, "WEB", ftitle, compress), fBlockList(size),
-   fSize(size), fSysOffset(0), fBlockSeek(&(fBlockList)), fBlockOffset(0)
+   fSize(size), fSysOffset(0), fBlockSeek(&(fBlockList)), fBlockOffset(0), fIsOwnedByROOT(kTRUE)
 {
    fOption = option;
    fOption.ToUpper();
@@ -179,13 +197,39 @@ zombie:
    gDirectory = gROOT;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor reading the ROOT file held in the memory region datarange,
+/// without copying it. The region is owned by the caller: it must stay
+/// valid and unchanged as long as the TMemFile exists, and is not deleted
+/// by it. The file is opened read-only.
+
+TMemFile::TMemFile(const char *path, const ZeroCopyView_t &datarange, const char *ftitle) :
+   TFile(path, "WEB", ftitle, 0),
+   fSize(datarange.fSize), fSysOffset(0), fBlockSeek(&(fBlockList)), fBlockOffset(0), fIsOwnedByROOT(kFALSE)
+{
+   fOption = "READ";
+   fWritable = kFALSE;
+
+   if (!datarange.fStart || datarange.fSize <= 0) {
+      Error("TMemFile", "file %s can not be read from an empty memory region", path);
+      MakeZombie();
+      gDirectory = gROOT;
+      return;
+   }
+   fBlockList.fBuffer = reinterpret_cast<UChar_t *>(const_cast<char *>(datarange.fStart));
+   fBlockList.fSize = datarange.fSize;
+
+   fD = SysOpen(path, O_RDONLY, 0644);
+   Init(kFALSE);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Copying the content of the TMemFile into another TMemFile.
 
 TMemFile::TMemFile(const TMemFile &orig) :
    TFile(orig.GetEndpointUrl()->GetUrl(), "WEB", orig.GetTitle(),
          orig.GetCompressionSettings() ), fBlockList(orig.GetEND()),
-   fSize(orig.GetEND()), fSysOffset(0), fBlockSeek(&(fBlockList)), fBlockOffset(0)
+   fSize(orig.GetEND()), fSysOffset(0), fBlockSeek(&(fBlockList)), fBlockOffset(0), fIsOwnedByROOT(kTRUE)
 {
    fOption = orig.fOption;
 
@@ -216,6 +260,11 @@ TMemFile::~TMemFile()
    // Need to call close, now as it will need both our virtual table
    // and the content of the list of blocks
    Close();
+   if (!fIsOwnedByROOT) {
+      // The external buffer belongs to the caller.
+      fBlockList.fBuffer = 0;
+      fBlockList.fSize = 0;
+   }
    TRACE("destroy")
 }
 
@@ -256,6 +305,27 @@ void TMemFile::CopyTo(TBuffer &tobuf) const
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the memory blocks holding the content of the TMemFile, i.e. its
+/// first GetEND() bytes, in order, to be sent without copying them. As for
+/// CopyTo(), the file must have been written (see TFile::Write()) for its
+/// header and keys to be up to date. The views are valid until the file is
+/// modified or deleted.
+
+std::vector<TMemFile::ZeroCopyView_t> TMemFile::GetBlockViews() const
+{
+   std::vector<ZeroCopyView_t> views;
+   Long64_t left = GetEND();
+   const TMemBlock *current = &fBlockList;
+   while (current && left > 0) {
+      Long64_t len = current->fSize < left ? current->fSize : left;
+      views.push_back(ZeroCopyView_t(reinterpret_cast<const char *>(current->fBuffer), len));
+      left -= len;
+      current = current->fNext;
+   }
+   return views;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the current size of the memory file
 
@@ -291,6 +361,10 @@ void TMemFile::Print(Option_t *option /* = "" */) const
 
 void TMemFile::ResetAfterMerge(TFileMergeInfo *info)
 {
+   if (!fIsOwnedByROOT) {
+      Error("ResetAfterMerge", "the external buffer of %s can not be reset", GetName());
+      return;
+   }
    ResetObjects(this,info);
 
    fNbytesKeys = 0;
@@ -561,6 +635,11 @@ Int_t TMemFile::SysWrite(Int_t /* fd */, const void *buf, Int_t len)
 {
    TRACE("WRITE")
 
+   if (!fIsOwnedByROOT) {
+      errno = EROFS;
+      gSystem->SetErrorStr("The external buffer of the memory file is read-only.");
+      return -1;
+   }
    if (fBlockList.fBuffer == 0) {
       errno = EBADF;
       gSystem->SetErrorStr("The memory file is not open.");
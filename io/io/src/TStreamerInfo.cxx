@@ -55,6 +55,7 @@ element type.
 #include "TRef.h"
 #include "TProcessID.h"
 #include "TSystem.h"
+#include "TRegexp.h"
 
 #include "TStreamer.h"
 #include "TContainerConverters.h"
@@ -75,6 +76,7 @@ element type.
 
 #include <memory>
 #include <array>
+#include <vector>
 
 std::atomic<Int_t> TStreamerInfo::fgCount{0};
 
@@ -2521,6 +2523,63 @@ void TStreamerInfo::BuildOld()
    Compile();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Compile the StreamerInfos known in this process which are not compiled
+/// yet, for the classes whose name matches the wildcard expression classes.
+///
+/// The StreamerInfos read from a file, in particular those of the older
+/// versions of a class, are only compiled (i.e. their actions sequences are
+/// created) when an object of this version is first read. Calling this
+/// function before forking creates them once in the parent process: the
+/// children share them instead of each creating them again. This is done by
+/// TProcessExecutor unless the rootrc variable MultiProc.CompileStreamerInfo
+/// is 0, for example after opening one of the files to process to read its
+/// StreamerInfo in the parent. The member-wise actions of the collections
+/// are also created, for each version of their content known in the process.
+///
+/// Return the number of StreamerInfos compiled.
+
+Int_t TStreamerInfo::CompileAll(const char *classes)
+{
+   TRegexp re(classes && classes[0] ? classes : "*", kTRUE);
+   Int_t ncompiled = 0;
+
+   R__LOCKGUARD(gInterpreterMutex);
+
+   // Compiling a StreamerInfo may create new TClass objects.
+   std::vector<TClass*> list;
+   list.reserve(gROOT->GetListOfClasses()->GetSize());
+   TIter next(gROOT->GetListOfClasses());
+   while (TClass *cl = (TClass*)next()) {
+      list.push_back(cl);
+   }
+
+   for (TClass *cl : list) {
+      TString name(cl->GetName());
+      if (name.Index(re) == kNPOS) continue;
+
+      TVirtualCollectionProxy *proxy = cl->GetCollectionProxy();
+      if (proxy) {
+         TClass *valueClass = proxy->GetValueClass();
+         if (!valueClass || proxy->HasPointers() || valueClass->GetCollectionProxy()) continue;
+         const TObjArray *infos = valueClass->GetStreamerInfos();
+         for (Int_t v = infos->LowerBound(); v <= infos->GetLast(); ++v) {
+            if (infos->At(v)) proxy->GetReadMemberWiseActions(v);
+         }
+         continue;
+      }
+
+      const TObjArray *infos = cl->GetStreamerInfos();
+      for (Int_t v = infos->LowerBound(); v <= infos->GetLast(); ++v) {
+         TVirtualStreamerInfo *info = (TVirtualStreamerInfo*)infos->At(v);
+         if (!info || info->IsCompiled()) continue;
+         info = cl->GetStreamerInfo(v);
+         if (info && info->IsCompiled()) ++ncompiled;
+      }
+   }
+   return ncompiled;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// If opt contains 'built', reset this StreamerInfo as if Build or BuildOld
 /// was never called on it (useful to force their re-running).
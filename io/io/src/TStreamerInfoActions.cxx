@@ -23,6 +23,7 @@
 #include "TClassEdit.h"
 #include "TVirtualCollectionIterators.h"
 #include "TProcessID.h"
+#include "Bswapcpy.h"
 
 static const Int_t kRegrouped = TStreamerInfo::kOffsetL;
 
@@ -226,6 +227,245 @@ namespace TStreamerInfoActions
       return 0;
    }
 
+   class TFusedBasicTypesConfiguration : public TConfiguration {
+      // Configuration of the action streaming in one go a run of consecutive
+      // data members of fundamental types, contiguous in memory and whose
+      // on-file representation is the in-memory one, up to the endianess.
+      // fCompInfo and fElemId are those of the first member of the run.
+   public:
+      struct Segment_t {
+         Int_t fSize;   // Size in byte of the elements
+         Int_t fCount;  // Number of consecutive elements of this size
+      };
+
+      Int_t                  fNbytes;   // Total number of bytes of the run
+      std::vector<Segment_t> fSegments; // Elements of the run, grouped by size
+      ActionContainer_t      fActions;  // The actions of each member, for the text based buffers
+
+      TFusedBasicTypesConfiguration(TVirtualStreamerInfo *info, UInt_t id, TCompInfo_t *compinfo, Int_t offset) : TConfiguration(info,id,compinfo,offset),fNbytes(0) {};
+
+      void Add(const TConfiguredAction &action, Int_t size, Int_t count)
+      {
+         // Append the (moved) action of a member made of count elements of the given size.
+
+         fActions.push_back(action);
+         fNbytes += size * count;
+         if (!fSegments.empty() && fSegments.back().fSize == size) {
+            fSegments.back().fCount += count;
+         } else {
+            Segment_t segment = { size, count };
+            fSegments.push_back(segment);
+         }
+      }
+
+      void AddToOffset(Int_t delta)
+      {
+         // Add the (potentially negative) delta to all the configuration's offset.  This is used by
+         // TBranchElement in the case of split sub-object.
+
+         fOffset += delta;
+         for (ActionContainer_t::iterator iter = fActions.begin(); iter != fActions.end(); ++iter) {
+            iter->fConfiguration->AddToOffset(delta);
+         }
+      }
+
+      Int_t ApplyOneByOne(TBuffer &buf, void *addr) const
+      {
+         // Stream the members with their own action; the buffer has already been
+         // told about the first one.
+
+         for (ActionContainer_t::const_iterator iter = fActions.begin(); iter != fActions.end(); ++iter) {
+            if (iter != fActions.begin()) {
+               buf.SetStreamerElementNumber(iter->fConfiguration->fCompInfo->fElem, iter->fConfiguration->fCompInfo->fType);
+            }
+            (*iter)(buf, addr);
+         }
+         return 0;
+      }
+
+      void Print() const
+      {
+         for (ActionContainer_t::const_iterator iter = fActions.begin(); iter != fActions.end(); ++iter) {
+            iter->fConfiguration->Print();
+         }
+      }
+
+      void PrintDebug(TBuffer &buf, void *addr) const
+      {
+         for (ActionContainer_t::const_iterator iter = fActions.begin(); iter != fActions.end(); ++iter) {
+            iter->fConfiguration->PrintDebug(buf, addr);
+         }
+      }
+
+      virtual TConfiguration *Copy()
+      {
+         TFusedBasicTypesConfiguration *copy = new TFusedBasicTypesConfiguration(fInfo,fElemId,fCompInfo,fOffset);
+         copy->fNbytes = fNbytes;
+         copy->fSegments = fSegments;
+         copy->fActions.reserve(fActions.size());
+         for (ActionContainer_t::const_iterator iter = fActions.begin(); iter != fActions.end(); ++iter) {
+            copy->fActions.push_back(TConfiguredAction(iter->fAction, iter->fConfiguration->Copy()));
+         }
+         return copy;
+      }
+   };
+
+   static void SwapSegments(char *where, const TFusedBasicTypesConfiguration *conf)
+   {
+      // Byte swap in place the elements of the run starting at where.
+
+      for (std::vector<TFusedBasicTypesConfiguration::Segment_t>::const_iterator iter = conf->fSegments.begin();
+           iter != conf->fSegments.end(); ++iter) {
+         switch (iter->fSize) {
+            case 2: bswapcpy16(where, where, iter->fCount); break;
+            case 4: bswapcpy32(where, where, iter->fCount); break;
+            case 8: bswapcpy64(where, where, iter->fCount); break;
+            default: break;
+         }
+         where += iter->fSize * iter->fCount;
+      }
+   }
+
+   Int_t ReadFusedBasicTypes(TBuffer &buf, void *addr, const TConfiguration *config)
+   {
+      // Read a run of fundamental members with a single copy, followed on
+      // little endian platforms by an in place byte swap.
+
+      const TFusedBasicTypesConfiguration *conf = (const TFusedBasicTypesConfiguration*)config;
+      if (buf.TestBit(TBufferFile::kTextBasedStreaming)) {
+         return conf->ApplyOneByOne(buf, addr);
+      }
+      char *where = ((char*)addr) + config->fOffset;
+      buf.ReadFastArray(where, conf->fNbytes);
+#ifdef R__BYTESWAP
+      SwapSegments(where, conf);
+#endif
+      return 0;
+   }
+
+   Int_t WriteFusedBasicTypes(TBuffer &buf, void *addr, const TConfiguration *config)
+   {
+      // Write a run of fundamental members with a single copy, followed on
+      // little endian platforms by an in place byte swap within the buffer.
+
+      const TFusedBasicTypesConfiguration *conf = (const TFusedBasicTypesConfiguration*)config;
+      if (buf.TestBit(TBufferFile::kTextBasedStreaming)) {
+         return conf->ApplyOneByOne(buf, addr);
+      }
+      Int_t start = buf.Length();
+      buf.WriteFastArray(((char*)addr) + config->fOffset, conf->fNbytes);
+#ifdef R__BYTESWAP
+      // The buffer may have been expanded, so look it up after writing.
+      SwapSegments(buf.Buffer() + start, conf);
+#else
+      (void)start;
+#endif
+      return 0;
+   }
+
+   static Int_t GetFusableTypeSize(Int_t type)
+   {
+      // Return the size of the fundamental type if its members can be part of
+      // a fused run, i.e. if its on-file and in-memory sizes are identical.
+
+      switch (type) {
+         case TStreamerInfo::kBool:
+         case TStreamerInfo::kChar:
+         case TStreamerInfo::kUChar:   return 1;
+         case TStreamerInfo::kShort:
+         case TStreamerInfo::kUShort:  return 2;
+         case TStreamerInfo::kInt:
+         case TStreamerInfo::kUInt:
+         case TStreamerInfo::kFloat:   return 4;
+         case TStreamerInfo::kDouble:
+         case TStreamerInfo::kLong64:
+         case TStreamerInfo::kULong64: return 8;
+         default:                      return 0;
+      }
+   }
+
+   static Bool_t IsFusable(const TConfiguredAction &action, Bool_t read, Int_t &offset, Int_t &size, Int_t &count)
+   {
+      // Return true if the action streams a member, or a group of members
+      // regrouped by TStreamerInfo::Compile, of fundamental types without
+      // conversion: either a single value with ReadBasicType/WriteBasicType
+      // or a fixed size array with the generic action. Set the offset in
+      // the object, the size of the elements and their number.
+
+      const TConfiguration *config = action.fConfiguration;
+      const TStreamerInfo::TCompInfo_t *compinfo = config->fCompInfo;
+      const TStreamerElement *element = compinfo->fElem;
+      if (!element || element->TestBit(TStreamerElement::kCache) || element->TestBit(TStreamerElement::kWrite)
+          || compinfo->fOffset == TStreamerInfo::kMissing) {
+         return kFALSE;
+      }
+      Int_t type = compinfo->fType;
+      if (type > kRegrouped && type < kRegrouped + TStreamerInfo::kFloat16) {
+         if (action.fAction != (read ? GenericReadAction : GenericWriteAction)) return kFALSE;
+         size = GetFusableTypeSize(type - kRegrouped);
+         count = compinfo->fLength;
+         offset = compinfo->fOffset + config->fOffset;
+         return size && count > 0;
+      }
+      TStreamerInfoAction_t expected = 0;
+      switch (type) {
+         case TStreamerInfo::kBool:    expected = read ? ReadBasicType<Bool_t>    : WriteBasicType<Bool_t>;    break;
+         case TStreamerInfo::kChar:    expected = read ? ReadBasicType<Char_t>    : WriteBasicType<Char_t>;    break;
+         case TStreamerInfo::kUChar:   expected = read ? ReadBasicType<UChar_t>   : WriteBasicType<UChar_t>;   break;
+         case TStreamerInfo::kShort:   expected = read ? ReadBasicType<Short_t>   : WriteBasicType<Short_t>;   break;
+         case TStreamerInfo::kUShort:  expected = read ? ReadBasicType<UShort_t>  : WriteBasicType<UShort_t>;  break;
+         case TStreamerInfo::kInt:     expected = read ? ReadBasicType<Int_t>     : WriteBasicType<Int_t>;     break;
+         case TStreamerInfo::kUInt:    expected = read ? ReadBasicType<UInt_t>    : WriteBasicType<UInt_t>;    break;
+         case TStreamerInfo::kFloat:   expected = read ? ReadBasicType<Float_t>   : WriteBasicType<Float_t>;   break;
+         case TStreamerInfo::kDouble:  expected = read ? ReadBasicType<Double_t>  : WriteBasicType<Double_t>;  break;
+         case TStreamerInfo::kLong64:  expected = read ? ReadBasicType<Long64_t>  : WriteBasicType<Long64_t>;  break;
+         case TStreamerInfo::kULong64: expected = read ? ReadBasicType<ULong64_t> : WriteBasicType<ULong64_t>; break;
+         default: return kFALSE;
+      }
+      if (action.fAction != expected) return kFALSE;
+      size = GetFusableTypeSize(type);
+      count = 1;
+      offset = config->fOffset;
+      return kTRUE;
+   }
+
+   static void FuseBasicTypeActions(TActionSequence *sequence, Bool_t read)
+   {
+      // Replace each run of at least two consecutive actions streaming
+      // fundamental members laid out contiguously in memory by a single
+      // ReadFusedBasicTypes or WriteFusedBasicTypes action.
+
+      ActionContainer_t &actions = sequence->fActions;
+      ActionContainer_t fused;
+      fused.reserve(actions.size());
+
+      size_t i = 0;
+      while (i < actions.size()) {
+         Int_t offset, size, count;
+         size_t end = i;
+         Int_t next = 0;
+         while (end < actions.size() && IsFusable(actions[end], read, offset, size, count)
+                && (end == i || offset == next)) {
+            next = offset + size * count;
+            ++end;
+         }
+         if (end - i < 2) {
+            fused.push_back(actions[i]); // Action is moved.
+            ++i;
+            continue;
+         }
+         IsFusable(actions[i], read, offset, size, count);
+         TConfiguration *first = actions[i].fConfiguration;
+         TFusedBasicTypesConfiguration *conf = new TFusedBasicTypesConfiguration(first->fInfo, first->fElemId, first->fCompInfo, offset);
+         for (; i < end; ++i) {
+            IsFusable(actions[i], read, offset, size, count);
+            conf->Add(actions[i], size, count); // Action is moved.
+         }
+         fused.push_back(TConfiguredAction(read ? ReadFusedBasicTypes : WriteFusedBasicTypes, conf));
+      }
+      actions.swap(fused);
+   }
+
    class TConfWithFactor : public TConfiguration {
       // Configuration object for the Float16/Double32 where a factor has been specified.
    public:
@@ -2462,6 +2702,13 @@ void TStreamerInfo::Compile()
       AddReadAction(fReadObjectWise, i, fCompOpt[i]);
       AddWriteAction(fWriteObjectWise, i, fCompOpt[i]);
    }
+   if (!TestBit(kCannotOptimize)) {
+      // Stream with a single copy (and byte swap) the runs of consecutive
+      // fundamental members which the grouping above could not merge
+      // because their types differ.
+      FuseBasicTypeActions(fReadObjectWise, kTRUE);
+      FuseBasicTypeActions(fWriteObjectWise, kFALSE);
+   }
    for (i = 0; i < fNfulldata; ++i) {
       if (!fCompFull[i]->fElem || fCompFull[i]->fElem->GetType()< 0) {
          continue;
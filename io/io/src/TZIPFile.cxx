@@ -26,7 +26,8 @@ compression algorithm. The archive format is used among others by
 PKZip and Info-ZIP. The compression algorithm is also used by
 GZIP and the PNG graphics standard. The format of the archives is
 explained briefly below. This class provides an interface to read
-such archives.
+such archives, and MakeArchive() creates them from a list of files,
+writing the members in parallel.
 A ZIP archive contains a prefix, series of archive members
 (sub-files), and a central directory. In theory the archive could
 span multiple disks (or files) with the central directory of the
@@ -50,11 +51,94 @@ stored in archives larger than 4 GB.
 Once the archive has been opened, the client can query the members
 and read their contents by asking the archive for an offset where
 the sub-file starts. The members can be accessed in any order.
+The directory is read at once, and the directories of the last
+archives opened are kept: opening the other members of an archive,
+possibly from several threads at the same time, does not read its
+directory again.
 */
 
 #include "TZIPFile.h"
 #include "TFile.h"
 #include "TObjArray.h"
+#include "TSystem.h"
+#include "TError.h"
+
+#include "zlib.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <fstream>
+#include <list>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Members of the directories read last, shared by all the TZIPFile objects:
+/// an archive is usually opened once for each member which is read, possibly
+/// from several threads at the same time. An archive is identified by its
+/// name, its size and the position and size of its directory. The cache is
+/// never deleted, archives may be opened during the destruction of the
+/// static objects.
+
+class TZIPDirectoryCache {
+   enum { kMaxArchives = 16 };
+
+   std::mutex                               fMutex;
+   std::list<std::pair<TString, TObjArray*>> fArchives; // the most recent first
+
+public:
+   static TZIPDirectoryCache &Instance()
+   {
+      static TZIPDirectoryCache *cache = new TZIPDirectoryCache;
+      return *cache;
+   }
+
+   /// Copy the members of the archive key to members, return false if they
+   /// are not in the cache.
+   Bool_t Get(const TString &key, TObjArray *members)
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      for (auto it = fArchives.begin(); it != fArchives.end(); ++it) {
+         if (it->first != key)
+            continue;
+         TIter next(it->second);
+         while (TObject *m = next())
+            members->Add(new TZIPMember(*(TZIPMember*)m));
+         fArchives.splice(fArchives.begin(), fArchives, it);
+         return kTRUE;
+      }
+      return kFALSE;
+   }
+
+   /// Keep a copy of the members of the archive key.
+   void Add(const TString &key, const TObjArray *members)
+   {
+      TObjArray *copy = new TObjArray(members->GetEntriesFast());
+      copy->SetOwner();
+      TIter next(members);
+      while (TObject *m = next())
+         copy->Add(new TZIPMember(*(TZIPMember*)m));
+
+      std::lock_guard<std::mutex> lock(fMutex);
+      for (auto &archive : fArchives) {
+         if (archive.first == key) {
+            // added meanwhile by another thread
+            delete copy;
+            return;
+         }
+      }
+      fArchives.emplace_front(key, copy);
+      if (fArchives.size() > kMaxArchives) {
+         delete fArchives.back().second;
+         fArchives.pop_back();
+      }
+   }
+};
+
+} // unnamed namespace
 
 
 ClassImp(TZIPFile)
@@ -274,25 +358,45 @@ Int_t TZIPFile::ReadZip64EndRecord(Long64_t pos)
 ////////////////////////////////////////////////////////////////////////////////
 /// Read the directory of the ZIP archive. Returns -1 in case of error,
 /// 0 otherwise.
+///
+/// The directory is read with a single request and then decoded. The
+/// members of the last archives opened are kept, so that opening the
+/// members of an archive one after the other, or from several threads,
+/// reads and decodes its directory only once.
 
 Int_t TZIPFile::ReadDirectory()
 {
-   char   buf[kDIR_HEADER_SIZE];
-   UInt_t n, i;
+   TString key;
+   key.Form("%s:%lld:%lld:%lld", fArchiveName.Data(), fFile->GetSize(), fDirPos, fDirSize);
+   if (TZIPDirectoryCache::Instance().Get(key, fMembers))
+      return 0;
 
-   // read and validate first the header magic
+   if (fDirSize < 0 || fDirSize > kMaxInt - kZIP_MAGIC_LEN) {
+      Error("ReadDirectory", "wrong directory size %lld in %s", fDirSize, fArchiveName.Data());
+      return -1;
+   }
+   // the directory and the magic of the end header which follows it
+   std::vector<char> dir(fDirSize + kZIP_MAGIC_LEN);
    fFile->Seek(fDirPos);
-   if (fFile->ReadBuffer(buf, kZIP_MAGIC_LEN) ||
-       (n = Get(buf, kZIP_MAGIC_LEN)) != kDIR_HEADER_MAGIC) {
+   if (fFile->ReadBuffer(dir.data(), (Int_t)dir.size())) {
+      Error("ReadDirectory", "error reading %lld directory bytes from %s",
+            fDirSize, fArchiveName.Data());
+      return -1;
+   }
+   const char *buf = dir.data();
+   const char *end = dir.data() + dir.size();
+   UInt_t n = Get(buf, kZIP_MAGIC_LEN);
+
+   // validate first the header magic
+   if (n != kDIR_HEADER_MAGIC) {
       Error("ReadDirectory", "wrong directory header magic in %s",
             fArchiveName.Data());
       return -1;
    }
 
-   // now read the full directory
-   for (i = 0; n == kDIR_HEADER_MAGIC; i++) {
-      // read the rest of the header
-      if (fFile->ReadBuffer(buf + kZIP_MAGIC_LEN, kDIR_HEADER_SIZE - kZIP_MAGIC_LEN)) {
+   // now decode the full directory
+   for (UInt_t i = 0; n == kDIR_HEADER_MAGIC; i++) {
+      if (end - buf < kDIR_HEADER_SIZE + kZIP_MAGIC_LEN) {
          Error("ReadDirectory", "error reading %d directory bytes from %s",
                kDIR_HEADER_SIZE - kZIP_MAGIC_LEN, fArchiveName.Data());
          return -1;
@@ -314,8 +418,7 @@ Int_t TZIPFile::ReadDirectory()
       Long64_t offset  = Get(buf + kDIR_ENTRY_POS_OFF,  kDIR_ENTRY_POS_LEN);
 
       // check value sanity and the variable-length fields
-      if (Get(buf + kDIR_MAGIC_OFF, kZIP_MAGIC_LEN) != kDIR_HEADER_MAGIC ||
-          version > kARCHIVE_VERSION ||
+      if (version > kARCHIVE_VERSION ||
           flags & 8 ||
           (method != kSTORED && method != kDEFLATED) ||
           disk != 0 ||
@@ -327,26 +430,21 @@ Int_t TZIPFile::ReadDirectory()
                fArchiveName.Data());
          return -1;
       }
-
-      char *name    = new char[namelen+1];
-      char *extra   = new char[extlen];
-      char *comment = new char[commlen+1];
-      if (fFile->ReadBuffer(name, namelen) ||
-          fFile->ReadBuffer(extra, extlen) ||
-          fFile->ReadBuffer(comment, commlen)) {
+      buf += kDIR_HEADER_SIZE;
+      if (end - buf < namelen + extlen + commlen + kZIP_MAGIC_LEN) {
          Error("ReadDirectory", "error reading additional directory data from %s",
                fArchiveName.Data());
-         delete [] name;
-         delete [] extra;
-         delete [] comment;
          return -1;
       }
-      name[namelen]    = '\0';
-      comment[commlen] = '\0';
 
       // create a new archive member and store the fields
-      TZIPMember *m = new TZIPMember(name);
+      TZIPMember *m = new TZIPMember(TString(buf, namelen));
       fMembers->Add(m);
+      buf += namelen;
+
+      char *extra = new char[extlen];
+      memcpy(extra, buf, extlen);
+      buf += extlen;
 
       m->fMethod = method;
       m->fLevel  = method == kSTORED ? 0
@@ -360,15 +458,12 @@ Int_t TZIPFile::ReadDirectory()
       m->fCRC32     = crc32;
       m->fModTime.Set(time, kTRUE);   // DOS date/time format
       m->fGlobalLen = extlen;
-      m->fGlobal    = extra;
-      m->fComment   = comment;
+      m->fGlobal    = extra;          // adopted by the TZIPMember
+      m->fComment   = TString(buf, commlen);
       m->fAttrInt   = iattr;
       m->fAttrExt   = xattr;
       m->fPosition  = offset;
-
-      delete [] name;
-      delete [] comment;
-      // extra is adopted be the TZIPMember
+      buf += commlen;
 
       if (DecodeZip64ExtendedExtraField(m) == -1)
          return -1;
@@ -378,12 +473,7 @@ Int_t TZIPFile::ReadDirectory()
               m->GetDecompressedSize(), m->GetCompressedSize(),
               m->GetModTime().AsSQLString(), m->GetName());
 
-      // done, read the next magic
-      if (fFile->ReadBuffer(buf, kZIP_MAGIC_LEN)) {
-         Error("ReadDirectory", "error reading %d directory bytes from %s",
-               kZIP_MAGIC_LEN, fArchiveName.Data());
-         return -1;
-      }
+      // done, decode the next magic
       n = Get(buf, kZIP_MAGIC_LEN);
    }
 
@@ -393,6 +483,7 @@ Int_t TZIPFile::ReadDirectory()
       return -1;
    }
 
+   TZIPDirectoryCache::Instance().Add(key, fMembers);
    return 0;
 }
 
@@ -560,6 +651,545 @@ void TZIPFile::Print(Option_t *) const
       fMembers->Print();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Writer of the archives created by MakeArchive().
+
+struct TZIPFile::TWriter {
+   /// A member of the archive being written.
+   struct TEntry {
+      std::string       fPath;          // file stored in the member
+      TString           fName;          // name of the member
+      Long64_t          fDsize = 0;     // size of the file
+      Long64_t          fCsize = 0;     // size of the member data
+      Long64_t          fPosition = 0;  // position of the local header
+      UInt_t            fTime = 0;      // modification time, in DOS format
+      UInt_t            fCRC32 = 0;     // CRC-32 of the file
+      Int_t             fPadding = 0;   // length of the alignment extra field
+      Bool_t            fDone = kFALSE; // true once processed by a worker
+      TString           fError;         // set by the worker in case of error
+      std::vector<char> fData;          // deflated data of the member
+   };
+
+   static const Int_t  kCHUNK                  = 1 << 20; ///< Size of the reads of the files
+   static const UInt_t kALIGN_EXTRA_MAGIC      = 0xd935;  ///< Alignment extra field (as zipalign)
+   static const Int_t  kALIGN_EXTRA_MIN_SIZE   = 6;       ///< Length of the smallest alignment extra field
+   static const Int_t  kZIP64_LOCAL_EXTRA_SIZE = 20;      ///< Zip64 extra field of the local headers
+   static const Int_t  kZIP64_DIR_EXTRA_SIZE   = 28;      ///< Zip64 extra field of the directory headers
+   static const UInt_t kVERSION_MADE           = (3 << 8) | kARCHIVE_VERSION; ///< Unix, version 4.5
+   static const UInt_t kEXT_ATTR_FILE          = 0100644u << 16;             ///< Regular file, rw-r--r--
+   static const UInt_t kVERSION_DEFLATE        = 20;      ///< Version needed for deflated members
+   static const UInt_t kVERSION_STORE          = 10;      ///< Version needed for stored members
+
+   TString             fArchive;          // name of the archive
+   std::vector<TEntry> fEntries;          // members of the archive
+   Bool_t              fDeflate = kFALSE; // deflate the members, else store them
+   Int_t               fLevel   = Z_DEFAULT_COMPRESSION;
+   Int_t               fAlign   = 4096;   // alignment of the stored data
+   UInt_t              fThreads = 0;      // number of worker threads
+
+   std::mutex              fMutex;         // protects the fields below and fDone
+   std::condition_variable fCondition;
+   size_t                  fNext = 0;      // next entry to be processed
+   size_t                  fNwritten = 0;  // entries written by the main thread
+   Bool_t                  fAbort = kFALSE;
+
+   static void Put(char *buffer, ULong64_t value, Int_t bytes);
+
+   Bool_t IsLocalZip64(const TEntry &e) const { return e.fDsize >= kMAX_SIZE || e.fCsize >= kMAX_SIZE; }
+   Bool_t IsDirZip64(const TEntry &e) const   { return IsLocalZip64(e) || e.fPosition >= kMAX_SIZE; }
+   UInt_t GetVersion(Bool_t zip64) const      { return zip64 ? UInt_t(kARCHIVE_VERSION) : fDeflate ? kVERSION_DEFLATE : kVERSION_STORE; }
+   UInt_t GetFlags() const;
+   Int_t  GetLocalHeaderSize(const TEntry &e) const;
+   Int_t  GetPadding(Long64_t datapos) const;
+
+   Int_t  ParseOption(Option_t *option);
+   Int_t  AddFile(const std::string &path, std::set<TString> &names);
+   void   MakeLocalHeader(const TEntry &e, std::vector<char> &header) const;
+   void   MakeDirHeader(const TEntry &e, std::vector<char> &dir) const;
+   void   MakeEndRecords(std::vector<char> &dir, Long64_t diroff, Long64_t dirsize) const;
+   void   Store(TEntry &e);
+   void   Deflate(TEntry &e);
+   void   Work();
+   Int_t  Write();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write a "bytes" long little-endian integer value to "buffer".
+
+void TZIPFile::TWriter::Put(char *buffer, ULong64_t value, Int_t bytes)
+{
+   for (; bytes; --bytes, ++buffer, value >>= 8)
+      *buffer = char(value & 0xff);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// General purpose flags of the members: the compression level, in the
+/// bits 1 and 2, for deflated members.
+
+UInt_t TZIPFile::TWriter::GetFlags() const
+{
+   if (!fDeflate)
+      return 0;
+   if (fLevel >= 8)
+      return 2;   // maximum
+   if (fLevel == 2)
+      return 4;   // fast
+   if (fLevel == 1)
+      return 6;   // super fast
+   return 0;      // normal
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Length of the local header of the member e, its extra fields included.
+
+Int_t TZIPFile::TWriter::GetLocalHeaderSize(const TEntry &e) const
+{
+   return kENTRY_HEADER_SIZE + e.fName.Length() +
+          (IsLocalZip64(e) ? kZIP64_LOCAL_EXTRA_SIZE : 0) + e.fPadding;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Length of the alignment extra field to add to a local header so that
+/// the data which was to start at datapos starts at a multiple of fAlign.
+/// The field is at least kALIGN_EXTRA_MIN_SIZE bytes long.
+
+Int_t TZIPFile::TWriter::GetPadding(Long64_t datapos) const
+{
+   if (fDeflate || fAlign <= 1)
+      return 0;
+   Int_t padding = (fAlign - datapos % fAlign) % fAlign;
+   while (padding > 0 && padding < kALIGN_EXTRA_MIN_SIZE)
+      padding += fAlign;
+   return padding;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Decode the options of MakeArchive(). Returns -1 in case of error, 0
+/// otherwise.
+
+Int_t TZIPFile::TWriter::ParseOption(Option_t *option)
+{
+   TString opt = option;
+   opt.ToLower();
+   fDeflate = opt.Contains("deflate");
+
+   Ssiz_t pos;
+   if ((pos = opt.Index("level=")) != kNPOS) {
+      fLevel = TString(opt(pos + 6, opt.Length())).Atoi();
+      if (fLevel < 1 || fLevel > 9) {
+         ::Error("TZIPFile::MakeArchive", "compression level must be in [1, 9]");
+         return -1;
+      }
+   }
+   if ((pos = opt.Index("threads=")) != kNPOS) {
+      Int_t threads = TString(opt(pos + 8, opt.Length())).Atoi();
+      if (threads < 1) {
+         ::Error("TZIPFile::MakeArchive", "the number of threads must be positive");
+         return -1;
+      }
+      fThreads = threads;
+   }
+   if ((pos = opt.Index("align=")) != kNPOS) {
+      fAlign = TString(opt(pos + 6, opt.Length())).Atoi();
+      if (fAlign < 1 || fAlign > 32768 || (fAlign & (fAlign - 1))) {
+         ::Error("TZIPFile::MakeArchive", "alignment must be a power of 2 in [1, 32768]");
+         return -1;
+      }
+   }
+   if (!fThreads)
+      fThreads = std::max(1u, std::thread::hardware_concurrency());
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the file path to the members of the archive, named as the file
+/// without its directory. Returns -1 in case of error, 0 otherwise.
+
+Int_t TZIPFile::TWriter::AddFile(const std::string &path, std::set<TString> &names)
+{
+   FileStat_t st;
+   if (gSystem->GetPathInfo(path.c_str(), st) || !R_ISREG(st.fMode)) {
+      ::Error("TZIPFile::MakeArchive", "%s is not a regular file", path.c_str());
+      return -1;
+   }
+
+   TEntry e;
+   e.fPath  = path;
+   e.fName  = gSystem->BaseName(path.c_str());
+   e.fDsize = st.fSize;
+   if (e.fName.Length() > Int_t(kMAX_VAR_LEN) || !names.insert(e.fName).second) {
+      ::Error("TZIPFile::MakeArchive", "member name %s is too long or not unique in %s",
+              e.fName.Data(), fArchive.Data());
+      return -1;
+   }
+
+   TDatime mtime((UInt_t)st.fMtime);
+   e.fTime = mtime.GetYear() < 1980 ? (1 << 21) | (1 << 16) // 1980-01-01
+           : (mtime.GetYear() - 1980) << 25 | mtime.GetMonth() << 21 | mtime.GetDay() << 16 |
+             mtime.GetHour() << 11 | mtime.GetMinute() << 5 | mtime.GetSecond() / 2;
+
+   fEntries.push_back(std::move(e));
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Build the local header of the member e.
+
+void TZIPFile::TWriter::MakeLocalHeader(const TEntry &e, std::vector<char> &header) const
+{
+   const Bool_t zip64  = IsLocalZip64(e);
+   const Int_t  namelen = e.fName.Length();
+   const Int_t  extlen  = (zip64 ? kZIP64_LOCAL_EXTRA_SIZE : 0) + e.fPadding;
+
+   header.assign(kENTRY_HEADER_SIZE + namelen + extlen, 0);
+   char *buf = header.data();
+   Put(buf + kENTRY_MAGIC_OFF,    kENTRY_HEADER_MAGIC,                    kZIP_MAGIC_LEN);
+   Put(buf + kENTRY_VREQD_OFF,    GetVersion(zip64),                      kENTRY_VREQD_LEN);
+   Put(buf + kENTRY_FLAG_OFF,     GetFlags(),                             kENTRY_FLAG_LEN);
+   Put(buf + kENTRY_METHOD_OFF,   fDeflate ? kDEFLATED : kSTORED,         kENTRY_METHOD_LEN);
+   Put(buf + kENTRY_DATE_OFF,     e.fTime,                                kENTRY_DATE_LEN);
+   Put(buf + kENTRY_CRC32_OFF,    e.fCRC32,                               kENTRY_CRC32_LEN);
+   Put(buf + kENTRY_CSIZE_OFF,    zip64 ? Long64_t(kMAX_SIZE) : e.fCsize, kENTRY_CSIZE_LEN);
+   Put(buf + kENTRY_USIZE_OFF,    zip64 ? Long64_t(kMAX_SIZE) : e.fDsize, kENTRY_USIZE_LEN);
+   Put(buf + kENTRY_NAMELEN_OFF,  namelen,                                kENTRY_NAMELEN_LEN);
+   Put(buf + kENTRY_EXTRALEN_OFF, extlen,                                 kENTRY_EXTRALEN_LEN);
+   memcpy(buf + kENTRY_HEADER_SIZE, e.fName.Data(), namelen);
+
+   char *extra = buf + kENTRY_HEADER_SIZE + namelen;
+   if (zip64) {
+      Put(extra + kZIP64_EXTENDED_MAGIC_OFF, kZIP64_EXTENDED_MAGIC,       kZIP64_EXTENDED_MAGIC_LEN);
+      Put(extra + kZIP64_EXTENDED_SIZE_OFF,  kZIP64_LOCAL_EXTRA_SIZE - 4, kZIP64_EXTENDED_SIZE_LEN);
+      Put(extra + kZIP64_EXTENDED_USIZE_OFF, e.fDsize,                    kZIP64_EXTENDED_USIZE_LEN);
+      Put(extra + kZIP64_EXTENTED_CSIZE_OFF, e.fCsize,                    kZIP64_EXTENDED_CSIZE_LEN);
+      extra += kZIP64_LOCAL_EXTRA_SIZE;
+   }
+   if (e.fPadding) {
+      // alignment followed by zeros, as written by zipalign
+      Put(extra,     kALIGN_EXTRA_MAGIC, 2);
+      Put(extra + 2, e.fPadding - 4,     2);
+      Put(extra + 4, fAlign,             2);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Append the central directory header of the member e to dir.
+
+void TZIPFile::TWriter::MakeDirHeader(const TEntry &e, std::vector<char> &dir) const
+{
+   const Bool_t zip64   = IsDirZip64(e);
+   const Int_t  namelen = e.fName.Length();
+   const Int_t  extlen  = zip64 ? kZIP64_DIR_EXTRA_SIZE : 0;
+
+   const size_t off = dir.size();
+   dir.resize(off + kDIR_HEADER_SIZE + namelen + extlen, 0);
+   char *buf = dir.data() + off;
+   Put(buf + kDIR_MAGIC_OFF,     kDIR_HEADER_MAGIC,                         kZIP_MAGIC_LEN);
+   Put(buf + kDIR_VMADE_OFF,     kVERSION_MADE,                             kDIR_VMADE_LEN);
+   Put(buf + kDIR_VREQD_OFF,     GetVersion(zip64),                         kDIR_VREQD_LEN);
+   Put(buf + kDIR_FLAG_OFF,      GetFlags(),                                kDIR_FLAG_LEN);
+   Put(buf + kDIR_METHOD_OFF,    fDeflate ? kDEFLATED : kSTORED,            kDIR_METHOD_LEN);
+   Put(buf + kDIR_DATE_OFF,      e.fTime,                                   kDIR_DATE_LEN);
+   Put(buf + kDIR_CRC32_OFF,     e.fCRC32,                                  kDIR_CRC32_LEN);
+   Put(buf + kDIR_CSIZE_OFF,     zip64 ? Long64_t(kMAX_SIZE) : e.fCsize,    kDIR_CSIZE_LEN);
+   Put(buf + kDIR_USIZE_OFF,     zip64 ? Long64_t(kMAX_SIZE) : e.fDsize,    kDIR_USIZE_LEN);
+   Put(buf + kDIR_NAMELEN_OFF,   namelen,                                   kDIR_NAMELEN_LEN);
+   Put(buf + kDIR_EXTRALEN_OFF,  extlen,                                    kDIR_EXTRALEN_LEN);
+   Put(buf + kDIR_EXT_ATTR_OFF,  kEXT_ATTR_FILE,                            kDIR_EXT_ATTR_LEN);
+   Put(buf + kDIR_ENTRY_POS_OFF, zip64 ? Long64_t(kMAX_SIZE) : e.fPosition, kDIR_ENTRY_POS_LEN);
+   memcpy(buf + kDIR_HEADER_SIZE, e.fName.Data(), namelen);
+
+   if (zip64) {
+      // all the three fields, as expected by DecodeZip64ExtendedExtraField()
+      char *extra = buf + kDIR_HEADER_SIZE + namelen;
+      Put(extra + kZIP64_EXTENDED_MAGIC_OFF,      kZIP64_EXTENDED_MAGIC,     kZIP64_EXTENDED_MAGIC_LEN);
+      Put(extra + kZIP64_EXTENDED_SIZE_OFF,       kZIP64_DIR_EXTRA_SIZE - 4, kZIP64_EXTENDED_SIZE_LEN);
+      Put(extra + kZIP64_EXTENDED_USIZE_OFF,      e.fDsize,                  kZIP64_EXTENDED_USIZE_LEN);
+      Put(extra + kZIP64_EXTENTED_CSIZE_OFF,      e.fCsize,                  kZIP64_EXTENDED_CSIZE_LEN);
+      Put(extra + kZIP64_EXTENDED_HDR_OFFSET_OFF, e.fPosition,               kZIP64_EXTENDED_HDR_OFFSET_LEN);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Append the end of directory records to dir: the Zip64 end record and
+/// locator if needed, then the end header.
+
+void TZIPFile::TWriter::MakeEndRecords(std::vector<char> &dir, Long64_t diroff, Long64_t dirsize) const
+{
+   const Long64_t n = fEntries.size();
+   const Bool_t zip64 = n >= kMAX_VAR_LEN || dirsize >= kMAX_SIZE || diroff >= kMAX_SIZE;
+
+   size_t off = dir.size();
+   if (zip64) {
+      dir.resize(off + kZIP64_EDR_HEADER_SIZE + kZIP64_EDL_HEADER_SIZE, 0);
+      char *buf = dir.data() + off;
+      Put(buf + kZIP64_EDR_MAGIC_OFF,      kZIP64_EDR_HEADER_MAGIC,     kZIP_MAGIC_LEN);
+      Put(buf + kZIP64_EDR_SIZE_OFF,       kZIP64_EDR_HEADER_SIZE - 12, kZIP64_EDR_SIZE_LEN);
+      Put(buf + kZIP64_EDR_VERS_MADE_OFF,  kVERSION_MADE,               kZIP64_EDR_VERS_MADE_LEN);
+      Put(buf + kZIP64_EDR_VERS_EXT_OFF,   kARCHIVE_VERSION,            kZIP64_EDR_VERS_EXT_LEN);
+      Put(buf + kZIP64_EDR_DISK_HDRS_OFF,  n,                           kZIP64_EDR_DISK_HDRS_LEN);
+      Put(buf + kZIP64_EDR_TOTAL_HDRS_OFF, n,                           kZIP64_EDR_TOTAL_HDRS_LEN);
+      Put(buf + kZIP64_EDR_DIR_SIZE_OFF,   dirsize,                     kZIP64_EDR_DIR_SIZE_LEN);
+      Put(buf + kZIP64_EDR_DIR_OFFSET_OFF, diroff,                      kZIP64_EDR_DIR_OFFSET_LEN);
+
+      buf += kZIP64_EDR_HEADER_SIZE;
+      Put(buf + kZIP64_EDL_MAGIC_OFF,      kZIP64_EDL_HEADER_MAGIC, kZIP_MAGIC_LEN);
+      Put(buf + kZIP64_EDL_REC_OFFSET_OFF, diroff + dirsize,        kZIP64_EDL_REC_OFFSET_LEN);
+      Put(buf + kZIP64_EDL_TOTAL_DISK_OFF, 1,                       kZIP64_EDL_TOTAL_DISK_LEN);
+      off = dir.size();
+   }
+
+   dir.resize(off + kEND_HEADER_SIZE, 0);
+   char *buf = dir.data() + off;
+   Put(buf + kEND_MAGIC_OFF,      kEND_HEADER_MAGIC,                     kZIP_MAGIC_LEN);
+   Put(buf + kEND_DISK_HDRS_OFF,  std::min<Long64_t>(n, kMAX_VAR_LEN),   kEND_DISK_HDRS_LEN);
+   Put(buf + kEND_TOTAL_HDRS_OFF, std::min<Long64_t>(n, kMAX_VAR_LEN),   kEND_TOTAL_HDRS_LEN);
+   Put(buf + kEND_DIR_SIZE_OFF,   zip64 ? Long64_t(kMAX_SIZE) : dirsize, kEND_DIR_SIZE_LEN);
+   Put(buf + kEND_DIR_OFFSET_OFF, zip64 ? Long64_t(kMAX_SIZE) : diroff,  kEND_DIR_OFFSET_LEN);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the file of the stored member e to its place in the archive, then
+/// write its local header. Each worker uses its own streams.
+
+void TZIPFile::TWriter::Store(TEntry &e)
+{
+   std::ifstream in(e.fPath.c_str(), std::ios::binary);
+   std::fstream  out(fArchive.Data(), std::ios::binary | std::ios::in | std::ios::out);
+   if (!in || !out) {
+      e.fError.Form("cannot open %s", in ? fArchive.Data() : e.fPath.c_str());
+      return;
+   }
+
+   std::vector<char> buf(kCHUNK);
+   uLong    crc  = crc32(0, Z_NULL, 0);
+   Long64_t left = e.fDsize;
+   out.seekp(e.fPosition + GetLocalHeaderSize(e));
+   while (left > 0 && out) {
+      const Long64_t n = std::min<Long64_t>(left, kCHUNK);
+      if (!in.read(buf.data(), n)) {
+         e.fError.Form("error reading %s, its size changed", e.fPath.c_str());
+         return;
+      }
+      crc = crc32(crc, (const Bytef *)buf.data(), (uInt)n);
+      out.write(buf.data(), n);
+      left -= n;
+   }
+   e.fCRC32 = crc;
+
+   MakeLocalHeader(e, buf);
+   out.seekp(e.fPosition);
+   out.write(buf.data(), buf.size());
+   if (!out.flush())
+      e.fError.Form("error writing %s to %s", e.fPath.c_str(), fArchive.Data());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Deflate in memory the file of the member e.
+
+void TZIPFile::TWriter::Deflate(TEntry &e)
+{
+   std::ifstream in(e.fPath.c_str(), std::ios::binary);
+   if (!in) {
+      e.fError.Form("cannot open %s", e.fPath.c_str());
+      return;
+   }
+
+   z_stream stream;
+   memset(&stream, 0, sizeof(stream));
+   // negative window bits: raw deflate data, without the zlib header
+   if (deflateInit2(&stream, fLevel, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+      e.fError.Form("error in deflateInit2 (zlib) for %s", e.fPath.c_str());
+      return;
+   }
+
+   std::vector<char> buf(kCHUNK);
+   uLong    crc  = crc32(0, Z_NULL, 0);
+   Long64_t left = e.fDsize;
+   Int_t    err  = Z_OK;
+   do {
+      const Long64_t n = std::min<Long64_t>(left, kCHUNK);
+      if (n && !in.read(buf.data(), n)) {
+         e.fError.Form("error reading %s, its size changed", e.fPath.c_str());
+         break;
+      }
+      crc  = crc32(crc, (const Bytef *)buf.data(), (uInt)n);
+      left -= n;
+
+      stream.next_in  = (Bytef *)buf.data();
+      stream.avail_in = (uInt)n;
+      const Int_t flush = left ? Z_NO_FLUSH : Z_FINISH;
+      do {
+         const size_t size = e.fData.size();
+         e.fData.resize(size + kCHUNK / 4);
+         stream.next_out  = (Bytef *)e.fData.data() + size;
+         stream.avail_out = kCHUNK / 4;
+         err = deflate(&stream, flush);
+         e.fData.resize(e.fData.size() - stream.avail_out);
+      } while (err == Z_OK && (stream.avail_in || stream.avail_out == 0 || flush == Z_FINISH));
+      if (err == Z_BUF_ERROR && flush == Z_NO_FLUSH)
+         err = Z_OK;   // no progress possible, all the input was consumed
+   } while (left > 0 && err == Z_OK);
+   deflateEnd(&stream);
+
+   if (err != Z_STREAM_END && e.fError.IsNull())
+      e.fError.Form("error in deflate (zlib) for %s", e.fPath.c_str());
+   e.fCRC32 = crc;
+   e.fCsize = e.fData.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Loop of the worker threads: take the next member and store or deflate
+/// it. When deflating, a worker does not start more than 2 members per
+/// thread ahead of the main thread, which writes them in order, so that
+/// the compressed data kept in memory is bounded.
+
+void TZIPFile::TWriter::Work()
+{
+   while (true) {
+      size_t i;
+      {
+         std::unique_lock<std::mutex> lock(fMutex);
+         fCondition.wait(lock, [this] {
+            return fAbort || fNext >= fEntries.size() || !fDeflate || fNext < fNwritten + 2 * fThreads;
+         });
+         if (fAbort || fNext >= fEntries.size())
+            return;
+         i = fNext++;
+      }
+
+      TEntry &e = fEntries[i];
+      if (fDeflate)
+         Deflate(e);
+      else
+         Store(e);
+
+      std::lock_guard<std::mutex> lock(fMutex);
+      e.fDone = kTRUE;
+      fCondition.notify_all();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the archive with fThreads workers. Returns -1 in case of error, 0
+/// otherwise.
+
+Int_t TZIPFile::TWriter::Write()
+{
+   // lay out the stored members, whose sizes are known
+   Long64_t pos = 0;
+   if (!fDeflate) {
+      for (TEntry &e : fEntries) {
+         e.fCsize    = e.fDsize;
+         e.fPosition = pos;
+         e.fPadding  = 0;
+         e.fPadding  = GetPadding(pos + GetLocalHeaderSize(e));
+         pos += GetLocalHeaderSize(e) + e.fCsize;
+      }
+   }
+
+   std::ofstream out(fArchive.Data(), std::ios::binary | std::ios::trunc);
+   if (!out) {
+      ::Error("TZIPFile::MakeArchive", "cannot create %s", fArchive.Data());
+      return -1;
+   }
+
+   std::vector<std::thread> workers;
+   const UInt_t nworkers = std::min<size_t>(fThreads, fEntries.size());
+   for (UInt_t i = 0; i < nworkers; ++i)
+      workers.emplace_back(&TWriter::Work, this);
+
+   // write the deflated members in order, as they are ready
+   Int_t status = 0;
+   std::vector<char> header;
+   for (TEntry &e : fEntries) {
+      {
+         std::unique_lock<std::mutex> lock(fMutex);
+         fCondition.wait(lock, [&e] { return e.fDone; });
+      }
+      if (!e.fError.IsNull()) {
+         ::Error("TZIPFile::MakeArchive", "%s", e.fError.Data());
+         status = -1;
+         break;
+      }
+      if (fDeflate) {
+         e.fPosition = pos;
+         MakeLocalHeader(e, header);
+         out.write(header.data(), header.size());
+         out.write(e.fData.data(), e.fData.size());
+         pos += header.size() + e.fData.size();
+         std::vector<char>().swap(e.fData);
+      }
+      std::lock_guard<std::mutex> lock(fMutex);
+      ++fNwritten;
+      fCondition.notify_all();
+   }
+
+   {
+      std::lock_guard<std::mutex> lock(fMutex);
+      fAbort = status != 0;
+      fCondition.notify_all();
+   }
+   for (std::thread &worker : workers)
+      worker.join();
+   if (status)
+      return status;
+
+   // the directory follows the last member
+   std::vector<char> dir;
+   for (const TEntry &e : fEntries)
+      MakeDirHeader(e, dir);
+   MakeEndRecords(dir, pos, dir.size());
+
+   out.seekp(pos);
+   out.write(dir.data(), dir.size());
+   if (!out.flush()) {
+      ::Error("TZIPFile::MakeArchive", "error writing %s", fArchive.Data());
+      return -1;
+   }
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the ZIP archive "archive" containing the files "files", each
+/// stored in a member named as the file without its directory. The members
+/// are written in parallel, by several threads. Returns -1 in case of
+/// error, 0 otherwise. The options are:
+///
+///  - "deflate": deflate the members instead of storing them. ROOT files
+///    are already compressed and TArchiveFile can only read the stored
+///    members, so they are stored by default.
+///  - "level=N": deflate the members with the zlib level N, in [1, 9].
+///  - "threads=N": use N threads, by default as many as hardware threads.
+///  - "align=N": align the data of the stored members on N bytes, by
+///    default 4096 (the size of a page): a member can then be mapped in
+///    memory in place. N must be a power of 2, 1 to disable the alignment.
+///
+/// The stored members, whose sizes are known beforehand, are copied by the
+/// threads to their place in the archive, each with its own streams. The
+/// deflated members are compressed in memory by the threads and written in
+/// order by the calling thread. The Zip64 extensions are used for the
+/// members and archives which need them, larger than 4 GB or with more than
+/// 65535 members. For example:
+/// ~~~{.cpp}
+///    TZIPFile::MakeArchive("multi.zip", {"file1.root", "file2.root"});
+///    TFile *f = TFile::Open("multi.zip#file2.root");
+/// ~~~
+
+Int_t TZIPFile::MakeArchive(const char *archive, const std::vector<std::string> &files, Option_t *option)
+{
+   TWriter writer;
+   writer.fArchive = archive;
+   if (writer.ParseOption(option) == -1)
+      return -1;
+
+   std::set<TString> names;
+   for (const std::string &file : files)
+      if (writer.AddFile(file, names) == -1)
+         return -1;
+
+   return writer.Write();
+}
+
 
 ClassImp(TZIPMember)
 
@@ -77,6 +77,7 @@ protected:
    // generic sql functions
    TSQLResult*       SQLQuery(const char* cmd, Int_t flag = 0, Bool_t* res = 0);
    Bool_t            SQLCanStatement();
+   Bool_t            SQLCanMultiRowInsert() const;
    TSQLStatement*    SQLStatement(const char* cmd, Int_t bufsize = 1000);
    void              SQLDeleteStatement(TSQLStatement* stmt);
    Bool_t            SQLApplyCommands(TObjArray* cmds);
@@ -169,6 +170,7 @@ protected:
 
    Bool_t            fIdsTableExists;  ///<! indicate if IdsTable exists
    Int_t             fStmtCounter;     ///<! count numbers of active statements
+   Int_t             fInsertBatchSize; ///<! maximum number of rows in one INSERT query or in one statement buffer
 
 private:
    //let the compiler do the job. gcc complains when the following line is activated
@@ -206,6 +208,8 @@ public:
    void              SetUseIndexes(Int_t use_type = kIndexesBasic);
    Int_t             GetUseIndexes() const { return fUseIndexes; }
    Int_t             GetQuerisCounter() const { return fQuerisCounter; }
+   void              SetInsertBatchSize(Int_t rows = 1000);
+   Int_t             GetInsertBatchSize() const { return fInsertBatchSize; }
 
    TString           MakeSelectQuery(TClass* cl);
    Bool_t            StartTransaction();
@@ -293,7 +293,8 @@ TSQLFile::TSQLFile() :
    fUserName(),
    fLogFile(0),
    fIdsTableExists(kFALSE),
-   fStmtCounter(0)
+   fStmtCounter(0),
+   fInsertBatchSize(1000)
 {
    SetBit(kBinaryFile, kFALSE);
 }
@@ -332,7 +333,8 @@ TSQLFile::TSQLFile(const char* dbname, Option_t* option, const char* user, const
    fUserName(user),
    fLogFile(0),
    fIdsTableExists(kFALSE),
-   fStmtCounter(0)
+   fStmtCounter(0),
+   fInsertBatchSize(1000)
 {
    if (!gROOT)
       ::Fatal("TFile::TFile", "ROOT system not initialized");
@@ -576,6 +578,20 @@ void TSQLFile::SetUseTransactions(Int_t mode)
    fUseTransactions = mode;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Defines maximum number of rows, written to a table with one SQL command.
+///
+/// For MySQL, PostgreSQL and SQLite several rows are inserted with one
+/// INSERT query, for Oracle and ODBC the values of several rows are bound
+/// as arrays to one prepared statement and sent together. The length of
+/// INSERT queries is also limited to about 50 KB. Default value is 1000,
+/// 1 means one command per row.
+
+void TSQLFile::SetInsertBatchSize(Int_t rows)
+{
+   fInsertBatchSize = rows < 1 ? 1 : rows;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Start user transaction.
 ///
@@ -1461,6 +1477,18 @@ Bool_t TSQLFile::SQLCanStatement()
    return kTRUE; // !IsOracle() || (fStmtCounter<15);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Test if DB support INSERT queries with values of several rows
+
+Bool_t TSQLFile::SQLCanMultiRowInsert() const
+{
+   if (fSQL==0) return kFALSE;
+
+   return IsMySQL() ||
+          (strcmp(fSQL->ClassName(),"TPgSQLServer")==0) ||
+          (strcmp(fSQL->ClassName(),"TSQLiteServer")==0);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Produces SQL statement for currently conected DB server
 
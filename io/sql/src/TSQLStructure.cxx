@@ -948,14 +948,16 @@ public:
    void ConvertSqlValues(TObjArray& values, const char* tablename)
    {
    // this function transforms array of values for one table
-   // to SQL command. For MySQL one INSERT querie can
-   // contain data for more than one row
+   // to SQL command. For MySQL, PostgreSQL and SQLite one INSERT
+   // querie can contain data for more than one row,
+   // up to TSQLFile::GetInsertBatchSize() rows
 
       if ((values.GetLast()<0) || (tablename==0)) return;
 
-      Bool_t canbelong = fFile->IsMySQL();
+      Bool_t canbelong = fFile->SQLCanMultiRowInsert();
+      Int_t maxrows = canbelong ? fFile->GetInsertBatchSize() : 1;
 
-      Int_t maxsize = 50000;
+      Int_t maxsize = 50000, nrows = 0;
       TString sqlcmd(maxsize), value, onecmd, cmdmask;
 
       const char* quote = fFile->SQLIdentifierQuote();
@@ -973,9 +975,10 @@ public:
             sqlcmd+=")";
          }
 
-         if (!canbelong || (sqlcmd.Length()>maxsize*0.9)) {
+         if ((++nrows >= maxrows) || (sqlcmd.Length()>maxsize*0.9)) {
             AddSqlCmd(sqlcmd.Data());
             sqlcmd = "";
+            nrows = 0;
          }
       }
 
@@ -1021,7 +1024,7 @@ public:
             const char* pars = fFile->IsOracle() ? ":1, :2, :3, :4" : "?, ?, ?, ?";
             sqlcmd.Form("INSERT INTO %s%s%s VALUES (%s)",
                      quote, sqlio::ObjectsTable, quote, pars);
-            fRegStmt = fFile->SQLStatement(sqlcmd.Data(), 1000);
+            fRegStmt = fFile->SQLStatement(sqlcmd.Data(), fFile->GetInsertBatchSize());
          }
 
          if (fRegStmt!=0) {
@@ -1086,7 +1089,7 @@ public:
          }
          sqlcmd += ")";
 
-         stmt = fFile->SQLStatement(sqlcmd.Data(), 1000);
+         stmt = fFile->SQLStatement(sqlcmd.Data(), fFile->GetInsertBatchSize());
          if (stmt==0) return kFALSE;
          buf->fNormStmt = stmt;
       }
@@ -1196,7 +1199,7 @@ public:
             const char* params = fFile->IsOracle() ? ":1, :2, :3, :4" : "?, ?, ?, ?";
             sqlcmd.Form("INSERT INTO %s%s%s VALUES (%s)",
                         quote, fInfo->GetRawTableName(), quote, params);
-            TSQLStatement* stmt = fFile->SQLStatement(sqlcmd.Data(), 2000);
+            TSQLStatement* stmt = fFile->SQLStatement(sqlcmd.Data(), 2*fFile->GetInsertBatchSize());
             fCmdBuf->fBlobStmt = stmt;
          }
       }
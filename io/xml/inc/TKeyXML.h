@@ -62,6 +62,9 @@ public:
 
    XMLNodePointer_t  KeyNode() const { return fKeyNode; }
    Long64_t          GetKeyId() const { return fKeyId; }
+   Long64_t          GetKeyPos() const { return fKeyPos; }
+   void              SetKeyPos(Long64_t pos) { fKeyPos = pos; }
+   Bool_t            LoadKeyNode(Bool_t keep = kFALSE);
    Bool_t            IsSubdir() const { return fSubdir; }
    void              SetSubir() { fSubdir = kTRUE; }
    void              UpdateObject(TObject* obj);
@@ -78,6 +81,7 @@ protected:
    XMLNodePointer_t  fKeyNode;  //! node with stored object
    Long64_t          fKeyId;    //! unique identifier of key for search methods
    Bool_t            fSubdir;   //! indicates that key contains subdirectory
+   Long64_t          fKeyPos;   //! position of key node in the file, when its content is read on demand, -1 otherwise
 
    ClassDef(TKeyXML,1) // a special TKey for XML files
 };
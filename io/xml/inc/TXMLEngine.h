@@ -20,6 +20,7 @@ typedef void* XMLNodePointer_t;
 typedef void* XMLNsPointer_t;
 typedef void* XMLAttrPointer_t;
 typedef void* XMLDocPointer_t;
+typedef void* XMLReaderPointer_t;
 
 class TXMLInputStream;
 class TXMLOutputStream;
@@ -37,13 +38,21 @@ protected:
    void              UnpackSpecialCharacters(char* target, const char* source, int srclen);
    void              OutputValue(char* value, TXMLOutputStream* out);
    void              SaveNode(XMLNodePointer_t xmlnode, TXMLOutputStream* out, Int_t layout, Int_t level);
-   XMLNodePointer_t  ReadNode(XMLNodePointer_t xmlparent, TXMLInputStream* inp, Int_t& resvalue);
+   XMLNodePointer_t  ReadNode(XMLNodePointer_t xmlparent, TXMLInputStream* inp, Int_t& resvalue, Bool_t recursive = kTRUE);
    void              DisplayError(Int_t error, Int_t linenumber);
    XMLDocPointer_t   ParseStream(TXMLInputStream* input);
 
    Bool_t            fSkipComments;    //! if true, do not create comments nodes in document during parsing
 
 public:
+   enum EReaderToken {
+      kReaderError     = -1,   // error in the document
+      kReaderEndOfDoc  = 0,    // end of the document
+      kReaderStartNode = 1,    // start of a node, its attributes are available
+      kReaderEndNode   = 2,    // end of the last started node
+      kReaderOther     = 3     // content, comment or processing instruction
+   };
+
    TXMLEngine();
    virtual ~TXMLEngine();
 
@@ -118,6 +127,15 @@ public:
    void              SaveSingleNode(XMLNodePointer_t xmlnode, TString* res, Int_t layout = 1);
    XMLNodePointer_t  ReadSingleNode(const char* src);
 
+   XMLReaderPointer_t OpenReader(const char* filename, Long64_t pos = 0, Int_t maxbuf = 100000);
+   void              CloseReader(XMLReaderPointer_t reader);
+   Int_t             ReaderNext(XMLReaderPointer_t reader);
+   XMLNodePointer_t  ReaderGetNode(XMLReaderPointer_t reader);
+   Int_t             ReaderGetDepth(XMLReaderPointer_t reader);
+   Long64_t          ReaderGetPosition(XMLReaderPointer_t reader);
+   XMLNodePointer_t  ReaderReadSubtree(XMLReaderPointer_t reader);
+   Bool_t            ReaderSkipSubtree(XMLReaderPointer_t reader);
+
    ClassDef(TXMLEngine,1);   // ROOT XML I/O parser, user by TXMLFile to read/write xml files
 };
 
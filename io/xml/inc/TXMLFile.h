@@ -120,6 +120,7 @@ public:
    Bool_t            AddXmlLine(const char* line);
 
    TXMLEngine*       XML() { return fXML; }
+   XMLNodePointer_t  ReadKeyNode(Long64_t pos);
 
 protected:
    // functions to store streamer infos
@@ -128,6 +129,9 @@ protected:
    void              ReadStreamerElement(XMLNodePointer_t node, TStreamerInfo* info);
 
    Bool_t            ReadFromFile();
+   Bool_t            ReadFromFileLazy();
+   void              ReadRootAttributes(XMLNodePointer_t rootnode);
+   XMLNodePointer_t  CopyNodeHeader(XMLNodePointer_t node, XMLNodePointer_t parent);
    Int_t             ReadKeysList(TDirectory* dir, XMLNodePointer_t topnode);
    TKeyXML*          FindDirKey(TDirectory* dir);
    TDirectory*       FindKeyDir(TDirectory* mother, Long64_t keyid);
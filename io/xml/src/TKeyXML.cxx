@@ -34,7 +34,8 @@ TKeyXML::TKeyXML() :
    TKey(),
    fKeyNode(0),
    fKeyId(0),
-   fSubdir(kFALSE)
+   fSubdir(kFALSE),
+   fKeyPos(-1)
 {
 }
 
@@ -45,7 +46,8 @@ TKeyXML::TKeyXML(TDirectory* mother, Long64_t keyid, const TObject* obj, const c
     TKey(mother),
     fKeyNode(0),
     fKeyId(keyid),
-    fSubdir(kFALSE)
+    fSubdir(kFALSE),
+    fKeyPos(-1)
 {
    if (name)
       SetName(name);
@@ -76,7 +78,8 @@ TKeyXML::TKeyXML(TDirectory* mother, Long64_t keyid, const void* obj, const TCla
    TKey(mother),
    fKeyNode(0),
    fKeyId(keyid),
-   fSubdir(kFALSE)
+   fSubdir(kFALSE),
+   fKeyPos(-1)
 {
    if (name && *name) SetName(name);
    else SetName(cl ? cl->GetName() : "Noname");
@@ -101,7 +104,8 @@ TKeyXML::TKeyXML(TDirectory* mother, Long64_t keyid, XMLNodePointer_t keynode) :
    TKey(mother),
    fKeyNode(keynode),
    fKeyId(keyid),
-   fSubdir(kFALSE)
+   fSubdir(kFALSE),
+   fKeyPos(-1)
 {
    TXMLEngine* xml = XMLEngine();
 
@@ -329,6 +333,8 @@ void* TKeyXML::XmlReadAny(void* obj, const TClass* expectedClass)
    TXMLEngine* xml = XMLEngine();
    if ((f==0) || (xml==0)) return obj;
 
+   if (!LoadKeyNode()) return obj;
+
    TBufferXML buffer(TBuffer::kRead, f);
    if (f->GetIOVersion()==1)
       buffer.SetBit(TBuffer::kCannotHandleMemberWiseStreaming, kFALSE);
@@ -347,6 +353,15 @@ void* TKeyXML::XmlReadAny(void* obj, const TClass* expectedClass)
    TClass* cl = 0;
    void* res = buffer.XmlReadAny(objnode, obj, &cl);
 
+   // content of key read on demand is released again, except for
+   // subdirectory, which keys will be taken from it
+   if (fKeyPos >= 0) {
+      if (cl && cl->InheritsFrom(TDirectory::Class()))
+         fKeyPos = -1;
+      else
+         xml->CleanNode(fKeyNode);
+   }
+
    if ((cl==0) || (res==0)) return obj;
 
    Int_t delta = 0;
@@ -368,6 +383,31 @@ void* TKeyXML::XmlReadAny(void* obj, const TClass* expectedClass)
    return ((char*)res) + delta;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Reads complete key node from the file, if only its attributes were read
+/// when file was opened with option lazy=1 (see TXMLFile constructor).
+/// If keep is true, the node is not released after the object is read.
+
+Bool_t TKeyXML::LoadKeyNode(Bool_t keep)
+{
+   if (fKeyPos < 0) return kTRUE;
+
+   TXMLFile* f = (TXMLFile*) GetFile();
+   TXMLEngine* xml = XMLEngine();
+   if ((f==0) || (xml==0)) return kFALSE;
+
+   if (xml->GetChild(fKeyNode)==0) {
+      XMLNodePointer_t keynode = f->ReadKeyNode(fKeyPos);
+      if (keynode==0) return kFALSE;
+      xml->FreeNode(fKeyNode);
+      fKeyNode = keynode;
+   }
+
+   if (keep) fKeyPos = -1;
+
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// return pointer on TXMLEngine object, used for xml conversion
 
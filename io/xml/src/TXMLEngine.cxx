@@ -27,6 +27,7 @@
 #include "TObjArray.h"
 #include <stdlib.h>
 #include <string.h>
+#include <vector>
 
 ClassImp(TXMLEngine);
 
@@ -64,6 +65,19 @@ struct SXmlDoc_t {
    char        *fDtdRoot;
 };
 
+class TXMLInputStream;
+
+struct SXmlReader_t {
+   TXMLInputStream *fInp;        // input stream
+   XMLDocPointer_t  fDoc;        // document, its root node is the parent of the top-level nodes
+   std::vector<XMLNodePointer_t> fStack;  // nodes started and not yet ended, first is root node of fDoc
+   XMLNodePointer_t fCurrent;    // node of the last token
+   Long64_t         fPos;        // position in the file of the last started node
+   Int_t            fDepth;      // depth of the node of the last token
+   Int_t            fToken;      // last token
+   Bool_t           fPendingEnd; // last started node was like <node/>, next token is its end
+};
+
 class TXMLOutputStream {
 protected:
 
@@ -173,7 +187,7 @@ protected:
    char          *fMaxAddr;
    char          *fLimitAddr;
 
-   Int_t          fTotalPos;
+   Long64_t       fTotalPos;
    Int_t          fCurrentLine;
 
    TObjArray      fEntities;   //! array of TXMLEntity
@@ -182,7 +196,7 @@ public:
 
    char           *fCurrent;
 
-   TXMLInputStream(Bool_t isfilename, const char* filename, Int_t ibufsize) :
+   TXMLInputStream(Bool_t isfilename, const char* filename, Int_t ibufsize, Long64_t pos = 0) :
       fInp(0),
       fInpStr(0),
       fInpStrLen(0),
@@ -197,6 +211,7 @@ public:
    {
       if (isfilename) {
          fInp = new std::ifstream(filename);
+         if (pos > 0) fInp->seekg(pos);
          fInpStr = 0;
          fInpStrLen = 0;
       } else {
@@ -216,7 +231,7 @@ public:
       fMaxAddr = fBuf+len;
       fLimitAddr = fBuf + int(len*0.75);
 
-      fTotalPos = 0;
+      fTotalPos = pos > 0 ? pos : 0;
       fCurrentLine = 1;
 
       fEntities.SetOwner(kTRUE);
@@ -297,7 +312,7 @@ public:
       return kTRUE;
    }
 
-   Int_t  TotalPos() { return fTotalPos; }
+   Long64_t TotalPos() { return fTotalPos; }
 
    Int_t CurrentLine() { return fCurrentLine; }
 
@@ -1247,6 +1262,239 @@ XMLDocPointer_t TXMLEngine::ParseStream(TXMLInputStream* inp)
    return xmldoc;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Opens file for reading node after node, without building the complete
+/// document in memory. Returns 0 if file name is not specified.
+/// If pos is specified, reading starts at this position of the file, which
+/// should be value of ReaderGetPosition() for a node read before.
+///
+/// Nodes are provided by ReaderNext(), which returns the type of the next token.
+/// Only nodes which are started and not yet ended and node of the last token
+/// are kept in memory, therefore required memory is bounded by nesting depth
+/// of the document. Users are free to build complete subtree of the node
+/// with ReaderReadSubtree() or to skip it with ReaderSkipSubtree().
+/// Typical use is:
+/// ~~~{.cpp}
+///    TXMLEngine xml;
+///    XMLReaderPointer_t reader = xml.OpenReader("file.xml");
+///    Int_t token;
+///    while ((token = xml.ReaderNext(reader)) > 0) {
+///       if ((token == TXMLEngine::kReaderStartNode) && (xml.ReaderGetDepth(reader) == 1)) {
+///          XMLNodePointer_t node = xml.ReaderReadSubtree(reader);
+///          // ... use node and its children
+///          xml.FreeNode(node);
+///       }
+///    }
+///    xml.CloseReader(reader);
+/// ~~~
+
+XMLReaderPointer_t TXMLEngine::OpenReader(const char* filename, Long64_t pos, Int_t maxbuf)
+{
+   if ((filename==0) || (strlen(filename)==0)) return 0;
+   if (maxbuf < 100000) maxbuf = 100000;
+
+   SXmlReader_t* reader = new SXmlReader_t;
+   reader->fInp = new TXMLInputStream(true, filename, maxbuf, pos);
+   reader->fDoc = NewDoc(0);
+   reader->fStack.push_back((XMLNodePointer_t) ((SXmlDoc_t*) reader->fDoc)->fRootNode);
+   reader->fCurrent = 0;
+   reader->fPos = pos;
+   reader->fDepth = 0;
+   reader->fToken = kReaderOther;
+   reader->fPendingEnd = kFALSE;
+   return (XMLReaderPointer_t) reader;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// closes reader, created with OpenReader() and releases all its nodes.
+/// Subtrees returned by ReaderReadSubtree() should be released by user.
+
+void TXMLEngine::CloseReader(XMLReaderPointer_t xmlreader)
+{
+   SXmlReader_t* reader = (SXmlReader_t*) xmlreader;
+   if (reader==0) return;
+   delete reader->fInp;
+   FreeDoc(reader->fDoc);
+   delete reader;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// reads next token from the reader, returns:
+///  - kReaderStartNode - start of node, its name and attributes are available
+///  - kReaderEndNode   - end of last started node; node like <node/> produces
+///                       both kReaderStartNode and kReaderEndNode tokens
+///  - kReaderOther     - content, comment or processing instruction node.
+///                       Nodes included from external entities are provided
+///                       as complete subtrees with this token
+///  - kReaderEndOfDoc  - end of document is reached
+///  - kReaderError     - error in the document, reader cannot be used any more
+/// Node of the token is returned by ReaderGetNode(). It belongs to the
+/// reader and is valid until next call of ReaderNext(), except started
+/// nodes, which are valid until their end.
+
+Int_t TXMLEngine::ReaderNext(XMLReaderPointer_t xmlreader)
+{
+   SXmlReader_t* reader = (SXmlReader_t*) xmlreader;
+   if (reader==0) return kReaderError;
+   if ((reader->fToken == kReaderError) || (reader->fToken == kReaderEndOfDoc)) return reader->fToken;
+
+   if (reader->fPendingEnd) {
+      reader->fPendingEnd = kFALSE;
+      reader->fStack.pop_back();
+      reader->fDepth = reader->fStack.size() - 1;
+      return reader->fToken = kReaderEndNode;
+   }
+
+   // next node, included from external entity together with previous one
+   if ((reader->fToken == kReaderOther) && (reader->fCurrent!=0) && (((SXmlNode_t*) reader->fCurrent)->fNext!=0)) {
+      reader->fCurrent = (XMLNodePointer_t) ((SXmlNode_t*) reader->fCurrent)->fNext;
+      return reader->fToken;
+   }
+
+   TXMLInputStream* inp = reader->fInp;
+   XMLNodePointer_t parent = reader->fStack.back();
+
+   // nodes of previous tokens on this level are not required any more
+   CleanNode(parent);
+   reader->fCurrent = 0;
+
+   while (true) {
+      if (reader->fStack.size() == 1) {
+         // coverity[unchecked_value] result of SkipSpaces() doesn't matter, see ParseStream()
+         if (!inp->EndOfStream()) inp->SkipSpaces();
+         if (inp->EndOfStream()) return reader->fToken = kReaderEndOfDoc;
+      } else {
+         inp->SkipSpaces();
+      }
+
+      Long64_t pos = inp->TotalPos();
+      Int_t resvalue = 0;
+      XMLNodePointer_t node = ReadNode(parent, inp, resvalue, kFALSE);
+
+      if ((resvalue == 1) && (reader->fStack.size() > 1)) {
+         reader->fCurrent = parent;
+         reader->fStack.pop_back();
+         reader->fDepth = reader->fStack.size() - 1;
+         return reader->fToken = kReaderEndNode;
+      }
+
+      if (resvalue == 3) {
+         reader->fCurrent = node;
+         reader->fPos = pos;
+         reader->fDepth = reader->fStack.size() - 1;
+         reader->fStack.push_back(node);
+         return reader->fToken = kReaderStartNode;
+      }
+
+      if (resvalue != 2) {
+         DisplayError(resvalue, inp->CurrentLine());
+         return reader->fToken = kReaderError;
+      }
+
+      // content with entities is added directly to the parent
+      if (node==0) node = GetChild(parent, kFALSE);
+      // skipped comment or DTD
+      if (node==0) continue;
+
+      reader->fCurrent = node;
+      reader->fDepth = reader->fStack.size() - 1;
+
+      SXmlNode_t* snode = (SXmlNode_t*) node;
+      if ((snode->fType == kXML_NODE) && (snode->fChild == 0) && (snode->fNext == 0)) {
+         reader->fPos = pos;
+         reader->fStack.push_back(node);
+         reader->fPendingEnd = kTRUE;
+         return reader->fToken = kReaderStartNode;
+      }
+
+      return reader->fToken = kReaderOther;
+   }
+
+   return kReaderError;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// returns node of the last token of the reader
+
+XMLNodePointer_t TXMLEngine::ReaderGetNode(XMLReaderPointer_t xmlreader)
+{
+   SXmlReader_t* reader = (SXmlReader_t*) xmlreader;
+   return reader==0 ? 0 : reader->fCurrent;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// returns depth of the node of the last token, 0 for top-level nodes of the document
+
+Int_t TXMLEngine::ReaderGetDepth(XMLReaderPointer_t xmlreader)
+{
+   SXmlReader_t* reader = (SXmlReader_t*) xmlreader;
+   return reader==0 ? -1 : reader->fDepth;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// returns position in the file of the last started node.
+/// This value can be used to start new reader directly from this node
+
+Long64_t TXMLEngine::ReaderGetPosition(XMLReaderPointer_t xmlreader)
+{
+   SXmlReader_t* reader = (SXmlReader_t*) xmlreader;
+   return reader==0 ? -1 : reader->fPos;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// reads all children of the node, started with the last kReaderStartNode token.
+/// Returns complete node, which should be released by user with FreeNode().
+/// Next call of ReaderNext() continues after the end of this node.
+
+XMLNodePointer_t TXMLEngine::ReaderReadSubtree(XMLReaderPointer_t xmlreader)
+{
+   SXmlReader_t* reader = (SXmlReader_t*) xmlreader;
+   if ((reader==0) || (reader->fToken != kReaderStartNode)) return 0;
+
+   XMLNodePointer_t node = reader->fStack.back();
+
+   if (!reader->fPendingEnd) {
+      Int_t resvalue = 0;
+      do {
+         ReadNode(node, reader->fInp, resvalue);
+      } while (resvalue==2);
+
+      if (resvalue != 1) {
+         DisplayError(resvalue, reader->fInp->CurrentLine());
+         reader->fToken = kReaderError;
+         return 0;
+      }
+   }
+
+   reader->fPendingEnd = kFALSE;
+   reader->fStack.pop_back();
+   UnlinkNode(node);
+   reader->fCurrent = 0;
+   reader->fToken = kReaderEndNode;
+   return node;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// skips all children of the node, started with the last kReaderStartNode token.
+/// Contrary to ReaderReadSubtree(), nodes are not kept in memory.
+/// Returns kTRUE when the end of node is reached.
+
+Bool_t TXMLEngine::ReaderSkipSubtree(XMLReaderPointer_t xmlreader)
+{
+   SXmlReader_t* reader = (SXmlReader_t*) xmlreader;
+   if ((reader==0) || (reader->fToken != kReaderStartNode)) return kFALSE;
+
+   size_t depth = reader->fStack.size();
+
+   while (true) {
+      Int_t token = ReaderNext(xmlreader);
+      if ((token == kReaderEndNode) && (reader->fStack.size() < depth)) return kTRUE;
+      if (token <= kReaderEndOfDoc) return kFALSE;
+   }
+
+   return kFALSE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// check that first node is xml processing instruction with correct xml version number
 
@@ -1563,8 +1811,10 @@ void TXMLEngine::SaveNode(XMLNodePointer_t xmlnode, TXMLOutputStream* out, Int_t
 /// resvalue <= 0 if error
 /// resvalue == 1 if this is endnode of parent
 /// resvalue == 2 if this is child
+/// resvalue == 3 if this is start of child node, which children are not read
+/// (only when recursive is false)
 
-XMLNodePointer_t TXMLEngine::ReadNode(XMLNodePointer_t xmlparent, TXMLInputStream* inp, Int_t& resvalue)
+XMLNodePointer_t TXMLEngine::ReadNode(XMLNodePointer_t xmlparent, TXMLInputStream* inp, Int_t& resvalue, Bool_t recursive)
 {
    resvalue = 0;
 
@@ -1840,6 +2090,11 @@ XMLNodePointer_t TXMLEngine::ReadNode(XMLNodePointer_t xmlparent, TXMLInputStrea
 
          if (!inp->ShiftCurrent()) return 0;
 
+         if (!recursive) {
+            resvalue = 3;
+            return node;
+         }
+
          do {
             ReadNode(node, inp, resvalue);
          } while (resvalue==2);
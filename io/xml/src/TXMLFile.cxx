@@ -75,6 +75,7 @@
 
 #include "TROOT.h"
 #include "TSystem.h"
+#include "TEnv.h"
 #include "TList.h"
 #include "TBrowser.h"
 #include "TObjArray.h"
@@ -126,6 +127,16 @@ TXMLFile::TXMLFile() :
 ///
 /// For more details see comments for TFile::TFile() constructor
 ///
+/// A file opened for reading with the option lazy=1, like
+///
+///     file.xml?lazy=1
+///
+/// (or with "TFile.LazyInit: 1" in the system.rootrc file) is not loaded
+/// completely in memory. Only the attributes of the keys and the streamer
+/// infos are read when the file is opened, the content of a key is read
+/// from the file each time its object is read and released afterwards.
+/// The memory used is then bounded by the largest object of the file.
+///
 /// For a moment TXMLFile does not support TTree objects and subdirectories
 
 TXMLFile::TXMLFile(const char* filename, Option_t* option, const char* title, Int_t compression) :
@@ -144,6 +155,14 @@ TXMLFile::TXMLFile(const char* filename, Option_t* option, const char* title, In
    if (filename && !strncmp(filename, "xml:", 4))
       filename += 4;
 
+   TString fileopts, fullname = filename;
+   Ssiz_t optpos = fullname.Index("?");
+   if (optpos != kNPOS) {
+      fileopts = fullname(optpos+1, fullname.Length());
+      fullname.Remove(optpos);
+      filename = fullname.Data();
+   }
+
    gDirectory = 0;
    SetName(filename);
    SetTitle(title);
@@ -255,6 +274,9 @@ TXMLFile::TXMLFile(const char* filename, Option_t* option, const char* title, In
 
    fRealName = fname;
 
+   fLazyInit = read && ((fileopts.Index("lazy=1") != kNPOS) ||
+                        gEnv->GetValue("TFile.LazyInit", 0) == 1);
+
    if (create || update)
       SetWritable(kTRUE);
    else
@@ -424,6 +446,17 @@ Int_t TXMLFile::ReOpen(Option_t* mode)
    } else {
       fOption = opt;
 
+      // the keys read on demand are completed before they can be written
+      if (fLazyInit) {
+         TIter iter(GetListOfKeys());
+         TObject* obj = 0;
+         while ((obj = iter())!=0) {
+            TKeyXML* key = dynamic_cast<TKeyXML*> (obj);
+            if (key!=0) key->LoadKeyNode(kTRUE);
+         }
+         fLazyInit = kFALSE;
+      }
+
       SetWritable(kTRUE);
    }
 
@@ -576,6 +609,8 @@ void TXMLFile::CombineNodesTree(TDirectory* dir, XMLNodePointer_t topnode, Bool_
 
 Bool_t TXMLFile::ReadFromFile()
 {
+   if (fLazyInit) return ReadFromFileLazy();
+
    fDoc = fXML->ParseFile(fRealName);
    if (fDoc==0) return kFALSE;
 
@@ -587,33 +622,7 @@ Bool_t TXMLFile::ReadFromFile()
       return kFALSE;
    }
 
-   ReadSetupFromStr(fXML->GetAttr(fRootNode, xmlio::Setup));
-
-   if (fXML->HasAttr(fRootNode, xmlio::CreateTm)) {
-      TDatime tm(fXML->GetAttr(fRootNode, xmlio::CreateTm));
-      fDatimeC = tm;
-   }
-
-   if (fXML->HasAttr(fRootNode, xmlio::ModifyTm)) {
-      TDatime tm(fXML->GetAttr(fRootNode, xmlio::ModifyTm));
-      fDatimeM = tm;
-   }
-
-   if (fXML->HasAttr(fRootNode, xmlio::ObjectUUID)) {
-      TUUID id(fXML->GetAttr(fRootNode, xmlio::ObjectUUID));
-      fUUID = id;
-   }
-
-   if (fXML->HasAttr(fRootNode, xmlio::Title))
-      SetTitle(fXML->GetAttr(fRootNode, xmlio::Title));
-
-   if (fXML->HasAttr(fRootNode, xmlio::IOVersion))
-      fIOVersion = fXML->GetIntAttr(fRootNode, xmlio::IOVersion);
-   else
-      fIOVersion = 1;
-
-   if (fXML->HasAttr(fRootNode, "file_version"))
-      fVersion = fXML->GetIntAttr(fRootNode, "file_version");
+   ReadRootAttributes(fRootNode);
 
    fStreamerInfoNode = fXML->GetChild(fRootNode);
    fXML->SkipEmpty(fStreamerInfoNode);
@@ -640,6 +649,171 @@ Bool_t TXMLFile::ReadFromFile()
    return kTRUE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// read attributes of the root node of the document
+
+void TXMLFile::ReadRootAttributes(XMLNodePointer_t rootnode)
+{
+   ReadSetupFromStr(fXML->GetAttr(rootnode, xmlio::Setup));
+
+   if (fXML->HasAttr(rootnode, xmlio::CreateTm)) {
+      TDatime tm(fXML->GetAttr(rootnode, xmlio::CreateTm));
+      fDatimeC = tm;
+   }
+
+   if (fXML->HasAttr(rootnode, xmlio::ModifyTm)) {
+      TDatime tm(fXML->GetAttr(rootnode, xmlio::ModifyTm));
+      fDatimeM = tm;
+   }
+
+   if (fXML->HasAttr(rootnode, xmlio::ObjectUUID)) {
+      TUUID id(fXML->GetAttr(rootnode, xmlio::ObjectUUID));
+      fUUID = id;
+   }
+
+   if (fXML->HasAttr(rootnode, xmlio::Title))
+      SetTitle(fXML->GetAttr(rootnode, xmlio::Title));
+
+   if (fXML->HasAttr(rootnode, xmlio::IOVersion))
+      fIOVersion = fXML->GetIntAttr(rootnode, xmlio::IOVersion);
+   else
+      fIOVersion = 1;
+
+   if (fXML->HasAttr(rootnode, "file_version"))
+      fVersion = fXML->GetIntAttr(rootnode, "file_version");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// read structure of the file with option lazy=1
+/// File is read node after node, without building the complete document in
+/// memory. Only attributes of the keys and streamer infos are kept, the
+/// content of each key is read from the file when the key object is read,
+/// see ReadKeyNode()
+
+Bool_t TXMLFile::ReadFromFileLazy()
+{
+   XMLReaderPointer_t reader = fXML->OpenReader(fRealName);
+   if (reader==0) return kFALSE;
+
+   Bool_t first = kTRUE, validversion = kFALSE, rootread = kFALSE;
+   Int_t token;
+
+   while ((token = fXML->ReaderNext(reader)) > TXMLEngine::kReaderEndOfDoc) {
+      XMLNodePointer_t node = fXML->ReaderGetNode(reader);
+      Int_t depth = fXML->ReaderGetDepth(reader);
+
+      if (depth == 0) {
+         // same check as TXMLEngine::ValidateVersion()
+         if (first && (token == TXMLEngine::kReaderOther) && (strcmp(fXML->GetNodeName(node), "xml")==0)) {
+            const char* version = fXML->GetAttr(node, "version");
+            validversion = version && (strcmp(version, "1.0")==0);
+         }
+         first = kFALSE;
+         if (token != TXMLEngine::kReaderStartNode) continue;
+         if (!validversion || rootread) break;
+         ReadRootAttributes(node);
+         rootread = kTRUE;
+         continue;
+      }
+
+      if ((depth != 1) || (token != TXMLEngine::kReaderStartNode)) continue;
+
+      if (strcmp(xmlio::SInfos, fXML->GetNodeName(node))==0) {
+         if (fStreamerInfoNode) fXML->FreeNode(fStreamerInfoNode);
+         fStreamerInfoNode = fXML->ReaderReadSubtree(reader);
+         continue;
+      }
+
+      if (strcmp(xmlio::Xmlkey, fXML->GetNodeName(node))!=0) {
+         fXML->ReaderSkipSubtree(reader);
+         continue;
+      }
+
+      // copy attributes of the key node and of its object node,
+      // the rest of the key is skipped
+      Long64_t keypos = fXML->ReaderGetPosition(reader);
+      XMLNodePointer_t keynode = CopyNodeHeader(node, 0);
+      Bool_t objfound = kFALSE;
+
+      while ((token = fXML->ReaderNext(reader)) > TXMLEngine::kReaderEndOfDoc) {
+         if (token == TXMLEngine::kReaderEndNode) break;
+         if (token != TXMLEngine::kReaderStartNode) continue;
+         node = fXML->ReaderGetNode(reader);
+         if (!objfound && (strcmp(fXML->GetNodeName(node), xmlio::XmlBlock)!=0)) {
+            CopyNodeHeader(node, keynode);
+            objfound = kTRUE;
+         }
+         if (!fXML->ReaderSkipSubtree(reader)) break;
+      }
+
+      if (token != TXMLEngine::kReaderEndNode) {
+         fXML->FreeNode(keynode);
+         break;
+      }
+
+      TKeyXML* key = new TKeyXML(this, ++fKeyCounter, keynode);
+      key->SetKeyPos(keypos);
+      fXML->CleanNode(keynode);
+      AppendKey(key);
+
+      if (gDebug>2)
+         Info("ReadFromFileLazy","Add key %s at position %lld", key->GetName(), keypos);
+   }
+
+   fXML->CloseReader(reader);
+
+   if ((token != TXMLEngine::kReaderEndOfDoc) || !rootread) {
+      Error("ReadFromFileLazy", "Fail to read file %s", fRealName.Data());
+      return kFALSE;
+   }
+
+   if (fStreamerInfoNode!=0)
+      ReadStreamerInfo();
+
+   fDoc = fXML->NewDoc();
+   fXML->DocSetRootElement(fDoc, fXML->NewChild(0, 0, xmlio::Root, 0));
+
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// create new node with the same name and attributes as node,
+/// which becomes child of parent (if specified)
+
+XMLNodePointer_t TXMLFile::CopyNodeHeader(XMLNodePointer_t node, XMLNodePointer_t parent)
+{
+   XMLNodePointer_t copy = fXML->NewChild(parent, 0, fXML->GetNodeName(node), 0);
+   XMLAttrPointer_t attr = fXML->GetFirstAttr(node);
+   while (attr!=0) {
+      fXML->NewAttr(copy, 0, fXML->GetAttrName(attr), fXML->GetAttrValue(attr));
+      attr = fXML->GetNextAttr(attr);
+   }
+   return copy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// read complete key node, which starts at specified position of the file.
+/// Used by TKeyXML to read its content on demand in files opened with
+/// option lazy=1. Returned node should be released by the caller
+
+XMLNodePointer_t TXMLFile::ReadKeyNode(Long64_t pos)
+{
+   XMLReaderPointer_t reader = fXML->OpenReader(fRealName, pos);
+   if (reader==0) return 0;
+
+   XMLNodePointer_t keynode = 0;
+   if ((fXML->ReaderNext(reader) == TXMLEngine::kReaderStartNode) &&
+       (strcmp(fXML->GetNodeName(fXML->ReaderGetNode(reader)), xmlio::Xmlkey)==0))
+      keynode = fXML->ReaderReadSubtree(reader);
+
+   fXML->CloseReader(reader);
+
+   if (keynode==0)
+      Error("ReadKeyNode", "Fail to read key at position %lld of file %s", pos, fRealName.Data());
+
+   return keynode;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read list of keys for directory
 
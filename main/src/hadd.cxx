@@ -51,6 +51,14 @@
   If the option -cachedsize is used, hadd will resize (or disable if 0) the
   prefetching cache use to speed up I/O operations.
 
+  If the option -j is used, the inputs are split in N groups merged
+  concurrently, each into a partial file, and the partial files are then
+  merged into the target file. The partial files are created in the
+  directory given with -d (by default the system temporary directory) and
+  removed at the end. The limit on the number of opened files (-n) applies
+  to all the concurrent merges together.
+       hadd -j 8 result.root  myfil*.root
+
   For options that takes a size as argument, a decimal number of bytes is expected.
   If the number ends with a ``k'', ``m'', ``g'', etc., the number is multiplied
   by 1000 (1K), 1000000 (1MB), 1000000000 (1G), etc.
@@ -71,7 +79,11 @@
  */
 
 #include "RConfig.h"
+#include "RConfigure.h"
 #include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
 #include "TFile.h"
 #include "THashList.h"
 #include "TKey.h"
@@ -79,11 +91,16 @@
 #include "Riostream.h"
 #include "TClass.h"
 #include "TSystem.h"
+#include "TROOT.h"
 #include "ROOT/StringConv.hxx"
 #include <stdlib.h>
 #include <climits>
 
 #include "TFileMerger.h"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+#endif
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -92,6 +109,7 @@ int main( int argc, char **argv )
    if ( argc < 3 || "-h" == std::string(argv[1]) || "--help" == std::string(argv[1]) ) {
       std::cout << "Usage: " << argv[0] << " [-f[fk][0-9]] [-k] [-T] [-O] [-a] \n"
       "            [-n maxopenedfiles] [-cachesize size] [-v [verbosity]] \n"
+      "            [-j [njobs]] [-d workingdir] \n"
       "            targetfile source1 [source2 source3 ...]\n" << std::endl;
       std::cout << "This program will add histograms from a list of root files and write them" << std::endl;
       std::cout << "   to a target root file. The target file is newly created and must not" << std::endl;
@@ -108,6 +126,10 @@ int main( int argc, char **argv )
                    "   to request to use the system maximum." << std::endl;
       std::cout << "If the option -cachedsize is used, hadd will resize (or disable if 0) the\n"
                    "   prefetching cache use to speed up I/O operations." << std::endl;
+      std::cout << "If the option -j is used, hadd will merge 'njobs' groups of inputs concurrently\n"
+                   "   into partial files (in 'workingdir' if -d is used, the temporary directory\n"
+                   "   otherwise) before merging them into the target file; by default 'njobs' is\n"
+                   "   the number of cores." << std::endl;
       std::cout << "When -the -f option is specified, one can also specify the compression level of\n"
                    "   the target file.  By default the compression level is 1." <<std::endl;
       std::cout << "If \"-fk\" is specified, the target file contain the baskets with the same\n"
@@ -141,6 +163,8 @@ int main( int argc, char **argv )
    Bool_t useFirstInputCompression = kFALSE;
    Int_t maxopenedfiles = 0;
    Int_t verbosity = 99;
+   Int_t njobs = 1;
+   TString workingDir;
    TString cacheSize;
 
    int outputPlace = 0;
@@ -221,6 +245,31 @@ int main( int argc, char **argv )
             }
          }
          ++ffirst;
+      } else if ( strcmp(argv[a],"-j") == 0 ) {
+         if (a+1 == argc || !isdigit(argv[a+1][0])) {
+            // Number of jobs was not specified use the number of cores:
+            njobs = 0;
+         } else {
+            Long_t request = strtol(argv[a+1], 0, 10);
+            if (request < kMaxLong && request >= 0) {
+               njobs = (Int_t)request;
+               ++a;
+               ++ffirst;
+            } else {
+               std::cerr << "Error: could not parse the number of jobs passed after -j: " << argv[a+1] << ". We will use the number of cores.\n";
+               njobs = 0;
+            }
+         }
+         ++ffirst;
+      } else if ( strcmp(argv[a],"-d") == 0 ) {
+         if (a+1 >= argc) {
+            std::cerr << "Error: no working directory was provided after -d.\n";
+         } else {
+            workingDir = argv[a+1];
+            ++a;
+            ++ffirst;
+         }
+         ++ffirst;
       } else if ( strcmp(argv[a],"-v") == 0 ) {
          if (a+1 == argc || argv[a+1][0] == '-') {
             // Verbosity level was not specified use the default:
@@ -359,32 +408,132 @@ int main( int argc, char **argv )
    }
 
 
-   for ( int i = ffirst; i < argc; i++ ) {
-      if (argv[i] && argv[i][0]=='@') {
-         std::ifstream indirect_file(argv[i]+1);
-         if( ! indirect_file.is_open() ) {
-            std::cerr<< "hadd could not open indirect file " << (argv[i]+1) << std::endl;
-            return 1;
-         }
-         while( indirect_file ){
-            std::string line;
-            if( std::getline(indirect_file, line) && line.length() &&  !merger.AddFile(line.c_str()) ) {
+   if (njobs == 0) njobs = std::thread::hardware_concurrency();
+#ifndef R__USE_IMT
+   if (njobs > 1) {
+      std::cerr << "hadd was built without multi-threading support, option -j is ignored." << std::endl;
+      njobs = 1;
+   }
+#endif
+
+   std::vector<std::string> inputs;
+   std::vector<std::string> partialFiles;
+   Bool_t partialCompressionChange = kFALSE;
+#ifdef R__USE_IMT
+   Int_t maxPerJob = 2;
+   if (njobs > 1) {
+      for ( int i = ffirst; i < argc; i++ ) {
+         if (argv[i] && argv[i][0]=='@') {
+            std::ifstream indirect_file(argv[i]+1);
+            if( ! indirect_file.is_open() ) {
+               std::cerr<< "hadd could not open indirect file " << (argv[i]+1) << std::endl;
                return 1;
             }
+            while( indirect_file ){
+               std::string line;
+               if( std::getline(indirect_file, line) && line.length() ) {
+                  inputs.push_back(line);
+               }
+            }
+         } else if (argv[i]) {
+            inputs.push_back(argv[i]);
          }
-      } else if( ! merger.AddFile(argv[i]) ) {
-         if ( skip_errors ) {
-            std::cerr << "hadd skipping file with error: " << argv[i] << std::endl;
-         } else {
-            std::cerr << "hadd exiting due to error in " << argv[i] << std::endl;
+      }
+      // The concurrent merges, together with the target file, must stay within
+      // the limit on the number of opened files; each merges at least 2 inputs.
+      maxPerJob = (merger.GetMaxOpenedFiles() - 1) / njobs;
+      if (maxPerJob < 2) {
+         maxPerJob = 2;
+         njobs = (merger.GetMaxOpenedFiles() - 1) / maxPerJob;
+      }
+      if ((size_t)njobs > inputs.size() / 2) njobs = inputs.size() / 2;
+   }
+   if (njobs > 1) {
+      ROOT::EnableThreadSafety();
+      if (workingDir.IsNull()) workingDir = gSystem->TempDirectory();
+      for (Int_t job = 0; job < njobs; ++job) {
+         partialFiles.push_back(TString::Format("%s/hadd_partial_%d_%d.root", workingDir.Data(), gSystem->GetPid(), job).Data());
+      }
+      if (verbosity > 1) {
+         std::cout << "hadd merging " << inputs.size() << " input files in " << njobs << " concurrent jobs" << std::endl;
+      }
+
+      // Merge each group of inputs into its partial file.
+      std::atomic<bool> compressionChange(false);
+      auto mergeJob = [&](UInt_t job) -> Int_t {
+         TFileMerger partial(kFALSE,kFALSE);
+         partial.SetMsgPrefix(TString::Format("hadd [job %u]", job));
+         partial.SetPrintLevel(verbosity - 2);
+         partial.SetMaxOpenedFiles(maxPerJob);
+         if (!partial.OutputFile(partialFiles[job].c_str(), kTRUE, newcomp)) {
+            std::cerr << "hadd error opening partial file " << partialFiles[job] << "." << std::endl;
+            return 0;
+         }
+         for (size_t i = job * inputs.size() / njobs; i < (job + 1) * inputs.size() / njobs; ++i) {
+            if( ! partial.AddFile(inputs[i].c_str()) ) {
+               if ( skip_errors ) {
+                  std::cerr << "hadd skipping file with error: " << inputs[i] << std::endl;
+               } else {
+                  std::cerr << "hadd exiting due to error in " << inputs[i] << std::endl;
+                  return 0;
+               }
+            }
+         }
+         if (partial.HasCompressionChange()) compressionChange = true;
+         partial.SetFastMethod(!reoptimize);
+         partial.SetNotrees(noTrees);
+         partial.SetMergeOptions(cacheSize);
+         return partial.Merge();
+      };
+      ROOT::TThreadExecutor pool(njobs);
+      std::vector<Int_t> jobStatus = pool.Map(mergeJob, ROOT::TSeqU(njobs));
+      for (auto ok : jobStatus) {
+         if (!ok) {
+            std::cerr << "hadd failure during the concurrent merges." << std::endl;
+            for (auto &name : partialFiles) gSystem->Unlink(name.c_str());
             return 1;
          }
       }
+      partialCompressionChange = compressionChange;
+   }
+#endif
+
+   if (!partialFiles.empty()) {
+      for (auto &name : partialFiles) {
+         if( ! merger.AddFile(name.c_str()) ) {
+            std::cerr << "hadd exiting due to error in " << name << std::endl;
+            for (auto &partialName : partialFiles) gSystem->Unlink(partialName.c_str());
+            return 1;
+         }
+      }
+   } else {
+      for ( int i = ffirst; i < argc; i++ ) {
+         if (argv[i] && argv[i][0]=='@') {
+            std::ifstream indirect_file(argv[i]+1);
+            if( ! indirect_file.is_open() ) {
+               std::cerr<< "hadd could not open indirect file " << (argv[i]+1) << std::endl;
+               return 1;
+            }
+            while( indirect_file ){
+               std::string line;
+               if( std::getline(indirect_file, line) && line.length() &&  !merger.AddFile(line.c_str()) ) {
+                  return 1;
+               }
+            }
+         } else if( ! merger.AddFile(argv[i]) ) {
+            if ( skip_errors ) {
+               std::cerr << "hadd skipping file with error: " << argv[i] << std::endl;
+            } else {
+               std::cerr << "hadd exiting due to error in " << argv[i] << std::endl;
+               return 1;
+            }
+         }
+      }
    }
    if (reoptimize) {
       merger.SetFastMethod(kFALSE);
    } else {
-      if (!keepCompressionAsIs && merger.HasCompressionChange()) {
+      if (!keepCompressionAsIs && (merger.HasCompressionChange() || partialCompressionChange)) {
          // Don't warn if the user any request re-optimization.
          std::cout <<"hadd Sources and Target have different compression levels"<<std::endl;
          std::cout <<"hadd merging will be slower"<<std::endl;
@@ -396,14 +545,17 @@ int main( int argc, char **argv )
    if (append) status = merger.PartialMerge(TFileMerger::kIncremental | TFileMerger::kAll);
    else status = merger.Merge();
 
+   Int_t nmerged = partialFiles.empty() ? merger.GetMergeList()->GetEntries() : (Int_t)inputs.size();
+   for (auto &name : partialFiles) gSystem->Unlink(name.c_str());
+
    if (status) {
       if (verbosity == 1) {
-         std::cout << "hadd merged " << merger.GetMergeList()->GetEntries() << " input files in " << targetname << ".\n";
+         std::cout << "hadd merged " << nmerged << " input files in " << targetname << ".\n";
       }
       return 0;
    } else {
       if (verbosity == 1) {
-         std::cout << "hadd failure during the merge of " << merger.GetMergeList()->GetEntries() << " input files in " << targetname << ".\n";
+         std::cout << "hadd failure during the merge of " << nmerged << " input files in " << targetname << ".\n";
       }
       return 1;
    }
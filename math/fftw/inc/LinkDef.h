@@ -9,5 +9,6 @@
 #pragma link C++ class TFFTComplexReal+;
 #pragma link C++ class TFFTRealComplex+;
 #pragma link C++ class TFFTReal+;
+#pragma link C++ class TFFTWPlanCache;
 
 #endif
@@ -0,0 +1,56 @@
+// @(#)root/fft:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TFFTWPlanCache
+#define ROOT_TFFTWPlanCache
+
+//////////////////////////////////////////////////////////////////////////
+//
+// TFFTWPlanCache
+// Process-wide cache of the FFTW plans made by TFFTComplex, TFFTComplexReal,
+// TFFTRealComplex and TFFTReal. A plan is identified by the type, sizes,
+// sign or kinds, flags and placement of the transform, and by the number
+// of threads it uses: objects of the same transform share one plan, and
+// a plan stays in the cache when its last object is deleted, so that
+// TVirtualFFT::FFT does not plan again each time the sizes change back.
+// Clear() destroys the plans which are no longer used.
+//
+// Since the FFTW planner is not thread-safe, all the plans are made and
+// destroyed under the same lock; the transforms themselves can run
+// concurrently. The wisdom accumulated by the planner can be saved with
+// ExportWisdom() and reloaded in another session with ImportWisdom().
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_Rtypes
+#include "Rtypes.h"
+#endif
+
+#include <functional>
+#include <string>
+
+class TFFTWPlanCache {
+public:
+   static void    *GetPlan(const std::string &key, const std::function<void *()> &planner);
+   static void     Release(void *plan);
+   static Int_t    Clear();
+   static Int_t    GetSize();
+
+   static Bool_t   ImportWisdom(const char *filename);
+   static Bool_t   ExportWisdom(const char *filename);
+
+   static void     SetNumThreads(Int_t nthreads);
+   static Int_t    GetNumThreads();
+
+   static std::string MakeKey(const char *type, Int_t ndim, const Int_t *n, Int_t sign, const Int_t *kinds, UInt_t flags, Bool_t inPlace);
+};
+
+#endif
@@ -37,6 +37,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "TFFTComplex.h"
+#include "TFFTWPlanCache.h"
 #include "fftw3.h"
 #include "TComplex.h"
 
@@ -102,13 +103,12 @@ TFFTComplex::TFFTComplex(Int_t ndim, Int_t *n, Bool_t inPlace)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-///Destroys the data arrays and the plan. However, some plan information stays around
-///until the root session is over, and is reused if other plans of the same size are
-///created
+///Destroys the data arrays and gives back the plan to TFFTWPlanCache, where it stays
+///to be reused by the next transform of the same size and type
 
 TFFTComplex::~TFFTComplex()
 {
-   fftw_destroy_plan((fftw_plan)fPlan);
+   TFFTWPlanCache::Release(fPlan);
    fPlan = 0;
    fftw_free((fftw_complex*)fIn);
    if (fOut)
@@ -133,7 +133,8 @@ TFFTComplex::~TFFTComplex()
 ///"EX" (from "exhaustive") - the most optimal way is found
 ///This option should be chosen depending on how many transforms of the same size and
 ///type are going to be done. Planning is only done once, for the first transform of this
-///size and type.
+///size and type: the plans are kept in TFFTWPlanCache, and taken from there (without
+///touching the arrays) by the next objects of the same size, type and flags.
 
 void TFFTComplex::Init( Option_t *flags, Int_t sign,const Int_t* /*kind*/)
 {
@@ -141,13 +142,15 @@ void TFFTComplex::Init( Option_t *flags, Int_t sign,const Int_t* /*kind*/)
    fFlags = flags;
 
    if (fPlan)
-      fftw_destroy_plan((fftw_plan)fPlan);
+      TFFTWPlanCache::Release(fPlan);
    fPlan = 0;
 
-   if (fOut)
-      fPlan = (void*)fftw_plan_dft(fNdim, fN, (fftw_complex*)fIn, (fftw_complex*)fOut, sign,MapFlag(flags));
-   else
-      fPlan = (void*)fftw_plan_dft(fNdim, fN, (fftw_complex*)fIn, (fftw_complex*)fIn, sign, MapFlag(flags));
+   UInt_t fftwFlags = MapFlag(flags);
+   fftw_complex *out = (fftw_complex*)(fOut ? fOut : fIn);
+   std::string key = TFFTWPlanCache::MakeKey("C2C", fNdim, fN, sign, 0, fftwFlags, !fOut);
+   fPlan = TFFTWPlanCache::GetPlan(key, [&]() {
+      return (void*)fftw_plan_dft(fNdim, fN, (fftw_complex*)fIn, out, sign, fftwFlags);
+   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -156,7 +159,7 @@ void TFFTComplex::Init( Option_t *flags, Int_t sign,const Int_t* /*kind*/)
 void TFFTComplex::Transform()
 {
    if (fPlan)
-      fftw_execute((fftw_plan)fPlan);
+      fftw_execute_dft((fftw_plan)fPlan, (fftw_complex*)fIn, (fftw_complex*)(fOut ? fOut : fIn));
    else {
       Error("Transform", "transform not initialised");
       return;
@@ -42,6 +42,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "TFFTComplexReal.h"
+#include "TFFTWPlanCache.h"
 #include "fftw3.h"
 #include "TComplex.h"
 
@@ -111,13 +112,12 @@ TFFTComplexReal::TFFTComplexReal(Int_t ndim, Int_t *n, Bool_t inPlace)
 
 
 ////////////////////////////////////////////////////////////////////////////////
-///Destroys the data arrays and the plan. However, some plan information stays around
-///until the root session is over, and is reused if other plans of the same size are
-///created
+///Destroys the data arrays and gives back the plan to TFFTWPlanCache, where it stays
+///to be reused by the next transform of the same size and type
 
 TFFTComplexReal::~TFFTComplexReal()
 {
-   fftw_destroy_plan((fftw_plan)fPlan);
+   TFFTWPlanCache::Release(fPlan);
    fPlan = 0;
    fftw_free((fftw_complex*)fIn);
    if (fOut)
@@ -144,20 +144,23 @@ TFFTComplexReal::~TFFTComplexReal()
 ///"EX" (from "exhaustive") - the most optimal way is found
 ///This option should be chosen depending on how many transforms of the same size and
 ///type are going to be done. Planning is only done once, for the first transform of this
-///size and type.
+///size and type: the plans are kept in TFFTWPlanCache, and taken from there (without
+///touching the arrays) by the next objects of the same size, type and flags.
 
 void TFFTComplexReal::Init( Option_t *flags, Int_t /*sign*/,const Int_t* /*kind*/)
 {
    fFlags = flags;
 
    if (fPlan)
-      fftw_destroy_plan((fftw_plan)fPlan);
+      TFFTWPlanCache::Release(fPlan);
    fPlan = 0;
 
-   if (fOut)
-      fPlan = (void*)fftw_plan_dft_c2r(fNdim, fN,(fftw_complex*)fIn,(Double_t*)fOut, MapFlag(flags));
-   else
-      fPlan = (void*)fftw_plan_dft_c2r(fNdim, fN, (fftw_complex*)fIn, (Double_t*)fIn, MapFlag(flags));
+   UInt_t fftwFlags = MapFlag(flags);
+   Double_t *out = (Double_t*)(fOut ? fOut : fIn);
+   std::string key = TFFTWPlanCache::MakeKey("C2R", fNdim, fN, 0, 0, fftwFlags, !fOut);
+   fPlan = TFFTWPlanCache::GetPlan(key, [&]() {
+      return (void*)fftw_plan_dft_c2r(fNdim, fN, (fftw_complex*)fIn, out, fftwFlags);
+   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -166,7 +169,7 @@ void TFFTComplexReal::Init( Option_t *flags, Int_t /*sign*/,const Int_t* /*kind*
 void TFFTComplexReal::Transform()
 {
    if (fPlan)
-      fftw_execute((fftw_plan)fPlan);
+      fftw_execute_dft_c2r((fftw_plan)fPlan, (fftw_complex*)fIn, (Double_t*)(fOut ? fOut : fIn));
    else {
       Error("Transform", "transform was not initialized");
       return;
@@ -57,8 +57,11 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "TFFTReal.h"
+#include "TFFTWPlanCache.h"
 #include "fftw3.h"
 
+#include <vector>
+
 ClassImp(TFFTReal)
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -120,11 +123,11 @@ TFFTReal::TFFTReal(Int_t ndim, Int_t *n, Bool_t inPlace)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-///clean-up
+///clean-up; the plan is given back to TFFTWPlanCache
 
 TFFTReal::~TFFTReal()
 {
-   fftw_destroy_plan((fftw_plan)fPlan);
+   TFFTWPlanCache::Release(fPlan);
    fPlan = 0;
    fftw_free(fIn);
    fIn = 0;
@@ -155,7 +158,8 @@ TFFTReal::~TFFTReal()
 ///  "EX" (from "exhaustive") - the most optimal way is found
 ///  This option should be chosen depending on how many transforms of the same size and
 ///  type are going to be done. Planning is only done once, for the first transform of this
-///  size and type.
+///  size and type: the plans are kept in TFFTWPlanCache, and taken from there (without
+///  touching the arrays) by the next objects of the same size, kinds and flags.
 ///2nd parameter is dummy and doesn't need to be specified
 ///3rd parameter- transform kind for each dimension
 ///     4 different kinds of sine and cosine transforms are available
@@ -171,17 +175,22 @@ TFFTReal::~TFFTReal()
 void TFFTReal::Init( Option_t* flags,Int_t /*sign*/, const Int_t *kind)
 {
    if (fPlan)
-      fftw_destroy_plan((fftw_plan)fPlan);
+      TFFTWPlanCache::Release(fPlan);
    fPlan = 0;
 
    if (!fKind)
       fKind = (fftw_r2r_kind*)fftw_malloc(sizeof(fftw_r2r_kind)*fNdim);
 
    if (MapOptions(kind)){
-      if (fOut)
-         fPlan = (void*)fftw_plan_r2r(fNdim, fN, (Double_t*)fIn, (Double_t*)fOut, (fftw_r2r_kind*)fKind, MapFlag(flags));
-      else
-         fPlan = (void*)fftw_plan_r2r(fNdim, fN, (Double_t*)fIn, (Double_t*)fIn, (fftw_r2r_kind*)fKind, MapFlag(flags));
+      UInt_t fftwFlags = MapFlag(flags);
+      Double_t *out = (Double_t*)(fOut ? fOut : fIn);
+      std::vector<Int_t> kinds(fNdim);
+      for (Int_t i=0; i<fNdim; i++)
+         kinds[i] = ((fftw_r2r_kind*)fKind)[i];
+      std::string key = TFFTWPlanCache::MakeKey("R2R", fNdim, fN, 0, kinds.data(), fftwFlags, !fOut);
+      fPlan = TFFTWPlanCache::GetPlan(key, [&]() {
+         return (void*)fftw_plan_r2r(fNdim, fN, (Double_t*)fIn, out, (fftw_r2r_kind*)fKind, fftwFlags);
+      });
       fFlags = flags;
    }
 }
@@ -192,7 +201,7 @@ void TFFTReal::Init( Option_t* flags,Int_t /*sign*/, const Int_t *kind)
 void TFFTReal::Transform()
 {
    if (fPlan)
-      fftw_execute((fftw_plan)fPlan);
+      fftw_execute_r2r((fftw_plan)fPlan, (Double_t*)fIn, (Double_t*)(fOut ? fOut : fIn));
    else {
       Error("Transform", "transform hasn't been initialised");
       return;
@@ -42,6 +42,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "TFFTRealComplex.h"
+#include "TFFTWPlanCache.h"
 #include "fftw3.h"
 #include "TComplex.h"
 
@@ -114,13 +115,12 @@ TFFTRealComplex::TFFTRealComplex(Int_t ndim, Int_t *n, Bool_t inPlace)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-///Destroys the data arrays and the plan. However, some plan information stays around
-///until the root session is over, and is reused if other plans of the same size are
-///created
+///Destroys the data arrays and gives back the plan to TFFTWPlanCache, where it stays
+///to be reused by the next transform of the same size and type
 
 TFFTRealComplex::~TFFTRealComplex()
 {
-   fftw_destroy_plan((fftw_plan)fPlan);
+   TFFTWPlanCache::Release(fPlan);
    fPlan = 0;
    fftw_free(fIn);
    fIn = 0;
@@ -147,20 +147,23 @@ TFFTRealComplex::~TFFTRealComplex()
 ///"EX" (from "exhaustive") - the most optimal way is found
 ///This option should be chosen depending on how many transforms of the same size and
 ///type are going to be done. Planning is only done once, for the first transform of this
-///size and type.
+///size and type: the plans are kept in TFFTWPlanCache, and taken from there (without
+///touching the arrays) by the next objects of the same size, type and flags.
 
 void TFFTRealComplex::Init(Option_t *flags,Int_t /*sign*/, const Int_t* /*kind*/)
 {
    fFlags = flags;
 
    if (fPlan)
-      fftw_destroy_plan((fftw_plan)fPlan);
+      TFFTWPlanCache::Release(fPlan);
    fPlan = 0;
 
-   if (fOut)
-      fPlan = (void*)fftw_plan_dft_r2c(fNdim, fN, (Double_t*)fIn, (fftw_complex*)fOut,MapFlag(flags));
-   else
-      fPlan = (void*)fftw_plan_dft_r2c(fNdim, fN, (Double_t*)fIn, (fftw_complex*)fIn, MapFlag(flags));
+   UInt_t fftwFlags = MapFlag(flags);
+   fftw_complex *out = (fftw_complex*)(fOut ? fOut : fIn);
+   std::string key = TFFTWPlanCache::MakeKey("R2C", fNdim, fN, 0, 0, fftwFlags, !fOut);
+   fPlan = TFFTWPlanCache::GetPlan(key, [&]() {
+      return (void*)fftw_plan_dft_r2c(fNdim, fN, (Double_t*)fIn, out, fftwFlags);
+   });
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -170,7 +173,7 @@ void TFFTRealComplex::Transform()
 {
 
    if (fPlan){
-      fftw_execute((fftw_plan)fPlan);
+      fftw_execute_dft_r2c((fftw_plan)fPlan, (Double_t*)fIn, (fftw_complex*)(fOut ? fOut : fIn));
    }
    else {
       Error("Transform", "transform hasn't been initialised");
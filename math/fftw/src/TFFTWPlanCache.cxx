@@ -0,0 +1,230 @@
+// @(#)root/fft:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//
+// TFFTWPlanCache
+// Process-wide cache of the FFTW plans made by TFFTComplex, TFFTComplexReal,
+// TFFTRealComplex and TFFTReal. A plan is identified by the type, sizes,
+// sign or kinds, flags and placement of the transform, and by the number
+// of threads it uses: objects of the same transform share one plan, and
+// a plan stays in the cache when its last object is deleted, so that
+// TVirtualFFT::FFT does not plan again each time the sizes change back.
+// Clear() destroys the plans which are no longer used.
+//
+// Since the FFTW planner is not thread-safe, all the plans are made and
+// destroyed under the same lock; the transforms themselves can run
+// concurrently. The wisdom accumulated by the planner can be saved with
+// ExportWisdom() and reloaded in another session with ImportWisdom().
+//
+// If ROOT is linked against the fftw3_threads library, the plans made
+// after SetNumThreads(n) compute each transform with n threads.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "TFFTWPlanCache.h"
+#include "fftw3.h"
+#include "TError.h"
+
+#include <cstdio>
+#include <map>
+#include <mutex>
+
+namespace {
+   struct PlanEntry {
+      void  *fPlan;  // the fftw plan
+      Int_t  fRefs;  // number of transform objects using it
+   };
+
+   std::mutex &GetPlannerMutex()
+   {
+      static std::mutex mutex;
+      return mutex;
+   }
+
+   std::map<std::string, PlanEntry> &GetPlans()
+   {
+      static std::map<std::string, PlanEntry> plans;
+      return plans;
+   }
+
+   Int_t gNumThreads = 1;
+
+#ifdef R__HAS_FFTW_THREADS
+   // To be called with the planner lock held.
+   Bool_t InitThreads()
+   {
+      static Bool_t initialized = fftw_init_threads() != 0;
+      return initialized;
+   }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///Returns the plan of the transform identified by key (see MakeKey()),
+///calling planner to make it if it is not in the cache yet. planner is
+///called with the planner lock held and must not use the cache itself.
+///Each plan returned must be given back with Release().
+
+void *TFFTWPlanCache::GetPlan(const std::string &key, const std::function<void *()> &planner)
+{
+   std::lock_guard<std::mutex> lock(GetPlannerMutex());
+   std::string fullKey = key + " threads=" + std::to_string(gNumThreads);
+   auto &plans = GetPlans();
+   auto it = plans.find(fullKey);
+   if (it != plans.end()) {
+      ++it->second.fRefs;
+      return it->second.fPlan;
+   }
+
+#ifdef R__HAS_FFTW_THREADS
+   if (InitThreads())
+      fftw_plan_with_nthreads(gNumThreads);
+#endif
+   void *plan = planner();
+   if (plan)
+      plans[fullKey] = PlanEntry{plan, 1};
+   return plan;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///Gives back a plan returned by GetPlan(). The plan stays in the cache until
+///Clear() is called, to be reused by the next transform of the same kind.
+
+void TFFTWPlanCache::Release(void *plan)
+{
+   if (!plan) return;
+   std::lock_guard<std::mutex> lock(GetPlannerMutex());
+   for (auto &entry : GetPlans()) {
+      if (entry.second.fPlan == plan) {
+         if (entry.second.fRefs > 0) --entry.second.fRefs;
+         return;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///Destroys the cached plans which are not used by any transform object.
+///Returns the number of plans destroyed.
+
+Int_t TFFTWPlanCache::Clear()
+{
+   std::lock_guard<std::mutex> lock(GetPlannerMutex());
+   auto &plans = GetPlans();
+   Int_t ndestroyed = 0;
+   for (auto it = plans.begin(); it != plans.end();) {
+      if (it->second.fRefs == 0) {
+         fftw_destroy_plan((fftw_plan)it->second.fPlan);
+         it = plans.erase(it);
+         ++ndestroyed;
+      } else {
+         ++it;
+      }
+   }
+   return ndestroyed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///Returns the number of plans in the cache.
+
+Int_t TFFTWPlanCache::GetSize()
+{
+   std::lock_guard<std::mutex> lock(GetPlannerMutex());
+   return GetPlans().size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///Adds to the planner the wisdom saved in filename by ExportWisdom() (or by
+///the fftw-wisdom utility). The plans made afterwards with the same flags
+///reuse it instead of measuring again. Returns kFALSE if the file cannot
+///be read or its wisdom is not accepted.
+
+Bool_t TFFTWPlanCache::ImportWisdom(const char *filename)
+{
+   std::lock_guard<std::mutex> lock(GetPlannerMutex());
+   FILE *f = fopen(filename, "r");
+   if (!f) {
+      ::Error("TFFTWPlanCache::ImportWisdom", "cannot open %s", filename);
+      return kFALSE;
+   }
+   Bool_t ok = fftw_import_wisdom_from_file(f) != 0;
+   fclose(f);
+   if (!ok)
+      ::Error("TFFTWPlanCache::ImportWisdom", "%s does not contain valid fftw wisdom", filename);
+   return ok;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///Saves in filename the wisdom accumulated by the planner so far. Returns
+///kFALSE if the file cannot be written.
+
+Bool_t TFFTWPlanCache::ExportWisdom(const char *filename)
+{
+   std::lock_guard<std::mutex> lock(GetPlannerMutex());
+   FILE *f = fopen(filename, "w");
+   if (!f) {
+      ::Error("TFFTWPlanCache::ExportWisdom", "cannot open %s", filename);
+      return kFALSE;
+   }
+   fftw_export_wisdom_to_file(f);
+   return fclose(f) == 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///Sets the number of threads of the plans made from now on; the plans
+///already made keep theirs. Without the fftw3_threads library, only one
+///thread is used.
+
+void TFFTWPlanCache::SetNumThreads(Int_t nthreads)
+{
+   if (nthreads < 1) nthreads = 1;
+#ifndef R__HAS_FFTW_THREADS
+   if (nthreads > 1) {
+      ::Warning("TFFTWPlanCache::SetNumThreads", "ROOT was built without the fftw3_threads library, using one thread");
+      nthreads = 1;
+   }
+#endif
+   std::lock_guard<std::mutex> lock(GetPlannerMutex());
+   gNumThreads = nthreads;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///Returns the number of threads of the plans made from now on.
+
+Int_t TFFTWPlanCache::GetNumThreads()
+{
+   std::lock_guard<std::mutex> lock(GetPlannerMutex());
+   return gNumThreads;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///Returns the key of a transform of the given type (e.g. "C2C", "R2C"),
+///sizes, sign (0 if the type has none), kinds of each dimension (0 if the
+///type has none), fftw flags and placement.
+
+std::string TFFTWPlanCache::MakeKey(const char *type, Int_t ndim, const Int_t *n, Int_t sign, const Int_t *kinds, UInt_t flags, Bool_t inPlace)
+{
+   std::string key = type;
+   key += " n=";
+   for (Int_t i = 0; i < ndim; ++i) {
+      key += std::to_string(n[i]);
+      key += (i + 1 < ndim) ? "x" : "";
+   }
+   key += " sign=" + std::to_string(sign);
+   if (kinds) {
+      key += " kinds=";
+      for (Int_t i = 0; i < ndim; ++i)
+         key += std::to_string(kinds[i]) + ",";
+   }
+   key += " flags=" + std::to_string(flags);
+   key += inPlace ? " inplace" : " outofplace";
+   return key;
+}
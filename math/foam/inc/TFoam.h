@@ -40,6 +40,7 @@ protected:
    Int_t   fOptDrive;         // Optimization switch =1,2 for variance or maximum weight optimization
    Int_t   fChat;             // Chat=0,1,2 chat level in output, Chat=1 normal level
    Int_t   fOptRej;           // Switch =0 for weighted events; =1 for unweighted events in MC
+   Int_t   fOptMT;            //! Switch =1 for evaluating a thread-safe integrand concurrently
    //-------------------
    Int_t   fNBin;             // No. of bins in the edge histogram for cell MC exploration
    Int_t   fNSampl;           // No. of MC events, when dividing (exploring) cell
@@ -105,7 +106,9 @@ public:
    virtual void GenerCel2(TFoamCell *&);     // Chose an active cell the with probability ~ Primary integral
    // Generation
    virtual Double_t Eval(Double_t *);        // Evaluates value of the distribution function
+   virtual void     EvalBatch(Long_t, Double_t *, Double_t *); // Evaluates the distribution function at several points
    virtual void     MakeEvent();             // Makes (generates) single MC event
+   virtual void     MakeEvents(Long_t, Double_t *, Double_t *wt=0); // Makes (generates) several MC events at once
    virtual void     GetMCvect(Double_t *);   // Provides generated randomly MC vector
    virtual void     GetMCwt(Double_t &);     // Provides generated MC weight
    virtual Double_t GetMCwt();               // Provides generates MC weight
@@ -129,6 +132,7 @@ public:
    virtual void SetnBin(Int_t nBin){fNBin = nBin;}          // Sets no of bins in histogs in cell exploration
    virtual void SetChat(Int_t Chat){fChat = Chat;}          // Sets option Chat, chat level
    virtual void SetOptRej(Int_t OptRej){fOptRej =OptRej;}   // Sets option for MC rejection
+   virtual void SetOptMT(Int_t OptMT){fOptMT =OptMT;}       // Sets option for concurrent evaluation of the integrand
    virtual void SetOptDrive(Int_t OptDrive){fOptDrive =OptDrive;}  // Sets optimization switch
    virtual void SetEvPerBin(Int_t EvPerBin){fEvPerBin =EvPerBin;}  // Sets max. no. of effective events per bin
    virtual void SetMaxWtRej(Double_t MaxWtRej){fMaxWtRej=MaxWtRej;}  // Sets max. weight for rejection
@@ -149,6 +153,7 @@ public:
    // Inline
 private:
    Double_t Sqr(Double_t x) const { return x*x;}      // Square function
+   Long_t   FindActiveCell(Double_t random) const; // Index of the active cell at the given cumulative probability
    //////////////////////////////////////////////////////////////////////////////////////////////
    ClassDef(TFoam,1);   // General purpose self-adapting Monte Carlo event generator
 };
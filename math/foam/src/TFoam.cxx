@@ -123,6 +123,14 @@
 #include "TRandom.h"
 #include "TMath.h"
 #include "TInterpreter.h"
+#include "TROOT.h"
+
+#ifdef R__USE_IMT
+#include "ROOT/TSeq.hxx"
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
+#include <vector>
 
 ClassImp(TFoam);
 
@@ -177,7 +185,7 @@ private:
 
 TFoam::TFoam() :
    fDim(0), fNCells(0), fRNmax(0),
-   fOptDrive(0), fChat(0), fOptRej(0),
+   fOptDrive(0), fChat(0), fOptRej(0), fOptMT(0),
    fNBin(0), fNSampl(0), fEvPerBin(0),
    fMaskDiv(0), fInhiDiv(0), fOptPRD(0), fXdivPRD(0),
    fNoAct(0), fLastCe(0), fCells(0),
@@ -198,7 +206,7 @@ TFoam::TFoam() :
 
 TFoam::TFoam(const Char_t* Name) :
    fDim(0), fNCells(0), fRNmax(0),
-   fOptDrive(0), fChat(0), fOptRej(0),
+   fOptDrive(0), fChat(0), fOptRej(0), fOptMT(0),
    fNBin(0), fNSampl(0), fEvPerBin(0),
    fMaskDiv(0), fInhiDiv(0), fOptPRD(0), fXdivPRD(0),
    fNoAct(0), fLastCe(0), fCells(0),
@@ -236,6 +244,7 @@ TFoam::TFoam(const Char_t* Name) :
    fOptDrive = 2;                // type of Drive =1,2 for TrueVol,Sigma,WtMax
    fChat     = 1;                // Chat=0,1,2 chat level in output, Chat=1 normal level
    fOptRej   = 1;                // OptRej=0, wted events; OptRej=1, wt=1 events
+   fOptMT    = 0;                // OptMT=1, integrand evaluated concurrently in the implicit multi-threading
    /////////////////////////////////////////////////////////////////////////////
 
    fNBin     = 8;                // binning of edge-histogram in cell exploration
@@ -550,6 +559,11 @@ Int_t TFoam::CellFill(Int_t Status, TFoamCell *parent)
 /// The volume estimate in all (inactive) parent cells is updated.
 /// Note that links to parents and initial volume = 1/2 parent has to be
 /// already defined prior to calling this routine.
+/// The MC samples are drawn in batches and the integrand is evaluated for a
+/// whole batch with EvalBatch, concurrently if requested with SetOptMT(1).
+/// A batch then holds all the samples up to the first one after which the
+/// sampling may stop, then a fixed number of them, so that the result does
+/// not depend on the number of threads.
 
 void TFoam::Explore(TFoamCell *cell)
 {
@@ -569,7 +583,8 @@ void TFoam::Explore(TFoamCell *cell)
 
    TFoamCell  *parent;
 
-   Double_t *xRand = new Double_t[fDim];
+   const Long_t kNBatch = 16;
+   std::vector<Double_t> alphas, xRands, values;
 
    Double_t *volPart=0;
 
@@ -593,34 +608,50 @@ void TFoam::Explore(TFoamCell *cell)
    //
    // ||||||||||||||||||||||||||BEGIN MC LOOP|||||||||||||||||||||||||||||
    Double_t nevEff=0.;
-   for(iev=0;iev<fNSampl;iev++){
-      MakeAlpha();               // generate uniformly vector inside hypercube
-
-      if(fDim>0){
-      for(j=0; j<fDim; j++)
-         xRand[j]= cellPosi[j] +fAlpha[j]*(cellSize[j]);
+   Bool_t   mcExit=kFALSE;
+   // nevEff never exceeds the number of samples, the loop cannot stop earlier
+   Long_t   nevMin=(Long_t)TMath::Ceil((Double_t)fNBin*fEvPerBin);
+   for(iev=0;iev<fNSampl && !mcExit;){
+      Long_t nBatch = 1;
+      if(fOptMT==1) nBatch = TMath::Min((Long_t)fNSampl-iev, TMath::Max(kNBatch, nevMin-iev));
+      alphas.resize(nBatch*fDim);
+      xRands.resize(nBatch*fDim);
+      values.resize(nBatch);
+      for(Long_t ib=0; ib<nBatch; ib++){
+         MakeAlpha();               // generate uniformly vector inside hypercube
+         for(j=0; j<fDim; j++){
+            alphas[ib*fDim+j]= fAlpha[j];
+            xRands[ib*fDim+j]= cellPosi[j] +fAlpha[j]*(cellSize[j]);
+         }
       }
-
-      wt=dx*Eval(xRand);
-
-      nProj = 0;
-      if(fDim>0) {
-         for(k=0; k<fDim; k++) {
-            xproj =fAlpha[k];
-            ((TH1D *)(*fHistEdg)[nProj])->Fill(xproj,wt);
-            nProj++;
+      EvalBatch(nBatch, xRands.data(), values.data());
+      fNCalls += nBatch;
+
+      for(Long_t ib=0; ib<nBatch; ib++){
+         wt=dx*values[ib];
+
+         nProj = 0;
+         if(fDim>0) {
+            for(k=0; k<fDim; k++) {
+               xproj =alphas[ib*fDim+k];
+               ((TH1D *)(*fHistEdg)[nProj])->Fill(xproj,wt);
+               nProj++;
+            }
+         }
+         //
+         iev++;
+         ceSum[0] += wt;    // sum of weights
+         ceSum[1] += wt*wt; // sum of weights squared
+         ceSum[2]++;        // sum of 1
+         if (ceSum[3]>wt) ceSum[3]=wt;  // minimum weight;
+         if (ceSum[4]<wt) ceSum[4]=wt;  // maximum weight
+         // test MC loop exit condition
+         nevEff = ceSum[0]*ceSum[0]/ceSum[1];
+         if( nevEff >= fNBin*fEvPerBin) {
+            mcExit=kTRUE;
+            break;
          }
       }
-      //
-      fNCalls++;
-      ceSum[0] += wt;    // sum of weights
-      ceSum[1] += wt*wt; // sum of weights squared
-      ceSum[2]++;        // sum of 1
-      if (ceSum[3]>wt) ceSum[3]=wt;  // minimum weight;
-      if (ceSum[4]<wt) ceSum[4]=wt;  // maximum weight
-      // test MC loop exit condition
-      nevEff = ceSum[0]*ceSum[0]/ceSum[1];
-      if( nevEff >= fNBin*fEvPerBin) break;
    }   // ||||||||||||||||||||||||||END MC LOOP|||||||||||||||||||||||||||||
    //------------------------------------------------------------------
    //---  predefine logics of searching for the best division edge ---
@@ -692,7 +723,6 @@ void TFoam::Explore(TFoamCell *cell)
       parent->SetDriv( parDriv   +intDriv -driOld );
    }
    delete [] volPart;
-   delete [] xRand;
    //cell->Print();
 } // TFoam::Explore
 
@@ -1106,18 +1136,47 @@ Double_t TFoam::Eval(Double_t *xRand)
    return result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Internal subprogram.
+/// Evaluates the distribution function at the n points of xRand, stored one
+/// after the other, into values. With SetOptMT(1) and the implicit
+/// multi-threading enabled, the points are evaluated concurrently: the
+/// integrand must then be thread-safe. The distribution functions of the
+/// interactive mode are always evaluated one point after the other.
+
+void TFoam::EvalBatch(Long_t n, Double_t *xRand, Double_t *values)
+{
+   auto eval = [&](Int_t i) { values[i] = Eval(xRand + (Long_t)i*fDim); };
+#ifdef R__USE_IMT
+   if (fOptMT == 1 && fRho && n > 1 && ROOT::IsImplicitMTEnabled()) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(eval, ROOT::TSeqI(n));
+      return;
+   }
+#endif
+   for (Long_t i = 0; i < n; i++) eval(i);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Internal subprogram.
 /// Return randomly chosen active cell with probability equal to its
 /// contribution into total driver integral using interpolation search.
 
 void TFoam::GenerCel2(TFoamCell *&pCell)
+{
+   pCell = (TFoamCell *) fCellsAct->At(FindActiveCell(fPseRan->Rndm()));
+}       // TFoam::GenerCel2
+
+////////////////////////////////////////////////////////////////////////////////
+/// Internal subprogram.
+/// Return the index in fCellsAct of the active cell at the cumulative
+/// probability random, using interpolation search.
+
+Long_t TFoam::FindActiveCell(Double_t random) const
 {
    Long_t  lo, hi, hit;
    Double_t fhit, flo, fhi;
-   Double_t random;
 
-   random=fPseRan->Rndm();
    lo  = 0;              hi =fNoAct-1;
    flo = fPrimAcu[lo];  fhi=fPrimAcu[hi];
    while(lo+1<hi) {
@@ -1136,10 +1195,10 @@ void TFoam::GenerCel2(TFoamCell *&pCell)
       }
    }
    if (fPrimAcu[lo]>random)
-      pCell = (TFoamCell *) fCellsAct->At(lo);
+      return lo;
    else
-      pCell = (TFoamCell *) fCellsAct->At(hi);
-}       // TFoam::GenerCel2
+      return hi;
+}       // TFoam::FindActiveCell
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1196,6 +1255,114 @@ ee0:
    //********************** MC LOOP ENDS HERE **********************
 } // MakeEvent
 
+////////////////////////////////////////////////////////////////////////////////
+/// User subprogram.
+/// It generates nEvents MC points/vectors as MakeEvent does and stores them
+/// one after the other into events, which holds nEvents*GetTotDim() values;
+/// their MC weights are stored into wt if it is given.
+/// The events are generated in streams of 1000 events, each stream using its
+/// own copy of the r.n. generator seeded from the user-defined generator.
+/// With SetOptMT(1) and the implicit multi-threading enabled the streams are
+/// generated concurrently: the integrand must then be thread-safe. The
+/// events and the statistics of the MC weights do not depend on the number
+/// of threads, but differ from the ones of a series of MakeEvent calls.
+/// The last generated event is available with GetMCvect and GetMCwt.
+
+void TFoam::MakeEvents(Long_t nEvents, Double_t *events, Double_t *wt)
+{
+   if(nEvents<1) return;
+   const Long_t kNEvStream = 1000;
+   Int_t j;
+   // geometry of the active cells, finding it takes a walk to the root cell
+   std::vector<Double_t> cellPosi(fNoAct*fDim), cellSize(fNoAct*fDim);
+   std::vector<Double_t> cellVolu(fNoAct), cellPrim(fNoAct);
+   TFoamVect  posi(fDim); TFoamVect  size(fDim);
+   for(Long_t iCell=0; iCell<fNoAct; iCell++) {
+      TFoamCell *cell = (TFoamCell *) fCellsAct->At(iCell);
+      cell->GetHcub(posi,size);
+      for(j=0; j<fDim; j++) {
+         cellPosi[iCell*fDim+j] = posi[j];
+         cellSize[iCell*fDim+j] = size[j];
+      }
+      cellVolu[iCell] = cell->GetVolume();
+      cellPrim[iCell] = cell->GetPrim();
+   }
+   std::vector<Double_t> wtBuffer;
+   if(!wt) {
+      wtBuffer.resize(nEvents);
+      wt = wtBuffer.data();
+   }
+   // the r.n. streams are seeded one after the other from the user generator
+   Int_t nStreams = (Int_t)((nEvents+kNEvStream-1)/kNEvStream);
+   std::vector<TRandom*> streams(nStreams);
+   for(Int_t is=0; is<nStreams; is++) {
+      streams[is] = (TRandom *) fPseRan->Clone();
+      streams[is]->SetSeed((ULong_t)fPseRan->Integer(kMaxUInt)+1);
+   }
+   std::vector<std::vector<Double_t> > mcwts(nStreams); // all the weights, rejected ones included
+   std::vector<Double_t> sumOve(nStreams,0.);
+
+   auto generate = [&](Int_t is) {
+      TRandom *pseRan = streams[is];
+      std::vector<Double_t> alpha(fDim);
+      Long_t last = TMath::Min(nEvents, (is+1)*kNEvStream);
+      for(Long_t iev=is*kNEvStream; iev<last; iev++) {
+         Double_t *x = events + iev*fDim;
+         Double_t mcwt;
+         while(1) {
+            Long_t iCell = FindActiveCell(pseRan->Rndm());  // choose randomly one cell
+            if(fDim>0) pseRan->RndmArray(fDim,alpha.data());
+            for(Int_t k=0; k<fDim; k++)
+               x[k] = cellPosi[iCell*fDim+k] +alpha[k]*cellSize[iCell*fDim+k];
+            mcwt = cellVolu[iCell]*Eval(x) / cellPrim[iCell];  // PRIMARY controls normalization
+            mcwts[is].push_back(mcwt);
+            if(fOptRej != 1) break;
+            //*******  Optional rejection ******
+            if(fMaxWtRej*pseRan->Rndm() > mcwt) continue;  // Wt=1 events, internal rejection
+            if(mcwt<fMaxWtRej) {
+               mcwt = 1.0;                      // normal Wt=1 event
+            } else {
+               mcwt = mcwt/fMaxWtRej;           // weight for overweighted events! kept for debug
+               sumOve[is] += mcwt-fMaxWtRej;   // contribution of overweighted
+            }
+            break;
+         }
+         wt[iev] = mcwt;
+      }
+   };
+
+   Bool_t done = kFALSE;
+#ifdef R__USE_IMT
+   if (fOptMT == 1 && fRho && nStreams > 1 && ROOT::IsImplicitMTEnabled()) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(generate, ROOT::TSeqI(nStreams));
+      done = kTRUE;
+   }
+#endif
+   if (!done) {
+      for(Int_t is=0; is<nStreams; is++) generate(is);
+   }
+
+   // accumulation of statistics for the main MC weight, in the order of the events
+   for(Int_t is=0; is<nStreams; is++) {
+      for(size_t i=0; i<mcwts[is].size(); i++) {
+         Double_t mcwt = mcwts[is][i];
+         fNCalls++;
+         fSumWt  += mcwt;           // sum of Wt
+         fSumWt2 += mcwt*mcwt;      // sum of Wt**2
+         fNevGen++;                 // sum of 1d0
+         fWtMax  =  TMath::Max(fWtMax, mcwt);   // maximum wt
+         fWtMin  =  TMath::Min(fWtMin, mcwt);   // minimum wt
+         fMCMonit->Fill(mcwt);
+         fHistWt->Fill(mcwt,1.0);          // histogram
+      }
+      fSumOve += sumOve[is];
+      delete streams[is];
+   }
+   for(j=0; j<fDim; j++) fMCvect[j] = events[(nEvents-1)*fDim+j];
+   fMCwt = wt[nEvents-1];
+} // MakeEvents
+
 ////////////////////////////////////////////////////////////////////////////////
 /// User may get generated MC point/vector with help of this method
 
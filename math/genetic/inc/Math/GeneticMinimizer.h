@@ -41,6 +41,7 @@ struct GeneticMinimizerParameters {
    Double_t fSC_factor;
    Double_t fConvCrit;
    Int_t fSeed;
+   Int_t fParallel;  // evaluate the population in parallel (the function must be thread safe)
 
 
    // constructor with default value
@@ -55,6 +56,10 @@ struct GeneticMinimizerParameters {
 
    Minimizer class based on the Gentic algorithm implemented in TMVA
 
+   With the option "Parallel" set to 1, the individuals of each generation are
+   evaluated concurrently in the implicit multi-threading pool: the function
+   to minimize must then be thread safe.
+
    @ingroup MultiMin
 */
 class GeneticMinimizer: public ROOT::Math::Minimizer {
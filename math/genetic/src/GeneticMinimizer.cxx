@@ -8,6 +8,7 @@
 
 #include "TError.h"
 
+#include <atomic>
 #include <cassert>
 
 namespace ROOT {
@@ -17,17 +18,23 @@ namespace Math {
 // wrapper class for TMVA interface to evaluate objective function
 class MultiGenFunctionFitness : public TMVA::IFitterTarget {
 private:
-   unsigned int fNCalls;
+   std::atomic<unsigned int> fNCalls;
    unsigned int fNFree;
+   bool fThreadSafe;
    const ROOT::Math::IMultiGenFunction& fFunc;
    std::vector<int> fFixedParFlag;
    mutable std::vector<double> fValues;
 
 public:
    MultiGenFunctionFitness(const ROOT::Math::IMultiGenFunction& function) : fNCalls(0),
+                                                                            fThreadSafe(false),
                                                                             fFunc(function)
    { fNFree = fFunc.NDim(); }
 
+   // declare the function thread safe, to evaluate the population in parallel
+   void SetThreadSafe(bool on) { fThreadSafe = on; }
+   Bool_t IsThreadSafe() const { return fThreadSafe; }
+
    unsigned int NCalls() const { return fNCalls; }
    unsigned int NDims() const { return fNFree; }
 
@@ -69,6 +76,13 @@ public:
    }
 
    Double_t Evaluate(const std::vector<double> & factors ) const {
+      if (fThreadSafe && fNFree != fValues.size() && !fValues.empty()) {
+         // fill a copy of the fixed values, fValues may be used by another thread
+         std::vector<double> x(fValues);
+         for (unsigned int i = 0, j = 0; i < x.size(); ++i)
+            if (!fFixedParFlag[i]) x[i] = factors[j++];
+         return fFunc(&x[0]);
+      }
       const std::vector<double> & x = Transform( factors);
       return fFunc(&x[0]);
    }
@@ -92,6 +106,7 @@ GeneticMinimizerParameters::GeneticMinimizerParameters()
    fConvCrit =10.0 * ROOT::Math::MinimizerOptions::DefaultTolerance(); // default is 0.001
    if (fConvCrit <=0 ) fConvCrit = 0.001;
    fSeed=0;  // random seed
+   fParallel=0;
 }
 
 // genetic minimizer class
@@ -211,6 +226,7 @@ void  GeneticMinimizer::GetGeneticOptions(ROOT::Math::MinimizerOptions & opt) co
    geneticOpt.SetValue("SC_factor",fParameters.fSC_factor);
    geneticOpt.SetValue("ConvCrit",fParameters.fConvCrit);
    geneticOpt.SetValue("RandomSeed",fParameters.fSeed);
+   geneticOpt.SetValue("Parallel",fParameters.fParallel);
 
    opt.SetExtraOptions(geneticOpt);
 }
@@ -240,6 +256,7 @@ void GeneticMinimizer::SetOptions(const ROOT::Math::MinimizerOptions & opt)
    geneticOpt->GetValue("SC_factor",fParameters.fSC_factor);
    geneticOpt->GetValue("ConvCrit",fParameters.fConvCrit);
    geneticOpt->GetValue("RandomSeed",fParameters.fSeed);
+   geneticOpt->GetValue("Parallel",fParameters.fParallel);
 
    // use same of options in base class
    int maxiter = opt.MaxIterations();
@@ -262,6 +279,7 @@ bool GeneticMinimizer::Minimize()
    if (MaxIterations() > 0) fParameters.fNsteps = MaxIterations();
    if (Tolerance() > 0) fParameters.fConvCrit = 10* Tolerance();
 
+   static_cast<MultiGenFunctionFitness*>(fFitness)->SetThreadSafe(fParameters.fParallel != 0);
    TMVA::GeneticAlgorithm mg( *fFitness, fParameters.fPopSize, fRanges, fParameters.fSeed );
 
    if (PrintLevel() > 0) {
@@ -0,0 +1,193 @@
+// @(#)root/mathcore:$Id$
+// Author: ROOT core team   October 2016
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2016 , LCG ROOT MathLib Team                         *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Header file for the classes PxPyPzEBatch and PtEtaPhiMBatch, collections
+// of Lorentz vectors in structure-of-arrays layout, and for the functions
+// computing the kinematics of all the vectors or pairs of vectors at once
+//
+#ifndef ROOT_Math_GenVector_LorentzVectorBatch
+#define ROOT_Math_GenVector_LorentzVectorBatch  1
+
+#include "Math/GenVector/LorentzVector.h"
+#include "Math/GenVector/PxPyPzE4D.h"
+#include "Math/GenVector/PtEtaPhiM4D.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace ROOT {
+
+namespace Math {
+
+class PtEtaPhiMBatch;
+
+//__________________________________________________________________________________________
+/**
+   Collection of Lorentz vectors in (px, py, pz, E) coordinates, stored in
+   structure-of-arrays layout: each coordinate of all the vectors is in a
+   contiguous array, so that the functions of VectorUtil working on
+   PxPyPzEBatch (InvariantMass, InvariantMassPairs, Boost) are vectorized by
+   the compiler.
+
+   @ingroup GenVector
+*/
+class PxPyPzEBatch {
+
+public:
+
+   PxPyPzEBatch() {}
+
+   /// n vectors, with all their coordinates 0
+   explicit PxPyPzEBatch(std::size_t n) : fPx(n), fPy(n), fPz(n), fE(n) {}
+
+   /// conversion of all the vectors of v
+   explicit PxPyPzEBatch(const PtEtaPhiMBatch &v);
+
+   std::size_t size() const { return fE.size(); }
+   void resize(std::size_t n) { fPx.resize(n); fPy.resize(n); fPz.resize(n); fE.resize(n); }
+   void reserve(std::size_t n) { fPx.reserve(n); fPy.reserve(n); fPz.reserve(n); fE.reserve(n); }
+   void clear() { resize(0); }
+
+   /// add a vector in any coordinate system
+   template <class CoordSystem>
+   void push_back(const LorentzVector<CoordSystem> &v) {
+      fPx.push_back(v.Px()); fPy.push_back(v.Py()); fPz.push_back(v.Pz()); fE.push_back(v.E());
+   }
+
+   /// vector i
+   LorentzVector<PxPyPzE4D<double> > operator[](std::size_t i) const {
+      return LorentzVector<PxPyPzE4D<double> >(fPx[i], fPy[i], fPz[i], fE[i]);
+   }
+
+   /// arrays of the coordinates of the size() vectors
+   const double *Px() const { return fPx.data(); }
+   const double *Py() const { return fPy.data(); }
+   const double *Pz() const { return fPz.data(); }
+   const double *E()  const { return fE.data(); }
+   double *Px() { return fPx.data(); }
+   double *Py() { return fPy.data(); }
+   double *Pz() { return fPz.data(); }
+   double *E()  { return fE.data(); }
+
+private:
+
+   std::vector<double> fPx;
+   std::vector<double> fPy;
+   std::vector<double> fPz;
+   std::vector<double> fE;
+};
+
+//__________________________________________________________________________________________
+/**
+   Collection of Lorentz vectors in (pt, eta, phi, M) coordinates, stored in
+   structure-of-arrays layout, as used by the VectorUtil::DeltaR functions
+   working on PtEtaPhiMBatch.
+
+   @ingroup GenVector
+*/
+class PtEtaPhiMBatch {
+
+public:
+
+   PtEtaPhiMBatch() {}
+
+   /// n vectors, with all their coordinates 0
+   explicit PtEtaPhiMBatch(std::size_t n) : fPt(n), fEta(n), fPhi(n), fM(n) {}
+
+   /// conversion of all the vectors of v
+   explicit PtEtaPhiMBatch(const PxPyPzEBatch &v);
+
+   std::size_t size() const { return fM.size(); }
+   void resize(std::size_t n) { fPt.resize(n); fEta.resize(n); fPhi.resize(n); fM.resize(n); }
+   void reserve(std::size_t n) { fPt.reserve(n); fEta.reserve(n); fPhi.reserve(n); fM.reserve(n); }
+   void clear() { resize(0); }
+
+   /// add a vector in any coordinate system
+   template <class CoordSystem>
+   void push_back(const LorentzVector<CoordSystem> &v) {
+      fPt.push_back(v.Pt()); fEta.push_back(v.Eta()); fPhi.push_back(v.Phi()); fM.push_back(v.M());
+   }
+
+   /// vector i
+   LorentzVector<PtEtaPhiM4D<double> > operator[](std::size_t i) const {
+      return LorentzVector<PtEtaPhiM4D<double> >(fPt[i], fEta[i], fPhi[i], fM[i]);
+   }
+
+   /// arrays of the coordinates of the size() vectors
+   const double *Pt()  const { return fPt.data(); }
+   const double *Eta() const { return fEta.data(); }
+   const double *Phi() const { return fPhi.data(); }
+   const double *M()   const { return fM.data(); }
+   double *Pt()  { return fPt.data(); }
+   double *Eta() { return fEta.data(); }
+   double *Phi() { return fPhi.data(); }
+   double *M()   { return fM.data(); }
+
+private:
+
+   std::vector<double> fPt;
+   std::vector<double> fEta;
+   std::vector<double> fPhi;
+   std::vector<double> fM;
+};
+
+namespace VectorUtil {
+
+   /**
+      Invariant masses of the sums v1[i] + v2[i], stored in mass[i], for the
+      v1.size() vectors (v2 must have the same size), as
+      InvariantMass(v1[i], v2[i])
+   */
+   void InvariantMass(const PxPyPzEBatch &v1, const PxPyPzEBatch &v2, double *mass);
+
+   /**
+      Invariant masses of all the pairs (i,j), i < j, of vectors of v, stored
+      in mass in the order (0,1), (0,2), ... (0,n-1), (1,2), ...: mass must
+      hold n*(n-1)/2 values
+   */
+   void InvariantMassPairs(const PxPyPzEBatch &v, double *mass);
+
+   /**
+      Invariant masses of the pairs (v1[i], v2[j]), stored in
+      mass[i*v2.size()+j]
+   */
+   void InvariantMassPairs(const PxPyPzEBatch &v1, const PxPyPzEBatch &v2, double *mass);
+
+   /**
+      DeltaR(v1[i], v2[i]), stored in dr[i], for the v1.size() vectors (v2 must
+      have the same size). The phi are supposed to be in (-pi, pi].
+   */
+   void DeltaR(const PtEtaPhiMBatch &v1, const PtEtaPhiMBatch &v2, double *dr);
+
+   /**
+      DeltaR of all the pairs (i,j), i < j, of vectors of v, stored in dr in
+      the same order as by InvariantMassPairs
+   */
+   void DeltaRPairs(const PtEtaPhiMBatch &v, double *dr);
+
+   /**
+      DeltaR of the pairs (v1[i], v2[j]), stored in dr[i*v2.size()+j]
+   */
+   void DeltaRPairs(const PtEtaPhiMBatch &v1, const PtEtaPhiMBatch &v2, double *dr);
+
+   /**
+      Boost all the vectors of v by the beta vector (bx, by, bz), as
+      boost(v[i], b)
+   */
+   void Boost(PxPyPzEBatch &v, double bx, double by, double bz);
+
+}  // end namespace VectorUtil
+
+}  // end namespace Math
+
+}  // end namespace ROOT
+
+
+#endif /* ROOT_Math_GenVector_LorentzVectorBatch  */
@@ -0,0 +1,11 @@
+// @(#)root/mathcore:$Id$
+// Author: ROOT core team   October 2016
+
+#ifndef ROOT_Math_LorentzVectorBatch
+#define ROOT_Math_LorentzVectorBatch
+
+
+#include "Math/GenVector/LorentzVectorBatch.h"
+
+
+#endif
@@ -0,0 +1,167 @@
+// @(#)root/mathcore:$Id$
+// Author: ROOT core team   October 2016
+
+ /**********************************************************************
+  *                                                                    *
+  * Copyright (c) 2016 , LCG ROOT MathLib Team                         *
+  *                                                                    *
+  *                                                                    *
+  **********************************************************************/
+
+// Implementation of the batch kinematics functions of VectorUtil
+//
+// The loops only use arithmetic operations, selections and square roots in
+// their inner loop on the vectors, so that the compiler vectorizes them; the
+// trigonometric functions are only needed in the conversions between the
+// coordinate systems, which are done once per vector.
+//
+#include "Math/GenVector/LorentzVectorBatch.h"
+#include "Math/GenVector/GenVector_exception.h"
+#include "Math/GenVector/eta.h"
+
+#include <cmath>
+
+namespace ROOT {
+
+namespace Math {
+
+namespace {
+
+// invariant mass of the sum of two vectors, as VectorUtil::InvariantMass
+inline double PairMass(double x1, double y1, double z1, double e1,
+                       double x2, double y2, double z2, double e2) {
+   const double ee = e1 + e2;
+   const double xx = x1 + x2;
+   const double yy = y1 + y2;
+   const double zz = z1 + z2;
+   const double mm2 = ee*ee - xx*xx - yy*yy - zz*zz;
+   const double m = std::sqrt(std::fabs(mm2));
+   return mm2 < 0.0 ? -m : m;
+}
+
+// DeltaR of two vectors, as VectorUtil::DeltaR for phi in (-pi, pi]
+inline double PairDeltaR(double eta1, double phi1, double eta2, double phi2) {
+   double dphi = phi2 - phi1;
+   dphi = dphi >   M_PI ? dphi - 2.0*M_PI : dphi;
+   dphi = dphi <= -M_PI ? dphi + 2.0*M_PI : dphi;
+   const double deta = eta2 - eta1;
+   return std::sqrt(dphi*dphi + deta*deta);
+}
+
+}
+
+PxPyPzEBatch::PxPyPzEBatch(const PtEtaPhiMBatch &v) : fPx(v.size()), fPy(v.size()), fPz(v.size()), fE(v.size()) {
+   // conversion as done by PtEtaPhiM4D
+   const double *pt = v.Pt(), *eta = v.Eta(), *phi = v.Phi(), *m = v.M();
+   const std::size_t n = v.size();
+   for (std::size_t i = 0; i < n; ++i) {
+      fPx[i] = pt[i]*std::cos(phi[i]);
+      fPy[i] = pt[i]*std::sin(phi[i]);
+   }
+   for (std::size_t i = 0; i < n; ++i) {
+      fPz[i] = pt[i] > 0 ? pt[i]*std::sinh(eta[i]) :
+               eta[i] == 0 ? 0 :
+               eta[i] > 0 ? eta[i] - etaMax<double>() :
+               eta[i] + etaMax<double>();
+      const double p2 = pt[i]*pt[i] + fPz[i]*fPz[i];
+      const double e2 = m[i] >= 0 ? p2 + m[i]*m[i] : p2 - m[i]*m[i];
+      fE[i] = std::sqrt(e2 > 0 ? e2 : 0.);
+   }
+}
+
+PtEtaPhiMBatch::PtEtaPhiMBatch(const PxPyPzEBatch &v) : fPt(v.size()), fEta(v.size()), fPhi(v.size()), fM(v.size()) {
+   // conversion as done by PxPyPzE4D
+   const double *px = v.Px(), *py = v.Py(), *pz = v.Pz(), *e = v.E();
+   const std::size_t n = v.size();
+   for (std::size_t i = 0; i < n; ++i) {
+      fPt[i] = std::sqrt(px[i]*px[i] + py[i]*py[i]);
+      const double mm = e[i]*e[i] - fPt[i]*fPt[i] - pz[i]*pz[i];
+      const double m = std::sqrt(std::fabs(mm));
+      fM[i] = mm < 0 ? -m : m;
+   }
+   for (std::size_t i = 0; i < n; ++i) {
+      fPhi[i] = (px[i] == 0.0 && py[i] == 0.0) ? 0 : std::atan2(py[i], px[i]);
+      fEta[i] = Impl::Eta_FromRhoZ(fPt[i], pz[i]);
+   }
+}
+
+void VectorUtil::InvariantMass(const PxPyPzEBatch &v1, const PxPyPzEBatch &v2, double *mass) {
+   const double *x1 = v1.Px(), *y1 = v1.Py(), *z1 = v1.Pz(), *e1 = v1.E();
+   const double *x2 = v2.Px(), *y2 = v2.Py(), *z2 = v2.Pz(), *e2 = v2.E();
+   const std::size_t n = v1.size();
+   for (std::size_t i = 0; i < n; ++i)
+      mass[i] = PairMass(x1[i], y1[i], z1[i], e1[i], x2[i], y2[i], z2[i], e2[i]);
+}
+
+void VectorUtil::InvariantMassPairs(const PxPyPzEBatch &v, double *mass) {
+   const double *x = v.Px(), *y = v.Py(), *z = v.Pz(), *e = v.E();
+   const std::size_t n = v.size();
+   for (std::size_t i = 0; i + 1 < n; ++i) {
+      for (std::size_t j = i + 1; j < n; ++j)
+         mass[j - i - 1] = PairMass(x[i], y[i], z[i], e[i], x[j], y[j], z[j], e[j]);
+      mass += n - i - 1;
+   }
+}
+
+void VectorUtil::InvariantMassPairs(const PxPyPzEBatch &v1, const PxPyPzEBatch &v2, double *mass) {
+   const double *x1 = v1.Px(), *y1 = v1.Py(), *z1 = v1.Pz(), *e1 = v1.E();
+   const double *x2 = v2.Px(), *y2 = v2.Py(), *z2 = v2.Pz(), *e2 = v2.E();
+   const std::size_t n1 = v1.size(), n2 = v2.size();
+   for (std::size_t i = 0; i < n1; ++i) {
+      for (std::size_t j = 0; j < n2; ++j)
+         mass[j] = PairMass(x1[i], y1[i], z1[i], e1[i], x2[j], y2[j], z2[j], e2[j]);
+      mass += n2;
+   }
+}
+
+void VectorUtil::DeltaR(const PtEtaPhiMBatch &v1, const PtEtaPhiMBatch &v2, double *dr) {
+   const double *eta1 = v1.Eta(), *phi1 = v1.Phi(), *eta2 = v2.Eta(), *phi2 = v2.Phi();
+   const std::size_t n = v1.size();
+   for (std::size_t i = 0; i < n; ++i)
+      dr[i] = PairDeltaR(eta1[i], phi1[i], eta2[i], phi2[i]);
+}
+
+void VectorUtil::DeltaRPairs(const PtEtaPhiMBatch &v, double *dr) {
+   const double *eta = v.Eta(), *phi = v.Phi();
+   const std::size_t n = v.size();
+   for (std::size_t i = 0; i + 1 < n; ++i) {
+      for (std::size_t j = i + 1; j < n; ++j)
+         dr[j - i - 1] = PairDeltaR(eta[i], phi[i], eta[j], phi[j]);
+      dr += n - i - 1;
+   }
+}
+
+void VectorUtil::DeltaRPairs(const PtEtaPhiMBatch &v1, const PtEtaPhiMBatch &v2, double *dr) {
+   const double *eta1 = v1.Eta(), *phi1 = v1.Phi(), *eta2 = v2.Eta(), *phi2 = v2.Phi();
+   const std::size_t n1 = v1.size(), n2 = v2.size();
+   for (std::size_t i = 0; i < n1; ++i) {
+      for (std::size_t j = 0; j < n2; ++j)
+         dr[j] = PairDeltaR(eta1[i], phi1[i], eta2[j], phi2[j]);
+      dr += n2;
+   }
+}
+
+void VectorUtil::Boost(PxPyPzEBatch &v, double bx, double by, double bz) {
+   // same formulas as VectorUtil::boost
+   const double b2 = bx*bx + by*by + bz*bz;
+   if (b2 >= 1) {
+      GenVector::Throw ( "Beta Vector supplied to set Boost represents speed >= c");
+      return;
+   }
+   const double gamma = 1.0 / std::sqrt(1.0 - b2);
+   const double gamma2 = b2 > 0 ? (gamma - 1.0)/b2 : 0.0;
+   double *x = v.Px(), *y = v.Py(), *z = v.Pz(), *t = v.E();
+   const std::size_t n = v.size();
+   for (std::size_t i = 0; i < n; ++i) {
+      const double bp = bx*x[i] + by*y[i] + bz*z[i];
+      const double x2 = x[i] + gamma2*bp*bx + gamma*bx*t[i];
+      const double y2 = y[i] + gamma2*bp*by + gamma*by*t[i];
+      const double z2 = z[i] + gamma2*bp*bz + gamma*bz*t[i];
+      const double t2 = gamma*(t[i] + bp);
+      x[i] = x2; y[i] = y2; z[i] = z2; t[i] = t2;
+   }
+}
+
+}  // namespace Math
+
+}  // namespace ROOT
@@ -23,6 +23,10 @@
 
 #include "Math/IParamFunctionfwd.h"
 
+#ifndef ROOT_Fit_FitExecutionPolicy
+#include "Fit/FitExecutionPolicy.h"
+#endif
+
 #include <memory>
 
 
@@ -57,7 +61,8 @@ protected:
    BasicFCN (const std::shared_ptr<DataType> & data, const std::shared_ptr<IModelFunction> & func) :
       BaseObjFunction(func->NPar(), data->Size() ),
       fData(data),
-      fFunc(func)
+      fFunc(func),
+      fExecutionPolicy(ROOT::Fit::ExecutionPolicy::kSerial)
    { }
 
 
@@ -82,6 +87,12 @@ public:
    /// access to function pointer 
    std::shared_ptr<IModelFunction> ModelFunctionPtr() const { return fFunc; }
 
+   /// policy for the evaluation of the function over the data points
+   ROOT::Fit::ExecutionPolicy ExecutionPolicy() const { return fExecutionPolicy; }
+
+   /// set the policy for the evaluation (the model function must be thread safe for kMultithread)
+   void SetExecutionPolicy(ROOT::Fit::ExecutionPolicy policy) { fExecutionPolicy = policy; }
+
    
 
 protected:
@@ -96,6 +107,7 @@ protected:
 
    std::shared_ptr<DataType>  fData;
    std::shared_ptr<IModelFunction>  fFunc;
+   ROOT::Fit::ExecutionPolicy fExecutionPolicy;
 
 
 
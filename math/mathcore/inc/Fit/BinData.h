@@ -230,6 +230,14 @@ public :
       return fDataWrapper->Coords(ipoint);
    }
 
+   /**
+      return the distance between the coordinates of two consecutive points when the data
+      are stored in this object, or 0 when they are accessed through a data wrapper
+    */
+   unsigned int CoordStride() const {
+      return (fDataVector) ? fPointSize : 0;
+   }
+
    /**
       return the value for the given fit point
     */
@@ -108,7 +108,9 @@ public:
       BaseFCN(f.DataPtr(), f.ModelFunctionPtr() ),
       fNEffPoints( f.fNEffPoints ),
       fGrad( f.fGrad)
-   {  }
+   {
+      this->SetExecutionPolicy(f.ExecutionPolicy() );
+   }
 
    /**
       Assignment operator
@@ -117,6 +119,7 @@ public:
       SetData(rhs.DataPtr() );
       SetModelFunction(rhs.ModelFunctionPtr() );
       fNEffPoints = rhs.fNEffPoints;
+      this->SetExecutionPolicy(rhs.ExecutionPolicy() );
       fGrad = rhs.fGrad; 
    }
 
@@ -165,7 +168,7 @@ private:
       return FitUtilParallel::EvaluateChi2(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fNEffPoints);
 #else
       if (!BaseFCN::Data().HaveCoordErrors() )
-         return FitUtil::EvaluateChi2(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fNEffPoints);
+         return FitUtil::EvaluateChi2(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fNEffPoints, this->ExecutionPolicy() );
       else
          return FitUtil::EvaluateChi2Effective(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fNEffPoints);
 #endif
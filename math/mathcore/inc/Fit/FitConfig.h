@@ -26,6 +26,10 @@
 #include "Math/IParamFunctionfwd.h"
 #endif
 
+#ifndef ROOT_Fit_FitExecutionPolicy
+#include "Fit/FitExecutionPolicy.h"
+#endif
+
 
 #include <vector>
 
@@ -182,6 +186,9 @@ public:
    ///Apply Weight correction for error matrix computation
    bool UseWeightCorrection() const { return fWeightCorr; }
 
+   ///policy for the evaluation of the objective function over the data points
+   ROOT::Fit::ExecutionPolicy ExecutionPolicy() const { return fExecutionPolicy; }
+
 
    /// return vector of parameter indeces for which the Minos Error will be computed
    const std::vector<unsigned int> & MinosParams() const { return fMinosParams; }
@@ -200,6 +207,9 @@ public:
    ///apply the weight correction for error matric computation
    void SetWeightCorrection(bool on = true) { fWeightCorr = on; }
 
+   ///evaluate the objective function serially (default) or in parallel (see ROOT::Fit::ExecutionPolicy)
+   void SetExecutionPolicy(ROOT::Fit::ExecutionPolicy policy) { fExecutionPolicy = policy; }
+
    /// set parameter indeces for running Minos
    /// this can be used for running Minos on a subset of parameters - otherwise is run on all of them
    /// if MinosErrors() is set
@@ -230,6 +240,7 @@ private:
    bool fMinosErrors;      // do full error analysis using Minos
    bool fUpdateAfterFit;   // update the configuration after a fit using the result
    bool fWeightCorr;       // apply correction to errors for weights fits
+   ROOT::Fit::ExecutionPolicy fExecutionPolicy; // policy for the evaluation of the objective functions
 
    std::vector<ROOT::Fit::ParameterSettings> fSettings;  // vector with the parameter settings
    std::vector<unsigned int> fMinosParams;               // vector with the parameter indeces for running Minos
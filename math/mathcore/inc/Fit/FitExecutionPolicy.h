@@ -0,0 +1,37 @@
+// @(#)root/mathcore:$Id$
+// Author: ROOT core team   October 2016
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2016  LCG ROOT Math Team, CERN/PH-SFT                *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Header file for the execution policies of the fit method functions
+
+#ifndef ROOT_Fit_FitExecutionPolicy
+#define ROOT_Fit_FitExecutionPolicy
+
+
+namespace ROOT {
+
+   namespace Fit {
+
+/**
+   Policy for the evaluation of the fit method functions over the data points:
+   kSerial evaluates them in the calling thread, kMultithread evaluates chunks of
+   points in parallel with the implicit multi-threading (see ROOT::EnableImplicitMT()),
+   if it is enabled; otherwise the points are evaluated serially. With kMultithread
+   the model function must be thread safe.
+
+   @ingroup FitMain
+*/
+enum class ExecutionPolicy { kSerial, kMultithread };
+
+   } // end namespace Fit
+
+} // end namespace ROOT
+
+
+#endif /* ROOT_Fit_FitExecutionPolicy */
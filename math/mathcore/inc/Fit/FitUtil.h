@@ -21,6 +21,10 @@
 #include "Fit/DataVectorfwd.h"
 #endif
 
+#ifndef ROOT_Fit_FitExecutionPolicy
+#include "Fit/FitExecutionPolicy.h"
+#endif
+
 
 namespace ROOT {
 
@@ -44,9 +48,12 @@ namespace FitUtil {
 
    /**
        evaluate the Chi2 given a model function and the data at the point x.
-       return also nPoints as the effective number of used points in the Chi2 evaluation
+       return also nPoints as the effective number of used points in the Chi2 evaluation.
+       The data points are evaluated in chunks according to executionPolicy; the sums of the
+       chunks are added with Kahan compensation, in the same order for any policy.
    */
-   double EvaluateChi2(const IModelFunction & func, const BinData & data, const double * x, unsigned int & nPoints);
+   double EvaluateChi2(const IModelFunction & func, const BinData & data, const double * x, unsigned int & nPoints,
+                       ExecutionPolicy executionPolicy = ExecutionPolicy::kSerial);
 
    /**
        evaluate the effective Chi2 given a model function and the data at the point x.
@@ -64,8 +71,10 @@ namespace FitUtil {
    /**
        evaluate the LogL given a model function and the data at the point x.
        return also nPoints as the effective number of used points in the LogL evaluation
+       (see EvaluateChi2 for executionPolicy)
    */
-   double EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints);
+   double EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints,
+                       ExecutionPolicy executionPolicy = ExecutionPolicy::kSerial);
 
    /**
        evaluate the LogL gradient given a model function and the data at the point x.
@@ -77,8 +86,10 @@ namespace FitUtil {
        evaluate the Poisson LogL given a model function and the data at the point x.
        return also nPoints as the effective number of used points in the LogL evaluation
        By default is extended, pass extedend to false if want to be not extended (MultiNomial)
+       (see EvaluateChi2 for executionPolicy)
    */
-   double EvaluatePoissonLogL(const IModelFunction & func, const BinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints);
+   double EvaluatePoissonLogL(const IModelFunction & func, const BinData & data, const double * x, int iWeight, bool extended, unsigned int & nPoints,
+                              ExecutionPolicy executionPolicy = ExecutionPolicy::kSerial);
 
    /**
        evaluate the Poisson LogL given a model function and the data at the point x.
@@ -100,7 +100,9 @@ public:
       fWeight( f.fWeight ),
       fNEffPoints( f.fNEffPoints ),
       fGrad( f.fGrad)
-   {  }
+   {
+      this->SetExecutionPolicy(f.ExecutionPolicy() );
+   }
 
 
    /**
@@ -110,6 +112,7 @@ public:
       SetData(rhs.DataPtr() );
       SetModelFunction(rhs.ModelFunctionPtr() );
       fNEffPoints = rhs.fNEffPoints;
+      this->SetExecutionPolicy(rhs.ExecutionPolicy() );
       fGrad = rhs.fGrad; 
       fIsExtended = rhs.fIsExtended;
       fWeight = rhs.fWeight; 
@@ -166,7 +169,7 @@ private:
 #ifdef ROOT_FIT_PARALLEL
       return FitUtilParallel::EvaluateLogL(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fNEffPoints);
 #else
-      return FitUtil::EvaluateLogL(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fWeight, fIsExtended, fNEffPoints);
+      return FitUtil::EvaluateLogL(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fWeight, fIsExtended, fNEffPoints, this->ExecutionPolicy() );
 #endif
    }
 
@@ -102,7 +102,9 @@ public:
       fWeight( f.fWeight ),
       fNEffPoints( f.fNEffPoints ),
       fGrad( f.fGrad)
-   {  }
+   {
+      this->SetExecutionPolicy(f.ExecutionPolicy() );
+   }
 
    /**
       Assignment operator
@@ -111,6 +113,7 @@ public:
       SetData(rhs.DataPtr() );
       SetModelFunction(rhs.ModelFunctionPtr() );
       fNEffPoints = rhs.fNEffPoints;
+      this->SetExecutionPolicy(rhs.ExecutionPolicy() );
       fGrad = rhs.fGrad; 
       fIsExtended = rhs.fIsExtended;
       fWeight = rhs.fWeight; 
@@ -165,7 +168,7 @@ private:
     */
    virtual double DoEval (const double * x) const {
       this->UpdateNCalls();
-      return FitUtil::EvaluatePoissonLogL(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fWeight, fIsExtended, fNEffPoints);
+      return FitUtil::EvaluatePoissonLogL(BaseFCN::ModelFunction(), BaseFCN::Data(), x, fWeight, fIsExtended, fNEffPoints, this->ExecutionPolicy() );
    }
 
    // for derivatives
@@ -71,6 +71,13 @@ namespace Math {
      2.Numerical integration usually works best for smooth functions.
        Some analysis or suitable transformations of the integral prior to
        numerical work may contribute to numerical efficiency.
+     3.All the nodes of the rule in a subregion (in the two halves of a divided
+       subregion) are evaluated with a single call to IMultiGenFunction::EvalN,
+       which the integrand can implement to compute many points together.
+       With SetParallel(true) the nodes are evaluated in parallel when the implicit
+       multi-threading is enabled (see ROOT::EnableImplicitMT()); the integrand must
+       then be thread safe. The nodes are summed in a fixed order, thus the result
+       does not depend on the number of threads.
 
    References:
 
@@ -161,6 +168,12 @@ public:
    ///set max points
    void SetMaxPts(unsigned int n) { fMaxPts = n; }
 
+   /// evaluate the integrand at the nodes of the rule in parallel (integrand must be thread safe)
+   void SetParallel(bool on = true) { fParallel = on; }
+
+   /// return true if the integrand is evaluated in parallel
+   bool IsParallel() const { return fParallel; }
+
    /// set the options
    void SetOptions(const ROOT::Math::IntegratorMultiDimOptions & opt);
 
@@ -186,6 +199,7 @@ protected:
    double fRelError;      // Relative error
    int    fNEval;        // number of function evaluation
    int fStatus;   // status of algorithm (error if not zero)
+   bool fParallel;  // evaluate the nodes of the rule in parallel
 
    const IMultiGenFunction* fFun;   // pointer to integrand function
 
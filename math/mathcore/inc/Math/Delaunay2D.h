@@ -94,9 +94,20 @@ public:
    /// set the input points for building the graph
    void SetInputPoints(int n, const double *x, const double * y, const double * z, double xmin=0, double xmax=0, double ymin=0, double ymax=0);
 
+   /// add the points n0 to n-1 of the arrays, which replace the previous ones and whose
+   /// n0 first points must be the points given before (n0 = NumberOfPoints())
+   void AddPoints(int n, const double *x, const double * y, const double * z);
+
+   /// return the number of input points
+   Int_t     NumberOfPoints() const {return fNpoints;}
+
    /// Return the Interpolated z value corresponding to the (x,y) point
    double  Interpolate(double x, double y);
 
+   /// Interpolate the z values of the n points (x[i],y[i]); the triangle of a point
+   /// is tried first for the next one, which is fast for points close to each other
+   void    Interpolate(int n, const double *x, const double *y, double *z);
+
    /// Find all triangles 
    void      FindAllTriangles();
 
@@ -135,8 +146,25 @@ private:
    /// use Triangle or CGAL if flag is set 
    void DoFindTriangles();
 
-   /// internal method to compute the interpolation
-   double  DoInterpolateNormalized(double x, double y);
+   /// internal method to compute the interpolation, starting from the triangle
+   /// lastTriangle (if not negative), which is set to the triangle found
+   double  DoInterpolateNormalized(double x, double y, int &lastTriangle);
+
+   /// interpolation of a point not normalized
+   double  DoInterpolate(double x, double y, int &lastTriangle);
+
+#ifndef HAS_CGAL
+   /// internal method to build the grid of cells used to find the triangles
+   void DoBuildGrid();
+
+   /// internal method to find the triangle containing the normalized point (x,y),
+   /// walking from the triangle start; return -1 outside of the convex hull
+   int     DoLocate(double x, double y, int start) const;
+
+   /// internal method to insert the normalized point i in the triangles;
+   /// return false if it lies outside of their convex hull
+   bool    DoInsertPoint(int i);
+#endif
 
 
    
@@ -265,13 +293,28 @@ protected:
 
    /* To speed up localisation of points a grid is layed over normalized space
     *
-    * A reference to triangle ABC is added to _all_ grid cells that include ABC's bounding box
+    * A reference to triangle ABC is added to _all_ grid cells that include ABC's bounding box.
+    * The number of cells grows with the number of triangles (about two triangles per cell),
+    * and the triangles of all the cells are stored in a single array: the ones of cell c
+    * are fCellTriangles[fCellStart[c]], ..., fCellTriangles[fCellStart[c+1]-1]
     */
 
-   static const int fNCells = 25; //! number of cells to divide the normalized space
+   int    fNCells;     //! number of cells to divide each axis of the normalized space
    double fXCellStep; //! inverse denominator to calculate X cell = fNCells / (fXNmax - fXNmin)
    double fYCellStep; //! inverse denominator to calculate X cell = fNCells / (fYNmax - fYNmin)
-   std::set<UInt_t> fCells[(fNCells+1)*(fNCells+1)]; //! grid cells with containing triangles
+   std::vector<UInt_t> fCellStart;     //! index in fCellTriangles of the first triangle of each cell
+   std::vector<UInt_t> fCellTriangles; //! triangles of the grid cells
+   int    fNGridTriangles; //! number of triangles when the grid was built
+
+   /* The points added by AddPoints are inserted in the triangles with the Bowyer-Watson
+    * algorithm: the triangles whose circumcircle contains the point are replaced by the
+    * triangles joining it to the edges of their union. The neighbor opposite to vertex v
+    * of triangle t is fNeighbors[3*t+v] (-1 on the convex hull), the vertices being
+    * counterclockwise. The new triangles are not added to the grid, whose triangles
+    * are a starting point to walk to the triangle of a point, until it is built again.
+    */
+
+   std::vector<int> fNeighbors; //! neighbors of the triangles
 
    inline unsigned int Cell(UInt_t x, UInt_t y) const {
 	   return x*(fNCells+1) + y;
@@ -93,6 +93,16 @@ namespace Math {
          return DoEval(x);
       }
 
+      /**
+         Evaluate the function at the n points whose coordinates start at x, x + stride,
+         x + 2*stride, ... and store the values in f.
+         Use the virtual private method DoEvalN, which derived classes can implement to
+         evaluate the points together
+      */
+      void EvalN(unsigned int n, const double * x, unsigned int stride, double * f) const {
+         DoEvalN(n, x, stride, f);
+      }
+
 #ifdef LATER
       /**
          Template method to eveluate the function using the begin of an iterator
@@ -113,6 +123,14 @@ namespace Math {
       */
       virtual double DoEval(const double * x) const = 0;
 
+      /**
+         Implementation of the evaluation at many points: by default DoEval is called for each point
+      */
+      virtual void DoEvalN(unsigned int n, const double * x, unsigned int stride, double * f) const {
+         for (unsigned int i = 0; i < n; ++i)
+            f[i] = DoEval(x + i * stride);
+      }
+
 
   };
 
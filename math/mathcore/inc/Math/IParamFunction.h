@@ -126,6 +126,16 @@ public:
       return DoEvalPar(x, p);
    }
 
+   /**
+      Evaluate the function for the parameters p at the n points whose coordinates start at
+      x, x + stride, x + 2*stride, ... and store the values in f.
+      Use the virtual function DoEvalParN, which derived classes can implement to evaluate
+      the points together
+   */
+   void EvalParN(unsigned int n, const double * x, unsigned int stride, const double * p, double * f) const {
+      DoEvalParN(n, x, stride, p, f);
+   }
+
    using BaseFunc::operator();
 
 
@@ -137,6 +147,14 @@ private:
    */
    virtual double DoEvalPar(const double * x, const double * p) const = 0;
 
+   /**
+      Implementation of the evaluation at many points: by default DoEvalPar is called for each point
+   */
+   virtual void DoEvalParN(unsigned int n, const double * x, unsigned int stride, const double * p, double * f) const {
+      for (unsigned int i = 0; i < n; ++i)
+         f[i] = DoEvalPar(x + i * stride, p);
+   }
+
    /**
       Implement the ROOT::Math::IBaseFunctionMultiDim interface DoEval(x) using the cached parameter values
    */
@@ -144,6 +162,13 @@ private:
       return DoEvalPar( x, Parameters() );
    }
 
+   /**
+      Implement the ROOT::Math::IBaseFunctionMultiDim interface DoEvalN using the cached parameter values
+   */
+   virtual void DoEvalN(unsigned int n, const double * x, unsigned int stride, double * f) const {
+      DoEvalParN(n, x, stride, Parameters(), f);
+   }
+
 };
 
 //___________________________________________________________________
@@ -50,6 +50,11 @@ namespace ROOT {
          }
          inline double operator() () { return Rndm_impl(); }
 
+         /// generate an array of random numbers
+         void RndmArray(int n, double * array) {
+            for (int i = 0; i < n; ++i) array[i] = Rndm_impl();
+         }
+
          uint32_t IntRndm() {
             fSeed = (1103515245 * fSeed + 12345) & 0x7fffffffUL;
             return fSeed; 
@@ -72,6 +72,9 @@ namespace ROOT {
          }
          inline double operator() () { return Rndm_impl(); }
 
+         /// generate an array of random numbers, the same as n calls to Rndm()
+         void RndmArray(int n, double * array);
+
          uint32_t IntRndm() {
             return IntRndm_impl();
          }
@@ -109,6 +112,7 @@ namespace ROOT {
 
          double Rndm_impl();
          uint32_t IntRndm_impl(); 
+         void Twist();
 
          enum { 
             kSize=624
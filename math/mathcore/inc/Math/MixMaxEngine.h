@@ -96,6 +96,9 @@ namespace ROOT {
 
          MixMaxEngine(uint64_t seed=1);
 
+         /// create the generator for the stream streamID of the seed (see SetSeed(seed, streamID))
+         MixMaxEngine(uint64_t seed, uint32_t streamID);
+
          virtual ~MixMaxEngine();
 
 
@@ -111,13 +114,21 @@ namespace ROOT {
          /// set the generator seed
          void  SetSeed(Result_t seed);
 
+         /// set the generator seed and the number of the stream. The streams of
+         /// different (seed, streamID) start at points of the sequence which are
+         /// far apart (skip of more than 10^100 numbers), so they do not overlap:
+         /// each thread of a parallel job can use its own stream, e.g. with the
+         /// index of the worker as streamID. SetSeed(seed) is the stream 0.
+         void  SetSeed(Result_t seed, uint32_t streamID);
+
          // generate a random number (virtual interface)
          virtual double Rndm() { return Rndm_impl(); }
 
          /// generate a double random number (faster interface)
          inline double operator() () { return Rndm_impl(); }
 
-         /// generate an array of random numbers
+         /// generate an array of random numbers. The numbers are the same as the
+         /// ones of n calls to Rndm(), but are converted in blocks of the state
          void RndmArray (int n, double * array);
 
          /// generate a 64  bit integer number
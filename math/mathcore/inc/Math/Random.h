@@ -65,7 +65,7 @@ namespace Math {
          Function to preserve ROOT Trandom compatibility
       */
       void RndmArray(int n, double * array) {
-         fEngine.RandomArray(array, array+n);
+         fEngine.RndmArray(n, array);
       }
 
       /**
@@ -50,6 +50,7 @@ public:
    Index   GetBucketSize() {return fBucketSize;}
 
    void    FindNearestNeighbors(const Value *point, Int_t k, Index *ind, Value *dist);
+   void    FindNearestNeighbors(Index npoints, const Value *points, Int_t k, Index *ind, Value *dist);
    Index   FindNode(const Value * point) const;
    void    FindPoint(Value * point, Index &index, Int_t &iter);
    void    FindInRange(Value *point, Value range, std::vector<Index> &res);
@@ -62,6 +63,7 @@ public:
 
    void    MakeBoundaries(Value *range = 0x0);
    void    MakeBoundariesExact();
+   void    MakeLeafData();
    void    SetData(Index npoints, Index ndim, UInt_t bsize, Value **data);
    Int_t   SetData(Index idim, Value *data);
    void    SetOwner(Int_t owner) { fDataOwner = owner; }
@@ -71,8 +73,12 @@ public:
    TKDTree(const TKDTree &); // not implemented
    TKDTree<Index, Value>& operator=(const TKDTree<Index, Value>&); // not implemented
    void CookBoundaries(const Int_t node, Bool_t left);
+   Int_t DivideNode(Int_t cnode, Int_t crow, Int_t cpos, Int_t npoints);
+   void BuildSubtree(Int_t node, Int_t row, Int_t pos, Int_t npoints);
 
    void UpdateNearestNeighbors(Index inode, const Value *point, Int_t kNN, Index *ind, Value *dist);
+   void UpdateNearestNeighborsBlock(Index inode, Int_t nq, const Int_t *q, const Value *points, Int_t kNN,
+                                    Index *ind, Value *dist, Int_t *work, Double_t *dwork);
    void UpdateRange(Index inode, Value *point, Value range, std::vector<Index> &res);
 
  protected:
@@ -89,6 +95,7 @@ public:
    Value   *fRange;     //[fNDimm] range of data for each dimension
    Value   **fData;     //! data points
    Value   *fBoundaries;//! nodes boundaries
+   Value   *fLeafData;  //! coordinates of the points in the order of fIndPoints, dimension by dimension
 
 
    Index   *fIndPoints; //! array of points indexes
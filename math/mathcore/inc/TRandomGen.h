@@ -47,7 +47,7 @@ public:
       for (int i = 0; i < n; ++i) array[i] = fEngine(); 
    }
    virtual  void     RndmArray(Int_t n, Double_t *array) {
-            for (int i = 0; i < n; ++i) array[i] = fEngine(); 
+      fEngine.RndmArray(n, array);
    }
    virtual  void     SetSeed(ULong_t seed=0) {
       fEngine.SetSeed(seed);
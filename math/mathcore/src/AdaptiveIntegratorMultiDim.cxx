@@ -6,12 +6,105 @@
 #include "Math/IntegratorOptions.h"
 #include "Math/Error.h"
 
+#include "TROOT.h"  // for ROOT::IsImplicitMTEnabled
+
 #include <cmath>
 #include <algorithm>
+#include <vector>
+
+#ifdef R__USE_IMT
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
 
 namespace ROOT {
 namespace Math {
 
+namespace {
+
+const double kXl2 = 0.358568582800318073;//lambda_2
+const double kXl4 = 0.948683298050513796;//lambda_4
+const double kXl5 = 0.688247201611685289;//lambda_5
+
+// minimal number of nodes evaluated by a thread
+const unsigned int kNodeGrain = 16;
+
+// store in x the coordinates of the 2^n +2*n*(n+1) +1 nodes of the rule in the region of
+// center ctr and half widths wth, in the order in which DoIntegral uses their values
+void FillRuleNodes(unsigned int n, const double *ctr, const double *wth, double *x)
+{
+   double z[15], wthl[15];
+   unsigned int j, j1, k, l, m;
+   for (j = 0; j < n; j++) z[j] = ctr[j];
+   std::copy(z, z+n, x); x += n;
+
+   for (j = 0; j < n; j++) {
+      z[j] = ctr[j] - kXl2*wth[j];
+      std::copy(z, z+n, x); x += n;
+      z[j] = ctr[j] + kXl2*wth[j];
+      std::copy(z, z+n, x); x += n;
+      wthl[j] = kXl4*wth[j];
+      z[j] = ctr[j] - wthl[j];
+      std::copy(z, z+n, x); x += n;
+      z[j] = ctr[j] + wthl[j];
+      std::copy(z, z+n, x); x += n;
+      z[j] = ctr[j];
+   }
+
+   for (j = 1; j < n; j++) {
+      j1 = j-1;
+      for (k = j; k < n; k++) {
+         for (l = 0; l < 2; l++) {
+            wthl[j1] = -wthl[j1];
+            z[j1]    = ctr[j1] + wthl[j1];
+            for (m = 0; m < 2; m++) {
+               wthl[k] = -wthl[k];
+               z[k]    = ctr[k] + wthl[k];
+               std::copy(z, z+n, x); x += n;
+            }
+         }
+         z[k] = ctr[k];
+      }
+      z[j1] = ctr[j1];
+   }
+
+   // end nodes ~gray codes
+   for (j = 0; j < n; j++) {
+      wthl[j] = -kXl5*wth[j];
+      z[j] = ctr[j] + wthl[j];
+   }
+   for (;;) {
+      std::copy(z, z+n, x); x += n;
+      for (j = 0; j < n; j++) {
+         wthl[j] = -wthl[j];
+         z[j] = ctr[j] + wthl[j];
+         if (wthl[j] > 0) break;
+      }
+      if (j == n) break;
+   }
+}
+
+// evaluate the function at the npts nodes of dimension n stored in x, in parallel if requested
+// and the implicit multi-threading is enabled
+void EvalRuleNodes(const IMultiGenFunction &f, unsigned int n, unsigned int npts, const double *x, double *fval,
+                   bool parallel)
+{
+#ifdef R__USE_IMT
+   if (parallel && npts >= 2*kNodeGrain && ROOT::IsImplicitMTEnabled()) {
+      tbb::parallel_for(tbb::blocked_range<unsigned int>(0, npts, kNodeGrain),
+                        [&](const tbb::blocked_range<unsigned int> &r) {
+                           f.EvalN(r.end() - r.begin(), x + r.begin() * n, n, fval + r.begin());
+                        });
+      return;
+   }
+#else
+   (void)parallel;
+#endif
+   f.EvalN(npts, x, n, fval);
+}
+
+} // end anonymous namespace
+
 
 
 AdaptiveIntegratorMultiDim::AdaptiveIntegratorMultiDim(double absTol, double relTol, unsigned int maxpts, unsigned int size):
@@ -25,6 +118,7 @@ AdaptiveIntegratorMultiDim::AdaptiveIntegratorMultiDim(double absTol, double rel
    fError(0), fRelError(0),
    fNEval(0),
    fStatus(-1),
+   fParallel(false),
    fFun(0)
 {
    // constructor - without passing a function
@@ -45,6 +139,7 @@ AdaptiveIntegratorMultiDim::AdaptiveIntegratorMultiDim( const IMultiGenFunction
    fError(0), fRelError(0),
    fNEval(0),
    fStatus(-1),
+   fParallel(false),
    fFun(&f)
 {
    // constructur passing a multi-dimensional function interface
@@ -96,11 +191,8 @@ double AdaptiveIntegratorMultiDim::DoIntegral(const double* xmin, const double *
    double relerr; //an estimation of the relative accuracy of the result
 
 
-   double ctr[15], wth[15], wthl[15], z[15];
+   double ctr[15], wth[15];
 
-   static const double xl2 = 0.358568582800318073;//lambda_2
-   static const double xl4 = 0.948683298050513796;//lambda_4
-   static const double xl5 = 0.688247201611685289;//lambda_5
    static const double w2  = 980./6561; //weights/2^n
    static const double w4  = 200./19683;
    static const double wp2 = 245./486;//error weights/2^n
@@ -180,17 +272,48 @@ double AdaptiveIntegratorMultiDim::DoIntegral(const double* xmin, const double *
    double rgnvol, sum1, sum2, sum3, sum4, sum5, difmax, f2, f3, dif, aresult;
    double rgncmp=0, rgnval, rgnerr;
 
-   unsigned int j1, k, l, m, idvaxn=0, idvax0=0, isbtmp, isbtpp;
+   unsigned int k, idvaxn=0, idvax0=0, isbtmp, isbtpp;
 
-   //InitArgs(z,fParams);
+   // coordinates and function values of the nodes of the rule. When a region is divided
+   // the nodes of its two halves are evaluated together
+   std::vector<double> xnodes(2*irlcls*n);
+   std::vector<double> fnodes(2*irlcls);
+   double *fv;
+   bool secondHalf = false;
 
 L20:
    rgnvol = twondm;//=2^n
    for (j=0; j<n; j++) {
       rgnvol *= wth[j]; //region volume
-      z[j]    = ctr[j]; //temporary node
    }
-   sum1 = (*fFun)((const double*)z);//EvalPar(z,fParams); //evaluate function
+
+   if (secondHalf) {
+      // the nodes of the second half were evaluated with the first one
+      fv = &fnodes[irlcls];
+      secondHalf = false;
+   }
+   else {
+      unsigned int npts = irlcls;
+      FillRuleNodes(n, ctr, wth, &xnodes[0]);
+      if (ldv) {
+         // the second half is centered at ctr[idvax0-1] + 2*wth[idvax0-1] (see below)
+         double ctr2[15];
+         std::copy(ctr, ctr+n, ctr2);
+         ctr2[idvax0-1] += 2*wth[idvax0-1];
+         FillRuleNodes(n, ctr2, wth, &xnodes[irlcls*n]);
+         npts = 2*irlcls;
+         secondHalf = true;
+      }
+      EvalRuleNodes(*fFun, n, npts, &xnodes[0], &fnodes[0], fParallel);
+      fv = &fnodes[0];
+   }
+
+   // the value at the center is not taken in absolute value, as in the original algorithm
+   sum1 = fv[0];
+   if (absValue) {
+      for (j=1; j<irlcls; j++) fv[j] = std::abs(fv[j]);
+   }
+   ++fv;
 
    difmax = 0;
    sum2   = 0;
@@ -198,19 +321,9 @@ L20:
 
    //loop over coordinates
    for (j=0; j<n; j++) {
-      z[j]    = ctr[j] - xl2*wth[j];
-      if (absValue) f2 = std::abs((*fFun)(z));
-      else          f2 = (*fFun)(z);
-      z[j]    = ctr[j] + xl2*wth[j];
-      if (absValue) f2 += std::abs((*fFun)(z));
-      else          f2 += (*fFun)(z);
-      wthl[j] = xl4*wth[j];
-      z[j]    = ctr[j] - wthl[j];
-      if (absValue) f3 = std::abs((*fFun)(z));
-      else          f3 = (*fFun)(z);
-      z[j]    = ctr[j] + wthl[j];
-      if (absValue) f3 += std::abs((*fFun)(z));
-      else          f3 += (*fFun)(z);
+      f2      = fv[0] + fv[1];
+      f3      = fv[2] + fv[3];
+      fv     += 4;
       sum2   += f2;//sum func eval with different weights separately
       sum3   += f3;//for a given region
       dif     = std::abs(7*f2-f3-12*sum1);
@@ -219,42 +332,14 @@ L20:
          difmax=dif;
          idvaxn=j+1;
       }
-      z[j]    = ctr[j];
    }
 
    sum4 = 0;
-   for (j=1;j<n;j++) {
-      j1 = j-1;
-      for (k=j;k<n;k++) {
-         for (l=0;l<2;l++) {
-            wthl[j1] = -wthl[j1];
-            z[j1]    = ctr[j1] + wthl[j1];
-            for (m=0;m<2;m++) {
-               wthl[k] = -wthl[k];
-               z[k]    = ctr[k] + wthl[k];
-               if (absValue) sum4 += std::abs((*fFun)(z));
-               else            sum4 += (*fFun)(z);
-            }
-         }
-         z[k] = ctr[k];
-      }
-      z[j1] = ctr[j1];
-   }
+   for (k=0; k<2*n*(n-1); k++) sum4 += *fv++;
 
+   //sum over end nodes ~gray codes
    sum5 = 0;
-
-   for (j=0;j<n;j++) {
-      wthl[j] = -xl5*wth[j];
-      z[j] = ctr[j] + wthl[j];
-   }
-L90: //sum over end nodes ~gray codes
-   if (absValue) sum5 += std::abs((*fFun)(z));
-   else          sum5 += (*fFun)(z);
-   for (j=0;j<n;j++) {
-      wthl[j] = -wthl[j];
-      z[j] = ctr[j] + wthl[j];
-      if (wthl[j] > 0) goto L90;
-   }
+   for (k=0; k<irlcls-2*n*(n+1)-1; k++) sum5 += *fv++;
 
    rgncmp  = rgnvol*(wpn1[n-2]*sum1+wp2*sum2+wpn3[n-2]*sum3+wp4*sum4);
    rgnval  = wn1[n-2]*sum1+w2*sum2+wn3[n-2]*sum3+w4*sum4+wn5[n-2]*sum5;
@@ -23,6 +23,7 @@
 #endif
 
 #include <algorithm>
+#include <cmath>
 #include <stdlib.h>
 
 namespace ROOT {
@@ -65,6 +66,17 @@ void Delaunay2D::SetInputPoints(int n, const double * x, const double * y, const
    fInit         = kFALSE;
 #endif
 
+   fX            = x;
+   fY            = y;
+   fZ            = z;
+   fNpoints      = n;
+   fNdt          = 0;
+   fTriangles.clear();
+#ifdef HAS_CGAL
+   fNormalizedPoints.clear();
+   fCGALdelaunay.clear();
+#endif
+
    if (n == 0 || !x || !y || !z ) return; 
 
    if (xmin >= xmax) {
@@ -94,9 +106,62 @@ void Delaunay2D::SetInputPoints(int n, const double * x, const double * y, const
 
 
 #ifndef HAS_CGAL
+   fNCells       = 0;
    fXCellStep    = 0.;
    fYCellStep    = 0.;
+   fNGridTriangles = 0;
+#endif
+}
+
+/// add the points n0 to n-1, n0 being the current number of points. When the triangles
+/// have been found, the points inside of their convex hull are inserted in them, in a
+/// time proportional to the number of triangles they change; otherwise the triangles
+/// are found again at the next interpolation
+void Delaunay2D::AddPoints(int n, const double * x, const double * y, const double * z) {
+
+#ifndef HAS_CGAL
+#ifdef THREAD_SAFE
+   bool init = (fInit == Initialization::INITIALIZED);
+#else
+   bool init = fInit;
 #endif
+   int n0 = fNpoints;
+   if (init && n0 > 0 && n >= n0 && fNdt > 0) {
+      fX       = x;
+      fY       = y;
+      fZ       = z;
+      fNpoints = n;
+      for (int i = n0; i < n; ++i) {
+         fXN.push_back(Linear_transform(fX[i], fOffsetX, fScaleFactorX));
+         fYN.push_back(Linear_transform(fY[i], fOffsetY, fScaleFactorY));
+         if (!DoInsertPoint(i)) {
+            // out of the convex hull: the normalization has to change
+            SetInputPoints(n, x, y, z);
+            return;
+         }
+      }
+      fNdt = fTriangles.size();
+      // the grid has to be built again when the triangles have doubled
+      if (fNdt > 2*fNGridTriangles) DoBuildGrid();
+      return;
+   }
+#endif
+   if (fNpoints == 0 || fScaleFactorX == 0 || fScaleFactorY == 0 || n < fNpoints) {
+      SetInputPoints(n, x, y, z);
+      return;
+   }
+   // extend the range of the previous points, without looping on them
+   double xmin = fXNmin/fScaleFactorX - fOffsetX;
+   double xmax = fXNmax/fScaleFactorX - fOffsetX;
+   double ymin = fYNmin/fScaleFactorY - fOffsetY;
+   double ymax = fYNmax/fScaleFactorY - fOffsetY;
+   for (int i = fNpoints; i < n; ++i) {
+      xmin = std::min(xmin, x[i]);
+      xmax = std::max(xmax, x[i]);
+      ymin = std::min(ymin, y[i]);
+      ymax = std::max(ymax, y[i]);
+   }
+   SetInputPoints(n, x, y, z, xmin, xmax, ymin, ymax);
 }
 
 //______________________________________________________________________________
@@ -110,15 +175,34 @@ double Delaunay2D::Interpolate(double x, double y)
    // needed in this function.
    FindAllTriangles();
 
+   int lastTriangle = -1;
+   return DoInterpolate(x, y, lastTriangle);
+}
+
+//______________________________________________________________________________
+void Delaunay2D::Interpolate(int n, const double *x, const double *y, double *z)
+{
+   // Return in z the z values corresponding to the n points (x[i],y[i])
+
+   FindAllTriangles();
+
+   int lastTriangle = -1;
+   for (int i = 0; i < n; ++i)
+      z[i] = DoInterpolate(x[i], y[i], lastTriangle);
+}
+
+//______________________________________________________________________________
+double Delaunay2D::DoInterpolate(double x, double y, int &lastTriangle)
+{
    // Find the z value corresponding to the point (x,y).
    double xx, yy;
    xx = Linear_transform(x, fOffsetX, fScaleFactorX); //xx = xTransformer(x);
    yy = Linear_transform(y, fOffsetY, fScaleFactorY); //yy = yTransformer(y);
-   double zz = DoInterpolateNormalized(xx, yy);
+   double zz = DoInterpolateNormalized(xx, yy, lastTriangle);
 
    // Wrong zeros may appear when points sit on a regular grid.
    // The following line try to avoid this problem.
-   if (zz==0) zz = DoInterpolateNormalized(xx+0.0001, yy);
+   if (zz==0) zz = DoInterpolateNormalized(xx+0.0001, yy, lastTriangle);
 
    return zz;
 }
@@ -206,7 +290,7 @@ void Delaunay2D::DoFindTriangles() {
 }
 
 /// CGAL implementation for interpolation
-double Delaunay2D::DoInterpolateNormalized(double xx, double yy)
+double Delaunay2D::DoInterpolateNormalized(double xx, double yy, int & /* lastTriangle */)
 {
    // Finds the Delaunay triangle that the point (xi,yi) sits in (if any) and
    // calculate a z-value for it by linearly interpolating the z-values that
@@ -241,14 +325,12 @@ double Delaunay2D::DoInterpolateNormalized(double xx, double yy)
 
 /// Triangle implementation for normalizing the points
 void Delaunay2D::DoNormalizePoints() {
+   fXN.clear();
+   fYN.clear();
    for (Int_t n = 0; n < fNpoints; n++) {
       fXN.push_back(Linear_transform(fX[n], fOffsetX, fScaleFactorX));
       fYN.push_back(Linear_transform(fY[n], fOffsetY, fScaleFactorY));
    }
-
-   //also initialize fXCellStep and FYCellStep
-   fXCellStep = fNCells / (fXNmax - fXNmin);
-   fYCellStep = fNCells / (fYNmax - fYNmin);
 }
 
 /// Triangle implementation for finding all the triangles 
@@ -320,25 +402,22 @@ void Delaunay2D::DoFindTriangles() {
       in.pointlist[2 * i + 1] = fYN[i];
    }
 
-   triangulate((char *) "zQN", &in, &out, nullptr);
+   // also get the neighbors of the triangles, for inserting points later
+   triangulate((char *) "zQNn", &in, &out, nullptr);
 
    fTriangles.resize(out.numberoftriangles);
+   fNeighbors.assign(out.neighborlist, out.neighborlist + 3*out.numberoftriangles);
    for(int t = 0; t < out.numberoftriangles; ++t){
       Triangle tri;
-
       auto transform = [&] (const unsigned int v) {
          //each triangle as numberofcorners vertices ( = 3)
          tri.idx[v] = out.trianglelist[t*out.numberofcorners + v];
-
          //printf("triangle %u vertex %u: point %u/%i\n", t, v, tri.idx[v], out.numberofpoints);
 
          //pointlist is [x0 y0 x1 y1 ...]
          tri.x[v] = in.pointlist[tri.idx[v] * 2 + 0];
-
          //printf("\t x: %f\n", tri.x[v]);
-
          tri.y[v] = in.pointlist[tri.idx[v] * 2 + 1];
-
          //printf("\t y: %f\n", tri.y[v]);
       };
 
@@ -350,32 +429,190 @@ void Delaunay2D::DoFindTriangles() {
       tri.invDenom = 1 / ( (tri.y[1] - tri.y[2])*(tri.x[0] - tri.x[2]) + (tri.x[2] - tri.x[1])*(tri.y[0] - tri.y[2]) );
 
       fTriangles[t] = tri;
+   }
+
+   freeStruct(in); freeStruct(out);
+
+   DoBuildGrid();
+}
 
+/// Triangle implementation for building the grid of cells
+void Delaunay2D::DoBuildGrid() {
+
+   const int ntri = fTriangles.size();
+   fNGridTriangles = ntri;
+
+   // size the grid for about two triangles per cell (fXCellStep and fYCellStep are
+   // needed by CellX and CellY)
+   fNCells = std::max(1, std::min(1000, int(std::sqrt(0.5 * ntri))));
+   fXCellStep = fNCells / (fXNmax - fXNmin);
+   fYCellStep = fNCells / (fYNmax - fYNmin);
+   const unsigned int nCells = (fNCells+1)*(fNCells+1);
+
+   // cells covered by the bounding box of each triangle: first count the triangles of
+   // each cell, then fill them
+   std::vector<unsigned int> cellRanges(4*ntri);
+   fCellStart.assign(nCells+1, 0);
+   for(int t = 0; t < ntri; ++t){
+      const Triangle &tri = fTriangles[t];
       auto bx = std::minmax({tri.x[0], tri.x[1], tri.x[2]});
       auto by = std::minmax({tri.y[0], tri.y[1], tri.y[2]});
 
-      unsigned int cellXmin = CellX(bx.first);
-      unsigned int cellXmax = CellX(bx.second);
-
-      unsigned int cellYmin = CellY(by.first);
-      unsigned int cellYmax = CellY(by.second);
+      unsigned int *range = &cellRanges[4*t];
+      range[0] = std::min(std::max(CellX(bx.first), 0), fNCells);
+      range[1] = std::min(std::max(CellX(bx.second), 0), fNCells);
+      range[2] = std::min(std::max(CellY(by.first), 0), fNCells);
+      range[3] = std::min(std::max(CellY(by.second), 0), fNCells);
 
-      for(unsigned int i = cellXmin; i <= cellXmax; ++i) {
-         for(unsigned int j = cellYmin; j <= cellYmax; ++j) {
+      for(unsigned int i = range[0]; i <= range[1]; ++i) {
+         for(unsigned int j = range[2]; j <= range[3]; ++j) {
+            ++fCellStart[Cell(i,j)+1];
+         }
+      }
+   }
+   for (unsigned int c = 0; c < nCells; ++c) fCellStart[c+1] += fCellStart[c];
+
+   fCellTriangles.resize(fCellStart[nCells]);
+   std::vector<UInt_t> cellFill(fCellStart.begin(), fCellStart.end()-1);
+   for(int t = 0; t < ntri; ++t){
+      const unsigned int *range = &cellRanges[4*t];
+      for(unsigned int i = range[0]; i <= range[1]; ++i) {
+         for(unsigned int j = range[2]; j <= range[3]; ++j) {
             //printf("(%u,%u) = %u\n", i, j, Cell(i,j));
-            fCells[Cell(i,j)].insert(t);
+            fCellTriangles[cellFill[Cell(i,j)]++] = t;
          }
       }
    }
+}
 
-   freeStruct(in); freeStruct(out);
+/// Triangle implementation for finding the triangle of a point: from the triangle
+/// start, cross the edges beyond which the point lies (the vertices being
+/// counterclockwise), which ends in a Delaunay triangulation
+int Delaunay2D::DoLocate(double xx, double yy, int start) const
+{
+   const int ntri = fTriangles.size();
+   int t = (start >= 0 && start < ntri) ? start : 0;
+   for (int step = 0; step <= ntri; ++step) {
+      const Triangle &tri = fTriangles[t];
+      int next = -2;
+      for (int k = 0; k < 3 && next == -2; ++k) {
+         // try the edges in turn, for not looping on degenerate configurations
+         int v = (k + step) % 3;
+         int a = (v + 1) % 3, b = (v + 2) % 3;
+         double orient = (tri.x[b] - tri.x[a])*(yy - tri.y[a]) - (tri.y[b] - tri.y[a])*(xx - tri.x[a]);
+         if (orient < 0) next = fNeighbors[3*t+v];
+      }
+      if (next == -2) return t;
+      if (next < 0) return -1;
+      t = next;
+   }
+   return -1;
+}
+
+/// Triangle implementation for inserting a point (Bowyer-Watson algorithm)
+bool Delaunay2D::DoInsertPoint(int ip)
+{
+   const double px = fXN[ip];
+   const double py = fYN[ip];
+
+   // start from a triangle of the cell of the point
+   int cX = CellX(px);
+   int cY = CellY(py);
+   if (cX < 0 || cX > fNCells || cY < 0 || cY > fNCells) return false;
+   const unsigned int cell = Cell(cX, cY);
+   int start = (fCellStart[cell] < fCellStart[cell+1]) ? int(fCellTriangles[fCellStart[cell]]) : 0;
+   int t0 = DoLocate(px, py, start);
+   if (t0 < 0) return false;
+
+   // points already there are ignored, as by Triangle
+   for (int v = 0; v < 3; ++v) {
+      if (fTriangles[t0].x[v] == px && fTriangles[t0].y[v] == py) return true;
+   }
+
+   // the triangles whose circumcircle contains the point, around the one containing it
+   auto inCircle = [&] (int t) -> bool {
+      const Triangle &tri = fTriangles[t];
+      double adx = tri.x[0] - px, ady = tri.y[0] - py;
+      double bdx = tri.x[1] - px, bdy = tri.y[1] - py;
+      double cdx = tri.x[2] - px, cdy = tri.y[2] - py;
+      return (adx*adx + ady*ady) * (bdx*cdy - cdx*bdy)
+           + (bdx*bdx + bdy*bdy) * (cdx*ady - adx*cdy)
+           + (cdx*cdx + cdy*cdy) * (adx*bdy - bdx*ady) > 0;
+   };
+   std::vector<int> cavity(1, t0);
+   for (unsigned int k = 0; k < cavity.size(); ++k) {
+      for (int v = 0; v < 3; ++v) {
+         int nb = fNeighbors[3*cavity[k]+v];
+         if (nb < 0 || std::find(cavity.begin(), cavity.end(), nb) != cavity.end()) continue;
+         if (inCircle(nb)) cavity.push_back(nb);
+      }
+   }
+
+   // edges of the cavity, counterclockwise, with the triangles beyond them
+   struct Edge { UInt_t a, b; int outer; };
+   std::vector<Edge> edges;
+   for (int c : cavity) {
+      const Triangle &tri = fTriangles[c];
+      for (int v = 0; v < 3; ++v) {
+         int nb = fNeighbors[3*c+v];
+         if (nb >= 0 && std::find(cavity.begin(), cavity.end(), nb) != cavity.end()) continue;
+         int a = (v + 1) % 3, b = (v + 2) % 3;
+         // the point has to be strictly inside, which fails on the convex hull
+         double orient = (tri.x[b] - tri.x[a])*(py - tri.y[a]) - (tri.y[b] - tri.y[a])*(px - tri.x[a]);
+         if (orient <= 0) return false;
+         edges.push_back({tri.idx[a], tri.idx[b], nb});
+      }
+   }
+   // a cavity with a hole cannot be triangulated as a star
+   if (edges.size() != cavity.size() + 2) return false;
+
+   // the triangles joining the point to the edges replace the cavity
+   std::vector<int> slots(cavity);
+   slots.push_back(fTriangles.size());
+   slots.push_back(fTriangles.size() + 1);
+   fTriangles.resize(fTriangles.size() + 2);
+   fNeighbors.resize(3*fTriangles.size());
+   auto slotFrom = [&] (UInt_t a) -> int {
+      for (unsigned int k = 0; k < edges.size(); ++k) if (edges[k].a == a) return slots[k];
+      return -1;
+   };
+   auto slotTo = [&] (UInt_t b) -> int {
+      for (unsigned int k = 0; k < edges.size(); ++k) if (edges[k].b == b) return slots[k];
+      return -1;
+   };
+   for (unsigned int k = 0; k < edges.size(); ++k) {
+      const Edge &e = edges[k];
+      const int s = slots[k];
+      Triangle tri;
+      tri.idx[0] = ip;
+      tri.idx[1] = e.a;
+      tri.idx[2] = e.b;
+      for (int v = 0; v < 3; ++v) {
+         tri.x[v] = fXN[tri.idx[v]];
+         tri.y[v] = fYN[tri.idx[v]];
+      }
+      tri.invDenom = 1 / ( (tri.y[1] - tri.y[2])*(tri.x[0] - tri.x[2]) + (tri.x[2] - tri.x[1])*(tri.y[0] - tri.y[2]) );
+      fTriangles[s] = tri;
+      // opposite to the point, beyond the edge; opposite to a, the triangle of the
+      // edge from b; opposite to b, the triangle of the edge to a
+      fNeighbors[3*s]   = e.outer;
+      fNeighbors[3*s+1] = slotFrom(e.b);
+      fNeighbors[3*s+2] = slotTo(e.a);
+      if (e.outer >= 0) {
+         const Triangle &outer = fTriangles[e.outer];
+         for (int v = 0; v < 3; ++v) {
+            if (outer.idx[v] != e.a && outer.idx[v] != e.b) fNeighbors[3*e.outer+v] = s;
+         }
+      }
+   }
+   return true;
 }
 
 /// Triangle implementation for interpolation
 /// Finds the Delaunay triangle that the point (xi,yi) sits in (if any) and
 /// calculate a z-value for it by linearly interpolating the z-values that
 /// make up that triangle.
-double Delaunay2D::DoInterpolateNormalized(double xx, double yy)
+double Delaunay2D::DoInterpolateNormalized(double xx, double yy, int &lastTriangle)
 {
 
    // relay that ll the triangles have been found
@@ -394,22 +631,44 @@ double Delaunay2D::DoInterpolateNormalized(double xx, double yy)
     auto inTriangle = [] (const std::tuple<double, double, double> & coords) -> bool {
        return std::get<0>(coords) >= 0 && std::get<1>(coords) >= 0 && std::get<2>(coords) >= 0;
     };
-    
+
+    auto interpolate = [&] (const unsigned int t, const std::tuple<double, double, double> & coords) -> double {
+       //barycentric interpolation
+       return std::get<0>(coords) * fZ[fTriangles[t].idx[0]]
+              + std::get<1>(coords) * fZ[fTriangles[t].idx[1]]
+              + std::get<2>(coords) * fZ[fTriangles[t].idx[2]];
+    };
+
+   // try first the triangle of the previous point
+   if (lastTriangle >= 0 && lastTriangle < fNdt) {
+      auto coords = bayCoords(lastTriangle);
+      if (inTriangle(coords)) return interpolate(lastTriangle, coords);
+   }
+
    int cX = CellX(xx);
    int cY = CellY(yy);
 
    if(cX < 0 || cX > fNCells || cY < 0 || cY > fNCells)
       return fZout; //TODO some more fancy interpolation here
 
-    for(unsigned int t : fCells[Cell(cX, cY)]){
+    const unsigned int cell = Cell(cX, cY);
+    for(unsigned int k = fCellStart[cell]; k < fCellStart[cell+1]; ++k){
+       unsigned int t = fCellTriangles[k];
        auto coords = bayCoords(t);
 
        if(inTriangle(coords)){
           //we found the triangle -> interpolate using the barycentric interpolation
-          return std::get<0>(coords) * fZ[fTriangles[t].idx[0]]
-                 + std::get<1>(coords) * fZ[fTriangles[t].idx[1]]
-               + std::get<2>(coords) * fZ[fTriangles[t].idx[2]];
+          lastTriangle = t;
+          return interpolate(t, coords);
+       }
+    }
 
+    // the triangles of inserted points are not in the grid
+    if (fNGridTriangles != fNdt) {
+       int t = DoLocate(xx, yy, (fCellStart[cell] < fCellStart[cell+1]) ? int(fCellTriangles[fCellStart[cell]]) : lastTriangle);
+       if (t >= 0) {
+          lastTriangle = t;
+          return interpolate(t, bayCoords(t));
        }
     }
 
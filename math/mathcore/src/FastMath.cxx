@@ -0,0 +1,61 @@
+// @(#)root/mathcore:$Id$
+// Author: ROOT core team   October 2016
+
+/**********************************************************************
+ *                                                                    *
+ * Copyright (c) 2016 , LCG ROOT MathLib Team                         *
+ *                                                                    *
+ *                                                                    *
+ **********************************************************************/
+
+// Array versions of the fast vectorizable functions of Math/FastMath.h
+
+#include "Math/FastMath.h"
+
+namespace ROOT {
+namespace Math {
+
+void fast_exp(unsigned int n, const double *x, double *result)
+{
+   for (unsigned int i = 0; i < n; ++i)
+      result[i] = fast_exp(x[i]);
+}
+
+void fast_log(unsigned int n, const double *x, double *result)
+{
+   for (unsigned int i = 0; i < n; ++i)
+      result[i] = fast_log(x[i]);
+}
+
+void fast_erf(unsigned int n, const double *x, double *result)
+{
+   for (unsigned int i = 0; i < n; ++i)
+      result[i] = fast_erf(x[i]);
+}
+
+void fast_erfc(unsigned int n, const double *x, double *result)
+{
+   for (unsigned int i = 0; i < n; ++i)
+      result[i] = fast_erfc(x[i]);
+}
+
+void fast_normal_pdf(unsigned int n, const double *x, double *result, double sigma, double x0)
+{
+   for (unsigned int i = 0; i < n; ++i)
+      result[i] = fast_normal_pdf(x[i], sigma, x0);
+}
+
+void fast_normal_cdf(unsigned int n, const double *x, double *result, double sigma, double x0)
+{
+   for (unsigned int i = 0; i < n; ++i)
+      result[i] = fast_normal_cdf(x[i], sigma, x0);
+}
+
+void fast_normal_cdf_c(unsigned int n, const double *x, double *result, double sigma, double x0)
+{
+   for (unsigned int i = 0; i < n; ++i)
+      result[i] = fast_normal_cdf_c(x[i], sigma, x0);
+}
+
+} // namespace Math
+} // namespace ROOT
@@ -32,8 +32,15 @@
 #include <cmath>
 #include <cassert>
 #include <algorithm>
+#include <vector>
 //#include <memory>
 
+#include "TROOT.h"  // for ROOT::IsImplicitMTEnabled
+
+#ifdef R__USE_IMT
+#include "tbb/parallel_for.h"
+#endif
+
 //#define DEBUG
 #ifdef DEBUG
 #define NSAMPLE 10
@@ -326,6 +333,81 @@ namespace ROOT {
          }
 
 
+         // number of data points evaluated together. The chunks are the same for all execution
+         // policies and their sums are added in order, so that the result does not depend on it
+         const unsigned int kChunkSize = 1024;
+
+         // sum with Kahan compensation of the rounding errors
+         class KahanSum {
+         public:
+            KahanSum() : fSum(0), fCompensation(0) {}
+            void Add(double x) {
+               double y = x - fCompensation;
+               double t = fSum + y;
+               fCompensation = (t - fSum) - y;
+               fSum = t;
+            }
+            double Sum() const { return fSum; }
+         private:
+            double fSum;
+            double fCompensation;
+         };
+
+         // result of the evaluation of a chunk of data points
+         struct ChunkResult {
+            ChunkResult() : fSum(0), fSumW(0), fSumW2(0), fNPoints(0) {}
+            double fSum;            // sum of the contributions of the points
+            double fSumW;           // sum of the weights (for the extended weighted likelihood)
+            double fSumW2;          // sum of the squares of the weights
+            unsigned int fNPoints;  // number of points used
+         };
+
+         // evaluate the n data points in chunks, calling evalChunk(begin, end) for each chunk in
+         // parallel if required and possible, and add the results of the chunks in order
+         template <class EvalChunk>
+         ChunkResult EvaluateChunks(unsigned int n, ExecutionPolicy executionPolicy, const EvalChunk & evalChunk) {
+            unsigned int nChunks = (n + kChunkSize - 1) / kChunkSize;
+            std::vector<ChunkResult> results(nChunks);
+#ifdef R__USE_IMT
+            if (executionPolicy == ExecutionPolicy::kMultithread && nChunks > 1 && ROOT::IsImplicitMTEnabled()) {
+               tbb::parallel_for(0u, nChunks, [&](unsigned int ic) {
+                  results[ic] = evalChunk(ic * kChunkSize, std::min(n, (ic + 1) * kChunkSize));
+               });
+            }
+            else
+#else
+            (void) executionPolicy;
+#endif
+            {
+               for (unsigned int ic = 0; ic < nChunks; ++ic)
+                  results[ic] = evalChunk(ic * kChunkSize, std::min(n, (ic + 1) * kChunkSize));
+            }
+            ChunkResult total;
+            KahanSum sum, sumW, sumW2;
+            for (unsigned int ic = 0; ic < nChunks; ++ic) {
+               sum.Add(results[ic].fSum);
+               sumW.Add(results[ic].fSumW);
+               sumW2.Add(results[ic].fSumW2);
+               total.fNPoints += results[ic].fNPoints;
+            }
+            total.fSum = sum.Sum();
+            total.fSumW = sumW.Sum();
+            total.fSumW2 = sumW2.Sum();
+            return total;
+         }
+
+         // evaluate the model function at the data points [begin, end) with a single call, if
+         // the coordinates are stored in the data with a constant stride
+         template <class Data>
+         bool EvaluateModelN(const IModelFunction & func, const Data & data, const double * p,
+                             unsigned int begin, unsigned int end, std::vector<double> & fvals) {
+            unsigned int stride = data.CoordStride();
+            if (stride == 0 || begin == end) return false;
+            fvals.resize(end - begin);
+            func.EvalParN(end - begin, data.Coords(begin), stride, p, fvals.data());
+            return true;
+         }
+
 
       } // end namespace  FitUtil
 
@@ -335,7 +417,8 @@ namespace ROOT {
 // for chi2 functions
 //___________________________________________________________________________________________________________________________
 
-double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data, const double * p, unsigned int & nPoints) {
+double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data, const double * p, unsigned int & nPoints,
+                             ExecutionPolicy executionPolicy) {
    // evaluate the chi2 given a  function reference  , the data and returns the value and also in nPoints
    // the actual number of used points
    // normal chi2 using only error on values (from fitting histogram)
@@ -343,7 +426,6 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
 
    unsigned int n = data.Size();
 
-   double chi2 = 0;
    nPoints = 0; // count the effective non-zero points
    // set parameters of the function to cache integral value
 #ifdef USE_PARAMCACHE
@@ -367,97 +449,113 @@ double FitUtil::EvaluateChi2(const IModelFunction & func, const BinData & data,
    std::cout << "use all error=1 " << fitOpt.fErrors1 << std::endl;
 #endif
 
-#ifdef USE_PARAMCACHE
-   IntegralEvaluator<> igEval( func, 0, useBinIntegral); 
-#else
-   IntegralEvaluator<> igEval( func, p, useBinIntegral); 
-#endif
    double maxResValue = std::numeric_limits<double>::max() /n;
    double wrefVolume = 1.0;
-   std::vector<double> xc;
    if (useBinVolume) {
       if (fitOpt.fNormBinVolume) wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
    }
 
    (const_cast<IModelFunction &>(func)).SetParameters(p);
-   for (unsigned int i = 0; i < n; ++ i) {
 
-      double y = 0, invError = 1.;
+   // evaluate the points [begin, end)
+   auto evalChunk = [&](unsigned int begin, unsigned int end) {
+#ifdef USE_PARAMCACHE
+      IntegralEvaluator<> igEval( func, 0, useBinIntegral); 
+#else
+      IntegralEvaluator<> igEval( func, p, useBinIntegral); 
+#endif
+      std::vector<double> xc;
+      if (useBinVolume) xc.resize(data.NDim() );
+      std::vector<double> fvals;
+      bool useFvals = !useBinIntegral && !useBinVolume && EvaluateModelN(func, data, p, begin, end, fvals);
+      ChunkResult result;
+      KahanSum chi2;
 
-      // in case of no error in y invError=1 is returned
-      const double * x1 = data.GetPoint(i,y, invError);
+      for (unsigned int i = begin; i < end; ++ i) {
 
-      double fval = 0;
+         double y = 0, invError = 1.;
 
-      double binVolume = 1.0;
-        if (useBinVolume) {
-         unsigned int ndim = data.NDim();
-         const double * x2 = data.BinUpEdge(i);
-         for (unsigned int j = 0; j < ndim; ++j) {
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
+         // in case of no error in y invError=1 is returned
+         const double * x1 = data.GetPoint(i,y, invError);
+
+         double fval = 0;
+
+         double binVolume = 1.0;
+         if (useBinVolume) {
+            unsigned int ndim = data.NDim();
+            const double * x2 = data.BinUpEdge(i);
+            for (unsigned int j = 0; j < ndim; ++j) {
+               binVolume *= std::abs( x2[j]-x1[j] );
+               xc[j] = 0.5*(x2[j]+ x1[j]);
+            }
+            // normalize the bin volume using a reference value
+            binVolume *= wrefVolume;
          }
-         // normalize the bin volume using a reference value
-         binVolume *= wrefVolume;
-      }
 
-      const double * x = (useBinVolume) ? &xc.front() : x1;
+         const double * x = (useBinVolume) ? &xc.front() : x1;
 
-      if (!useBinIntegral) {
+         if (useFvals) {
+            fval = fvals[i - begin];
+         }
+         else if (!useBinIntegral) {
 #ifdef USE_PARAMCACHE
-         fval = func ( x );
+            fval = func ( x );
 #else
-         fval = func ( x, p );
+            fval = func ( x, p );
 #endif
-      }
-      else {
-         // calculate integral normalized by bin volume
-         // need to set function and parameters here in case loop is parallelized
-         fval = igEval( x1, data.BinUpEdge(i)) ;
-      }
-      // normalize result if requested according to bin volume
-      if (useBinVolume) fval *= binVolume;
-
-      // expected errors
-      if (useExpErrors) {
-         // we need first to check if a weight factor needs to be applied
-         // weight = sumw2/sumw = error**2/content
-         double invWeight = y * invError * invError;
-         if (invError == 0) invWeight = (data.SumOfError2() > 0) ? data.SumOfContent()/ data.SumOfError2() : 1.0;
-         // compute expected error  as f(x) / weight
-         double invError2 = (fval > 0) ? invWeight / fval : 0.0;
-         invError = std::sqrt(invError2);
-      }
+         }
+         else {
+            // calculate integral normalized by bin volume
+            // need to set function and parameters here in case loop is parallelized
+            fval = igEval( x1, data.BinUpEdge(i)) ;
+         }
+         // normalize result if requested according to bin volume
+         if (useBinVolume) fval *= binVolume;
+
+         // expected errors
+         if (useExpErrors) {
+            // we need first to check if a weight factor needs to be applied
+            // weight = sumw2/sumw = error**2/content
+            double invWeight = y * invError * invError;
+            if (invError == 0) invWeight = (data.SumOfError2() > 0) ? data.SumOfContent()/ data.SumOfError2() : 1.0;
+            // compute expected error  as f(x) / weight
+            double invError2 = (fval > 0) ? invWeight / fval : 0.0;
+            invError = std::sqrt(invError2);
+         }
 
-//#define DEBUG
+   //#define DEBUG
 #ifdef DEBUG
-      std::cout << x[0] << "  " << y << "  " << 1./invError << " params : ";
-      for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
-         std::cout << p[ipar] << "\t";
-      std::cout << "\tfval = " << fval << " bin volume " << binVolume << " ref " << wrefVolume << std::endl;
+         std::cout << x[0] << "  " << y << "  " << 1./invError << " params : ";
+         for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
+            std::cout << p[ipar] << "\t";
+         std::cout << "\tfval = " << fval << " bin volume " << binVolume << " ref " << wrefVolume << std::endl;
 #endif
-//#undef DEBUG
+   //#undef DEBUG
 
 
-      if (invError > 0) {
-         nPoints++;
+         if (invError > 0) {
+            result.fNPoints++;
 
-         double tmp = ( y -fval )* invError;
-         double resval = tmp * tmp;
+            double tmp = ( y -fval )* invError;
+            double resval = tmp * tmp;
 
 
-         // avoid inifinity or nan in chi2 values due to wrong function values
-         if ( resval < maxResValue )
-            chi2 += resval;
-         else {
-            //nRejected++;
-            chi2 += maxResValue;
+            // avoid inifinity or nan in chi2 values due to wrong function values
+            if ( resval < maxResValue )
+               chi2.Add(resval);
+            else {
+               //nRejected++;
+               chi2.Add(maxResValue);
+            }
          }
-      }
 
 
-   }
+      }
+      result.fSum = chi2.Sum();
+      return result;
+   };
+
+   double chi2 = EvaluateChunks(n, executionPolicy, evalChunk).fSum;
    nPoints=n;
 
 #ifdef DEBUG
@@ -891,7 +989,8 @@ double FitUtil::EvaluatePdf(const IModelFunction & func, const UnBinData & data,
 }
 
 double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data, const double * p,
-                                   int iWeight,  bool extended, unsigned int &nPoints) {
+                                   int iWeight,  bool extended, unsigned int &nPoints,
+                                   ExecutionPolicy executionPolicy) {
    // evaluate the LogLikelihood
 
    unsigned int n = data.Size();
@@ -901,7 +1000,6 @@ double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data
    std::cout << "func pointer is " << typeid(func).name() << std::endl;
 #endif
 
-   double logl = 0;
    //unsigned int nRejected = 0;
 
    // set parameters of the function to cache integral value
@@ -936,48 +1034,68 @@ double FitUtil::EvaluateLogL(const IModelFunction & func, const UnBinData & data
       }
    }
 
-   // needed to compue effective global weight in case of extended likelihood
-   double sumW = 0;
-   double sumW2 = 0;
-
-   for (unsigned int i = 0; i < n; ++ i) {
-      const double * x = data.Coords(i);
+   // evaluate the points [begin, end)
+   auto evalChunk = [&](unsigned int begin, unsigned int end) {
+      std::vector<double> fvals;
+      bool useFvals = EvaluateModelN(func, data, p, begin, end, fvals);
+      ChunkResult result;
+      KahanSum logl;
+      // needed to compue effective global weight in case of extended likelihood
+      double sumW = 0;
+      double sumW2 = 0;
+
+      for (unsigned int i = begin; i < end; ++ i) {
+         const double * x = data.Coords(i);
+         double fval;
+         if (useFvals)
+            fval = fvals[i - begin];
+         else
 #ifdef USE_PARAMCACHE
-       double fval = func ( x );
+            fval = func ( x );
 #else
-       double fval = func ( x, p );
+            fval = func ( x, p );
 #endif
-      if (normalizeFunc) fval = fval / norm;
+         if (normalizeFunc) fval = fval / norm;
 
 #ifdef DEBUG
-      if (i == 0) { 
-         std::cout << "x [ " << data.NDim() << " ] = ";
-         for (unsigned int j = 0; j < data.NDim(); ++j)
-            std::cout << x[j] << "\t";
-         std::cout << "\tpar = [ " << func.NPar() << " ] =  ";
-         for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
-            std::cout << p[ipar] << "\t";
-         std::cout << "\tfval = " << fval << std::endl;
-      } else {
-         std::cout << ".";
-      }
+         if (i == 0) { 
+            std::cout << "x [ " << data.NDim() << " ] = ";
+            for (unsigned int j = 0; j < data.NDim(); ++j)
+               std::cout << x[j] << "\t";
+            std::cout << "\tpar = [ " << func.NPar() << " ] =  ";
+            for (unsigned int ipar = 0; ipar < func.NPar(); ++ipar)
+               std::cout << p[ipar] << "\t";
+            std::cout << "\tfval = " << fval << std::endl;
+         } else {
+            std::cout << ".";
+         }
 #endif
-      // function EvalLog protects against negative or too small values of fval
-      double logval =  ROOT::Math::Util::EvalLog( fval);
-      if (iWeight > 0) {
-         double weight = data.Weight(i);
-         logval *= weight;
-         if (iWeight ==2) {
-            logval *= weight; // use square of weights in likelihood
-            if (extended) {
-               // needed sum of weights and sum of weight square if likelkihood is extended
-               sumW += weight;
-               sumW2 += weight*weight;
+         // function EvalLog protects against negative or too small values of fval
+         double logval =  ROOT::Math::Util::EvalLog( fval);
+         if (iWeight > 0) {
+            double weight = data.Weight(i);
+            logval *= weight;
+            if (iWeight ==2) {
+               logval *= weight; // use square of weights in likelihood
+               if (extended) {
+                  // needed sum of weights and sum of weight square if likelkihood is extended
+                  sumW += weight;
+                  sumW2 += weight*weight;
+               }
             }
          }
+         logl.Add(logval);
       }
-      logl += logval;
-   }
+      result.fSum = logl.Sum();
+      result.fSumW = sumW;
+      result.fSumW2 = sumW2;
+      return result;
+   };
+
+   ChunkResult total = EvaluateChunks(n, executionPolicy, evalChunk);
+   double logl = total.fSum;
+   double sumW = total.fSumW;
+   double sumW2 = total.fSumW2;
 
 #ifdef DEBUG
    std::cout << std::endl;
@@ -1207,7 +1325,8 @@ double FitUtil::EvaluatePoissonBinPdf(const IModelFunction & func, const BinData
 }
 
 double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData & data,
-                                    const double * p, int iWeight, bool extended,  unsigned int &   nPoints ) {
+                                    const double * p, int iWeight, bool extended,  unsigned int &   nPoints,
+                                    ExecutionPolicy executionPolicy) {
    // evaluate the Poisson Log Likelihood
    // for binned likelihood fits
    // this is Sum ( f(x_i)  -  y_i * log( f (x_i) ) )
@@ -1231,7 +1350,6 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
    (const_cast<IModelFunction &>(func)).SetParameters(p);
 #endif
    
-   double nloglike = 0;  // negative loglikelihood 
    nPoints = 0;  // npoints
 
 
@@ -1243,10 +1361,8 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
    
    // normalize if needed by a reference volume value
    double wrefVolume = 1.0;
-   std::vector<double> xc;
    if (useBinVolume) {
       if (fitOpt.fNormBinVolume) wrefVolume /= data.RefVolume();
-      xc.resize(data.NDim() );
    }
 
 #ifdef DEBUG
@@ -1256,112 +1372,130 @@ double FitUtil::EvaluatePoissonLogL(const IModelFunction & func, const BinData &
              << useBinVolume << " useW2 " << useW2 << " wrefVolume = " << wrefVolume << std::endl;
 #endif
 
-#ifdef USE_PARAMCACHE
-   IntegralEvaluator<> igEval( func, 0, useBinIntegral); 
-#else
-   IntegralEvaluator<> igEval( func, p, useBinIntegral); 
-#endif
    // double nuTot = 0; // total number of expected events (needed for non-extended fits)
    // double wTot = 0; // sum of all weights
    // double w2Tot = 0; // sum of weight squared  (these are needed for useW2)
 
-
-   for (unsigned int i = 0; i < n; ++ i) {
-      const double * x1 = data.Coords(i);
-      double y = data.Value(i);
-
-      double fval = 0;
-      double binVolume = 1.0;
-
-      if (useBinVolume) {
-         unsigned int ndim = data.NDim();
-         const double * x2 = data.BinUpEdge(i);
-         for (unsigned int j = 0; j < ndim; ++j) {
-            binVolume *= std::abs( x2[j]-x1[j] );
-            xc[j] = 0.5*(x2[j]+ x1[j]);
+   // evaluate the points [begin, end)
+   auto evalChunk = [&](unsigned int begin, unsigned int end) {
+#ifdef USE_PARAMCACHE
+      IntegralEvaluator<> igEval( func, 0, useBinIntegral); 
+#else
+      IntegralEvaluator<> igEval( func, p, useBinIntegral); 
+#endif
+      std::vector<double> xc;
+      if (useBinVolume) xc.resize(data.NDim() );
+      std::vector<double> fvals;
+      bool useFvals = !useBinIntegral && !useBinVolume && EvaluateModelN(func, data, p, begin, end, fvals);
+      ChunkResult result;
+      KahanSum nloglike;  // negative loglikelihood
+
+      for (unsigned int i = begin; i < end; ++ i) {
+         const double * x1 = data.Coords(i);
+         double y = data.Value(i);
+
+         double fval = 0;
+         double binVolume = 1.0;
+
+         if (useBinVolume) {
+            unsigned int ndim = data.NDim();
+            const double * x2 = data.BinUpEdge(i);
+            for (unsigned int j = 0; j < ndim; ++j) {
+               binVolume *= std::abs( x2[j]-x1[j] );
+               xc[j] = 0.5*(x2[j]+ x1[j]);
+            }
+            // normalize the bin volume using a reference value
+            binVolume *= wrefVolume;
          }
-         // normalize the bin volume using a reference value
-         binVolume *= wrefVolume;
-      }
 
-      const double * x = (useBinVolume) ? &xc.front() : x1;
+         const double * x = (useBinVolume) ? &xc.front() : x1;
 
-      if (!useBinIntegral) {
+         if (useFvals) {
+            fval = fvals[i - begin];
+         }
+         else if (!useBinIntegral) {
 #ifdef USE_PARAMCACHE
-         fval = func ( x );
+            fval = func ( x );
 #else
-         fval = func ( x, p );
+            fval = func ( x, p );
 #endif
-      }
-      else {
-         // calculate integral (normalized by bin volume)
-         // need to set function and parameters here in case loop is parallelized
-         fval = igEval( x1, data.BinUpEdge(i)) ;
-      }
-      if (useBinVolume) fval *= binVolume;
+         }
+         else {
+            // calculate integral (normalized by bin volume)
+            // need to set function and parameters here in case loop is parallelized
+            fval = igEval( x1, data.BinUpEdge(i)) ;
+         }
+         if (useBinVolume) fval *= binVolume;
 
 
 
 #ifdef DEBUG
-      int NSAMPLE = 100;
-      if (i%NSAMPLE == 0) {
-         std::cout << "evt " << i << " x1 = [ ";
-         for (unsigned int j=0; j < func.NDim(); ++j) std::cout << x[j] << " , ";
-         std::cout << "]  ";
-         if (fitOpt.fIntegral) {
-            std::cout << "x2 = [ ";
-            for (unsigned int j=0; j < func.NDim(); ++j) std::cout << data.BinUpEdge(i)[j] << " , ";
-            std::cout << "] ";
+         int NSAMPLE = 100;
+         if (i%NSAMPLE == 0) {
+            std::cout << "evt " << i << " x1 = [ ";
+            for (unsigned int j=0; j < func.NDim(); ++j) std::cout << x[j] << " , ";
+            std::cout << "]  ";
+            if (fitOpt.fIntegral) {
+               std::cout << "x2 = [ ";
+               for (unsigned int j=0; j < func.NDim(); ++j) std::cout << data.BinUpEdge(i)[j] << " , ";
+               std::cout << "] ";
+            }
+            std::cout << "  y = " << y << " fval = " << fval << std::endl;
          }
-         std::cout << "  y = " << y << " fval = " << fval << std::endl;
-      }
 #endif
 
 
-      // EvalLog protects against 0 values of fval but don't want to add in the -log sum
-      // negative values of fval
-      fval = std::max(fval, 0.0);
-
-
-      double tmp = 0;
-      if (useW2) {
-         // apply weight correction . Effective weight is error^2/ y
-         // and expected events in bins is fval/weight
-         // can apply correction only when y is not zero otherwise weight is undefined
-         // (in case of weighted likelihood I don't care about the constant term due to
-         // the saturated model)
-         if (y != 0) {
-            double error = data.Error(i);
-            double weight = (error*error)/y;  // this is the bin effective weight
-            if (extended) {
-               tmp = fval * weight;
-               // wTot  += weight;
-               // w2Tot += weight*weight;
+         // EvalLog protects against 0 values of fval but don't want to add in the -log sum
+         // negative values of fval
+         fval = std::max(fval, 0.0);
+
+
+         double tmp = 0;
+         if (useW2) {
+            // apply weight correction . Effective weight is error^2/ y
+            // and expected events in bins is fval/weight
+            // can apply correction only when y is not zero otherwise weight is undefined
+            // (in case of weighted likelihood I don't care about the constant term due to
+            // the saturated model)
+            if (y != 0) {
+               double error = data.Error(i);
+               double weight = (error*error)/y;  // this is the bin effective weight
+               if (extended) {
+                  tmp = fval * weight;
+                  // wTot  += weight;
+                  // w2Tot += weight*weight;
+               }
+               tmp -= weight * y * ROOT::Math::Util::EvalLog( fval);
             }
-            tmp -= weight * y * ROOT::Math::Util::EvalLog( fval);
-         }
 
-         //  need to compute total weight and weight-square
-         // if (extended ) {
-         //    nuTot += fval;
-         // }
+            //  need to compute total weight and weight-square
+            // if (extended ) {
+            //    nuTot += fval;
+            // }
 
-      }
-      else {
-         // standard case no weights or iWeight=1
-         // this is needed for Poisson likelihood (which are extened and not for multinomial)
-         // the formula below  include constant term due to likelihood of saturated model (f(x) = y)
-         // (same formula as in Baker-Cousins paper, page 439 except a factor of 2
-         if (extended) tmp = fval -y ;
-         if (y >  0) {
-            tmp +=  y *  (ROOT::Math::Util::EvalLog( y) - ROOT::Math::Util::EvalLog(fval));
-            nPoints++;
          }
-      }
+         else {
+            // standard case no weights or iWeight=1
+            // this is needed for Poisson likelihood (which are extened and not for multinomial)
+            // the formula below  include constant term due to likelihood of saturated model (f(x) = y)
+            // (same formula as in Baker-Cousins paper, page 439 except a factor of 2
+            if (extended) tmp = fval -y ;
+            if (y >  0) {
+               tmp +=  y *  (ROOT::Math::Util::EvalLog( y) - ROOT::Math::Util::EvalLog(fval));
+               result.fNPoints++;
+            }
+         }
 
 
-      nloglike +=  tmp;
-   }
+         nloglike.Add(tmp);
+      }
+      result.fSum = nloglike.Sum();
+      return result;
+   };
+
+   ChunkResult total = EvaluateChunks(n, executionPolicy, evalChunk);
+   double nloglike = total.fSum;
+   nPoints = total.fNPoints;
 
    // if (notExtended) {
    //    // not extended : remove from the Likelihood the global Poisson term
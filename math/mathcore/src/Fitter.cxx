@@ -348,6 +348,7 @@ bool Fitter::DoLeastSquareFit() {
    if (!fUseGradient) {
       // do minimzation without using the gradient
       Chi2FCN<BaseFunc> chi2(data,fFunc);
+      chi2.SetExecutionPolicy(fConfig.ExecutionPolicy() );
       fFitType = chi2.Type();
       return DoMinimization (chi2);
    }
@@ -358,6 +359,7 @@ bool Fitter::DoLeastSquareFit() {
       std::shared_ptr<IGradModelFunction> gradFun = std::dynamic_pointer_cast<IGradModelFunction>(fFunc);
       if (gradFun) {
          Chi2FCN<BaseGradFunc> chi2(data,gradFun);
+         chi2.SetExecutionPolicy(fConfig.ExecutionPolicy() );
          fFitType = chi2.Type();
          return DoMinimization (chi2);
       }
@@ -401,6 +403,7 @@ bool Fitter::DoBinnedLikelihoodFit(bool extended) {
    if (!fUseGradient) {
       // do minimization without using the gradient
       PoissonLikelihoodFCN<BaseFunc> logl(data,fFunc, useWeight, extended);
+      logl.SetExecutionPolicy(fConfig.ExecutionPolicy() );
       fFitType = logl.Type();
       // do minimization
       if (!DoMinimization (logl, &chi2) ) return false;
@@ -424,6 +427,7 @@ bool Fitter::DoBinnedLikelihoodFit(bool extended) {
          MATH_WARN_MSG("Fitter::DoBinnedLikelihoodFit","Not-extended binned fit with gradient not yet supported - do an extended fit");
       }
       PoissonLikelihoodFCN<BaseGradFunc> logl(data,gradFun, useWeight, true);
+      logl.SetExecutionPolicy(fConfig.ExecutionPolicy() );
       fFitType = logl.Type();
       // do minimization
       if (!DoMinimization (logl, &chi2) ) return false;
@@ -471,6 +475,7 @@ bool Fitter::DoUnbinnedLikelihoodFit(bool extended) {
    if (!fUseGradient) {
       // do minimization without using the gradient
       LogLikelihoodFCN<BaseFunc> logl(data,fFunc, useWeight, extended);
+      logl.SetExecutionPolicy(fConfig.ExecutionPolicy() );
       fFitType = logl.Type();
       if (!DoMinimization (logl) ) return false;
       if (useWeight) {
@@ -489,6 +494,7 @@ bool Fitter::DoUnbinnedLikelihoodFit(bool extended) {
             MATH_WARN_MSG("Fitter::DoUnbinnedLikelihoodFit","Extended unbinned fit with gradient not yet supported - do a not-extended fit");
          }
          LogLikelihoodFCN<BaseGradFunc> logl(data,gradFun,useWeight, extended);
+         logl.SetExecutionPolicy(fConfig.ExecutionPolicy() );
          fFitType = logl.Type();
          if (!DoMinimization (logl) ) return false;
          if (useWeight) {
@@ -33,49 +33,90 @@ namespace Math {
       }
    }
 
-   /// generate a random double number 
-   double MersenneTwisterEngine::Rndm_impl() {
+   /// compute the next 624 integers of the state
+   void MersenneTwisterEngine::Twist() {
 
-      
       uint32_t y;
-      
+
       const int  kM = 397;
       const int  kN = 624;
-      const uint32_t kTemperingMaskB =  0x9d2c5680;
-      const uint32_t kTemperingMaskC =  0xefc60000;
       const uint32_t kUpperMask =       0x80000000;
       const uint32_t kLowerMask =       0x7fffffff;
       const uint32_t kMatrixA =         0x9908b0df;
-      
-      if (fCount624 >= kN) {
-         int i;
-         
-         for (i=0; i < kN-kM; i++) {
-            y = (fMt[i] & kUpperMask) | (fMt[i+1] & kLowerMask);
-            fMt[i] = fMt[i+kM] ^ (y >> 1) ^ ((y & 0x1) ? kMatrixA : 0x0);
-         }
-         
-         for (   ; i < kN-1    ; i++) {
-            y = (fMt[i] & kUpperMask) | (fMt[i+1] & kLowerMask);
-            fMt[i] = fMt[i+kM-kN] ^ (y >> 1) ^ ((y & 0x1) ? kMatrixA : 0x0);
-         }
-         
-         y = (fMt[kN-1] & kUpperMask) | (fMt[0] & kLowerMask);
-         fMt[kN-1] = fMt[kM-1] ^ (y >> 1) ^ ((y & 0x1) ? kMatrixA : 0x0);
-         fCount624 = 0;
+
+      int i;
+
+      for (i=0; i < kN-kM; i++) {
+         y = (fMt[i] & kUpperMask) | (fMt[i+1] & kLowerMask);
+         fMt[i] = fMt[i+kM] ^ (y >> 1) ^ ((y & 0x1) ? kMatrixA : 0x0);
       }
-      
+
+      for (   ; i < kN-1    ; i++) {
+         y = (fMt[i] & kUpperMask) | (fMt[i+1] & kLowerMask);
+         fMt[i] = fMt[i+kM-kN] ^ (y >> 1) ^ ((y & 0x1) ? kMatrixA : 0x0);
+      }
+
+      y = (fMt[kN-1] & kUpperMask) | (fMt[0] & kLowerMask);
+      fMt[kN-1] = fMt[kM-1] ^ (y >> 1) ^ ((y & 0x1) ? kMatrixA : 0x0);
+      fCount624 = 0;
+   }
+
+   /// generate a random double number
+   double MersenneTwisterEngine::Rndm_impl() {
+
+      uint32_t y;
+
+      const uint32_t kTemperingMaskB =  0x9d2c5680;
+      const uint32_t kTemperingMaskC =  0xefc60000;
+
+      if (fCount624 >= kSize) Twist();
+
       y = fMt[fCount624++];
       y ^=  (y >> 11);
       y ^= ((y << 7 ) & kTemperingMaskB );
       y ^= ((y << 15) & kTemperingMaskC );
       y ^=  (y >> 18);
-      
+
       // 2.3283064365386963e-10 == 1./(max<UINt_t>+1)  -> then returned value cannot be = 1.0
       if (y) return ( (double) y * 2.3283064365386963e-10); // * Power(2,-32)
       return Rndm_impl();
-      
+
+   }
+
+   /// generate an array of n random numbers in ]0,1[, tempering the state
+   /// by blocks in a loop which the compiler vectorizes. The zeros, which
+   /// Rndm_impl skips, are removed afterwards.
+   void MersenneTwisterEngine::RndmArray(int n, double * array) {
+
+      const uint32_t kTemperingMaskB =  0x9d2c5680;
+      const uint32_t kTemperingMaskC =  0xefc60000;
+
+      int k = 0;
+      while (k < n) {
+         if (fCount624 >= kSize) Twist();
+         int m = (n - k < kSize - fCount624) ? n - k : kSize - fCount624;
+         const uint32_t * mt = fMt + fCount624;
+         double * a = array + k;
+         int nzero = 0;
+         for (int j = 0; j < m; ++j) {
+            uint32_t y = mt[j];
+            y ^=  (y >> 11);
+            y ^= ((y << 7 ) & kTemperingMaskB );
+            y ^= ((y << 15) & kTemperingMaskC );
+            y ^=  (y >> 18);
+            nzero += (y == 0);
+            a[j] = (double) y * 2.3283064365386963e-10;
+         }
+         fCount624 += m;
+         if (nzero) {
+            int j = 0;
+            for (int l = 0; l < m; ++l)
+               if (a[l] != 0) a[j++] = a[l];
+            m = j;
+         }
+         k += m;
+      }
    }
-  
+
    } // namespace Math
 } // namespace ROOT
@@ -50,7 +50,9 @@ namespace ROOT {
       }
       ~MixMaxEngineImpl() {}
       void SetSeed(uint64_t) { }
+      void SetSeed(uint64_t, uint32_t) { }
       double Rndm() { return -1; }
+      int RndmBlock(int n, double * array) { for (int i = 0; i < n; ++i) array[i] = -1; return n; }
       double IntRndm() { return 0; }
       void SetState(const std::vector<uint64_t> &) { }
       void GetState(std::vector<uint64_t> &) { }
@@ -82,9 +84,29 @@ public:
       //seed_spbox(fRngState, seed);
       seed_uniquestream(fRngState, 0, 0, (uint32_t)(seed>>32), (uint32_t)seed );
    }
+   void SetSeed(Result_t seed, uint32_t streamID) {
+      seed_uniquestream(fRngState, 0, streamID, (uint32_t)(seed>>32), (uint32_t)seed );
+   }
    double Rndm() {
        return get_next_float(fRngState);
    }
+   // fill array with the next numbers of the state vector, iterating it
+   // first if it is exhausted, as get_next_float does. Return the number of
+   // values filled (at most n and the size of the state). The loop has no
+   // dependency between iterations and is vectorized by the compiler
+   int RndmBlock(int n, double * array) {
+      int i = fRngState->counter;
+      if (i > _N-1) {
+         fRngState->sumtot = iterate_raw_vec(fRngState->V, fRngState->sumtot);
+         i = 1;
+      }
+      int m = (n < _N - i) ? n : _N - i;
+      const myuint * v = fRngState->V + i;
+      for (int j = 0; j < m; ++j)
+         array[j] = (double)(int64_t)v[j] * INV_MERSBASE;
+      fRngState->counter = i + m;
+      return m;
+   }
    // generate one integer number 
    Result_t IntRndm() {
       return get_next(fRngState);
@@ -15,6 +15,22 @@
 #include "TString.h"
 #include <string.h>
 #include <limits>
+#include <algorithm>
+
+#include "RConfigure.h"
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/parallel_for.h"
+#endif
+
+namespace {
+   // number of points from which Build() and the batch FindNearestNeighbors()
+   // are done in parallel, when the implicit multi-threading is enabled
+   const Int_t kKDTreeParallelMinPoints = 100000;
+   // number of query points traversing the tree together in the batch
+   // FindNearestNeighbors()
+   const Int_t kKDTreeQueryBlock = 64;
+}
 
 templateClassImp(TKDTree)
 
@@ -281,6 +297,7 @@ TKDTree<Index, Value>::TKDTree() :
    ,fRange(0x0)
    ,fData(0x0)
    ,fBoundaries(0x0)
+   ,fLeafData(0x0)
    ,fIndPoints(0x0)
    ,fRowT0(0)
    ,fCrossNode(0)
@@ -303,6 +320,7 @@ TKDTree<Index, Value>::TKDTree(Index npoints, Index ndim, UInt_t bsize) :
    ,fRange(0x0)
    ,fData(0x0)
    ,fBoundaries(0x0)
+   ,fLeafData(0x0)
    ,fIndPoints(0x0)
    ,fRowT0(0)
    ,fCrossNode(0)
@@ -355,6 +373,7 @@ TKDTree<Index, Value>::TKDTree(Index npoints, Index ndim, UInt_t bsize, Value **
    ,fRange(0x0)
    ,fData(data) //Columnwise!!!!!
    ,fBoundaries(0x0)
+   ,fLeafData(0x0)
    ,fIndPoints(0x0)
    ,fRowT0(0)
    ,fCrossNode(0)
@@ -377,6 +396,7 @@ TKDTree<Index, Value>::~TKDTree()
    if (fIndPoints) delete [] fIndPoints;
    if (fRange) delete [] fRange;
    if (fBoundaries) delete [] fBoundaries;
+   if (fLeafData) delete [] fLeafData;
    if (fData) {
       if (fDataOwner==1){
          //the tree owns all the data
@@ -449,93 +469,139 @@ void TKDTree<Index, Value>::Build()
    //
    //
    //4.
+   if (fNPoints <= fBucketSize) return;
+#ifdef R__USE_IMT
+   if (fNPoints >= kKDTreeParallelMinPoints && ROOT::IsImplicitMTEnabled()) {
+      // The nodes of a row of the tree divide disjoint ranges of fIndPoints:
+      // divide the upper rows node by node in parallel, then build the
+      // subtrees in parallel. The tree is the same as the serial one.
+      struct Task_t { Int_t fNode, fRow, fPos, fNPoints; };
+      std::vector<Task_t> row(1), next;
+      row[0].fNode = 0; row[0].fRow = 0; row[0].fPos = 0; row[0].fNPoints = fNPoints;
+      std::vector<Int_t> nleft;
+      while (!row.empty() && row.size() < 64) {
+         nleft.resize(row.size());
+         tbb::parallel_for(size_t(0), row.size(), [&](size_t i) {
+            nleft[i] = DivideNode(row[i].fNode, row[i].fRow, row[i].fPos, row[i].fNPoints);
+         });
+         next.clear();
+         for (size_t i = 0; i < row.size(); ++i) {
+            Task_t left = { 2*row[i].fNode+1, row[i].fRow+1, row[i].fPos, nleft[i] };
+            Task_t right = { 2*row[i].fNode+2, row[i].fRow+1, row[i].fPos+nleft[i], row[i].fNPoints-nleft[i] };
+            if (left.fNPoints > fBucketSize) next.push_back(left);
+            if (right.fNPoints > fBucketSize) next.push_back(right);
+         }
+         row.swap(next);
+      }
+      tbb::parallel_for(size_t(0), row.size(), [&](size_t i) {
+         BuildSubtree(row[i].fNode, row[i].fRow, row[i].fPos, row[i].fNPoints);
+      });
+      return;
+   }
+#endif
+   BuildSubtree(0, 0, 0, fNPoints);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Divide the npoints points starting at cpos in fIndPoints of the node cnode,
+/// in the row crow: set the axis and value of the node and partition the
+/// points. Return the number of points of the left daughter node.
+
+template <typename  Index, typename Value>
+Int_t TKDTree<Index, Value>::DivideNode(Int_t cnode, Int_t crow, Int_t cpos, Int_t npoints)
+{
+   //
+   // divide points
+   Int_t nbuckets0 = npoints/fBucketSize;           //current number of  buckets
+   if (npoints%fBucketSize) nbuckets0++;            //
+   Int_t restRows = fRowT0-crow;                    // rest of fully occupied node row
+   if (restRows<0) restRows =0;
+   for (;nbuckets0>(2<<restRows); restRows++) {}
+   Int_t nfull = 1<<restRows;
+   Int_t nrest = nbuckets0-nfull;
+   Int_t nleft =0, nright =0;
+   //
+   if (nrest>(nfull/2)){
+      nleft  = nfull*fBucketSize;
+      nright = npoints-nleft;
+   }else{
+      nright = nfull*fBucketSize/2;
+      nleft  = npoints-nright;
+   }
+
+   //
+   //find the axis with biggest spread
+   Value maxspread=0;
+   Value tempspread, min, max;
+   Index axspread=0;
+   Value *array;
+   for (Int_t idim=0; idim<fNDim; idim++){
+      array = fData[idim];
+      Spread(npoints, array, fIndPoints+cpos, min, max);
+      tempspread = max - min;
+      if (maxspread < tempspread) {
+         maxspread=tempspread;
+         axspread = idim;
+      }
+      if(cnode) continue;
+      //printf("set %d %6.3f %6.3f\n", idim, min, max);
+      fRange[2*idim] = min; fRange[2*idim+1] = max;
+   }
+   array = fData[axspread];
+   KOrdStat(npoints, array, nleft, fIndPoints+cpos);
+   fAxis[cnode]  = axspread;
+   fValue[cnode] = array[fIndPoints[cpos+nleft]];
+   //printf("Set node %d : ax %d val %f\n", cnode, node->fAxis, node->fValue);
+   //
+   if (0){
+      // consistency check
+      Info("Build()", "%s", Form("points %d left %d right %d", npoints, nleft, nright));
+      if (nleft<nright) Warning("Build", "Problem Left-Right");
+      if (nleft<0 || nright<0) Warning("Build()", "Problem Negative number");
+   }
+   return nleft;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Non recursive building of the subtree of the node node, in the row row,
+/// with the npoints points starting at pos in fIndPoints.
+
+template <typename  Index, typename Value>
+void TKDTree<Index, Value>::BuildSubtree(Int_t node, Int_t row, Int_t pos, Int_t npoints)
+{
    //    stack for non recursive build - size 128 bytes enough
    Int_t rowStack[128];
    Int_t nodeStack[128];
    Int_t npointStack[128];
    Int_t posStack[128];
    Int_t currentIndex = 0;
-   Int_t iter =0;
-   rowStack[0]    = 0;
-   nodeStack[0]   = 0;
-   npointStack[0] = fNPoints;
-   posStack[0]   = 0;
+   rowStack[0]    = row;
+   nodeStack[0]   = node;
+   npointStack[0] = npoints;
+   posStack[0]    = pos;
    //
-   Int_t nbucketsall =0;
    while (currentIndex>=0){
-      iter++;
       //
-      Int_t npoints  = npointStack[currentIndex];
-      if (npoints<=fBucketSize) {
-         //printf("terminal node : index %d iter %d\n", currentIndex, iter);
+      Int_t cpoints  = npointStack[currentIndex];
+      if (cpoints<=fBucketSize) {
+         // terminal node
          currentIndex--;
-         nbucketsall++;
-         continue; // terminal node
+         continue;
       }
       Int_t crow     = rowStack[currentIndex];
       Int_t cpos     = posStack[currentIndex];
       Int_t cnode    = nodeStack[currentIndex];
-      //printf("currentIndex %d npoints %d node %d\n", currentIndex, npoints, cnode);
-      //
-      // divide points
-      Int_t nbuckets0 = npoints/fBucketSize;           //current number of  buckets
-      if (npoints%fBucketSize) nbuckets0++;            //
-      Int_t restRows = fRowT0-rowStack[currentIndex];  // rest of fully occupied node row
-      if (restRows<0) restRows =0;
-      for (;nbuckets0>(2<<restRows); restRows++) {}
-      Int_t nfull = 1<<restRows;
-      Int_t nrest = nbuckets0-nfull;
-      Int_t nleft =0, nright =0;
-      //
-      if (nrest>(nfull/2)){
-         nleft  = nfull*fBucketSize;
-         nright = npoints-nleft;
-      }else{
-         nright = nfull*fBucketSize/2;
-         nleft  = npoints-nright;
-      }
-
-      //
-      //find the axis with biggest spread
-      Value maxspread=0;
-      Value tempspread, min, max;
-      Index axspread=0;
-      Value *array;
-      for (Int_t idim=0; idim<fNDim; idim++){
-         array = fData[idim];
-         Spread(npoints, array, fIndPoints+cpos, min, max);
-         tempspread = max - min;
-         if (maxspread < tempspread) {
-            maxspread=tempspread;
-            axspread = idim;
-         }
-         if(cnode) continue;
-         //printf("set %d %6.3f %6.3f\n", idim, min, max);
-         fRange[2*idim] = min; fRange[2*idim+1] = max;
-      }
-      array = fData[axspread];
-      KOrdStat(npoints, array, nleft, fIndPoints+cpos);
-      fAxis[cnode]  = axspread;
-      fValue[cnode] = array[fIndPoints[cpos+nleft]];
-      //printf("Set node %d : ax %d val %f\n", cnode, node->fAxis, node->fValue);
-      //
+      Int_t nleft    = DivideNode(cnode, crow, cpos, cpoints);
       //
       npointStack[currentIndex] = nleft;
       rowStack[currentIndex]    = crow+1;
       posStack[currentIndex]    = cpos;
       nodeStack[currentIndex]   = cnode*2+1;
       currentIndex++;
-      npointStack[currentIndex] = nright;
+      npointStack[currentIndex] = cpoints-nleft;
       rowStack[currentIndex]    = crow+1;
       posStack[currentIndex]    = cpos+nleft;
       nodeStack[currentIndex]   = (cnode*2)+2;
-      //
-      if (0){
-         // consistency check
-         Info("Build()", "%s", Form("points %d left %d right %d", npoints, nleft, nright));
-         if (nleft<nright) Warning("Build", "Problem Left-Right");
-         if (nleft<0 || nright<0) Warning("Build()", "Problem Negative number");
-      }
    }
 }
 
@@ -579,7 +645,15 @@ void TKDTree<Index, Value>::UpdateNearestNeighbors(Index inode, const Value *poi
       Index f1, l1, f2, l2;
       GetNodePointsIndexes(inode, f1, l1, f2, l2);
       for (Int_t ipoint=f1; ipoint<=l1; ipoint++){
-         Double_t d = Distance(point, fIndPoints[ipoint]);
+         Double_t d = 0;
+         if (fLeafData) {
+            for (Int_t idim=0; idim<fNDim; idim++){
+               Value dx = point[idim]-fLeafData[(Long64_t)idim*fNPoints+ipoint];
+               d += dx*dx;
+            }
+            d = TMath::Sqrt(d);
+         } else
+            d = Distance(point, fIndPoints[ipoint]);
          if (d<dist[kNN-1]){
             //found a closer point
             Int_t ishift=0;
@@ -607,6 +681,131 @@ void TKDTree<Index, Value>::UpdateNearestNeighbors(Index inode, const Value *poi
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///Find the kNN nearest neighbors of each of the npoints points of the second
+///argument, whose coordinates are given point by point (x0, y0, z0, x1, y1, ...).
+///The indexes and distances of the neighbors of the point i are returned in
+///ind[i*kNN] ... ind[i*kNN+kNN-1] and dist[i*kNN] ... dist[i*kNN+kNN-1],
+///arrays of at least npoints*kNN elements provided by the user.
+///
+///The points are sorted by terminal node and traverse the tree by blocks,
+///each node being examined for all the points of a block which can still
+///have a closer neighbor in it; the distances to the points of a terminal
+///node are computed from MakeLeafData() in loops the compiler vectorizes.
+///The blocks are processed in parallel if the implicit multi-threading is
+///enabled. The neighbors are the ones of FindNearestNeighbors(point, ...),
+///except for the order of neighbors at the same distance.
+
+template <typename  Index, typename Value>
+void TKDTree<Index, Value>::FindNearestNeighbors(Index npoints, const Value *points, Int_t kNN, Index *ind, Value *dist)
+{
+   if (!ind || !dist) {
+      Error("FindNearestNeighbors", "Working arrays must be allocated by the user!");
+      return;
+   }
+   if (npoints <= 0 || kNN <= 0) return;
+   for (Long64_t i=0; i<(Long64_t)npoints*kNN; i++){
+      dist[i]=std::numeric_limits<Value>::max();
+      ind[i]=-1;
+   }
+   MakeBoundariesExact();
+   MakeLeafData();
+
+   // order the points by terminal node, so that the points of a block are close
+   std::vector<Index> node(npoints);
+   std::vector<Int_t> order(npoints);
+   for (Index i=0; i<npoints; i++){
+      node[i] = FindNode(points + (Long64_t)i*fNDim);
+      order[i] = i;
+   }
+   std::stable_sort(order.begin(), order.end(), [&node](Int_t a, Int_t b) { return node[a] < node[b]; });
+
+   const Int_t nblocks = (npoints + kKDTreeQueryBlock - 1)/kKDTreeQueryBlock;
+   // each row of the tree uses at most kKDTreeQueryBlock entries of the work array
+   const Int_t nwork = kKDTreeQueryBlock*(fRowT0+4);
+   auto findBlock = [&](Int_t iblock) {
+      std::vector<Int_t> work(nwork);
+      std::vector<Double_t> dwork(fBucketSize);
+      Int_t first = iblock*kKDTreeQueryBlock;
+      Int_t nq = std::min(kKDTreeQueryBlock, (Int_t)npoints - first);
+      UpdateNearestNeighborsBlock(0, nq, &order[first], points, kNN, ind, dist, work.data(), dwork.data());
+   };
+#ifdef R__USE_IMT
+   if (nblocks > 1 && ROOT::IsImplicitMTEnabled()) {
+      tbb::parallel_for(0, nblocks, findBlock);
+      return;
+   }
+#endif
+   for (Int_t iblock=0; iblock<nblocks; iblock++) findBlock(iblock);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///Update the nearest neighbors of the nq points of indexes q by examining the
+///node inode. The points which cannot have a closer neighbor in the node are
+///left out; the others are stored in work, the rest of which is used by the
+///daughter nodes. dwork has space for the distances to the points of a
+///terminal node.
+
+template <typename Index, typename Value>
+void TKDTree<Index, Value>::UpdateNearestNeighborsBlock(Index inode, Int_t nq, const Int_t *q, const Value *points,
+                                                        Int_t kNN, Index *ind, Value *dist, Int_t *work, Double_t *dwork)
+{
+   Int_t *active = work;
+   Int_t nactive = 0;
+   Value min=0;
+   Value max=0;
+   for (Int_t iq=0; iq<nq; iq++){
+      DistanceToNode(points + (Long64_t)q[iq]*fNDim, inode, min, max);
+      if (min <= dist[(Long64_t)q[iq]*kNN+kNN-1]) active[nactive++] = q[iq];
+   }
+   if (!nactive) return;
+
+   if (IsTerminal(inode)) {
+      Index f1, l1, f2, l2;
+      GetNodePointsIndexes(inode, f1, l1, f2, l2);
+      const Int_t np = l1-f1+1;
+      for (Int_t iq=0; iq<nactive; iq++){
+         const Value *point = points + (Long64_t)active[iq]*fNDim;
+         Index *qind = ind + (Long64_t)active[iq]*kNN;
+         Value *qdist = dist + (Long64_t)active[iq]*kNN;
+         for (Int_t j=0; j<np; j++) dwork[j] = 0;
+         for (Int_t idim=0; idim<fNDim; idim++){
+            const Value x = point[idim];
+            const Value *leaf = fLeafData + (Long64_t)idim*fNPoints + f1;
+            for (Int_t j=0; j<np; j++){
+               Value dx = x-leaf[j];
+               dwork[j] += dx*dx;
+            }
+         }
+         for (Int_t j=0; j<np; j++){
+            Double_t d = TMath::Sqrt(dwork[j]);
+            if (d<qdist[kNN-1]){
+               //found a closer point: insert it as in UpdateNearestNeighbors
+               Int_t ishift=0;
+               while(ishift<kNN && d>qdist[ishift])
+                  ishift++;
+               for (Int_t i=kNN-1; i>ishift; i--){
+                  qdist[i]=qdist[i-1];
+                  qind[i]=qind[i-1];
+               }
+               qdist[ishift]=d;
+               qind[ishift]=fIndPoints[f1+j];
+            }
+         }
+      }
+      return;
+   }
+
+   //first examine the node that contains most of the points
+   Int_t nleft = 0;
+   for (Int_t iq=0; iq<nactive; iq++)
+      if (points[(Long64_t)active[iq]*fNDim+fAxis[inode]]<fValue[inode]) nleft++;
+   Index first = (2*nleft >= nactive) ? GetLeft(inode) : GetRight(inode);
+   Index second = (2*nleft >= nactive) ? GetRight(inode) : GetLeft(inode);
+   UpdateNearestNeighborsBlock(first, nactive, active, points, kNN, ind, dist, work+nactive, dwork);
+   UpdateNearestNeighborsBlock(second, nactive, active, points, kNN, ind, dist, work+nactive, dwork);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///Find the distance between point of the first argument and the point at index value ind
 ///Type argument specifies the metric: type=2 - L2 metric, type=1 - L1 metric
@@ -1169,6 +1368,26 @@ void TKDTree<Index, Value>::MakeBoundariesExact()
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the coordinates of the points in the order of fIndPoints, i.e. terminal
+/// node by terminal node, dimension by dimension, so that the nearest neighbor
+/// searches read the points of a terminal node contiguously. The copy takes as
+/// much memory as the data. It is done by the batch FindNearestNeighbors() and
+/// can be requested before the single point one; it must be done after Build().
+
+template <typename Index, typename Value>
+void TKDTree<Index, Value>::MakeLeafData()
+{
+   if (fLeafData || !fIndPoints) return;
+   fLeafData = new Value[(Long64_t)fNDim*fNPoints];
+   for (Index idim=0; idim<fNDim; idim++){
+      Value *leaf = fLeafData + (Long64_t)idim*fNPoints;
+      const Value *data = fData[idim];
+      for (Index i=0; i<fNPoints; i++)
+         leaf[i] = data[fIndPoints[i]];
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 /// find the smallest node covering the full range - start
@@ -216,6 +216,19 @@ Double_t TRandom::Exp(Double_t tau)
    return t;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill array with n exponential deviates of parameter tau.
+/// The uniform numbers are generated with RndmArray and transformed in a
+/// separate loop, which the compiler can vectorize; the result is the same
+/// as the one of n calls to Exp(tau).
+
+void TRandom::ExpArray(Int_t n, Double_t *array, Double_t tau)
+{
+   RndmArray(n, array);
+   for (Int_t i = 0; i < n; ++i)
+      array[i] = -tau * TMath::Log(array[i]);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Samples a random number from the standard Normal (Gaussian) Distribution
 /// with the given mean and sigma.
@@ -314,6 +327,28 @@ Double_t TRandom::Gaus(Double_t mean, Double_t sigma)
    return mean + sigma * result;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill array with n numbers distributed following a gaussian with the given
+/// mean and sigma.
+/// The numbers are produced by pairs with the Box-Muller method used by
+/// Rannor, from uniform numbers generated with RndmArray, in a loop without
+/// branches which the compiler can vectorize. This is faster than calling
+/// Gaus n times, but the numbers are not the same.
+
+void TRandom::GausArray(Int_t n, Double_t *array, Double_t mean, Double_t sigma)
+{
+   if (n <= 0) return;
+   const Int_t npair = n / 2;
+   RndmArray(2*npair, array);
+   for (Int_t i = 0; i < npair; ++i) {
+      const Double_t r = sigma * TMath::Sqrt(-2*TMath::Log(array[2*i]));
+      const Double_t x = array[2*i+1] * 6.28318530717958623;
+      array[2*i]   = mean + r * TMath::Sin(x);
+      array[2*i+1] = mean + r * TMath::Cos(x);
+   }
+   if (n % 2) array[n-1] = Gaus(mean, sigma);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns a random integer on [ 0, imax-1 ].
 
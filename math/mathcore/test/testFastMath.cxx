@@ -0,0 +1,96 @@
+// test of the fast vectorizable functions of Math/FastMath.h against the
+// functions of the C math library and of ROOT::Math
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <limits>
+
+#include "Math/FastMath.h"
+#include "Math/SpecFuncMathCore.h"
+#include "Math/PdfFuncMathCore.h"
+#include "Math/ProbFuncMathCore.h"
+#include "TRandom3.h"
+
+bool verbose = false;
+
+using namespace std;
+
+// compare the array version of a fast function with a reference function
+template <class FastArray, class Ref>
+int testFunction(const char *name, const vector<double> &x, FastArray fast, Ref ref, double tolerance)
+{
+   vector<double> y(x.size());
+   fast(x.size(), x.data(), y.data());
+   double maxError = 0;
+   for (unsigned int i = 0; i < x.size(); ++i) {
+      double r = ref(x[i]);
+      if (std::abs(r) < 1.E-300) continue;
+      double error = std::abs((y[i] - r) / r);
+      if (error > maxError) maxError = error;
+   }
+   bool ok = maxError < tolerance;
+   if (verbose || !ok)
+      cout << name << " : maximal relative error " << maxError << (ok ? "  OK" : "  FAILED") << endl;
+   return ok ? 0 : 1;
+}
+
+int testFastMath()
+{
+   const int n = 100000;
+   TRandom3 r(4357);
+   vector<double> xexp(n), xlog(n), xerf(n), xerfc(n);
+   for (int i = 0; i < n; ++i) {
+      xexp[i] = r.Uniform(-708, 708);
+      xlog[i] = std::exp(r.Uniform(-700, 700));
+      xerf[i] = r.Uniform(-6, 6);
+      xerfc[i] = r.Uniform(-6, 26);
+   }
+
+   int status = 0;
+   status += testFunction("fast_exp", xexp,
+                          [](unsigned int m, const double *x, double *y) { ROOT::Math::fast_exp(m, x, y); },
+                          [](double x) { return std::exp(x); }, 1.E-15);
+   status += testFunction("fast_log", xlog,
+                          [](unsigned int m, const double *x, double *y) { ROOT::Math::fast_log(m, x, y); },
+                          [](double x) { return std::log(x); }, 1.E-15);
+   status += testFunction("fast_erf", xerf,
+                          [](unsigned int m, const double *x, double *y) { ROOT::Math::fast_erf(m, x, y); },
+                          [](double x) { return ROOT::Math::erf(x); }, 1.E-14);
+   status += testFunction("fast_erfc", xerfc,
+                          [](unsigned int m, const double *x, double *y) { ROOT::Math::fast_erfc(m, x, y); },
+                          [](double x) { return ROOT::Math::erfc(x); }, 1.E-13);
+   status += testFunction("fast_normal_pdf", xerf,
+                          [](unsigned int m, const double *x, double *y) { ROOT::Math::fast_normal_pdf(m, x, y, 2., 1.); },
+                          [](double x) { return ROOT::Math::normal_pdf(x, 2., 1.); }, 1.E-14);
+   status += testFunction("fast_normal_cdf", xerf,
+                          [](unsigned int m, const double *x, double *y) { ROOT::Math::fast_normal_cdf(m, x, y, 0.5); },
+                          [](double x) { return ROOT::Math::normal_cdf(x, 0.5); }, 1.E-13);
+   status += testFunction("fast_normal_cdf_c", xerf,
+                          [](unsigned int m, const double *x, double *y) { ROOT::Math::fast_normal_cdf_c(m, x, y, 0.5); },
+                          [](double x) { return ROOT::Math::normal_cdf_c(x, 0.5); }, 1.E-13);
+
+   // special values
+   const double inf = std::numeric_limits<double>::infinity();
+   if (ROOT::Math::fast_exp(800.) != inf || ROOT::Math::fast_exp(-800.) != 0 ||
+       ROOT::Math::fast_log(0.) != -inf || !std::isnan(ROOT::Math::fast_log(-1.)) ||
+       ROOT::Math::fast_log(inf) != inf || ROOT::Math::fast_erfc(-30.) != 2. || ROOT::Math::fast_erf(0.) != 0) {
+      cout << "special values FAILED" << endl;
+      status++;
+   }
+
+   return status;
+}
+
+int main(int argc, char **argv)
+{
+   for (int i = 1; i < argc; ++i)
+      if (string(argv[i]) == "-v") verbose = true;
+
+   int status = testFastMath();
+   if (status)
+      cerr << "testFastMath: " << status << " tests FAILED" << endl;
+   else
+      cout << "testFastMath: OK" << endl;
+   return status;
+}
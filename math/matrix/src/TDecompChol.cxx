@@ -26,6 +26,7 @@
 
 #include "TDecompChol.h"
 #include "TMath.h"
+#include "TMatrixTParallel.h"
 
 ClassImp(TDecompChol)
 
@@ -112,7 +113,7 @@ Bool_t TDecompChol::Decompose()
       return kFALSE;
    }
 
-   Int_t i,j,icol,irow;
+   Int_t icol,irow;
    const Int_t     n  = fU.GetNrows();
          Double_t *pU = fU.GetMatrixArray();
    for (icol = 0; icol < n; icol++) {
@@ -132,14 +133,18 @@ Bool_t TDecompChol::Decompose()
       pU[rowOff+icol] = ujj;
 
       if (icol < n-1) {
-         for (j = icol+1; j < n; j++) {
-            for (i = 0; i < icol; i++) {
-               const Int_t rowOff2 = i*n;
-               pU[rowOff+j] -= pU[rowOff2+j]*pU[rowOff2+icol];
+         // the elements of the row are independent: they are computed by
+         // ranges, in parallel for a large matrix
+         ROOT::Internal::MatrixForEachRange(icol+1,n,Double_t(icol)*(n-icol-1),[&](Int_t first,Int_t last) {
+            for (Int_t i2 = 0; i2 < icol; i2++) {
+               const Int_t rowOff2 = i2*n;
+               const Double_t u2c = pU[rowOff2+icol];
+               for (Int_t j2 = first; j2 < last; j2++)
+                  pU[rowOff+j2] -= pU[rowOff2+j2]*u2c;
             }
-         }
-         for (j = icol+1; j < n; j++)
-            pU[rowOff+j] /= ujj;
+            for (Int_t j2 = first; j2 < last; j2++)
+               pU[rowOff+j2] /= ujj;
+         });
       }
    }
 
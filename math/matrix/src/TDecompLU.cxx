@@ -11,6 +11,7 @@
 
 #include "TDecompLU.h"
 #include "TMath.h"
+#include "TMatrixTParallel.h"
 
 ClassImp(TDecompLU)
 
@@ -642,17 +643,25 @@ Bool_t TDecompLU::DecomposeLUCrout(TMatrixD &lu,Int_t *index,Double_t &sign,
       // diagonal term will become the multipliers in the elimination of the jth.
       // subdiag. Find fIndex of largest scaled term in imax.
 
+      // The residuals are independent: they are computed in parallel for a
+      // large matrix.
+
+      ROOT::Internal::MatrixForEachRange(j,n,Double_t(j)*(n-j),[&](Int_t first,Int_t last) {
+         for (Int_t i = first; i < last; i++) {
+            const Int_t off_i = i*n;
+            Double_t r = pLU[off_i+j];
+            for (Int_t k = 0; k < j; k++) {
+               const Int_t off_k = k*n;
+               r -= pLU[off_i+k]*pLU[off_k+j];
+            }
+            pLU[off_i+j] = r;
+         }
+      });
+
       Double_t max = 0.0;
       Int_t imax = 0;
       for (Int_t i = j; i < n; i++) {
-         const Int_t off_i = i*n;
-         Double_t r = pLU[off_i+j];
-         for (Int_t k = 0; k < j; k++) {
-            const Int_t off_k = k*n;
-            r -= pLU[off_i+k]*pLU[off_k+j];
-         }
-         pLU[off_i+j] = r;
-         const Double_t tmp = scale[i]*TMath::Abs(r);
+         const Double_t tmp = scale[i]*TMath::Abs(pLU[i*n+j]);
          if (tmp >= max) {
             max = tmp;
             imax = i;
@@ -749,17 +758,21 @@ Bool_t TDecompLU::DecomposeLUGauss(TMatrixD &lu,Int_t *index,Double_t &sign,
       if (mLUjj != 0.0) {
          if (TMath::Abs(mLUjj) < tol)
             nrZeros++;
-         for (Int_t i = j+1; i < n; i++) {
-            const Int_t off_i = i*n;
-            const Double_t mLUij = pLU[off_i+j]/mLUjj;
-            pLU[off_i+j] = mLUij;
-
-            for (Int_t k = j+1; k < n; k++) {
-               const Double_t mLUik = pLU[off_i+k];
-               const Double_t mLUjk = pLU[off_j+k];
-               pLU[off_i+k] = mLUik-mLUij*mLUjk;
+         // the rows below the pivot are updated independently, in parallel
+         // for a large matrix
+         ROOT::Internal::MatrixForEachRange(j+1,n,Double_t(n-j-1)*(n-j-1),[&](Int_t first,Int_t last) {
+            for (Int_t i = first; i < last; i++) {
+               const Int_t off_i = i*n;
+               const Double_t mLUij = pLU[off_i+j]/mLUjj;
+               pLU[off_i+j] = mLUij;
+
+               for (Int_t k = j+1; k < n; k++) {
+                  const Double_t mLUik = pLU[off_i+k];
+                  const Double_t mLUjk = pLU[off_j+k];
+                  pLU[off_i+k] = mLUik-mLUij*mLUjk;
+               }
             }
-         }
+         });
       } else {
          ::Error("TDecompLU::DecomposeLUGauss","matrix is singular");
          return kFALSE;
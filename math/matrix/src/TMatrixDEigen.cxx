@@ -44,11 +44,74 @@
  This keeps V a real matrix in both symmetric and non-symmetric
  cases, and A*V = V*D.
 
+ When ROOT is built with the option `matrix_lapack`, the eigenvalues and
+ eigenvectors are computed by the LAPACK routine DGEEV. Its eigenvectors
+ are normalized to unit length, contrary to those of the Hessenberg and
+ Schur reduction used otherwise.
+
 */
 
 #include "TMatrixDEigen.h"
 #include "TMath.h"
 
+#ifdef MATRIX_USE_LAPACK
+#include <vector>
+
+// eigenvalues and eigenvectors of a real general matrix from LAPACK
+extern "C" void dgeev_(const char *jobvl, const char *jobvr, const int *n, double *a, const int *lda,
+                       double *wr, double *wi, double *vl, const int *ldvl, double *vr, const int *ldvr,
+                       double *work, const int *lwork, int *info);
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill v, d and e with the (right) eigenvectors and the real and imaginary
+/// parts of the eigenvalues of a, with the LAPACK routine DGEEV. The vectors
+/// of a pair of complex eigenvalues are stored as in the rest of the class:
+/// the real and imaginary parts of the eigenvector of the eigenvalue with a
+/// positive imaginary part. Returns false if it fails.
+
+Bool_t MakeEigenLapack(const TMatrixD &a,TMatrixD &v,TVectorD &d,TVectorD &e)
+{
+   int n = a.GetNrows();
+   const Double_t *pA = a.GetMatrixArray();
+   // LAPACK uses column major order
+   std::vector<double> work_a(n*n);
+   for (Int_t i = 0; i < n; i++)
+      for (Int_t j = 0; j < n; j++)
+         work_a[j*n+i] = pA[i*n+j];
+   std::vector<double> vr(n*n);
+   double vl_dummy = 0.;
+   int ldvl = 1;
+   int info = 0;
+
+   // workspace query
+   int lwork = -1;
+   double work_size = 0.;
+   dgeev_("N","V",&n,&work_a[0],&n,d.GetMatrixArray(),e.GetMatrixArray(),&vl_dummy,&ldvl,&vr[0],&n,
+          &work_size,&lwork,&info);
+   if (info != 0) return kFALSE;
+   lwork = Int_t(work_size);
+   std::vector<double> work(lwork);
+   dgeev_("N","V",&n,&work_a[0],&n,d.GetMatrixArray(),e.GetMatrixArray(),&vl_dummy,&ldvl,&vr[0],&n,
+          &work[0],&lwork,&info);
+   if (info != 0) return kFALSE;
+
+   // DGEEV puts the pairs of complex eigenvalues with the positive imaginary
+   // part first, and the real and imaginary parts of its eigenvector in the
+   // two corresponding columns, as in the Schur reduction
+   Double_t *pV = v.GetMatrixArray();
+   for (Int_t j = 0; j < n; j++) {
+      const Int_t off_j = j*n;
+      for (Int_t k = 0; k < n; k++)
+         pV[k*n+j] = vr[off_j+k];
+   }
+   return kTRUE;
+}
+
+}
+#endif
+
 ClassImp(TMatrixDEigen)
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -74,6 +137,14 @@ TMatrixDEigen::TMatrixDEigen(const TMatrixD &a)
    fEigenValuesRe.ResizeTo(rowLwb,rowUpb);
    fEigenValuesIm.ResizeTo(rowLwb,rowUpb);
 
+#ifdef MATRIX_USE_LAPACK
+   if (MakeEigenLapack(a,fEigenVectors,fEigenValuesRe,fEigenValuesIm)) {
+      Sort(fEigenVectors,fEigenValuesRe,fEigenValuesIm);
+      return;
+   }
+   Warning("TMatrixDEigen","LAPACK failed, using the Hessenberg and Schur reduction");
+#endif
+
    TVectorD ortho;
    Double_t work[kWorkMax];
    if (nRows > kWorkMax) ortho.ResizeTo(nRows);
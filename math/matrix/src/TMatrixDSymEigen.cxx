@@ -21,11 +21,79 @@
  diagonal values of D are the eigenvalues, and V*V' = I, where I is
  the identity matrix.  The columns of V represent the eigenvectors in
  the sense that A*V = V*D.
+
+ The eigenvalues are sorted in decreasing order. When ROOT is built with
+ the option `matrix_lapack`, they are computed by the LAPACK routine
+ DSYEVR (Relatively Robust Representations), which is much faster for
+ large matrices; the eigenvectors may then differ in sign from those of
+ the Householder and QL algorithm used otherwise. With the implicit
+ multi-threading, the O(n^3) steps of this algorithm share the rows of
+ large matrices between the threads, with results identical to the serial
+ ones.
 */
 
 #include "TMatrixDSymEigen.h"
+#include "TMatrixTParallel.h"
 #include "TMath.h"
 
+#include <vector>
+
+#ifdef MATRIX_USE_LAPACK
+// eigenvalues and eigenvectors of a real symmetric matrix from LAPACK
+extern "C" void dsyevr_(const char *jobz, const char *range, const char *uplo, const int *n, double *a,
+                        const int *lda, const double *vl, const double *vu, const int *il, const int *iu,
+                        const double *abstol, int *m, double *w, double *z, const int *ldz, int *isuppz,
+                        double *work, const int *lwork, int *iwork, const int *liwork, int *info);
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill v and d with the eigenvectors and eigenvalues of a, in decreasing
+/// order of the eigenvalues, with the LAPACK routine DSYEVR. Returns false
+/// if it fails.
+
+Bool_t MakeEigenLapack(const TMatrixDSym &a,TMatrixD &v,TVectorD &d)
+{
+   int n = a.GetNrows();
+   // a symmetric matrix has the same storage in row and column major order
+   std::vector<double> work_a(a.GetMatrixArray(),a.GetMatrixArray()+n*n);
+   std::vector<double> w(n);
+   std::vector<double> z(n*n);
+   std::vector<int> isuppz(2*n);
+   const double vl = 0., vu = 0., abstol = 0.;
+   const int il = 0, iu = 0;
+   int m = 0, info = 0;
+
+   // workspace query
+   int lwork = -1, liwork = -1, iwork_size = 0;
+   double work_size = 0.;
+   dsyevr_("V","A","L",&n,&work_a[0],&n,&vl,&vu,&il,&iu,&abstol,&m,&w[0],&z[0],&n,&isuppz[0],
+           &work_size,&lwork,&iwork_size,&liwork,&info);
+   if (info != 0) return kFALSE;
+   lwork  = Int_t(work_size);
+   liwork = iwork_size;
+   std::vector<double> work(lwork);
+   std::vector<int> iwork(liwork);
+   dsyevr_("V","A","L",&n,&work_a[0],&n,&vl,&vu,&il,&iu,&abstol,&m,&w[0],&z[0],&n,&isuppz[0],
+           &work[0],&lwork,&iwork[0],&liwork,&info);
+   if (info != 0 || m != n) return kFALSE;
+
+   // LAPACK returns the eigenvalues in increasing order, and the eigenvectors
+   // in the columns of z, in column major order
+   Double_t *pV = v.GetMatrixArray();
+   Double_t *pD = d.GetMatrixArray();
+   for (Int_t j = 0; j < n; j++) {
+      const Int_t off_z = (n-1-j)*n;
+      pD[j] = w[n-1-j];
+      for (Int_t k = 0; k < n; k++)
+         pV[k*n+j] = z[off_z+k];
+   }
+   return kTRUE;
+}
+
+}
+#endif
+
 ClassImp(TMatrixDSymEigen)
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -41,6 +109,12 @@ TMatrixDSymEigen::TMatrixDSymEigen(const TMatrixDSym &a)
    fEigenValues.ResizeTo(rowLwb,rowLwb+nRows-1);
    fEigenVectors.ResizeTo(a);
 
+#ifdef MATRIX_USE_LAPACK
+   if (MakeEigenLapack(a,fEigenVectors,fEigenValues))
+      return;
+   Warning("TMatrixDSymEigen","LAPACK failed, using the QL algorithm");
+#endif
+
    fEigenVectors = a;
 
    TVectorD offDiag;
@@ -120,19 +194,23 @@ void TMatrixDSymEigen::MakeTridiagonal(TMatrixD &v,TVectorD &d,TVectorD &e)
             pE[j] = 0.0;
 
          // Apply similarity transformation to remaining columns.
-
-         for (j = 0; j < i; j++) {
-            const Int_t off_j = j*n;
-            f = pD[j];
-            pV[off_j+i] = f;
-            g = pE[j]+pV[off_j+j]*f;
-            for (k = j+1; k <= i-1; k++) {
-               const Int_t off_k = k*n;
-               g += pV[off_k+j]*pD[k];
-               pE[k] += pV[off_k+j]*f;
+         // e = A*d with A the lower triangle of the remaining columns: each
+         // element sums its terms in the same order as the column by column
+         // loop of tred2, so that the rows can be computed independently.
+
+         ROOT::Internal::MatrixForEachRange(0,i,0.5*i*i,[pV,pD,pE,n,i](Int_t first,Int_t last) {
+            for (Int_t jj = first; jj < last; jj++) {
+               const Int_t off_j = jj*n;
+               Double_t gg = 0.0;
+               for (Int_t kk = 0; kk < jj; kk++)
+                  gg += pV[off_j+kk]*pD[kk];
+               gg += pV[off_j+jj]*pD[jj];
+               for (Int_t kk = jj+1; kk <= i-1; kk++)
+                  gg += pV[kk*n+jj]*pD[kk];
+               pE[jj] = gg;
+               pV[off_j+i] = pD[jj];
             }
-            pE[j] = g;
-         }
+         });
          f = 0.0;
          for (j = 0; j < i; j++) {
             pE[j] /= h;
@@ -141,13 +219,14 @@ void TMatrixDSymEigen::MakeTridiagonal(TMatrixD &v,TVectorD &d,TVectorD &e)
          Double_t hh = f/(h+h);
          for (j = 0; j < i; j++)
             pE[j] -= hh*pD[j];
-         for (j = 0; j < i; j++) {
-            f = pD[j];
-            g = pE[j];
-            for (k = j; k <= i-1; k++) {
-               const Int_t off_k = k*n;
-               pV[off_k+j] -= (f*pE[k]+g*pD[k]);
+         ROOT::Internal::MatrixForEachRange(0,i,0.5*i*i,[pV,pD,pE,n](Int_t first,Int_t last) {
+            for (Int_t kk = first; kk < last; kk++) {
+               const Int_t off_k = kk*n;
+               for (Int_t jj = 0; jj <= kk; jj++)
+                  pV[off_k+jj] -= (pD[jj]*pE[kk]+pE[jj]*pD[kk]);
             }
+         });
+         for (j = 0; j < i; j++) {
             pD[j] = pV[off_i1+j];
             pV[off_i+j] = 0.0;
          }
@@ -156,7 +235,11 @@ void TMatrixDSymEigen::MakeTridiagonal(TMatrixD &v,TVectorD &d,TVectorD &e)
    }
 
    // Accumulate transformations.
+   // The products g of the columns with column i+1 are summed row by row,
+   // then the columns are updated row by row.
 
+   std::vector<Double_t> gv(n);
+   Double_t *pG = &gv[0];
    for (i = 0; i < n-1; i++) {
       const Int_t off_i  = i*n;
       pV[off_n1+i] = pV[off_i+i];
@@ -167,17 +250,24 @@ void TMatrixDSymEigen::MakeTridiagonal(TMatrixD &v,TVectorD &d,TVectorD &e)
             const Int_t off_k = k*n;
             pD[k] = pV[off_k+i+1]/h;
          }
-         for (j = 0; j <= i; j++) {
-            Double_t g = 0.0;
-            for (k = 0; k <= i; k++) {
-               const Int_t off_k = k*n;
-               g += pV[off_k+i+1]*pV[off_k+j];
+         const Double_t nOps = Double_t(i+1)*(i+1);
+         ROOT::Internal::MatrixForEachRange(0,i+1,nOps,[pV,pG,n,i](Int_t first,Int_t last) {
+            for (Int_t jj = first; jj < last; jj++)
+               pG[jj] = 0.0;
+            for (Int_t kk = 0; kk <= i; kk++) {
+               const Int_t off_k = kk*n;
+               const Double_t vk = pV[off_k+i+1];
+               for (Int_t jj = first; jj < last; jj++)
+                  pG[jj] += vk*pV[off_k+jj];
             }
-            for (k = 0; k <= i; k++) {
-               const Int_t off_k = k*n;
-               pV[off_k+j] -= g*pD[k];
+         });
+         ROOT::Internal::MatrixForEachRange(0,i+1,nOps,[pV,pD,pG,n,i](Int_t first,Int_t last) {
+            for (Int_t kk = first; kk < last; kk++) {
+               const Int_t off_k = kk*n;
+               for (Int_t jj = 0; jj <= i; jj++)
+                  pV[off_k+jj] -= pG[jj]*pD[kk];
             }
-         }
+         });
       }
       for (k = 0; k <= i; k++) {
          const Int_t off_k = k*n;
@@ -206,6 +296,11 @@ void TMatrixDSymEigen::MakeEigenVectors(TMatrixD &v,TVectorD &d,TVectorD &e)
 
    const Int_t n = v.GetNrows();
 
+   // rotations of a QL transformation, applied to the rows of v at once
+   std::vector<Double_t> cosv(n), sinv(n);
+   Double_t *pC = &cosv[0];
+   Double_t *pS = &sinv[0];
+
    Int_t i,j,k,l;
    for (i = 1; i < n; i++)
       pE[i-1] = pE[i];
@@ -276,16 +371,23 @@ void TMatrixDSymEigen::MakeEigenVectors(TMatrixD &v,TVectorD &d,TVectorD &e)
                c = p/r;
                p = c*pD[i]-s*g;
                pD[i+1] = h+s*(c*g+s*pD[i]);
+               pC[i] = c;
+               pS[i] = s;
+            }
 
-               // Accumulate transformation.
-
-               for (k = 0; k < n; k++) {
-                  const Int_t off_k = k*n;
-                  h = pV[off_k+i+1];
-                  pV[off_k+i+1] = s*pV[off_k+i]+c*h;
-                  pV[off_k+i]   = c*pV[off_k+i]-s*h;
+            // Accumulate transformation: the rotations only mix the elements
+            // of a row, which can be applied independently.
+
+            ROOT::Internal::MatrixForEachRange(0,n,4.0*n*(m-l),[pV,pC,pS,n,l,m](Int_t first,Int_t last) {
+               for (Int_t kk = first; kk < last; kk++) {
+                  Double_t *row = pV+kk*n;
+                  for (Int_t ii = m-1; ii >= l; ii--) {
+                     const Double_t hh = row[ii+1];
+                     row[ii+1] = pS[ii]*row[ii]+pC[ii]*hh;
+                     row[ii]   = pC[ii]*row[ii]-pS[ii]*hh;
+                  }
                }
-            }
+            });
             p = -s*s2*c3*el1*pE[l]/dl1;
             pE[l] = s*p;
             pD[l] = c*p;
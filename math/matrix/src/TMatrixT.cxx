@@ -17,6 +17,7 @@
  Template class of a general matrix in the linear algebra package
 */
 
+#include <algorithm>
 #include <iostream>
 #include <typeinfo>
 
@@ -29,6 +30,7 @@
 #include "TMatrixDEigen.h"
 #include "TClass.h"
 #include "TMath.h"
+#include "TMatrixTParallel.h"
 
 templateClassImp(TMatrixT)
 
@@ -3070,13 +3072,63 @@ TMatrixT<Element> &ElementDiv(TMatrixT<Element> &target,const TMatrixTSym<Elemen
    return target;
 }
 
+namespace {
+
+/// Size of the blocks of the cache-blocked matrix products: kBlockK rows of
+/// kBlockJ elements of B (128 kB for doubles) are used for all the rows of A.
+const Int_t kBlockK = 64;
+const Int_t kBlockJ = 256;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Cache-blocked product of rows [first,last) of C = op(A) * B, with
+/// op(A)[i,k] = ap[i*aRowStride+k*aColStride] and B nk x ncolsb. Each element
+/// of C is the sum of the products in increasing k, as in the simple loop.
+
+template<class Element>
+void MultBlocked(const Element * const ap,Int_t aRowStride,Int_t aColStride,Int_t nk,
+                 const Element * const bp,Int_t ncolsb,Element *cp,Int_t first,Int_t last)
+{
+   std::fill(cp+first*ncolsb,cp+last*ncolsb,Element(0));
+   for (Int_t k0 = 0; k0 < nk; k0 += kBlockK) {
+      const Int_t k1 = std::min(k0+kBlockK,nk);
+      for (Int_t j0 = 0; j0 < ncolsb; j0 += kBlockJ) {
+         const Int_t j1 = std::min(j0+kBlockJ,ncolsb);
+         for (Int_t i = first; i < last; i++) {
+            const Element *arp = ap+i*aRowStride;
+                  Element *crp = cp+i*ncolsb;
+            for (Int_t k = k0; k < k1; k++) {
+               const Element aik = arp[k*aColStride];
+               const Element *brp = bp+k*ncolsb;
+               for (Int_t j = j0; j < j1; j++)
+                  crp[j] += aik*brp[j];
+            }
+         }
+      }
+   }
+}
+
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Elementary routine to calculate matrix multiplication A*B
+///
+/// For large matrices the product is computed by blocks which fit in the
+/// cache, and the rows of the result are shared between the threads if the
+/// implicit multi-threading is enabled (see ROOT::EnableImplicitMT). The
+/// result is identical to the one of the simple loop.
 
 template<class Element>
 void AMultB(const Element * const ap,Int_t na,Int_t ncolsa,
             const Element * const bp,Int_t nb,Int_t ncolsb,Element *cp)
 {
+   const Double_t nOps = Double_t(na)*ncolsb;
+   if (nOps >= ROOT::Internal::kMatrixParallelMinOps && ncolsa > 0) {
+      ROOT::Internal::MatrixForEachRange(0,na/ncolsa,nOps,[&](Int_t first,Int_t last) {
+         MultBlocked(ap,ncolsa,1,ncolsa,bp,ncolsb,cp,first,last);
+      });
+      return;
+   }
+
    const Element *arp0 = ap;                     // Pointer to  A[i,0];
    while (arp0 < ap+na) {
       for (const Element *bcp = bp; bcp < bp+ncolsb; ) { // Pointer to the j-th column of B, Start bcp = B[0,0]
@@ -3100,6 +3152,14 @@ template<class Element>
 void AtMultB(const Element * const ap,Int_t ncolsa,
              const Element * const bp,Int_t nb,Int_t ncolsb,Element *cp)
 {
+   const Double_t nOps = Double_t(nb)*ncolsa;
+   if (nOps >= ROOT::Internal::kMatrixParallelMinOps && ncolsb > 0) {
+      ROOT::Internal::MatrixForEachRange(0,ncolsa,nOps,[&](Int_t first,Int_t last) {
+         MultBlocked(ap,1,ncolsa,nb/ncolsb,bp,ncolsb,cp,first,last);
+      });
+      return;
+   }
+
    const Element *acp0 = ap;           // Pointer to  A[i,0];
    while (acp0 < ap+ncolsa) {
       for (const Element *bcp = bp; bcp < bp+ncolsb; ) { // Pointer to the j-th column of B, Start bcp = B[0,0]
@@ -3124,6 +3184,30 @@ template<class Element>
 void AMultBt(const Element * const ap,Int_t na,Int_t ncolsa,
              const Element * const bp,Int_t nb,Int_t ncolsb,Element *cp)
 {
+   const Double_t nOps = Double_t(na)*(ncolsb > 0 ? nb/ncolsb : 0);
+   if (nOps >= ROOT::Internal::kMatrixParallelMinOps && ncolsa > 0) {
+      // blocks of rows of B which fit in the cache are used for all the rows of A
+      const Int_t nrowsb  = nb/ncolsb;
+      const Int_t blockB  = std::max(1,kBlockK*kBlockJ/ncolsb);
+      ROOT::Internal::MatrixForEachRange(0,na/ncolsa,nOps,[&](Int_t first,Int_t last) {
+         for (Int_t j0 = 0; j0 < nrowsb; j0 += blockB) {
+            const Int_t j1 = std::min(j0+blockB,nrowsb);
+            for (Int_t i = first; i < last; i++) {
+               const Element *arp = ap+i*ncolsa;
+                     Element *crp = cp+i*nrowsb;
+               for (Int_t j = j0; j < j1; j++) {
+                  const Element *brp = bp+j*ncolsb;
+                  Element cij = 0;
+                  for (Int_t k = 0; k < ncolsb; k++)
+                     cij += arp[k]*brp[k];
+                  crp[j] = cij;
+               }
+            }
+         }
+      });
+      return;
+   }
+
    const Element *arp0 = ap;                    // Pointer to  A[i,0];
    while (arp0 < ap+na) {
       const Element *brp0 = bp;                  // Pointer to  B[j,0];
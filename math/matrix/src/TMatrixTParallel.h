@@ -0,0 +1,62 @@
+// @(#)root/matrix:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TMatrixTParallel
+#define ROOT_TMatrixTParallel
+
+// Internal helper of the linear algebra package, not part of the dictionary:
+// split a loop over the rows of a large matrix between the threads of the
+// implicit multi-threading pool.
+
+#include "RConfigure.h"
+#include "Rtypes.h"
+
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#endif
+
+namespace ROOT {
+namespace Internal {
+
+/// Minimal number of multiplications for a loop to be split between threads,
+/// and for the matrix products to use the cache-blocked kernels.
+const Double_t kMatrixParallelMinOps = 262144.;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Call f(begin,end) on sub-ranges of [first,last), in parallel if the
+/// implicit multi-threading is enabled and the loop costs at least
+/// kMatrixParallelMinOps multiplications (nOps). The calls must be
+/// independent: each computes only the elements of its rows, in the same
+/// order as in the serial loop, so that the result does not depend on the
+/// number of threads.
+
+template <class F>
+void MatrixForEachRange(Int_t first, Int_t last, Double_t nOps, const F &f)
+{
+#ifdef R__USE_IMT
+   if (nOps >= kMatrixParallelMinOps && last - first > 1 && ROOT::IsImplicitMTEnabled()) {
+      tbb::parallel_for(tbb::blocked_range<Int_t>(first, last),
+                        [&f](const tbb::blocked_range<Int_t> &r) { f(r.begin(), r.end()); });
+      return;
+   }
+#else
+   (void)nOps;
+#endif
+   if (first < last)
+      f(first, last);
+}
+
+} // namespace Internal
+} // namespace ROOT
+
+#endif
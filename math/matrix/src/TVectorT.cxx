@@ -38,6 +38,7 @@
 #include "TVectorT.h"
 #include "TClass.h"
 #include "TMath.h"
+#include "TMatrixTParallel.h"
 #include "TROOT.h"
 #include "Varargs.h"
 
@@ -1055,16 +1056,18 @@ TVectorT<Element> &TVectorT<Element>::operator*=(const TMatrixTSparse<Element> &
    const Element * const sp = elements_old;
          Element *       tp = this->GetMatrixArray(); // Target vector ptr
 
-   for (Int_t irow = 0; irow < fNrows; irow++) {
-      const Int_t sIndex = pRowIndex[irow];
-      const Int_t eIndex = pRowIndex[irow+1];
-      Element sum = 0.0;
-      for (Int_t index = sIndex; index < eIndex; index++) {
-         const Int_t icol = pColIndex[index];
-         sum += mp[index]*sp[icol];
+   ROOT::Internal::MatrixForEachRange(0,fNrows,a.GetNoElements(),[&](Int_t first,Int_t last) {
+      for (Int_t irow = first; irow < last; irow++) {
+         const Int_t sIndex = pRowIndex[irow];
+         const Int_t eIndex = pRowIndex[irow+1];
+         Element sum = 0.0;
+         for (Int_t index = sIndex; index < eIndex; index++) {
+            const Int_t icol = pColIndex[index];
+            sum += mp[index]*sp[icol];
+         }
+         tp[irow] = sum;
       }
-      tp[irow] = sum;
-   }
+   });
 
    if (isAllocated)
       delete [] elements_old;
@@ -1786,8 +1789,10 @@ TVectorT<Element> &Add(TVectorT<Element> &target,Element scalar,
    const Element * const sp = source.GetMatrixArray(); // Source vector ptr
          Element *       tp = target.GetMatrixArray(); // Target vector ptr
 
-   if (scalar == 1.0) {
-      for (Int_t irow = 0; irow < a.GetNrows(); irow++) {
+   // the rows are independent: they are computed by ranges, in parallel for
+   // a large matrix unless the target is also the source
+   auto multRows = [&](Int_t first,Int_t last) {
+      for (Int_t irow = first; irow < last; irow++) {
          const Int_t sIndex = pRowIndex[irow];
          const Int_t eIndex = pRowIndex[irow+1];
          Element sum = 0.0;
@@ -1795,42 +1800,18 @@ TVectorT<Element> &Add(TVectorT<Element> &target,Element scalar,
             const Int_t icol = pColIndex[index];
             sum += mp[index]*sp[icol];
          }
-         tp[irow] += sum;
+         if (scalar == 1.0)
+            tp[irow] += sum;
+         else if (scalar == 0.0)
+            tp[irow]  = sum;
+         else if (scalar == -1.0)
+            tp[irow] -= sum;
+         else
+            tp[irow] += scalar * sum;
       }
-   } else if (scalar == 0.0) {
-      for (Int_t irow = 0; irow < a.GetNrows(); irow++) {
-         const Int_t sIndex = pRowIndex[irow];
-         const Int_t eIndex = pRowIndex[irow+1];
-         Element sum = 0.0;
-         for (Int_t index = sIndex; index < eIndex; index++) {
-            const Int_t icol = pColIndex[index];
-            sum += mp[index]*sp[icol];
-         }
-         tp[irow]  = sum;
-      }
-   } else if (scalar == -1.0) {
-     for (Int_t irow = 0; irow < a.GetNrows(); irow++) {
-        const Int_t sIndex = pRowIndex[irow];
-        const Int_t eIndex = pRowIndex[irow+1];
-        Element sum = 0.0;
-        for (Int_t index = sIndex; index < eIndex; index++) {
-           const Int_t icol = pColIndex[index];
-           sum += mp[index]*sp[icol];
-        }
-        tp[irow] -= sum;
-      }
-   } else {
-      for (Int_t irow = 0; irow < a.GetNrows(); irow++) {
-        const Int_t sIndex = pRowIndex[irow];
-        const Int_t eIndex = pRowIndex[irow+1];
-        Element sum = 0.0;
-        for (Int_t index = sIndex; index < eIndex; index++) {
-           const Int_t icol = pColIndex[index];
-           sum += mp[index]*sp[icol];
-        }
-        tp[irow] += scalar * sum;
-      }
-   }
+   };
+   const Double_t nOps = (sp != tp) ? a.GetNoElements() : 0.;
+   ROOT::Internal::MatrixForEachRange(0,a.GetNrows(),nOps,multRows);
 
    return target;
 }
@@ -14,6 +14,7 @@
 #include "Minuit2/MnMatrix.h"
 
 #include <vector>
+#include <atomic>
 
 namespace ROOT {
 
@@ -56,7 +57,8 @@ private:
 
 protected:
 
-  mutable int fNumCall;
+  // the FCN can be called from several threads (see MnStrategy::SetGradientParallel)
+  mutable std::atomic<int> fNumCall;
 };
 
   }  // namespace Minuit2
@@ -49,6 +49,8 @@ public:
 
    int StorageLevel() const { return fStoreLevel; }
 
+   bool GradientParallel() const { return fGradParallel; }
+
    bool IsLow() const {return fStrategy == 0;}
    bool IsMedium() const {return fStrategy == 1;}
    bool IsHigh() const {return fStrategy >= 2;}
@@ -69,6 +71,11 @@ public:
    // set storage level of iteration quantities
    // 0 = store only last iterations 1 = full storage (default)
    void SetStorageLevel(unsigned int level) { fStoreLevel = level; }
+
+   // compute the numerical gradient with respect to the different parameters
+   // in parallel, using the ROOT implicit multi-threading pool when it is
+   // enabled (see ROOT::EnableImplicitMT). The FCN must be thread safe.
+   void SetGradientParallel(bool on) { fGradParallel = on; }
 private:
 
    unsigned int fStrategy;
@@ -81,6 +88,7 @@ private:
    double fHessTlrG2;
    unsigned int fHessGradNCyc;
    int fStoreLevel;
+   bool fGradParallel;
 };
 
   }  // namespace Minuit2
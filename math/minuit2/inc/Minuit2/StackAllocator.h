@@ -12,10 +12,10 @@
 
 #include "Minuit2/MnConfig.h"
 
-// comment out this line and recompile if you want to gain additional
+// define MN_USE_STACK_ALLOC and recompile if you want to gain additional
 // performance (the gain is mainly for "simple" functions which are easy
 // to calculate and vanishes quickly if going to cost-intensive functions)
-// the library is no longer thread save however
+// each thread then uses its own stack, so that the library stays thread safe
 
 #ifdef MN_USE_STACK_ALLOC
 #define _MN_NO_THREAD_SAVE_
@@ -26,7 +26,14 @@
 
 
 #include <cstdlib>
+#include <cstring>
 #include <new>
+#ifdef _MN_NO_THREAD_SAVE_
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#endif
 
 namespace ROOT {
 
@@ -45,8 +52,15 @@ class StackError {};
 /** StackAllocator controls the memory allocation/deallocation of Minuit. If
     _MN_NO_THREAD_SAVE_ is defined, memory is taken from a pre-allocated piece
     of heap memory which is then used like a stack, otherwise via standard
-    malloc/free. Note that defining _MN_NO_THREAD_SAVE_ makes the code thread-
-    unsave. The gain in performance is mainly for cost-cheap FCN functions.
+    malloc/free. The gain in performance is mainly for cost-cheap FCN functions.
+
+    Each thread has its own stack (see StackAllocatorHolder), allocated at its
+    first allocation with the size given by SetStackSize, so that concurrent
+    fits share no state. When its stack is full, a thread takes the memory
+    from the heap. A block released by another thread than the one which
+    allocated it (e.g. a FunctionMinimum returned by a worker thread) is
+    handed back to the stack of its thread, which releases it at its next
+    allocation.
  */
 
 class StackAllocator {
@@ -57,12 +71,13 @@ public:
   enum {default_size = 524288};
 
    StackAllocator() :   fStack(0)  {
-#ifdef _MN_NO_THREAD_SAVE_
-    //std::cout<<"StackAllocator Allocate "<<default_size<<std::endl;
-    fStack = new unsigned char[default_size];
-#endif
+    fStackSize = 0;
     fStackOffset = 0;
     fBlockCount = 0;
+#ifdef _MN_NO_THREAD_SAVE_
+    fPending = 0;
+    fOrphan = false;
+#endif
   }
 
   ~StackAllocator() {
@@ -72,11 +87,21 @@ public:
 #endif
   }
 
+  /// size in bytes of the stacks allocated from now on (default_size by default)
+  static void SetStackSize(size_t nBytes) { StackSizeRef() = nBytes; }
+  static size_t StackSize() { return StackSizeRef(); }
+
   void* Allocate( size_t nBytes) {
 #ifdef _MN_NO_THREAD_SAVE_
-    if(fStack == 0) fStack = new unsigned char[default_size];
+      if(fPending.load(std::memory_order_relaxed)) DeallocatePending();
+      if(fStack == 0) CreateStack();
+      if(nBytes >= fStackSize || fStackOffset + AlignedSize(nBytes) >= int(fStackSize)) {
+         // no more space on the stack: use the heap
+         void* result = malloc(nBytes);
+         if (!result) throw std::bad_alloc();
+         return result;
+      }
       int nAlloc = AlignedSize(nBytes);
-      CheckOverflow(nAlloc);
 
 //       std::cout << "Allocating " << nAlloc << " bytes, requested = " << nBytes << std::endl;
 
@@ -103,6 +128,20 @@ public:
 
   void Deallocate( void* p) {
 #ifdef _MN_NO_THREAD_SAVE_
+      if(Owns(p)) DeallocateLocal(p);
+      else DeallocateForeign(p);
+#else
+      free(p);
+#endif
+  }
+
+#ifdef _MN_NO_THREAD_SAVE_
+  bool Owns( void* p) const {
+      unsigned char* pc = static_cast<unsigned char*>(p);
+      return fStack != 0 && pc >= fStack && pc < fStack + fStackSize;
+  }
+
+  void DeallocateLocal( void* p) {
       // int previousOffset = ReadInt( fStackOffset - sizeof(int));
       int delBlock = ToInt(p);
       int nextBlock = ReadInt( delBlock);
@@ -122,14 +161,66 @@ public:
 
 #ifdef DEBUG_ALLOCATOR
       CheckConsistency();
-#endif
-#else
-      free(p);
 #endif
       // std::cout << "Block at " << delBlock
       //   << " deallocated, fStackOffset = " << fStackOffset << std::endl;
   }
 
+  /// release a block which is not on the stack of the calling thread: it is
+  /// on the stack of another thread, else it comes from the heap
+  static void DeallocateForeign( void* p) {
+      std::lock_guard<std::mutex> lock(RegistryMutex());
+      std::vector<StackAllocator*> & stacks = Registry();
+      for (std::vector<StackAllocator*>::iterator itr = stacks.begin(); itr != stacks.end(); ++itr) {
+         StackAllocator* owner = *itr;
+         if (!owner->Owns(p)) continue;
+         if (owner->fOrphan) {
+            // its thread has exited: nobody else uses the stack
+            owner->DeallocateLocal(p);
+            if (owner->fBlockCount == 0) {
+               stacks.erase(itr);
+               delete owner;
+            }
+         } else {
+            // let the thread release the block: push it on the pending list,
+            // using the block itself to store the link
+            void* head = owner->fPending.load(std::memory_order_relaxed);
+            do {
+               memcpy(p, &head, sizeof(void*));
+            } while (!owner->fPending.compare_exchange_weak(head, p, std::memory_order_release,
+                                                            std::memory_order_relaxed));
+         }
+         return;
+      }
+      free(p);
+  }
+
+  /// release the blocks handed back by other threads
+  void DeallocatePending() {
+      void* p = fPending.exchange(0, std::memory_order_acquire);
+      while (p) {
+         void* next;
+         memcpy(&next, p, sizeof(void*));
+         DeallocateLocal(p);
+         p = next;
+      }
+  }
+
+  /// called when the thread owning the allocator exits: delete it, unless
+  /// some of its blocks are still in use
+  static void Release( StackAllocator* stack) {
+      std::lock_guard<std::mutex> lock(RegistryMutex());
+      stack->DeallocatePending();
+      if (stack->fBlockCount == 0) {
+         std::vector<StackAllocator*> & stacks = Registry();
+         stacks.erase(std::remove(stacks.begin(), stacks.end(), stack), stacks.end());
+         delete stack;
+      } else {
+         stack->fOrphan = true;
+      }
+  }
+#endif
+
   int ReadInt( int offset) {
       int* ip = (int*)(fStack+offset);
 
@@ -157,12 +248,14 @@ public:
 
   int AlignedSize( int nBytes) {
       const int fAlignment = 4;
+      // a released block must be able to hold the link of the pending list
+      if (nBytes < int(sizeof(void*))) nBytes = sizeof(void*);
       int needed = nBytes % fAlignment == 0 ? nBytes : (nBytes/fAlignment+1)*fAlignment;
       return needed + 2*sizeof(int);
   }
 
   void CheckOverflow( int n) {
-      if (fStackOffset + n >= default_size) {
+      if (fStackOffset + n >= int(fStackSize)) {
          //std::cout << " no more space on stack allocator" << std::endl;
          throw StackOverflow();
       }
@@ -204,10 +297,45 @@ public:
 
 private:
 
+  StackAllocator(const StackAllocator&); // not implemented
+  StackAllocator& operator=(const StackAllocator&); // not implemented
+
+  static size_t & StackSizeRef() {
+     static size_t gStackSize = default_size;
+     return gStackSize;
+  }
+
+#ifdef _MN_NO_THREAD_SAVE_
+  void CreateStack() {
+     std::lock_guard<std::mutex> lock(RegistryMutex());
+     fStackSize = StackSize();
+     //std::cout<<"StackAllocator Allocate "<<fStackSize<<std::endl;
+     fStack = new unsigned char[fStackSize];
+     Registry().push_back(this);
+  }
+
+  // the stacks of all the threads, to find the owner of a block released by
+  // another thread; never deleted, as blocks can be released at exit
+  static std::mutex & RegistryMutex() {
+     static std::mutex* gMutex = new std::mutex;
+     return *gMutex;
+  }
+
+  static std::vector<StackAllocator*> & Registry() {
+     static std::vector<StackAllocator*>* gRegistry = new std::vector<StackAllocator*>;
+     return *gRegistry;
+  }
+#endif
+
   unsigned char* fStack;
 //   unsigned char fStack[default_size];
+  size_t         fStackSize;
   int            fStackOffset;
   int            fBlockCount;
+#ifdef _MN_NO_THREAD_SAVE_
+  std::atomic<void*> fPending;  // blocks released by other threads
+  bool           fOrphan;       // the thread owning the stack has exited
+#endif
 
 };
 
@@ -218,12 +346,28 @@ class StackAllocatorHolder {
   // t.b.d need to use same trick as  Boost singleton.hpp to be sure that
   // StackAllocator is created before main()
 
+#ifdef _MN_NO_THREAD_SAVE_
+  // the stack of a thread, released when the thread exits
+  struct ThreadStack {
+     ThreadStack() : fAllocator(new StackAllocator) {}
+     ~ThreadStack() { StackAllocator::Release(fAllocator); }
+     StackAllocator* fAllocator;
+  };
+#endif
+
  public:
 
 
   static StackAllocator & Get() {
+#ifdef _MN_NO_THREAD_SAVE_
+    // one stack per thread
+    static thread_local ThreadStack gThreadStack;
+    return *gThreadStack.fAllocator;
+#else
+    // malloc and free are thread safe
     static StackAllocator gStackAllocator;
     return gStackAllocator;
+#endif
   }
 };
 
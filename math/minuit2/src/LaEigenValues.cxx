@@ -10,11 +10,42 @@
 #include "Minuit2/LAVector.h"
 #include "Minuit2/LASymMatrix.h"
 
+#ifdef MINUIT2_USE_BLAS
+#include <vector>
+
+// eigenvalues of a symmetric matrix in packed storage from LAPACK
+extern "C" void dspev_(const char* jobz, const char* uplo, const int* n, double* ap, double* w,
+                       double* z, const int* ldz, double* work, int* info);
+#endif
+
 namespace ROOT {
 
    namespace Minuit2 {
 
 
+#ifdef MINUIT2_USE_BLAS
+
+LAVector eigenvalues(const LASymMatrix& mat) {
+   // calculate eigenvalues of symmetric matrices with the LAPACK routine DSPEV,
+   // which uses the same packed storage as LASymMatrix and also returns them in
+   // increasing order
+   int nrow = mat.Nrow();
+
+   std::vector<double> ap(mat.Data(), mat.Data() + mat.size());
+   std::vector<double> work(3*nrow);
+   double z = 0.;
+   int ldz = 1;
+   int info = 0;
+   LAVector result(nrow);
+   dspev_("N", "U", &nrow, &ap[0], result.Data(), &z, &ldz, &work[0], &info);
+   (void)info;
+   assert(info == 0);
+
+   return result;
+}
+
+#else
+
 int mneigen(double*, unsigned int, unsigned int, unsigned int, double*,double);
 
 LAVector eigenvalues(const LASymMatrix& mat) {
@@ -40,6 +71,8 @@ LAVector eigenvalues(const LASymMatrix& mat) {
    return result;
 }
 
+#endif
+
    }  // namespace Minuit2
 
 }  // namespace ROOT
@@ -456,6 +456,12 @@ bool Minuit2Minimizer::Minimize() {
       bool ret = minuit2Opt->GetValue("StorageLevel",storageLevel);
       if (ret) SetStorageLevel(storageLevel);
 
+      // the user declares that the function can be called from several
+      // threads at the same time
+      int gradParallel = 0;
+      minuit2Opt->GetValue("GradientParallel",gradParallel);
+      strategy.SetGradientParallel(gradParallel != 0);
+
       if (printLevel > 0) {
          std::cout << "Minuit2Minimizer::Minuit  - Changing default options" << std::endl;
          minuit2Opt->Print();
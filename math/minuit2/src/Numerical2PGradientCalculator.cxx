@@ -33,6 +33,15 @@
 
 #include "Minuit2/MPIProcess.h"
 
+// R__USE_IMT is defined only when Minuit2 is built inside ROOT
+#ifdef USE_ROOT_ERROR
+#include "RConfigure.h"
+#endif
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/parallel_for.h"
+#endif
+
 namespace ROOT {
 
    namespace Minuit2 {
@@ -111,37 +120,10 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
    std::cout.precision(pr);
 #endif
 
-#ifndef _OPENMP
-   // for serial execution this can be outside the loop
-   MnAlgebraicVector x = par.Vec();
-
-   unsigned int startElementIndex = mpiproc.StartElementIndex();
-   unsigned int endElementIndex = mpiproc.EndElementIndex();
-
-   for(unsigned int i = startElementIndex; i < endElementIndex; i++) {
-
-#else
-
- // parallelize this loop using OpenMP
-//#define N_PARALLEL_PAR 5
-#pragma omp parallel
-#pragma omp for
-//#pragma omp for schedule (static, N_PARALLEL_PAR)
-
-   for(int i = 0; i < int(n); i++) {
-
-#endif
-
-#ifdef DEBUG_MP
-      int ith = omp_get_thread_num();
-      //std::cout << "Thread number " << ith << "  " << i << std::endl;
-#endif
-
-#ifdef _OPENMP
-       // create in loop since each thread will use its own copy
-      MnAlgebraicVector x = par.Vec();
-#endif
-
+   // compute the derivatives with respect to parameter i, moving x(i) and
+   // restoring it at the end: only the elements i of grd, g2 and gstep are
+   // modified, so that different parameters can be computed at the same time
+   auto derivative = [&](unsigned int i, MnAlgebraicVector & x) {
       double xtf = x(i);
       double epspri = eps2 + fabs(grd(i)*eps2);
       double stepb4 = 0.;
@@ -183,10 +165,10 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
          g2(i) = (fs1 + fs2 - 2.*fcnmin)/step/step;
 
 #ifdef DEBUG
-         pr = std::cout.precision(13);
+         int prc = std::cout.precision(13);
          std::cout << "cycle " << j << " x " << x(i) << " step " << step << " f1 " << fs1 << " f2 " << fs2
                    << " grd " << grd(i) << " g2 " << g2(i) << std::endl;
-         std::cout.precision(pr);
+         std::cout.precision(prc);
 #endif
 
          if(fabs(grdb4-grd(i))/(fabs(grd(i))+dfmin/step) < GradTolerance())  {
@@ -198,6 +180,60 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
          }
       }
 
+#ifdef DEBUG
+      int prp = std::cout.precision(13);
+      int iext = Trafo().ExtOfInt(i);
+      std::cout << "Parameter " << Trafo().Name(iext) << " Gradient =   " << grd(i) << " g2 = " << g2(i) << " step " << gstep(i) << std::endl;
+      std::cout.precision(prp);
+#endif
+   };
+
+#if defined(R__USE_IMT) && !defined(_OPENMP) && !defined(MPIPROC)
+   // parallelize the loop on the parameters with the ROOT implicit
+   // multi-threading pool, if requested by the strategy: the FCN must then
+   // be thread safe, as it is called at the same time from several threads
+   if (Strategy().GradientParallel() && ROOT::IsImplicitMTEnabled() && n > 1) {
+      tbb::parallel_for(0u, n, [&](unsigned int i) {
+         // each task uses its own copy of the parameters
+         MnAlgebraicVector x = par.Vec();
+         derivative(i, x);
+      });
+      return FunctionGradient(grd, g2, gstep);
+   }
+#endif
+
+#ifndef _OPENMP
+   // for serial execution this can be outside the loop
+   MnAlgebraicVector x = par.Vec();
+
+   unsigned int startElementIndex = mpiproc.StartElementIndex();
+   unsigned int endElementIndex = mpiproc.EndElementIndex();
+
+   for(unsigned int i = startElementIndex; i < endElementIndex; i++) {
+
+#else
+
+ // parallelize this loop using OpenMP
+//#define N_PARALLEL_PAR 5
+#pragma omp parallel
+#pragma omp for
+//#pragma omp for schedule (static, N_PARALLEL_PAR)
+
+   for(int i = 0; i < int(n); i++) {
+
+#endif
+
+#ifdef DEBUG_MP
+      int ith = omp_get_thread_num();
+      //std::cout << "Thread number " << ith << "  " << i << std::endl;
+#endif
+
+#ifdef _OPENMP
+       // create in loop since each thread will use its own copy
+      MnAlgebraicVector x = par.Vec();
+#endif
+
+      derivative(i, x);
 
 #ifdef DEBUG_MP
 #pragma omp critical
@@ -209,14 +245,6 @@ FunctionGradient Numerical2PGradientCalculator::operator()(const MinimumParamete
       //     vgrd(i) = grd;
       //     vgrd2(i) = g2;
       //     vgstp(i) = gstep;
-
-
-#ifdef DEBUG
-      pr = std::cout.precision(13);
-      int iext = Trafo().ExtOfInt(i);
-      std::cout << "Parameter " << Trafo().Name(iext) << " Gradient =   " << grd(i) << " g2 = " << g2(i) << " step " << gstep(i) << std::endl;
-      std::cout.precision(pr);
-#endif
    }
 
 #ifndef _OPENMP
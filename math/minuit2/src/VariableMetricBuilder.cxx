@@ -27,6 +27,12 @@
 //#define DEBUG
 #include "Minuit2/MnPrint.h"
 
+#ifdef USE_ROOT_ERROR
+#include "ROOT/TTrace.hxx"
+#else
+#define R__TRACE_ZONE(name, category)
+#endif
+
 // #if defined(DEBUG) || defined(WARNINGMSG)
 // #endif
 
@@ -268,6 +274,8 @@ FunctionMinimum VariableMetricBuilder::Minimum(const MnFcn& fcn, const GradientC
 
    do {
 
+      R__TRACE_ZONE("VariableMetricBuilder::Iteration", "minuit2");
+
       //MinimumState s0 = result.back();
 
       step = -1.*s0.Error().InvHessian()*s0.Gradient().Vec();
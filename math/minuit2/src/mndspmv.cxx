@@ -17,6 +17,23 @@ namespace ROOT {
    namespace Minuit2 {
 
 
+#ifdef MINUIT2_USE_BLAS
+
+// use the optimized DSPMV of the BLAS library
+extern "C" void dspmv_(const char* uplo, const int* n, const double* alpha,
+                       const double* ap, const double* x, const int* incx,
+                       const double* beta, double* y, const int* incy);
+
+int Mndspmv(const char* uplo, unsigned int n, double alpha,
+            const double* ap, const double* x, int incx, double beta,
+            double* y, int incy) {
+   int nn = n;
+   dspmv_(uplo, &nn, &alpha, ap, x, &incx, &beta, y, &incy);
+   return 0;
+}
+
+#else
+
 bool mnlsame(const char*, const char*);
 int mnxerbla(const char*, int);
 
@@ -316,6 +333,8 @@ int Mndspmv(const char* uplo, unsigned int n, double alpha,
 
 } /* dspmv_ */
 
+#endif
+
 
    }  // namespace Minuit2
 
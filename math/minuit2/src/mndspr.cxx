@@ -17,6 +17,21 @@ namespace ROOT {
    namespace Minuit2 {
 
 
+#ifdef MINUIT2_USE_BLAS
+
+// use the optimized DSPR of the BLAS library
+extern "C" void dspr_(const char* uplo, const int* n, const double* alpha,
+                      const double* x, const int* incx, double* ap);
+
+int mndspr(const char* uplo, unsigned int n, double alpha,
+           const double* x, int incx, double* ap) {
+   int nn = n;
+   dspr_(uplo, &nn, &alpha, x, &incx, ap);
+   return 0;
+}
+
+#else
+
 bool mnlsame(const char*, const char*);
 int mnxerbla(const char*, int);
 
@@ -241,6 +256,8 @@ int mndspr(const char* uplo, unsigned int n, double alpha,
 
 } /* dspr_ */
 
+#endif
+
 
    }  // namespace Minuit2
 
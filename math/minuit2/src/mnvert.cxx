@@ -11,11 +11,45 @@
 
 #include <cmath>
 
+#ifdef MINUIT2_USE_BLAS
+#include <vector>
+
+// factorization and inversion of a symmetric matrix in packed storage from LAPACK
+extern "C" void dsptrf_(const char* uplo, const int* n, double* ap, int* ipiv, int* info);
+extern "C" void dsptri_(const char* uplo, const int* n, double* ap, const int* ipiv,
+                        double* work, int* info);
+#endif
+
 namespace ROOT {
 
    namespace Minuit2 {
 
 
+#ifdef MINUIT2_USE_BLAS
+
+/** Inverts a symmetric matrix with the Bunch-Kaufman factorization of LAPACK
+    (DSPTRF and DSPTRI), which uses the same packed storage as LASymMatrix.
+    As the version below, fails for a negative diagonal element or a
+    singular matrix.
+ */
+
+int mnvert(MnAlgebraicSymMatrix& a) {
+
+   int nrow = a.Nrow();
+   for(int i = 0; i < nrow; i++)
+      if (a(i,i) < 0.) return 1;
+
+   std::vector<int> ipiv(nrow);
+   std::vector<double> work(nrow);
+   int info = 0;
+   dsptrf_("U", &nrow, a.Data(), &ipiv[0], &info);
+   if (info != 0) return 1;
+   dsptri_("U", &nrow, a.Data(), &ipiv[0], &work[0], &info);
+   return (info != 0) ? 1 : 0;
+}
+
+#else
+
 /** Inverts a symmetric matrix. Matrix is first scaled to have all ones on
     the diagonal (equivalent to change of units) but no pivoting is done
     since matrix is positive-definite.
@@ -71,6 +105,8 @@ int mnvert(MnAlgebraicSymMatrix& a) {
    return 0;
 }
 
+#endif
+
    }  // namespace Minuit2
 
 }  // namespace ROOT
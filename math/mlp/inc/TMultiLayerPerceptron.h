@@ -32,6 +32,7 @@ class TTree;
 class TEventList;
 class TTreeFormula;
 class TTreeFormulaManager;
+class TMLPDenseNetwork;
 
 //____________________________________________________________________
 //
@@ -179,6 +180,7 @@ class TMultiLayerPerceptron : public TObject {
    Int_t fReset;                   //! number of epochs between two resets of the search direction to the steepest descent - Default=50
    Bool_t fTrainingOwner;          //! internal flag whether one has to delete fTraining or not
    Bool_t fTestOwner;              //! internal flag whether one has to delete fTest or not
+   TMLPDenseNetwork *fDenseNetwork; //! dense copy of the network and of the events, used during the training
    ClassDef(TMultiLayerPerceptron, 4) // a Neural Network
 };
 
@@ -47,6 +47,7 @@ class TFormula;
 
 class TNeuron : public TNamed {
    friend class TSynapse;
+   friend class TMLPDenseNetwork;
 
  public:
    enum ENeuronType { kOff, kLinear, kSigmoid, kTanh, kGauss, kSoftmax, kExternal };
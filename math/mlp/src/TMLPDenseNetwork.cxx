@@ -0,0 +1,506 @@
+// @(#)root/mlp:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////////
+//
+// TMLPDenseNetwork
+//
+// Dense copy of a TMultiLayerPerceptron used during the training.
+// The weights are stored in the order of the buffers of
+// TMultiLayerPerceptron::Train: the neurons of fNetwork, then the
+// synapses of fSynapses. Since the network is built layer by layer,
+// the synapses ending in a layer form a matrix, whose row i holds the
+// weights from the previous layer to its neuron i.
+//
+// Each quantity is computed with the same operations, in the same order,
+// as by TNeuron and TSynapse; only the sums over the events are split in
+// chunks.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "TMLPDenseNetwork.h"
+#include "TSynapse.h"
+#include "TNeuron.h"
+#include "TMath.h"
+#include "TROOT.h"
+#include "ROOT/TSeq.hxx"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
+#include <float.h>
+
+namespace {
+   // The events are split in at most kMaxChunks chunks of at least
+   // kMinChunkSize events.
+   const Int_t kMinChunkSize = 256;
+   const Int_t kMaxChunks = 64;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Default constructor
+
+TMLPDenseNetwork::TMLPDenseNetwork() : fOutType(TNeuron::kLinear)
+{
+   for (Int_t i = 0; i < 2; i++)
+      fData[i].fN = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Returns the dense copy of the network made of the neurons in network
+/// and the synapses in synapses, or 0 if it cannot be represented:
+/// the network must be made of fully connected layers, built as in
+/// TMultiLayerPerceptron::BuildNetwork, and its hidden neurons must not
+/// be of type kSoftmax or kExternal.
+/// outType is the type of the output neurons of the perceptron, which
+/// defines the error function.
+
+TMLPDenseNetwork *TMLPDenseNetwork::Create(const TObjArray &network, const TObjArray &firstLayer,
+                                           const TObjArray &lastLayer, const TObjArray &synapses,
+                                           TNeuron::ENeuronType outType)
+{
+   TMLPDenseNetwork *dense = new TMLPDenseNetwork;
+   dense->fOutType = outType;
+   Int_t nentries = network.GetEntriesFast();
+   for (Int_t i = 0; i < nentries; i++)
+      dense->fNeurons.push_back((TNeuron *) network.UncheckedAt(i));
+   nentries = synapses.GetEntriesFast();
+   for (Int_t i = 0; i < nentries; i++)
+      dense->fSynapses.push_back((TSynapse *) synapses.UncheckedAt(i));
+   if (!dense->BuildLayers(firstLayer, lastLayer)) {
+      delete dense;
+      return 0;
+   }
+   dense->ReadWeights();
+   return dense;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Finds the layers of the network and checks that TNeuron and TSynapse
+/// would compute the same quantities as the dense arrays.
+
+Bool_t TMLPDenseNetwork::BuildLayers(const TObjArray &firstLayer, const TObjArray &lastLayer)
+{
+   const Int_t nNeurons = fNeurons.size();
+   const Int_t nSynapses = fSynapses.size();
+   const Int_t nIn = firstLayer.GetEntriesFast();
+   const Int_t nOut = lastLayer.GetEntriesFast();
+   if (!nIn || !nOut || nIn + nOut > nNeurons)
+      return false;
+   for (Int_t i = 0; i < nIn; i++) {
+      if (fNeurons[i] != firstLayer.UncheckedAt(i) || fNeurons[i]->fpre.GetEntriesFast())
+         return false;
+   }
+   Layer input = {nIn, 0, 0, TNeuron::kOff};
+   fLayers.push_back(input);
+
+   // Each layer is made of the consecutive neurons fed by the previous one.
+   Int_t pos = nIn;
+   Int_t nSyn = 0;
+   while (pos < nNeurons) {
+      const Layer prev = fLayers.back();
+      Layer layer = {0, pos, nSyn, fNeurons[pos]->fType};
+      while (pos + layer.fSize < nNeurons) {
+         TNeuron *neuron = fNeurons[pos + layer.fSize];
+         if (neuron->fpre.GetEntriesFast() != prev.fSize ||
+             ((TSynapse *) neuron->fpre.UncheckedAt(0))->GetPre() != fNeurons[prev.fNeuronOffset])
+            break;
+         layer.fSize++;
+      }
+      if (!layer.fSize || nSyn + layer.fSize * prev.fSize > nSynapses)
+         return false;
+      for (Int_t i = 0; i < layer.fSize; i++) {
+         TNeuron *neuron = fNeurons[pos + i];
+         if (neuron->fType != layer.fType)
+            return false;
+         for (Int_t j = 0; j < prev.fSize; j++) {
+            TSynapse *synapse = fSynapses[nSyn + i * prev.fSize + j];
+            if (neuron->fpre.UncheckedAt(j) != synapse ||
+                synapse->GetPre() != fNeurons[prev.fNeuronOffset + j] || synapse->GetPost() != neuron)
+               return false;
+         }
+      }
+      nSyn += layer.fSize * prev.fSize;
+      pos += layer.fSize;
+      fLayers.push_back(layer);
+   }
+   const Int_t nLayers = fLayers.size();
+   if (nLayers < 2 || nSyn != nSynapses)
+      return false;
+
+   // The output layer must be fLastLayer
+   const Layer &out = fLayers.back();
+   if (out.fSize != nOut)
+      return false;
+   for (Int_t i = 0; i < nOut; i++) {
+      TNeuron *neuron = fNeurons[out.fNeuronOffset + i];
+      if (neuron != lastLayer.UncheckedAt(i) || neuron->fpost.GetEntriesFast())
+         return false;
+   }
+   if (out.fType == TNeuron::kExternal)
+      return false;
+   if (out.fType == TNeuron::kSoftmax) {
+      // the normalization is the sum over the layer, in its order
+      for (Int_t i = 0; i < nOut; i++) {
+         TNeuron *neuron = fNeurons[out.fNeuronOffset + i];
+         if (neuron->flayer.GetEntriesFast() != nOut)
+            return false;
+         for (Int_t k = 0; k < nOut; k++) {
+            if (neuron->flayer.UncheckedAt(k) != fNeurons[out.fNeuronOffset + k])
+               return false;
+         }
+      }
+   }
+
+   // The hidden neurons sum the DeDw of the next layer in its order
+   for (Int_t l = 1; l < nLayers - 1; l++) {
+      const Layer &layer = fLayers[l];
+      const Layer &next = fLayers[l + 1];
+      if (layer.fType == TNeuron::kSoftmax || layer.fType == TNeuron::kExternal)
+         return false;
+      for (Int_t j = 0; j < layer.fSize; j++) {
+         TNeuron *neuron = fNeurons[layer.fNeuronOffset + j];
+         if (neuron->fpost.GetEntriesFast() != next.fSize)
+            return false;
+         for (Int_t k = 0; k < next.fSize; k++) {
+            if (neuron->fpost.UncheckedAt(k) != fSynapses[next.fSynapseOffset + k * layer.fSize + j])
+               return false;
+         }
+      }
+   }
+   return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copies the current weights of the neurons and synapses.
+
+void TMLPDenseNetwork::ReadWeights()
+{
+   const Int_t nNeurons = fNeurons.size();
+   const Int_t nSynapses = fSynapses.size();
+   fParams.resize(nNeurons + nSynapses);
+   for (Int_t i = 0; i < nNeurons; i++)
+      fParams[i] = fNeurons[i]->GetWeight();
+   for (Int_t i = 0; i < nSynapses; i++)
+      fParams[nNeurons + i] = fSynapses[i]->GetWeight();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Adds to set the event loaded in the network, with the given event and
+/// tree weights: the values of the input neurons and the targets of the
+/// output neurons are stored.
+
+void TMLPDenseNetwork::AddEvent(TMultiLayerPerceptron::EDataSet set, Double_t weight, Double_t treeWeight)
+{
+   DataSet &data = fData[set];
+   const Layer &in = fLayers.front();
+   const Layer &out = fLayers.back();
+   for (Int_t i = 0; i < in.fSize; i++)
+      data.fInputs.push_back(fNeurons[in.fNeuronOffset + i]->GetValue());
+   for (Int_t i = 0; i < out.fSize; i++)
+      data.fTargets.push_back(fNeurons[out.fNeuronOffset + i]->GetTarget());
+   data.fWeights.push_back(weight);
+   data.fTreeWeights.push_back(treeWeight);
+   data.fN++;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Allocates the buffers of one event.
+
+void TMLPDenseNetwork::InitWorkspace(Workspace &ws) const
+{
+   const Int_t nLayers = fLayers.size();
+   ws.fInput.resize(nLayers);
+   ws.fValue.resize(nLayers);
+   ws.fDeDw.resize(nLayers);
+   for (Int_t l = 0; l < nLayers; l++) {
+      ws.fInput[l].assign(fLayers[l].fSize, 0.);
+      ws.fValue[l].assign(fLayers[l].fSize, 0.);
+      ws.fDeDw[l].assign(fLayers[l].fSize, 0.);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Computes the input and the output of all the neurons, as
+/// TNeuron::GetInput() and TNeuron::GetValue().
+
+void TMLPDenseNetwork::Forward(const Double_t *inputs, Workspace &ws) const
+{
+   const Int_t nNeurons = fNeurons.size();
+   const Int_t nLayers = fLayers.size();
+   for (Int_t i = 0; i < fLayers[0].fSize; i++)
+      ws.fValue[0][i] = inputs[i];
+   for (Int_t l = 1; l < nLayers; l++) {
+      const Layer &layer = fLayers[l];
+      const Int_t nPrev = fLayers[l - 1].fSize;
+      const Double_t *prev = &ws.fValue[l - 1][0];
+      const Double_t *bias = &fParams[layer.fNeuronOffset];
+      const Double_t *w = &fParams[nNeurons + layer.fSynapseOffset];
+      Double_t *input = &ws.fInput[l][0];
+      Double_t *value = &ws.fValue[l][0];
+      for (Int_t i = 0; i < layer.fSize; i++) {
+         Double_t x = bias[i];
+         const Double_t *row = w + i * nPrev;
+         for (Int_t j = 0; j < nPrev; j++)
+            x += row[j] * prev[j];
+         input[i] = x;
+      }
+      switch (layer.fType) {
+      case TNeuron::kLinear:
+         for (Int_t i = 0; i < layer.fSize; i++)
+            value[i] = input[i];
+         break;
+      case TNeuron::kSigmoid:
+         for (Int_t i = 0; i < layer.fSize; i++)
+            value[i] = fNeurons[0]->Sigmoid(input[i]);
+         break;
+      case TNeuron::kTanh:
+         for (Int_t i = 0; i < layer.fSize; i++)
+            value[i] = TMath::TanH(input[i]);
+         break;
+      case TNeuron::kGauss:
+         for (Int_t i = 0; i < layer.fSize; i++)
+            value[i] = TMath::Exp(-input[i] * input[i]);
+         break;
+      case TNeuron::kSoftmax: {
+         Double_t normalization = 0.0;
+         for (Int_t i = 0; i < layer.fSize; i++)
+            normalization += TMath::Exp(input[i]);
+         for (Int_t i = 0; i < layer.fSize; i++)
+            value[i] = (normalization > 0.0) ? TMath::Exp(input[i]) / normalization : 1.0 / layer.fSize;
+         break;
+      }
+      default:
+         for (Int_t i = 0; i < layer.fSize; i++)
+            value[i] = 0;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Computes the derivative of the error wrt the weight of all the neurons
+/// of the event processed by Forward(), as TNeuron::GetDeDw().
+
+void TMLPDenseNetwork::Backward(const Double_t *targets, Workspace &ws) const
+{
+   const Int_t nNeurons = fNeurons.size();
+   const Int_t nLayers = fLayers.size();
+   const Layer &out = fLayers[nLayers - 1];
+   for (Int_t k = 0; k < out.fSize; k++)
+      ws.fDeDw[nLayers - 1][k] = ws.fValue[nLayers - 1][k] - targets[k];
+   for (Int_t l = nLayers - 2; l > 0; l--) {
+      const Layer &layer = fLayers[l];
+      const Layer &next = fLayers[l + 1];
+      const Double_t *w = &fParams[nNeurons + next.fSynapseOffset];
+      const Double_t *nextDeDw = &ws.fDeDw[l + 1][0];
+      for (Int_t j = 0; j < layer.fSize; j++) {
+         Double_t dedw = 0.0;
+         for (Int_t k = 0; k < next.fSize; k++)
+            dedw += w[k * layer.fSize + j] * nextDeDw[k];
+         dedw *= GetDerivative(layer.fType, ws.fInput[l][j]);
+         ws.fDeDw[l][j] = dedw;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Derivative of the activation function of the given type, as
+/// TNeuron::GetDerivative().
+
+Double_t TMLPDenseNetwork::GetDerivative(TNeuron::ENeuronType type, Double_t input) const
+{
+   switch (type) {
+   case TNeuron::kLinear:
+      return 1;
+   case TNeuron::kSigmoid:
+      return fNeurons[0]->DSigmoid(input);
+   case TNeuron::kTanh:
+      return (1 - (TMath::TanH(input) * TMath::TanH(input)));
+   case TNeuron::kGauss:
+      return (-2) * input * TMath::Exp(-input * input);
+   default:
+      return 0;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Error of the event processed by Forward(), without its weights, as
+/// TMultiLayerPerceptron::GetCrossEntropyBinary(), GetCrossEntropy() or
+/// GetSumSquareError().
+
+Double_t TMLPDenseNetwork::GetEventError(const Double_t *targets, const Workspace &ws) const
+{
+   const Int_t nOut = fLayers.back().fSize;
+   const Double_t *value = &ws.fValue.back()[0];
+   Double_t error = 0;
+   switch (fOutType) {
+   case TNeuron::kSigmoid:
+      for (Int_t i = 0; i < nOut; i++) {
+         Double_t output = value[i];
+         Double_t target = targets[i];
+         if (target < DBL_EPSILON) {
+            if (output == 1.0)
+               error = DBL_MAX;
+            else
+               error -= TMath::Log(1 - output);
+         } else
+         if ((1 - target) < DBL_EPSILON) {
+            if (output == 0.0)
+               error = DBL_MAX;
+            else
+               error -= TMath::Log(output);
+         } else {
+            if (output == 0.0 || output == 1.0)
+               error = DBL_MAX;
+            else
+               error -= target * TMath::Log(output / target) + (1-target) * TMath::Log((1 - output)/(1 - target));
+         }
+      }
+      return error;
+   case TNeuron::kSoftmax:
+      for (Int_t i = 0; i < nOut; i++) {
+         Double_t output = value[i];
+         Double_t target = targets[i];
+         if (target > DBL_EPSILON) {
+            if (output == 0.0)
+               error = DBL_MAX;
+            else
+               error -= target * TMath::Log(output / target);
+         }
+      }
+      return error;
+   default:
+      for (Int_t i = 0; i < nOut; i++) {
+         Double_t diff = value[i] - targets[i];
+         error += diff * diff;
+      }
+      return (error / 2.);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Returns the number of chunks of nEvents events, and their size.
+
+Int_t TMLPDenseNetwork::GetNChunks(Int_t nEvents, Int_t &chunkSize) const
+{
+   chunkSize = (nEvents + kMaxChunks - 1) / kMaxChunks;
+   if (chunkSize < kMinChunkSize)
+      chunkSize = kMinChunkSize;
+   return (nEvents + chunkSize - 1) / chunkSize;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calls func for each chunk, in parallel if the implicit multi-threading
+/// is enabled.
+
+void TMLPDenseNetwork::ForEachChunk(Int_t nChunks, const std::function<void(Int_t)> &func) const
+{
+#ifdef R__USE_IMT
+   if (nChunks > 1 && ROOT::IsImplicitMTEnabled()) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(func, ROOT::TSeqI(nChunks));
+      return;
+   }
+#endif
+   for (Int_t c = 0; c < nChunks; c++)
+      func(c);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Computes the DEDw of all the neurons and synapses, as
+/// TMultiLayerPerceptron::ComputeDEDw(), and sets them.
+
+void TMLPDenseNetwork::ComputeDEDw()
+{
+   ReadWeights();
+   const DataSet &data = fData[TMultiLayerPerceptron::kTraining];
+   const Int_t nNeurons = fNeurons.size();
+   const Int_t nSynapses = fSynapses.size();
+   const Int_t nParams = fParams.size();
+   const Int_t nLayers = fLayers.size();
+   const Int_t nIn = fLayers.front().fSize;
+   const Int_t nOut = fLayers.back().fSize;
+   Int_t chunkSize = 0;
+   const Int_t nChunks = GetNChunks(data.fN, chunkSize);
+   std::vector<std::vector<Double_t> > partial(nChunks);
+
+   ForEachChunk(nChunks, [&](Int_t c) {
+      std::vector<Double_t> &sum = partial[c];
+      sum.assign(nParams, 0.);
+      Workspace ws;
+      InitWorkspace(ws);
+      const Int_t last = TMath::Min((c + 1) * chunkSize, data.fN);
+      for (Int_t e = c * chunkSize; e < last; e++) {
+         Forward(&data.fInputs[(size_t) e * nIn], ws);
+         Backward(&data.fTargets[(size_t) e * nOut], ws);
+         Double_t eventWeight = data.fWeights[e];
+         eventWeight *= data.fTreeWeights[e];
+         for (Int_t l = 1; l < nLayers; l++) {
+            const Layer &layer = fLayers[l];
+            const Int_t nPrev = fLayers[l - 1].fSize;
+            const Double_t *prev = &ws.fValue[l - 1][0];
+            const Double_t *dedw = &ws.fDeDw[l][0];
+            Double_t *neuronSum = &sum[layer.fNeuronOffset];
+            Double_t *synapseSum = &sum[nNeurons + layer.fSynapseOffset];
+            for (Int_t i = 0; i < layer.fSize; i++) {
+               neuronSum[i] += dedw[i] * eventWeight;
+               Double_t *row = synapseSum + i * nPrev;
+               for (Int_t j = 0; j < nPrev; j++)
+                  row[j] += (prev[j] * dedw[i]) * eventWeight;
+            }
+         }
+      }
+   });
+
+   std::vector<Double_t> total(nParams, 0.);
+   for (Int_t c = 0; c < nChunks; c++) {
+      for (Int_t k = 0; k < nParams; k++)
+         total[k] += partial[c][k];
+   }
+   for (Int_t i = 0; i < nNeurons; i++)
+      fNeurons[i]->SetDEDw(total[i] / (Double_t) data.fN);
+   for (Int_t i = 0; i < nSynapses; i++)
+      fSynapses[i]->SetDEDw(total[nNeurons + i] / (Double_t) data.fN);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Error on the whole dataset, as TMultiLayerPerceptron::GetError().
+
+Double_t TMLPDenseNetwork::GetError(TMultiLayerPerceptron::EDataSet set)
+{
+   ReadWeights();
+   const DataSet &data = fData[set];
+   const Int_t nIn = fLayers.front().fSize;
+   const Int_t nOut = fLayers.back().fSize;
+   Int_t chunkSize = 0;
+   const Int_t nChunks = GetNChunks(data.fN, chunkSize);
+   std::vector<Double_t> partial(nChunks, 0.);
+
+   ForEachChunk(nChunks, [&](Int_t c) {
+      Workspace ws;
+      InitWorkspace(ws);
+      Double_t sum = 0;
+      const Int_t last = TMath::Min((c + 1) * chunkSize, data.fN);
+      for (Int_t e = c * chunkSize; e < last; e++) {
+         Forward(&data.fInputs[(size_t) e * nIn], ws);
+         Double_t error = GetEventError(&data.fTargets[(size_t) e * nOut], ws);
+         error *= data.fWeights[e];
+         error *= data.fTreeWeights[e];
+         sum += error;
+      }
+      partial[c] = sum;
+   });
+
+   Double_t error = 0;
+   for (Int_t c = 0; c < nChunks; c++)
+      error += partial[c];
+   return error;
+}
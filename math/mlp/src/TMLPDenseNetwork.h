@@ -0,0 +1,93 @@
+// @(#)root/mlp:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TMLPDenseNetwork
+#define ROOT_TMLPDenseNetwork
+
+//////////////////////////////////////////////////////////////////////////
+//
+// TMLPDenseNetwork
+//
+// Internal helper of TMultiLayerPerceptron::Train. It holds a copy of
+// the weights of a layered network in contiguous arrays, and of the
+// normalized inputs, targets and weights of the training and test events,
+// so that the error and its derivatives are computed without reading the
+// tree again nor going through the TNeuron and TSynapse objects.
+//
+// The events are processed in chunks whose size only depends on their
+// number; the chunks run in parallel when the implicit multi-threading
+// is enabled, and their partial sums are added in order, so that the
+// results do not depend on the number of threads.
+//
+// This class is not part of the dictionary.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "TMultiLayerPerceptron.h"
+
+#include <functional>
+#include <vector>
+
+class TSynapse;
+
+class TMLPDenseNetwork {
+public:
+   static TMLPDenseNetwork *Create(const TObjArray &network, const TObjArray &firstLayer,
+                                   const TObjArray &lastLayer, const TObjArray &synapses,
+                                   TNeuron::ENeuronType outType);
+
+   void AddEvent(TMultiLayerPerceptron::EDataSet set, Double_t weight, Double_t treeWeight);
+   void ComputeDEDw();
+   Double_t GetError(TMultiLayerPerceptron::EDataSet set);
+
+private:
+   struct Layer {
+      Int_t fSize;                // number of neurons
+      Int_t fNeuronOffset;        // index of the first neuron in the network
+      Int_t fSynapseOffset;       // index of the first synapse ending in this layer
+      TNeuron::ENeuronType fType; // type of the neurons
+   };
+   struct DataSet {
+      Int_t fN;                          // number of events
+      std::vector<Double_t> fInputs;     // normalized inputs, fN x the size of the first layer
+      std::vector<Double_t> fTargets;    // normalized targets, fN x the size of the last layer
+      std::vector<Double_t> fWeights;    // weights of the events
+      std::vector<Double_t> fTreeWeights;// weights of the trees of the events
+   };
+   struct Workspace {
+      std::vector<std::vector<Double_t> > fInput; // input of each neuron, by layer
+      std::vector<std::vector<Double_t> > fValue; // output of each neuron, by layer
+      std::vector<std::vector<Double_t> > fDeDw;  // derivative of the error wrt the neuron weight, by layer
+   };
+
+   TMLPDenseNetwork();
+   TMLPDenseNetwork(const TMLPDenseNetwork &);            // Not implemented
+   TMLPDenseNetwork &operator=(const TMLPDenseNetwork &); // Not implemented
+
+   Bool_t BuildLayers(const TObjArray &firstLayer, const TObjArray &lastLayer);
+   void ReadWeights();
+   void InitWorkspace(Workspace &ws) const;
+   void Forward(const Double_t *inputs, Workspace &ws) const;
+   void Backward(const Double_t *targets, Workspace &ws) const;
+   Double_t GetEventError(const Double_t *targets, const Workspace &ws) const;
+   Double_t GetDerivative(TNeuron::ENeuronType type, Double_t input) const;
+   Int_t GetNChunks(Int_t nEvents, Int_t &chunkSize) const;
+   void ForEachChunk(Int_t nChunks, const std::function<void(Int_t)> &func) const;
+
+   std::vector<Layer> fLayers;        // the layers, from the input to the output one
+   std::vector<TNeuron *> fNeurons;   // the neurons, in the order of TMultiLayerPerceptron::fNetwork
+   std::vector<TSynapse *> fSynapses; // the synapses, in the order of TMultiLayerPerceptron::fSynapses
+   std::vector<Double_t> fParams;     // weights of the neurons, then of the synapses
+   TNeuron::ENeuronType fOutType;     // type of the output neurons, which defines the error
+   DataSet fData[2];                  // training and test events
+};
+
+#endif
@@ -221,6 +221,7 @@ In addition, the paw version of mlpfit had additional limitations on the number
 #include "TMultiLayerPerceptron.h"
 #include "TSynapse.h"
 #include "TNeuron.h"
+#include "TMLPDenseNetwork.h"
 #include "TClass.h"
 #include "TTree.h"
 #include "TEventList.h"
@@ -259,6 +260,7 @@ TMultiLayerPerceptron::TMultiLayerPerceptron()
    fData = 0;
    fCurrentTree = -1;
    fCurrentTreeWeight = 1;
+   fDenseNetwork = 0;
    fStructure = "";
    fWeight = "1";
    fTraining = 0;
@@ -314,6 +316,7 @@ TMultiLayerPerceptron::TMultiLayerPerceptron(const char * layout, TTree * data,
    fData = data;
    fCurrentTree = -1;
    fCurrentTreeWeight = 1;
+   fDenseNetwork = 0;
    fTraining = training;
    fTrainingOwner = false;
    fTest = test;
@@ -373,6 +376,7 @@ TMultiLayerPerceptron::TMultiLayerPerceptron(const char * layout,
    fData = data;
    fCurrentTree = -1;
    fCurrentTreeWeight = 1;
+   fDenseNetwork = 0;
    fTraining = training;
    fTrainingOwner = false;
    fTest = test;
@@ -432,6 +436,7 @@ TMultiLayerPerceptron::TMultiLayerPerceptron(const char * layout, TTree * data,
    fData = data;
    fCurrentTree = -1;
    fCurrentTreeWeight = 1;
+   fDenseNetwork = 0;
    fTraining = new TEventList(Form("fTrainingList_%lu",(ULong_t)this));
    fTrainingOwner = true;
    fTest = new TEventList(Form("fTestList_%lu",(ULong_t)this));
@@ -499,6 +504,7 @@ TMultiLayerPerceptron::TMultiLayerPerceptron(const char * layout,
    fData = data;
    fCurrentTree = -1;
    fCurrentTreeWeight = 1;
+   fDenseNetwork = 0;
    fTraining = new TEventList(Form("fTrainingList_%lu",(ULong_t)this));
    fTrainingOwner = true;
    fTest = new TEventList(Form("fTestList_%lu",(ULong_t)this));
@@ -538,6 +544,7 @@ TMultiLayerPerceptron::~TMultiLayerPerceptron()
 {
    if(fTraining && fTrainingOwner) delete fTraining;
    if(fTest && fTestOwner) delete fTest;
+   delete fDenseNetwork;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -734,6 +741,13 @@ void TMultiLayerPerceptron::GetEntry(Int_t entry) const
 /// - "minErrorTrain" (stop when NN error on the training sample gets below minE
 /// - "minErrorTest" (stop when NN error on the test sample gets below minE
 /// All combinations are available.
+///
+/// Unless the network has hidden neurons of type kSoftmax or kExternal,
+/// the inputs, targets and weights of the training and test events are
+/// read once and kept in memory during the training. The error and its
+/// derivatives are then computed over chunks of events, in parallel if
+/// the implicit multi-threading is enabled (see ROOT::EnableImplicitMT());
+/// the results do not depend on the number of threads.
 
 void TMultiLayerPerceptron::Train(Int_t nEpoch, Option_t * option, Double_t minE)
 {
@@ -796,6 +810,20 @@ void TMultiLayerPerceptron::Train(Int_t nEpoch, Option_t * option, Double_t minE
    // If the option "+" is not set, one has to randomize the weights first
    if (!opt.Contains("+"))
       Randomize();
+   // Load the events once in a dense copy of the network, if it can be
+   // represented this way.
+   delete fDenseNetwork;
+   fDenseNetwork = TMLPDenseNetwork::Create(fNetwork, fFirstLayer, fLastLayer, fSynapses, fOutType);
+   if (fDenseNetwork) {
+      for (i = 0; i < fTraining->GetN(); i++) {
+         GetEntry(fTraining->GetEntry(i));
+         fDenseNetwork->AddEvent(TMultiLayerPerceptron::kTraining, fEventWeight->EvalInstance(), fCurrentTreeWeight);
+      }
+      for (i = 0; i < fTest->GetN(); i++) {
+         GetEntry(fTest->GetEntry(i));
+         fDenseNetwork->AddEvent(TMultiLayerPerceptron::kTest, fEventWeight->EvalInstance(), fCurrentTreeWeight);
+      }
+   }
    // Initialisation
    fLastAlpha = 0;
    Int_t els = fNetwork.GetEntriesFast() + fSynapses.GetEntriesFast();
@@ -963,6 +991,8 @@ void TMultiLayerPerceptron::Train(Int_t nEpoch, Option_t * option, Double_t minE
    // Cleaning
    delete [] buffer;
    delete [] dir;
+   delete fDenseNetwork;
+   fDenseNetwork = 0;
    // Final Text and Graph outputs
    if (verbosity % 2)
       std::cout << "Training done." << std::endl;
@@ -1020,10 +1050,15 @@ Double_t TMultiLayerPerceptron::GetError(Int_t event) const
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Error on the whole dataset
+/// Error on the whole dataset.
+/// During Train(), it is computed from the events loaded in memory at the
+/// beginning of the training, in parallel if the implicit multi-threading
+/// is enabled.
 
 Double_t TMultiLayerPerceptron::GetError(TMultiLayerPerceptron::EDataSet set) const
 {
+   if (fDenseNetwork)
+      return fDenseNetwork->GetError(set);
    TEventList *list =
        ((set == TMultiLayerPerceptron::kTraining) ? fTraining : fTest);
    Double_t error = 0;
@@ -1109,9 +1144,16 @@ Double_t TMultiLayerPerceptron::GetCrossEntropy() const
 ////////////////////////////////////////////////////////////////////////////////
 /// Compute the DEDw = sum on all training events of dedw for each weight
 /// normalized by the number of events.
+/// During Train(), it is computed from the events loaded in memory at the
+/// beginning of the training, in parallel if the implicit multi-threading
+/// is enabled.
 
 void TMultiLayerPerceptron::ComputeDEDw() const
 {
+   if (fDenseNetwork) {
+      fDenseNetwork->ComputeDEDw();
+      return;
+   }
    Int_t i,j;
    Int_t nentries = fSynapses.GetEntriesFast();
    TSynapse *synapse;
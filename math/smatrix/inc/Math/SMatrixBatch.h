@@ -0,0 +1,385 @@
+// @(#)root/smatrix:$Id$
+// Author: ROOT core team   October 2016
+
+#ifndef ROOT_Math_SMatrixBatch
+#define ROOT_Math_SMatrixBatch
+
+/** @file
+ * header file containing SMatrixBatch and SVectorBatch, which hold N
+ * fixed size matrices or vectors in structure-of-arrays layout, and the
+ * operations on them (sum, product, similarity, inversion of symmetric
+ * positive definite matrices), computed for the N of them at the same time
+ */
+
+#include "Math/SMatrix.h"
+#include "Math/SVector.h"
+
+#include <cmath>
+
+namespace ROOT {
+
+   namespace Math {
+
+/**
+   N vectors of dimension D, stored in structure-of-arrays layout: the
+   elements i of the N vectors are contiguous, so that the operations on
+   SVectorBatch and SMatrixBatch, which loop on the N vectors in their inner
+   loop, are vectorized by the compiler.
+
+   @ingroup SMatrixSVector
+*/
+template <class T, unsigned int D, unsigned int N = 8>
+class SVectorBatch {
+
+public:
+
+   typedef T value_type;
+
+   enum {
+      /// vector size
+      kSize = D,
+      /// number of vectors of the batch
+      kBatch = N
+   };
+
+   /// elements are not initialized
+   SVectorBatch() {}
+
+   /// element i of vector n
+   T  operator()(unsigned int i, unsigned int n) const { return fArray[i][n]; }
+   T& operator()(unsigned int i, unsigned int n)       { return fArray[i][n]; }
+
+   /// the elements i of the N vectors
+   const T *Lanes(unsigned int i) const { return fArray[i]; }
+   T       *Lanes(unsigned int i)       { return fArray[i]; }
+
+   /// set vector n of the batch
+   void Set(unsigned int n, const SVector<T,D> &v) {
+      for (unsigned int i = 0; i < D; ++i) fArray[i][n] = v[i];
+   }
+
+   /// return vector n of the batch
+   SVector<T,D> Get(unsigned int n) const {
+      SVector<T,D> v;
+      for (unsigned int i = 0; i < D; ++i) v[i] = fArray[i][n];
+      return v;
+   }
+
+   SVectorBatch &operator+=(const SVectorBatch &rhs) {
+      for (unsigned int i = 0; i < D; ++i)
+         for (unsigned int n = 0; n < N; ++n) fArray[i][n] += rhs.fArray[i][n];
+      return *this;
+   }
+
+   SVectorBatch &operator-=(const SVectorBatch &rhs) {
+      for (unsigned int i = 0; i < D; ++i)
+         for (unsigned int n = 0; n < N; ++n) fArray[i][n] -= rhs.fArray[i][n];
+      return *this;
+   }
+
+   SVectorBatch &operator*=(const T &rhs) {
+      for (unsigned int i = 0; i < D; ++i)
+         for (unsigned int n = 0; n < N; ++n) fArray[i][n] *= rhs;
+      return *this;
+   }
+
+private:
+
+   T fArray[D][N];
+};
+
+/**
+   N matrices of dimension D1 x D2, stored in structure-of-arrays layout:
+   the elements (i,j) of the N matrices are contiguous. The operations loop
+   on the N matrices in their inner loop, so that they are vectorized by the
+   compiler across the matrices, e.g. for the Kalman filter of N tracks:
+   @code
+   SMatrixBatch<double,5,5,8> cov, jac;
+   for (unsigned int n = 0; n < 8; ++n) {
+      cov.Set(n, track[n].Covariance());   // SMatrix<double,5,5,MatRepSym<double,5> >
+      jac.Set(n, track[n].Jacobian());
+   }
+   SMatrixBatch<double,5,5,8> prop = Similarity(jac, cov);
+   bool ok[8];
+   prop.InvertChol(ok);
+   @endcode
+   All the matrices are stored with their D1*D2 elements; symmetric
+   matrices set from a SMatrix with MatRepSym are expanded, and Get returns
+   the symmetric part when asked for a MatRepSym matrix.
+
+   @ingroup SMatrixSVector
+*/
+template <class T, unsigned int D1, unsigned int D2 = D1, unsigned int N = 8>
+class SMatrixBatch {
+
+public:
+
+   typedef T value_type;
+
+   enum {
+      /// return no. of matrix rows
+      kRows = D1,
+      /// return no. of matrix columns
+      kCols = D2,
+      /// return no of elements: rows*columns
+      kSize = D1*D2,
+      /// number of matrices of the batch
+      kBatch = N
+   };
+
+   /// elements are not initialized
+   SMatrixBatch() {}
+
+   /// element (i,j) of matrix n
+   T  operator()(unsigned int i, unsigned int j, unsigned int n) const { return fArray[i*D2+j][n]; }
+   T& operator()(unsigned int i, unsigned int j, unsigned int n)       { return fArray[i*D2+j][n]; }
+
+   /// the elements (i,j) of the N matrices
+   const T *Lanes(unsigned int i, unsigned int j) const { return fArray[i*D2+j]; }
+   T       *Lanes(unsigned int i, unsigned int j)       { return fArray[i*D2+j]; }
+
+   /// set matrix n of the batch
+   template <class R>
+   void Set(unsigned int n, const SMatrix<T,D1,D2,R> &m) {
+      for (unsigned int i = 0; i < D1; ++i)
+         for (unsigned int j = 0; j < D2; ++j) fArray[i*D2+j][n] = m(i,j);
+   }
+
+   /// return matrix n of the batch
+   template <class R>
+   void Get(unsigned int n, SMatrix<T,D1,D2,R> &m) const {
+      for (unsigned int i = 0; i < D1; ++i)
+         for (unsigned int j = 0; j < D2; ++j) m(i,j) = fArray[i*D2+j][n];
+   }
+
+   SMatrix<T,D1,D2> Get(unsigned int n) const {
+      SMatrix<T,D1,D2> m;
+      Get(n, m);
+      return m;
+   }
+
+   SMatrixBatch &operator+=(const SMatrixBatch &rhs) {
+      for (unsigned int k = 0; k < kSize; ++k)
+         for (unsigned int n = 0; n < N; ++n) fArray[k][n] += rhs.fArray[k][n];
+      return *this;
+   }
+
+   SMatrixBatch &operator-=(const SMatrixBatch &rhs) {
+      for (unsigned int k = 0; k < kSize; ++k)
+         for (unsigned int n = 0; n < N; ++n) fArray[k][n] -= rhs.fArray[k][n];
+      return *this;
+   }
+
+   SMatrixBatch &operator*=(const T &rhs) {
+      for (unsigned int k = 0; k < kSize; ++k)
+         for (unsigned int n = 0; n < N; ++n) fArray[k][n] *= rhs;
+      return *this;
+   }
+
+   /**
+      invert the N symmetric positive definite matrices with a Cholesky
+      decomposition, as SMatrix::InvertChol. Only the lower triangle is used.
+      The matrices which are not positive definite are left unchanged; ok, if
+      given, receives for each matrix if it was inverted. Return true if all
+      the matrices were inverted.
+   */
+   bool InvertChol(bool *ok = 0);
+
+private:
+
+   T fArray[D1*D2][N];
+};
+
+
+//==============================================================================
+// operations on batches
+//==============================================================================
+
+template <class T, unsigned int D1, unsigned int D2, unsigned int N>
+inline SMatrixBatch<T,D1,D2,N> operator+(const SMatrixBatch<T,D1,D2,N> &lhs, const SMatrixBatch<T,D1,D2,N> &rhs) {
+   SMatrixBatch<T,D1,D2,N> result(lhs);
+   return result += rhs;
+}
+
+template <class T, unsigned int D1, unsigned int D2, unsigned int N>
+inline SMatrixBatch<T,D1,D2,N> operator-(const SMatrixBatch<T,D1,D2,N> &lhs, const SMatrixBatch<T,D1,D2,N> &rhs) {
+   SMatrixBatch<T,D1,D2,N> result(lhs);
+   return result -= rhs;
+}
+
+template <class T, unsigned int D, unsigned int N>
+inline SVectorBatch<T,D,N> operator+(const SVectorBatch<T,D,N> &lhs, const SVectorBatch<T,D,N> &rhs) {
+   SVectorBatch<T,D,N> result(lhs);
+   return result += rhs;
+}
+
+template <class T, unsigned int D, unsigned int N>
+inline SVectorBatch<T,D,N> operator-(const SVectorBatch<T,D,N> &lhs, const SVectorBatch<T,D,N> &rhs) {
+   SVectorBatch<T,D,N> result(lhs);
+   return result -= rhs;
+}
+
+/// products A*B of the N matrices
+template <class T, unsigned int D1, unsigned int D2, unsigned int D3, unsigned int N>
+inline SMatrixBatch<T,D1,D3,N> operator*(const SMatrixBatch<T,D1,D2,N> &lhs, const SMatrixBatch<T,D2,D3,N> &rhs) {
+   SMatrixBatch<T,D1,D3,N> result;
+   for (unsigned int i = 0; i < D1; ++i) {
+      for (unsigned int j = 0; j < D3; ++j) {
+         T *r = result.Lanes(i,j);
+         for (unsigned int n = 0; n < N; ++n) r[n] = T(0);
+         for (unsigned int k = 0; k < D2; ++k) {
+            const T *a = lhs.Lanes(i,k);
+            const T *b = rhs.Lanes(k,j);
+            for (unsigned int n = 0; n < N; ++n) r[n] += a[n]*b[n];
+         }
+      }
+   }
+   return result;
+}
+
+/// products A*v of the N matrices and vectors
+template <class T, unsigned int D1, unsigned int D2, unsigned int N>
+inline SVectorBatch<T,D1,N> operator*(const SMatrixBatch<T,D1,D2,N> &lhs, const SVectorBatch<T,D2,N> &rhs) {
+   SVectorBatch<T,D1,N> result;
+   for (unsigned int i = 0; i < D1; ++i) {
+      T *r = result.Lanes(i);
+      for (unsigned int n = 0; n < N; ++n) r[n] = T(0);
+      for (unsigned int k = 0; k < D2; ++k) {
+         const T *a = lhs.Lanes(i,k);
+         const T *v = rhs.Lanes(k);
+         for (unsigned int n = 0; n < N; ++n) r[n] += a[n]*v[n];
+      }
+   }
+   return result;
+}
+
+/// transposes of the N matrices
+template <class T, unsigned int D1, unsigned int D2, unsigned int N>
+inline SMatrixBatch<T,D2,D1,N> Transpose(const SMatrixBatch<T,D1,D2,N> &rhs) {
+   SMatrixBatch<T,D2,D1,N> result;
+   for (unsigned int i = 0; i < D1; ++i)
+      for (unsigned int j = 0; j < D2; ++j) {
+         const T *a = rhs.Lanes(i,j);
+         T *r = result.Lanes(j,i);
+         for (unsigned int n = 0; n < N; ++n) r[n] = a[n];
+      }
+   return result;
+}
+
+/**
+   similarities U*S*U^T of the N matrices, with S symmetric: the result is
+   symmetric, only its lower triangle is computed and copied to the upper one
+*/
+template <class T, unsigned int D1, unsigned int D2, unsigned int N>
+inline SMatrixBatch<T,D1,D1,N> Similarity(const SMatrixBatch<T,D1,D2,N> &lhs, const SMatrixBatch<T,D2,D2,N> &rhs) {
+   const SMatrixBatch<T,D1,D2,N> tmp = lhs * rhs;
+   SMatrixBatch<T,D1,D1,N> result;
+   for (unsigned int i = 0; i < D1; ++i) {
+      for (unsigned int j = 0; j <= i; ++j) {
+         T *r = result.Lanes(i,j);
+         for (unsigned int n = 0; n < N; ++n) r[n] = T(0);
+         for (unsigned int k = 0; k < D2; ++k) {
+            const T *a = tmp.Lanes(i,k);
+            const T *u = lhs.Lanes(j,k);
+            for (unsigned int n = 0; n < N; ++n) r[n] += a[n]*u[n];
+         }
+         T *rt = result.Lanes(j,i);
+         for (unsigned int n = 0; n < N; ++n) rt[n] = r[n];
+      }
+   }
+   return result;
+}
+
+/// similarities v^T*S*v of the N vectors and matrices, stored in result[N]
+template <class T, unsigned int D, unsigned int N>
+inline void Similarity(const SVectorBatch<T,D,N> &lhs, const SMatrixBatch<T,D,D,N> &rhs, T *result) {
+   const SVectorBatch<T,D,N> tmp = rhs * lhs;
+   for (unsigned int n = 0; n < N; ++n) result[n] = T(0);
+   for (unsigned int i = 0; i < D; ++i) {
+      const T *a = tmp.Lanes(i);
+      const T *v = lhs.Lanes(i);
+      for (unsigned int n = 0; n < N; ++n) result[n] += a[n]*v[n];
+   }
+}
+
+template <class T, unsigned int D1, unsigned int D2, unsigned int N>
+bool SMatrixBatch<T,D1,D2,N>::InvertChol(bool *ok)
+{
+   STATIC_CHECK( D1 == D2, SMatrixBatch_InvertChol_requires_square_matrices);
+   const unsigned int D = D1;
+
+   // Cholesky decomposition M = L L^T of the N matrices, as in
+   // CholeskyDecompHelpers::_decomposerGenDim: L(i,j) is at (i*(i+1))/2+j and
+   // the diagonal holds the reciprocals of the elements of L
+   T l[D*(D+1)/2][N];
+   bool valid[N];
+   for (unsigned int n = 0; n < N; ++n) valid[n] = true;
+   for (unsigned int i = 0; i < D; ++i) {
+      const unsigned int bi = (i*(i+1))/2;
+      T tmpdiag[N];
+      for (unsigned int n = 0; n < N; ++n) tmpdiag[n] = T(0);
+      for (unsigned int j = 0; j < i; ++j) {
+         const unsigned int bj = (j*(j+1))/2;
+         T tmp[N];
+         for (unsigned int n = 0; n < N; ++n) tmp[n] = fArray[i*D+j][n];
+         for (unsigned int k = j; k--; )
+            for (unsigned int n = 0; n < N; ++n) tmp[n] -= l[bi+k][n]*l[bj+k][n];
+         for (unsigned int n = 0; n < N; ++n) {
+            l[bi+j][n] = tmp[n] *= l[bj+j][n];
+            tmpdiag[n] += tmp[n]*tmp[n];
+         }
+      }
+      for (unsigned int n = 0; n < N; ++n) {
+         const T d = fArray[i*D+i][n] - tmpdiag[n];
+         // a matrix which is not positive definite goes on with a diagonal
+         // element 1, to avoid branches and invalid operations
+         const bool pos = d > T(0);
+         valid[n] = valid[n] && pos;
+         l[bi+i][n] = std::sqrt(T(1)/(pos ? d : T(1)));
+      }
+   }
+
+   // invert the off-diagonal part of L, as in CholeskyDecompHelpers::_inverterGenDim
+   for (unsigned int i = 1; i < D; ++i) {
+      const unsigned int bi = (i*(i+1))/2;
+      for (unsigned int j = 0; j < i; ++j) {
+         T tmp[N];
+         for (unsigned int n = 0; n < N; ++n) tmp[n] = T(0);
+         for (unsigned int k = i; k-- > j; ) {
+            const unsigned int bk = (k*(k+1))/2;
+            for (unsigned int n = 0; n < N; ++n) tmp[n] -= l[bi+k][n]*l[bk+j][n];
+         }
+         for (unsigned int n = 0; n < N; ++n) l[bi+j][n] = tmp[n]*l[bi+i][n];
+      }
+   }
+
+   // M^(-1) = Li^T Li, stored only for the matrices which were inverted
+   bool all = true;
+   for (unsigned int n = 0; n < N; ++n) {
+      if (ok) ok[n] = valid[n];
+      all = all && valid[n];
+   }
+   for (unsigned int i = 0; i < D; ++i) {
+      for (unsigned int j = 0; j <= i; ++j) {
+         T tmp[N];
+         for (unsigned int n = 0; n < N; ++n) tmp[n] = T(0);
+         for (unsigned int k = D; k-- > i; ) {
+            const unsigned int bk = (k*(k+1))/2;
+            for (unsigned int n = 0; n < N; ++n) tmp[n] += l[bk+i][n]*l[bk+j][n];
+         }
+         T *mij = fArray[i*D+j];
+         T *mji = fArray[j*D+i];
+         for (unsigned int n = 0; n < N; ++n) {
+            mij[n] = valid[n] ? tmp[n] : mij[n];
+            mji[n] = valid[n] ? tmp[n] : mji[n];
+         }
+      }
+   }
+   return all;
+}
+
+  }  // namespace Math
+
+}  // namespace ROOT
+
+#endif
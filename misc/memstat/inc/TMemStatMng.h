@@ -81,6 +81,8 @@ namespace Memstat {
 
    class TMemStatMng: public TObject {
       typedef std::map<SCustomDigest, Int_t> CRCSet_t;
+      typedef std::map<ULong64_t, std::pair<Int_t, Long64_t> > LiveSamples_t;
+      typedef std::map<Int_t, std::pair<Long64_t, Int_t> > LiveSites_t;
 
    private:
       TMemStatMng();
@@ -93,6 +95,8 @@ namespace Memstat {
       static void Close();                 //close MemStatManager
       void SetBufferSize(Int_t buffersize);
       void SetMaxCalls(Int_t maxcalls);
+      void SetSamplingInterval(Long64_t nbytes);   //record one allocation every nbytes on average, 0 records all
+      void SetSnapshotInterval(Double_t seconds);  //time between two snapshots of the sampled live heap
 
    public:
       //stack data members
@@ -106,8 +110,12 @@ namespace Memstat {
       TMemStatHook::FreeHookFunc_t fPreviousFreeHook;        //!old free function
 #endif
       void Init();
-      void AddPointer(void *ptr, Int_t size);    //add pointer to the table
+      Int_t AddPointer(void *ptr, Int_t size);   //add pointer to the table, returns its back trace identifier
       void FillTree();
+      Bool_t SampleAllocation(size_t size);
+      void AddSample(void *ptr, Int_t size);
+      void RemoveSample(void *ptr);
+      void FillSnapshot();
       static void *AllocHook(size_t size, const void* /*caller*/);
       static void FreeHook(void* ptr, const void* /*caller*/);
       static void MacAllocHook(void *ptr, size_t size);
@@ -139,6 +147,18 @@ namespace Memstat {
       Int_t     *fIndex;      //array to sort fBufPos
       Bool_t    *fMustWrite;  //flag to write or not the entry
 
+      //  sampling mode
+      Long64_t  fSamplingInterval; //mean number of bytes between two sampled allocations, 0 if not sampling
+      Double_t  fSnapshotInterval; //time in seconds between two snapshots of the live heap
+      Double_t  fLastSnapshot;     //time of the last snapshot
+      TTree    *fHeapTree;         //!tree of the snapshots of the live heap by call site
+      Int_t     fHeapTimems;       //10000*(snapshot time - begin time)
+      Int_t     fHeapBtID;         //back trace identifier of the call site
+      Long64_t  fHeapNBytes;       //estimated number of live bytes allocated at the call site
+      Int_t     fHeapNSamples;     //number of live sampled allocations of the call site
+      LiveSamples_t fLiveSamples;  //!sampled allocations not freed yet, by address
+      LiveSites_t   fLiveSites;    //!estimated live bytes and samples, by back trace identifier
+
    private:
       TMemStatFAddrContainer fFAddrs;
       TObjArray *fFAddrsList;
@@ -47,6 +47,16 @@
 //    Root.TMemStat.buffersize  100000
 //    Root.TMemStat.maxcalls    5000000
 //
+// Recording every call is too slow for production jobs. With the option
+// "sampling=N", e.g. TMemStat mm("gnubuiltin sampling=524288"), only one
+// allocation every N bytes on average is recorded (with its free), picked
+// by a Poisson process on the allocated bytes, so the overhead is of a few
+// percent. Every 10 seconds, a second Tree "H" then receives the estimated
+// live heap by call site: for each back trace id "btid" the live bytes
+// "nbytes" and the live sampled allocations "nsamples" at the time "time".
+// The sampling interval is set in $ROOTSYS/etc/system.rootrc with
+//    Root.TMemStat.sampling    524288
+//
 // TMemStat::Show creates 3 canvases.
 // -In canvas1 it displays a dynamic histogram showing for pages (10 kbytes by default)
 //  the percentage of the page used.
@@ -104,6 +114,8 @@ _INIT_TOP_STACK;
 /// Supported options:
 ///    "gnubuiltin" - if declared, then MemStat will use gcc build-in function,
 ///                      otherwise glibc backtrace will be used
+///    "sampling=N" - record one allocation every N bytes on average, see
+///                      TMemStatMng::SetSamplingInterval
 ///
 /// Note: Currently MemStat uses a hard-coded output file name (for writing) = "memstat.root";
 
@@ -116,6 +128,7 @@ TMemStat::TMemStat(Option_t* option, Int_t buffersize, Int_t maxcalls): fIsActiv
    TDirectory::TContext context;
 
    Bool_t useBuiltin = kTRUE;
+   Long64_t sampling = 0;
    // Define string in a scope, so that the deletion of it will be not recorded by YAMS
    {
       string opt(option);
@@ -123,11 +136,15 @@ TMemStat::TMemStat(Option_t* option, Int_t buffersize, Int_t maxcalls): fIsActiv
                 Memstat::ToLower_t());
 
       useBuiltin = (opt.find("gnubuiltin") != string::npos) ? kTRUE : kFALSE;
+      string::size_type pos = opt.find("sampling=");
+      if (pos != string::npos)
+         sampling = strtoll(opt.c_str() + pos + 9, 0, 10);
    }
 
    TMemStatMng::GetInstance()->SetUseGNUBuiltinBacktrace(useBuiltin);
    TMemStatMng::GetInstance()->SetBufferSize(buffersize);
    TMemStatMng::GetInstance()->SetMaxCalls(maxcalls);
+   TMemStatMng::GetInstance()->SetSamplingInterval(sampling);
    TMemStatMng::GetInstance()->Enable();
    // set this variable only if "NEW" mode is active
    fIsActive = kTRUE;
@@ -22,6 +22,8 @@
 #include "TH1.h"
 #include "TMD5.h"
 #include "TMath.h"
+#include "TDirectory.h"
+#include "ThreadLocalStorage.h"
 // Memstat
 #include "TMemStatBacktrace.h"
 #include "TMemStatMng.h"
@@ -32,6 +34,21 @@ ClassImp(TMemStatMng)
 
 TMemStatMng* TMemStatMng::fgInstance = NULL;
 
+namespace {
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Distance in bytes to the next sampled byte, exponentially distributed with
+   /// the given mean, drawn with the xorshift generator state of the thread.
+
+   Long64_t NextSampleDistance(ULong64_t &state, Long64_t mean)
+   {
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      Double_t u = (Double_t(state >> 11) + 0.5) / 9007199254740992.;   // in (0,1)
+      return Long64_t(-TMath::Log(u) * mean) + 1;
+   }
+}
+
 //****************************************************************************//
 //
 //****************************************************************************//
@@ -59,6 +76,14 @@ TMemStatMng::TMemStatMng():
    fBufBtID(0),
    fIndex(0),
    fMustWrite(0),
+   fSamplingInterval(0),
+   fSnapshotInterval(10),
+   fLastSnapshot(0),
+   fHeapTree(0),
+   fHeapTimems(0),
+   fHeapBtID(0),
+   fHeapNBytes(0),
+   fHeapNSamples(0),
    fFAddrsList(0),
    fHbtids(0),
    fBTCount(0),
@@ -171,6 +196,10 @@ void TMemStatMng::Close()
    // to be documented
    fgInstance->FillTree();
    fgInstance->Disable();
+   if (fgInstance->fHeapTree) {
+      fgInstance->FillSnapshot();
+      fgInstance->fHeapTree->AutoSave();
+   }
    fgInstance->fDumpTree->AutoSave();
    fgInstance->fDumpTree->GetUserInfo()->Delete();
 
@@ -226,6 +255,42 @@ void TMemStatMng::SetMaxCalls(Int_t maxcalls)
    fMaxCalls = maxcalls;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Record only a sample of the allocations, one every nbytes allocated bytes
+/// on average. The sampled bytes are a Poisson process, so an allocation of
+/// size bytes is recorded with the probability 1-exp(-size/nbytes), and the
+/// cost of the backtrace and of the output is paid only for those. The frees
+/// are recorded only for the sampled allocations.
+/// In this mode, a second tree "H" holds every fSnapshotInterval seconds, see
+/// SetSnapshotInterval, the estimated live heap by call site ("btid"): the
+/// number of live bytes ("nbytes") and of live sampled allocations ("nsamples")
+/// at the time ("time") of the snapshot.
+/// nbytes=0 records every call to malloc/free, as by default.
+
+void TMemStatMng::SetSamplingInterval(Long64_t nbytes)
+{
+   fSamplingInterval = nbytes > 0 ? nbytes : 0;
+   if (!fSamplingInterval || fHeapTree || !fDumpFile)
+      return;
+
+   TDirectory::TContext context(fDumpFile);
+   fHeapTree = new TTree("H", "Sampled live heap by call site");
+   fHeapTree->Branch("time",     &fHeapTimems,   "time/I");
+   fHeapTree->Branch("btid",     &fHeapBtID,     "btid/I");
+   fHeapTree->Branch("nbytes",   &fHeapNBytes,   "nbytes/L");
+   fHeapTree->Branch("nsamples", &fHeapNSamples, "nsamples/I");
+   fLastSnapshot = fTimeStamp.AsDouble();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the time in seconds between two snapshots of the live heap in the
+/// sampling mode, see SetSamplingInterval.
+
+void TMemStatMng::SetSnapshotInterval(Double_t seconds)
+{
+   fSnapshotInterval = seconds;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Enable memory hooks
 
@@ -271,7 +336,10 @@ void TMemStatMng::MacAllocHook(void *ptr, size_t size)
    instance->Disable();
 
    // Call our routine
-   instance->AddPointer(ptr, Int_t(size));
+   if (!instance->fSamplingInterval)
+      instance->AddPointer(ptr, Int_t(size));
+   else if (instance->SampleAllocation(size))
+      instance->AddSample(ptr, Int_t(size));
 
    // Restore our own hooks
    instance->Enable();
@@ -289,7 +357,10 @@ void TMemStatMng::MacFreeHook(void *ptr)
    instance->Disable();
 
    // Call our routine
-   instance->AddPointer(ptr, -1);
+   if (!instance->fSamplingInterval)
+      instance->AddPointer(ptr, -1);
+   else
+      instance->RemoveSample(ptr);
 
    // Restore our own hooks
    instance->Enable();
@@ -308,7 +379,10 @@ void *TMemStatMng::AllocHook(size_t size, const void* /*caller*/)
    // Call recursively
    void *result = malloc(size);
    // Call our routine
-   instance->AddPointer(result, Int_t(size));
+   if (!instance->fSamplingInterval)
+      instance->AddPointer(result, Int_t(size));
+   else if (result && instance->SampleAllocation(size))
+      instance->AddSample(result, Int_t(size));
    //  TTimer::SingleShot(0, "TYamsMemMng", instance, "SaveData()");
 
    // Restore our own hooks
@@ -331,12 +405,109 @@ void TMemStatMng::FreeHook(void* ptr, const void* /*caller*/)
    free(ptr);
 
    // Call our routine
-   instance->AddPointer(ptr, -1);
+   if (!instance->fSamplingInterval)
+      instance->AddPointer(ptr, -1);
+   else
+      instance->RemoveSample(ptr);
 
    // Restore our own hooks
    instance->Enable();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Decide whether an allocation of size bytes is sampled. Each thread counts
+/// down the bytes it allocates to the next sampled byte; the distances between
+/// the sampled bytes are exponentially distributed with the mean
+/// fSamplingInterval, and since the distribution is memoryless the count
+/// restarts after each sampled allocation.
+
+Bool_t TMemStatMng::SampleAllocation(size_t size)
+{
+   TTHREAD_TLS(Long64_t) bytesToSample = 0;
+   TTHREAD_TLS(ULong64_t) state = 0;
+
+   if (!state) {
+      // xorshift generator, seeded per thread from the address of its state
+      state = ULong64_t((ULong_t)&state) ^ 0x9E3779B97F4A7C15ULL;
+      bytesToSample = NextSampleDistance(state, fSamplingInterval);
+   }
+
+   bytesToSample -= Long64_t(size);
+   if (bytesToSample > 0)
+      return kFALSE;
+
+   bytesToSample = NextSampleDistance(state, fSamplingInterval);
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record a sampled allocation, as AddPointer does, and add its estimated
+/// size, size/(1-exp(-size/fSamplingInterval)), to the live heap of its call
+/// site.
+
+void TMemStatMng::AddSample(void *ptr, Int_t size)
+{
+   Int_t btid = AddPointer(ptr, size);
+   Double_t ratio = Double_t(size) / fSamplingInterval;
+   Long64_t nbytes = ratio > 1e-6 ? Long64_t(size / (1 - TMath::Exp(-ratio))) : fSamplingInterval;
+
+   LiveSamples_t::value_type sample((ULong64_t)(ULong_t)ptr, std::make_pair(btid, nbytes));
+   std::pair<LiveSamples_t::iterator, bool> res = fLiveSamples.insert(sample);
+   if (!res.second) {
+      // the previous sample at this address was freed without being seen
+      std::pair<Long64_t, Int_t> &old = fLiveSites[res.first->second.first];
+      old.first -= res.first->second.second;
+      old.second--;
+      res.first->second = sample.second;
+   }
+   std::pair<Long64_t, Int_t> &site = fLiveSites[btid];
+   site.first += nbytes;
+   site.second++;
+
+   if (fTimeStamp.AsDouble() - fLastSnapshot >= fSnapshotInterval)
+      FillSnapshot();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the free of ptr if it was a sampled allocation, and remove it from
+/// the live heap of its call site.
+
+void TMemStatMng::RemoveSample(void *ptr)
+{
+   LiveSamples_t::iterator iter = fLiveSamples.find((ULong64_t)(ULong_t)ptr);
+   if (iter == fLiveSamples.end())
+      return;
+
+   std::pair<Long64_t, Int_t> &site = fLiveSites[iter->second.first];
+   site.first -= iter->second.second;
+   site.second--;
+   fLiveSamples.erase(iter);
+
+   AddPointer(ptr, -1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write a snapshot of the live heap by call site to the tree "H"; the call
+/// sites without live samples are not written.
+
+void TMemStatMng::FillSnapshot()
+{
+   if (!fHeapTree)
+      return;
+
+   fTimeStamp.Set();
+   fLastSnapshot = fTimeStamp.AsDouble();
+   fHeapTimems = Int_t(10000.*(fLastSnapshot - fBeginTime));
+   for (LiveSites_t::const_iterator iter = fLiveSites.begin(); iter != fLiveSites.end(); ++iter) {
+      if (iter->second.second <= 0)
+         continue;
+      fHeapBtID     = iter->first;
+      fHeapNBytes   = iter->second.first;
+      fHeapNSamples = iter->second.second;
+      fHeapTree->Fill();
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// An internal function, which returns a bitid for a corresponding CRC digest
 /// cache variables
@@ -427,8 +598,9 @@ Int_t TMemStatMng::generateBTID(UChar_t *CRCdigest, Int_t stackEntries,
 /// Add pointer to table.
 /// This method is called every time when any of the hooks are triggered.
 /// The memory de-/allocation information will is recorded.
+/// Returns the back trace identifier of the call.
 
-void TMemStatMng::AddPointer(void *ptr, Int_t size)
+Int_t TMemStatMng::AddPointer(void *ptr, Int_t size)
 {
    void *stptr[g_BTStackLevel + 1];
    const int stackentries = getBacktrace(stptr, g_BTStackLevel, fUseGNUBuiltinBacktrace);
@@ -458,6 +630,7 @@ void TMemStatMng::AddPointer(void *ptr, Int_t size)
    if (fBufN >= fBufferSize) {
       FillTree();
    }
+   return btid;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
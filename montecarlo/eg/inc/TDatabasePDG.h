@@ -19,27 +19,48 @@
 #include "TParticleClassPDG.h"
 #endif
 
+#include <atomic>
+
 class THashList;
 class TExMap;
 
+// Static properties of a particle, copied from its TParticlePDG in a
+// contiguous table so that they are read without dereferencing the object.
+struct PDGProperties_t {
+   Int_t         fPdgCode;      // PDG code of the particle
+   Int_t         fStable;       // 1 if stable, 0 otherwise
+   Int_t         fTrackingCode; // G3 tracking code of the particle
+   Double_t      fMass;         // particle mass in GeV
+   Double_t      fCharge;       // charge in units of |e|/3
+   Double_t      fWidth;        // total width in GeV
+   Double_t      fLifetime;     // proper lifetime in seconds
+   TParticlePDG *fParticle;     // the particle these properties come from
+};
+
 class TDatabasePDG: public TNamed {
 
 protected:
+   class TPDGTable;
+
    THashList           *fParticleList;     // list of PDG particles
    TObjArray           *fListOfClasses;    // list of classes (leptons etc.)
    mutable TExMap      *fPdgMap;           //!hash-map from pdg-code to particle
+   std::atomic<const TPDGTable*> fPdgTable; //!lookup table of the particles, once read
+   TPDGTable           *fPdgTables;        //!all the tables built, deleted with the database
 
    // make copy-constructor and assigment protected since class cannot be copied
    TDatabasePDG(const TDatabasePDG& db)
      : TNamed(db), fParticleList(db.fParticleList),
-     fListOfClasses(db.fListOfClasses), fPdgMap(0) { }
+     fListOfClasses(db.fListOfClasses), fPdgMap(0), fPdgTable(nullptr), fPdgTables(0) { }
 
    TDatabasePDG& operator=(const TDatabasePDG& db)
    {if(this!=&db) {TNamed::operator=(db); fParticleList=db.fParticleList;
-         fListOfClasses=db.fListOfClasses; fPdgMap=db.fPdgMap;}
+         fListOfClasses=db.fListOfClasses; fPdgMap=db.fPdgMap; fPdgTable=nullptr;}
       return *this;}
 
    void BuildPdgMap() const;
+   const TPDGTable *GetPdgTable() const;
+   void PublishPdgTable();
 
 public:
 
@@ -68,6 +89,9 @@ public:
    TParticlePDG  *GetParticle(Int_t pdgCode) const;
    TParticlePDG  *GetParticle(const char *name) const;
 
+   const PDGProperties_t *GetParticleProperties(Int_t pdgCode) const;
+   const PDGProperties_t *GetParticleProperties(const char *name) const;
+
    TParticleClassPDG* GetParticleClass(const char* name) {
       if (fParticleList == 0)  ((TDatabasePDG*)this)->ReadPDGTable();
       return (TParticleClassPDG*) fListOfClasses->FindObject(name);
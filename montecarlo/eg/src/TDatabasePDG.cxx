@@ -18,7 +18,10 @@
 #include "TDatabasePDG.h"
 #include "TDecayChannel.h"
 #include "TParticlePDG.h"
+#include <algorithm>
 #include <stdlib.h>
+#include <string.h>
+#include <vector>
 
 
 /** \class TDatabasePDG
@@ -45,10 +48,92 @@ Root.DatabasePDG: $(HOME)/my_pdg_table.txt
 
 See TParticlePDG for the description of a static particle properties.
 See TParticle    for the description of a dynamic particle particle.
+
+Once the table is read, the particles are also indexed by an immutable
+table sorted by PDG code and by name, in which GetParticle() and
+GetParticleProperties() look up without locking, from any thread. The
+table is rebuilt, and published atomically, when a particle is added
+later on; the tables it replaces are kept until the database is deleted,
+so that the pointers obtained from them stay valid.
 */
 
 ClassImp(TDatabasePDG)
 
+////////////////////////////////////////////////////////////////////////////////
+/// Immutable lookup table of the particles: the properties sorted by PDG
+/// code, with a direct index for the codes of the usual particles, and
+/// the names sorted alphabetically.
+
+class TDatabasePDG::TPDGTable {
+public:
+   enum { kDirect = 4096 };  // the codes in ]-kDirect, kDirect[ are indexed directly
+
+   std::vector<Int_t>           fCodes;      // sorted PDG codes
+   std::vector<PDGProperties_t> fRecords;    // properties, in the order of fCodes
+   std::vector<Int_t>           fDirect;     // index in fRecords of code+kDirect-1, -1 if none
+   std::vector<std::pair<const char*, Int_t> > fNames; // names and index in fRecords
+   TPDGTable                   *fPrevious;   // table built before this one
+
+   TPDGTable(THashList *particles, TPDGTable *previous);
+
+   const PDGProperties_t *Find(Int_t pdgCode) const
+   {
+      if (pdgCode > -kDirect && pdgCode < kDirect) {
+         Int_t i = fDirect[pdgCode + kDirect - 1];
+         return i < 0 ? 0 : &fRecords[i];
+      }
+      std::vector<Int_t>::const_iterator it = std::lower_bound(fCodes.begin(), fCodes.end(), pdgCode);
+      if (it == fCodes.end() || *it != pdgCode) return 0;
+      return &fRecords[it - fCodes.begin()];
+   }
+
+   const PDGProperties_t *Find(const char *name) const
+   {
+      Int_t lo = 0, hi = fNames.size();
+      while (lo < hi) {
+         Int_t mid = (lo + hi) / 2;
+         Int_t cmp = strcmp(fNames[mid].first, name);
+         if (cmp == 0) return &fRecords[fNames[mid].second];
+         if (cmp < 0) lo = mid + 1;
+         else         hi = mid;
+      }
+      return 0;
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Index the particles of the list.
+
+TDatabasePDG::TPDGTable::TPDGTable(THashList *particles, TPDGTable *previous)
+   : fDirect(2*kDirect - 1, -1), fPrevious(previous)
+{
+   std::vector<TParticlePDG*> sorted;
+   sorted.reserve(particles->GetEntries());
+   TIter next(particles);
+   TParticlePDG *p;
+   while ((p = (TParticlePDG*)next())) sorted.push_back(p);
+   std::sort(sorted.begin(), sorted.end(),
+             [](TParticlePDG *a, TParticlePDG *b) { return a->PdgCode() < b->PdgCode(); });
+
+   fCodes.reserve(sorted.size());
+   fRecords.reserve(sorted.size());
+   fNames.reserve(sorted.size());
+   for (TParticlePDG *part : sorted) {
+      Int_t i = fRecords.size();
+      PDGProperties_t record = { part->PdgCode(), part->Stable(), part->TrackingCode(), part->Mass(),
+                                 part->Charge(), part->Width(), part->Lifetime(), part };
+      fCodes.push_back(part->PdgCode());
+      fRecords.push_back(record);
+      if (part->PdgCode() > -kDirect && part->PdgCode() < kDirect)
+         fDirect[part->PdgCode() + kDirect - 1] = i;
+      fNames.push_back(std::make_pair(part->GetName(), i));
+   }
+   // THashList::FindObject returns the first particle of a given name.
+   std::stable_sort(fNames.begin(), fNames.end(),
+                    [](const std::pair<const char*, Int_t> &a, const std::pair<const char*, Int_t> &b) {
+                       return strcmp(a.first, b.first) < 0; });
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Static function holding the instance.
 
@@ -66,6 +151,8 @@ TDatabasePDG::TDatabasePDG(): TNamed("PDGDB","The PDG particle data base")
 {
    fParticleList  = 0;
    fPdgMap        = 0;
+   fPdgTable      = nullptr;
+   fPdgTables     = 0;
    fListOfClasses = 0;
    auto fgInstance = GetInstancePtr();
    if (*fgInstance != nullptr) {
@@ -85,6 +172,11 @@ TDatabasePDG::~TDatabasePDG()
       fParticleList->Delete();
       delete fParticleList;    // this deletes all objects in the list
       if (fPdgMap) delete fPdgMap;
+   }
+   while (fPdgTables) {
+      TPDGTable *previous = fPdgTables->fPrevious;
+      delete fPdgTables;
+      fPdgTables = previous;
    }
                                 // classes do not own particles...
    if (fListOfClasses) {
@@ -127,6 +219,31 @@ void TDatabasePDG::BuildPdgMap() const
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Build the lookup table of the particles and make it the one used by the
+/// readers; the previous one is kept for the readers which still use it.
+
+void TDatabasePDG::PublishPdgTable()
+{
+   fPdgTables = new TPDGTable(fParticleList, fPdgTables);
+   fPdgTable.store(fPdgTables, std::memory_order_release);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Lookup table of the particles, built after reading the particle table
+/// if needed.
+
+const TDatabasePDG::TPDGTable *TDatabasePDG::GetPdgTable() const
+{
+   const TPDGTable *table = fPdgTable.load(std::memory_order_acquire);
+   if (!table) {
+      if (fParticleList == 0)  ((TDatabasePDG*)this)->ReadPDGTable();
+      if (fPdgTable.load(std::memory_order_acquire) == 0)  ((TDatabasePDG*)this)->PublishPdgTable();
+      table = fPdgTable.load(std::memory_order_acquire);
+   }
+   return table;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ///
 ///  Particle definition normal constructor. If the particle is set to be
@@ -168,6 +285,9 @@ TParticlePDG* TDatabasePDG::AddParticle(const char *name, const char *title,
 
    pclass->AddParticle(p);
 
+   if (fPdgTable.load(std::memory_order_relaxed))
+      PublishPdgTable();
+
    return p;
 }
 
@@ -212,6 +332,10 @@ TParticlePDG* TDatabasePDG::AddAntiParticle(const char* Name, Int_t PdgCode)
 
 TParticlePDG *TDatabasePDG::GetParticle(const char *name) const
 {
+   if (const TPDGTable *table = fPdgTable.load(std::memory_order_acquire)) {
+      const PDGProperties_t *record = table->Find(name);
+      return record ? record->fParticle : 0;
+   }
    if (fParticleList == 0)  ((TDatabasePDG*)this)->ReadPDGTable();
 
    TParticlePDG *def = (TParticlePDG *)fParticleList->FindObject(name);
@@ -228,12 +352,39 @@ TParticlePDG *TDatabasePDG::GetParticle(const char *name) const
 
 TParticlePDG *TDatabasePDG::GetParticle(Int_t PDGcode) const
 {
+   if (const TPDGTable *table = fPdgTable.load(std::memory_order_acquire)) {
+      const PDGProperties_t *record = table->Find(PDGcode);
+      return record ? record->fParticle : 0;
+   }
    if (fParticleList == 0)  ((TDatabasePDG*)this)->ReadPDGTable();
    if (fPdgMap       == 0)  BuildPdgMap();
 
    return (TParticlePDG*) (Long_t)fPdgMap->GetValue((Long_t)PDGcode);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+///
+///  Get the static properties of the particle with the MC code number, or
+///  0 if it is not known. They are copied in a contiguous table, valid as
+///  long as the database.
+///
+
+const PDGProperties_t *TDatabasePDG::GetParticleProperties(Int_t PDGcode) const
+{
+   return GetPdgTable()->Find(PDGcode);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+///
+///  Get the static properties of the particle with the given name, or 0 if
+///  it is not known.
+///
+
+const PDGProperties_t *TDatabasePDG::GetParticleProperties(const char *name) const
+{
+   return GetPdgTable()->Find(name);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Print contents of PDG database.
 
@@ -580,6 +731,10 @@ void TDatabasePDG::ReadPDGTable(const char *FileName)
       return;
    }
 
+   // While the particles are added the readers go through fPdgMap; the
+   // table is published again when they are all read.
+   fPdgTable.store(nullptr, std::memory_order_release);
+
    char      c[512];
    Int_t     class_number, anti, isospin, i3, spin, tracking_code;
    Int_t     ich, kf, nch, charge;
@@ -726,6 +881,7 @@ void TDatabasePDG::ReadPDGTable(const char *FileName)
    }
 
    fclose(file);
+   PublishPdgTable();
    return;
 }
 
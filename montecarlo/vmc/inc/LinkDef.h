@@ -18,6 +18,7 @@
 #pragma link C++ class  TVirtualMCGeometry+;
 #pragma link C++ class  TVirtualMCApplication+;
 #pragma link C++ class  TVirtualMCStack+;
+#pragma link C++ class  TMCConcurrentStack+;
 #pragma link C++ class  TMCVerbose+;
 #pragma link C++ class  TGeoMCGeometry+;
 
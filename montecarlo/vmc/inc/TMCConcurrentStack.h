@@ -0,0 +1,94 @@
+// @(#)root/vmc:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TMCConcurrentStack
+#define ROOT_TMCConcurrentStack
+
+//
+// Class TMCConcurrentStack
+// ------------------------
+// Particles stack shared by the worker threads of an event, with one
+// queue per worker; an idle worker steals the tracks queued by the others.
+//
+
+#include "TVirtualMCStack.h"
+#include "TMCtls.h"
+
+class TMCConcurrentStack : public TVirtualMCStack {
+
+public:
+   TMCConcurrentStack(Int_t nofWorkers = 1);
+   virtual ~TMCConcurrentStack();
+
+   //
+   // Methods for stacking
+   //
+
+   virtual void  PushTrack(Int_t toBeDone, Int_t parent, Int_t pdg,
+                           Double_t px, Double_t py, Double_t pz, Double_t e,
+                           Double_t vx, Double_t vy, Double_t vz, Double_t tof,
+                           Double_t polx, Double_t poly, Double_t polz,
+                           TMCProcess mech, Int_t& ntr, Double_t weight,
+                           Int_t is);
+
+   virtual TParticle* PopNextTrack(Int_t& itrack);
+   virtual TParticle* PopPrimaryForTracking(Int_t i);
+
+   /// Delete the particles of the event and empty the queues
+   void               Reset();
+
+   //
+   // Set methods
+   //
+
+   virtual void       SetCurrentTrack(Int_t trackNumber);
+
+   /// Set the queue used by the calling thread
+   static void        SetWorker(Int_t worker);
+
+   //
+   // Get methods
+   //
+
+   virtual Int_t      GetNtrack()    const;
+   virtual Int_t      GetNprimary()  const;
+   virtual TParticle* GetCurrentTrack() const;
+   virtual Int_t      GetCurrentTrackNumber() const;
+   virtual Int_t      GetCurrentParentTrackNumber() const;
+
+   /// Number of worker queues
+   Int_t              GetNworkers()  const { return fNworkers; }
+   TParticle*         GetParticle(Int_t trackNumber) const;
+   Bool_t             IsEventDone()  const;
+
+private:
+   struct TImpl;
+
+   TMCConcurrentStack(const TMCConcurrentStack&);            // not implemented
+   TMCConcurrentStack& operator=(const TMCConcurrentStack&); // not implemented
+
+   Int_t  GetWorker() const;
+
+   // data members
+   Int_t  fNworkers; ///< Number of worker queues
+   TImpl *fImpl;     //! Queues and particles of the event
+
+   // static data members
+#if !defined(__CINT__)
+   static TMCThreadLocal Int_t fgWorker; ///< Queue of the calling thread, -1 if not yet assigned
+#else
+   static                Int_t fgWorker; ///< Queue of the calling thread, -1 if not yet assigned
+#endif
+
+   ClassDef(TMCConcurrentStack,1) //Particles stack shared by worker threads
+};
+
+#endif //ROOT_TMCConcurrentStack
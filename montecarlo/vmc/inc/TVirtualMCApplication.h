@@ -27,6 +27,8 @@
 
 #include "TMCtls.h"
 
+class TVirtualMCStack;
+
 class TVirtualMCApplication : public TNamed {
 
 public:
@@ -112,6 +114,12 @@ public:
    virtual void FinishWorkerRun() const {}
    /// Merge the data accumulated on workers to the master if needed
    virtual void Merge(TVirtualMCApplication* /*localMCApplication*/) {}
+   /// Return the stack shared by the workers of an event, if it may be
+   /// (a TMCConcurrentStack): a worker which is done with its own tracks
+   /// then pops the secondaries queued by the others and transports them,
+   /// with PreTrack(), Stepping() and PostTrack() of its application,
+   /// until TMCConcurrentStack::IsEventDone()
+   virtual TVirtualMCStack* GetSharedStack() const { return 0; }
 
 private:
    // static data members
@@ -0,0 +1,293 @@
+// @(#)root/vmc:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#include "TMCConcurrentStack.h"
+#include "TParticle.h"
+#include "TError.h"
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/** \class TMCConcurrentStack
+    \ingroup vmc
+
+Particles stack shared by the worker threads which transport the tracks
+of one event.
+
+Each worker has a queue of its own: the tracks it pushes are appended to
+it and PopNextTrack() takes the last one, so that a worker follows its
+showers depth first as with a sequential stack. When its queue is empty,
+a worker steals the oldest track queued by another worker, which is
+usually the root of the largest subtree still to be transported. All the
+workers of an event thus keep busy until the event is done, instead of
+waiting for the one which got the largest primary.
+
+A worker is given a queue when it first uses the stack, or with
+SetWorker(), for instance in TVirtualMCApplication::InitForWorker(). The
+current track is kept per queue, so GetCurrentTrack() and the other get
+methods answer for the calling thread. IsEventDone() tells an idle worker
+when no track is queued and no worker is transporting one any more; see
+TVirtualMCApplication::GetSharedStack().
+
+The particles belong to the stack until Reset(), to be called between
+events.
+*/
+
+ClassImp(TMCConcurrentStack)
+
+TMCThreadLocal Int_t TMCConcurrentStack::fgWorker = -1;
+
+struct TMCConcurrentStack::TImpl {
+   struct TQueue {
+      std::mutex          fMutex;
+      std::deque<Int_t>   fTracks;        // tracks to be done, the most recent at the back
+      Int_t               fCurrent = -1;  // track transported by the worker
+   };
+
+   std::vector<TQueue>     fQueues;
+   mutable std::mutex      fMutex;        // protects fParticles and fPrimaries
+   std::vector<TParticle*> fParticles;    // all the tracks of the event
+   std::vector<Int_t>      fPrimaries;    // track numbers of the primaries
+   std::atomic<Int_t>      fNpending{0};  // number of queued tracks
+   std::atomic<Int_t>      fNactive{0};   // number of workers with a current track
+   std::atomic<UInt_t>     fNextWorker{0};
+
+   TImpl(Int_t nofWorkers) : fQueues(nofWorkers) {}
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor for nofWorkers worker threads
+
+TMCConcurrentStack::TMCConcurrentStack(Int_t nofWorkers)
+  : TVirtualMCStack(),
+    fNworkers(nofWorkers > 0 ? nofWorkers : 1),
+    fImpl(new TImpl(fNworkers))
+{}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor
+
+TMCConcurrentStack::~TMCConcurrentStack()
+{
+   Reset();
+   delete fImpl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Queue of the calling thread, assigned in turn on first use
+
+Int_t TMCConcurrentStack::GetWorker() const
+{
+   if (fgWorker < 0)
+      fgWorker = fImpl->fNextWorker++ % fNworkers;
+   return fgWorker % fNworkers;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the queue used by the calling thread, usually its worker index
+
+void TMCConcurrentStack::SetWorker(Int_t worker)
+{
+   fgWorker = worker;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a new particle and push it in the queue of the calling thread if
+/// toBeDone; see TVirtualMCStack::PushTrack() for the arguments.
+
+void  TMCConcurrentStack::PushTrack(Int_t toBeDone, Int_t parent, Int_t pdg,
+                                    Double_t px, Double_t py, Double_t pz, Double_t e,
+                                    Double_t vx, Double_t vy, Double_t vz, Double_t tof,
+                                    Double_t polx, Double_t poly, Double_t polz,
+                                    TMCProcess mech, Int_t& ntr, Double_t weight,
+                                    Int_t is)
+{
+   TParticle* particle
+      = new TParticle(pdg, is, parent, -1, -1, -1, px, py, pz, e, vx, vy, vz, tof);
+   particle->SetPolarisation(polx, poly, polz);
+   particle->SetWeight(weight);
+   particle->SetUniqueID(mech);
+
+   {
+      std::lock_guard<std::mutex> lock(fImpl->fMutex);
+      ntr = fImpl->fParticles.size();
+      fImpl->fParticles.push_back(particle);
+      if (parent < 0) {
+         fImpl->fPrimaries.push_back(ntr);
+      } else if (parent < ntr) {
+         TParticle* parentParticle = fImpl->fParticles[parent];
+         parentParticle->SetLastDaughter(ntr);
+         if (parentParticle->GetFirstDaughter() < 0)
+            parentParticle->SetFirstDaughter(ntr);
+      }
+   }
+
+   if (toBeDone) {
+      ++fImpl->fNpending;
+      TImpl::TQueue& queue = fImpl->fQueues[GetWorker()];
+      std::lock_guard<std::mutex> lock(queue.fMutex);
+      queue.fTracks.push_back(ntr);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Pop the last track pushed by the calling thread or, if there is none,
+/// steal the oldest track of another worker. The popped track becomes the
+/// current track of the calling thread. Return 0 and itrack = -1 if no
+/// track is queued.
+
+TParticle* TMCConcurrentStack::PopNextTrack(Int_t& itrack)
+{
+   const Int_t worker = GetWorker();
+   itrack = -1;
+   {
+      TImpl::TQueue& queue = fImpl->fQueues[worker];
+      std::lock_guard<std::mutex> lock(queue.fMutex);
+      if (!queue.fTracks.empty()) {
+         itrack = queue.fTracks.back();
+         queue.fTracks.pop_back();
+      }
+   }
+   for (Int_t i = 1; itrack < 0 && i < fNworkers; ++i) {
+      TImpl::TQueue& victim = fImpl->fQueues[(worker + i) % fNworkers];
+      std::lock_guard<std::mutex> lock(victim.fMutex);
+      if (!victim.fTracks.empty()) {
+         itrack = victim.fTracks.front();
+         victim.fTracks.pop_front();
+      }
+   }
+
+   // The worker counts as active before the track stops counting as
+   // pending, so that IsEventDone() cannot be true in between.
+   TImpl::TQueue& queue = fImpl->fQueues[worker];
+   if (itrack >= 0) {
+      if (queue.fCurrent < 0)
+         ++fImpl->fNactive;
+      --fImpl->fNpending;
+   } else if (queue.fCurrent >= 0) {
+      --fImpl->fNactive;
+   }
+   queue.fCurrent = itrack;
+
+   return itrack >= 0 ? GetParticle(itrack) : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the i-th primary, without removing it from the queues
+
+TParticle* TMCConcurrentStack::PopPrimaryForTracking(Int_t i)
+{
+   std::lock_guard<std::mutex> lock(fImpl->fMutex);
+   if (i < 0 || i >= (Int_t)fImpl->fPrimaries.size()) {
+      Warning("PopPrimaryForTracking", "Primary %d does not exist", i);
+      return 0;
+   }
+   return fImpl->fParticles[fImpl->fPrimaries[i]];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete the particles of the event and empty the queues; no worker may
+/// use the stack meanwhile.
+
+void TMCConcurrentStack::Reset()
+{
+   for (Int_t i = 0; i < fNworkers; ++i) {
+      TImpl::TQueue& queue = fImpl->fQueues[i];
+      std::lock_guard<std::mutex> lock(queue.fMutex);
+      queue.fTracks.clear();
+      queue.fCurrent = -1;
+   }
+   std::lock_guard<std::mutex> lock(fImpl->fMutex);
+   for (TParticle* particle : fImpl->fParticles)
+      delete particle;
+   fImpl->fParticles.clear();
+   fImpl->fPrimaries.clear();
+   fImpl->fNpending = 0;
+   fImpl->fNactive = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the current track of the calling thread
+
+void TMCConcurrentStack::SetCurrentTrack(Int_t trackNumber)
+{
+   TImpl::TQueue& queue = fImpl->fQueues[GetWorker()];
+   if (trackNumber >= 0 && queue.fCurrent < 0)
+      ++fImpl->fNactive;
+   else if (trackNumber < 0 && queue.fCurrent >= 0)
+      --fImpl->fNactive;
+   queue.fCurrent = trackNumber;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Total number of tracks of the event
+
+Int_t TMCConcurrentStack::GetNtrack() const
+{
+   std::lock_guard<std::mutex> lock(fImpl->fMutex);
+   return fImpl->fParticles.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Number of primary tracks of the event
+
+Int_t TMCConcurrentStack::GetNprimary() const
+{
+   std::lock_guard<std::mutex> lock(fImpl->fMutex);
+   return fImpl->fPrimaries.size();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Particle of the track trackNumber, 0 if it does not exist
+
+TParticle* TMCConcurrentStack::GetParticle(Int_t trackNumber) const
+{
+   std::lock_guard<std::mutex> lock(fImpl->fMutex);
+   if (trackNumber < 0 || trackNumber >= (Int_t)fImpl->fParticles.size())
+      return 0;
+   return fImpl->fParticles[trackNumber];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Current track particle of the calling thread
+
+TParticle* TMCConcurrentStack::GetCurrentTrack() const
+{
+   return GetParticle(GetCurrentTrackNumber());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Current track number of the calling thread
+
+Int_t TMCConcurrentStack::GetCurrentTrackNumber() const
+{
+   return fImpl->fQueues[GetWorker()].fCurrent;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Number of the parent of the current track of the calling thread
+
+Int_t TMCConcurrentStack::GetCurrentParentTrackNumber() const
+{
+   TParticle* current = GetCurrentTrack();
+   return current ? current->GetFirstMother() : -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// True when no track is queued and no worker is transporting one: the
+/// event is done and the idle workers can stop popping tracks.
+
+Bool_t TMCConcurrentStack::IsEventDone() const
+{
+   return fImpl->fNpending == 0 && fImpl->fNactive == 0;
+}
@@ -51,6 +51,8 @@
 #include <sstream>
 #include <string>
 #include <cstring>
+#include <thread>
+#include <vector>
 
 
 static const std::string VERSION = "0.2.0";
@@ -770,15 +772,23 @@ Long64_t TDavixFile::DavixPReadBuffer(Davix_fd *fd, char *buf, Long64_t pos, Int
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+/// Read the nbuf chunks pos[i], len[i] in buf.
+///
+/// The chunks are read with multi-range requests. When they add up to more
+/// than Davix.ReadvParallelMinBytes (1 MB by default), they are split in up
+/// to Davix.ReadvParallel (4 by default) groups of about the same size, read
+/// concurrently by as many requests: the connections are taken from the
+/// session pool of the Davix context, which is shared by all the files, so
+/// that the successive calls reuse the connections to the same host.
 
 Long64_t TDavixFile::DavixReadBuffers(Davix_fd *fd, char *buf, Long64_t *pos, Int_t *len, Int_t nbuf)
 {
    DavixError *davixErr = NULL;
    Double_t start_time = eventStart();
-   DavIOVecInput in[nbuf];
-   DavIOVecOuput out[nbuf];
+   std::vector<DavIOVecInput> in(nbuf);
+   std::vector<DavIOVecOuput> out(nbuf);
 
-   int lastPos = 0;
+   Long64_t lastPos = 0;
    for (Int_t i = 0; i < nbuf; ++i) {
       in[i].diov_buffer = &buf[lastPos];
       in[i].diov_offset = pos[i];
@@ -786,14 +796,61 @@ Long64_t TDavixFile::DavixReadBuffers(Davix_fd *fd, char *buf, Long64_t *pos, In
       lastPos += len[i];
    }
 
-   Long64_t ret = d_ptr->davixPosix->preadVec(fd, in, out, nbuf, &davixErr);
-   if (ret < 0) {
-      Error("DavixReadBuffers", "can not read data with davix: %s (%d)",
-            davixErr->getErrMsg().c_str(), davixErr->getStatus());
-      DavixError::clearError(&davixErr);
+   static const Int_t parallel = gEnv->GetValue(ENVPFX "ReadvParallel", 4);
+   static const Long64_t minBytes = gEnv->GetValue(ENVPFX "ReadvParallelMinBytes", 1024 * 1024);
+   Int_t ngroups = parallel;
+   if (ngroups > nbuf) ngroups = nbuf;
+   if (lastPos < minBytes) ngroups = 1;
+
+   Long64_t ret = 0;
+   if (ngroups <= 1) {
+      ret = d_ptr->davixPosix->preadVec(fd, in.data(), out.data(), nbuf, &davixErr);
+      if (ret < 0) {
+         Error("DavixReadBuffers", "can not read data with davix: %s (%d)",
+               davixErr->getErrMsg().c_str(), davixErr->getStatus());
+         DavixError::clearError(&davixErr);
+      }
    } else {
-      eventStop(start_time, ret);
+      // Split the chunks in groups of about lastPos / ngroups bytes.
+      std::vector<Int_t> first(1, 0);
+      Long64_t groupBytes = 0;
+      for (Int_t i = 0; i < nbuf; ++i) {
+         groupBytes += len[i];
+         if (groupBytes * ngroups >= lastPos * (Long64_t)first.size() && (Int_t)first.size() < ngroups && i + 1 < nbuf)
+            first.push_back(i + 1);
+      }
+      first.push_back(nbuf);
+
+      Uri uri(d_ptr->fUrl.GetUrl());
+      std::vector<dav_ssize_t> results(first.size() - 1, -1);
+      std::vector<DavixError *> errors(first.size() - 1, NULL);
+      auto readGroup = [&](size_t g) {
+         DavFile file(*d_ptr->davixContext, uri);
+         results[g] = file.readPartialBufferVec(d_ptr->davixParam, &in[first[g]], &out[first[g]],
+                                                first[g + 1] - first[g], &errors[g]);
+      };
+      std::vector<std::thread> threads;
+      for (size_t g = 1; g + 1 < first.size(); ++g)
+         threads.emplace_back(readGroup, g);
+      readGroup(0);
+      for (auto &t : threads)
+         t.join();
+
+      for (size_t g = 0; g < results.size(); ++g) {
+         if (results[g] < 0) {
+            if (ret >= 0 && errors[g])
+               Error("DavixReadBuffers", "can not read data with davix: %s (%d)",
+                     errors[g]->getErrMsg().c_str(), errors[g]->getStatus());
+            ret = -1;
+         } else if (ret >= 0) {
+            ret += results[g];
+         }
+         DavixError::clearError(&errors[g]);
+      }
    }
 
+   if (ret >= 0)
+      eventStop(start_time, ret);
+
    return ret;
 }
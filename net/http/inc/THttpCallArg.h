@@ -33,6 +33,7 @@ protected:
    Long_t fPostDataLength;       //! length of binary data
 
    TNamed *fWSHandle;            //!  web-socket handle, derived from TNamed class
+   ULong_t fWSId;                //!  web-socket connection id, identical for all the calls of the connection
 
    std::condition_variable fCond; //! condition used to wait for processing
 
@@ -111,6 +112,18 @@ public:
 
    TNamed* TakeWSHandle();
 
+   void SetWSId(ULong_t id)
+   {
+      // set web-socket connection id
+      fWSId = id;
+   }
+
+   ULong_t GetWSId() const
+   {
+      // returns web-socket connection id, 0 if not a web-socket call
+      return fWSId;
+   }
+
    void SetRequestHeader(const char* h)
    {
       // set full set of request header
@@ -21,8 +21,11 @@
 #endif
 
 #include <mutex>
+#include <map>
+#include <string>
 
 class THttpEngine;
+class THttpWSEngine;
 class THttpTimer;
 class TRootSniffer;
 
@@ -50,9 +53,48 @@ protected:
    std::mutex   fMutex;       //! mutex to protect list with arguments
    TList        fCallArgs;    //! submitted arguments
 
+   /** Response produced for an object, kept while the object does not change */
+   struct CachedResponse_t {
+      TString  fPath;         ///< item path of the object
+      ULong_t  fHash;         ///< content hash of the object when the response was produced
+      Bool_t   fValid;        ///< hash checked during the last ProcessRequests(), response can be served by engine threads
+      Bool_t   fUsed;         ///< served by an engine thread since the hash was checked
+      Bool_t   fBinary;       ///< content is binary data
+      TString  fContentType;  ///< type of content
+      TString  fContent;      ///< text or binary content
+   };
+
+   std::mutex   fCacheMutex;  //! mutex to protect the cache of responses
+   std::map<std::string, CachedResponse_t> fCache; //! cached responses, by item path, file name and query
+   Int_t        fCacheLimit;  //! maximal number of cached responses, 0 disables the cache
+
+   /** Client of the monitor.websocket, to which the subscribed items are pushed */
+   struct MonitorClient_t {
+      THttpWSEngine *fHandle;                  ///< web-socket handle
+      Bool_t         fReady;                   ///< client processed the previous update
+      std::map<std::string, ULong_t> fItems;   ///< subscribed items and content hash of their last update
+   };
+
+   std::map<ULong_t, MonitorClient_t> fMonitors; //! monitor clients, by web-socket id
+   Long_t       fMonitorInterval; //! interval between two updates of the monitor clients (ms)
+   Long64_t     fMonitorLast;     //! time of the last update of the monitor clients (ms)
+
    // Here any request can be processed
    virtual void ProcessRequest(THttpCallArg *arg);
 
+   Bool_t ProcessDirectly(THttpCallArg *arg);
+
+   Bool_t GetCacheKey(THttpCallArg *arg, const TString &filename, std::string &key) const;
+   Bool_t GetFromCache(const std::string &key, ULong_t hash, THttpCallArg *arg);
+   void   AddToCache(const std::string &key, ULong_t hash, THttpCallArg *arg);
+   void   ValidateCache();
+   void   ClearCache();
+
+   static void SetCachedResponse(const CachedResponse_t &entry, THttpCallArg *arg);
+
+   void   ProcessMonitorRequest(THttpCallArg *arg);
+   void   UpdateMonitors();
+
    static Bool_t VerifyFilePath(const char *fname);
 
 public:
@@ -99,6 +141,16 @@ public:
 
    void SetTimer(Long_t milliSec = 100, Bool_t mode = kTRUE);
 
+   void SetCacheLimit(Int_t n = 100);
+
+   /** Returns maximal number of cached responses */
+   Int_t GetCacheLimit() const { return fCacheLimit; }
+
+   void SetMonitorInterval(Long_t milliSec = 1000);
+
+   /** Returns interval between two updates of the monitor.websocket clients (ms) */
+   Long_t GetMonitorInterval() const { return fMonitorInterval; }
+
    /** Check if file is requested, thread safe */
    Bool_t  IsFileRequested(const char *uri, TString &res) const;
 
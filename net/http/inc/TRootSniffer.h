@@ -232,6 +232,8 @@ public:
 
    ULong_t GetItemHash(const char *itemname);
 
+   ULong_t GetItemContentHash(const char *itemname);
+
    Bool_t ProduceJson(const char *path, const char *options, TString &res);
 
    Bool_t ProduceXml(const char *path, const char *options, TString &res);
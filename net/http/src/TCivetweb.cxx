@@ -69,6 +69,7 @@ int websocket_connect_handler(const struct mg_connection *conn, void*)
    arg.SetPathAndFileName(request_info->uri); // path and file name
    arg.SetQuery(request_info->query_string);  // query arguments
    arg.SetMethod("WS_CONNECT");
+   arg.SetWSId((ULong_t) conn);
 
    Bool_t execres = serv->ExecuteHttp(&arg);
 
@@ -94,6 +95,7 @@ void websocket_ready_handler(struct mg_connection *conn, void*)
    arg.SetPathAndFileName(request_info->uri); // path and file name
    arg.SetQuery(request_info->query_string);  // query arguments
    arg.SetMethod("WS_READY");
+   arg.SetWSId((ULong_t) conn);
 
    arg.SetWSHandle(new TCivetwebWSEngine("websocket", "title", conn));
 
@@ -115,6 +117,7 @@ int websocket_data_handler(struct mg_connection *conn, int, char *data, size_t l
    arg.SetPathAndFileName(request_info->uri); // path and file name
    arg.SetQuery(request_info->query_string);  // query arguments
    arg.SetMethod("WS_DATA");
+   arg.SetWSId((ULong_t) conn);
 
    void* buf = malloc(len+1); // one byte more for null-termination
    memcpy(buf, data, len);
@@ -153,6 +156,7 @@ void websocket_close_handler(const struct mg_connection *conn, void*)
    arg.SetPathAndFileName(request_info->uri); // path and file name
    arg.SetQuery(request_info->query_string);  // query arguments
    arg.SetMethod("WS_CLOSE");
+   arg.SetWSId((ULong_t) conn);
 
    serv->ExecuteHttp(&arg);
 }
@@ -478,6 +482,15 @@ Bool_t TCivetweb::Create(const char *args)
                              websocket_close_handler,
                              0);
 
+   // web-socket of the clients subscribing to updates of objects
+   mg_set_websocket_handler((struct mg_context *) fCtx,
+                            "**monitor.websocket$",
+                             websocket_connect_handler,
+                             websocket_ready_handler,
+                             websocket_data_handler,
+                             websocket_close_handler,
+                             0);
+
    return kTRUE;
 }
 
@@ -122,13 +122,19 @@ THttpServer::THttpServer(const char *engine) :
    fDefaultPageCont(),
    fDrawPage(),
    fDrawPageCont(),
-   fCallArgs()
+   fCallArgs(),
+   fCache(),
+   fCacheLimit(100),
+   fMonitors(),
+   fMonitorInterval(1000),
+   fMonitorLast(0)
 {
    // As argument, one specifies engine kind which should be
    // created like "http:8080". One could specify several engines
    // at once, separating them with ; like "http:8080;fastcgi:9000"
    // One also can configure readonly flag for sniffer like
    // "http:8080;readonly" or "http:8080;readwrite"
+   // The caching of the responses is disabled with "http:8080;nocache"
    //
    // Also searches for JavaScript ROOT sources, which are used in web clients
    // Typically JSROOT sources located in $ROOTSYS/etc/http directory,
@@ -195,6 +201,8 @@ THttpServer::THttpServer(const char *engine) :
             GetSniffer()->SetReadOnly(kTRUE);
          } else if ((strcmp(opt, "readwrite") == 0) || (strcmp(opt, "rw") == 0)) {
             GetSniffer()->SetReadOnly(kFALSE);
+         } else if (strcmp(opt, "nocache") == 0) {
+            SetCacheLimit(0);
          } else
             CreateEngine(opt);
       }
@@ -209,6 +217,12 @@ THttpServer::THttpServer(const char *engine) :
 
 THttpServer::~THttpServer()
 {
+   for (auto &mon : fMonitors) {
+      mon.second.fHandle->ClearHandle();
+      delete mon.second.fHandle;
+   }
+   fMonitors.clear();
+
    fEngines.Delete();
 
    SetSniffer(0);
@@ -224,6 +238,7 @@ void THttpServer::SetSniffer(TRootSniffer *sniff)
 {
    if (fSniffer) delete fSniffer;
    fSniffer = sniff;
+   ClearCache();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -378,6 +393,30 @@ void THttpServer::SetTimer(Long_t milliSec, Bool_t mode)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set the maximal number of cached responses, 0 disables the cache
+///
+/// The responses to the requests of objects as JSON, XML or images
+/// (root.json, root.xml, root.png, root.jpeg, root.gif) are kept, together
+/// with a hash of the content of the object (see
+/// TRootSniffer::GetItemContentHash()). A new request of the same object
+/// with the same options is answered from the cache as long as the object
+/// does not change, without streaming or drawing it again. The hashes of
+/// the cached objects which were requested are checked at each call of
+/// ProcessRequests(); in between, the cached responses are served directly
+/// by the threads of the http engine, without waiting for the main thread,
+/// so that the monitoring clients are not blocked while the
+/// application is busy (the number of threads of the civetweb engine is
+/// set with its "thrds" option). Requests of authenticated users are not
+/// cached. By default up to 100 responses are cached.
+
+void THttpServer::SetCacheLimit(Int_t n)
+{
+   std::lock_guard<std::mutex> lk(fCacheMutex);
+   fCacheLimit = n > 0 ? n : 0;
+   if (fCacheLimit == 0) fCache.clear();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Checked that filename does not contains relative path below current directory
 /// Used to prevent access to files below current directory
@@ -457,6 +496,10 @@ Bool_t THttpServer::IsFileRequested(const char *uri, TString &res) const
 
 Bool_t THttpServer::ExecuteHttp(THttpCallArg *arg)
 {
+   // files and cached responses do not need the main thread
+   if (ProcessDirectly(arg))
+      return kTRUE;
+
    if ((fMainThrdId!=0) && (fMainThrdId == TThread::SelfId())) {
       // should not happen, but one could process requests directly without any signaling
 
@@ -474,6 +517,209 @@ Bool_t THttpServer::ExecuteHttp(THttpCallArg *arg)
    return kTRUE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set the interval between two updates of the monitor.websocket clients
+///
+/// A client opening a web-socket on "monitor.websocket" (at the top of the
+/// server, e.g. ws://localhost:8080/monitor.websocket) subscribes to items
+/// with the messages "SUBSCRIBE:itemname" and "UNSUBSCRIBE:itemname".
+/// At most every milliSec milliseconds, from ProcessRequests(), the
+/// server checks the content hashes of the subscribed objects and pushes
+/// to the client the JSON (in compact form, as "root.json?compact=23") of
+/// the objects which changed since its last update, in a single message:
+///     UPDATE{"hpx":{...},"Files/job1.root/hpxpy":{...}}
+/// An item which is not found is sent as null. The next update is only
+/// sent after the client has replied "READY", so that a slow client does
+/// not accumulate messages. Unchanged objects are neither streamed nor
+/// sent, which makes many monitoring clients much cheaper than polling.
+
+void THttpServer::SetMonitorInterval(Long_t milliSec)
+{
+   fMonitorInterval = milliSec > 0 ? milliSec : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process the requests which do not need the main thread, in the thread
+/// of the http engine calling ExecuteHttp(): requests of files, and of
+/// objects whose response is in the cache and was validated by the last
+/// ProcessRequests(). Returns kFALSE if the request must be processed in
+/// the main thread.
+
+Bool_t THttpServer::ProcessDirectly(THttpCallArg *arg)
+{
+   if (arg->fFileName.IsNull() || (arg->fFileName == "index.htm") || (arg->fFileName == "draw.htm"))
+      return kFALSE;
+
+   TString filename;
+   if (IsFileRequested(arg->fFileName.Data(), filename)) {
+      arg->SetFile(filename);
+      return kTRUE;
+   }
+
+   filename = arg->fFileName;
+   Bool_t iszip = filename.EndsWith(".gz");
+   if (iszip) filename.Resize(filename.Length() - 3);
+
+   std::string key;
+   if (!GetCacheKey(arg, filename, key))
+      return kFALSE;
+
+   {
+      std::lock_guard<std::mutex> lk(fCacheMutex);
+      auto iter = fCache.find(key);
+      if ((iter == fCache.end()) || !iter->second.fValid)
+         return kFALSE;
+      iter->second.fUsed = kTRUE;
+      SetCachedResponse(iter->second, arg);
+   }
+
+   if (iszip) arg->SetZipping(3);
+
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Returns in key the cache key of the response to the request of the
+/// file filename, and kFALSE if the response cannot be cached
+
+Bool_t THttpServer::GetCacheKey(THttpCallArg *arg, const TString &filename, std::string &key) const
+{
+   if ((fCacheLimit <= 0) || arg->fPathName.IsNull() || (arg->GetUserName() != 0))
+      return kFALSE;
+
+   if ((filename != "root.json") && (filename != "root.xml") && (filename != "root.png") &&
+       (filename != "root.jpeg") && (filename != "root.gif"))
+      return kFALSE;
+
+   key = arg->fPathName.Data();
+   key.append("/").append(filename.Data()).append("?").append(arg->fQuery.Data());
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the response of the request arg from the cache if the object had
+/// the same content hash when the response was produced, otherwise
+/// remove the outdated response. Called in the main thread.
+
+Bool_t THttpServer::GetFromCache(const std::string &key, ULong_t hash, THttpCallArg *arg)
+{
+   std::lock_guard<std::mutex> lk(fCacheMutex);
+   auto iter = fCache.find(key);
+   if (iter == fCache.end())
+      return kFALSE;
+   if (iter->second.fHash != hash) {
+      fCache.erase(iter);
+      return kFALSE;
+   }
+   iter->second.fValid = kTRUE;
+   iter->second.fUsed = kFALSE;
+   SetCachedResponse(iter->second, arg);
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Keep the response just produced for arg in the cache
+
+void THttpServer::AddToCache(const std::string &key, ULong_t hash, THttpCallArg *arg)
+{
+   std::lock_guard<std::mutex> lk(fCacheMutex);
+   if (fCacheLimit <= 0)
+      return;
+
+   if ((fCache.find(key) == fCache.end()) && ((Int_t) fCache.size() >= fCacheLimit)) {
+      // drop a response which was not requested recently, else any
+      auto iter = fCache.begin();
+      for (auto it = fCache.begin(); it != fCache.end(); ++it)
+         if (!it->second.fValid) {
+            iter = it;
+            break;
+         }
+      fCache.erase(iter);
+   }
+
+   CachedResponse_t &entry = fCache[key];
+   entry.fPath = arg->fPathName;
+   entry.fHash = hash;
+   entry.fValid = kTRUE;
+   entry.fUsed = kFALSE;
+   entry.fBinary = arg->IsBinData();
+   entry.fContentType = arg->GetContentType();
+   entry.fContent.Clear();
+   entry.fContent.Append((const char *) arg->GetContent(), arg->GetContentLength());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Check the content hashes of the objects whose cached responses were
+/// served by the engine threads since the previous call, and remove
+/// the outdated responses. The responses which were not used have to be
+/// checked again in the main thread before being served.
+/// Called by ProcessRequests() in the main thread.
+
+void THttpServer::ValidateCache()
+{
+   std::map<std::string, TString> used;
+   {
+      std::lock_guard<std::mutex> lk(fCacheMutex);
+      for (auto &item : fCache) {
+         if (item.second.fUsed)
+            used[item.first] = item.second.fPath;
+         else
+            item.second.fValid = kFALSE;
+      }
+   }
+   if (used.empty())
+      return;
+
+   // the hashes are computed without locking the cache
+   std::map<std::string, ULong_t> hashes;
+   for (auto &item : used) {
+      std::string path = item.second.Data();
+      if (hashes.find(path) == hashes.end())
+         hashes[path] = fSniffer->GetItemContentHash(path.c_str());
+   }
+
+   std::lock_guard<std::mutex> lk(fCacheMutex);
+   for (auto &item : used) {
+      auto iter = fCache.find(item.first);
+      if (iter == fCache.end())
+         continue;
+      ULong_t hash = hashes[item.second.Data()];
+      if ((hash == 0) || (hash != iter->second.fHash)) {
+         fCache.erase(iter);
+      } else {
+         iter->second.fValid = kTRUE;
+         iter->second.fUsed = kFALSE;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove all the cached responses
+
+void THttpServer::ClearCache()
+{
+   std::lock_guard<std::mutex> lk(fCacheMutex);
+   fCache.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the response of arg from the cached entry
+
+void THttpServer::SetCachedResponse(const CachedResponse_t &entry, THttpCallArg *arg)
+{
+   if (entry.fBinary) {
+      void *ptr = malloc(entry.fContent.Length());
+      memcpy(ptr, entry.fContent.Data(), entry.fContent.Length());
+      arg->SetBinData(ptr, entry.fContent.Length());
+   } else {
+      arg->fContent = entry.fContent;
+   }
+   arg->SetContentType(entry.fContentType.Data());
+
+   // try to avoid caching on the browser
+   arg->AddHeader("Cache-Control", "private, no-cache, no-store, must-revalidate, max-age=0, proxy-revalidate, s-maxage=0");
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Process requests, submitted for execution
 /// Regularly invoked by THttpTimer, when somewhere in the code
@@ -489,6 +735,8 @@ void THttpServer::ProcessRequests()
       return;
    }
 
+   ValidateCache();
+
    std::unique_lock<std::mutex> lk(fMutex, std::defer_lock);
    while (true) {
       THttpCallArg *arg = 0;
@@ -519,6 +767,116 @@ void THttpServer::ProcessRequests()
    THttpEngine *engine = 0;
    while ((engine = (THttpEngine *)iter()) != 0)
       engine->Process();
+
+   UpdateMonitors();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process the requests of the monitor.websocket, see SetMonitorInterval()
+
+void THttpServer::ProcessMonitorRequest(THttpCallArg *arg)
+{
+   ULong_t id = arg->GetWSId();
+   if (id == 0) {
+      // engine without web-socket support
+      arg->Set404();
+      return;
+   }
+
+   if (strcmp(arg->GetMethod(), "WS_CONNECT") == 0)
+      return;
+
+   if (strcmp(arg->GetMethod(), "WS_READY") == 0) {
+      THttpWSEngine *wshandle = dynamic_cast<THttpWSEngine *>(arg->TakeWSHandle());
+      if (wshandle == 0) return;
+
+      if (gDebug > 0) Info("ProcessMonitorRequest", "Set monitor WebSocket handle %p", wshandle);
+
+      MonitorClient_t &client = fMonitors[id];
+      if (client.fHandle) delete client.fHandle;
+      client.fHandle = wshandle;
+      client.fReady = kTRUE;
+      client.fItems.clear();
+      return;
+   }
+
+   auto iter = fMonitors.find(id);
+   if (iter == fMonitors.end()) return;
+   MonitorClient_t &client = iter->second;
+
+   if (strcmp(arg->GetMethod(), "WS_CLOSE") == 0) {
+      if (gDebug > 0) Info("ProcessMonitorRequest", "Clear monitor WebSocket handle");
+      client.fHandle->ClearHandle();
+      delete client.fHandle;
+      fMonitors.erase(iter);
+      return;
+   }
+
+   if ((strcmp(arg->GetMethod(), "WS_DATA") != 0) || (arg->GetPostDataLength() <= 0))
+      return;
+
+   TString data((const char *) arg->GetPostData(), arg->GetPostDataLength());
+
+   if (data == "READY") {
+      client.fReady = kTRUE;
+   } else if (data.BeginsWith("SUBSCRIBE:")) {
+      TString item = data(10, data.Length() - 10);
+      // the first update is always sent
+      if (item.Length() > 0) client.fItems[item.Data()] = (ULong_t) -1;
+   } else if (data.BeginsWith("UNSUBSCRIBE:")) {
+      TString item = data(12, data.Length() - 12);
+      client.fItems.erase(item.Data());
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Push the changed subscribed objects to the monitor.websocket clients,
+/// if the monitor interval elapsed since the last update.
+
+void THttpServer::UpdateMonitors()
+{
+   if (fMonitors.empty()) return;
+
+   Long64_t now = (Long64_t) gSystem->Now();
+   if (now - fMonitorLast < fMonitorInterval) return;
+   fMonitorLast = now;
+
+   // each object is hashed and streamed at most once for all clients
+   std::map<std::string, ULong_t> hashes;
+   std::map<std::string, TString> jsons;
+
+   for (auto &mon : fMonitors) {
+      MonitorClient_t &client = mon.second;
+      if (!client.fReady || client.fItems.empty()) continue;
+
+      TString buf;
+      for (auto &item : client.fItems) {
+         auto h = hashes.find(item.first);
+         if (h == hashes.end())
+            h = hashes.insert(std::make_pair(item.first, fSniffer->GetItemContentHash(item.first.c_str()))).first;
+         if (h->second == item.second) continue;
+         item.second = h->second;
+
+         auto j = jsons.find(item.first);
+         if (j == jsons.end()) {
+            TString json;
+            if ((h->second == 0) || !fSniffer->ProduceJson(item.first.c_str(), "compact=23", json))
+               json = "null";
+            j = jsons.insert(std::make_pair(item.first, json)).first;
+         }
+
+         buf.Append(buf.Length() == 0 ? "UPDATE{\"" : ",\"");
+         buf.Append(item.first.c_str());
+         buf.Append("\":");
+         buf.Append(j->second);
+      }
+
+      if (buf.Length() > 0) {
+         buf.Append("}");
+         client.fReady = kFALSE;
+         client.fHandle->Send(buf.Data(), buf.Length());
+      }
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -634,6 +992,13 @@ void THttpServer::ProcessRequest(THttpCallArg *arg)
    void* bindata(0);
    Long_t bindatalen(0);
 
+   // responses of unchanged objects are taken from the cache
+   std::string cachekey;
+   ULong_t hash = 0;
+   if (GetCacheKey(arg, filename, cachekey))
+      hash = fSniffer->GetItemContentHash(arg->fPathName.Data());
+   if (hash == 0) cachekey.clear();
+
    if ((filename == "h.xml") || (filename == "get.xml"))  {
 
       Bool_t compact = arg->fQuery.Index("compact") != kNPOS;
@@ -664,6 +1029,11 @@ void THttpServer::ProcessRequest(THttpCallArg *arg)
       arg->SetJson();
    } else
 
+   if (filename == "monitor.websocket") {
+      ProcessMonitorRequest(arg);
+      return;
+   } else
+
    if (filename == "root.websocket") {
       // handling of web socket
 
@@ -715,11 +1085,19 @@ void THttpServer::ProcessRequest(THttpCallArg *arg)
 
    } else
 
+   if (!cachekey.empty() && GetFromCache(cachekey, hash, arg)) {
+      // the response is already complete
+      if (iszip) arg->SetZipping(3);
+      return;
+   } else
+
    if (fSniffer->Produce(arg->fPathName.Data(), filename.Data(), arg->fQuery.Data(), bindata, bindatalen, arg->fContent)) {
       if (bindata != 0) arg->SetBinData(bindata, bindatalen);
 
       // define content type base on extension
       arg->SetContentType(GetMimeType(filename.Data()));
+
+      if (!cachekey.empty()) AddToCache(cachekey, hash, arg);
    } else {
       // request is not processed
       arg->Set404();
@@ -747,6 +1125,7 @@ void THttpServer::ProcessRequest(THttpCallArg *arg)
 
 Bool_t THttpServer::Register(const char *subfolder, TObject *obj)
 {
+   ClearCache();
    return fSniffer->RegisterObject(subfolder, obj);
 }
 
@@ -757,6 +1136,7 @@ Bool_t THttpServer::Register(const char *subfolder, TObject *obj)
 
 Bool_t THttpServer::Unregister(TObject *obj)
 {
+   ClearCache();
    return fSniffer->UnregisterObject(obj);
 }
 
@@ -1055,6 +1055,44 @@ ULong_t TRootSniffer::GetItemHash(const char *itemname)
    return obj == 0 ? 0 : TString::Hash(obj, obj->IsA()->Size());
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Get hash of the content of the specified item, computed from its binary
+/// streaming. Unlike GetItemHash(), it changes when any data of the object
+/// changes, e.g. the bin contents of a histogram, the points of a graph or
+/// the primitives of a canvas. For a tree, whose streaming would include
+/// its baskets, it is GetItemHash(), which changes at each Fill().
+/// Used by THttpServer to detect that its cached responses are outdated.
+/// Returns 0 if the item is not found or is not an object.
+
+ULong_t TRootSniffer::GetItemContentHash(const char *itemname)
+{
+   if ((itemname == 0) || (*itemname == 0) || IsStreamerInfoItem(itemname)) return 0;
+
+   if (*itemname == '/') itemname++;
+
+   TClass *obj_cl(0);
+   TDataMember *member(0);
+   void *obj_ptr = FindInHierarchy(itemname, &obj_cl, &member);
+   if ((obj_ptr == 0) || (obj_cl == 0) || (member != 0)) return 0;
+
+   if (obj_cl->InheritsFrom(TTree::Class()))
+      return TString::Hash(obj_ptr, obj_cl->Size());
+
+   TDirectory *olddir = gDirectory;
+   gDirectory = 0;
+   TFile *oldfile = gFile;
+   gFile = 0;
+
+   TBufferFile sbuf(TBuffer::kWrite, 100000);
+   sbuf.MapObject(obj_ptr, obj_cl);
+   obj_cl->Streamer(obj_ptr, sbuf);
+
+   gDirectory = olddir;
+   gFile = oldfile;
+
+   return TString::Hash(sbuf.Buffer(), sbuf.Length());
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Method verifies if object can be drawn
 
@@ -1128,7 +1166,10 @@ void TRootSniffer::CreateMemFile()
 
 ////////////////////////////////////////////////////////////////////////////////
 /// produce JSON data for specified item
-/// For object conversion TBufferJSON is used
+/// For object conversion TBufferJSON is used, the JSON code is directly
+/// appended to res while the object is converted.
+/// Option compact=23 suppresses the spaces and writes the numeric arrays
+/// (e.g. histogram contents) in compact form, see TBufferJSON::SetCompact
 
 Bool_t TRootSniffer::ProduceJson(const char *path, const char *options,
                                  TString &res)
@@ -1149,9 +1190,10 @@ Bool_t TRootSniffer::ProduceJson(const char *path, const char *options,
    void *obj_ptr = FindInHierarchy(path, &obj_cl, &member);
    if ((obj_ptr == 0) || ((obj_cl == 0) && (member == 0))) return kFALSE;
 
-   res = TBufferJSON::ConvertToJSON(obj_ptr, obj_cl, compact >= 0 ? compact : 0, member ? member->GetName() : 0);
+   res.Clear();
+   Long64_t len = TBufferJSON::StreamToJSON(res, obj_ptr, obj_cl, compact >= 0 ? compact : 0, member ? member->GetName() : 0);
 
-   return res.Length() > 0;
+   return len > 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -60,5 +60,6 @@
 #pragma link C++ class TSSLSocket;
 #endif
 #pragma link C++ class TParallelMergingFile+;
+#pragma link C++ class TParallelMergingServer+;
 
 #endif
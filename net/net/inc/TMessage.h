@@ -62,6 +62,7 @@ private:
 
    // used by friend TSocket
    Bool_t TestBitNumber(UInt_t bitnumber) const { return fBitsPIDs.TestBitNumber(bitnumber); }
+   Int_t  Compress(const char *payload, Int_t length);
 
 protected:
    TMessage(void *buf, Int_t bufsize);   // only called by T(P)Socket::Recv()
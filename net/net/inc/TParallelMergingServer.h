@@ -0,0 +1,73 @@
+// @(#)root/net:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TParallelMergingServer
+#define ROOT_TParallelMergingServer
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TParallelMergingServer                                               //
+//                                                                      //
+// Server collating the content uploaded by TParallelMergingFile        //
+// clients into the files named after the client files. The buffers    //
+// are merged concurrently by a pool of threads, each of them owning    //
+// the state of a subset of the clients, and a merged snapshot of each  //
+// output file is written at regular intervals.                         //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_Rtypes
+#include "Rtypes.h"
+#endif
+#ifndef ROOT_TString
+#include "TString.h"
+#endif
+
+#include <map>
+#include <vector>
+
+class TServerSocket;
+class TSocket;
+class TMonitor;
+
+class TParallelMergingServer
+{
+private:
+   struct Shard;
+   struct Output;
+
+   TServerSocket                *fServerSocket;   // Socket accepting the client connections.
+   std::vector<Shard*>           fShards;         //! Threads merging the buffers, by client.
+   std::map<TString, Output*>    fOutputs;        //! Merged files, by name.
+   Double_t                      fSnapshotInterval; // Seconds between two snapshots of the merged files.
+   UInt_t                        fNThreads;       // Number of merging threads.
+
+   TParallelMergingServer(const TParallelMergingServer &);            // Not implemented
+   TParallelMergingServer &operator=(const TParallelMergingServer &); // Not implemented
+
+   Bool_t HandleMessage(TSocket *s);
+   void   Snapshot();
+   void   Stop();
+
+public:
+   TParallelMergingServer(Int_t port = 1095, Int_t nthreads = 0);
+   virtual ~TParallelMergingServer();
+
+   Bool_t   IsValid() const;
+   Double_t GetSnapshotInterval() const { return fSnapshotInterval; }
+   void     SetSnapshotInterval(Double_t seconds) { fSnapshotInterval = seconds; }
+   Int_t    Run();
+
+   ClassDef(TParallelMergingServer, 0);  // Server merging concurrently the content uploaded by TParallelMergingFile clients.
+};
+
+#endif // ROOT_TParallelMergingServer
@@ -45,6 +45,16 @@
 // on a per-file basis. See the documentation of the constructor of     //
 // this class for details on the syntax.                                //
 //                                                                      //
+// A TS3WebFile can also be opened in CREATE, NEW or RECREATE mode. The //
+// file is then written with the multipart upload API of S3: it is      //
+// kept in memory in parts of TS3WebFile.PartSize bytes (16 MB by       //
+// default) which are uploaded, by up to TS3WebFile.UploadThreads (4 by //
+// default) concurrent requests, as soon as the file has grown one      //
+// part beyond them. The first part, holding the header of the file and //
+// of its top directory, is uploaded at Close(), when the upload is     //
+// completed and the object appears in the bucket. The space freed in   //
+// the parts already sent cannot be reused and is lost.                 //
+//                                                                      //
 // For generating and signing the HTTP request, this class uses         //
 // TS3HTTPRequest.                                                      //
 //                                                                      //
@@ -72,14 +82,19 @@
 #include "TS3HTTPRequest.h"
 #endif
 
+class TS3MultipartUpload;
 
 class TS3WebFile: public TWebFile {
 
+friend class TS3MultipartUpload;
+
 private:
    TS3WebFile();
    Bool_t ParseOptions(Option_t* options, TString& accessKey, TString& secretKey, TString& token);
    Bool_t GetCredentialsFromEnv(const char* accessKeyEnv, const char* secretKeyEnv, const char* tokenEnv,
                                 TString& outAccessKey, TString& outSecretKey, TString& outToken);
+   void   InitWrite(Bool_t mustNotExist);
+   void   ClipFreeSegments(Long64_t first, Long64_t last);
 
 protected:
    // Super-class methods extended by this class
@@ -87,6 +102,14 @@ protected:
    virtual void SetMsgReadBuffer10(const char* redirectLocation = 0, Bool_t tempRedirect = kFALSE);
    virtual void ProcessHttpHeader(const TString& headerLine);
 
+   // Write mode
+   virtual Int_t SysClose(Int_t fd);
+   virtual Int_t SysRead(Int_t fd, void *buf, Int_t len);
+   virtual Int_t SysWrite(Int_t fd, const void *buf, Int_t len);
+   virtual Int_t SysSync(Int_t fd);
+   Int_t         SendS3Request(TS3HTTPRequest::EHTTPVerb verb, const TString& subresource,
+                               const char* body, Long64_t length, TString* etag, TString* response);
+
    // Modifiers of data members (to be used mainly by subclasses)
    void SetAccessKey(const TString& accessKey) { fS3Request.SetAccessKey(accessKey); }
    void SetSecretKey(const TString& secretKey) { fS3Request.SetSecretKey(secretKey); }
@@ -94,11 +117,12 @@ protected:
    // Data members
    TS3HTTPRequest fS3Request;      // S3 HTTP request
    Bool_t         fUseMultiRange;  // Is the S3 server capable of serving multirange requests?
+   TS3MultipartUpload *fUpload;    //! Upload of the file, in write mode
 
 public:
    // Constructors & Destructor
    TS3WebFile(const char* url, Option_t* options="");
-   virtual ~TS3WebFile() {}
+   virtual ~TS3WebFile();
 
    // Selectors
    const TString&  GetAccessKey() const { return fS3Request.GetAccessKey(); }
@@ -107,10 +131,15 @@ public:
    const TString&  GetObjectKey() const { return fS3Request.GetObjectKey(); }
    const TUrl&     GetUrl() const { return fUrl; }
 
+   virtual Long64_t GetSize() const;
+
    // Modifiers
+   virtual Bool_t ReadBuffer(char* buf, Int_t len);
+   virtual Bool_t ReadBuffer(char* buf, Long64_t pos, Int_t len);
    virtual Bool_t ReadBuffers(char* buf, Long64_t* pos, Int_t* len, Int_t nbuf);
+   virtual void   MakeFree(Long64_t first, Long64_t last);
 
-   ClassDef(TS3WebFile, 0)  // Read a ROOT file from a S3 server
+   ClassDef(TS3WebFile, 0)  // Read and write a ROOT file from a S3 server
 };
 
 #endif // ROOT_TS3WebFile
@@ -126,6 +126,7 @@ protected:
 private:
    TSocket&      operator=(const TSocket &);  // not implemented
    Option_t     *GetOption() const { return TObject::GetOption(); }
+   Int_t         RecvAck(const char *where);
 
 public:
    TSocket(TInetAddress address, const char *service, Int_t tcpwindowsize = -1);
@@ -172,6 +173,7 @@ public:
    virtual Int_t         Send(Int_t status, Int_t kind);
    virtual Int_t         Send(const char *mess, Int_t kind = kMESS_STRING);
    virtual Int_t         SendObject(const TObject *obj, Int_t kind = kMESS_OBJECT);
+   virtual Int_t         SendWithPayload(const TMessage &mess, const void *payload, Int_t length);
    virtual Int_t         SendRaw(const void *buffer, Int_t length,
                                  ESendRecvOptions opt = kDefault);
    void                  SetCompressionAlgorithm(Int_t algorithm=0);
@@ -282,8 +282,21 @@ void TMessage::SetCompressionSettings(Int_t settings)
 /// Returns -1 in case of error (when compression fails or
 /// when the message increases in size in some pathological cases),
 /// otherwise returns 0.
+/// For a fast compression of large messages use the LZ4 algorithm, e.g.
+/// SetCompressionSettings(ROOT::CompressionSettings(ROOT::kLZ4, 1)).
 
 Int_t TMessage::Compress()
+{
+   return Compress(0, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compress the message followed by the length bytes of payload, as if
+/// they had been written at the end of the message, but without copying
+/// them into the message buffer. Used by TSocket::SendWithPayload().
+/// Returns as Compress().
+
+Int_t TMessage::Compress(const char *payload, Int_t length)
 {
    Int_t compressionLevel = GetCompressionLevel();
    Int_t compressionAlgorithm = GetCompressionAlgorithm();
@@ -298,7 +311,7 @@ Int_t TMessage::Compress()
       return 0;
    }
 
-   if (fBufComp && fCompPos == fBufCur) {
+   if (!length && fBufComp && fCompPos == fBufCur) {
       // the message was already compressed
       return 0;
    }
@@ -311,49 +324,50 @@ Int_t TMessage::Compress()
       fCompPos    = 0;
    }
 
-   if (Length() <= (Int_t)(256 + 2*sizeof(UInt_t))) {
+   if (!payload) length = 0;
+   if (Length() + length <= (Int_t)(256 + 2*sizeof(UInt_t))) {
       // this message is too small to be compressed
       return 0;
    }
 
+   // the message and the payload are compressed in separate chunks
    Int_t hdrlen   = 2*sizeof(UInt_t);
-   Int_t messlen  = Length() - hdrlen;
-   Int_t nbuffers = 1 + (messlen - 1) / kMAXZIPBUF;
+   const char *segbuf[2] = { Buffer() + hdrlen, payload };
+   Int_t seglen[2] = { Length() - hdrlen, length };
+   Int_t messlen  = seglen[0] + seglen[1];
+   Int_t nbuffers = 0;
+   for (Int_t s = 0; s < 2; ++s)
+      if (seglen[s] > 0) nbuffers += 1 + (seglen[s] - 1) / kMAXZIPBUF;
    Int_t chdrlen  = 3*sizeof(UInt_t);   // compressed buffer header length
    Int_t buflen   = std::max(512, chdrlen + messlen + 9*nbuffers);
    fBufComp       = new char[buflen];
-   char *messbuf  = Buffer() + hdrlen;
    char *bufcur   = fBufComp + chdrlen;
-   Int_t noutot   = 0;
-   Int_t nzip     = 0;
    Int_t nout, bufmax;
-   for (Int_t i = 0; i < nbuffers; ++i) {
-      if (i == nbuffers - 1)
-         bufmax = messlen - nzip;
-      else
-         bufmax = kMAXZIPBUF;
-      R__zipMultipleAlgorithm(compressionLevel, &bufmax, messbuf, &bufmax, bufcur, &nout, compressionAlgorithm);
-      if (nout == 0 || nout >= messlen) {
-         //this happens when the buffer cannot be compressed
-         delete [] fBufComp;
-         fBufComp    = 0;
-         fBufCompCur = 0;
-         fCompPos    = 0;
-         return -1;
+   for (Int_t s = 0; s < 2; ++s) {
+      char *messbuf = const_cast<char *>(segbuf[s]);
+      for (Int_t nzip = 0; nzip < seglen[s]; nzip += kMAXZIPBUF) {
+         bufmax = std::min(seglen[s] - nzip, (Int_t)kMAXZIPBUF);
+         R__zipMultipleAlgorithm(compressionLevel, &bufmax, messbuf + nzip, &bufmax, bufcur, &nout, compressionAlgorithm);
+         if (nout == 0 || nout >= messlen) {
+            //this happens when the buffer cannot be compressed
+            delete [] fBufComp;
+            fBufComp    = 0;
+            fBufCompCur = 0;
+            fCompPos    = 0;
+            return -1;
+         }
+         bufcur += nout;
       }
-      bufcur  += nout;
-      noutot  += nout;
-      messbuf += kMAXZIPBUF;
-      nzip    += kMAXZIPBUF;
    }
    fBufCompCur = bufcur;
-   fCompPos    = fBufCur;
+   // a compressed payload is not part of the message: compress again next time
+   fCompPos    = length ? 0 : fBufCur;
 
    bufcur = fBufComp;
    tobuf(bufcur, (UInt_t)(CompLength() - sizeof(UInt_t)));
    Int_t what = fWhat | kMESS_ZIP;
    tobuf(bufcur, what);
-   tobuf(bufcur, Length());    // original uncompressed buffer length
+   tobuf(bufcur, Length() + length);    // original uncompressed buffer length
 
    return 0;
 }
@@ -0,0 +1,471 @@
+// @(#)root/net:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TParallelMergingServer
+\ingroup net
+
+Server collating the content uploaded by TParallelMergingFile clients,
+with the protocol of the tutorial parallelMergeServer.C:
+
+~~~{.cpp}
+ROOT::EnableThreadSafety();
+TParallelMergingServer server(1095, 4);
+server.SetSnapshotInterval(10);
+server.Run(); // returns once all the clients are gone
+~~~
+The sockets are handled by a TMonitor, hence by the event loop of the
+system (epoll or kqueue based where available), in the thread calling
+Run(). Each client is assigned to one of the merging threads, which
+owns its files: the buffers of a client are thus processed in the order
+they were received, while those of different clients are merged
+concurrently. The objects reset by the clients after each upload
+(TTree) are merged right away into the output file, the lock of which
+is the only one taken by the merging threads. The other objects
+(histograms) are merged every SetSnapshotInterval() seconds, and when
+Run() ends: each merging thread merges the files of its clients into
+a TMemFile, and these partial merges are then merged into the output
+file, which is written to disk.
+*/
+
+#include "TParallelMergingServer.h"
+
+#include "TClass.h"
+#include "TError.h"
+#include "TFileMerger.h"
+#include "TKey.h"
+#include "TMemFile.h"
+#include "TMessage.h"
+#include "TMonitor.h"
+#include "TROOT.h"
+#include "TServerSocket.h"
+#include "TSocket.h"
+#include "TSystem.h"
+#include "TVirtualMutex.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+ClassImp(TParallelMergingServer)
+
+namespace {
+
+enum EStatusKind {
+   kStartConnection = 0,
+   kProtocol = 1,
+
+   kProtocolVersion = 1
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if dir holds objects which are reset by the clients after
+/// each upload (see TClass::GetResetAfterMerge).
+
+Bool_t NeedInitialMerge(TDirectory *dir)
+{
+   if (dir == 0) return kFALSE;
+
+   TIter nextkey(dir->GetListOfKeys());
+   TKey *key;
+   while ((key = (TKey*)nextkey())) {
+      TClass *cl = TClass::GetClass(key->GetClassName());
+      if (!cl) continue;
+      if (cl->InheritsFrom(TDirectory::Class())) {
+         TDirectory *subdir = (TDirectory *)dir->GetList()->FindObject(key->GetName());
+         if (!subdir) subdir = (TDirectory *)key->ReadObj();
+         if (NeedInitialMerge(subdir)) return kTRUE;
+      } else if (cl->GetResetAfterMerge()) {
+         return kTRUE;
+      }
+   }
+   return kFALSE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete the keys of the objects of dir which are reset by the clients
+/// (withReset) or of the other ones (!withReset).
+
+void DeleteObject(TDirectory *dir, Bool_t withReset)
+{
+   if (dir == 0) return;
+
+   TIter nextkey(dir->GetListOfKeys());
+   TKey *key;
+   while ((key = (TKey*)nextkey())) {
+      TClass *cl = TClass::GetClass(key->GetClassName());
+      if (!cl) continue;
+      if (cl->InheritsFrom(TDirectory::Class())) {
+         TDirectory *subdir = (TDirectory *)dir->GetList()->FindObject(key->GetName());
+         if (!subdir) subdir = (TDirectory *)key->ReadObj();
+         DeleteObject(subdir, withReset);
+      } else if (withReset == (0 != cl->GetResetAfterMerge())) {
+         key->Delete();
+         dir->GetListOfKeys()->Remove(key);
+         delete key;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the keys of source into destination, replacing the ones of the
+/// same name.
+
+void MigrateKey(TDirectory *destination, TDirectory *source)
+{
+   if (destination == 0 || source == 0) return;
+
+   TIter nextkey(source->GetListOfKeys());
+   TKey *key;
+   while ((key = (TKey*)nextkey())) {
+      TClass *cl = TClass::GetClass(key->GetClassName());
+      if (cl && cl->InheritsFrom(TDirectory::Class())) {
+         TDirectory *source_subdir = (TDirectory *)source->GetList()->FindObject(key->GetName());
+         if (!source_subdir) source_subdir = (TDirectory *)key->ReadObj();
+         TDirectory *destination_subdir = destination->GetDirectory(key->GetName());
+         if (!destination_subdir) destination_subdir = destination->mkdir(key->GetName());
+         MigrateKey(destination_subdir, source_subdir);
+      } else {
+         TKey *oldkey = destination->GetKey(key->GetName());
+         if (oldkey) {
+            oldkey->Delete();
+            delete oldkey;
+         }
+         TKey *newkey = new TKey(destination, *key, 0 /* pidoffset */); // the files come from the same client
+         destination->GetFile()->SumBuffer(newkey->GetObjlen());
+         newkey->WriteFile(0);
+         if (destination->GetFile()->TestBit(TFile::kWriteError)) return;
+      }
+   }
+   destination->SaveSelf();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a TMemFile which is not registered in the list of files of gROOT,
+/// as it only belongs to the calling thread.
+
+TMemFile *CreateMemFile(const char *name, char *buffer, Long64_t length)
+{
+   R__LOCKGUARD(gROOTMutex);
+   TDirectory::TContext ctxt;
+   TMemFile *file = buffer ? new TMemFile(name, buffer, length, "UPDATE") : new TMemFile(name, "RECREATE");
+   gROOT->GetListOfFiles()->Remove(file);
+   return file;
+}
+
+} // end of anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merged file: the merger is used by the merging threads for the objects
+/// reset by the clients, and by the thread calling Run() for the snapshots.
+
+struct TParallelMergingServer::Output {
+   TString           fName;   // name of the file
+   std::mutex        fMutex;  // lock of fMerger and of its output file
+   TFileMerger       fMerger; // merger into the file
+   Bool_t            fDirty;  // true if objects were received since the last snapshot
+
+   Output(const char *name) : fName(name), fMerger(kFALSE, kTRUE), fDirty(kFALSE)
+   {
+      fMerger.SetPrintLevel(0);
+      fMerger.OutputFile(name, "RECREATE");
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merging thread with its task queue and the files of its clients.
+
+struct TParallelMergingServer::Shard {
+   typedef std::map<Int_t, TFile*> ClientFiles_t;
+
+   std::mutex                         fMutex;   // lock of fTasks and fStop
+   std::condition_variable            fCond;    // signals a new task or the stop
+   std::deque<std::function<void()> > fTasks;   // tasks to run, in order
+   Bool_t                             fStop;    // true if the thread ends once fTasks is empty
+   std::map<TString, ClientFiles_t>   fClients; // files of the clients, by output file name
+   std::thread                        fThread;  // the thread, started last
+
+   Shard() : fStop(kFALSE), fThread([this]() { this->Loop(); }) {}
+
+   ~Shard()
+   {
+      {
+         std::lock_guard<std::mutex> lock(fMutex);
+         fStop = kTRUE;
+      }
+      fCond.notify_one();
+      fThread.join();
+      for (auto &output : fClients) {
+         for (auto &client : output.second)
+            delete client.second;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   /// Queue a task for the thread.
+
+   void Post(std::function<void()> &&task)
+   {
+      {
+         std::lock_guard<std::mutex> lock(fMutex);
+         fTasks.push_back(std::move(task));
+      }
+      fCond.notify_one();
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   /// Body of the thread: run the tasks until stopped.
+
+   void Loop()
+   {
+      while (true) {
+         std::unique_lock<std::mutex> lock(fMutex);
+         fCond.wait(lock, [this]() { return fStop || !fTasks.empty(); });
+         if (fTasks.empty()) return;
+         std::function<void()> task = std::move(fTasks.front());
+         fTasks.pop_front();
+         lock.unlock();
+         task();
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   /// Merge the objects reset by the client into the output file, and keep
+   /// the others as the file of the client. Takes the ownership of mess.
+
+   void Receive(TMessage *mess, Output *output, Int_t clientId, Long64_t length)
+   {
+      TFile *transient = CreateMemFile(output->fName, mess->Buffer() + mess->Length(), length);
+      delete mess;
+
+      if (NeedInitialMerge(transient)) {
+         std::lock_guard<std::mutex> lock(output->fMutex);
+         output->fMerger.AddFile(transient, kFALSE);
+         output->fMerger.PartialMerge(TFileMerger::kIncremental | TFileMerger::kResetable);
+      }
+      DeleteObject(transient, kTRUE);
+
+      TFile *&file = fClients[output->fName][clientId];
+      if (file) {
+         MigrateKey(file, transient);
+         delete transient;
+      } else {
+         file = transient;
+      }
+   }
+
+   /////////////////////////////////////////////////////////////////////////////
+   /// Return, for each of the outputs, a merger holding the files of the
+   /// clients merged into a TMemFile, or 0 if there are none. The objects
+   /// reset by the clients are removed from their files.
+
+   std::vector<TFileMerger*> MergeClients(const std::vector<Output*> &outputs)
+   {
+      std::vector<TFileMerger*> partials(outputs.size(), (TFileMerger*)0);
+      for (size_t i = 0; i < outputs.size(); ++i) {
+         auto clients = fClients.find(outputs[i]->fName);
+         if (clients == fClients.end() || clients->second.empty()) continue;
+         TFileMerger *merger = new TFileMerger(kFALSE, kTRUE);
+         merger->SetPrintLevel(0);
+         merger->OutputFile(std::unique_ptr<TFile>(CreateMemFile(outputs[i]->fName, 0, 0)));
+         for (auto &client : clients->second)
+            merger->AddFile(client.second, kFALSE);
+         merger->PartialMerge(TFileMerger::kAllIncremental);
+         for (auto &client : clients->second)
+            DeleteObject(client.second, kTRUE);
+         partials[i] = merger;
+      }
+      return partials;
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create a server listening on port, with nthreads merging threads (the
+/// number of cores if nthreads <= 0). Enables the thread safety of ROOT.
+
+TParallelMergingServer::TParallelMergingServer(Int_t port, Int_t nthreads)
+   : fServerSocket(0), fSnapshotInterval(10), fNThreads(nthreads > 0 ? nthreads : 0)
+{
+   if (fNThreads == 0) {
+      SysInfo_t info;
+      fNThreads = (gSystem->GetSysInfo(&info) == 0 && info.fCpus > 0) ? info.fCpus : 1;
+   }
+   ROOT::EnableThreadSafety();
+   fServerSocket = new TServerSocket(port, kTRUE, 100);
+   if (!fServerSocket->IsValid())
+      Error("TParallelMergingServer", "cannot listen on port %d", port);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor. Closes the merged files.
+
+TParallelMergingServer::~TParallelMergingServer()
+{
+   Stop();
+   delete fServerSocket;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the server is listening.
+
+Bool_t TParallelMergingServer::IsValid() const
+{
+   return fServerSocket && fServerSocket->IsValid();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Accept the clients and merge their uploads until all of them are
+/// gone, then write the final snapshot and close the merged files.
+/// Return the number of clients served, or -1 if the server is not valid.
+
+Int_t TParallelMergingServer::Run()
+{
+   if (!IsValid()) return -1;
+
+   for (UInt_t i = fShards.size(); i < fNThreads; ++i)
+      fShards.push_back(new Shard);
+
+   TMonitor mon;
+   mon.Add(fServerSocket);
+
+   typedef std::chrono::steady_clock Clock_t;
+   Clock_t::time_point nextSnapshot = Clock_t::now() + std::chrono::duration_cast<Clock_t::duration>(
+                                                          std::chrono::duration<Double_t>(fSnapshotInterval));
+   Int_t clientIndex = 0;
+   Int_t clientCount = 0;
+   while (clientIndex == 0 || clientCount > 0) {
+      Long_t timeout = -1;
+      if (fSnapshotInterval > 0) {
+         auto left = std::chrono::duration_cast<std::chrono::milliseconds>(nextSnapshot - Clock_t::now());
+         timeout = left.count() > 0 ? left.count() : 0;
+      }
+      TSocket *s = timeout < 0 ? mon.Select() : mon.Select(timeout);
+
+      if (s == fServerSocket) {
+         TSocket *client = fServerSocket->Accept();
+         if (client && client != (TSocket*)-1) {
+            client->Send(clientIndex, kStartConnection);
+            client->Send(kProtocolVersion, kProtocol);
+            ++clientCount;
+            ++clientIndex;
+            mon.Add(client);
+         }
+      } else if (s && s != (TSocket*)-1 && !HandleMessage(s)) {
+         mon.Remove(s);
+         s->Close();
+         delete s;
+         --clientCount;
+      }
+
+      if (fSnapshotInterval > 0 && Clock_t::now() >= nextSnapshot) {
+         Snapshot();
+         nextSnapshot = Clock_t::now() + std::chrono::duration_cast<Clock_t::duration>(
+                                            std::chrono::duration<Double_t>(fSnapshotInterval));
+      }
+   }
+   mon.Remove(fServerSocket);
+
+   Stop();
+   return clientIndex;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read a message of a client and queue its content for the thread of the
+/// client. Return false if the client is gone.
+
+Bool_t TParallelMergingServer::HandleMessage(TSocket *s)
+{
+   TMessage *mess = 0;
+   if (s->Recv(mess) <= 0 || !mess) {
+      delete mess;
+      return kFALSE;
+   }
+   if (mess->What() != kMESS_ANY) {
+      // kMESS_STRING: the client is finished
+      delete mess;
+      return kFALSE;
+   }
+
+   Int_t clientId;
+   TString filename;
+   Long64_t length;
+   mess->ReadInt(clientId);
+   mess->ReadTString(filename);
+   mess->ReadLong64(length);
+
+   Output *&output = fOutputs[filename];
+   if (!output) output = new Output(filename);
+   output->fDirty = kTRUE;
+
+   Shard *shard = fShards[(UInt_t)clientId % fShards.size()];
+   shard->Post([shard, mess, output, clientId, length]() { shard->Receive(mess, output, clientId, length); });
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the merged files which received objects since the last snapshot.
+/// The threads merge the files of their clients once they have processed
+/// the messages already queued, and these partial merges are then merged,
+/// in the order of the threads, into the output files.
+
+void TParallelMergingServer::Snapshot()
+{
+   std::vector<Output*> dirty;
+   for (auto &output : fOutputs) {
+      if (output.second->fDirty) dirty.push_back(output.second);
+      output.second->fDirty = kFALSE;
+   }
+   if (dirty.empty() || fShards.empty()) return;
+
+   std::vector<std::future<std::vector<TFileMerger*> > > futures;
+   for (Shard *shard : fShards) {
+      auto promise = std::make_shared<std::promise<std::vector<TFileMerger*> > >();
+      futures.push_back(promise->get_future());
+      shard->Post([shard, dirty, promise]() { promise->set_value(shard->MergeClients(dirty)); });
+   }
+   std::vector<std::vector<TFileMerger*> > partials;
+   for (auto &future : futures)
+      partials.push_back(future.get());
+
+   for (size_t i = 0; i < dirty.size(); ++i) {
+      std::lock_guard<std::mutex> lock(dirty[i]->fMutex);
+      TFileMerger &merger = dirty[i]->fMerger;
+      DeleteObject(merger.GetOutputFile(), kFALSE); // replaced by the new merge of the clients
+      for (auto &shardPartials : partials) {
+         if (shardPartials[i]) merger.AddFile(shardPartials[i]->GetOutputFile(), kFALSE);
+      }
+      if (!merger.PartialMerge(TFileMerger::kAllIncremental))
+         Error("Snapshot", "cannot merge into %s", dirty[i]->fName.Data());
+   }
+   for (auto &shardPartials : partials) {
+      for (TFileMerger *partial : shardPartials)
+         delete partial;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the final snapshot, stop the merging threads and close the merged
+/// files.
+
+void TParallelMergingServer::Stop()
+{
+   Snapshot();
+   for (Shard *shard : fShards)
+      delete shard;
+   fShards.clear();
+   for (auto &output : fOutputs)
+      delete output.second;
+   fOutputs.clear();
+}
@@ -89,6 +89,7 @@ TS3HTTPRequest::TS3HTTPRequest(const TS3HTTPRequest& r)
    fAccessKey = r.fAccessKey;
    fSecretKey = r.fSecretKey;
    fTimeStamp = r.fTimeStamp;
+   fSessionToken = r.fSessionToken;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
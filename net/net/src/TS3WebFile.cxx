@@ -64,6 +64,253 @@
 #include "TSystem.h"
 #include "TPRegexp.h"
 #include "TEnv.h"
+#include "TObjArray.h"
+#include "TObjString.h"
+#include "TFree.h"
+#include "TMath.h"
+#include "TList.h"
+#include "TSocket.h"
+#include "TSSLSocket.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// State of the multipart upload of a TS3WebFile opened in write mode.
+///
+/// The file is cut in parts of fPartSize bytes; part i holds the bytes
+/// [i*fPartSize, (i+1)*fPartSize) and is sent as part number i+1. The parts
+/// are kept in memory until they are sealed: from then on they cannot be
+/// modified anymore and are uploaded, in a thread of their own if ROOT
+/// thread safety is enabled. The first part is sealed at the end only.
+
+class TS3MultipartUpload {
+public:
+   TS3WebFile                         *fFile;       // File being written
+   TString                             fUploadId;   // Identifier of the upload
+   Long64_t                            fPartSize;   // Size of a part
+   Int_t                               fMaxThreads; // Maximum number of uploads in flight
+   Long64_t                            fSize;       // Size of the file
+   Int_t                               fNextSeal;   // First part, beyond the first one, not sealed
+   std::map<Int_t, std::vector<char> > fParts;      // Parts in memory
+   std::vector<TString>                fETags;      // ETag of the parts uploaded
+   std::deque<std::thread>             fThreads;    // Uploads in flight
+   std::mutex                          fMutex;      // Protect fETags and fFailed
+   Bool_t                              fFailed;     // An upload failed
+
+   static const Int_t kMaxParts = 10000;            // Limit of the S3 protocol
+
+   TS3MultipartUpload(TS3WebFile *file);
+   ~TS3MultipartUpload() { Wait(); }
+
+   Bool_t IsSealed(Int_t part) const { return part > 0 && part < fNextSeal; }
+   Bool_t Start();
+   Int_t  Read(Long64_t pos, char *buf, Int_t len);
+   Int_t  Write(Long64_t pos, const char *buf, Int_t len);
+   void   Seal(Int_t part, Long64_t size);
+   void   Upload(Int_t part, std::vector<char> &data);
+   void   Wait();
+   Bool_t Complete();
+   void   Abort();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+TS3MultipartUpload::TS3MultipartUpload(TS3WebFile *file)
+   : fFile(file), fSize(0), fNextSeal(1), fFailed(kFALSE)
+{
+   // Parts, but the last one, must be at least 5 MB long; HTTP requests
+   // are limited to 2 GB by TSocket.
+   fPartSize = gEnv->GetValue("TS3WebFile.PartSize", 16 * 1024 * 1024);
+   if (fPartSize < 5 * 1024 * 1024) fPartSize = 5 * 1024 * 1024;
+   if (fPartSize > 1024 * 1024 * 1024) fPartSize = 1024 * 1024 * 1024;
+   fMaxThreads = gEnv->GetValue("TS3WebFile.UploadThreads", 4);
+   if (!gROOTMutex) fMaxThreads = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Initiate the upload. Returns kFALSE in case of failure.
+
+Bool_t TS3MultipartUpload::Start()
+{
+   TString response;
+   Int_t status = fFile->SendS3Request(TS3HTTPRequest::kPOST, "?uploads", 0, 0, 0, &response);
+   Ssiz_t b = response.Index("<UploadId>");
+   Ssiz_t e = response.Index("</UploadId>");
+   if (status != 200 || b == kNPOS || e == kNPOS) {
+      ::Error("TS3WebFile", "cannot initiate the upload of %s (HTTP status %d)", fFile->GetName(), status);
+      return kFALSE;
+   }
+   b += strlen("<UploadId>");
+   fUploadId = response(b, e - b);
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy in buf the len bytes at pos, from the parts still in memory. Returns
+/// the number of bytes read, -1 if they have already been uploaded.
+
+Int_t TS3MultipartUpload::Read(Long64_t pos, char *buf, Int_t len)
+{
+   if (pos >= fSize) return 0;
+   if (pos + len > fSize) len = fSize - pos;
+   for (Int_t done = 0; done < len; ) {
+      Int_t part = pos / fPartSize;
+      Long64_t offset = pos - part * fPartSize;
+      Int_t n = TMath::Min((Long64_t)len - done, fPartSize - offset);
+      if (IsSealed(part)) {
+         errno = EIO;
+         return -1;
+      }
+      auto it = fParts.find(part);
+      if (it == fParts.end())
+         memset(buf + done, 0, n);
+      else
+         memcpy(buf + done, it->second.data() + offset, n);
+      done += n;
+      pos += n;
+   }
+   return len;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the len bytes of buf at pos in the parts in memory. Returns len, or
+/// -1 if they fall in a part already sealed.
+
+Int_t TS3MultipartUpload::Write(Long64_t pos, const char *buf, Int_t len)
+{
+   if (pos + len > kMaxParts * fPartSize) {
+      ::Error("TS3WebFile", "%s: the file cannot be larger than %lld bytes, increase TS3WebFile.PartSize",
+              fFile->GetName(), kMaxParts * fPartSize);
+      errno = EFBIG;
+      return -1;
+   }
+   for (Int_t done = 0; done < len; ) {
+      Int_t part = pos / fPartSize;
+      Long64_t offset = pos - part * fPartSize;
+      Int_t n = TMath::Min((Long64_t)len - done, fPartSize - offset);
+      if (IsSealed(part)) {
+         ::Error("TS3WebFile", "%s: cannot write at %lld, this part of the file is already uploaded",
+                 fFile->GetName(), pos);
+         errno = EROFS;
+         return -1;
+      }
+      std::vector<char> &data = fParts[part];
+      if (data.empty()) data.resize(fPartSize);
+      memcpy(data.data() + offset, buf + done, n);
+      done += n;
+      pos += n;
+   }
+   if (pos > fSize) fSize = pos;
+   return len;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Upload the first size bytes of part, which cannot be modified anymore.
+
+void TS3MultipartUpload::Seal(Int_t part, Long64_t size)
+{
+   std::vector<char> data;
+   auto it = fParts.find(part);
+   if (it != fParts.end()) {
+      data.swap(it->second);
+      fParts.erase(it);
+   }
+   data.resize(size);
+   if (part >= fNextSeal) fNextSeal = part + 1;
+   if ((Int_t)fETags.size() <= part) fETags.resize(part + 1);
+
+   if (fMaxThreads <= 0) {
+      Upload(part, data);
+      return;
+   }
+   // Do not keep more than fMaxThreads parts in flight.
+   while ((Int_t)fThreads.size() >= fMaxThreads) {
+      fThreads.front().join();
+      fThreads.pop_front();
+   }
+   fThreads.emplace_back([this, part](std::vector<char> &&buf) { Upload(part, buf); }, std::move(data));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Send part; this runs in a thread of its own when uploads are concurrent.
+
+void TS3MultipartUpload::Upload(Int_t part, std::vector<char> &data)
+{
+   TString etag;
+   TString subresource = TString::Format("?partNumber=%d&uploadId=%s", part + 1, fUploadId.Data());
+   Int_t status = fFile->SendS3Request(TS3HTTPRequest::kPUT, subresource, data.data(), data.size(), &etag, 0);
+
+   std::lock_guard<std::mutex> lock(fMutex);
+   if (status != 200 || etag.IsNull()) {
+      ::Error("TS3WebFile", "cannot upload part %d of %s (HTTP status %d)", part + 1, fFile->GetName(), status);
+      fFailed = kTRUE;
+   } else {
+      fETags[part] = etag;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for the end of the uploads in flight.
+
+void TS3MultipartUpload::Wait()
+{
+   for (auto &t : fThreads)
+      t.join();
+   fThreads.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Upload the remaining parts and complete the upload. Returns kFALSE in
+/// case of failure, the upload being then aborted.
+
+Bool_t TS3MultipartUpload::Complete()
+{
+   Int_t nparts = fSize ? (fSize + fPartSize - 1) / fPartSize : 1;
+   for (Int_t part = 0; part < nparts; ++part) {
+      if (IsSealed(part)) continue;
+      Seal(part, TMath::Min(fPartSize, fSize - part * fPartSize));
+   }
+   Wait();
+
+   if (fFailed) {
+      Abort();
+      return kFALSE;
+   }
+
+   TString body = "<CompleteMultipartUpload>";
+   for (Int_t part = 0; part < nparts; ++part)
+      body += TString::Format("<Part><PartNumber>%d</PartNumber><ETag>%s</ETag></Part>",
+                              part + 1, fETags[part].Data());
+   body += "</CompleteMultipartUpload>";
+
+   TString response;
+   Int_t status = fFile->SendS3Request(TS3HTTPRequest::kPOST, "?uploadId=" + fUploadId,
+                                       body.Data(), body.Length(), 0, &response);
+   // The server may report an error after having sent the status line.
+   if (status != 200 || response.Contains("<Error>")) {
+      ::Error("TS3WebFile", "cannot complete the upload of %s (HTTP status %d)", fFile->GetName(), status);
+      Abort();
+      return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Abort the upload, discarding the parts sent.
+
+void TS3MultipartUpload::Abort()
+{
+   Wait();
+   fFile->SendS3Request(TS3HTTPRequest::kDELETE, "?uploadId=" + fUploadId, 0, 0, 0, 0);
+}
 
 
 ClassImp(TS3WebFile)
@@ -138,9 +385,16 @@ ClassImp(TS3WebFile)
 /// without providing any authentication information to the server. This
 /// is useful when the file is set an access control that allows for
 /// any unidentified user to read the file.
+///
+/// The 'options' argument may also contain 'RECREATE', 'CREATE' or 'NEW'
+/// for writing the file (see the class description); with 'CREATE' and
+/// 'NEW' the file must not exist yet. The 'UPDATE' mode is not supported.
+///
+///    TFile* f4 = TFile::Open("s3://host.example.com/bucket/path/to/my/output",
+///                            "RECREATE");
 
 TS3WebFile::TS3WebFile(const char* path, Option_t* options)
-           : TWebFile(path, "IO")
+           : TWebFile(path, "IO"), fUpload(0)
 {
    // Make sure this is a valid S3 path. We accept 'as3' as a scheme, for
    // backwards compatibility
@@ -159,6 +413,24 @@ TS3WebFile::TS3WebFile(const char* path, Option_t* options)
       doMakeZombie = kTRUE;
    }
 
+   // Look for the open mode among the options
+   Bool_t writeMode = kFALSE;
+   Bool_t mustNotExist = kFALSE;
+   TObjArray *tokens = TString(options).Tokenize(" ");
+   for (Int_t i = 0; i < tokens->GetEntriesFast(); i++) {
+      TString opt = ((TObjString*)tokens->At(i))->GetString();
+      if (opt.EqualTo("RECREATE", TString::kIgnoreCase)) {
+         writeMode = kTRUE;
+      } else if (opt.EqualTo("CREATE", TString::kIgnoreCase) || opt.EqualTo("NEW", TString::kIgnoreCase)) {
+         writeMode = kTRUE;
+         mustNotExist = kTRUE;
+      } else if (opt.EqualTo("UPDATE", TString::kIgnoreCase)) {
+         errorMsg = TString::Format("UPDATE mode not supported for '%s'", path);
+         doMakeZombie = kTRUE;
+      }
+   }
+   delete tokens;
+
    // Should we stop initializing this object?
    if (doMakeZombie) {
       Error("TS3WebFile", "%s", (const char*)errorMsg);
@@ -216,8 +488,11 @@ TS3WebFile::TS3WebFile(const char* path, Option_t* options)
    // later in the initialization process
    fUseMultiRange = kFALSE;
 
-   // Call super-class initializer
-   TWebFile::Init(kFALSE);
+   // Call super-class initializer, or create the file
+   if (writeMode)
+      InitWrite(mustNotExist);
+   else
+      TWebFile::Init(kFALSE);
 
    // Were there some errors opening this file?
    if (IsZombie() && (accessKey.IsNull() || secretKey.IsNull())) {
@@ -230,6 +505,187 @@ TS3WebFile::TS3WebFile(const char* path, Option_t* options)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Close the file if it is being written, completing its upload.
+
+TS3WebFile::~TS3WebFile()
+{
+   if (fUpload)
+      Close();
+   delete fUpload;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the file: initiate its multipart upload and write the header of a
+/// new ROOT file. If mustNotExist, fail if the object already exists.
+
+void TS3WebFile::InitWrite(Bool_t mustNotExist)
+{
+   // The members set by TWebFile::Init
+   fSize          = -1;
+   fHasModRoot    = kFALSE;
+   fHTTP11        = kFALSE;
+   fFullCache     = 0;
+   fFullCacheSize = 0;
+   SetMsgReadBuffer10();
+
+   if (mustNotExist && GetHead() == 0) {
+      Error("TS3WebFile", "file %s already exists", GetName());
+      MakeZombie();
+      gDirectory = gROOT;
+      return;
+   }
+
+   fUpload = new TS3MultipartUpload(this);
+   if (!fUpload->Start()) {
+      delete fUpload;
+      fUpload = 0;
+      MakeZombie();
+      gDirectory = gROOT;
+      return;
+   }
+
+   fOption   = "CREATE";
+   fWritable = kTRUE;
+   fD        = -2;   // so TFile::IsOpen() will return true when in TFile::~TFile
+   fOffset   = 0;
+   TFile::Init(kTRUE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove [first, last] from the list of free segments, so that no record
+/// is allocated in a part of the file already uploaded.
+
+void TS3WebFile::ClipFreeSegments(Long64_t first, Long64_t last)
+{
+   if (!fFree) return;
+   TIter next(fFree);
+   TFree *f;
+   while ((f = (TFree*)next())) {
+      if (f->GetLast() < first || f->GetFirst() > last)
+         continue;
+      if (f->GetFirst() < first && f->GetLast() > last) {
+         TFree *tail = new TFree();
+         tail->SetFirst(last + 1);
+         tail->SetLast(f->GetLast());
+         fFree->AddAfter(f, tail);
+         f->SetLast(first - 1);
+      } else if (f->GetFirst() < first) {
+         f->SetLast(first - 1);
+      } else if (f->GetLast() > last) {
+         f->SetFirst(last + 1);
+      } else {
+         fFree->Remove(f);
+         delete f;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Send a request for the object of this file, with subresource appended
+/// to its key (e.g. "?uploads"), and length bytes of body. The ETag header
+/// of the reply is returned in etag and its body in response, if not null.
+/// Returns the HTTP status of the reply, -1 in case of error.
+///
+/// Each request uses a connection of its own, so that it may be sent from
+/// any thread.
+
+Int_t TS3WebFile::SendS3Request(TS3HTTPRequest::EHTTPVerb verb, const TString& subresource,
+                                const char* body, Long64_t length, TString* etag, TString* response)
+{
+   TS3HTTPRequest request(fS3Request);
+   request.SetObjectKey(fS3Request.GetObjectKey() + subresource);
+   TString msg = request.GetRequest(verb, kFALSE);
+   msg += TString::Format("Content-Length: %lld\r\nConnection: close\r\n\r\n", length);
+
+   TUrl connurl;
+   if (fProxy.IsValid())
+      connurl = fProxy;
+   else
+      connurl = fUrl;
+
+   TSocket *s;
+   if (strcmp(connurl.GetProtocol(), "https") == 0) {
+#ifdef R__SSL
+      s = new TSSLSocket(connurl.GetHost(), connurl.GetPort());
+#else
+      Error("SendS3Request", "library compiled without SSL, https not supported");
+      return -1;
+#endif
+   } else
+      s = new TSocket(connurl.GetHost(), connurl.GetPort());
+
+   if (!s->IsValid()) {
+      Error("SendS3Request", "cannot connect to host %s", fUrl.GetHost());
+      delete s;
+      return -1;
+   }
+
+   if (gDebug > 0)
+      Info("SendS3Request", "sending HTTP request:\n%s", msg.Data());
+
+   if (s->SendRaw(msg.Data(), msg.Length()) == -1 ||
+       (length > 0 && s->SendRaw(body, length) == -1)) {
+      Error("SendS3Request", "error sending request to host %s", fUrl.GetHost());
+      delete s;
+      return -1;
+   }
+
+   // Read the status line and the headers
+   char line[8192];
+   Int_t status = -1;
+   Long64_t contentLength = -1;
+   Bool_t chunked = kFALSE;
+   if (GetLine(s, line, sizeof(line)) <= 0 || sscanf(line, "HTTP/%*s %d", &status) != 1) {
+      Error("SendS3Request", "invalid reply from host %s", fUrl.GetHost());
+      delete s;
+      return -1;
+   }
+   Int_t n;
+   while ((n = GetLine(s, line, sizeof(line))) > 0) {
+      TString header = line;
+      if (header.BeginsWith("ETag:", TString::kIgnoreCase)) {
+         if (etag) *etag = TString(header(5, header.Length())).Strip(TString::kBoth);
+      } else if (header.BeginsWith("Content-Length:", TString::kIgnoreCase)) {
+         contentLength = atoll(header.Data() + 15);
+      } else if (header.BeginsWith("Transfer-Encoding:", TString::kIgnoreCase) &&
+                 header.Contains("chunked", TString::kIgnoreCase)) {
+         chunked = kTRUE;
+      }
+   }
+   if (n < 0) {
+      delete s;
+      return -1;
+   }
+
+   // Read the body
+   if (response) {
+      *response = "";
+      if (chunked) {
+         while (GetLine(s, line, sizeof(line)) > 0) {
+            Long64_t size = strtoll(line, 0, 16);
+            if (size <= 0) break;
+            std::vector<char> chunk(size);
+            if (s->RecvRaw(chunk.data(), size) != size) break;
+            response->Append(chunk.data(), size);
+            GetLine(s, line, sizeof(line)); // CRLF ending the chunk
+         }
+      } else {
+         // Without length, read until the server closes the connection
+         while (contentLength != 0) {
+            Int_t size = (contentLength > 0 && contentLength < (Long64_t)sizeof(line)) ? contentLength : sizeof(line);
+            Int_t nread = s->RecvRaw(line, size);
+            if (nread <= 0) break;
+            response->Append(line, nread);
+            if (contentLength > 0) contentLength -= nread;
+         }
+      }
+   }
+
+   delete s;
+   return status;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Extracts the S3 authentication key pair (access key and secret key)
 /// from the options. The authentication credentials can be specified in
@@ -305,6 +761,10 @@ Bool_t TS3WebFile::ReadBuffers(char* buf, Long64_t* pos, Int_t* len, Int_t nbuf)
    // single HTTP request with a muti-range header or we generate multiple
    // requests with a single range each.
 
+   // In write mode, read the parts in memory
+   if (fUpload)
+      return TFile::ReadBuffers(buf, pos, len, nbuf);
+
    // Does this server support multi-range GET requests?
    if (fUseMultiRange)
       return TWebFile::ReadBuffers(buf, pos, len, nbuf);
@@ -323,6 +783,125 @@ Bool_t TS3WebFile::ReadBuffers(char* buf, Long64_t* pos, Int_t* len, Int_t nbuf)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read len bytes at the current offset. In write mode, the bytes are read
+/// from the parts of the file not yet uploaded.
+
+Bool_t TS3WebFile::ReadBuffer(char* buf, Int_t len)
+{
+   if (fUpload)
+      return TFile::ReadBuffer(buf, len);
+   return TWebFile::ReadBuffer(buf, len);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read len bytes at pos. In write mode, the bytes are read from the parts
+/// of the file not yet uploaded.
+
+Bool_t TS3WebFile::ReadBuffer(char* buf, Long64_t pos, Int_t len)
+{
+   if (fUpload)
+      return TFile::ReadBuffer(buf, pos, len);
+   return TWebFile::ReadBuffer(buf, pos, len);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the size of the file; in write mode, the number of bytes written.
+
+Long64_t TS3WebFile::GetSize() const
+{
+   if (fUpload)
+      return fUpload->fSize;
+   return TWebFile::GetSize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Mark [first, last] as unused. In write mode, the bytes in the parts of
+/// the file already uploaded cannot be reused and are simply dropped.
+
+void TS3WebFile::MakeFree(Long64_t first, Long64_t last)
+{
+   if (fUpload) {
+      Long64_t partSize = fUpload->fPartSize;
+      Long64_t sealedEnd = fUpload->fNextSeal * partSize;
+      if (fUpload->fNextSeal > 1 && first < partSize && last >= partSize) {
+         // Keep the part in the first part of the file
+         TFile::MakeFree(first, partSize - 1);
+         first = partSize;
+      }
+      if (first >= partSize && first < sealedEnd)
+         first = sealedEnd;
+      if (first > last)
+         return;
+   }
+   TFile::MakeFree(first, last);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Read len bytes at the current offset, from the parts in memory.
+
+Int_t TS3WebFile::SysRead(Int_t fd, void *buf, Int_t len)
+{
+   if (!fUpload)
+      return TWebFile::SysRead(fd, buf, len);
+   Int_t n = fUpload->Read(fOffset - fArchiveOffset, (char*)buf, len);
+   if (n > 0)
+      fOffset += n;
+   return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write len bytes at the current offset. Once the file has grown one part
+/// beyond a part, that part is sealed and uploaded.
+
+Int_t TS3WebFile::SysWrite(Int_t fd, const void *buf, Int_t len)
+{
+   if (!fUpload)
+      return TWebFile::SysWrite(fd, buf, len);
+   Int_t n = fUpload->Write(fOffset - fArchiveOffset, (const char*)buf, len);
+   if (n < 0)
+      return n;
+   fOffset += n;
+
+   Long64_t partSize = fUpload->fPartSize;
+   Long64_t end = TMath::Max(fEND, fUpload->fSize);
+   while ((fUpload->fNextSeal + 2) * partSize <= end) {
+      Int_t part = fUpload->fNextSeal;
+      ClipFreeSegments(part * partSize, (part + 1) * partSize - 1);
+      fUpload->Seal(part, partSize);
+   }
+   return n;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Nothing to synchronize in write mode, the parts are sent when sealed.
+
+Int_t TS3WebFile::SysSync(Int_t fd)
+{
+   if (!fUpload)
+      return TWebFile::SysSync(fd);
+   return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// In write mode, upload the remaining parts and complete the upload: the
+/// object is then created in the bucket.
+
+Int_t TS3WebFile::SysClose(Int_t fd)
+{
+   if (!fUpload)
+      return TWebFile::SysClose(fd);
+   Bool_t ok = fUpload->Complete();
+   delete fUpload;
+   fUpload = 0;
+   if (!ok) {
+      errno = EIO;
+      return -1;
+   }
+   return 0;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// This method is called by the super-class TWebFile when a HTTP header
 /// for this file is retrieved. We scan the 'Server' header to detect the
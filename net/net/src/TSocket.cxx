@@ -565,25 +565,102 @@ Int_t TSocket::Send(const TMessage &mess)
 
    // If acknowledgement is desired, wait for it
    if (mess.What() & kMESS_ACK) {
-      TSystem::ResetErrno();
-      ResetBit(TSocket::kBrokenConn);
-      char buf[2];
-      Int_t n = 0;
-      if ((n = gSystem->RecvRaw(fSocket, buf, sizeof(buf), 0)) < 0) {
-         if (n == -5) {
-            // Connection reset by peer or broken
-            SetBit(TSocket::kBrokenConn);
-            Close();
-         } else
-            n = -1;
+      Int_t n;
+      if ((n = RecvAck("Send")) < 0)
          return n;
+   }
+
+   Touch();  // update usage timestamp
+
+   return nsent - sizeof(UInt_t);  //length - length header
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Send a TMessage object followed by the length bytes of payload, as a
+/// single message: the receiver gets a TMessage whose content is the one
+/// of mess followed by the payload, which it reads with e.g.
+/// TMessage::ReadFastArray(buf, length). The payload is not copied into
+/// the message buffer: without compression the length header, the message
+/// and the payload are sent together with a single scatter-gather system
+/// call (see TSystem::SendRawBuffers()), and with compression the payload
+/// is compressed directly from its own buffer. This avoids the copies of
+/// large payloads owned by the caller; use a fast compression algorithm
+/// for them, e.g. SetCompressionSettings(ROOT::CompressionSettings(ROOT::kLZ4, 1)).
+/// Derived classes with their own transport send a copy with Send().
+/// Returns the number of bytes of the message and of the payload that were
+/// sent, and the same error codes as Send().
+
+Int_t TSocket::SendWithPayload(const TMessage &mess, const void *payload, Int_t length)
+{
+   if (!payload || length <= 0)
+      return Send(mess);
+
+   TSystem::ResetErrno();
+
+   if (fSocket == -1) return -1;
+
+   if (mess.IsReading()) {
+      Error("SendWithPayload", "cannot send a message used for reading");
+      return -1;
+   }
+
+   const Int_t hdrlen = 2*sizeof(UInt_t);
+
+   if (IsA() != TSocket::Class()) {
+      // derived classes have their own transport: send a copy
+      TMessage copy(mess.What(), mess.Length() + length);
+      copy.SetCompressionSettings(mess.GetCompressionSettings());
+      copy.WriteFastArray(mess.Buffer() + hdrlen, mess.Length() - hdrlen);
+      copy.WriteFastArray((const char *)payload, length);
+      SendStreamerInfos(mess);
+      SendProcessIDs(mess);
+      return Send(copy);
+   }
+
+   // send streamer infos in case schema evolution is enabled in the TMessage
+   SendStreamerInfos(mess);
+
+   // send the process id's so TRefs work
+   SendProcessIDs(mess);
+
+   mess.SetLength();   //write length in first word of buffer
+
+   if (GetCompressionLevel() > 0 && mess.GetCompressionLevel() == 0)
+      const_cast<TMessage&>(mess).SetCompressionSettings(fCompress);
+
+   if (mess.GetCompressionLevel() > 0)
+      const_cast<TMessage&>(mess).Compress((const char *)payload, length);
+
+   ResetBit(TSocket::kBrokenConn);
+   Int_t nsent;
+   if (mess.CompBuffer()) {
+      nsent = gSystem->SendRaw(fSocket, mess.CompBuffer(), mess.CompLength(), 0);
+   } else {
+      // length header (covering the payload), message and payload
+      char hdr[sizeof(UInt_t)];
+      char *h = hdr;
+      tobuf(h, (UInt_t)(mess.Length() + length - sizeof(UInt_t)));
+      const void *bufs[3] = { hdr, mess.Buffer() + sizeof(UInt_t), payload };
+      Int_t lens[3] = { (Int_t)sizeof(UInt_t), mess.Length() - (Int_t)sizeof(UInt_t), length };
+      nsent = gSystem->SendRawBuffers(fSocket, bufs, lens, 3, 0);
+   }
+   if (nsent <= 0) {
+      if (nsent == -5) {
+         // Connection reset by peer or broken
+         SetBit(TSocket::kBrokenConn);
+         Close();
       }
-      if (strncmp(buf, "ok", 2)) {
-         Error("Send", "bad acknowledgement");
-         return -1;
-      }
-      fBytesRecv  += 2;
-      fgBytesRecv += 2;
+      return nsent;
+   }
+
+   fBytesSent  += nsent;
+   fgBytesSent += nsent;
+
+   // If acknowledgement is desired, wait for it
+   if (mess.What() & kMESS_ACK) {
+      Int_t n;
+      if ((n = RecvAck("SendWithPayload")) < 0)
+         return n;
    }
 
    Touch();  // update usage timestamp
@@ -591,6 +668,35 @@ Int_t TSocket::Send(const TMessage &mess)
    return nsent - sizeof(UInt_t);  //length - length header
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Wait for the acknowledgement of a message sent with kMESS_ACK.
+/// Returns 0 if it was received, -5 if the connection was reset by peer or
+/// broken, and -1 in case of any other error.
+
+Int_t TSocket::RecvAck(const char *where)
+{
+   TSystem::ResetErrno();
+   ResetBit(TSocket::kBrokenConn);
+   char buf[2];
+   Int_t n = 0;
+   if ((n = gSystem->RecvRaw(fSocket, buf, sizeof(buf), 0)) < 0) {
+      if (n == -5) {
+         // Connection reset by peer or broken
+         SetBit(TSocket::kBrokenConn);
+         Close();
+      } else
+         n = -1;
+      return n;
+   }
+   if (strncmp(buf, "ok", 2)) {
+      Error(where, "bad acknowledgement");
+      return -1;
+   }
+   fBytesRecv  += 2;
+   fgBytesRecv += 2;
+   return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Send an object. Returns the number of bytes sent and -1 in case of error.
 /// In case the "kind" has been or'ed with kMESS_ACK, the call will only
@@ -23,6 +23,7 @@
 
 #include "TFile.h"
 #include "TSemaphore.h"
+#include <vector>
 #ifndef __CLING__
 #include <XrdCl/XrdClFileSystem.hh>
 #endif
@@ -50,13 +51,18 @@ private:
    // if requested
    Int_t                   fReadvIorMax; // Max size of a single readv chunk
    Int_t                   fReadvIovMax; // Max number of readv chunks
+   Int_t                   fReadvParallel;  // Number of readv requests to have in flight
+   Long64_t                fReadvGap;       // Max gap between coalesced chunks, -1 if adaptive
+   Double_t                fReadvLatency;   // Measured latency of the readv requests in seconds
+   Double_t                fReadvBandwidth; // Measured bandwidth of the readv requests in bytes/s
    Int_t                   fQueryReadVParams;
    TString                 fNewUrl;
 
 public:
    TNetXNGFile() : TFile(),
       fFile(0), fUrl(0), fMode(XrdCl::OpenFlags::None), fInitCondVar(0),
-      fReadvIorMax(0), fReadvIovMax(0) {}
+      fReadvIorMax(0), fReadvIovMax(0), fReadvParallel(1), fReadvGap(-1),
+      fReadvLatency(0), fReadvBandwidth(0) {}
    TNetXNGFile(const char *url, Option_t *mode = "", const char *title = "",
                Int_t compress = 1, Int_t netopt = 0, Bool_t parallelopen = kFALSE);
    virtual ~TNetXNGFile();
@@ -69,6 +75,8 @@ public:
    virtual Int_t    ReOpen(Option_t *modestr);
    virtual Bool_t   IsOpen() const;
    virtual Bool_t   WriteBuffer(const char *buffer, Int_t length);
+   virtual Bool_t   WriteBufferAt(const char *buffer, Long64_t position, Int_t length);
+   virtual Bool_t   CanWriteAsync() const { return IsUseable(); }
    virtual void     Flush();
    virtual Bool_t   ReadBuffer(char *buffer, Int_t length);
    virtual Bool_t   ReadBuffer(char *buffer, Long64_t position, Int_t length);
@@ -79,6 +87,10 @@ public:
 private:
    virtual Bool_t IsUseable() const;
    virtual Bool_t GetVectorReadLimits();
+   Long64_t       GetVectorReadGap() const;
+   void           UpdateVectorReadRates(const std::vector<Long64_t> &bytes,
+                                        const std::vector<Double_t> &durations,
+                                        Double_t elapsed);
    virtual void   SetEnv();
    Int_t ParseOpenMode(Option_t *in, TString &modestr,
                        XrdCl::OpenFlags::Flags &mode, Bool_t assumeRead);
@@ -37,6 +37,7 @@ class TNetXNGSystem: public TSystem {
 
 private:
    std::set<void *>    fDirPtrs;
+   TMutex              fDirPtrsMutex; // Serialise access to fDirPtrs, for concurrent listings
    static THashList   fgAddrFQDN;  // Cache of addresses to FQDNs
    static TMutex      fgAddrMutex; // Serialise access to the FQDN list
 #ifndef __CINT__
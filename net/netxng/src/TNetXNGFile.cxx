@@ -20,6 +20,7 @@
 
 #include "TNetXNGFile.h"
 #include "TEnv.h"
+#include "TMath.h"
 #include "TSystem.h"
 #include "TTimeStamp.h"
 #include "TVirtualPerfStats.h"
@@ -30,6 +31,8 @@
 #include <XrdCl/XrdClDefaultEnv.hh>
 #include <XrdVersion.hh>
 #include <iostream>
+#include <string.h>
+#include <vector>
 
 //------------------------------------------------------------------------------
 // Open handler for async open requests
@@ -86,8 +89,10 @@ class TAsyncReadvHandler: public XrdCl::ResponseHandler
 
       TAsyncReadvHandler(std::vector<XrdCl::XRootDStatus*> *statuses,
                          Int_t                              statusIndex,
-                         TSemaphore                        *semaphore):
-         fStatuses(statuses), fStatusIndex(statusIndex), fSemaphore(semaphore) {}
+                         TSemaphore                        *semaphore,
+                         std::vector<Double_t>             *durations):
+         fStatuses(statuses), fStatusIndex(statusIndex), fSemaphore(semaphore),
+         fDurations(durations), fStart(TTimeStamp()) {}
 
 
       //------------------------------------------------------------------------
@@ -98,6 +103,7 @@ class TAsyncReadvHandler: public XrdCl::ResponseHandler
                                   XrdCl::AnyObject    *response)
       {
          fStatuses->at(fStatusIndex) = status;
+         fDurations->at(fStatusIndex) = Double_t(TTimeStamp()) - fStart;
          fSemaphore->Post();
          delete response;
          delete this;
@@ -107,6 +113,8 @@ class TAsyncReadvHandler: public XrdCl::ResponseHandler
       std::vector<XrdCl::XRootDStatus*> *fStatuses;    // Pointer to status vector
       Int_t                              fStatusIndex; // Index into status vector
       TSemaphore                        *fSemaphore;   // Synchronize the responses
+      std::vector<Double_t>             *fDurations;   // Pointer to duration vector
+      Double_t                           fStart;       // Time the request was sent
 };
 
 
@@ -147,6 +155,10 @@ TNetXNGFile::TNetXNGFile(const char *url,
    fQueryReadVParams = 1;
    fReadvIorMax = 2097136;
    fReadvIovMax = 1024;
+   fReadvParallel = TMath::Max(1, gEnv->GetValue("NetXNG.ReadvParallel", 4));
+   fReadvGap = gEnv->GetValue("NetXNG.ReadvCoalesceGap", -1);
+   fReadvLatency = 0;
+   fReadvBandwidth = 0;
 
    if (ParseOpenMode(mode, fOption, fMode, kTRUE)<0) {
       Error("Open", "could not parse open mode %s", mode);
@@ -438,6 +450,17 @@ Bool_t TNetXNGFile::ReadBuffer(char *buffer, Long64_t position, Int_t length)
 ////////////////////////////////////////////////////////////////////////////////
 /// Read scattered data chunks in one operation
 ///
+/// The chunks are first coalesced: consecutive chunks separated by a gap
+/// smaller than GetVectorReadGap() are read as a single one, the gaps being
+/// read into a scratch buffer and dropped. The resulting chunks are split in
+/// several vector reads, respecting the server limits, so that up to
+/// NetXNG.ReadvParallel (4 by default) requests of at least one
+/// bandwidth-delay product each are outstanding at the same time. The data
+/// is written directly in buffer by the response handlers; the function
+/// returns when all the responses have arrived. The latency and the
+/// bandwidth measured on these requests drive the coalescing and the
+/// splitting of the next calls.
+///
 /// param buffer:   a pointer to a buffer big enough to hold all of the
 ///                 requested data
 /// param position: position[i] is the seek position of chunk i of len
@@ -457,107 +480,155 @@ Bool_t TNetXNGFile::ReadBuffers(char *buffer, Long64_t *position, Int_t *length,
       return kTRUE;
 
    std::vector<ChunkList>      chunkLists;
+   std::vector<Long64_t>       listBytes;
    ChunkList                   chunks;
+   Long64_t                    chunksBytes = 0;
    std::vector<XRootDStatus*> *statuses;
+   std::vector<Double_t>      *durations;
    TSemaphore                 *semaphore;
    Int_t                       totalBytes = 0;
-   Long64_t                    offset     = 0;
+   Long64_t                    gapBytes   = 0;
    char                       *cursor     = buffer;
 
    Double_t start = 0;
    if (gPerfStats) start = TTimeStamp();
+   Double_t callStart = TTimeStamp();
 
    if (fArchiveOffset)
       for (Int_t i = 0; i < nbuffs; i++)
          position[i] += fArchiveOffset;
 
-   // Build a list of chunks. Put the buffers in the ChunkInfo's
+   // Coalesce the buffers separated by small gaps. Contiguous buffers are
+   // also contiguous in buffer; the ranges with gaps are read in scratch
+   // and copied in buffer once read.
+   struct TRange {
+      Long64_t fPos;    // Position in the file
+      Long64_t fLen;    // Length, including the gaps
+      Int_t    fFirst;  // First buffer of the range
+      Int_t    fLast;   // Last buffer of the range
+      char    *fCursor; // Position of the first buffer in buffer
+      Long64_t fScratch;// Offset in scratch, -1 if read directly in buffer
+   };
+   std::vector<TRange> ranges;
+   Long64_t maxGap = GetVectorReadGap();
+   Long64_t scratchSize = 0;
    for (Int_t i = 0; i < nbuffs; ++i) {
       totalBytes += length[i];
-
-      // If the length is bigger than max readv size, split into smaller chunks
-      if (length[i] > fReadvIorMax) {
-         Int_t nsplit = length[i] / fReadvIorMax;
-         Int_t rem    = length[i] % fReadvIorMax;
-         Int_t j;
-
-         // Add as many max-size chunks as are divisible
-         for (j = 0; j < nsplit; ++j) {
-            offset = position[i] + (j * fReadvIorMax);
-            chunks.push_back(ChunkInfo(offset, fReadvIorMax, cursor));
-            cursor += fReadvIorMax;
+      if (!ranges.empty()) {
+         TRange &r = ranges.back();
+         Long64_t gap = position[i] - (r.fPos + r.fLen);
+         if (gap == 0 || (gap > 0 && gap <= maxGap)) {
+            r.fLen += gap + length[i];
+            r.fLast = i;
+            gapBytes += gap;
+            if (gap) r.fScratch = 0;
+            cursor += length[i];
+            continue;
          }
-
-         // Add the remainder
-         offset = position[i] + (j * fReadvIorMax);
-         chunks.push_back(ChunkInfo(offset, rem, cursor));
-         cursor += rem;
-      } else {
-         chunks.push_back(ChunkInfo(position[i], length[i], cursor));
-         cursor += length[i];
       }
+      ranges.push_back(TRange{position[i], length[i], i, i, cursor, -1});
+      cursor += length[i];
+   }
+   for (auto &r : ranges) {
+      if (r.fScratch < 0) continue;
+      r.fScratch = scratchSize;
+      scratchSize += r.fLen;
+   }
+   std::vector<char> *scratch = new std::vector<char>(scratchSize);
 
-      // If there are more than or equal to max chunks, make another chunk list
-      if ((Int_t) chunks.size() == fReadvIovMax) {
-         chunkLists.push_back(chunks);
-         chunks = ChunkList();
-      } else if ((Int_t) chunks.size() > fReadvIovMax) {
-         chunkLists.push_back(ChunkList(chunks.begin(),
-                                        chunks.begin() + fReadvIovMax));
-         chunks = ChunkList(chunks.begin() + fReadvIovMax, chunks.end());
+   // Size of the requests: enough to have ReadvParallel of them in flight,
+   // but not less than what the link transfers during one round trip.
+   Long64_t requestBytes = (totalBytes + gapBytes) / fReadvParallel + 1;
+   if (requestBytes < fReadvLatency * fReadvBandwidth)
+      requestBytes = Long64_t(fReadvLatency * fReadvBandwidth);
+
+   // Build a list of chunks. Put the buffers in the ChunkInfo's
+   for (auto &r : ranges) {
+      char *dest = r.fScratch < 0 ? r.fCursor : scratch->data() + r.fScratch;
+
+      // If the length is bigger than max readv size, split into smaller chunks
+      for (Long64_t done = 0; done < r.fLen; ) {
+         Int_t len = (Int_t) TMath::Min(r.fLen - done, (Long64_t)fReadvIorMax);
+         chunks.push_back(ChunkInfo(r.fPos + done, len, dest + done));
+         chunksBytes += len;
+         done += len;
+
+         // If there are max chunks or enough bytes, make another chunk list
+         if ((Int_t) chunks.size() >= fReadvIovMax || chunksBytes >= requestBytes) {
+            chunkLists.push_back(chunks);
+            listBytes.push_back(chunksBytes);
+            chunks = ChunkList();
+            chunksBytes = 0;
+         }
       }
    }
 
    // Push back the last chunk list
-   if( !chunks.empty() )
+   if( !chunks.empty() ) {
       chunkLists.push_back(chunks);
+      listBytes.push_back(chunksBytes);
+   }
 
    TAsyncReadvHandler *handler;
    XRootDStatus        status;
    semaphore = new TSemaphore(0);
    statuses  = new std::vector<XRootDStatus*>(chunkLists.size());
+   durations = new std::vector<Double_t>(chunkLists.size());
 
    // Read asynchronously but wait for all responses
-   std::vector<ChunkList>::iterator it;
-   for (it = chunkLists.begin(); it != chunkLists.end(); ++it)
-   {
-      handler = new TAsyncReadvHandler(statuses, it - chunkLists.begin(),
-                                       semaphore);
-      status = fFile->VectorRead(*it, 0, handler);
+   size_t nsent = 0;
+   Bool_t failed = kFALSE;
+   for (nsent = 0; nsent < chunkLists.size(); ++nsent) {
+      handler = new TAsyncReadvHandler(statuses, nsent, semaphore, durations);
+      status = fFile->VectorRead(chunkLists[nsent], 0, handler);
 
       if (!status.IsOK()) {
          Error("ReadBuffers", "%s", status.ToStr().c_str());
-         return kTRUE;
+         delete handler;
+         failed = kTRUE;
+         break;
       }
    }
 
-   // Wait for all responses
-   for (it = chunkLists.begin(); it != chunkLists.end(); ++it) {
+   // Wait for all responses, the handlers write in the buffers
+   for (size_t i = 0; i < nsent; ++i) {
       semaphore->Wait();
    }
 
    // Check for errors
-   for (it = chunkLists.begin(); it != chunkLists.end(); ++it) {
-      XRootDStatus *st = statuses->at(it - chunkLists.begin());
-
-      if (!st->IsOK()) {
+   for (size_t i = 0; i < nsent; ++i) {
+      XRootDStatus *st = statuses->at(i);
+      if (!failed && !st->IsOK()) {
          Error("ReadBuffers", "%s", st->ToStr().c_str());
-         for( ; it != chunkLists.end(); ++it )
-         {
-            st = statuses->at( it - chunkLists.begin() );
-            delete st;
-         }
-         delete statuses;
-         delete semaphore;
-
-         return kTRUE;
+         failed = kTRUE;
       }
       delete st;
    }
 
+   if (!failed) {
+      // Copy the buffers read with their gaps
+      for (auto &r : ranges) {
+         if (r.fScratch < 0) continue;
+         char *dest = r.fCursor;
+         for (Int_t i = r.fFirst; i <= r.fLast; ++i) {
+            memcpy(dest, scratch->data() + r.fScratch + (position[i] - r.fPos), length[i]);
+            dest += length[i];
+         }
+      }
+      UpdateVectorReadRates(listBytes, *durations, TTimeStamp() - callStart);
+   }
+
+   delete scratch;
+   delete durations;
+   delete statuses;
+   delete semaphore;
+   if (failed)
+      return kTRUE;
+
    // Bump the globals
    fBytesRead  += totalBytes;
    fgBytesRead += totalBytes;
+   fBytesReadExtra += gapBytes;
    fReadCalls  ++;
    fgReadCalls ++;
 
@@ -569,11 +640,68 @@ Bool_t TNetXNGFile::ReadBuffers(char *buffer, Long64_t *position, Int_t *length,
    if (gMonitoringWriter)
       gMonitoringWriter->SendFileReadProgress(this);
 
-   delete statuses;
-   delete semaphore;
    return kFALSE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the largest gap, in bytes, between two chunks that ReadBuffers
+/// reads as a single one (NetXNG.ReadvCoalesceGap).
+///
+/// If it is not set (or negative), the gap is adapted to the link: a vector
+/// read costs one round trip for at most fReadvIovMax chunks, so reading
+/// the gap is worth it as long as it takes less than the share of the
+/// round trip of one chunk, i.e. latency * bandwidth / fReadvIovMax bytes
+/// (capped to half of the maximal chunk size).
+
+Long64_t TNetXNGFile::GetVectorReadGap() const
+{
+   if (fReadvGap >= 0)
+      return fReadvGap;
+   if (fReadvLatency <= 0 || fReadvBandwidth <= 0 || fReadvIovMax <= 0)
+      return 0;
+   Double_t gap = fReadvLatency * fReadvBandwidth / fReadvIovMax;
+   return (Long64_t) TMath::Min(gap, 0.5 * fReadvIorMax);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Update the estimates of the latency and of the bandwidth of the link
+/// with the vector reads of one ReadBuffers call: bytes[i] the size and
+/// durations[i] the duration of request i, elapsed the duration of the call.
+
+void TNetXNGFile::UpdateVectorReadRates(const std::vector<Long64_t> &bytes,
+      const std::vector<Double_t> &durations, Double_t elapsed)
+{
+   if (bytes.empty() || elapsed <= 0)
+      return;
+
+   // The fastest request bounds the latency, its transfer time excluded.
+   Double_t latency = -1;
+   Long64_t total = 0;
+   for (size_t i = 0; i < bytes.size(); ++i) {
+      Double_t l = durations[i];
+      if (fReadvBandwidth > 0) l -= bytes[i] / fReadvBandwidth;
+      if (l < 0) l = 0;
+      if (latency < 0 || l < latency) latency = l;
+      total += bytes[i];
+   }
+
+   // Running averages of the measures.
+   const Double_t kWeight = 0.25;
+   if (fReadvLatency <= 0)
+      fReadvLatency = latency;
+   else
+      fReadvLatency = kWeight * latency + (1 - kWeight) * fReadvLatency;
+
+   Double_t transfer = elapsed - fReadvLatency;
+   if (transfer <= 0)
+      return;
+   Double_t bandwidth = total / transfer;
+   if (fReadvBandwidth <= 0)
+      fReadvBandwidth = bandwidth;
+   else
+      fReadvBandwidth = kWeight * bandwidth + (1 - kWeight) * fReadvBandwidth;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Write a data chunk
 ///
@@ -618,6 +746,36 @@ Bool_t TNetXNGFile::WriteBuffer(const char *buffer, Int_t length)
    return kFALSE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Write a data chunk at a given position, without using the current
+/// offset nor the write cache; the XrdCl file can be written from any
+/// thread.
+///
+/// param buffer:   the data to be written
+/// param position: the position of the data in the file
+/// param length:   the size of the buffer
+/// returns:        kTRUE in case of failure
+
+Bool_t TNetXNGFile::WriteBufferAt(const char *buffer, Long64_t position, Int_t length)
+{
+   using namespace XrdCl;
+
+   // Check the file isn't a zombie or closed
+   if (!IsUseable() || !fWritable)
+      return kTRUE;
+
+   XRootDStatus st = fFile->Write(position + fArchiveOffset, length, buffer);
+   if (!st.IsOK()) {
+      Error("WriteBufferAt", "%s", st.ToStr().c_str());
+      return kTRUE;
+   }
+
+   fBytesWrite  += length;
+   fgBytesWrite += length;
+
+   return kFALSE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void TNetXNGFile::Flush()
@@ -111,6 +111,7 @@ void* TNetXNGSystem::OpenDirectory(const char *dir)
    using namespace XrdCl;
 
    DirectoryInfo *dirInfo = new DirectoryInfo(dir);
+   R__LOCKGUARD(&fDirPtrsMutex);
    fDirPtrs.insert( (void*)dirInfo );
    return (void *) dirInfo;
 }
@@ -142,7 +143,10 @@ Int_t TNetXNGSystem::MakeDirectory(const char *dir)
 
 void TNetXNGSystem::FreeDirectory(void *dirp)
 {
-   fDirPtrs.erase( dirp );
+   {
+      R__LOCKGUARD(&fDirPtrsMutex);
+      fDirPtrs.erase( dirp );
+   }
    delete (DirectoryInfo *) dirp;
 }
 
@@ -265,8 +269,10 @@ Bool_t TNetXNGSystem::ConsistentWith(const char *path, void *dirptr)
          return kTRUE;
    }
 
-   if( dirptr )
+   if( dirptr ) {
+      R__LOCKGUARD(&fDirPtrsMutex);
       return fDirPtrs.find( dirptr ) != fDirPtrs.end();
+   }
 
    return kFALSE;
 }
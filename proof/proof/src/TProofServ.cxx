@@ -4561,6 +4561,16 @@ void TProofServ::ProcessNext(TString *slb)
          }
       }
    }
+   // Without any setting, use the submergers when there are enough workers for the
+   // serial merging on the master to be the bottleneck
+   if (IsMaster() && fProof && !gEnv->Lookup("Proof.UseMergers") && !input->FindObject("PROOF_UseMergers")) {
+      Int_t thr = gEnv->GetValue("Proof.AutoMergers", 64);
+      if (thr > 0 && fProof->GetParallel() >= thr) {
+         input->Add(new TParameter<Int_t>("PROOF_UseMergers", 0));
+         PDB(kSubmerger, 2) Info("ProcessNext", "%d workers: submergers enabled (threshold: %d)",
+                                 fProof->GetParallel(), thr);
+      }
+   }
 
    // Set input
    TIter next(input);
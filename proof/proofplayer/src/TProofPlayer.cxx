@@ -2287,6 +2287,13 @@ Long64_t TProofPlayerRemote::Process(TDSet *dset, const char *selector_file,
             }
          }
       }
+      // Without any setting, use the submergers when there are enough workers for the
+      // serial merging on the master to be the bottleneck
+      if (!gEnv->Lookup("Proof.UseMergers") && !fInput->FindObject("PROOF_UseMergers")) {
+         Int_t thr = gEnv->GetValue("Proof.AutoMergers", 64);
+         if (thr > 0 && fProof->GetParallel() >= thr)
+            fInput->Add(new TParameter<Int_t>("PROOF_UseMergers", 0));
+      }
 
       // For a new query clients should make sure that the temporary
       // output list is empty
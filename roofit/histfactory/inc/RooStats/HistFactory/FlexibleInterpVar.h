@@ -56,9 +56,12 @@ namespace HistFactory{
     virtual void printMultiline(std::ostream& os, Int_t contents, Bool_t verbose = kFALSE, TString indent = "") const;
     virtual void printFlexibleInterpVars(std::ostream& os) const;
 
+    virtual Bool_t gradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset=0) const ;
+
   private:
 
     double PolyInterpValue(int i, double x) const;
+    double PolyInterpDerivative(int i, double x) const;
 
   protected:
 
@@ -58,6 +58,10 @@ public:
   Int_t getAnalyticalIntegralWN(RooArgSet& allVars, RooArgSet& analVars, const RooArgSet* normSet,const char* rangeName=0) const ;
   Double_t analyticalIntegralWN(Int_t code, const RooArgSet* normSet, const char* rangeName=0) const ;
 
+  virtual Bool_t gradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset=0) const ;
+  virtual Bool_t analyticalIntegralGradient(Int_t code, const RooArgList& params, Double_t* grad,
+                                            const RooArgSet* normSet, const char* rangeName=0) const ;
+
   static RooArgList createParamSet(RooWorkspace& w, const std::string&, const RooArgList& Vars);
   static RooArgList createParamSet(RooWorkspace& w, const std::string&, const RooArgList& Vars, Double_t, Double_t);
   static RooArgList createParamSet(const std::string&, Int_t, Double_t, Double_t);
@@ -105,6 +109,7 @@ protected:
   Int_t addParamSet( const RooArgList& params );
   static Int_t GetNumBins( const RooArgSet& vars );
   Double_t evaluate() const;
+  Bool_t evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const ;
 
   ClassDef(ParamHistFunc,5) // Sum of RooAbsReal objects
 };
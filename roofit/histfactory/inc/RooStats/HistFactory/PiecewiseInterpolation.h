@@ -49,6 +49,10 @@ public:
   Int_t getAnalyticalIntegralWN(RooArgSet& allVars, RooArgSet& analVars, const RooArgSet* normSet,const char* rangeName=0) const ;
   Double_t analyticalIntegralWN(Int_t code, const RooArgSet* normSet, const char* rangeName=0) const ;
 
+  virtual Bool_t gradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset=0) const ;
+  virtual Bool_t analyticalIntegralGradient(Int_t code, const RooArgList& params, Double_t* grad,
+                                            const RooArgSet* normSet, const char* rangeName=0) const ;
+
   void setPositiveDefinite(bool flag=true){_positiveDefinite=flag;}
 
   void setInterpCode(RooAbsReal& param, int code);
@@ -89,6 +93,7 @@ protected:
   std::vector<int> _interpCode;
 
   Double_t evaluate() const;
+  Bool_t evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const ;
 
   ClassDef(PiecewiseInterpolation,3) // Sum of RooAbsReal objects
 };
@@ -23,6 +23,8 @@ END_HTML
 
 #include "Riostream.h"
 #include <math.h>
+#include <vector>
+#include <algorithm>
 #include "TMath.h"
 
 #include "RooAbsReal.h"
@@ -381,6 +383,28 @@ double FlexibleInterpVar::PolyInterpValue(int i, double x) const {
    return value; 
 }
 
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivative with respect to x of the polynomial used for
+/// interpCode=4, see PolyInterpValue()
+
+double FlexibleInterpVar::PolyInterpDerivative(int i, double x) const {
+   // make sure the polynomial coefficients are cached
+   if (!_logInit) PolyInterpValue(i, x);
+
+   const double * coefficients = &_polCoeff.front() + 6*i;
+
+   double a = coefficients[0];
+   double b = coefficients[1];
+   double c = coefficients[2];
+   double d = coefficients[3];
+   double e = coefficients[4];
+   double f = coefficients[5];
+
+   return a + x * ( 2*b + x * ( 3*c + x * ( 4*d + x * ( 5*e + x * 6*f ) ) ) );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Calculate and return value of polynomial
 
@@ -484,6 +508,118 @@ Double_t FlexibleInterpVar::evaluate() const
   return total;
 }
 
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of evaluate() with respect to 'params'. The
+/// interpolation is differentiated term by term with the same codes as in
+/// evaluate(), with additive and multiplicative terms treated accordingly.
+/// The derivatives are zero where the result is clipped.
+
+Bool_t FlexibleInterpVar::gradient(const RooArgList& params, Double_t* grad, const RooArgSet* /*nset*/) const
+{
+  Int_t n = params.getSize() ;
+  std::fill(grad,grad+n,0.) ;
+  std::vector<Double_t> paramGrad(n) ;
+
+  Double_t total(_nominal) ;
+  RooFIter paramIter = _paramList.fwdIterator() ;
+  RooAbsReal* param ;
+  int i=0;
+
+  while((param=(RooAbsReal*)paramIter.next())) {
+
+    if (!param->gradient(params,paramGrad.data())) return kFALSE ;
+
+    Int_t icode = _interpCode[i] ;
+    double x = param->getVal();
+
+    // Additive terms change the total by 'term', multiplicative terms
+    // multiply it by 'factor'
+    Bool_t additive(kTRUE) ;
+    double term(0), dterm(0), factor(1), dfactor(0) ;
+
+    switch(icode) {
+
+    case 0: {
+      // piece-wise linear
+      dterm = (x>0) ? _high[i] - _nominal : _nominal - _low[i] ;
+      term = x*dterm ;
+      break ;
+    }
+    case 1: {
+      // pice-wise log
+      additive = kFALSE ;
+      if(x>=0) {
+	factor = pow(_high[i]/_nominal, +x);
+	dfactor = factor*log(_high[i]/_nominal);
+      } else {
+	factor = pow(_low[i]/_nominal,  -x);
+	dfactor = -factor*log(_low[i]/_nominal);
+      }
+      break ;
+    }
+    case 2:
+    case 3: {
+      // parabolic with linear
+      double a = 0.5*(_high[i]+_low[i])-_nominal;
+      double b = 0.5*(_high[i]-_low[i]);
+      if(x>1 ){
+	term = (2*a+b)*(x-1)+_high[i]-_nominal;
+	dterm = 2*a+b ;
+      } else if(x<-1 ) {
+	term = -1*(2*a-b)*(x+1)+_low[i]-_nominal;
+	dterm = -1*(2*a-b) ;
+      } else {
+	term = a*x*x + b*x ;
+	dterm = 2*a*x + b ;
+      }
+      break ;
+    }
+    case 4: {
+      additive = kFALSE ;
+      double boundary = _interpBoundary;
+      if(x >= boundary) {
+	factor = std::pow(_high[i]/_nominal, +x);
+	dfactor = factor*std::log(_high[i]/_nominal);
+      } else if (x <= -boundary) {
+	factor = std::pow(_low[i]/_nominal, -x);
+	dfactor = -factor*std::log(_low[i]/_nominal);
+      } else {
+	// The polynomial is one at x=0, its derivative is not zero there
+	factor = (x != 0) ? PolyInterpValue(i, x) : 1. ;
+	dfactor = PolyInterpDerivative(i, x) ;
+      }
+      break ;
+    }
+    default: {
+      coutE(InputArguments) << "FlexibleInterpVar::gradient ERROR:  " << param->GetName()
+			    << " with unknown interpolation code" << endl ;
+      return kFALSE ;
+    }
+    }
+
+    if (additive) {
+      total += term ;
+      for (Int_t k=0 ; k<n ; k++) {
+	grad[k] += dterm*paramGrad[k] ;
+      }
+    } else {
+      for (Int_t k=0 ; k<n ; k++) {
+	grad[k] = grad[k]*factor + total*dfactor*paramGrad[k] ;
+      }
+      total *= factor ;
+    }
+    ++i;
+  }
+
+  if(total<=0) {
+    std::fill(grad,grad+n,0.) ;
+  }
+
+  return kTRUE ;
+}
+
 void FlexibleInterpVar::printMultiline(ostream& os, Int_t contents, 
 				       Bool_t verbose, TString indent) const
 {
@@ -22,6 +22,8 @@ END_HTML
 #include <sstream>
 #include <math.h>
 #include <stdexcept>
+#include <vector>
+#include <algorithm>
 
 #include "TMath.h"
 #include "TH1.h"
@@ -689,6 +691,55 @@ Double_t ParamHistFunc::evaluate() const
 }
 
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate() for the events [begin,end) of 'data'. The
+/// values of the parameters are collected once in an array indexed by bin,
+/// and the bins of all events are calculated in one pass with
+/// RooDataHist::binIndices(). Returns kFALSE if the bins cannot be
+/// calculated in this way, e.g. for non-uniform binnings.
+
+Bool_t ParamHistFunc::evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const
+{
+  const Int_t n = end-begin ;
+
+  // Values of the observables, in the order of the variables of _dataSet
+  RooArgList histVars(*_dataSet.get()) ;
+  std::vector<std::vector<Double_t> > values(histVars.getSize(), std::vector<Double_t>(n)) ;
+  std::vector<const Double_t*> coords(histVars.getSize()) ;
+  for (Int_t i=0; i < histVars.getSize(); ++i) {
+    const RooAbsReal* var = dynamic_cast<const RooAbsReal*>(_dataVars.find(histVars[i].GetName())) ;
+    if (!var || !var->getValBatch(&values[i][0],begin,end,data)) return kFALSE ;
+    coords[i] = &values[i][0] ;
+  }
+
+  std::vector<Int_t> bins(n) ;
+  if (n > 0 && !_dataSet.binIndices(&bins[0],n,coords)) return kFALSE ;
+
+  std::vector<Double_t> binValues(numBins()) ;
+  for (Int_t i=0; i < numBins(); ++i) {
+    binValues[i] = getParameter(i).getVal() ;
+  }
+
+  for (Int_t k=0; k < n; ++k) {
+    output[k] = binValues[bins[k]] ;
+  }
+
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives with respect to 'params', which are those of
+/// the parameter of the current bin
+
+Bool_t ParamHistFunc::gradient(const RooArgList& params, Double_t* grad, const RooArgSet* /*nset*/) const
+{
+  return getParameter().gradient(params,grad) ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Advertise that all integrals can be handled internally.
 
@@ -770,6 +821,41 @@ Double_t ParamHistFunc::analyticalIntegralWN(Int_t /*code*/, const RooArgSet* /*
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of analyticalIntegralWN() with respect to
+/// 'params': the sum of the derivatives of the bin parameters weighted
+/// with the bin volumes
+
+Bool_t ParamHistFunc::analyticalIntegralGradient(Int_t /*code*/, const RooArgList& params, Double_t* grad,
+						 const RooArgSet* /*normSet2*/, const char* /*rangeName*/) const
+{
+  Int_t n = params.getSize() ;
+  std::fill(grad,grad+n,0.) ;
+  std::vector<Double_t> paramGrad(n) ;
+
+  RooFIter paramIter = _paramSet.fwdIterator();
+  RooAbsReal* param = NULL;
+  Int_t nominalItr = 0;
+  while((param = (RooAbsReal*) paramIter.next())) {
+
+    if (!param->gradient(params,paramGrad.data())) return kFALSE ;
+
+    // Get the bin volume
+    _dataSet.get( nominalItr );
+    Double_t binVolumeDS  = _dataSet.binVolume();
+
+    for (Int_t i=0 ; i<n ; i++) {
+      grad[i] += paramGrad[i]*binVolumeDS ;
+    }
+
+    ++nominalItr;
+  }
+
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return sampling hint for making curves of (projections) of this function
 /// as the recursive division strategy of RooCurve cannot deal efficiently
@@ -29,6 +29,8 @@
 
 #include <exception>
 #include <math.h>
+#include <vector>
+#include <algorithm>
 
 using namespace std;
 
@@ -309,6 +311,303 @@ Double_t PiecewiseInterpolation::evaluate() const
 
 }
 
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate() for the events [begin,end) of 'data'. The
+/// nominal and the variations are obtained as arrays with getValBatch(),
+/// e.g. the template histograms of a binned HistFactory channel, and they
+/// are interpolated in one pass over the array per parameter, with the same
+/// expressions as in evaluate(). Returns kFALSE if one of the inputs does not
+/// support batch evaluation or an interpolation code is unknown.
+
+Bool_t PiecewiseInterpolation::evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const
+{
+  const Int_t n = end-begin ;
+  vector<Double_t> nominal(n), low(n), high(n) ;
+  if (!_nominal.arg().getValBatch(&nominal[0],begin,end,data)) return kFALSE ;
+  std::copy(nominal.begin(),nominal.end(),output) ;
+
+  RooAbsReal* param ;
+  int i=0;
+
+  RooFIter lowIter(_lowSet.fwdIterator()) ;
+  RooFIter highIter(_highSet.fwdIterator()) ;
+  RooFIter paramIter(_paramSet.fwdIterator()) ;
+
+  while((param=(RooAbsReal*)paramIter.next())) {
+    RooAbsReal* lowFunc = (RooAbsReal*)lowIter.next() ;
+    RooAbsReal* highFunc = (RooAbsReal*)highIter.next() ;
+    if (!lowFunc->getValBatch(&low[0],begin,end,data) || !highFunc->getValBatch(&high[0],begin,end,data)) return kFALSE ;
+
+    const Int_t icode = _interpCode[i] ;
+    const Double_t x = param->getVal() ;
+
+    switch(icode) {
+    case 0: {
+      // piece-wise linear
+      if (x>0) {
+	for (Int_t k=0 ; k<n ; k++) output[k] += x*(high[k] - nominal[k]) ;
+      } else {
+	for (Int_t k=0 ; k<n ; k++) output[k] += x*(nominal[k] - low[k]) ;
+      }
+      break ;
+    }
+    case 1: {
+      // pice-wise log
+      if (x>=0) {
+	for (Int_t k=0 ; k<n ; k++) output[k] *= pow(high[k]/nominal[k], +x) ;
+      } else {
+	for (Int_t k=0 ; k<n ; k++) output[k] *= pow(low[k]/nominal[k], -x) ;
+      }
+      break ;
+    }
+    case 2:
+    case 3: {
+      // parabolic with linear, and parabolic version of log-normal
+      for (Int_t k=0 ; k<n ; k++) {
+	double a = 0.5*(high[k]+low[k])-nominal[k];
+	double b = 0.5*(high[k]-low[k]);
+	double c = 0;
+	if (x>1) {
+	  output[k] += (2*a+b)*(x-1)+high[k]-nominal[k];
+	} else if (x<-1) {
+	  output[k] += -1*(2*a-b)*(x+1)+low[k]-nominal[k];
+	} else {
+	  output[k] += a*pow(x,2) + b*x+c;
+	}
+      }
+      break ;
+    }
+    case 4: {
+      if (x>1) {
+	for (Int_t k=0 ; k<n ; k++) output[k] += x*(high[k] - nominal[k]) ;
+      } else if (x<-1) {
+	for (Int_t k=0 ; k<n ; k++) output[k] += x*(nominal[k] - low[k]) ;
+      } else {
+	// the polynomial in x is the same for all elements
+	const double q = 15 + x * x * (-10 + x * x * 3  ) ;
+	for (Int_t k=0 ; k<n ; k++) {
+	  double eps_plus = high[k] - nominal[k];
+	  double eps_minus = nominal[k] - low[k];
+	  double S = 0.5 * (eps_plus + eps_minus);
+	  double A = 0.0625 * (eps_plus - eps_minus);
+	  double val = nominal[k] + x * (S + x * A * q) ;
+	  if (val < 0) val = 0;
+	  output[k] += val-nominal[k];
+	}
+      }
+      break ;
+    }
+    case 5: {
+      double x0 = 1.0;//boundary;
+      if (x > x0 || x < -x0) {
+	if (x>0) {
+	  for (Int_t k=0 ; k<n ; k++) output[k] += x*(high[k] - nominal[k]) ;
+	} else {
+	  for (Int_t k=0 ; k<n ; k++) output[k] += x*(nominal[k] - low[k]) ;
+	}
+      } else {
+	for (Int_t k=0 ; k<n ; k++) {
+	  if (nominal[k] == 0) continue ;
+	  double eps_plus = high[k] - nominal[k];
+	  double eps_minus = nominal[k] - low[k];
+	  double S = (eps_plus + eps_minus)/2;
+	  double A = (eps_plus - eps_minus)/2;
+	  double a = S;
+	  double b = 3*A/(2*x0);
+	  double d = -A/(2*x0*x0*x0);
+	  double val = nominal[k] + a*x + b*pow(x, 2) + d*pow(x, 4);
+	  if (val < 0) val = 0;
+	  output[k] += val-nominal[k];
+	}
+      }
+      break ;
+    }
+    default: {
+      coutE(InputArguments) << "PiecewiseInterpolation::evaluateBatch ERROR:  " << param->GetName() 
+			    << " with unknown interpolation code" << icode << endl ;
+      return kFALSE ;
+    }
+    }
+    ++i;
+  }
+
+  if (_positiveDefinite) {
+    for (Int_t k=0 ; k<n ; k++) {
+      if (output[k]<0) output[k] = 0 ;
+    }
+  }
+
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if one of the functions in 'funcs' depends on the value of
+/// one of the parameters in 'params'
+
+static Bool_t anyDependsOnValue(const RooArgList& funcs, const RooArgList& params)
+{
+  RooFIter iter(funcs.fwdIterator()) ;
+  RooAbsArg* func ;
+  while((func=iter.next())) {
+    if (func->dependsOnValue(params)) return kTRUE ;
+  }
+  return kFALSE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of evaluate() with respect to 'params'. The
+/// interpolation is differentiated term by term with the same codes as in
+/// evaluate(), where the derivative is zero where a term or the result is
+/// clipped at zero. Returns kFALSE if the nominal or the variations depend on
+/// the parameters.
+
+Bool_t PiecewiseInterpolation::gradient(const RooArgList& params, Double_t* grad, const RooArgSet* /*nset*/) const
+{
+  if (_nominal.arg().dependsOnValue(params) || anyDependsOnValue(_lowSet,params) || anyDependsOnValue(_highSet,params)) {
+    return kFALSE ;
+  }
+
+  Int_t n = params.getSize() ;
+  std::fill(grad,grad+n,0.) ;
+  std::vector<Double_t> paramGrad(n) ;
+
+  Double_t nominal = _nominal;
+  Double_t sum(nominal) ;
+
+  RooAbsReal* param ;
+  RooAbsReal* high ;
+  RooAbsReal* low ;
+  int i=0;
+
+  RooFIter lowIter(_lowSet.fwdIterator()) ;
+  RooFIter highIter(_highSet.fwdIterator()) ;
+  RooFIter paramIter(_paramSet.fwdIterator()) ;
+
+  while((param=(RooAbsReal*)paramIter.next())) {
+    low = (RooAbsReal*)lowIter.next() ;
+    high = (RooAbsReal*)highIter.next() ;
+
+    if (!param->gradient(params,paramGrad.data())) return kFALSE ;
+
+    Int_t icode = _interpCode[i] ;
+    double x = param->getVal();
+    double term(0), dterm(0) ;
+
+    switch(icode) {
+    case 0: {
+      // piece-wise linear
+      dterm = (x>0) ? high->getVal() - nominal : nominal - low->getVal() ;
+      term = x*dterm ;
+      break ;
+    }
+    case 1: {
+      // pice-wise log, multiplies the sum
+      double factor, dfactor ;
+      if(x>=0) {
+	factor = pow(high->getVal()/nominal, +x);
+	dfactor = factor*log(high->getVal()/nominal);
+      } else {
+	factor = pow(low->getVal()/nominal,  -x);
+	dfactor = -factor*log(low->getVal()/nominal);
+      }
+      for (Int_t k=0 ; k<n ; k++) {
+	grad[k] = grad[k]*factor + sum*dfactor*paramGrad[k] ;
+      }
+      sum *= factor ;
+      ++i;
+      continue ;
+    }
+    case 2:
+    case 3: {
+      // parabolic with linear
+      double a = 0.5*(high->getVal()+low->getVal())-nominal;
+      double b = 0.5*(high->getVal()-low->getVal());
+      if(x>1 ){
+	term = (2*a+b)*(x-1)+high->getVal()-nominal;
+	dterm = 2*a+b ;
+      } else if(x<-1 ) {
+	term = -1*(2*a-b)*(x+1)+low->getVal()-nominal;
+	dterm = -1*(2*a-b) ;
+      } else {
+	term = a*x*x + b*x ;
+	dterm = 2*a*x + b ;
+      }
+      break ;
+    }
+    case 4: {
+      if (x>1) {
+	term = x*(high->getVal() - nominal );
+	dterm = high->getVal() - nominal ;
+      } else if (x<-1) {
+	term = x*(nominal - low->getVal());
+	dterm = nominal - low->getVal() ;
+      } else {
+	double eps_plus = high->getVal() - nominal;
+	double eps_minus = nominal - low->getVal();
+	double S = 0.5 * (eps_plus + eps_minus);
+	double A = 0.0625 * (eps_plus - eps_minus);
+
+	double val = nominal + x * (S + x * A * ( 15 + x * x * (-10 + x * x * 3  ) ) );
+	if (val < 0) {
+	  term = -nominal ;
+	} else {
+	  term = val-nominal ;
+	  dterm = S + x * A * ( 30 + x * x * (-40 + x * x * 18 ) ) ;
+	}
+      }
+      break ;
+    }
+    case 5: {
+      double x0 = 1.0;//boundary;
+      if (x > x0 || x < -x0) {
+	dterm = (x>0) ? high->getVal() - nominal : nominal - low->getVal() ;
+	term = x*dterm ;
+      } else if (nominal != 0) {
+	double eps_plus = high->getVal() - nominal;
+	double eps_minus = nominal - low->getVal();
+	double S = (eps_plus + eps_minus)/2;
+	double A = (eps_plus - eps_minus)/2;
+
+	double a = S;
+	double b = 3*A/(2*x0);
+	double d = -A/(2*x0*x0*x0);
+
+	double val = nominal + a*x + b*x*x + d*x*x*x*x;
+	if (val < 0) {
+	  term = -nominal ;
+	} else {
+	  term = val-nominal ;
+	  dterm = a + 2*b*x + 4*d*x*x*x ;
+	}
+      }
+      break ;
+    }
+    default: {
+      coutE(InputArguments) << "PiecewiseInterpolation::gradient ERROR:  " << param->GetName()
+			    << " with unknown interpolation code" << icode << endl ;
+      return kFALSE ;
+    }
+    }
+
+    sum += term ;
+    for (Int_t k=0 ; k<n ; k++) {
+      grad[k] += dterm*paramGrad[k] ;
+    }
+    ++i;
+  }
+
+  if(_positiveDefinite && (sum<0)){
+    std::fill(grad,grad+n,0.) ;
+  }
+  return kTRUE ;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Bool_t PiecewiseInterpolation::setBinIntegrator(RooArgSet& allVars) 
@@ -604,6 +903,49 @@ Double_t PiecewiseInterpolation::analyticalIntegralWN(Int_t code, const RooArgSe
 }
 
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of analyticalIntegralWN() with respect to 'params',
+/// using the same piece-wise linear interpolation of the integrals. Returns
+/// kFALSE if the integrals of the nominal or the variations depend on the
+/// parameters
+
+Bool_t PiecewiseInterpolation::analyticalIntegralGradient(Int_t code, const RooArgList& params, Double_t* grad,
+							  const RooArgSet* normSet2, const char* /*rangeName*/) const
+{
+  if (code==0) return gradient(params,grad,normSet2) ;
+
+  CacheElem* cache = (CacheElem*) _normIntMgr.getObjByIndex(code-1) ;
+  if( cache==NULL || cache->_funcIntList.getSize()!=1 ||
+      anyDependsOnValue(cache->_funcIntList,params) || anyDependsOnValue(cache->_lowIntList,params) ||
+      anyDependsOnValue(cache->_highIntList,params) ) {
+    return kFALSE ;
+  }
+
+  Int_t n = params.getSize() ;
+  std::fill(grad,grad+n,0.) ;
+  std::vector<Double_t> paramGrad(n) ;
+
+  Double_t nominal = ((RooAbsReal*)cache->_funcIntList.at(0))->getVal() ;
+  RooFIter lowIntIter = cache->_lowIntList.fwdIterator() ;
+  RooFIter highIntIter = cache->_highIntList.fwdIterator() ;
+  RooFIter paramIter(_paramSet.fwdIterator()) ;
+  RooAbsReal *low(0), *high(0), *param(0) ;
+  while( (param=(RooAbsReal*)paramIter.next()) ) {
+    low = (RooAbsReal*)lowIntIter.next() ;
+    high = (RooAbsReal*)highIntIter.next() ;
+
+    if (!param->gradient(params,paramGrad.data())) return kFALSE ;
+    Double_t dterm = (param->getVal()>0) ? high->getVal() - nominal : nominal - low->getVal() ;
+    for (Int_t k=0 ; k<n ; k++) {
+      grad[k] += dterm*paramGrad[k] ;
+    }
+  }
+
+  return kTRUE ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void PiecewiseInterpolation::setInterpCode(RooAbsReal& param, int code){
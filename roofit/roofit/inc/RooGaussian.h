@@ -46,6 +46,9 @@ protected:
   RooRealProxy sigma ;
   
   Double_t evaluate() const ;
+  Bool_t evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const ;
+  Bool_t evaluateGradient(const RooArgList& params, Double_t* grad) const ;
+  Bool_t analyticalIntegralRawGradient(Int_t code, const RooArgList& params, Double_t* grad, const char* rangeName=0) const ;
 
 private:
 
@@ -27,6 +27,7 @@ Exponential p.d.f
 #include "Riostream.h"
 #include "Riostream.h"
 #include <math.h>
+#include <vector>
 
 #include "RooExponential.h"
 #include "RooRealVar.h"
@@ -63,6 +64,25 @@ Double_t RooExponential::evaluate() const{
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate() for the events [begin,end) of 'data'
+
+Bool_t RooExponential::evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const
+{
+  const Int_t n = end-begin;
+  std::vector<Double_t> xv(n), cv(n);
+  if (!x.arg().getValBatch(&xv[0],begin,end,data,x.nset()) ||
+      !c.arg().getValBatch(&cv[0],begin,end,data,c.nset())) {
+    return kFALSE;
+  }
+
+  for (Int_t i=0 ; i<n ; i++) {
+    output[i] = exp(cv[i]*xv[i]);
+  }
+  return kTRUE;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Int_t RooExponential::getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* /*rangeName*/) const 
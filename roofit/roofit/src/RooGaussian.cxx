@@ -27,6 +27,7 @@ Plain Gaussian p.d.f
 #include "Riostream.h"
 #include "Riostream.h"
 #include <math.h>
+#include <vector>
 
 #include "RooGaussian.h"
 #include "RooAbsReal.h"
@@ -78,6 +79,55 @@ Double_t RooGaussian::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivatives of evaluate() with respect to 'params' with the
+/// chain rule from those of x, mean and sigma
+
+Bool_t RooGaussian::evaluateGradient(const RooArgList& params, Double_t* grad) const
+{
+  Int_t n = params.getSize() ;
+  std::vector<Double_t> gx(n), gmean(n), gsigma(n) ;
+  if (!x.arg().gradient(params,gx.data()) || !mean.arg().gradient(params,gmean.data()) ||
+      !sigma.arg().gradient(params,gsigma.data())) {
+    return kFALSE ;
+  }
+
+  Double_t arg = x - mean ;
+  Double_t sig = sigma ;
+  Double_t ret = exp(-0.5*arg*arg/(sig*sig)) ;
+  Double_t dArg = -arg/(sig*sig)*ret ;
+  Double_t dSig = arg*arg/(sig*sig*sig)*ret ;
+  for (Int_t i=0 ; i<n ; i++) {
+    grad[i] = dArg*(gx[i]-gmean[i]) + dSig*gsigma[i] ;
+  }
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate() for the events [begin,end) of 'data'
+
+Bool_t RooGaussian::evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const
+{
+  const Int_t n = end-begin ;
+  std::vector<Double_t> xv(n), meanv(n), sigmav(n) ;
+  if (!x.arg().getValBatch(&xv[0],begin,end,data,x.nset()) ||
+      !mean.arg().getValBatch(&meanv[0],begin,end,data,mean.nset()) ||
+      !sigma.arg().getValBatch(&sigmav[0],begin,end,data,sigma.nset())) {
+    return kFALSE ;
+  }
+
+  for (Int_t i=0 ; i<n ; i++) {
+    Double_t arg = xv[i] - meanv[i] ;
+    Double_t sig = sigmav[i] ;
+    output[i] = exp(-0.5*arg*arg/(sig*sig)) ;
+  }
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// calculate and return the negative log-likelihood of the Poisson                                                                                                                                    
 
@@ -136,6 +186,42 @@ Double_t RooGaussian::analyticalIntegral(Int_t code, const char* rangeName) cons
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivatives of analyticalIntegral() with respect to
+/// 'params' from those of sigma and of the variable that is not integrated
+
+Bool_t RooGaussian::analyticalIntegralRawGradient(Int_t code, const RooArgList& params, Double_t* grad, const char* rangeName) const
+{
+  assert(code==1 || code==2) ;
+
+  // The integral depends on (max-c)/sigma and (min-c)/sigma where c is
+  // the mean for integrals over x and x for integrals over the mean
+  const RooAbsReal& center = (code==1) ? mean.arg() : x.arg() ;
+  Double_t c = center.getVal() ;
+  Double_t cmin = (code==1) ? x.min(rangeName) : mean.min(rangeName) ;
+  Double_t cmax = (code==1) ? x.max(rangeName) : mean.max(rangeName) ;
+
+  Int_t n = params.getSize() ;
+  std::vector<Double_t> gcenter(n), gsigma(n) ;
+  if (!center.gradient(params,gcenter.data()) || !sigma.arg().gradient(params,gsigma.data())) {
+    return kFALSE ;
+  }
+
+  Double_t sig = sigma ;
+  Double_t ua = (cmin-c)/sig ;
+  Double_t ub = (cmax-c)/sig ;
+  Double_t ea = exp(-0.5*ua*ua) ;
+  Double_t eb = exp(-0.5*ub*ub) ;
+  Double_t dCenter = ea - eb ;
+  Double_t dSig = analyticalIntegral(code,rangeName)/sig - (ub*eb - ua*ea) ;
+  for (Int_t i=0 ; i<n ; i++) {
+    grad[i] = dCenter*gcenter[i] + dSig*gsigma[i] ;
+  }
+  return kTRUE ;
+}
+
+
+
 
 ////////////////////////////////////////////////////////////////////////////////
 
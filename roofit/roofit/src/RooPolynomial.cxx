@@ -28,6 +28,7 @@ less than polynomial functions due to the normalization condition
 
 #include <cmath>
 #include <cassert>
+#include <algorithm>
 
 #include "RooPolynomial.h"
 #include "RooAbsReal.h"
@@ -137,6 +138,42 @@ Double_t RooPolynomial::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate() for the events [begin,end) of 'data'
+
+Bool_t RooPolynomial::evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const
+{
+  const unsigned sz = _coefList.getSize();
+  const int lowestOrder = _lowestOrder;
+  const Int_t n = end - begin;
+  if (!sz) {
+    std::fill(output, output + n, lowestOrder ? 1. : 0.);
+    return kTRUE;
+  }
+
+  // coefficient k of event i is coefs[k * n + i]
+  std::vector<Double_t> xv(n), coefs(sz * n);
+  if (!_x.arg().getValBatch(&xv[0], begin, end, data, _x.nset())) return kFALSE;
+  {
+    const RooArgSet* nset = _coefList.nset();
+    RooFIter it = _coefList.fwdIterator();
+    RooAbsReal* c;
+    for (unsigned k = 0; (c = (RooAbsReal*) it.next()); ++k) {
+      if (!c->getValBatch(&coefs[k * n], begin, end, data, nset)) return kFALSE;
+    }
+  }
+
+  for (Int_t i = 0; i < n; ++i) {
+    const Double_t x = xv[i];
+    Double_t retVal = coefs[(sz - 1) * n + i];
+    for (unsigned k = sz - 1; k--; ) retVal = coefs[k * n + i] + x * retVal;
+    output[i] = retVal * std::pow(x, lowestOrder) + (lowestOrder ? 1.0 : 0.0);
+  }
+  return kTRUE;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Int_t RooPolynomial::getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* /*rangeName*/) const 
@@ -21,6 +21,7 @@
 #pragma link C++ class RooHistFunc- ;
 #pragma link C++ class RooExpensiveObjectCache+ ;
 #pragma link C++ class RooExpensiveObjectCache::ExpensiveObject+ ;
+#pragma link C++ class RooNumIntCache+ ;
 #pragma link C++ class std::map<std::string,RooAbsPdf*>+ ;
 // The nomap options excludes the class from the roomap file
 #pragma link C++ options=nomap class std::map<std::string,TH1*>+ ;
@@ -29,6 +29,7 @@
 #include <set>
 #include <deque>
 #include <stack>
+#include <vector>
 
 #include <iostream>
 
@@ -566,6 +567,12 @@ public:
   mutable Bool_t _valueDirty ;  // Flag set if value needs recalculating because input values modified
   mutable Bool_t _shapeDirty ;  // Flag set if value needs recalculating because input shapes modified
 
+  // Flattened value dirty state propagation
+  void buildValueDirtyList() const ;
+  static void graphChanged() ;
+  mutable std::vector<const RooAbsArg*> _valueDirtyList ; //! Nodes that setValueDirty() marks dirty
+  mutable UInt_t _valueDirtyListEpoch ; //! Graph epoch at which _valueDirtyList was built
+
   friend class RooRealProxy ;
   mutable OperMode _operMode ; // Dirty state propagation mode
   mutable Bool_t _fast ; // Allow fast access mode in getVal() and proxies
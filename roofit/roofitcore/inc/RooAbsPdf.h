@@ -185,7 +185,9 @@ public:
   // Function evaluation support
   virtual Bool_t traceEvalHook(Double_t value) const ;  
   virtual Double_t getValV(const RooArgSet* set=0) const ;
+  virtual Bool_t getValBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data, const RooArgSet* set=0) const ;
   virtual Double_t getLogVal(const RooArgSet* set=0) const ;
+  virtual Bool_t gradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset=0) const ;
 
   Double_t getNorm(const RooArgSet& nset) const { 
     // Get p.d.f normalization term needed for observables 'nset'
@@ -198,6 +200,8 @@ public:
   Bool_t traceEvalPdf(Double_t value) const ;
 
   Double_t analyticalIntegralWN(Int_t code, const RooArgSet* normSet, const char* rangeName=0) const ;
+  virtual Bool_t analyticalIntegralGradient(Int_t code, const RooArgList& params, Double_t* grad,
+                                            const RooArgSet* normSet, const char* rangeName=0) const ;
 
   virtual Bool_t selfNormalized() const { 
     // If true, p.d.f is taken as self-normalized and no attempt is made to add a normalization term
@@ -226,6 +230,7 @@ public:
     // Return expecteded number of p.d.fs to be used in calculated of extended likelihood
     return expectedEvents(&nset) ; 
   }
+  virtual Bool_t expectedEventsGradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset) const ;
 
   // Printing interface (human readable)
   virtual void printValue(std::ostream& os) const ;
@@ -296,6 +301,10 @@ protected:
 
   virtual Bool_t syncNormalization(const RooArgSet* dset, Bool_t adjustProxies=kTRUE) const ;
 
+  // Analytic derivatives of the unnormalized value and integrals
+  virtual Bool_t evaluateGradient(const RooArgList& params, Double_t* grad) const ;
+  virtual Bool_t analyticalIntegralRawGradient(Int_t code, const RooArgList& params, Double_t* grad, const char* rangeName=0) const ;
+
   friend class RooAbsAnaConvPdf ;
   mutable Double_t _rawValue ;
   mutable RooAbsReal* _norm   ;      //! Normalization integral (owned by _normMgr)
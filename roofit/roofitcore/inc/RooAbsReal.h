@@ -73,6 +73,12 @@ public:
 
   virtual Double_t getValV(const RooArgSet* set=0) const ;
 
+  // Batch evaluation over the events [begin,end) of a vector data store
+  virtual Bool_t getValBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data, const RooArgSet* set=0) const ;
+
+  // Analytic gradient with respect to a list of parameters
+  virtual Bool_t gradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset=0) const ;
+
   Double_t getPropagatedError(const RooFitResult& fr) ;
 
   Bool_t operator==(Double_t value) const ;
@@ -101,6 +107,8 @@ public:
   virtual Double_t analyticalIntegralWN(Int_t code, const RooArgSet* normSet, const char* rangeName=0) const ;
   virtual Int_t getAnalyticalIntegral(RooArgSet& allVars, RooArgSet& analVars, const char* rangeName=0) const ;
   virtual Double_t analyticalIntegral(Int_t code, const char* rangeName=0) const ;
+  virtual Bool_t analyticalIntegralGradient(Int_t code, const RooArgList& params, Double_t* grad,
+                                            const RooArgSet* normSet, const char* rangeName=0) const ;
   virtual Bool_t forceAnalyticalInt(const RooAbsArg& /*dep*/) const { 
     // Interface to force RooRealIntegral to offer given observable for internal integration
     // even if this is deemed unsafe. This default implementation returns always flase
@@ -372,6 +380,10 @@ protected:
   }
   virtual Double_t evaluate() const = 0 ;
 
+  // Batch evaluation support
+  virtual Bool_t evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const ;
+  Bool_t getBatchFromData(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data, const RooArgSet* set) const ;
+
   // Hooks for RooDataSet interface
   friend class RooRealIntegral ;
   friend class RooVectorDataStore ;
@@ -64,6 +64,11 @@ public:
   virtual Double_t offset() const { return _offset ; }
   virtual Double_t offsetCarry() const { return _offsetCarry; }
 
+  virtual Bool_t gradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset=0) const ;
+
+  static void enableThreadedMode(Bool_t flag=kTRUE) ;
+  static Bool_t isThreadedModeEnabled() ;
+
 protected:
 
   virtual void printCompactTreeHook(std::ostream& os, const char* indent="") ;
@@ -72,6 +77,8 @@ protected:
   virtual Double_t evaluate() const ;
 
   virtual Double_t evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t stepSize) const = 0 ;
+  virtual Bool_t gradientPartition(Int_t firstEvent, Int_t lastEvent, Int_t stepSize, const RooArgList& params, Double_t* grad) const ;
+  void partitionRange(Int_t& firstEvent, Int_t& lastEvent, Int_t& stepSize) const ;
   virtual Double_t getCarry() const;
 
   void setMPSet(Int_t setNum, Int_t numSets) ; 
@@ -96,9 +103,9 @@ protected:
   
   RooSetProxy _paramSet ;          // Parameters of the test statistic (=parameters of the input function)
 
-  enum GOFOpMode { SimMaster,MPMaster,Slave } ;
+  enum GOFOpMode { SimMaster,MPMaster,Slave,MTMaster } ;
   GOFOpMode operMode() const { 
-    // Return test statistic operation mode of this instance (SimMaster, MPMaster or Slave)
+    // Return test statistic operation mode of this instance (SimMaster, MPMaster, MTMaster or Slave)
     return _gofOpMode ; 
   }
 
@@ -122,6 +129,8 @@ protected:
   Bool_t initialize() ;
   void initSimMode(RooSimultaneous* pdf, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;    
   void initMPMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;
+  void initMTMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName) ;
+  void evaluateComponents() const ;
 
   mutable Bool_t _init ;          //! Is object initialized  
   GOFOpMode   _gofOpMode ;        // Operation mode of test statistic instance 
@@ -131,9 +140,10 @@ protected:
   Int_t       _numSets ;          // Total number of partitions in parallel calculation mode
   Int_t       _extSet ;           //! Number of designated set to calculated extended term
 
-  // Simultaneous mode data
+  // Simultaneous and multi-thread mode data
   Int_t          _nGof        ; // Number of sub-contexts 
   pRooAbsTestStatistic* _gofArray ; //! Array of sub-contexts representing part of the combined test statistic
+  mutable Bool_t _gofWarm ;   //! Components were evaluated once since their (re)configuration
   std::vector<RooFit::MPSplit> _gofSplitMode ; //! GOF MP Split mode specified by component (when Auto is active)
   
   // Parallel mode data
@@ -146,6 +156,8 @@ protected:
   mutable Double_t _offsetCarry; //! avoids loss of precision
   mutable Double_t _evalCarry; //! carry of Kahan sum in evaluatePartition
 
+  static Bool_t _threadedMode ; // Evaluate NumCPU partitions with threads (MTMaster) rather than processes
+
   ClassDef(RooAbsTestStatistic,2) // Abstract base class for real-valued test statistics
 
 };
@@ -25,10 +25,11 @@ class RooRealVar;
 class RooDataSet;
 class RooRealBinding;
 class RooNumGenFactory ;
+class RooVectorDataStore ;
 
 class RooAcceptReject : public RooAbsNumGenerator {
 public:
-  RooAcceptReject() : _nextCatVar(0), _nextRealVar(0) {
+  RooAcceptReject() : _nextCatVar(0), _nextRealVar(0), _trials(0), _batchEval(kFALSE) {
     // coverity[UNINIT_CTOR]
   } ; 
   RooAcceptReject(const RooAbsReal &func, const RooArgSet &genVars, const RooNumGenConfig& config, Bool_t verbose=kFALSE, const RooAbsReal* maxFuncVal=0);
@@ -53,6 +54,9 @@ protected:
   static void registerSampler(RooNumGenFactory& fact) ;	
 
   void addEventToCache();
+  void addEventsToCache(UInt_t nEvents);
+  void randomizeEvent();
+  void cacheEvent(Double_t val);
   const RooArgSet *nextAcceptedEvent();
 
   Double_t _maxFuncVal, _funcSum;      // Maximum function value found, and sum of all samples made
@@ -65,6 +69,11 @@ protected:
 
   UInt_t _minTrialsArray[4];           // Minimum number of trials samples for 1,2,3 dimensional problems
 
+  static const UInt_t kTrialBlockSize = 1024 ; // Number of trial events evaluated together
+  RooArgSet _trialVars ;               // Generated variables stored in the trial block
+  RooVectorDataStore* _trials ;        // Block of trial events for batch evaluation of the function
+  Bool_t _batchEval ;                  // Evaluate the function for blocks of trial events?
+
   ClassDef(RooAcceptReject,0) // Context for generating a dataset from a PDF
 };
 
@@ -36,6 +36,8 @@ public:
 
   virtual Double_t defaultErrorLevel() const ;
 
+  virtual Bool_t gradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset=0) const ;
+
   void printMetaArgs(std::ostream& os) const ;
 
   const RooArgList& list1() const { return _set ; }
@@ -71,6 +71,20 @@ public:
     return _size ; 
   }
 
+  ULong64_t hits() const {
+    // Return number of lookups that found the slot by the address of the sets
+    return _hits ;
+  }
+  ULong64_t contentHits() const {
+    // Return number of lookups that found the slot by the contents of the sets
+    return _contentHits ;
+  }
+  ULong64_t misses() const {
+    // Return number of lookups that did not find a slot
+    return _misses ;
+  }
+  void printStatistics(std::ostream& os) const ;
+
   virtual Bool_t redirectServersHook(const RooAbsCollection& /*newServerList*/, Bool_t /*mustReplaceAll*/, 
 				     Bool_t /*nameChange*/, Bool_t /*isRecursive*/) { 
     // Interface function to intercept server redirects
@@ -104,6 +118,8 @@ public:
  
 protected:
 
+  Int_t findSlot(const RooArgSet* nset, const RooArgSet* iset, const TNamed* isetRangeName, Bool_t countLookup=kTRUE) ;
+
   Int_t _maxSize ;    //! Maximum size
   Int_t _size ;       //! Actual use
   Int_t _lastIndex ;  //! Last slot accessed
@@ -112,6 +128,10 @@ protected:
   std::vector<T*> _object ;                 //! Payload
   Bool_t _wired ;               //! In wired mode, there is a single payload which is returned always
 
+  ULong64_t _hits ;             //! Number of lookups matched by set address
+  ULong64_t _contentHits ;      //! Number of lookups matched by set contents
+  ULong64_t _misses ;           //! Number of failed lookups
+
   ClassDef(RooCacheManager,2) // Cache Manager class generic objects
 } ;
 
@@ -128,6 +148,7 @@ RooCacheManager<T>::RooCacheManager(Int_t maxSize) : RooAbsCache(0)
   _nsetCache.resize(_maxSize) ; // = new RooNormSetCache[maxSize] ;
   _object.resize(_maxSize,0) ; // = new T*[maxSize] ;
   _wired = kFALSE ;
+  _hits = _contentHits = _misses = 0 ;
 }
 
 template<class T>
@@ -145,6 +166,7 @@ RooCacheManager<T>::RooCacheManager(RooAbsArg* owner, Int_t maxSize) : RooAbsCac
   _object.resize(_maxSize,0) ; // = new T*[maxSize] ;
   _wired = kFALSE ;
   _lastIndex = -1 ;
+  _hits = _contentHits = _misses = 0 ;
 
   Int_t i ;
   for (i=0 ; i<_maxSize ; i++) {
@@ -166,6 +188,7 @@ RooCacheManager<T>::RooCacheManager(const RooCacheManager& other, RooAbsArg* own
   _object.resize(_maxSize,0) ; // = new T*[_maxSize] ;
   _wired = kFALSE ;
   _lastIndex = -1 ;
+  _hits = _contentHits = _misses = 0 ;
 
   //std::cout << "RooCacheManager:cctor(" << this << ") other = " << &other << " _size=" << _size << " _maxSize = " << _maxSize << std::endl ;
 
@@ -234,9 +257,14 @@ Int_t RooCacheManager<T>::setObj(const RooArgSet* nset, const RooArgSet* iset, T
 
   // Check if object is already registered
   Int_t sterileIdx(-1) ;
-  if (getObj(nset,iset,&sterileIdx,isetRangeName)) {
-    return lastIndex() ;
-  } 
+  Int_t idx = _wired ? 0 : findSlot(nset,iset,isetRangeName,kFALSE) ;
+  if (idx>=0) {
+    _lastIndex = idx ;
+    if (_object[idx]) {
+      return lastIndex() ;
+    }
+    sterileIdx = idx ;
+  }
 
 
   if (sterileIdx>=0) {
@@ -298,24 +326,68 @@ T* RooCacheManager<T>::getObj(const RooArgSet* nset, const RooArgSet* iset, Int_
     return _object[0] ;
   }
   
+  Int_t i = findSlot(nset,iset,isetRangeName) ;
+  if (i<0) {
+    return 0 ;
+  }
+
+  _lastIndex = i ;
+  if(_object[i]==0 && sterileIdx) *sterileIdx=i ;
+  return _object[i] ;
+}
+
+
+
+template<class T>
+Int_t RooCacheManager<T>::findSlot(const RooArgSet* nset, const RooArgSet* iset, const TNamed* isetRangeName, Bool_t countLookup) 
+{
+  // Return the index of the slot for nset,iset and isetRangeName, or -1
+  // if there is none. The slots are first matched on the addresses of
+  // the sets. Sets that were not seen before are matched on their
+  // contents, the names of the observables of the owner in nset and iset,
+  // which are calculated once and compared with the reference of each
+  // slot. The sets are then registered with the matching slot so that the
+  // next lookup can use their address. If countLookup is true, the lookup
+  // is included in the statistics
+
   Int_t i ;
   for (i=0 ; i<_size ; i++) {
     if (_nsetCache[i].contains(nset,iset,isetRangeName)==kTRUE) {      
-      _lastIndex = i ;
-      if(_object[i]==0 && sterileIdx) *sterileIdx=i ;
-      return _object[i] ;
+      if (countLookup) _hits++ ;
+      return i ;
     }
   }
 
-  for (i=0 ; i<_size ; i++) {
-    if (_nsetCache[i].autoCache(_owner,nset,iset,isetRangeName,kFALSE)==kFALSE) {
-      _lastIndex = i ;
-      if(_object[i]==0 && sterileIdx) *sterileIdx=i ;
-      return _object[i] ;
+  if (_size>0) {
+    RooNameSet name1, name2 ;
+    RooNormSetCache::observableNames(_owner,nset,iset,name1,name2) ;
+    for (i=0 ; i<_size ; i++) {
+      if (_nsetCache[i].matches(name1,name2,isetRangeName)) {
+	_nsetCache[i].add(nset,iset) ;
+	if (countLookup) _contentHits++ ;
+	if (_owner && countLookup) {
+	  oocxcoutD(_owner,Caching) << "RooCacheManager::findSlot(" << _owner->GetName() << ") sets with equal contents found in slot " << i 
+				    << ", " << _contentHits << " of " << _hits+_contentHits+_misses << " lookups matched by contents" << std::endl ;
+	}
+	return i ;
+      }
     }
   }
 
-  return 0 ;
+  if (countLookup) _misses++ ;
+  return -1 ;
+}
+
+
+
+template<class T>
+void RooCacheManager<T>::printStatistics(std::ostream& os) const 
+{
+  // Print the number of slots and the numbers of lookups that were matched
+  // on the addresses of the sets, on their contents and that failed
+
+  os << _size << " slots, " << _hits << " hits by address, " << _contentHits << " hits by contents, " 
+     << _misses << " misses" ;
 }
 
 
@@ -36,6 +36,8 @@ public:
 
   const RooArgList& list() { return _set1 ; }
 
+  virtual Bool_t gradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset=0) const ;
+
 protected:
 
   RooListProxy _set1 ;    // Set of constraint terms
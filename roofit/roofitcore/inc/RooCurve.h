@@ -36,7 +36,7 @@ public:
   RooCurve(const RooAbsReal &func, RooAbsRealLValue &x, Double_t xlo, Double_t xhi, Int_t xbins,
 	   Double_t scaleFactor= 1, const RooArgSet *normVars= 0, Double_t prec= 1e-3, Double_t resolution= 1e-3,
 	   Bool_t shiftToZero=kFALSE, WingMode wmode=Extended, Int_t nEvalError=-1, Int_t doEEVal=kFALSE, Double_t eeVal=0,
-	   Bool_t showProgress=kFALSE);
+	   Bool_t showProgress=kFALSE, Int_t nThreads=1);
   RooCurve(const char *name, const char *title, const RooAbsFunc &func, Double_t xlo,
 	   Double_t xhi, UInt_t minPoints, Double_t prec= 1e-3, Double_t resolution= 1e-3,
 	   Bool_t shiftToZero=kFALSE, WingMode wmode=Extended, Int_t nEvalError=-1, Int_t doEEVal=kFALSE, Double_t eeVal=0);
@@ -84,6 +84,11 @@ protected:
   void addRange(const RooAbsFunc& func, Double_t x1, Double_t x2, Double_t y1,
 		Double_t y2, Double_t minDy, Double_t minDx,
 		Int_t numee=0, Bool_t doEEVal=kFALSE, Double_t eeVal=0.)  ;
+  void addPoints(const std::vector<const RooAbsFunc*>& funcs, Double_t xlo, Double_t xhi,
+		 Int_t minPoints, Double_t prec, Double_t resolution, WingMode wmode,
+		 Int_t numee=0, Bool_t doEEVal=kFALSE, Double_t eeVal=0.,std::list<Double_t>* samplingHint=0) ;
+  void evalPoints(const std::vector<const RooAbsFunc*>& funcs, const std::vector<Double_t>& xvals,
+		  std::vector<Double_t>& yvals, Int_t numee, Bool_t doEEVal, Double_t eeVal) ;
 
 
   void shiftCurveToZero(Double_t prevYMax) ;
@@ -128,6 +128,17 @@ public:
 
   Int_t getIndex(const RooArgSet& coord, Bool_t fast=kFALSE) ;
 
+  Bool_t binIndices(Int_t* output, Int_t n, const std::vector<const Double_t*>& coords) const ;
+  Bool_t weights(Double_t* output, Int_t n, const std::vector<const Double_t*>& coords, Bool_t correctForBinSize=kFALSE) const ;
+  const Double_t* weightArray() const { 
+    // Return array of bin weights, indexed by the master index of the bins
+    return _wgt ; 
+  }
+  const Double_t* binVolumeArray() const { 
+    // Return array of bin volumes, indexed by the master index of the bins
+    return _binv ; 
+  }
+
   void removeSelfFromDir() { removeFromDir(this) ; }
   
 protected:
@@ -138,6 +149,7 @@ protected:
   friend class RooAbsOptTestStatistic ;
 
   Int_t calcTreeIndex() const ;
+  void initFastIndex() ;
   void cacheValidEntries() ;
 
   void setAllWeights(Double_t value) ;
@@ -183,6 +195,10 @@ protected:
   mutable RooCacheManager<std::vector<Double_t> > _pbinvCacheMgr ; //! Cache manager for arrays of partial bin volumes
   std::vector<RooAbsLValue*> _lvvars ; //! List of observables casted as RooAbsLValue
   std::vector<const RooAbsBinning*> _lvbins ; //! List of used binnings associated with lvalues
+  std::vector<const RooAbsReal*> _idxReal ; //! Observables with uniform binning, for fast index calculation (null for others)
+  std::vector<Double_t> _idxLo ; //! Lower bound of uniform binnings
+  std::vector<Double_t> _idxBinW ; //! Bin width of uniform binnings
+  std::vector<Int_t> _idxNBins ; //! Number of bins of uniform binnings
   mutable std::vector<std::vector<Double_t> > _binbounds; //! list of bin bounds per dimension
 
   mutable Int_t _cache_sum_valid ; //! Is cache sum valid
@@ -23,6 +23,8 @@ class RooDataHist ;
 #include "RooAbsData.h"
 #include "RooDirItem.h"
 
+#include <vector>
+
 #define USEMEMPOOL
 
 
@@ -114,6 +116,7 @@ public:
 
   virtual RooAbsArg* addColumn(RooAbsArg& var, Bool_t adjustRange=kTRUE) ;
   virtual RooArgSet* addColumns(const RooArgList& varList) ;
+  RooArgSet* addRealColumns(const RooArgList& varList, std::vector<std::vector<Double_t> >& values) ;
 
   // Plot the distribution of a real valued arg
   using RooAbsData::createHistogram ;
@@ -21,6 +21,7 @@
 class RooRealVar ;
 
 #include <map>
+#include <vector>
  
 class RooFFTConvPdf : public RooAbsCachedPdf {
 public:
@@ -82,9 +83,22 @@ protected:
 
     virtual RooArgList containedArgs(Action) ;
 
-    TVirtualFFT* fftr2c1 ;
-    TVirtualFFT* fftr2c2 ;
-    TVirtualFFT* fftc2r ;
+    // Spectra of the samplings of both input p.d.f.s in each slice, and the
+    // parameter values for which they were calculated
+    std::vector<std::vector<Double_t> > spectrum1 ;
+    std::vector<std::vector<Double_t> > spectrum2 ;
+    std::vector<Double_t> params1Vals ;
+    std::vector<Double_t> params2Vals ;
+    Bool_t reuse1 ;
+    Bool_t reuse2 ;
+
+    // Samplings and convolution output of each slice during a fill
+    std::vector<std::vector<Double_t> > input1 ;
+    std::vector<std::vector<Double_t> > input2 ;
+    std::vector<std::vector<Double_t> > output ;
+    Int_t nBins ;
+    Int_t nBins2 ;
+    Int_t binShift1 ;
 
     RooAbsPdf* pdf1Clone ;
     RooAbsPdf* pdf2Clone ;
@@ -102,7 +116,9 @@ protected:
   virtual RooArgSet* actualParameters(const RooArgSet& nset) const ;
   virtual RooAbsArg& pdfObservable(RooAbsArg& histObservable) const ;
   virtual void fillCacheObject(PdfCacheElem& cache) const ;
-  void fillCacheSlice(FFTCacheElem& cache, const RooArgSet& slicePosition) const ;
+  void scanCacheSlice(FFTCacheElem& cache, const RooArgSet& slicePosition, Int_t slice) const ;
+  void transformCacheSlices(FFTCacheElem& cache) const ;
+  void storeCacheSlice(FFTCacheElem& cache, const RooArgSet& slicePosition, Int_t slice) const ;
 
   virtual PdfCacheElem* createCache(const RooArgSet* nset) const ;
   virtual TString histNameSuffix() const ;
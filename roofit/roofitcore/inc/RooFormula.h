@@ -23,6 +23,9 @@
 #include "RooPrintable.h"
 #include "RooLinkedList.h"
 #include <vector>
+#include <string>
+
+class RooVectorDataStore ;
 
 class RooFormula : public ROOT::v5::TFormula, public RooPrintable {
 public:
@@ -49,6 +52,27 @@ public:
   // Function value accessor
   inline Bool_t ok() { return _isOK ; }
   Double_t eval(const RooArgSet* nset=0) ;
+  void evalBatch(Int_t n, const Double_t* const* slotValues, Double_t* result) ;
+  Bool_t evalBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data, const RooArgSet* nset=0) ;
+
+  // Slots of the formula, i.e. the values it is evaluated on
+  inline Int_t numSlots() const { 
+    // Return number of distinct variable references in the formula expression
+    return _useList.GetSize() ; 
+  }
+  inline RooAbsArg* getSlotArg(Int_t slot) const { 
+    // Return pointer to object whose value fills given slot
+    return (RooAbsArg*) _useList.At(slot) ; 
+  }
+  const char* getSlotLabel(Int_t slot) const ;
+
+  // Compilation of the formula expression with the interpreter
+  static void setJITEnabled(Bool_t flag) ;
+  static Bool_t isJITEnabled() ;
+  inline Bool_t isJITCompiled() const { 
+    // Return true if formula is evaluated by function compiled with the interpreter
+    return _jitFunc!=0 ; 
+  }
 
   // Debugging
   void dump() ;
@@ -77,6 +101,11 @@ protected:
   Int_t DefinedVariable(TString &name) ; // ROOT 3
   Double_t DefinedValue(Int_t code) ;
 
+  // Translation of the formula program to C++ compiled by the interpreter
+  Bool_t jitCode(std::string& body, Int_t& depth) const ;
+  void jitCompile() ;
+  void jitReset() ;
+
   RooArgSet* _nset ;
   mutable Bool_t    _isOK ;     // Is internal state OK?
   RooLinkedList     _origList ; //! Original list of dependents
@@ -86,6 +115,14 @@ protected:
   RooLinkedList _labelList ;    //  List of label names for category objects  
   mutable Bool_t    _compiled ; //  Flag set if formula is compiled
 
+  Bool_t _jitTried ;            //! Flag set if compilation with interpreter was attempted
+  void* _jitFunc ;              //! Interpreter wrapper of compiled evaluation function, 0 if not available
+  void* _jitBatchFunc ;         //! Interpreter wrapper of compiled batch evaluation function
+  std::vector<Double_t> _slotValues ; //! Values of the slots for one evaluation
+  const Double_t* _slotOverride ; //! Slot values used by DefinedValue() instead of those of the slot objects
+
+  static Bool_t _jitEnabled ;   // Global activation switch for compilation with interpreter
+
   ClassDef(RooFormula,1)     // ROOT::v5::TFormula derived class interfacing with RooAbsArg objects
 };
 
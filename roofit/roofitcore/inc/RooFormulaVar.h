@@ -65,6 +65,7 @@ protected:
 
   // Function evaluation
   virtual Double_t evaluate() const ;
+  virtual Bool_t evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const ;
   RooFormula& formula() const ;
 
   // Post-processing of server redirection
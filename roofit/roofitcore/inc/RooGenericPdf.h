@@ -50,6 +50,7 @@ protected:
   // Function evaluation
   RooListProxy _actualVars ; 
   virtual Double_t evaluate() const ;
+  virtual Bool_t evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const ;
 
   Bool_t setFormula(const char* formula) ;
 
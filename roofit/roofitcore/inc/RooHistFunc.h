@@ -80,6 +80,7 @@ protected:
   Bool_t areIdentical(const RooDataHist& dh1, const RooDataHist& dh2) ;
 
   Double_t evaluate() const;
+  Bool_t evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const ;
   Double_t totalVolume() const ;
   friend class RooAbsCachedReal ;
   Double_t totVolume() const ;
@@ -90,6 +90,7 @@ protected:
   Bool_t importWorkspaceHook(RooWorkspace& ws) ;
   
   Double_t evaluate() const;
+  Bool_t evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const ;
   Double_t totalVolume() const ;
   friend class RooAbsCachedPdf ;
   Double_t totVolume() const ;
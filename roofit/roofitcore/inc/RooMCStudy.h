@@ -54,6 +54,16 @@ public:
   Bool_t fit(Int_t nSamples, TList& dataSetList) ;
   Bool_t addFitResult(const RooFitResult& fr) ;
 
+  void setNWorkers(Int_t nWorkers) {
+    // Process the samples of the run methods in 'nWorkers' forked processes.
+    // With zero or one worker the samples are processed in this process
+    _nWorkers = nWorkers ;
+  }
+  Int_t nWorkers() const {
+    // Return the number of worker processes used by the run methods
+    return _nWorkers ;
+  }
+
   // Result accessors
   const RooArgSet* fitParams(Int_t sampleNum) const ;
   const RooFitResult* fitResult(Int_t sampleNum) const ;
@@ -102,7 +112,9 @@ protected:
 
   RooPlot* makeFrameAndPlotCmd(const RooRealVar& param, RooLinkedList& cmdList, Bool_t symRange=kFALSE) const ;
 
-  Bool_t run(Bool_t generate, Bool_t fit, Int_t nSamples, Int_t nEvtPerSample, Bool_t keepGenData, const char* asciiFilePat) ;
+  Bool_t run(Bool_t generate, Bool_t fit, Int_t nSamples, Int_t nEvtPerSample, Bool_t keepGenData, const char* asciiFilePat,
+	     Int_t firstSample=0, Int_t lastSample=-1) ;
+  Bool_t runParallel(Bool_t generate, Bool_t fit, Int_t nSamples, Int_t nEvtPerSample, Bool_t keepGenData, const char* asciiFilePat) ;
   Bool_t fitSample(RooAbsData* genSample) ;
   RooFitResult* doFit(RooAbsData* genSample) ;	
 
@@ -142,6 +154,7 @@ protected:
   Bool_t      _verboseGen       ; // Verbose generation?
   Bool_t      _perExptGenParams ; // Do generation parameter change per event?
   Bool_t      _silence          ; // Silent running mode?
+  Int_t       _nWorkers         ; // Number of worker processes for the run methods
 
   std::list<RooAbsMCStudyModule*> _modList ; // List of additional study modules ;
 
@@ -51,6 +51,7 @@ public:
   void setOffsetting(Bool_t flag) ;
   void setMaxIterations(Int_t n) ;
   void setMaxFunctionCalls(Int_t n) ; 
+  void setUseGradient(Bool_t flag=kTRUE) { _useGradient = flag ; }
 
   RooFitResult* fit(const char* options) ;
 
@@ -100,8 +101,10 @@ protected:
   inline std::ofstream* logfile() { return fitterFcn()->GetLogFile(); }
   inline Double_t& maxFCN() { return fitterFcn()->GetMaxFCN() ; }
   
-  const RooMinimizerFcn* fitterFcn() const {  return ( fitter()->GetFCN() ? ((RooMinimizerFcn*) fitter()->GetFCN()) : _fcn ) ; }
-  RooMinimizerFcn* fitterFcn() { return ( fitter()->GetFCN() ? ((RooMinimizerFcn*) fitter()->GetFCN()) : _fcn ) ; }
+  const RooMinimizerFcn* fitterFcn() const {  return ( fitter()->GetFCN() ? dynamic_cast<RooMinimizerFcn*>(fitter()->GetFCN()) : _fcn ) ; }
+  RooMinimizerFcn* fitterFcn() { return ( fitter()->GetFCN() ? dynamic_cast<RooMinimizerFcn*>(fitter()->GetFCN()) : _fcn ) ; }
+
+  bool fitFCN() ;
 
 private:
 
@@ -112,6 +115,7 @@ private:
   RooAbsReal* _func ;
 
   Bool_t      _verbose ;
+  Bool_t      _useGradient ;
   TStopwatch  _timer ;
   TStopwatch  _cumulTimer ;
   Bool_t      _profileStart ;
@@ -30,7 +30,7 @@
 
 class RooMinimizer;
 
-class RooMinimizerFcn : public ROOT::Math::IBaseFunctionMultiDim {
+class RooMinimizerFcn : public ROOT::Math::IMultiGradFunction {
 
  public:
 
@@ -64,6 +64,10 @@ class RooMinimizerFcn : public ROOT::Math::IBaseFunctionMultiDim {
   Int_t evalCounter() const { return _evalCounter ; }
   void zeroEvalCount() { _evalCounter = 0 ; }
 
+  Bool_t HasGradient() const ;
+  virtual void Gradient(const double *x, double *grad) const ;
+  virtual void FdF(const double *x, double &f, double *df) const ;
+
 
  private:
   
@@ -77,6 +81,7 @@ class RooMinimizerFcn : public ROOT::Math::IBaseFunctionMultiDim {
 
 
   virtual double DoEval(const double * x) const;  
+  virtual double DoDerivative(const double * x, unsigned int icoord) const;
   void updateFloatVec() ;
 
 private:
@@ -94,6 +99,7 @@ private:
   int _nDim;
   std::ofstream *_logfile;
   bool _verbose;
+  mutable bool _numGradWarned;
 
   RooArgList* _floatParamList;
   std::vector<RooAbsArg*> _floatParamVec ;
@@ -66,6 +66,7 @@ protected:
 
   Bool_t _extended ;
   virtual Double_t evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t stepSize) const ;
+  virtual Bool_t gradientPartition(Int_t firstEvent, Int_t lastEvent, Int_t stepSize, const RooArgList& params, Double_t* grad) const ;
   Bool_t _weightSq ; // Apply weights squared?
   mutable Bool_t _first ; //!
   Double_t _offsetSaveW2; //!
@@ -83,6 +83,17 @@ public:
   Bool_t autoCache(const RooAbsArg* self, const RooArgSet* set1,
       const RooArgSet* set2 = 0, const TNamed* set2RangeName = 0,
       Bool_t autoRefill = kTRUE);
+
+  static void observableNames(const RooAbsArg* self, const RooArgSet* set1,
+      const RooArgSet* set2, RooNameSet& name1, RooNameSet& name2);
+
+  inline Bool_t matches(const RooNameSet& name1, const RooNameSet& name2,
+      const TNamed* set2RangeName = 0) const
+  {
+    // Check if the observable names of set1/set2 as returned by
+    // observableNames() and the range name match the current reference
+    return set2RangeName == _set2RangeName && name1 == _name1 && name2 == _name2;
+  }
     
   void clear();
   Int_t entries() const { return _pairs.size(); }
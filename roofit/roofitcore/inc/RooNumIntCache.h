@@ -0,0 +1,99 @@
+/*****************************************************************************
+ * Project: RooFit                                                           *
+ * Package: RooFitCore                                                       *
+ *    File: $Id$
+ * Authors:                                                                  *
+ *   WV, Wouter Verkerke, UC Santa Barbara, verkerke@slac.stanford.edu       *
+ *   DK, David Kirkby,    UC Irvine,         dkirkby@uci.edu                 *
+ *                                                                           *
+ * Copyright (c) 2000-2005, Regents of the University of California          *
+ *                          and Stanford University. All rights reserved.    *
+ *                                                                           *
+ * Redistribution and use in source and binary forms,                        *
+ * with or without modification, are permitted according to the terms        *
+ * listed in LICENSE (http://roofit.sourceforge.net/license.txt)             *
+ *****************************************************************************/
+#ifndef ROO_NUM_INT_CACHE
+#define ROO_NUM_INT_CACHE
+
+#include "Rtypes.h"
+#include "Riosfwd.h"
+#include "RooAbsCache.h"
+#include <list>
+#include <map>
+#include <vector>
+
+class RooAbsArg ;
+class RooArgSet ;
+
+class RooNumIntCache : public RooAbsCache {
+
+public:
+
+  RooNumIntCache(RooAbsArg* owner=0, Double_t precision=0, Int_t maxKBytes=1024, Bool_t interpolate=kFALSE) ;
+  RooNumIntCache(const RooNumIntCache& other, RooAbsArg* owner=0) ;
+  virtual ~RooNumIntCache() ;
+
+  void makeKey(const RooArgSet& params, std::vector<Double_t>& key) const ;
+  Bool_t makeCell(const RooArgSet& params, std::vector<Double_t>& key, std::vector<Double_t>& frac) const ;
+  Double_t gridValue(const RooAbsArg& param, Double_t index) const ;
+
+  Bool_t lookup(const std::vector<Double_t>& key, Double_t& value) ;
+  void insert(const std::vector<Double_t>& key, Double_t value) ;
+  void reset() ;
+
+  Double_t precision() const {
+    // Grid spacing of the parameter values, relative to the parameter ranges
+    return _precision ;
+  }
+  Bool_t interpolate() const {
+    // If true, values are interpolated between the cached grid points
+    return _interpolate ;
+  }
+  Int_t maxKBytes() const {
+    // Memory bound of the cache in kilobytes
+    return _maxKBytes ;
+  }
+  Int_t size() const {
+    // Number of cached values
+    return _index.size() ;
+  }
+  ULong64_t hits() const {
+    // Number of lookups that found a cached value
+    return _hits ;
+  }
+  ULong64_t misses() const {
+    // Number of lookups that did not find a cached value
+    return _misses ;
+  }
+  Double_t memoryUsage() const ;
+
+  void printStatistics(std::ostream& os) const ;
+
+  virtual Bool_t redirectServersHook(const RooAbsCollection& /*newServerList*/, Bool_t /*mustReplaceAll*/,
+				     Bool_t /*nameChange*/, Bool_t /*isRecursive*/) ;
+  virtual void printCompactTreeHook(std::ostream&, const char *) ;
+
+  static const Int_t kMaxInterpolationDim = 4 ; // Maximal number of interpolated parameters
+
+protected:
+
+  Double_t quantum(const RooAbsArg& param, Double_t& origin) const ;
+  Double_t entryBytes(Int_t nParams) const ;
+
+  typedef std::list<std::pair<std::vector<Double_t>,Double_t> > LRUList ;
+  typedef std::map<std::vector<Double_t>,LRUList::iterator> EntryMap ;
+
+  Double_t _precision ;   //! Grid spacing relative to the parameter ranges, exact keys if zero
+  Int_t _maxKBytes ;      //! Memory bound in kilobytes
+  Bool_t _interpolate ;   //! Interpolate between grid points
+  LRUList _lru ;          //! Keys and values, most recently used first
+  EntryMap _index ;       //! Entries by key
+  ULong64_t _hits ;       //! Number of successful lookups
+  ULong64_t _misses ;     //! Number of failed lookups
+
+  ClassDef(RooNumIntCache,1) // LRU cache of integral values keyed on quantized parameter values
+} ;
+
+
+#endif
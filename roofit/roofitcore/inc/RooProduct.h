@@ -43,6 +43,9 @@ public:
                                                    const char* rangeName=0) const ;
   virtual Double_t analyticalIntegral(Int_t code, const char* rangeName=0) const;
 
+  virtual Bool_t gradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset=0) const ;
+  virtual Bool_t analyticalIntegralGradient(Int_t code, const RooArgList& params, Double_t* grad,
+                                            const RooArgSet* normSet, const char* rangeName=0) const ;
 
   RooArgList components() { RooArgList tmp(_compRSet) ; tmp.add(_compCSet) ; return tmp ; }
 
@@ -76,7 +79,9 @@ protected:
                                                                                                                                                              
 
   Double_t calculate(const RooArgList& partIntList) const;
+  Bool_t calculateGradient(const RooArgList& terms, const RooArgSet* nset, const RooArgList& params, Double_t* grad) const;
   Double_t evaluate() const;
+  Bool_t evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const ;
   const char* makeFPName(const char *pfx,const RooArgSet& terms) const ;
   ProdMap* groupProductTerms(const RooArgSet&) const;
   Int_t getPartIntList(const RooArgSet* iset, const char *rangeName=0) const;
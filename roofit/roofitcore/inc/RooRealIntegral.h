@@ -29,6 +29,7 @@ class RooAbsCategory ;
 class RooRealVar ;
 class RooAbsIntegrator ;
 class RooNumIntConfig ;
+class RooNumIntCache ;
 
 class RooRealIntegral : public RooAbsReal {
 public:
@@ -70,6 +71,14 @@ public:
 
   static Int_t getCacheAllNumeric() ;
 
+  void setParamCache(Bool_t flag, Double_t precision=0, Int_t maxKBytes=1024, Bool_t interpolate=kFALSE) ;
+  const RooNumIntCache* paramCache() const { 
+    // Cache of numeric integral values by parameter point, if enabled
+    return _paramCache ; 
+  }
+
+  virtual Bool_t gradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset=0) const ;
+
   virtual std::list<Double_t>* plotSamplingHint(RooAbsRealLValue& obs, Double_t xlo, Double_t xhi) const {
     // Forward plot sampling hint of integrand
     return _function.arg().plotSamplingHint(obs,xlo,xhi) ;
@@ -92,6 +101,9 @@ protected:
   virtual Double_t sum() const ;
   virtual Double_t integrate() const ;
   virtual Double_t jacobianProduct() const ;
+  Double_t factorizedRange() const ;
+  Double_t evaluateNumeric() const ;
+  Double_t evaluateCached() const ;
 
   // Evaluation and validation implementation
   Double_t evaluate() const ;
@@ -136,6 +148,7 @@ protected:
 
   Bool_t _cacheNum ;           // Cache integral if numeric
   static Int_t _cacheAllNDim ; //! Cache all integrals with given numeric dimension
+  RooNumIntCache* _paramCache ; //! Optional cache of numeric integral values by parameter point
 
 
   virtual void operModeHook() ; // cache operation mode
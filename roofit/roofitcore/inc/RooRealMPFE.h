@@ -59,10 +59,12 @@ public:
   State _state ;
 
   enum Message { SendReal=0, SendCat, Calculate, Retrieve, ReturnValue, Terminate, 
-		 ConstOpt, Verbose, LogEvalError, ApplyNLLW2, EnableOffset, CalculateNoOffset } ;
+		 ConstOpt, Verbose, LogEvalError, ApplyNLLW2, EnableOffset, CalculateNoOffset,
+		 UpdateShared } ;
   
   void initialize() ; 
   void initVars() ;
+  void freeShared() ;
   void serverLoop() ;
 
   void doApplyNLLW2(Bool_t flag) ;
@@ -78,6 +80,8 @@ public:
   mutable RooAbsReal::ErrorLoggingMode _remoteEvalErrorLoggingState ;
 
   RooFit::BidirMMapPipe *_pipe; //! connection to child
+  void* _shm ; //! block of memory shared with child for variable values and result
+  size_t _shmSize ; //! size of shared block
 
   mutable std::vector<Bool_t> _valueChanged ; //! Flags if variable needs update on server-side
   mutable std::vector<Bool_t> _constChanged ; //! Flags if variable needs update on server-side
@@ -34,11 +34,14 @@ public:
   virtual ~RooRealSumPdf() ;
 
   Double_t evaluate() const ;
+  Bool_t evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const ;
   virtual Bool_t checkObservables(const RooArgSet* nset) const ;	
 
   virtual Bool_t forceAnalyticalInt(const RooAbsArg& arg) const { return arg.isFundamental() ; }
   Int_t getAnalyticalIntegralWN(RooArgSet& allVars, RooArgSet& numVars, const RooArgSet* normSet, const char* rangeName=0) const ;
   Double_t analyticalIntegralWN(Int_t code, const RooArgSet* normSet, const char* rangeName=0) const ;
+  virtual Bool_t analyticalIntegralGradient(Int_t code, const RooArgList& params, Double_t* grad,
+                                            const RooArgSet* normSet, const char* rangeName=0) const ;
 
   const RooArgList& funcList() const { return _funcList ; }
   const RooArgList& coefList() const { return _coefList ; }
@@ -51,6 +54,7 @@ public:
     // which is the sum of all coefficients
     return expectedEvents(&nset) ; 
   }
+  virtual Bool_t expectedEventsGradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset) const ;
 
   virtual Bool_t selfNormalized() const { return getAttribute("BinnedLikelihoodActive") ; }
 
@@ -70,6 +74,10 @@ public:
   virtual void setCacheAndTrackHints(RooArgSet&) ;
 
 protected:
+
+  virtual Bool_t evaluateGradient(const RooArgList& params, Double_t* grad) const ;
+  Bool_t sumGradient(const RooArgList& terms, const RooArgSet* coefNSet, Bool_t selectedOnly,
+                     const RooArgList& params, Double_t* grad, Double_t& value) const ;
   
   class CacheElem : public RooAbsCacheElement {
   public:
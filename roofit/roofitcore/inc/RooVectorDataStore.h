@@ -81,6 +81,7 @@ public:
   // Add one or more columns
   virtual RooAbsArg* addColumn(RooAbsArg& var, Bool_t adjustRange=kTRUE) ;
   virtual RooArgSet* addColumns(const RooArgList& varList) ;
+  RooArgSet* addRealColumns(const RooArgList& varList, std::vector<std::vector<Double_t> >& values) ;
 
   // Merge column-wise
   RooAbsDataStore* merge(const RooArgSet& allvars, std::list<RooAbsDataStore*> dstoreList) ;
@@ -110,7 +111,12 @@ public:
 
   const RooVectorDataStore* cache() const { return _cache ; }
 
+  // Direct access to the stored values, used by RooAbsReal::getValBatch()
+  const Double_t* realColumn(const RooAbsReal& real) const ;
+  Bool_t weightBatch(Double_t* output, Int_t begin, Int_t end) const ;
+
   void loadValues(const RooAbsDataStore *tds, const RooFormulaVar* select=0, const char* rangeName=0, Int_t nStart=0, Int_t nStop=2000000000) ;
+  Bool_t loadValues(const TTree *t, const RooFormulaVar* select=0, const char* rangeName=0, Int_t nStart=0, Int_t nStop=2000000000) ;
   
   void dump() ;
 
@@ -238,6 +244,8 @@ public:
 
     Int_t size() const { return _vec.size() ; }
 
+    const Double_t* data() const { return _vec0 ; }
+
     void resize(Int_t siz) {
       if (siz < Int_t(_vec.capacity()) / 2 && _vec.capacity() > (VECTOR_BUFFER_SIZE / sizeof(Double_t))) {
 	// do an expensive copy, if we save at least a factor 2 in size
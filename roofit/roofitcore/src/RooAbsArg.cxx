@@ -69,6 +69,7 @@ setting/clearing/testing named attributes.
 #include <fstream>
 #include <algorithm>
 #include <sstream>
+#include <atomic>
 
 using namespace std ;
 
@@ -83,6 +84,12 @@ Bool_t RooAbsArg::_verboseDirty(kFALSE) ;
 Bool_t RooAbsArg::_inhibitDirty(kFALSE) ;
 Bool_t RooAbsArg::inhibitDirty() const { return _inhibitDirty && !_localNoInhibitDirty; }
 
+namespace {
+  // Counter of the changes of the value client links and of the operation
+  // modes of all objects, which invalidate the flattened value dirty lists
+  std::atomic<UInt_t> gGraphEpoch(1) ;
+}
+
 std::map<RooAbsArg*,TRefArray*> RooAbsArg::_ioEvoList ;
 std::stack<RooAbsArg*> RooAbsArg::_ioReadStack ;
 
@@ -93,6 +100,7 @@ std::stack<RooAbsArg*> RooAbsArg::_ioReadStack ;
 RooAbsArg::RooAbsArg() :
   TNamed(),
   _deleteWatch(kFALSE),
+  _valueDirtyListEpoch(0),
   _operMode(Auto),
   _fast(kFALSE),
   _ownedComponents(0),
@@ -119,6 +127,7 @@ RooAbsArg::RooAbsArg(const char *name, const char *title) :
   _deleteWatch(kFALSE),
   _valueDirty(kTRUE),
   _shapeDirty(kTRUE),
+  _valueDirtyListEpoch(0),
   _operMode(Auto),
   _fast(kFALSE),
   _ownedComponents(0),
@@ -145,6 +154,7 @@ RooAbsArg::RooAbsArg(const RooAbsArg& other, const char* name)
     _boolAttrib(other._boolAttrib),
     _stringAttrib(other._stringAttrib),
     _deleteWatch(other._deleteWatch),
+    _valueDirtyListEpoch(0),
     _operMode(Auto),
     _fast(kFALSE),
     _ownedComponents(0),
@@ -387,6 +397,8 @@ void RooAbsArg::addServer(RooAbsArg& server, Bool_t valueProp, Bool_t shapeProp)
   server._clientList.Add(this) ;
   if (valueProp) server._clientListValue.Add(this) ;
   if (shapeProp) server._clientListShape.Add(this) ;
+
+  graphChanged() ;
 }
 
 
@@ -437,6 +449,8 @@ void RooAbsArg::removeServer(RooAbsArg& server, Bool_t force)
     server._clientListValue.RemoveAll(this) ;
     server._clientListShape.RemoveAll(this) ;
   }
+
+  graphChanged() ;
 }
 
 
@@ -482,6 +496,8 @@ void RooAbsArg::changeServer(RooAbsArg& server, Bool_t valueProp, Bool_t shapePr
   if (shapeProp) {
     server._clientListShape.Add(this, scount) ;
   }
+
+  graphChanged() ;
 }
 
 
@@ -849,6 +865,21 @@ void RooAbsArg::setValueDirty(const RooAbsArg* source) const
     return ;
   }
 
+  // For fundamental objects (the parameters and observables), raise the flags
+  // of the precomputed list of all value clients reached through objects in
+  // Auto mode, rather than recursing through the clients. The list is rebuilt
+  // after changes of the graph or of the operation modes.
+  if (source==0 && !_verboseDirty && isFundamental()) {
+    if (_valueDirtyListEpoch!=gGraphEpoch) {
+      buildValueDirtyList() ;
+    }
+    _valueDirty = kTRUE ;
+    for (std::vector<const RooAbsArg*>::const_iterator iter = _valueDirtyList.begin() ; iter!=_valueDirtyList.end() ; ++iter) {
+      (*iter)->_valueDirty = kTRUE ;
+    }
+    return ;
+  }
+
   // Cyclical dependency interception
   if (source==0) {
     source=this ;
@@ -879,6 +910,52 @@ void RooAbsArg::setValueDirty(const RooAbsArg* source) const
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Collect in _valueDirtyList all objects whose value dirty flag is raised
+/// by setValueDirty(): the value clients of this object in Auto mode, their
+/// value clients in Auto mode, and so on. Each object appears once.
+
+void RooAbsArg::buildValueDirtyList() const
+{
+  _valueDirtyListEpoch = gGraphEpoch ;
+  _valueDirtyList.clear() ;
+
+  std::set<const RooAbsArg*> visited ;
+  std::vector<const RooAbsArg*> todo ;
+  todo.push_back(this) ;
+  while (!todo.empty()) {
+    const RooAbsArg* arg = todo.back() ;
+    todo.pop_back() ;
+
+    RooFIter clientValueIter = arg->_clientListValue.fwdIterator() ;
+    const RooAbsArg* client ;
+    while ((client=clientValueIter.next())) {
+      if (client==this) {
+	// Cyclical dependency, do not follow
+	coutE(LinkStateMgmt) << "RooAbsArg::setValueDirty(" << GetName()
+			     << "): cyclical dependency detected, source = " << GetName() << endl ;
+	continue ;
+      }
+      if (client->_operMode!=Auto || !visited.insert(client).second) continue ;
+      _valueDirtyList.push_back(client) ;
+      todo.push_back(client) ;
+    }
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Invalidate the flattened value dirty lists of all objects after a change
+/// of the client-server links or of the operation mode of an object
+
+void RooAbsArg::graphChanged()
+{
+  ++gGraphEpoch ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Mark this object as having changed its shape, and propagate this status
 /// change to all of our clients.
@@ -1756,6 +1833,11 @@ void RooAbsArg::setOperMode(OperMode mode, Bool_t recurseADirty)
   // Prevent recursion loops
   if (mode==_operMode) return ;
 
+  // Dirty flags propagate only through objects in Auto mode
+  if (mode==Auto || _operMode==Auto) {
+    graphChanged() ;
+  }
+
   _operMode = mode ;
   _fast = ((mode==AClean) || dynamic_cast<RooRealVar*>(this)!=0 || dynamic_cast<RooConstVar*>(this)!=0 ) ;
   for (Int_t i=0 ;i<numCaches() ; i++) {
@@ -2426,6 +2508,11 @@ void RooAbsArg::Streamer(TBuffer &R__b)
      _ioReadStack.pop() ;
      _namePtr = (TNamed*) RooNameReg::instance().constPtr(GetName()) ;  
      _isConstant = getAttribute("Constant") ;
+
+     // Use hash tables for larger lists, as in addServer()
+     if (_serverList.GetSize() > 999 && _serverList.getHashTableSize() == 0) _serverList.setHashTableSize(1000);
+     if (_clientList.GetSize() > 999 && _clientList.getHashTableSize() == 0) _clientList.setHashTableSize(1000);
+     if (_clientListValue.GetSize() > 999 && _clientListValue.getHashTableSize() == 0) _clientListValue.setHashTableSize(1000);
    } else {
      R__b.WriteClassBuffer(RooAbsArg::Class(),this);
    }
@@ -158,6 +158,7 @@ the proxy holds a function, and will trigger an assert
 #include "RooRealIntegral.h"
 #include "Math/CholeskyDecomp.h"
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -311,6 +312,152 @@ Double_t RooAbsPdf::getValV(const RooArgSet* nset) const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of getVal(nset) with respect to 'params', see
+/// RooAbsReal::gradient(). The derivatives of the unnormalized value are
+/// calculated by evaluateGradient(), those of the normalization integral
+/// by its own gradient(), and are combined with the quotient rule.
+
+Bool_t RooAbsPdf::gradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset) const
+{
+  // Special handling of case without normalization set, as in getValV()
+  if (!nset) {
+    RooArgSet* tmp = _normSet ;
+    _normSet = 0 ;
+    Bool_t ret = evaluateGradient(params,grad) ;
+    _normSet = tmp ;
+    return ret ;
+  }
+
+  if (nset!=_normSet || _norm==0) {
+    syncNormalization(nset) ;
+  }
+
+  Double_t value = getVal(nset) ;
+  Double_t normVal = _norm->getVal() ;
+  if (normVal<=0.) {
+    return kFALSE ;
+  }
+
+  std::vector<Double_t> normGrad(params.getSize()) ;
+  if (!evaluateGradient(params,grad) || !_norm->gradient(params,normGrad.data())) {
+    return kFALSE ;
+  }
+
+  for (Int_t i=0 ; i<params.getSize() ; i++) {
+    grad[i] = (grad[i] - value*normGrad[i]) / normVal ;
+  }
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivatives of the unnormalized value of the p.d.f, as
+/// returned by evaluate(), with respect to 'params'. P.d.f.s that support
+/// analytic derivatives override this method. The default implementation
+/// only handles p.d.f.s that do not depend on the parameters.
+
+Bool_t RooAbsPdf::evaluateGradient(const RooArgList& params, Double_t* grad) const
+{
+  return RooAbsReal::gradient(params,grad,0) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of analyticalIntegralWN() with respect to
+/// 'params'. The derivatives of the unnormalized integral are calculated
+/// by analyticalIntegralRawGradient() and are divided by the normalization
+/// integral as in analyticalIntegralWN().
+
+Bool_t RooAbsPdf::analyticalIntegralGradient(Int_t code, const RooArgList& params, Double_t* grad,
+					     const RooArgSet* normSet, const char* rangeName) const
+{
+  if (code==0) return gradient(params,grad,normSet) ;
+  if (!analyticalIntegralRawGradient(code,params,grad,rangeName)) return kFALSE ;
+  if (!normSet) return kTRUE ;
+
+  Double_t normVal = getNorm(normSet) ;
+  std::vector<Double_t> normGrad(params.getSize()) ;
+  if (normVal<=0. || !_norm->gradient(params,normGrad.data())) {
+    return kFALSE ;
+  }
+
+  Double_t value = analyticalIntegral(code,rangeName) / normVal ;
+  for (Int_t i=0 ; i<params.getSize() ; i++) {
+    grad[i] = (grad[i] - value*normGrad[i]) / normVal ;
+  }
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivatives of the analytical integral with code 'code'
+/// as returned by analyticalIntegral() with respect to 'params'. The
+/// default implementation returns kFALSE to signal that they are not
+/// available.
+
+Bool_t RooAbsPdf::analyticalIntegralRawGradient(Int_t /*code*/, const RooArgList& /*params*/, Double_t* /*grad*/,
+						const char* /*rangeName*/) const
+{
+  return kFALSE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of getValV(): fill output[0..end-begin) with the values of
+/// the p.d.f. normalized over 'nset' for the events [begin,end) of 'data'.
+/// The unnormalized values are calculated by evaluateBatch() and are checked
+/// and divided by the normalization integral as in getValV(). Returns kFALSE
+/// if batch evaluation is not supported by the p.d.f or one of its servers.
+
+Bool_t RooAbsPdf::getValBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data, const RooArgSet* nset) const
+{
+  if (getBatchFromData(output,begin,end,data,nset)) return kTRUE ;
+
+  const Int_t n = end-begin ;
+
+  // Special handling of case without normalization set
+  if (!nset) {
+    RooArgSet* tmp = _normSet ;
+    _normSet = 0 ;
+    Bool_t ok = evaluateBatch(output,begin,end,data) ;
+    _normSet = tmp ;
+    if (!ok) return kFALSE ;
+
+    for (Int_t i=0 ; i<n ; i++) {
+      if (traceEvalPdf(output[i])) output[i] = 0 ;
+    }
+    return kTRUE ;
+  }
+
+  if (nset!=_normSet || _norm==0) {
+    syncNormalization(nset) ;
+  }
+
+  // Evaluate numerators
+  if (!evaluateBatch(output,begin,end,data)) return kFALSE ;
+
+  // Evaluate denominator
+  Double_t normVal(_norm->getVal()) ;
+
+  for (Int_t i=0 ; i<n ; i++) {
+    Bool_t error = traceEvalPdf(output[i]) ;
+    if (normVal<=0.) {
+      error=kTRUE ;
+      logEvalError("p.d.f normalization integral is zero or negative") ;
+    }
+    output[i] = error ? 0 : output[i] / normVal ;
+  }
+
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Analytical integral with normalization (see RooAbsReal::analyticalIntegralWN() for further information)
 ///
@@ -2934,6 +3081,18 @@ Double_t RooAbsPdf::expectedEvents(const RooArgSet*) const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of expectedEvents(nset) with respect to 'params'
+/// for the gradient of extended likelihoods, following the conventions of
+/// RooAbsReal::gradient(). This default implementation returns kFALSE.
+
+Bool_t RooAbsPdf::expectedEventsGradient(const RooArgList& /*params*/, Double_t* /*grad*/, const RooArgSet* /*nset*/) const
+{
+  return kFALSE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Change global level of verbosity for p.d.f. evaluations
 
@@ -103,8 +103,15 @@
 #include "TF3.h"
 #include "TMatrixD.h"
 #include "TVector.h"
+#include "TVirtualMutex.h"
+#include "RConfigure.h"
 
 #include <sstream>
+#include <algorithm>
+
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#endif
 
 using namespace std ;
 
@@ -122,6 +129,8 @@ RooAbsReal::ErrorLoggingMode RooAbsReal::_evalErrorMode = RooAbsReal::PrintError
 Int_t RooAbsReal::_evalErrorCount = 0 ;
 map<const RooAbsArg*,pair<string,list<RooAbsReal::EvalError> > > RooAbsReal::_evalErrorList ;
 
+static TVirtualMutex* gEvalErrorMutex = 0 ;
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// coverity[UNINIT_CTOR]
@@ -266,6 +275,102 @@ Double_t RooAbsReal::getValV(const RooArgSet* nset) const
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill output[0..end-begin) with the values of this function for the events
+/// [begin,end) of the vector data store 'data', with the observables
+/// normalized over 'nset'. The values are taken from the columns of the
+/// store (or of its cache of precalculated nodes) if the function is stored
+/// there, are constant if the function does not depend on the observables
+/// of the store, and are calculated by evaluateBatch() otherwise. Returns
+/// kFALSE if a function in the expression tree does not implement the batch
+/// evaluation, in which case the caller should fall back to the event by
+/// event evaluation with getVal().
+
+Bool_t RooAbsReal::getValBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data, const RooArgSet* nset) const
+{
+  if (getBatchFromData(output,begin,end,data,nset)) return kTRUE ;
+
+  if (nset && nset!=_lastNSet) {
+    ((RooAbsReal*) this)->setProxyNormSet(nset) ;
+    _lastNSet = (RooArgSet*) nset ;
+  }
+
+  if (!evaluateBatch(output,begin,end,data)) return kFALSE ;
+
+  // Same checks as in traceEval()
+  for (Int_t i=0 ; i<end-begin ; i++) {
+    if (TMath::IsNaN(output[i])) {
+      logEvalError("function value is NAN") ;
+    }
+  }
+  if (hideOffset()) {
+    for (Int_t i=0 ; i<end-begin ; i++) {
+      output[i] += offset() ;
+    }
+  }
+
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the unnormalized values of this function for the events
+/// [begin,end) of 'data', the batch equivalent of evaluate(). The values of
+/// the servers are obtained with their getValBatch(). The default
+/// implementation returns kFALSE to signal that batch evaluation is not
+/// supported.
+
+Bool_t RooAbsReal::evaluateBatch(Double_t* /*output*/, Int_t /*begin*/, Int_t /*end*/, const RooVectorDataStore& /*data*/) const
+{
+  return kFALSE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the batch without evaluating this function if possible: copy its
+/// column if it is stored in 'data' or in the cache of 'data', or repeat its
+/// current value if it does not depend on the observables of 'data'.
+/// Returns kFALSE if the function needs to be evaluated.
+
+Bool_t RooAbsReal::getBatchFromData(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data, const RooArgSet* nset) const
+{
+  const Double_t* column = data.realColumn(*this) ;
+  if (column) {
+    std::copy(column+begin,column+end,output) ;
+    return kTRUE ;
+  }
+
+  if (!dependsOn(*data.get())) {
+    std::fill(output,output+(end-begin),getVal(nset)) ;
+    return kTRUE ;
+  }
+
+  return kFALSE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill grad[0..params.getSize()) with the derivatives of getVal(nset) with
+/// respect to the parameters in 'params', at their current values. Returns
+/// kFALSE if the derivatives are not available analytically, in which case
+/// the caller should differentiate numerically. Functions that support
+/// analytic derivatives override this method and obtain the derivatives of
+/// their servers by calling gradient() on them. The default implementation
+/// only handles the trivial case of a function that does not depend on any
+/// of the parameters, for which all derivatives are zero.
+
+Bool_t RooAbsReal::gradient(const RooArgList& params, Double_t* grad, const RooArgSet* /*nset*/) const
+{
+  if (dependsOnValue(params)) return kFALSE ;
+  std::fill(grad,grad+params.getSize(),0.) ;
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Int_t RooAbsReal::numEvalErrorItems()
@@ -369,6 +474,23 @@ Double_t RooAbsReal::analyticalIntegral(Int_t code, const char* /*rangeName*/) c
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Fill grad[0..params.getSize()) with the derivatives of the analytical
+/// integral with code 'code' with respect to the parameters in 'params'.
+/// It is used by RooRealIntegral::gradient() and follows the conventions of
+/// gradient(). For code zero this is the gradient of the function itself.
+/// Functions that implement gradient() and analytical integrals should also
+/// implement this method, otherwise kFALSE is returned for nonzero codes.
+
+Bool_t RooAbsReal::analyticalIntegralGradient(Int_t code, const RooArgList& params, Double_t* grad,
+					      const RooArgSet* normSet, const char* /*rangeName*/) const
+{
+  if (code==0) return gradient(params,grad,normSet) ;
+  return kFALSE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Get the label associated with the variable
 
@@ -1596,6 +1718,9 @@ void RooAbsReal::plotOnCompSelect(RooArgSet* selNodes) const
 ///                                    This technique allows you to project a finite width slice in a real-valued observable
 ///
 /// NumCPU(Int_t ncpu)              -- Number of CPUs to use simultaneously to calculate data-weighted projections (only in combination with ProjWData)
+///                                    With the implicit multi-threading enabled, the data-weighted projections are calculated by
+///                                    ncpu threads instead of processes, and the points of the other curves are calculated
+///                                    concurrently by ncpu clones of the projected function
 ///
 ///
 /// Misc content control
@@ -2174,9 +2299,16 @@ RooPlot* RooAbsReal::plotOn(RooPlot *frame, PlotOpt o) const
     projection->getVal(projDataSel->get()) ;
     projection->attachDataSet(*projDataSel) ;
 
-    // Construct optimized data weighted average
+    // Construct optimized data weighted average. With the implicit multi-threading
+    // enabled, its NumCPU partitions are calculated by threads, each with its own
+    // clone of the projection and of the projection data, instead of forked processes
+    Bool_t threadedMode = RooAbsTestStatistic::isThreadedModeEnabled() ;
+#ifdef R__USE_IMT
+    if (o.numCPU>1 && ROOT::IsImplicitMTEnabled()) RooAbsTestStatistic::enableThreadedMode() ;
+#endif
     RooDataWeightedAverage dwa(Form("%sDataWgtAvg",GetName()),"Data Weighted average",*projection,*projDataSel,RooArgSet()/**projDataSel->get()*/,o.numCPU,o.interleave,kTRUE) ;
     //RooDataWeightedAverage dwa(Form("%sDataWgtAvg",GetName()),"Data Weighted average",*projection,*projDataSel,*projDataSel->get(),o.numCPU,o.interleave,kTRUE) ;
+    RooAbsTestStatistic::enableThreadedMode(threadedMode) ;
 
     // Do _not_ activate cache-and-track as necessary information to define normalization observables are not present in the underlying dataset
     dwa.constOptimizeTestStatistic(Activate,kFALSE) ;
@@ -2263,7 +2395,8 @@ RooPlot* RooAbsReal::plotOn(RooPlot *frame, PlotOpt o) const
 
     RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::CollectErrors) ;
     RooCurve *curve = new RooCurve(*projection,*plotVar,o.rangeLo,o.rangeHi,frame->GetNbinsX(),
-				   o.scaleFactor,0,o.precision,o.precision,o.shiftToZero,o.wmode,o.numee,o.doeeval,o.eeval,o.progress);
+				   o.scaleFactor,0,o.precision,o.precision,o.shiftToZero,o.wmode,o.numee,o.doeeval,o.eeval,o.progress,
+				   o.numCPU);
     RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
 
 
@@ -3581,6 +3714,9 @@ void RooAbsReal::logEvalError(const RooAbsReal* originator, const char* origName
     return ;
   }
 
+  // Errors may be logged concurrently by the partitions of a test statistic in threaded mode
+  R__LOCKGUARD2(gEvalErrorMutex) ;
+
   if (_evalErrorMode==CountErrors) {
     _evalErrorCount++ ;
     return ;
@@ -3636,6 +3772,9 @@ void RooAbsReal::logEvalError(const char* message, const char* serverValueString
     return ;
   }
 
+  // Errors may be logged concurrently by the partitions of a test statistic in threaded mode
+  R__LOCKGUARD2(gEvalErrorMutex) ;
+
   if (_evalErrorMode==CountErrors) {
     _evalErrorCount++ ;
     return ;
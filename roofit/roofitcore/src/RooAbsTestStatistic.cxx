@@ -32,6 +32,13 @@ organizes multi-processor parallel calculation of test statistic
 values. For the latter, the test statistic value is calculated in
 partitions in parallel executing processes and a posteriori
 combined in the main thread.
+
+If the threaded mode is enabled with enableThreadedMode(), the
+partitions are instead evaluated in the same process as implicit
+multi-threading tasks (see ROOT::EnableImplicitMT()), each by its own
+clone of the function and of the data, and the components of a
+RooSimultaneous are evaluated concurrently as well. The function
+must then be safe to evaluate in several threads on separate clones.
 **/
 
 
@@ -51,14 +58,24 @@ combined in the main thread.
 #include "TTimeStamp.h"
 #include "RooProdPdf.h"
 #include "RooRealSumPdf.h"
+#include "RConfigure.h"
 
 #include <string>
+#include <vector>
+#include <algorithm>
+
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/parallel_for.h"
+#endif
 
 using namespace std;
 
 ClassImp(RooAbsTestStatistic)
 ;
 
+Bool_t RooAbsTestStatistic::_threadedMode = kFALSE ;
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Default constructor
@@ -66,7 +83,7 @@ ClassImp(RooAbsTestStatistic)
 RooAbsTestStatistic::RooAbsTestStatistic() :
   _func(0), _data(0), _projDeps(0), _splitRange(0), _simCount(0),
   _verbose(kFALSE), _init(kFALSE), _gofOpMode(Slave), _nEvents(0), _setNum(0),
-  _numSets(0), _extSet(0), _nGof(0), _gofArray(0), _nCPU(1), _mpfeArray(0),
+  _numSets(0), _extSet(0), _nGof(0), _gofArray(0), _gofWarm(kFALSE), _nCPU(1), _mpfeArray(0),
   _mpinterl(RooFit::BulkPartition), _doOffset(kFALSE), _offset(0),
   _offsetCarry(0), _evalCarry(0)
 {
@@ -103,6 +120,7 @@ RooAbsTestStatistic::RooAbsTestStatistic(const char *name, const char *title, Ro
   _verbose(verbose),
   _nGof(0),
   _gofArray(0),
+  _gofWarm(kFALSE),
   _nCPU(nCPU),
   _mpfeArray(0),
   _mpinterl(interleave),
@@ -116,13 +134,18 @@ RooAbsTestStatistic::RooAbsTestStatistic(const char *name, const char *title, Ro
   _paramSet.add(*params) ;
   delete params ;
 
+  if (_nCPU==-1 && _threadedMode) {
+    // A single partition is simply evaluated in this process
+    _nCPU=1 ;
+  }
+
   if (_nCPU>1 || _nCPU==-1) {
 
     if (_nCPU==-1) {
       _nCPU=1 ;
     }
 
-    _gofOpMode = MPMaster ;
+    _gofOpMode = _threadedMode ? MTMaster : MPMaster ;
 
   } else {
 
@@ -161,6 +184,7 @@ RooAbsTestStatistic::RooAbsTestStatistic(const RooAbsTestStatistic& other, const
   _verbose(other._verbose),
   _nGof(0),
   _gofArray(0),
+  _gofWarm(kFALSE),
   _gofSplitMode(other._gofSplitMode),
   _nCPU(other._nCPU),
   _mpfeArray(0),
@@ -179,7 +203,7 @@ RooAbsTestStatistic::RooAbsTestStatistic(const RooAbsTestStatistic& other, const
       _nCPU=1 ;
     }
       
-    _gofOpMode = MPMaster ;
+    _gofOpMode = (other._gofOpMode==MTMaster) ? MTMaster : MPMaster ;
 
   } else {
 
@@ -214,7 +238,7 @@ RooAbsTestStatistic::~RooAbsTestStatistic()
     delete[] _mpfeArray ;
   }
 
-  if (SimMaster == _gofOpMode && _init) {
+  if ((SimMaster == _gofOpMode || MTMaster == _gofOpMode) && _init) {
     for (Int_t i = 0; i < _nGof; ++i) delete _gofArray[i];
     delete[] _gofArray ;
   }
@@ -230,7 +254,8 @@ RooAbsTestStatistic::~RooAbsTestStatistic()
 /// is calculated from on a RooSimultaneous, the test statistic calculation
 /// is performed separately on each simultaneous p.d.f component and associated
 /// data and then combined. If the test statistic calculation is parallelized
-/// partitions are calculated in nCPU processes and a posteriori combined.
+/// partitions are calculated in nCPU processes, or in nCPU implicit multi-threading
+/// tasks in the threaded mode, and a posteriori combined.
 
 Double_t RooAbsTestStatistic::evaluate() const
 {
@@ -241,6 +266,7 @@ Double_t RooAbsTestStatistic::evaluate() const
 
   if (SimMaster == _gofOpMode) {
     // Evaluate array of owned GOF objects
+    evaluateComponents() ;
     Double_t ret = 0.;
 
     if (_mpinterl == RooFit::BulkPartition || _mpinterl == RooFit::Interleave ) {
@@ -290,34 +316,30 @@ Double_t RooAbsTestStatistic::evaluate() const
     _evalCarry = carry;
     return ret ;
 
+  } else if (MTMaster == _gofOpMode) {
+
+    // Evaluate the partitions concurrently, then combine them in order
+    evaluateComponents() ;
+
+    Double_t sum(0), carry = 0.;
+    for (Int_t i = 0; i < _nGof; ++i) {
+      Double_t y = _gofArray[i]->getValV();
+      carry += _gofArray[i]->getCarry();
+      y -= carry;
+      const Double_t t = sum + y;
+      carry = (t - sum) - y;
+      sum = t;
+    }
+
+    Double_t ret = sum ;
+    _evalCarry = carry;
+    return ret ;
+
   } else {
 
     // Evaluate as straight FUNC
-    Int_t nFirst(0), nLast(_nEvents), nStep(1) ;
-    
-    switch (_mpinterl) {
-    case RooFit::BulkPartition:
-      nFirst = _nEvents * _setNum / _numSets ;
-      nLast  = _nEvents * (_setNum+1) / _numSets ;
-      nStep  = 1 ;
-      break;
-      
-    case RooFit::Interleave:
-      nFirst = _setNum ;
-      nLast  = _nEvents ;
-      nStep  = _numSets ;
-      break ;
-      
-    case RooFit::SimComponents:
-      nFirst = 0 ;
-      nLast  = _nEvents ;
-      nStep  = 1 ;
-      break ;
-      
-    case RooFit::Hybrid:
-      throw(std::string("this should never happen")) ;
-      break ;
-    }
+    Int_t nFirst, nLast, nStep ;
+    partitionRange(nFirst,nLast,nStep) ;
 
     Double_t ret = evaluatePartition(nFirst,nLast,nStep);
 
@@ -334,6 +356,117 @@ Double_t RooAbsTestStatistic::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the range and step of the events evaluated by this instance in
+/// Slave mode, following the partitioning mode of the parallel calculation
+
+void RooAbsTestStatistic::partitionRange(Int_t& nFirst, Int_t& nLast, Int_t& nStep) const
+{
+  nFirst = 0 ;
+  nLast = _nEvents ;
+  nStep = 1 ;
+
+  switch (_mpinterl) {
+  case RooFit::BulkPartition:
+    nFirst = _nEvents * _setNum / _numSets ;
+    nLast  = _nEvents * (_setNum+1) / _numSets ;
+    nStep  = 1 ;
+    break;
+
+  case RooFit::Interleave:
+    nFirst = _setNum ;
+    nLast  = _nEvents ;
+    nStep  = _numSets ;
+    break ;
+
+  case RooFit::SimComponents:
+    nFirst = 0 ;
+    nLast  = _nEvents ;
+    nStep  = 1 ;
+    break ;
+
+  case RooFit::Hybrid:
+    throw(std::string("this should never happen")) ;
+    break ;
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of the test statistic with respect to 'params',
+/// see RooAbsReal::gradient(). In SimMaster and MTMaster mode the
+/// derivatives of the components are summed, in Slave mode they are
+/// calculated by gradientPartition(). The derivatives are not available in
+/// multi-process mode, as the components are evaluated in other processes.
+
+Bool_t RooAbsTestStatistic::gradient(const RooArgList& params, Double_t* grad, const RooArgSet* /*nset*/) const
+{
+  // One-time Initialization
+  if (!_init) {
+    const_cast<RooAbsTestStatistic*>(this)->initialize() ;
+  }
+
+  Int_t n = params.getSize() ;
+
+  if (SimMaster == _gofOpMode || MTMaster == _gofOpMode) {
+
+    // The combined value is the sum of the components
+    std::fill(grad,grad+n,0.) ;
+    std::vector<Double_t> compGrad(n) ;
+    for (Int_t i = 0 ; i < _nGof; ++i) {
+      if (SimMaster == _gofOpMode && _mpinterl != RooFit::BulkPartition && _mpinterl != RooFit::Interleave &&
+	  !(i % _numSets == _setNum || (_mpinterl==RooFit::Hybrid && _gofSplitMode[i] != RooFit::SimComponents))) {
+	continue ;
+      }
+      if (!_gofArray[i]->gradient(params,compGrad.data())) return kFALSE ;
+      for (Int_t k = 0 ; k < n ; ++k) {
+	grad[k] += compGrad[k] ;
+      }
+    }
+
+    if (SimMaster == _gofOpMode && numSets()==1) {
+      const Double_t norm = globalNormalization();
+      for (Int_t k = 0 ; k < n ; ++k) {
+	grad[k] /= norm ;
+      }
+    }
+    return kTRUE ;
+
+  } else if (MPMaster == _gofOpMode) {
+
+    return kFALSE ;
+
+  }
+
+  Int_t nFirst, nLast, nStep ;
+  partitionRange(nFirst,nLast,nStep) ;
+  if (!gradientPartition(nFirst,nLast,nStep,params,grad)) return kFALSE ;
+
+  if (numSets()==1) {
+    const Double_t norm = globalNormalization();
+    for (Int_t k = 0 ; k < n ; ++k) {
+      grad[k] /= norm ;
+    }
+  }
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivatives of evaluatePartition() for the same events with
+/// respect to 'params'. The default implementation returns kFALSE to signal
+/// that they are not available.
+
+Bool_t RooAbsTestStatistic::gradientPartition(Int_t /*firstEvent*/, Int_t /*lastEvent*/, Int_t /*stepSize*/,
+					      const RooArgList& /*params*/, Double_t* /*grad*/) const
+{
+  return kFALSE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// One-time initialization of the test statistic. Setup
 /// infrastructure for simultaneous p.d.f processing and/or
@@ -345,6 +478,8 @@ Bool_t RooAbsTestStatistic::initialize()
   
   if (MPMaster == _gofOpMode) {
     initMPMode(_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
+  } else if (MTMaster == _gofOpMode) {
+    initMTMode(_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
   } else if (SimMaster == _gofOpMode) {
     initSimMode((RooSimultaneous*)_func,_data,_projDeps,_rangeName.size()?_rangeName.c_str():0,_addCoefRangeName.size()?_addCoefRangeName.c_str():0) ;
   }
@@ -359,7 +494,7 @@ Bool_t RooAbsTestStatistic::initialize()
 
 Bool_t RooAbsTestStatistic::redirectServersHook(const RooAbsCollection& newServerList, Bool_t mustReplaceAll, Bool_t nameChange, Bool_t)
 {
-  if (SimMaster == _gofOpMode && _gofArray) {
+  if ((SimMaster == _gofOpMode || MTMaster == _gofOpMode) && _gofArray) {
     // Forward to slaves
     for (Int_t i = 0; i < _nGof; ++i) {
       if (_gofArray[i]) {
@@ -386,7 +521,7 @@ Bool_t RooAbsTestStatistic::redirectServersHook(const RooAbsCollection& newServe
 
 void RooAbsTestStatistic::printCompactTreeHook(ostream& os, const char* indent)
 {
-  if (SimMaster == _gofOpMode) {
+  if (SimMaster == _gofOpMode || MTMaster == _gofOpMode) {
     // Forward to slaves
     os << indent << "RooAbsTestStatistic begin GOF contents" << endl ;
     for (Int_t i = 0; i < _nGof; ++i) {
@@ -411,6 +546,7 @@ void RooAbsTestStatistic::printCompactTreeHook(ostream& os, const char* indent)
 void RooAbsTestStatistic::constOptimizeTestStatistic(ConstOpCode opcode, Bool_t doAlsoTrackingOpt)
 {
   initialize();
+  _gofWarm = kFALSE ;
   if (SimMaster == _gofOpMode) {
     // Forward to slaves
     for (Int_t i = 0; i < _nGof; ++i) {
@@ -424,11 +560,44 @@ void RooAbsTestStatistic::constOptimizeTestStatistic(ConstOpCode opcode, Bool_t
     for (Int_t i = 0; i < _nCPU; ++i) {
       _mpfeArray[i]->constOptimizeTestStatistic(opcode,doAlsoTrackingOpt);
     }
+  } else if (MTMaster == _gofOpMode) {
+    for (Int_t i = 0; i < _nGof; ++i) {
+      _gofArray[i]->constOptimizeTestStatistic(opcode,doAlsoTrackingOpt);
+    }
   }
 }
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Enable or disable the threaded mode for the test statistics created afterwards.
+/// In the threaded mode a test statistic created with NumCPU(n) evaluates its n
+/// partitions of the data as implicit multi-threading tasks in this process
+/// instead of in n forked server processes. Each partition is calculated by its own
+/// clone of the function and of the data, attached to the shared parameters, with
+/// the same partitioning strategies as in multi-process mode. The components of
+/// a RooSimultaneous are also evaluated concurrently. The partial results are combined
+/// in a fixed order, so that the value does not depend on the number of threads.
+/// If the implicit multi-threading is not enabled the partitions and components are
+/// evaluated sequentially.
+
+void RooAbsTestStatistic::enableThreadedMode(Bool_t flag)
+{
+  _threadedMode = flag ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the test statistics are created in threaded mode
+
+Bool_t RooAbsTestStatistic::isThreadedModeEnabled()
+{
+  return _threadedMode ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set MultiProcessor set number identification of this instance
 
@@ -481,6 +650,58 @@ void RooAbsTestStatistic::initMPMode(RooAbsReal* real, RooAbsData* data, const R
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Initialize multi-thread calculation mode. Create a component test statistic for each
+/// partition of the data, with its own clone of the function and of the data, attached to
+/// the parameters of this test statistic.
+
+void RooAbsTestStatistic::initMTMode(RooAbsReal* real, RooAbsData* data, const RooArgSet* projDeps, const char* rangeName, const char* addCoefRangeName)
+{
+  _nGof = _nCPU ;
+  _gofArray = new pRooAbsTestStatistic[_nGof];
+
+  for (Int_t i = 0; i < _nGof; ++i) {
+    _gofArray[i] = create(Form("%s_GOF%d",GetName(),i),Form("%s_GOF%d",GetTitle(),i),*real,*data,*projDeps,rangeName,addCoefRangeName,1,_mpinterl,_verbose,_splitRange);
+    _gofArray[i]->recursiveRedirectServers(_paramSet);
+    _gofArray[i]->setMPSet(i,_nGof);
+  }
+  coutI(Eval) << "RooAbsTestStatistic::initMTMode: created " << _nGof << " partitions evaluated as implicit multi-threading tasks." << endl;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// In threaded mode, evaluate the component test statistics that are used by evaluate()
+/// concurrently as implicit multi-threading tasks. The components own separate clones of
+/// the function and of the data and only share the parameters. Their values are cached,
+/// and are then combined in a fixed order by evaluate(). The first evaluation after the
+/// creation or a reconfiguration of the components is done sequentially, so that their
+/// lazily created objects (normalization integrals, caches) are made in a single thread.
+
+void RooAbsTestStatistic::evaluateComponents() const
+{
+  if (!_gofWarm) {
+    _gofWarm = kTRUE ;
+    return ;
+  }
+#ifdef R__USE_IMT
+  if ((!_threadedMode && MTMaster != _gofOpMode) || _nGof < 2 || !ROOT::IsImplicitMTEnabled()) return ;
+
+  std::vector<Int_t> used ;
+  for (Int_t i = 0; i < _nGof; ++i) {
+    if (MTMaster == _gofOpMode || _mpinterl == RooFit::BulkPartition || _mpinterl == RooFit::Interleave ||
+	i % _numSets == _setNum || (_mpinterl==RooFit::Hybrid && _gofSplitMode[i] != RooFit::SimComponents)) {
+      used.push_back(i) ;
+    }
+  }
+  if (used.size() < 2) return ;
+
+  tbb::parallel_for(0, (Int_t)used.size(), [&](Int_t k) { _gofArray[used[k]]->getValV() ; }) ;
+#endif
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Initialize simultaneous p.d.f processing mode. Strip simultaneous
 /// p.d.f into individual components, split dataset in subset
@@ -637,6 +858,7 @@ Bool_t RooAbsTestStatistic::setData(RooAbsData& indata, Bool_t cloneData)
   case SimMaster:
     // Forward to slaves
     //     cout << "RATS::setData(" << GetName() << ") SimMaster, calling setDataSlave() on slave nodes" << endl;
+    _gofWarm = kFALSE ;
     if (indata.canSplitFast()) {
       for (Int_t i = 0; i < _nGof; ++i) {
 	RooAbsData* compData = indata.getSimData(_gofArray[i]->GetName());
@@ -662,6 +884,14 @@ Bool_t RooAbsTestStatistic::setData(RooAbsData& indata, Bool_t cloneData)
       }
     }
     break;
+  case MTMaster:
+    // Forward to the partitions, each of which needs its own copy of the data
+    initialize() ;
+    _gofWarm = kFALSE ;
+    for (Int_t i = 0; i < _nGof; ++i) {
+      _gofArray[i]->setData(indata, kTRUE);
+    }
+    break;
   case MPMaster:
     // Not supported
     coutF(DataHandling) << "RooAbsTestStatistic::setData(" << GetName() << ") FATAL: setData() is not supported in multi-processor mode" << endl;
@@ -692,6 +922,7 @@ void RooAbsTestStatistic::enableOffsetting(Bool_t flag)
     setValueDirty() ;
     break ;
   case SimMaster:
+  case MTMaster:
     _doOffset = flag;
     for (Int_t i = 0; i < _nGof; ++i) {
       _gofArray[i]->enableOffsetting(flag);
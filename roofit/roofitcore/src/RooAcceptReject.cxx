@@ -36,10 +36,12 @@ do not define internal methods
 #include "RooCategory.h"
 #include "RooRealVar.h"
 #include "RooDataSet.h"
+#include "RooVectorDataStore.h"
 #include "RooRandom.h"
 #include "RooErrorHandler.h"
 
 #include "TString.h"
+#include "TMath.h"
 #include "TIterator.h"
 #include "RooMsgService.h"
 #include "TClass.h"
@@ -79,7 +81,7 @@ void RooAcceptReject::registerSampler(RooNumGenFactory& fact)
 /// cloned and so will not be disturbed during the generation process.
 
 RooAcceptReject::RooAcceptReject(const RooAbsReal &func, const RooArgSet &genVars, const RooNumGenConfig& config, Bool_t verbose, const RooAbsReal* maxFuncVal) :
-  RooAbsNumGenerator(func,genVars,verbose,maxFuncVal), _nextCatVar(0), _nextRealVar(0)
+  RooAbsNumGenerator(func,genVars,verbose,maxFuncVal), _nextCatVar(0), _nextRealVar(0), _trials(0), _batchEval(kTRUE)
 {
   _minTrialsArray[0] = static_cast<Int_t>(config.getConfigSection("RooAcceptReject").getRealValue("nTrial0D")) ;
   _minTrialsArray[1] = static_cast<Int_t>(config.getConfigSection("RooAcceptReject").getRealValue("nTrial1D")) ;
@@ -167,6 +169,7 @@ RooAcceptReject::~RooAcceptReject()
 {
   delete _nextCatVar;
   delete _nextRealVar;
+  delete _trials;
 }
 
 
@@ -189,7 +192,7 @@ const RooArgSet *RooAcceptReject::generateEvent(UInt_t remaining, Double_t& resa
     // maximum function value
 
     while(_totalEvents < _minTrials) {
-      addEventToCache();
+      addEventsToCache(TMath::Min(_minTrials-_totalEvents,kTrialBlockSize));
 
       // Limit cache size to 1M events
       if (_cache->numEntries()>1000000) {
@@ -225,8 +228,10 @@ const RooArgSet *RooAcceptReject::generateEvent(UInt_t remaining, Double_t& resa
       Long64_t extra= 1 + (Long64_t)(1.05*remaining/eff);
       cxcoutD(Generation) << "RooAcceptReject::generateEvent: adding " << extra << " events to the cache, eff = " << eff << endl;
       Double_t oldMax(_maxFuncVal);
-      while(extra--) {
-	addEventToCache();
+      while(extra>0) {
+	UInt_t nEvents = extra<kTrialBlockSize ? UInt_t(extra) : kTrialBlockSize ;
+	addEventsToCache(nEvents);
+	extra -= nEvents ;
 	if((_maxFuncVal > oldMax)) {
 	  cxcoutD(Generation) << "RooAcceptReject::generateEvent: estimated function maximum increased from "
 			      << oldMax << " to " << _maxFuncVal << endl;
@@ -296,6 +301,67 @@ const RooArgSet *RooAcceptReject::nextAcceptedEvent()
 /// of the function maximum value and integral.
 
 void RooAcceptReject::addEventToCache() 
+{
+  randomizeEvent();
+
+  // calculate and store our function value at this new point
+  cacheEvent(_funcClone->getVal());
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add 'nEvents' trial events to our cache. The trial events are generated
+/// in blocks of kTrialBlockSize events, for which the function is evaluated
+/// together with RooAbsReal::getValBatch(). If the function does not support
+/// batch evaluation, it is evaluated event by event for this and all
+/// following trials.
+
+void RooAcceptReject::addEventsToCache(UInt_t nEvents) 
+{
+  if (_batchEval && !_trials) {
+    // The store writes the generated variables directly, the function value
+    // is not included so that it is not taken for the value of the function
+    _trialVars.add(_catVars);
+    _trialVars.add(_realVars);
+    _trials = new RooVectorDataStore("trials","Accept-Reject Trial Events",_trialVars);
+  }
+
+  vector<Double_t> vals(kTrialBlockSize);
+  while(_batchEval && nEvents>0) {
+    UInt_t nBlock = TMath::Min(nEvents,kTrialBlockSize);
+    nEvents -= nBlock;
+
+    // generate a block of trial events and evaluate the function for all of them
+    _trials->reset();
+    for (UInt_t i=0 ; i<nBlock ; i++) {
+      randomizeEvent();
+      _trials->fill();
+    }
+    _batchEval = _funcClone->getValBatch(&vals[0],0,nBlock,*_trials);
+    if (!_batchEval) {
+      cxcoutD(Generation) << "RooAcceptReject::addEventsToCache(" << fName << ") batch evaluation not supported by "
+			  << _funcClone->GetName() << ", evaluating trial events one by one" << endl;
+    }
+
+    // load the trial events back into the generated variables and cache them
+    for (UInt_t i=0 ; i<nBlock ; i++) {
+      _trials->get(i);
+      cacheEvent(_batchEval ? vals[i] : _funcClone->getVal());
+    }
+  }
+
+  while(nEvents--) {
+    addEventToCache();
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Assign random values to the generated variables
+
+void RooAcceptReject::randomizeEvent() 
 {
   // randomize each discrete argument
   _nextCatVar->Reset();
@@ -306,9 +372,17 @@ void RooAcceptReject::addEventToCache()
   _nextRealVar->Reset();
   RooRealVar *real = 0;
   while((real= (RooRealVar*)_nextRealVar->Next())) real->randomize();
+}
 
-  // calculate and store our function value at this new point
-  Double_t val= _funcClone->getVal();
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Store the current values of the generated variables in our cache
+/// together with the function value 'val' at this point, and update
+/// our estimates of the function maximum value and integral.
+
+void RooAcceptReject::cacheEvent(Double_t val) 
+{
   _funcValPtr->setVal(val);
 
   // Update the estimated integral and maximum value. Increase our
@@ -335,7 +409,7 @@ Double_t RooAcceptReject::getFuncMax()
 
   // Generate the minimum required number of samples for a reliable maximum estimate
   while(_totalEvents < _minTrials) {
-    addEventToCache();
+    addEventsToCache(TMath::Min(_minTrials-_totalEvents,kTrialBlockSize));
 
     // Limit cache size to 1M events
     if (_cache->numEntries()>1000000) {
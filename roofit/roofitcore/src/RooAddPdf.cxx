@@ -78,6 +78,7 @@ of each coefficient_i.
 
 #include "Riostream.h"
 #include <algorithm>
+#include <vector>
 
 
 using namespace std;
@@ -860,6 +861,48 @@ Double_t RooAddPdf::evaluate() const
 }
 
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate(): sum the batches of the component p.d.f.s
+/// weighted with the coefficients for the events [begin,end) of 'data'
+
+Bool_t RooAddPdf::evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const
+{
+  const RooArgSet* nset = _normSet ;
+
+  if (nset==0 || nset->getSize()==0) {
+    if (_refCoefNorm.getSize()!=0) {
+      nset = &_refCoefNorm ;
+    }
+  }
+
+  CacheElem* cache = getProjCache(nset) ;
+  updateCoefficients(*cache,nset) ;
+
+  const Int_t n = end-begin ;
+  std::vector<Double_t> pdfVal(n) ;
+  std::fill(output,output+n,0.) ;
+
+  RooAbsPdf* pdf ;
+  Int_t i(0) ;
+  RooFIter pi = _pdfList.fwdIterator() ;
+  while((pdf = (RooAbsPdf*)pi.next())) {
+    Double_t snormVal = cache->_needSupNorm ? ((RooAbsReal*)cache->_suppNormList.at(i))->getVal() : 1 ;
+    if (!pdf->getValBatch(&pdfVal[0],begin,end,data,nset)) return kFALSE ;
+    if (pdf->isSelectedComp()) {
+      if (cache->_needSupNorm) {
+	for (Int_t j=0 ; j<n ; j++) output[j] += pdfVal[j]*_coefCache[i]/snormVal ;
+      } else {
+	for (Int_t j=0 ; j<n ; j++) output[j] += pdfVal[j]*_coefCache[i] ;
+      }
+    }
+    i++ ;
+  }
+
+  return kTRUE ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Reset error counter to given value, limiting the number
 /// of future error messages for this pdf to 'resetValue'
@@ -33,6 +33,7 @@ i.e. all integrals of the product are handled numerically
 #include <memory>
 #include <list>
 #include <algorithm>
+#include <vector>
 using namespace std ;
 
 #include "RooAddition.h"
@@ -179,6 +180,31 @@ Double_t RooAddition::evaluate() const
 }
 
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of the sum with respect to 'params': the sum of
+/// the derivatives of the terms. Returns kFALSE if the derivatives of one
+/// of the terms are not available
+
+Bool_t RooAddition::gradient(const RooArgList& params, Double_t* grad, const RooArgSet* /*nset*/) const
+{
+  Int_t n = params.getSize() ;
+  std::fill(grad,grad+n,0.) ;
+  std::vector<Double_t> compGrad(n) ;
+  const RooArgSet* nset = _set.nset() ;
+
+  RooFIter setIter = _set.fwdIterator() ;
+  RooAbsReal* comp ;
+  while((comp=(RooAbsReal*)setIter.next())) {
+    if (!comp->gradient(params,compGrad.data(),nset)) return kFALSE ;
+    for (Int_t i=0 ; i<n ; i++) {
+      grad[i] += compGrad[i] ;
+    }
+  }
+  return kTRUE ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the default error level for MINUIT error analysis
 /// If the addition contains one or more RooNLLVars and 
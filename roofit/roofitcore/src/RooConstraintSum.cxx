@@ -32,6 +32,8 @@ arguments
 #include "Riostream.h"
 #include "Riostream.h"
 #include <math.h>
+#include <vector>
+#include <algorithm>
 
 #include "RooConstraintSum.h"
 #include "RooAbsReal.h"
@@ -129,3 +131,28 @@ Double_t RooConstraintSum::evaluate() const
   return sum ;
 }
 
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of the sum of -log(p) of the constraint terms with
+/// respect to 'params'. Returns kFALSE if the derivatives of one of the
+/// constraint p.d.f.s are not available or if its value is not positive
+
+Bool_t RooConstraintSum::gradient(const RooArgList& params, Double_t* grad, const RooArgSet* /*nset*/) const
+{
+  Int_t n = params.getSize() ;
+  std::fill(grad,grad+n,0.) ;
+  std::vector<Double_t> compGrad(n) ;
+
+  RooAbsReal* comp ;
+  RooFIter setIter1 = _set1.fwdIterator() ;
+  while((comp=(RooAbsReal*)setIter1.next())) {
+    Double_t val = comp->getVal(&_paramSet) ;
+    if (val<=0 || !comp->gradient(params,compGrad.data(),&_paramSet)) return kFALSE ;
+    for (Int_t i=0 ; i<n ; i++) {
+      grad[i] -= compGrad[i]/val ;
+    }
+  }
+  return kTRUE ;
+}
+
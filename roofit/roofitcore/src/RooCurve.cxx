@@ -43,6 +43,7 @@ a function y(x) is actually evaluated to approximate a smooth curve, use:
 #include "RooRealBinding.h"
 #include "RooScaledFunc.h"
 #include "RooMsgService.h"
+#include "RConfigure.h"
 
 #include "Riostream.h"
 #include "TClass.h"
@@ -56,6 +57,11 @@ a function y(x) is actually evaluated to approximate a smooth curve, use:
 #include <algorithm>
 #include <limits>
 
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/parallel_for.h"
+#endif
+
 using namespace std ;
 
 ClassImp(RooCurve)
@@ -78,11 +84,15 @@ RooCurve::RooCurve() : _showProgress(kFALSE)
 /// factor to rescale the expression after normalization.
 /// If shiftToZero is set, the entire curve is shift down to make the lowest
 /// point in of the curve go through zero.
+/// If nThreads is larger than one and the implicit multi-threading is enabled,
+/// the points of the curve are calculated concurrently by nThreads clones of
+/// the expression tree (see addPoints()), which yields the same curve as the
+/// sequential sampling.
 
 RooCurve::RooCurve(const RooAbsReal &f, RooAbsRealLValue &x, Double_t xlo, Double_t xhi, Int_t xbins,
 		   Double_t scaleFactor, const RooArgSet *normVars, Double_t prec, Double_t resolution,
 		   Bool_t shiftToZero, WingMode wmode, Int_t nEvalError, Int_t doEEVal, Double_t eeVal, 
-		   Bool_t showProg) : _showProgress(showProg)
+		   Bool_t showProg, Int_t nThreads) : _showProgress(showProg)
 {
 
   // grab the function's name and title
@@ -117,10 +127,47 @@ RooCurve::RooCurve(const RooAbsReal &f, RooAbsRealLValue &x, Double_t xlo, Doubl
   }
   assert(0 != funcPtr);
 
+  // Make the clones of the expression tree evaluating the points in the other threads.
+  // Each clone is evaluated once here, so that its normalization integrals and caches
+  // are created in a single thread
+  std::vector<const RooAbsFunc*> funcs(1,funcPtr) ;
+  std::vector<RooAbsFunc*> cloneFuncs ;
+  std::vector<RooAbsReal*> clones ;
+#ifdef R__USE_IMT
+  if (nThreads>1 && ROOT::IsImplicitMTEnabled()) {
+    Double_t xx = xlo ;
+    (*funcPtr)(&xx) ;
+    for (Int_t i=1 ; i<nThreads ; i++) {
+      RooAbsReal* clone = (RooAbsReal*) f.cloneTree() ;
+      RooArgSet nodes ;
+      clone->treeNodeServerList(&nodes) ;
+      RooAbsRealLValue* xclone = dynamic_cast<RooAbsRealLValue*>(nodes.find(x.GetName())) ;
+      if (!xclone) {
+	delete clone ;
+	break ;
+      }
+      clones.push_back(clone) ;
+      RooAbsFunc* cloneFunc = clone->bindVars(*xclone,normVars,kTRUE) ;
+      cloneFuncs.push_back(cloneFunc) ;
+      if (scaleFactor != 1) {
+	cloneFunc = new RooScaledFunc(*cloneFunc,scaleFactor) ;
+	cloneFuncs.push_back(cloneFunc) ;
+      }
+      (*cloneFunc)(&xx) ;
+      funcs.push_back(cloneFunc) ;
+    }
+    RooAbsReal::clearEvalErrorLog() ;
+  }
+#endif
+
   // calculate the points to add to our curve
   Double_t prevYMax = getYAxisMax() ;
   list<Double_t>* hint = f.plotSamplingHint(x,xlo,xhi) ;
-  addPoints(*funcPtr,xlo,xhi,xbins+1,prec,resolution,wmode,nEvalError,doEEVal,eeVal,hint);
+  if (funcs.size()>1) {
+    addPoints(funcs,xlo,xhi,xbins+1,prec,resolution,wmode,nEvalError,doEEVal,eeVal,hint);
+  } else {
+    addPoints(*funcPtr,xlo,xhi,xbins+1,prec,resolution,wmode,nEvalError,doEEVal,eeVal,hint);
+  }
   if (_showProgress) {
     ccoutP(Plotting) << endl ;
   }
@@ -132,6 +179,12 @@ RooCurve::RooCurve(const RooAbsReal &f, RooAbsRealLValue &x, Double_t xlo, Doubl
   // cleanup
   delete funcPtr;
   if(rawPtr) delete rawPtr;
+  for (std::vector<RooAbsFunc*>::reverse_iterator it=cloneFuncs.rbegin() ; it!=cloneFuncs.rend() ; ++it) {
+    delete *it ;
+  }
+  for (std::vector<RooAbsReal*>::iterator it=clones.begin() ; it!=clones.end() ; ++it) {
+    delete *it ;
+  }
   if (shiftToZero) shiftCurveToZero(prevYMax) ;
 
   // Adjust limits
@@ -452,6 +505,196 @@ void RooCurve::addRange(const RooAbsFunc& func, Double_t x1, Double_t x2,
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add points calculated with the specified functions, which must be independent
+/// clones of the same function, as addPoints(const RooAbsFunc&,...) does. The
+/// points of the coarse scan are calculated concurrently, and the ranges are then
+/// refined level by level: the midpoints of all the ranges of a level are
+/// calculated concurrently, before the ranges to subdivide further are chosen with
+/// the criterion of addRange(). The resulting points are the same as those of the
+/// recursive sequential sampling.
+
+void RooCurve::addPoints(const std::vector<const RooAbsFunc*>& funcs, Double_t xlo, Double_t xhi,
+			 Int_t minPoints, Double_t prec, Double_t resolution, WingMode wmode,
+			 Int_t numee, Bool_t doEEVal, Double_t eeVal, list<Double_t>* samplingHint) 
+{
+  // check the inputs
+  if(funcs.empty() || !funcs[0]->isValid()) {
+    coutE(InputArguments) << fName << "::addPoints: input function is not valid" << endl;
+    return;
+  }
+  if(minPoints <= 0 || xhi <= xlo) {
+    coutE(InputArguments) << fName << "::addPoints: bad input (nothing added)" << endl;
+    return;
+  }
+
+  // Adjust minimum number of points to external sampling hint if used
+  if (samplingHint) {
+    minPoints = samplingHint->size() ;
+  }
+
+  // Get list of initial x values. If function provides sampling hint use that,
+  // otherwise use default binning of frame
+  Double_t dx= (xhi-xlo)/(minPoints-1.);
+  std::vector<Double_t> xval ;
+  if (samplingHint) {
+    xval.assign(samplingHint->begin(),samplingHint->end()) ;
+  } else {
+    for(Int_t step= 0; step < minPoints; step++) {
+      xval.push_back(xlo + step*dx) ;
+    }    
+  }
+
+  // Perform a coarse scan of the function to estimate its y range
+  std::vector<Double_t> xeval(xval) ;
+  xeval.back() -= 1e-15 ;
+  std::vector<Double_t> yval ;
+  evalPoints(funcs,xeval,yval,numee,doEEVal,eeVal) ;
+
+  Double_t ymax(-1e30), ymin(1e30) ;
+  for (UInt_t i=0 ; i<yval.size() ; i++) {
+    if (yval[i]>ymax) ymax=yval[i] ;
+    if (yval[i]<ymin) ymin=yval[i] ;
+  }
+  Double_t yrangeEst=(ymax-ymin) ;
+  Double_t minDy= prec*yrangeEst ;
+  Double_t minDx= resolution*(xhi-xlo);
+
+  if (wmode==Extended) {
+    addPoint(xlo-dx,0) ;
+    addPoint(xlo-dx,yval[0]) ;
+  } else if (wmode==Straight) {
+    addPoint(xlo,0) ;
+  }
+
+  addPoint(xlo,yval[0]);
+
+  if (prec<0) {
+    // If precision is <0, no attempt at recursive interpolation is made
+    for (UInt_t step=1 ; step<xval.size() ; step++) {
+      addPoint(xval[step],yval[step]) ;
+    }
+  } else {
+
+    // A range of the coarse scan (whose index is step) being refined. The points
+    // added by the recursive sampling are the upper ends of the final ranges
+    struct Range {
+      Double_t x1, x2, y1, y2 ;
+      UInt_t step ;
+    } ;
+    std::vector<Range> ranges, next, final ;
+    for (UInt_t step=1 ; step<xval.size() ; step++) {
+      Range r = { xval[step-1], xval[step], yval[step-1], yval[step], step } ;
+      ranges.push_back(r) ;
+    }
+
+    std::vector<Double_t> xmid, ymid ;
+    while (!ranges.empty()) {
+      // Explicitly skip empty ranges to eliminate point duplication
+      ranges.erase(std::remove_if(ranges.begin(),ranges.end(),
+				  [](const Range& r) { return fabs(r.x2-r.x1)<1e-20 ; }),ranges.end()) ;
+
+      xmid.resize(ranges.size()) ;
+      for (UInt_t i=0 ; i<ranges.size() ; i++) {
+	xmid[i] = 0.5*(ranges[i].x1+ranges[i].x2) ;
+      }
+      evalPoints(funcs,xmid,ymid,numee,doEEVal,eeVal) ;
+
+      // test if the midpoint is sufficiently close to a straight line across each range
+      next.clear() ;
+      for (UInt_t i=0 ; i<ranges.size() ; i++) {
+	const Range& r = ranges[i] ;
+	Double_t dy= ymid[i] - 0.5*(r.y1+r.y2);
+	if((xmid[i] - r.x1 >= minDx) && fabs(dy)>0 && fabs(dy) >= minDy) {
+	  Range lo = { r.x1, xmid[i], r.y1, ymid[i], r.step } ;
+	  Range hi = { xmid[i], r.x2, ymid[i], r.y2, r.step } ;
+	  next.push_back(lo) ;
+	  next.push_back(hi) ;
+	} else {
+	  final.push_back(r) ;
+	}
+      }
+      ranges.swap(next) ;
+    }
+
+    // add the points in the order of the recursive sampling, i.e. by range of the
+    // coarse scan and then along the direction of that range
+    std::sort(final.begin(),final.end(),[&xval](const Range& a, const Range& b) {
+	if (a.step != b.step) return a.step < b.step ;
+	return (xval[a.step] >= xval[a.step-1]) ? a.x2 < b.x2 : a.x2 > b.x2 ; }) ;
+    for (UInt_t i=0 ; i<final.size() ; i++) {
+      addPoint(final[i].x2,final[i].y2) ;
+    }
+  }
+  addPoint(xhi,yval.back()) ;
+
+  if (wmode==Extended) {
+    addPoint(xhi+dx,yval.back()) ;
+    addPoint(xhi+dx,0) ;
+  } else if (wmode==Straight) {
+    addPoint(xhi,0) ;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the values of the independent clones of a function in funcs at the
+/// points xvals. With the implicit multi-threading enabled, the points are split in
+/// contiguous blocks calculated concurrently, each by its own clone. If evaluation
+/// errors occur, the values are calculated again sequentially so that the errors
+/// are reported, and replaced if requested, point by point as in addRange().
+
+void RooCurve::evalPoints(const std::vector<const RooAbsFunc*>& funcs, const std::vector<Double_t>& xvals,
+			  std::vector<Double_t>& yvals, Int_t numee, Bool_t doEEVal, Double_t eeVal) 
+{
+  yvals.resize(xvals.size()) ;
+  Bool_t done(kFALSE) ;
+
+#ifdef R__USE_IMT
+  Int_t nBlocks = std::min<Int_t>(funcs.size(),xvals.size()) ;
+  if (nBlocks>1 && ROOT::IsImplicitMTEnabled()) {
+    RooAbsReal::clearEvalErrorLog() ;
+    tbb::parallel_for(0, nBlocks, [&](Int_t k) {
+	const RooAbsFunc& func = *funcs[k] ;
+	for (UInt_t i=xvals.size()*k/nBlocks ; i<xvals.size()*(k+1)/nBlocks ; i++) {
+	  Double_t xx = xvals[i] ;
+	  yvals[i] = func(&xx) ;
+	}
+      }) ;
+    done = (RooAbsReal::numEvalErrors()==0) ;
+    RooAbsReal::clearEvalErrorLog() ;
+    if (done && _showProgress) {
+      ccoutP(Plotting) << std::string(xvals.size(),'.') ;
+      cout.flush() ;
+    }
+  }
+#endif
+
+  if (done) return ;
+
+  const RooAbsFunc& func = *funcs[0] ;
+  for (UInt_t i=0 ; i<xvals.size() ; i++) {
+    Double_t xx = xvals[i] ;
+    yvals[i] = func(&xx) ;
+    if (_showProgress) {
+      ccoutP(Plotting) << "." ;
+      cout.flush() ;
+    }
+
+    if (RooAbsReal::numEvalErrors()>0) {
+      if (numee>=0) {
+	coutW(Plotting) << "At observable [x]=" << xx <<  " " ;
+	RooAbsReal::printEvalErrors(ccoutW(Plotting),numee) ;
+      }
+      if (doEEVal) {
+	yvals[i]=eeVal ;
+      }
+    }
+    RooAbsReal::clearEvalErrorLog() ;
+  }
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Add a point with the specified coordinates. Update our y-axis limits.
 
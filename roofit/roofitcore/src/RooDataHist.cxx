@@ -39,6 +39,7 @@ or RooStringVar objects, thus data can be binned in real and/or discrete dimensi
 #include "RooRealVar.h"
 #include "RooMath.h"
 #include "RooBinning.h"
+#include "RooUniformBinning.h"
 #include "RooPlot.h"
 #include "RooHistError.h"
 #include "RooCategory.h"
@@ -800,6 +801,7 @@ void RooDataHist::initialize(const char* binningName, Bool_t fillTree)
     const RooAbsBinning* binning = dynamic_cast<RooAbsLValue*>(rvarg)->getBinningPtr(0);
     _lvbins.push_back(binning ? binning->clone() : 0);
   }
+  initFastIndex() ;
 
   
   // Allocate coefficients array
@@ -931,6 +933,7 @@ RooDataHist::RooDataHist(const RooDataHist& other, const char* newname) :
     const RooAbsBinning* binning = dynamic_cast<RooAbsLValue*>(rvarg)->getBinningPtr(0) ;
     _lvbins.push_back(binning ? binning->clone() : 0) ;    
   }
+  initFastIndex() ;
 
   _dstore->setExternalWeightArray(_wgt,_errLo,_errHi,_sumw2) ;
 
@@ -1102,19 +1105,116 @@ Int_t RooDataHist::getIndex(const RooArgSet& coord, Bool_t fast)
 
 Int_t RooDataHist::calcTreeIndex() const 
 {
-  Int_t masterIdx(0), i(0) ;
-  vector<RooAbsLValue*>::const_iterator iter = _lvvars.begin() ;
-  vector<const RooAbsBinning*>::const_iterator biter = _lvbins.begin() ;
-  for (;iter!=_lvvars.end() ; ++iter) {
-    const RooAbsBinning* binning = (*biter) ;
-    masterIdx += _idxMult[i++]*(*iter)->getBin(binning) ;
-    biter++ ;
+  Int_t masterIdx(0) ;
+  for (UInt_t i=0 ; i<_lvvars.size() ; i++) {
+    const RooAbsReal* real = _idxReal[i] ;
+    if (real) {
+      // Same as RooUniformBinning::binNumber()
+      Int_t bin = Int_t((real->getVal()-_idxLo[i])/_idxBinW[i]) ;
+      if (bin<0) bin = 0 ;
+      if (bin>_idxNBins[i]-1) bin = _idxNBins[i]-1 ;
+      masterIdx += _idxMult[i]*bin ;
+    } else {
+      masterIdx += _idxMult[i]*_lvvars[i]->getBin(_lvbins[i]) ;
+    }
   }
   return masterIdx ;
 }
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Precompute the bounds and bin widths of the observables that are RooRealVars
+/// with a uniform binning, so that calcTreeIndex() can calculate their bin numbers
+/// directly instead of through the virtual getBin() and binNumber() calls
+
+void RooDataHist::initFastIndex()
+{
+  _idxReal.assign(_lvvars.size(),0) ;
+  _idxLo.assign(_lvvars.size(),0.) ;
+  _idxBinW.assign(_lvvars.size(),1.) ;
+  _idxNBins.assign(_lvvars.size(),1) ;
+  for (UInt_t i=0 ; i<_lvvars.size() ; i++) {
+    RooRealVar* real = dynamic_cast<RooRealVar*>(_lvvars[i]) ;
+    const RooUniformBinning* binning = dynamic_cast<const RooUniformBinning*>(_lvbins[i]) ;
+    if (real && real->IsA()==RooRealVar::Class() && binning && binning->IsA()==RooUniformBinning::Class()) {
+      _idxReal[i] = real ;
+      _idxLo[i] = binning->lowBound() ;
+      _idxBinW[i] = binning->averageBinWidth() ;
+      _idxNBins[i] = binning->numBins() ;
+    }
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the master index of the bins enclosing 'n' points. The coordinates
+/// of the points are passed as one array of 'n' values per observable of the 
+/// histogram, in the order of get(). Return false if not all observables are 
+/// real-valued with a uniform binning, in which case the indices must be 
+/// calculated point by point with getIndex()
+
+Bool_t RooDataHist::binIndices(Int_t* output, Int_t n, const vector<const Double_t*>& coords) const
+{
+  checkInit() ;
+  if (coords.size()!=_lvvars.size()) {
+    coutE(InputArguments) << "RooDataHist::binIndices(" << GetName() << ") ERROR: expected " << _lvvars.size() 
+			  << " coordinate arrays, got " << coords.size() << endl ;
+    return kFALSE ;
+  }
+  for (UInt_t i=0 ; i<_lvvars.size() ; i++) {
+    if (!_idxReal[i]) return kFALSE ;
+  }
+
+  for (Int_t k=0 ; k<n ; k++) {
+    output[k] = 0 ;
+  }
+  for (UInt_t i=0 ; i<_lvvars.size() ; i++) {
+    const Double_t* x = coords[i] ;
+    const Double_t lo = _idxLo[i] ;
+    const Double_t binw = _idxBinW[i] ;
+    const Int_t maxBin = _idxNBins[i]-1 ;
+    const Int_t mult = _idxMult[i] ;
+    for (Int_t k=0 ; k<n ; k++) {
+      Int_t bin = Int_t((x[k]-lo)/binw) ;
+      if (bin<0) bin = 0 ;
+      if (bin>maxBin) bin = maxBin ;
+      output[k] += mult*bin ;
+    }
+  }
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return in 'output' the weights of the bins enclosing 'n' points, divided by 
+/// the bin volume if 'correctForBinSize' is true. This is the equivalent of 
+/// weight(bin,0,correctForBinSize) for many points at once, with the coordinates 
+/// passed as in binIndices(). Return false if the bin indices cannot be calculated
+/// in one pass
+
+Bool_t RooDataHist::weights(Double_t* output, Int_t n, const vector<const Double_t*>& coords, Bool_t correctForBinSize) const
+{
+  vector<Int_t> idx(n) ;
+  if (n>0 && !binIndices(&idx[0],n,coords)) {
+    return kFALSE ;
+  }
+  if (correctForBinSize) {
+    for (Int_t k=0 ; k<n ; k++) {
+      output[k] = _wgt[idx[k]] / _binv[idx[k]] ;
+    }
+  } else {
+    for (Int_t k=0 ; k<n ; k++) {
+      output[k] = _wgt[idx[k]] ;
+    }
+  }
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Debug stuff, should go...
 
@@ -493,7 +493,7 @@ RooDataSet::RooDataSet(const char* name, const char* title, const RooArgSet& var
 	RooFormulaVar cutVarTmp(cutSpec,cutSpec,_vars) ;
 	if (tstore) {
 	  tstore->loadValues(impTree,&cutVarTmp,cutRange);      
-	} else {
+	} else if (!vstore || !vstore->loadValues(impTree,&cutVarTmp,cutRange)) {
 	  RooTreeDataStore tmpstore(name,title,_vars,wgtVarName) ;
 	  tmpstore.loadValues(impTree,&cutVarTmp,cutRange) ;
 	  _dstore->append(tmpstore) ;
@@ -514,7 +514,7 @@ RooDataSet::RooDataSet(const char* name, const char* title, const RooArgSet& var
 	RooFormulaVar cutVarTmp(cutSpec,cutSpec,_vars) ;
 	if (tstore) {
 	  tstore->loadValues(t,&cutVarTmp,cutRange);      	
-	} else {
+	} else if (!vstore || !vstore->loadValues(t,&cutVarTmp,cutRange)) {
 	  RooTreeDataStore tmpstore(name,title,_vars,wgtVarName) ;
 	  tmpstore.loadValues(t,&cutVarTmp,cutRange) ;
 	  _dstore->append(tmpstore) ;
@@ -552,7 +552,7 @@ RooDataSet::RooDataSet(const char* name, const char* title, const RooArgSet& var
 	// Case 4b --- Import TTree from memory with cutvar
 	if (tstore) {
 	  tstore->loadValues(impTree,cutVar,cutRange);
-	} else {
+	} else if (!vstore || !vstore->loadValues(impTree,cutVar,cutRange)) {
 	  RooTreeDataStore tmpstore(name,title,_vars,wgtVarName) ;
 	  tmpstore.loadValues(impTree,cutVar,cutRange) ;
 	  _dstore->append(tmpstore) ;
@@ -571,7 +571,7 @@ RooDataSet::RooDataSet(const char* name, const char* title, const RooArgSet& var
 	}
 	if (tstore) {
 	  tstore->loadValues(t,cutVar,cutRange);      	
-	} else {
+	} else if (!vstore || !vstore->loadValues(t,cutVar,cutRange)) {
 	  RooTreeDataStore tmpstore(name,title,_vars,wgtVarName) ;
 	  tmpstore.loadValues(t,cutVar,cutRange) ;
 	  _dstore->append(tmpstore) ;
@@ -608,7 +608,7 @@ RooDataSet::RooDataSet(const char* name, const char* title, const RooArgSet& var
 	// Case 4c --- Import TTree from memort
 	if (tstore) {
 	  tstore->loadValues(impTree,0,cutRange);
-	} else {
+	} else if (!vstore || !vstore->loadValues(impTree,0,cutRange)) {
 	  RooTreeDataStore tmpstore(name,title,_vars,wgtVarName) ;
 	  tmpstore.loadValues(impTree,0,cutRange) ;
 	  _dstore->append(tmpstore) ;
@@ -627,7 +627,7 @@ RooDataSet::RooDataSet(const char* name, const char* title, const RooArgSet& var
 	}
 	if (tstore) {
 	  tstore->loadValues(t,0,cutRange);      	
-	} else {
+	} else if (!vstore || !vstore->loadValues(t,0,cutRange)) {
 	  RooTreeDataStore tmpstore(name,title,_vars,wgtVarName) ;
 	  tmpstore.loadValues(t,0,cutRange) ;
 	  _dstore->append(tmpstore) ;
@@ -759,19 +759,33 @@ RooDataSet::RooDataSet(const char *name, const char *title, TTree *intree,
 		       const RooArgSet& vars, const RooFormulaVar& cutVar, const char* wgtVarName) :
   RooAbsData(name,title,vars)
 {
-  // Create tree version of datastore 
-  RooTreeDataStore* tstore = new RooTreeDataStore(name,title,_vars,*intree,cutVar,wgtVarName) ;
-
-  // Convert to vector datastore if needed
-  if (defaultStorageType==Tree) {
-    _dstore = tstore ;
-  } else if (defaultStorageType==Vector) {
-    RooVectorDataStore* vstore = new RooVectorDataStore(name,title,_vars,wgtVarName) ;
+  // Read the branches directly into a vector datastore if possible
+  RooVectorDataStore* vstore(0) ;
+  if (defaultStorageType==Vector) {
+    vstore = new RooVectorDataStore(name,title,_vars,wgtVarName) ;
+    if (!vstore->loadValues(intree,&cutVar)) {
+      delete vstore ;
+      vstore = 0 ;
+    }
+  }
+
+  if (vstore) {
     _dstore = vstore ;
-    _dstore->append(*tstore) ;
-    delete tstore ;
   } else {
-    _dstore = 0 ;
+    // Create tree version of datastore 
+    RooTreeDataStore* tstore = new RooTreeDataStore(name,title,_vars,*intree,cutVar,wgtVarName) ;
+
+    // Convert to vector datastore if needed
+    if (defaultStorageType==Tree) {
+      _dstore = tstore ;
+    } else if (defaultStorageType==Vector) {
+      vstore = new RooVectorDataStore(name,title,_vars,wgtVarName) ;
+      _dstore = vstore ;
+      _dstore->append(*tstore) ;
+      delete tstore ;
+    } else {
+      _dstore = 0 ;
+    }
   }
   
   appendToDir(this,kTRUE) ;
@@ -801,19 +815,40 @@ RooDataSet::RooDataSet(const char *name, const char *title, TTree *intree,
 		       const RooArgSet& vars, const char *selExpr, const char* wgtVarName) :
   RooAbsData(name,title,vars)
 {
-  // Create tree version of datastore 
-  RooTreeDataStore* tstore = new RooTreeDataStore(name,title,_vars,*intree,selExpr,wgtVarName) ;
-
-  // Convert to vector datastore if needed
-  if (defaultStorageType==Tree) {
-    _dstore = tstore ;
-  } else if (defaultStorageType==Vector) {
-    RooVectorDataStore* vstore = new RooVectorDataStore(name,title,_vars,wgtVarName) ;
+  // Read the branches directly into a vector datastore if possible
+  RooVectorDataStore* vstore(0) ;
+  if (defaultStorageType==Vector) {
+    vstore = new RooVectorDataStore(name,title,_vars,wgtVarName) ;
+    Bool_t loaded ;
+    if (selExpr && *selExpr) {
+      RooFormulaVar select(selExpr,selExpr,_vars) ;
+      loaded = vstore->loadValues(intree,&select) ;
+    } else {
+      loaded = vstore->loadValues(intree) ;
+    }
+    if (!loaded) {
+      delete vstore ;
+      vstore = 0 ;
+    }
+  }
+
+  if (vstore) {
     _dstore = vstore ;
-    _dstore->append(*tstore) ;
-    delete tstore ;
   } else {
-    _dstore = 0 ;
+    // Create tree version of datastore 
+    RooTreeDataStore* tstore = new RooTreeDataStore(name,title,_vars,*intree,selExpr,wgtVarName) ;
+
+    // Convert to vector datastore if needed
+    if (defaultStorageType==Tree) {
+      _dstore = tstore ;
+    } else if (defaultStorageType==Vector) {
+      vstore = new RooVectorDataStore(name,title,_vars,wgtVarName) ;
+      _dstore = vstore ;
+      _dstore->append(*tstore) ;
+      delete tstore ;
+    } else {
+      _dstore = 0 ;
+    }
   }
 
   appendToDir(this,kTRUE) ;
@@ -1323,6 +1358,27 @@ RooArgSet* RooDataSet::addColumns(const RooArgList& varList)
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add columns of real values which are already calculated: the values of
+/// the i-th variable of 'varList' for all data points are taken from
+/// values[i], which is left empty. This is only supported if the data is
+/// stored in a RooVectorDataStore, zero is returned otherwise. See
+/// RooVectorDataStore::addRealColumns()
+
+RooArgSet* RooDataSet::addRealColumns(const RooArgList& varList, std::vector<std::vector<Double_t> >& values)
+{
+  checkInit() ;
+  RooVectorDataStore* vstore = dynamic_cast<RooVectorDataStore*>(_dstore) ;
+  if (!vstore) return 0 ;
+  RooArgSet* ret = vstore->addRealColumns(varList,values) ;
+  if (!ret) return 0 ;
+  _vars.addOwned(*ret) ;
+  initialize(_wgtVar?_wgtVar->GetName():0) ;
+  return ret ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Create a TH2F histogram of the distribution of the specified variable
 /// using this dataset. Apply any cuts to select which events are used.
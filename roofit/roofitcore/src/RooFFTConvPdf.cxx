@@ -119,13 +119,125 @@
 #include "RooGlobalFunc.h"
 #include "RooLinearVar.h"
 #include "RooConstVar.h"
+#include "RooAbsCategory.h"
 #include "TClass.h"
 #include "TSystem.h"
+#include "TVirtualMutex.h"
+#include "RConfigure.h"
+
+#ifdef R__USE_IMT
+#include "TROOT.h"
+#include "tbb/parallel_for.h"
+#include <thread>
+#endif
+
+#include <algorithm>
 
 using namespace std ;
 
 ClassImp(RooFFTConvPdf) 
 
+namespace {
+
+  // Real to complex and complex to real FFT plans of a given size
+  struct FFTPlans {
+    FFTPlans() : r2c(0), c2r(0) {}
+    TVirtualFFT* r2c ;
+    TVirtualFFT* c2r ;
+  } ;
+
+  // Idle FFT plans by size, shared by all instances. The plans are never
+  // deleted, so that they can be reused by all convolutions of equal size.
+  TVirtualMutex* gFFTPlansMutex = 0 ;
+  std::multimap<Int_t,FFTPlans>& idlePlans()
+  {
+    static std::multimap<Int_t,FFTPlans>* plans = new std::multimap<Int_t,FFTPlans> ;
+    return *plans ;
+  }
+
+  // Take a set of plans of size n from the idle plans, or create it. The
+  // caller has exclusive use of it until it is released.
+  FFTPlans acquirePlans(Int_t n)
+  {
+    R__LOCKGUARD2(gFFTPlansMutex) ;
+    std::multimap<Int_t,FFTPlans>::iterator iter = idlePlans().find(n) ;
+    if (iter!=idlePlans().end()) {
+      FFTPlans plans = iter->second ;
+      idlePlans().erase(iter) ;
+      return plans ;
+    }
+    FFTPlans plans ;
+    plans.r2c = TVirtualFFT::FFT(1, &n, "R2CK") ;
+    plans.c2r = TVirtualFFT::FFT(1, &n, "C2RK") ;
+    return plans ;
+  }
+
+  void releasePlans(Int_t n, const FFTPlans& plans)
+  {
+    R__LOCKGUARD2(gFFTPlansMutex) ;
+    idlePlans().insert(std::make_pair(n,plans)) ;
+  }
+
+  // Fill 'spectrum' with the real and imaginary parts of the n/2+1 complex
+  // coefficients of the transform of 'input'
+  void forwardTransform(Int_t n, const std::vector<Double_t>& input, std::vector<Double_t>& spectrum, TVirtualFFT* r2c)
+  {
+    r2c->SetPoints(&input[0]) ;
+    r2c->Transform() ;
+    spectrum.resize(2*(n/2+1)) ;
+    for (Int_t i=0 ; i<n/2+1 ; i++) {
+      r2c->GetPointComplex(i,spectrum[2*i],spectrum[2*i+1]) ;
+    }
+  }
+
+  // Convolve two samplings of size n through the product of their spectra.
+  // The spectrum of an input with an empty sampling is reused as is.
+  void convolveSlice(Int_t n, const std::vector<Double_t>& input1, std::vector<Double_t>& spectrum1,
+		     const std::vector<Double_t>& input2, std::vector<Double_t>& spectrum2,
+		     std::vector<Double_t>& output, const FFTPlans& plans)
+  {
+    if (!input1.empty()) forwardTransform(n,input1,spectrum1,plans.r2c) ;
+    if (!input2.empty()) forwardTransform(n,input2,spectrum2,plans.r2c) ;
+
+    // Loop over first half +1 of complex output results, multiply 
+    // and set as input of reverse transform
+    for (Int_t i=0 ; i<n/2+1 ; i++) {
+      Double_t re1 = spectrum1[2*i], im1 = spectrum1[2*i+1] ;
+      Double_t re2 = spectrum2[2*i], im2 = spectrum2[2*i+1] ;
+      Double_t re = re1*re2 - im1*im2 ;
+      Double_t im = re1*im2 + re2*im1 ;
+      TComplex t(re,im) ;
+      plans.c2r->SetPointComplex(i,t) ;
+    }
+
+    // Reverse Complex->Real FFT transform product
+    plans.c2r->Transform() ;
+
+    output.resize(n) ;
+    for (Int_t j=0 ; j<n ; j++) {
+      output[j] = plans.c2r->GetPointReal(j) ;
+    }
+  }
+
+  // Current values of the parameters of 'pdf' for observables 'obs'
+  void paramValues(const RooAbsPdf& pdf, const RooArgSet& obs, std::vector<Double_t>& vals)
+  {
+    vals.clear() ;
+    RooArgSet* params = pdf.getParameters(obs) ;
+    RooFIter iter = params->fwdIterator() ;
+    RooAbsArg* arg ;
+    while((arg=iter.next())) {
+      if (RooAbsReal* real = dynamic_cast<RooAbsReal*>(arg)) {
+	vals.push_back(real->getVal()) ;
+      } else if (RooAbsCategory* cat = dynamic_cast<RooAbsCategory*>(arg)) {
+	vals.push_back(cat->getIndex()) ;
+      }
+    }
+    delete params ;
+  }
+
+}
+
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -247,7 +359,7 @@ RooFFTConvPdf::PdfCacheElem* RooFFTConvPdf::createCache(const RooArgSet* nset) c
 
 RooFFTConvPdf::FFTCacheElem::FFTCacheElem(const RooFFTConvPdf& self, const RooArgSet* nsetIn) : 
   PdfCacheElem(self,nsetIn),
-  fftr2c1(0),fftr2c2(0),fftc2r(0) 
+  reuse1(kFALSE),reuse2(kFALSE),nBins(0),nBins2(0),binShift1(0)
 {
   RooAbsPdf* clonePdf1 = (RooAbsPdf*) self._pdf1.arg().cloneTree() ;
   RooAbsPdf* clonePdf2 = (RooAbsPdf*) self._pdf2.arg().cloneTree() ;
@@ -362,10 +474,6 @@ RooArgList RooFFTConvPdf::FFTCacheElem::containedArgs(Action a)
 
 RooFFTConvPdf::FFTCacheElem::~FFTCacheElem() 
 { 
-  delete fftr2c1 ; 
-  delete fftr2c2 ; 
-  delete fftc2r ; 
-
   delete pdf1Clone ;
   delete pdf2Clone ;
 
@@ -379,13 +487,20 @@ RooFFTConvPdf::FFTCacheElem::~FFTCacheElem()
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill the contents of the cache the FFT convolution output
+///
+/// All slices of the cache are first sampled, then convolved, in parallel
+/// if implicit multi-threading is enabled, and finally stored. The spectrum of
+/// an input p.d.f. whose parameters did not change since the previous fill
+/// is reused, so that e.g. a resolution model with fixed parameters is
+/// sampled and transformed only once.
 
 void RooFFTConvPdf::fillCacheObject(RooAbsCachedPdf::PdfCacheElem& cache) const 
 {
+  FFTCacheElem& aux = (FFTCacheElem&)cache ;
   RooDataHist& cacheHist = *cache.hist() ;
   
-  ((FFTCacheElem&)cache).pdf1Clone->setOperMode(ADirty,kTRUE) ;
-  ((FFTCacheElem&)cache).pdf2Clone->setOperMode(ADirty,kTRUE) ;
+  aux.pdf1Clone->setOperMode(ADirty,kTRUE) ;
+  aux.pdf2Clone->setOperMode(ADirty,kTRUE) ;
 
   // Determine if there other observables than the convolution observable in the cache
   RooArgSet otherObs ;
@@ -399,20 +514,12 @@ void RooFFTConvPdf::fillCacheObject(RooAbsCachedPdf::PdfCacheElem& cache) const
 
   //cout << "RooFFTConvPdf::fillCacheObject() otherObs = " << otherObs << endl ;
 
-  // Handle trivial scenario -- no other observables
-  if (otherObs.getSize()==0) {
-    fillCacheSlice((FFTCacheElem&)cache,RooArgSet()) ;
-    return ;
-  }
-
-  // Handle cases where there are other cache slices
-  // Iterator over available slice positions and fill each
-
   // Determine number of bins for each slice position observable
   Int_t n = otherObs.getSize() ;
   Int_t* binCur = new Int_t[n+1] ;
   Int_t* binMax = new Int_t[n+1] ;
   Int_t curObs = 0 ;
+  Int_t nSlices = 1 ;
 
   RooAbsLValue** obsLV = new RooAbsLValue*[n] ;
   TIterator* iter = otherObs.createIterator() ;
@@ -424,40 +531,82 @@ void RooFFTConvPdf::fillCacheObject(RooAbsCachedPdf::PdfCacheElem& cache) const
     binCur[i] = 0 ;
     // coverity[FORWARD_NULL]
     binMax[i] = lvarg->numBins(binningName())-1 ;    
+    nSlices *= binMax[i]+1 ;
     i++ ;
   }
   delete iter ;
 
-  Bool_t loop(kTRUE) ;
-  while(loop) {
-    // Set current slice position
-    for (Int_t j=0 ; j<n ; j++) { obsLV[j]->setBin(binCur[j],binningName()) ; }
+  // Check which input spectra of the previous fill can be reused. At least
+  // one input is always sampled again.
+  std::vector<Double_t> vals1, vals2 ;
+  paramValues(*aux.pdf1Clone,*cacheHist.get(),vals1) ;
+  paramValues(*aux.pdf2Clone,*cacheHist.get(),vals2) ;
+  Bool_t sameSlices = (Int_t(aux.spectrum1.size())==nSlices && Int_t(aux.spectrum2.size())==nSlices) ;
+  aux.reuse2 = sameSlices && vals2==aux.params2Vals ;
+  aux.reuse1 = sameSlices && vals1==aux.params1Vals && !aux.reuse2 ;
+  aux.params1Vals.swap(vals1) ;
+  aux.params2Vals.swap(vals2) ;
+
+  aux.spectrum1.resize(nSlices) ;
+  aux.spectrum2.resize(nSlices) ;
+  aux.input1.resize(nSlices) ;
+  aux.input2.resize(nSlices) ;
+  aux.output.resize(nSlices) ;
+
+  // Sample all slices. Iterate over available slice positions and fill each.
+  for (Int_t pass=0 ; pass<2 ; pass++) {
+
+    if (pass==1) {
+      // Convolve all slices, then store them in a second iteration
+      transformCacheSlices(aux) ;
+    }
+
+    Bool_t loop(kTRUE) ;
+    Int_t slice(0) ;
+    curObs = 0 ;
+    for (Int_t j=0 ; j<n ; j++) { binCur[j] = 0 ; }
+    while(loop) {
+      // Set current slice position
+      for (Int_t j=0 ; j<n ; j++) { obsLV[j]->setBin(binCur[j],binningName()) ; }
 
 //     cout << "filling slice: bin of obsLV[0] = " << obsLV[0]->getBin() << endl ;
 
-    // Fill current slice
-    fillCacheSlice((FFTCacheElem&)cache,otherObs) ;
+      if (pass==0) {
+	scanCacheSlice(aux,otherObs,slice) ;
+      } else {
+	storeCacheSlice(aux,otherObs,slice) ;
+      }
+      slice++ ;
+
+      // Handle trivial scenario -- no other observables
+      if (n==0) break ;
 
-    // Determine which iterator to increment
-    while(binCur[curObs]==binMax[curObs]) {
+      // Determine which iterator to increment
+      while(binCur[curObs]==binMax[curObs]) {
       
-      // Reset current iterator and consider next iterator ;
-      binCur[curObs]=0 ;      
-      curObs++ ;
-
-      // master termination condition
-      if (curObs==n) {
-	loop=kFALSE ;
-	break ;
+	// Reset current iterator and consider next iterator ;
+	binCur[curObs]=0 ;      
+	curObs++ ;
+
+	// master termination condition
+	if (curObs==n) {
+	  loop=kFALSE ;
+	  break ;
+	}
       }
-    }
 
-    // Increment current iterator
-    binCur[curObs]++ ;
-    curObs=0 ;      
+      // Increment current iterator
+      binCur[curObs]++ ;
+      curObs=0 ;      
     
+    }
   }
 
+  // Release sampling arrays
+  std::vector<std::vector<Double_t> >().swap(aux.input1) ;
+  std::vector<std::vector<Double_t> >().swap(aux.input2) ;
+  std::vector<std::vector<Double_t> >().swap(aux.output) ;
+
   delete[] obsLV ;
   delete[] binMax ;
   delete[] binCur ;
@@ -466,9 +615,10 @@ void RooFFTConvPdf::fillCacheObject(RooAbsCachedPdf::PdfCacheElem& cache) const
 
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Fill a slice of cachePdf with the output of the FFT convolution calculation
+/// Sample both input p.d.f.s for the given slice of the cache, except those
+/// whose spectrum of the previous fill is reused
 
-void RooFFTConvPdf::fillCacheSlice(FFTCacheElem& aux, const RooArgSet& slicePos) const 
+void RooFFTConvPdf::scanCacheSlice(FFTCacheElem& aux, const RooArgSet& slicePos, Int_t slice) const 
 {
   // Extract histogram that is the basis of the RooHistPdf
   RooDataHist& cacheHist = *aux.hist() ;
@@ -484,48 +634,71 @@ void RooFFTConvPdf::fillCacheSlice(FFTCacheElem& aux, const RooArgSet& slicePos)
   //
   // 
 
-  Int_t N,N2,binShift1,binShift2 ;
+  Int_t binShift2 ;
   
   RooRealVar* histX = (RooRealVar*) cacheHist.get()->find(_x.arg().GetName()) ;
   if (_bufStrat==Extend) histX->setBinning(*aux.scanBinning) ;
-  Double_t* input1 = scanPdf((RooRealVar&)_x.arg(),*aux.pdf1Clone,cacheHist,slicePos,N,N2,binShift1,_shift1) ;
-  Double_t* input2 = scanPdf((RooRealVar&)_x.arg(),*aux.pdf2Clone,cacheHist,slicePos,N,N2,binShift2,_shift2) ;
+  if (!aux.reuse1) {
+    Double_t* input1 = scanPdf((RooRealVar&)_x.arg(),*aux.pdf1Clone,cacheHist,slicePos,aux.nBins,aux.nBins2,aux.binShift1,_shift1) ;
+    aux.input1[slice].assign(input1,input1+aux.nBins2) ;
+    delete[] input1 ;
+  }
+  if (!aux.reuse2) {
+    Double_t* input2 = scanPdf((RooRealVar&)_x.arg(),*aux.pdf2Clone,cacheHist,slicePos,aux.nBins,aux.nBins2,binShift2,_shift2) ;
+    aux.input2[slice].assign(input2,input2+aux.nBins2) ;
+    delete[] input2 ;
+  }
   if (_bufStrat==Extend) histX->setBinning(*aux.histBinning) ;
+}
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Convolve the samplings of all slices of the cache. The slices are
+/// distributed over the threads of the implicit multi-threading pool if it
+/// is enabled, each with its own FFT plans.
 
+void RooFFTConvPdf::transformCacheSlices(FFTCacheElem& aux) const
+{
+  const Int_t nSlices = aux.output.size() ;
+  const Int_t N2 = aux.nBins2 ;
+
+#ifdef R__USE_IMT
+  if (nSlices>1 && ROOT::IsImplicitMTEnabled()) {
+    // Plans are created in this thread, only their execution is concurrent
+    const Int_t nChunks = std::min(nSlices,(Int_t)std::max(1u,std::thread::hardware_concurrency())) ;
+    std::vector<FFTPlans> plans(nChunks) ;
+    for (Int_t c=0 ; c<nChunks ; c++) plans[c] = acquirePlans(N2) ;
+
+    tbb::parallel_for(0, nChunks, [&](Int_t c) {
+      for (Int_t slice=c*nSlices/nChunks ; slice<(c+1)*nSlices/nChunks ; slice++) {
+	convolveSlice(N2,aux.input1[slice],aux.spectrum1[slice],aux.input2[slice],aux.spectrum2[slice],aux.output[slice],plans[c]) ;
+      }
+    }) ;
 
-  // Retrieve previously defined FFT transformation plans
-  if (!aux.fftr2c1) {
-    aux.fftr2c1 = TVirtualFFT::FFT(1, &N2, "R2CK");
-    aux.fftr2c2 = TVirtualFFT::FFT(1, &N2, "R2CK");
-    aux.fftc2r  = TVirtualFFT::FFT(1, &N2, "C2RK");
+    for (Int_t c=0 ; c<nChunks ; c++) releasePlans(N2,plans[c]) ;
+    return ;
   }
-  
-  // Real->Complex FFT Transform on p.d.f. 1 sampling
-  aux.fftr2c1->SetPoints(input1);
-  aux.fftr2c1->Transform();
-
-  // Real->Complex FFT Transform on p.d.f 2 sampling
-  aux.fftr2c2->SetPoints(input2);
-  aux.fftr2c2->Transform();
-
-  // Loop over first half +1 of complex output results, multiply 
-  // and set as input of reverse transform
-  for (Int_t i=0 ; i<N2/2+1 ; i++) {
-    Double_t re1,re2,im1,im2 ;
-    aux.fftr2c1->GetPointComplex(i,re1,im1) ;
-    aux.fftr2c2->GetPointComplex(i,re2,im2) ;
-    Double_t re = re1*re2 - im1*im2 ;
-    Double_t im = re1*im2 + re2*im1 ;
-    TComplex t(re,im) ;
-    aux.fftc2r->SetPointComplex(i,t) ;
+#endif
+
+  FFTPlans plans = acquirePlans(N2) ;
+  for (Int_t slice=0 ; slice<nSlices ; slice++) {
+    convolveSlice(N2,aux.input1[slice],aux.spectrum1[slice],aux.input2[slice],aux.spectrum2[slice],aux.output[slice],plans) ;
   }
+  releasePlans(N2,plans) ;
+}
 
-  // Reverse Complex->Real FFT transform product
-  aux.fftc2r->Transform() ;
 
-  Int_t totalShift = binShift1 + (N2-N)/2 ;
+////////////////////////////////////////////////////////////////////////////////
+/// Store the convolution output of the given slice in the cache histogram
+
+void RooFFTConvPdf::storeCacheSlice(FFTCacheElem& aux, const RooArgSet& slicePos, Int_t slice) const 
+{
+  RooDataHist& cacheHist = *aux.hist() ;
+  const Int_t N = aux.nBins ;
+  const Int_t N2 = aux.nBins2 ;
+  const std::vector<Double_t>& output = aux.output[slice] ;
+
+  Int_t totalShift = aux.binShift1 + (N2-N)/2 ;
 
   // Store FFT result in cache
 
@@ -538,16 +711,11 @@ void RooFFTConvPdf::fillCacheSlice(FFTCacheElem& aux, const RooArgSet& slicePos)
     while (j>=N2) j-= N2 ;
 
     iter->Next() ;
-    cacheHist.set(aux.fftc2r->GetPointReal(j)) ;    
+    cacheHist.set(output[j]) ;    
   }
   delete iter ;
 
   // cacheHist.dump2() ;
-
-  // Delete input arrays
-  delete[] input1 ;
-  delete[] input2 ;
-
 }
 
 
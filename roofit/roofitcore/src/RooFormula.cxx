@@ -26,6 +26,16 @@ or by list ordinal postion ('@0,@1,...'). State information
 of RooAbsCategories can be accessed used the '::' operator,
 e.g. 'tagCat::Kaon' will resolve to the numerical value of
 the 'Kaon' state of the RooAbsCategory object named tagCat.
+
+The expression is parsed by ROOT::v5::TFormula, which resolves the references
+to the RooAbsArg objects into slots. At the first evaluation, the program
+produced by the parser is translated into C++ and compiled by the interpreter,
+so that the evaluation does not go through the opcode interpreter of
+ROOT::v5::TFormula anymore. Expressions which cannot be translated (e.g.
+string operations or predefined functions like gaus) are still evaluated
+by ROOT::v5::TFormula. The compilation can be disabled globally with
+RooFormula::setJITEnabled(kFALSE). The values of the slots can also be provided
+directly for many points with evalBatch().
 **/
 
 #include "RooFit.h"
@@ -36,23 +46,39 @@ the 'Kaon' state of the RooAbsCategory object named tagCat.
 #include "TROOT.h"
 #include "TClass.h"
 #include "TObjString.h"
+#include "TInterpreter.h"
+#include "TMethodCall.h"
+#include "TVirtualMutex.h"
+#include "TMath.h"
 #include "RooFormula.h"
 #include "RooAbsReal.h"
 #include "RooAbsCategory.h"
 #include "RooArgList.h"
 #include "RooMsgService.h"
 #include "RooTrace.h"
+#include "RooVectorDataStore.h"
+
+#include <map>
+#include <functional>
+#include <algorithm>
 
 using namespace std;
 
 ClassImp(RooFormula)
 
+Bool_t RooFormula::_jitEnabled = kTRUE ;
+
+namespace {
+  // Compiled functions, by translated formula program. A failure is also stored, not to try again
+  std::map<std::string,std::pair<void*,void*> > gJITFunctions ;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Default constructor
 /// coverity[UNINIT_CTOR]
 
-RooFormula::RooFormula() : ROOT::v5::TFormula(), _nset(0)
+RooFormula::RooFormula() : ROOT::v5::TFormula(), _nset(0), _jitTried(kFALSE), _jitFunc(0), _jitBatchFunc(0), _slotOverride(0)
 {
 }
 
@@ -61,7 +87,7 @@ RooFormula::RooFormula() : ROOT::v5::TFormula(), _nset(0)
 /// Constructor with expression string and list of RooAbsArg variables
 
 RooFormula::RooFormula(const char* name, const char* formula, const RooArgList& list) : 
-  ROOT::v5::TFormula(), _isOK(kTRUE), _compiled(kFALSE)
+  ROOT::v5::TFormula(), _isOK(kTRUE), _compiled(kFALSE), _jitTried(kFALSE), _jitFunc(0), _jitBatchFunc(0), _slotOverride(0)
 {
   SetName(name) ;
   SetTitle(formula) ;
@@ -87,7 +113,8 @@ RooFormula::RooFormula(const char* name, const char* formula, const RooArgList&
 /// Copy constructor
 
 RooFormula::RooFormula(const RooFormula& other, const char* name) : 
-  ROOT::v5::TFormula(), RooPrintable(other), _isOK(other._isOK), _compiled(kFALSE) 
+  ROOT::v5::TFormula(), RooPrintable(other), _isOK(other._isOK), _compiled(kFALSE), 
+  _jitTried(kFALSE), _jitFunc(0), _jitBatchFunc(0), _slotOverride(0)
 {
   SetName(name?name:other.GetName()) ;
   SetTitle(other.GetTitle()) ;
@@ -112,6 +139,7 @@ Bool_t RooFormula::reCompile(const char* newFormula)
 {
   fNval=0 ;
   _useList.Clear() ;  
+  jitReset() ;
 
   TString oldFormula=GetTitle() ;
   if (Compile(newFormula)) {
@@ -247,10 +275,401 @@ Double_t RooFormula::eval(const RooArgSet* nset)
   // Pass current dataset pointer to DefinedValue
   _nset = (RooArgSet*) nset ;
 
+  if (!_jitTried) jitCompile() ;
+  if (_jitFunc) {
+    // Evaluate the slots and pass them to the compiled function
+    Int_t nslot = _useList.GetSize() ;
+    for (Int_t i=0 ; i<nslot ; i++) {
+      _slotValues[i] = DefinedValue(i) ;
+    }
+    Double_t result(0) ;
+    const Double_t* values = _slotValues.data() ;
+    void* args[1] = { &values } ;
+    (*(TInterpreter::CallFuncIFacePtr_t::Generic_t)_jitFunc)(0,1,args,&result) ;
+    return result ;
+  }
+
   return EvalPar(0,0) ; 
 }
 
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate formula for n points, given the values of its slots instead of
+/// those of the slot objects: slotValues[k][i] is the value of slot k
+/// (see getSlotArg() and getSlotLabel()) for point i. The values are
+/// written to result, which must have room for n values.
+
+void RooFormula::evalBatch(Int_t n, const Double_t* const* slotValues, Double_t* result)
+{
+  if (!_compiled) {
+    _isOK = !Compile() ;
+    _compiled = kTRUE ;
+  }
+
+  if (!_isOK) {
+    coutE(Eval) << "RooFormula::evalBatch(" << GetName() << "): Formula doesn't compile: " << GetTitle() << endl ;
+    for (Int_t i=0 ; i<n ; i++) result[i] = 0. ;
+    return ;
+  }
+
+  if (!_jitTried) jitCompile() ;
+  if (_jitBatchFunc) {
+    void* args[3] = { &n, &slotValues, &result } ;
+    (*(TInterpreter::CallFuncIFacePtr_t::Generic_t)_jitBatchFunc)(0,3,args,0) ;
+    return ;
+  }
+
+  // Interpret formula, with slot values taken from given arrays
+  Int_t nslot = _useList.GetSize() ;
+  std::vector<Double_t> values(nslot>0?nslot:1) ;
+  _slotOverride = values.data() ;
+  for (Int_t i=0 ; i<n ; i++) {
+    for (Int_t k=0 ; k<nslot ; k++) values[k] = slotValues[k][i] ;
+    result[i] = EvalPar(0,0) ;
+  }
+  _slotOverride = 0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate formula for the events [begin,end) of 'data', the values of the
+/// real valued slots being obtained with their getValBatch() using
+/// normalization set 'nset'. Returns kFALSE if a slot does not support batch
+/// evaluation, or is the index of a category that depends on the observables
+/// of 'data'.
+
+Bool_t RooFormula::evalBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data, const RooArgSet* nset)
+{
+  if (!_compiled) {
+    _isOK = !Compile() ;
+    _compiled = kTRUE ;
+  }
+  if (!_isOK) return kFALSE ;
+
+  const Int_t n = end-begin ;
+  Int_t nslot = _useList.GetSize() ;
+  std::vector<std::vector<Double_t> > columns(nslot) ;
+  std::vector<const Double_t*> slots(nslot>0?nslot:1) ;
+  _nset = (RooArgSet*) nset ;
+  for (Int_t k=0 ; k<nslot ; k++) {
+    columns[k].resize(n>0?n:1) ;
+    RooAbsArg* arg = (RooAbsArg*)_useList.At(k) ;
+    if (!_useIsCat[k]) {
+      if (!((RooAbsReal*)arg)->getValBatch(&columns[k][0],begin,end,data,nset)) return kFALSE ;
+    } else {
+      if (((TObjString*)_labelList.At(k))->String().IsNull() && arg->dependsOn(*data.get())) return kFALSE ;
+      std::fill(columns[k].begin(),columns[k].end(),DefinedValue(k)) ;
+    }
+    slots[k] = &columns[k][0] ;
+  }
+
+  evalBatch(n,&slots[0],output) ;
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return label of category state which fills given slot, or an empty string
+/// if the slot is filled with the value of the object
+
+const char* RooFormula::getSlotLabel(Int_t slot) const
+{
+  TObjString* label = (TObjString*) _labelList.At(slot) ;
+  return label ? label->GetName() : "" ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Enable or disable globally the compilation of formula expressions
+/// by the interpreter. Formulas already compiled are not affected.
+
+void RooFormula::setJITEnabled(Bool_t flag)
+{
+  _jitEnabled = flag ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if formula expressions are compiled by the interpreter
+
+Bool_t RooFormula::isJITEnabled()
+{
+  return _jitEnabled ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Forget the compiled functions, after a change of the formula program
+
+void RooFormula::jitReset()
+{
+  _jitTried = kFALSE ;
+  _jitFunc = 0 ;
+  _jitBatchFunc = 0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Look for the functions evaluating the formula program, and translate
+/// and compile them with the interpreter if they do not exist yet. If the
+/// program cannot be translated, the formula is interpreted by ROOT::v5::TFormula
+
+void RooFormula::jitCompile()
+{
+  _jitTried = kTRUE ;
+  _jitFunc = 0 ;
+  _jitBatchFunc = 0 ;
+  if (!_jitEnabled || !gInterpreter) return ;
+
+  std::string body ;
+  Int_t depth(0) ;
+  if (!jitCode(body,depth)) {
+    cxcoutD(Eval) << "RooFormula::jitCompile(" << GetName() << "): expression " << GetTitle() 
+		  << " is interpreted by ROOT::v5::TFormula" << endl ;
+    return ;
+  }
+
+  // The translated program only depends on the expression structure and its
+  // constants, so that copies of a formula share the compiled functions
+  Int_t nslot = _useList.GetSize() ;
+  std::string key = Form("%d:%d:",nslot,depth) + body ;
+
+  R__LOCKGUARD2(gROOTMutex) ;
+  std::map<std::string,std::pair<void*,void*> >::iterator it = gJITFunctions.find(key) ;
+  if (it==gJITFunctions.end()) {
+    std::string name = Form("RooFormula__jit%zu",std::hash<std::string>()(key)) ;
+    std::string code = "#include \"TMath.h\"\n#include <cmath>\n" ;
+    code += "Double_t " + name + "(const Double_t* x) {\n  Double_t t0(0)" ;
+    for (Int_t d=1 ; d<depth ; d++) code += Form(", t%d(0)",d) ;
+    code += " ;\n" + body + "  return t0 ;\n}\n" ;
+    code += "void " + name + "_batch(Int_t n, const Double_t* const* slots, Double_t* r) {\n" ;
+    code += Form("  Double_t x[%d] ;\n",nslot>0?nslot:1) ;
+    code += Form("  for (Int_t i=0 ; i<n ; i++) {\n    for (Int_t k=0 ; k<%d ; k++) x[k] = slots[k][i] ;\n",nslot) ;
+    code += "    r[i] = " + name + "(x) ;\n  }\n}\n" ;
+
+    void* func(0) ;
+    void* batchFunc(0) ;
+    if (gInterpreter->Declare(code.c_str())) {
+      TMethodCall method ;
+      method.InitWithPrototype(name.c_str(),"const Double_t*") ;
+      TMethodCall batchMethod ;
+      batchMethod.InitWithPrototype((name+"_batch").c_str(),"Int_t,const Double_t* const*,Double_t*") ;
+      if (method.IsValid() && batchMethod.IsValid()) {
+	func = (void*) gInterpreter->CallFunc_IFacePtr(method.GetCallFunc()).fGeneric ;
+	batchFunc = (void*) gInterpreter->CallFunc_IFacePtr(batchMethod.GetCallFunc()).fGeneric ;
+      }
+    }
+    if (!func || !batchFunc) {
+      coutW(Eval) << "RooFormula::jitCompile(" << GetName() << "): compilation of expression " << GetTitle() 
+		  << " failed, it is interpreted by ROOT::v5::TFormula" << endl ;
+      func = 0 ;
+      batchFunc = 0 ;
+    }
+    it = gJITFunctions.insert(std::make_pair(key,std::make_pair(func,batchFunc))).first ;
+  }
+
+  _jitFunc = it->second.first ;
+  _jitBatchFunc = it->second.second ;
+  _slotValues.assign(nslot>0?nslot:1,0.) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Translate the program of operators produced by ROOT::v5::TFormula into
+/// the body of a C++ function of the slot values x[], keeping the exact
+/// semantics of ROOT::v5::TFormula::EvalParOld(). Each level of the evaluation
+/// stack becomes a local variable t<level>, of which depth are needed, and
+/// jumps of conditional expressions become gotos. Return false if the program
+/// uses an operator which has no translation.
+
+Bool_t RooFormula::jitCode(std::string& body, Int_t& depth) const
+{
+  body.clear() ;
+  depth = 0 ;
+  if (fNoper<=0) return kFALSE ;
+
+  // Find the targets of the jumps: an operator at i jumping to j continues at j+1
+  std::vector<Int_t> target(fNoper+1,0) ;
+  for (Int_t i=0 ; i<fNoper ; i++) {
+    Int_t action = GetAction(i) ;
+    Int_t param = GetActionParam(i) ;
+    Int_t to(-1) ;
+    if (action==kJump || action==kJumpIf) {
+      to = param+1 ;
+    } else if (action==kBoolOptimize) {
+      to = i+param/10+1 ;
+    }
+    if (to>=0) {
+      if (to<=i || to>fNoper) return kFALSE ;
+      target[to] = 1 ;
+    }
+  }
+
+  // Stack level at the jump targets, -1 if not yet known
+  std::vector<Int_t> level(fNoper+1,-1) ;
+  Int_t pos(0) ;
+  Bool_t reachable(kTRUE) ;
+
+  for (Int_t i=0 ; i<=fNoper ; i++) {
+
+    // Merge the stack levels of the paths reaching this operator
+    if (target[i]) {
+      if (!reachable) {
+	if (level[i]<0) return kFALSE ;
+	pos = level[i] ;
+      } else if (level[i]>=0 && level[i]!=pos) {
+	return kFALSE ;
+      }
+      reachable = kTRUE ;
+      body += Form("L%d: ;\n",i) ;
+    } else if (!reachable) {
+      return kFALSE ;
+    }
+    if (i==fNoper) break ;
+
+    Int_t action = GetAction(i) ;
+    Int_t param = GetActionParam(i) ;
+
+    // Operands: a is the top of the stack after the operator is applied, b the popped one if any
+    TString a, b ;
+    switch (action) {
+    case kAdd: case kSubstract: case kMultiply: case kDivide: case kModulo:
+    case katan2: case kfmod: case kpow: case kmin: case kmax:
+    case kAnd: case kOr: case kEqual: case kNotEqual: case kLess: case kGreater:
+    case kLessThan: case kGreaterThan:
+    case kBitAnd: case kBitOr: case kLeftShift: case kRightShift:
+      if (pos<2) return kFALSE ;
+      pos-- ;
+      break ;
+    case kConstant: case kDefinedVariable: case kpi:
+      pos++ ;
+      break ;
+    case kJumpIf:
+      if (pos<1) return kFALSE ;
+      pos-- ;
+      break ;
+    case kJump:
+      break ;
+    default:
+      if (pos<1) return kFALSE ;
+      break ;
+    }
+    if (pos>depth) depth = pos ;
+    a.Form("t%d",pos-1) ;
+    b.Form("t%d",pos) ;
+    const char* sa = a.Data() ;
+    const char* sb = b.Data() ;
+
+    TString line ;
+    switch (action) {
+    case kConstant: {
+      if (param>=fNconst || !TMath::Finite(fConst[param])) return kFALSE ;
+      line.Form("%s = %.17g ;",sa,fConst[param]) ;
+      break ;
+    }
+    case kDefinedVariable:
+      if (param>=_useList.GetSize()) return kFALSE ;
+      line.Form("%s = x[%d] ;",sa,param) ;
+      break ;
+    case kpi:
+      line.Form("%s = TMath::ACos(-1) ;",sa) ;
+      break ;
+
+    case kAdd: line.Form("%s += %s ;",sa,sb) ; break ;
+    case kSubstract: line.Form("%s -= %s ;",sa,sb) ; break ;
+    case kMultiply: line.Form("%s *= %s ;",sa,sb) ; break ;
+    case kDivide: line.Form("%s = (%s == 0) ? 0. : %s / %s ;",sa,sb,sa,sb) ; break ;
+    case kModulo: line.Form("%s = Double_t(Long64_t(%s) %% Long64_t(%s)) ;",sa,sa,sb) ; break ;
+    case katan2: line.Form("%s = TMath::ATan2(%s,%s) ;",sa,sa,sb) ; break ;
+    case kfmod: line.Form("%s = std::fmod(%s,%s) ;",sa,sa,sb) ; break ;
+    case kpow: line.Form("%s = TMath::Power(%s,%s) ;",sa,sa,sb) ; break ;
+    case kmin: line.Form("%s = TMath::Min(%s,%s) ;",sa,sa,sb) ; break ;
+    case kmax: line.Form("%s = TMath::Max(%s,%s) ;",sa,sa,sb) ; break ;
+    case kAnd: line.Form("%s = (%s != 0 && %s != 0) ? 1. : 0. ;",sa,sa,sb) ; break ;
+    case kOr: line.Form("%s = (%s != 0 || %s != 0) ? 1. : 0. ;",sa,sa,sb) ; break ;
+    case kEqual: line.Form("%s = (%s == %s) ? 1. : 0. ;",sa,sa,sb) ; break ;
+    case kNotEqual: line.Form("%s = (%s != %s) ? 1. : 0. ;",sa,sa,sb) ; break ;
+    case kLess: line.Form("%s = (%s < %s) ? 1. : 0. ;",sa,sa,sb) ; break ;
+    case kGreater: line.Form("%s = (%s > %s) ? 1. : 0. ;",sa,sa,sb) ; break ;
+    case kLessThan: line.Form("%s = (%s <= %s) ? 1. : 0. ;",sa,sa,sb) ; break ;
+    case kGreaterThan: line.Form("%s = (%s >= %s) ? 1. : 0. ;",sa,sa,sb) ; break ;
+    case kBitAnd: line.Form("%s = Int_t(%s) & Int_t(%s) ;",sa,sa,sb) ; break ;
+    case kBitOr: line.Form("%s = Int_t(%s) | Int_t(%s) ;",sa,sa,sb) ; break ;
+    case kLeftShift: line.Form("%s = Int_t(%s) << Int_t(%s) ;",sa,sa,sb) ; break ;
+    case kRightShift: line.Form("%s = Int_t(%s) >> Int_t(%s) ;",sa,sa,sb) ; break ;
+
+    case kcos: line.Form("%s = TMath::Cos(%s) ;",sa,sa) ; break ;
+    case ksin: line.Form("%s = TMath::Sin(%s) ;",sa,sa) ; break ;
+    case ktan: line.Form("%s = (TMath::Cos(%s) == 0) ? 0. : TMath::Tan(%s) ;",sa,sa,sa) ; break ;
+    case kacos: line.Form("%s = (TMath::Abs(%s) > 1) ? 0. : TMath::ACos(%s) ;",sa,sa,sa) ; break ;
+    case kasin: line.Form("%s = (TMath::Abs(%s) > 1) ? 0. : TMath::ASin(%s) ;",sa,sa,sa) ; break ;
+    case katan: line.Form("%s = TMath::ATan(%s) ;",sa,sa) ; break ;
+    case kcosh: line.Form("%s = TMath::CosH(%s) ;",sa,sa) ; break ;
+    case ksinh: line.Form("%s = TMath::SinH(%s) ;",sa,sa) ; break ;
+    case ktanh: line.Form("%s = (TMath::CosH(%s) == 0) ? 0. : TMath::TanH(%s) ;",sa,sa,sa) ; break ;
+    case kacosh: line.Form("%s = (%s < 1) ? 0. : TMath::ACosH(%s) ;",sa,sa,sa) ; break ;
+    case kasinh: line.Form("%s = TMath::ASinH(%s) ;",sa,sa) ; break ;
+    case katanh: line.Form("%s = (TMath::Abs(%s) > 1) ? 0. : TMath::ATanH(%s) ;",sa,sa,sa) ; break ;
+    case ksq: line.Form("%s = %s * %s ;",sa,sa,sa) ; break ;
+    case ksqrt: line.Form("%s = TMath::Sqrt(TMath::Abs(%s)) ;",sa,sa) ; break ;
+    case klog: line.Form("%s = (%s > 0) ? TMath::Log(%s) : 0. ;",sa,sa,sa) ; break ;
+    case klog10: line.Form("%s = (%s > 0) ? TMath::Log10(%s) : 0. ;",sa,sa,sa) ; break ;
+    case kexp: line.Form("%s = (%s < -700) ? 0. : (%s > 700) ? TMath::Exp(700) : TMath::Exp(%s) ;",sa,sa,sa,sa) ; break ;
+    case kabs: line.Form("%s = TMath::Abs(%s) ;",sa,sa) ; break ;
+    case ksign: line.Form("%s = (%s < 0) ? -1. : 1. ;",sa,sa) ; break ;
+    case kint: line.Form("%s = Double_t(Int_t(%s)) ;",sa,sa) ; break ;
+    case kSignInv: line.Form("%s = -%s ;",sa,sa) ; break ;
+    case kNot: line.Form("%s = (%s != 0) ? 0. : 1. ;",sa,sa) ; break ;
+
+    case kJump:
+      line.Form("goto L%d ;",param+1) ;
+      if (level[param+1]>=0 && level[param+1]!=pos) return kFALSE ;
+      level[param+1] = pos ;
+      reachable = kFALSE ;
+      break ;
+    case kJumpIf:
+      line.Form("if (!%s) goto L%d ;",sb,param+1) ;
+      if (level[param+1]>=0 && level[param+1]!=pos) return kFALSE ;
+      level[param+1] = pos ;
+      break ;
+    case kBoolOptimize: {
+      Int_t op = param%10 ;
+      Int_t to = i+param/10+1 ;
+      if (op==1) {
+	line.Form("if (!%s) { %s = 0. ; goto L%d ; }",sa,sa,to) ;
+      } else if (op==2) {
+	line.Form("if (%s) { %s = 1. ; goto L%d ; }",sa,sa,to) ;
+      } else {
+	break ;
+      }
+      if (level[to]>=0 && level[to]!=pos) return kFALSE ;
+      level[to] = pos ;
+      break ;
+    }
+
+    default:
+      // Parameters, variables, strings, random numbers, predefined and user functions
+      return kFALSE ;
+    }
+    if (line.Length()) {
+      body += "  " ;
+      body += line.Data() ;
+      body += "\n" ;
+    }
+  }
+
+  return pos==1 ;
+}
+
+
 Double_t
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -261,6 +680,7 @@ RooFormula::DefinedValue(Int_t code)
 {
   // Return current value for variable indicated by internal reference code
   if (code>=_useList.GetSize()) return 0 ;
+  if (_slotOverride) return _slotOverride[code] ;
 
   RooAbsArg* arg=(RooAbsArg*)_useList.At(code) ;
   if (_useIsCat[code]) {
@@ -130,6 +130,16 @@ Double_t RooFormulaVar::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate() for the events [begin,end) of 'data'
+
+Bool_t RooFormulaVar::evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const
+{
+  return formula().evalBatch(output,begin,end,data,_lastNSet) ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Check if given value is valid
 
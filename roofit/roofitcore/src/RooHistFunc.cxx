@@ -29,6 +29,8 @@ discrete dimensions and may have negative values
 
 #include "RooHistFunc.h"
 #include "RooDataHist.h"
+#include "RooVectorDataStore.h"
+#include "RooArgList.h"
 #include "RooMsgService.h"
 #include "RooRealVar.h"
 #include "RooCategory.h"
@@ -216,6 +218,62 @@ Double_t RooHistFunc::evaluate() const
   return ret ;
 }
 
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate() for the non-interpolated case: the bin
+/// indices of all points are calculated in one pass by RooDataHist::weights().
+/// Points outside the range of a histogram observable get a zero value.
+
+Bool_t RooHistFunc::evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const
+{
+  if (_intOrder!=0 || _depList.getSize()!=_histObsList.getSize()) {
+    return kFALSE ;
+  }
+  const Int_t n = end-begin ;
+
+  // Values of the mapped observables, in the order of the histogram observables
+  RooArgList histVars(*_dataHist->get()) ;
+  vector<vector<Double_t> > values(histVars.getSize(),vector<Double_t>(n)) ;
+  vector<const Double_t*> coords(histVars.getSize()) ;
+  vector<Bool_t> inRange(n,kTRUE) ;
+  _histObsIter->Reset() ;
+  _pdfObsIter->Reset() ;
+  RooAbsArg* harg, *parg ;
+  while((harg=(RooAbsArg*)_histObsIter->Next())) {
+    parg = (RooAbsArg*)_pdfObsIter->Next() ;
+    const RooAbsRealLValue* hreal = dynamic_cast<const RooAbsRealLValue*>(harg) ;
+    const RooAbsReal* preal = dynamic_cast<const RooAbsReal*>(parg) ;
+    Int_t i = histVars.index(harg->GetName()) ;
+    if (!hreal || !preal || i<0) {
+      return kFALSE ;
+    }
+    Double_t* x = &values[i][0] ;
+    if (!preal->getValBatch(x,begin,end,data)) {
+      return kFALSE ;
+    }
+    coords[i] = x ;
+    if (harg != parg) {
+      // Same as RooAbsRealLValue::inRange(0)
+      Double_t xmin = hreal->getMin() ;
+      Double_t xmax = hreal->getMax() ;
+      for (Int_t k=0 ; k<n ; k++) {
+	Double_t epsilon = 1e-8 * fabs(x[k]) ;
+	if (x[k]<xmin-epsilon || x[k]>xmax+epsilon) inRange[k] = kFALSE ;
+      }
+    }
+  }
+
+  if (!_dataHist->weights(output,n,coords,kFALSE)) {
+    return kFALSE ;
+  }
+  for (Int_t k=0 ; k<n ; k++) {
+    if (!inRange[k]) output[k] = 0 ;
+  }
+  return kTRUE ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Only handle case of maximum in all variables
 
@@ -871,10 +871,13 @@ void RooLinkedList::Streamer(TBuffer &R__b)
     Int_t size ;
     TObject* arg ;
 
+    // The streamed elements are unique, so they are appended directly:
+    // the duplicate search of RooRefCountList::Add() is quadratic in the
+    // size of the list, which is large for nodes with many clients
     R__b >> size ;
     while(size--) {
       R__b >> arg ;
-      Add(arg) ;      
+      RooLinkedList::Add(arg,1) ;
     }
 
     if (v>1 ) {
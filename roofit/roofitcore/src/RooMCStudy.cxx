@@ -62,6 +62,10 @@ These study modules should derive from classs RooAbsMCStudyModel
 #include "RooPullVar.h"
 #include "RooMsgService.h"
 #include "RooProdPdf.h"
+#include "TRandom2.h"
+#include "TMath.h"
+#include "ROOT/TProcessExecutor.hxx"
+#include "ROOT/TSeq.hxx"
 
 using namespace std ;
 
@@ -229,6 +233,7 @@ RooMCStudy::RooMCStudy(const RooAbsPdf& model, const RooArgSet& observables,
   _allDependents.add(_dependents) ;  
   _fitOptions = pc.getString("fitOpts") ;
   _canAddFitResults = kTRUE ;
+  _nWorkers = 0 ;
   
   if (_extendedGen && _genProtoData && !_randProto) {
     oocoutW(_fitModel,Generation) << "RooMCStudy::RooMCStudy: WARNING Using generator option 'e' (Poisson distribution of #events) together " << endl
@@ -338,7 +343,8 @@ RooMCStudy::RooMCStudy(const RooAbsPdf& genModel, const RooAbsPdf& fitModel,
   _fitOptions(fitOptions),
   _canAddFitResults(kTRUE),
   _perExptGenParams(0),
-  _silence(kFALSE)
+  _silence(kFALSE),
+  _nWorkers(0)
 {
   // Decode generator options
   TString genOpt(genOptions) ;
@@ -455,9 +461,19 @@ void RooMCStudy::addModule(RooAbsMCStudyModule& module)
 /// When fitting only, data sets may optionally be read from ascii files, using the same file
 /// pattern.
 ///
+/// If lastSample is not negative, only the samples with serial numbers in
+/// [firstSample,lastSample) are processed. If more than one worker was
+/// requested with setNWorkers(), the samples are distributed over worker
+/// processes by runParallel().
+///
 
-Bool_t RooMCStudy::run(Bool_t doGenerate, Bool_t DoFit, Int_t nSamples, Int_t nEvtPerSample, Bool_t keepGenData, const char* asciiFilePat) 
+Bool_t RooMCStudy::run(Bool_t doGenerate, Bool_t DoFit, Int_t nSamples, Int_t nEvtPerSample, Bool_t keepGenData, const char* asciiFilePat,
+		       Int_t firstSample, Int_t lastSample) 
 {
+  if (_nWorkers>1 && nSamples>1 && lastSample<0) {
+    return runParallel(doGenerate,DoFit,nSamples,nEvtPerSample,keepGenData,asciiFilePat) ;
+  }
+
   RooFit::MsgLevel oldLevel(RooFit::FATAL) ;
   if (_silence) {
     oldLevel = RooMsgService::instance().globalKillBelow() ;
@@ -472,6 +488,10 @@ Bool_t RooMCStudy::run(Bool_t doGenerate, Bool_t DoFit, Int_t nSamples, Int_t nE
   Int_t prescale = nSamples>100 ? Int_t(nSamples/100) : 1 ;
 
   while(nSamples--) {
+
+    if (lastSample>=0 && (nSamples<firstSample || nSamples>=lastSample)) {
+      continue ;
+    }
     
     if (nSamples%prescale==0) {
       oocoutP(_fitModel,Generation) << "RooMCStudy::run: " ;
@@ -637,6 +657,126 @@ Bool_t RooMCStudy::run(Bool_t doGenerate, Bool_t DoFit, Int_t nSamples, Int_t nE
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Parallel version of run(). The samples are split in contiguous ranges of
+/// serial numbers, each of which is processed by run() in a forked worker
+/// process with its own copy of the models. The random generator of each
+/// worker is seeded from a sequence derived from the current state of
+/// RooRandom, so that the result is reproducible for a given seed.
+/// Processes rather than threads are used because generation and fitting
+/// use global state of RooFit that is not thread safe.
+///
+/// The fit parameter datasets of the workers, including the pulls and the
+/// output of the study modules, are merged in the order of the serial run,
+/// as are the saved fit results and generated samples. Study modules that
+/// keep results in their own data members only see them in the workers.
+
+Bool_t RooMCStudy::runParallel(Bool_t doGenerate, Bool_t DoFit, Int_t nSamples, Int_t nEvtPerSample, Bool_t keepGenData, const char* asciiFilePat)
+{
+  UInt_t nWorkers = _nWorkers<nSamples ? _nWorkers : nSamples ;
+
+  // Independent seeds for the workers
+  TRandom2 seedGen(RooRandom::randomGenerator()->Integer(TMath::Limits<UInt_t>::Max())) ;
+  vector<UInt_t> seeds(nWorkers) ;
+  for (UInt_t i=0 ; i<nWorkers ; i++) {
+    seeds[i] = seedGen.Integer(TMath::Limits<UInt_t>::Max()) ;
+  }
+
+  oocoutP(_fitModel,Generation) << "RooMCStudy::run: processing " << nSamples << " samples in "
+				<< nWorkers << " worker processes" << endl ;
+
+  // Executed in the forked processes. The samples are processed in descending
+  // order, so the first worker takes the highest range of serial numbers
+  auto work = [&](UInt_t iWorker) -> TList* {
+    RooRandom::randomGenerator()->SetSeed(seeds[iWorker]) ;
+    Int_t firstSample = Int_t(Long64_t(nSamples)*(nWorkers-1-iWorker)/nWorkers) ;
+    Int_t lastSample = Int_t(Long64_t(nSamples)*(nWorkers-iWorker)/nWorkers) ;
+    run(doGenerate,DoFit,nSamples,nEvtPerSample,keepGenData,asciiFilePat,firstSample,lastSample) ;
+
+    TList* output = new TList ;
+    output->Add(_fitParData) ;
+    if (_genParData) {
+      output->Add(_genParData) ;
+    }
+    TList* fitResults = new TList ;
+    fitResults->SetName("fitResults") ;
+    fitResults->AddAll(&_fitResList) ;
+    output->Add(fitResults) ;
+    if (doGenerate && keepGenData) {
+      TList* genData = new TList ;
+      genData->SetName("genData") ;
+      genData->AddAll(&_genDataList) ;
+      output->Add(genData) ;
+    }
+    return output ;
+  } ;
+
+  ROOT::TProcessExecutor workers(nWorkers) ;
+  vector<TList*> results = workers.Map(work, ROOT::TSeqU(nWorkers)) ;
+
+  // Merge the output of the workers
+  RooDataSet* fitParData(0) ;
+  RooDataSet* genParData(0) ;
+  Bool_t ok(kTRUE) ;
+  for (UInt_t i=0 ; i<results.size() ; i++) {
+    if (!results[i]) {
+      oocoutE(_fitModel,Generation) << "RooMCStudy::run: ERROR no output from worker " << i << endl ;
+      ok = kFALSE ;
+      continue ;
+    }
+
+    RooDataSet* data = (RooDataSet*) results[i]->FindObject(_fitParData->GetName()) ;
+    if (data) {
+      if (!fitParData) {
+	fitParData = data ;
+      } else {
+	fitParData->append(*data) ;
+	delete data ;
+      }
+    }
+
+    data = _genParData ? (RooDataSet*) results[i]->FindObject(_genParData->GetName()) : 0 ;
+    if (data) {
+      if (!genParData) {
+	genParData = data ;
+      } else {
+	genParData->append(*data) ;
+	delete data ;
+      }
+    }
+
+    TList* fitResults = (TList*) results[i]->FindObject("fitResults") ;
+    if (fitResults) {
+      _fitResList.AddAll(fitResults) ;
+      delete fitResults ;
+    }
+
+    TList* genData = (TList*) results[i]->FindObject("genData") ;
+    if (genData) {
+      _genDataList.AddAll(genData) ;
+      delete genData ;
+    }
+
+    delete results[i] ;
+  }
+
+  if (fitParData) {
+    delete _fitParData ;
+    _fitParData = fitParData ;
+  }
+  if (genParData) {
+    delete _genParData ;
+    _genParData = genParData ;
+  }
+
+  // The pulls were calculated by the workers
+  _canAddFitResults = kFALSE ;
+
+  return !ok ;
+}
+
+
+
 
 
 
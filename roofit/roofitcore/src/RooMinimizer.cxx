@@ -119,6 +119,7 @@ RooMinimizer::RooMinimizer(RooAbsReal& function)
   _func = &function ;
   _optConst = kFALSE ;
   _verbose = kFALSE ;
+  _useGradient = kFALSE ;
   _profile = kFALSE ;
   _profileStart = kFALSE ;
   _printLevel = 1 ;
@@ -321,7 +322,7 @@ Int_t RooMinimizer::minimize(const char* type, const char* alg)
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::CollectErrors) ;
   RooAbsReal::clearEvalErrorLog() ;
 
-  bool ret = _theFitter->FitFCN(*_fcn);
+  bool ret = fitFCN();
   _status = ((ret) ? _theFitter->Result().Status() : -1);
 
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
@@ -335,6 +336,26 @@ Int_t RooMinimizer::minimize(const char* type, const char* alg)
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Run the fitter on the function. If enabled with setUseGradient() and the
+/// function provides analytic derivatives at the current parameter values,
+/// the function is passed with its gradient, so that the minimizer does not
+/// calculate the derivatives numerically
+
+bool RooMinimizer::fitFCN()
+{
+  if (_useGradient) {
+    if (_fcn->HasGradient()) {
+      return _theFitter->FitFCN(static_cast<const ROOT::Math::IMultiGradFunction&>(*_fcn)) ;
+    }
+    coutI(Minimization) << "RooMinimizer::fitFCN: analytic gradient of " << _func->GetName()
+			<< " not available, using numeric derivatives" << endl ;
+  }
+  return _theFitter->FitFCN(static_cast<const ROOT::Math::IMultiGenFunction&>(*_fcn)) ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Execute MIGRAD. Changes in parameter values
 /// and calculated errors are automatically
@@ -350,7 +371,7 @@ Int_t RooMinimizer::migrad()
   RooAbsReal::clearEvalErrorLog() ;
 
   _theFitter->Config().SetMinimizer(_minimizerType.c_str(),"migrad");
-  bool ret = _theFitter->FitFCN(*_fcn);
+  bool ret = fitFCN();
   _status = ((ret) ? _theFitter->Result().Status() : -1);
 
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
@@ -513,7 +534,7 @@ Int_t RooMinimizer::seek()
   RooAbsReal::clearEvalErrorLog() ;
 
   _theFitter->Config().SetMinimizer(_minimizerType.c_str(),"seek");
-  bool ret = _theFitter->FitFCN(*_fcn);
+  bool ret = fitFCN();
   _status = ((ret) ? _theFitter->Result().Status() : -1);
 
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
@@ -542,7 +563,7 @@ Int_t RooMinimizer::simplex()
   RooAbsReal::clearEvalErrorLog() ;
 
   _theFitter->Config().SetMinimizer(_minimizerType.c_str(),"simplex");
-  bool ret = _theFitter->FitFCN(*_fcn);
+  bool ret = fitFCN();
   _status = ((ret) ? _theFitter->Result().Status() : -1);
 
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
@@ -571,7 +592,7 @@ Int_t RooMinimizer::improve()
   RooAbsReal::clearEvalErrorLog() ;
 
   _theFitter->Config().SetMinimizer(_minimizerType.c_str(),"migradimproved");
-  bool ret = _theFitter->FitFCN(*_fcn);
+  bool ret = fitFCN();
   _status = ((ret) ? _theFitter->Result().Status() : -1);
 
   RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::PrintErrors) ;
@@ -38,6 +38,10 @@
 
 #include "RooMinimizer.h"
 
+#include <vector>
+#include <algorithm>
+#include <math.h>
+
 using namespace std;
 
 RooMinimizerFcn::RooMinimizerFcn(RooAbsReal *funct, RooMinimizer* context,
@@ -47,7 +51,7 @@ RooMinimizerFcn::RooMinimizerFcn(RooAbsReal *funct, RooMinimizer* context,
   _maxFCN(-1e30), _numBadNLL(0),  
   _printEvalErrors(10), _doEvalErrorWall(kTRUE),
   _nDim(0), _logfile(0),
-  _verbose(verbose)
+  _verbose(verbose), _numGradWarned(false)
 { 
 
   _evalCounter = 0 ;
@@ -94,7 +98,7 @@ RooMinimizerFcn::RooMinimizerFcn(RooAbsReal *funct, RooMinimizer* context,
 
 
 
-RooMinimizerFcn::RooMinimizerFcn(const RooMinimizerFcn& other) : ROOT::Math::IBaseFunctionMultiDim(other), 
+RooMinimizerFcn::RooMinimizerFcn(const RooMinimizerFcn& other) : ROOT::Math::IMultiGradFunction(other), 
   _evalCounter(other._evalCounter),
   _funct(other._funct),
   _context(other._context),
@@ -105,6 +109,7 @@ RooMinimizerFcn::RooMinimizerFcn(const RooMinimizerFcn& other) : ROOT::Math::IBa
   _nDim(other._nDim),
   _logfile(other._logfile),
   _verbose(other._verbose),
+  _numGradWarned(other._numGradWarned),
   _floatParamVec(other._floatParamVec)
 {  
   _floatParamList = new RooArgList(*other._floatParamList) ;
@@ -582,5 +587,90 @@ double RooMinimizerFcn::DoEval(const double *x) const
   return fvalue;
 }
 
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the minimized function provides analytic derivatives with
+/// respect to all floating parameters at their current values, see
+/// RooAbsReal::gradient()
+
+Bool_t RooMinimizerFcn::HasGradient() const
+{
+  std::vector<Double_t> grad(_nDim) ;
+  Bool_t ret = _funct->gradient(*_floatParamList,grad.data()) ;
+
+  // Errors are reported by the function evaluation
+  RooAbsPdf::clearEvalError() ;
+  RooAbsReal::clearEvalErrorLog() ;
+  return ret ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the gradient of the minimized function at 'x' with the analytic
+/// derivatives of RooAbsReal::gradient(). If they are not available at this
+/// point, central finite differences of DoEval() are used instead
+
+void RooMinimizerFcn::Gradient(const double *x, double *grad) const
+{
+  // Set the parameter values for this iteration
+  for (int index = 0; index < _nDim; index++) {
+    SetPdfParamVal(index,x[index]);
+  }
+
+  Bool_t ok = _funct->gradient(*_floatParamList,grad) ;
+
+  // Errors are reported by the function evaluation
+  RooAbsPdf::clearEvalError() ;
+  RooAbsReal::clearEvalErrorLog() ;
+
+  if (ok) return ;
+
+  if (!_numGradWarned) {
+    oocoutW(_context,Minimization) << "RooMinimizerFcn::Gradient: analytic derivatives of " << _funct->GetName()
+				   << " not available at current parameter values, using finite differences" << endl ;
+    _numGradWarned = true ;
+  }
+
+  std::vector<double> xx(x,x+_nDim) ;
+  for (int index = 0; index < _nDim; index++) {
+    double h = 1e-6*std::max(1.,fabs(x[index])) ;
+    xx[index] = x[index]+h ;
+    double fUp = DoEval(&xx[0]) ;
+    xx[index] = x[index]-h ;
+    double fDown = DoEval(&xx[0]) ;
+    xx[index] = x[index] ;
+    grad[index] = (fUp-fDown)/(2*h) ;
+  }
+  for (int index = 0; index < _nDim; index++) {
+    SetPdfParamVal(index,x[index]);
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the value and the gradient of the minimized function at 'x'
+
+void RooMinimizerFcn::FdF(const double *x, double &f, double *df) const
+{
+  f = DoEval(x) ;
+  Gradient(x,df) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivative of the minimized function with respect to the
+/// parameter with index 'icoord' at 'x'
+
+double RooMinimizerFcn::DoDerivative(const double *x, unsigned int icoord) const
+{
+  std::vector<double> grad(_nDim) ;
+  Gradient(x,&grad[0]) ;
+  return grad[icoord] ;
+}
+
 #endif
 
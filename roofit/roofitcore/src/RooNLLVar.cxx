@@ -39,10 +39,13 @@ In extended mode, a (Nexpect - Nobserved*log(NExpected) term is added
 #include "RooCmdConfig.h"
 #include "RooMsgService.h"
 #include "RooAbsDataStore.h"
+#include "RooVectorDataStore.h"
+#include "RooDataSet.h"
 #include "RooRealMPFE.h"
 #include "RooRealSumPdf.h"
 #include "RooRealVar.h"
 #include "RooProdPdf.h"
+#include "ROOT/TTrace.hxx"
 
 ClassImp(RooNLLVar)
 ;
@@ -227,7 +230,7 @@ void RooNLLVar::applyWeightSquared(Bool_t flag)
   } else if ( _gofOpMode==MPMaster) {
     for (Int_t i=0 ; i<_nCPU ; i++)
       _mpfeArray[i]->applyNLLWeightSquared(flag);
-  } else if ( _gofOpMode==SimMaster) {
+  } else if ( _gofOpMode==SimMaster || _gofOpMode==MTMaster) {
     for (Int_t i=0 ; i<_nGof ; i++)
       ((RooNLLVar*)_gofArray[i])->applyWeightSquared(flag);
   }
@@ -243,6 +246,8 @@ void RooNLLVar::applyWeightSquared(Bool_t flag)
 
 Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t stepSize) const
 {
+  R__TRACE_ZONE("RooNLLVar::evaluatePartition", "roofit") ;
+
   // Throughout the calculation, we use Kahan's algorithm for summing to
   // prevent loss of precision - this is a factor four more expensive than
   // straight addition, but since evaluating the PDF is usually much more
@@ -261,6 +266,16 @@ Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t s
   // If pdf is marked as binned - do a binned likelihood calculation here (sum of log-Poisson for each bin)
   if (_binnedPdf) {
 
+    // For a dataset in a vector store the expected yields of contiguous bins
+    // are calculated in batches, so that the templates of the binned model
+    // are evaluated as arrays. If the p.d.f does not support batch
+    // evaluation, the bins are evaluated one by one.
+    const RooVectorDataStore* vstore = dynamic_cast<const RooVectorDataStore*>(_dataClone->store()) ;
+    Bool_t batch = vstore && stepSize==1 && dynamic_cast<const RooDataSet*>(_dataClone) ;
+    const Int_t batchSize(1024) ;
+    std::vector<Double_t> yields(batch ? batchSize : 0) ;
+    Int_t batchBegin(firstEvent), batchEnd(firstEvent) ;
+
     for (i=firstEvent ; i<lastEvent ; i+=stepSize) {
 
       _dataClone->get(i) ;
@@ -269,10 +284,15 @@ Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t s
 
       Double_t eventWeight = _dataClone->weight();
 
+      if (batch && i>=batchEnd) {
+	batchBegin = i ;
+	batchEnd = std::min(i+batchSize,lastEvent) ;
+	batch = _binnedPdf->getValBatch(&yields[0],batchBegin,batchEnd,*vstore) ;
+      }
 
       // Calculate log(Poisson(N|mu) for this bin
       Double_t N = eventWeight ;
-      Double_t mu = _binnedPdf->getVal()*_binw[i] ;
+      Double_t mu = (batch ? yields[i-batchBegin] : _binnedPdf->getVal())*_binw[i] ;
       //cout << "RooNLLVar::binnedL(" << GetName() << ") N=" << N << " mu = " << mu << endl ;
 
       if (mu<=0 && N>0) {
@@ -306,7 +326,66 @@ Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t s
 
   } else {
 
-    for (i=firstEvent ; i<lastEvent ; i+=stepSize) {
+    // Contiguous events of an unbinned dataset in a vector store are first
+    // evaluated in batches of events, reading the observables directly from
+    // the columns of the store. The remaining events, or all of them if the
+    // p.d.f does not support batch evaluation, are evaluated one by one.
+    Int_t firstScalar = firstEvent ;
+    const RooVectorDataStore* vstore = dynamic_cast<const RooVectorDataStore*>(_dataClone->store()) ;
+    if (vstore && stepSize==1 && dynamic_cast<const RooDataSet*>(_dataClone)) {
+
+      const Int_t batchSize(1024) ;
+      std::vector<Double_t> probs(batchSize), weights(batchSize) ;
+
+      for ( ; firstScalar<lastEvent ; firstScalar+=batchSize) {
+	const Int_t end = std::min(firstScalar+batchSize,lastEvent) ;
+	const Int_t n = end-firstScalar ;
+
+	// Events with zero weight must not be evaluated
+	if (!vstore->weightBatch(&weights[0],firstScalar,end) ||
+	    std::find(weights.begin(),weights.begin()+n,0.)!=weights.begin()+n) break ;
+	if (!pdfClone->getValBatch(&probs[0],firstScalar,end,*vstore,_normSet)) break ;
+
+	for (Int_t j=0 ; j<n ; j++) {
+
+	  Double_t eventWeight = weights[j] ;
+	  if (_weightSq) eventWeight *= eventWeight ;
+
+	  // Same checks as in RooAbsPdf::getLogVal()
+	  Double_t prob = probs[j] ;
+	  Double_t logProb ;
+	  if (fabs(prob)>1e6) {
+	    coutW(Eval) << "RooAbsPdf::getLogVal(" << pdfClone->GetName() << ") WARNING: large likelihood value: " << prob << std::endl ;
+	  }
+	  if (prob<0) {
+	    pdfClone->logEvalError("getLogVal() top-level p.d.f evaluates to a negative number") ;
+	    logProb = 0 ;
+	  } else if (prob==0) {
+	    pdfClone->logEvalError("getLogVal() top-level p.d.f evaluates to zero") ;
+	    logProb = log((double)0) ;
+	  } else if (TMath::IsNaN(prob)) {
+	    pdfClone->logEvalError("getLogVal() top-level p.d.f evaluates to NaN") ;
+	    logProb = log((double)0) ;
+	  } else {
+	    logProb = log(prob) ;
+	  }
+
+	  Double_t term = -eventWeight * logProb ;
+
+	  Double_t y = eventWeight - sumWeightCarry;
+	  Double_t t = sumWeight + y;
+	  sumWeightCarry = (t - sumWeight) - y;
+	  sumWeight = t;
+
+	  y = term - carry;
+	  t = result + y;
+	  carry = (t - result) - y;
+	  result = t;
+	}
+      }
+    }
+
+    for (i=firstScalar ; i<lastEvent ; i+=stepSize) {
 
       _dataClone->get(i) ;
 
@@ -425,4 +504,100 @@ Double_t RooNLLVar::evaluatePartition(Int_t firstEvent, Int_t lastEvent, Int_t s
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivatives of evaluatePartition() with respect to 'params'
+/// from the derivatives of the p.d.f for each event or bin and, for extended
+/// likelihoods, of the expected number of events. The offset and the
+/// normalization term of simultaneous p.d.f.s are constant and do not
+/// contribute. Returns kFALSE if the derivatives of the p.d.f are not
+/// available or if the likelihood is not defined at the current parameters.
+
+Bool_t RooNLLVar::gradientPartition(Int_t firstEvent, Int_t lastEvent, Int_t stepSize, const RooArgList& params, Double_t* grad) const
+{
+  Int_t n = params.getSize() ;
+  std::fill(grad,grad+n,0.) ;
+  std::vector<Double_t> pdfGrad(n) ;
+
+  RooAbsPdf* pdfClone = (RooAbsPdf*) _funcClone ;
+
+  _dataClone->store()->recalculateCache( _projDeps, firstEvent, lastEvent, stepSize,(_binnedPdf?kFALSE:kTRUE) ) ;
+
+  if (_binnedPdf) {
+
+    for (Int_t i=firstEvent ; i<lastEvent ; i+=stepSize) {
+
+      _dataClone->get(i) ;
+
+      if (!_dataClone->valid()) continue;
+
+      // d/dmu of -log(Poisson(N|mu)) is 1-N/mu
+      Double_t N = _dataClone->weight() ;
+      Double_t mu = _binnedPdf->getVal()*_binw[i] ;
+
+      if (mu<=0 && N>0) {
+	return kFALSE ;
+      } else if (fabs(mu)<1e-10 && fabs(N)<1e-10) {
+	continue ;
+      }
+
+      if (!_binnedPdf->gradient(params,pdfGrad.data())) return kFALSE ;
+      Double_t dTerm = (1 - N/mu)*_binw[i] ;
+      for (Int_t k=0 ; k<n ; k++) {
+	grad[k] += dTerm*pdfGrad[k] ;
+      }
+    }
+
+  } else {
+
+    for (Int_t i=firstEvent ; i<lastEvent ; i+=stepSize) {
+
+      _dataClone->get(i) ;
+
+      if (!_dataClone->valid()) continue;
+
+      Double_t eventWeight = _dataClone->weight();
+      if (0. == eventWeight * eventWeight) continue ;
+      if (_weightSq) eventWeight = _dataClone->weightSquared() ;
+
+      Double_t prob = pdfClone->getVal(_normSet) ;
+      if (prob<=0 || TMath::IsNaN(prob)) return kFALSE ;
+      if (!pdfClone->gradient(params,pdfGrad.data(),_normSet)) return kFALSE ;
+
+      for (Int_t k=0 ; k<n ; k++) {
+	grad[k] -= eventWeight*pdfGrad[k]/prob ;
+      }
+    }
+
+    // include the extended maximum likelihood term, if requested
+    if(_extended && _setNum==_extSet) {
+
+      Double_t expected = pdfClone->expectedEvents(_dataClone->get()) ;
+      if (expected<=0 || TMath::IsNaN(expected)) return kFALSE ;
+      if (!pdfClone->expectedEventsGradient(params,pdfGrad.data(),_dataClone->get())) return kFALSE ;
+
+      // Derivatives of the extended terms of evaluatePartition() with
+      // respect to the expected number of events
+      Double_t dTerm ;
+      if (_weightSq) {
+	Double_t sumW2(0) ;
+	for (Int_t i=0 ; i<_dataClone->numEntries() ; i++) {
+	  _dataClone->get(i);
+	  sumW2 += _dataClone->weightSquared() ;
+	}
+	dTerm = sumW2/_dataClone->sumEntries() - sumW2/expected ;
+      } else {
+	dTerm = 1 - _dataClone->sumEntries()/expected ;
+      }
+
+      for (Int_t k=0 ; k<n ; k++) {
+	grad[k] += dTerm*pdfGrad[k] ;
+      }
+    }
+  }
+
+  return kTRUE ;
+}
+
+
+
 
@@ -35,6 +35,7 @@ during their lifetime.
 
 #include "RooNormSetCache.h"
 #include "RooArgSet.h"
+#include "RooAbsArg.h"
 
 ClassImp(RooNormSetCache)
 ;
@@ -123,32 +124,11 @@ Bool_t RooNormSetCache::autoCache(const RooAbsArg* self, const RooArgSet* set1,
 
   // B - Check if dependents(set1/set2) are compatible with current cache
   RooNameSet nset1d, nset2d;
+  observableNames(self,set1,set2,nset1d,nset2d);
 
-//   cout << "RooNormSetCache::autoCache set1 = " << (set1?*set1:RooArgSet()) << " set2 = " << (set2?*set2:RooArgSet()) << endl;
-//   if (set1) set1->Print("v");
-//   if (set2) set2->Print("v");
-  //if (self) self->Print("v");
-
-  RooArgSet *set1d, *set2d ;
-  if (self) {
-    set1d = set1 ? self->getObservables(*set1,kFALSE) : new RooArgSet;
-    set2d = set2 ? self->getObservables(*set2,kFALSE) : new RooArgSet;
-  } else {
-    set1d = set1 ? (RooArgSet*)set1->snapshot() : new RooArgSet;
-    set2d = set2 ? (RooArgSet*)set2->snapshot() : new RooArgSet;
-  }
-
-//   cout << "RooNormSetCache::autoCache set1d = " << *set1d << " set2 = " << *set2d << endl;
-
-  nset1d.refill(*set1d);
-  nset2d.refill(*set2d);
-
-  if (nset1d == _name1 && nset2d == _name2 && _set2RangeName == set2RangeName) {
+  if (matches(nset1d,nset2d,set2RangeName)) {
     // Compatible - Add current set1/2 to cache
     add(set1,set2);
-
-    delete set1d;
-    delete set2d;
     return kFALSE;
   }
   
@@ -156,14 +136,36 @@ Bool_t RooNormSetCache::autoCache(const RooAbsArg* self, const RooArgSet* set1,
   if (doRefill) {
     clear();
     add(set1,set2);
-    _name1.refill(*set1d);
-    _name2.refill(*set2d);
-//     cout << "RooNormSetCache::autoCache() _name1 refilled from " << *set1d << " to " ; _name1.printValue(cout) ; cout << endl;
-//     cout << "RooNormSetCache::autoCache() _name2 refilled from " << *set2d << " to " ; _name2.printValue(cout) ; cout << endl;
+    _name1 = nset1d;
+    _name2 = nset2d;
     _set2RangeName = (TNamed*) set2RangeName;
   }
   
+  return kTRUE;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill name1 and name2 with the names of the observables of 'self' in
+/// set1 and set2, the content-based key of a pair of sets. If self is null
+/// the names of all elements of the sets are used.
+
+void RooNormSetCache::observableNames(const RooAbsArg* self, const RooArgSet* set1,
+	const RooArgSet* set2, RooNameSet& name1, RooNameSet& name2)
+{
+  RooArgSet *set1d, *set2d ;
+  if (self) {
+    set1d = set1 ? self->getObservables(*set1,kFALSE) : new RooArgSet;
+    set2d = set2 ? self->getObservables(*set2,kFALSE) : new RooArgSet;
+  } else {
+    set1d = set1 ? (RooArgSet*)set1->snapshot() : new RooArgSet;
+    set2d = set2 ? (RooArgSet*)set2->snapshot() : new RooArgSet;
+  }
+
+  name1.refill(*set1d);
+  name2.refill(*set2d);
+
   delete set1d;
   delete set2d;
-  return kTRUE;
 }
@@ -0,0 +1,320 @@
+/*****************************************************************************
+ * Project: RooFit                                                           *
+ * Package: RooFitCore                                                       *
+ *    File: $Id$
+ * Authors:                                                                  *
+ *   WV, Wouter Verkerke, UC Santa Barbara, verkerke@slac.stanford.edu       *
+ *   DK, David Kirkby,    UC Irvine,         dkirkby@uci.edu                 *
+ *                                                                           *
+ * Copyright (c) 2000-2005, Regents of the University of California          *
+ *                          and Stanford University. All rights reserved.    *
+ *                                                                           *
+ * Redistribution and use in source and binary forms,                        *
+ * with or without modification, are permitted according to the terms        *
+ * listed in LICENSE (http://roofit.sourceforge.net/license.txt)             *
+ *****************************************************************************/
+
+/**
+\file RooNumIntCache.cxx
+\class RooNumIntCache
+\ingroup Roofitcore
+
+RooNumIntCache is a cache of values of a numeric integral for the
+parameter points at which it was calculated, used by RooRealIntegral
+when enabled with RooRealIntegral::setParamCache(). The parameter
+values are quantized on a grid whose spacing is a given fraction of
+the range of each parameter (or an absolute spacing for parameters
+without a finite range), so that points closer than the spacing share
+the same value. With a zero precision the parameter values must match
+exactly. The cache is bounded in memory: when full, the least recently
+used value is dropped.
+
+Optionally, the values are calculated at the grid points only and
+interpolated multilinearly in between. This is only meaningful if the
+integral is a smooth function of the parameters on the scale of the
+grid spacing.
+
+Like the other RooAbsCache implementations the cache is registered
+with its owner, and is emptied when the servers of the owner are
+redirected.
+**/
+
+#include "RooFit.h"
+
+#include "Riostream.h"
+#include "TMath.h"
+#include "RooNumIntCache.h"
+#include "RooArgSet.h"
+#include "RooAbsRealLValue.h"
+#include "RooAbsCategory.h"
+
+#include <algorithm>
+
+using namespace std;
+
+ClassImp(RooNumIntCache)
+   ;
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Constructor of cache for owner 'owner'. The parameters are quantized on
+/// a grid with spacing 'precision' times their range, the cache uses at most
+/// 'maxKBytes' kilobytes, and if 'interpolate' is true the values are
+/// interpolated between the grid points
+
+RooNumIntCache::RooNumIntCache(RooAbsArg* owner, Double_t precision, Int_t maxKBytes, Bool_t interpolate) :
+  RooAbsCache(owner),
+  _precision(precision>0 ? precision : 0),
+  _maxKBytes(maxKBytes),
+  _interpolate(interpolate && precision>0),
+  _hits(0),
+  _misses(0)
+{
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy constructor. The configuration is copied, the cached values are not
+
+RooNumIntCache::RooNumIntCache(const RooNumIntCache& other, RooAbsArg* owner) :
+  RooAbsCache(other,owner),
+  _precision(other._precision),
+  _maxKBytes(other._maxKBytes),
+  _interpolate(other._interpolate),
+  _hits(0),
+  _misses(0)
+{
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor
+
+RooNumIntCache::~RooNumIntCache()
+{
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the grid spacing of parameter 'param' and set 'origin' to
+/// the position of the grid point with index zero. A zero spacing
+/// means that the value is used as it is.
+
+Double_t RooNumIntCache::quantum(const RooAbsArg& param, Double_t& origin) const
+{
+  origin = 0 ;
+  if (_precision==0 || !dynamic_cast<const RooAbsReal*>(&param)) {
+    return 0 ;
+  }
+
+  const RooAbsRealLValue* lvalue = dynamic_cast<const RooAbsRealLValue*>(&param) ;
+  if (lvalue && lvalue->hasMin() && lvalue->hasMax()) {
+    origin = lvalue->getMin() ;
+    return _precision*(lvalue->getMax()-lvalue->getMin()) ;
+  }
+  return _precision ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill 'key' with the index of the grid point closest to the current
+/// value of each parameter in 'params'. Categories are represented by
+/// their index
+
+void RooNumIntCache::makeKey(const RooArgSet& params, vector<Double_t>& key) const
+{
+  key.resize(params.getSize()) ;
+  RooFIter iter = params.fwdIterator() ;
+  RooAbsArg* param ;
+  Int_t i(0) ;
+  while((param=iter.next())) {
+    Double_t origin ;
+    Double_t q = quantum(*param,origin) ;
+    const RooAbsReal* real = dynamic_cast<const RooAbsReal*>(param) ;
+    const RooAbsCategory* cat = dynamic_cast<const RooAbsCategory*>(param) ;
+    if (real) {
+      key[i] = q>0 ? TMath::Floor((real->getVal()-origin)/q+0.5) : real->getVal() ;
+    } else if (cat) {
+      key[i] = cat->getIndex() ;
+    } else {
+      key[i] = 0 ;
+    }
+    i++ ;
+  }
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Locate the grid cell that contains the current parameter values for
+/// interpolation. On return 'key' holds the index of the lower corner of
+/// the cell and 'frac' the position inside the cell along each parameter,
+/// between 0 and 1. Return false if the values cannot be interpolated:
+/// interpolation is not enabled, there are more than kMaxInterpolationDim
+/// parameters, a parameter is not a real-valued lvalue with a finite range,
+/// or the cell extends beyond the range of a parameter
+
+Bool_t RooNumIntCache::makeCell(const RooArgSet& params, vector<Double_t>& key, vector<Double_t>& frac) const
+{
+  if (!_interpolate || params.getSize()>kMaxInterpolationDim) {
+    return kFALSE ;
+  }
+
+  key.resize(params.getSize()) ;
+  frac.resize(params.getSize()) ;
+  RooFIter iter = params.fwdIterator() ;
+  RooAbsArg* param ;
+  Int_t i(0) ;
+  while((param=iter.next())) {
+    const RooAbsRealLValue* lvalue = dynamic_cast<const RooAbsRealLValue*>(param) ;
+    if (!lvalue || !lvalue->hasMin() || !lvalue->hasMax()) {
+      return kFALSE ;
+    }
+    Double_t origin ;
+    Double_t q = quantum(*param,origin) ;
+    Double_t t = (lvalue->getVal()-origin)/q ;
+    key[i] = TMath::Floor(t) ;
+    frac[i] = t-key[i] ;
+    if (key[i]<0 || (frac[i]>0 && origin+(key[i]+1)*q>lvalue->getMax())) {
+      return kFALSE ;
+    }
+    i++ ;
+  }
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the value of parameter 'param' at the grid point with index 'index'
+
+Double_t RooNumIntCache::gridValue(const RooAbsArg& param, Double_t index) const
+{
+  Double_t origin ;
+  Double_t q = quantum(param,origin) ;
+  return origin + index*q ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Look up the value cached for 'key'. Return true and set 'value' if
+/// it is found, and mark it as most recently used
+
+Bool_t RooNumIntCache::lookup(const vector<Double_t>& key, Double_t& value)
+{
+  EntryMap::iterator iter = _index.find(key) ;
+  if (iter==_index.end()) {
+    _misses++ ;
+    return kFALSE ;
+  }
+
+  _lru.splice(_lru.begin(),_lru,iter->second) ;
+  value = iter->second->second ;
+  _hits++ ;
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Store 'value' for 'key'. If the memory bound would be exceeded, the
+/// least recently used values are dropped first
+
+void RooNumIntCache::insert(const vector<Double_t>& key, Double_t value)
+{
+  EntryMap::iterator iter = _index.find(key) ;
+  if (iter!=_index.end()) {
+    iter->second->second = value ;
+    _lru.splice(_lru.begin(),_lru,iter->second) ;
+    return ;
+  }
+
+  UInt_t maxSize = std::max(1.,TMath::Floor(1024.*_maxKBytes/entryBytes(key.size()))) ;
+  while (_index.size()>=maxSize) {
+    _index.erase(_lru.back().first) ;
+    _lru.pop_back() ;
+  }
+
+  _lru.push_front(make_pair(key,value)) ;
+  _index[key] = _lru.begin() ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Remove all cached values
+
+void RooNumIntCache::reset()
+{
+  _index.clear() ;
+  _lru.clear() ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the approximate number of bytes used by one cached value with
+/// 'nParams' parameters: the key is stored both in the list node and in
+/// the index node
+
+Double_t RooNumIntCache::entryBytes(Int_t nParams) const
+{
+  return 2.*(nParams*sizeof(Double_t) + sizeof(vector<Double_t>)) + sizeof(Double_t)
+    + sizeof(LRUList::iterator) + 7*sizeof(void*) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the approximate memory used by the cached values in kilobytes
+
+Double_t RooNumIntCache::memoryUsage() const
+{
+  if (_lru.empty()) {
+    return 0 ;
+  }
+  return _lru.size()*entryBytes(_lru.front().first.size())/1024. ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the size and the hit and miss counts of the cache
+
+void RooNumIntCache::printStatistics(ostream& os) const
+{
+  os << size() << " values (" << memoryUsage() << " of " << _maxKBytes << " kB), "
+     << _hits << " hits, " << _misses << " misses, precision " << _precision
+     << (_interpolate ? ", interpolated" : "") ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Empty the cache when the servers of the owner are redirected, as the
+/// cached values may no longer correspond to the parameters
+
+Bool_t RooNumIntCache::redirectServersHook(const RooAbsCollection& /*newServerList*/, Bool_t /*mustReplaceAll*/,
+					   Bool_t /*nameChange*/, Bool_t /*isRecursive*/)
+{
+  reset() ;
+  return kFALSE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add the cache statistics to the output of tree printing
+
+void RooNumIntCache::printCompactTreeHook(ostream& os, const char* indent)
+{
+  os << indent << "RooNumIntCache: " ;
+  printStatistics(os) ;
+  os << endl ;
+}
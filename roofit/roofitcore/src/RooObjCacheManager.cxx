@@ -196,10 +196,17 @@ void RooObjCacheManager::insertObjectHook(RooAbsCacheElement& obj)
 
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Add details on cache contents when printing in tree mode
+/// Add the lookup statistics and details on cache contents when printing
+/// in tree mode
 
 void RooObjCacheManager::printCompactTreeHook(std::ostream& os, const char *indent)
 {
+  if (_hits+_contentHits+_misses>0) {
+    os << indent << "RooObjCacheManager: " ;
+    printStatistics(os) ;
+    os << std::endl ;
+  }
+
   for (Int_t i=0 ; i<cacheSize() ; i++) {
     if (_object[i]) {
       _object[i]->printCompactTreeHook(os,indent,i,cacheSize()-1) ;
@@ -473,6 +473,17 @@ Double_t RooProdPdf::getValV(const RooArgSet* set) const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Overload getValBatch() to intercept normalization set for use in evaluateBatch()
+
+Bool_t RooProdPdf::getValBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data, const RooArgSet* set) const
+{
+  _curNormSet = (RooArgSet*)set ;
+  return RooAbsPdf::getValBatch(output,begin,end,data,set) ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Calculate current value of object
 
@@ -495,6 +506,50 @@ Double_t RooProdPdf::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate(): running product of the batches of the
+/// partial integrals for the events [begin,end) of 'data'. Products that
+/// were rearranged to a ratio of terms are not evaluated in batches.
+
+Bool_t RooProdPdf::evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const
+{
+  Int_t code ;
+  CacheElem* cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+
+  // If cache doesn't have our configuration, recalculate here
+  if (!cache) {
+    RooArgList *plist(0) ;
+    RooLinkedList *nlist(0) ;
+    getPartIntList(_curNormSet,0,plist,nlist,code) ;
+    cache = (CacheElem*) _cacheMgr.getObj(_curNormSet,0,&code) ;
+  }
+
+  if (cache->_isRearranged) return kFALSE ;
+
+  const Int_t n = end-begin ;
+  std::vector<Double_t> piVal(n) ;
+  std::fill(output,output+n,1.) ;
+
+  RooAbsReal* partInt;
+  RooArgSet* normSet;
+  RooFIter plIter = cache->_partList.fwdIterator();
+  RooFIter nlIter = cache->_normList.fwdIterator();
+  for (partInt = (RooAbsReal*) plIter.next(),
+	 normSet = (RooArgSet*) nlIter.next(); partInt && normSet;
+       partInt = (RooAbsReal*) plIter.next(),
+	 normSet = (RooArgSet*) nlIter.next()) {
+    if (!partInt->getValBatch(&piVal[0],begin,end,data,normSet->getSize() > 0 ? normSet : 0)) return kFALSE ;
+    // The running product of an event stops once it falls below the cutoff
+    for (Int_t i=0 ; i<n ; i++) {
+      if (output[i] > _cutOff) output[i] *= piVal[i] ;
+    }
+  }
+
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Calculate running product of pdfs terms, using the supplied
 /// normalization set in 'normSetList' for each component
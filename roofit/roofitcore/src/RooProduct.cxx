@@ -39,6 +39,7 @@ of a given set of other RooAbsReal objects
 #include "RooErrorHandler.h"
 #include "RooMsgService.h"
 #include "RooTrace.h"
+#include "RooVectorDataStore.h"
 
 using namespace std ;
 
@@ -386,6 +387,106 @@ Double_t RooProduct::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate(): multiply the batches of the real-valued
+/// factors for the events [begin,end) of 'data'. Categories are supported
+/// only if they do not depend on the observables of 'data'
+
+Bool_t RooProduct::evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const
+{
+  const Int_t n = end-begin ;
+  std::vector<Double_t> compVal(n) ;
+  std::fill(output,output+n,1.) ;
+
+  RooFIter compRIter = _compRSet.fwdIterator() ;
+  RooAbsReal* rcomp ;
+  const RooArgSet* nset = _compRSet.nset() ;
+  while((rcomp=(RooAbsReal*)compRIter.next())) {
+    if (!rcomp->getValBatch(&compVal[0],begin,end,data,nset)) return kFALSE ;
+    for (Int_t i=0 ; i<n ; i++) output[i] *= compVal[i] ;
+  }
+
+  RooFIter compCIter = _compCSet.fwdIterator() ;
+  RooAbsCategory* ccomp ;
+  while((ccomp=(RooAbsCategory*)compCIter.next())) {
+    if (ccomp->dependsOn(*data.get())) return kFALSE ;
+    Int_t index = ccomp->getIndex() ;
+    for (Int_t i=0 ; i<n ; i++) output[i] *= index ;
+  }
+
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of the product with respect to 'params',
+/// calculated with the product rule. Returns kFALSE if the derivatives
+/// of one of the factors are not available
+
+Bool_t RooProduct::gradient(const RooArgList& params, Double_t* grad, const RooArgSet* /*nset*/) const
+{
+  if (!calculateGradient(_compRSet,_compRSet.nset(),params,grad)) return kFALSE ;
+
+  // Category factors are constant
+  RooFIter compCIter = _compCSet.fwdIterator() ;
+  RooAbsCategory* ccomp ;
+  while((ccomp=(RooAbsCategory*)compCIter.next())) {
+    for (Int_t i=0 ; i<params.getSize() ; i++) {
+      grad[i] *= ccomp->getIndex() ;
+    }
+  }
+
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of analyticalIntegral() with respect to 'params',
+/// calculated with the product rule from those of the partial integrals.
+/// Returns kFALSE if the cache for 'code' is not available
+
+Bool_t RooProduct::analyticalIntegralGradient(Int_t code, const RooArgList& params, Double_t* grad,
+					      const RooArgSet* normSet, const char* /*rangeName*/) const
+{
+  if (code==0) return gradient(params,grad,normSet) ;
+
+  CacheElem *cache = (CacheElem*) _cacheMgr.getObjByIndex(code-1);
+  if (cache==0) {
+    return kFALSE ;
+  }
+  return calculateGradient(cache->_prodList,0,params,grad) ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill 'grad' with the derivatives of the product of the values of 'terms',
+/// evaluated with normalization set 'nset', with respect to 'params'
+
+Bool_t RooProduct::calculateGradient(const RooArgList& terms, const RooArgSet* nset, const RooArgList& params, Double_t* grad) const
+{
+  Int_t n = params.getSize() ;
+  std::fill(grad,grad+n,0.) ;
+  std::vector<Double_t> termGrad(n) ;
+  Double_t prod(1) ;
+
+  RooFIter iter = terms.fwdIterator() ;
+  RooAbsReal* term ;
+  while((term=(RooAbsReal*)iter.next())) {
+    if (!term->gradient(params,termGrad.data(),nset)) return kFALSE ;
+    Double_t val = term->getVal(nset) ;
+    for (Int_t i=0 ; i<n ; i++) {
+      grad[i] = grad[i]*val + prod*termGrad[i] ;
+    }
+    prod *= val ;
+  }
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Forward the plot sampling hint from the p.d.f. that defines the observable obs  
 
@@ -50,6 +50,7 @@ integration is performed in the various implemenations of the RooAbsIntegrator b
 #include "RooConstVar.h"
 #include "RooDouble.h"
 #include "RooTrace.h"
+#include "RooNumIntCache.h"
 
 using namespace std;
 
@@ -74,7 +75,8 @@ RooRealIntegral::RooRealIntegral() :
   _numIntegrand(0),
   _rangeName(0),
   _params(0),
-  _cacheNum(kFALSE)
+  _cacheNum(kFALSE),
+  _paramCache(0)
 {
   _facListIter = _facList.createIterator() ;
   _jacListIter = _jacList.createIterator() ;
@@ -117,7 +119,8 @@ RooRealIntegral::RooRealIntegral(const char *name, const char *title,
   _numIntegrand(0),
   _rangeName((TNamed*)RooNameReg::ptr(rangeName)),
   _params(0),
-  _cacheNum(kFALSE)
+  _cacheNum(kFALSE),
+  _paramCache(0)
 {
   //   A) Check that all dependents are lvalues 
   //
@@ -773,7 +776,8 @@ RooRealIntegral::RooRealIntegral(const RooRealIntegral& other, const char* name)
   _numIntegrand(0),
   _rangeName(other._rangeName),
   _params(0),
-  _cacheNum(kFALSE)
+  _cacheNum(kFALSE),
+  _paramCache(other._paramCache ? new RooNumIntCache(*other._paramCache,this) : 0)
 {
  _funcNormSet = other._funcNormSet ? (RooArgSet*)other._funcNormSet->snapshot(kFALSE) : 0 ;
 
@@ -806,6 +810,7 @@ RooRealIntegral::~RooRealIntegral()
   delete _jacListIter ;
   if (_sumCatIter)  delete _sumCatIter ;
   if (_params) delete _params ;
+  if (_paramCache) delete _paramCache ;
 
   TRACE_DESTROY
 }
@@ -891,6 +896,13 @@ Double_t RooRealIntegral::evaluate() const
     
   case Hybrid: 
     {      
+      // Use the parameter point cache if enabled
+      if (_paramCache && _intList.getSize()>0) {
+	retVal = evaluateCached() ;
+	if (!_valid) return 0 ;
+	break ;
+      }
+
       // Cache numeric integrals in >1d expensive object cache
       RooDouble* cacheVal(0) ;
       if ((_cacheNum && _intList.getSize()>0) || _intList.getSize()>=_cacheAllNDim) {
@@ -903,31 +915,8 @@ Double_t RooRealIntegral::evaluate() const
       } else {
 
 
-	// Find any function dependents that are AClean 
-	// and switch them temporarily to ADirty
-	Bool_t origState = inhibitDirty() ;
-	setDirtyInhibit(kTRUE) ;
-	
-	// try to initialize our numerical integration engine
-	if(!(_valid= initNumIntegrator())) {
-	  coutE(Integration) << ClassName() << "::" << GetName()
-			     << ":evaluate: cannot initialize numerical integrator" << endl;
-	  return 0;
-	}
-	
-	// Save current integral dependent values 
-	_saveInt = _intList ;
-	_saveSum = _sumList ;
-
-	// Evaluate sum/integral
-	retVal = sum() ;
-
-	// This must happen BEFORE restoring dependents, otherwise no dirty state propagation in restore step
-	setDirtyInhibit(origState) ;
-	
-	// Restore integral dependent values
-	_intList=_saveInt ;
-	_sumList=_saveSum ;
+	retVal = evaluateNumeric() ;
+	if (!_valid) return 0 ;
 
 	// Cache numeric integrals in >1d expensive object cache
 	if ((_cacheNum && _intList.getSize()>0) || _intList.getSize()>=_cacheAllNDim) {
@@ -962,20 +951,7 @@ Double_t RooRealIntegral::evaluate() const
 
   // Multiply answer with integration ranges of factorized variables
   if (_facList.getSize()>0) {
-    RooAbsArg *arg ;
-    _facListIter->Reset() ;
-    while((arg=(RooAbsArg*)_facListIter->Next())) {
-      // Multiply by fit range for 'real' dependents
-      if (arg->IsA()->InheritsFrom(RooAbsRealLValue::Class())) {
-	RooAbsRealLValue* argLV = (RooAbsRealLValue*)arg ;
-	retVal *= (argLV->getMax() - argLV->getMin()) ;
-      }
-      // Multiply by number of states for category dependents
-      if (arg->IsA()->InheritsFrom(RooAbsCategoryLValue::Class())) {
-	RooAbsCategoryLValue* argLV = (RooAbsCategoryLValue*)arg ;
-	retVal *= argLV->numTypes() ;
-      }    
-    } 
+    retVal *= factorizedRange() ;
   }
 
 
@@ -996,6 +972,204 @@ Double_t RooRealIntegral::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Perform the numeric part of the integration at the current parameter values
+
+Double_t RooRealIntegral::evaluateNumeric() const
+{
+  // Find any function dependents that are AClean 
+  // and switch them temporarily to ADirty
+  Bool_t origState = inhibitDirty() ;
+  setDirtyInhibit(kTRUE) ;
+  
+  // try to initialize our numerical integration engine
+  if(!(_valid= initNumIntegrator())) {
+    coutE(Integration) << ClassName() << "::" << GetName()
+		       << ":evaluate: cannot initialize numerical integrator" << endl;
+    return 0;
+  }
+  
+  // Save current integral dependent values 
+  _saveInt = _intList ;
+  _saveSum = _sumList ;
+  
+  // Evaluate sum/integral
+  Double_t retVal = sum() ;
+  
+  // This must happen BEFORE restoring dependents, otherwise no dirty state propagation in restore step
+  setDirtyInhibit(origState) ;
+  
+  // Restore integral dependent values
+  _intList=_saveInt ;
+  _sumList=_saveSum ;
+
+  return retVal ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the numeric integral at the current parameter values from the
+/// parameter point cache, calculating and storing it if it is not cached.
+/// If the cache interpolates, the integral is calculated at the corners of
+/// the grid cell containing the parameter point, by temporarily moving the
+/// parameters to the grid points, and interpolated multilinearly. Points
+/// whose cell is not inside the parameter ranges are calculated directly
+/// and not cached.
+
+Double_t RooRealIntegral::evaluateCached() const
+{
+  const RooArgSet& params = parameters() ;
+  vector<Double_t> key ;
+  vector<Double_t> frac ;
+  Double_t value(0) ;
+
+  if (!_paramCache->interpolate()) {
+    _paramCache->makeKey(params,key) ;
+    if (!_paramCache->lookup(key,value)) {
+      value = evaluateNumeric() ;
+      if (_valid) _paramCache->insert(key,value) ;
+    }
+    return value ;
+  }
+
+  if (!_paramCache->makeCell(params,key,frac)) {
+    return evaluateNumeric() ;
+  }
+
+  // makeCell() guarantees that all parameters are real-valued lvalues
+  Int_t n = key.size() ;
+  vector<RooAbsRealLValue*> lvalues ;
+  vector<Double_t> saved ;
+  RooFIter iter = params.fwdIterator() ;
+  RooAbsArg* param ;
+  while((param=iter.next())) {
+    lvalues.push_back(static_cast<RooAbsRealLValue*>(param)) ;
+    saved.push_back(lvalues.back()->getVal()) ;
+  }
+
+  Double_t retVal(0) ;
+  Bool_t moved(kFALSE) ;
+  vector<Double_t> corner(n) ;
+  for (Int_t c=0 ; c<(1<<n) && _valid ; c++) {
+    Double_t weight(1) ;
+    for (Int_t i=0 ; i<n ; i++) {
+      Int_t upper = (c>>i)&1 ;
+      weight *= upper ? frac[i] : 1-frac[i] ;
+      corner[i] = key[i]+upper ;
+    }
+    if (weight==0) continue ;
+
+    if (!_paramCache->lookup(corner,value)) {
+      for (Int_t i=0 ; i<n ; i++) {
+	lvalues[i]->setVal(_paramCache->gridValue(*lvalues[i],corner[i])) ;
+      }
+      moved = kTRUE ;
+      value = evaluateNumeric() ;
+      if (_valid) _paramCache->insert(corner,value) ;
+    }
+    retVal += weight*value ;
+  }
+
+  if (moved) {
+    // Restoring the parameters also marks this integral dirty, although
+    // the value returned is the one at the restored point
+    for (Int_t i=0 ; i<n ; i++) {
+      lvalues[i]->setVal(saved[i]) ;
+    }
+    clearValueDirty() ;
+  }
+
+  return retVal ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of the integral with respect to 'params', see
+/// RooAbsReal::gradient(). They are available if the integral is calculated
+/// analytically and the integrand implements analyticalIntegralGradient(), or
+/// if no integration is needed and the integrand implements gradient().
+/// Kinematic factors from integrations over the ranges of factorizing
+/// observables are applied as in evaluate(). Numeric integrals are not
+/// differentiated, and return kFALSE unless they do not depend on the
+/// parameters.
+
+Bool_t RooRealIntegral::gradient(const RooArgList& params, Double_t* grad, const RooArgSet* /*nset*/) const
+{
+  if (!dependsOnValue(params)) {
+    return RooAbsReal::gradient(params,grad) ;
+  }
+
+  const RooAbsReal& func = (const RooAbsReal&)_function.arg() ;
+  switch (_intOperMode) {
+
+  case Hybrid:
+    return kFALSE ;
+
+  case Analytic:
+    {
+      // The derivatives of jacobians that depend on the parameters are not known
+      RooFIter jiter = _jacList.fwdIterator() ;
+      RooAbsArg* jac ;
+      while((jac=jiter.next())) {
+	if (jac->dependsOnValue(params)) return kFALSE ;
+      }
+      if (!func.analyticalIntegralGradient(_mode,params,grad,_funcNormSet,RooNameReg::str(_rangeName))) {
+	return kFALSE ;
+      }
+      Double_t jacProd = jacobianProduct() ;
+      for (Int_t i=0 ; i<params.getSize() ; i++) {
+	grad[i] /= jacProd ;
+      }
+      break ;
+    }
+
+  case PassThrough:
+    {
+      if (!func.gradient(params,grad,_funcNormSet)) return kFALSE ;
+      break ;
+    }
+  }
+
+  if (_facList.getSize()>0) {
+    Double_t fac = factorizedRange() ;
+    for (Int_t i=0 ; i<params.getSize() ; i++) {
+      grad[i] *= fac ;
+    }
+  }
+
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the product of the integration ranges of the factorized real
+/// observables and of the number of states of the factorized categories
+
+Double_t RooRealIntegral::factorizedRange() const
+{
+  Double_t fac(1) ;
+  RooAbsArg *arg ;
+  _facListIter->Reset() ;
+  while((arg=(RooAbsArg*)_facListIter->Next())) {
+    // Multiply by fit range for 'real' dependents
+    if (arg->IsA()->InheritsFrom(RooAbsRealLValue::Class())) {
+      RooAbsRealLValue* argLV = (RooAbsRealLValue*)arg ;
+      fac *= (argLV->getMax() - argLV->getMin()) ;
+    }
+    // Multiply by number of states for category dependents
+    if (arg->IsA()->InheritsFrom(RooAbsCategoryLValue::Class())) {
+      RooAbsCategoryLValue* argLV = (RooAbsCategoryLValue*)arg ;
+      fac *= argLV->numTypes() ;
+    }
+  }
+  return fac ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return product of jacobian terms originating from analytical integration
 
@@ -1197,6 +1371,11 @@ void RooRealIntegral::printMultiline(ostream& os, Int_t contents, Bool_t verbose
   os << indent << "  Analytically integrated args using mode " << _mode << " are " << _anaList << endl ;
   os << indent << "  Arguments included in Jacobian are " << _jacList << endl ;
   os << indent << "  Factorized arguments are " << _facList << endl ;
+  if (_paramCache) {
+    os << indent << "  Parameter point cache has " ;
+    _paramCache->printStatistics(os) ;
+    os << endl ;
+  }
   os << indent << "  Function normalization set " ;
   if (_funcNormSet) 
     _funcNormSet->Print("1") ; 
@@ -1225,3 +1404,28 @@ Int_t RooRealIntegral::getCacheAllNumeric()
 }
 
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Enable (flag=true) or disable the cache of the numeric integral values by
+/// parameter point. When enabled, a numeric integral already calculated at
+/// the same parameter point, e.g. in a profile likelihood scan or a loop over
+/// toy samples, is taken from the cache. The parameter values are quantized
+/// on a grid with a spacing of 'precision' times their range (an absolute
+/// spacing for parameters without a finite range), or must match exactly if
+/// 'precision' is zero. The cache uses at most 'maxKBytes' of memory and drops
+/// the least recently used values first. If 'interpolate' is true the
+/// integral is calculated at the grid points only and interpolated linearly
+/// in between, which is only meaningful for integrals that are a smooth
+/// function of at most RooNumIntCache::kMaxInterpolationDim parameters.
+
+void RooRealIntegral::setParamCache(Bool_t flag, Double_t precision, Int_t maxKBytes, Bool_t interpolate)
+{
+  if (_paramCache) {
+    delete _paramCache ;
+    _paramCache = 0 ;
+  }
+  if (flag) {
+    _paramCache = new RooNumIntCache(this,precision,maxKBytes,interpolate) ;
+  }
+  setValueDirty() ;
+}
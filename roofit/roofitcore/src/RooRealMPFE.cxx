@@ -49,9 +49,11 @@ For general multiprocessing in ROOT, please refer to the TProcessExecutor class.
 
 #ifndef _WIN32
 #include "BidirMMapPipe.h"
+#include <sys/mman.h>
 #endif
 
 #include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include "RooRealMPFE.h"
 #include "RooArgSet.h"
@@ -73,6 +75,49 @@ using namespace RooFit;
 ClassImp(RooRealMPFE)
   ;
 
+namespace {
+
+  // Layout of the block of memory shared between the client and the server
+  // process: the header is followed by the values of the variables and by
+  // their update flags. The client writes the changed variables into the block
+  // and sends a single UpdateShared message, the server returns the result of
+  // the calculation in the header.
+  struct SharedHeader {
+    Double_t _value ; // Result of the last calculation
+    Double_t _carry ; // Carry of the summation of the last calculation
+    Int_t _nVars ;    // Number of variables in the block
+  } ;
+
+  enum SharedFlag { kChanged=1, kConstant=2, kCategory=4 } ;
+
+  inline SharedHeader* sharedHeader(void* shm) { return static_cast<SharedHeader*>(shm) ; }
+
+  inline Double_t* sharedValues(void* shm) {
+    return reinterpret_cast<Double_t*>(static_cast<char*>(shm)+sizeof(SharedHeader)) ;
+  }
+
+  inline UChar_t* sharedFlags(void* shm) {
+    return reinterpret_cast<UChar_t*>(sharedValues(shm)+sharedHeader(shm)->_nVars) ;
+  }
+
+#ifndef _WIN32
+  // Map an anonymous block of len bytes that remains shared after fork().
+  // Returns zero if this is not supported.
+  void* allocShared(size_t len)
+  {
+#if defined(MAP_ANONYMOUS)
+    void* shm = ::mmap(0, len, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_SHARED, -1, 0) ;
+#elif defined(MAP_ANON)
+    void* shm = ::mmap(0, len, PROT_READ | PROT_WRITE, MAP_ANON | MAP_SHARED, -1, 0) ;
+#else
+    void* shm = MAP_FAILED ; (void)len ;
+#endif
+    return (MAP_FAILED==shm) ? 0 : shm ;
+  }
+#endif
+
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Construct front-end object for object 'arg' whose evaluation will be calculated
@@ -90,6 +135,8 @@ RooRealMPFE::RooRealMPFE(const char *name, const char *title, RooAbsReal& arg, B
   _inlineMode(calcInline),
   _remoteEvalErrorLoggingState(RooAbsReal::PrintErrors),
   _pipe(0),
+  _shm(0),
+  _shmSize(0),
   _updateMaster(0),
   _retrieveDispatched(kFALSE), _evalCarry(0.)
 {
@@ -119,6 +166,8 @@ RooRealMPFE::RooRealMPFE(const RooRealMPFE& other, const char* name) :
   _forceCalc(other._forceCalc),
   _remoteEvalErrorLoggingState(other._remoteEvalErrorLoggingState),
   _pipe(0),
+  _shm(0),
+  _shmSize(0),
   _updateMaster(0),
   _retrieveDispatched(kFALSE), _evalCarry(other._evalCarry)
 {
@@ -193,6 +242,14 @@ void RooRealMPFE::initialize()
   // Clear eval error log prior to forking
   // to avoid confusions...
   clearEvalErrorLog() ;
+  // Allocate the block shared with the server process for the values of the
+  // variables and the result. Without it every change is sent as a message.
+  _shmSize = sizeof(SharedHeader) + _vars.getSize()*(sizeof(Double_t)+sizeof(UChar_t)) ;
+  _shm = allocShared(_shmSize) ;
+  if (_shm) {
+    memset(_shm,0,_shmSize) ;
+    sharedHeader(_shm)->_nVars = _vars.getSize() ;
+  }
   // Fork server process and setup IPC
   _pipe = new BidirMMapPipe();
 
@@ -208,6 +265,7 @@ void RooRealMPFE::initialize()
 
     delete _arg.absArg();
     delete _pipe;
+    freeShared() ;
     _exit(0) ;
   } else {
     // Client process - fork successul
@@ -261,6 +319,31 @@ void RooRealMPFE::serverLoop()
       }
       break ;
 
+    case UpdateShared:
+      {
+	if (_verboseServer) cout << "RooRealMPFE::serverLoop(" << GetName()
+				 << ") IPC fromClient> UpdateShared" << endl ;
+	const Double_t* values = sharedValues(_shm) ;
+	UChar_t* flags = sharedFlags(_shm) ;
+	RooFIter viter = _vars.fwdIterator() ;
+	RooAbsArg* var ;
+	for (idx=0 ; (var = viter.next()) ; idx++) {
+	  if (!(flags[idx] & kChanged)) continue ;
+	  if (flags[idx] & kCategory) {
+	    ((RooCategory*)var)->setIndex((Int_t)values[idx]) ;
+	  } else {
+	    RooRealVar* rvar = (RooRealVar*)var ;
+	    rvar->setVal(values[idx]) ;
+	    isConst = (flags[idx] & kConstant) ? kTRUE : kFALSE ;
+	    if (rvar->isConstant() != isConst) {
+	      rvar->setConstant(isConst) ;
+	    }
+	  }
+	  flags[idx] = 0 ;
+	}
+      }
+      break ;
+
     case SendCat:
       {
 	*_pipe >> idx >> index;
@@ -291,7 +374,13 @@ void RooRealMPFE::serverLoop()
 				 << ") IPC fromClient> Retrieve" << endl ;
 	msg = ReturnValue;
 	numErrors = numEvalErrors();
-	*_pipe << msg << _value << getCarry() << numErrors;
+	if (_shm) {
+	  sharedHeader(_shm)->_value = _value ;
+	  sharedHeader(_shm)->_carry = getCarry() ;
+	  *_pipe << msg << numErrors;
+	} else {
+	  *_pipe << msg << _value << getCarry() << numErrors;
+	}
 
 	if (_verboseServer) cout << "RooRealMPFE::serverLoop(" << GetName()
 				 << ") IPC toClient> ReturnValue " << _value << " NumError " << numErrors << endl ;
@@ -427,6 +516,10 @@ void RooRealMPFE::calculate() const
     RooFIter viter = _vars.fwdIterator() ;
     RooFIter siter = _saveVars.fwdIterator() ;
 
+    // Variables are passed through the shared block if its layout matches
+    const Bool_t useShared = _shm && sharedHeader(_shm)->_nVars==_vars.getSize() ;
+    Int_t nShared(0) ;
+
     //for (i=0 ; i<_vars.getSize() ; i++) {
     RooAbsArg *var, *saveVar ;
     while((var = viter.next())) {
@@ -454,7 +547,15 @@ void RooRealMPFE::calculate() const
 	saveVar->copyCache(var) ;
 
 	// send message to server
-	if (dynamic_cast<RooAbsReal*>(var)) {
+	if (useShared && dynamic_cast<RooAbsReal*>(var)) {
+	  sharedValues(_shm)[i] = ((RooAbsReal*)var)->getVal() ;
+	  sharedFlags(_shm)[i] = kChanged | (var->isConstant() ? kConstant : 0) ;
+	  nShared++ ;
+	} else if (useShared && dynamic_cast<RooAbsCategory*>(var)) {
+	  sharedValues(_shm)[i] = ((RooAbsCategory*)var)->getIndex() ;
+	  sharedFlags(_shm)[i] = kChanged | kCategory ;
+	  nShared++ ;
+	} else if (dynamic_cast<RooAbsReal*>(var)) {
 	  int msg = SendReal ;
 	  Double_t val = ((RooAbsReal*)var)->getVal() ;
 	  Bool_t isC = var->isConstant() ;
@@ -473,6 +574,13 @@ void RooRealMPFE::calculate() const
       i++ ;
     }
 
+    if (nShared) {
+      int msg = UpdateShared ;
+      *_pipe << msg;
+      if (_verboseServer) cout << "RooRealMPFE::calculate(" << GetName()
+			       << ") IPC toServer> UpdateShared " << nShared << " variables" << endl ;
+    }
+
     int msg = hideOffset() ? Calculate : CalculateNoOffset;
     *_pipe << msg;
     if (_verboseServer) cout << "RooRealMPFE::calculate(" << GetName()
@@ -570,7 +678,13 @@ Double_t RooRealMPFE::evaluate() const
 
     Int_t numError;
 
-    *_pipe >> msg >> value >> _evalCarry >> numError;
+    if (_shm) {
+      *_pipe >> msg >> numError;
+      value = sharedHeader(_shm)->_value ;
+      _evalCarry = sharedHeader(_shm)->_carry ;
+    } else {
+      *_pipe >> msg >> value >> _evalCarry >> numError;
+    }
 
     if (msg!=ReturnValue) {
       cout << "RooRealMPFE::evaluate(" << GetName()
@@ -643,6 +757,7 @@ void RooRealMPFE::standby()
     // Close pipes
     delete _pipe;
     _pipe = 0;
+    freeShared() ;
 
     // Revert to initialize state
     _state = Initialize;
@@ -652,6 +767,21 @@ void RooRealMPFE::standby()
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Release the block of memory shared with the server process
+
+void RooRealMPFE::freeShared()
+{
+#ifndef _WIN32
+  if (_shm) {
+    ::munmap(_shm,_shmSize) ;
+    _shm = 0 ;
+  }
+#endif // _WIN32
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Intercept call to optimize constant term in test statistics
 /// and forward it to object on server side.
@@ -50,6 +50,7 @@ In the present version \f$coef_i\f$ may not depend on x, but this limitation may
 #include "RooNameReg.h"
 #include <memory>
 #include <algorithm>
+#include <vector>
 
 #include "TError.h"
 
@@ -277,6 +278,146 @@ Double_t RooRealSumPdf::evaluate() const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Batch version of evaluate(): sum the batches of the functions weighted
+/// with the coefficients for the events [begin,end) of 'data'. For the
+/// binned models of HistFactory the functions are the interpolated
+/// templates, which are then calculated as arrays over all bins.
+
+Bool_t RooRealSumPdf::evaluateBatch(Double_t* output, Int_t begin, Int_t end, const RooVectorDataStore& data) const
+{
+  const Int_t n = end-begin ;
+  std::vector<Double_t> funcVal(n) ;
+  std::fill(output,output+n,0.) ;
+
+  RooFIter funcIter = _funcList.fwdIterator() ;
+  RooFIter coefIter = _coefList.fwdIterator() ;
+  RooAbsReal* coef ;
+  RooAbsReal* func ;
+
+  // N funcs, N-1 coefficients 
+  Double_t lastCoef(1) ;
+  while((coef=(RooAbsReal*)coefIter.next())) {
+    func = (RooAbsReal*)funcIter.next() ;
+    Double_t coefVal = coef->getVal() ;
+    if (coefVal) {
+      if (func->isSelectedComp()) {
+	if (!func->getValBatch(&funcVal[0],begin,end,data)) return kFALSE ;
+	for (Int_t i=0 ; i<n ; i++) output[i] += funcVal[i]*coefVal ;
+      }
+      lastCoef -= coefVal ;
+    }
+  }
+
+  if (!_haveLastCoef) {
+    // Add last func with correct coefficient
+    func = (RooAbsReal*) funcIter.next() ;
+    if (func->isSelectedComp()) {
+      if (!func->getValBatch(&funcVal[0],begin,end,data)) return kFALSE ;
+      for (Int_t i=0 ; i<n ; i++) output[i] += funcVal[i]*lastCoef ;
+    }
+
+    // Warn about coefficient degeneration
+    if (lastCoef<0 || lastCoef>1) {
+      coutW(Eval) << "RooRealSumPdf::evaluateBatch(" << GetName() 
+		  << " WARNING: sum of FUNC coefficients not in range [0-1], value=" 
+		  << 1-lastCoef << endl ;
+    } 
+  }
+
+  // Introduce floor if so requested
+  if (_doFloor || _doFloorGlobal) {
+    for (Int_t i=0 ; i<n ; i++) {
+      if (output[i]<0) output[i] = 0 ;
+    }
+  }
+
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the derivatives of the unnormalized value of evaluate() with
+/// respect to 'params' from those of the functions and coefficients. The
+/// derivatives are zero if the floor at zero applies
+
+Bool_t RooRealSumPdf::evaluateGradient(const RooArgList& params, Double_t* grad) const
+{
+  Double_t value ;
+  if (!sumGradient(_funcList,0,kTRUE,params,grad,value)) return kFALSE ;
+
+  if (value<0 && (_doFloor || _doFloorGlobal)) {
+    std::fill(grad,grad+params.getSize(),0.) ;
+  }
+  return kTRUE ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate value = sum_i coef_i*term_i, where 'terms' holds the functions
+/// or their integrals in the order of the function list and the last
+/// coefficient is one minus the sum of the others if it is not given, and
+/// fill 'grad' with its derivatives with respect to 'params'. The
+/// coefficients are evaluated with normalization set 'coefNSet'. If
+/// 'selectedOnly' is true only the terms of selected components are
+/// included, as in evaluate()
+
+Bool_t RooRealSumPdf::sumGradient(const RooArgList& terms, const RooArgSet* coefNSet, Bool_t selectedOnly,
+				  const RooArgList& params, Double_t* grad, Double_t& value) const
+{
+  Int_t n = params.getSize() ;
+  std::fill(grad,grad+n,0.) ;
+  std::vector<Double_t> coefGrad(n), termGrad(n), lastCoefGrad(n,0.) ;
+  value = 0 ;
+
+  RooFIter termIter = terms.fwdIterator() ;
+  RooFIter funcIter = _funcList.fwdIterator() ;
+  RooFIter coefIter = _coefList.fwdIterator() ;
+  RooAbsReal *coef(0), *term(0), *func(0) ;
+
+  // N funcs, N-1 coefficients. Terms with zero coefficient are included
+  // as the derivative of the coefficient need not be zero
+  Double_t lastCoef(1) ;
+  while((coef=(RooAbsReal*)coefIter.next())) {
+    term = (RooAbsReal*)termIter.next() ;
+    func = (RooAbsReal*)funcIter.next() ;
+    Double_t coefVal = coef->getVal(coefNSet) ;
+    if (!coef->gradient(params,coefGrad.data(),coefNSet)) return kFALSE ;
+    lastCoef -= coefVal ;
+    for (Int_t i=0 ; i<n ; i++) {
+      lastCoefGrad[i] -= coefGrad[i] ;
+    }
+    if (selectedOnly && !func->isSelectedComp()) continue ;
+
+    Double_t termVal = term->getVal() ;
+    if (!term->gradient(params,termGrad.data())) return kFALSE ;
+    value += coefVal*termVal ;
+    for (Int_t i=0 ; i<n ; i++) {
+      grad[i] += coefGrad[i]*termVal + coefVal*termGrad[i] ;
+    }
+  }
+
+  if (!_haveLastCoef) {
+    // Add last func with correct coefficient
+    term = (RooAbsReal*)termIter.next() ;
+    func = (RooAbsReal*)funcIter.next() ;
+    if (!selectedOnly || func->isSelectedComp()) {
+      Double_t termVal = term->getVal() ;
+      if (!term->gradient(params,termGrad.data())) return kFALSE ;
+      value += lastCoef*termVal ;
+      for (Int_t i=0 ; i<n ; i++) {
+	grad[i] += lastCoefGrad[i]*termVal + lastCoef*termGrad[i] ;
+      }
+    }
+  }
+
+  return kTRUE ;
+}
+
+
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Check if FUNC is valid for given normalization set.
@@ -459,6 +600,41 @@ Double_t RooRealSumPdf::analyticalIntegralWN(Int_t code, const RooArgSet* normSe
 }
 
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of analyticalIntegralWN() with respect to
+/// 'params', using the derivatives of the integrals of the component
+/// functions. Returns kFALSE if the integration cache for 'code' is not
+/// available
+
+Bool_t RooRealSumPdf::analyticalIntegralGradient(Int_t code, const RooArgList& params, Double_t* grad,
+						 const RooArgSet* normSet2, const char* /*rangeName*/) const
+{
+  if (code==0) return gradient(params,grad,normSet2) ;
+
+  CacheElem* cache = (CacheElem*) _normIntMgr.getObjByIndex(code-1) ;
+  if (cache==0) {
+    return kFALSE ;
+  }
+
+  Double_t value ;
+  if (!sumGradient(cache->_funcIntList,normSet2,normSet2!=0,params,grad,value)) return kFALSE ;
+
+  if (normSet2 && normSet2->getSize()>0) {
+    Double_t normVal ;
+    std::vector<Double_t> normGrad(params.getSize()) ;
+    if (!sumGradient(cache->_funcNormList,normSet2,kFALSE,params,normGrad.data(),normVal) || normVal==0) {
+      return kFALSE ;
+    }
+    for (Int_t i=0 ; i<params.getSize() ; i++) {
+      grad[i] = (grad[i] - value/normVal*normGrad[i]) / normVal ;
+    }
+  }
+
+  return kTRUE ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Double_t RooRealSumPdf::expectedEvents(const RooArgSet* nset) const
@@ -471,6 +647,22 @@ Double_t RooRealSumPdf::expectedEvents(const RooArgSet* nset) const
 }
 
 
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of expectedEvents() with respect to 'params',
+/// which are those of the normalization integral
+
+Bool_t RooRealSumPdf::expectedEventsGradient(const RooArgList& params, Double_t* grad, const RooArgSet* nset) const
+{
+  if (!nset) {
+    std::fill(grad,grad+params.getSize(),0.) ;
+    return kTRUE ;
+  }
+  getNorm(nset) ;
+  return _norm->gradient(params,grad) ;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 
 std::list<Double_t>* RooRealSumPdf::binBoundaries(RooAbsRealLValue& obs, Double_t xlo, Double_t xhi) const
@@ -198,6 +198,23 @@ Double_t RooRealVar::getValV(const RooArgSet*) const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the derivatives of the variable with respect to 'params': one
+/// for the parameter with the same name as the variable, zero otherwise
+
+Bool_t RooRealVar::gradient(const RooArgList& params, Double_t* grad, const RooArgSet*) const
+{
+  RooFIter iter = params.fwdIterator() ;
+  RooAbsArg* param ;
+  Int_t i(0) ;
+  while((param=iter.next())) {
+    grad[i++] = (param->namePtr()==namePtr()) ? 1. : 0. ;
+  }
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set value of variable to 'value'. If 'value' is outside
 /// range of object, clip value into range
@@ -31,6 +31,9 @@ use a TTree as internal storage mechanism
 #include "Riostream.h"
 #include "TTree.h"
 #include "TChain.h"
+#include "TBranch.h"
+#include "TLeaf.h"
+#include "TBufferFile.h"
 #include "TDirectory.h"
 #include "TROOT.h"
 #include "RooFormulaVar.h"
@@ -38,11 +41,18 @@ use a TTree as internal storage mechanism
 #include "RooCategory.h"
 #include "RooNameSet.h"
 #include "RooHistError.h"
+#include "RooNumber.h"
 #include "RooTrace.h"
+#include "RConfigure.h"
 
 #include <iomanip>
 #include <algorithm>
 #include <memory>
+
+#ifdef R__USE_IMT
+#include "tbb/parallel_for.h"
+#endif
+
 using namespace std ;
 
 ClassImp(RooVectorDataStore)
@@ -622,6 +632,55 @@ const RooArgSet* RooVectorDataStore::getNative(Int_t index) const
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the stored values of 'real', matched by name, if it is a column of
+/// this store or of its cache of precalculated nodes, and zero otherwise
+
+const Double_t* RooVectorDataStore::realColumn(const RooAbsReal& real) const
+{
+  std::vector<RealVector*>::const_iterator iter = _realStoreList.begin() ;
+  for (; iter!=_realStoreList.end() ; ++iter) {
+    if ((*iter)->bufArg()->namePtr()==real.namePtr()) {
+      return (*iter)->data() ;
+    }
+  }
+
+  std::vector<RealFullVector*>::const_iterator iter2 = _realfStoreList.begin() ;
+  for (; iter2!=_realfStoreList.end() ; ++iter2) {
+    if ((*iter2)->bufArg()->namePtr()==real.namePtr()) {
+      return (*iter2)->data() ;
+    }
+  }
+
+  return _cache ? _cache->realColumn(real) : 0 ;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill output[0..end-begin) with the weights of the data points
+/// [begin,end). Returns kFALSE if the weights are not available as a column.
+
+Bool_t RooVectorDataStore::weightBatch(Double_t* output, Int_t begin, Int_t end) const
+{
+  const Double_t* column(0) ;
+  if (_extWgtArray) {
+    column = _extWgtArray ;
+  } else if (_wgtVar) {
+    column = realColumn(*_wgtVar) ;
+    if (!column) return kFALSE ;
+  }
+
+  if (column) {
+    std::copy(column+begin,column+end,output) ;
+  } else {
+    std::fill(output,output+(end-begin),_curWgt) ;
+  }
+  return kTRUE ;
+}
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return the weight of the n-th data point (n='index') in memory
 
@@ -834,6 +893,328 @@ void RooVectorDataStore::loadValues(const RooAbsDataStore *ads, const RooFormula
 
 
 
+namespace {
+
+  // Types of the branches read in bulk by RooVectorDataStore::loadValues(const TTree*...)
+  enum BulkType { kBulkNone, kBulkDouble, kBulkFloat, kBulkInt, kBulkUInt, kBulkChar, kBulkUChar, kBulkBool } ;
+
+  // Type of the values of 'branch' if it can be read with TBranch::GetBulkEntries(),
+  // i.e. if it has a single leaf holding one value of a type supported by
+  // RooAbsReal::attachToTree()
+  BulkType bulkType(TBranch* branch) 
+  {
+    if (!branch || branch->IsA()!=TBranch::Class() || branch->GetListOfLeaves()->GetEntriesFast()!=1) return kBulkNone ;
+    TLeaf* leaf = (TLeaf*) branch->GetListOfLeaves()->At(0) ;
+    Int_t dummy ;
+    if (leaf->GetLeafCounter(dummy) || leaf->GetLenStatic()!=1) return kBulkNone ;
+    TString typeName(leaf->GetTypeName()) ;
+    if (typeName=="Double_t") return kBulkDouble ;
+    if (typeName=="Float_t") return kBulkFloat ;
+    if (typeName=="Int_t") return kBulkInt ;
+    if (typeName=="UInt_t") return kBulkUInt ;
+    if (typeName=="Char_t") return kBulkChar ;
+    if (typeName=="UChar_t") return kBulkUChar ;
+    if (typeName=="Bool_t") return kBulkBool ;
+    return kBulkNone ;
+  }
+
+  template<class T> void convertColumn(const char* raw, Int_t n, Double_t* output) 
+  {
+    const T* input = reinterpret_cast<const T*>(raw) ;
+    for (Int_t i=0 ; i<n ; i++) {
+      output[i] = input[i] ;
+    }
+  }
+
+  // Read the entries [first,last) of 'branch' as doubles into 'output'
+  Bool_t readColumn(TBranch* branch, BulkType type, Long64_t first, Long64_t last, Double_t* output, TBufferFile& buf) 
+  {
+    Long64_t entry = first ;
+    while (entry<last) {
+      Int_t n = branch->GetBulkEntries(entry,buf) ;
+      if (n<=0) return kFALSE ;
+      n = (Int_t) std::min(Long64_t(n),last-entry) ;
+      const char* raw = buf.Buffer() ;
+      switch (type) {
+      case kBulkDouble: convertColumn<Double_t>(raw,n,output) ; break ;
+      case kBulkFloat: convertColumn<Float_t>(raw,n,output) ; break ;
+      case kBulkInt: convertColumn<Int_t>(raw,n,output) ; break ;
+      case kBulkUInt: convertColumn<UInt_t>(raw,n,output) ; break ;
+      case kBulkChar: convertColumn<Char_t>(raw,n,output) ; break ;
+      case kBulkUChar: convertColumn<UChar_t>(raw,n,output) ; break ;
+      case kBulkBool: convertColumn<Bool_t>(raw,n,output) ; break ;
+      default: return kFALSE ;
+      }
+      output += n ;
+      entry += n ;
+    }
+    return kTRUE ;
+  }
+
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+/// Load the entries [nStart,nStop) of the tree or chain 't' into this data
+/// collection, optionally selecting events using 'select' RooFormulaVar and
+/// the range 'rangeName' of the variables. Contrary to
+/// RooTreeDataStore::loadValues(), the tree is neither cloned nor read event
+/// by event: the branches of each cluster are read as whole columns (through
+/// the TTreeCache of the tree, and in parallel if implicit multi-threading
+/// is enabled for the tree), the values outside of the range of the
+/// variables are rejected column by column, and the selection is evaluated
+/// with RooAbsReal::getValBatch() where possible.
+///
+/// This requires a branch of the same name for each variable, holding one
+/// value of a type supported by RooAbsReal::attachToTree() (or an Int_t or
+/// UChar_t index for a category), and no stored errors. Returns kFALSE,
+/// without loading anything, otherwise: the caller should then go through a
+/// RooTreeDataStore.
+
+Bool_t RooVectorDataStore::loadValues(const TTree *t, const RooFormulaVar* select, const char* rangeName, Int_t nStart, Int_t nStop) 
+{
+  TTree* tree = const_cast<TTree*>(t) ;
+  if (nStop>tree->GetEntries()) nStop = (Int_t) tree->GetEntries() ;
+  if (nStart>=nStop) return kTRUE ;
+  if (tree->LoadTree(nStart)<0 || !tree->GetTree()) return kFALSE ;
+
+  // Match each variable to its column in this store and to its branch
+  struct Column {
+    RooAbsArg* arg ;
+    RooAbsRealLValue* real ;
+    RooAbsCategory* cat ;
+    TString branchName ;
+    TBranch* branch ;
+    BulkType type ;
+    std::vector<Double_t> values ;
+    std::vector<const RooCatType*> types ;
+  } ;
+  std::vector<Column> columns ;
+  RooFIter iter = _varsww.fwdIterator() ;
+  RooAbsArg* arg ;
+  while ((arg=iter.next())) {
+    Column col ;
+    col.arg = arg ;
+    col.real = dynamic_cast<RooRealVar*>(arg) ;
+    col.cat = dynamic_cast<RooAbsCategory*>(arg) ;
+    col.branchName = arg->cleanBranchName() ;
+    col.branch = 0 ;
+    col.type = bulkType(tree->GetTree()->GetBranch(col.branchName)) ;
+    if (col.type==kBulkNone) return kFALSE ;
+    if (col.real) {
+      if (arg->getAttribute("StoreError") || arg->getAttribute("StoreAsymError") || hasError(col.real) || hasAsymError(col.real)) return kFALSE ;
+    } else if (!col.cat || rangeName || (col.type!=kBulkInt && col.type!=kBulkUChar)) {
+      return kFALSE ;
+    }
+    columns.push_back(col) ;
+  }
+  std::vector<RealVector*> realCols(columns.size(),0) ;
+  std::vector<CatVector*> catCols(columns.size(),0) ;
+  std::vector<std::vector<Double_t>*> realVecs(columns.size(),0) ;
+  std::vector<std::vector<RooCatType>*> catVecs(columns.size(),0) ;
+  const std::vector<Double_t>* wgtVec(0) ;
+  for (UInt_t c=0 ; c<columns.size() ; c++) {
+    if (columns[c].real) {
+      realCols[c] = addReal(columns[c].real) ;
+      realVecs[c] = &realCols[c]->_vec ;
+      if (columns[c].arg==_wgtVar) wgtVec = realVecs[c] ;
+    } else {
+      catCols[c] = addCategory(columns[c].cat) ;
+      catVecs[c] = &catCols[c]->_vec ;
+    }
+  }
+  // The vectors are modified directly, update the pointers cached by get()
+  auto updateVectorPointers = [&]() {
+    for (UInt_t c=0 ; c<columns.size() ; c++) {
+      if (realCols[c]) {
+	realCols[c]->_vec0 = realVecs[c]->empty() ? 0 : &realVecs[c]->front() ;
+      } else {
+	catCols[c]->_vec0 = catVecs[c]->empty() ? 0 : &catVecs[c]->front() ;
+      }
+    }
+  } ;
+
+  // Read only these branches through the cache
+  for (UInt_t c=0 ; c<columns.size() ; c++) {
+    tree->AddBranchToCache(columns[c].branchName,kTRUE) ;
+  }
+  tree->StopCacheLearningPhase() ;
+
+  RooFormulaVar* selectClone(0) ;
+  if (select) {
+    selectClone = (RooFormulaVar*) select->cloneTree() ;
+    selectClone->recursiveRedirectServers(_varsww) ;
+    selectClone->setOperMode(RooAbsArg::ADirty,kTRUE) ;
+  }
+
+  const Int_t n0 = _nEntries ;
+  const Double_t sumWeight0(_sumWeight), sumWeightCarry0(_sumWeightCarry) ;
+  Int_t numInvalid(0) ;
+  Bool_t ok(kTRUE) ;
+  std::vector<char> keep ;
+  std::vector<Double_t> selValues ;
+  Long64_t entry = nStart ;
+  while (ok && entry<nStop) {
+    Long64_t local = tree->LoadTree(entry) ;
+    TTree* cur = tree->GetTree() ;
+    if (local<0 || !cur) {
+      ok = kFALSE ;
+      break ;
+    }
+    TTree::TClusterIterator clusters = cur->GetClusterIterator(local) ;
+    clusters() ;
+    const Long64_t last = std::min(clusters.GetNextEntry(),local+(nStop-entry)) ;
+    const Int_t n = (Int_t) (last-local) ;
+    for (UInt_t c=0 ; c<columns.size() ; c++) {
+      columns[c].branch = cur->GetBranch(columns[c].branchName) ;
+      if (bulkType(columns[c].branch)!=columns[c].type) ok = kFALSE ;
+      columns[c].values.resize(n) ;
+    }
+    if (!ok) break ;
+
+    // Read the columns of the cluster
+    std::vector<char> readOK(columns.size(),1) ;
+    auto readOne = [&](Int_t c) {
+      TBufferFile buf(TBuffer::kRead,32*1024) ;
+      readOK[c] = readColumn(columns[c].branch,columns[c].type,local,last,columns[c].values.data(),buf) ;
+    } ;
+#ifdef R__USE_IMT
+    if (columns.size()>1 && ROOT::IsImplicitMTEnabled() && tree->GetImplicitMT()) {
+      tbb::parallel_for(0,(Int_t)columns.size(),readOne) ;
+    } else
+#endif
+    {
+      for (UInt_t c=0 ; c<columns.size() ; c++) readOne(c) ;
+    }
+    if (std::find(readOK.begin(),readOK.end(),0)!=readOK.end()) {
+      ok = kFALSE ;
+      break ;
+    }
+
+    // Reject the values out of range, as RooAbsArg::isValid() and RooAbsArg::inRange() do
+    keep.assign(n,1) ;
+    for (UInt_t c=0 ; c<columns.size() ; c++) {
+      const Double_t* v = columns[c].values.data() ;
+      if (columns[c].real) {
+	const RooAbsBinning& binning = columns[c].real->getBinning() ;
+	const Double_t vmin(binning.lowBound()), vmax(binning.highBound()) ;
+	if (!RooNumber::isInfinite(vmax)) {
+	  for (Int_t i=0 ; i<n ; i++) keep[i] &= !(v[i] > vmax+1e-6) ;
+	}
+	if (!RooNumber::isInfinite(vmin)) {
+	  for (Int_t i=0 ; i<n ; i++) keep[i] &= !(v[i] < vmin-1e-6) ;
+	}
+	if (rangeName) {
+	  const Double_t rmin(columns[c].real->getMin(rangeName)), rmax(columns[c].real->getMax(rangeName)) ;
+	  for (Int_t i=0 ; i<n ; i++) {
+	    const Double_t epsilon = 1e-8*fabs(v[i]) ;
+	    keep[i] &= (v[i] >= rmin-epsilon && v[i] <= rmax+epsilon) ;
+	  }
+	}
+      } else {
+	std::vector<const RooCatType*>& types = columns[c].types ;
+	types.resize(n) ;
+	for (Int_t i=0 ; i<n ; i++) {
+	  types[i] = (i>0 && v[i]==v[i-1]) ? types[i-1] : columns[c].cat->lookupType((Int_t)v[i]) ;
+	  keep[i] &= (types[i]!=0) ;
+	}
+      }
+    }
+
+    // Append the valid rows to the columns
+    const Int_t first = _nEntries ;
+    const Int_t nkept = (Int_t) std::count(keep.begin(),keep.end(),1) ;
+    numInvalid += n-nkept ;
+    for (UInt_t c=0 ; c<columns.size() ; c++) {
+      if (realVecs[c]) {
+	std::vector<Double_t>& vec = *realVecs[c] ;
+	vec.reserve(first+nkept) ;
+	const Double_t* v = columns[c].values.data() ;
+	for (Int_t i=0 ; i<n ; i++) {
+	  if (keep[i]) vec.push_back(v[i]) ;
+	}
+      } else {
+	std::vector<RooCatType>& vec = *catVecs[c] ;
+	vec.reserve(first+nkept) ;
+	for (Int_t i=0 ; i<n ; i++) {
+	  if (keep[i]) vec.push_back(*columns[c].types[i]) ;
+	}
+      }
+    }
+    updateVectorPointers() ;
+    _nEntries += nkept ;
+
+    // Apply the selection to the new rows
+    if (selectClone && nkept>0) {
+      selValues.resize(nkept) ;
+      if (!selectClone->getValBatch(selValues.data(),first,first+nkept,*this)) {
+	for (Int_t i=0 ; i<nkept ; i++) {
+	  get(first+i) ;
+	  selValues[i] = selectClone->getVal() ;
+	}
+      }
+      Int_t nsel(0) ;
+      for (Int_t i=0 ; i<nkept ; i++) {
+	if (selValues[i]!=0) {
+	  for (UInt_t c=0 ; c<columns.size() ; c++) {
+	    if (realVecs[c]) {
+	      (*realVecs[c])[first+nsel] = (*realVecs[c])[first+i] ;
+	    } else {
+	      (*catVecs[c])[first+nsel] = (*catVecs[c])[first+i] ;
+	    }
+	  }
+	  nsel++ ;
+	}
+      }
+      for (UInt_t c=0 ; c<columns.size() ; c++) {
+	if (realVecs[c]) {
+	  realVecs[c]->resize(first+nsel) ;
+	} else {
+	  catVecs[c]->resize(first+nsel) ;
+	}
+      }
+      updateVectorPointers() ;
+      _nEntries = first+nsel ;
+    }
+
+    // use Kahan's algorithm to sum up weights as fill() does
+    for (Int_t i=first ; i<_nEntries ; i++) {
+      Double_t y = (wgtVec ? (*wgtVec)[i] : 1.) - _sumWeightCarry;
+      Double_t tsum = _sumWeight + y;
+      _sumWeightCarry = (tsum - _sumWeight) - y;
+      _sumWeight = tsum;
+    }
+
+    entry += last-local ;
+  }
+
+  delete selectClone ;
+
+  if (!ok) {
+    // Leave the store as it was for the caller to fall back
+    for (UInt_t c=0 ; c<columns.size() ; c++) {
+      if (realVecs[c]) {
+	realVecs[c]->resize(n0) ;
+      } else {
+	catVecs[c]->resize(n0) ;
+      }
+    }
+    updateVectorPointers() ;
+    _nEntries = n0 ;
+    _sumWeight = sumWeight0 ;
+    _sumWeightCarry = sumWeightCarry0 ;
+    return kFALSE ;
+  }
+
+  if (numInvalid>0) {
+    coutI(Eval) << "RooVectorDataStore::loadValues(" << GetName() << ") Ignored " << numInvalid << " out of range events" << endl ;
+  }
+  return kTRUE ;
+}
+
+
+
 
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1005,6 +1386,53 @@ RooArgSet* RooVectorDataStore::addColumns(const RooArgList& varList)
 
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Add columns holding values which are already calculated: the values of
+/// the real valued i-th element of 'varList' for all data points are moved
+/// from values[i] into the new column, without evaluating the element.
+/// This is the bulk equivalent of addColumns() for values computed by the
+/// caller, e.g. sWeights. Returns the place holders of the new columns, or
+/// zero if an element is not real valued or if a vector has not one value
+/// per data point.
+
+RooArgSet* RooVectorDataStore::addRealColumns(const RooArgList& varList, std::vector<std::vector<Double_t> >& values)
+{
+  checkInit() ;
+
+  if (varList.getSize()!=Int_t(values.size())) {
+    coutE(InputArguments) << GetName() << "::addRealColumns: " << values.size() << " columns of values for "
+			  << varList.getSize() << " variables" << endl ;
+    return 0 ;
+  }
+  for (Int_t i=0 ; i<varList.getSize() ; i++) {
+    if (!dynamic_cast<RooAbsReal*>(varList.at(i)) || Int_t(values[i].size())!=numEntries()) {
+      coutE(InputArguments) << GetName() << "::addRealColumns: no column of " << numEntries()
+			    << " real values for \"" << varList.at(i)->GetName() << "\"" << endl ;
+      return 0 ;
+    }
+  }
+
+  RooArgSet* holderSet = new RooArgSet ;
+  for (Int_t i=0 ; i<varList.getSize() ; i++) {
+    // Create a fundamental object to hold the values
+    RooAbsArg* valHolder = varList.at(i)->createFundamental() ;
+    holderSet->add(*valHolder) ;
+
+    // Attach value place holder to this store
+    valHolder->attachToVStore(*this) ;
+    _vars.add(*valHolder) ;
+
+    RealVector* rv = addReal((RooAbsReal*)valHolder) ;
+    rv->_vec.swap(values[i]) ;
+    rv->_vec0 = rv->_vec.size()>0 ? &rv->_vec.front() : 0 ;
+    values[i].clear() ;
+  }
+
+  return holderSet ;
+}
+
+
+
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Merge columns of supplied data set(s) with this data set.  All
@@ -1310,6 +1738,7 @@ void RooVectorDataStore::recalculateCache( const RooArgSet *projectedArgs, Int_t
       tv[ntv] = (*(_cache->_firstReal+i)) ;
       tv[ntv]->_nativeReal->setOperMode(RooAbsArg::ADirty) ;
       tv[ntv]->_nativeReal->_operMode=RooAbsArg::Auto ;
+      RooAbsArg::graphChanged() ;
 //       cout << "recalculate: need to update " << tv[ntv]->_nativeReal->GetName() << endl ;
       ntv++ ;
     }    
@@ -2616,6 +2616,9 @@ void RooWorkspace::Streamer(TBuffer &R__b)
    if (R__b.IsReading()) {
 
       R__b.ReadClassBuffer(RooWorkspace::Class(),this);
+
+      // Use a hash table for lookups by name in large workspaces, as in import()
+      if (_allOwnedNodes.getSize() > 999) _allOwnedNodes.setHashTableSize(1000);
             
       // Perform any pass-2 schema evolution here
       RooFIter fiter = _allOwnedNodes.fwdIterator() ;
@@ -2719,6 +2722,9 @@ void RooWorkspace::Streamer(TBuffer &R__b)
        }
      }
 
+     // Links were modified directly
+     RooAbsArg::graphChanged() ;
+
    }
 }
 
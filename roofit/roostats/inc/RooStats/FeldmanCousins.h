@@ -29,6 +29,8 @@
 #include "RooArgSet.h"
 #include "TList.h"
 
+#include <string>
+
 class RooAbsData; 
 
 namespace RooStats {
@@ -128,6 +130,14 @@ by the Neyman-Pearson lemma.  When nuisance parameters are involved, the profile
       }
       void CreateConfBelt(bool flag=true){fCreateBelt = flag;}
 
+      /// run the parameter points of the construction in nWorkers forked processes
+      /// (see NeymanConstruction::SetNWorkers)
+      void SetNWorkers(UInt_t nWorkers = 0) {fNWorkers = nWorkers;}
+
+      /// store the finished points in the ROOT file fileName to resume an interrupted
+      /// construction (see NeymanConstruction::SetCheckpointFile)
+      void SetCheckpointFile(const char* fileName) {fCheckpointFile = fileName ? fileName : "";}
+
       /// Returns instance of TestStatSampler. Use to change properties of
       /// TestStatSampler, e.g. GetTestStatSampler.SetTestSize(Double_t size);
       TestStatSampler* GetTestStatSampler() const;
@@ -163,6 +173,8 @@ by the Neyman-Pearson lemma.  When nuisance parameters are involved, the profile
       Bool_t fDoProfileConstruction; // instead of full construction over nuisance parametrs, do profile
       Bool_t fSaveBeltToFile; // controls use if ConfidenceBelt should be saved to a TFile
       Bool_t fCreateBelt; // controls use if ConfidenceBelt should be saved to a TFile
+      UInt_t fNWorkers; //! number of worker processes running the points
+      std::string fCheckpointFile; //! file storing the results of the finished points
 
    protected:
       ClassDef(FeldmanCousins,2)   // Interface for tools setting limits (producing confidence intervals)
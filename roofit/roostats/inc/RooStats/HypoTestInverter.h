@@ -162,6 +162,12 @@ public:
    // set numerical error in test statistic evaluation (default is zero)
    void SetNumErr(double err) { fNumErr = err; }
 
+   // run the points of a fixed scan in nWorkers forked processes (0 or 1 for a serial scan)
+   // In the automatic scan (RunLimit) the points depend on each other and are run one after
+   // the other, but the toys of each point are then split among the workers
+   void SetNWorkers(unsigned int nWorkers = 0) { fNWorkers = nWorkers; }
+   unsigned int GetNWorkers() const { return fNWorkers; }
+
    // set flag to close proof for every new run
    static void SetCloseProof(Bool_t flag);
 
@@ -179,6 +185,15 @@ protected:
    // run the hybrid at a single point
    HypoTestResult * Eval( HypoTestCalculatorGeneric &hc, bool adaptive , double clsTarget) const;
 
+   // set the scanned variable to rVal and run the hypothesis test
+   HypoTestResult * EvalPoint( double & rVal, bool adaptive, double clTarget) const;
+
+   // add the result of a point to the HypoTestInverterResult
+   bool AddResult( double rVal, HypoTestResult * result) const;
+
+   // run several points in parallel in the worker processes
+   bool RunPoints( const std::vector<double> & xValues) const;
+
    // helper functions 
    static RooRealVar * GetVariableToScan(const HypoTestCalculatorGeneric &hc);    
    static void CheckInputModels(const HypoTestCalculatorGeneric &hc, const RooRealVar & scanVar);    
@@ -215,6 +230,7 @@ private:
    double fXmin; 
    double fXmax; 
    double fNumErr;
+   unsigned int fNWorkers;  //! number of worker processes for the scan
 
 protected:
 
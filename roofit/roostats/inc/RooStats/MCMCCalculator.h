@@ -41,6 +41,8 @@
 #include "RooStats/MCMCInterval.h"
 #endif
 
+#include <vector>
+
 
 namespace RooStats {
 
@@ -136,6 +138,20 @@ namespace RooStats {
       virtual void SetNumBurnInSteps(Int_t numBurnInSteps)
       { fNumBurnInSteps = numBurnInSteps; }
 
+      /// set the number of independent Markov chains sharing the iterations.
+      /// With several chains the burn-in steps are discarded from each chain
+      /// before they are merged (see MetropolisHastings::SetNumChains)
+      virtual void SetNumChains(Int_t numChains) { fNumChains = numChains > 1 ? numChains : 1; }
+
+      /// run the chains in nWorkers forked processes (0 or 1 for a serial run)
+      virtual void SetNWorkers(UInt_t nWorkers = 0) { fNWorkers = nWorkers; }
+
+      /// enable parallel tempering with replicas at the given temperatures (> 1),
+      /// exchanging their points every swapInterval iterations
+      /// (see MetropolisHastings::SetTemperatures)
+      virtual void SetTemperatures(const std::vector<Double_t> & temperatures, Int_t swapInterval = 1)
+      { fTemperatures = temperatures; fSwapInterval = swapInterval; }
+
       /// set the number of bins to create for each axis when constructing the interval
       virtual void SetNumBins(Int_t numBins) { fNumBins = numBins; }
       /// set which variables to put on each axis
@@ -227,6 +243,10 @@ namespace RooStats {
                        // floating-point arithmetic does not always work
                        // perfectly, and the Abs doesn't hurt
       enum MCMCInterval::IntervalType fIntervalType; // type of interval to find
+      Int_t fNumChains; // number of independent Markov chains
+      UInt_t fNWorkers; //! number of forked worker processes running the chains
+      std::vector<Double_t> fTemperatures; // temperatures of the replicas of parallel tempering
+      Int_t fSwapInterval; // number of iterations between the exchanges of the replicas
 
       void SetupBasicUsage();
       void SetBins(const RooAbsCollection& coll, Int_t numBins) const
@@ -239,7 +259,7 @@ namespace RooStats {
          delete it;
       }
 
-      ClassDef(MCMCCalculator,3) // Markov Chain Monte Carlo calculator for Bayesian credible intervals
+      ClassDef(MCMCCalculator,4) // Markov Chain Monte Carlo calculator for Bayesian credible intervals
    };
 }
 
@@ -31,6 +31,8 @@
 #include "RooStats/MarkovChain.h"
 #endif
 
+#include <vector>
+
 namespace RooStats {
 
 /**
@@ -62,7 +64,23 @@ namespace RooStats {
 
    Also note that in ConstructChain(), the values of the variables are randomized
    uniformly over their intervals before construction of the MarkovChain begins.
-   
+
+   Several independent chains can be run with SetNumChains(n): the iterations
+   are shared among the chains, each of which starts from its own random point
+   and uses its own seed of RooRandom, derived from the current state of the
+   generator. With SetNWorkers(m) the chains are run in m processes forked by
+   ROOT::TProcessExecutor, otherwise one after the other; the result is the
+   same for a given seed. The first SetNumBurnInSteps() steps of each chain
+   are discarded before the chains are merged into the returned MarkovChain,
+   so that no further burn-in has to be applied to it.
+
+   Parallel tempering is enabled by SetTemperatures(): each chain then runs
+   one replica at each of the given temperatures T > 1, sampling the function
+   raised to the power 1/T, next to the replica at T = 1. Adjacent replicas
+   exchange their points every SetSwapInterval() iterations according to the
+   Metropolis criterion, which lets the chain escape local maxima of
+   multimodal functions. Only the points of the replica at T = 1 are stored.
+
 */
 
 
@@ -109,6 +127,22 @@ namespace RooStats {
       virtual void SetSign(enum FunctionSign sign) { fSign = sign; }
       // set the type of the function
       virtual void SetType(enum FunctionType type) { fType = type; }
+      // set the number of independent chains sharing the iterations,
+      // merged into one MarkovChain after their burn-in
+      virtual void SetNumChains(Int_t numChains)
+      { fNumChains = numChains > 1 ? numChains : 1; }
+      // run the chains in nWorkers forked processes (0 or 1 for a serial run)
+      virtual void SetNWorkers(UInt_t nWorkers = 0) { fNWorkers = nWorkers; }
+      // set the temperatures (> 1) of the replicas of parallel tempering,
+      // an empty ladder disables it
+      virtual void SetTemperatures(const std::vector<Double_t>& temperatures)
+      { fTemperatures = temperatures; }
+      // set the number of iterations between the exchanges of the points
+      // of the tempered replicas
+      virtual void SetSwapInterval(Int_t swapInterval)
+      { fSwapInterval = swapInterval > 1 ? swapInterval : 1; }
+      Int_t GetNumChains() const { return fNumChains; }
+      UInt_t GetNWorkers() const { return fNWorkers; }
 
 
    protected:
@@ -120,12 +154,20 @@ namespace RooStats {
       Int_t fNumBurnInSteps; // number of iterations to discard as burn-in, starting from the first
       enum FunctionSign fSign; // whether the likelihood is negative (like NLL) or positive
       enum FunctionType fType; // whether the likelihood is on a regular, log, (or other) scale
+      Int_t fNumChains; // number of independent chains
+      UInt_t fNWorkers; //! number of forked worker processes, serial run if 0 or 1
+      std::vector<Double_t> fTemperatures; // temperatures of the replicas of parallel tempering
+      Int_t fSwapInterval; // number of iterations between the exchanges of the replicas
 
       // whether we should take the step, based on the value of d, fSign, fType
       virtual Bool_t ShouldTakeStep(Double_t d);
       virtual Double_t CalcNLL(Double_t xL);
+      // run one chain (with its tempered replicas) of numIters iterations
+      virtual MarkovChain* ConstructSingleChain(Int_t numIters);
+      // find a random starting point where the function can be evaluated
+      virtual Bool_t FindStartingPoint(RooArgSet& x, Double_t& xL);
 
-      ClassDef(MetropolisHastings,2) // Markov Chain Monte Carlo calculator for Bayesian credible intervals
+      ClassDef(MetropolisHastings,3) // Markov Chain Monte Carlo calculator for Bayesian credible intervals
    };
 }
 
@@ -30,6 +30,8 @@
 #include "RooArgSet.h"
 #include "TList.h"
 
+#include <string>
+
 class RooAbsData; 
 
 namespace RooStats {
@@ -53,6 +55,8 @@ This class is fairly light weight, because the choice of parameter points to be
 *   defining the acceptance region in the data by finding the thresholds on the test statistic such that the integral of the sampling distribution is of the appropriate size and consistent with the limits of integration (eg. upper/lower/central limits),
 *   and finally updating the PointSetInterval based on whether the value of the test statistic evaluated on the data are in the acceptance region.
 
+The parameter points are independent of each other: with SetNWorkers(n) they are distributed among n processes forked by ROOT::TProcessExecutor, each working on its own copy of the model and sampler, with the random generator seeded for every point from a sequence derived from the current state of RooRandom. With SetCheckpointFile() the result of every finished point is stored in a ROOT file, and the points found there are not run again, so that an interrupted construction can be resumed by running it again with the same file.
+
 */
 
    class NeymanConstruction : public IntervalCalculator{
@@ -140,9 +144,24 @@ This class is fairly light weight, because the choice of parameter points to be
       /// TestStatSampler, e.g. GetTestStatSampler.SetTestSize(Double_t size);
       TestStatSampler* GetTestStatSampler(void) { return fTestStatSampler; }
 
+      /// run the parameter points in nWorkers forked processes (0 or 1 for a serial run)
+      void SetNWorkers(UInt_t nWorkers = 0) { fNWorkers = nWorkers; }
+      UInt_t GetNWorkers() const { return fNWorkers; }
+
+      /// store the result of each finished point in the ROOT file fileName and skip
+      /// the points already stored there, so that an interrupted construction resumes
+      /// (an empty name disables the checkpoints)
+      void SetCheckpointFile(const char* fileName) { fCheckpointFile = fileName ? fileName : ""; }
+      const char* GetCheckpointFile() const { return fCheckpointFile.c_str(); }
+
       
    private:
 
+      /// generate the sampling distribution at the point i and find its acceptance
+      /// region and the value of the test statistic on the data
+      SamplingDistribution* EvalPoint(Int_t i, Double_t& testStatistic,
+                                      Double_t& lowerEdge, Double_t& upperEdge) const;
+
       Double_t fSize; /// size of the test (eg. specified rate of Type I error)
       RooAbsData& fData; /// data set 
       ModelConfig &fModel;
@@ -160,6 +179,8 @@ This class is fairly light weight, because the choice of parameter points to be
       Double_t fAdditionalNToysFactor; // give user ability to ask for more toys
       bool fSaveBeltToFile; // controls use if ConfidenceBelt should be saved to a TFile
       bool fCreateBelt; // controls use if ConfidenceBelt should be saved to a TFile
+      UInt_t fNWorkers; //! number of worker processes running the points
+      std::string fCheckpointFile; //! file storing the results of the finished points
 
    protected:
       ClassDef(NeymanConstruction,1)   // Interface for tools setting limits (producing confidence intervals)
@@ -51,6 +51,11 @@ namespace RooStats{
    Create an instance of the class by supplying a data set,
    the pdf, and a list of the yield variables.  The SPlot Class
    will calculate SWeights and include these as columns in the RooDataSet.
+
+   With SetNWorkers(n), the values of the pdf of each species, which are
+   the bulk of the calculation, are computed for n contiguous chunks of the
+   events by n processes forked with ROOT::TProcessExecutor. Use the
+   constructor without the pdf, then SetNWorkers() and AddSWeight().
    
 */
 
@@ -85,6 +90,10 @@ namespace RooStats{
 
     Double_t GetSWeight(Int_t numEvent, const char* sVariable) const;
 
+    // number of worker processes computing the pdf values in AddSWeight, serial if 0 or 1
+    void SetNWorkers(UInt_t nWorkers = 0) { fNWorkers = nWorkers; }
+    UInt_t GetNWorkers() const { return fNWorkers; }
+
 
     
   protected:
@@ -99,6 +108,8 @@ namespace RooStats{
     
     RooDataSet* fSData;
 
+    UInt_t fNWorkers; //! number of worker processes computing the pdf values
+
     ClassDef(SPlot,1)   // Class used for making sPlots
       
       
@@ -112,6 +112,7 @@ class ToyMCSampler: public TestStatSampler {
       virtual SamplingDistribution* GetSamplingDistribution(RooArgSet& paramPoint);
       virtual RooDataSet* GetSamplingDistributions(RooArgSet& paramPoint);
       virtual RooDataSet* GetSamplingDistributionsSingleWorker(RooArgSet& paramPoint);
+      virtual RooDataSet* GetSamplingDistributionsMultiProcess(RooArgSet& paramPoint);
 
       virtual SamplingDistribution* AppendSamplingDistribution(
          RooArgSet& allParameters, 
@@ -262,6 +263,11 @@ class ToyMCSampler: public TestStatSampler {
       // calling with argument or NULL deactivates proof
       void SetProofConfig(ProofConfig *pc = NULL) { fProofConfig = pc; }
 
+      // generate and evaluate the toys in nWorkers forked processes when
+      // proof is not used (0 or 1 for a serial run)
+      void SetNWorkers(UInt_t nWorkers = 0) { fNWorkers = nWorkers; }
+      UInt_t GetNWorkers() const { return fNWorkers; }
+
       void SetProtoData(const RooDataSet* d) { fProtoData = d; }
       
    protected:
@@ -307,6 +313,7 @@ class ToyMCSampler: public TestStatSampler {
       const RooDataSet *fProtoData; // in dev
       
       ProofConfig *fProofConfig;   //!
+      UInt_t fNWorkers;   //! number of forked worker processes, serial run if 0 or 1
       
       mutable NuisanceParametersSampler *fNuisanceParametersSampler; //!
 
@@ -84,7 +84,8 @@ FeldmanCousins::FeldmanCousins(RooAbsData& data, ModelConfig& model) :
   fFluctuateData(true),
   fDoProfileConstruction(true),
   fSaveBeltToFile(false),
-  fCreateBelt(false)
+  fCreateBelt(false),
+  fNWorkers(0)
 {
 }
 
@@ -263,6 +264,8 @@ PointSetInterval* FeldmanCousins::GetInterval() const {
   nc.AdditionalNToysFactor(fAdditionalNToysFactor);
   nc.SaveBeltToFile(fSaveBeltToFile);
   nc.CreateConfBelt(fCreateBelt);
+  nc.SetNWorkers(fNWorkers);
+  nc.SetCheckpointFile(fCheckpointFile.c_str());
   fConfBelt = nc.GetConfidenceBelt();
   // use it
   return nc.GetInterval();
@@ -48,6 +48,10 @@
 
 #include "RooStats/ProofConfig.h"
 
+#include "TRandom2.h"
+#include "ROOT/TProcessExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+
 ClassImp(RooStats::HypoTestInverter)
 
 using namespace RooStats;
@@ -149,7 +153,8 @@ HypoTestInverter::HypoTestInverter( ) :
    fVerbose(0),
    fCalcType(kUndefined), 
    fNBins(0), fXmin(1), fXmax(1),
-   fNumErr(0)
+   fNumErr(0),
+   fNWorkers(0)
 {
   // default constructor (doesn't do anything) 
 }
@@ -167,7 +172,8 @@ HypoTestInverter::HypoTestInverter( HypoTestCalculatorGeneric& hc,
    fVerbose(0),
    fCalcType(kUndefined), 
    fNBins(0), fXmin(1), fXmax(1),
-   fNumErr(0)
+   fNumErr(0),
+   fNWorkers(0)
 {
    // Constructor from a HypoTestCalculatorGeneric
    // The HypoTest calculator must be a FrequentistCalculator or HybridCalculator type 
@@ -221,7 +227,8 @@ HypoTestInverter::HypoTestInverter( HybridCalculator& hc,
    fVerbose(0),
    fCalcType(kHybrid), 
    fNBins(0), fXmin(1), fXmax(1),
-   fNumErr(0)
+   fNumErr(0),
+   fNWorkers(0)
 {
    // Constructor from a reference to a HybridCalculator 
    // The calculator must be created before by using the S+B model for the null and 
@@ -255,7 +262,8 @@ HypoTestInverter::HypoTestInverter( FrequentistCalculator& hc,
    fVerbose(0),
    fCalcType(kFrequentist), 
    fNBins(0), fXmin(1), fXmax(1),
-   fNumErr(0)
+   fNumErr(0),
+   fNWorkers(0)
 {
    // Constructor from a reference to a FrequentistCalculator  
    // The calculator must be created before by using the S+B model for the null and 
@@ -285,7 +293,8 @@ HypoTestInverter::HypoTestInverter( AsymptoticCalculator& hc,
    fVerbose(0),
    fCalcType(kAsymptotic), 
    fNBins(0), fXmin(1), fXmax(1),
-   fNumErr(0)
+   fNumErr(0),
+   fNWorkers(0)
 {
    // Constructor from a reference to a AsymptoticCalculator 
    // The calculator must be created before by using the S+B model for the null and 
@@ -324,7 +333,8 @@ HypoTestInverter::HypoTestInverter( RooAbsData& data, ModelConfig &sbModel, Mode
    fVerbose(0),
    fCalcType(type), 
    fNBins(0), fXmin(1), fXmax(1),
-   fNumErr(0)
+   fNumErr(0),
+   fNWorkers(0)
 {
    if(fCalcType==kFrequentist) fHC.reset(new FrequentistCalculator(data, bModel, sbModel)); 
    if(fCalcType==kHybrid) fHC.reset( new HybridCalculator(data, bModel, sbModel)) ; 
@@ -374,6 +384,7 @@ HypoTestInverter & HypoTestInverter::operator= (const HypoTestInverter & rhs) {
    fXmin = rhs.fXmin;
    fXmax = rhs.fXmax;
    fNumErr = rhs.fNumErr;
+   fNWorkers = rhs.fNWorkers;
 
    return *this;
 }
@@ -600,6 +611,7 @@ bool HypoTestInverter::RunFixedScan( int nBins, double xMin, double xMax, bool s
                                           << xMax << std::endl; 
    }         
 
+   std::vector<double> xValues(nBins);
    double thisX = xMin; 
    for (int i=0; i<nBins; i++) {
       
@@ -609,8 +621,15 @@ bool HypoTestInverter::RunFixedScan( int nBins, double xMin, double xMax, bool s
          else
             thisX = xMin + i*(xMax-xMin)/(nBins-1);          // linear scan in x 
       }
+      xValues[i] = thisX;
+   }
+
+   // distribute the points among the worker processes
+   if (fNWorkers > 1 && nBins > 1) return RunPoints(xValues);
+
+   for (int i=0; i<nBins; i++) {
          
-      bool status = RunOnePoint(thisX);
+      bool status = RunOnePoint(xValues[i]);
       
       // check if failed status
       if ( status==false ) {
@@ -625,11 +644,11 @@ bool HypoTestInverter::RunFixedScan( int nBins, double xMin, double xMax, bool s
 }
 
 
-bool HypoTestInverter::RunOnePoint( double rVal, bool adaptive, double clTarget) const
+HypoTestResult * HypoTestInverter::EvalPoint( double & rVal, bool adaptive, double clTarget) const
 {
-   // run only one point at the given POI value
-
-   CreateResults();
+   // run the hypothesis test at the given POI value, which is moved
+   // inside the range of the scanned variable if needed
+   // (internal function called by RunOnePoint and RunPoints)
 
    // check if rVal is in the range specified for fScannedVariable
    if ( rVal < fScannedVariable->getMin() ) {
@@ -665,15 +684,28 @@ bool HypoTestInverter::RunOnePoint( double rVal, bool adaptive, double clTarget)
    
    // compute the results
    HypoTestResult* result =   Eval(*fCalculator0,adaptive,clTarget);
+
+   fScannedVariable->setVal(oldValue);
+
+   return result;
+}
+
+
+bool HypoTestInverter::AddResult( double rVal, HypoTestResult * result) const
+{
+   // store the result of the hypothesis test at rVal in the HypoTestInverterResult,
+   // merging it with the previous one if it was computed at the same point.
+   // Return false if the hypothesis test failed (null result)
+
    if (!result) { 
       oocoutE((TObject*)0,Eval) << "HypoTestInverter - Error running point " << fScannedVariable->GetName() << " = " <<
-   fScannedVariable->getVal() << endl;
+   rVal << endl;
       return false;
    }
    // in case of a dummy result
    if (TMath::IsNaN(result->NullPValue() ) && TMath::IsNaN(result->AlternatePValue() ) ) {
       oocoutW((TObject*)0,Eval) << "HypoTestInverter - Skip invalid result for  point " << fScannedVariable->GetName() << " = " <<
-         fScannedVariable->getVal() << endl;
+         rVal << endl;
       return true;  // need to return true to avoid breaking the scan loop
    }
    
@@ -709,12 +741,90 @@ bool HypoTestInverter::RunOnePoint( double rVal, bool adaptive, double clTarget)
       // std::cout << "computed value for poi  " << rVal  << " : " << fResults->GetYValue(fResults->ArraySize()-1) 
       //        << " +/- " << fResults->GetYError(fResults->ArraySize()-1) << endl;
 
-   fScannedVariable->setVal(oldValue);
-   
    return true;
 }
 
 
+bool HypoTestInverter::RunOnePoint( double rVal, bool adaptive, double clTarget) const
+{
+   // run only one point at the given POI value
+
+   CreateResults();
+
+   HypoTestResult* result = EvalPoint(rVal, adaptive, clTarget);
+
+   return AddResult(rVal, result);
+}
+
+
+bool HypoTestInverter::RunPoints( const std::vector<double> & xValues) const
+{
+   // run the points of a scan in parallel in fNWorkers forked processes and
+   // add the results in order to the HypoTestInverterResult.
+   // Each process works on its own copy of the calculator and of the model,
+   // and the random generator is seeded for every point with a seed
+   // derived from the current state of RooRandom, so that the toys of the
+   // different points are independent and the result is reproducible.
+   // Processes are used rather than threads because the fits and the toy
+   // generation share global state of RooFit which is not thread safe.
+
+   CreateResults();
+
+   std::vector<UInt_t> seeds(xValues.size());
+   TRandom2 r(RooRandom::randomGenerator()->Integer(TMath::Limits<unsigned int>::Max()));
+   for (unsigned int i = 0; i < seeds.size(); ++i) seeds[i] = r.Integer(TMath::Limits<unsigned int>::Max());
+
+   oocoutP((TObject*)0,Eval) << "HypoTestInverter::RunPoints - running " << xValues.size() << " points in "
+                             << std::min<unsigned int>(fNWorkers, xValues.size()) << " worker processes" << std::endl;
+
+   // executed in the worker processes
+   auto work = [&](unsigned int i) -> HypoTestResult* {
+      RooRandom::randomGenerator()->SetSeed(seeds[i]);
+      double rVal = xValues[i];
+      return EvalPoint(rVal, false, -1);
+   };
+
+   ROOT::TProcessExecutor workers(std::min<unsigned int>(fNWorkers, xValues.size()));
+   std::vector<HypoTestResult*> results = workers.Map(work, ROOT::TSeqU(xValues.size()));
+
+   bool ret = true;
+   for (unsigned int i = 0; i < results.size(); ++i) {
+      // the number of toys cannot be counted in the worker processes
+      if (results[i] && (fCalcType == kFrequentist || fCalcType == kHybrid) &&
+          results[i]->GetNullDistribution() && results[i]->GetAltDistribution())
+         fTotalToysRun += results[i]->GetAltDistribution()->GetSize() + results[i]->GetNullDistribution()->GetSize();
+
+      double rVal = std::min(std::max(xValues[i], fScannedVariable->getMin()), fScannedVariable->getMax());
+      if (!ret) {
+         delete results[i];
+         continue;
+      }
+      if (!AddResult(rVal, results[i])) {
+         std::cout << "\t\tLoop interrupted because of failed status\n";
+         ret = false;
+      }
+   }
+
+   return ret;
+}
+
+
+
+namespace {
+   // use a number of worker processes in a ToyMCSampler during the lifetime of the object
+   struct ToyMCSamplerWorkers {
+      ToyMCSamplerWorkers(TestStatSampler * sampler, unsigned int nWorkers) :
+         fSampler(dynamic_cast<ToyMCSampler*>(sampler)), fOldNWorkers(0) {
+         if (fSampler) {
+            fOldNWorkers = fSampler->GetNWorkers();
+            if (fOldNWorkers < 2) fSampler->SetNWorkers(nWorkers);
+         }
+      }
+      ~ToyMCSamplerWorkers() { if (fSampler) fSampler->SetNWorkers(fOldNWorkers); }
+      ToyMCSampler * fSampler;
+      unsigned int fOldNWorkers;
+   };
+}
 
 bool HypoTestInverter::RunLimit(double &limit, double &limitErr, double absAccuracy, double relAccuracy, const double*hint) const {
    // run an automatic scan until the desired accurancy is reached
@@ -730,6 +840,11 @@ bool HypoTestInverter::RunLimit(double &limit, double &limitErr, double absAccur
    RooRealVar *r = fScannedVariable; 
    //w->loadSnapshot("clean");
 
+   // each point of the scan depends on the previous ones, so use the worker
+   // processes for the toys of the points instead
+   std::unique_ptr<ToyMCSamplerWorkers> toyWorkers;
+   if (fNWorkers > 1 && fCalculator0) toyWorkers.reset(new ToyMCSamplerWorkers(fCalculator0->GetTestStatSampler(), fNWorkers));
+
   if ((hint != 0) && (*hint > r->getMin())) {
      r->setMax(std::min<double>(3.0 * (*hint), r->getMax()));
      r->setMin(std::max<double>(0.3 * (*hint), r->getMin()));
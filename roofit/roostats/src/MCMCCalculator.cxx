@@ -69,7 +69,10 @@ MCMCCalculator::MCMCCalculator() :
    fPdf(0), 
    fPriorPdf(0),
    fData(0),
-   fAxes(0)
+   fAxes(0),
+   fNumChains(1),
+   fNWorkers(0),
+   fSwapInterval(1)
 {
    fNumIters = 0;
    fNumBurnInSteps = 0;
@@ -88,7 +91,10 @@ MCMCCalculator::MCMCCalculator() :
 MCMCCalculator::MCMCCalculator(RooAbsData& data, const ModelConfig & model) :
    fPropFunc(0), 
    fData(&data),
-   fAxes(0)
+   fAxes(0),
+   fNumChains(1),
+   fNWorkers(0),
+   fSwapInterval(1)
 {
    SetModel(model);
    SetupBasicUsage();
@@ -191,6 +197,12 @@ MCMCInterval* MCMCCalculator::GetInterval() const
    if (fChainParams.getSize() > 0) mh.SetChainParameters(fChainParams); 
    mh.SetProposalFunction(*fPropFunc);
    mh.SetNumIters(fNumIters);
+   mh.SetNumChains(fNumChains);
+   mh.SetNWorkers(fNWorkers);
+   mh.SetTemperatures(fTemperatures);
+   mh.SetSwapInterval(fSwapInterval);
+   // several chains are merged after the burn-in of each of them
+   if (fNumChains > 1) mh.SetNumBurnInSteps(fNumBurnInSteps);
 
    MarkovChain* chain = mh.ConstructChain();
 
@@ -198,7 +210,7 @@ MCMCInterval* MCMCCalculator::GetInterval() const
    MCMCInterval* interval = new MCMCInterval(name, fPOI, *chain);
    if (fAxes != NULL)
       interval->SetAxes(*fAxes);
-   if (fNumBurnInSteps > 0)
+   if (fNumBurnInSteps > 0 && fNumChains < 2)
       interval->SetNumBurnInSteps(fNumBurnInSteps);
    interval->SetUseKeys(fUseKeys);
    interval->SetUseSparseHist(fUseSparseHist);
@@ -60,6 +60,11 @@
 #ifndef ROOT_TFile
 #include "TFile.h"
 #endif
+#include "TRandom2.h"
+#include "ROOT/TProcessExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+
+#include <utility>
 
 ClassImp(RooStats::MetropolisHastings);
 
@@ -76,6 +81,9 @@ MetropolisHastings::MetropolisHastings()
    fNumBurnInSteps = 0;
    fSign = kSignUnset;
    fType = kTypeUnset;
+   fNumChains = 1;
+   fNWorkers = 0;
+   fSwapInterval = 1;
 }
 
 MetropolisHastings::MetropolisHastings(RooAbsReal& function, const RooArgSet& paramsOfInterest,
@@ -88,6 +96,9 @@ MetropolisHastings::MetropolisHastings(RooAbsReal& function, const RooArgSet& pa
    fNumBurnInSteps = 0;
    fSign = kSignUnset;
    fType = kTypeUnset;
+   fNumChains = 1;
+   fNWorkers = 0;
+   fSwapInterval = 1;
 }
 
 MarkovChain* MetropolisHastings::ConstructChain()
@@ -106,38 +117,63 @@ MarkovChain* MetropolisHastings::ConstructChain()
 
    if (fChainParams.getSize() == 0) fChainParams.add(fParameters);
 
-   RooArgSet x;
-   RooArgSet xPrime;
-   x.addClone(fParameters);
-   RandomizeCollection(x);
-   xPrime.addClone(fParameters);
-   RandomizeCollection(xPrime);
+   // a single chain is returned as it is, the burn-in being left to the
+   // MCMCInterval
+   if (fNumChains < 2) return ConstructSingleChain(fNumIters);
+
+   // share the iterations among the chains
+   Int_t numChains = fNumChains;
+   std::vector<Int_t> numIters(numChains, fNumIters / numChains);
+   for (Int_t i = 0; i < fNumIters % numChains; ++i) numIters[i]++;
+
+   // independent seeds for the chains, as in ToyMCSampler, so that the
+   // chains do not depend on the number of workers
+   TRandom2 r(RooRandom::randomGenerator()->Integer(TMath::Limits<unsigned int>::Max()));
+   std::vector<UInt_t> seeds(numChains);
+   for (Int_t i = 0; i < numChains; ++i) seeds[i] = r.Integer(TMath::Limits<unsigned int>::Max());
+
+   // executed in the forked processes for a parallel run: the changes of
+   // the parameters and of the random generator do not affect this process
+   auto run = [&](UInt_t iChain) -> MarkovChain* {
+      RooRandom::randomGenerator()->SetSeed(seeds[iChain]);
+      return ConstructSingleChain(numIters[iChain]);
+   };
+
+   UInt_t nWorkers = fNWorkers < UInt_t(numChains) ? fNWorkers : numChains;
+   std::vector<MarkovChain*> chains;
+   if (nWorkers > 1) {
+      coutI(Eval) << "MetropolisHastings: running " << numChains << " chains in "
+                  << nWorkers << " worker processes" << endl;
+      ROOT::TProcessExecutor workers(nWorkers);
+      chains = workers.Map(run, ROOT::TSeqU(numChains));
+   } else {
+      for (Int_t i = 0; i < numChains; ++i) chains.push_back(run(i));
+   }
 
+   // merge the chains, discarding the burn-in of each of them
    MarkovChain* chain = new MarkovChain();
-   // only the POI will be added to the chain
    chain->SetParameters(fChainParams);
-
-   Int_t weight = 0;
-   Double_t xL = 0.0, xPrimeL = 0.0, a = 0.0;
-
-   // ibucur: i think the user should have the possiblity to display all the message
-   //    levels should they want to; maybe a setPrintLevel would be appropriate
-   //    (maybe for the other classes that use this approach as well)?
-   RooFit::MsgLevel oldMsgLevel = RooMsgService::instance().globalKillBelow();
-   RooMsgService::instance().setGlobalKillBelow(RooFit::PROGRESS);
-
-   // We will need to check if log-likelihood evaluation left an error status.
-   // Now using faster eval error logging with CountErrors.
-   if (fType == kLog) {
-     RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::CountErrors);
-     //N.B: need to clear the count in case of previous errors !
-     // the clear needs also to be done after calling setEvalErrorLoggingMode 
-     RooAbsReal::clearEvalErrorLog();
+   for (UInt_t i = 0; i < chains.size(); ++i) {
+      if (!chains[i]) {
+         coutW(Eval) << "MetropolisHastings: no output from chain " << i << endl;
+         continue;
+      }
+      if (chains[i]->Size() <= fNumBurnInSteps) {
+         coutW(Eval) << "MetropolisHastings: chain " << i << " has " << chains[i]->Size()
+                     << " steps, not more than the " << fNumBurnInSteps << " burn-in steps" << endl;
+      }
+      chain->AddWithBurnIn(*chains[i], fNumBurnInSteps);
+      delete chains[i];
    }
+   coutI(Eval) << "Number of steps in the " << numChains << " merged chains: " << chain->Size() << endl;
+
+   return chain;
+}
 
+Bool_t MetropolisHastings::FindStartingPoint(RooArgSet& x, Double_t& xL)
+{
    bool hadEvalError = true;
 
-   Int_t i = 0;
    // get a good starting point for x
    // for fType == kLog, this means that fFunction->getVal() did not cause
    // an eval error
@@ -145,7 +181,7 @@ MarkovChain* MetropolisHastings::ConstructChain()
    //
    // kbelasco: i < 1000 is sort of arbitary, but way higher than the number of
    // steps we should have to take for any reasonable (log) likelihood function
-   while (i < 1000 && hadEvalError) {
+   for (Int_t i = 0; i < 1000 && hadEvalError; ++i) {
       RandomizeCollection(x);
       RooStats::SetParameters(&x, &fParameters);
       xL = fFunction->getVal();
@@ -166,91 +202,163 @@ MarkovChain* MetropolisHastings::ConstructChain()
          hadEvalError = false;
    }
 
-   if(hadEvalError) {
-      coutE(Eval) << "Problem finding a good starting point in " <<
-                     "MetropolisHastings::ConstructChain() " << endl;
-   }
-
+   return !hadEvalError;
+}
 
-   ooccoutP((TObject *)0, Generation) << "Metropolis-Hastings progress: ";
+MarkovChain* MetropolisHastings::ConstructSingleChain(Int_t numIters)
+{
+   // inverse temperatures of the replicas, the first one samples the
+   // function itself and is the only one stored in the chain
+   std::vector<Double_t> betas(1, 1.0);
+   for (UInt_t k = 0; k < fTemperatures.size(); ++k) {
+      if (fTemperatures[k] > 1.0)
+         betas.push_back(1.0 / fTemperatures[k]);
+      else
+         coutW(Eval) << "MetropolisHastings: ignoring the temperature " << fTemperatures[k]
+                     << ", the temperatures of the tempered replicas must be larger than 1" << endl;
+   }
+   const UInt_t nReplicas = betas.size();
+
+   std::vector<RooArgSet*> x(nReplicas);
+   std::vector<Double_t> xL(nReplicas, 0.0);
+   for (UInt_t k = 0; k < nReplicas; ++k) {
+      x[k] = new RooArgSet();
+      x[k]->addClone(fParameters);
+      RandomizeCollection(*x[k]);
+   }
+   RooArgSet xPrime;
+   xPrime.addClone(fParameters);
+   RandomizeCollection(xPrime);
 
-   // do main loop
-   for (i = 0; i < fNumIters; i++) {
-      // reset error handling flag
-      hadEvalError = false;
+   MarkovChain* chain = new MarkovChain();
+   // only the POI will be added to the chain
+   chain->SetParameters(fChainParams);
 
-      // print a dot every 1% of the chain construction
-      if (i % (fNumIters / 100) == 0) ooccoutP((TObject*)0, Generation) << ".";
+   Int_t weight = 0;
+   Double_t xPrimeL = 0.0, a = 0.0;
 
-      fPropFunc->Propose(xPrime, x);
+   // ibucur: i think the user should have the possiblity to display all the message
+   //    levels should they want to; maybe a setPrintLevel would be appropriate
+   //    (maybe for the other classes that use this approach as well)?
+   RooFit::MsgLevel oldMsgLevel = RooMsgService::instance().globalKillBelow();
+   RooMsgService::instance().setGlobalKillBelow(RooFit::PROGRESS);
 
-      RooStats::SetParameters(&xPrime, &fParameters);
-      xPrimeL = fFunction->getVal();
+   // We will need to check if log-likelihood evaluation left an error status.
+   // Now using faster eval error logging with CountErrors.
+   if (fType == kLog) {
+     RooAbsReal::setEvalErrorLoggingMode(RooAbsReal::CountErrors);
+     //N.B: need to clear the count in case of previous errors !
+     // the clear needs also to be done after calling setEvalErrorLoggingMode 
+     RooAbsReal::clearEvalErrorLog();
+   }
 
-      // check if log-likelihood for xprime had an error status
-      if (fFunction->numEvalErrors() > 0 && fType == kLog) {
-         xPrimeL = RooNumber::infinity();
-         fFunction->clearEvalErrorLog();
-         hadEvalError = true;
+   bool hadEvalError = false;
+   for (UInt_t k = 0; k < nReplicas; ++k) {
+      if (!FindStartingPoint(*x[k], xL[k])) {
+         coutE(Eval) << "Problem finding a good starting point in " <<
+                        "MetropolisHastings::ConstructChain() " << endl;
       }
+   }
 
-      // why evaluate the last point again, can't we cache it?
-      // kbelasco: commenting out lines below to add/test caching support
-      //RooStats::SetParameters(&x, &fParameters);
-      //xL = fFunction->getVal();
+   ooccoutP((TObject *)0, Generation) << "Metropolis-Hastings progress: ";
 
-      if (fType == kLog) {
-         if (fSign == kPositive)
-            a = xL - xPrimeL;
-         else
-            a = xPrimeL - xL;
-      }
-      else
-         a = xPrimeL / xL;
-      //a = xL / xPrimeL;
-
-      if (!hadEvalError && !fPropFunc->IsSymmetric(xPrime, x)) {
-         Double_t xPrimePD = fPropFunc->GetProposalDensity(xPrime, x);
-         Double_t xPD      = fPropFunc->GetProposalDensity(x, xPrime);
-         if (fType == kRegular)
-            a *= xPD / xPrimePD;
-         else
-            a += TMath::Log(xPrimePD) - TMath::Log(xPD);
+   // do main loop
+   for (Int_t i = 0; i < numIters; i++) {
+      // print a dot every 1% of the chain construction
+      if (numIters >= 100 && i % (numIters / 100) == 0) ooccoutP((TObject*)0, Generation) << ".";
+
+      // exchange the points of adjacent replicas, from the hottest to the
+      // coldest one, with the probability
+      // min(1, exp((beta_cold - beta_hot) * (nll_cold - nll_hot)))
+      // A new point of the first replica starts with a null weight: the
+      // step below counts this iteration for it
+      if (nReplicas > 1 && i > 0 && i % fSwapInterval == 0) {
+         for (UInt_t k = nReplicas - 1; k > 0; --k) {
+            Double_t logR = (betas[k - 1] - betas[k]) * (CalcNLL(xL[k - 1]) - CalcNLL(xL[k]));
+            if (logR >= 0.0 || TMath::Log(RooRandom::uniform()) < logR) {
+               if (k == 1) {
+                  if (weight != 0.0)
+                     chain->Add(*x[0], CalcNLL(xL[0]), (Double_t)weight);
+                  weight = 0;
+               }
+               std::swap(x[k - 1], x[k]);
+               std::swap(xL[k - 1], xL[k]);
+            }
+         }
       }
 
-      if (!hadEvalError && ShouldTakeStep(a)) {
-         // go to the proposed point xPrime
+      for (UInt_t k = 0; k < nReplicas; ++k) {
+         // reset error handling flag
+         hadEvalError = false;
 
-         // add the current point with the current weight
-         if (weight != 0.0)
-            chain->Add(x, CalcNLL(xL), (Double_t)weight);
+         fPropFunc->Propose(xPrime, *x[k]);
 
-         // reset the weight and go to xPrime
-         weight = 1;
-         RooStats::SetParameters(&xPrime, &x);
-         xL = xPrimeL;
-      } else {
-         // stay at the current point
-         weight++;
+         RooStats::SetParameters(&xPrime, &fParameters);
+         xPrimeL = fFunction->getVal();
+
+         // check if log-likelihood for xprime had an error status
+         if (fFunction->numEvalErrors() > 0 && fType == kLog) {
+            xPrimeL = RooNumber::infinity();
+            fFunction->clearEvalErrorLog();
+            hadEvalError = true;
+         }
+
+         // the tempered replicas sample the function to the power beta
+         if (fType == kLog) {
+            if (fSign == kPositive)
+               a = xL[k] - xPrimeL;
+            else
+               a = xPrimeL - xL[k];
+            a *= betas[k];
+         }
+         else {
+            a = xPrimeL / xL[k];
+            if (betas[k] != 1.0 && a > 0.0) a = TMath::Power(a, betas[k]);
+         }
+
+         if (!hadEvalError && !fPropFunc->IsSymmetric(xPrime, *x[k])) {
+            Double_t xPrimePD = fPropFunc->GetProposalDensity(xPrime, *x[k]);
+            Double_t xPD      = fPropFunc->GetProposalDensity(*x[k], xPrime);
+            if (fType == kRegular)
+               a *= xPD / xPrimePD;
+            else
+               a += TMath::Log(xPrimePD) - TMath::Log(xPD);
+         }
+
+         if (!hadEvalError && ShouldTakeStep(a)) {
+            // go to the proposed point xPrime
+
+            // add the current point with the current weight
+            if (k == 0) {
+               if (weight != 0.0)
+                  chain->Add(*x[0], CalcNLL(xL[0]), (Double_t)weight);
+               // reset the weight
+               weight = 1;
+            }
+
+            RooStats::SetParameters(&xPrime, x[k]);
+            xL[k] = xPrimeL;
+         } else if (k == 0) {
+            // stay at the current point
+            weight++;
+         }
       }
    }
 
    // make sure to add the last point
    if (weight != 0.0)
-      chain->Add(x, CalcNLL(xL), (Double_t)weight);
+      chain->Add(*x[0], CalcNLL(xL[0]), (Double_t)weight);
    ooccoutP((TObject *)0, Generation) << endl;
 
    RooMsgService::instance().setGlobalKillBelow(oldMsgLevel);
 
+   for (UInt_t k = 0; k < nReplicas; ++k) delete x[k];
+
    Int_t numAccepted = chain->Size();
    coutI(Eval) << "Proposal acceptance rate: " <<
-                   numAccepted/(Float_t)fNumIters * 100 << "%" << endl;
+                   numAccepted/(Float_t)numIters * 100 << "%" << endl;
    coutI(Eval) << "Number of steps in chain: " << numAccepted << endl;
 
-   //TFile chainDataFile("chainData.root", "recreate");
-   //chain->GetDataSet()->Write();
-   //chainDataFile.Close();
-
    return chain;
 }
 
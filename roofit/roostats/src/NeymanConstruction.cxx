@@ -37,6 +37,14 @@
 #include "TTree.h"
 #include "TMath.h"
 #include "TH1F.h"
+#include "TVectorD.h"
+#include "TRandom2.h"
+#include "RooRandom.h"
+#include "RooRealVar.h"
+#include "ROOT/TProcessExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+
+#include <algorithm>
 
 
 
@@ -60,7 +68,8 @@ NeymanConstruction::NeymanConstruction(RooAbsData& data, ModelConfig& model):
    fAdaptiveSampling(false),
    fAdditionalNToysFactor(1.),
    fSaveBeltToFile(false),
-   fCreateBelt(false)
+   fCreateBelt(false),
+   fNWorkers(0)
 
 {
    // default constructor
@@ -78,47 +87,76 @@ NeymanConstruction::NeymanConstruction(RooAbsData& data, ModelConfig& model):
 NeymanConstruction::~NeymanConstruction() {
 }
 
+namespace {
+   // The result of a parameter point, as exchanged with the worker processes and stored
+   // in the checkpoint file: a vector with the test statistic evaluated on the data, the
+   // edges of the acceptance region, the number of toys and the coordinates of the point,
+   // followed by the sampling distribution if it is kept.
+   TList* MakeRecord(const RooArgSet& point, Double_t testStatistic, Double_t lowerEdge, Double_t upperEdge,
+                     SamplingDistribution* samplingDist, bool keepDist)
+   {
+      std::vector<Double_t> values = {testStatistic, lowerEdge, upperEdge, Double_t(samplingDist->GetSize())};
+      RooFIter itr = point.fwdIterator();
+      RooAbsArg* arg;
+      while ((arg = itr.next())) {
+         if (RooAbsReal* var = dynamic_cast<RooAbsReal*>(arg)) values.push_back(var->getVal());
+      }
+      TList* record = new TList();
+      record->SetOwner();
+      record->Add(new TVectorD(values.size(), values.data()));
+      if (keepDist)
+         record->Add(samplingDist);
+      else
+         delete samplingDist;
+      return record;
+   }
+
+   // Check that the record is the one of point, i.e. that the points to test did not change
+   bool MatchRecord(const TList* record, const RooArgSet& point)
+   {
+      const TVectorD* values = record ? dynamic_cast<const TVectorD*>(record->At(0)) : 0;
+      if (!values || values->GetNrows() < 4) return false;
+      Int_t k = 4;
+      RooFIter itr = point.fwdIterator();
+      RooAbsArg* arg;
+      while ((arg = itr.next())) {
+         RooAbsReal* var = dynamic_cast<RooAbsReal*>(arg);
+         if (!var) continue;
+         if (k >= values->GetNrows() || (*values)[k] != var->getVal()) return false;
+         ++k;
+      }
+      return k == values->GetNrows();
+   }
+
+   TString RecordName(Int_t i) { return TString::Format("NeymanConstruction_point_%d", i); }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
-/// Main interface to get a RooStats::ConfInterval.  
-/// It constructs a RooStats::SetInterval.
+/// Generate the sampling distribution of the test statistic at the point i of the
+/// points to test, find the thresholds defining its acceptance region and evaluate
+/// the test statistic on the data. Returns a null pointer in case of error.
 
-PointSetInterval* NeymanConstruction::GetInterval() const {
+SamplingDistribution* NeymanConstruction::EvalPoint(Int_t i, Double_t& thisTestStatistic,
+                                                    Double_t& lowerEdgeOfAcceptance, Double_t& upperEdgeOfAcceptance) const {
 
-  TFile* f=0;
-  if(fSaveBeltToFile){
-    //coverity[FORWARD_NULL]
-    oocoutI(f,Contents) << "NeymanConstruction saving ConfidenceBelt to file SamplingDistributions.root" << endl;
-    f = new TFile("SamplingDistributions.root","recreate");
-  }
-  
-  Int_t npass = 0;
-  RooArgSet* point; 
-  
-  // strange problems when using snapshots.  
-  //  RooArgSet* fPOI = (RooArgSet*) fModel.GetParametersOfInterest()->snapshot();
-  RooArgSet* fPOI = new RooArgSet(*fModel.GetParametersOfInterest());
+    // get a parameter point from the list of points to test.
+    RooArgSet* point = (RooArgSet*) fPointsToTest->get(i);//->clone("temp");
 
-  RooDataSet* pointsInInterval = new RooDataSet("pointsInInterval", 
-						 "points in interval", 
-						*(fPointsToTest->get(0)) );
+    // strange problems when using snapshots.
+    RooArgSet fPOI(*fModel.GetParametersOfInterest());
 
-  // loop over points to test
-  for(Int_t i=0; i<fPointsToTest->numEntries(); ++i){
-     // get a parameter point from the list of points to test.
-    point = (RooArgSet*) fPointsToTest->get(i);//->clone("temp");
-    
     // set parameters of interest to current point
-    *fPOI = *point;
+    fPOI = *point;
 
     // set test stat sampler to use this point
-    fTestStatSampler->SetParametersForTestStat(*fPOI);
+    fTestStatSampler->SetParametersForTestStat(fPOI);
 
      // get the value of the test statistic for this data set
-    Double_t thisTestStatistic = fTestStatSampler->EvaluateTestStatistic(fData, *fPOI );
+    thisTestStatistic = fTestStatSampler->EvaluateTestStatistic(fData, fPOI );
     /*
     cout << "NC CHECK: " << i << endl;
     point->Print();
-    fPOI->Print("v");
+    fPOI.Print("v");
     fData.Print();
     cout <<"thisTestStatistic = " << thisTestStatistic << endl;
     */
@@ -128,8 +166,8 @@ PointSetInterval* NeymanConstruction::GetInterval() const {
 
     SamplingDistribution* samplingDist=0;
     Double_t sigma;
-    Double_t upperEdgeOfAcceptance, upperEdgeMinusSigma, upperEdgePlusSigma;
-    Double_t lowerEdgeOfAcceptance, lowerEdgeMinusSigma, lowerEdgePlusSigma;
+    Double_t upperEdgeMinusSigma, upperEdgePlusSigma;
+    Double_t lowerEdgeMinusSigma, lowerEdgePlusSigma;
     Int_t additionalMC=0;
 
     // the adaptive sampling algorithm wants at least one toy event to be outside
@@ -222,6 +260,149 @@ PointSetInterval* NeymanConstruction::GetInterval() const {
       upperEdgeOfAcceptance = 
 	samplingDist->InverseCDF( 1. - ((1.-fLeftSideFraction) * fSize) );
     }
+
+    return samplingDist;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Main interface to get a RooStats::ConfInterval.  
+/// It constructs a RooStats::SetInterval.
+///
+/// The points are run in fNWorkers forked processes if SetNWorkers was called
+/// with more than one worker. Processes are used rather than threads because the
+/// toy generation and the fits share global state of RooFit which is not thread
+/// safe. The results are then used in the order of the points to test, so that the
+/// interval and the confidence belt do not depend on the number of workers.
+
+PointSetInterval* NeymanConstruction::GetInterval() const {
+
+  const Int_t nPoints = fPointsToTest->numEntries();
+  std::vector<TList*> records(nPoints, (TList*)0);
+
+  // read the results of the points already done
+  TFile* checkpoint = 0;
+  if (!fCheckpointFile.empty()) {
+    checkpoint = TFile::Open(fCheckpointFile.c_str(), "UPDATE");
+    if (!checkpoint || checkpoint->IsZombie()) {
+      oocoutE((TObject*)0,InputArguments) << "NeymanConstruction: cannot open the checkpoint file "
+                                          << fCheckpointFile << endl;
+      delete checkpoint;
+      return 0;
+    }
+    Int_t nRead = 0;
+    for (Int_t i=0; i<nPoints; ++i) {
+      TList* record = dynamic_cast<TList*>(checkpoint->Get(RecordName(i)));
+      if (!record) continue;
+      record->SetOwner();
+      if (!MatchRecord(record, *fPointsToTest->get(i)) ||
+          (fSaveBeltToFile && !dynamic_cast<SamplingDistribution*>(record->At(1)))) {
+        oocoutW((TObject*)0,Eval) << "NeymanConstruction: ignoring the result of point " << i
+                                  << " stored in " << fCheckpointFile << ", which does not match the current configuration" << endl;
+        delete record;
+        continue;
+      }
+      records[i] = record;
+      ++nRead;
+    }
+    oocoutI((TObject*)0,Eval) << "NeymanConstruction: " << nRead << " of the " << nPoints
+                              << " points read from the checkpoint file " << fCheckpointFile << endl;
+  }
+
+  // save the result of point i in the checkpoint file, keeping the file valid
+  // after each point as TTree::AutoSave("SaveSelf") does
+  auto saveRecord = [&](Int_t i) {
+    if (!checkpoint || !records[i]) return;
+    checkpoint->WriteTObject(records[i], RecordName(i), "Overwrite");
+    checkpoint->WriteStreamerInfo();
+    checkpoint->SaveSelf();
+    checkpoint->WriteHeader();
+  };
+
+  std::vector<Int_t> toRun;
+  for (Int_t i=0; i<nPoints; ++i) {
+    if (!records[i]) toRun.push_back(i);
+  }
+
+  if (fNWorkers > 1 && toRun.size() > 1) {
+    // seeds for all the points, so that they do not depend on which points are resumed
+    TRandom2 r(RooRandom::randomGenerator()->Integer(TMath::Limits<unsigned int>::Max()));
+    std::vector<UInt_t> seeds(nPoints);
+    for (Int_t i=0; i<nPoints; ++i) seeds[i] = r.Integer(TMath::Limits<unsigned int>::Max());
+
+    oocoutP((TObject*)0,Eval) << "NeymanConstruction: running " << toRun.size() << " points in "
+                              << std::min<UInt_t>(fNWorkers, toRun.size()) << " worker processes" << endl;
+
+    // with checkpoints, the points are run in groups of fNWorkers after which
+    // the results are saved
+    UInt_t groupSize = checkpoint ? fNWorkers : toRun.size();
+    for (UInt_t first = 0; first < toRun.size(); first += groupSize) {
+      UInt_t n = std::min<UInt_t>(groupSize, toRun.size() - first);
+
+      // executed in the worker processes
+      auto work = [&](UInt_t k) -> TList* {
+        Int_t i = toRun[first + k];
+        RooRandom::randomGenerator()->SetSeed(seeds[i]);
+        // the toys of a point are not split further
+        ToyMCSampler* toyMCSampler = dynamic_cast<ToyMCSampler*>(fTestStatSampler);
+        if (toyMCSampler) toyMCSampler->SetNWorkers(0);
+        Double_t thisTestStatistic = 0, lowerEdge = 0, upperEdge = 0;
+        SamplingDistribution* samplingDist = EvalPoint(i, thisTestStatistic, lowerEdge, upperEdge);
+        if (!samplingDist) return 0;
+        return MakeRecord(*fPointsToTest->get(i), thisTestStatistic, lowerEdge, upperEdge, samplingDist, fSaveBeltToFile);
+      };
+
+      ROOT::TProcessExecutor workers(std::min<UInt_t>(fNWorkers, n));
+      std::vector<TList*> results = workers.Map(work, ROOT::TSeqU(n));
+      for (UInt_t k = 0; k < results.size(); ++k) {
+        records[toRun[first + k]] = results[k];
+        if (results[k]) results[k]->SetOwner();
+        saveRecord(toRun[first + k]);
+      }
+    }
+  } else {
+    for (UInt_t k = 0; k < toRun.size(); ++k) {
+      Int_t i = toRun[k];
+      Double_t thisTestStatistic = 0, lowerEdge = 0, upperEdge = 0;
+      SamplingDistribution* samplingDist = EvalPoint(i, thisTestStatistic, lowerEdge, upperEdge);
+      if (!samplingDist) break;
+      records[i] = MakeRecord(*fPointsToTest->get(i), thisTestStatistic, lowerEdge, upperEdge, samplingDist, fSaveBeltToFile);
+      saveRecord(i);
+    }
+  }
+
+  delete checkpoint;
+
+  for (Int_t i=0; i<nPoints; ++i) {
+    if (!records[i]) {
+      oocoutE((TObject*)0,Eval) << "Neyman Construction: error generating the sampling distribution of point " << i << endl;
+      for (Int_t j=0; j<nPoints; ++j) delete records[j];
+      return 0;
+    }
+  }
+
+  TFile* f=0;
+  if(fSaveBeltToFile){
+    //coverity[FORWARD_NULL]
+    oocoutI(f,Contents) << "NeymanConstruction saving ConfidenceBelt to file SamplingDistributions.root" << endl;
+    f = new TFile("SamplingDistributions.root","recreate");
+  }
+  
+  Int_t npass = 0;
+  RooArgSet* point; 
+  
+  RooDataSet* pointsInInterval = new RooDataSet("pointsInInterval", 
+						 "points in interval", 
+						*(fPointsToTest->get(0)) );
+
+  // loop over points to test
+  for(Int_t i=0; i<nPoints; ++i){
+     // get a parameter point from the list of points to test.
+    point = (RooArgSet*) fPointsToTest->get(i);//->clone("temp");
+
+    const TVectorD& values = *(TVectorD*)records[i]->At(0);
+    Double_t thisTestStatistic = values[0];
+    Double_t lowerEdgeOfAcceptance = values[1];
+    Double_t upperEdgeOfAcceptance = values[2];
     
     // add acceptance region to ConfidenceBelt
     if(fConfBelt && fCreateBelt){
@@ -234,14 +415,14 @@ PointSetInterval* NeymanConstruction::GetInterval() const {
     // printout some debug info
     TIter      itr = point->createIterator();
     RooRealVar* myarg;
-    ooccoutP(samplingDist,Eval) << "NeymanConstruction: Prog: "<< i+1<<"/"<<fPointsToTest->numEntries()
-				<< " total MC = " << samplingDist->GetSize()
+    ooccoutP((TObject*)0,Eval) << "NeymanConstruction: Prog: "<< i+1<<"/"<<nPoints
+				<< " total MC = " << Int_t(values[3])
 				<< " this test stat = " << thisTestStatistic << endl;
-    ooccoutP(samplingDist,Eval) << " ";
+    ooccoutP((TObject*)0,Eval) << " ";
     while ((myarg = (RooRealVar *)itr.Next())) { 
-      ooccoutP(samplingDist,Eval) << myarg->GetName() << "=" << myarg->getVal() << " ";
+      ooccoutP((TObject*)0,Eval) << myarg->GetName() << "=" << myarg->getVal() << " ";
     }
-    ooccoutP(samplingDist,Eval) << "[" << lowerEdgeOfAcceptance << ", " 
+    ooccoutP((TObject*)0,Eval) << "[" << lowerEdgeOfAcceptance << ", " 
 		       << upperEdgeOfAcceptance << "] " << " in interval = " <<
       (thisTestStatistic >= lowerEdgeOfAcceptance && thisTestStatistic <= upperEdgeOfAcceptance) 
 	      << endl << endl;
@@ -256,6 +437,8 @@ PointSetInterval* NeymanConstruction::GetInterval() const {
 
     if(fSaveBeltToFile){
       //write to file
+      SamplingDistribution* samplingDist = (SamplingDistribution*)records[i]->At(1);
+      f->cd();
       samplingDist->Write();
       string tmpName = "hist_";
       tmpName+=samplingDist->GetName();
@@ -267,7 +450,7 @@ PointSetInterval* NeymanConstruction::GetInterval() const {
       delete h;
     }
 
-    delete samplingDist;
+    delete records[i];
     //    delete point; // from dataset
   }
   oocoutI(pointsInInterval,Eval) << npass << " points in interval" << endl;
@@ -279,6 +462,7 @@ PointSetInterval* NeymanConstruction::GetInterval() const {
 
   if(fSaveBeltToFile){
     //   write belt to file
+    f->cd();
     fConfBelt->Write();
 
     f->Close();
@@ -288,5 +472,3 @@ PointSetInterval* NeymanConstruction::GetInterval() const {
   //delete data;
   return interval;
 }
-
-
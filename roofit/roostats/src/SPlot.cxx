@@ -27,6 +27,7 @@
 
 #include <vector>
 #include <map>
+#include <algorithm>
 
 #include "RooStats/SPlot.h"
 #include "RooAbsPdf.h"
@@ -35,9 +36,12 @@
 #include "RooGlobalFunc.h"
 #include "TTree.h"
 #include "RooStats/RooStatsUtils.h" 
+#include "RooVectorDataStore.h"
+#include "ROOT/TProcessExecutor.hxx"
 
 
 #include "TMatrixD.h"
+#include "TVectorD.h"
 
 
 ClassImp(RooStats::SPlot) ;
@@ -46,6 +50,58 @@ using namespace RooStats;
 using namespace std;
 
 
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill columns[k][ievt-begin] with the value of the pdf, normalized over
+/// nset, for the event ievt of data in [begin,end) when the yield of the
+/// specie k is 1 and the others 0. The events are evaluated by blocks with
+/// RooAbsPdf::getValBatch() if the data is in a RooVectorDataStore and the
+/// pdf supports it, and one by one otherwise.
+
+void EvalSpeciePdfs(RooAbsPdf& pdf, RooDataSet& data, const std::vector<RooRealVar*>& yieldvars,
+                    const RooArgSet& nset, RooArgSet* pdfvars, Int_t begin, Int_t end,
+                    const std::vector<Double_t*>& columns)
+{
+  const Int_t nspec = yieldvars.size() ;
+  const Int_t batchSize(1024) ;
+
+  Int_t firstScalar = begin ;
+  const RooVectorDataStore* vstore = dynamic_cast<const RooVectorDataStore*>(data.store()) ;
+  for ( ; vstore && firstScalar < end ; firstScalar += batchSize) {
+    const Int_t last = std::min(firstScalar+batchSize,end) ;
+    Bool_t ok(kTRUE) ;
+    for (Int_t k = 0; ok && k < nspec; ++k) {
+      yieldvars[k]->setVal( 1 ) ;
+      ok = pdf.getValBatch(columns[k] + (firstScalar-begin), firstScalar, last, *vstore, &nset) ;
+      yieldvars[k]->setVal( 0 ) ;
+    }
+    if (!ok) break ;
+  }
+
+  for (Int_t ievt = firstScalar; ievt < end; ievt++) {
+    RooStats::SetParameters(data.get(ievt), pdfvars); 
+    for (Int_t k = 0; k < nspec; ++k) {
+      // set this yield to 1
+      yieldvars[k]->setVal( 1 ) ;
+      // evaluate the pdf    
+      columns[k][ievt-begin] = pdf.getVal(&nset) ;
+      yieldvars[k]->setVal( 0 ) ;
+    }
+  }
+
+  for (Int_t ievt = begin; ievt < end; ievt++) {
+    for (Int_t k = 0; k < nspec; ++k) {
+      Double_t f_k = columns[k][ievt-begin] ;
+      if( !(f_k>1 || f_k<1) ) 
+        oocoutW((TObject*)0,InputArguments) << "Strange pdf value: " << ievt << " " << k << " " << f_k << std::endl ;
+    }
+  }
+}
+
+}
+
+
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -60,7 +116,7 @@ SPlot::~SPlot()
 /// Default constructor
 
 SPlot::SPlot():
-  TNamed()
+  TNamed(), fNWorkers(0)
 {
   RooArgList Args;
 
@@ -73,7 +129,7 @@ SPlot::SPlot():
 ////////////////////////////////////////////////////////////////////////////////
 
 SPlot::SPlot(const char* name, const char* title):
-  TNamed(name, title)
+  TNamed(name, title), fNWorkers(0)
 {
   RooArgList Args;
 
@@ -88,7 +144,7 @@ SPlot::SPlot(const char* name, const char* title):
 ///No sWeighted variables are present
 
 SPlot::SPlot(const char* name, const char* title, const RooDataSet &data):
-  TNamed(name, title)
+  TNamed(name, title), fNWorkers(0)
 {
   RooArgList Args;
   
@@ -102,7 +158,7 @@ SPlot::SPlot(const char* name, const char* title, const RooDataSet &data):
 /// Copy Constructor from another SPlot
 
 SPlot::SPlot(const SPlot &other):
-  TNamed(other)
+  TNamed(other), fNWorkers(other.fNWorkers)
 {
   RooArgList Args = (RooArgList) other.GetSWeightVars();
   
@@ -118,7 +174,7 @@ SPlot::SPlot(const SPlot &other):
 SPlot::SPlot(const char* name, const char* title, RooDataSet& data, RooAbsPdf* pdf, 
 	     const RooArgList &yieldsList, const RooArgSet &projDeps, 
 	     bool includeWeights, bool cloneData, const char* newName):
-  TNamed(name, title)
+  TNamed(name, title), fNWorkers(0)
 {
    if(cloneData == 1) {
     fSData = (RooDataSet*) data.Clone(newName);
@@ -410,11 +466,30 @@ void SPlot::AddSWeight( RooAbsPdf* pdf, const RooArgList &yieldsTmp,
   
   Int_t numevents = fSData->numEntries() ;
   
-  std::vector<std::vector<Double_t> > pdfvalues(numevents,std::vector<Double_t>(nspec,0)) ; 
+  // The values are stored by column: one vector of all the events for each specie
+  std::vector<std::vector<Double_t> > pdfvalues(nspec,std::vector<Double_t>(numevents,0)) ; 
 
       
   // set all yield to zero
   for(Int_t m=0; m<nspec; ++m) yieldvars[m]->setVal(0) ;
+
+  for(Int_t k = 0; k < nspec; ++k) 
+    {
+      //Check that range of yields is at least (0,1), and fix otherwise
+      if(yieldvars[k]->getMin() > 0) 
+	{
+	  coutW(InputArguments)  << "Minimum Range for " << yieldvars[k]->GetName() << " must be 0.  ";
+	  coutW(InputArguments)  << "Setting min range to 0" << std::endl;
+	  yieldvars[k]->setMin(0);
+	}
+
+      if(yieldvars[k]->getMax() < 1) 
+	{
+	  coutW(InputArguments)  << "Maximum Range for " << yieldvars[k]->GetName() << " must be 1.  ";
+	  coutW(InputArguments)  << "Setting max range to 1" << std::endl;
+	  yieldvars[k]->setMax(1);
+	}
+    }
    
 
   // For every event and for every specie,
@@ -422,57 +497,80 @@ void SPlot::AddSWeight( RooAbsPdf* pdf, const RooArgList &yieldsTmp,
   // by setting the yield of that specie to 1
   // and all others to 0.  Evaluate the pdf for each event
   // and store the values.
+  // With several workers, each of them evaluates a contiguous
+  // chunk of the events.
 
   RooArgSet * pdfvars = pdf->getVariables();
 
-  for (Int_t ievt = 0; ievt <numevents; ievt++) 
+  UInt_t nWorkers = std::min<UInt_t>(fNWorkers, numevents) ;
+  if (nWorkers > 1) 
     {
-      //   if (ievt % 100 == 0) 
-      //  coutP(Eval)  << ".";
-
-
-      //FIX THIS PART, EVALUATION PROGRESS!!
-
-      RooStats::SetParameters(fSData->get(ievt), pdfvars); 
-
-      //   RooArgSet row(*fSData->get(ievt));
-       
-      for(Int_t k = 0; k < nspec; ++k) 
+      coutI(Eval) << "Calculating the pdf values in " << nWorkers << " worker processes" << std::endl;
+
+      // executed in the forked processes
+      auto work = [&](UInt_t iWorker) -> TVectorD* {
+	Int_t begin = Long64_t(numevents)*iWorker/nWorkers ;
+	Int_t n = Long64_t(numevents)*(iWorker+1)/nWorkers - begin ;
+	TVectorD* values = new TVectorD(nspec*n) ;
+	std::vector<Double_t*> columns ;
+	for(Int_t k = 0; k < nspec; ++k) columns.push_back(values->GetMatrixArray() + k*n) ;
+	EvalSpeciePdfs(*pdf, *fSData, yieldvars, vars, pdfvars, begin, begin+n, columns) ;
+	return values ;
+      };
+
+      ROOT::TProcessExecutor workers(nWorkers);
+      std::vector<TVectorD*> results = workers.Map(work, ROOT::TSeqU(nWorkers));
+
+      Bool_t received(results.size() == nWorkers) ;
+      for(UInt_t i = 0; received && i < nWorkers; ++i) 
 	{
-	  //Check that range of yields is at least (0,1), and fix otherwise
-	  if(yieldvars[k]->getMin() > 0) 
-	    {
-	      coutW(InputArguments)  << "Minimum Range for " << yieldvars[k]->GetName() << " must be 0.  ";
-	      coutW(InputArguments)  << "Setting min range to 0" << std::endl;
-	      yieldvars[k]->setMin(0);
-	    }
+	  Int_t begin = Long64_t(numevents)*i/nWorkers ;
+	  Int_t n = Long64_t(numevents)*(i+1)/nWorkers - begin ;
+	  received = results[i] && results[i]->GetNrows() == nspec*n ;
+	  for(Int_t k = 0; received && k < nspec; ++k) 
+	    std::copy(results[i]->GetMatrixArray() + k*n, results[i]->GetMatrixArray() + (k+1)*n, pdfvalues[k].begin() + begin) ;
+	}
+      for(UInt_t i = 0; i < results.size(); ++i) delete results[i] ;
+      if (!received) 
+	{
+	  coutE(Eval) << "SPlot Error: the pdf values were not received from all the workers" << std::endl;
+	  delete pdfvars;
+	  return;
+	}
+    }
+  else
+    {
+      std::vector<Double_t*> columns ;
+      for(Int_t k = 0; k < nspec; ++k) columns.push_back(numevents > 0 ? &pdfvalues[k][0] : 0) ;
+      EvalSpeciePdfs(*pdf, *fSData, yieldvars, vars, pdfvars, 0, numevents, columns) ;
+    }
+  delete pdfvars;
 
-	  if(yieldvars[k]->getMax() < 1) 
+  // The weights of the events, read by column from a vector store
+  std::vector<Double_t> weights(numevents,1) ;
+  if (includeWeights == kTRUE && numevents > 0) 
+    {
+      const RooVectorDataStore* vstore = dynamic_cast<const RooVectorDataStore*>(fSData->store()) ;
+      if (!vstore || !vstore->weightBatch(&weights[0], 0, numevents)) 
+	{
+	  for (Int_t ievt = 0; ievt < numevents; ++ievt) 
 	    {
-	      coutW(InputArguments)  << "Maximum Range for " << yieldvars[k]->GetName() << " must be 1.  ";
-	      coutW(InputArguments)  << "Setting max range to 1" << std::endl;
-	      yieldvars[k]->setMax(1);
+	      fSData->get(ievt) ;
+	      weights[ievt] = fSData->weight() ;
 	    }
-
-	  // set this yield to 1
-	  yieldvars[k]->setVal( 1 ) ;
-	  // evaluate the pdf    
-	  Double_t f_k = pdf->getVal(&vars) ;
-	  pdfvalues[ievt][k] = f_k ;
-	  if( !(f_k>1 || f_k<1) ) 
-	    coutW(InputArguments) << "Strange pdf value: " << ievt << " " << k << " " << f_k << std::endl ;
-	  yieldvars[k]->setVal( 0 ) ;
 	}
     }
-  delete pdfvars;
    
-  // check that the likelihood normalization is fine
+  // check that the likelihood normalization is fine,
+  // and keep the denominator of each event
   std::vector<Double_t> norm(nspec,0) ;
+  std::vector<Double_t> dsums(numevents,0) ;
   for (Int_t ievt = 0; ievt <numevents ; ievt++) 
     {
       Double_t dnorm(0) ;
-      for(Int_t k=0; k<nspec; ++k) dnorm += yieldvalues[k] * pdfvalues[ievt][k] ;
-      for(Int_t j=0; j<nspec; ++j) norm[j] += pdfvalues[ievt][j]/dnorm ;
+      for(Int_t k=0; k<nspec; ++k) dnorm += yieldvalues[k] * pdfvalues[k][ievt] ;
+      for(Int_t j=0; j<nspec; ++j) norm[j] += pdfvalues[j][ievt]/dnorm ;
+      dsums[ievt] = dnorm ;
     }
    
   coutI(Contents) << "likelihood norms: "  ;
@@ -488,31 +586,29 @@ void SPlot::AddSWeight( RooAbsPdf* pdf, const RooArgList &yieldsTmp,
 
 
   // Calculate the inverse covariance matrix, using weights
+  std::vector<Double_t> covSum(nspec*nspec,0) ;
   for (Int_t ievt = 0; ievt < numevents; ++ievt) 
     {
-      
-      fSData->get(ievt) ;
-     
       // Calculate contribution to the inverse of the covariance
       // matrix. See BAD 509 V2 eqn. 15
 
       // Sum for the denominator
-      Double_t dsum(0);
-      for(Int_t k = 0; k < nspec; ++k) 
-	dsum += pdfvalues[ievt][k] * yieldvalues[k] ;
+      Double_t dsum = dsums[ievt] ;
        
       for(Int_t n=0; n<nspec; ++n)
 	for(Int_t j=0; j<nspec; ++j) 
 	  {
 	    if(includeWeights == kTRUE)
-	      covInv(n,j) +=  fSData->weight()*pdfvalues[ievt][n]*pdfvalues[ievt][j]/(dsum*dsum) ;
+	      covSum[n*nspec+j] +=  weights[ievt]*pdfvalues[n][ievt]*pdfvalues[j][ievt]/(dsum*dsum) ;
 	    else 
-	      covInv(n,j) +=  pdfvalues[ievt][n]*pdfvalues[ievt][j]/(dsum*dsum) ;
+	      covSum[n*nspec+j] +=  pdfvalues[n][ievt]*pdfvalues[j][ievt]/(dsum*dsum) ;
 	  }
 
       //ADDED WEIGHT ABOVE
 
     }
+  for(Int_t n=0; n<nspec; ++n)
+    for(Int_t j=0; j<nspec; ++j) covInv(n,j) = covSum[n*nspec+j] ;
    
   // Covariance inverse should now be computed!
    
@@ -543,6 +639,36 @@ void SPlot::AddSWeight( RooAbsPdf* pdf, const RooArgList &yieldsTmp,
   
   // calculate for each event the sWeight (BAD 509 V2 eq. 21)
   coutI(Eval) << "Calculating sWeight" << std::endl;
+  std::vector<std::vector<Double_t> > sweights(nspec,std::vector<Double_t>(numevents,0)) ;
+  std::vector<Double_t> cov(covMatrix.GetMatrixArray(), covMatrix.GetMatrixArray() + nspec*nspec) ;
+   
+  for(Int_t ievt = 0; ievt < numevents; ++ievt) 
+    {
+      // sum for denominator
+      Double_t dsum = dsums[ievt] ;
+      // covariance weighted pdf for each specief
+      for(Int_t n=0; n<nspec; ++n) 
+	{
+	  Double_t nsum(0) ;
+	  for(Int_t j=0; j<nspec; ++j) nsum += cov[n*nspec+j] * pdfvalues[j][ievt] ;     
+	   
+
+	  //Add the sWeights here!!
+	  //Include weights,
+	  //ie events weights are absorbed into sWeight
+
+
+	  if(includeWeights == kTRUE) sweights[n][ievt] = weights[ievt] * nsum/dsum ;
+	  else  sweights[n][ievt] = nsum/dsum ;
+
+	  if( !(fabs(nsum/dsum)>=0 ) ) 
+	    {
+	      coutE(Contents) << "error: " << nsum/dsum << endl ;
+	      return;
+	    }
+	}
+    }
+
   std::vector<RooRealVar*> sweightvec ;
   std::vector<RooRealVar*> pdfvec ;  
   RooArgSet sweightset ;
@@ -566,52 +692,50 @@ void SPlot::AddSWeight( RooAbsPdf* pdf, const RooArgList &yieldsTmp,
        sweightset.add(*var) ;
     }
 
-  // Create and fill a RooDataSet
-  // with the SWeights
+  // Add the SWeights to the original data set. The columns are
+  // moved as they are into a vector store, unless it already
+  // has columns of these names, otherwise a data set of the
+  // SWeights is merged with it
+
+  Bool_t existing(kFALSE) ;
+  for(Int_t k=0; k<nspec; ++k) 
+    existing = existing || fSData->get()->find(*sweightvec[k]) || fSData->get()->find(*pdfvec[k]) ;
+
+  if (!existing && dynamic_cast<RooVectorDataStore*>(fSData->store())) 
+    {
+      RooArgList columnVars ;
+      std::vector<std::vector<Double_t> > columns(2*nspec) ;
+      for(Int_t k=0; k<nspec; ++k) 
+	{
+	  columnVars.add(*sweightvec[k]) ;
+	  columns[2*k].swap(sweights[k]) ;
+	  columnVars.add(*pdfvec[k]) ;
+	  columns[2*k+1].swap(pdfvalues[k]) ;
+	}
+      delete fSData->addRealColumns(columnVars, columns) ;
+    }
+  else 
+    {
+      // Create and fill a RooDataSet
+      // with the SWeights
  
-  RooDataSet* sWeightData = new RooDataSet("dataset", "dataset with sWeights", sweightset);
+      RooDataSet* sWeightData = new RooDataSet("dataset", "dataset with sWeights", sweightset);
   
-  for(Int_t ievt = 0; ievt < numevents; ++ievt) 
-    {
-
-      fSData->get(ievt) ;
-       
-      // sum for denominator
-      Double_t dsum(0);
-      for(Int_t k = 0; k < nspec; ++k)   dsum +=  pdfvalues[ievt][k] * yieldvalues[k] ;
-      // covariance weighted pdf for each specief
-      for(Int_t n=0; n<nspec; ++n) 
+      for(Int_t ievt = 0; ievt < numevents; ++ievt) 
 	{
-	  Double_t nsum(0) ;
-	  for(Int_t j=0; j<nspec; ++j) nsum += covMatrix(n,j) * pdfvalues[ievt][j] ;     
-	   
-
-	  //Add the sWeights here!!
-	  //Include weights,
-	  //ie events weights are absorbed into sWeight
-
-
-	  if(includeWeights == kTRUE) sweightvec[n]->setVal(fSData->weight() * nsum/dsum) ;
-	  else  sweightvec[n]->setVal( nsum/dsum) ;
-
-	  pdfvec[n]->setVal( pdfvalues[ievt][n] ) ;
-
-	  if( !(fabs(nsum/dsum)>=0 ) ) 
+	  for(Int_t n=0; n<nspec; ++n) 
 	    {
-	      coutE(Contents) << "error: " << nsum/dsum << endl ;
-	      return;
+	      sweightvec[n]->setVal( sweights[n][ievt] ) ;
+	      pdfvec[n]->setVal( pdfvalues[n][ievt] ) ;
 	    }
-	}
       
-      sWeightData->add(sweightset) ;
-    }
-
-    
-  // Add the SWeights to the original data set
+	  sWeightData->add(sweightset) ;
+	}
 
-  fSData->merge(sWeightData);
+      fSData->merge(sWeightData);
 
-  delete sWeightData; 
+      delete sWeightData; 
+    }
 
   //Restore yield values
 
@@ -35,6 +35,9 @@
 #include "RooCategory.h"
 
 #include "TMath.h"
+#include "TRandom2.h"
+#include "ROOT/TProcessExecutor.hxx"
+#include "ROOT/TSeq.hxx"
 
 
 using namespace RooFit;
@@ -157,6 +160,7 @@ ToyMCSampler::ToyMCSampler() : fSamplingDistName("SD"), fNToys(1)
    fProtoData = NULL;
 
    fProofConfig = NULL;
+   fNWorkers = 0;
    fNuisanceParametersSampler = NULL;
 
    _allVars = NULL ;
@@ -196,6 +200,7 @@ ToyMCSampler::ToyMCSampler(TestStatistic &ts, Int_t ntoys) :
    fProtoData = NULL;
 
    fProofConfig = NULL;
+   fNWorkers = 0;
    fNuisanceParametersSampler = NULL;
 
    _allVars = NULL ;
@@ -302,8 +307,10 @@ RooDataSet* ToyMCSampler::GetSamplingDistributions(RooArgSet& paramPointIn)
    // Use for serial and parallel runs.
 
    // ======= S I N G L E   R U N ? =======
-   if(!fProofConfig)
+   if(!fProofConfig) {
+      if(fNWorkers > 1) return GetSamplingDistributionsMultiProcess(paramPointIn);
       return GetSamplingDistributionsSingleWorker(paramPointIn);
+   }
 
 
    // ======= P A R A L L E L   R U N =======
@@ -346,6 +353,76 @@ RooDataSet* ToyMCSampler::GetSamplingDistributions(RooArgSet& paramPointIn)
    return output;
 }
 
+RooDataSet* ToyMCSampler::GetSamplingDistributionsMultiProcess(RooArgSet& paramPointIn)
+{
+   // Parallel run on the local machine, used by GetSamplingDistributions
+   // when no ProofConfig is given and SetNWorkers was called with more than
+   // one worker. The toys are split among forked processes, each of which
+   // works on its own copy of the model and runs
+   // GetSamplingDistributionsSingleWorker for its share of the toys. The
+   // random generator of each worker is seeded from a sequence derived
+   // from the current state of RooRandom, so that the workers produce
+   // independent toys and the result is reproducible for a given seed.
+   // The distributions of the workers are merged into one data set.
+   // Separate processes are used because the generation and the fits
+   // share global state of RooFit (e.g. the random generator and the
+   // integrator caches) that is not thread safe.
+
+   if (!CheckConfig()){
+      oocoutE((TObject*)NULL, InputArguments)
+         << "Bad COnfiguration in ToyMCSampler "
+         << endl;
+      return nullptr;
+   }
+
+   // never more workers than toys
+   UInt_t nWorkers = fNWorkers;
+   if (fToysInTails == 0 && fNToys < Int_t(nWorkers)) nWorkers = fNToys > 1 ? fNToys : 1;
+   if (nWorkers < 2) return GetSamplingDistributionsSingleWorker(paramPointIn);
+
+   // split the toys so that the total number of toys stays the same, the
+   // adaptive sampling thresholds are rounded up on each worker
+   std::vector<Int_t> nToys(nWorkers, fNToys / nWorkers);
+   for (Int_t i = 0; i < fNToys % Int_t(nWorkers); ++i) nToys[i]++;
+   Double_t toysInTails = TMath::Ceil(fToysInTails / nWorkers);
+   Double_t maxToys = fMaxToys < RooNumber::infinity() ? TMath::Ceil(fMaxToys / nWorkers) : fMaxToys;
+
+   // independent seeds for the workers, as in ToyMCStudy
+   TRandom2 r(RooRandom::randomGenerator()->Integer(TMath::Limits<unsigned int>::Max()));
+   std::vector<UInt_t> seeds(nWorkers);
+   for (UInt_t i = 0; i < nWorkers; ++i) seeds[i] = r.Integer(TMath::Limits<unsigned int>::Max());
+
+   oocoutP((TObject*)0,Generation) << "ToyMCSampler: generating " << fNToys << " toys in "
+                                   << nWorkers << " worker processes" << endl;
+
+   // executed in the forked processes, the changes of the configuration
+   // do not affect this process
+   auto work = [&](UInt_t iWorker) -> RooDataSet* {
+      RooRandom::randomGenerator()->SetSeed(seeds[iWorker]);
+      fNToys = nToys[iWorker];
+      fToysInTails = toysInTails;
+      fMaxToys = maxToys;
+      return GetSamplingDistributionsSingleWorker(paramPointIn);
+   };
+
+   ROOT::TProcessExecutor workers(nWorkers);
+   std::vector<RooDataSet*> results = workers.Map(work, ROOT::TSeqU(nWorkers));
+
+   RooDataSet* output = NULL;
+   for (unsigned int i = 0; i < results.size(); ++i) {
+      if (!results[i]) {
+         oocoutW((TObject*)NULL, Generation) << "ToyMCSampler: no output from worker " << i << endl;
+         continue;
+      }
+      if (!output) output = results[i];
+      else {
+         output->append(*results[i]);
+         delete results[i];
+      }
+   }
+   return output;
+}
+
 RooDataSet* ToyMCSampler::GetSamplingDistributionsSingleWorker(RooArgSet& paramPointIn)
 {
    // This is the main function for serial runs. It is called automatically
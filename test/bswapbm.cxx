@@ -0,0 +1,99 @@
+// @(#)root/test:$Id$
+// Author: ROOT I/O team   October 2016
+
+#include <stdlib.h>
+
+#include "Riostream.h"
+#include "TBufferFile.h"
+#include "TStopwatch.h"
+#include "Bswapcpy.h"
+//
+// This program benchmarks the reading and writing of arrays of basic
+// types with TBufferFile::ReadFastArray/WriteFastArray, i.e. the byte
+// swapping of the array content on little endian machines. Each test is
+// run with the portable byte swapping routines and with the vectorized
+// ones selected for this CPU.
+//
+// Usage: bswapbm [nelements] [ntimes]
+//
+// parameters:
+//       nelements     - number of elements in each array
+//       ntimes        - number of times the array is written and read back
+
+int nelements = 100000;   // Number of elements per array.
+int ntimes    = 1000;     // Number of write/read cycles.
+
+//_____________________________________________________________
+
+template <typename T>
+Double_t BenchArray(T *values, T *result, Bool_t scalar, Bool_t &ok)
+{
+   // Write 'values' into a buffer and read them back into 'result',
+   // 'ntimes' times; return the number of MB/s processed.
+
+   ROOT::Internal::SetBswapcpyScalar(scalar);
+   TBufferFile b(TBuffer::kWrite, nelements * sizeof(T) + 1024);
+   TStopwatch timer;
+   timer.Start();
+   for (int t = 0; t < ntimes; t++) {
+      b.SetWriteMode();
+      b.SetBufferOffset(0);
+      b.WriteFastArray(values, nelements);
+      b.SetReadMode();
+      b.SetBufferOffset(0);
+      b.ReadFastArray(result, nelements);
+   }
+   timer.Stop();
+   ROOT::Internal::SetBswapcpyScalar(kFALSE);
+
+   for (int i = 0; i < nelements; i++) {
+      if (result[i] != values[i]) { ok = kFALSE; break; }
+   }
+   Double_t mbytes = 2. * ntimes * nelements * sizeof(T) / 1024. / 1024.;
+   return timer.RealTime() > 0 ? mbytes / timer.RealTime() : 0;
+}
+
+//_____________________________________________________________
+
+template <typename T>
+Bool_t TestType(const char *name)
+{
+   T *values = new T[nelements];
+   T *result = new T[nelements];
+   for (int i = 0; i < nelements; i++) values[i] = (T)(i * 7 + 1);
+
+   Bool_t ok = kTRUE;
+   Double_t scalar = BenchArray(values, result, kTRUE, ok);
+   Double_t best   = BenchArray(values, result, kFALSE, ok);
+
+   printf("%-10s %10.1f MB/s %10.1f MB/s   x%5.2f   %s\n", name, scalar, best,
+          scalar > 0 ? best / scalar : 0., ok ? "OK" : "FAILED");
+
+   delete [] values;
+   delete [] result;
+   return ok;
+}
+
+//_____________________________________________________________
+
+int main(int argc,char **argv)
+{
+   if (argc > 1) nelements = atoi(argv[1]);
+   if (argc > 2) ntimes    = atoi(argv[2]);
+   if (nelements <= 0 || ntimes <= 0) {
+      std::cout << "Usage: bswapbm [nelements] [ntimes]" << std::endl;
+      return 1;
+   }
+
+   printf("Byte swapping kernel: %s\n", ROOT::Internal::GetBswapcpyKernel());
+   printf("%-10s %15s %15s\n", "type", "scalar", "selected");
+
+   Bool_t ok = kTRUE;
+   ok &= TestType<Short_t>("Short_t");
+   ok &= TestType<Int_t>("Int_t");
+   ok &= TestType<Float_t>("Float_t");
+   ok &= TestType<Long64_t>("Long64_t");
+   ok &= TestType<Double_t>("Double_t");
+
+   return ok ? 0 : 1;
+}
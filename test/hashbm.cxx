@@ -0,0 +1,180 @@
+// @(#)root/test:$Id$
+// Author: ROOT core team   October 2016
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Riostream.h"
+#include "TNamed.h"
+#include "THashList.h"
+#include "THashTable.h"
+#include "TStopwatch.h"
+#include "TRandom.h"
+//
+// This program benchmarks the lookup of objects by name in THashList and
+// THashTable for the numbers of keys found in large directories (from 100
+// to 100000 keys), as done by TDirectory::Get or gROOT->FindObject. For
+// each number of keys it measures the time to fill the collection, to find
+// existing and missing names, and to read the list of the objects with a
+// given name (GetListForObject, used to find the cycles of a key). A
+// std::unordered_map, whose buckets are linked nodes, is given as
+// reference.
+//
+// Usage: hashbm [maxkeys] [nlookups]
+//
+// parameters:
+//       maxkeys       - largest number of keys (10 times more at each step)
+//       nlookups      - number of random lookups for each number of keys
+
+int maxkeys  = 100000;    // Largest number of keys.
+int nlookups = 1000000;   // Number of random lookups.
+
+//_____________________________________________________________
+
+struct Result {
+   Double_t fFill;        // ns per insertion
+   Double_t fHit;         // ns per lookup of an existing name
+   Double_t fMiss;        // ns per lookup of a missing name
+   Double_t fList;        // ns per GetListForObject
+};
+
+const std::vector<std::string> &KeyNames(Int_t nkeys)
+{
+   // Names like the ones of the histograms of a large file.
+   static std::vector<std::string> names;
+   char name[64];
+   for (Int_t i = names.size(); i < nkeys; i++) {
+      snprintf(name, sizeof(name), "h_%s_%d", i % 2 ? "pt" : "eta", i);
+      names.push_back(name);
+   }
+   return names;
+}
+
+//_____________________________________________________________
+
+template <typename Coll>
+Result BenchCollection(Int_t nkeys, Bool_t &ok)
+{
+   const std::vector<std::string> &names = KeyNames(nkeys);
+   std::vector<TNamed*> objects;
+   for (Int_t i = 0; i < nkeys; i++) objects.push_back(new TNamed(names[i].c_str(), ""));
+
+   Result r;
+   TStopwatch timer;
+   Coll *coll = new Coll;
+   coll->SetOwner();
+   timer.Start();
+   for (Int_t i = 0; i < nkeys; i++) coll->Add(objects[i]);
+   timer.Stop();
+   r.fFill = 1.e9 * timer.RealTime() / nkeys;
+
+   gRandom->SetSeed(1);
+   timer.Start();
+   for (Int_t j = 0; j < nlookups; j++) {
+      Int_t i = Int_t(nkeys * gRandom->Rndm());
+      if (coll->FindObject(names[i].c_str()) != objects[i]) ok = kFALSE;
+   }
+   timer.Stop();
+   r.fHit = 1.e9 * timer.RealTime() / nlookups;
+
+   timer.Start();
+   for (Int_t j = 0; j < nlookups; j++) {
+      Int_t i = Int_t(nkeys * gRandom->Rndm());
+      if (coll->FindObject(names[i].c_str() + 1)) ok = kFALSE;
+   }
+   timer.Stop();
+   r.fMiss = 1.e9 * timer.RealTime() / nlookups;
+
+   timer.Start();
+   for (Int_t j = 0; j < nlookups; j++) {
+      Int_t i = Int_t(nkeys * gRandom->Rndm());
+      TIter next(coll->GetListForObject(names[i].c_str()));
+      Bool_t found = kFALSE;
+      TObject *obj;
+      while ((obj = next())) found |= (obj == objects[i]);
+      if (!found) ok = kFALSE;
+   }
+   timer.Stop();
+   r.fList = 1.e9 * timer.RealTime() / nlookups;
+
+   delete coll;
+   return r;
+}
+
+//_____________________________________________________________
+
+Result BenchReference(Int_t nkeys, Bool_t &ok)
+{
+   const std::vector<std::string> &names = KeyNames(nkeys);
+   std::vector<TNamed*> objects;
+   for (Int_t i = 0; i < nkeys; i++) objects.push_back(new TNamed(names[i].c_str(), ""));
+
+   Result r;
+   TStopwatch timer;
+   std::unordered_map<std::string, TObject*> map;
+   timer.Start();
+   for (Int_t i = 0; i < nkeys; i++) map[objects[i]->GetName()] = objects[i];
+   timer.Stop();
+   r.fFill = 1.e9 * timer.RealTime() / nkeys;
+
+   gRandom->SetSeed(1);
+   timer.Start();
+   for (Int_t j = 0; j < nlookups; j++) {
+      Int_t i = Int_t(nkeys * gRandom->Rndm());
+      auto it = map.find(names[i].c_str());
+      if (it == map.end() || it->second != objects[i]) ok = kFALSE;
+   }
+   timer.Stop();
+   r.fHit = 1.e9 * timer.RealTime() / nlookups;
+
+   timer.Start();
+   for (Int_t j = 0; j < nlookups; j++) {
+      Int_t i = Int_t(nkeys * gRandom->Rndm());
+      if (map.find(names[i].c_str() + 1) != map.end()) ok = kFALSE;
+   }
+   timer.Stop();
+   r.fMiss = 1.e9 * timer.RealTime() / nlookups;
+   r.fList = 0;
+
+   for (auto obj : objects) delete obj;
+   return r;
+}
+
+//_____________________________________________________________
+
+void PrintResult(const char *name, Int_t nkeys, const Result &r)
+{
+   printf("%-20s %8d %10.1f %10.1f %10.1f", name, nkeys, r.fFill, r.fHit, r.fMiss);
+   if (r.fList > 0)
+      printf(" %10.1f\n", r.fList);
+   else
+      printf(" %10s\n", "-");
+}
+
+//_____________________________________________________________
+
+int main(int argc,char **argv)
+{
+   if (argc > 1) maxkeys  = atoi(argv[1]);
+   if (argc > 2) nlookups = atoi(argv[2]);
+   if (maxkeys <= 0 || nlookups <= 0) {
+      std::cout << "Usage: hashbm [maxkeys] [nlookups]" << std::endl;
+      return 1;
+   }
+
+   printf("%-20s %8s %10s %10s %10s %10s   (ns per operation)\n", "collection", "keys",
+          "fill", "find", "miss", "list");
+
+   Bool_t ok = kTRUE;
+   for (Int_t nkeys = 100; nkeys <= maxkeys; nkeys *= 10) {
+      PrintResult("THashList", nkeys, BenchCollection<THashList>(nkeys, ok));
+      PrintResult("THashTable", nkeys, BenchCollection<THashTable>(nkeys, ok));
+      PrintResult("std::unordered_map", nkeys, BenchReference(nkeys, ok));
+   }
+
+   if (!ok) std::cout << "hashbm: wrong object found" << std::endl;
+   return ok ? 0 : 1;
+}
@@ -0,0 +1,459 @@
+// @(#)root/test:$Id$
+// Author: ROOT core team   October 2016
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Riostream.h"
+#include "Compression.h"
+#include "RZip.h"
+#include "TBufferFile.h"
+#include "TDatime.h"
+#include "TDirectory.h"
+#include "TFormula.h"
+#include "TH1.h"
+#include "TMath.h"
+#include "TMemFile.h"
+#include "TRandom3.h"
+#include "TROOT.h"
+#include "TStopwatch.h"
+#include "TSystem.h"
+#include "TTree.h"
+#include "TTreeReader.h"
+#include "TTreeReaderValue.h"
+//
+// This program benchmarks individual hot paths of the I/O and of the
+// histogram libraries, to follow their performance from one version to the
+// next: TTree::Fill, TBranch::GetEntry, TTreeReader loops, the compression
+// and decompression of a buffer with each algorithm, the streaming of an
+// object with TBufferFile, TH1::Fill and FillN, and TFormula::Eval.
+//
+// Each benchmark is first calibrated, increasing its number of iterations
+// until one run lasts at least min-time seconds, then run 'repetitions'
+// times; the median time per iteration is reported. The fixtures (the
+// input values, the trees to read, the buffers to decompress) are built
+// once from a fixed seed and are not timed. With '-threads n', the
+// benchmarks that only use objects of their own are also run concurrently
+// in n threads. The results can be written in the JSON format of Google
+// Benchmark, to be compared by its tools.
+//
+// Usage: hotpathbm [-filter name] [-threads n] [-repetitions n] [-min-time s] [-json file]
+//
+// parameters:
+//       filter        - run only the benchmarks whose name contains 'name'
+//       threads       - number of threads of the multithreaded variants (default 1, none)
+//       repetitions   - number of timed runs of each benchmark (default 5)
+//       min-time      - minimal duration in seconds of one run (default 0.5)
+//       json          - file in which the results are written in JSON
+
+Int_t       nthreads    = 1;      // Threads of the multithreaded variants.
+Int_t       repetitions = 5;      // Timed runs of each benchmark.
+Double_t    mintime     = 0.5;    // Minimal duration of one run.
+std::string filter;               // Substring of the names of the benchmarks to run.
+std::string jsonfile;             // Output file for the JSON results.
+
+const Int_t   kNvalues      = 1 << 20;   // Number of input values, a power of 2.
+const Long64_t kReadEntries = 1000000;   // Entries of the trees read back.
+const Int_t   kZipBlock     = 256 * 1024;
+
+volatile Double_t gSink = 0;             // keeps the results of the loops alive
+
+// The body of a benchmark runs n iterations and returns the number of bytes
+// processed, 0 if not relevant, or -1 if it is not available on this build.
+typedef std::function<Long64_t(Long64_t)> BenchFunc_t;
+
+struct Benchmark {
+   std::string fName;
+   BenchFunc_t fFunc;
+   Bool_t      fThreaded;    // uses only objects of its own, can run in several threads
+};
+
+struct Result {
+   std::string fName;
+   Int_t       fThreads;
+   Long64_t    fIterations;  // iterations of each run
+   Double_t    fRealTime;    // median ns per iteration, per thread
+   Double_t    fCpuTime;     // median process cpu ns per iteration, per thread
+   Double_t    fItemsRate;   // iterations per second, all threads
+   Double_t    fBytesRate;   // bytes per second, all threads
+};
+
+//_____________________________________________________________
+// Fixtures
+
+const std::vector<Double_t> &Values()
+{
+   // Gaussian values, rounded as for detector quantities so that the
+   // buffers made of them compress like real data.
+   static std::vector<Double_t> values;
+   if (values.empty()) {
+      TRandom3 rnd(4357);
+      values.resize(kNvalues);
+      for (Int_t i = 0; i < kNvalues; i++) values[i] = TMath::Nint(rnd.Gaus() * 1000) / 1000.;
+   }
+   return values;
+}
+
+struct TreeFixture {
+   TMemFile *fFile;
+   TTree    *fTree;
+   Float_t   fPx, fPy, fPz;
+   Int_t     fEvent;
+};
+
+void BookTree(TTree *tree, TreeFixture &fix)
+{
+   tree->Branch("px",    &fix.fPx,    "px/F");
+   tree->Branch("py",    &fix.fPy,    "py/F");
+   tree->Branch("pz",    &fix.fPz,    "pz/F");
+   tree->Branch("event", &fix.fEvent, "event/I");
+}
+
+void FillEntry(TTree *tree, TreeFixture &fix, Long64_t i)
+{
+   const std::vector<Double_t> &v = Values();
+   fix.fPx = v[i & (kNvalues - 1)];
+   fix.fPy = v[(i + 1) & (kNvalues - 1)];
+   fix.fPz = v[(i + 2) & (kNvalues - 1)];
+   fix.fEvent = Int_t(i);
+   tree->Fill();
+}
+
+TreeFixture *MakeReadFixture(const char *name)
+{
+   // A tree of kReadEntries entries, written with the default compression
+   // into a memory file.
+   TDirectory::TContext context;
+   TreeFixture *fix = new TreeFixture;
+   fix->fFile = new TMemFile(name, "RECREATE");
+   fix->fTree = new TTree("T", "hot path benchmark");
+   BookTree(fix->fTree, *fix);
+   for (Long64_t i = 0; i < kReadEntries; i++) FillEntry(fix->fTree, *fix, i);
+   fix->fTree->Write();
+   fix->fTree->DropBaskets();
+   return fix;
+}
+
+const std::vector<char> &ZipInput()
+{
+   // One block of floats as streamed by TBufferFile.
+   static std::vector<char> input;
+   if (input.empty()) {
+      const std::vector<Double_t> &v = Values();
+      TBufferFile b(TBuffer::kWrite, kZipBlock + 1024);
+      for (Int_t i = 0; b.Length() + (Int_t)sizeof(Float_t) <= kZipBlock; i++) b << Float_t(v[i]);
+      input.assign(b.Buffer(), b.Buffer() + b.Length());
+   }
+   return input;
+}
+
+//_____________________________________________________________
+// Benchmarks
+
+Long64_t BenchTreeFill(Long64_t n)
+{
+   // Uncompressed, to time the filling and the streaming into the baskets.
+   TDirectory::TContext context;
+   TMemFile file("hotpathbm_fill.root", "RECREATE", "", 0);
+   TreeFixture fix;
+   TTree *tree = new TTree("T", "hot path benchmark");
+   BookTree(tree, fix);
+   for (Long64_t i = 0; i < n; i++) FillEntry(tree, fix, i);
+   delete tree;
+   return n * (3 * sizeof(Float_t) + sizeof(Int_t));
+}
+
+Long64_t BenchBranchGetEntry(Long64_t n)
+{
+   static TreeFixture *fix = MakeReadFixture("hotpathbm_getentry.root");
+   TBranch *branch = fix->fTree->GetBranch("px");
+   Double_t sum = 0;
+   for (Long64_t i = 0; i < n; i++) {
+      branch->GetEntry(i % kReadEntries);
+      sum += fix->fPx;
+   }
+   gSink = gSink + sum;
+   return n * sizeof(Float_t);
+}
+
+Long64_t BenchTreeReader(Long64_t n)
+{
+   static TreeFixture *fix = MakeReadFixture("hotpathbm_reader.root");
+   TTreeReader reader(fix->fTree);
+   TTreeReaderValue<Float_t> px(reader, "px");
+   TTreeReaderValue<Float_t> py(reader, "py");
+   Double_t sum = 0;
+   for (Long64_t i = 0; i < n; i++) {
+      if (!reader.Next()) {
+         reader.SetEntry(0);
+      }
+      sum += *px + *py;
+   }
+   gSink = gSink + sum;
+   return n * 2 * sizeof(Float_t);
+}
+
+Long64_t BenchZip(Int_t algorithm, Long64_t n)
+{
+   const std::vector<char> &input = ZipInput();
+   std::vector<char> src(input), tgt(input.size() + 1024);
+   for (Long64_t i = 0; i < n; i++) {
+      Int_t srcsize = src.size(), tgtsize = tgt.size(), irep = 0;
+      R__zipMultipleAlgorithm(1, &srcsize, &src[0], &tgtsize, &tgt[0], &irep, algorithm);
+      if (irep <= 0) return -1;
+   }
+   return n * input.size();
+}
+
+Long64_t BenchUnzip(Int_t algorithm, Long64_t n)
+{
+   const std::vector<char> &input = ZipInput();
+   std::vector<char> src(input), zipped(input.size() + 1024), tgt(input.size());
+   Int_t srcsize = src.size(), zipsize = zipped.size(), irep = 0;
+   R__zipMultipleAlgorithm(1, &srcsize, &src[0], &zipsize, &zipped[0], &irep, algorithm);
+   if (irep <= 0) return -1;
+   zipsize = irep;
+   for (Long64_t i = 0; i < n; i++) {
+      Int_t insize = zipsize, outsize = tgt.size(), orep = 0;
+      R__unzip(&insize, (unsigned char *)&zipped[0], &outsize, (unsigned char *)&tgt[0], &orep);
+      if (orep != (Int_t)input.size()) return -1;
+   }
+   return n * input.size();
+}
+
+Long64_t BenchBufferStreaming(Long64_t n)
+{
+   TH1F h("hotpathbm_stream", "streamed histogram", 100, -4, 4);
+   h.SetDirectory(0);
+   const std::vector<Double_t> &v = Values();
+   for (Int_t i = 0; i < 10000; i++) h.Fill(v[i]);
+
+   TBufferFile b(TBuffer::kWrite);
+   Long64_t nbytes = 0;
+   for (Long64_t i = 0; i < n; i++) {
+      b.SetWriteMode();
+      b.Reset();
+      b.WriteObject(&h);
+      nbytes += b.Length();
+      b.SetReadMode();
+      b.Reset();
+      delete b.ReadObject(TH1F::Class());
+   }
+   return nbytes;
+}
+
+Long64_t BenchH1Fill(Long64_t n)
+{
+   TH1D h("hotpathbm_fill", "filled histogram", 100, -4, 4);
+   h.SetDirectory(0);
+   const std::vector<Double_t> &v = Values();
+   for (Long64_t i = 0; i < n; i++) h.Fill(v[i & (kNvalues - 1)]);
+   return 0;
+}
+
+Long64_t BenchH1FillN(Long64_t n)
+{
+   const Int_t chunk = 1000;
+   TH1D h("hotpathbm_filln", "filled histogram", 100, -4, 4);
+   h.SetDirectory(0);
+   const std::vector<Double_t> &v = Values();
+   for (Long64_t i = 0; i < n; i += chunk) {
+      Int_t first = Int_t(i & (kNvalues - 1)) / chunk * chunk;
+      h.FillN(Int_t(std::min<Long64_t>(chunk, n - i)), &v[first], 0);
+   }
+   return 0;
+}
+
+Long64_t BenchFormulaEval(Long64_t n)
+{
+   static TFormula formula("hotpathbm_formula", "[0]+[1]*x+sin(x)*exp(-0.5*x*x)");
+   formula.SetParameters(1., 2.);
+   const std::vector<Double_t> &v = Values();
+   Double_t sum = 0;
+   for (Long64_t i = 0; i < n; i++) sum += formula.Eval(v[i & (kNvalues - 1)]);
+   gSink = gSink + sum;
+   return 0;
+}
+
+//_____________________________________________________________
+// Runner
+
+Double_t Median(std::vector<Double_t> t)
+{
+   std::sort(t.begin(), t.end());
+   return t.size() % 2 ? t[t.size() / 2] : 0.5 * (t[t.size() / 2 - 1] + t[t.size() / 2]);
+}
+
+Bool_t RunOnce(const Benchmark &bench, Int_t threads, Long64_t n,
+               Double_t &real, Double_t &cpu, Long64_t &nbytes)
+{
+   // Run n iterations in each of the threads; real and cpu are in seconds.
+   std::vector<Long64_t> bytes(threads, 0);
+   TStopwatch timer;
+   timer.Start();
+   if (threads == 1) {
+      bytes[0] = bench.fFunc(n);
+   } else {
+      std::atomic<Int_t> ready(0);
+      std::vector<std::thread> workers;
+      for (Int_t t = 0; t < threads; t++) {
+         workers.emplace_back([&, t]() {
+            ++ready;
+            while (ready < threads) {}   // start all threads together
+            bytes[t] = bench.fFunc(n);
+         });
+      }
+      for (Int_t t = 0; t < threads; t++) workers[t].join();
+   }
+   timer.Stop();
+   real = timer.RealTime();
+   cpu = timer.CpuTime();
+   nbytes = 0;
+   for (Int_t t = 0; t < threads; t++) {
+      if (bytes[t] < 0) return kFALSE;
+      nbytes += bytes[t];
+   }
+   return kTRUE;
+}
+
+Bool_t RunBenchmark(const Benchmark &bench, Int_t threads, Result &res)
+{
+   Double_t real = 0, cpu = 0;
+   Long64_t nbytes = 0;
+   Long64_t n = 1;
+   // calibrate the number of iterations
+   while (kTRUE) {
+      if (!RunOnce(bench, threads, n, real, cpu, nbytes)) return kFALSE;
+      if (real >= mintime || n >= (1LL << 40)) break;
+      Double_t factor = real > 0 ? 1.4 * mintime / real : 10.;
+      n = Long64_t(n * std::max(2., std::min(10., factor)));
+   }
+
+   std::vector<Double_t> reals, cpus;
+   Long64_t totalbytes = 0;
+   for (Int_t r = 0; r < repetitions; r++) {
+      if (!RunOnce(bench, threads, n, real, cpu, nbytes)) return kFALSE;
+      reals.push_back(real);
+      cpus.push_back(cpu);
+      totalbytes += nbytes;
+   }
+
+   res.fName       = threads > 1 ? Form("%s/threads:%d", bench.fName.c_str(), threads) : bench.fName;
+   res.fThreads    = threads;
+   res.fIterations = n;
+   Double_t medreal = Median(reals);
+   res.fRealTime   = 1e9 * medreal / n;
+   res.fCpuTime    = 1e9 * Median(cpus) / n / threads;
+   res.fItemsRate  = medreal > 0 ? n * threads / medreal : 0;
+   res.fBytesRate  = medreal > 0 ? Double_t(totalbytes) / repetitions / medreal : 0;
+   return kTRUE;
+}
+
+void WriteJSON(const std::vector<Result> &results)
+{
+   FILE *out = fopen(jsonfile.c_str(), "w");
+   if (!out) {
+      std::cout << "hotpathbm: cannot write " << jsonfile << std::endl;
+      return;
+   }
+   SysInfo_t sys;
+   gSystem->GetSysInfo(&sys);
+   fprintf(out, "{\n  \"context\": {\n");
+   fprintf(out, "    \"date\": \"%s\",\n", TDatime().AsSQLString());
+   fprintf(out, "    \"executable\": \"hotpathbm\",\n");
+   fprintf(out, "    \"num_cpus\": %d,\n", sys.fCpus);
+   fprintf(out, "    \"mhz_per_cpu\": %d,\n", sys.fCpuSpeed);
+   fprintf(out, "    \"library_version\": \"%s\"\n  },\n", gROOT->GetVersion());
+   fprintf(out, "  \"benchmarks\": [\n");
+   for (size_t i = 0; i < results.size(); i++) {
+      const Result &r = results[i];
+      fprintf(out, "    {\n      \"name\": \"%s\",\n", r.fName.c_str());
+      fprintf(out, "      \"iterations\": %lld,\n", r.fIterations);
+      fprintf(out, "      \"threads\": %d,\n", r.fThreads);
+      fprintf(out, "      \"real_time\": %g,\n", r.fRealTime);
+      fprintf(out, "      \"cpu_time\": %g,\n", r.fCpuTime);
+      fprintf(out, "      \"time_unit\": \"ns\",\n");
+      if (r.fBytesRate > 0) fprintf(out, "      \"bytes_per_second\": %g,\n", r.fBytesRate);
+      fprintf(out, "      \"items_per_second\": %g\n", r.fItemsRate);
+      fprintf(out, "    }%s\n", i + 1 < results.size() ? "," : "");
+   }
+   fprintf(out, "  ]\n}\n");
+   fclose(out);
+}
+
+//_____________________________________________________________
+
+int main(int argc,char **argv)
+{
+   for (int i = 1; i < argc; i++) {
+      Bool_t more = i + 1 < argc;
+      if (!strcmp(argv[i], "-filter") && more)           filter = argv[++i];
+      else if (!strcmp(argv[i], "-threads") && more)     nthreads = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-repetitions") && more) repetitions = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-min-time") && more)    mintime = atof(argv[++i]);
+      else if (!strcmp(argv[i], "-json") && more)        jsonfile = argv[++i];
+      else {
+         std::cout << "Usage: hotpathbm [-filter name] [-threads n] [-repetitions n] "
+                      "[-min-time s] [-json file]" << std::endl;
+         return 1;
+      }
+   }
+   if (nthreads < 1 || repetitions < 1 || mintime < 0) {
+      std::cout << "hotpathbm: invalid parameters" << std::endl;
+      return 1;
+   }
+   if (nthreads > 1) ROOT::EnableThreadSafety();
+   TH1::AddDirectory(kFALSE);
+
+   std::vector<Benchmark> benchmarks;
+   benchmarks.push_back({"TTree::Fill",       BenchTreeFill,        kTRUE});
+   benchmarks.push_back({"TBranch::GetEntry", BenchBranchGetEntry,  kFALSE});
+   benchmarks.push_back({"TTreeReader",       BenchTreeReader,      kFALSE});
+   const struct { const char *fName; Int_t fAlgorithm; } algorithms[] = {
+      {"ZLIB", ROOT::kZLIB}, {"LZMA", ROOT::kLZMA}, {"LZ4", ROOT::kLZ4}, {"ZSTD", ROOT::kZSTD}};
+   for (const auto &alg : algorithms) {
+      Int_t algorithm = alg.fAlgorithm;
+      benchmarks.push_back({std::string("R__zipMultipleAlgorithm/") + alg.fName,
+                            [algorithm](Long64_t n) { return BenchZip(algorithm, n); }, kTRUE});
+      benchmarks.push_back({std::string("R__unzip/") + alg.fName,
+                            [algorithm](Long64_t n) { return BenchUnzip(algorithm, n); }, kTRUE});
+   }
+   benchmarks.push_back({"TBufferFile::WriteObject+ReadObject", BenchBufferStreaming, kTRUE});
+   benchmarks.push_back({"TH1::Fill",         BenchH1Fill,          kTRUE});
+   benchmarks.push_back({"TH1::FillN",        BenchH1FillN,         kTRUE});
+   benchmarks.push_back({"TFormula::Eval",    BenchFormulaEval,     kFALSE});
+
+   // build the shared input before any thread uses it
+   Values();
+   ZipInput();
+
+   printf("%-45s %14s %14s %12s %14s\n", "benchmark", "time/iter", "cpu/iter", "iterations", "rate");
+   std::vector<Result> results;
+   for (const Benchmark &bench : benchmarks) {
+      if (!filter.empty() && bench.fName.find(filter) == std::string::npos) continue;
+      std::vector<Int_t> variants(1, 1);
+      if (nthreads > 1 && bench.fThreaded) variants.push_back(nthreads);
+      for (Int_t threads : variants) {
+         Result res;
+         if (!RunBenchmark(bench, threads, res)) {
+            printf("%-45s %14s\n", bench.fName.c_str(), "not available");
+            break;
+         }
+         printf("%-45s %11.1f ns %11.1f ns %12lld ", res.fName.c_str(), res.fRealTime, res.fCpuTime,
+                res.fIterations);
+         if (res.fBytesRate > 0) printf("%9.1f MB/s\n", res.fBytesRate / 1024. / 1024.);
+         else                    printf("%8.3g it/s\n", res.fItemsRate);
+         results.push_back(res);
+      }
+   }
+
+   if (!jsonfile.empty()) WriteJSON(results);
+   return 0;
+}
@@ -27,6 +27,7 @@
 //   stressGeometry
 // or  stressGeometry *
 // or  stressGeometry alice
+// or  stressGeometry shapes   // throughput of the vectorized shape methods
 // or from the ROOT command line
 // root > .L stressGeometry.cxx  or .L stressGeometry.cxx+
 // root > stressGeometry(exp_name); // where exp_name is the geometry file name without .root
@@ -41,6 +42,11 @@
 #include "TGeoMedium.h"
 #include "TGeoMaterial.h"
 #include "TGeoBBox.h"
+#include "TGeoTube.h"
+#include "TGeoCone.h"
+#include "TGeoTrd1.h"
+#include "TGeoTrd2.h"
+#include "TGeoPcon.h"
 #include "TROOT.h"
 #include "TFile.h"
 #include "TTree.h"
@@ -53,18 +59,22 @@
 #include "TSystem.h"
 #include "TVirtualGeoConverter.h"
 
+#include <vector>
+
 // Total and reference times
 Double_t tpstot = 0;
 Double_t tpsref = 112.1; //time including the generation of the ref files
 Bool_t testfailed = kFALSE;
 #ifndef __CINT__
 void stressGeometry(const char*, Bool_t, Bool_t);
+void ShapesBenchmark(Int_t, Int_t);
 
 int main(int argc, char **argv)
 {
    gROOT->SetBatch();
    TApplication theApp("App", &argc, argv);
    Bool_t vecgeom = kFALSE;
+   Bool_t shapes = kFALSE;
    TString geom = "*";
    if (argc > 1) geom = argv[1];
    geom.ToLower();
@@ -74,8 +84,13 @@ int main(int argc, char **argv)
    if (argc > 1) {
        for (Int_t iarg=1; iarg<argc; ++iarg) {
           if (!strcmp(argv[iarg], "vecgeom")) vecgeom = kTRUE;
+          if (!strcmp(argv[iarg], "shapes")) shapes = kTRUE;
        }
    }
+   if (shapes) {
+      ShapesBenchmark(100000, 20);
+      return testfailed ? 1 : 0;
+   }
    stressGeometry(geom,kFALSE,vecgeom);
    return 0;
 }
@@ -610,3 +625,118 @@ void InspectRef(const char *exp, Int_t vers) {
    fprintf(stderr,"Total nradlen: %f\n", vect(3));
    fprintf(stderr,"=====================================\n");
 }
+
+//______________________________________________________________________________
+void BenchmarkShape(TGeoShape *shape, Int_t npoints, Int_t nrep)
+{
+// Compare the vectorized methods of a shape with the corresponding loops over
+// the scalar methods on random points of its bounding box. The results must
+// be identical, the throughput of both is printed in millions of points per second.
+   TGeoBBox *box = (TGeoBBox*)shape;
+   const Double_t *origin = box->GetOrigin();
+   Double_t dd[3] = {box->GetDX(), box->GetDY(), box->GetDZ()};
+   TRandom3 r(4357);
+   std::vector<Double_t> points(3*npoints), dirs(3*npoints), steps(npoints, TGeoShape::Big());
+   for (Int_t i=0; i<npoints; i++) {
+      for (Int_t j=0; j<3; j++) points[3*i+j] = origin[j] + dd[j]*r.Uniform(-1.2, 1.2);
+      r.Sphere(dirs[3*i], dirs[3*i+1], dirs[3*i+2], 1.);
+   }
+   // the inside status selects the points used for the distances
+   Bool_t *inside = new Bool_t[3*npoints];
+   Bool_t *ins = inside + npoints;
+   Bool_t *insv = inside + 2*npoints;
+   shape->Contains_v(&points[0], inside, npoints);
+   std::vector<Double_t> pin, din, pout, dout;
+   for (Int_t i=0; i<npoints; i++) {
+      std::vector<Double_t> &pv = inside[i] ? pin : pout;
+      std::vector<Double_t> &dv = inside[i] ? din : dout;
+      pv.insert(pv.end(), points.begin()+3*i, points.begin()+3*i+3);
+      dv.insert(dv.end(), dirs.begin()+3*i, dirs.begin()+3*i+3);
+   }
+   Int_t nin = pin.size()/3;
+   Int_t nout = pout.size()/3;
+   if (!nin || !nout) {
+      fprintf(stderr,"*     shape %-10s: no points %s\n", shape->ClassName(), nin ? "outside" : "inside");
+      testfailed = kTRUE;
+      delete [] inside;
+      return;
+   }
+   std::vector<Double_t> res(npoints), resv(npoints);
+   const char *methods[4] = {"Contains", "Safety", "DistFromInside", "DistFromOutside"};
+   TStopwatch sw;
+   for (Int_t m=0; m<4; m++) {
+      Int_t n = (m==2) ? nin : ((m==3) ? nout : npoints);
+      Double_t tscalar = 0, tvector = 0;
+      for (Int_t loop=0; loop<2; loop++) {
+         sw.Start();
+         for (Int_t irep=0; irep<nrep; irep++) {
+            switch (m) {
+               case 0:
+                  if (loop) shape->Contains_v(&points[0], insv, n);
+                  else for (Int_t i=0; i<n; i++) ins[i] = shape->Contains(&points[3*i]);
+                  break;
+               case 1:
+                  if (loop) shape->Safety_v(&points[0], inside, &resv[0], n);
+                  else for (Int_t i=0; i<n; i++) res[i] = shape->Safety(&points[3*i], inside[i]);
+                  break;
+               case 2:
+                  if (loop) shape->DistFromInside_v(&pin[0], &din[0], &resv[0], n, &steps[0]);
+                  else for (Int_t i=0; i<n; i++) res[i] = shape->DistFromInside(&pin[3*i], &din[3*i], 3, steps[i]);
+                  break;
+               default:
+                  if (loop) shape->DistFromOutside_v(&pout[0], &dout[0], &resv[0], n, &steps[0]);
+                  else for (Int_t i=0; i<n; i++) res[i] = shape->DistFromOutside(&pout[3*i], &dout[3*i], 3, steps[i]);
+            }
+         }
+         sw.Stop();
+         if (loop) tvector = sw.CpuTime();
+         else      tscalar = sw.CpuTime();
+      }
+      Int_t nbad = 0;
+      for (Int_t i=0; i<n; i++) {
+         if ((m==0) ? (ins[i] != insv[i]) : (res[i] != resv[i])) nbad++;
+      }
+      Double_t mpts = 1E-6*n*nrep;
+      if (nbad) {
+         fprintf(stderr,"*     shape %-10s %-16s: %d points differ ......... failed\n", shape->ClassName(), methods[m], nbad);
+         testfailed = kTRUE;
+      } else {
+         fprintf(stderr,"*     shape %-10s %-16s: scalar %8.2f, vector %8.2f Mpoints/s\n", shape->ClassName(), methods[m],
+                 (tscalar>0) ? mpts/tscalar : 0., (tvector>0) ? mpts/tvector : 0.);
+      }
+   }
+   delete [] inside;
+}
+
+//______________________________________________________________________________
+void ShapesBenchmark(Int_t npoints=100000, Int_t nrep=20)
+{
+// Throughput benchmark of the vectorized navigation methods (Contains_v,
+// Safety_v, DistFromInside_v, DistFromOutside_v) of the most common shapes,
+// compared with loops over their scalar methods.
+   fprintf(stderr,"******************************************************************\n");
+   fprintf(stderr,"* STRESS GEOMETRY - SHAPES BENCHMARK\n");
+   if (gGeoManager) {
+      delete gGeoManager;
+      gGeoManager = 0;
+   }
+   new TGeoManager("shapes", "shapes benchmark");
+   Double_t origin[3] = {1., -2., 3.};
+   TGeoPcon *pcon = new TGeoPcon(0., 360., 4);
+   pcon->DefineSection(0, -20., 2., 10.);
+   pcon->DefineSection(1, -5., 2., 15.);
+   pcon->DefineSection(2, 5., 5., 15.);
+   pcon->DefineSection(3, 20., 5., 8.);
+   TGeoShape *shapes[] = {new TGeoBBox(10., 20., 30., origin),
+                          new TGeoTube(5., 10., 20.),
+                          new TGeoTubeSeg(5., 10., 20., -30., 120.),
+                          new TGeoCone(20., 2., 6., 5., 10.),
+                          new TGeoConeSeg(20., 2., 6., 5., 10., 10., 250.),
+                          new TGeoTrd1(5., 10., 15., 20.),
+                          new TGeoTrd2(5., 10., 15., 8., 20.),
+                          pcon};
+   for (UInt_t i=0; i<sizeof(shapes)/sizeof(shapes[0]); i++) BenchmarkShape(shapes[i], npoints, nrep);
+   delete gGeoManager;
+   gGeoManager = 0;
+   fprintf(stderr,"******************************************************************\n");
+}
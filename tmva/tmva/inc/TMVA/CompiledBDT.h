@@ -0,0 +1,89 @@
+// @(#)root/tmva $Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TMVA_CompiledBDT
+#define ROOT_TMVA_CompiledBDT
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// CompiledBDT                                                          //
+//                                                                      //
+// Immutable copy of a trained classification BDT for the evaluation    //
+// of its MVA response. It holds everything needed to compute the       //
+// response in a FlatForest and does not refer to the method, the      //
+// reader or to any global state after its construction, so a single    //
+// instance can be shared by many threads, which call Evaluate          //
+// concurrently.                                                        //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "TString.h"
+
+#ifndef ROOT_TMVA_FlatForest
+#include "TMVA/FlatForest.h"
+#endif
+
+namespace TMVA {
+
+   class MethodBDT;
+   class MsgLogger;
+
+   class CompiledBDT {
+
+   public:
+
+      // copy the trees and the preselection cuts of 'bdt', which must be a
+      // trained classification BDT without variable transformations
+      CompiledBDT( const MethodBDT& bdt,
+                   FlatForest::ENodeOrdering ordering = FlatForest::kDepthFirst,
+                   Bool_t quantizeCuts = kFALSE );
+      ~CompiledBDT();
+
+      // number of input variables and their expressions, in the order in which
+      // the values of an event are passed to Evaluate
+      UInt_t         GetNVariables() const { return fExpressions.size(); }
+      const TString& GetVariableExpression( UInt_t ivar ) const { return fExpressions[ivar]; }
+
+      const FlatForest& GetForest() const { return fForest; }
+
+      // MVA value of one event with the variable values vars[0] ... vars[nvar-1]
+      Double_t Evaluate( const Float_t* vars ) const;
+
+      // MVA values of 'nEvents' events, the values of event i being
+      // vars[i*nvar] ... vars[(i+1)*nvar-1]
+      void     Evaluate( const Float_t* vars, UInt_t nEvents, Double_t* mvaValues ) const;
+
+   private:
+
+      Double_t ApplyPreselectionCuts( const Float_t* values ) const;
+      Double_t CombineTreeValues( Double_t sum ) const;
+
+      MsgLogger& Log() const;
+
+      FlatForest            fForest;          // the trees of the BDT
+      Bool_t                fGradBoost;       // the trees are combined as in gradient boosting
+      Double_t              fSumOfWeights;    // sum of the boost weights of the trees
+      Bool_t                fDoPreselection;  // apply the preselection cuts
+      std::vector<Double_t> fLowSigCut;       // preselection cuts, as in MethodBDT
+      std::vector<Double_t> fLowBkgCut;
+      std::vector<Double_t> fHighSigCut;
+      std::vector<Double_t> fHighBkgCut;
+      std::vector<Bool_t>   fIsLowSigCut;
+      std::vector<Bool_t>   fIsLowBkgCut;
+      std::vector<Bool_t>   fIsHighSigCut;
+      std::vector<Bool_t>   fIsHighBkgCut;
+      std::vector<TString>  fExpressions;     // expressions of the input variables
+   };
+
+} // namespace TMVA
+
+#endif
@@ -52,6 +52,8 @@
 #include <TMVA/Envelope.h>
 #endif
 
+class TList;
+
 namespace TMVA {
 
    class CrossValidationResult {
@@ -100,6 +102,7 @@ namespace TMVA {
       UInt_t                 fNumFolds;     //!
       CrossValidationResult  fResults;      //!
       Bool_t                 fFoldStatus;   //!
+      UInt_t                 fNWorkers;     //! number of worker processes for the folds
    public:
       explicit CrossValidation(DataLoader *loader);
       ~CrossValidation();
@@ -107,12 +110,17 @@ namespace TMVA {
       void SetNumFolds(UInt_t i);
       UInt_t GetNumFolds() {return fNumFolds;}
 
+      // process the folds in up to n forked worker processes (serially for n < 2)
+      void SetNWorkers(UInt_t n) {fNWorkers=n;}
+      UInt_t GetNWorkers() const {return fNWorkers;}
+
       virtual void Evaluate();
-//    void EvaluateFold(UInt_t fold);//used in ParallelExecution
 
       const CrossValidationResult& GetResults() const;
 
    private:
+      TList* EvaluateFold(UInt_t fold, const TString &methodName, const TString &methodTitle, const TString &methodOptions);
+
       std::unique_ptr<Factory> fClassifier;
       ClassDef(CrossValidation, 0);
    };
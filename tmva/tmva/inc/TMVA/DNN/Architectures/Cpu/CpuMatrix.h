@@ -17,6 +17,7 @@
 #ifndef TMVA_DNN_ARCHITECTURES_CPU_CPUMATRIX
 #define TMVA_DNN_ARCHITECTURES_CPU_CPUMATRIX
 
+#include <algorithm>
 #include <cstddef>
 #include <vector>
 
@@ -34,7 +35,10 @@ namespace DNN
  * Matrix class for multi-threaded CPU architectures. Uses the TCpuBuffer
  * class to store the matrices in column-major format for compatibility with
  * BLAS. Provides Map and MapFrom member functions to simplify the application of
- * activation functions and derivatives to matrices.
+ * activation functions and derivatives to matrices. Element-wise kernels and
+ * reductions are split into ranges of about fgElementsPerTask elements, each of
+ * which is processed by one task of the thread pool, using ForEachRange and
+ * SumRanges.
  *
  * Copying and assignment of TCpuMatrix objects only performs shallow copies, i.e.
  * copying is fast and the resulting objects share the element data.
@@ -50,6 +54,10 @@ private:
    static ROOT::TThreadExecutor fPool;
    static std::vector<AFloat> fOnes;  ///< Vector filled with ones used for BLAS calls.
 
+   /** Number of ranges into which \p nItems items of \p itemSize elements
+    *  each are split for ForEachRange and SumRanges. */
+   static size_t GetNRanges(size_t nItems, size_t itemSize);
+
    TCpuBuffer<AFloat> fBuffer; ///< The buffer holding the matrix elements
                                ///< in column-major format.
    size_t     fNCols;
@@ -57,6 +65,11 @@ private:
 
 public:
 
+   /** Number of matrix elements processed by one task of the thread pool in
+    *  the element-wise kernels. Smaller matrices are processed in the calling
+    *  thread. */
+   static constexpr size_t fgElementsPerTask = 4096;
+
    /** Returns pointer to a vector holding only ones with a guaranteed length
     *  of the number of columns of every instantiated CpuMatrix object. */
    static const AFloat * GetOnePointer() {return fOnes.data();}
@@ -80,6 +93,21 @@ public:
     *  elements. */
    operator TMatrixT<Double_t>() const;
 
+   /** Call \p f(begin, end) on contiguous ranges [begin, end) that together
+    *  cover the items 0, ..., \p nItems - 1. The ranges are processed in
+    *  parallel using TThreadExecutor. \p itemSize is the number of matrix
+    *  elements processed per item, e.g. the number of columns for kernels that
+    *  work row by row, and is used to choose the size of the ranges. */
+   template <typename Function_t>
+   static void ForEachRange(Function_t &f, size_t nItems, size_t itemSize = 1);
+
+   /** Same as ForEachRange, but \p f(begin, end) returns a partial sum over its
+    *  range and the total sum is returned. The partial sums are added in the
+    *  order of the ranges, so that the result does not depend on the scheduling
+    *  of the threads. */
+   template <typename Function_t>
+   static AFloat SumRanges(Function_t &f, size_t nItems, size_t itemSize = 1);
+
    /** Map the given function over the matrix elements. Executed in parallel
     *  using TThreadExecutor. */
    template <typename Function_t>
@@ -112,6 +140,59 @@ private:
 };
 
 // Inline Functions.
+//______________________________________________________________________________
+template<typename AFloat>
+inline size_t TCpuMatrix<AFloat>::GetNRanges(size_t nItems, size_t itemSize)
+{
+   size_t nElements = nItems * std::max(itemSize, (size_t) 1);
+   size_t nRanges   = (nElements + fgElementsPerTask - 1) / fgElementsPerTask;
+   return std::min(nRanges, nItems);
+}
+
+//______________________________________________________________________________
+template<typename AFloat>
+template<typename Function_t>
+inline void TCpuMatrix<AFloat>::ForEachRange(Function_t &f, size_t nItems, size_t itemSize)
+{
+   size_t nRanges = GetNRanges(nItems, itemSize);
+   if (nRanges < 2) {
+      if (nItems > 0) f((size_t) 0, nItems);
+      return;
+   }
+
+   auto ff = [&f, nItems, nRanges](UInt_t range)
+   {
+      f(range * nItems / nRanges, (range + 1) * nItems / nRanges);
+   };
+
+   fPool.Foreach(ff, ROOT::TSeqU(nRanges));
+}
+
+//______________________________________________________________________________
+template<typename AFloat>
+template<typename Function_t>
+inline AFloat TCpuMatrix<AFloat>::SumRanges(Function_t &f, size_t nItems, size_t itemSize)
+{
+   size_t nRanges = GetNRanges(nItems, itemSize);
+   if (nRanges < 2) {
+      return (nItems > 0) ? f((size_t) 0, nItems) : 0.0;
+   }
+
+   std::vector<AFloat> sums(nRanges);
+   auto ff = [&f, &sums, nItems, nRanges](UInt_t range)
+   {
+      sums[range] = f(range * nItems / nRanges, (range + 1) * nItems / nRanges);
+   };
+
+   fPool.Foreach(ff, ROOT::TSeqU(nRanges));
+
+   AFloat sum = 0.0;
+   for (size_t i = 0; i < nRanges; i++) {
+      sum += sums[i];
+   }
+   return sum;
+}
+
 //______________________________________________________________________________
 template<typename AFloat>
 template<typename Function_t>
@@ -119,15 +200,17 @@ inline void TCpuMatrix<AFloat>::Map(Function_t &f)
 {
    AFloat  *data = GetRawDataPointer();
 
-   auto ff = [data, &f](UInt_t workerID)
+   auto ff = [data, &f](size_t begin, size_t end)
    {
-      data[workerID] = f(data[workerID]);
-      return 0;
+      for (size_t i = begin; i < end; i++) {
+         data[i] = f(data[i]);
+      }
    };
 
-   fPool.Map(ff, ROOT::TSeqI(fNCols * fNRows));
+   ForEachRange(ff, GetNElements());
 }
 
+//______________________________________________________________________________
 template<typename AFloat>
 template<typename Function_t>
 inline void TCpuMatrix<AFloat>::MapFrom(Function_t &f, const TCpuMatrix &A)
@@ -135,13 +218,14 @@ inline void TCpuMatrix<AFloat>::MapFrom(Function_t &f, const TCpuMatrix &A)
          AFloat  *dataB = GetRawDataPointer();
    const AFloat  *dataA = A.GetRawDataPointer();
 
-   auto ff = [&dataB, &dataA, &f](UInt_t workerID)
+   auto ff = [dataB, dataA, &f](size_t begin, size_t end)
    {
-      dataB[workerID] = f(dataA[workerID]);
-      return 0;
+      for (size_t i = begin; i < end; i++) {
+         dataB[i] = f(dataA[i]);
+      }
    };
 
-   fPool.Map(ff, ROOT::TSeqI(fNCols * fNRows));
+   ForEachRange(ff, GetNElements());
 }
 
 } // namespace DNN
@@ -19,6 +19,8 @@
 #define TMVA_DNN_DATALOADER
 
 #include "TMatrix.h"
+#include <deque>
+#include <future>
 #include <vector>
 #include <iostream>
 
@@ -114,6 +116,13 @@ TBatchIterator(TDataLoader<Data_t, AArchitecture> & dataLoader, size_t index = 0
  * the complete training set. Using the begin() and end() member functions allows
  * the user to iterate over the batches in one epoch.
  *
+ * The batches are prepared by copying the sampled events into a host buffer
+ * and transferring it to the device. If a number of prefetched batches is
+ * given, the following batches are prepared in the background while the
+ * current ones are processed. One buffer pair is allocated for each stream
+ * and for each prefetched batch, so that the user can keep up to nStreams
+ * batches alive at any time without them being overwritten.
+ *
  * \tparam AData The input data type.
  * \tparam AArchitecture The achitecture class of the underlying architecture.
  */
@@ -135,20 +144,36 @@ private:
    size_t fNOutputFeatures;
    size_t fBatchIndex;
 
-   size_t fNStreams;                            ///< Number of buffer pairs.
+   size_t fNStreams;                            ///< Number of batches the user may hold.
+   size_t fNPrefetch;                           ///< Number of batches prepared ahead.
+   size_t fBufferIndex;                         ///< Buffer pair of the next prepared batch.
    std::vector<DeviceBuffer_t> fDeviceBuffers;
    std::vector<HostBuffer_t>   fHostBuffers;
 
    std::vector<size_t> fSampleIndices; ///< Ordering of the samples in the epoch.
 
+   /** Buffer pair indices and completion of the batches being prepared, in
+    *  the order in which they are returned. Declared last so that pending
+    *  copies are waited for before the buffers are destroyed. */
+   std::deque<std::pair<size_t, std::future<void>>> fPending;
+
+   /** Start the preparation of the next batch in the next buffer pair. */
+   void PushBatch();
+   /** Copy the batch with index batchIndex into the buffer pair with index
+    *  bufferIndex and transfer it to the device. */
+   void PrepareBatch(size_t batchIndex, size_t bufferIndex);
+   /** Wait for the batches in preparation and discard them. */
+   void DiscardPending();
+
 public:
 
    TDataLoader(const Data_t & data, size_t nSamples, size_t batchSize,
-               size_t nInputFeatures, size_t nOutputFeatures, size_t nStreams = 1);
-   TDataLoader(const TDataLoader  &) = default;
-   TDataLoader(      TDataLoader &&) = default;
-   TDataLoader & operator=(const TDataLoader  &) = default;
-   TDataLoader & operator=(      TDataLoader &&) = default;
+               size_t nInputFeatures, size_t nOutputFeatures, size_t nStreams = 1,
+               size_t nPrefetch = 0);
+   TDataLoader(const TDataLoader  &) = delete;
+   TDataLoader(      TDataLoader &&) = delete;
+   TDataLoader & operator=(const TDataLoader  &) = delete;
+   TDataLoader & operator=(      TDataLoader &&) = delete;
 
    /** Copy input matrix into the given host buffer. Function to be specialized by
     *  the architecture-specific backend. */
@@ -165,12 +190,13 @@ public:
 
    /** Shuffle the order of the samples in the batch. The shuffling is indirect,
     *  i.e. only the indices are shuffled. No input data is moved by this
-    * routine. */
+    * routine. Batches prefetched with the previous ordering are discarded. */
    void Shuffle();
 
    /** Return the next batch from the training set. The TDataLoader object
     *  keeps an internal counter that cycles over the batches in the training
-    *  set. */
+    *  set. The preparation of the following nPrefetch batches is started
+    *  before returning. */
    TBatch<AArchitecture> GetBatch();
 
 };
@@ -191,16 +217,17 @@ TBatch<AArchitecture>::TBatch(Matrix_t & inputMatrix, Matrix_t & outputMatrix)
 template<typename Data_t, typename AArchitecture>
 TDataLoader<Data_t, AArchitecture>::TDataLoader(
     const Data_t & data, size_t nSamples, size_t batchSize,
-    size_t nInputFeatures, size_t nOutputFeatures, size_t nStreams)
+    size_t nInputFeatures, size_t nOutputFeatures, size_t nStreams,
+    size_t nPrefetch)
     : fData(data), fNSamples(nSamples), fBatchSize(batchSize),
       fNInputFeatures(nInputFeatures), fNOutputFeatures(nOutputFeatures),
-      fBatchIndex(0), fNStreams(nStreams), fDeviceBuffers(), fHostBuffers(),
-      fSampleIndices()
+      fBatchIndex(0), fNStreams(nStreams), fNPrefetch(nPrefetch), fBufferIndex(0),
+      fDeviceBuffers(), fHostBuffers(), fSampleIndices(), fPending()
 {
    size_t inputMatrixSize  = fBatchSize * fNInputFeatures;
    size_t outputMatrixSize = fBatchSize * fNOutputFeatures;
 
-   for (size_t i = 0; i < fNStreams; i++)
+   for (size_t i = 0; i < fNStreams + fNPrefetch; i++)
    {
       fHostBuffers.push_back(HostBuffer_t(inputMatrixSize + outputMatrixSize));
       fDeviceBuffers.push_back(DeviceBuffer_t(inputMatrixSize + outputMatrixSize));
@@ -214,36 +241,87 @@ TDataLoader<Data_t, AArchitecture>::TDataLoader(
 
 //______________________________________________________________________________
 template<typename Data_t, typename AArchitecture>
-TBatch<AArchitecture> TDataLoader<Data_t, AArchitecture>::GetBatch()
+void TDataLoader<Data_t, AArchitecture>::PrepareBatch(size_t batchIndex,
+                                                      size_t bufferIndex)
 {
-   fBatchIndex %= (fNSamples / fBatchSize); // Cycle through samples.
-
-
    size_t inputMatrixSize  = fBatchSize * fNInputFeatures;
    size_t outputMatrixSize = fBatchSize * fNOutputFeatures;
 
-   size_t streamIndex = fBatchIndex % fNStreams;
-   HostBuffer_t   & hostBuffer   = fHostBuffers[streamIndex];
-   DeviceBuffer_t & deviceBuffer = fDeviceBuffers[streamIndex];
+   HostBuffer_t   & hostBuffer   = fHostBuffers[bufferIndex];
+   DeviceBuffer_t & deviceBuffer = fDeviceBuffers[bufferIndex];
 
    HostBuffer_t inputHostBuffer  = hostBuffer.GetSubBuffer(0, inputMatrixSize);
    HostBuffer_t outputHostBuffer = hostBuffer.GetSubBuffer(inputMatrixSize,
                                                            outputMatrixSize);
 
-   DeviceBuffer_t inputDeviceBuffer  = deviceBuffer.GetSubBuffer(0, inputMatrixSize);
-   DeviceBuffer_t outputDeviceBuffer = deviceBuffer.GetSubBuffer(inputMatrixSize,
-                                                                 outputMatrixSize);
-   size_t sampleIndex = fBatchIndex * fBatchSize;
+   size_t sampleIndex = batchIndex * fBatchSize;
    IndexIterator_t sampleIndexIterator = fSampleIndices.begin() + sampleIndex;
 
    CopyInput(inputHostBuffer,   sampleIndexIterator, fBatchSize);
    CopyOutput(outputHostBuffer, sampleIndexIterator, fBatchSize);
 
    deviceBuffer.CopyFrom(hostBuffer);
+}
+
+//______________________________________________________________________________
+template<typename Data_t, typename AArchitecture>
+void TDataLoader<Data_t, AArchitecture>::PushBatch()
+{
+   fBatchIndex %= (fNSamples / fBatchSize); // Cycle through samples.
+
+   size_t batchIndex  = fBatchIndex++;
+   size_t bufferIndex = fBufferIndex;
+   fBufferIndex = (fBufferIndex + 1) % fHostBuffers.size();
+
+   // Without prefetching the batch is prepared in the calling thread when it
+   // is requested.
+   auto policy = (fNPrefetch > 0) ? std::launch::async : std::launch::deferred;
+   fPending.emplace_back(bufferIndex,
+                         std::async(policy, [this, batchIndex, bufferIndex]() {
+                            PrepareBatch(batchIndex, bufferIndex);
+                         }));
+}
+
+//______________________________________________________________________________
+template<typename Data_t, typename AArchitecture>
+void TDataLoader<Data_t, AArchitecture>::DiscardPending()
+{
+   size_t nBatches = fNSamples / fBatchSize;
+   for (auto & batch : fPending) {
+      if (batch.second.valid()) batch.second.wait();
+   }
+   // Rewind, so that the discarded batches are returned next.
+   fBatchIndex = (fBatchIndex + nBatches - fPending.size() % nBatches) % nBatches;
+   fBufferIndex = (fBufferIndex + fHostBuffers.size() - fPending.size())
+                  % fHostBuffers.size();
+   fPending.clear();
+}
+
+//______________________________________________________________________________
+template<typename Data_t, typename AArchitecture>
+TBatch<AArchitecture> TDataLoader<Data_t, AArchitecture>::GetBatch()
+{
+   if (fPending.empty()) {
+      PushBatch();
+   }
+   size_t bufferIndex = fPending.front().first;
+   fPending.front().second.get();
+   fPending.pop_front();
+
+   while (fPending.size() < fNPrefetch) {
+      PushBatch();
+   }
+
+   size_t inputMatrixSize  = fBatchSize * fNInputFeatures;
+   size_t outputMatrixSize = fBatchSize * fNOutputFeatures;
+
+   DeviceBuffer_t & deviceBuffer = fDeviceBuffers[bufferIndex];
+   DeviceBuffer_t inputDeviceBuffer  = deviceBuffer.GetSubBuffer(0, inputMatrixSize);
+   DeviceBuffer_t outputDeviceBuffer = deviceBuffer.GetSubBuffer(inputMatrixSize,
+                                                                 outputMatrixSize);
    Matrix_t  inputMatrix(inputDeviceBuffer,  fBatchSize, fNInputFeatures);
    Matrix_t outputMatrix(outputDeviceBuffer, fBatchSize, fNOutputFeatures);
 
-   fBatchIndex++;
    return TBatch<AArchitecture>(inputMatrix, outputMatrix);
 }
 
@@ -251,6 +329,7 @@ TBatch<AArchitecture> TDataLoader<Data_t, AArchitecture>::GetBatch()
 template<typename Data_t, typename AArchitecture>
 void TDataLoader<Data_t, AArchitecture>::Shuffle()
 {
+   DiscardPending();
    std::random_shuffle(fSampleIndices.begin(), fSampleIndices.end());
 }
 
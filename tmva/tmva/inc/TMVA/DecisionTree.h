@@ -242,6 +242,7 @@ namespace TMVA {
 
       UInt_t     fMaxDepth;      // max depth
       UInt_t     fSigClass;      // class which is treated as signal when building the tree
+      static const UInt_t fgMinEventsMT = 1000; // minimal number of events in a node to fill its histograms in parallel
       static const Int_t  fgDebugLevel = 0;     // debug level determining some printout/control plots etc.
       Int_t     fTreeID;        // just an ID number given to the tree.. makes debugging easier as tree knows who he is.
 
@@ -138,6 +138,10 @@ namespace TMVA {
       Bool_t Verbose( void ) const { return fVerbose; }
       void SetVerbose( Bool_t v=kTRUE );
 
+      // number of worker processes training the methods of a dataset (0 or 1: no worker)
+      void SetNWorkers(UInt_t n) { fNWorkers = n; }
+      UInt_t GetNWorkers() const { return fNWorkers; }
+
       // make ROOT-independent C++ class for classifier response 
       // (classifier-specific implementation)
       // If no classifier name is given, help messages for all booked 
@@ -183,6 +187,11 @@ namespace TMVA {
       
       void WriteDataInformation(DataSetInfo&     fDataSetInfo);
 
+      // checks before the training of a method, false if it must not be trained
+      Bool_t PrepareTraining(MethodBase *mva);
+      // trains the methods in fNWorkers processes, false if not possible
+      Bool_t TrainMethodsInWorkers(MVector *methods);
+
       void SetInputTreesFromEventAssignTrees();
 
    private:
@@ -206,6 +215,7 @@ namespace TMVA {
 
       Types::EAnalysisType                      fAnalysisType;    //! the training type
       Bool_t                                    fModelPersistence;//!option to save the trained model in xml file or using serialization
+      UInt_t                                    fNWorkers;        //! number of worker processes for the trainings
       
       
    protected:
@@ -0,0 +1,112 @@
+// @(#)root/tmva $Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TMVA_FlatForest
+#define ROOT_TMVA_FlatForest
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// FlatForest                                                           //
+//                                                                      //
+// Read-only copy of a forest of decision trees in which the nodes of   //
+// all trees are stored in one contiguous array. Each node holds the    //
+// index of its variable, its cut and the positions of its daughters,   //
+// so that an event descends a tree without following pointers to      //
+// individual node objects. The leaves hold the value that              //
+// DecisionTree::CheckEvent returns, hence the results are identical to //
+// those of the original trees.                                         //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include "Rtypes.h"
+
+namespace TMVA {
+
+   class DecisionTree;
+   class DecisionTreeNode;
+   class MsgLogger;
+
+   class FlatForest {
+
+   public:
+
+      // order of the nodes of a tree in the array
+      enum ENodeOrdering { kDepthFirst = 0, kBreadthFirst };
+
+      FlatForest();
+
+      // compile the trees of 'forest', which are evaluated on events with 'nVars'
+      // variables. The value of each tree is multiplied by the corresponding
+      // entry of 'weights', if given. If 'quantizeCuts' is set, the values of the
+      // events are converted once to their positions among all cuts on the same
+      // variable, and the nodes compare integer positions instead of cut values
+      FlatForest( const std::vector<DecisionTree*>& forest, UInt_t nVars,
+                  const std::vector<Double_t>& weights = std::vector<Double_t>(),
+                  Bool_t useYesNoLeaf = kFALSE, ENodeOrdering ordering = kDepthFirst,
+                  Bool_t quantizeCuts = kFALSE );
+      ~FlatForest();
+
+      UInt_t GetNTrees() const { return fTreeOffsets.size(); }
+      UInt_t GetNNodes() const { return fNodes.size(); }
+      UInt_t GetNVars()  const { return fNVars; }
+      Bool_t IsQuantized() const { return fQuantized; }
+      ENodeOrdering GetNodeOrdering() const { return fOrdering; }
+
+      // value of tree 'itree' (not multiplied by its weight) for the event with
+      // the variable values 'values'
+      Double_t GetTreeValue( UInt_t itree, const Float_t* values ) const;
+
+      // add the weighted values of the trees firstTree, firstTree+treeStep, ...
+      // up to lastTree (excluded, all trees if zero) to 'sums' for 'nEvents'
+      // events. The values of event i are values[i*nVars ... (i+1)*nVars-1].
+      // The trees are added in their order for each event
+      void AddTreeValues( const Float_t* values, UInt_t nEvents, Double_t* sums,
+                          UInt_t firstTree = 0, UInt_t lastTree = 0, UInt_t treeStep = 1 ) const;
+
+      // sum of the tree weights of the trees selected as in AddTreeValues
+      Double_t GetSumOfWeights( UInt_t firstTree = 0, UInt_t lastTree = 0, UInt_t treeStep = 1 ) const;
+
+   private:
+
+      // node of the flat tree
+      struct Node {
+         Int_t   fSelector;  // variable of the cut, kLeaf for leaves or kFisher for Fisher cuts
+         UInt_t  fLeft;      // position of the daughter for failed cuts, relative to the root
+         UInt_t  fRight;     // position of the daughter for passed cuts, relative to the root
+         UInt_t  fAux;       // position of the cut among the cuts on the variable, or of the Fisher coefficients
+         Float_t fCut;       // cut value, or value of the leaf
+      };
+
+      enum { kLeaf = -1, kFisher = -2 };
+
+      void     AddTree( const DecisionTree* tree, Bool_t useYesNoLeaf );
+      UInt_t   AddNode( const DecisionTreeNode* node, UInt_t root, Bool_t isRegression, Bool_t useYesNoLeaf );
+      void     Quantize();
+      void     QuantizeEvent( const Float_t* values, UInt_t* positions ) const;
+      Float_t  GetLeaf( const Node* root, const Float_t* values, const UInt_t* positions ) const;
+      UInt_t   GetLastTree( UInt_t lastTree ) const;
+
+      MsgLogger& Log() const;
+
+      UInt_t                             fNVars;        // number of variables of the events
+      ENodeOrdering                      fOrdering;     // order of the nodes in each tree
+      Bool_t                             fQuantized;    // compare positions among the cuts instead of the values
+      std::vector<Node>                  fNodes;        // nodes of all trees
+      std::vector<UInt_t>                fTreeOffsets;  // position of the root node of each tree
+      std::vector<Double_t>              fWeights;      // weight of each tree
+      std::vector<Double_t>              fFisherCoeff;  // coefficients of the Fisher cuts, the offset last
+      std::vector< std::vector<Float_t> > fCuts;        // sorted distinct cut values of each variable
+   };
+
+} // namespace TMVA
+
+#endif
@@ -45,6 +45,8 @@
 #include<TMVA/Envelope.h>
 #endif
 
+class TList;
+
 namespace TMVA {
 
    class HyperParameterOptimisationResult
@@ -107,6 +109,10 @@ namespace TMVA {
        
        void SetNumFolds(UInt_t folds);
        UInt_t GetNumFolds(){return fNumFolds;}
+
+       // optimise the folds in up to n forked worker processes (serially for n < 2)
+       void SetNWorkers(UInt_t n){fNWorkers=n;}
+       UInt_t GetNWorkers() const {return fNWorkers;}
        
        virtual void Evaluate();
        const HyperParameterOptimisationResult& GetResults() const {return fResults;}
@@ -119,6 +125,9 @@ namespace TMVA {
        Bool_t                            fFoldStatus;  //!
        HyperParameterOptimisationResult  fResults;     //!
        std::unique_ptr<Factory>          fClassifier;  //!
+       UInt_t                            fNWorkers;    //! number of worker processes for the folds
+
+       TList* OptimiseFold(UInt_t fold, const TString &methodName, const TString &methodTitle, const TString &methodOptions);
 
    public:
        ClassDef(HyperParameterOptimisation,0);  
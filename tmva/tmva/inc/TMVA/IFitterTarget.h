@@ -53,6 +53,19 @@ namespace TMVA {
 
       virtual Double_t EstimatorFunction( std::vector<Double_t>& parameters ) = 0;
 
+      // evaluate the estimator for each set of parameters (e.g. each individual
+      // of a population of the GeneticAlgorithm) and store the results in the
+      // same order; the default calls EstimatorFunction for each set, in
+      // parallel with the implicit multi-threading if IsThreadSafe() is true
+      virtual void     EstimatorFunctions( const std::vector<std::vector<Double_t>*>& parameters,
+                                           std::vector<Double_t>& estimators );
+
+      // thread-safety contract: return true only if EstimatorFunction can be
+      // called concurrently from several threads, each with its own vector of
+      // parameters, with the same results as in sequence (it must not modify
+      // any shared state); false by default
+      virtual Bool_t   IsThreadSafe() const { return kFALSE; }
+
       // function to notify the FitterTarget of the progress status of the fitter
       // sender : "GA", "MC", ...
       // progress : "init", "iteration", "last", "stop"
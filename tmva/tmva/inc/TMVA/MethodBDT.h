@@ -52,6 +52,9 @@
 #ifndef ROOT_TMVA_DecisionTree
 #include "TMVA/DecisionTree.h"
 #endif
+#ifndef ROOT_TMVA_FlatForest
+#include "TMVA/FlatForest.h"
+#endif
 #ifndef ROOT_TMVA_Event
 #include "TMVA/Event.h"
 #endif
@@ -63,6 +66,9 @@ namespace TMVA {
 
    class MethodBDT : public MethodBase {
 
+      // copies the trees and the preselection cuts for the evaluation
+      friend class CompiledBDT;
+
    public:
       // constructor for training and reading
       MethodBDT( const TString& jobName,
@@ -108,6 +114,17 @@ namespace TMVA {
       // calculate the MVA value
       Double_t GetMvaValue( Double_t* err = 0, Double_t* errUpper = 0);
 
+      // calculate the MVA values of nEvents events, whose nVar input variables
+      // are given one event after the other in 'inputs', using the flat forest
+      using MethodBase::GetMvaValues;
+      void GetMvaValues( const Float_t* inputs, UInt_t nEvents, Double_t* mvaValues );
+
+      // compile the forest into a flat array of nodes, which is used by the
+      // MVA evaluation from then on
+      void CompileForest( FlatForest::ENodeOrdering ordering = FlatForest::kDepthFirst,
+                          Bool_t quantizeCuts = kFALSE );
+      const FlatForest* GetFlatForest() const { return fFlatForest; }
+
       // get the actual forest size (might be less than fNTrees, the requested one, if boosting is stopped early
       UInt_t   GetNTrees() const {return fForest.size();}
    private:
@@ -200,6 +217,8 @@ namespace TMVA {
       void UpdateTargets( std::vector<const TMVA::Event*>&, UInt_t cls = 0);
       void UpdateTargetsRegression( std::vector<const TMVA::Event*>&,Bool_t first=kFALSE);
       Double_t GetGradBoostMVA(const TMVA::Event *e, UInt_t nTrees);
+      void     DeleteFlatForest();
+      Double_t CombineTreeValues(Double_t sum, Double_t norm) const;
       void     GetBaggedSubSample(std::vector<const TMVA::Event*>&);
 
       std::vector<const TMVA::Event*>       fEventSample;     // the training events
@@ -210,6 +229,8 @@ namespace TMVA {
       Int_t                           fNTrees;          // number of decision trees requested
       std::vector<DecisionTree*>      fForest;          // the collection of decision trees
       std::vector<double>             fBoostWeights;    // the weights applied in the individual boosts
+      FlatForest*                     fFlatForest;      //! flat copy of the forest for the evaluation, if compiled
+      std::vector<Float_t>            fFlatValues;      //! input values of the evaluated event for the flat forest
       Double_t                        fSigToBkgFraction;// Signal to Background fraction assumed during training
       TString                         fBoostType;       // string specifying the boost type
       Double_t                        fAdaBoostBeta;    // beta parameter for AdaBoost algorithm
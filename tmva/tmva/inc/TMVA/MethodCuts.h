@@ -126,6 +126,7 @@ namespace TMVA {
       
       Double_t EstimatorFunction( std::vector<Double_t> & );
       Double_t EstimatorFunction( Int_t ievt1, Int_t ievt2 );
+      void     EstimatorFunctions( const std::vector<std::vector<Double_t>*>&, std::vector<Double_t>& );
 
       void     SetTestSignalEfficiency( Double_t effS ) { fTestSignalEff = effS; }
 
@@ -246,6 +247,9 @@ namespace TMVA {
       void     GetEffsfromPDFs( Double_t* cutMin, Double_t* cutMax,
                                 Double_t& effS, Double_t& effB );
 
+      // estimator for the efficiencies of the cuts in fTmpCutMin and fTmpCutMax
+      Double_t ComputeEstimatorFromEffs( Double_t effS, Double_t effB );
+
       // default initialisation method called by all constructors
       void     Init( void );
 
@@ -116,6 +116,7 @@ private:
    TString                        fTrainingStrategyString;
    TString                        fWeightInitializationString;
    TString                        fArchitectureString;
+   TString                        fPrecisionString;
    LayoutVector_t                 fLayout;
    std::vector<TTrainingSettings> fTrainingSettings;
    bool                           fResume;
@@ -152,8 +153,10 @@ public:
                                       TString blockDelim,
                                       TString tokenDelim);
    void Train();
-   void TrainGpu();
-   void TrainCpu();
+   /** Train on the GPU and CPU architectures using scalar type AReal. The
+    *  trained weights are copied back to the double precision master net. */
+   template <typename AReal> void TrainGpu();
+   template <typename AReal> void TrainCpu();
 
    virtual Double_t GetMvaValue( Double_t* err=0, Double_t* errUpper=0 );
    virtual const std::vector<Float_t>& GetRegressionValues();
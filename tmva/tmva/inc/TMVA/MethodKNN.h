@@ -76,6 +76,7 @@ namespace TMVA
       void Train( void );
 
       Double_t GetMvaValue( Double_t* err = 0, Double_t* errUpper = 0 );
+      std::vector<Double_t> GetMvaValues(Long64_t firstEvt = 0, Long64_t lastEvt = -1, Bool_t logProgress = false);
       const std::vector<Float_t>& GetRegressionValues();
 
       using MethodBase::ReadWeightsFromStream;
@@ -114,10 +115,16 @@ namespace TMVA
       Double_t PolnKernel(Double_t value) const;
       Double_t GausKernel(const kNN::Event &event_knn, const kNN::Event &event, const std::vector<Double_t> &svec) const;
 
-      Double_t getKernelRadius(const kNN::List &rlist) const;
-      const std::vector<Double_t> getRMS(const kNN::List &rlist, const kNN::Event &event_knn) const;
+      Double_t getKernelRadius(const kNN::ElemVec &rlist) const;
+      const std::vector<Double_t> getRMS(const kNN::ElemVec &rlist, const kNN::Event &event_knn) const;
       
-      double getLDAValue(const kNN::List &rlist, const kNN::Event &event_knn);
+      double getLDAValue(const kNN::ElemVec &rlist, const kNN::Event &event_knn);
+
+      // classifier response for the query event and its nearest neighbors
+      Double_t ComputeMvaValue(const kNN::Event &event_knn, const kNN::ElemVec &rlist);
+
+      // query event for the current event of the data set
+      const kNN::Event GetkNNEvent() const;
 
    private:
 
@@ -142,6 +149,8 @@ namespace TMVA
 
       kNN::EventVec fEvent;   //! (untouched) events used for learning
 
+      kNN::ElemVec fkNNResult; //! nearest neighbors of the last query event
+
       LDA fLDA;               //! Experimental feature for local knn analysis
 
       // for backward compatibility
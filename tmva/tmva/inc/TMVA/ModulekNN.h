@@ -105,6 +105,7 @@ namespace TMVA {
       typedef std::vector<TMVA::kNN::Event> EventVec;
       typedef std::pair<const Node<Event> *, VarType> Elem;
       typedef std::list<Elem> List;
+      typedef std::vector<Elem> ElemVec;
 
       std::ostream& operator<<(std::ostream& os, const Event& event);
 
@@ -127,6 +128,15 @@ namespace TMVA {
 
          Bool_t Find(Event event, UInt_t nfind = 100, const std::string &option = "count") const;
          Bool_t Find(UInt_t nfind, const std::string &option) const;
+
+         // search for the nfind nearest neighbors of 'event' counting events, as
+         // Find(event, nfind), but return them sorted by distance in 'result'
+         // without changing the module, so that it can be called concurrently
+         Bool_t Find(const Event &event, UInt_t nfind, ElemVec &result) const;
+
+         // search for the nfind nearest neighbors of all 'events', in parallel
+         // if implicit multi-threading is enabled
+         Bool_t Find(const EventVec &events, UInt_t nfind, std::vector<ElemVec> &results) const;
       
          const EventVec& GetEventVec() const;
 
@@ -144,6 +154,24 @@ namespace TMVA {
 
          Node<Event>* Optimize(UInt_t optimize_depth);
 
+         // node of the flattened copy of the kd-tree
+         struct FlatNode {
+            Float_t fVarDis;            // value of the splitting variable
+            Float_t fVarMin;            // minimum of the splitting variable below the node
+            Float_t fVarMax;            // maximum of the splitting variable below the node
+            UInt_t  fMod;               // index of the splitting variable
+            Int_t   fNodeL;             // position of the left daughter, -1 if none
+            Int_t   fNodeR;             // position of the right daughter, -1 if none
+            Double_t fWeight;           // weight of the event of the node
+            const Node<Event> *fNode;   // node of the kd-tree
+         };
+
+         Int_t Flatten(const Node<Event> *node);
+
+         Bool_t CheckQuery(UInt_t nvar, UInt_t nfind) const;
+         void ScaleVars(const Event &event, VarType *vars) const;
+         void FindFlat(Int_t inode, const VarType *vars, UInt_t nfind, ElemVec &result) const;
+
          void ComputeMetric(UInt_t ifrac);
 
          const Event Scale(const Event &event) const;
@@ -158,6 +186,9 @@ namespace TMVA {
 
          Node<Event> *fTree;
 
+         std::vector<FlatNode> fFlatTree; // nodes of fTree in depth-first order
+         std::vector<VarType>  fFlatVars; // variables of the events of the nodes of fFlatTree
+
          std::map<Int_t, Double_t> fVarScale;
 
          mutable List  fkNNList;     // latest result from kNN search
@@ -44,24 +44,44 @@ namespace TMVA {
   class MsgLogger;
 
 
+  // The MVA values are accumulated into histograms of fixed resolution,
+  // one for signal and one for background, from which the ROC integral and
+  // the efficiencies are computed: the memory does not depend on the number
+  // of events, and the histograms of several ROCCurve objects of the same
+  // binning can be added, e.g. when filled in parallel.
+
   class ROCCurve {
     
   public:
-    ROCCurve( const std::vector<Float_t> & mvaS, const std::vector<Bool_t> & mvat);
+    enum { kDefaultNBins = 10000 }; // default resolution of the histograms of the MVA values
+
+    ROCCurve( const std::vector<Float_t> & mvaS, const std::vector<Bool_t> & mvat, UInt_t nbins=kDefaultNBins);
+    ROCCurve( Double_t xmin, Double_t xmax, UInt_t nbins=kDefaultNBins);
     
     ~ROCCurve();
     
+    void     Fill(Float_t mva, Bool_t isSignal, Double_t weight=1);
+    void     Add(const ROCCurve &other);
 
     Double_t GetROCIntegral();
+    Double_t GetROCIntegralError() const;
+    Double_t GetSignalEfficiency(Double_t effB) const;
     TGraph* GetROCCurve(const UInt_t points=100);//nvidisions = #points -1
     
   private:
-    void EpsilonCount();
+    ROCCurve(const ROCCurve &);            // Not implemented
+    ROCCurve &operator=(const ROCCurve &); // Not implemented
+
+    Int_t    FindBin(Float_t mva) const;
+    Double_t GetFractionBelow(const std::vector<Double_t> &hist, Double_t sum, Double_t cut) const;
     mutable MsgLogger* fLogger;   //! message logger
     MsgLogger& Log() const { return *fLogger; }                       
     TGraph *fGraph;
-    std::vector<Float_t> fMvaS;
-    std::vector<Float_t> fMvaB;
+    Double_t fXmin;                  // lower edge of the histograms
+    Double_t fXmax;                  // upper edge of the histograms
+    UInt_t   fNBins;                 // number of bins of the histograms
+    std::vector<Double_t> fHistS;    // [fNBins+2] signal weights per bin, underflow and overflow included
+    std::vector<Double_t> fHistB;    // [fNBins+2] background weights per bin, underflow and overflow included
     std::vector<Float_t> fEpsilonSig;
     std::vector<Float_t> fEpsilonBgk;
 
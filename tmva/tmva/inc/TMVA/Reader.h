@@ -61,6 +61,7 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 #include <stdexcept>
 
 namespace TMVA {
@@ -69,6 +70,7 @@ namespace TMVA {
    class MethodBase;
    class DataSetInfo;
    class MethodCuts;
+   class CompiledBDT;
 
    class Reader : public Configurable {
 
@@ -102,6 +104,15 @@ namespace TMVA {
       Double_t EvaluateMVA( MethodBase* method,           Double_t aux = 0 );
       Double_t EvaluateMVA( const TString& methodTag,     Double_t aux = 0 );
 
+      // returns the MVA responses of nEvents events, whose input variables are
+      // stored one event after the other in 'inputs'
+      void     EvaluateMVA( const Float_t* inputs, UInt_t nEvents, Double_t* mvaValues,
+                            const TString& methodTag, Double_t aux = 0 );
+
+      // returns an immutable copy of a booked classification BDT, which can be
+      // evaluated concurrently by many threads and outlives the reader
+      std::shared_ptr<const CompiledBDT> CompileBDT( const TString& methodTag, Bool_t quantizeCuts = kFALSE );
+
       // returns error on MVA response for given event
       // NOTE: must be called AFTER "EvaluateMVA(...)" call !
       Double_t GetMVAError() const { return fMvaEventError; }
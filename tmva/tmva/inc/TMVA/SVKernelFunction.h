@@ -48,12 +48,14 @@ namespace TMVA {
       SVKernelFunction(EKernelType k, std::vector<EKernelType> kernels, std::vector<Float_t> gammas, Float_t gamma, Float_t order, Float_t theta);
       ~SVKernelFunction();
       
-      Float_t Evaluate( SVEvent* ev1, SVEvent* ev2 );
+      Float_t Evaluate( SVEvent* ev1, SVEvent* ev2 ) const;
 
       void setCompatibilityParams(EKernelType k, UInt_t order, Float_t theta, Float_t kappa);
          
    private:
 
+      Float_t Evaluate( EKernelType kernel, SVEvent* ev1, SVEvent* ev2 ) const;
+
       Float_t fGamma;   // documentation
 
       // vector of gammas for multidimensional gaussian
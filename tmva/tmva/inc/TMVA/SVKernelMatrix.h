@@ -32,6 +32,7 @@
 #include "Rtypes.h"
 #endif
 
+#include <list>
 #include <vector>
 
 namespace TMVA {
@@ -46,25 +47,44 @@ namespace TMVA {
 
       //constructors
       SVKernelMatrix();
-      SVKernelMatrix( std::vector<TMVA::SVEvent*>*, SVKernelFunction* );
-      
+      // the rows of the kernel matrix are computed on demand and the most
+      // recently used ones are kept in a cache of at most 'cacheSize' MB
+      // (at least two rows), all rows if cacheSize is not positive
+      SVKernelMatrix( std::vector<TMVA::SVEvent*>*, SVKernelFunction*, Double_t cacheSize = 0 );
+
       //destructor
       ~SVKernelMatrix();
-      
+
       //functions
+      // row of the kernel matrix; the pointer is owned by the matrix and is
+      // valid until the row is evicted from the cache, which does not happen
+      // before two other rows have been requested
       Float_t* GetLine   ( UInt_t );
       Float_t* GetColumn ( UInt_t col ) { return this->GetLine(col);}
+      // element of the kernel matrix, taken from a cached row if possible;
+      // the cache is not changed
       Float_t  GetElement( UInt_t i, UInt_t j );
 
+      UInt_t   GetNCachedRows() const { return fSlots.size(); }
+
    private:
 
+      Float_t  Evaluate( UInt_t i, UInt_t j ) const;
+      void     ComputeLine( UInt_t line, Float_t* values ) const;
+
       UInt_t               fSize;              // matrix size
+      std::vector<TMVA::SVEvent*>* fInputVectors; // events of the rows and columns
       SVKernelFunction*    fKernelFunction;    // kernel function
-      Float_t**            fSVKernelMatrix;    // kernel matrix
-
+      std::vector<Float_t> fDiagonal;          // diagonal elements of the kernel matrix
+      std::vector<Float_t> fCache;             // cached rows, fSize values for each slot
+      std::vector<Int_t>   fSlots;             // row stored in each slot of the cache, -1 if none
+      std::vector<Int_t>   fRowSlots;          // slot of each row, -1 if not cached
+      std::list<UInt_t>    fLRU;               // slots in use, the most recently used first
+      std::vector<std::list<UInt_t>::iterator> fLRUPos; // position of each slot in use in fLRU
       mutable MsgLogger* fLogger;                     //! message logger
       MsgLogger& Log() const { return *fLogger; }
 
    };
 }
+
 #endif
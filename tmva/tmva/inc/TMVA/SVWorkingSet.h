@@ -46,7 +46,9 @@ namespace TMVA {
    public:
 
       SVWorkingSet();
-      SVWorkingSet( std::vector<TMVA::SVEvent*>*, SVKernelFunction*, Float_t , Bool_t);
+      // the kernel matrix caches at most kernelCacheSize MB of rows, all rows if
+      // kernelCacheSize is not positive
+      SVWorkingSet( std::vector<TMVA::SVEvent*>*, SVKernelFunction*, Float_t , Bool_t, Double_t kernelCacheSize = 0);
       ~SVWorkingSet();
                 
       Bool_t  ExamineExample( SVEvent*);
@@ -92,6 +94,7 @@ namespace TMVA {
       bool * fExitFromTraining = nullptr;
 
       void SetIndex( TMVA::SVEvent* );
+      void UpdateErrorCaches( TMVA::SVEvent* ievt, Float_t dI, TMVA::SVEvent* jevt, Float_t dJ );
    };
 }
 
@@ -61,6 +61,7 @@ namespace TMVA {
        UInt_t                    fNumFolds;
        VariableImportanceResult  fResults;
        VIType                    fType;
+       UInt_t                    fNWorkers;  //! number of worker processes for the trainings
    public:
        explicit VariableImportance(DataLoader *loader);
        ~VariableImportance();
@@ -69,6 +70,11 @@ namespace TMVA {
        
        void SetType(VIType type){fType=type;}
        VIType GetType(){return fType;}
+
+       // train the classifiers of the variable subsets in up to n forked worker
+       // processes (serially for n < 2)
+       void SetNWorkers(UInt_t n){fNWorkers=n;}
+       UInt_t GetNWorkers() const {return fNWorkers;}
        
        const VariableImportanceResult& GetResults() const {return fResults;}//I need to think about this, which is the best way to get the results?
    protected:
@@ -84,6 +90,11 @@ namespace TMVA {
 
        //method to compute the range(number total of operations for every bit configuration)
        ULong_t Sum(ULong_t i);
+
+       //train, test and evaluate the classifier for the variables in the bits of x and return its ROC integral
+       Float_t EvaluateSubset(UInt_t x, Bool_t prepare);
+       //ROC integrals for all the subsets, computed in fNWorkers processes if requested
+       std::vector<Float_t> EvaluateSubsets(const std::vector<UInt_t> &subsets, Bool_t prepare);
        
    private:
        std::unique_ptr<Factory>     fClassifier;
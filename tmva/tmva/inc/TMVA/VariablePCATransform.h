@@ -59,6 +59,7 @@ namespace TMVA {
 
       virtual const Event* Transform(const Event* const, Int_t cls ) const;
       virtual const Event* InverseTransform(const Event* const, Int_t cls ) const;
+      virtual void         TransformEvents( const std::vector<Event*>& events, Int_t cls ) const;
 
       void WriteTransformationToStream ( std::ostream& ) const;
       void ReadTransformationFromStream( std::istream&, const TString& );
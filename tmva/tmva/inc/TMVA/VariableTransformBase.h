@@ -80,6 +80,10 @@ namespace TMVA {
       virtual const Event* Transform       ( const Event* const, Int_t cls ) const = 0;
       virtual const Event* InverseTransform( const Event* const, Int_t cls ) const = 0;
 
+      // transform all 'events' in place, with the same result as replacing each
+      // event by its transformed copy
+      virtual void         TransformEvents( const std::vector<Event*>& events, Int_t cls ) const;
+
       // accessors
       void   SetEnabled  ( Bool_t e ) { fEnabled = e; }
       void   SetNormalise( Bool_t n ) { fNormalise = n; }
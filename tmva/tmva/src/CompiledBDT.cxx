@@ -0,0 +1,176 @@
+// @(#)root/tmva $Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/*! \class TMVA::CompiledBDT
+\ingroup TMVA
+
+Immutable, thread-safe evaluator of a trained classification BDT.
+
+The trees, the boost weights and the preselection cuts of a MethodBDT
+are copied at construction time, the trees into a TMVA::FlatForest.
+Evaluate is const and keeps its intermediate results on the stack, so
+one instance can be evaluated concurrently from many threads without
+locking, and without the one-Reader-per-thread pattern that the
+address-bound TMVA::Reader interface requires. The values of an event
+are passed directly in the order of GetVariableExpression.
+
+The MVA values are identical to those of MethodBDT::GetMvaValue. Events
+with a NaN variable get the value -999, as in TMVA::Reader::EvaluateMVA,
+but no message is printed.
+
+Typical use, with the model loaded once from the weight file:
+
+~~~ {.cpp}
+TMVA::Reader reader;
+reader.AddVariable("x", &x);
+...
+reader.BookMVA("BDT", "weights/TMVAClassification_BDT.weights.xml");
+std::shared_ptr<const TMVA::CompiledBDT> bdt = reader.CompileBDT("BDT");
+
+// in any thread
+bdt->Evaluate(values, nEvents, mvaValues);
+~~~
+*/
+
+#include "TMVA/CompiledBDT.h"
+
+#include "TMVA/DataSetInfo.h"
+#include "TMVA/MethodBDT.h"
+#include "TMVA/MsgLogger.h"
+#include "TMVA/TransformationHandler.h"
+#include "TMVA/VariableInfo.h"
+
+#include "TMath.h"
+
+#include <limits>
+
+////////////////////////////////////////////////////////////////////////////////
+/// constructor; the forest of 'bdt' is compiled with the given node
+/// ordering and quantization of the cuts, see TMVA::FlatForest
+
+TMVA::CompiledBDT::CompiledBDT( const MethodBDT& bdt, FlatForest::ENodeOrdering ordering,
+                                Bool_t quantizeCuts )
+   : fForest( bdt.fForest, bdt.GetNvar(),
+              bdt.fBoostType=="Grad" ? std::vector<Double_t>() : bdt.fBoostWeights,
+              bdt.fBoostType=="Grad" ? kFALSE : bdt.fUseYesNoLeaf, ordering, quantizeCuts ),
+     fGradBoost( bdt.fBoostType=="Grad" ),
+     fSumOfWeights( 0 ),
+     fDoPreselection( bdt.fDoPreselection ),
+     fLowSigCut( bdt.fLowSigCut ),
+     fLowBkgCut( bdt.fLowBkgCut ),
+     fHighSigCut( bdt.fHighSigCut ),
+     fHighBkgCut( bdt.fHighBkgCut ),
+     fIsLowSigCut( bdt.fIsLowSigCut ),
+     fIsLowBkgCut( bdt.fIsLowBkgCut ),
+     fIsHighSigCut( bdt.fIsHighSigCut ),
+     fIsHighBkgCut( bdt.fIsHighBkgCut )
+{
+   if (bdt.DoRegression() || bdt.DoMulticlass()) {
+      Log() << kFATAL << "<CompiledBDT> only classification BDTs can be compiled, not \""
+            << bdt.GetMethodName() << "\"" << Endl;
+   }
+   if (bdt.GetTransformationHandler().GetNumOfTransformations() > 0) {
+      Log() << kFATAL << "<CompiledBDT> the BDT \"" << bdt.GetMethodName()
+            << "\" uses variable transformations, which cannot be compiled" << Endl;
+   }
+   if (fForest.GetNTrees() == 0) {
+      Log() << kFATAL << "<CompiledBDT> the BDT \"" << bdt.GetMethodName() << "\" has no trees" << Endl;
+   }
+   if (fDoPreselection && fLowSigCut.size() < bdt.GetNvar()) {
+      Log() << kFATAL << "<CompiledBDT> incomplete preselection cuts" << Endl;
+   }
+
+   fSumOfWeights = fForest.GetSumOfWeights();
+   for (UInt_t ivar=0; ivar<bdt.GetNvar(); ivar++) {
+      fExpressions.push_back( bdt.DataInfo().GetVariableInfo(ivar).GetExpression() );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// destructor
+
+TMVA::CompiledBDT::~CompiledBDT()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// MVA value of one event
+
+Double_t TMVA::CompiledBDT::Evaluate( const Float_t* vars ) const
+{
+   Double_t mvaValue;
+   Evaluate( vars, 1, &mvaValue );
+   return mvaValue;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// MVA values of 'nEvents' events; the trees are applied to blocks of events
+/// by FlatForest::AddTreeValues
+
+void TMVA::CompiledBDT::Evaluate( const Float_t* vars, UInt_t nEvents, Double_t* mvaValues ) const
+{
+   UInt_t nVars = GetNVariables();
+   for (UInt_t iev=0; iev<nEvents; iev++) mvaValues[iev] = 0;
+   fForest.AddTreeValues( vars, nEvents, mvaValues );
+
+   for (UInt_t iev=0; iev<nEvents; iev++) {
+      const Float_t* values = vars + iev*nVars;
+      Bool_t isNaN = kFALSE;
+      for (UInt_t ivar=0; ivar<nVars && !isNaN; ivar++) isNaN = TMath::IsNaN(values[ivar]);
+      if (isNaN) {
+         mvaValues[iev] = -999;
+         continue;
+      }
+      if (fDoPreselection) {
+         Double_t val = ApplyPreselectionCuts( values );
+         if (TMath::Abs(val)>0.05) {
+            mvaValues[iev] = val;
+            continue;
+         }
+      }
+      mvaValues[iev] = CombineTreeValues( mvaValues[iev] );
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// apply the preselection cuts as MethodBDT::ApplyPreselectionCuts
+
+Double_t TMVA::CompiledBDT::ApplyPreselectionCuts( const Float_t* values ) const
+{
+   Double_t result=0;
+
+   for (UInt_t ivar=0; ivar < GetNVariables(); ivar++ ) {
+      if (fIsLowBkgCut[ivar]  && values[ivar] < fLowBkgCut[ivar])  result = -1;  // is background
+      if (fIsLowSigCut[ivar]  && values[ivar] < fLowSigCut[ivar])  result =  1;  // is signal
+      if (fIsHighBkgCut[ivar] && values[ivar] > fHighBkgCut[ivar]) result = -1;  // is background
+      if (fIsHighSigCut[ivar] && values[ivar] > fHighSigCut[ivar]) result =  1;  // is signal
+   }
+
+   return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// MVA value for the sum of the weighted tree values, as in
+/// MethodBDT::PrivateGetMvaValue
+
+Double_t TMVA::CompiledBDT::CombineTreeValues( Double_t sum ) const
+{
+   if (fGradBoost) return 2.0/(1.0+exp(-2.0*sum))-1; //MVA output between -1 and 1
+   return ( fSumOfWeights > std::numeric_limits<double>::epsilon() ) ? sum / fSumOfWeights : 0 ;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// message logger
+
+TMVA::MsgLogger& TMVA::CompiledBDT::Log() const
+{
+   TTHREAD_TLS_DECL_ARG(MsgLogger,logger,"CompiledBDT");
+   return logger;
+}
@@ -16,11 +16,25 @@
 #include "TAxis.h"
 #include "TCanvas.h"
 #include "TGraph.h"
+#include "TList.h"
 #include "TMath.h"
+#include "TParameter.h"
+#include "ROOT/TProcessExecutor.hxx"
+#include "ROOT/TSeq.hxx"
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 
+namespace {
+   // value stored by EvaluateFold under the given name
+   Double_t GetFoldValue(TList *fold, const char *name)
+   {
+      TParameter<Double_t> *par = dynamic_cast<TParameter<Double_t>*>(fold->FindObject(name));
+      return par ? par->GetVal() : 0;
+   }
+}
+
 TMVA::CrossValidationResult::CrossValidationResult():fROCCurves(new TMultiGraph())
 {
 }
@@ -83,7 +97,7 @@ TCanvas* TMVA::CrossValidationResult::Draw(const TString name) const
 }
 
 TMVA::CrossValidation::CrossValidation(TMVA::DataLoader *dataloader):TMVA::Envelope("CrossValidation",dataloader),
-fNumFolds(5),fClassifier(new TMVA::Factory("CrossValidation","!V:!ROC:Silent:!ModelPersistence:!Color:!DrawProgressBar:AnalysisType=Classification"))
+fNumFolds(5),fNWorkers(0),fClassifier(new TMVA::Factory("CrossValidation","!V:!ROC:Silent:!ModelPersistence:!Color:!DrawProgressBar:AnalysisType=Classification"))
 {
    fFoldStatus=kFALSE;
 }
@@ -118,52 +132,46 @@ void TMVA::CrossValidation::Evaluate()
        fFoldStatus=kTRUE;
    }
 
-   // Process K folds
-   for(UInt_t i=0; i<fNumFolds; ++i){
-      Log() << kDEBUG << "Fold (" << methodTitle << "): " << i << Endl;
-      // Get specific fold of dataset and setup method
-      TString foldTitle = methodTitle;
-      foldTitle += "_fold";
-      foldTitle += i+1;
-
-      fDataLoader->PrepareFoldDataSet(i, TMVA::Types::kTesting);
-      MethodBase* smethod = fClassifier->BookMethod(fDataLoader.get(), methodName, methodTitle, methodOptions);
-
-      // Train method
-      Event::SetIsTraining(kTRUE);
-      smethod->TrainMethod();
-
-      // Test method
-      Event::SetIsTraining(kFALSE);
-      smethod->AddOutput(Types::kTesting, smethod->GetAnalysisType());
-      smethod->TestClassification();
-
-      // Store results
-      fResults.fROCs[i] = fClassifier->GetROCIntegral(fDataLoader->GetName(),methodTitle);
-
-      TGraph* gr = fClassifier->GetROCCurve(fDataLoader->GetName(), methodTitle, true);
-      gr->SetLineColor(i+1);
-      gr->SetLineWidth(2);
-      gr->SetTitle(foldTitle.Data());
-      fResults.fROCCurves->Add(gr);
-
-      fResults.fSigs.push_back(smethod->GetSignificance());
-      fResults.fSeps.push_back(smethod->GetSeparation());
-
-      Double_t err;
-      fResults.fEff01s.push_back(smethod->GetEfficiency("Efficiency:0.01",Types::kTesting, err));
-      fResults.fEff10s.push_back(smethod->GetEfficiency("Efficiency:0.10",Types::kTesting,err));
-      fResults.fEff30s.push_back(smethod->GetEfficiency("Efficiency:0.30",Types::kTesting,err));
-      fResults.fEffAreas.push_back(smethod->GetEfficiency(""             ,Types::kTesting,err));
-      fResults.fTrainEff01s.push_back(smethod->GetTrainingEfficiency("Efficiency:0.01"));
-      fResults.fTrainEff10s.push_back(smethod->GetTrainingEfficiency("Efficiency:0.10"));
-      fResults.fTrainEff30s.push_back(smethod->GetTrainingEfficiency("Efficiency:0.30"));
-
-      // Clean-up for this fold
-      smethod->Data()->DeleteResults(smethod->GetMethodName(), Types::kTesting, Types::kClassification);
-      smethod->Data()->DeleteResults(smethod->GetMethodName(), Types::kTraining, Types::kClassification);
-      fClassifier->DeleteAllMethods();
-      fClassifier->fMethodsMap.clear();
+   // Process K folds, in worker processes if requested. Each worker prepares
+   // its fold on its own copy of the data set.
+   std::vector<TList*> folds;
+   if(fNWorkers > 1 && fNumFolds > 1){
+      UInt_t nWorkers = std::min(fNWorkers, fNumFolds);
+      TMVA::gConfig().SetSilent(kFALSE);
+      Log() << kINFO << "Processing " << fNumFolds << " folds in " << nWorkers << " worker processes" << Endl;
+      TMVA::gConfig().SetSilent(kTRUE);
+
+      auto work = [&](UInt_t i) { return EvaluateFold(i, methodName, methodTitle, methodOptions); };
+      ROOT::TProcessExecutor workers(nWorkers);
+      folds = workers.Map(work, ROOT::TSeqU(fNumFolds));
+   }else{
+      for(UInt_t i=0; i<fNumFolds; ++i) folds.push_back(EvaluateFold(i, methodName, methodTitle, methodOptions));
+   }
+
+   // Collect the results in the order of the folds
+   for(UInt_t i=0; i<folds.size(); ++i){
+      TList *fold = folds[i];
+      if(!fold) Log() << kFATAL << "No results received for fold " << i << Endl;
+
+      fResults.fROCs[i] = GetFoldValue(fold, "ROCIntegral");
+
+      TGraph *gr = dynamic_cast<TGraph*>(fold->FindObject("ROCCurve"));
+      if(gr){
+         fold->Remove(gr);
+         fResults.fROCCurves->Add(gr);
+      }
+
+      fResults.fSigs.push_back(GetFoldValue(fold, "Significance"));
+      fResults.fSeps.push_back(GetFoldValue(fold, "Separation"));
+      fResults.fEff01s.push_back(GetFoldValue(fold, "Eff01"));
+      fResults.fEff10s.push_back(GetFoldValue(fold, "Eff10"));
+      fResults.fEff30s.push_back(GetFoldValue(fold, "Eff30"));
+      fResults.fEffAreas.push_back(GetFoldValue(fold, "EffArea"));
+      fResults.fTrainEff01s.push_back(GetFoldValue(fold, "TrainEff01"));
+      fResults.fTrainEff10s.push_back(GetFoldValue(fold, "TrainEff10"));
+      fResults.fTrainEff30s.push_back(GetFoldValue(fold, "TrainEff30"));
+
+      delete fold;
    }
 
    TMVA::gConfig().SetSilent(kFALSE);
@@ -171,6 +179,62 @@ void TMVA::CrossValidation::Evaluate()
    TMVA::gConfig().SetSilent(kTRUE);
 }
 
+TList* TMVA::CrossValidation::EvaluateFold(UInt_t i, const TString &methodName, const TString &methodTitle, const TString &methodOptions)
+{
+   // Train and test the method on fold i. The results are returned in a list,
+   // which can be sent from a worker process: the ROC curve, named "ROCCurve",
+   // and one TParameter<Double_t> per figure of merit.
+   Log() << kDEBUG << "Fold (" << methodTitle << "): " << i << Endl;
+   // Get specific fold of dataset and setup method
+   TString foldTitle = methodTitle;
+   foldTitle += "_fold";
+   foldTitle += i+1;
+
+   fDataLoader->PrepareFoldDataSet(i, TMVA::Types::kTesting);
+   MethodBase* smethod = fClassifier->BookMethod(fDataLoader.get(), methodName, methodTitle, methodOptions);
+
+   // Train method
+   Event::SetIsTraining(kTRUE);
+   smethod->TrainMethod();
+
+   // Test method
+   Event::SetIsTraining(kFALSE);
+   smethod->AddOutput(Types::kTesting, smethod->GetAnalysisType());
+   smethod->TestClassification();
+
+   // Store results
+   TList *fold = new TList();
+   fold->SetOwner();
+   fold->Add(new TParameter<Double_t>("ROCIntegral", fClassifier->GetROCIntegral(fDataLoader->GetName(),methodTitle)));
+
+   TGraph* gr = fClassifier->GetROCCurve(fDataLoader->GetName(), methodTitle, true);
+   gr->SetName("ROCCurve");
+   gr->SetLineColor(i+1);
+   gr->SetLineWidth(2);
+   gr->SetTitle(foldTitle.Data());
+   fold->Add(gr);
+
+   fold->Add(new TParameter<Double_t>("Significance", smethod->GetSignificance()));
+   fold->Add(new TParameter<Double_t>("Separation", smethod->GetSeparation()));
+
+   Double_t err;
+   fold->Add(new TParameter<Double_t>("Eff01", smethod->GetEfficiency("Efficiency:0.01",Types::kTesting, err)));
+   fold->Add(new TParameter<Double_t>("Eff10", smethod->GetEfficiency("Efficiency:0.10",Types::kTesting,err)));
+   fold->Add(new TParameter<Double_t>("Eff30", smethod->GetEfficiency("Efficiency:0.30",Types::kTesting,err)));
+   fold->Add(new TParameter<Double_t>("EffArea", smethod->GetEfficiency(""             ,Types::kTesting,err)));
+   fold->Add(new TParameter<Double_t>("TrainEff01", smethod->GetTrainingEfficiency("Efficiency:0.01")));
+   fold->Add(new TParameter<Double_t>("TrainEff10", smethod->GetTrainingEfficiency("Efficiency:0.10")));
+   fold->Add(new TParameter<Double_t>("TrainEff30", smethod->GetTrainingEfficiency("Efficiency:0.30")));
+
+   // Clean-up for this fold
+   smethod->Data()->DeleteResults(smethod->GetMethodName(), Types::kTesting, Types::kClassification);
+   smethod->Data()->DeleteResults(smethod->GetMethodName(), Types::kTraining, Types::kClassification);
+   fClassifier->DeleteAllMethods();
+   fClassifier->fMethodsMap.clear();
+
+   return fold;
+}
+
 const TMVA::CrossValidationResult& TMVA::CrossValidation::GetResults() const {
    if(fResults.fROCs.size()==0) Log() << kFATAL << "No cross-validation results available" << Endl;
    return fResults;
@@ -79,13 +79,14 @@ void TCpu<Real_t>::Hadamard(TCpuMatrix<Real_t> &B,
    const Real_t *dataA      = A.GetRawDataPointer();
          Real_t *dataB      = B.GetRawDataPointer();
 
-   auto f = [&dataA, &dataB](UInt_t workerID)
+   auto f = [dataA, dataB](size_t begin, size_t end)
    {
-      dataB[workerID] *= dataA[workerID];
-      return 0;
+      for (size_t i = begin; i < end; i++) {
+         dataB[i] *= dataA[i];
+      }
    };
 
-   B.GetThreadExecutor().Map(f, ROOT::TSeqI(B.GetNElements()));
+   TCpuMatrix<Real_t>::ForEachRange(f, B.GetNElements());
 }
 
 //____________________________________________________________________________
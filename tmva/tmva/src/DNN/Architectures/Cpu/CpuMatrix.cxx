@@ -22,6 +22,8 @@ template<typename AReal>
 ROOT::TThreadExecutor TCpuMatrix<AReal>::fPool{};
 template<typename AReal>
 std::vector<AReal> TCpuMatrix<AReal>::fOnes{};
+template<typename AReal>
+constexpr size_t TCpuMatrix<AReal>::fgElementsPerTask;
 
 //____________________________________________________________________________
 template<typename AReal>
@@ -26,15 +26,18 @@ void TCpu<AFloat>::Dropout(TCpuMatrix<AFloat> &A,
 {
    AFloat *data = A.GetRawDataPointer();
 
-   auto f = [&data, dropoutProbability](UInt_t workerID)
+   // One generator per range, seeded with the index of the first element of
+   // the range.
+   auto f = [data, dropoutProbability](size_t begin, size_t end)
    {
-      TRandom rand(time(nullptr) + workerID);
-      AFloat r = rand.Uniform();
-      data[workerID] = (r > dropoutProbability) ? 0.0 : data[workerID] / dropoutProbability;
-      return 0;
+      TRandom rand(time(nullptr) + begin);
+      for (size_t i = begin; i < end; i++) {
+         AFloat r = rand.Uniform();
+         data[i] = (r > dropoutProbability) ? 0.0 : data[i] / dropoutProbability;
+      }
    };
 
-   A.GetThreadExecutor().Map(f, ROOT::TSeqI(A.GetNElements()));
+   TCpuMatrix<AFloat>::ForEachRange(f, A.GetNElements());
 }
 
 } // namespace DNN
@@ -28,23 +28,19 @@ AFloat TCpu<AFloat>::MeanSquaredError(const TCpuMatrix<AFloat> &Y,
 {
    const AFloat  *dataY      = Y.GetRawDataPointer();
    const AFloat  *dataOutput = output.GetRawDataPointer();
-   std::vector<AFloat> temp(Y.GetNElements());
    AFloat norm = 1.0 / ((AFloat) Y.GetNrows() * Y.GetNcols());
 
-   auto f = [&dataY, &dataOutput, &temp](UInt_t workerID)
+   auto f = [dataY, dataOutput](size_t begin, size_t end)
    {
-      AFloat dy = dataY[workerID] - dataOutput[workerID];
-      temp[workerID] = dy * dy;
-      return 0;
-   };
-
-   auto reduction = [](AFloat sum1, AFloat sum2)
-   {
-      return sum1 + sum2;
+      AFloat sum = 0.0;
+      for (size_t i = begin; i < end; i++) {
+         AFloat dy = dataY[i] - dataOutput[i];
+         sum += dy * dy;
+      }
+      return sum;
    };
 
-   Y.GetThreadExecutor().Map(f, ROOT::TSeqI(Y.GetNElements()));
-   return norm * Y.GetThreadExecutor().Reduce(temp, reduction);
+   return norm * TCpuMatrix<AFloat>::SumRanges(f, Y.GetNElements());
 }
 
 //______________________________________________________________________________
@@ -60,13 +56,14 @@ void TCpu<AFloat>::MeanSquaredErrorGradients(
    const AFloat  *dataOutput = output.GetRawDataPointer();
    AFloat norm = 1.0 / ((AFloat) Y.GetNrows() * Y.GetNcols());
 
-   auto f = [&dataDY, &dataY, &dataOutput, norm](UInt_t workerID)
+   auto f = [dataDY, dataY, dataOutput, norm](size_t begin, size_t end)
    {
-      dataDY[workerID] = - 2.0 * norm * (dataY[workerID] - dataOutput[workerID]);
-      return 0;
+      for (size_t i = begin; i < end; i++) {
+         dataDY[i] = - 2.0 * norm * (dataY[i] - dataOutput[i]);
+      }
    };
 
-   Y.GetThreadExecutor().Map(f, ROOT::TSeqI(Y.GetNElements()));
+   TCpuMatrix<AFloat>::ForEachRange(f, Y.GetNElements());
 }
 
 //______________________________________________________________________________
@@ -76,24 +73,20 @@ AFloat TCpu<AFloat>::CrossEntropy(const TCpuMatrix<AFloat> &Y,
 {
    const AFloat  *dataY      = Y.GetRawDataPointer();
    const AFloat  *dataOutput = output.GetRawDataPointer();
-   std::vector<AFloat> temp(Y.GetNElements());
    AFloat norm = 1.0 / ((AFloat) Y.GetNrows() * Y.GetNcols());
 
-   auto f = [&dataY, &dataOutput, &temp](UInt_t workerID)
+   auto f = [dataY, dataOutput](size_t begin, size_t end)
    {
-      AFloat y   = dataY[workerID];
-      AFloat sig = 1.0 / (1.0 + exp(- dataOutput[workerID]));
-      temp[workerID] = - (y * log(sig) + (1.0 - y) * log(1.0 - sig));
-      return 0;
-   };
-
-   auto reduction = [](AFloat sum1, AFloat sum2)
-   {
-      return sum1 + sum2;
+      AFloat sum = 0.0;
+      for (size_t i = begin; i < end; i++) {
+         AFloat y   = dataY[i];
+         AFloat sig = 1.0 / (1.0 + exp(- dataOutput[i]));
+         sum -= y * log(sig) + (1.0 - y) * log(1.0 - sig);
+      }
+      return sum;
    };
 
-   Y.GetThreadExecutor().Map(f, ROOT::TSeqI(Y.GetNElements()));
-   return norm * Y.GetThreadExecutor().Reduce(temp, reduction);
+   return norm * TCpuMatrix<AFloat>::SumRanges(f, Y.GetNElements());
 }
 
 //______________________________________________________________________________
@@ -108,15 +101,16 @@ void TCpu<AFloat>::CrossEntropyGradients(
    const AFloat  *dataOutput = output.GetRawDataPointer();
    AFloat norm = 1.0 / ((AFloat) Y.GetNrows() * Y.GetNcols());
 
-   auto f = [&dataDY, &dataY, &dataOutput, norm](UInt_t workerID)
+   auto f = [dataDY, dataY, dataOutput, norm](size_t begin, size_t end)
    {
-      AFloat y   = dataY[workerID];
-      AFloat sig = 1.0 / (1.0 + exp(- dataOutput[workerID]));
-      dataDY[workerID] = norm * (sig - y);
-      return 0;
+      for (size_t i = begin; i < end; i++) {
+         AFloat y   = dataY[i];
+         AFloat sig = 1.0 / (1.0 + exp(- dataOutput[i]));
+         dataDY[i] = norm * (sig - y);
+      }
    };
 
-   Y.GetThreadExecutor().Map(f, ROOT::TSeqI(Y.GetNElements()));
+   TCpuMatrix<AFloat>::ForEachRange(f, Y.GetNElements());
 }
 
 //______________________________________________________________________________
@@ -127,31 +121,26 @@ AFloat TCpu<AFloat>::SoftmaxCrossEntropy(
 {
    const AFloat  *dataY      = Y.GetRawDataPointer();
    const AFloat  *dataOutput = output.GetRawDataPointer();
-   std::vector<AFloat> temp(Y.GetNrows());
    size_t m = Y.GetNrows();
    size_t n = Y.GetNcols();
    AFloat norm = 1.0 / ((AFloat) m);
 
-   auto f = [&dataY, &dataOutput, &temp, n, m](UInt_t workerID)
+   auto f = [dataY, dataOutput, n, m](size_t begin, size_t end)
    {
-      AFloat sum = 0.0;
-      for (size_t j = 0; j < n; j++) {
-         sum += exp(dataOutput[workerID + j * m]);
+      AFloat result = 0.0;
+      for (size_t row = begin; row < end; row++) {
+         AFloat sum = 0.0;
+         for (size_t j = 0; j < n; j++) {
+            sum += exp(dataOutput[row + j * m]);
+         }
+         for (size_t j = 0; j < n; j++) {
+            result -= dataY[row + j * m] * log(exp(dataOutput[row + j * m]) / sum);
+         }
       }
-      for (size_t j = 0; j < n; j++) {
-         temp[workerID] -=
-            dataY[workerID + j * m] * log(exp(dataOutput[workerID + j * m]) / sum);
-      }
-      return 0;
+      return result;
    };
 
-   auto reduction = [](AFloat sum1, AFloat sum2)
-   {
-      return sum1 + sum2;
-   };
-
-   Y.GetThreadExecutor().Map(f, ROOT::TSeqI(Y.GetNrows()));
-   return norm * Y.GetThreadExecutor().Reduce(temp, reduction);
+   return norm * TCpuMatrix<AFloat>::SumRanges(f, m, n);
 }
 
 //______________________________________________________________________________
@@ -168,23 +157,23 @@ void TCpu<AFloat>::SoftmaxCrossEntropyGradients(
    size_t n = Y.GetNcols();
    AFloat norm = 1.0 / ((AFloat) m);
 
-   auto f = [&dataDY, &dataY, &dataOutput, norm, n, m](UInt_t workerID)
+   auto f = [dataDY, dataY, dataOutput, norm, n, m](size_t begin, size_t end)
    {
-      AFloat sum  = 0.0;
-      AFloat sumY = 0.0;
-      for (size_t j = 0; j < n; j++) {
-         sum  += exp(dataOutput[workerID + j * m]);
-         sumY += dataY[workerID + j * m];
-      }
-      for (size_t j = 0; j < n; j++) {
-         dataDY[workerID + j * m] =
-            norm * (exp(dataOutput[workerID + j * m]) / sum * sumY - dataY[workerID + j * m]);
-
+      for (size_t row = begin; row < end; row++) {
+         AFloat sum  = 0.0;
+         AFloat sumY = 0.0;
+         for (size_t j = 0; j < n; j++) {
+            sum  += exp(dataOutput[row + j * m]);
+            sumY += dataY[row + j * m];
+         }
+         for (size_t j = 0; j < n; j++) {
+            dataDY[row + j * m] =
+               norm * (exp(dataOutput[row + j * m]) / sum * sumY - dataY[row + j * m]);
+         }
       }
-      return 0;
    };
 
-   Y.GetThreadExecutor().Map(f, ROOT::TSeqI(Y.GetNrows()));
+   TCpuMatrix<AFloat>::ForEachRange(f, m, n);
 }
 
 } // namespace DNN
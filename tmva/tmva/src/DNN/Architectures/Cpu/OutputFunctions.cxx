@@ -38,19 +38,20 @@ void TCpu<AFloat>::Softmax(TCpuMatrix<AFloat> & B,
    size_t n = A.GetNcols();
    size_t m = A.GetNrows();
 
-   auto f = [&dataA, &dataB, n, m](UInt_t workerID)
+   auto f = [dataA, dataB, n, m](size_t begin, size_t end)
    {
-      AFloat sum = 0.0;
-      for (size_t i = 0; i < n; i++) {
-         sum += exp(dataA[workerID + i * m]);
+      for (size_t row = begin; row < end; row++) {
+         AFloat sum = 0.0;
+         for (size_t i = 0; i < n; i++) {
+            sum += exp(dataA[row + i * m]);
+         }
+         for (size_t i = 0; i < n; i++) {
+            dataB[row + i * m] = exp(dataA[row + i * m]) / sum;
+         }
       }
-      for (size_t i = 0; i < n; i++) {
-         dataB[workerID + i * m] = exp(dataA[workerID + i * m]) / sum;
-      }
-      return 0;
    };
 
-   B.GetThreadExecutor().Map(f, ROOT::TSeqI(A.GetNrows()));
+   TCpuMatrix<AFloat>::ForEachRange(f, m, n);
 }
 
 } // namespace DNN
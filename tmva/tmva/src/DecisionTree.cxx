@@ -66,6 +66,10 @@
 #include "TRandom3.h"
 #include "TMath.h"
 #include "TMatrix.h"
+#include "ROOT/TSeq.hxx"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 
 #include "TMVA/MsgLogger.h"
 #include "TMVA/DecisionTree.h"
@@ -1149,37 +1153,53 @@ Double_t TMVA::DecisionTree::TrainNodeFast( const EventConstList & eventSample,
          nTotB+=eventWeight;
          nTotB_unWeighted++;
       }
-      
-      Int_t iBin=-1;
-      for (UInt_t ivar=0; ivar < cNvars; ivar++) {
-         // now scan trough the cuts for each varable and find which one gives
-         // the best separationGain at the current stage.
-         if ( useVariable[ivar] ) {
-            Double_t eventData;
-            if (ivar < fNvars) eventData = eventSample[iev]->GetValue(ivar); 
-            else { // the fisher variable
-               eventData = fisherCoeff[fNvars];
-               for (UInt_t jvar=0; jvar<fNvars; jvar++)
-                  eventData += fisherCoeff[jvar]*(eventSample[iev])->GetValue(jvar);
-               
-            }
-            // "maximum" is nbins-1 (the "-1" because we start counting from 0 !!
-            iBin = TMath::Min(Int_t(nBins[ivar]-1),TMath::Max(0,int (invBinWidth[ivar]*(eventData-xmin[ivar]) ) ));
-            if (eventSample[iev]->GetClass() == fSigClass) {
-               nSelS[ivar][iBin]+=eventWeight;
-               nSelS_unWeighted[ivar][iBin]++;
-            } 
-            else {
-               nSelB[ivar][iBin]+=eventWeight;
-               nSelB_unWeighted[ivar][iBin]++;
-            }
-            if (DoRegression()) {
-               target[ivar][iBin] +=eventWeight*eventSample[iev]->GetTarget(0);
-               target2[ivar][iBin]+=eventWeight*eventSample[iev]->GetTarget(0)*eventSample[iev]->GetTarget(0);
-            }
+   }
+
+   // fill the histogram of one variable. The histograms of the different
+   // variables are independent and each is filled in the order of the events,
+   // hence they can be filled concurrently with identical results
+   auto fillVariable = [&](UInt_t ivar) {
+      // now scan trough the cuts for each varable and find which one gives
+      // the best separationGain at the current stage.
+      if ( !useVariable[ivar] ) return 0;
+      for (UInt_t iev=0; iev<nevents; iev++) {
+         Double_t eventWeight =  eventSample[iev]->GetWeight(); 
+         Double_t eventData;
+         if (ivar < fNvars) eventData = eventSample[iev]->GetValue(ivar); 
+         else { // the fisher variable
+            eventData = fisherCoeff[fNvars];
+            for (UInt_t jvar=0; jvar<fNvars; jvar++)
+               eventData += fisherCoeff[jvar]*(eventSample[iev])->GetValue(jvar);
+            
+         }
+         // "maximum" is nbins-1 (the "-1" because we start counting from 0 !!
+         Int_t iBin = TMath::Min(Int_t(nBins[ivar]-1),TMath::Max(0,int (invBinWidth[ivar]*(eventData-xmin[ivar]) ) ));
+         if (eventSample[iev]->GetClass() == fSigClass) {
+            nSelS[ivar][iBin]+=eventWeight;
+            nSelS_unWeighted[ivar][iBin]++;
+         } 
+         else {
+            nSelB[ivar][iBin]+=eventWeight;
+            nSelB_unWeighted[ivar][iBin]++;
+         }
+         if (DoRegression()) {
+            target[ivar][iBin] +=eventWeight*eventSample[iev]->GetTarget(0);
+            target2[ivar][iBin]+=eventWeight*eventSample[iev]->GetTarget(0)*eventSample[iev]->GetTarget(0);
          }
       }
-   }   
+      return 0;
+   };
+
+#ifdef R__USE_IMT
+   if (cNvars > 1 && nevents >= fgMinEventsMT && ROOT::IsImplicitMTEnabled()) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(fillVariable, ROOT::TSeqU(cNvars));
+   } else
+#endif
+   {
+      for (UInt_t ivar=0; ivar < cNvars; ivar++) fillVariable(ivar);
+   }
+
    // now turn the "histogram" into a cumulative distribution
    for (UInt_t ivar=0; ivar < cNvars; ivar++) {
       if (useVariable[ivar]) {
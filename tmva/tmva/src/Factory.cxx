@@ -72,6 +72,7 @@
 #include "TMVA/ResultsMulticlass.h"
 #include <list>
 #include <bitset>
+#include <algorithm>
 
 #include "TMVA/Types.h"
 
@@ -93,6 +94,9 @@
 #include "TObjString.h"
 #include "TSystem.h"
 #include "TCanvas.h"
+#include "TKey.h"
+#include "TClass.h"
+#include "ROOT/TProcessExecutor.hxx"
 
 const Int_t  MinNoTrainingEvents = 10;
 //const Int_t  MinNoTestEvents     = 1;
@@ -122,7 +126,8 @@ TMVA::Factory::Factory( TString jobName, TFile* theTargetFile, TString theOption
    fSilentFile           ( kFALSE ),
    fJobName              ( jobName ),
    fAnalysisType         ( Types::kClassification ),
-   fModelPersistence     (kTRUE)
+   fModelPersistence     (kTRUE),
+   fNWorkers             (0)
 {
    fgTargetFile = theTargetFile;
    fLogger->SetSource(GetName());
@@ -197,7 +202,8 @@ TMVA::Factory::Factory( TString jobName, TString theOption )
    fSilentFile           ( kTRUE ),
    fJobName              ( jobName ),
    fAnalysisType         ( Types::kClassification ),
-   fModelPersistence     (kTRUE)
+   fModelPersistence     (kTRUE),
+   fNWorkers             (0)
 {
    fgTargetFile = 0;
    fLogger->SetSource(GetName());
@@ -679,6 +685,7 @@ Double_t TMVA::Factory::GetROCIntegral(TString datasetname,TString theMethodName
    if (!fROCCurve) Log() << kFATAL << Form("ROCCurve object was not created in Method = %s not found with Dataset = %s ", theMethodName.Data(), datasetname.Data()) << Endl;
 
    Double_t fROCalcValue = fROCCurve->GetROCIntegral();
+   delete fROCCurve;
 
    return fROCalcValue;
 }
@@ -817,7 +824,159 @@ TCanvas * TMVA::Factory::GetROCCurve(TString datasetname)
 
 
 ////////////////////////////////////////////////////////////////////////////////
-/// iterates through all booked methods and calls training
+/// checks the data set of a method before its training, and writes its
+/// information into the output file; returns false if the method has too
+/// few training events to be trained
+
+Bool_t TMVA::Factory::PrepareTraining(MethodBase *mva)
+{
+   if(mva->DataInfo().GetDataSetManager()->DataInput().GetEntries() <=1) { // 0 entries --> 0 events, 1 entry --> dynamical dataset (or one entry)
+      Log() << kFATAL << "No input data for the training provided!" << Endl;
+   }
+
+   if(fAnalysisType == Types::kRegression && mva->DataInfo().GetNTargets() < 1 )
+   Log() << kFATAL << "You want to do regression training without specifying a target." << Endl;
+   else if( (fAnalysisType == Types::kMulticlass || fAnalysisType == Types::kClassification)
+         && mva->DataInfo().GetNClasses() < 2 )
+   Log() << kFATAL << "You want to do classification training, but specified less than two classes." << Endl;
+
+   // first print some information about the default dataset
+   if(!IsSilentFile()) WriteDataInformation(mva->fDataSetInfo);
+
+   if (mva->Data()->GetNTrainingEvents() < MinNoTrainingEvents) {
+      Log() << kWARNING << "Method " << mva->GetMethodName()
+            << " not trained (training tree has less entries ["
+            << mva->Data()->GetNTrainingEvents()
+            << "] than required [" << MinNoTrainingEvents << "]" << Endl;
+      return kFALSE;
+   }
+   return kTRUE;
+}
+
+namespace {
+   ////////////////////////////////////////////////////////////////////////////////
+   /// copies recursively the last cycle of the objects of src into dst, in the
+   /// order in which they were written, but those of which dst already has one
+   /// of the same name
+
+   void CopyDirectory(TDirectory *src, TDirectory *dst)
+   {
+      TIter next(src->GetListOfKeys(), kIterBackward);
+      while (TKey *key = (TKey*)next()) {
+         if (key != src->GetKey(key->GetName())) continue;
+         TClass *cl = TClass::GetClass(key->GetClassName());
+         if (cl && cl->InheritsFrom(TDirectory::Class())) {
+            TDirectory *subdir = dst->GetDirectory(key->GetName());
+            if (!subdir) subdir = dst->mkdir(key->GetName(), key->GetTitle());
+            CopyDirectory(src->GetDirectory(key->GetName()), subdir);
+            continue;
+         }
+         if (dst->GetKey(key->GetName())) continue;
+         TObject *obj = key->ReadObj();
+         if (!obj) continue;
+         dst->cd();
+         if (TTree *tree = dynamic_cast<TTree*>(obj)) {
+            TTree *copy = tree->CloneTree(-1, "fast");
+            copy->Write(key->GetName());
+            delete copy;
+         } else {
+            obj->Write(key->GetName());
+         }
+         delete obj;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// trains the methods of a data set in fNWorkers worker processes, each of
+/// them writing the weight file of its method and, unless the file is
+/// silent, its histograms into a temporary ROOT file. The temporary files
+/// are then copied into the output file in the order of the booking, so
+/// that its content does not depend on which training finishes first.
+/// The trained methods only live in the workers: they are recreated from
+/// their weight files by TrainAllMethods, which then computes their output
+/// on the training sample. Returns false, without training any method, if
+/// there are less than two methods or the weight files are not written.
+
+Bool_t TMVA::Factory::TrainMethodsInWorkers(MVector *methods)
+{
+   if (fNWorkers < 2 || !fModelPersistence) return kFALSE;
+
+   std::vector<MethodBase*> booked;
+   for (UInt_t i=0; i<methods->size(); i++) {
+      MethodBase* mva = dynamic_cast<MethodBase*>((*methods)[i]);
+      if (mva) booked.push_back(mva);
+   }
+   if (booked.size() < 2) return kFALSE;
+
+   std::vector<MethodBase*> trained;
+   for (UInt_t i=0; i<booked.size(); i++) {
+      if (PrepareTraining(booked[i])) trained.push_back(booked[i]);
+   }
+   if (trained.empty()) return kTRUE;
+
+   UInt_t nWorkers = std::min(fNWorkers, (UInt_t)trained.size());
+   Log() << kHEADER << "Train " << trained.size() << " methods in " << nWorkers << " worker processes" << Endl << Endl;
+
+   // the output file is only written by this process
+   auto work = [&](UInt_t i) {
+      MethodBase* mva = trained[i];
+      // do not let the worker close the output file at exit
+      if (fgTargetFile) gROOT->GetListOfFiles()->Remove(fgTargetFile);
+      TString fileName;
+      TFile *file = 0;
+      if (!IsSilentFile()) {
+         fileName = Form("%s/TMVA_%d_%s_%s.root", gSystem->TempDirectory(), gSystem->GetPid(),
+                         mva->DataInfo().GetName(), mva->GetMethodName().Data());
+         file = TFile::Open(fileName, "RECREATE");
+         if (!file || file->IsZombie()) return (TObjString*)0;
+         mva->SetFile(file);
+         mva->SetMethodDir(0);
+      }
+      Log() << kHEADER << "Train method: " << mva->GetMethodName() << Endl << Endl;
+      Event::SetIsTraining(kTRUE);
+      mva->TrainMethod();
+      if (file) {
+         file->Close();
+         delete file;
+      }
+      return new TObjString(fileName);
+   };
+   ROOT::TProcessExecutor workers(nWorkers);
+   std::vector<TObjString*> files = workers.Map(work, ROOT::TSeqU(trained.size()));
+
+   for (UInt_t i=0; i<trained.size(); i++) {
+      MethodBase* mva = trained[i];
+      TObjString *fileName = i < files.size() ? files[i] : 0;
+      if (!fileName) {
+         Log() << kFATAL << "No training received for method " << mva->GetMethodName() << Endl;
+         continue;
+      }
+      if (fileName->GetString() != "") {
+         TFile *file = TFile::Open(fileName->GetString());
+         if (!file || file->IsZombie()) {
+            Log() << kFATAL << "Could not open the training output " << fileName->GetString()
+                  << " of method " << mva->GetMethodName() << Endl;
+         } else {
+            mva->BaseDir();
+            TString path = mva->MethodBaseDir()->GetPath();
+            path.Remove(0, path.Index(":/") + 2);
+            TDirectory *dir = file->GetDirectory(path);
+            if (dir) CopyDirectory(dir, mva->MethodBaseDir());
+            delete file;
+         }
+         gSystem->Unlink(fileName->GetString());
+      }
+      delete fileName;
+   }
+   Log() << kHEADER << "Training finished" << Endl << Endl;
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// iterates through all booked methods and calls training. With SetNWorkers(n)
+/// and the ModelPersistence option, the methods of each data set are trained
+/// in n worker processes (see TrainMethodsInWorkers)
 
 void TMVA::Factory::TrainAllMethods() 
 {  
@@ -844,34 +1003,17 @@ void TMVA::Factory::TrainAllMethods()
       MVector *methods=itrMap->second;
       MVector::iterator itrMethod;
 
+      Event::SetIsTraining(kTRUE);
+      Bool_t inWorkers = TrainMethodsInWorkers(methods);
+
       // iterate over methods and train
-      for( itrMethod = methods->begin(); itrMethod != methods->end(); itrMethod++ ) {
+      for( itrMethod = methods->begin(); !inWorkers && itrMethod != methods->end(); itrMethod++ ) {
 	  Event::SetIsTraining(kTRUE);
 	  MethodBase* mva = dynamic_cast<MethodBase*>(*itrMethod);
 	  
 	  if(mva==0) continue;
 	  
-	  if(mva->DataInfo().GetDataSetManager()->DataInput().GetEntries() <=1) { // 0 entries --> 0 events, 1 entry --> dynamical dataset (or one entry)
-	      Log() << kFATAL << "No input data for the training provided!" << Endl;
-	  }
-	  
-	  if(fAnalysisType == Types::kRegression && mva->DataInfo().GetNTargets() < 1 )
-	  Log() << kFATAL << "You want to do regression training without specifying a target." << Endl;
-	  else if( (fAnalysisType == Types::kMulticlass || fAnalysisType == Types::kClassification) 
-		&& mva->DataInfo().GetNClasses() < 2 ) 
-	  Log() << kFATAL << "You want to do classification training, but specified less than two classes." << Endl;
-	  
-	  // first print some information about the default dataset
-	  if(!IsSilentFile()) WriteDataInformation(mva->fDataSetInfo);
-
-	  
-	  if (mva->Data()->GetNTrainingEvents() < MinNoTrainingEvents) {
-	    Log() << kWARNING << "Method " << mva->GetMethodName()
-		  << " not trained (training tree has less entries ["
-		  << mva->Data()->GetNTrainingEvents()
-		  << "] than required [" << MinNoTrainingEvents << "]" << Endl;
-	    continue;
-	  }
+	  if (!PrepareTraining(mva)) continue;
 
 	  Log() << kHEADER << "Train method: " << mva->GetMethodName() << " for "
 		<< (fAnalysisType == Types::kRegression ? "Regression" :
@@ -880,9 +1022,8 @@ void TMVA::Factory::TrainAllMethods()
           Log() << kHEADER << "Training finished" << Endl << Endl;
       }
 
-      if (fAnalysisType != Types::kRegression) {
-
-	  // variable ranking
+      // variable ranking, of the recreated methods when trained in workers
+      auto printRankings = [&]() {
 	  //Log() << Endl;
 	  Log() << kINFO << "Ranking input variables (method specific)..." << Endl;
 	  for (itrMethod = methods->begin(); itrMethod != methods->end(); itrMethod++) {
@@ -896,7 +1037,8 @@ void TMVA::Factory::TrainAllMethods()
 			  << dynamic_cast<MethodBase*>(*itrMethod)->GetMethodName() << Endl;
 	    }
 	  }
-      }
+      };
+      if (fAnalysisType != Types::kRegression && !inWorkers) printRankings();
 
       // delete all methods and recreate them from weight file - this ensures that the application
       // of the methods (in TMVAClassificationApplication) is consistent with the results obtained
@@ -946,10 +1088,18 @@ void TMVA::Factory::TrainAllMethods()
 	    m->ReadStateFromFile();
 	    m->SetTestvarName(testvarName);
 
+	    // the output on the training sample was lost with the worker
+	    if (inWorkers && m->Data()->GetNTrainingEvents() >= MinNoTrainingEvents) {
+	       Event::SetIsTraining(kTRUE);
+	       m->AddOutput(Types::kTraining, m->GetAnalysisType());
+	    }
+
 	    // replace trained method by newly created one (from weight file) in methods vector
 	    (*methods)[i] = m;
 	  }
        }
+
+      if (fAnalysisType != Types::kRegression && inWorkers) printRankings();
    }
 }
 
@@ -0,0 +1,319 @@
+// @(#)root/tmva $Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/*! \class TMVA::FlatForest
+\ingroup TMVA
+
+Forest of decision trees compiled into a flat array of nodes.
+
+All nodes of all trees are stored in one contiguous array, the nodes
+of each tree either in depth-first order (the daughter for a failed
+cut directly follows its mother) or in breadth-first order (the nodes
+of the same depth are adjacent). The cut type of the original nodes is
+absorbed by exchanging their daughters, so that every node sends the
+event to the "right" daughter if its cut is passed.
+
+The batch evaluation AddTreeValues processes the events in blocks and
+loops over the trees for each block, so that the nodes of a tree stay
+in the cache while they are applied to all events of the block.
+
+With quantized cuts, the value of each variable of an event is
+converted once to its position among the sorted distinct cuts on that
+variable, and the nodes compare these integer positions. As
+`x >= cut[k]` is equivalent to `position(x) > k`, the results do not
+change.
+*/
+
+#include "TMVA/FlatForest.h"
+
+#include "TMVA/DecisionTree.h"
+#include "TMVA/DecisionTreeNode.h"
+#include "TMVA/MsgLogger.h"
+
+#include "TMath.h"
+
+#include <algorithm>
+#include <deque>
+
+namespace {
+   // number of events evaluated together in AddTreeValues
+   const UInt_t kBlockSize = 64;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// default constructor of an empty forest
+
+TMVA::FlatForest::FlatForest()
+   : fNVars(0),
+     fOrdering(kDepthFirst),
+     fQuantized(kFALSE)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// compile the decision trees of 'forest' for events with 'nVars' variables.
+/// The leaves of classification trees hold the node type if 'useYesNoLeaf'
+/// is set, and the purity otherwise; those of regression trees hold the
+/// response, as in DecisionTree::CheckEvent
+
+TMVA::FlatForest::FlatForest( const std::vector<DecisionTree*>& forest, UInt_t nVars,
+                              const std::vector<Double_t>& weights, Bool_t useYesNoLeaf,
+                              ENodeOrdering ordering, Bool_t quantizeCuts )
+   : fNVars(nVars),
+     fOrdering(ordering),
+     fQuantized(kFALSE)
+{
+   if (!weights.empty() && weights.size() < forest.size()) {
+      Log() << kFATAL << "<FlatForest> " << weights.size() << " weights given for "
+            << forest.size() << " trees" << Endl;
+   }
+
+   fTreeOffsets.reserve(forest.size());
+   fWeights.reserve(forest.size());
+   for (UInt_t itree=0; itree<forest.size(); itree++) {
+      AddTree(forest[itree], useYesNoLeaf);
+      fWeights.push_back(weights.empty() ? 1. : weights[itree]);
+   }
+
+   if (quantizeCuts) Quantize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// destructor
+
+TMVA::FlatForest::~FlatForest()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// append the nodes of 'tree' to the array
+
+void TMVA::FlatForest::AddTree( const DecisionTree* tree, Bool_t useYesNoLeaf )
+{
+   const DecisionTreeNode* top = tree->GetRoot();
+   if (!top) {
+      Log() << kFATAL << "<FlatForest> tree without root node" << Endl;
+      return;
+   }
+
+   UInt_t root = fNodes.size();
+   fTreeOffsets.push_back(root);
+
+   if (fOrdering == kDepthFirst) {
+      AddNode(top, root, tree->DoRegression(), useYesNoLeaf);
+      return;
+   }
+
+   // breadth first: the daughters of a node are appended when the node is
+   // taken from the queue, together with the position of the link to them
+   std::deque<std::pair<const DecisionTreeNode*, UInt_t> > queue;
+   queue.push_back(std::make_pair(top, AddNode(top, root, tree->DoRegression(), useYesNoLeaf)));
+   while (!queue.empty()) {
+      const DecisionTreeNode* node = queue.front().first;
+      UInt_t pos = queue.front().second;
+      queue.pop_front();
+      if (fNodes[root+pos].fSelector == kLeaf) continue;
+
+      const DecisionTreeNode* fail = node->GetCutType() ? node->GetLeft()  : node->GetRight();
+      const DecisionTreeNode* pass = node->GetCutType() ? node->GetRight() : node->GetLeft();
+      UInt_t left = AddNode(fail, root, tree->DoRegression(), useYesNoLeaf);
+      fNodes[root+pos].fLeft = left;
+      queue.push_back(std::make_pair(fail, left));
+      UInt_t right = AddNode(pass, root, tree->DoRegression(), useYesNoLeaf);
+      fNodes[root+pos].fRight = right;
+      queue.push_back(std::make_pair(pass, right));
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// append 'node' to the array and return its position relative to the root
+/// of its tree. In depth-first ordering its daughters are appended as well
+
+UInt_t TMVA::FlatForest::AddNode( const DecisionTreeNode* node, UInt_t root,
+                                  Bool_t isRegression, Bool_t useYesNoLeaf )
+{
+   UInt_t pos = fNodes.size() - root;
+
+   Node flat;
+   flat.fLeft  = 0;
+   flat.fRight = 0;
+   flat.fAux   = 0;
+   if (node->GetNodeType() != 0) { // leaf, possibly of a pruned tree
+      flat.fSelector = kLeaf;
+      if (isRegression)      flat.fCut = node->GetResponse();
+      else if (useYesNoLeaf) flat.fCut = Float_t(node->GetNodeType());
+      else                   flat.fCut = node->GetPurity();
+      fNodes.push_back(flat);
+      return pos;
+   }
+
+   if (!node->GetLeft() || !node->GetRight()) {
+      Log() << kFATAL << "<FlatForest> inconsistent tree structure" << Endl;
+   }
+   flat.fCut = node->GetCutValue();
+   if (node->GetNFisherCoeff() == 0) {
+      if (node->GetSelector() < 0 || UInt_t(node->GetSelector()) >= fNVars) {
+         Log() << kFATAL << "<FlatForest> cut on variable " << node->GetSelector()
+               << " for events with " << fNVars << " variables" << Endl;
+      }
+      flat.fSelector = node->GetSelector();
+   } else {
+      if (node->GetNFisherCoeff() != fNVars+1) {
+         Log() << kFATAL << "<FlatForest> Fisher cut with " << node->GetNFisherCoeff()
+               << " coefficients for events with " << fNVars << " variables" << Endl;
+      }
+      flat.fSelector = kFisher;
+      flat.fAux = fFisherCoeff.size();
+      for (UInt_t i=0; i<node->GetNFisherCoeff(); i++) fFisherCoeff.push_back(node->GetFisherCoeff(i));
+   }
+   fNodes.push_back(flat);
+
+   if (fOrdering == kDepthFirst) {
+      const DecisionTreeNode* fail = node->GetCutType() ? node->GetLeft()  : node->GetRight();
+      const DecisionTreeNode* pass = node->GetCutType() ? node->GetRight() : node->GetLeft();
+      UInt_t left = AddNode(fail, root, isRegression, useYesNoLeaf);
+      fNodes[root+pos].fLeft = left;
+      UInt_t right = AddNode(pass, root, isRegression, useYesNoLeaf);
+      fNodes[root+pos].fRight = right;
+   }
+   return pos;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// collect the distinct cut values of each variable and store the position
+/// of its cut in each node
+
+void TMVA::FlatForest::Quantize()
+{
+   fCuts.assign(fNVars, std::vector<Float_t>());
+   for (UInt_t i=0; i<fNodes.size(); i++) {
+      if (fNodes[i].fSelector >= 0) fCuts[fNodes[i].fSelector].push_back(fNodes[i].fCut);
+   }
+   for (UInt_t ivar=0; ivar<fNVars; ivar++) {
+      std::sort(fCuts[ivar].begin(), fCuts[ivar].end());
+      fCuts[ivar].erase(std::unique(fCuts[ivar].begin(), fCuts[ivar].end()), fCuts[ivar].end());
+   }
+   for (UInt_t i=0; i<fNodes.size(); i++) {
+      if (fNodes[i].fSelector < 0) continue;
+      const std::vector<Float_t>& cuts = fCuts[fNodes[i].fSelector];
+      fNodes[i].fAux = std::lower_bound(cuts.begin(), cuts.end(), fNodes[i].fCut) - cuts.begin();
+   }
+   fQuantized = kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// convert the values of an event to their positions among the cuts, i.e.
+/// to the number of cuts on the same variable that are not above the value.
+/// NaN values fail all cuts, as in the comparison with the cut values
+
+void TMVA::FlatForest::QuantizeEvent( const Float_t* values, UInt_t* positions ) const
+{
+   for (UInt_t ivar=0; ivar<fNVars; ivar++) {
+      const std::vector<Float_t>& cuts = fCuts[ivar];
+      positions[ivar] = (cuts.empty() || TMath::IsNaN(values[ivar])) ? 0 :
+         std::upper_bound(cuts.begin(), cuts.end(), values[ivar]) - cuts.begin();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// descend the tree starting at 'root' and return the value of the leaf
+/// reached by the event
+
+Float_t TMVA::FlatForest::GetLeaf( const Node* root, const Float_t* values, const UInt_t* positions ) const
+{
+   const Node* node = root;
+   while (node->fSelector != kLeaf) {
+      Bool_t pass;
+      if (node->fSelector == kFisher) {
+         const Double_t* coeff = &fFisherCoeff[node->fAux];
+         Double_t fisher = coeff[fNVars]; // the offset
+         for (UInt_t ivar=0; ivar<fNVars; ivar++) fisher += coeff[ivar]*values[ivar];
+         pass = fisher > node->fCut;
+      }
+      else if (positions) pass = positions[node->fSelector] > node->fAux;
+      else                pass = values[node->fSelector] >= node->fCut;
+      node = root + (pass ? node->fRight : node->fLeft);
+   }
+   return node->fCut;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// return the end of the tree range, all trees for zero
+
+UInt_t TMVA::FlatForest::GetLastTree( UInt_t lastTree ) const
+{
+   return (lastTree == 0 || lastTree > GetNTrees()) ? GetNTrees() : lastTree;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// return the value of tree 'itree' for an event
+
+Double_t TMVA::FlatForest::GetTreeValue( UInt_t itree, const Float_t* values ) const
+{
+   if (itree >= GetNTrees()) {
+      Log() << kFATAL << "<FlatForest::GetTreeValue> tree " << itree << " does not exist" << Endl;
+      return 0;
+   }
+   std::vector<UInt_t> positions;
+   if (fQuantized) {
+      positions.resize(fNVars);
+      QuantizeEvent(values, positions.data());
+   }
+   return GetLeaf(&fNodes[fTreeOffsets[itree]], values, fQuantized ? positions.data() : 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// add the weighted values of the selected trees to the sums of the events
+
+void TMVA::FlatForest::AddTreeValues( const Float_t* values, UInt_t nEvents, Double_t* sums,
+                                      UInt_t firstTree, UInt_t lastTree, UInt_t treeStep ) const
+{
+   lastTree = GetLastTree(lastTree);
+   if (treeStep == 0) treeStep = 1;
+
+   std::vector<UInt_t> positions(fQuantized ? kBlockSize*fNVars : 0);
+   for (UInt_t begin=0; begin<nEvents; begin+=kBlockSize) {
+      UInt_t end = std::min(nEvents, begin+kBlockSize);
+      if (fQuantized) {
+         for (UInt_t iev=begin; iev<end; iev++) {
+            QuantizeEvent(values + iev*fNVars, &positions[(iev-begin)*fNVars]);
+         }
+      }
+      for (UInt_t itree=firstTree; itree<lastTree; itree+=treeStep) {
+         const Node* root = &fNodes[fTreeOffsets[itree]];
+         Double_t weight = fWeights[itree];
+         for (UInt_t iev=begin; iev<end; iev++) {
+            const UInt_t* pos = fQuantized ? &positions[(iev-begin)*fNVars] : 0;
+            sums[iev] += weight * GetLeaf(root, values + iev*fNVars, pos);
+         }
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// return the sum of the weights of the selected trees
+
+Double_t TMVA::FlatForest::GetSumOfWeights( UInt_t firstTree, UInt_t lastTree, UInt_t treeStep ) const
+{
+   lastTree = GetLastTree(lastTree);
+   if (treeStep == 0) treeStep = 1;
+   Double_t sum = 0;
+   for (UInt_t itree=firstTree; itree<lastTree; itree+=treeStep) sum += fWeights[itree];
+   return sum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// message logger
+
+TMVA::MsgLogger& TMVA::FlatForest::Log() const
+{
+   TTHREAD_TLS_DECL_ARG(MsgLogger,logger,"FlatForest");
+   return logger;
+}
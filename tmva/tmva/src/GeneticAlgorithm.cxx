@@ -31,10 +31,6 @@
 #include <algorithm>
 #include <float.h>
 
-#ifdef _GLIBCXX_PARALLEL
-#include <omp.h>
-#endif
-
 #include "TMVA/GeneticAlgorithm.h"
 #include "TMVA/Interval.h"
 #include "TMVA/IFitterTarget.h"
@@ -131,37 +127,19 @@ Double_t TMVA::GeneticAlgorithm::NewFitness( Double_t /*oldValue*/, Double_t new
 Double_t TMVA::GeneticAlgorithm::CalculateFitness()
 {
    fBestFitness = DBL_MAX;
-#ifdef _GLIBCXX_PARALLEL
-
-   const int nt = omp_get_num_threads();
-   Double_t bests[nt];
-   for ( int i =0; i < nt; ++i )
-      bests[i] = fBestFitness;
-
-#pragma omp parallel
-   {
-      int thread_number = omp_get_thread_num();
-#pragma omp for
-      for ( int index = 0; index < fPopulation.GetPopulationSize(); ++index )
-         {
-            GeneticGenes* genes = fPopulation.GetGenes(index);
-            Double_t fitness = NewFitness( genes->GetFitness(), 
-                                           fFitterTarget.EstimatorFunction(genes->GetFactors()) );
-            genes->SetFitness( fitness );
-         
-            if ( bests[thread_number] > fitness )
-               bests[thread_number] = fitness;
-         }
-   }
-   
-   fBestFitness = *std::min_element(bests, bests+nt);
 
-#else 
+   // the whole population is given at once to the fitter target, which
+   // evaluates it in parallel if it is thread-safe (see IFitterTarget)
+   const Int_t nind = fPopulation.GetPopulationSize();
+   std::vector<std::vector<Double_t>*> factors( nind );
+   for ( Int_t index = 0; index < nind; ++index )
+      factors[index] = &fPopulation.GetGenes(index)->GetFactors();
+   std::vector<Double_t> estimators;
+   fFitterTarget.EstimatorFunctions( factors, estimators );
 
-   for ( int index = 0; index < fPopulation.GetPopulationSize(); ++index ) {
+   for ( Int_t index = 0; index < nind; ++index ) {
       GeneticGenes* genes = fPopulation.GetGenes(index);
-      Double_t fitness = NewFitness( genes->GetFitness(),
-                                     fFitterTarget.EstimatorFunction(genes->GetFactors()) );
+      Double_t fitness = NewFitness( genes->GetFitness(), estimators[index] );
       genes->SetFitness( fitness );
       
       if ( fBestFitness  > fitness )
@@ -169,8 +147,6 @@ Double_t TMVA::GeneticAlgorithm::CalculateFitness()
       
    }
 
-#endif
-
    fPopulation.Sort();
 
    return fBestFitness; 
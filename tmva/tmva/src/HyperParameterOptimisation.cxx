@@ -11,10 +11,15 @@
 #include "TMVA/Types.h"
 
 #include "TGraph.h"
+#include "TList.h"
 #include "TMultiGraph.h"
+#include "TParameter.h"
 #include "TString.h"
 #include "TSystem.h"
+#include "ROOT/TProcessExecutor.hxx"
+#include "ROOT/TSeq.hxx"
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -58,7 +63,8 @@ TMVA::HyperParameterOptimisation::HyperParameterOptimisation(TMVA::DataLoader *d
     fFitType("Minuit"),
     fNumFolds(5),
     fResults(),
-    fClassifier(new TMVA::Factory("HyperParameterOptimisation","!V:!ROC:Silent:!ModelPersistence:!Color:!DrawProgressBar:AnalysisType=Classification"))
+    fClassifier(new TMVA::Factory("HyperParameterOptimisation","!V:!ROC:Silent:!ModelPersistence:!Color:!DrawProgressBar:AnalysisType=Classification")),
+    fNWorkers(0)
 {
     fFoldStatus=kFALSE;
 }
@@ -88,26 +94,54 @@ void TMVA::HyperParameterOptimisation::Evaluate()
     }
     fResults.fMethodName = methodName;
 
-    for(UInt_t i = 0; i < fNumFolds; ++i) {
+    // optimise the folds, in worker processes if requested. Each worker
+    // prepares its fold on its own copy of the data set.
+    std::vector<TList*> folds;
+    if(fNWorkers > 1 && fNumFolds > 1) {
+        auto work = [&](UInt_t i) { return OptimiseFold(i, methodName, methodTitle, methodOptions); };
+        ROOT::TProcessExecutor workers(std::min(fNWorkers, fNumFolds));
+        folds = workers.Map(work, ROOT::TSeqU(fNumFolds));
+    } else {
+        for(UInt_t i = 0; i < fNumFolds; ++i) folds.push_back(OptimiseFold(i, methodName, methodTitle, methodOptions));
+    }
 
-        TString foldTitle = methodTitle;
-        foldTitle += "_opt";
-        foldTitle += i+1;
+    // collect the parameters in the order of the folds
+    for(UInt_t i = 0; i < folds.size(); ++i) {
+        if(!folds[i]) Log() << kFATAL << "No results received for fold " << i << Endl;
+        std::map<TString,Double_t> params;
+        TIter next(folds[i]);
+        while(TParameter<Double_t> *par = dynamic_cast<TParameter<Double_t>*>(next())) {
+            params[par->GetName()] = par->GetVal();
+        }
+        fResults.fFoldParameters.push_back(params);
+        delete folds[i];
+    }
 
-        Event::SetIsTraining(kTRUE);
-        fDataLoader->PrepareFoldDataSet(i, TMVA::Types::kTraining);
+}
 
-        auto smethod = fClassifier->BookMethod(fDataLoader.get(), methodName, methodTitle, methodOptions);
+TList* TMVA::HyperParameterOptimisation::OptimiseFold(UInt_t i, const TString &methodName, const TString &methodTitle, const TString &methodOptions)
+{
+    // Optimise the tuning parameters of the method on fold i. The parameters are
+    // returned as a list of TParameter<Double_t>, which can be sent from a worker process.
+    TString foldTitle = methodTitle;
+    foldTitle += "_opt";
+    foldTitle += i+1;
 
-        auto params=smethod->OptimizeTuningParameters(fFomType,fFitType);
-        fResults.fFoldParameters.push_back(params);
+    Event::SetIsTraining(kTRUE);
+    fDataLoader->PrepareFoldDataSet(i, TMVA::Types::kTraining);
 
-        smethod->Data()->DeleteResults(smethod->GetMethodName(), Types::kTraining, Types::kClassification);
+    auto smethod = fClassifier->BookMethod(fDataLoader.get(), methodName, methodTitle, methodOptions);
 
-        fClassifier->DeleteAllMethods();
+    auto params=smethod->OptimizeTuningParameters(fFomType,fFitType);
+    TList *fold = new TList();
+    fold->SetOwner();
+    for(auto &it : params) fold->Add(new TParameter<Double_t>(it.first, it.second));
 
-        fClassifier->fMethodsMap.clear();
+    smethod->Data()->DeleteResults(smethod->GetMethodName(), Types::kTraining, Types::kClassification);
 
-    }
+    fClassifier->DeleteAllMethods();
+
+    fClassifier->fMethodsMap.clear();
 
+    return fold;
 }
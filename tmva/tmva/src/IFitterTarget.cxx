@@ -35,6 +35,11 @@
 #include "TMVA/IFitterTarget.h"
 
 #include "Rtypes.h"
+#include "TROOT.h"
+#include "ROOT/TSeq.hxx"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 
 ClassImp(TMVA::IFitterTarget)
 
@@ -45,3 +50,28 @@ TMVA::IFitterTarget::IFitterTarget()
 {
 }            
 
+////////////////////////////////////////////////////////////////////////////////
+/// evaluates the estimator for each set of parameters; the sets are shared
+/// between the threads of the implicit multi-threading pool only if the
+/// target declares itself thread-safe (see IsThreadSafe)
+
+void TMVA::IFitterTarget::EstimatorFunctions( const std::vector<std::vector<Double_t>*>& parameters,
+                                              std::vector<Double_t>& estimators )
+{
+   estimators.resize( parameters.size() );
+   auto evaluate = [&](UInt_t i) {
+      estimators[i] = EstimatorFunction( *parameters[i] );
+   };
+
+#ifdef R__USE_IMT
+   if (parameters.size() > 1 && IsThreadSafe() && ROOT::IsImplicitMTEnabled()) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(evaluate, ROOT::TSeqU(parameters.size()));
+      return;
+   }
+#endif
+   for (UInt_t i = 0; i < parameters.size(); ++i) {
+      evaluate(i);
+   }
+}
+
@@ -209,6 +209,7 @@ TMVA::MethodBDT::MethodBDT( const TString& jobName,
 {
    fMonitorNtuple = NULL;
    fSepType = NULL;
+   fFlatForest = NULL;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -263,6 +264,7 @@ TMVA::MethodBDT::MethodBDT( DataSetInfo& theData,
 {
    fMonitorNtuple = NULL;
    fSepType = NULL;
+   fFlatForest = NULL;
    // constructor for calculating BDT-MVA using previously generated decision trees
    // the result of the previous training (the decision trees) are read in via the
    // weight file. Make sure the the variables correspond to the ones used in
@@ -723,6 +725,7 @@ void TMVA::MethodBDT::Reset( void )
    // remove all the trees 
    for (UInt_t i=0; i<fForest.size();           i++) delete fForest[i];
    fForest.clear();
+   DeleteFlatForest();
 
    fBoostWeights.clear();
    if (fMonitorNtuple) { fMonitorNtuple->Delete(); fMonitorNtuple=NULL; }
@@ -747,6 +750,7 @@ void TMVA::MethodBDT::Reset( void )
 TMVA::MethodBDT::~MethodBDT( void )
 {
    for (UInt_t i=0; i<fForest.size();           i++) delete fForest[i];
+   DeleteFlatForest();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1134,6 +1138,7 @@ void TMVA::MethodBDT::SetTuneParameters(std::map<TString,Double_t> tuneParameter
 void TMVA::MethodBDT::Train()
 {
    TMVA::DecisionTreeNode::fgIsTraining=true;
+   DeleteFlatForest();
 
    // fill the STL Vector with the event sample
    // (needs to be done here and cannot be done in "init" as the options need to be 
@@ -2217,6 +2222,7 @@ void TMVA::MethodBDT::ReadWeightsFromXML(void* parent) {
    for (i=0; i<fForest.size(); i++) delete fForest[i];
    fForest.clear();
    fBoostWeights.clear();
+   DeleteFlatForest();
 
    UInt_t ntrees;
    UInt_t analysisType;
@@ -2292,6 +2298,7 @@ void  TMVA::MethodBDT::ReadWeightsFromStream( std::istream& istr )
    for (UInt_t i=0;i<fForest.size();i++) delete fForest[i];
    fForest.clear();
    fBoostWeights.clear();
+   DeleteFlatForest();
    Int_t iTree;
    Double_t boostWeight;
    for (int i=0;i<fNTrees;i++) {
@@ -2349,6 +2356,14 @@ Double_t TMVA::MethodBDT::PrivateGetMvaValue(const TMVA::Event* ev, Double_t* er
 
    if (useNTrees > 0 ) nTrees = useNTrees;
 
+   if (fFlatForest && fFlatForest->GetNTrees() == fForest.size()) {
+      fFlatValues.resize(GetNvar());
+      for (UInt_t ivar=0; ivar<GetNvar(); ivar++) fFlatValues[ivar] = ev->GetValue(ivar);
+      Double_t sum = 0;
+      fFlatForest->AddTreeValues(&fFlatValues[0], 1, &sum, 0, nTrees);
+      return CombineTreeValues(sum, fFlatForest->GetSumOfWeights(0, nTrees));
+   }
+
    if (fBoostType=="Grad") return GetGradBoostMVA(ev,nTrees);
    
    Double_t myMVA = 0;
@@ -2362,6 +2377,81 @@ Double_t TMVA::MethodBDT::PrivateGetMvaValue(const TMVA::Event* ev, Double_t* er
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the MVA value for the sum of the tree values 'sum' and the sum of
+/// the boost weights 'norm', as in PrivateGetMvaValue
+
+Double_t TMVA::MethodBDT::CombineTreeValues( Double_t sum, Double_t norm ) const
+{
+   if (fBoostType=="Grad") return 2.0/(1.0+exp(-2.0*sum))-1; //MVA output between -1 and 1
+   return ( norm > std::numeric_limits<double>::epsilon() ) ? sum / norm : 0 ;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compile the forest into a TMVA::FlatForest, in which the nodes of all
+/// trees are stored in one array in the given order, optionally with
+/// quantized cuts. GetMvaValue uses the flat forest from then on, with
+/// identical results. It is discarded when the forest changes.
+
+void TMVA::MethodBDT::CompileForest( FlatForest::ENodeOrdering ordering, Bool_t quantizeCuts )
+{
+   DeleteFlatForest();
+   Bool_t isGrad = (fBoostType=="Grad");
+   fFlatForest = new FlatForest(fForest, GetNvar(),
+                                isGrad ? std::vector<Double_t>() : fBoostWeights,
+                                isGrad ? kFALSE : fUseYesNoLeaf, ordering, quantizeCuts);
+   Log() << kDEBUG << "Compiled " << fFlatForest->GetNTrees() << " trees with "
+         << fFlatForest->GetNNodes() << " nodes into a flat forest" << Endl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// delete the flat copy of the forest
+
+void TMVA::MethodBDT::DeleteFlatForest()
+{
+   delete fFlatForest;
+   fFlatForest = NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Calculate the MVA values of 'nEvents' events at once. The GetNvar() input
+/// variables of event i are inputs[i*GetNvar()] ... inputs[(i+1)*GetNvar()-1],
+/// before the variable transformations of the method. The forest is compiled
+/// with the default options if that has not been done yet. The MVA values
+/// are identical to those of GetMvaValue.
+
+void TMVA::MethodBDT::GetMvaValues( const Float_t* inputs, UInt_t nEvents, Double_t* mvaValues )
+{
+   if (!fFlatForest || fFlatForest->GetNTrees() != fForest.size()) CompileForest();
+
+   UInt_t nVars = GetNvar();
+   const Float_t* values = inputs;
+   std::vector<Float_t> transformed;
+   std::vector<Double_t> preselection;
+   if (GetTransformationHandler().GetNumOfTransformations() > 0 || fDoPreselection) {
+      transformed.resize(nEvents*nVars);
+      if (fDoPreselection) preselection.assign(nEvents, 0);
+      std::vector<Float_t> input(nVars);
+      for (UInt_t iev=0; iev<nEvents; iev++) {
+         input.assign(inputs + iev*nVars, inputs + (iev+1)*nVars);
+         Event event(input, 0);
+         const Event* ev = GetEvent(&event);
+         for (UInt_t ivar=0; ivar<nVars; ivar++) transformed[iev*nVars+ivar] = ev->GetValue(ivar);
+         if (fDoPreselection) preselection[iev] = ApplyPreselectionCuts(ev);
+      }
+      values = &transformed[0];
+   }
+
+   for (UInt_t iev=0; iev<nEvents; iev++) mvaValues[iev] = 0;
+   fFlatForest->AddTreeValues(values, nEvents, mvaValues);
+
+   Double_t norm = fFlatForest->GetSumOfWeights();
+   for (UInt_t iev=0; iev<nEvents; iev++) {
+      if (fDoPreselection && TMath::Abs(preselection[iev])>0.05) mvaValues[iev] = preselection[iev];
+      else mvaValues[iev] = CombineTreeValues(mvaValues[iev], norm);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// get the multiclass MVA response for the BDT classifier
 
@@ -136,6 +136,31 @@ const Bool_t   Use_Splines_for_Eff_      = kTRUE;
 //const Int_t    NBIN_HIST_PLOT = 100;
 const Int_t    NBIN_HIST_HIGH = 10000;
 
+namespace {
+   ////////////////////////////////////////////////////////////////////////////////
+   /// adds to the nbins bins of the efficiency histogram hist the weights of
+   /// the events passing the cut of each bin, diff holding the weights of the
+   /// events by the last bin of which they pass the cut (sign > 0) or the
+   /// first one (sign < 0): the sums are cumulated from the last bin for
+   /// sign > 0 and from the first one for sign < 0
+
+   void AddCumulatedWeights(TH1 *hist, const std::vector<Double_t> &diff, Int_t nbins, Int_t sign)
+   {
+      Double_t sum = 0;
+      if (sign > 0) {
+         for (Int_t ibin=nbins; ibin>=1; ibin--) {
+            sum += diff[ibin];
+            hist->AddBinContent( ibin, sum );
+         }
+      } else {
+         for (Int_t ibin=1; ibin<=nbins; ibin++) {
+            sum += diff[ibin];
+            hist->AddBinContent( ibin, sum );
+         }
+      }
+   }
+}
+
 #ifdef _WIN32
 /* Disable warning C4355: 'this' : used in base member initializer list */
 #pragma warning ( disable : 4355 )
@@ -2274,7 +2299,10 @@ Double_t TMVA::MethodBase::GetEfficiency( const TString& theString, Types::ETree
       // sign if cut
       Int_t sign = (fCutOrientation == kPositive) ? +1 : -1;
 
-      // this method is unbinned
+      // this method is unbinned; the weight of each event is added to the
+      // first (last) bin of which it passes the cut, the efficiencies being
+      // cumulated at the end
+      std::vector<Double_t> diffS(fNbinsH+2, 0.), diffB(fNbinsH+2, 0.);
       nevtS = 0;
       for (UInt_t ievt=0; ievt<Data()->GetNEvents(); ievt++) {
 
@@ -2285,6 +2313,7 @@ Double_t TMVA::MethodBase::GetEfficiency( const TString& theString, Types::ETree
 
          // select histogram depending on if sig or bgd
          TH1* theHist = isSignal ? eff_s : eff_b;
+         std::vector<Double_t> &diff = isSignal ? diffS : diffB;
 
          // count signal and background events in tree
          if (isSignal) nevtS+=theWeight;
@@ -2296,13 +2325,12 @@ Double_t TMVA::MethodBase::GetEfficiency( const TString& theString, Types::ETree
          if (sign > 0 && maxbin < 1      ) maxbin = 1;
          if (sign < 0 && maxbin > fNbinsH) maxbin = fNbinsH;
 
-         if (sign > 0)
-            for (Int_t ibin=1; ibin<=maxbin; ibin++) theHist->AddBinContent( ibin , theWeight);
-         else if (sign < 0)
-            for (Int_t ibin=maxbin+1; ibin<=fNbinsH; ibin++) theHist->AddBinContent( ibin , theWeight );
-         else
-            Log() << kFATAL <<Form("Dataset[%s] : ",DataInfo().GetName())<< "<GetEfficiency> Mismatch in sign" << Endl;
+         // bins 1 to maxbin for sign > 0, maxbin+1 to fNbinsH for sign < 0
+         if (sign > 0) diff[maxbin]   += theWeight;
+         else          diff[maxbin+1] += theWeight;
       }
+      AddCumulatedWeights( eff_s, diffS, fNbinsH, sign );
+      AddCumulatedWeights( eff_b, diffB, fNbinsH, sign );
 
       // renormalise maximum to <=1
       // eff_s->Scale( 1.0/TMath::Max(1.,eff_s->GetMaximum()) );
@@ -2520,7 +2548,9 @@ Double_t TMVA::MethodBase::GetTrainingEfficiency(const TString& theString)
       std::vector<Double_t> mvaValues = GetMvaValues(0,Data()->GetNEvents());
       assert( (Long64_t) mvaValues.size() == Data()->GetNEvents()); 
 
-      // this method is unbinned
+      // this method is unbinned; the efficiencies are cumulated at the end,
+      // as in GetEfficiency
+      std::vector<Double_t> diffS(fNbinsH+2, 0.), diffB(fNbinsH+2, 0.);
       for (Int_t ievt=0; ievt<Data()->GetNEvents(); ievt++) {
 
          Data()->SetCurrentEvent(ievt);
@@ -2531,6 +2561,7 @@ Double_t TMVA::MethodBase::GetTrainingEfficiency(const TString& theString)
 
          TH1* theEffHist = DataInfo().IsSignal(ev) ? mva_eff_tr_s : mva_eff_tr_b;
          TH1* theClsHist = DataInfo().IsSignal(ev) ? mva_s_tr : mva_b_tr;
+         std::vector<Double_t> &diff = DataInfo().IsSignal(ev) ? diffS : diffB;
 
          theClsHist->Fill( theVal, theWeight );
 
@@ -2541,9 +2572,11 @@ Double_t TMVA::MethodBase::GetTrainingEfficiency(const TString& theString)
          if (sign > 0 && maxbin < 1      ) maxbin = 1;
          if (sign < 0 && maxbin > fNbinsH) maxbin = fNbinsH;
 
-         if (sign > 0) for (Int_t ibin=1;        ibin<=maxbin;  ibin++) theEffHist->AddBinContent( ibin , theWeight );
-         else          for (Int_t ibin=maxbin+1; ibin<=fNbinsH; ibin++) theEffHist->AddBinContent( ibin , theWeight );
+         if (sign > 0) diff[maxbin]   += theWeight;
+         else          diff[maxbin+1] += theWeight;
       }
+      AddCumulatedWeights( mva_eff_tr_s, diffS, fNbinsH, sign );
+      AddCumulatedWeights( mva_eff_tr_b, diffB, fNbinsH, sign );
 
       // normalise output distributions
       // uncomment those (and several others if you want unnormalized output
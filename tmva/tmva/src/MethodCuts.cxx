@@ -125,6 +125,11 @@
 #include "TGraph.h"
 #include "TSpline.h"
 #include "TRandom3.h"
+#include "TROOT.h"
+#include "ROOT/TSeq.hxx"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 
 #include <cstdlib>
 #include <iostream>
@@ -890,6 +895,44 @@ Double_t TMVA::MethodCuts::EstimatorFunction( std::vector<Double_t>& pars )
    return ComputeEstimator( pars );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// estimators of a whole population of the GA: the efficiencies of the
+/// cuts only read the binary search trees or the PDFs, and are computed in
+/// parallel with the implicit multi-threading; the estimators, which update
+/// the best cuts found so far, are then computed in the order of the
+/// parameters, so that the result is the same as in sequence
+
+void TMVA::MethodCuts::EstimatorFunctions( const std::vector<std::vector<Double_t>*>& parameters,
+                                           std::vector<Double_t>& estimators )
+{
+   const UInt_t npars = parameters.size();
+   std::vector<Double_t> effS( npars, 0. ), effB( npars, 0. );
+   auto computeEffs = [&](UInt_t i) {
+      std::vector<Double_t> cutMin( GetNvar() ), cutMax( GetNvar() );
+      this->MatchParsToCuts( *parameters[i], &cutMin[0], &cutMax[0] );
+      if (fEffMethod == kUsePDFs)
+         this->GetEffsfromPDFs      ( &cutMin[0], &cutMax[0], effS[i], effB[i] );
+      else
+         this->GetEffsfromSelection ( &cutMin[0], &cutMax[0], effS[i], effB[i] );
+   };
+
+#ifdef R__USE_IMT
+   if (npars > 1 && ROOT::IsImplicitMTEnabled()) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(computeEffs, ROOT::TSeqU(npars));
+   } else
+#endif
+   {
+      for (UInt_t i = 0; i < npars; ++i) computeEffs(i);
+   }
+
+   estimators.resize( npars );
+   for (UInt_t i = 0; i < npars; ++i) {
+      this->MatchParsToCuts( *parameters[i], &fTmpCutMin[0], &fTmpCutMax[0] );
+      estimators[i] = ComputeEstimatorFromEffs( effS[i], effB[i] );
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// returns estimator for "cut fitness" used by GA
 /// there are two requirements:
@@ -919,6 +962,15 @@ Double_t TMVA::MethodCuts::ComputeEstimator( std::vector<Double_t>& pars )
       this->GetEffsfromSelection (&fTmpCutMin[0], &fTmpCutMax[0], effS, effB);
    }
 
+   return ComputeEstimatorFromEffs( effS, effB );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// estimator of the cuts in fTmpCutMin and fTmpCutMax, of efficiencies effS
+/// and effB; updates the best cuts found so far
+
+Double_t TMVA::MethodCuts::ComputeEstimatorFromEffs( Double_t effS, Double_t effB )
+{
    Double_t eta = 0;      
    
    // test for a estimator function which optimizes on the whole background-rejection signal-efficiency plot
@@ -78,6 +78,7 @@ TMVA::MethodDNN::MethodDNN(const TString& jobName,
    : MethodBase( jobName, Types::kDNN, methodTitle, theData, theOption),
      fWeightInitialization(), fOutputFunction(), fLayoutString(), fErrorStrategy(),
      fTrainingStrategyString(), fWeightInitializationString(), fArchitectureString(),
+     fPrecisionString(),
      fTrainingSettings(), fResume(false), fSettings()
 {
    // standard constructor
@@ -89,6 +90,7 @@ TMVA::MethodDNN::MethodDNN(DataSetInfo& theData,
     : MethodBase( Types::kDNN, theData, theWeightFile),
      fWeightInitialization(), fOutputFunction(), fLayoutString(), fErrorStrategy(),
      fTrainingStrategyString(), fWeightInitializationString(), fArchitectureString(),
+     fPrecisionString(),
      fTrainingSettings(), fResume(false), fSettings()
 {
    // constructor from a weight file
@@ -156,6 +158,14 @@ void TMVA::MethodDNN::DeclareOptions()
    AddPreDefVal(TString("GPU"));
    AddPreDefVal(TString("OPENCL"));
 
+   DeclareOptionRef(fPrecisionString="SINGLE",
+                    "Precision",
+                    "Floating point precision of the training on the CPU and GPU"
+                    " architectures. The weights are always stored in double"
+                    " precision.");
+   AddPreDefVal(TString("SINGLE"));
+   AddPreDefVal(TString("DOUBLE"));
+
    DeclareOptionRef(
        fTrainingStrategyString = "LearningRate=1e-1,"
                                  "Momentum=0.3,"
@@ -516,8 +526,14 @@ void TMVA::MethodDNN::Train()
       fIPyMaxIter = 100;
    }
 
+   bool doublePrecision = (fPrecisionString == "DOUBLE");
+
    if (fArchitectureString == "GPU") {
-       TrainGpu();
+       if (doublePrecision) {
+          TrainGpu<Double_t>();
+       } else {
+          TrainGpu<Float_t>();
+       }
        if (!fExitFromTraining) fIPyMaxIter = fIPyCurrentIter;
        ExitFromTraining();
        return;
@@ -525,7 +541,11 @@ void TMVA::MethodDNN::Train()
       Log() << kFATAL << "OpenCL backend not yes supported." << Endl;
       return;
    } else if (fArchitectureString == "CPU") {
-      TrainCpu();
+      if (doublePrecision) {
+         TrainCpu<Double_t>();
+      } else {
+         TrainCpu<Float_t>();
+      }
       if (!fExitFromTraining) fIPyMaxIter = fIPyCurrentIter;
       ExitFromTraining();
       return;
@@ -726,6 +746,7 @@ void TMVA::MethodDNN::Train()
 }
 
 //______________________________________________________________________________
+template <typename AReal>
 void TMVA::MethodDNN::TrainGpu()
 {
 
@@ -734,7 +755,9 @@ void TMVA::MethodDNN::TrainGpu()
    size_t nTrainingSamples = GetEventCollection(Types::kTraining).size();
    size_t nTestSamples     = GetEventCollection(Types::kTesting).size();
 
-   Log() << kINFO << "Start of neural network training on GPU." << Endl;
+   Log() << kINFO << "Start of neural network training on GPU in "
+         << ((sizeof(AReal) == sizeof(Double_t)) ? "double" : "single")
+         << " precision." << Endl;
 
    size_t trainingPhase = 1;
    fNet.Initialize(fWeightInitialization);
@@ -744,7 +767,7 @@ void TMVA::MethodDNN::TrainGpu()
          fInteractive->ClearGraphs();
       }
 
-      TNet<TCuda<>> net(settings.batchSize, fNet);
+      TNet<TCuda<AReal>> net(settings.batchSize, fNet);
       net.SetWeightDecay(settings.weightDecay);
       net.SetRegularization(settings.regularization);
 
@@ -763,25 +786,28 @@ void TMVA::MethodDNN::TrainGpu()
             << fTrainingSettings.size() << ":" << Endl;
       trainingPhase++;
 
-      using DataLoader_t = TDataLoader<TMVAInput_t, TCuda<>>;
+      using DataLoader_t = TDataLoader<TMVAInput_t, TCuda<AReal>>;
 
-      size_t nThreads = 1;
+      // Prepare the next batch in the background while the current one is
+      // processed.
+      size_t nThreads  = 1;
+      size_t nPrefetch = 1;
       DataLoader_t trainingData(GetEventCollection(Types::kTraining),
                                 nTrainingSamples,
                                 net.GetBatchSize(),
                                 net.GetInputWidth(),
-                                net.GetOutputWidth(), nThreads);
+                                net.GetOutputWidth(), nThreads, nPrefetch);
       DataLoader_t testData(GetEventCollection(Types::kTesting),
                             nTestSamples,
                             testNet.GetBatchSize(),
                             net.GetInputWidth(),
-                            net.GetOutputWidth(), nThreads);
-      DNN::TGradientDescent<TCuda<>> minimizer(settings.learningRate,
+                            net.GetOutputWidth(), nThreads, nPrefetch);
+      DNN::TGradientDescent<TCuda<AReal>> minimizer(settings.learningRate,
                                              settings.convergenceSteps,
                                              settings.testInterval);
 
-      std::vector<TNet<TCuda<>>> nets{};
-      std::vector<TBatch<TCuda<>>> batches{};
+      std::vector<TNet<TCuda<AReal>>> nets{};
+      std::vector<TBatch<TCuda<AReal>>> batches{};
       nets.reserve(nThreads);
       for (size_t i = 0; i < nThreads; i++) {
          nets.push_back(net);
@@ -789,9 +815,9 @@ void TMVA::MethodDNN::TrainGpu()
          {
             auto &masterLayer = net.GetLayer(j);
             auto &layer = nets.back().GetLayer(j);
-            TCuda<>::Copy(layer.GetWeights(),
+            TCuda<AReal>::Copy(layer.GetWeights(),
                           masterLayer.GetWeights());
-            TCuda<>::Copy(layer.GetBiases(),
+            TCuda<AReal>::Copy(layer.GetBiases(),
                           masterLayer.GetBiases());
          }
       }
@@ -895,6 +921,7 @@ void TMVA::MethodDNN::TrainGpu()
 }
 
 //______________________________________________________________________________
+template <typename AReal>
 void TMVA::MethodDNN::TrainCpu()
 {
 
@@ -903,7 +930,9 @@ void TMVA::MethodDNN::TrainCpu()
    size_t nTrainingSamples = GetEventCollection(Types::kTraining).size();
    size_t nTestSamples     = GetEventCollection(Types::kTesting).size();
 
-   Log() << kINFO << "Start of neural network training on CPU." << Endl << Endl;
+   Log() << kINFO << "Start of neural network training on CPU in "
+         << ((sizeof(AReal) == sizeof(Double_t)) ? "double" : "single")
+         << " precision." << Endl << Endl;
 
    fNet.Initialize(fWeightInitialization);
 
@@ -918,7 +947,7 @@ void TMVA::MethodDNN::TrainCpu()
             << fTrainingSettings.size() << ":" << Endl;
       trainingPhase++;
 
-      TNet<TCpu<>> net(settings.batchSize, fNet);
+      TNet<TCpu<AReal>> net(settings.batchSize, fNet);
       net.SetWeightDecay(settings.weightDecay);
       net.SetRegularization(settings.regularization);
       // Need to convert dropoutprobabilities to conventions used
@@ -932,25 +961,28 @@ void TMVA::MethodDNN::TrainCpu()
       net.InitializeGradients();
       auto testNet = net.CreateClone(settings.batchSize);
 
-      using DataLoader_t = TDataLoader<TMVAInput_t, TCpu<>>;
+      using DataLoader_t = TDataLoader<TMVAInput_t, TCpu<AReal>>;
 
-      size_t nThreads = 1;
+      // Prepare the next batch in the background while the current one is
+      // processed.
+      size_t nThreads  = 1;
+      size_t nPrefetch = 1;
       DataLoader_t trainingData(GetEventCollection(Types::kTraining),
                                 nTrainingSamples,
                                 net.GetBatchSize(),
                                 net.GetInputWidth(),
-                                net.GetOutputWidth(), nThreads);
+                                net.GetOutputWidth(), nThreads, nPrefetch);
       DataLoader_t testData(GetEventCollection(Types::kTesting),
                             nTestSamples,
                             testNet.GetBatchSize(),
                             net.GetInputWidth(),
-                            net.GetOutputWidth(), nThreads);
-      DNN::TGradientDescent<TCpu<>> minimizer(settings.learningRate,
+                            net.GetOutputWidth(), nThreads, nPrefetch);
+      DNN::TGradientDescent<TCpu<AReal>> minimizer(settings.learningRate,
                                                settings.convergenceSteps,
                                                settings.testInterval);
 
-      std::vector<TNet<TCpu<>>>   nets{};
-      std::vector<TBatch<TCpu<>>> batches{};
+      std::vector<TNet<TCpu<AReal>>>   nets{};
+      std::vector<TBatch<TCpu<AReal>>> batches{};
       nets.reserve(nThreads);
       for (size_t i = 0; i < nThreads; i++) {
          nets.push_back(net);
@@ -958,9 +990,9 @@ void TMVA::MethodDNN::TrainCpu()
          {
             auto &masterLayer = net.GetLayer(j);
             auto &layer = nets.back().GetLayer(j);
-            TCpu<>::Copy(layer.GetWeights(),
+            TCpu<AReal>::Copy(layer.GetWeights(),
                           masterLayer.GetWeights());
-            TCpu<>::Copy(layer.GetBiases(),
+            TCpu<AReal>::Copy(layer.GetBiases(),
                           masterLayer.GetBiases());
          }
       }
@@ -42,6 +42,7 @@
 #include "TMVA/MethodBase.h"
 #include "TMVA/MsgLogger.h"
 #include "TMVA/Ranking.h"
+#include "TMVA/Timer.h"
 #include "TMVA/Tools.h"
 #include "TMVA/Types.h"
 
@@ -49,6 +50,7 @@
 #include "TMath.h"
 #include "TTree.h"
 
+#include <algorithm>
 #include <cmath>
 #include <string>
 #include <cstdlib>
@@ -292,20 +294,13 @@ void TMVA::MethodKNN::Train()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Compute classifier response
+/// The kNN event with the variables and the weight of the current event,
+/// and the type 3 of query events
 
-Double_t TMVA::MethodKNN::GetMvaValue( Double_t* err, Double_t* errUpper )
+const TMVA::kNN::Event TMVA::MethodKNN::GetkNNEvent() const
 {
-   // cannot determine error
-   NoErrorCalc(err, errUpper);
-
-   //
-   // Define local variables
-   //
    const Event *ev = GetEvent();
    const Int_t nvar = GetNVariables();
-   const Double_t weight = ev->GetWeight();
-   const UInt_t knn = static_cast<UInt_t>(fnkNN);
 
    kNN::VarVec vvec(static_cast<UInt_t>(nvar), 0.0);
    
@@ -313,13 +308,88 @@ Double_t TMVA::MethodKNN::GetMvaValue( Double_t* err, Double_t* errUpper )
       vvec[ivar] = ev->GetValue(ivar);
    }
 
+   return kNN::Event(vvec, ev->GetWeight(), 3);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute classifier response
+
+Double_t TMVA::MethodKNN::GetMvaValue( Double_t* err, Double_t* errUpper )
+{
+   // cannot determine error
+   NoErrorCalc(err, errUpper);
+
    // search for fnkNN+2 nearest neighbors, pad with two 
    // events to avoid Monte-Carlo events with zero distance
    // most of CPU time is spent in this recursive function
-   const kNN::Event event_knn(vvec, weight, 3);
-   fModule->Find(event_knn, knn + 2);
+   const kNN::Event event_knn = GetkNNEvent();
+   fModule->Find(event_knn, static_cast<UInt_t>(fnkNN) + 2, fkNNResult);
+
+   return ComputeMvaValue(event_knn, fkNNResult);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compute the classifier responses of the events firstEvt to lastEvt of the
+/// current data set. The nearest neighbors of blocks of events are searched
+/// together by ModulekNN, in parallel if implicit multi-threading is enabled;
+/// the values are identical to those of GetMvaValue
+
+std::vector<Double_t> TMVA::MethodKNN::GetMvaValues(Long64_t firstEvt, Long64_t lastEvt, Bool_t logProgress)
+{
+   Long64_t nEvents = Data()->GetNEvents();
+   if (firstEvt > lastEvt || lastEvt > nEvents) lastEvt = nEvents;
+   if (firstEvt < 0) firstEvt = 0;
+   std::vector<Double_t> values(lastEvt-firstEvt);
+   nEvents = values.size();
+
+   Timer timer( nEvents, GetName(), kTRUE );
+
+   if (logProgress)
+      Log() << kHEADER << Form("[%s] : ",DataInfo().GetName()) << "Evaluation of " << GetMethodName() << " on "
+            << (Data()->GetCurrentType()==Types::kTraining?"training":"testing") << " sample (" << nEvents << " events)" << Endl;
+
+   const Long64_t nblock = 1000;
+   const UInt_t knn = static_cast<UInt_t>(fnkNN);
+
+   kNN::EventVec events;
+   std::vector<kNN::ElemVec> results;
+   events.reserve(nblock);
+
+   for (Long64_t ifirst = firstEvt; ifirst < lastEvt; ifirst += nblock) {
+      const Long64_t ilast = std::min(ifirst + nblock, lastEvt);
+
+      events.clear();
+      for (Long64_t ievt = ifirst; ievt < ilast; ++ievt) {
+         Data()->SetCurrentEvent(ievt);
+         events.push_back(GetkNNEvent());
+      }
+
+      fModule->Find(events, knn + 2, results);
+
+      for (Long64_t ievt = ifirst; ievt < ilast; ++ievt) {
+         values[ievt-firstEvt] = ComputeMvaValue(events[ievt-ifirst], results[ievt-ifirst]);
+      }
+
+      // print progress
+      if (logProgress) timer.DrawProgressBar( ilast-firstEvt );
+   }
+   if (logProgress) {
+      Log() << kINFO
+            << "Elapsed time for evaluation of " << nEvents <<  " events: "
+            << timer.GetElapsedTime() << "       " << Endl;
+   }
+
+   return values;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Classifier response for the query event 'event_knn' from the list of its
+/// fnkNN+2 nearest neighbors 'rlist', sorted by distance
+
+Double_t TMVA::MethodKNN::ComputeMvaValue(const kNN::Event &event_knn, const kNN::ElemVec &rlist)
+{
+   const UInt_t knn = static_cast<UInt_t>(fnkNN);
 
-   const kNN::List &rlist = fModule->GetkNNList();
    if (rlist.size() != knn + 2) {
       Log() << kFATAL << "kNN result list is empty" << Endl;
       return -100.0;  
@@ -367,7 +437,7 @@ Double_t TMVA::MethodKNN::GetMvaValue( Double_t* err, Double_t* errUpper )
    UInt_t count_all = 0;
    Double_t weight_all = 0, weight_sig = 0, weight_bac = 0;
 
-   for (kNN::List::const_iterator lit = rlist.begin(); lit != rlist.end(); ++lit) {
+   for (kNN::ElemVec::const_iterator lit = rlist.begin(); lit != rlist.end(); ++lit) {
 
       // get reference to current node to make code more readable
       const kNN::Node<kNN::Event> &node = *(lit->first);
@@ -445,24 +515,15 @@ const std::vector< Float_t >& TMVA::MethodKNN::GetRegressionValues()
    //
    // Define local variables
    //
-   const Event *evt = GetEvent();
-   const Int_t nvar = GetNVariables();
    const UInt_t knn = static_cast<UInt_t>(fnkNN);
    std::vector<float> reg_vec;
 
-   kNN::VarVec vvec(static_cast<UInt_t>(nvar), 0.0);
-   
-   for (Int_t ivar = 0; ivar < nvar; ++ivar) {
-      vvec[ivar] = evt->GetValue(ivar);
-   }   
-
    // search for fnkNN+2 nearest neighbors, pad with two 
    // events to avoid Monte-Carlo events with zero distance
    // most of CPU time is spent in this recursive function
-   const kNN::Event event_knn(vvec, evt->GetWeight(), 3);
-   fModule->Find(event_knn, knn + 2);
+   fModule->Find(GetkNNEvent(), knn + 2, fkNNResult);
 
-   const kNN::List &rlist = fModule->GetkNNList();
+   const kNN::ElemVec &rlist = fkNNResult;
    if (rlist.size() != knn + 2) {
       Log() << kFATAL << "kNN result list is empty" << Endl;
       return *fRegressionReturnVal;
@@ -472,7 +533,7 @@ const std::vector< Float_t >& TMVA::MethodKNN::GetRegressionValues()
    Double_t weight_all = 0;
    UInt_t count_all = 0;
 
-   for (kNN::List::const_iterator lit = rlist.begin(); lit != rlist.end(); ++lit) {
+   for (kNN::ElemVec::const_iterator lit = rlist.begin(); lit != rlist.end(); ++lit) {
 
       // get reference to current node to make code more readable
       const kNN::Node<kNN::Event> &node = *(lit->first);
@@ -869,13 +930,13 @@ Double_t TMVA::MethodKNN::GausKernel(const kNN::Event &event_knn,
 /// Get polynomial kernel radius
 ///
 
-Double_t TMVA::MethodKNN::getKernelRadius(const kNN::List &rlist) const
+Double_t TMVA::MethodKNN::getKernelRadius(const kNN::ElemVec &rlist) const
 {
    Double_t kradius = -1.0;
    UInt_t kcount = 0;
    const UInt_t knn = static_cast<UInt_t>(fnkNN);
 
-   for (kNN::List::const_iterator lit = rlist.begin(); lit != rlist.end(); ++lit)
+   for (kNN::ElemVec::const_iterator lit = rlist.begin(); lit != rlist.end(); ++lit)
       {
          if (!(lit->second > 0.0)) continue;         
       
@@ -893,13 +954,13 @@ Double_t TMVA::MethodKNN::getKernelRadius(const kNN::List &rlist) const
 /// Get polynomial kernel radius
 ///
 
-const std::vector<Double_t> TMVA::MethodKNN::getRMS(const kNN::List &rlist, const kNN::Event &event_knn) const
+const std::vector<Double_t> TMVA::MethodKNN::getRMS(const kNN::ElemVec &rlist, const kNN::Event &event_knn) const
 {
    std::vector<Double_t> rvec;
    UInt_t kcount = 0;
    const UInt_t knn = static_cast<UInt_t>(fnkNN);
 
-   for (kNN::List::const_iterator lit = rlist.begin(); lit != rlist.end(); ++lit)
+   for (kNN::ElemVec::const_iterator lit = rlist.begin(); lit != rlist.end(); ++lit)
       {
          if (!(lit->second > 0.0)) continue;         
       
@@ -945,11 +1006,11 @@ const std::vector<Double_t> TMVA::MethodKNN::getRMS(const kNN::List &rlist, cons
 
 ////////////////////////////////////////////////////////////////////////////////
 
-Double_t TMVA::MethodKNN::getLDAValue(const kNN::List &rlist, const kNN::Event &event_knn)
+Double_t TMVA::MethodKNN::getLDAValue(const kNN::ElemVec &rlist, const kNN::Event &event_knn)
 {
    LDAEvents sig_vec, bac_vec;
 
-   for (kNN::List::const_iterator lit = rlist.begin(); lit != rlist.end(); ++lit) {
+   for (kNN::ElemVec::const_iterator lit = rlist.begin(); lit != rlist.end(); ++lit) {
        
       // get reference to current node to make code more readable
       const kNN::Node<kNN::Event> &node = *(lit->first);
@@ -103,6 +103,7 @@ ClassImp(TMVA::MethodSVM)
    , fCost(0)
    , fTolerance(0)
    , fMaxIter(0)
+   , fKernelCacheSize(0)
    , fNSubSets(0)
    , fBparm(0)
    , fGamma(0)
@@ -138,6 +139,7 @@ TMVA::MethodSVM::MethodSVM( DataSetInfo& theData, const TString& theWeightFile)
    , fCost(0)
    , fTolerance(0)
    , fMaxIter(0)
+   , fKernelCacheSize(0)
    , fNSubSets(0)
    , fBparm(0)
    , fGamma(0)
@@ -252,6 +254,8 @@ void TMVA::MethodSVM::DeclareOptions()
    }
    DeclareOptionRef( fTolerance = 0.01, "Tol",      "Tolerance parameter" );  //should be fixed
    DeclareOptionRef( fMaxIter   = 1000, "MaxIter",  "Maximum number of training loops" );
+   DeclareOptionRef( fKernelCacheSize = 0, "KernelCacheSize",
+                     "Memory budget in MB of the cache of kernel matrix rows (0: keep the full matrix)" );
 
 }
 
@@ -379,7 +383,7 @@ void TMVA::MethodSVM::Train()
 
    Log()<< kINFO << "Building SVM Working Set...with "<<fInputData->size()<<" event instances"<< Endl;
    Timer bldwstime( GetName());
-   fWgSet = new SVWorkingSet( fInputData, fSVKernelFunction,fTolerance, DoRegression() );
+   fWgSet = new SVWorkingSet( fInputData, fSVKernelFunction,fTolerance, DoRegression(), fKernelCacheSize );
    Log() << kINFO <<"Elapsed time for Working Set build: "<< bldwstime.GetElapsedTime()<<Endl;
 
    // timing
@@ -31,6 +31,11 @@
 #include "ThreadLocalStorage.h"
 #include "TMath.h"
 #include "TRandom3.h"
+#include "TROOT.h"
+#include "ROOT/TSeq.hxx"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 
 #include <assert.h>
 #include <iomanip>
@@ -194,6 +199,8 @@ void TMVA::kNN::ModulekNN::Clear()
       fTree = 0;
    }
 
+   fFlatTree.clear();
+   fFlatVars.clear();
    fVarScale.clear();
    fCount.clear();
    fEvent.clear();
@@ -330,9 +337,52 @@ Bool_t TMVA::kNN::ModulekNN::Fill(const UShort_t odepth, const UInt_t ifrac, con
             << it->second << " events" << Endl;
    }
 
+   // flattened copy of the tree for the neighbor search
+   fFlatTree.clear();
+   fFlatVars.clear();
+   fFlatTree.reserve(fEvent.size());
+   fFlatVars.reserve(fEvent.size()*fDimn);
+   Flatten(fTree);
+
    return kTRUE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// append 'node' and its children in depth-first order to the flattened tree
+/// and return the position of 'node'
+
+Int_t TMVA::kNN::ModulekNN::Flatten(const Node<Event> *node)
+{
+   const Int_t inode = fFlatTree.size();
+
+   FlatNode flat;
+   flat.fVarDis = node->GetVarDis();
+   flat.fVarMin = node->GetVarMin();
+   flat.fVarMax = node->GetVarMax();
+   flat.fMod    = node->GetMod();
+   flat.fNodeL  = -1;
+   flat.fNodeR  = -1;
+   flat.fWeight = node->GetWeight();
+   flat.fNode   = node;
+   fFlatTree.push_back(flat);
+
+   const Event &event = node->GetEvent();
+   for (UInt_t ivar = 0; ivar < fDimn; ++ivar) {
+      fFlatVars.push_back(ivar < event.GetNVar() ? event.GetVar(ivar) : 0.0);
+   }
+
+   if (node->GetNodeL()) {
+      const Int_t inodeL = Flatten(node->GetNodeL());
+      fFlatTree[inode].fNodeL = inodeL;
+   }
+   if (node->GetNodeR()) {
+      const Int_t inodeR = Flatten(node->GetNodeR());
+      fFlatTree[inode].fNodeR = inodeR;
+   }
+
+   return inode;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// find in tree
 /// if tree has been filled then search for nfind closest events
@@ -619,6 +669,194 @@ void TMVA::kNN::ModulekNN::ComputeMetric(const UInt_t ifrac)
 /// scale each event variable so that rms of variables is approximately 1.0
 /// this allows comparisons of variables with distinct scales and units
 
+////////////////////////////////////////////////////////////////////////////////
+/// check that the tree exists and that a query with 'nvar' variables for
+/// 'nfind' neighbors is valid
+
+Bool_t TMVA::kNN::ModulekNN::CheckQuery(const UInt_t nvar, const UInt_t nfind) const
+{
+   if (!fTree || fFlatTree.empty()) {
+      Log() << kFATAL << "ModulekNN::Find() - tree has not been filled" << Endl;
+      return kFALSE;
+   }
+   if (fDimn != nvar) {
+      Log() << kFATAL << "ModulekNN::Find() - number of dimension does not match training events" << Endl;
+      return kFALSE;
+   }
+   if (nfind < 1) {
+      Log() << kFATAL << "ModulekNN::Find() - requested 0 nearest neighbors" << Endl;
+      return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// copy the variables of 'event' to 'vars', rescaled as by Scale()
+
+void TMVA::kNN::ModulekNN::ScaleVars(const Event &event, VarType *vars) const
+{
+   if (fVarScale.empty()) {
+      for (UInt_t ivar = 0; ivar < fDimn; ++ivar) {
+         vars[ivar] = event.GetVar(ivar);
+      }
+      return;
+   }
+
+   for (UInt_t ivar = 0; ivar < fDimn; ++ivar) {
+      vars[ivar] = 0.0;
+
+      std::map<int, Double_t>::const_iterator fit = fVarScale.find(ivar);
+      if (fit == fVarScale.end()) {
+         Log() << kFATAL << "ModulekNN::Scale() - failed to find scale for " << ivar << Endl;
+         continue;
+      }
+
+      if (fit->second > 0.0) {
+         vars[ivar] = event.GetVar(ivar)/fit->second;
+      }
+      else {
+         Log() << kFATAL << "Variable " << ivar << " has zero width" << Endl;
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Search the flattened tree below node 'inode' for the nfind nearest
+/// neighbors of the event with the (scaled) variables 'vars'. 'result' holds
+/// at most nfind neighbors sorted by distance, neighbors at equal distance in
+/// the order in which they were found, and is never reallocated if it has
+/// the capacity for nfind neighbors. The search visits the nodes in the same
+/// order and applies the same cuts as the recursive kNN::Find() on the kd-tree,
+/// hence the neighbors are the same.
+
+void TMVA::kNN::ModulekNN::FindFlat(const Int_t inode, const VarType *vars, const UInt_t nfind, ElemVec &result) const
+{
+   const FlatNode &node = fFlatTree[inode];
+   const VarType value = vars[node.fMod];
+
+   if (node.fWeight > 0.0) {
+
+      VarType max_dist = 0.0;
+
+      if (!result.empty()) {
+
+         max_dist = result.back().second;
+
+         if (result.size() == nfind) {
+            if (value > node.fVarMax) {
+               const VarType dmax = node.fVarMax - value;
+               if (dmax*dmax > max_dist) return;
+            }
+            if (value < node.fVarMin) {
+               const VarType dmin = node.fVarMin - value;
+               if (dmin*dmin > max_dist) return;
+            }
+         }
+      }
+
+      const VarType *nvars = &fFlatVars[inode*fDimn];
+      VarType distance = 0.0;
+      for (UInt_t ivar = 0; ivar < fDimn; ++ivar) {
+         const VarType diff = nvars[ivar] - vars[ivar];
+         distance += diff*diff;
+      }
+
+      if (result.size() < nfind || distance < max_dist) {
+         if (result.size() == nfind) {
+            result.pop_back();
+         }
+
+         // insert after the neighbors at smaller or equal distance
+         ElemVec::iterator lit = result.begin();
+         for (; lit != result.end(); ++lit) {
+            if (distance < lit->second) break;
+         }
+         result.insert(lit, Elem(node.fNode, distance));
+      }
+   }
+
+   if (node.fNodeL >= 0 && node.fNodeR >= 0) {
+      if (value < node.fVarDis) {
+         FindFlat(node.fNodeL, vars, nfind, result);
+         FindFlat(node.fNodeR, vars, nfind, result);
+      }
+      else {
+         FindFlat(node.fNodeR, vars, nfind, result);
+         FindFlat(node.fNodeL, vars, nfind, result);
+      }
+   }
+   else {
+      if (node.fNodeL >= 0) {
+         FindFlat(node.fNodeL, vars, nfind, result);
+      }
+      if (node.fNodeR >= 0) {
+         FindFlat(node.fNodeR, vars, nfind, result);
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// find the nfind nearest neighbors of 'event'; the module is not modified
+
+Bool_t TMVA::kNN::ModulekNN::Find(const Event &event, const UInt_t nfind, ElemVec &result) const
+{
+   result.clear();
+   if (!CheckQuery(event.GetNVar(), nfind)) {
+      return kFALSE;
+   }
+
+   std::vector<VarType> vars(fDimn);
+   ScaleVars(event, &vars[0]);
+
+   result.reserve(nfind);
+   FindFlat(0, &vars[0], nfind, result);
+
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// find the nfind nearest neighbors of each of 'events'. The searches run in
+/// parallel if implicit multi-threading is enabled. The vectors of 'results'
+/// are reused, so that no memory is allocated when the same vectors are
+/// passed again
+
+Bool_t TMVA::kNN::ModulekNN::Find(const EventVec &events, const UInt_t nfind, std::vector<ElemVec> &results) const
+{
+   results.resize(events.size());
+   for (UInt_t i = 0; i < events.size(); ++i) {
+      results[i].clear();
+      if (!CheckQuery(events[i].GetNVar(), nfind)) {
+         return kFALSE;
+      }
+   }
+   if (events.empty()) {
+      return kTRUE;
+   }
+
+   std::vector<VarType> vars(events.size()*fDimn);
+   for (UInt_t i = 0; i < events.size(); ++i) {
+      ScaleVars(events[i], &vars[i*fDimn]);
+   }
+
+   auto findEvent = [&](UInt_t i) {
+      results[i].reserve(nfind);
+      FindFlat(0, &vars[i*fDimn], nfind, results[i]);
+   };
+
+#ifdef R__USE_IMT
+   if (events.size() > 1 && ROOT::IsImplicitMTEnabled()) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(findEvent, ROOT::TSeqU(events.size()));
+      return kTRUE;
+   }
+#endif
+   for (UInt_t i = 0; i < events.size(); ++i) {
+      findEvent(i);
+   }
+
+   return kTRUE;
+}
+
 const TMVA::kNN::Event TMVA::kNN::ModulekNN::Scale(const Event &event) const
 {
    if (fVarScale.empty()) {
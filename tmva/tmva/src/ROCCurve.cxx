@@ -39,24 +39,86 @@
 #include "TGraph.h"
 #endif
 
-#include<vector>
+#include "TMath.h"
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#include "TROOT.h"
+#endif
+
+#include <algorithm>
+#include <vector>
 #include <cassert>
 
 using namespace std;
 
+////////////////////////////////////////////////////////////////////////////////
+/// constructor from the MVA values of the events and whether they are
+/// signal events. The histograms cover the range of the values, with nbins
+/// bins. Large numbers of events are histogrammed in parallel when the
+/// implicit multi-threading is enabled. The values are not kept.
 
-TMVA::ROCCurve::ROCCurve(const std::vector<Float_t> & mva, const std::vector<Bool_t> & mvat) :
-   fLogger ( new TMVA::MsgLogger("ROCCurve") ),fGraph(NULL)
+TMVA::ROCCurve::ROCCurve(const std::vector<Float_t> & mva, const std::vector<Bool_t> & mvat, UInt_t nbins) :
+   fLogger ( new TMVA::MsgLogger("ROCCurve") ),fGraph(NULL),
+   fXmin(0), fXmax(1), fNBins(TMath::Max(nbins, 1u)),
+   fHistS(fNBins+2, 0.), fHistB(fNBins+2, 0.)
 {
    assert(mva.size() == mvat.size() );
-   for(UInt_t i=0;i<mva.size();i++)
-   {
-      if(mvat[i] ) fMvaS.push_back(mva[i]);
-      else fMvaB.push_back(mva[i]);
+   if (!mva.empty()) {
+      std::pair<std::vector<Float_t>::const_iterator, std::vector<Float_t>::const_iterator> range =
+         std::minmax_element(mva.begin(), mva.end());
+      fXmin = *range.first;
+      fXmax = *range.second;
+   }
+   // the largest value belongs to the last bin
+   if (fXmax > fXmin) fXmax += 1.E-6*(fXmax - fXmin);
+   else               fXmax = fXmin + 1;
+
+   const UInt_t n = mva.size();
+   auto fill = [&](UInt_t first, UInt_t last, Double_t *histS, Double_t *histB) {
+      for (UInt_t i = first; i < last; i++) {
+         if (mvat[i]) histS[FindBin(mva[i])] += 1;
+         else         histB[FindBin(mva[i])] += 1;
+      }
+   };
+
+#ifdef R__USE_IMT
+   // the number of tasks does not depend on the number of threads, and the
+   // counts are added exactly
+   const UInt_t ntasks = TMath::Min(16u, n/(1u << 16));
+   if (ntasks > 1 && ROOT::IsImplicitMTEnabled()) {
+      const UInt_t nb = fNBins+2;
+      const UInt_t step = (n + ntasks - 1)/ntasks;
+      std::vector<Double_t> hists(2*(size_t)ntasks*nb, 0.);
+      ROOT::TThreadExecutor pool;
+      pool.Foreach([&](UInt_t t) {
+         Double_t *h = &hists[2*(size_t)t*nb];
+         fill(t*step, TMath::Min(n, (t+1)*step), h, h+nb);
+      }, ROOT::TSeqU(ntasks));
+      for (UInt_t t = 0; t < ntasks; t++) {
+         const Double_t *h = &hists[2*(size_t)t*nb];
+         for (UInt_t bin = 0; bin < nb; bin++) {
+            fHistS[bin] += h[bin];
+            fHistB[bin] += h[nb+bin];
+         }
+      }
+      return;
    }
+#endif
+   fill(0, n, &fHistS[0], &fHistB[0]);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// constructor of empty histograms of nbins bins between xmin and xmax, to
+/// be filled event by event with Fill. The values outside of the range are
+/// counted below (resp. above) every cut.
 
+TMVA::ROCCurve::ROCCurve(Double_t xmin, Double_t xmax, UInt_t nbins) :
+   fLogger ( new TMVA::MsgLogger("ROCCurve") ),fGraph(NULL),
+   fXmin(xmin), fXmax(xmax > xmin ? xmax : xmin + 1), fNBins(TMath::Max(nbins, 1u)),
+   fHistS(fNBins+2, 0.), fHistB(fNBins+2, 0.)
+{
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 /// destructor
@@ -65,107 +127,168 @@ TMVA::ROCCurve::~ROCCurve() {
    delete fLogger;
    if(fGraph) delete fGraph;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+/// bin of a MVA value, 0 below the range and fNBins+1 above it
+
+Int_t TMVA::ROCCurve::FindBin(Float_t mva) const
+{
+   if (mva < fXmin) return 0;
+   if (!(mva < fXmax)) return fNBins+1;   // NaN is an overflow
+   Int_t bin = 1 + Int_t(fNBins*(mva - fXmin)/(fXmax - fXmin));
+   return TMath::Min(bin, (Int_t)fNBins);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// add the MVA value of an event
+
+void TMVA::ROCCurve::Fill(Float_t mva, Bool_t isSignal, Double_t weight)
+{
+   if (isSignal) fHistS[FindBin(mva)] += weight;
+   else          fHistB[FindBin(mva)] += weight;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// add the histograms of another ROC curve, of the same binning
+
+void TMVA::ROCCurve::Add(const ROCCurve &other)
+{
+   if (other.fNBins != fNBins || other.fXmin != fXmin || other.fXmax != fXmax) {
+      Log() << kERROR << "<Add> Cannot add ROC curves of different binnings" << Endl;
+      return;
+   }
+   for (UInt_t bin = 0; bin < fNBins+2; bin++) {
+      fHistS[bin] += other.fHistS[bin];
+      fHistB[bin] += other.fHistB[bin];
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// fraction of the weights of hist, of sum sum, below cut, the values of a
+/// bin being taken as uniformly distributed in the bin
+
+Double_t TMVA::ROCCurve::GetFractionBelow(const std::vector<Double_t> &hist, Double_t sum, Double_t cut) const
+{
+   if (sum <= 0 || cut < fXmin) return 0;
+   if (cut >= fXmax) return (sum - hist[fNBins+1])/sum;
+   Double_t t = fNBins*(cut - fXmin)/(fXmax - fXmin);
+   Int_t k = TMath::Min(Int_t(t), (Int_t)fNBins - 1);
+   Double_t below = 0;
+   for (Int_t bin = 0; bin <= k; bin++) below += hist[bin];
+   below += (t - k)*hist[k+1];
+   return below/sum;
+}
       
 ////////////////////////////////////////////////////////////////////////////////
-/// ROC Integral (AUC)
+/// ROC Integral (AUC), the area below the background rejection versus the
+/// signal efficiency, computed from the histograms of the MVA values. The
+/// events of the same bin are counted as half above and half below each
+/// other, so that the integral differs from the one of the exact ROC curve
+/// by at most GetROCIntegralError().
 
 Double_t TMVA::ROCCurve::GetROCIntegral(){
   
-  Float_t integral=0;
-  int ndivisions = 40;
-  fEpsilonSig.push_back(0);
-  fEpsilonBgk.push_back(0);
-
-  Float_t epsilon_s = 0.0;
-  Float_t epsilon_b = 0.0;
-
-  for(Float_t i=-1.0;i<1.0;i+=(1.0/ndivisions))
-  {
-      Float_t acounter = 0.0;
-      Float_t bcounter = 0.0;
-      Float_t ccounter = 0.0;
-      Float_t dcounter = 0.0;
-      
-      for(UInt_t j=0;j<fMvaS.size();j++)
-      {
-        if(fMvaS[j] > i) acounter++;
-        else            bcounter++;
-	
-        if(fMvaB[j] > i) ccounter++;
-        else            dcounter++;
-      }
-      
-      if(acounter != 0 || bcounter != 0)
-      {
-	epsilon_s = 1.0*bcounter/(acounter+bcounter);
-      }
-      fEpsilonSig.push_back(epsilon_s);
-      
-      if(ccounter != 0 || dcounter != 0)
-      {
-	epsilon_b = 1.0*dcounter/(ccounter+dcounter);
-      }
-      fEpsilonBgk.push_back(epsilon_b);
-  }
-  fEpsilonSig.push_back(1.0);
-  fEpsilonBgk.push_back(1.0);
-  for(UInt_t i=0;i<fEpsilonSig.size()-1;i++)
-  {
-      integral += 0.5*(fEpsilonSig[i+1]-fEpsilonSig[i])*(fEpsilonBgk[i]+fEpsilonBgk[i+1]);
-  }
+   Double_t sumS = 0, sumB = 0;
+   for (UInt_t bin = 0; bin < fNBins+2; bin++) {
+      sumS += fHistS[bin];
+      sumB += fHistB[bin];
+   }
+   if (sumS <= 0 || sumB <= 0) return 0;
+
+   // sum over the bins of the signal fraction times the background fraction
+   // below it
+   Double_t integral = 0, belowB = 0;
+   for (UInt_t bin = 0; bin < fNBins+2; bin++) {
+      Double_t s = fHistS[bin]/sumS;
+      Double_t b = fHistB[bin]/sumB;
+      integral += s*(belowB + 0.5*b);
+      belowB += b;
+   }
    return integral;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// upper bound of the difference between GetROCIntegral() and the integral
+/// of the exact ROC curve: half of the sum over the bins of the products of
+/// the signal and background fractions of the bin
+
+Double_t TMVA::ROCCurve::GetROCIntegralError() const
+{
+   Double_t sumS = 0, sumB = 0, sumSB = 0;
+   for (UInt_t bin = 0; bin < fNBins+2; bin++) {
+      sumS  += fHistS[bin];
+      sumB  += fHistB[bin];
+      sumSB += fHistS[bin]*fHistB[bin];
+   }
+   if (sumS <= 0 || sumB <= 0) return 0;
+   return 0.5*sumSB/(sumS*sumB);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// signal efficiency of the cut of background efficiency effB, the
+/// efficiencies being the fractions of events above the cut. The result is
+/// interpolated linearly inside the bin of the cut, and differs from the
+/// exact one by at most the signal fraction of this bin.
+
+Double_t TMVA::ROCCurve::GetSignalEfficiency(Double_t effB) const
+{
+   Double_t sumS = 0, sumB = 0;
+   for (UInt_t bin = 0; bin < fNBins+2; bin++) {
+      sumS += fHistS[bin];
+      sumB += fHistB[bin];
+   }
+   if (sumS <= 0 || sumB <= 0) return 0;
+
+   Double_t aboveS = 0, aboveB = 0;
+   for (Int_t bin = fNBins+1; bin >= 0; bin--) {
+      Double_t s = fHistS[bin]/sumS;
+      Double_t b = fHistB[bin]/sumB;
+      if (aboveB + b >= effB) {
+         Double_t f = (b > 0) ? (effB - aboveB)/b : 0;
+         return aboveS + f*s;
+      }
+      aboveS += s;
+      aboveB += b;
+   }
+   return 1.;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// graph of the background rejection versus the signal efficiency, for
+/// points-2 cuts equally spaced in the range of the histograms, made at
+/// the first call
 
 TGraph* TMVA::ROCCurve::GetROCCurve(const UInt_t points)
 {
-  
-    const UInt_t ndivisions = points - 1;
-    fEpsilonSig.resize(points);
-    fEpsilonBgk.resize(points);
+    if (fGraph) return fGraph;
+
+    const UInt_t ndivisions = TMath::Max(points, 2u) - 1;
+    fEpsilonSig.resize(ndivisions + 1);
+    fEpsilonBgk.resize(ndivisions + 1);
     // Fixed values.
     fEpsilonSig[0] = 0.0;
     fEpsilonSig[ndivisions] = 1.0;
     fEpsilonBgk[0] = 1.0;
     fEpsilonBgk[ndivisions] = 0.0;
 
+    Double_t sumS = 0, sumB = 0;
+    for (UInt_t bin = 0; bin < fNBins+2; bin++) {
+       sumS += fHistS[bin];
+       sumB += fHistB[bin];
+    }
+
     for(UInt_t i = 1; i < ndivisions; i++)
     {
-	Float_t threshold = -1.0 + i * 2.0 / (Float_t) ndivisions;
-	Float_t true_positives = 0.0;
-	Float_t false_positives = 0.0;
-	Float_t true_negatives = 0.0;
-	Float_t false_negatives = 0.0;
-
-	for(UInt_t j=0; j<fMvaS.size(); j++)
-	{
-	    if(fMvaS[j] > threshold)
-		true_positives += 1.0;
-	    else
-		false_negatives += 1.0;
-
-	    if(fMvaB[j] > threshold)
-		false_positives += 1.0;
-	    else
-		true_negatives += 1.0;
-	}
+	Double_t threshold = fXmin + i * (fXmax - fXmin) / ndivisions;
 
+	// true positives and true negatives rates
 	fEpsilonSig[ndivisions - i] = 0.0;
-	if ((true_positives > 0.0) || (false_negatives > 0.0))
-	    fEpsilonSig[ndivisions - i] =
-		true_positives / (true_positives + false_negatives);
-
-	fEpsilonBgk[ndivisions - i] =0.0;
-	if ((true_negatives > 0.0) || (false_positives > 0.0))
-	    fEpsilonBgk[ndivisions - i] =
-		true_negatives / (true_negatives + false_positives);
+	if (sumS > 0) fEpsilonSig[ndivisions - i] = 1.0 - GetFractionBelow(fHistS, sumS, threshold);
 
+	fEpsilonBgk[ndivisions - i] = 0.0;
+	if (sumB > 0) fEpsilonBgk[ndivisions - i] = GetFractionBelow(fHistB, sumB, threshold);
     }  
   
- if(!fGraph)    fGraph=new TGraph(fEpsilonSig.size(),&fEpsilonSig[0],&fEpsilonBgk[0]);
+ fGraph=new TGraph(fEpsilonSig.size(),&fEpsilonSig[0],&fEpsilonBgk[0]);
  return fGraph;
 }
-
-
-
-
@@ -99,6 +99,8 @@
 #include "TMVA/DataSetManager.h"
 #include "TMVA/IMethod.h"
 #include "TMVA/MethodBase.h"
+#include "TMVA/MethodBDT.h"
+#include "TMVA/CompiledBDT.h"
 #include "TMVA/MethodCuts.h"
 #include "TMVA/MethodCategory.h"
 #include "TMVA/MsgLogger.h"
@@ -526,6 +528,72 @@ Double_t TMVA::Reader::EvaluateMVA( const std::vector<Double_t>& inputVec, const
    return EvaluateMVA( fTmpEvalVec, methodTag, aux );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate 'nEvents' events at once for a given method and write the MVA
+/// values to 'mvaValues'. The input variables of event i are
+/// inputs[i*nvar] ... inputs[(i+1)*nvar-1], in the order in which they were
+/// added to the reader. BDTs evaluate all events together on the flattened
+/// forest (see MethodBDT::GetMvaValues), the other methods one by one.
+/// Events with a NaN variable get the MVA value -999.
+/// The parameter aux is obligatory for the cuts method where it represents the efficiency cutoff
+
+void TMVA::Reader::EvaluateMVA( const Float_t* inputs, UInt_t nEvents, Double_t* mvaValues,
+                                const TString& methodTag, Double_t aux )
+{
+   IMethod* imeth = FindMVA( methodTag );
+   MethodBase* meth = dynamic_cast<TMVA::MethodBase*>(imeth);
+   if (meth==0) {
+      for (UInt_t iev=0; iev<nEvents; iev++) mvaValues[iev] = 0;
+      return;
+   }
+
+   UInt_t nvar = DataInfo().GetNVariables();
+   MethodBDT* bdt = dynamic_cast<TMVA::MethodBDT*>(meth);
+   if (bdt && !bdt->DoRegression() && !bdt->DoMulticlass()) {
+      bdt->GetMvaValues( inputs, nEvents, mvaValues );
+   }
+   else {
+      if (meth->GetMethodType() == TMVA::Types::kCuts) {
+         TMVA::MethodCuts* mc = dynamic_cast<TMVA::MethodCuts*>(meth);
+         if(mc)
+            mc->SetTestSignalEfficiency( aux );
+      }
+      std::vector<Float_t> inputVec(nvar);
+      for (UInt_t iev=0; iev<nEvents; iev++) {
+         inputVec.assign( inputs + iev*nvar, inputs + (iev+1)*nvar );
+         Event tmpEvent( inputVec, DataInfo().GetNVariables() );
+         mvaValues[iev] = meth->GetMvaValue( &tmpEvent, (fCalculateError?&fMvaEventError:0) );
+      }
+   }
+
+   for (UInt_t iev=0; iev<nEvents; iev++) {
+      for (UInt_t i=0; i<nvar; i++) {
+         if (TMath::IsNaN(inputs[iev*nvar+i])) {
+            Log() << kERROR << i << "-th variable of event " << iev << " is NaN --> return MVA value -999, \n that's all I can do, please fix or remove this event." << Endl;
+            mvaValues[iev] = -999;
+            break;
+         }
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compile the booked BDT 'methodTag' into a TMVA::CompiledBDT for the
+/// thread-safe evaluation of its classification response, optionally with
+/// quantized cuts (see TMVA::FlatForest). The compiled BDT does not depend
+/// on the reader, which may be deleted afterwards. Returns a null pointer if
+/// the method does not exist or is not a BDT.
+
+std::shared_ptr<const TMVA::CompiledBDT> TMVA::Reader::CompileBDT( const TString& methodTag, Bool_t quantizeCuts )
+{
+   MethodBDT* bdt = dynamic_cast<TMVA::MethodBDT*>( FindMVA( methodTag ) );
+   if (bdt==0) {
+      Log() << kERROR << "<CompileBDT> \"" << methodTag << "\" is not a booked BDT" << Endl;
+      return std::shared_ptr<const CompiledBDT>();
+   }
+   return std::make_shared<CompiledBDT>( *bdt, FlatForest::kDepthFirst, quantizeCuts );
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// evaluates MVA for given set of input variables
 
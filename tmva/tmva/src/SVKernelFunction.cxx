@@ -125,9 +125,18 @@ void TMVA::SVKernelFunction::setCompatibilityParams(EKernelType k, UInt_t order,
 
 ////////////////////////////////////////////////////////////////////////////////
 
-Float_t TMVA::SVKernelFunction::Evaluate( SVEvent* ev1, SVEvent* ev2 )
+Float_t TMVA::SVKernelFunction::Evaluate( SVEvent* ev1, SVEvent* ev2 ) const
 {
-   switch(fKernel) {
+   return Evaluate( fKernel, ev1, ev2 );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// value of the kernel 'kernel' for the events ev1 and ev2; the function object
+/// is not modified, so that the kernel can be evaluated concurrently
+
+Float_t TMVA::SVKernelFunction::Evaluate( EKernelType kernel, SVEvent* ev1, SVEvent* ev2 ) const
+{
+   switch(kernel) {
    case kRBF:
       {
          std::vector<Float_t> *v1 = ev1->GetDataVector();
@@ -198,32 +207,26 @@ Float_t TMVA::SVKernelFunction::Evaluate( SVEvent* ev1, SVEvent* ev2 )
    case kProd:
       {
          // Calculate product of kernels by looping over list of kernels                 
-         // and evaluating the value for each, setting kernel back to                    
-         // kProd before returning so it can be used again. Described in "An Introduction to         // Support Vector Machines and Other Kernel-based Learning
+         // and evaluating the value for each. Described in "An Introduction to         // Support Vector Machines and Other Kernel-based Learning
          // Methods" by Cristianini and Shawe-Taylor, Section 3.3.2
          Float_t kernelVal;
          kernelVal = 1;
          for(UInt_t i = 0; i<fKernelsList.size(); i++){
-            fKernel = fKernelsList.at(i);
-            Float_t a = Evaluate(ev1,ev2);
+            Float_t a = Evaluate(fKernelsList.at(i),ev1,ev2);
             kernelVal *= a;
          }
-         fKernel = kProd;
          return kernelVal;
       }
    case kSum:
       {
          // Calculate sum of kernels by looping over list of kernels                     
-         // and evaluating the value for each, setting kernel back to                    
-         // kSum before returning so it can be used again. Described in "An Introduction to          // Support Vector Machines and Other Kernel-based Learning                      
+         // and evaluating the value for each. Described in "An Introduction to          // Support Vector Machines and Other Kernel-based Learning                      
          // Methods" by Cristianini and Shawe-Taylor, Section 3.3.2                      
          Float_t kernelVal = 0;
          for(UInt_t i = 0; i<fKernelsList.size(); i++){
-            fKernel = fKernelsList.at(i);
-            Float_t a = Evaluate(ev1,ev2);
+            Float_t a = Evaluate(fKernelsList.at(i),ev1,ev2);
             kernelVal += a;
          }
-         fKernel = kSum;
          return kernelVal;
       }
    }
@@ -39,42 +39,71 @@
 #include "TMVA/Types.h"
 
 #include "RtypesCore.h"
+#include "TROOT.h"
+#include "ROOT/TSeq.hxx"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
+/*! \class TMVA::SVKernelMatrix
+\ingroup TMVA
+Kernel matrix for Support Vector Machine
+
+The rows of the matrix are computed when they are first requested and
+kept in a cache with a memory budget; the least recently used row is
+replaced when the cache is full. Only the diagonal is always stored, so
+the memory needed is no longer quadratic in the number of events. The
+elements of a row are computed in parallel if implicit multi-threading
+is enabled. The elements are computed as before, so the results of the
+training do not depend on the size of the cache.
+*/
+
 ////////////////////////////////////////////////////////////////////////////////
 /// constructor
 
 TMVA::SVKernelMatrix::SVKernelMatrix()
    : fSize(0),
+     fInputVectors(0),
      fKernelFunction(0),
-     fSVKernelMatrix(0),
-     fLogger( new MsgLogger("ResultsRegression", kINFO) )
+     fLogger( new MsgLogger("SVKernelMatrix", kINFO) )
 {
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// constructor
 
-TMVA::SVKernelMatrix::SVKernelMatrix( std::vector<TMVA::SVEvent*>* inputVectors, SVKernelFunction* kernelFunction )
+TMVA::SVKernelMatrix::SVKernelMatrix( std::vector<TMVA::SVEvent*>* inputVectors, SVKernelFunction* kernelFunction,
+                                      Double_t cacheSize )
    : fSize(inputVectors->size()),
+     fInputVectors(inputVectors),
      fKernelFunction(kernelFunction),
      fLogger( new MsgLogger("SVKernelMatrix", kINFO) )
 {
-   fSVKernelMatrix = new Float_t*[fSize];
+   UInt_t nslots = fSize;
+   if (cacheSize > 0 && fSize > 0) {
+      Double_t nrows = cacheSize*1024*1024/(Double_t(fSize)*sizeof(Float_t));
+      if (nrows < nslots) nslots = std::max(UInt_t(nrows), UInt_t(2));
+      nslots = std::min(nslots, fSize);
+   }
+
    try{
-      for (UInt_t i = 0; i < fSize; i++) fSVKernelMatrix[i] = new Float_t[i+1];
+      fDiagonal.resize(fSize);
+      fCache.resize(size_t(nslots)*fSize);
+      fSlots.assign(nslots, -1);
+      fRowSlots.assign(fSize, -1);
+      fLRUPos.resize(nslots);
    }catch(...){
-      Log() << kFATAL << "Input data too large. Not enough memory to allocate memory for Support Vector Kernel Matrix. Please reduce the number of input events or use a different method."<<Endl;
+      Log() << kFATAL << "Input data too large. Not enough memory to allocate memory for Support Vector Kernel Matrix. Please reduce the number of input events or the size of the kernel cache."<<Endl;
    }
-   // We compute the diagonal and one half of the off diagonal. When reading back we use
-   // the symmetry of i,j to j,i to ensure the correct values are returned.
-   for (UInt_t i = 0; i < fSize; i++) {
-      for (UInt_t j = 0; j <=i; j++) {
-         fSVKernelMatrix[i][j] = fKernelFunction->Evaluate((*inputVectors)[i], (*inputVectors)[j]);
-      }
+   if (nslots < fSize) {
+      Log() << kINFO << "Caching " << nslots << " of " << fSize << " rows of the kernel matrix" << Endl;
    }
+
+   for (UInt_t i = 0; i < fSize; i++) fDiagonal[i] = Evaluate(i, i);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -82,12 +111,39 @@ TMVA::SVKernelMatrix::SVKernelMatrix( std::vector<TMVA::SVEvent*>* inputVectors,
 
 TMVA::SVKernelMatrix::~SVKernelMatrix()
 {
-   for (UInt_t i = fSize -1; i > 0; i--) {
-      delete[] fSVKernelMatrix[i];
-      fSVKernelMatrix[i] = 0;
+   delete fLogger;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// element (i,j) of the kernel matrix; the kernel is evaluated with the
+/// larger index first, as the lower triangle was computed before
+
+Float_t TMVA::SVKernelMatrix::Evaluate( UInt_t i, UInt_t j ) const
+{
+   if (i < j) std::swap(i, j);
+   return fKernelFunction->Evaluate((*fInputVectors)[i], (*fInputVectors)[j]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// compute the row 'line' of the kernel matrix into 'values'
+
+void TMVA::SVKernelMatrix::ComputeLine( UInt_t line, Float_t* values ) const
+{
+   const UInt_t nchunk = 1024;
+   const UInt_t nchunks = (fSize + nchunk - 1)/nchunk;
+   auto computeChunk = [&](UInt_t ichunk) {
+      const UInt_t last = std::min(fSize, (ichunk + 1)*nchunk);
+      for (UInt_t i = ichunk*nchunk; i < last; i++) values[i] = Evaluate(line, i);
+   };
+
+#ifdef R__USE_IMT
+   if (nchunks > 1 && ROOT::IsImplicitMTEnabled()) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(computeChunk, ROOT::TSeqU(nchunks));
+      return;
    }
-   delete[] fSVKernelMatrix;
-   fSVKernelMatrix = 0;
+#endif
+   for (UInt_t ichunk = 0; ichunk < nchunks; ichunk++) computeChunk(ichunk);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -95,25 +151,43 @@ TMVA::SVKernelMatrix::~SVKernelMatrix()
 
 Float_t* TMVA::SVKernelMatrix::GetLine( UInt_t line )
 {
-   Float_t* fLine = NULL;
    if (line >= fSize) {
       return NULL;
    }
+
+   Int_t slot = fRowSlots[line];
+   if (slot >= 0) {
+      // move the row to the front of the LRU list
+      fLRU.splice(fLRU.begin(), fLRU, fLRUPos[slot]);
+      return &fCache[size_t(slot)*fSize];
+   }
+
+   if (fLRU.size() < fSlots.size()) {
+      slot = fLRU.size();
+   }
    else {
-      fLine = new Float_t[fSize];
-      for( UInt_t i = 0; i <line; i++)
-         fLine[i] = fSVKernelMatrix[line][i];
-      for( UInt_t i = line; i < fSize; i++)
-         fLine[i] = fSVKernelMatrix[i][line];
-      return fLine;
+      // replace the least recently used row
+      slot = fLRU.back();
+      fLRU.pop_back();
+      fRowSlots[fSlots[slot]] = -1;
    }
+   fLRU.push_front(slot);
+   fLRUPos[slot] = fLRU.begin();
+   fSlots[slot] = line;
+   fRowSlots[line] = slot;
+
+   Float_t* values = &fCache[size_t(slot)*fSize];
+   ComputeLine(line, values);
+   return values;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// returns an element of the kernel matrix
 
 Float_t TMVA::SVKernelMatrix::GetElement(UInt_t i, UInt_t j)
-{ 
-   if (i > j) return fSVKernelMatrix[i][j]; 
-   else       return fSVKernelMatrix[j][i]; // it's symmetric, ;)
+{
+   if (i == j) return fDiagonal[i];
+   if (fRowSlots[i] >= 0) return fCache[size_t(fRowSlots[i])*fSize + j];
+   if (fRowSlots[j] >= 0) return fCache[size_t(fRowSlots[j])*fSize + i]; // it's symmetric, ;)
+   return Evaluate(i, j);
 }
@@ -36,6 +36,13 @@
 
 #include "TMath.h"
 #include "TRandom3.h"
+#include "TROOT.h"
+#include "ROOT/TSeq.hxx"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadExecutor.hxx"
+#endif
+
+#include <algorithm>
 
 #include <iostream>
 #include <vector>
@@ -62,7 +69,7 @@ TMVA::SVWorkingSet::SVWorkingSet()
 /// constructor
 
 TMVA::SVWorkingSet::SVWorkingSet(std::vector<TMVA::SVEvent*>*inputVectors, SVKernelFunction* kernelFunction,
-                                 Float_t tol, Bool_t doreg)
+                                 Float_t tol, Bool_t doreg, Double_t kernelCacheSize)
    : fdoRegression(doreg),
      fInputData(inputVectors),
      fSupVec(0),
@@ -74,11 +81,8 @@ TMVA::SVWorkingSet::SVWorkingSet(std::vector<TMVA::SVEvent*>*inputVectors, SVKer
      fTolerance(tol),      
      fLogger( new MsgLogger( "SVWorkingSet", kINFO ) )
 {
-   fKMatrix = new TMVA::SVKernelMatrix(inputVectors, kernelFunction);
-   Float_t *pt;
+   fKMatrix = new TMVA::SVKernelMatrix(inputVectors, kernelFunction, kernelCacheSize);
    for( UInt_t i = 0; i < fInputData->size(); i++){ 
-      pt = fKMatrix->GetLine(i);
-      fInputData->at(i)->SetLine(pt);
       fInputData->at(i)->SetNs(i);
       if(fdoRegression) fInputData->at(i)->SetErrorCache(fInputData->at(i)->GetTarget());
    }
@@ -127,7 +131,7 @@ Bool_t TMVA::SVWorkingSet::ExamineExample( TMVA::SVEvent* jevt )
    Float_t fErrorC_J = 0.;
    if( jevt->GetIdx()==0) fErrorC_J = jevt->GetErrorCache();
    else{
-      Float_t *fKVals = jevt->GetLine();
+      Float_t *fKVals = fKMatrix->GetLine(jevt->GetNs());
       fErrorC_J = 0.;
       std::vector<TMVA::SVEvent*>::iterator idIter;
       
@@ -303,16 +307,7 @@ Bool_t TMVA::SVWorkingSet::TakeStep(TMVA::SVEvent* ievt,TMVA::SVEvent* jevt )
    Float_t dL_I = type_I * ( newAlpha_I - alpha_I );
    Float_t dL_J = type_J * ( newAlpha_J - alpha_J );  
 
-   Int_t k = 0; 
-   for(idIter = fInputData->begin(); idIter != fInputData->end(); idIter++){
-      k++;
-      if((*idIter)->GetIdx()==0){
-         Float_t ii = fKMatrix->GetElement(ievt->GetNs(), (*idIter)->GetNs());
-         Float_t jj = fKMatrix->GetElement(jevt->GetNs(), (*idIter)->GetNs());
-         
-         (*idIter)->UpdateErrorCache(dL_I * ii + dL_J * jj);       
-      }
-   }
+   UpdateErrorCaches(ievt, dL_I, jevt, dL_J);
    ievt->SetAlpha(newAlpha_I);
    jevt->SetAlpha(newAlpha_J);
    // set new indexes
@@ -629,17 +624,8 @@ Bool_t TMVA::SVWorkingSet::TakeStepReg(TMVA::SVEvent* ievt,TMVA::SVEvent* jevt )
       const Float_t diff_alpha_j = jevt->GetDeltaAlpha()+b_alpha_j_p - jevt->GetAlpha();
 
       //update error cache
-      Int_t k = 0; 
-      for(idIter = fInputData->begin(); idIter != fInputData->end(); idIter++){
-         k++;
-         //there will be some changes in Idx notation
-         if((*idIter)->GetIdx()==0){
-            Float_t k_ii = fKMatrix->GetElement(ievt->GetNs(), (*idIter)->GetNs());
-            Float_t k_jj = fKMatrix->GetElement(jevt->GetNs(), (*idIter)->GetNs());
-         
-            (*idIter)->UpdateErrorCache(diff_alpha_i * k_ii + diff_alpha_j * k_jj);
-         }
-      }
+      //there will be some changes in Idx notation
+      UpdateErrorCaches(ievt, diff_alpha_i, jevt, diff_alpha_j);
          
       //store new alphas in SVevents
       ievt->SetAlpha(b_alpha_i);
@@ -681,7 +667,7 @@ Bool_t TMVA::SVWorkingSet::ExamineExampleReg(TMVA::SVEvent* jevt)
       fErrorC_J = jevt->GetErrorCache();
    }
    else{
-      Float_t *fKVals = jevt->GetLine();
+      Float_t *fKVals = fKMatrix->GetLine(jevt->GetNs());
       fErrorC_J = 0.;
       std::vector<TMVA::SVEvent*>::iterator idIter;
       
@@ -791,3 +777,36 @@ Bool_t TMVA::SVWorkingSet::IsDiffSignificant(Float_t a_i, Float_t a_j, Float_t e
    else return kFALSE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// add dI*K(i,k) + dJ*K(j,k) to the error cache of the events k with index 0,
+/// using the rows of ievt and jevt of the kernel matrix. The events are
+/// updated in parallel if implicit multi-threading is enabled
+
+void TMVA::SVWorkingSet::UpdateErrorCaches( TMVA::SVEvent* ievt, Float_t dI, TMVA::SVEvent* jevt, Float_t dJ )
+{
+   // the row of ievt stays in the cache while the row of jevt is computed
+   const Float_t* kernel_I = fKMatrix->GetLine(ievt->GetNs());
+   const Float_t* kernel_J = fKMatrix->GetLine(jevt->GetNs());
+
+   const UInt_t nevents = fInputData->size();
+   const UInt_t nchunk = 4096;
+   const UInt_t nchunks = (nevents + nchunk - 1)/nchunk;
+   auto updateChunk = [&](UInt_t ichunk) {
+      const UInt_t last = std::min(nevents, (ichunk + 1)*nchunk);
+      for (UInt_t k = ichunk*nchunk; k < last; k++) {
+         SVEvent* kevt = (*fInputData)[k];
+         if (kevt->GetIdx()==0) {
+            kevt->UpdateErrorCache(dI * kernel_I[kevt->GetNs()] + dJ * kernel_J[kevt->GetNs()]);
+         }
+      }
+   };
+
+#ifdef R__USE_IMT
+   if (nchunks > 1 && ROOT::IsImplicitMTEnabled()) {
+      ROOT::TThreadExecutor pool;
+      pool.Foreach(updateChunk, ROOT::TSeqU(nchunks));
+      return;
+   }
+#endif
+   for (UInt_t ichunk = 0; ichunk < nchunks; ichunk++) updateChunk(ichunk);
+}
@@ -212,9 +212,7 @@ const std::vector<TMVA::Event*>* TMVA::TransformationHandler::CalcTransformation
    std::vector< Int_t >::iterator rClsIt = fTransformationsReferenceClasses.begin();
    while (VariableTransformBase *trf = (VariableTransformBase*) trIt()) {
       if (trf->PrepareTransformation(*transformedEvents)) {
-         for (UInt_t ievt = 0; ievt<transformedEvents->size(); ievt++) {  // loop through all events
-            *(*transformedEvents)[ievt] = *trf->Transform((*transformedEvents)[ievt],(*rClsIt));
-         }
+         trf->TransformEvents(*transformedEvents,(*rClsIt)); // in place, for all events at once
          rClsIt++;
       }
    }
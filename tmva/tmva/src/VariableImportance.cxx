@@ -14,6 +14,9 @@
 #include "TMVA/Types.h"
 #include "TMVA/VarTransformHandler.h"
 
+#include "ROOT/TProcessExecutor.hxx"
+#include "ROOT/TSeq.hxx"
+
 #include "TAxis.h"
 #include "TGraph.h"
 #include "TCanvas.h"
@@ -22,6 +25,7 @@
 #include "TStyle.h"
 #include "TSystem.h"
 
+#include <algorithm>
 #include <bitset>
 #include <iostream>
 #include <memory>
@@ -75,7 +79,7 @@ TCanvas* TMVA::VariableImportanceResult::Draw(const TString name) const
     return c;
 }
 
-TMVA::VariableImportance::VariableImportance(TMVA::DataLoader *dataloader):TMVA::Envelope("VariableImportance",dataloader,nullptr),fType(VIType::kShort)
+TMVA::VariableImportance::VariableImportance(TMVA::DataLoader *dataloader):TMVA::Envelope("VariableImportance",dataloader,nullptr),fType(VIType::kShort),fNWorkers(0)
 {
     fClassifier=std::unique_ptr<Factory>(new TMVA::Factory("VariableImportance","!V:!ROC:!ModelPersistence:Silent:Color:!DrawProgressBar:AnalysisType=Classification"));
 }
@@ -120,6 +124,70 @@ ULong_t TMVA::VariableImportance::Sum(ULong_t i)
     return sum;
 }
 
+Float_t TMVA::VariableImportance::EvaluateSubset(UInt_t x, Bool_t prepare)
+{
+    TString methodName    = fMethod.GetValue<TString>("MethodName");
+    TString methodTitle   = fMethod.GetValue<TString>("MethodTitle");
+    TString methodOptions = fMethod.GetValue<TString>("MethodOptions");
+
+    const UInt_t nbits = fDataLoader->GetDefaultDataSetInfo().GetNVariables();
+    std::vector<TString> varNames = fDataLoader->GetDefaultDataSetInfo().GetListOfVariables();
+
+    std::bitset<NBITS>  xbitset(x);
+
+    //creating loader for the subset
+    TMVA::DataLoader *subsetdl = new TMVA::DataLoader(xbitset.to_string());
+
+    //adding variables from the subset
+    for (UInt_t index = 0; index < nbits; index++) {
+        if (xbitset[index]) subsetdl->AddVariable(varNames[index], 'F');
+    }
+
+    //Loading Dataset
+    DataLoaderCopy(subsetdl,fDataLoader.get());
+
+    if (prepare)
+        subsetdl->PrepareTrainingAndTestTree(fDataLoader->GetDefaultDataSetInfo().GetCut("Signal"), fDataLoader->GetDefaultDataSetInfo().GetCut("Background"), fDataLoader->GetDefaultDataSetInfo().GetSplitOptions());
+
+    //Booking the subset
+    fClassifier->BookMethod(subsetdl, methodName, methodTitle, methodOptions);
+
+    //Train/Test/Evaluation
+    fClassifier->TrainAllMethods();
+    fClassifier->TestAllMethods();
+    fClassifier->EvaluateAllMethods();
+
+    //getting ROC
+    Float_t roc = fClassifier->GetROCIntegral(xbitset.to_string(), methodTitle);
+
+    delete subsetdl;
+    fClassifier->DeleteAllMethods();
+    fClassifier->fMethodsMap.clear();
+
+    return roc;
+}
+
+std::vector<Float_t> TMVA::VariableImportance::EvaluateSubsets(const std::vector<UInt_t> &subsets, Bool_t prepare)
+{
+    //the trainings are independent, so they are distributed over worker processes if requested.
+    //Every worker trains on its own (forked) copy of the data loader and returns the ROC integral,
+    //and the values are collected in the order of the subsets
+    std::vector<Float_t> rocs;
+    if (fNWorkers > 1 && subsets.size() > 1) {
+        UInt_t nWorkers = std::min<size_t>(fNWorkers, subsets.size());
+        TMVA::gConfig().SetSilent(kFALSE);
+        Log() << kINFO << "Training " << subsets.size() << " classifiers in " << nWorkers << " worker processes" << Endl;
+        TMVA::gConfig().SetSilent(kTRUE);
+
+        auto work = [&](UInt_t i) { return EvaluateSubset(subsets[i], prepare); };
+        ROOT::TProcessExecutor workers(nWorkers);
+        rocs = workers.Map(work, ROOT::TSeqU(subsets.size()));
+    } else {
+        for (UInt_t i = 0; i < subsets.size(); i++) rocs.push_back(EvaluateSubset(subsets[i], prepare));
+    }
+    return rocs;
+}
+
 TH1F* TMVA::VariableImportance::GetImportance(const UInt_t nbits,std::vector<Float_t> &importances,std::vector<TString> &varNames)
 {
     TH1F *vihist  = new TH1F("vihist", "", nbits, 0, nbits);
@@ -163,10 +231,6 @@ TH1F* TMVA::VariableImportance::GetImportance(const UInt_t nbits,std::vector<Flo
 
 void TMVA::VariableImportance::EvaluateImportanceShort()
 {    
-    TString methodName    = fMethod.GetValue<TString>("MethodName");
-    TString methodTitle   = fMethod.GetValue<TString>("MethodTitle");
-    TString methodOptions = fMethod.GetValue<TString>("MethodOptions");
-    
     uint32_t x = 0;
     uint32_t y = 0;
     //getting number of variables and variable names from loader
@@ -183,40 +247,27 @@ void TMVA::VariableImportance::EvaluateImportanceShort()
     
     x = range;
     
-    std::bitset<NBITS>  xbitset(x);
     if (x == 0) Log()<<kFATAL<<"Error: need at least one variable."; //dataloader need at least one variable
     
-    
-    //creating loader for seed
-    TMVA::DataLoader *seeddl = new TMVA::DataLoader(xbitset.to_string());
-    
-    //adding variables from seed
-    for (UInt_t index = 0; index < nbits; index++){ 
-        if (xbitset[index]) seeddl->AddVariable(varNames[index], 'F');
+    //the seed with all variables and the subseeds with one variable removed
+    std::vector<UInt_t> subsets(1, x);
+    for (uint32_t i = 0; i < NBITS; ++i) {
+        if (x & (1 << i)) {
+            y = x & ~(1 << i);
+            if (y != 0) subsets.push_back(y);
+        }
     }
     
-    //Loading Dataset
-    DataLoaderCopy(seeddl,fDataLoader.get());
-    
-    //Booking Seed
-    fClassifier->BookMethod(seeddl, methodName, methodTitle, methodOptions);
-    
     //Train/Test/Evaluation
-    fClassifier->TrainAllMethods();
-    fClassifier->TestAllMethods();
-    fClassifier->EvaluateAllMethods();
+    std::vector<Float_t> rocs = EvaluateSubsets(subsets, kFALSE);
     
     //getting ROC
-    SROC = fClassifier->GetROCIntegral(xbitset.to_string(), methodTitle);
+    SROC = rocs[0];
     
-    delete seeddl;  
-    fClassifier->DeleteAllMethods();
-    fClassifier->fMethodsMap.clear();
-        
+    UInt_t isubset = 1;
     for (uint32_t i = 0; i < NBITS; ++i) {
         if (x & (1 << i)) {
             y = x & ~(1 << i);
-            std::bitset<NBITS>  ybitset(y);
             //need at least one variable
             //NOTE: if subssed is zero then is the special case
             //that count in xbitset is 1
@@ -226,31 +277,9 @@ void TMVA::VariableImportance::EvaluateImportanceShort()
                 continue;
             }
             
-            //creating loader for subseed
-            TMVA::DataLoader *subseeddl = new TMVA::DataLoader(ybitset.to_string());
-            //adding variables from subseed
-            for (UInt_t index = 0; index < nbits; index++) {
-                if (ybitset[index]) subseeddl->AddVariable(varNames[index], 'F');
-            }
-            
-            //Loading Dataset
-            DataLoaderCopy(subseeddl,fDataLoader.get());
-            
-            //Booking SubSeed
-            fClassifier->BookMethod(subseeddl, methodName, methodTitle, methodOptions);
-            
-            //Train/Test/Evaluation
-            fClassifier->TrainAllMethods();
-            fClassifier->TestAllMethods();
-            fClassifier->EvaluateAllMethods();
-            
             //getting ROC
-            SSROC = fClassifier->GetROCIntegral(ybitset.to_string(), methodTitle);
+            SSROC = rocs[isubset++];
             importances[ny] += SROC - SSROC;
-            
-            delete subseeddl;
-            fClassifier->DeleteAllMethods();
-	    fClassifier->fMethodsMap.clear();
         }
     }
     Float_t normalization = 0.0;
@@ -267,10 +296,6 @@ void TMVA::VariableImportance::EvaluateImportanceShort()
 
 void TMVA::VariableImportance::EvaluateImportanceRandom(UInt_t seeds)
 {
-    TString methodName    = fMethod.GetValue<TString>("MethodName");
-    TString methodTitle   = fMethod.GetValue<TString>("MethodTitle");
-    TString methodOptions = fMethod.GetValue<TString>("MethodOptions");
-
     TRandom3 *rangen = new TRandom3(0);  //Random Gen.
     
     uint32_t x = 0;
@@ -291,44 +316,37 @@ void TMVA::VariableImportance::EvaluateImportanceRandom(UInt_t seeds)
     Float_t SROC, SSROC; //computed ROC value for every Seed and SubSeed
     
     x = range;
-        
+    
+    //drawing the seeds, followed each by its subseeds with one variable removed
+    std::vector<UInt_t> seedsList;
+    std::vector<UInt_t> subsets;
     for (UInt_t n = 0; n < seeds; n++) {
         x = rangen -> Integer(range);
-        
-        std::bitset<NBITS>  xbitset(x);
         if (x == 0) continue; //dataloader need at least one variable
         
-        
-        //creating loader for seed
-        TMVA::DataLoader *seeddl = new TMVA::DataLoader(xbitset.to_string());
-        
-        //adding variables from seed
-        for (UInt_t index = 0; index < nbits; index++) {
-            if (xbitset[index]) seeddl->AddVariable(varNames[index], 'F');
+        seedsList.push_back(x);
+        subsets.push_back(x);
+        for (uint32_t i = 0; i < 32; ++i) {
+            if (x & (1 << i)) {
+                y = x & ~(1 << i);
+                if (y != 0) subsets.push_back(y);
+            }
         }
-        
-        //Loading Dataset
-        DataLoaderCopy(seeddl,fDataLoader.get());
-        
-        //Booking Seed
-        fClassifier->BookMethod(seeddl, methodName, methodTitle, methodOptions);
-        
-        //Train/Test/Evaluation
-        fClassifier->TrainAllMethods();
-        fClassifier->TestAllMethods();
-        fClassifier->EvaluateAllMethods();
+    }
+    
+    //Train/Test/Evaluation
+    std::vector<Float_t> rocs = EvaluateSubsets(subsets, kFALSE);
+    
+    UInt_t isubset = 0;
+    for (UInt_t n = 0; n < seedsList.size(); n++) {
+        x = seedsList[n];
         
         //getting ROC
-        SROC = fClassifier->GetROCIntegral(xbitset.to_string(), methodTitle);
-        
-        delete seeddl;
-        fClassifier->DeleteAllMethods();
-	fClassifier->fMethodsMap.clear();
+        SROC = rocs[isubset++];
         
         for (uint32_t i = 0; i < 32; ++i) {
             if (x & (1 << i)) {
                 y = x & ~(1 << i);
-                std::bitset<NBITS>  ybitset(y);
                 //need at least one variable
                 //NOTE: if subssed is zero then is the special case
                 //that count in xbitset is 1
@@ -339,31 +357,9 @@ void TMVA::VariableImportance::EvaluateImportanceRandom(UInt_t seeds)
                     continue;
                 }
                 
-                //creating loader for subseed
-                TMVA::DataLoader *subseeddl = new TMVA::DataLoader(ybitset.to_string());
-                //adding variables from subseed
-                for (UInt_t index = 0; index < nbits; index++) {
-                    if (ybitset[index]) subseeddl->AddVariable(varNames[index], 'F');
-                }
-                
-                //Loading Dataset
-                DataLoaderCopy(subseeddl,fDataLoader.get());
-                
-                //Booking SubSeed
-                fClassifier->BookMethod(subseeddl, methodName, methodTitle, methodOptions);
-                
-                //Train/Test/Evaluation
-                fClassifier->TrainAllMethods();
-                fClassifier->TestAllMethods();
-                fClassifier->EvaluateAllMethods();
-                
                 //getting ROC
-                SSROC = fClassifier->GetROCIntegral(ybitset.to_string(), methodTitle);
+                SSROC = rocs[isubset++];
                 importances[ny] += SROC - SSROC;
-                
-                delete subseeddl;
-                fClassifier->DeleteAllMethods();
-		fClassifier->fMethodsMap.clear();
             }
         }
     }
@@ -385,11 +381,6 @@ void TMVA::VariableImportance::EvaluateImportanceRandom(UInt_t seeds)
 
 void TMVA::VariableImportance::EvaluateImportanceAll()
 {
-
-    TString methodName    = fMethod.GetValue<TString>("MethodName");
-    TString methodTitle   = fMethod.GetValue<TString>("MethodTitle");
-    TString methodOptions = fMethod.GetValue<TString>("MethodOptions");
-    
     uint32_t x = 0;
     uint32_t y = 0;
     
@@ -408,38 +399,14 @@ void TMVA::VariableImportance::EvaluateImportanceAll()
     for (UInt_t i = 0; i < nbits; i++) importances[i] = 0;
     
     Float_t SROC, SSROC; //computed ROC value
-    for ( x = 1; x <range ; x++) {
-        
-        std::bitset<NBITS>  xbitset(x);
-        if (x == 0) continue; //dataloader need at least one variable
-        
-        //creating loader for seed
-        TMVA::DataLoader *seeddl = new TMVA::DataLoader(xbitset.to_string());
-        
-        //adding variables from seed
-        for (UInt_t index = 0; index < nbits; index++) {
-            if (xbitset[index]) seeddl->AddVariable(varNames[index], 'F');
-        }
-        
-        DataLoaderCopy(seeddl,fDataLoader.get());
-        
-        seeddl->PrepareTrainingAndTestTree(fDataLoader->GetDefaultDataSetInfo().GetCut("Signal"), fDataLoader->GetDefaultDataSetInfo().GetCut("Background"), fDataLoader->GetDefaultDataSetInfo().GetSplitOptions());
-        
-        //Booking Seed
-        fClassifier->BookMethod(seeddl, methodName, methodTitle, methodOptions);
-        
-        //Train/Test/Evaluation
-        fClassifier->TrainAllMethods();
-        fClassifier->TestAllMethods();
-        fClassifier->EvaluateAllMethods();
-        
-        //getting ROC
-        ROC[x] = fClassifier->GetROCIntegral(xbitset.to_string(), methodTitle);
-        
-        delete seeddl;    
-        fClassifier->DeleteAllMethods();
-	fClassifier->fMethodsMap.clear();
-    }
+    
+    //all seeds, each one needs at least one variable
+    std::vector<UInt_t> subsets;
+    for ( x = 1; x <range ; x++) subsets.push_back(x);
+    
+    //Train/Test/Evaluation
+    std::vector<Float_t> rocs = EvaluateSubsets(subsets, kTRUE);
+    for ( x = 1; x <range ; x++) ROC[x] = rocs[x - 1];
     
     
     for ( x = 0; x <range ; x++) 
@@ -154,6 +154,41 @@ const TMVA::Event* TMVA::VariableNormalizeTransform::Transform( const TMVA::Even
    return fTransformedEvent;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// apply the normalization transformation to all events in place. The
+/// offsets and scales are computed once, and the vectors for the values of
+/// the events are reused, so that no event is allocated or copied
+
+void TMVA::VariableNormalizeTransform::TransformEvents( const std::vector<Event*>& events, Int_t cls ) const
+{
+   if (!IsCreated()) Log() << kFATAL << "Transformation not yet created" << Endl;
+
+   // the same class workaround as in Transform
+   if (cls < 0 || cls >= (int) fMin.size()) cls = fMin.size()-1;
+
+   const FloatVector& minVector = fMin.at(cls);
+   const FloatVector& maxVector = fMax.at(cls);
+   FloatVector offsets(minVector.size()), scales(minVector.size());
+   for (UInt_t iidx=0; iidx<minVector.size(); iidx++) {
+      offsets[iidx] = minVector[iidx];
+      scales[iidx]  = 1.0/(maxVector[iidx]-minVector[iidx]);
+   }
+
+   FloatVector input;
+   FloatVector output;
+   std::vector<Char_t> mask;
+   for (std::vector<Event*>::const_iterator itEv = events.begin(); itEv != events.end(); ++itEv) {
+      GetInput( *itEv, input, mask );
+      output.clear();
+      for (UInt_t iidx=0; iidx<input.size(); iidx++) {
+         if (mask[iidx]) continue; // don't put any value into output if the value is masked
+         if (iidx >= offsets.size()) Log() << kFATAL << "<TransformEvents> more inputs than normalization ranges" << Endl;
+         output.push_back( (input[iidx]-offsets[iidx])*scales[iidx] * 2 - 1 );
+      }
+      SetOutput( *itEv, output, mask );
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// apply the inverse transformation
 
@@ -163,6 +163,31 @@ const TMVA::Event* TMVA::VariablePCATransform::Transform( const Event* const ev,
    return fTransformedEvent;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// apply the principal component analysis to all events in place, reusing
+/// the vectors for the values and principal components of the events
+
+void TMVA::VariablePCATransform::TransformEvents( const std::vector<Event*>& events, Int_t cls ) const
+{
+   if (!IsCreated()) return;
+
+   // the same class workaround as in Transform
+   if (cls < 0 || cls >= (int) fMeanValues.size()) cls = fMeanValues.size()-1;
+
+   std::vector<Float_t> input;
+   std::vector<Char_t>  mask;
+   std::vector<Float_t> principalComponents;
+   for (std::vector<Event*>::const_iterator itEv = events.begin(); itEv != events.end(); ++itEv) {
+      if (GetInput( *itEv, input, mask )) {
+         // masked targets, handled by Transform
+         **itEv = *Transform( *itEv, cls );
+         continue;
+      }
+      X2P( principalComponents, input, cls );
+      SetOutput( *itEv, principalComponents, mask );
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// apply the principal component analysis
 /// TODO: implementation of inverse transformation
@@ -277,10 +302,18 @@ void TMVA::VariablePCATransform::X2P( std::vector<Float_t>& pc, const std::vecto
    const Int_t nInput = x.size();
    pc.assign(nInput,0);
 
+   // subtract the mean values once, then project on the eigenvectors
+   const TVectorD& mean = *fMeanValues.at(cls);
+   const TMatrixD& eigenVectors = *fEigenVectors.at(cls);
+   const Double_t* vectors = eigenVectors.GetMatrixArray();
+   const Int_t nCols = eigenVectors.GetNcols();
+   std::vector<Double_t> dx(nInput);
+   for (Int_t j = 0; j < nInput; j++) dx[j] = ((Double_t)x[j]) - mean(j);
+
    for (Int_t i = 0; i < nInput; i++) {
       Double_t pv = 0;
       for (Int_t j = 0; j < nInput; j++)
-         pv += (((Double_t)x.at(j)) - (*fMeanValues.at(cls))(j)) * (*fEigenVectors.at(cls))(j,i);
+         pv += dx[j] * vectors[j*nCols+i];
       pc[i] = pv;
    }
 }
@@ -359,6 +359,18 @@ Bool_t TMVA::VariableTransformBase::GetInput( const Event* event, std::vector<Fl
    return hasMaskedEntries;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// transform all events in place. The default implementation transforms
+/// the events one by one and copies the transformed event back; derived
+/// classes can avoid the copies and the temporary vectors of each event.
+
+void TMVA::VariableTransformBase::TransformEvents( const std::vector<Event*>& events, Int_t cls ) const
+{
+   for (UInt_t ievt = 0; ievt<events.size(); ievt++) {
+      *events[ievt] = *Transform( events[ievt], cls );
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// select the values from the event
 
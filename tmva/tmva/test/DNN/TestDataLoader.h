@@ -24,10 +24,11 @@ namespace DNN
 
 /** Test that the data loader loads all data in the data set by summing
  *  up all elements batch wise and comparing to the result over the complete
- *  data set. */
+ *  data set. The samples are shuffled after the first batch, which has to
+ *  discard the batches prefetched with the previous ordering. */
 //______________________________________________________________________________
 template <typename Architecture_t>
-auto testSum()
+auto testSum(size_t nPrefetch = 0)
     -> typename Architecture_t::Scalar_t
 {
    using Scalar_t     = typename Architecture_t::Scalar_t;
@@ -41,7 +42,9 @@ auto testSum()
       X(i,0) = i;
    }
    MatrixInput_t input(X, X);
-   DataLoader_t  loader(input, nSamples, 5, 1, 1);
+   DataLoader_t  loader(input, nSamples, 5, 1, 1, 1, nPrefetch);
+   loader.GetBatch();
+   loader.Shuffle();
 
    Matrix_t XArch(X), Sum(1,1), SumTotal(1,1);
    Scalar_t sum = 0.0, sumTotal = 0.0;
@@ -62,7 +65,7 @@ auto testSum()
  *  Should obviously be zero. */
 //______________________________________________________________________________
 template <typename Architecture_t>
-auto testIdentity()
+auto testIdentity(size_t nPrefetch = 0)
     -> typename Architecture_t::Scalar_t
 {
    using Scalar_t     = typename Architecture_t::Scalar_t;
@@ -71,7 +74,7 @@ auto testIdentity()
 
    TMatrixT<Double_t> X(2000, 100); randomMatrix(X);
    MatrixInput_t input(X, X);
-   DataLoader_t loader(input, 2000, 20, 100, 100);
+   DataLoader_t loader(input, 2000, 20, 100, 100, 1, nPrefetch);
 
    Net_t net(20, 100, ELossFunction::kMeanSquaredError);
    net.AddLayer(100,  EActivationFunction::kIdentity);
@@ -33,6 +33,14 @@ int main ()
    std::cout << "Identity: Maximum relative error = " << error << std::endl;
    maximumError = std::max(error, maximumError);
 
+   std::cout << "Testing data loader with prefetching:" << std::endl;
+   error = testSum<TCpu<Scalar_t>>(2);
+   std::cout << "Sum:      Maximum relative error = " << error << std::endl;
+   maximumError = std::max(error, maximumError);
+   error = testIdentity<TCpu<Scalar_t>>(2);
+   std::cout << "Identity: Maximum relative error = " << error << std::endl;
+   maximumError = std::max(error, maximumError);
+
    if (maximumError > 1e-3) {
       return 1;
    }
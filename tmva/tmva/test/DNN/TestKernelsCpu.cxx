@@ -0,0 +1,161 @@
+// @(#)root/tmva $Id$
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+//////////////////////////////////////////////////////////////////////
+// Benchmark of the element-wise and reduction kernels of the       //
+// multi-threaded CPU implementation against the reference          //
+// implementation. Each kernel is applied to a large random matrix  //
+// with both architectures, the results are compared and the        //
+// timings are printed.                                             //
+//////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include "TMatrixT.h"
+#include "TMVA/DNN/Architectures/Cpu.h"
+#include "TMVA/DNN/Architectures/Reference.h"
+#include "TMVA/DNN/Functions.h"
+#include "Utility.h"
+
+using namespace TMVA::DNN;
+
+using Scalar_t    = Double_t;
+using Cpu_t       = TCpu<Scalar_t>;
+using Reference_t = TReference<Scalar_t>;
+
+/*! Return the time in seconds taken by \p f(). */
+//______________________________________________________________________________
+template <typename Function_t>
+double timeIt(Function_t f)
+{
+   auto start = std::chrono::high_resolution_clock::now();
+   f();
+   auto stop = std::chrono::high_resolution_clock::now();
+   return std::chrono::duration<double>(stop - start).count();
+}
+
+/*! Print the timings of a kernel and return its maximum relative error. */
+//______________________________________________________________________________
+double report(const char *name, double tCpu, double tReference, double error)
+{
+   std::cout << std::setw(28) << std::left << name << ": ";
+   std::cout << "cpu " << std::setw(10) << tCpu << " s, ";
+   std::cout << "reference " << std::setw(10) << tReference << " s, ";
+   std::cout << "speedup " << std::setw(8) << tReference / tCpu << ", ";
+   std::cout << "maximum relative error = " << print_error(error) << std::endl;
+   return error;
+}
+
+/*! Benchmark the application of activation function \p f and of its
+ *  derivative on matrices of m times n elements. */
+//______________________________________________________________________________
+double benchmarkActivation(const char *name, EActivationFunction f, size_t m, size_t n)
+{
+   TMatrixT<Double_t> ARef(m, n), BRef(m, n);
+   randomMatrix(ARef);
+   TCpuMatrix<Scalar_t> ACpu(ARef), BCpu(m, n);
+
+   double error = 0.0;
+
+   double tCpu = timeIt([&]() {evaluateDerivative<Cpu_t>(BCpu, f, ACpu);});
+   double tRef = timeIt([&]() {evaluateDerivative<Reference_t>(BRef, f, ARef);});
+   TMatrixT<Double_t> B = BCpu;
+   error = std::max(error, report(Form("%s derivative", name), tCpu, tRef,
+                                  maximumRelativeError(B, BRef)));
+
+   tCpu = timeIt([&]() {evaluate<Cpu_t>(ACpu, f);});
+   tRef = timeIt([&]() {evaluate<Reference_t>(ARef, f);});
+   TMatrixT<Double_t> A = ACpu;
+   error = std::max(error, report(name, tCpu, tRef, maximumRelativeError(A, ARef)));
+
+   return error;
+}
+
+/*! Benchmark the evaluation of loss function \p f and of its gradients on
+ *  matrices of m times n elements. */
+//______________________________________________________________________________
+double benchmarkLoss(const char *name, ELossFunction f, size_t m, size_t n)
+{
+   TMatrixT<Double_t> YRef(m, n), outputRef(m, n), dYRef(m, n);
+   randomMatrix(outputRef);
+   for (size_t i = 0; i < m; i++) {
+      for (size_t j = 0; j < n; j++) {
+         YRef(i, j) = (outputRef(i, j) > 0.0) ? 1.0 : 0.0;
+      }
+   }
+   randomMatrix(outputRef);
+   TCpuMatrix<Scalar_t> YCpu(YRef), outputCpu(outputRef), dYCpu(m, n);
+
+   Scalar_t lossCpu = 0.0, lossRef = 0.0;
+   double tCpu = timeIt([&]() {lossCpu = evaluate<Cpu_t>(f, YCpu, outputCpu);});
+   double tRef = timeIt([&]() {lossRef = evaluate<Reference_t>(f, YRef, outputRef);});
+   double error = report(name, tCpu, tRef, std::fabs((lossCpu - lossRef) / lossRef));
+
+   tCpu = timeIt([&]() {evaluateGradients<Cpu_t>(dYCpu, f, YCpu, outputCpu);});
+   tRef = timeIt([&]() {evaluateGradients<Reference_t>(dYRef, f, YRef, outputRef);});
+   TMatrixT<Double_t> dY = dYCpu;
+   error = std::max(error, report(Form("%s gradients", name), tCpu, tRef,
+                                  maximumRelativeError(dY, dYRef)));
+
+   return error;
+}
+
+/*! Benchmark the evaluation of regularization \p r and of its gradients on
+ *  matrices of m times n elements. */
+//______________________________________________________________________________
+double benchmarkRegularization(const char *name, ERegularization r, size_t m, size_t n)
+{
+   TMatrixT<Double_t> ARef(m, n), BRef(m, n);
+   randomMatrix(ARef);
+   randomMatrix(BRef);
+   TCpuMatrix<Scalar_t> ACpu(ARef), BCpu(BRef);
+
+   Scalar_t regCpu = 0.0, regRef = 0.0;
+   double tCpu = timeIt([&]() {regCpu = regularization<Cpu_t>(ACpu, r);});
+   double tRef = timeIt([&]() {regRef = regularization<Reference_t>(ARef, r);});
+   double error = report(name, tCpu, tRef, std::fabs((regCpu - regRef) / regRef));
+
+   tCpu = timeIt([&]() {addRegularizationGradients<Cpu_t>(BCpu, ACpu, 1e-3, r);});
+   tRef = timeIt([&]() {addRegularizationGradients<Reference_t>(BRef, ARef, 1e-3, r);});
+   TMatrixT<Double_t> B = BCpu;
+   error = std::max(error, report(Form("%s gradients", name), tCpu, tRef,
+                                  maximumRelativeError(B, BRef)));
+
+   return error;
+}
+
+int main()
+{
+   // A batch of 4096 events in a layer of 256 neurons.
+   size_t m = 4096;
+   size_t n = 256;
+
+   std::cout << "Benchmarking CPU kernels on " << m << " x " << n << " matrices:" << std::endl;
+
+   double error = 0.0;
+
+   error = std::max(error, benchmarkActivation("ReLU", EActivationFunction::kRelu, m, n));
+   error = std::max(error, benchmarkActivation("Sigmoid", EActivationFunction::kSigmoid, m, n));
+   error = std::max(error, benchmarkActivation("TanH", EActivationFunction::kTanh, m, n));
+   error = std::max(error, benchmarkActivation("Gauss", EActivationFunction::kGauss, m, n));
+
+   error = std::max(error, benchmarkLoss("Mean squared error", ELossFunction::kMeanSquaredError, m, n));
+   error = std::max(error, benchmarkLoss("Cross entropy", ELossFunction::kCrossEntropy, m, n));
+
+   error = std::max(error, benchmarkRegularization("L1 regularization", ERegularization::kL1, m, n));
+   error = std::max(error, benchmarkRegularization("L2 regularization", ERegularization::kL2, m, n));
+
+   std::cout << "Maximum relative error = " << print_error(error) << std::endl;
+   if (error > 1e-8)
+      return 1;
+
+   return 0;
+}
@@ -60,6 +60,7 @@ protected:
    TBuffer    *fCompressedBufferRef; ///<! Compressed buffer.
    Bool_t      fOwnsCompressedBuffer; ///<! Whether or not we own the compressed buffer.
    Int_t       fLastWriteBufferSize; ///<! Size of the buffer last time we wrote it to disk
+   Int_t       fCompressedSize;      ///<! Size of the payload prepared by CompressBuffer (0: uncompressed, -1: not prepared)
 
 public:
 
@@ -69,6 +70,7 @@ public:
    virtual ~TBasket();
 
    virtual void    AdjustSize(Int_t newsize);
+           Int_t   CompressBuffer();
    virtual void    DeleteEntryOffset();
    virtual Int_t   DropBuffers();
    TBranch        *GetBranch() const {return fBranch;}
@@ -86,6 +88,7 @@ public:
    virtual void    Reset();
 
            Int_t   LoadBasketBuffers(Long64_t pos, Int_t len, TFile *file, TTree *tree = 0);
+           Int_t   RecompressBuffers(Int_t cxlevel, Int_t cxAlgorithm);
    Long64_t        CopyTo(TFile *to);
 
            void    SetBranch(TBranch *branch) { fBranch = branch; }
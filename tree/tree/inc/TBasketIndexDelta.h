@@ -0,0 +1,77 @@
+// @(#)root/tree:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TBasketIndexDelta
+#define ROOT_TBasketIndexDelta
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TBasketIndexDelta                                                    //
+//                                                                      //
+// Baskets written by the branches of a TTree since its previous        //
+// AutoSave, written by the incremental AutoSave instead of the whole   //
+// tree header.                                                         //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef ROOT_TObject
+#include "TObject.h"
+#endif
+#ifndef ROOT_TString
+#include "TString.h"
+#endif
+
+#include <vector>
+
+class TBranch;
+class TDirectory;
+class TTree;
+
+class TBasketIndexDelta : public TObject {
+
+protected:
+   Long64_t              fEntries;        ///<  Number of entries of the tree
+   Long64_t              fTotBytes;       ///<  Uncompressed bytes of the tree
+   Long64_t              fZipBytes;       ///<  Compressed bytes of the tree
+   Long64_t              fFlushedBytes;   ///<  Auto-flushed bytes of the tree
+   std::vector<Int_t>    fFirstBasket;    ///<  For each branch, number of baskets at the previous save
+   std::vector<Int_t>    fNbaskets;       ///<  For each branch, number of baskets written since
+   std::vector<Long64_t> fBranchEntries;  ///<  For each branch, number of entries
+   std::vector<Long64_t> fBranchTotBytes; ///<  For each branch, uncompressed bytes
+   std::vector<Long64_t> fBranchZipBytes; ///<  For each branch, compressed bytes
+   std::vector<Int_t>    fBasketBytes;    ///<  Length on file of the new baskets of all the branches
+   std::vector<Long64_t> fBasketEntry;    ///<  First entry of the new baskets of all the branches
+   std::vector<Long64_t> fBasketSeek;     ///<  Address of the new baskets of all the branches
+
+   Int_t                 fNdeltas;        ///<! Number of deltas written since the last full save
+   Int_t                 fNClusterRange;  ///<! Number of cluster ranges of the tree at the last full save
+   Long64_t              fAutoFlush;      ///<! AutoFlush of the tree at the last full save
+
+   static void CollectBranches(const TTree *tree, std::vector<TBranch*> &branches);
+
+public:
+   TBasketIndexDelta();
+   TBasketIndexDelta(const TTree *tree);
+   virtual ~TBasketIndexDelta();
+
+   Bool_t         Apply(TTree *tree) const;
+   Int_t          GetNdeltas() const { return fNdeltas; }
+   Bool_t         Update(const TTree *tree);
+   void           Reset(const TTree *tree, Bool_t full);
+
+   static TString GetKeyName(const TTree *tree);
+   static Int_t   ReadAll(TTree *tree, TDirectory *dir);
+   static void    DeleteAll(const TTree *tree, TDirectory *dir);
+
+   ClassDef(TBasketIndexDelta,1);  //Baskets written by a TTree since its previous AutoSave
+};
+
+#endif
@@ -40,6 +40,8 @@
 #include "TDataType.h"
 #endif
 
+#include <vector>
+
 class TTree;
 class TBasket;
 class TLeaf;
@@ -59,6 +61,7 @@ class TBranch : public TNamed , public TAttFill {
 
 protected:
    friend class TTreeCloner;
+   friend class TBasketIndexDelta;
    // TBranch status bits
    enum EStatusBits {
       kAutoDelete = BIT(15),
@@ -103,6 +106,11 @@ protected:
 
    Bool_t      fSkipZip;          ///<! After being read, the buffer will not be unzipped.
 
+   Bool_t      fDictSampling;     ///<! True while the small baskets are sampled to train a Zstd dictionary
+   UInt_t      fCompressionDict;  ///<! Id of the Zstd dictionary of the small baskets, 0 if none
+   std::vector<char>   fDictSamples;     ///<! Payloads of the sampled baskets
+   std::vector<size_t> fDictSampleSizes; ///<! Size of each sampled payload
+
    typedef void (TBranch::*ReadLeaves_t)(TBuffer &b);
    ReadLeaves_t fReadLeaves;      ///<! Pointer to the ReadLeaves implementation to use.
    typedef void (TBranch::*FillLeaves_t)(TBuffer &b);
@@ -123,6 +131,7 @@ protected:
 
 private:
    Int_t FillEntryBuffer(TBasket* basket,TBuffer* buf, Int_t& lnew);
+   TBasket *GetBasketImpl(Int_t basketnumber, Bool_t reuse);
    TBranch(const TBranch&);             // not implemented
    TBranch& operator=(const TBranch&);  // not implemented
 
@@ -134,6 +143,7 @@ public:
 
    virtual void      AddBasket(TBasket &b, Bool_t ondisk, Long64_t startEntry);
    virtual void      AddLastBasket(Long64_t startEntry);
+           void      AddCompressionSample(const char *buffer, Int_t len);
    virtual void      Browse(TBrowser *b);
    virtual void      DeleteBaskets(Option_t* option="");
    virtual void      DropBaskets(Option_t *option = "");
@@ -155,9 +165,12 @@ public:
            Int_t     GetCompressionAlgorithm() const;
            Int_t     GetCompressionLevel() const;
            Int_t     GetCompressionSettings() const;
+           UInt_t    GetCompressionDictionary() const { return fCompressionDict; }
    TDirectory       *GetDirectory() const {return fDirectory;}
    virtual Int_t     GetEntry(Long64_t entry=0, Int_t getall = 0);
    virtual Int_t     GetEntryExport(Long64_t entry, Int_t getall, TClonesArray *list, Int_t n);
+           TBuffer  *GetRawEntry(Long64_t entry, Int_t &nbytes);
+           Int_t     GetBulkEntries(Long64_t entry, TBuffer &user_buf);
            Int_t     GetEntryOffsetLen() const { return fEntryOffsetLen; }
            Int_t     GetEvent(Long64_t entry=0) {return GetEntry(entry);}
    const char       *GetIconName() const;
@@ -191,6 +204,7 @@ public:
    Bool_t            IsFolder() const;
    virtual void      KeepCircular(Long64_t maxEntries);
    virtual Int_t     LoadBaskets();
+           Int_t     PrefetchBaskets(Long64_t first, Long64_t last);
    virtual void      Print(Option_t *option="") const;
    virtual void      ReadBasket(TBuffer &b);
    virtual void      Refresh(TBranch *b);
@@ -216,6 +230,7 @@ public:
    virtual void      SetStatus(Bool_t status=1);
    virtual void      SetTree(TTree *tree) { fTree = tree;}
    virtual void      SetupAddresses();
+           UInt_t    TrainCompressionDictionary();
    virtual void      UpdateAddress() {;}
    virtual void      UpdateFile();
 
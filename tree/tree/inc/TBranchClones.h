@@ -39,6 +39,7 @@ protected:
    TBranch          *fBranchCount;    ///< Branch with clones count
 
    friend class TTreeCloner;
+   friend class TBasketIndexDelta;
 
    void Init(TTree *tree, TBranch *parent, const char *name, void *clonesaddress, Int_t basketsize=32000,Int_t compress=-1, Int_t splitlevel=1);
 
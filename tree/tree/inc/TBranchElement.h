@@ -63,7 +63,8 @@ protected:
       kOwnOnfileObj = BIT(19),  ///<  We are the owner of fOnfileObject.
       kAddressSet   = BIT(20),  ///<  The addressing set have been called for this branch
       kMakeClass    = BIT(21),  ///<  This branch has been switched to using the MakeClass Mode
-      kDecomposedObj= BIT(21)   ///<  More explicit alias for kMakeClass.
+      kDecomposedObj= BIT(21),  ///<  More explicit alias for kMakeClass.
+      kNoReferenceTracking = BIT(23) ///< Do not register the objects in the buffer map (see SetReferenceTracking)
    };
 
    // Note on fType values:
@@ -201,6 +202,7 @@ public:
            Int_t            GetID() const { return fID; }
            TStreamerInfo   *GetInfo() const;
            Bool_t           GetMakeClass() const;
+           Bool_t           GetReferenceTracking() const { return !TestBit(kNoReferenceTracking); }
            char            *GetObject() const;
    virtual const char      *GetParentName() const { return fParentName.Data(); }
    virtual Int_t            GetMaximum() const;
@@ -232,6 +234,7 @@ public:
    virtual void             SetOffset(Int_t offset);
    inline  void             SetParentClass(TClass* clparent);
    virtual void             SetParentName(const char* name) { fParentName = name; }
+           void             SetReferenceTracking(Bool_t track = kTRUE);
    virtual void             SetTargetClass(const char *name);
    virtual void             SetupAddresses();
    virtual void             SetType(Int_t btype) { fType = btype; }
@@ -31,6 +31,7 @@ class TCut;
 class TEntryList;
 class TEventList;
 class TCollection;
+class TTreeCache;
 
 class TChain : public TTree {
 
@@ -45,6 +46,7 @@ protected:
    TObjArray   *fFiles;            ///< -> List of file names containing the trees (TChainElement, owned)
    TList       *fStatus;           ///< -> List of active/inactive branches (TChainElement, owned)
    TChain      *fProofChain;       ///<! chain proxy when going to be processed by PROOF
+   TTreeCache  *fCacheDetached;    ///<! TTreeCache of the previous tree, waiting to be attached (with what it learnt) to the next one
 
 private:
    TChain(const TChain&);            // not implemented
@@ -53,6 +55,7 @@ private:
 
 protected:
    void InvalidateCurrentTree();
+   Bool_t LookupEntries();
    void ReleaseChainProof();
 
 public:
@@ -159,6 +162,7 @@ public:
    virtual void      SetEntryList(TEntryList *elist, Option_t *opt="");
    virtual void      SetEntryListFile(const char *filename="", Option_t *opt="");
    virtual void      SetEventList(TEventList *evlist);
+   virtual void      SetImplicitMTClusterMode(Bool_t enabled = kTRUE) { TTree::SetImplicitMTClusterMode(enabled); if (fTree) fTree->SetImplicitMTClusterMode(enabled);}
    virtual void      SetMakeClass(Int_t make) { TTree::SetMakeClass(make); if (fTree) fTree->SetMakeClass(make);}
    virtual void      SetPacketSize(Int_t size = 100);
    virtual void      SetProof(Bool_t on = kTRUE, Bool_t refresh = kFALSE, Bool_t gettreeheader = kFALSE);
@@ -26,6 +26,7 @@
 #endif
 
 class TBranch;
+class TFile;
 
 class TChainElement : public TNamed {
 
@@ -46,6 +47,7 @@ protected:
    char         *fPackets;           ///<! Packet descriptor string
    TBranch     **fBranchPtr;         ///<! Address of user branch pointer (to updated upon loading a file)
    Int_t         fLoadResult;        ///<! Return value of TChain::LoadTree(); 0 means success
+   TFile        *fFile;              ///<! File opened in advance by TChain::GetEntries, not yet used by TChain::LoadTree
 
 public:
    TChainElement();
@@ -58,6 +60,7 @@ public:
    virtual UInt_t      GetBaddressType() const { return fBaddressType; }
    virtual TBranch   **GetBranchPtr() const { return fBranchPtr; }
    virtual Long64_t    GetEntries() const {return fEntries;}
+           TFile      *GetFile() const { return fFile; }
            Int_t       GetLoadResult() const { return fLoadResult; }
    virtual char       *GetPackets() const {return fPackets;}
    virtual Int_t       GetPacketSize() const {return fPacketSize;}
@@ -69,11 +72,13 @@ public:
    virtual void        SetBaddressIsPtr(Bool_t isptr) { fBaddressIsPtr = isptr; }
    virtual void        SetBaddressType(UInt_t type) { fBaddressType = type; }
    virtual void        SetBranchPtr(TBranch **ptr) { fBranchPtr = ptr; }
+           void        SetFile(TFile *file);
            void        SetLoadResult(Int_t result) { fLoadResult = result; }
    virtual void        SetLookedUp(Bool_t y = kTRUE);
    virtual void        SetNumberEntries(Long64_t n) {fEntries=n;}
    virtual void        SetPacketSize(Int_t size = 100);
    virtual void        SetStatus(Int_t status) {fStatus = status;}
+           TFile      *TakeFile() { TFile *file = fFile; fFile = 0; return file; }
 
    ClassDef(TChainElement,2);  //A chain element
 };
@@ -65,6 +65,7 @@ class TEntryList: public TNamed
 
    virtual void        Add(const TEntryList *elist);
    virtual Int_t       Contains(Long64_t entry, TTree *tree = 0);
+   virtual Bool_t      ContainsRange(Long64_t entrymin, Long64_t entrymax);
    virtual void        DirectoryAutoAdd(TDirectory *);
    virtual Bool_t      Enter(Long64_t entry, TTree *tree = 0);
    virtual TEntryList *GetCurrentList() const { return fCurrent; };
@@ -82,6 +83,7 @@ class TEntryList: public TNamed
    virtual Int_t       Merge(TCollection *list);
 
    virtual Long64_t    Next();
+   virtual Long64_t    NextRun(Long64_t entry, Long64_t &last);
    virtual void        OptimizeStorage();
    virtual Int_t       RelocatePaths(const char *newloc, const char *oldloc = 0);
    virtual Bool_t      Remove(Long64_t entry, TTree *tree = 0);
@@ -32,6 +32,9 @@
 // - GetEntry(n) - returns n-th non-zero entry.
 // - Next()      - return next non-zero entry. In case of representation 1), Next()
 //                 is faster than GetEntry()
+// - Subtract()  - removes all entries of the other block from this one
+// - NextRun()   - returns the first entry of the next run of consecutive entries
+//                 and the last entry of that run
 //
 //////////////////////////////////////////////////////////////////////////
 
@@ -57,6 +60,7 @@ class TEntryListBlock:public TObject
    Int_t    fLastIndexReturned; ///<! to optimize GetEntry() in a loop
 
    void Transform(Bool_t dir, UShort_t *indexnew);
+   void GetBits(UShort_t *bits) const;
 
  public:
 
@@ -71,7 +75,9 @@ class TEntryListBlock:public TObject
    Int_t   Contains(Int_t entry);
    void    OptimizeStorage();
    Int_t   Merge(TEntryListBlock *block);
+   Int_t   Subtract(TEntryListBlock *block);
    Int_t   Next();
+   Int_t   NextRun(Int_t entry, Int_t &last);
    Int_t   GetEntry(Int_t entry);
    void    ResetIndices() {fLastIndexQueried = -1, fLastIndexReturned = -1;}
    Int_t   GetType() { return fType; }
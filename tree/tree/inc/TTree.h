@@ -94,6 +94,7 @@ class TTreeCache;
 class TTreeCloner;
 class TFileMergeInfo;
 class TVirtualPerfStats;
+class TBasketIndexDelta;
 
 class TTree : public TNamed, public TAttLine, public TAttFill, public TAttMarker {
 
@@ -152,6 +153,17 @@ protected:
    Bool_t         fIMTEnabled;            ///<! true if implicit multi-threading is enabled for this tree
    UInt_t         fNEntriesSinceSorting;  ///<! Number of entries processed since the last re-sorting of branches
    std::vector<std::pair<Long64_t,TBranch*>> fSortedBranches; ///<! Branches sorted by average task time
+   Bool_t         fIMTClusterMode;        ///<! true if the IMT tasks of GetEntry unzip the baskets of whole clusters
+   Long64_t       fIMTFirstEntry;         ///<! First entry of the cluster whose baskets were prefetched (cluster mode)
+   Long64_t       fIMTLastEntry;          ///<! End (excluded) of the cluster whose baskets were prefetched (cluster mode)
+   Long64_t       fAdaptiveBasketMemory;  ///<! Memory budget of the adaptive basket sizing, 0 if disabled
+   Long64_t       fAdaptiveBasketEntry;   ///<! Number of entries at the last basket re-balancing
+   Int_t          fAutoSaveDeltas;        ///<! Maximum number of incremental AutoSave between two full ones, 0 if disabled
+   TBasketIndexDelta *fBasketIndexDelta;  ///<! Baskets written since the previous AutoSave (see SetAutoSaveDeltas)
+   TTree         *fFriendMapMaster;       ///<! Master tree of the entries mapped with our index, 0 if none (see BuildFriendEntryMap)
+   Long64_t       fFriendMapFirst;        ///<! First entry of the master tree in the entry map
+   Long64_t       fFriendMapLast;         ///<! End (excluded) of the master entries in the entry map
+   std::vector<Long64_t> fFriendMap;      ///<! Our entry for each master entry of the map, empty for the identity
 
    static Int_t     fgBranchStyle;        ///<  Old/New branch style
    static Long64_t  fgMaxTreeSize;        ///<  Maximum size of a file containing a Tree
@@ -162,10 +174,23 @@ private:
 
    void             InitializeSortedBranches();
    void             SortBranchesByTime();
+   Int_t            PrefetchClusterBaskets(Long64_t entry, Int_t getall);
+   void             BuildFriendEntryMap(Long64_t entry, TTree *masterTree);
+
+   /// Sizes written by a branch, used by the adaptive basket sizing.
+   struct TBasketSizeInfo {
+      TBranch  *fBranch;       ///< Branch described
+      Long64_t  fTotBytes;     ///< Uncompressed bytes of the branch at the last re-balancing
+      Long64_t  fZipBytes;     ///< Compressed bytes of the branch at the last re-balancing
+      Double_t  fEntrySize;    ///< Running average of the uncompressed size of one entry
+      Double_t  fEntryZipSize; ///< Running average of the compressed size of one entry
+   };
+   std::vector<TBasketSizeInfo> fBasketSizeInfo; ///<! Per-branch sizes for the adaptive basket sizing
 
 protected:
    void             AddClone(TTree*);
    virtual void     KeepCircular();
+   virtual void     AdaptBaskets();
    virtual TBranch *BranchImp(const char* branchname, const char* classname, TClass* ptrClass, void* addobj, Int_t bufsize, Int_t splitlevel);
    virtual TBranch *BranchImp(const char* branchname, TClass* ptrClass, void* addobj, Int_t bufsize, Int_t splitlevel);
    virtual TBranch *BranchImpRef(const char* branchname, const char* classname, TClass* ptrClass, void* addobj, Int_t bufsize, Int_t splitlevel);
@@ -182,6 +207,8 @@ protected:
    void             ImportClusterRanges(TTree *fromtree);
    void             MoveReadCache(TFile *src, TDirectory *dir);
    Int_t            SetCacheSizeAux(Bool_t autocache = kTRUE, Long64_t cacheSize = 0);
+   void             TrainCompressionDictionaries();
+   void             WriteCompressionDictionaries();
 
    class TFriendLock {
       // Helper class to prevent infinite recursion in the
@@ -201,9 +228,12 @@ protected:
    friend class TFriendLock;
    // So that the index class can use TFriendLock:
    friend class TTreeIndex;
+   friend class TTreeCompactIndex;
    friend class TChainIndex;
    // So that the TTreeCloner can access the protected interfaces
    friend class TTreeCloner;
+   // So that the incremental AutoSave can record and restore the tree counters
+   friend class TBasketIndexDelta;
 
    // use to update fFriendLockStatus
    enum ELockStatusBits {
@@ -374,8 +404,10 @@ public:
    virtual Int_t           Fit(const char* funcname, const char* varexp, const char* selection = "", Option_t* option = "", Option_t* goption = "", Long64_t nentries = kMaxEntries, Long64_t firstentry = 0); // *MENU*
    virtual Int_t           FlushBaskets() const;
    virtual const char     *GetAlias(const char* aliasName) const;
+   virtual Long64_t        GetAdaptiveBaskets() const { return fAdaptiveBasketMemory; }
    virtual Long64_t        GetAutoFlush() const {return fAutoFlush;}
    virtual Long64_t        GetAutoSave()  const {return fAutoSave;}
+   virtual Int_t           GetAutoSaveDeltas() const {return fAutoSaveDeltas;}
    virtual TBranch        *GetBranch(const char* name);
    virtual TBranchRef     *GetBranchRef() const { return fBranchRef; };
    virtual Bool_t          GetBranchStatus(const char* branchname) const;
@@ -407,6 +439,7 @@ public:
    virtual const char     *GetFriendAlias(TTree*) const;
    TH1                    *GetHistogram() { return GetPlayer()->GetHistogram(); }
    virtual Bool_t          GetImplicitMT() { return fIMTEnabled; }
+   virtual Bool_t          GetImplicitMTClusterMode() const { return fIMTClusterMode; }
    virtual Int_t          *GetIndex() { return &fIndex.fArray[0]; }
    virtual Double_t       *GetIndexValues() { return &fIndexValues.fArray[0]; }
    virtual TIterator      *GetIteratorOnAllLeaves(Bool_t dir = kIterForward);
@@ -507,7 +540,9 @@ public:
    virtual void            ResetBranchAddresses();
    virtual Long64_t        Scan(const char* varexp = "", const char* selection = "", Option_t* option = "", Long64_t nentries = kMaxEntries, Long64_t firstentry = 0); // *MENU*
    virtual Bool_t          SetAlias(const char* aliasName, const char* aliasFormula);
+   virtual void            SetAdaptiveBaskets(Long64_t maxMemory = 10000000);
    virtual void            SetAutoSave(Long64_t autos = -300000000);
+   virtual void            SetAutoSaveDeltas(Int_t ndeltas = 100);
    virtual void            SetAutoFlush(Long64_t autof = -30000000);
    virtual void            SetBasketSize(const char* bname, Int_t buffsize = 16000);
 #if !defined(__CINT__)
@@ -547,6 +582,7 @@ public:
    virtual void            SetEventList(TEventList* list);
    virtual void            SetEntryList(TEntryList* list, Option_t *opt="");
    virtual void            SetImplicitMT(Bool_t enabled) { fIMTEnabled = enabled; }
+   virtual void            SetImplicitMTClusterMode(Bool_t enabled = kTRUE);
    virtual void            SetMakeClass(Int_t make);
    virtual void            SetMaxEntryLoop(Long64_t maxev = kMaxEntries) { fMaxEntryLoop = maxev; } // *MENU*
    static  void            SetMaxTreeSize(Long64_t maxsize = 1900000000);
@@ -29,6 +29,7 @@
 #include "TTreeCache.h"
 #endif
 
+#include <atomic>
 #include <queue>
 
 class TTree;
@@ -37,6 +38,7 @@ class TThread;
 class TCondition;
 class TBasket;
 class TMutex;
+class TTreeCacheUnzipTasks;
 
 class TTreeCacheUnzip : public TTreeCache {
 public:
@@ -62,11 +64,18 @@ protected:
    Int_t       fLastReadPos;
    Int_t       fBlocksToGo;
 
+   // Members for the task-based unzipping (implicit multi-threading)
+   TTreeCacheUnzipTasks *fUnzipTasks;  ///<! Task group running the unzip tasks, 0 if the threads are used
+   std::atomic<Int_t>    fNActiveTasks; ///<! Number of unzip tasks currently running
+   std::atomic<Int_t>    fUnzipNext;    ///<! Next block to be claimed by an unzip task
+   std::atomic<Bool_t>   fUnzipCancel;  ///<! Tells the unzip tasks to stop claiming blocks
+   static Int_t          fgUnzipConcurrency; ///< Max number of baskets unzipped concurrently (0: size of the IMT pool)
+
    // Unzipping related members
    Int_t      *fUnzipLen;         ///<! [fNseek] Length of the unzipped buffers
    char      **fUnzipChunks;      ///<! [fNseek] Individual unzipped chunks. Their summed size is kept under control.
-   Byte_t     *fUnzipStatus;      ///<! [fNSeek] For each blk, tells us if it's unzipped or pending
-   Long64_t    fTotalUnzipBytes;  ///<! The total sum of the currently unzipped blks
+   std::atomic<Byte_t> *fUnzipStatus; ///<! [fNSeek] For each blk, tells us if it's unzipped or pending
+   std::atomic<Long64_t> fTotalUnzipBytes; ///<! The total sum of the currently unzipped blks
 
    Int_t       fNseekMax;         ///<!  fNseek can change so we need to know its max size
    Long64_t    fUnzipBufferSize;  ///<!  Max Size for the ready unzipped blocks (default is 2*fBufferSize)
@@ -74,7 +83,7 @@ protected:
    static Double_t fgRelBuffSize; ///< This is the percentage of the TTreeCacheUnzip that will be used
 
    // Members use to keep statistics
-   Int_t       fNUnzip;           ///<! number of blocks that were unzipped
+   std::atomic<Int_t> fNUnzip;    ///<! number of blocks that were unzipped
    Int_t       fNFound;           ///<! number of blocks that were found in the cache
    Int_t       fNStalls;          ///<! number of hits which caused a stall
    Int_t       fNMissed;          ///<! number of blocks that were not found in the cache and were unzipped
@@ -92,6 +101,10 @@ private:
    void  Init();
    Int_t StartThreadUnzip(Int_t nthreads);
    Int_t StopThreadUnzip();
+   void  LaunchUnzipTasks();
+   void  StopUnzipTasks();
+   void  UnzipTask();
+   Int_t UnzipBlock(Int_t idx, Int_t &locbuffsz, char *&locbuff);
 
 public:
    TTreeCacheUnzip();
@@ -109,6 +122,8 @@ public:
    static EParUnzipMode GetParallelUnzip();
    static Bool_t        IsParallelUnzip();
    static Int_t         SetParallelUnzip(TTreeCacheUnzip::EParUnzipMode option = TTreeCacheUnzip::kEnable);
+   static Int_t         GetUnzipConcurrency();
+   static void          SetUnzipConcurrency(Int_t nbaskets);
 
    Bool_t               IsActiveThread();
    Bool_t               IsQueueEmpty();
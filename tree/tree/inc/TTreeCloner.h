@@ -50,6 +50,7 @@ class TTreeCloner {
    TObjArray  fToBranches;
 
    UInt_t     fMaxBaskets;
+   UInt_t     fNBaskets;         ///< Number of baskets to be copied, at most fMaxBaskets.
    UInt_t    *fBasketBranchNum;  ///<[fMaxBaskets] Index of the branch(es) of the basket.
    UInt_t    *fBasketNum;        ///<[fMaxBaskets] index of the basket within the branch.
 
@@ -60,7 +61,10 @@ class TTreeCloner {
    UShort_t   fPidOffset;        ///< Offset to be added to the copied key/basket.
 
    UInt_t     fCloneMethod;      ///< Indicates which cloning method was selected.
-   Long64_t   fToStartEntries;   ///< Number of entries in the target tree before any addition.
+   Long64_t   fToStartEntries;   ///< Offset of the entry numbers of the copied baskets in the target tree.
+   Long64_t   fFirstEntry;       ///< First entry of the range being copied by ExecRange.
+   Long64_t   fLastEntry;        ///< End (exclusive) of the range being copied by ExecRange, -1 for the whole tree.
+   Bool_t     fRangeStarted;     ///< True once ExecRange copied the streamer infos and process ids.
 
    Int_t           fCacheSize;   ///< Requested size of the file cache
    TFileCacheRead *fFileCache;   ///< File Cache used to reduce the number of individual reads
@@ -104,7 +108,8 @@ public:
       kNone       = 0,
       kNoWarnings = BIT(1),
       kIgnoreMissingTopLevel = BIT(2),
-      kNoFileCache = BIT(3)
+      kNoFileCache = BIT(3),
+      kRecompress  = BIT(4)
    };
 
    TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t options = kNone);
@@ -117,9 +122,12 @@ public:
    void   CollectBaskets();
    void   CopyMemoryBaskets();
    void   CopyStreamerInfos();
+   void   CopyCompressionDictionaries();
    void   CopyProcessIds();
    const char *GetWarning() const { return fWarningMsg; }
    Bool_t Exec();
+   Bool_t ExecRange(Long64_t first, Long64_t last);
+   Bool_t IsRangeAligned(Long64_t first, Long64_t last) const;
    Bool_t IsValid() { return fIsValid; }
    Bool_t NeedConversion() { return fNeedConversion; }
    void   SetCacheSize(Int_t size);
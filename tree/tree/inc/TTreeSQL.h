@@ -52,6 +52,9 @@ protected:
    TSQLRow               *fRow;
    TSQLServer            *fServer;
    Bool_t                 fBranchChecked;
+   TString                fPendingRows;   ///<! Values of the rows filled and not yet sent to the database
+   Int_t                  fNPendingRows;  ///<! Number of rows in fPendingRows
+   Int_t                  fBatchSize;     ///<! Maximum number of rows sent with one INSERT query
 
    void                   CheckBasket(TBranch * tb);
    Bool_t                 CheckBranch(TBranch * tb);
@@ -70,6 +73,7 @@ protected:
 
 public:
    TTreeSQL(TSQLServer * server, TString DB, const TString& table);
+   virtual ~TTreeSQL();
 
    virtual Int_t          Branch(TCollection *list, Int_t bufsize=32000, Int_t splitlevel=99, const char *name="");
    virtual Int_t          Branch(TList *list, Int_t bufsize=32000, Int_t splitlevel=99);
@@ -83,6 +87,9 @@ public:
    virtual TBranch       *Branch(const char *name, void *address, const char *leaflist, Int_t bufsize);
 
    virtual Int_t          Fill();
+           Int_t          FlushRows();
+           Int_t          GetBatchSize() const { return fBatchSize; }
+           void           SetBatchSize(Int_t rows = 100);
    virtual Int_t          GetEntry(Long64_t entry=0, Int_t getall=0);
    virtual Long64_t       GetEntries()    const;
    virtual Long64_t       GetEntries(const char *sel) { return TTree::GetEntries(sel); }
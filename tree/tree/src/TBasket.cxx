@@ -9,6 +9,7 @@
  *************************************************************************/
 
 #include "TBasket.h"
+#include "Compression.h"
 #include "TBuffer.h"
 #include "TBufferFile.h"
 #include "TTree.h"
@@ -22,6 +23,10 @@
 #include "TVirtualPerfStats.h"
 #include "TTimeStamp.h"
 #include "RZip.h"
+#include "ROOT/TBufferPool.hxx"
+#include "ROOT/TTrace.hxx"
+
+#include <vector>
 
 const UInt_t kDisplacementMask = 0xFF000000;  // In the streamer the two highest bytes of
                                               // the fEntryOffset are used to stored displacement.
@@ -39,7 +44,7 @@ See picture in TTree.
 ////////////////////////////////////////////////////////////////////////////////
 /// Default contructor.
 
-TBasket::TBasket() : fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0)
+TBasket::TBasket() : fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0), fCompressedSize(-1)
 {
    fDisplacement  = 0;
    fEntryOffset   = 0;
@@ -56,7 +61,7 @@ TBasket::TBasket() : fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLa
 ////////////////////////////////////////////////////////////////////////////////
 /// Constructor used during reading.
 
-TBasket::TBasket(TDirectory *motherDir) : TKey(motherDir),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0)
+TBasket::TBasket(TDirectory *motherDir) : TKey(motherDir),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0), fCompressedSize(-1)
 {
    fDisplacement  = 0;
    fEntryOffset   = 0;
@@ -74,7 +79,7 @@ TBasket::TBasket(TDirectory *motherDir) : TKey(motherDir),fCompressedBufferRef(0
 /// Basket normal constructor, used during writing.
 
 TBasket::TBasket(const char *name, const char *title, TBranch *branch) :
-   TKey(branch->GetDirectory()),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0)
+   TKey(branch->GetDirectory()),fCompressedBufferRef(0), fOwnsCompressedBuffer(kFALSE), fLastWriteBufferSize(0), fCompressedSize(-1)
 {
    SetName(name);
    SetTitle(title);
@@ -101,7 +106,7 @@ TBasket::TBasket(const char *name, const char *title, TBranch *branch) :
 #endif
       fOwnsCompressedBuffer = kFALSE;
       if (!fCompressedBufferRef) {
-         fCompressedBufferRef = new TBufferFile(TBuffer::kRead, fBufferSize);
+         fCompressedBufferRef = ROOT::Internal::TBufferPool::CreateBuffer(TBuffer::kRead, fBufferSize);
          fOwnsCompressedBuffer = kTRUE;
       }
    }
@@ -126,14 +131,14 @@ TBasket::~TBasket()
 {
    if (fDisplacement) delete [] fDisplacement;
    if (fEntryOffset)  delete [] fEntryOffset;
-   if (fBufferRef) delete fBufferRef;
+   ROOT::Internal::TBufferPool::DeleteBuffer(fBufferRef);
    fBufferRef = 0;
    fBuffer = 0;
    fDisplacement= 0;
    fEntryOffset = 0;
    // Note we only delete the compressed buffer if we own it
    if (fCompressedBufferRef && fOwnsCompressedBuffer) {
-      delete fCompressedBufferRef;
+      ROOT::Internal::TBufferPool::DeleteBuffer(fCompressedBufferRef);
       fCompressedBufferRef = 0;
    }
 }
@@ -190,8 +195,8 @@ Int_t TBasket::DropBuffers()
 
    if (fDisplacement) delete [] fDisplacement;
    if (fEntryOffset)  delete [] fEntryOffset;
-   if (fBufferRef)    delete fBufferRef;
-   if (fCompressedBufferRef && fOwnsCompressedBuffer) delete fCompressedBufferRef;
+   ROOT::Internal::TBufferPool::DeleteBuffer(fBufferRef);
+   if (fCompressedBufferRef && fOwnsCompressedBuffer) ROOT::Internal::TBufferPool::DeleteBuffer(fCompressedBufferRef);
    fBufferRef   = 0;
    fCompressedBufferRef = 0;
    fBuffer      = 0;
@@ -232,7 +237,7 @@ Int_t TBasket::LoadBasketBuffers(Long64_t pos, Int_t len, TFile *file, TTree *tr
       }
       fBufferRef->SetReadMode();
    } else {
-      fBufferRef = new TBufferFile(TBuffer::kRead, len);
+      fBufferRef = ROOT::Internal::TBufferPool::CreateBuffer(TBuffer::kRead, len);
    }
    fBufferRef->SetParent(file);
    char *buffer = fBufferRef->Buffer();
@@ -279,6 +284,83 @@ Int_t TBasket::LoadBasketBuffers(Long64_t pos, Int_t len, TFile *file, TTree *tr
    return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Recompress the payload of the basket buffers loaded by LoadBasketBuffers
+/// with the given compression level and algorithm, keeping the basket
+/// content (entries and offsets) untouched. The key header is not updated,
+/// this is done by CopyTo.
+///
+/// Only the buffer of this basket is modified, hence several baskets can be
+/// recompressed concurrently. This function is called by TTreeCloner.
+/// The function returns 0 in case of success, 1 in case of error, in which
+/// case the basket buffers are left as they were loaded.
+
+Int_t TBasket::RecompressBuffers(Int_t cxlevel, Int_t cxAlgorithm)
+{
+   if (!fBufferRef || fObjlen <= 0) return 1;
+
+   // Uncompress the payload.
+   char *payload = fBufferRef->Buffer() + fKeylen;
+   std::vector<char> objbuf(fObjlen);
+   if (fNbytes - fKeylen < fObjlen) {
+      UChar_t *bufcur = (UChar_t *)payload;
+      char *objcur = &objbuf[0];
+      Int_t nin, nbuf, nout = 0;
+      Int_t noutot = 0;
+      while (noutot < fObjlen) {
+         if (R__unzip_header(&nin, bufcur, &nbuf) != 0) break;
+         if (noutot + nbuf > fObjlen) break;
+         R__unzip(&nin, bufcur, &nbuf, (unsigned char*) objcur, &nout);
+         if (!nout) break;
+         noutot += nout;
+         bufcur += nin;
+         objcur += nout;
+      }
+      if (noutot != fObjlen) return 1;
+   } else {
+      memcpy(&objbuf[0], payload, fObjlen);
+   }
+
+   // Compress it again, directly in place of the old payload.
+   Int_t nbuffers = 1 + (fObjlen - 1) / kMAXZIPBUF;
+   Int_t buflen = fKeylen + fObjlen + 9 * nbuffers + 28;
+   Bool_t writing = fBufferRef->IsWriting();
+   fBufferRef->SetWriteMode();
+   if (fBufferRef->BufferSize() < buflen) {
+      fBufferRef->Expand(buflen);
+   }
+   if (!writing) fBufferRef->SetReadMode();
+   payload = fBufferRef->Buffer() + fKeylen;
+
+   Int_t noutot = 0;
+   if (cxlevel > 0) {
+      char *objcur = &objbuf[0];
+      char *bufcur = payload;
+      Int_t nout, bufmax;
+      Int_t nzip = 0;
+      for (Int_t i = 0; i < nbuffers; ++i) {
+         if (i == nbuffers - 1) bufmax = fObjlen - nzip;
+         else bufmax = kMAXZIPBUF;
+         R__zipMultipleAlgorithm(cxlevel, &bufmax, objcur, &bufmax, bufcur, &nout, cxAlgorithm);
+         if (nout == 0 || nout >= fObjlen) {
+            // Not compressible, store the payload uncompressed.
+            noutot = 0;
+            break;
+         }
+         bufcur += nout;
+         noutot += nout;
+         objcur += kMAXZIPBUF;
+         nzip   += kMAXZIPBUF;
+      }
+   }
+   if (noutot == 0) {
+      memcpy(payload, &objbuf[0], fObjlen);
+      noutot = fObjlen;
+   }
+   fNbytes = fKeylen + noutot;
+   return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Remove the first dentries of this basket, moving entries at
 /// dentries to the start of the buffer.
@@ -354,12 +436,19 @@ Int_t TBasket::ReadBasketBuffersUncompressedCase()
 
 Int_t TBasket::ReadBasketBuffersUnzip(char* buffer, Int_t size, Bool_t mustFree, TFile* file)
 {
+   // The buffers handed over by TTreeCacheUnzip come from the buffer pool.
    if (fBufferRef) {
-      fBufferRef->SetBuffer(buffer, size, mustFree);
+      if (mustFree) {
+         ROOT::Internal::TBufferPool::AdoptBlock(*fBufferRef, buffer, size);
+      } else {
+         ROOT::Internal::TBufferPool::ReleaseBuffer(*fBufferRef);
+         fBufferRef->SetBuffer(buffer, size, mustFree);
+      }
       fBufferRef->SetReadMode();
       fBufferRef->Reset();
    } else {
-      fBufferRef = new TBufferFile(TBuffer::kRead, size, buffer, mustFree);
+      fBufferRef = new TBufferFile(TBuffer::kRead, size, buffer, mustFree,
+                                   mustFree ? &ROOT::Internal::TBufferPool::ReAlloc : 0);
    }
    fBufferRef->SetParent(file);
 
@@ -395,7 +484,7 @@ static inline TBuffer* R__InitializeReadBasketBuffer(TBuffer* bufferRef, Int_t l
       bufferRef->Reset();
       result = bufferRef;
    } else {
-      result = new TBufferFile(TBuffer::kRead, len);
+      result = ROOT::Internal::TBufferPool::CreateBuffer(TBuffer::kRead, len);
    }
    result->SetParent(file);
    return result;
@@ -447,7 +536,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
    if (pf) {
       Int_t res = -1;
       Bool_t free = kTRUE;
-      char *buffer;
+      char *buffer = nullptr;
       res = pf->GetUnzipBuffer(&buffer, pos, len, &free);
       if (R__unlikely(res >= 0)) {
          len = ReadBasketBuffersUnzip(buffer, res, free, file);
@@ -481,6 +570,9 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
    if (pf) {
       TVirtualPerfStats* temp = gPerfStats;
       if (fBranch->GetTree()->GetPerfStats() != 0) gPerfStats = fBranch->GetTree()->GetPerfStats();
+      Double_t readStart = 0;
+      if (R__unlikely(gPerfStats)) readStart = TTimeStamp();
+      Bool_t cacheMiss = kFALSE;
       Int_t st = 0;
       {
          R__LOCKGUARD_IMT2(gROOTMutex); // Lock for parallel TTree I/O
@@ -502,18 +594,23 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
          if (ret) {
             return 1;
          }
+         cacheMiss = kTRUE;
       }
+      if (R__unlikely(gPerfStats)) gPerfStats->BasketReadEvent(fBranch, len, readStart, cacheMiss);
       gPerfStats = temp;
    } else {
       // Read from the file and unstream the header information.
       TVirtualPerfStats* temp = gPerfStats;
       if (fBranch->GetTree()->GetPerfStats() != 0) gPerfStats = fBranch->GetTree()->GetPerfStats();
+      Double_t readStart = 0;
+      if (R__unlikely(gPerfStats)) readStart = TTimeStamp();
       R__LOCKGUARD_IMT2(gROOTMutex);  // Lock for parallel TTree I/O
       if (file->ReadBuffer(readBufferRef->Buffer(),pos,len)) {
          gPerfStats = temp;
          return 1;
       }
-      else gPerfStats = temp;
+      if (R__unlikely(gPerfStats)) gPerfStats->BasketReadEvent(fBranch, len, readStart, kTRUE);
+      gPerfStats = temp;
    }
    Streamer(*readBufferRef);
    if (IsZombie()) {
@@ -560,7 +657,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
 
       // Optional monitor for zip time profiling.
       Double_t start = 0;
-      if (R__unlikely(gPerfStats)) {
+      if (R__unlikely(gPerfStats || fBranch->GetTree()->GetPerfStats())) {
          start = TTimeStamp();
       }
 
@@ -571,6 +668,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       Int_t nout = 0, noutot = 0, nintot = 0;
 
       // Unzip all the compressed objects in the compressed object buffer.
+      R__TRACE_ZONE("TBasket::Unzip", "io");
       while (1) {
          // Check the header for errors.
          if (R__unlikely(R__unzip_header(&nin, rawCompressedObjectBuffer, &nbuf) != 0)) {
@@ -603,6 +701,7 @@ Int_t TBasket::ReadBasketBuffers(Long64_t pos, Int_t len, TFile *file)
       if (fBranch->GetTree()->GetPerfStats() != 0) gPerfStats = fBranch->GetTree()->GetPerfStats();
       if (R__unlikely(gPerfStats)) {
          gPerfStats->UnzipEvent(fBranch->GetTree(),pos,start,nintot,fObjlen);
+         gPerfStats->BasketUnzipEvent(fBranch,start,nintot,fObjlen);
       }
       gPerfStats = temp;
    } else {
@@ -724,6 +823,7 @@ void TBasket::Reset()
    Int_t *storeDisplacement = fDisplacement;
    fDisplacement= 0;
    fBuffer      = 0;
+   fCompressedSize = -1;
 
    fBufferRef->Reset();
    fBufferRef->SetWriteMode();
@@ -916,44 +1016,28 @@ void TBasket::Update(Int_t offset, Int_t skipped)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Write buffer of this basket on the current file.
+/// Compress the content of this basket into the compressed buffer.
 ///
-/// The function returns the number of bytes committed to the memory.
-/// If a write error occurs, the number of bytes returned is -1.
-/// If no data are written, the number of bytes returned is 0.
+/// This is the first half of WriteBuffer: it finalizes the payload (the
+/// entry offset table is transferred at the end of fBuffer) and compresses
+/// it, but it neither allocates space in the file nor writes anything.
+/// It can therefore be run concurrently for baskets that do not share
+/// their compressed buffer (e.g. baskets of different branches when
+/// implicit multi-threading is enabled). WriteBuffer will then skip the
+/// compression step.
+///
+/// The function returns the number of bytes of the (possibly compressed)
+/// payload or -1 in case of error.
 
-Int_t TBasket::WriteBuffer()
+Int_t TBasket::CompressBuffer()
 {
-   const Int_t kWrite = 1;
-
-   TFile *file = fBranch->GetFile(kWrite);
-   if (!file) return 0;
-   if (!file->IsWritable()) {
-      return -1;
+   if (fCompressedSize >= 0) {
+      // Already done, the basket has not been written yet.
+      return fCompressedSize ? fCompressedSize : fObjlen;
    }
-   fMotherDir = file; // fBranch->GetDirectory();
-
-   if (R__unlikely(fBufferRef->TestBit(TBufferFile::kNotDecompressed))) {
-      // Read the basket information that was saved inside the buffer.
-      Bool_t writing = fBufferRef->IsWriting();
-      fBufferRef->SetReadMode();
-      fBufferRef->SetBufferOffset(0);
-
-      Streamer(*fBufferRef);
-      if (writing) fBufferRef->SetWriteMode();
-      Int_t nout = fNbytes - fKeylen;
-
-      fBuffer = fBufferRef->Buffer();
-
-      Create(nout,file);
-      fBufferRef->SetBufferOffset(0);
-      fHeaderOnly = kTRUE;
 
-      Streamer(*fBufferRef);         //write key itself again
-      int nBytes = WriteFileKeepBuffer();
-      fHeaderOnly = kFALSE;
-      return nBytes>0 ? fKeylen+nout : -1;
-   }
+   const Int_t kWrite = 1;
+   TFile *file = fBranch->GetFile(kWrite);
 
    // Transfer fEntryOffset table at the end of fBuffer.
    fLast = fBufferRef->Length();
@@ -976,8 +1060,9 @@ Int_t TBasket::WriteBuffer()
    lbuf       = fBufferRef->Length();
    fObjlen    = lbuf - fKeylen;
 
-   fHeaderOnly = kTRUE;
-   fCycle = fBranch->GetWriteBasket();
+   // By default the payload is stored uncompressed.
+   fCompressedSize = 0;
+
    Int_t cxlevel = fBranch->GetCompressionLevel();
    Int_t cxAlgorithm = fBranch->GetCompressionAlgorithm();
    if (cxlevel > 0) {
@@ -986,59 +1071,117 @@ Int_t TBasket::WriteBuffer()
       InitializeCompressedBuffer(buflen, file);
       if (!fCompressedBufferRef) {
          Warning("WriteBuffer", "Unable to allocate the compressed buffer");
+         fCompressedSize = -1;
          return -1;
       }
       fCompressedBufferRef->SetWriteMode();
-      fBuffer = fCompressedBufferRef->Buffer();
       char *objbuf = fBufferRef->Buffer() + fKeylen;
-      char *bufcur = &fBuffer[fKeylen];
+      char *bufcur = fCompressedBufferRef->Buffer() + fKeylen;
+      // Small baskets of the first cluster train the Zstd dictionary used
+      // for the following ones (see TBranch::TrainCompressionDictionary).
+      fBranch->AddCompressionSample(objbuf, fObjlen);
+      UInt_t dictID = (nbuffers == 1 && cxAlgorithm == ROOT::kZSTD) ? fBranch->GetCompressionDictionary() : 0;
       noutot = 0;
       nzip   = 0;
       for (Int_t i = 0; i < nbuffers; ++i) {
          if (i == nbuffers - 1) bufmax = fObjlen - nzip;
          else bufmax = kMAXZIPBUF;
          //compress the buffer
-         R__zipMultipleAlgorithm(cxlevel, &bufmax, objbuf, &bufmax, bufcur, &nout, cxAlgorithm);
+         if (dictID) {
+            R__zipZSTDDict(cxlevel, &bufmax, objbuf, &bufmax, bufcur, &nout, dictID);
+         } else {
+            R__zipMultipleAlgorithm(cxlevel, &bufmax, objbuf, &bufmax, bufcur, &nout, cxAlgorithm);
+         }
 
          // test if buffer has really been compressed. In case of small buffers
          // when the buffer contains random data, it may happen that the compressed
          // buffer is larger than the input. In this case, we write the original uncompressed buffer
          if (nout == 0 || nout >= fObjlen) {
-            nout = fObjlen;
             // We used to delete fBuffer here, we no longer want to since
             // the buffer (held by fCompressedBufferRef) might be re-used later.
-            fBuffer = fBufferRef->Buffer();
-            Create(fObjlen,file);
-            fBufferRef->SetBufferOffset(0);
-
-            Streamer(*fBufferRef);         //write key itself again
-            if ((nout+fKeylen)>buflen) {
+            if ((fObjlen+fKeylen)>buflen) {
                Warning("WriteBuffer","Possible memory corruption due to compression algorithm, wrote %d bytes past the end of a block of %d bytes. fNbytes=%d, fObjLen=%d, fKeylen=%d",
-                  (nout+fKeylen-buflen),buflen,fNbytes,fObjlen,fKeylen);
+                  (fObjlen+fKeylen-buflen),buflen,fNbytes,fObjlen,fKeylen);
             }
-            goto WriteFile;
+            return fObjlen;
          }
          bufcur += nout;
          noutot += nout;
          objbuf += kMAXZIPBUF;
          nzip   += kMAXZIPBUF;
       }
-      nout = noutot;
-      Create(noutot,file);
+      fCompressedSize = noutot;
+      return noutot;
+   }
+   return fObjlen;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write buffer of this basket on the current file.
+///
+/// The function returns the number of bytes committed to the memory.
+/// If a write error occurs, the number of bytes returned is -1.
+/// If no data are written, the number of bytes returned is 0.
+
+Int_t TBasket::WriteBuffer()
+{
+   const Int_t kWrite = 1;
+
+   TFile *file = fBranch->GetFile(kWrite);
+   if (!file) return 0;
+   if (!file->IsWritable()) {
+      return -1;
+   }
+   fMotherDir = file; // fBranch->GetDirectory();
+
+   if (R__unlikely(fBufferRef->TestBit(TBufferFile::kNotDecompressed))) {
+      // Read the basket information that was saved inside the buffer.
+      Bool_t writing = fBufferRef->IsWriting();
+      fBufferRef->SetReadMode();
+      fBufferRef->SetBufferOffset(0);
+
+      Streamer(*fBufferRef);
+      if (writing) fBufferRef->SetWriteMode();
+      Int_t nout = fNbytes - fKeylen;
+
+      fBuffer = fBufferRef->Buffer();
+
+      Create(nout,file);
+      fBufferRef->SetBufferOffset(0);
+      fHeaderOnly = kTRUE;
+
+      Streamer(*fBufferRef);         //write key itself again
+      int nBytes = WriteFileKeepBuffer();
+      fHeaderOnly = kFALSE;
+      return nBytes>0 ? fKeylen+nout : -1;
+   }
+
+   // Compress the payload unless this was already done (see CompressBuffer).
+   if (CompressBuffer() < 0) {
+      return -1;
+   }
+
+   Int_t nout;
+   fHeaderOnly = kTRUE;
+   fCycle = fBranch->GetWriteBasket();
+   if (fCompressedSize > 0) {
+      nout = fCompressedSize;
+      fBuffer = fCompressedBufferRef->Buffer();
+      Create(nout,file);
       fBufferRef->SetBufferOffset(0);
 
       Streamer(*fBufferRef);         //write key itself again
       memcpy(fBuffer,fBufferRef->Buffer(),fKeylen);
    } else {
+      nout = fObjlen;
       fBuffer = fBufferRef->Buffer();
       Create(fObjlen,file);
       fBufferRef->SetBufferOffset(0);
 
       Streamer(*fBufferRef);         //write key itself again
-      nout = fObjlen;
    }
+   fCompressedSize = -1;
 
-WriteFile:
    Int_t nBytes = WriteFileKeepBuffer();
    fHeaderOnly = kFALSE;
    return nBytes>0 ? fKeylen+nout : -1;
@@ -0,0 +1,303 @@
+// @(#)root/tree:$Id$
+// Author: ROOT core team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TBasketIndexDelta
+\ingroup tree
+
+Baskets written by the branches of a TTree since its previous AutoSave.
+
+TTree::AutoSave writes the whole tree header, including the basket tables
+(fBasketBytes, fBasketEntry and fBasketSeek) of all the branches, whose
+size grows with the number of baskets written so far. With
+TTree::SetAutoSaveDeltas(n), AutoSave writes the full header only every
+n+1 calls and otherwise one TBasketIndexDelta, under the key
+`<treename>_baskets`, holding only the new baskets of each branch and the
+counters of the branches and of the tree. The records are append-only: a
+new cycle of the key is written at each AutoSave, and all of them are
+deleted when the full header is written again.
+
+When the tree header is read from a file (see TTree::DirectoryAutoAdd),
+the records are applied in the order of their cycles. A record is applied
+only if it continues the basket tables of the header or of the previous
+record, so that the records older than the header are skipped; the tree
+thus comes back up to its last AutoSave, as if the full header had been
+written each time.
+
+A record only describes baskets on file, so the incremental AutoSave
+always flushes the baskets first. Adding branches or changing the cluster
+ranges (SetAutoFlush) forces a full write of the header.
+*/
+
+#include "TBasketIndexDelta.h"
+
+#include "TBasket.h"
+#include "TBranch.h"
+#include "TBranchClones.h"
+#include "TBranchRef.h"
+#include "TDirectory.h"
+#include "TKey.h"
+#include "TList.h"
+#include "TTree.h"
+
+#include <algorithm>
+#include <string.h>
+
+ClassImp(TBasketIndexDelta)
+
+////////////////////////////////////////////////////////////////////////////////
+/// Default constructor, used when reading.
+
+TBasketIndexDelta::TBasketIndexDelta() :
+   fEntries(0), fTotBytes(0), fZipBytes(0), fFlushedBytes(0),
+   fNdeltas(0), fNClusterRange(0), fAutoFlush(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Start recording the baskets written by tree after its current state,
+/// which was just saved with the full header.
+
+TBasketIndexDelta::TBasketIndexDelta(const TTree *tree) :
+   fEntries(0), fTotBytes(0), fZipBytes(0), fFlushedBytes(0),
+   fNdeltas(0), fNClusterRange(0), fAutoFlush(0)
+{
+   Reset(tree, kTRUE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+TBasketIndexDelta::~TBasketIndexDelta()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Append the branches of tree, and their sub-branches, to branches, in an
+/// order which only depends on the structure of the tree.
+
+void TBasketIndexDelta::CollectBranches(const TTree *tree, std::vector<TBranch*> &branches)
+{
+   std::vector<const TObjArray*> lists(1, &tree->fBranches);
+   while (!lists.empty()) {
+      const TObjArray *list = lists.back();
+      lists.pop_back();
+      for (Int_t i = list->GetEntriesFast() - 1; i >= 0; --i) {
+         TBranch *branch = (TBranch*)list->UncheckedAt(i);
+         if (!branch) continue;
+         branches.push_back(branch);
+         if (branch->InheritsFrom(TBranchClones::Class()) && ((TBranchClones*)branch)->fBranchCount) {
+            branches.push_back(((TBranchClones*)branch)->fBranchCount);
+         }
+         lists.push_back(&branch->fBranches);
+      }
+   }
+   if (tree->fBranchRef) {
+      branches.push_back(tree->fBranchRef);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the current state of tree as saved: the next Update starts from
+/// it. If full, the full header was written and the count of deltas restarts.
+
+void TBasketIndexDelta::Reset(const TTree *tree, Bool_t full)
+{
+   std::vector<TBranch*> branches;
+   CollectBranches(tree, branches);
+   fFirstBasket.resize(branches.size());
+   for (size_t i = 0; i < branches.size(); ++i) {
+      fFirstBasket[i] = branches[i]->GetWriteBasket();
+   }
+   fNbaskets.clear();
+   fBranchEntries.clear();
+   fBranchTotBytes.clear();
+   fBranchZipBytes.clear();
+   fBasketBytes.clear();
+   fBasketEntry.clear();
+   fBasketSeek.clear();
+   if (full) {
+      fNdeltas = 0;
+      fNClusterRange = tree->fNClusterRange;
+      fAutoFlush = tree->fAutoFlush;
+   } else {
+      ++fNdeltas;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Collect the baskets written by tree since the previous save. Returns
+/// false if a delta cannot describe the changes, which then require a full
+/// write of the header: new branches, new cluster ranges or baskets still
+/// in memory.
+
+Bool_t TBasketIndexDelta::Update(const TTree *tree)
+{
+   if (tree->fNClusterRange != fNClusterRange || tree->fAutoFlush != fAutoFlush) {
+      return kFALSE;
+   }
+   std::vector<TBranch*> branches;
+   CollectBranches(tree, branches);
+   if (branches.size() != fFirstBasket.size()) {
+      return kFALSE;
+   }
+
+   fNbaskets.resize(branches.size());
+   fBranchEntries.resize(branches.size());
+   fBranchTotBytes.resize(branches.size());
+   fBranchZipBytes.resize(branches.size());
+   fBasketBytes.clear();
+   fBasketEntry.clear();
+   fBasketSeek.clear();
+   for (size_t i = 0; i < branches.size(); ++i) {
+      TBranch *branch = branches[i];
+      Int_t writeBasket = branch->GetWriteBasket();
+      TBasket *basket = (TBasket*)branch->fBaskets.At(writeBasket);
+      if (writeBasket < fFirstBasket[i] || (basket && basket->GetNevBuf())) {
+         return kFALSE;
+      }
+      fNbaskets[i] = writeBasket - fFirstBasket[i];
+      fBranchEntries[i] = branch->fEntries;
+      fBranchTotBytes[i] = branch->fTotBytes;
+      fBranchZipBytes[i] = branch->fZipBytes;
+      for (Int_t b = fFirstBasket[i]; b < writeBasket; ++b) {
+         fBasketBytes.push_back(branch->fBasketBytes[b]);
+         fBasketEntry.push_back(branch->fBasketEntry[b]);
+         fBasketSeek.push_back(branch->fBasketSeek[b]);
+      }
+   }
+   fEntries = tree->fEntries;
+   fTotBytes = tree->fTotBytes;
+   fZipBytes = tree->fZipBytes;
+   fFlushedBytes = tree->fFlushedBytes;
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Append the baskets of this record to the branches of tree, which was just
+/// read. Returns false, leaving tree unchanged, if the record does not
+/// continue the basket tables of tree (e.g. it is older than its header).
+
+Bool_t TBasketIndexDelta::Apply(TTree *tree) const
+{
+   if (fEntries <= tree->fEntries) {
+      return kFALSE;
+   }
+   std::vector<TBranch*> branches;
+   CollectBranches(tree, branches);
+   if (branches.size() != fFirstBasket.size() || branches.size() != fNbaskets.size()) {
+      return kFALSE;
+   }
+   for (size_t i = 0; i < branches.size(); ++i) {
+      TBranch *branch = branches[i];
+      if (branch->fWriteBasket < fFirstBasket[i] || branch->fWriteBasket > fFirstBasket[i] + fNbaskets[i]) {
+         return kFALSE;
+      }
+      TBasket *basket = (TBasket*)branch->fBaskets.At(branch->fWriteBasket);
+      if (basket && basket->GetNevBuf()) {
+         return kFALSE;
+      }
+   }
+
+   size_t offset = 0;
+   for (size_t i = 0; i < branches.size(); ++i) {
+      TBranch *branch = branches[i];
+      Int_t writeBasket = branch->fWriteBasket;
+      // The baskets of the record up to writeBasket are already in the tables.
+      for (Int_t b = writeBasket - fFirstBasket[i]; b < fNbaskets[i]; ++b) {
+         while (branch->fWriteBasket + 1 >= branch->fMaxBaskets) {
+            branch->ExpandBasketArrays();
+         }
+         Int_t where = branch->fWriteBasket;
+         branch->fBasketBytes[where] = fBasketBytes[offset + b];
+         branch->fBasketEntry[where] = fBasketEntry[offset + b];
+         branch->fBasketSeek[where] = fBasketSeek[offset + b];
+         ++branch->fWriteBasket;
+      }
+      offset += fNbaskets[i];
+      if (branch->fWriteBasket != writeBasket) {
+         // Move the (empty) write basket, if any, to the new end of the tables.
+         TBasket *basket = (TBasket*)branch->fBaskets.At(writeBasket);
+         if (basket) {
+            branch->fBaskets.AddAt(0, writeBasket);
+         }
+         branch->fBaskets.AddAtAndExpand(basket, branch->fWriteBasket);
+      }
+      branch->fBasketEntry[branch->fWriteBasket] = fBranchEntries[i];
+      branch->fEntries = fBranchEntries[i];
+      branch->fEntryNumber = fBranchEntries[i];
+      branch->fTotBytes = fBranchTotBytes[i];
+      branch->fZipBytes = fBranchZipBytes[i];
+   }
+   tree->fEntries = fEntries;
+   tree->fTotBytes = fTotBytes;
+   tree->fZipBytes = fZipBytes;
+   tree->fSavedBytes = fZipBytes;
+   tree->fFlushedBytes = fFlushedBytes;
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Name of the key of the records of tree.
+
+TString TBasketIndexDelta::GetKeyName(const TTree *tree)
+{
+   return TString::Format("%s_baskets", tree->GetName());
+}
+
+namespace {
+   // The keys of the records of tree in dir, in the order of their cycles.
+   std::vector<TKey*> GetDeltaKeys(const TTree *tree, TDirectory *dir)
+   {
+      std::vector<TKey*> keys;
+      TList *list = dir ? dir->GetListOfKeys() : 0;
+      TString name = TBasketIndexDelta::GetKeyName(tree);
+      if (!list || !list->FindObject(name)) {
+         return keys;
+      }
+      TIter next(list);
+      TKey *key;
+      while ((key = (TKey*)next())) {
+         if (name == key->GetName() && !strcmp(key->GetClassName(), TBasketIndexDelta::Class_Name())) {
+            keys.push_back(key);
+         }
+      }
+      std::sort(keys.begin(), keys.end(), [](TKey *a, TKey *b) { return a->GetCycle() < b->GetCycle(); });
+      return keys;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Apply to tree, just read from dir, the records written in dir since its
+/// header. Returns the number of records applied.
+
+Int_t TBasketIndexDelta::ReadAll(TTree *tree, TDirectory *dir)
+{
+   Int_t napplied = 0;
+   for (TKey *key : GetDeltaKeys(tree, dir)) {
+      TBasketIndexDelta *delta = (TBasketIndexDelta*)key->ReadObjectAny(TBasketIndexDelta::Class());
+      if (delta && delta->Apply(tree)) {
+         ++napplied;
+      }
+      delete delta;
+   }
+   return napplied;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete from dir all the records of tree, when its full header was written.
+
+void TBasketIndexDelta::DeleteAll(const TTree *tree, TDirectory *dir)
+{
+   for (TKey *key : GetDeltaKeys(tree, dir)) {
+      key->Delete();
+      delete key;
+   }
+}
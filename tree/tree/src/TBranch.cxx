@@ -18,6 +18,7 @@
 #include "TBuffer.h"
 #include "TClass.h"
 #include "TBufferFile.h"
+#include "ROOT/TBufferPool.hxx"
 #include "TClonesArray.h"
 #include "TFile.h"
 #include "TLeaf.h"
@@ -31,14 +32,17 @@
 #include "TLeafObject.h"
 #include "TLeafS.h"
 #include "TMessage.h"
+#include "RZip.h"
 #include "TROOT.h"
 #include "TSystem.h"
 #include "TMath.h"
 #include "TTree.h"
 #include "TTreeCache.h"
 #include "TTreeCacheUnzip.h"
+#include "TTimeStamp.h"
 #include "TVirtualMutex.h"
 #include "TVirtualPad.h"
+#include "TVirtualPerfStats.h"
 
 #include <atomic>
 #include <cstddef>
@@ -106,6 +110,8 @@ TBranch::TBranch()
 , fTransientBuffer(0)
 , fBrowsables(0)
 , fSkipZip(kFALSE)
+, fDictSampling(kFALSE)
+, fCompressionDict(0)
 , fReadLeaves(&TBranch::ReadLeavesImpl)
 , fFillLeaves(&TBranch::FillLeavesImpl)
 {
@@ -209,6 +215,8 @@ TBranch::TBranch(TTree *tree, const char* name, void* address, const char* leafl
 , fTransientBuffer(0)
 , fBrowsables(0)
 , fSkipZip(kFALSE)
+, fDictSampling(kTRUE)
+, fCompressionDict(0)
 , fReadLeaves(&TBranch::ReadLeavesImpl)
 , fFillLeaves(&TBranch::FillLeavesImpl)
 {
@@ -259,6 +267,8 @@ TBranch::TBranch(TBranch *parent, const char* name, void* address, const char* l
 , fTransientBuffer(0)
 , fBrowsables(0)
 , fSkipZip(kFALSE)
+, fDictSampling(kTRUE)
+, fCompressionDict(0)
 , fReadLeaves(&TBranch::ReadLeavesImpl)
 , fFillLeaves(&TBranch::FillLeavesImpl)
 {
@@ -464,7 +474,7 @@ TBranch::~TBranch()
    fDirectory = 0;
 
    if (fTransientBuffer) {
-      delete fTransientBuffer;
+      ROOT::Internal::TBufferPool::DeleteBuffer(fTransientBuffer);
       fTransientBuffer = 0;
    }
 }
@@ -480,7 +490,7 @@ TBuffer* TBranch::GetTransientBuffer(Int_t size)
       }
       return fTransientBuffer;
    }
-   fTransientBuffer = new TBufferFile(TBuffer::kRead, size);
+   fTransientBuffer = ROOT::Internal::TBufferPool::CreateBuffer(TBuffer::kRead, size);
    return fTransientBuffer;
 }
 
@@ -577,6 +587,23 @@ void TBranch::AddLastBasket(Long64_t startEntry)
    fBaskets.AddAtAndExpand(0,fWriteBasket);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Keep the payload of a small basket, about to be compressed, as a sample
+/// to train the Zstd dictionary of the branch (see TrainCompressionDictionary).
+/// Only the baskets of the branches compressed with Zstd are sampled, within
+/// a budget of 64 kilobytes per branch. Called by TBasket::CompressBuffer.
+
+void TBranch::AddCompressionSample(const char *buffer, Int_t len)
+{
+   const Int_t    kMaxSampleSize = 16384;
+   const size_t   kMaxSamples    = 65536;
+   if (!fDictSampling || fCompressionDict || len <= 0 || len > kMaxSampleSize) return;
+   if (GetCompressionAlgorithm() != ROOT::kZSTD || GetCompressionLevel() <= 0) return;
+   if (fDictSamples.size() + len > kMaxSamples) return;
+   fDictSamples.insert(fDictSamples.end(), buffer, buffer + len);
+   fDictSampleSizes.push_back(len);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Browser interface.
 
@@ -1093,6 +1120,17 @@ Int_t TBranch::FlushOneBasket(UInt_t ibasket)
 /// Return pointer to basket basketnumber in this Branch
 
 TBasket* TBranch::GetBasket(Int_t basketnumber)
+{
+   return GetBasketImpl(basketnumber, kTRUE);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return pointer to basket basketnumber in this Branch, reading it if
+/// needed. If reuse is true, the basket may take the place of other read
+/// baskets when the memory of the tree is full (see GetFreshBasket);
+/// otherwise they are kept (see PrefetchBaskets).
+
+TBasket* TBranch::GetBasketImpl(Int_t basketnumber, Bool_t reuse)
 {
    // This counter in the sequential case collects errors coming also from
    // different files (suppose to have a program reading f1.root, f2.root ...)
@@ -1111,7 +1149,7 @@ TBasket* TBranch::GetBasket(Int_t basketnumber)
    if (file == 0) {
       return 0;
    }
-   basket = GetFreshBasket();
+   basket = reuse ? GetFreshBasket() : fTree->CreateBasket(this);
 
    // fSkipZip is old stuff still maintained for CDF
    if (fSkipZip) basket->SetBit(TBufferFile::kNotDecompressed);
@@ -1297,6 +1335,14 @@ Int_t TBranch::GetEntry(Long64_t entry, Int_t getall)
    }
 
    // Int_t bufbegin = buf->Length();
+   TVirtualPerfStats *perfStats = fTree->GetPerfStats();
+   if (R__unlikely(perfStats)) {
+      // Optional monitor for deserialization time profiling.
+      Double_t start = TTimeStamp();
+      (this->*fReadLeaves)(*buf);
+      perfStats->EntryReadEvent(this, buf->Length() - bufbegin, start);
+      return buf->Length() - bufbegin;
+   }
    (this->*fReadLeaves)(*buf);
    return buf->Length() - bufbegin;
 }
@@ -1372,6 +1418,186 @@ Int_t TBranch::GetEntryExport(Long64_t entry, Int_t /*getall*/, TClonesArray* li
    return nbytes;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read in one go all the entries from entry to the end of the basket
+/// containing it, and store them contiguously, in the host byte order, at
+/// the beginning of user_buf (which is expanded if needed).
+///
+/// This bypasses the per-entry TLeaf::ReadBasket calls and is only
+/// supported for branches with a single leaf of fundamental type and of
+/// fixed length (TLeafF, TLeafD, TLeafI, TLeafL, TLeafS, TLeafB, TLeafO).
+/// The values of entry `entry+i` start at element `i*leaf->GetLenStatic()`
+/// of the array of the leaf type at user_buf.Buffer().
+///
+/// Returns the number of entries read, 0 if entry is out of range, or
+/// -1 if the branch is not supported or on error.
+/// Example:
+/// ~~~ {.cpp}
+///     TBufferFile buf(TBuffer::kRead, 32*1024);
+///     Long64_t entry = 0;
+///     while (entry < branch->GetEntries()) {
+///        Int_t n = branch->GetBulkEntries(entry, buf);
+///        if (n <= 0) break;
+///        const Float_t *values = reinterpret_cast<Float_t*>(buf.Buffer());
+///        ...
+///        entry += n;
+///     }
+/// ~~~
+
+Int_t TBranch::GetBulkEntries(Long64_t entry, TBuffer &user_buf)
+{
+   // Remember which entry we are reading.
+   fReadEntry = entry;
+
+   if (fNleaves != 1) {
+      return -1;
+   }
+   TLeaf* leaf = (TLeaf*) fLeaves.UncheckedAt(0);
+   if (leaf->GetLeafCount()) {
+      return -1;
+   }
+   if ((entry < fFirstEntry) || (entry >= fEntryNumber)) {
+      return 0;
+   }
+   Long64_t first  = fFirstBasketEntry;
+   Long64_t last = fNextBasketEntry - 1;
+   // Are we still in the same ReadBasket?
+   if ((entry < first) || (entry > last)) {
+      fReadBasket = TMath::BinarySearch(fWriteBasket + 1, fBasketEntry, entry);
+      if (fReadBasket < 0) {
+         fNextBasketEntry = -1;
+         Error("GetBulkEntries", "In the branch %s, no basket contains the entry %lld\n", GetName(), entry);
+         return -1;
+      }
+      if (fReadBasket == fWriteBasket) {
+         fNextBasketEntry = fEntryNumber;
+      } else {
+         fNextBasketEntry = fBasketEntry[fReadBasket+1];
+      }
+      fFirstBasketEntry = first = fBasketEntry[fReadBasket];
+   }
+
+   // We have found the basket containing this entry.
+   // Make sure basket buffers are in memory.
+   TBasket* basket = GetBasket(fReadBasket);
+   fCurrentBasket = basket;
+   if (!basket) {
+      fFirstBasketEntry = -1;
+      fNextBasketEntry = -1;
+      return -1;
+   }
+   TBuffer* buf = basket->GetBufferRef();
+   if (R__unlikely(!buf)) {
+      return -1;
+   }
+   if (R__unlikely(!buf->IsReading())) {
+      basket->SetReadMode();
+   }
+
+   // All the entries have the same size, so they are contiguous in the basket.
+   Int_t* entryOffset = basket->GetEntryOffset();
+   Int_t bufbegin = 0;
+   if (entryOffset) {
+      bufbegin = entryOffset[entry-first];
+   } else {
+      bufbegin = basket->GetKeylen() + ((entry-first) * basket->GetNevBufSize());
+   }
+   Long64_t nentries = fNextBasketEntry - entry;
+   Long64_t nbytes = nentries * leaf->GetLenStatic() * leaf->GetLenType();
+   if (nbytes <= 0 || bufbegin + nbytes > buf->BufferSize()) {
+      return -1;
+   }
+
+   if (user_buf.BufferSize() < nbytes) {
+      user_buf.Expand(Int_t(nbytes), kFALSE);
+   }
+   memcpy(user_buf.Buffer(), buf->Buffer() + bufbegin, nbytes);
+
+   // Convert the whole array to the host representation in one pass.
+   user_buf.SetBufferOffset(0);
+   if (!leaf->ReadBasketFast(user_buf, nentries)) {
+      return -1;
+   }
+   user_buf.SetBufferOffset(0);
+
+   return Int_t(nentries);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the buffer of the basket holding entry, positioned at the start of
+/// the entry, without reading it; nbytes is set to the size of the entry in
+/// the buffer. This gives access to the serialized content of the entry, for
+/// the readers decoding it themselves (see TTreeReaderArray).
+///
+/// Returns 0 if the entry does not exist or on I/O error.
+
+TBuffer *TBranch::GetRawEntry(Long64_t entry, Int_t &nbytes)
+{
+   // Remember which entry we are reading.
+   fReadEntry = entry;
+   nbytes = 0;
+
+   if ((entry < fFirstEntry) || (entry >= fEntryNumber)) {
+      return 0;
+   }
+   Long64_t first  = fFirstBasketEntry;
+   Long64_t last = fNextBasketEntry - 1;
+   // Are we still in the same ReadBasket?
+   if ((entry < first) || (entry > last)) {
+      fReadBasket = TMath::BinarySearch(fWriteBasket + 1, fBasketEntry, entry);
+      if (fReadBasket < 0) {
+         fNextBasketEntry = -1;
+         Error("GetRawEntry", "In the branch %s, no basket contains the entry %lld\n", GetName(), entry);
+         return 0;
+      }
+      if (fReadBasket == fWriteBasket) {
+         fNextBasketEntry = fEntryNumber;
+      } else {
+         fNextBasketEntry = fBasketEntry[fReadBasket+1];
+      }
+      fFirstBasketEntry = first = fBasketEntry[fReadBasket];
+   }
+
+   // We have found the basket containing this entry.
+   // Make sure basket buffers are in memory.
+   TBasket* basket = GetBasket(fReadBasket);
+   fCurrentBasket = basket;
+   if (!basket) {
+      fFirstBasketEntry = -1;
+      fNextBasketEntry = -1;
+      return 0;
+   }
+   basket->PrepareBasket(entry);
+   TBuffer* buf = basket->GetBufferRef();
+   if (R__unlikely(!buf)) {
+      return 0;
+   }
+   if (R__unlikely(!buf->IsReading())) {
+      basket->SetReadMode();
+   }
+
+   Int_t* entryOffset = basket->GetEntryOffset();
+   Int_t bufbegin = 0;
+   Int_t bufend = 0;
+   if (entryOffset) {
+      bufbegin = entryOffset[entry-first];
+      bufend = (entry-first+1 < basket->GetNevBuf()) ? entryOffset[entry-first+1] : basket->GetLast();
+      Int_t* displacement = basket->GetDisplacement();
+      if (R__unlikely(displacement)) {
+         buf->SetBufferDisplacement(displacement[entry-first]);
+      }
+   } else {
+      bufbegin = basket->GetKeylen() + ((entry-first) * basket->GetNevBufSize());
+      bufend = bufbegin + basket->GetNevBufSize();
+   }
+   if (bufend < bufbegin || bufend > buf->BufferSize()) {
+      return 0;
+   }
+   buf->SetBufferOffset(bufbegin);
+   nbytes = bufend - bufbegin;
+   return buf;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Fill expectedClass and expectedType with information on the data type of the
 /// object/values contained in this branch (and thus the type of pointers
@@ -1740,6 +1966,50 @@ Int_t TBranch::LoadBaskets()
    return nimported;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read and unzip the baskets of this branch holding the entries first to
+/// last (included), and drop the other baskets read so far. Used by
+/// TTree::GetEntry to load the baskets of a whole cluster in parallel tasks
+/// (see TTree::SetImplicitMTClusterMode); GetEntry then only has to
+/// deserialize the entries from baskets in memory. The sub-branches are not
+/// prefetched. Returns the number of baskets read, -1 in case of error.
+
+Int_t TBranch::PrefetchBaskets(Long64_t first, Long64_t last)
+{
+   if (first < fFirstEntry) first = fFirstEntry;
+   if (last >= fEntryNumber) last = fEntryNumber - 1;
+   if (!fBasketEntry || first > last) return 0;
+   Int_t ifirst = TMath::BinarySearch(fWriteBasket + 1, fBasketEntry, first);
+   Int_t ilast  = TMath::BinarySearch(fWriteBasket + 1, fBasketEntry, last);
+   if (ilast < 0) return 0;
+   if (ifirst < 0) ifirst = 0;
+
+   // Drop the baskets of the previous range, as GetFreshBasket would do.
+   Int_t nbaskets = fBaskets.GetEntriesFast();
+   for (Int_t i = 0; i < nbaskets; ++i) {
+      if (i >= ifirst && i <= ilast) continue;
+      TBasket *basket = (TBasket*)fBaskets.UncheckedAt(i);
+      if (!basket || i == fWriteBasket || fBasketBytes[i] == 0) continue;
+      basket->DropBuffers();
+      --fNBaskets;
+      fBaskets.RemoveAt(i);
+      if (basket == fCurrentBasket) {
+         fCurrentBasket    = 0;
+         fFirstBasketEntry = -1;
+         fNextBasketEntry  = -1;
+      }
+      delete basket;
+   }
+
+   Int_t nread = 0;
+   for (Int_t i = ifirst; i <= ilast && i < fWriteBasket; ++i) {
+      if (fBaskets.UncheckedAt(i)) continue;
+      if (!GetBasketImpl(i, kFALSE)) return -1;
+      ++nread;
+   }
+   return nread;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Print TBranch parameters
 
@@ -2655,6 +2925,32 @@ void TBranch::SetupAddresses()
    // Nothing to do for regular branch, the TLeaf already did it.
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Train the Zstd dictionary of the small baskets of this branch on the
+/// samples collected so far, at the first AutoFlush of the tree. The
+/// dictionary is registered for the process and the following baskets are
+/// compressed with it; the tree then stores it in its file (see
+/// TCompressionDictionaries). Sampling stops whether or not a dictionary
+/// could be trained. Returns the id of the dictionary, 0 if none.
+
+UInt_t TBranch::TrainCompressionDictionary()
+{
+   const Int_t    kMaxDictSize = 4096;
+   const size_t   kMinSamples  = 8;
+   if (fDictSampling && !fCompressionDict && fDictSampleSizes.size() >= kMinSamples) {
+      std::vector<char> dict(kMaxDictSize);
+      Int_t dictsize = kMaxDictSize;
+      UInt_t id = R__ZSTDTrainDictionary(&fDictSamples[0], &fDictSampleSizes[0], fDictSampleSizes.size(), &dict[0], &dictsize);
+      if (id && dictsize > 0) {
+         fCompressionDict = R__ZSTDAddDictionary(&dict[0], dictsize);
+      }
+   }
+   fDictSampling = kFALSE;
+   std::vector<char>().swap(fDictSamples);
+   std::vector<size_t>().swap(fDictSampleSizes);
+   return fCompressionDict;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Refresh the value of fDirectory (i.e. where this branch writes/reads its buffers)
 /// with the current value of fTree->GetCurrentFile unless this branch has been
@@ -48,6 +48,8 @@ A Branch for the case of an object.
 #include "TStreamerInfoActions.h"
 #include "TSchemaRuleSet.h"
 
+#include <set>
+
 ClassImp(TBranchElement)
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -102,12 +104,19 @@ void TBranchElement::SwitchContainer(TObjArray* branches) {
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace {
-   Bool_t CanSelfReference(TClass *cl) {
+   Bool_t CanSelfReference(TClass *cl, std::set<TClass*> &visited) {
       if (cl) {
+         if (!visited.insert(cl).second) {
+            // Already being scanned, the other members decide.
+            return kFALSE;
+         }
          if (cl->GetCollectionProxy()) {
+            if (cl->GetCollectionProxy()->HasPointers()) {
+               return kTRUE;
+            }
             TClass *inside = cl->GetCollectionProxy()->GetValueClass();
             if (inside) {
-               return CanSelfReference(inside);
+               return CanSelfReference(inside, visited);
             } else {
                return kFALSE;
             }
@@ -116,13 +125,62 @@ namespace {
          if (cl == stringClass || cl == TString::Class()) {
             return kFALSE;
          }
-         // Here we could scan through the TStreamerInfo to see if there
-         // is any pointer anywhere and know whether this is a possibility
-         // of selfreference (but watch out for very indirect cases).
-         return kTRUE;
+         // A custom streamer may write anything.
+         if (cl->GetStreamer() || cl->TestBit(TClass::kHasCustomStreamerMember)) {
+            return kTRUE;
+         }
+         // Scan through the TStreamerInfo to see if there is any pointer
+         // anywhere (in the bases, the members and the content of the
+         // collections); if not, there is no possibility of selfreference
+         // and the objects do not need to be registered in the buffer map.
+         TVirtualStreamerInfo *info = cl->GetStreamerInfo();
+         if (!info || !info->GetElements()) {
+            return kTRUE;
+         }
+         TIter next(info->GetElements());
+         TStreamerElement *element;
+         while ((element = (TStreamerElement*)next())) {
+            Int_t type = element->GetType();
+            if (type >= TVirtualStreamerInfo::kOffsetL + TVirtualStreamerInfo::kObject
+                && type <= TVirtualStreamerInfo::kOffsetL + TVirtualStreamerInfo::kSTLp) {
+               // Fixed size array of objects or pointers.
+               type -= TVirtualStreamerInfo::kOffsetL;
+            }
+            switch (type) {
+               case TVirtualStreamerInfo::kObjectp:
+               case TVirtualStreamerInfo::kObjectP:
+               case TVirtualStreamerInfo::kAnyp:
+               case TVirtualStreamerInfo::kAnyP:
+               case TVirtualStreamerInfo::kAnyPnoVT:
+               case TVirtualStreamerInfo::kSTLp:
+               case TVirtualStreamerInfo::kStreamer:
+               case TVirtualStreamerInfo::kStreamLoop:
+                  return kTRUE;
+               case TVirtualStreamerInfo::kBase:
+               case TVirtualStreamerInfo::kObject:
+               case TVirtualStreamerInfo::kAny:
+               case TVirtualStreamerInfo::kSTL:
+                  if (!element->GetClassPointer() || CanSelfReference(element->GetClassPointer(), visited)) {
+                     return kTRUE;
+                  }
+                  break;
+               default:
+                  if (type >= TVirtualStreamerInfo::kArtificial) {
+                     return kTRUE;
+                  }
+                  // Basic types, arrays of basic types, TString, TObject and TNamed.
+                  break;
+            }
+         }
+         return kFALSE;
       }
       return kFALSE;
    }
+
+   Bool_t CanSelfReference(TClass *cl) {
+      std::set<TClass*> visited;
+      return CanSelfReference(cl, visited);
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1615,10 +1673,12 @@ void TBranchElement::FillLeavesCustomStreamer(TBuffer& b)
    // Remember tobjects written to the buffer so that
    // pointers are handled correctly later.
 
-   if (TestBit(kBranchObject)) {
-      b.MapObject((TObject*) fObject);
-   } else if (TestBit(kBranchAny)) {
-      b.MapObject(fObject, fBranchClass);
+   if (!TestBit(kNoReferenceTracking)) {
+      if (TestBit(kBranchObject)) {
+         b.MapObject((TObject*) fObject);
+      } else if (TestBit(kBranchAny)) {
+         b.MapObject(fObject, fBranchClass);
+      }
    }
 
    fBranchClass->Streamer(fObject,b);
@@ -1699,10 +1759,12 @@ void TBranchElement::FillLeavesMember(TBuffer& b)
       return;
    }
 
-   if (TestBit(kBranchObject)) {
-      b.MapObject((TObject*) fObject);
-   } else if (TestBit(kBranchAny)) {
-      b.MapObject(fObject, fBranchClass);
+   if (!TestBit(kNoReferenceTracking)) {
+      if (TestBit(kBranchObject)) {
+         b.MapObject((TObject*) fObject);
+      } else if (TestBit(kBranchAny)) {
+         b.MapObject(fObject, fBranchClass);
+      }
    }
 
    // -- Top-level, data member, base class, or split class branch.
@@ -4027,10 +4089,12 @@ void TBranchElement::ReadLeavesMember(TBuffer& b)
    // or sub-branch and branch inherits from tobject,
    // then register with the buffer so that pointers are
    // handled properly.
-   if (TestBit(kBranchObject)) {
-      b.MapObject((TObject*) fObject);
-   } else if (TestBit(kBranchAny)) {
-      b.MapObject(fObject, fBranchClass);
+   if (!TestBit(kNoReferenceTracking)) {
+      if (TestBit(kBranchObject)) {
+         b.MapObject((TObject*) fObject);
+      } else if (TestBit(kBranchAny)) {
+         b.MapObject(fObject, fBranchClass);
+      }
    }
 
    fNdata = 1;
@@ -4063,10 +4127,12 @@ void TBranchElement::ReadLeavesMemberBranchCount(TBuffer& b)
    // or sub-branch and branch inherits from tobject,
    // then register with the buffer so that pointers are
    // handled properly.
-   if (TestBit(kBranchObject)) {
-      b.MapObject((TObject*) fObject);
-   } else if (TestBit(kBranchAny)) {
-      b.MapObject(fObject, fBranchClass);
+   if (!TestBit(kNoReferenceTracking)) {
+      if (TestBit(kBranchObject)) {
+         b.MapObject((TObject*) fObject);
+      } else if (TestBit(kBranchAny)) {
+         b.MapObject(fObject, fBranchClass);
+      }
    }
 
    fNdata = (Int_t) fBranchCount->GetValue(0, 0);
@@ -4098,10 +4164,12 @@ void TBranchElement::ReadLeavesMemberCounter(TBuffer& b)
    // or sub-branch and branch inherits from tobject,
    // then register with the buffer so that pointers are
    // handled properly.
-   if (TestBit(kBranchObject)) {
-      b.MapObject((TObject*) fObject);
-   } else if (TestBit(kBranchAny)) {
-      b.MapObject(fObject, fBranchClass);
+   if (!TestBit(kNoReferenceTracking)) {
+      if (TestBit(kBranchObject)) {
+         b.MapObject((TObject*) fObject);
+      } else if (TestBit(kBranchAny)) {
+         b.MapObject(fObject, fBranchClass);
+      }
    }
 
    TStreamerInfo *info = GetInfoImp();
@@ -5026,6 +5094,27 @@ void TBranchElement::SetOffset(Int_t offset)
    fOffset = offset;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Set whether the objects of this branch (and of its sub-branches) are
+/// registered in the buffer map while they are streamed, so that pointers
+/// to them from within the same entry are written as references.
+///
+/// By default the objects are registered unless the StreamerInfo of the
+/// class shows that it contains no pointer at all. Turning the tracking
+/// off saves the cost of the map for classes whose pointers never refer
+/// back to the branch object itself; if they do, the object would be
+/// written again (and possibly endlessly) instead of as a reference.
+
+void TBranchElement::SetReferenceTracking(Bool_t track /* = kTRUE */)
+{
+   SetBit(kNoReferenceTracking, !track);
+   Int_t nbranches = fBranches.GetEntriesFast();
+   for (Int_t i = 0; i < nbranches; ++i) {
+      TBranchElement *br = dynamic_cast<TBranchElement*>(fBranches.UncheckedAt(i));
+      if (br) br->SetReferenceTracking(track);
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set the sequence of actions needed to read the data out of the buffer.
 
@@ -35,6 +35,7 @@ TBufferSQL::TBufferSQL(TBuffer::EMode mode, std::vector<Int_t> *vc,
    fColumnVec(vc), fInsertQuery(insert_query), fRowPtr(r)
 {
    fIter = fColumnVec->begin();
+   SetBit(kTextBasedStreaming);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -46,6 +47,7 @@ TBufferSQL::TBufferSQL(TBuffer::EMode mode, Int_t bufsiz, std::vector<Int_t> *vc
    fColumnVec(vc), fInsertQuery(insert_query), fRowPtr(r)
 {
    fIter = fColumnVec->begin();
+   SetBit(kTextBasedStreaming);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -58,6 +60,7 @@ TBufferSQL::TBufferSQL(TBuffer::EMode mode, Int_t bufsiz, std::vector<Int_t> *vc
    fColumnVec(vc), fInsertQuery(insert_query), fRowPtr(r)
 {
    fIter = fColumnVec->begin();
+   SetBit(kTextBasedStreaming);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -65,6 +68,7 @@ TBufferSQL::TBufferSQL(TBuffer::EMode mode, Int_t bufsiz, std::vector<Int_t> *vc
 
 TBufferSQL::TBufferSQL() : TBufferFile(), fColumnVec(0),fInsertQuery(0),fRowPtr(0)
 {
+   SetBit(kTextBasedStreaming);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -53,6 +53,16 @@ the trees in the chain.
 #include "TEntryListFromFile.h"
 #include "TFileStager.h"
 #include "TFilePrefetch.h"
+#include "TEnv.h"
+
+#include <algorithm>
+#include <vector>
+
+#ifdef R__USE_IMT
+#include "tbb/task.h"
+#include "tbb/task_group.h"
+#include <atomic>
+#endif
 
 ClassImp(TChain)
 
@@ -71,6 +81,7 @@ TChain::TChain()
 , fFiles(0)
 , fStatus(0)
 , fProofChain(0)
+, fCacheDetached(0)
 {
    fTreeOffset = new Long64_t[fTreeOffsetLen];
    fFiles = new TObjArray(fTreeOffsetLen);
@@ -144,6 +155,7 @@ TChain::TChain(const char* name, const char* title)
 , fFiles(0)
 , fStatus(0)
 , fProofChain(0)
+, fCacheDetached(0)
 {
    //
    //*-*
@@ -190,6 +202,8 @@ TChain::~TChain()
       delete fFile->GetCacheRead(fTree);
       fFile->SetCacheRead(0, fTree);
    }
+   delete fCacheDetached;
+   fCacheDetached = 0;
 
    delete fFile;
    fFile = 0;
@@ -251,6 +265,86 @@ Int_t TChain::Add(TChain* chain)
    return nf;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the path of the entry name of the directory dir, dir being empty
+/// for the current directory.
+
+static TString JoinPath(const TString &dir, const TString &name)
+{
+   if (dir.IsNull()) return name;
+   if (dir.EndsWith("/")) return dir + name;
+   return dir + "/" + name;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill entries with the names of the entries of the directory dir matching
+/// the wildcard expression pattern (the entry called pattern always
+/// matching), in alphanumeric order. If dirsOnly, only the entries which
+/// are directories are kept. Nothing is filled if dir cannot be listed.
+
+static void ListDirectory(const TString &dir, const TString &pattern, Bool_t dirsOnly, std::vector<TString> &entries)
+{
+   void *dirp = gSystem->OpenDirectory(dir);
+   if (!dirp) return;
+   TRegexp re(pattern, kTRUE);
+   const char *file;
+   while ((file = gSystem->GetDirEntry(dirp))) {
+      if (!strcmp(file,".") || !strcmp(file,"..")) continue;
+      TString s = file;
+      if ((pattern != file) && s.Index(re) == kNPOS) continue;
+      entries.push_back(s);
+   }
+   gSystem->FreeDirectory(dirp);
+   if (dirsOnly) {
+      // Only the matching entries are stat'ed, not all the directory.
+      std::vector<TString> dirs;
+      for (size_t i = 0; i < entries.size(); ++i) {
+         FileStat_t st;
+         if (!gSystem->GetPathInfo(JoinPath(dir, entries[i]), st) && R_ISDIR(st.fMode))
+            dirs.push_back(entries[i]);
+      }
+      entries.swap(dirs);
+   }
+   std::sort(entries.begin(), entries.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Call ListDirectory for each of dirs, filling the corresponding element
+/// of entries. Remote directories are listed concurrently when the implicit
+/// multi-threading is enabled, by at most `TChain.ParallelOpen` tasks at a
+/// time; local ones are listed in turn.
+
+static void ListDirectories(const std::vector<TString> &dirs, const TString &pattern, Bool_t dirsOnly,
+                            std::vector<std::vector<TString> > &entries)
+{
+   const Int_t ndirs = dirs.size();
+   entries.assign(ndirs, std::vector<TString>());
+#ifdef R__USE_IMT
+   // The first listing, done alone, creates the TSystem helper of remote
+   // directories; the helpers found afterwards are only looked up.
+   if (ndirs > 2 && ROOT::IsImplicitMTEnabled() &&
+       strcmp(TUrl(dirs[0], kTRUE).GetProtocol(), "file")) {
+      ListDirectory(dirs[0], pattern, dirsOnly, entries[0]);
+      Int_t ntasks = gEnv->GetValue("TChain.ParallelOpen", 16);
+      if (ntasks < 1) ntasks = 1;
+      if (ntasks > ndirs - 1) ntasks = ndirs - 1;
+      std::atomic<Int_t> next(1);
+      tbb::task_group g;
+      for (Int_t t = 0; t < ntasks; ++t) {
+         g.run([&]() {
+            Int_t k;
+            while ((k = next++) < ndirs)
+               ListDirectory(dirs[k], pattern, dirsOnly, entries[k]);
+         });
+      }
+      g.wait();
+      return;
+   }
+#endif
+   for (Int_t k = 0; k < ndirs; ++k)
+      ListDirectory(dirs[k], pattern, dirsOnly, entries[k]);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Add a new file to this chain.
 ///
@@ -262,6 +356,11 @@ Int_t TChain::Add(TChain* chain)
 /// Wildcard treatment is triggered by the any of the special characters []*?
 /// which may be used in the file name, eg. specifying "xxx*.root" adds
 /// all files starting with xxx in the current file system directory.
+/// They may also be used in the names of the directories, eg.
+/// "/data/run*/xxx*.root" adds the files starting with xxx of all the
+/// directories starting with run. The directories of remote file systems
+/// are listed concurrently when the implicit multi-threading is enabled,
+/// by at most `TChain.ParallelOpen` (see TEnv, default 16) tasks at a time.
 ///
 /// Alternatively name may have the format of a url, eg.
 /// ~~~ {.cpp}
@@ -298,7 +397,9 @@ Int_t TChain::Add(TChain* chain)
 ///    Note that if one calls TChain::GetEntriesFast() after having created
 ///    a chain with this default, GetEntriesFast will return TTree::kMaxEntries!
 ///    TChain::GetEntries will force of the Tree headers in the chain to be
-///    read to read the number of entries in each Tree.
+///    read to read the number of entries in each Tree; with implicit
+///    multi-threading enabled the headers are read concurrently, see
+///    TChain::LookupEntries.
 ///
 /// D. The TChain data structure
 ///    Each TChainElement has a name equal to the tree name of this TChain
@@ -347,31 +448,49 @@ Int_t TChain::Add(const char* name, Long64_t nentries /* = TTree::kMaxEntries */
    } else {
       directory = gSystem->UnixPathName(gSystem->WorkingDirectory());
    }
+   if (directory.IsNull()) directory = "/";
+
+   // Split the directory before its first component with wildcards: the
+   // part before is listed as is, the components after are expanded one
+   // level at a time, listing all the directories of a level together.
+   TString prefix = directory;
+   std::vector<TString> components;
+   Ssiz_t wild = directory.First("[]*?");
+   if (wild != kNPOS) {
+      Ssiz_t slash = TString(directory(0, wild)).Last('/');
+      prefix = (slash == kNPOS) ? TString("") : TString(directory(0, slash > 0 ? slash : 1));
+      TString rest = directory(slash + 1, directory.Length() - slash - 1);
+      while (rest.Length()) {
+         Ssiz_t end = rest.Index("/");
+         if (end == kNPOS) end = rest.Length();
+         if (end > 0) components.push_back(rest(0, end));
+         rest.Remove(0, end + 1 < rest.Length() ? end + 1 : rest.Length());
+      }
+   }
 
-   const char *file;
-   const char *epath = gSystem->ExpandPathName(directory.Data());
-   void *dir = gSystem->OpenDirectory(epath);
-   delete [] epath;
-   if (dir) {
-      //create a TList to store the file names (not yet sorted)
-      TList l;
-      TRegexp re(basename,kTRUE);
-      while ((file = gSystem->GetDirEntry(dir))) {
-         if (!strcmp(file,".") || !strcmp(file,"..")) continue;
-         TString s = file;
-         if ( (basename!=file) && s.Index(re) == kNPOS) continue;
-         l.Add(new TObjString(file));
-      }
-      gSystem->FreeDirectory(dir);
-      //sort the files in alphanumeric order
-      l.Sort();
-      TIter next(&l);
-      TObjString *obj;
-      while ((obj = (TObjString*)next())) {
-         file = obj->GetName();
-         nf += AddFile(TString::Format("%s/%s%s",directory.Data(),file,suffix.Data()),nentries);
-      }
-      l.Delete();
+   std::vector<TString> names(1, prefix), paths(1, ".");
+   if (prefix.Length()) {
+      const char *epath = gSystem->ExpandPathName(prefix.Data());
+      paths[0] = epath;
+      delete [] epath;
+   }
+   for (size_t level = 0; level <= components.size() && !names.empty(); ++level) {
+      Bool_t last = (level == components.size());
+      std::vector<std::vector<TString> > entries;
+      ListDirectories(paths, last ? basename : components[level], !last, entries);
+      std::vector<TString> subnames, subpaths;
+      for (size_t i = 0; i < entries.size(); ++i) {
+         for (size_t j = 0; j < entries[i].size(); ++j) {
+            subnames.push_back(JoinPath(names[i], entries[i][j]));
+            subpaths.push_back(JoinPath(paths[i], entries[i][j]));
+         }
+      }
+      if (last) {
+         for (size_t i = 0; i < subnames.size(); ++i)
+            nf += AddFile(subnames[i] + suffix, nentries);
+      }
+      names.swap(subnames);
+      paths.swap(subpaths);
    }
    if (fProofChain)
       // This updates the proxy chain when we will really use PROOF
@@ -923,12 +1042,108 @@ Long64_t TChain::GetEntries() const
                                " run TChain::SetProof(kTRUE, kTRUE) first");
       return fProofChain->GetEntries();
    }
-   if (fEntries == TTree::kMaxEntries) {
+   if (fEntries == TTree::kMaxEntries && !const_cast<TChain*>(this)->LookupEntries()) {
       const_cast<TChain*>(this)->LoadTree(TTree::kMaxEntries-1);
    }
    return fEntries;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read concurrently the number of entries of the trees whose number of
+/// entries is not known yet and fill the offset table.
+///
+/// With implicit multi-threading enabled, the files are opened and their
+/// tree headers read by at most `TChain.ParallelOpen` (see TEnv, default 16)
+/// tasks at a time, which hides the latency of remote files. The files of
+/// the first `TChain.KeepOpenFiles` (default 64) trees are kept open by
+/// their TChainElement, so that TChain::LoadTree does not open them again.
+///
+/// Return kFALSE if nothing was done or if a file or tree could not be
+/// read, in which case the offset table is left to TChain::LoadTree (and
+/// the errors are reported there).
+
+Bool_t TChain::LookupEntries()
+{
+#ifdef R__USE_IMT
+   if (!ROOT::IsImplicitMTEnabled() || fProofChain) return kFALSE;
+
+   std::vector<TChainElement*> elements;
+   std::vector<Int_t> treenums;
+   for (Int_t i = 0; i < fNtrees; ++i) {
+      TChainElement *element = (TChainElement*) fFiles->UncheckedAt(i);
+      if (element->GetEntries() == TTree::kMaxEntries && !element->GetFile()) {
+         elements.push_back(element);
+         treenums.push_back(i);
+      }
+   }
+   if (elements.size() < 2) return kFALSE;
+
+   const Int_t nelements = elements.size();
+   const Int_t nkeep = gEnv->GetValue("TChain.KeepOpenFiles", 64);
+   Int_t ntasks = gEnv->GetValue("TChain.ParallelOpen", 16);
+   if (ntasks < 1) ntasks = 1;
+   if (ntasks > nelements) ntasks = nelements;
+
+   std::vector<Long64_t> entries(nelements, -1);
+   std::vector<TFile*> files(nelements, (TFile*)0);
+   std::atomic<Int_t> next(0);
+
+   // Each task opens the files one after the other, which bounds the number
+   // of files being opened at the same time by ntasks.
+   tbb::task_group g;
+   for (Int_t t = 0; t < ntasks; ++t) {
+      g.run([&]() {
+         Int_t k;
+         while ((k = next++) < nelements) {
+            TFile *file;
+            {
+               TDirectory::TContext ctxt;
+               file = TFile::Open(elements[k]->GetTitle());
+            }
+            if (!file || file->IsZombie()) {
+               delete file;
+               continue;
+            }
+            TTree *tree = 0;
+            file->GetObject(elements[k]->GetName(), tree);
+            if (!tree) {
+               delete file;
+               continue;
+            }
+            entries[k] = tree->GetEntries();
+            if (treenums[k] < nkeep) files[k] = file;
+            else delete file;
+         }
+      });
+   }
+   g.wait();
+
+   Bool_t complete = kTRUE;
+   for (Int_t k = 0; k < nelements; ++k) {
+      if (entries[k] < 0) {
+         complete = kFALSE;
+         continue;
+      }
+      elements[k]->SetNumberEntries(entries[k]);
+      if (files[k]) {
+         files[k]->SetBit(kMustCleanup);
+         elements[k]->SetFile(files[k]);
+      }
+   }
+   if (!complete) return kFALSE;
+
+   for (Int_t i = 0; i < fNtrees; ++i) {
+      Long64_t nentries = ((TChainElement*) fFiles->UncheckedAt(i))->GetEntries();
+      if (nentries == TTree::kMaxEntries) return kFALSE;
+      fTreeOffset[i+1] = fTreeOffset[i] + nentries;
+   }
+   fEntries = fTreeOffset[fNtrees];
+   return kTRUE;
+#else
+   return kFALSE;
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Get entry from the file to memory.
 ///
@@ -1208,6 +1423,20 @@ Double_t TChain::GetWeight() const
 
 void TChain::InvalidateCurrentTree()
 {
+   if (fFile && fTree) {
+      // Detach the TTreeCache from the tree we are about to forget, so that
+      // the set of branches it learnt (or was given via AddBranch/DropBranch)
+      // is carried over to the next tree instead of being learnt again.
+      TTreeCache *tpf = (TTreeCache*) fFile->GetCacheRead(fTree);
+      if (tpf) {
+         tpf->ResetCache();
+         fFile->SetCacheRead(0, fTree);
+         if (tpf != fCacheDetached) {
+            delete fCacheDetached;
+            fCacheDetached = tpf;
+         }
+      }
+   }
    if (fTree && fTree->GetListOfClones()) {
       for (TObjLink* lnk = fTree->GetListOfClones()->FirstLink(); lnk; lnk = lnk->Next()) {
          TTree* clone = (TTree*) lnk->GetObject();
@@ -1389,7 +1618,6 @@ Long64_t TChain::LoadTree(Long64_t entry)
 
    // Delete the current tree and open the new tree.
 
-   TTreeCache* tpf = 0;
    // Delete file unless the file owns this chain!
    // FIXME: The "unless" case here causes us to leak memory.
    if (fFile) {
@@ -1400,14 +1628,9 @@ Long64_t TChain::LoadTree(Long64_t entry)
             // AddFriend).  Having fTree === 0 is necessary in that
             // case because in some cases GetTree is used as a check
             // to see if a TTree is already loaded.
-            // However, this prevent using the following to reuse
-            // the TTreeCache object.
-            tpf = (TTreeCache*) fFile->GetCacheRead(fTree);
-            if (tpf) {
-               tpf->ResetCache();
-               }
-
-            fFile->SetCacheRead(0, fTree);
+            // InvalidateCurrentTree also detaches the TTreeCache
+            // object (into fCacheDetached) so that it can be reused.
+            //
             // If the tree has clones, copy them into the chain
             // clone list so we can change their branch addresses
             // when necessary.
@@ -1456,7 +1679,9 @@ Long64_t TChain::LoadTree(Long64_t entry)
    //        if we did not delete it above.
    {
       TDirectory::TContext ctxt;
-      fFile = TFile::Open(element->GetTitle());
+      // Reuse the file opened by TChain::LookupEntries, if any.
+      fFile = element->TakeFile();
+      if (!fFile) fFile = TFile::Open(element->GetTitle());
       if (fFile) fFile->SetBit(kMustCleanup);
    }
 
@@ -1489,20 +1714,19 @@ Long64_t TChain::LoadTree(Long64_t entry)
    // FIXME: We may set fDirectory to zero here!
    fDirectory = fFile;
 
-   // Reuse cache from previous file (if any).
-   if (tpf) {
-      if (fFile) {
+   // Reuse cache from previous file (if any), including the list of
+   // branches it learnt, so that only the first tree pays for the learning
+   // phase.
+   if (fCacheDetached) {
+      if (fTree) {
+         TTreeCache *tpf = fCacheDetached;
+         fCacheDetached = 0;
          tpf->ResetCache();
          fFile->SetCacheRead(tpf, fTree);
-         // FIXME: fTree may be zero here.
          tpf->UpdateBranches(fTree);
-      } else {
-         // FIXME: One of the file in the chain is missing
-         // we have no place to hold the pointer to the
-         // TTreeCache.
-         delete tpf;
-         tpf = 0;
       }
+      // Otherwise one of the file in the chain is missing: keep the
+      // TTreeCache around for the next tree.
    } else {
       if (fCacheUserSet) {
          this->SetCacheSize(fCacheSize);
@@ -1609,6 +1833,7 @@ Long64_t TChain::LoadTree(Long64_t entry)
 
    fTree->SetMakeClass(fMakeClass);
    fTree->SetMaxVirtualSize(fMaxVirtualSize);
+   fTree->SetImplicitMTClusterMode(fIMTClusterMode);
 
    SetChainOffset(fTreeOffset[fTreeNumber]);
 
@@ -2254,6 +2479,8 @@ void TChain::RemoveFriend(TTree* oldFriend)
 
 void TChain::Reset(Option_t*)
 {
+   delete fCacheDetached;
+   fCacheDetached = 0;
    delete fFile;
    fFile = 0;
    fNtrees         = 0;
@@ -2333,7 +2560,15 @@ Int_t TChain::SetCacheSize(Long64_t cacheSize)
       res = fTree->SetCacheSize(cacheSize);
    } else {
       // If we don't have a TTree yet only record the cache size wanted
-      res = 0;
+      // (and apply it to the cache waiting for the next tree, if any).
+      if (fCacheDetached) {
+         if (cacheSize <= 0) {
+            delete fCacheDetached;
+            fCacheDetached = 0;
+         } else if (fCacheDetached->SetBufferSize(cacheSize) < 0) {
+            res = -1;
+         }
+      }
    }
    fCacheSize = cacheSize; // Record requested size.
    return res;
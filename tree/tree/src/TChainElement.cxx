@@ -17,6 +17,7 @@ A TChainElement describes a component of a TChain.
 
 #include "TChainElement.h"
 #include "TBuffer.h"
+#include "TFile.h"
 #include "TTree.h"
 #include "Riostream.h"
 #include "TROOT.h"
@@ -27,7 +28,7 @@ ClassImp(TChainElement)
 /// Default constructor for a chain element.
 
 TChainElement::TChainElement() : TNamed(),fBaddress(0),fBaddressType(0),
-   fBaddressIsPtr(kFALSE), fBranchPtr(0), fLoadResult(0)
+   fBaddressIsPtr(kFALSE), fBranchPtr(0), fLoadResult(0), fFile(0)
 {
    fNPackets   = 0;
    fPackets    = 0;
@@ -42,7 +43,7 @@ TChainElement::TChainElement() : TNamed(),fBaddress(0),fBaddressType(0),
 
 TChainElement::TChainElement(const char *name, const char *title)
    :TNamed(name,title),fBaddress(0),fBaddressType(0),
-    fBaddressIsPtr(kFALSE), fBranchPtr(0), fLoadResult(0)
+    fBaddressIsPtr(kFALSE), fBranchPtr(0), fLoadResult(0), fFile(0)
 {
    fNPackets   = 0;
    fPackets    = 0;
@@ -58,6 +59,7 @@ TChainElement::TChainElement(const char *name, const char *title)
 TChainElement::~TChainElement()
 {
    delete [] fPackets;
+   delete fFile;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -95,6 +97,18 @@ void TChainElement::SetPacketSize(Int_t size)
    fPacketSize = size;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Keep file, which holds the tree of this element, for the next
+/// TChain::LoadTree of this element. The element owns the file until it is
+/// taken with TakeFile.
+
+void TChainElement::SetFile(TFile *file)
+{
+   if (file == fFile) return;
+   delete fFile;
+   fFile = file;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set/Reset the looked-up bit
 
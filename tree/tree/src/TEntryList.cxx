@@ -540,6 +540,63 @@ Int_t TEntryList::Contains(Long64_t entry, TTree *tree)
 
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return kTRUE if at least one entry from entrymin to entrymax included
+/// is in the list (of the current tree, if this list has sub-lists).
+/// Used by TTreeCache to only prefetch the baskets holding selected entries.
+
+Bool_t TEntryList::ContainsRange(Long64_t entrymin, Long64_t entrymax)
+{
+   Long64_t last;
+   Long64_t first = NextRun(entrymin, last);
+   return first >= 0 && first <= entrymax;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the first entry >= entry of the list, and set last to the last entry
+/// of the run of consecutive entries of the list starting there.
+/// If this list has sub-lists, the run is searched in the list of the current
+/// tree. Returns -1 if there is no entry >= entry.
+///
+/// Example, looping over the ranges of selected entries:
+/// ~~~{.cpp}
+///     Long64_t last;
+///     for (Long64_t first = elist->NextRun(0, last); first >= 0;
+///          first = elist->NextRun(last+1, last)) {
+///        // entries first to last (included) are selected
+///     }
+/// ~~~
+
+Long64_t TEntryList::NextRun(Long64_t entry, Long64_t &last)
+{
+   if (!fBlocks) {
+      if (fLists && fCurrent) return fCurrent->NextRun(entry, last);
+      return -1;
+   }
+   if (entry < 0) entry = 0;
+   Int_t nblock = entry/kBlockSize;
+   Long64_t first = -1;
+   Int_t blocklast = 0;
+   for (; nblock < fNBlocks; nblock++) {
+      TEntryListBlock *block = (TEntryListBlock*)fBlocks->UncheckedAt(nblock);
+      Int_t local = block->NextRun(entry - nblock*(Long64_t)kBlockSize, blocklast);
+      if (local >= 0) {
+         first = local + nblock*(Long64_t)kBlockSize;
+         break;
+      }
+      entry = (nblock+1)*(Long64_t)kBlockSize;
+   }
+   if (first < 0) return -1;
+   // The run may continue in the next blocks.
+   last = blocklast + nblock*(Long64_t)kBlockSize;
+   while (blocklast == kBlockSize-1 && ++nblock < fNBlocks) {
+      TEntryListBlock *block = (TEntryListBlock*)fBlocks->UncheckedAt(nblock);
+      if (block->NextRun(0, blocklast) != 0) break;
+      last = blocklast + nblock*(Long64_t)kBlockSize;
+   }
+   return first;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Called by TKey and others to automatically add us to a directory when we are read from a file.
 
@@ -1227,13 +1284,21 @@ void TEntryList::Subtract(const TEntryList *elist)
          //second list is also only for 1 tree
          if (!strcmp(elist->fTreeName.Data(),fTreeName.Data()) &&
              !strcmp(elist->fFileName.Data(),fFileName.Data())){
-            //same tree
-            Long64_t n2 = elist->GetN();
-            Long64_t entry;
-            for (Int_t i=0; i<n2; i++){
-               entry = (const_cast<TEntryList*>(elist))->GetEntry(i);
-               Remove(entry);
+            //same tree, subtract block by block
+            if (!elist->fBlocks) return;
+            TEntryListBlock *block1=0;
+            TEntryListBlock *block2=0;
+            Int_t nmin = TMath::Min(fNBlocks, elist->fNBlocks);
+            Long64_t nnew, nold;
+            for (Int_t i=0; i<nmin; i++){
+               block1 = (TEntryListBlock*)fBlocks->UncheckedAt(i);
+               block2 = (TEntryListBlock*)elist->fBlocks->UncheckedAt(i);
+               nold = block1->GetNPassed();
+               nnew = block1->Subtract(block2);
+               fN = fN - nold + nnew;
             }
+            fLastIndexQueried = -1;
+            fLastIndexReturned = 0;
          } else {
             //different trees
             return;
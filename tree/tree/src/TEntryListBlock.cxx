@@ -41,13 +41,43 @@ End_Macro
  - __GetEntry(n)__ - returns n-th non-zero entry.
  - __Next__()      - return next non-zero entry. In case of representation 1), Next()
                  is faster than GetEntry()
+ - __Subtract__() - removes all entries of the other block from this one
+ - __NextRun__(n) - returns the first entry >= n and the last entry of the run of
+                 consecutive entries starting there (used to find whole ranges of
+                 selected entries, e.g. by TEntryList::ContainsRange)
+
+The bit operations of Merge() and Subtract() work a full word at a time on the
+bits representation so that the compiler can vectorize them; the list
+representation is searched by bisection.
 */
 
 #include "TEntryListBlock.h"
 #include "TString.h"
 
+#include <algorithm>
+
 ClassImp(TEntryListBlock)
 
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Number of bits set in the kBlockSize words of bits
+
+inline Int_t CountBits(const UShort_t *bits)
+{
+   Int_t n = 0;
+   for (Int_t i=0; i<TEntryListBlock::kBlockSize; i++) {
+#if defined(__GNUC__)
+      n += __builtin_popcount(bits[i]);
+#else
+      for (UShort_t w = bits[i]; w; w &= w-1) n++;
+#endif
+   }
+   return n;
+}
+
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Default c-tor
 
@@ -206,34 +236,17 @@ Int_t TEntryListBlock::Contains(Int_t entry)
       Bool_t result = (fIndices[i] & (1<<j))!=0;
       return result;
    }
-   //list
-   if (entry < fCurrent) fCurrent = 0;
-   if (fPassing && fIndices){
-      for (Int_t i = fCurrent; i<fNPassed; i++){
-         if (fIndices[i]==entry){
-            fCurrent = i;
-            return kTRUE;
-         }
-      }
-   } else {
-      if (!fIndices || fNPassed==0){
-         //all entries pass
-         return kTRUE;
-      }
-      if (entry > fIndices[fNPassed-1])
-         return kTRUE;
-      for (Int_t i= fCurrent; i<fNPassed; i++){
-         if (fIndices[i]==entry){
-            fCurrent = i;
-            return kFALSE;
-         }
-         if (fIndices[i]>entry){
-            fCurrent = i;
-            return kTRUE;
-         }
-      }
+   //list, sorted: check the position found last time, then bisect
+   if (!fIndices || fNPassed==0){
+      //empty list of passing entries, or all entries pass
+      return !fPassing;
    }
-   return 0;
+   Int_t pos;
+   if (fCurrent < fNPassed && fIndices[fCurrent] == entry) pos = fCurrent;
+   else pos = std::lower_bound(fIndices, fIndices+fNPassed, (UShort_t)entry) - fIndices;
+   Bool_t found = pos < fNPassed && fIndices[pos] == entry;
+   if (pos < fNPassed) fCurrent = pos;
+   return fPassing ? found : !found;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -242,10 +255,12 @@ Int_t TEntryListBlock::Contains(Int_t entry)
 
 Int_t TEntryListBlock::Merge(TEntryListBlock *block)
 {
-   Int_t i, j;
+   Int_t i;
    if (block->GetNPassed() == 0) return GetNPassed();
    if (GetNPassed() == 0){
       //this block is empty
+      if (fIndices)
+         delete [] fIndices;
       fN = block->fN;
       fIndices = new UShort_t[fN];
       for (i=0; i<fN; i++)
@@ -260,34 +275,18 @@ Int_t TEntryListBlock::Merge(TEntryListBlock *block)
    }
    if (fType==0){
       //stored as bits
-      if (block->fType == 0){
-         for (i=0; i<kBlockSize*16; i++){
-            if (block->Contains(i))
-               Enter(i);
+      if (block->fType == 1 && block->fPassing){
+         //the other block stores entries that pass
+         for (i=0; i<block->fNPassed; i++){
+            Enter(block->fIndices[i]);
          }
       } else {
-         if (block->fPassing){
-            //the other block stores entries that pass
-            for (i=0; i<block->fNPassed; i++){
-               Enter(block->fIndices[i]);
-            }
-         } else {
-            //the other block stores entries that don't pass
-            if (block->fNPassed==0){
-               for (i=0; i<kBlockSize*16; i++){
-                  Enter(i);
-               }
-            }
-            for (j=0; j<block->fIndices[0]; j++)
-               Enter(j);
-            for (i=0; i<block->fNPassed-1; i++){
-               for (j=block->fIndices[i]+1; j<block->fIndices[i+1]; j++){
-                  Enter(j);
-               }
-            }
-            for (j=block->fIndices[block->fNPassed-1]+1; j<kBlockSize*16; j++)
-               Enter(j);
-         }
+         //or the words of both blocks
+         UShort_t bits[kBlockSize];
+         block->GetBits(bits);
+         for (i=0; i<kBlockSize; i++)
+            fIndices[i] |= bits[i];
+         fNPassed = CountBits(fIndices);
       }
    } else {
       //stored as a list
@@ -363,6 +362,58 @@ Int_t TEntryListBlock::Merge(TEntryListBlock *block)
    return GetNPassed();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Remove all the entries of the other block from this block
+/// Returns the resulting number of entries in the block
+
+Int_t TEntryListBlock::Subtract(TEntryListBlock *block)
+{
+   Int_t i;
+   if (GetNPassed() == 0 || block->GetNPassed() == 0) return GetNPassed();
+   if (fType!=0){
+      //change to bits
+      UShort_t *bits = new UShort_t[kBlockSize];
+      Transform(1, bits);
+   }
+   if (block->fType == 1 && block->fPassing){
+      //the other block stores entries that pass
+      for (i=0; i<block->fNPassed; i++){
+         Remove(block->fIndices[i]);
+      }
+   } else {
+      //and the words of this block with the complement of the other block
+      UShort_t bits[kBlockSize];
+      block->GetBits(bits);
+      for (i=0; i<kBlockSize; i++)
+         fIndices[i] &= ~bits[i];
+      fNPassed = CountBits(fIndices);
+   }
+   fLastIndexQueried = -1;
+   fLastIndexReturned = -1;
+   OptimizeStorage();
+   return GetNPassed();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill the kBlockSize words of bits with the bits representation of this
+/// block, whatever its current representation
+
+void TEntryListBlock::GetBits(UShort_t *bits) const
+{
+   Int_t i;
+   if (fType==0 && fIndices){
+      for (i=0; i<kBlockSize; i++)
+         bits[i] = fIndices[i];
+      return;
+   }
+   UShort_t fill = fPassing ? 0 : 65535;
+   for (i=0; i<kBlockSize; i++)
+      bits[i] = fill;
+   if (!fIndices) return;
+   for (i=0; i<fNPassed; i++)
+      bits[fIndices[i]>>4] ^= 1<<(fIndices[i] & 15);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Returns the number of entries, passing the selection.
 /// In case, when the block stores entries that pass (fPassing=1) returns fNPassed
@@ -487,6 +538,65 @@ Int_t TEntryListBlock::Next()
    return -1;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return the first entry >= entry of the block and set last to the last entry
+/// of the run of consecutive entries starting there.
+/// Returns -1 if there is no entry >= entry in the block.
+/// Whole words of the bits representation are skipped at once.
+
+Int_t TEntryListBlock::NextRun(Int_t entry, Int_t &last)
+{
+   const Int_t nmax = kBlockSize*16;
+   if (entry < 0) entry = 0;
+   if (entry >= nmax) return -1;
+   if (!fIndices){
+      if (fPassing) return -1;
+      //all entries pass
+      last = nmax-1;
+      return entry;
+   }
+   if (fType==0){
+      //bits: find the first bit set, then the first bit not set after it
+      Int_t i = entry>>4;
+      UShort_t word = fIndices[i] & (0xFFFF << (entry & 15));
+      while (!word){
+         if (++i == kBlockSize) return -1;
+         word = fIndices[i];
+      }
+      Int_t first = i*16;
+      while (!(word & 1)) { word >>= 1; first++; }
+      Int_t j = first+1;
+      i = j>>4;
+      while (i < kBlockSize){
+         // complement of the bits from j on
+         UShort_t holes = ~fIndices[i] & (0xFFFF << (j & 15));
+         if (holes){
+            j = i*16;
+            while (!(holes & 1)) { holes >>= 1; j++; }
+            break;
+         }
+         j = ++i*16;
+      }
+      last = j-1;
+      return first;
+   }
+   Int_t pos = std::lower_bound(fIndices, fIndices+fNPassed, (UShort_t)entry) - fIndices;
+   if (fPassing){
+      //list of the entries that pass
+      if (pos == fNPassed) return -1;
+      Int_t first = fIndices[pos];
+      last = first;
+      while (pos+1 < fNPassed && fIndices[pos+1] == last+1) { pos++; last++; }
+      return first;
+   }
+   //list of the entries that don't pass
+   Int_t first = entry;
+   while (pos < fNPassed && fIndices[pos] == first) { pos++; first++; }
+   if (first >= nmax) return -1;
+   last = pos < fNPassed ? fIndices[pos]-1 : nmax-1;
+   return first;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Print the entries in this block
 
@@ -169,6 +169,16 @@ void TLeafB::ReadBasketExport(TBuffer& b, TClonesArray* list, Int_t n)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Entries of single bytes are already in the host representation, nothing
+/// to convert. Used by TBranch::GetBulkEntries.
+/// Returns kFALSE if the leaf has a variable length.
+
+Bool_t TLeafB::ReadBasketFast(TBuffer &, Long64_t)
+{
+   return fLeafCount == 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read a 8 bit integer from std::istream s and store it into the branch buffer.
 
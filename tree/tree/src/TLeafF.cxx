@@ -156,6 +156,20 @@ void TLeafF::ReadBasketExport(TBuffer &b, TClonesArray *list, Int_t n)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Convert in place to the host byte order the n entries starting at the
+/// current position of b. Used by TBranch::GetBulkEntries.
+/// Returns kFALSE if the leaf has a variable length.
+
+Bool_t TLeafF::ReadBasketFast(TBuffer &b, Long64_t n)
+{
+   if (fLeafCount) return kFALSE;
+
+   Float_t *values = reinterpret_cast<Float_t*>(b.Buffer() + b.Length());
+   b.ReadFastArray(values, Int_t(n*fLen));
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read a float from std::istream s and store it into the branch buffer.
 
@@ -199,6 +199,20 @@ void TLeafL::ReadBasketExport(TBuffer &b, TClonesArray *list, Int_t n)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Convert in place to the host byte order the n entries starting at the
+/// current position of b. Used by TBranch::GetBulkEntries.
+/// Returns kFALSE if the leaf has a variable length.
+
+Bool_t TLeafL::ReadBasketFast(TBuffer &b, Long64_t n)
+{
+   if (fLeafCount) return kFALSE;
+
+   Long64_t *values = reinterpret_cast<Long64_t*>(b.Buffer() + b.Length());
+   b.ReadFastArray(values, Int_t(n*fLen));
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read a long integer from std::istream s and store it into the branch buffer.
 
@@ -151,6 +151,16 @@ void TLeafO::ReadBasketExport(TBuffer &b, TClonesArray *list, Int_t n)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Entries of single bytes are already in the host representation, nothing
+/// to convert. Used by TBranch::GetBulkEntries.
+/// Returns kFALSE if the leaf has a variable length.
+
+Bool_t TLeafO::ReadBasketFast(TBuffer &, Long64_t)
+{
+   return fLeafCount == 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read a string from std::istream s and store it into the branch buffer.
 
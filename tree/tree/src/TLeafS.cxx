@@ -181,6 +181,20 @@ void TLeafS::ReadBasketExport(TBuffer &b, TClonesArray *list, Int_t n)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Convert in place to the host byte order the n entries starting at the
+/// current position of b. Used by TBranch::GetBulkEntries.
+/// Returns kFALSE if the leaf has a variable length.
+
+Bool_t TLeafS::ReadBasketFast(TBuffer &b, Long64_t n)
+{
+   if (fLeafCount) return kFALSE;
+
+   Short_t *values = reinterpret_cast<Short_t*>(b.Buffer() + b.Length());
+   b.ReadFastArray(values, Int_t(n*fLen));
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Read a integer integer from std::istream s and store it into the branch buffer.
 
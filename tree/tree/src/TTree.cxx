@@ -338,6 +338,7 @@ End_Macro
 
 #include "TArrayC.h"
 #include "TBufferFile.h"
+#include "ROOT/TBufferPool.hxx"
 #include "TBaseClass.h"
 #include "TBasket.h"
 #include "TBranchClones.h"
@@ -380,6 +381,8 @@ End_Macro
 #include "TStyle.h"
 #include "TSystem.h"
 #include "TTreeCloner.h"
+#include "TBasketIndexDelta.h"
+#include "TCompressionDictionaries.h"
 #include "TTreeCache.h"
 #include "TTreeCacheUnzip.h"
 #include "TVirtualCollectionProxy.h"
@@ -392,6 +395,7 @@ End_Macro
 #include "TSchemaRuleSet.h"
 #include "TFileMergeInfo.h"
 #include "ROOT/StringConv.hxx"
+#include "ROOT/TTrace.hxx"
 
 #include <chrono>
 #include <cstddef>
@@ -408,10 +412,12 @@ End_Macro
 #include <thread>
 #include <string>
 #include <sstream>
+#include <vector>
 #endif
 
 constexpr Int_t   kNEntriesResort    = 100;
 constexpr Float_t kNEntriesResortInv = 1.f/kNEntriesResort;
+constexpr Long64_t kIMTMinTaskBytes  = 256*1024; // compressed bytes below which branches share a prefetch task
 
 Int_t    TTree::fgBranchStyle = 1;  // Use new TBranch style with TBranchElement.
 Long64_t TTree::fgMaxTreeSize = 100000000000LL;
@@ -456,6 +462,43 @@ static char DataTypeToChar(EDataType datatype)
    return 0;
 }
 
+#ifdef R__USE_IMT
+////////////////////////////////////////////////////////////////////////////////
+/// Collect the write baskets of `branch` and its sub-branches which can be
+/// compressed ahead of TTree::FlushBaskets.
+///
+/// With implicit multi-threading each branch has its own transient buffer
+/// for compression (see TBranch::GetTransientBuffer), so only the write
+/// basket is considered and only if no other basket of the same branch is
+/// waiting to be written.
+
+static void CollectBasketsToCompress(TBranch *branch, std::vector<TBasket*> &pending)
+{
+   TFile *file = branch->GetFile(1);
+   TObjArray *baskets = branch->GetListOfBaskets();
+   Int_t wb = branch->GetWriteBasket();
+   if (branch->GetDirectory() && file && file->IsWritable() && baskets->GetEntries()) {
+      TBasket *basket = (TBasket*)baskets->UncheckedAt(wb);
+      Bool_t alone = kTRUE;
+      for (Int_t i = 0; alone && i < wb; ++i) {
+         TBasket *other = (TBasket*)baskets->UncheckedAt(i);
+         if (other && other->GetNevBuf() && branch->GetBasketSeek(i) == 0) alone = kFALSE;
+      }
+      if (alone && basket && basket->IsA() == TBasket::Class() && basket->GetNevBuf()
+          && branch->GetBasketSeek(wb) == 0 && basket->GetBufferRef()->IsWriting()
+          && !basket->GetBufferRef()->TestBit(TBufferFile::kNotDecompressed)) {
+         pending.push_back(basket);
+      }
+   }
+   TObjArray *subbranches = branch->GetListOfBranches();
+   Int_t nsub = subbranches->GetEntriesFast();
+   for (Int_t i = 0; i < nsub; ++i) {
+      TBranch *sub = (TBranch*)subbranches->UncheckedAt(i);
+      if (sub) CollectBasketsToCompress(sub, pending);
+   }
+}
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 /// \class TTree::TFriendLock
 /// Helper class to prevent infinite recursion in the usage of TTree Friends.
@@ -703,6 +746,16 @@ TTree::TTree()
 , fCacheUserSet(kFALSE)
 , fIMTEnabled(ROOT::IsImplicitMTEnabled())
 , fNEntriesSinceSorting(0)
+, fIMTClusterMode(kFALSE)
+, fIMTFirstEntry(-1)
+, fIMTLastEntry(-1)
+, fAdaptiveBasketMemory(0)
+, fAdaptiveBasketEntry(0)
+, fAutoSaveDeltas(0)
+, fBasketIndexDelta(0)
+, fFriendMapMaster(0)
+, fFriendMapFirst(-1)
+, fFriendMapLast(-1)
 {
    fMaxEntries = 1000000000;
    fMaxEntries *= 1000;
@@ -781,6 +834,16 @@ TTree::TTree(const char* name, const char* title, Int_t splitlevel /* = 99 */)
 , fCacheUserSet(kFALSE)
 , fIMTEnabled(ROOT::IsImplicitMTEnabled())
 , fNEntriesSinceSorting(0)
+, fIMTClusterMode(kFALSE)
+, fIMTFirstEntry(-1)
+, fIMTLastEntry(-1)
+, fAdaptiveBasketMemory(0)
+, fAdaptiveBasketEntry(0)
+, fAutoSaveDeltas(0)
+, fBasketIndexDelta(0)
+, fFriendMapMaster(0)
+, fFriendMapFirst(-1)
+, fFriendMapLast(-1)
 {
    // TAttLine state.
    SetLineColor(gStyle->GetHistLineColor());
@@ -894,6 +957,8 @@ TTree::~TTree()
    }
    delete fTreeIndex;
    fTreeIndex = 0;
+   delete fBasketIndexDelta;
+   fBasketIndexDelta = 0;
    delete fBranchRef;
    fBranchRef = 0;
    delete [] fClusterRangeEnd;
@@ -905,7 +970,7 @@ TTree::~TTree()
    fDirectory = 0;
 
    if (fTransientBuffer) {
-      delete fTransientBuffer;
+      ROOT::Internal::TBufferPool::DeleteBuffer(fTransientBuffer);
       fTransientBuffer = 0;
    }
 }
@@ -921,10 +986,93 @@ TBuffer* TTree::GetTransientBuffer(Int_t size)
       }
       return fTransientBuffer;
    }
-   fTransientBuffer = new TBufferFile(TBuffer::kRead, size);
+   fTransientBuffer = ROOT::Internal::TBufferPool::CreateBuffer(TBuffer::kRead, size);
    return fTransientBuffer;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Re-balance the basket sizes of the branches, called at each cluster flush
+/// when the adaptive basket sizing is enabled (see SetAdaptiveBaskets).
+///
+/// For each branch, the uncompressed and compressed sizes of one entry are
+/// estimated from the cluster just written and folded into running averages,
+/// so that the estimate follows the content of the tree when it changes
+/// during the run. The basket of a branch is then sized to hold one cluster
+/// of entries (including the entry offsets of variable size branches); when
+/// the sum of these sizes exceeds the memory budget, all the baskets are
+/// scaled down by the same factor. A branch is only resized when its new
+/// basket size differs by more than an eighth from the current one, to avoid
+/// reallocating the baskets at each cluster. Each change is reported to the
+/// TVirtualPerfStats object of the tree, if any (see TTreePerfStats).
+
+void TTree::AdaptBaskets()
+{
+   Long64_t nentries = fEntries - fAdaptiveBasketEntry;
+   if (fAdaptiveBasketMemory <= 0 || nentries <= 0) return;
+
+   TObjArray *leaves = GetListOfLeaves();
+   Int_t nleaves = leaves->GetEntriesFast();
+   if (nleaves == 0) return;
+   if ((Int_t)fBasketSizeInfo.size() < nleaves) fBasketSizeInfo.resize(nleaves, TBasketSizeInfo{0, 0, 0, -1, -1});
+
+   // Weight of the last cluster in the running averages.
+   const Double_t kWeight = 0.5;
+   std::vector<Double_t> wanted(nleaves, 0.);
+   Double_t total = 0;
+   for (Int_t i = 0; i < nleaves; ++i) {
+      TLeaf *leaf = (TLeaf*)leaves->UncheckedAt(i);
+      TBranch *branch = leaf->GetBranch();
+      // Consider each terminal branch once, through its first leaf.
+      if (branch->GetListOfLeaves()->UncheckedAt(0) != leaf) continue;
+      if (branch->GetListOfBranches()->GetEntriesFast() > 0) continue;
+
+      TBasketSizeInfo &info = fBasketSizeInfo[i];
+      if (info.fBranch != branch || branch->GetTotBytes() < info.fTotBytes) {
+         info = TBasketSizeInfo{branch, 0, 0, -1, -1};
+      }
+      Double_t entrySize = Double_t(branch->GetTotBytes() - info.fTotBytes) / nentries;
+      Double_t entryZipSize = Double_t(branch->GetZipBytes() - info.fZipBytes) / nentries;
+      if (info.fEntrySize < 0) {
+         info.fEntrySize = entrySize;
+         info.fEntryZipSize = entryZipSize;
+      } else {
+         info.fEntrySize = kWeight * entrySize + (1 - kWeight) * info.fEntrySize;
+         info.fEntryZipSize = kWeight * entryZipSize + (1 - kWeight) * info.fEntryZipSize;
+      }
+      info.fTotBytes = branch->GetTotBytes();
+      info.fZipBytes = branch->GetZipBytes();
+
+      wanted[i] = info.fEntrySize * nentries;
+      if (branch->GetEntryOffsetLen() > 0) wanted[i] += nentries * sizeof(Int_t) * 2; // make room for the entry offsets
+      total += wanted[i];
+   }
+   fAdaptiveBasketEntry = fEntries;
+   if (total <= 0) return;
+
+   Double_t memFactor = Double_t(fAdaptiveBasketMemory) / total;
+   if (memFactor > 1) memFactor = 1;
+   // Really, really never give more than 1Gb to a single buffer.
+   static const Double_t hardmax = 1*1024*1024*1024;
+   for (Int_t i = 0; i < nleaves; ++i) {
+      if (wanted[i] <= 0) continue;
+      TBasketSizeInfo &info = fBasketSizeInfo[i];
+      TBranch *branch = info.fBranch;
+      Double_t bsize = wanted[i] * memFactor;
+      if (bsize < info.fEntrySize) bsize = info.fEntrySize + 1;
+      if (bsize > hardmax) bsize = hardmax;
+      Int_t newBsize = Int_t(bsize);
+      newBsize = newBsize - newBsize%512 + 512;
+      Int_t oldBsize = branch->GetBasketSize();
+      if (8 * TMath::Abs(newBsize - oldBsize) <= oldBsize) continue;
+      if (gDebug > 0) Info("AdaptBaskets", "Changing buffer size from %6d to %6d bytes for %s at entry %lld", oldBsize, newBsize, branch->GetName(), fEntries);
+      branch->SetBasketSize(newBsize);
+      if (fPerfStats) {
+         Double_t comp = info.fEntryZipSize > 0 ? info.fEntrySize / info.fEntryZipSize : 1;
+         fPerfStats->BasketSizeEvent(this, branch, fEntries, oldBsize, branch->GetBasketSize(), comp);
+      }
+   }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Add branch with name bname to the Tree cache.
 /// If bname="*" all branches are added to the cache.
@@ -1341,7 +1489,7 @@ Long64_t TTree::AutoSave(Option_t* option)
    TString opt = option;
    opt.ToLower();
 
-   if (opt.Contains("flushbaskets")) {
+   if (opt.Contains("flushbaskets") || fAutoSaveDeltas > 0) {
       if (gDebug > 0) printf("AutoSave:  calling FlushBaskets \n");
       FlushBaskets();
    }
@@ -1350,13 +1498,29 @@ Long64_t TTree::AutoSave(Option_t* option)
 
    TKey *key = (TKey*)fDirectory->GetListOfKeys()->FindObject(GetName());
    Long64_t nbytes;
-   if (opt.Contains("overwrite")) {
-      nbytes = fDirectory->WriteTObject(this,"","overwrite");
+   if (fAutoSaveDeltas > 0 && fBasketIndexDelta && key && !opt.Contains("overwrite")
+       && fBasketIndexDelta->GetNdeltas() < fAutoSaveDeltas && fBasketIndexDelta->Update(this)) {
+      // Only write the baskets written since the previous AutoSave.
+      nbytes = fDirectory->WriteTObject(fBasketIndexDelta, TBasketIndexDelta::GetKeyName(this));
+      if (nbytes) {
+         fBasketIndexDelta->Reset(this, kFALSE);
+      }
    } else {
-      nbytes = fDirectory->WriteTObject(this); //nbytes will be 0 if Write failed (disk space exceeded)
-      if (nbytes && key) {
-         key->Delete();
-         delete key;
+      if (opt.Contains("overwrite")) {
+         nbytes = fDirectory->WriteTObject(this,"","overwrite");
+      } else {
+         nbytes = fDirectory->WriteTObject(this); //nbytes will be 0 if Write failed (disk space exceeded)
+         if (nbytes && key) {
+            key->Delete();
+            delete key;
+         }
+      }
+      if (nbytes && fBasketIndexDelta) {
+         TBasketIndexDelta::DeleteAll(this, fDirectory);
+      }
+      if (nbytes && fAutoSaveDeltas > 0) {
+         if (fBasketIndexDelta) fBasketIndexDelta->Reset(this, kTRUE);
+         else fBasketIndexDelta = new TBasketIndexDelta(this);
       }
    }
    // save StreamerInfo
@@ -2534,6 +2698,7 @@ void TTree::Browse(TBrowser* b)
 
 Int_t TTree::BuildIndex(const char* majorname, const char* minorname /* = "0" */)
 {
+   fFriendMapMaster = 0;
    fTreeIndex = GetPlayer()->BuildIndex(this, majorname, minorname);
    if (fTreeIndex->IsZombie()) {
       delete fTreeIndex;
@@ -2704,6 +2869,8 @@ TFile* TTree::ChangeFile(TFile* file)
          if (t->GetBranchRef()) {
             t->GetBranchRef()->SetFile(newfile);
          }
+         // The baskets written in the new file use the same dictionaries.
+         t->WriteCompressionDictionaries();
          continue;
       }
       // Not a TH1 or a TTree, move object to new file.
@@ -3337,7 +3504,10 @@ namespace {
 ///
 /// If 'option' contains the word 'fast' and nentries is -1, the cloning will be
 /// done without unzipping or unstreaming the baskets (i.e., a direct copy of the
-/// raw bytes on disk).
+/// raw bytes on disk).  If nentries is smaller than the number of entries of
+/// the tree, the clusters within the first nentries are copied that way
+/// (provided their baskets are aligned on the cluster boundaries, see
+/// TTreeCloner::ExecRange) and the remaining entries are copied one by one.
 ///
 /// When 'fast' is specified, 'option' can also contains a sorting order for the
 /// baskets in the output file.
@@ -3350,6 +3520,12 @@ namespace {
 ///
 /// See TTree::CloneTree for a detailed explanation of the semantics of these 3 options.
 ///
+/// By default the fast cloning copies the baskets with their input compression.
+/// With the option 'recompress', the baskets of the branches whose compression
+/// settings differ in this tree are uncompressed and compressed again with the
+/// settings of this tree, without being unstreamed (and concurrently when
+/// implicit multi-threading is enabled). The baskets and clusters are preserved.
+///
 /// If the tree or any of the underlying tree of the chain has an index, that index and any
 /// index in the subsequent underlying TTree objects will be merged.
 ///
@@ -3370,6 +3546,7 @@ Long64_t TTree::CopyEntries(TTree* tree, Long64_t nentries /* = -1 */, Option_t*
    TString opt = option;
    opt.ToLower();
    Bool_t fastClone = opt.Contains("fast");
+   Bool_t recompress = opt.Contains("recompress");
    Bool_t withIndex = !opt.Contains("noindex");
    EOnIndexError onIndexError;
    if (opt.Contains("asisindex")) {
@@ -3426,7 +3603,9 @@ Long64_t TTree::CopyEntries(TTree* tree, Long64_t nentries /* = -1 */, Option_t*
                }
             }
          }
-         TTreeCloner cloner(tree->GetTree(), this, option, TTreeCloner::kNoWarnings);
+         UInt_t cloneOptions = TTreeCloner::kNoWarnings;
+         if (recompress) cloneOptions |= TTreeCloner::kRecompress;
+         TTreeCloner cloner(tree->GetTree(), this, option, cloneOptions);
          if (cloner.IsValid()) {
             this->SetEntries(this->GetEntries() + tree->GetTree()->GetEntries());
             if (cacheSize != -1) cloner.SetCacheSize(cacheSize);
@@ -3473,8 +3652,11 @@ Long64_t TTree::CopyEntries(TTree* tree, Long64_t nentries /* = -1 */, Option_t*
          nentries = treeEntries;
       }
       Int_t treenumber = -1;
+      TTreeCloner *cloner = 0;
+      Long64_t clusterEnd = 0;
       for (Long64_t i = 0; i < nentries; i++) {
-         if (tree->LoadTree(i) < 0) {
+         Long64_t localEntry = tree->LoadTree(i);
+         if (localEntry < 0) {
             break;
          }
          if (treenumber != tree->GetTreeNumber()) {
@@ -3482,12 +3664,35 @@ Long64_t TTree::CopyEntries(TTree* tree, Long64_t nentries /* = -1 */, Option_t*
                withIndex = R__HandleIndex( onIndexError, this, tree );
             }
             treenumber = tree->GetTreeNumber();
+            if (fastClone) {
+               UInt_t cloneOptions = TTreeCloner::kNoWarnings | TTreeCloner::kNoFileCache;
+               if (recompress) cloneOptions |= TTreeCloner::kRecompress;
+               delete cloner;
+               cloner = new TTreeCloner(tree->GetTree(), this, option, cloneOptions);
+            }
+            clusterEnd = 0;
+         }
+         if (cloner && localEntry >= clusterEnd) {
+            // Copy the clusters which are entirely within the first nentries
+            // without unzipping them, the others entry by entry.
+            TClusterIterator clusters = tree->GetTree()->GetClusterIterator(localEntry);
+            Long64_t clusterStart = clusters();
+            clusterEnd = clusters.GetNextEntry();
+            if (clusterStart == localEntry && i + clusterEnd - clusterStart <= nentries) {
+               Long64_t totbytes = GetTotBytes();
+               if (cloner->ExecRange(clusterStart, clusterEnd)) {
+                  nbytes += GetTotBytes() - totbytes;
+                  i += clusterEnd - clusterStart - 1;
+                  continue;
+               }
+            }
          }
          if (tree->GetEntry(i) <= 0) {
             break;
          }
          nbytes += this->Fill();
       }
+      delete cloner;
       if (this->GetTreeIndex()) {
          this->GetTreeIndex()->Append(0,kFALSE); // Force the sorting
       }
@@ -3649,6 +3854,8 @@ void TTree::DirectoryAutoAdd(TDirectory* dir)
       fBranchRef->UpdateFile();
    }
    if (fDirectory) fDirectory->Append(this);
+   // Bring the tree up to its last incremental AutoSave, if any.
+   TBasketIndexDelta::ReadAll(this, fDirectory);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -4117,6 +4324,27 @@ Long64_t TTree::Draw(const char* varexp, const TCut& selection, Option_t* option
 ///
 /// When option contains "norm" the output histogram is normalized to 1.
 ///
+/// ## Compiling the expressions
+///
+/// When option contains "jit", the selection and the expressions are compiled
+/// into native functions (see TTreeFormula::JitCompile) instead of being
+/// interpreted for each entry. Only the expressions made of arithmetic,
+/// logical and mathematical operations on scalar leaves of basic types are
+/// compiled, the others are interpreted as usual.
+///
+/// ## Implicit multi-threading
+///
+/// When implicit multi-threading is enabled (see ROOT::EnableImplicitMT) and
+/// the tree is read from a file (not a TChain, without friends, entry list or
+/// event list), the histograms and profiles are filled concurrently: each
+/// thread reads a range of clusters from its own copy of the tree and fills
+/// its own copy of the histogram, and the copies are merged at the end.
+/// When the histogram limits are computed from the data, the entries used to
+/// compute them (see TTree::SetEstimate) are processed sequentially; give the
+/// limits explicitly, e.g. `tree.Draw("x>>h(100,0,10)")`, to process all the
+/// entries concurrently. TTree::Project and TTree::GetEntries(selection) use
+/// threads in the same way.
+///
 /// ## Saving the result of Draw to a TEventList, a TEntryList or a TEntryListArray
 ///
 /// TTree::Draw can be used to fill a TEventList object (list of entry numbers)
@@ -4432,7 +4660,9 @@ Int_t TTree::Fill()
 
             //First call FlushBasket to make sure that fTotBytes is up to date.
             FlushBaskets();
-            OptimizeBaskets(fTotBytes,1,"");
+            TrainCompressionDictionaries();
+            if (fAdaptiveBasketMemory > 0) AdaptBaskets();
+            else OptimizeBaskets(fTotBytes,1,"");
             if (gDebug > 0) Info("TTree::Fill","OptimizeBaskets called at entry %lld, fZipBytes=%lld, fFlushedBytes=%lld\n",fEntries,fZipBytes,fFlushedBytes);
             fFlushedBytes = fZipBytes;
             fAutoFlush    = fEntries;  // Use test on entries rather than bytes
@@ -4469,6 +4699,7 @@ Int_t TTree::Fill()
             if (gDebug > 0) Info("TTree::Fill","FlushBasket called at entry %lld, fZipBytes=%lld, fFlushedBytes=%lld\n",fEntries,fZipBytes,fFlushedBytes);
          }
          fFlushedBytes = fZipBytes;
+         if (fAdaptiveBasketMemory > 0) AdaptBaskets();
       } else if (fNClusterRange == 0 && fEntries > 1 && fAutoFlush && fEntries%fAutoFlush == 0) {
          if (fAutoSave != 0 && fEntries%fAutoSave == 0) {
             //We are at an AutoSave point. AutoSave flushes baskets and saves the Tree header
@@ -4480,6 +4711,7 @@ Int_t TTree::Fill()
             if (gDebug > 0) Info("TTree::Fill","FlushBasket called at entry %lld, fZipBytes=%lld, fFlushedBytes=%lld\n",fEntries,fZipBytes,fFlushedBytes);
          }
          fFlushedBytes = fZipBytes;
+         if (fAdaptiveBasketMemory > 0) AdaptBaskets();
       }
    }
    // Check that output file is still below the maximum size.
@@ -4802,6 +5034,31 @@ Int_t TTree::FlushBaskets() const
    Int_t nerror = 0;
    TObjArray *lb = const_cast<TTree*>(this)->GetListOfBranches();
    Int_t nb = lb->GetEntriesFast();
+
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled() && fIMTEnabled) {
+      // Compress the pending baskets concurrently. They are then written
+      // below in the usual sequential order, so that the allocation of the
+      // file space (and hence the file layout) does not depend on the
+      // scheduling of the tasks.
+      std::vector<TBasket*> pending;
+      for (Int_t j = 0; j < nb; j++) {
+         TBranch* branch = (TBranch*) lb->UncheckedAt(j);
+         if (branch) CollectBasketsToCompress(branch, pending);
+      }
+      if (pending.size() > 1) {
+         tbb::task_group g;
+         for (auto basket : pending) {
+            g.run([basket]() {
+               // In case of failure the compression is simply attempted
+               // again (and the error reported) by TBasket::WriteBuffer.
+               basket->CompressBuffer();
+            });
+         }
+         g.wait();
+      }
+   }
+#endif
    for (Int_t j = 0; j < nb; j++) {
       TBranch* branch = (TBranch*) lb->UncheckedAt(j);
       if (branch) {
@@ -5208,6 +5465,7 @@ Long64_t TTree::GetEntriesFriend() const
 
 Int_t TTree::GetEntry(Long64_t entry, Int_t getall)
 {
+   R__TRACE_ZONE("TTree::GetEntry", "io");
 
    // We already have been visited while recursively looking
    // through the friends tree, let return
@@ -5235,7 +5493,17 @@ Int_t TTree::GetEntry(Long64_t entry, Int_t getall)
    };
 
 #ifdef R__USE_IMT
-   if (ROOT::IsImplicitMTEnabled() && fIMTEnabled) {
+   if (ROOT::IsImplicitMTEnabled() && fIMTEnabled && fIMTClusterMode) {
+      // The baskets of the cluster are unzipped by parallel tasks when the
+      // cluster is entered; the entries are then deserialized sequentially.
+      if (entry < fIMTFirstEntry || entry >= fIMTLastEntry) {
+         nb = PrefetchClusterBaskets(entry, getall);
+      }
+      if (nb >= 0) {
+         nb = 0;
+         seqprocessing();
+      }
+   } else if (ROOT::IsImplicitMTEnabled() && fIMTEnabled) {
       if (fSortedBranches.empty()) InitializeSortedBranches();
 
       // Enable this IMT use case (activate its locks)
@@ -5348,6 +5616,86 @@ void TTree::InitializeSortedBranches()
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Read and unzip, in parallel tasks, the baskets of the cluster containing
+/// entry for all the branches read by GetEntry (see SetImplicitMTClusterMode).
+/// The branches are sorted by the compressed size of their baskets in the
+/// cluster; each of the largest ones gets a task of its own while the small
+/// ones are grouped, so that each task has at least kIMTMinTaskBytes to read.
+/// Returns the number of baskets read, or a negative value in case of error.
+
+Int_t TTree::PrefetchClusterBaskets(Long64_t entry, Int_t getall)
+{
+#ifdef R__USE_IMT
+   TClusterIterator clusters = GetClusterIterator(entry);
+   Long64_t first = clusters();
+   Long64_t last = clusters.GetNextEntry();
+   if (first > entry) first = entry;
+   if (last <= entry) last = entry + 1;
+   if (last > fEntries) last = fEntries;
+   fIMTFirstEntry = first;
+   fIMTLastEntry = last;
+
+   // The branches (and sub-branches) read by GetEntry, with their bytes in the cluster.
+   std::vector<std::pair<Long64_t,TBranch*>> branches;
+   std::vector<TObjArray*> lists(1, &fBranches);
+   while (!lists.empty()) {
+      TObjArray *list = lists.back();
+      lists.pop_back();
+      for (Int_t i = 0, n = list->GetEntriesFast(); i < n; ++i) {
+         TBranch *branch = (TBranch*)list->UncheckedAt(i);
+         if (!branch || (branch->TestBit(kDoNotProcess) && !getall)) continue;
+         lists.push_back(branch->GetListOfBranches());
+         Int_t nbaskets = branch->GetWriteBasket();
+         Long64_t *basketEntry = branch->GetBasketEntry();
+         if (!nbaskets || !basketEntry) continue;
+         Long64_t bytes = 0;
+         for (Int_t b = TMath::Max(0, (Int_t)TMath::BinarySearch(nbaskets, basketEntry, first)); b < nbaskets && basketEntry[b] < last; ++b) {
+            bytes += branch->GetBasketBytes()[b];
+         }
+         if (bytes) branches.emplace_back(bytes, branch);
+      }
+   }
+   if (branches.empty()) return 0;
+   std::sort(branches.begin(), branches.end(),
+             [](const std::pair<Long64_t,TBranch*> &a, const std::pair<Long64_t,TBranch*> &b) {
+                return a.first > b.first;
+             });
+
+   // Enable this IMT use case (activate its locks)
+   ROOT::Internal::TParBranchProcessingRAII pbpRAII;
+
+   std::atomic<Int_t> nread(0);
+   std::atomic<Int_t> errnb(0);
+   tbb::task_group g;
+   size_t begin = 0;
+   while (begin < branches.size()) {
+      size_t end = begin;
+      Long64_t bytes = 0;
+      while (end < branches.size() && (end == begin || bytes < kIMTMinTaskBytes)) {
+         bytes += branches[end++].first;
+      }
+      g.run([&, begin, end]() {
+         for (size_t j = begin; j < end; ++j) {
+            Int_t n = branches[j].second->PrefetchBaskets(first, last - 1);
+            if (n < 0) errnb = n;
+            else       nread += n;
+         }
+      });
+      begin = end;
+   }
+   g.wait();
+   if (errnb < 0) {
+      fIMTFirstEntry = fIMTLastEntry = -1;
+      return errnb;
+   }
+   return nread;
+#else
+   (void)entry; (void)getall;
+   return 0;
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Sorts top-level branches by the last average task time recorded per branch.
 
@@ -6054,13 +6402,109 @@ Long64_t TTree::LoadTree(Long64_t entry)
 /// If we *do* have an index, we must find the (major, minor) value pair
 /// in masterTree to locate our corresponding entry.
 ///
+/// When both trees are plain TTrees and the index names are branches of
+/// masterTree, the lookups are made once for all the entries of the
+/// masterTree cluster holding entry (see BuildFriendEntryMap), instead of
+/// one lookup per LoadTree call.
 
 Long64_t TTree::LoadTreeFriend(Long64_t entry, TTree* masterTree)
 {
    if (!fTreeIndex) {
       return LoadTree(entry);
    }
-   return LoadTree(fTreeIndex->GetEntryNumberFriend(masterTree));
+   if (masterTree != fFriendMapMaster || (fFriendMapLast >= 0 && (entry < fFriendMapFirst || entry >= fFriendMapLast))) {
+      BuildFriendEntryMap(entry, masterTree);
+   }
+   if (masterTree != fFriendMapMaster || fFriendMapLast < 0) {
+      return LoadTree(fTreeIndex->GetEntryNumberFriend(masterTree));
+   }
+   if (fFriendMap.empty()) {
+      return LoadTree(entry);
+   }
+   return LoadTree(fFriendMap[entry - fFriendMapFirst]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Map, with our index, the entries of the masterTree cluster holding entry
+/// to our entries, for LoadTreeFriend. The map is not stored if it is the
+/// identity. Otherwise, if the mapped entries are not too scattered, the
+/// baskets holding them are read at once for the branches we read, in the
+/// order of the file, rather than as the entries come.
+///
+/// The index is evaluated on masterTree at each entry of the cluster, which
+/// only reads the index branches of masterTree. No map is made if masterTree
+/// or we are not plain TTrees or if entry is out of masterTree; if the index
+/// names are not branches (or numbers) of masterTree itself, the map is
+/// marked as unusable (fFriendMapLast < 0) for this masterTree.
+
+void TTree::BuildFriendEntryMap(Long64_t entry, TTree *masterTree)
+{
+   const Long64_t kMaxMapEntries = 1000000;
+
+   fFriendMapMaster = 0;
+   fFriendMap.clear();
+   if (!masterTree || IsA() != TTree::Class() || masterTree->IsA() != TTree::Class()) return;
+   if (entry < 0 || entry >= masterTree->GetEntries()) return;
+   const char *names[2] = { fTreeIndex->GetMajorName(), fTreeIndex->GetMinorName() };
+   for (Int_t i = 0; i < 2; ++i) {
+      if (!TString(names[i]).IsDigit() && !masterTree->GetListOfLeaves()->FindObject(names[i])) {
+         fFriendMapMaster = masterTree;
+         fFriendMapFirst = fFriendMapLast = -1;
+         return;
+      }
+   }
+
+   TClusterIterator clusters = masterTree->GetClusterIterator(entry);
+   Long64_t first = clusters();
+   Long64_t last = clusters.GetNextEntry();
+   if (first > entry) first = entry;
+   if (last <= entry) last = entry + 1;
+   if (last > masterTree->GetEntries()) last = masterTree->GetEntries();
+   if (last - first > kMaxMapEntries) {
+      first = entry;
+      last = TMath::Min(last, entry + kMaxMapEntries);
+   }
+
+   fFriendMap.resize(last - first);
+   Bool_t identity = kTRUE;
+   Long64_t minEntry = -1, maxEntry = -1, nmapped = 0;
+   Long64_t readEntry = masterTree->fReadEntry;
+   for (Long64_t e = first; e < last; ++e) {
+      masterTree->fReadEntry = e;
+      Long64_t mapped = fTreeIndex->GetEntryNumberFriend(masterTree);
+      fFriendMap[e - first] = mapped;
+      if (mapped != e) identity = kFALSE;
+      if (mapped >= 0) {
+         if (!nmapped || mapped < minEntry) minEntry = mapped;
+         if (!nmapped || mapped > maxEntry) maxEntry = mapped;
+         ++nmapped;
+      }
+   }
+   masterTree->fReadEntry = readEntry;
+   fFriendMapMaster = masterTree;
+   fFriendMapFirst = first;
+   fFriendMapLast = last;
+
+   if (identity) {
+      fFriendMap.clear();
+      return;
+   }
+
+   // The baskets of the mapped range are read now unless most of them
+   // would not be used.
+   if (nmapped && maxEntry - minEntry < 4 * nmapped) {
+      std::vector<TObjArray*> lists(1, &fBranches);
+      while (!lists.empty()) {
+         TObjArray *list = lists.back();
+         lists.pop_back();
+         for (Int_t i = 0, n = list->GetEntriesFast(); i < n; ++i) {
+            TBranch *branch = (TBranch*)list->UncheckedAt(i);
+            if (!branch || branch->TestBit(kDoNotProcess)) continue;
+            lists.push_back(branch->GetListOfBranches());
+            branch->PrefetchBaskets(minEntry, maxEntry);
+         }
+      }
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -7389,6 +7833,8 @@ void TTree::RemoveFriend(TTree* oldFriend)
    while ((fe = (TFriendElement*) nextf())) {
       TTree* friend_t = fe->GetTree();
       if (friend_t == oldFriend) {
+         // the entries mapped for us are no longer valid
+         if (friend_t && friend_t->fFriendMapMaster == this) friend_t->fFriendMapMaster = 0;
          fFriends->Remove(fe);
          delete fe;
          fe = 0;
@@ -7411,9 +7857,12 @@ void TTree::Reset(Option_t* option)
    fTotalBuffers  = 0;
    fChainOffset   = 0;
    fReadEntry     = -1;
+   fAdaptiveBasketEntry = 0;
+   fBasketSizeInfo.clear();
 
    delete fTreeIndex;
    fTreeIndex = 0;
+   fFriendMapMaster = 0;
 
    Int_t nb = fBranches.GetEntriesFast();
    for (Int_t i = 0; i < nb; ++i)  {
@@ -7441,6 +7890,8 @@ void TTree::ResetAfterMerge(TFileMergeInfo *info)
    fTotalBuffers  = 0;
    fChainOffset   = 0;
    fReadEntry     = -1;
+   fAdaptiveBasketEntry = 0;
+   fBasketSizeInfo.clear();
 
    delete fTreeIndex;
    fTreeIndex     = 0;
@@ -7554,6 +8005,33 @@ Bool_t TTree::SetAlias(const char* aliasName, const char* aliasFormula)
    return kTRUE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Enable the adaptive basket sizing, with a budget of maxMemory bytes for
+/// the baskets of all the branches; 0 disables it.
+///
+/// By default, the basket sizes are optimized once, by OptimizeBaskets,
+/// at the first AutoFlush, from the content of the first cluster only. In
+/// adaptive mode, the sizes written by each branch are tracked for the whole
+/// run and the basket sizes are re-balanced at every cluster flush (see
+/// AdaptBaskets), so that a branch that becomes sparse or dense later in the
+/// run gets baskets matching its current content. The mode requires
+/// clusters, i.e. a non zero AutoFlush (see SetAutoFlush).
+///
+/// The decisions are reported to the TTreePerfStats object of the tree:
+/// ~~~ {.cpp}
+///     tree->SetAdaptiveBaskets(50000000);
+///     TTreePerfStats *ps = new TTreePerfStats("ioperf", tree);
+///     ... fill the tree ...
+///     ps->Print();
+/// ~~~
+
+void TTree::SetAdaptiveBaskets(Long64_t maxMemory /* = 10000000 */)
+{
+   fAdaptiveBasketMemory = maxMemory > 0 ? maxMemory : 0;
+   fAdaptiveBasketEntry = fEntries;
+   fBasketSizeInfo.clear();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// This function may be called at the start of a program to change
 /// the default value for fAutoFlush.
@@ -7677,6 +8155,30 @@ void TTree::SetAutoSave(Long64_t autos)
    fAutoSave = autos;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Make AutoSave incremental: between two writes of the full tree header,
+/// up to ndeltas AutoSave write only the baskets written since the
+/// previous one, as a TBasketIndexDelta record; 0 disables it.
+///
+/// The full header holds the basket tables of all the branches, so its
+/// size grows with the number of baskets written. For trees with many
+/// branches and long runs, most of what AutoSave writes is thus the
+/// metadata already saved by the previous AutoSave. A record only holds
+/// the new baskets and the counters of the branches; the records are
+/// applied when the tree header is read back (by TFile::Get,
+/// TTree::Refresh or after a recovery), see TBasketIndexDelta. The
+/// incremental AutoSave always flushes the baskets.
+///
+/// The first AutoSave, and every ndeltas+1-th one, writes the full header,
+/// as does TTree::Write, after which the records are deleted. Files
+/// written this way can be read by older versions of ROOT, which ignore
+/// the records and see the tree as of its last full header.
+
+void TTree::SetAutoSaveDeltas(Int_t ndeltas /* = 100 */)
+{
+   fAutoSaveDeltas = ndeltas > 0 ? ndeltas : 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set a branch's basket size.
 ///
@@ -8454,6 +8956,28 @@ void TTree::SetFileNumber(Int_t number)
    fFileNumber = number;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Choose the granularity of the implicit multi-threading of GetEntry.
+///
+/// By default, GetEntry runs one task per top-level branch for each entry,
+/// which only pays off when the branches have much to deserialize: for most
+/// entries the baskets are already unzipped and the tasks cost more than
+/// the work they do. In cluster mode, when GetEntry enters a new cluster,
+/// parallel tasks read and unzip the baskets of the whole cluster for all
+/// the branches read (the small branches sharing a task); the entries of the
+/// cluster are then deserialized sequentially from the baskets in memory.
+/// All the baskets of a cluster are thus kept in memory while it is read.
+///
+/// This has no effect unless implicit multi-threading is enabled (see
+/// ROOT::EnableImplicitMT and SetImplicitMT).
+
+void TTree::SetImplicitMTClusterMode(Bool_t enabled)
+{
+   fIMTClusterMode = enabled;
+   fIMTFirstEntry = -1;
+   fIMTLastEntry = -1;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Set all the branches in this TTree to be in decomposed object mode
 /// (also known as MakeClass mode).
@@ -8583,6 +9107,7 @@ void TTree::SetTreeIndex(TVirtualIndex* index)
       fTreeIndex->SetTree(0);
    }
    fTreeIndex = index;
+   fFriendMapMaster = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -8887,6 +9412,45 @@ void TTree::Streamer(TBuffer& b)
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Train the Zstd dictionaries of the small baskets of the branches, at the
+/// first AutoFlush, on the baskets of the first cluster (see
+/// TBranch::TrainCompressionDictionary), and store them in the file.
+
+void TTree::TrainCompressionDictionaries()
+{
+   TObjArray *leaves = GetListOfLeaves();
+   Int_t nleaves = leaves->GetEntriesFast();
+   for (Int_t i = 0; i < nleaves; ++i) {
+      TLeaf *leaf = (TLeaf*)leaves->UncheckedAt(i);
+      leaf->GetBranch()->TrainCompressionDictionary();
+   }
+   if (fBranchRef) fBranchRef->TrainCompressionDictionary();
+   WriteCompressionDictionaries();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write in the current file the Zstd dictionaries used by the branches and
+/// not yet stored there (see TCompressionDictionaries).
+
+void TTree::WriteCompressionDictionaries()
+{
+   TFile *file = GetCurrentFile();
+   if (!file || !file->IsWritable()) return;
+   std::vector<UInt_t> ids;
+   TObjArray *leaves = GetListOfLeaves();
+   Int_t nleaves = leaves->GetEntriesFast();
+   for (Int_t i = 0; i < nleaves; ++i) {
+      TLeaf *leaf = (TLeaf*)leaves->UncheckedAt(i);
+      UInt_t id = leaf->GetBranch()->GetCompressionDictionary();
+      if (id) ids.push_back(id);
+   }
+   if (fBranchRef && fBranchRef->GetCompressionDictionary()) {
+      ids.push_back(fBranchRef->GetCompressionDictionary());
+   }
+   TCompressionDictionaries::Save(file, ids);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Unbinned fit of one or more variable(s) from a tree.
 ///
@@ -8990,7 +9554,13 @@ void TTree::UseCurrentStyle()
 Int_t TTree::Write(const char *name, Int_t option, Int_t bufsize) const
 {
    FlushBaskets();
-   return TObject::Write(name, option, bufsize);
+   Int_t nbytes = TObject::Write(name, option, bufsize);
+   if (nbytes && fBasketIndexDelta) {
+      // The full header supersedes the incremental AutoSave records.
+      TBasketIndexDelta::DeleteAll(this, fDirectory);
+      fBasketIndexDelta->Reset(this, kTRUE);
+   }
+   return nbytes;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
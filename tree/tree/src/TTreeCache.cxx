@@ -213,6 +213,20 @@ branches that will be used very rarely.
        ... here you process your entry
     }
 ~~~
+## PREFETCHING THE NEXT CLUSTER
+
+By default the baskets of a cluster are read when the first of them is
+needed, i.e. the analysis waits for the I/O at every cluster transition.
+With the asynchronous prefetching enabled, either with the resource
+`TFile.AsyncPrefetching: yes` or by calling
+~~~ {.cpp}
+    file->GetCacheRead(tree)->SetEnablePrefetching(kTRUE);
+~~~
+the cache is double buffered: while the entries of one cluster are being
+processed, the baskets of the next cluster are read by a separate thread.
+The two buffers share the memory given to TTree::SetCacheSize. This is
+supported for remote files and, on Linux, for local files.
+
 ## SPECIAL CASES WHERE TreeCache should not be activated
 
 When reading only a small fraction of all entries such that not all branch
@@ -235,11 +249,13 @@ of effective system reads for a given file with a code like
 #include "TList.h"
 #include "TBranch.h"
 #include "TEventList.h"
+#include "TEntryList.h"
 #include "TObjString.h"
 #include "TRegexp.h"
 #include "TLeaf.h"
 #include "TFriendElement.h"
 #include "TFile.h"
+#include "ROOT/TTrace.hxx"
 #include <limits.h>
 
 Int_t TTreeCache::fgLearnEntries = 100;
@@ -619,10 +635,15 @@ Int_t TTreeCache::DropBranch(const char *bname, Bool_t subbranches /*= kFALSE*/)
 Bool_t TTreeCache::FillBuffer()
 {
    if (fNbranches <= 0) return kFALSE;
+   R__TRACE_ZONE("TTreeCache::FillBuffer", "io");
    TTree *tree = ((TBranch*)fBranches->UncheckedAt(0))->GetTree();
    Long64_t entry = tree->GetReadEntry();
    Long64_t fEntryCurrentMax = 0;
 
+   // In prefetching mode the next cluster is read while the current one is
+   // processed: the two buffers share the memory allowed for the cache.
+   Int_t bufferSizeMin = fEnablePrefetching ? fBufferSizeMin / 2 : fBufferSizeMin;
+
    if (fEnablePrefetching) { // Prefetching mode
       if (fIsLearning) { // Learning mode
          if (fEntryNext >= 0 && entry >= fEntryNext) {
@@ -728,6 +749,11 @@ Bool_t TTreeCache::FillBuffer()
          chainOffset = chain->GetTreeOffset()[t];
       }
    }
+   // Otherwise, if it has a TEntryList, only the baskets containing entries of
+   // the list of the current tree are read.
+   TEntryList *enlist = elist ? 0 : fTree->GetEntryList();
+   if (enlist && enlist->GetLists()) enlist = enlist->GetCurrentList();
+   if (enlist && enlist->GetLists()) enlist = 0;
 
    //clear cache buffer
    Int_t fNtotCurrentBuf = 0;
@@ -781,17 +807,18 @@ Bool_t TTreeCache::FillBuffer()
                Long64_t pos = b->GetBasketSeek(j);
                Int_t len = lbaskets[j];
                if (pos <= 0 || len <= 0) continue;
-               if (len > fBufferSizeMin) {
+               if (len > bufferSizeMin) {
                   // Do not cache a basket if it is bigger than the cache size!
                   continue;
                }
                //important: do not try to read fEntryNext, otherwise you jump to the next autoflush
                if (entries[j] >= fEntryNext) break; // break out of the for each branch loop.
                if (entries[j] < minEntry && (j<nb-1 && entries[j+1] <= minEntry)) continue;
-               if (elist) {
+               if (elist || enlist) {
                   Long64_t emax = fEntryMax;
                   if (j<nb-1) emax = entries[j+1]-1;
-                  if (!elist->ContainsRange(entries[j]+chainOffset,emax+chainOffset)) continue;
+                  if (elist && !elist->ContainsRange(entries[j]+chainOffset,emax+chainOffset)) continue;
+                  if (enlist && !enlist->ContainsRange(entries[j],emax)) continue;
                }
                if (pass==2 && !firstBasketSeen) {
                   // Okay, this has already been requested in the first pass.
@@ -800,27 +827,27 @@ Bool_t TTreeCache::FillBuffer()
                }
                fNReadPref++;
 
-               if ( (fNtotCurrentBuf+len) > fBufferSizeMin ) {
+               if ( (fNtotCurrentBuf+len) > bufferSizeMin ) {
                   // Humm ... we are going to go over the requested size.
                   if (clusterIterations > 0) {
                      // We already have a full cluster and now we would go over the requested
                      // size, let's stop caching (and make sure we start next time from the
                      // end of the previous cluster).
                      if (gDebug > 5) {
-                        Info("FillBuffer","Breaking early because %d is greater than %d at cluster iteration %d will restart at %lld",(fNtotCurrentBuf+len), fBufferSizeMin, clusterIterations,minEntry);
+                        Info("FillBuffer","Breaking early because %d is greater than %d at cluster iteration %d will restart at %lld",(fNtotCurrentBuf+len), bufferSizeMin, clusterIterations,minEntry);
                      }
                      fEntryNext = minEntry;
                      break;
                   } else {
                      if (pass == 1) {
-                        if ( (fNtotCurrentBuf+len) > 4*fBufferSizeMin ) {
+                        if ( (fNtotCurrentBuf+len) > 4*bufferSizeMin ) {
                            // Okay, so we have not even made one pass and we already have
                            // accumulated request for more than twice the memory size ...
                            // So stop for now, and will restart at the same point, hoping
                            // that the basket will still be in memory and not asked again ..
                            fEntryNext = maxReadEntry;
                            if (gDebug > 5) {
-                              Info("FillBuffer","Breaking early because %d is greater than 2*%d at cluster iteration %d pass %d will restart at %lld",(fNtotCurrentBuf+len), fBufferSizeMin, clusterIterations,pass,fEntryNext);
+                              Info("FillBuffer","Breaking early because %d is greater than 2*%d at cluster iteration %d pass %d will restart at %lld",(fNtotCurrentBuf+len), bufferSizeMin, clusterIterations,pass,fEntryNext);
                            }
                            break;
                         }
@@ -828,10 +855,10 @@ Bool_t TTreeCache::FillBuffer()
                         // We have made one pass through the branches and thus already
                         // requested one basket per branch, let's stop prefetching
                         // now.
-                        if ( (fNtotCurrentBuf+len) > 2*fBufferSizeMin ) {
+                        if ( (fNtotCurrentBuf+len) > 2*bufferSizeMin ) {
                            fEntryNext = maxReadEntry;
                            if (gDebug > 5) {
-                              Info("FillBuffer","Breaking early because %d is greater than 2*%d at cluster iteration %d pass %d will restart at %lld",(fNtotCurrentBuf+len), fBufferSizeMin, clusterIterations,pass,fEntryNext);
+                              Info("FillBuffer","Breaking early because %d is greater than 2*%d at cluster iteration %d pass %d will restart at %lld",(fNtotCurrentBuf+len), bufferSizeMin, clusterIterations,pass,fEntryNext);
                            }
                            break;
                         }
@@ -855,10 +882,10 @@ Bool_t TTreeCache::FillBuffer()
                if ( ( j < (nb-1) ) && entries[j+1] > maxReadEntry ) {
                   maxReadEntry = entries[j+1];
                }
-               if (fNtotCurrentBuf > 4*fBufferSizeMin) {
+               if (fNtotCurrentBuf > 4*bufferSizeMin) {
                   // Humm something wrong happened.
                   Warning("FillBuffer","There is more data in this cluster (starting at entry %lld to %lld, current=%lld) than usual ... with %d %.3f%% of the branches we already have %d bytes (instead of %d)",
-                          fEntryCurrent,fEntryNext, entries[j], i, (100.0*i) / ((float)fNbranches), fNtotCurrentBuf,fBufferSizeMin);
+                          fEntryCurrent,fEntryNext, entries[j], i, (100.0*i) / ((float)fNbranches), fNtotCurrentBuf,bufferSizeMin);
 
                }
                if (pass==1) {
@@ -881,13 +908,13 @@ Bool_t TTreeCache::FillBuffer()
       // Continue as long as we still make progress (prevNtot < fNtotCurrentBuf), that the next entry range to be looked at,
       // which start at 'minEntry', is not past the end of the requested range (minEntry < fEntryMax)
       // and we guess that we not going to go over the requested amount of memory by asking for another set
-      // of entries (fBufferSizeMin > ((Long64_t)fNtotCurrentBuf*(clusterIterations+1))/clusterIterations).
+      // of entries (bufferSizeMin > ((Long64_t)fNtotCurrentBuf*(clusterIterations+1))/clusterIterations).
       // fNtotCurrentBuf / clusterIterations is the average size we are accumulated so far at each loop.
       // and thus (fNtotCurrentBuf / clusterIterations) * (clusterIterations+1) is a good guess at what the next total size
       // would be if we run the loop one more time.   fNtotCurrentBuf and clusterIterations are Int_t but can sometimes
       // be 'large' (i.e. 30Mb * 300 intervals) and can overflow the numercial limit of Int_t (i.e. become
       // artificially negative).   To avoid this issue we promote fNtotCurrentBuf to a long long (64 bits rather than 32 bits)
-      if (!((fBufferSizeMin > ((Long64_t)fNtotCurrentBuf*(clusterIterations+1))/clusterIterations) && (prevNtot < fNtotCurrentBuf) && (minEntry < fEntryMax)))
+      if (!((bufferSizeMin > ((Long64_t)fNtotCurrentBuf*(clusterIterations+1))/clusterIterations) && (prevNtot < fNtotCurrentBuf) && (minEntry < fEntryMax)))
          break;
 
       //for the reverse reading case
@@ -39,6 +39,19 @@ The default parameters are the same of the prev version, i.e. 20%
 of the TTreeCache cache size. To change it use
 TTreeCache::SetUnzipBufferSize(Long64_t bufferSize)
 where bufferSize must be passed in bytes.
+
+## Task-based unzipping
+
+If ROOT was built with implicit multi-threading and it is enabled
+(see ROOT::EnableImplicitMT) when the cache is created, the dedicated
+unzip threads are not started. Instead, every time the cache content
+has been transferred, tasks are submitted to the same pool used by the
+rest of ROOT; each task claims baskets one by one and unzips them. A
+basket is claimed and handed over to the reading thread through an
+atomic status flag, so no lock is taken to pick up a ready basket.
+The number of baskets unzipped concurrently can be changed with
+TTreeCacheUnzip::SetUnzipConcurrency(Int_t nbaskets); by default it is
+the size of the thread pool.
 */
 
 #include "TTreeCacheUnzip.h"
@@ -46,6 +59,7 @@ where bufferSize must be passed in bytes.
 #include "TBranch.h"
 #include "TFile.h"
 #include "TEventList.h"
+#include "TEntryList.h"
 #include "TMutex.h"
 #include "TVirtualMutex.h"
 #include "TThread.h"
@@ -54,6 +68,15 @@ where bufferSize must be passed in bytes.
 #include "Bytes.h"
 
 #include "TEnv.h"
+#include "TROOT.h"
+#include "ROOT/TBufferPool.hxx"
+
+#ifdef R__USE_IMT
+#include "tbb/task_group.h"
+#include "tbb/task_scheduler_init.h"
+#endif
+
+#include <thread>
 
 #define THREADCNT 2
 extern "C" void R__unzip(Int_t *nin, UChar_t *bufin, Int_t *lout, char *bufout, Int_t *nout);
@@ -66,6 +89,17 @@ TTreeCacheUnzip::EParUnzipMode TTreeCacheUnzip::fgParallel = TTreeCacheUnzip::kD
 // Hence there is no good reason to limit it too much
 Double_t TTreeCacheUnzip::fgRelBuffSize = .5;
 
+// Maximum number of baskets unzipped concurrently by the tasks, 0 means
+// as many as the threads in the pool
+Int_t TTreeCacheUnzip::fgUnzipConcurrency = 0;
+
+#ifdef R__USE_IMT
+class TTreeCacheUnzipTasks {
+public:
+   tbb::task_group fGroup;
+};
+#endif
+
 ClassImp(TTreeCacheUnzip)
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -77,6 +111,10 @@ TTreeCacheUnzip::TTreeCacheUnzip() : TTreeCache(),
    fCycle(0),
    fLastReadPos(0),
    fBlocksToGo(0),
+   fUnzipTasks(0),
+   fNActiveTasks(0),
+   fUnzipNext(0),
+   fUnzipCancel(kFALSE),
    fUnzipLen(0),
    fUnzipChunks(0),
    fUnzipStatus(0),
@@ -103,6 +141,10 @@ TTreeCacheUnzip::TTreeCacheUnzip(TTree *tree, Int_t buffersize) : TTreeCache(tre
    fCycle(0),
    fLastReadPos(0),
    fBlocksToGo(0),
+   fUnzipTasks(0),
+   fNActiveTasks(0),
+   fUnzipNext(0),
+   fUnzipCancel(kFALSE),
    fUnzipLen(0),
    fUnzipChunks(0),
    fUnzipStatus(0),
@@ -149,7 +191,15 @@ void TTreeCacheUnzip::Init()
 
       for (Int_t i = 0; i < 10; i++) fUnzipThread[i] = 0;
 
-      StartThreadUnzip(THREADCNT);
+#ifdef R__USE_IMT
+      if (ROOT::IsImplicitMTEnabled()) {
+         if(gDebug > 0)
+            Info("TTreeCacheUnzip", "Using tasks for the parallel unzipping");
+         fUnzipTasks = new TTreeCacheUnzipTasks;
+      }
+#endif
+      if (!fUnzipTasks)
+         StartThreadUnzip(THREADCNT);
 
    }
    else {
@@ -174,6 +224,10 @@ TTreeCacheUnzip::~TTreeCacheUnzip()
    if (IsActiveThread())
       StopThreadUnzip();
 
+#ifdef R__USE_IMT
+   delete fUnzipTasks;
+#endif
+
    delete [] fUnzipLen;
 
    delete fUnzipStartCondition;
@@ -195,6 +249,7 @@ TTreeCacheUnzip::~TTreeCacheUnzip()
 
 Int_t TTreeCacheUnzip::AddBranch(TBranch *b, Bool_t subbranches /*= kFALSE*/)
 {
+   StopUnzipTasks();
    R__LOCKGUARD(fMutexList);
 
    return TTreeCache::AddBranch(b, subbranches);
@@ -209,6 +264,7 @@ Int_t TTreeCacheUnzip::AddBranch(TBranch *b, Bool_t subbranches /*= kFALSE*/)
 
 Int_t TTreeCacheUnzip::AddBranch(const char *branch, Bool_t subbranches /*= kFALSE*/)
 {
+   StopUnzipTasks();
    R__LOCKGUARD(fMutexList);
 
    return TTreeCache::AddBranch(branch, subbranches);
@@ -219,6 +275,9 @@ Int_t TTreeCacheUnzip::AddBranch(const char *branch, Bool_t subbranches /*= kFAL
 Bool_t TTreeCacheUnzip::FillBuffer()
 {
    if (fNbranches <= 0) return kFALSE;
+
+   // The unzip tasks must not look at the cache while it is being refilled
+   StopUnzipTasks();
    {
       // Fill the cache buffer with the branches in the cache.
       R__LOCKGUARD(fMutexList);
@@ -256,6 +315,11 @@ Bool_t TTreeCacheUnzip::FillBuffer()
             chainOffset = chain->GetTreeOffset()[t];
          }
       }
+      // Otherwise, if it has a TEntryList, only the baskets containing entries of
+      // the list of the current tree are read.
+      TEntryList *enlist = elist ? 0 : fTree->GetEntryList();
+      if (enlist && enlist->GetLists()) enlist = enlist->GetCurrentList();
+      if (enlist && enlist->GetLists()) enlist = 0;
 
       //clear cache buffer
       TFileCacheRead::Prefetch(0,0);
@@ -282,10 +346,11 @@ Bool_t TTreeCacheUnzip::FillBuffer()
             //important: do not try to read fEntryNext, otherwise you jump to the next autoflush
             if (entries[j] >= fEntryNext) continue;
             if (entries[j] < entry && (j<nb-1 && entries[j+1] <= entry)) continue;
-            if (elist) {
+            if (elist || enlist) {
                Long64_t emax = fEntryMax;
                if (j<nb-1) emax = entries[j+1]-1;
-               if (!elist->ContainsRange(entries[j]+chainOffset,emax+chainOffset)) continue;
+               if (elist && !elist->ContainsRange(entries[j]+chainOffset,emax+chainOffset)) continue;
+               if (enlist && !enlist->ContainsRange(entries[j],emax)) continue;
             }
             fNReadPref++;
 
@@ -313,6 +378,7 @@ Bool_t TTreeCacheUnzip::FillBuffer()
 
 Int_t TTreeCacheUnzip::SetBufferSize(Int_t buffersize)
 {
+   StopUnzipTasks();
    R__LOCKGUARD(fMutexList);
 
    Int_t res = TTreeCache::SetBufferSize(buffersize);
@@ -331,6 +397,7 @@ Int_t TTreeCacheUnzip::SetBufferSize(Int_t buffersize)
 
 void TTreeCacheUnzip::SetEntryRange(Long64_t emin, Long64_t emax)
 {
+   StopUnzipTasks();
    R__LOCKGUARD(fMutexList);
 
    TTreeCache::SetEntryRange(emin, emax);
@@ -342,6 +409,7 @@ void TTreeCacheUnzip::SetEntryRange(Long64_t emin, Long64_t emax)
 
 void TTreeCacheUnzip::StopLearningPhase()
 {
+   StopUnzipTasks();
    R__LOCKGUARD(fMutexList);
 
    TTreeCache::StopLearningPhase();
@@ -353,6 +421,7 @@ void TTreeCacheUnzip::StopLearningPhase()
 
 void TTreeCacheUnzip::UpdateBranches(TTree *tree)
 {
+   StopUnzipTasks();
    R__LOCKGUARD(fMutexList);
 
    TTreeCache::UpdateBranches(tree);
@@ -453,6 +522,33 @@ Int_t TTreeCacheUnzip::SetParallelUnzip(TTreeCacheUnzip::EParUnzipMode option)
    return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Static function that returns the maximum number of baskets unzipped
+/// concurrently by the unzip tasks. If no limit was set with
+/// SetUnzipConcurrency, this is the number of threads in the pool.
+
+Int_t TTreeCacheUnzip::GetUnzipConcurrency()
+{
+   if (fgUnzipConcurrency > 0)
+      return fgUnzipConcurrency;
+#ifdef R__USE_IMT
+   return tbb::task_scheduler_init::default_num_threads();
+#else
+   return THREADCNT;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Static function that sets the maximum number of baskets unzipped
+/// concurrently when the task-based unzipping is used (i.e. when implicit
+/// multi-threading is enabled). A value <= 0 restores the default,
+/// the number of threads in the pool.
+
+void TTreeCacheUnzip::SetUnzipConcurrency(Int_t nbaskets)
+{
+   fgUnzipConcurrency = nbaskets > 0 ? nbaskets : 0;
+}
+
 class TTreeCacheUnzipData {
 public:
    TTreeCacheUnzip *fInstance;
@@ -584,6 +680,137 @@ void* TTreeCacheUnzip::UnzipLoop(void *arg)
    return (void *)0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Submit unzip tasks to the implicit multi-threading pool, until there are
+/// GetUnzipConcurrency() of them running. Nothing is done if there are no
+/// blocks left to be claimed or if the unzipped blocks already fill the
+/// allowed memory.
+/// Called only by the thread reading the tree.
+
+void TTreeCacheUnzip::LaunchUnzipTasks()
+{
+#ifdef R__USE_IMT
+   if (!fUnzipTasks || !fNseek || fIsLearning || !fIsTransferred || fUnzipCancel)
+      return;
+   if (fUnzipNext >= fNseek || fTotalUnzipBytes >= fUnzipBufferSize)
+      return;
+
+   const Int_t maxTasks = GetUnzipConcurrency();
+   while (fNActiveTasks < maxTasks) {
+      fNActiveTasks++;
+      fUnzipTasks->fGroup.run([this]() { UnzipTask(); fNActiveTasks--; });
+   }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Tell the unzip tasks to stop claiming new blocks and wait for all of
+/// them to finish. After this the unzip arrays can be safely modified.
+
+void TTreeCacheUnzip::StopUnzipTasks()
+{
+#ifdef R__USE_IMT
+   if (!fUnzipTasks)
+      return;
+   fUnzipCancel = kTRUE;
+   fUnzipTasks->fGroup.wait();
+   fUnzipCancel = kFALSE;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Body of an unzip task: claim the blocks not yet unzipped nor claimed,
+/// in the order of the requests, and unzip them until there is nothing
+/// left, the allowed memory is full or the tasks are cancelled.
+
+void TTreeCacheUnzip::UnzipTask()
+{
+   Int_t locbuffsz = 16384;
+   char *locbuff = ROOT::Internal::TBufferPool::Acquire(locbuffsz);
+
+   while (!fUnzipCancel && fTotalUnzipBytes < fUnzipBufferSize) {
+      Int_t idx = fUnzipNext++;
+      if (idx >= fNseek) break;
+
+      // Small blocks are cheaper to unzip in the reading thread
+      if (fSeekLen[idx] <= 256) continue;
+
+      Byte_t expected = 0;
+      if (!fUnzipStatus[idx].compare_exchange_strong(expected, 1))
+         continue; // Already taken by the reading thread
+
+      UnzipBlock(idx, locbuffsz, locbuff);
+   }
+
+   ROOT::Internal::TBufferPool::Release(locbuff, locbuffsz);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Unzip the block idx, previously claimed by an unzip task, and publish
+/// it to the reading thread. The block is always marked as done at the end,
+/// with a null chunk if it could not be unzipped: in this case the reading
+/// thread will unzip it by itself.
+/// Returns 0 in normal conditions or -1 if error
+
+Int_t TTreeCacheUnzip::UnzipBlock(Int_t idx, Int_t &locbuffsz, char *&locbuff)
+{
+   const Int_t hlen=128;
+   Int_t objlen=0, keylen=0;
+   Int_t nbytes=0;
+
+   Long64_t rdoffs = fSeek[idx];
+   Int_t rdlen = fSeekLen[idx];
+
+   fUnzipChunks[idx] = 0;
+   fUnzipLen[idx] = 0;
+
+   // Prepare a tmp buf of adequate size
+   if(locbuffsz < rdlen) {
+      ROOT::Internal::TBufferPool::Release(locbuff, locbuffsz);
+      locbuffsz = rdlen;
+      locbuff = ROOT::Internal::TBufferPool::Acquire(locbuffsz);
+   } else if(locbuffsz > rdlen*3) {
+      ROOT::Internal::TBufferPool::Release(locbuff, locbuffsz);
+      locbuffsz = rdlen*2;
+      locbuff = ROOT::Internal::TBufferPool::Acquire(locbuffsz);
+   }
+
+   Int_t loc = -1;
+   if (ReadBufferExt(locbuff, rdoffs, rdlen, loc) <= 0) {
+      if (gDebug > 0)
+         Info("UnzipBlock", "Block %d not done. rdoffs=%lld rdlen=%d", idx, rdoffs, rdlen);
+      fUnzipStatus[idx].store(2, std::memory_order_release);
+      return -1;
+   }
+
+   GetRecordHeader(locbuff, hlen, nbytes, objlen, keylen);
+
+   // If the single unzipped chunk is really too big, leave it to the reading thread
+   Int_t len = (objlen > nbytes-keylen)? keylen+objlen : nbytes;
+   if (len > 4*fUnzipBufferSize) {
+      if (gDebug > 0)
+         Info("UnzipBlock", "Block %d is too big, skipping.", idx);
+      fUnzipStatus[idx].store(2, std::memory_order_release);
+      return 0;
+   }
+
+   char *ptr = 0;
+   Int_t loclen = UnzipBuffer(&ptr, locbuff);
+
+   if ((loclen > 0) && (loclen == objlen+keylen)) {
+      fUnzipChunks[idx] = ptr;
+      fUnzipLen[idx] = loclen;
+      fTotalUnzipBytes += loclen;
+      fNUnzip++;
+   } else {
+      delete [] ptr;
+   }
+
+   // Hand over the block to the reading thread
+   fUnzipStatus[idx].store(2, std::memory_order_release);
+   return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //                                                                            //
 // From now on we have the methods concerning the unzipping part of the cache //
@@ -642,11 +869,14 @@ Int_t TTreeCacheUnzip::GetRecordHeader(char *buf, Int_t maxbytes, Int_t &nbytes,
 
 void TTreeCacheUnzip::ResetCache()
 {
+   // The unzip tasks must be done before wiping the chunks
+   StopUnzipTasks();
+
    {
    R__LOCKGUARD(fMutexList);
 
    if (gDebug > 0)
-      Info("ResetCache", "Thread: %ld -- Resetting the cache. fNseek:%d fNSeekMax:%d fTotalUnzipBytes:%lld", TThread::SelfId(), fNseek, fNseekMax, fTotalUnzipBytes);
+      Info("ResetCache", "Thread: %ld -- Resetting the cache. fNseek:%d fNSeekMax:%d fTotalUnzipBytes:%lld", TThread::SelfId(), fNseek, fNseekMax, fTotalUnzipBytes.load());
 
    // Reset all the lists and wipe all the chunks
    fCycle++;
@@ -666,8 +896,8 @@ void TTreeCacheUnzip::ResetCache()
       if (gDebug > 0)
          Info("ResetCache", "Changing fNseekMax from:%d to:%d", fNseekMax, fNseek);
 
-      Byte_t *aUnzipStatus = new Byte_t[fNseek];
-      memset(aUnzipStatus, 0, fNseek*sizeof(Byte_t));
+      std::atomic<Byte_t> *aUnzipStatus = new std::atomic<Byte_t>[fNseek];
+      for (Int_t i = 0; i < fNseek; i++) aUnzipStatus[i] = 0;
 
       Int_t *aUnzipLen = new Int_t[fNseek];
       memset(aUnzipLen, 0, fNseek*sizeof(Int_t));
@@ -689,6 +919,7 @@ void TTreeCacheUnzip::ResetCache()
    fLastReadPos = 0;
    fTotalUnzipBytes = 0;
    fBlocksToGo = fNseek;
+   fUnzipNext = 0;
    }
 
    SendUnzipStartSignal(kTRUE);
@@ -710,7 +941,57 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
    Int_t res = 0;
    Int_t loc = -1;
 
-   {
+   if (fUnzipTasks) {
+      // Task-based unzipping: the blocks are handed over through their
+      // status, no lock is needed to pick them up.
+      if (!fIsLearning && fIsTransferred) {
+         // The requests list grew after the last reset
+         if (fNseekMax < fNseek) ResetCache();
+
+         loc = (Int_t)TMath::BinarySearch(fNseek,fSeekSort,pos);
+         if ((loc >= 0) && (loc < fNseek) && (pos == fSeekSort[loc])) {
+            Int_t seekidx = fSeekIndex[loc];
+            fLastReadPos = seekidx;
+
+            // Claim the block if no task did it yet, so that it is not unzipped twice
+            Byte_t status = 0;
+            if (!fUnzipStatus[seekidx].compare_exchange_strong(status, 2)) {
+               Bool_t stalled = kFALSE;
+               while (status == 1) {
+                  // A task is unzipping it right now
+                  stalled = kTRUE;
+                  std::this_thread::yield();
+                  status = fUnzipStatus[seekidx].load(std::memory_order_acquire);
+               }
+
+               Int_t uzlen = fUnzipLen[seekidx];
+               if (fUnzipChunks[seekidx] && (uzlen > 0)) {
+                  if(!(*buf)) {
+                     *buf = fUnzipChunks[seekidx];
+                     *free = kTRUE;
+                  }
+                  else {
+                     memcpy(*buf, fUnzipChunks[seekidx], uzlen);
+                     ROOT::Internal::TBufferPool::Release(fUnzipChunks[seekidx], uzlen);
+                     *free = kFALSE;
+                  }
+                  fUnzipChunks[seekidx] = 0;
+                  fUnzipLen[seekidx] = 0;
+                  fTotalUnzipBytes -= uzlen;
+
+                  if (stalled) fNStalls++;
+                  else fNFound++;
+
+                  // Some memory was freed, keep the tasks busy
+                  LaunchUnzipTasks();
+                  return uzlen;
+               }
+            }
+         } else {
+            loc = -1;
+         }
+      }
+   } else {
       R__LOCKGUARD(fMutexList);
 
       // We go straight to TTreeCache/TfileCacheRead, in order to get the info we need
@@ -731,8 +1012,8 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
             if (gDebug > 0)
                Info("GetUnzipBuffer", "Changing fNseekMax from:%d to:%d", fNseekMax, fNseek);
 
-            Byte_t *aUnzipStatus = new Byte_t[fNseek];
-            memset(aUnzipStatus, 0, fNseek*sizeof(Byte_t));
+            std::atomic<Byte_t> *aUnzipStatus = new std::atomic<Byte_t>[fNseek];
+            for (Int_t i = 0; i < fNseek; i++) aUnzipStatus[i] = 0;
 
             Int_t *aUnzipLen = new Int_t[fNseek];
             memset(aUnzipLen, 0, fNseek*sizeof(Int_t));
@@ -741,7 +1022,7 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
             memset(aUnzipChunks, 0, fNseek*sizeof(char *));
 
             for (Int_t i = 0; i < fNseekMax; i++) {
-               aUnzipStatus[i] = fUnzipStatus[i];
+               aUnzipStatus[i] = fUnzipStatus[i].load();
                aUnzipLen[i] = fUnzipLen[i];
                aUnzipChunks[i] = fUnzipChunks[i];
             }
@@ -912,6 +1193,9 @@ Int_t TTreeCacheUnzip::GetUnzipBuffer(char **buf, Long64_t pos, Int_t len, Bool_
       fNMissed++;
    }
 
+   // The cache content is now transferred, the tasks can start
+   LaunchUnzipTasks();
+
    return res;
 
 }
@@ -964,7 +1248,8 @@ Int_t TTreeCacheUnzip::UnzipBuffer(char **dest, char *src)
          return uzlen;
       }
       Int_t l = keylen+objlen;
-      *dest = new char[l];
+      // From the buffer pool, as TBasket adopts it as such (see TBasket::ReadBasketBuffersUnzip)
+      *dest = ROOT::Internal::TBufferPool::Acquire(l);
       alloc = kTRUE;
    }
    // Must unzip the buffer
@@ -1109,7 +1394,7 @@ Int_t TTreeCacheUnzip::UnzipCache(Int_t &startindex, Int_t &locbuffsz, char *&lo
    if (idxtounzip < 0) {
       if (gDebug > 0)
          Info("UnzipCache", "Nothing to do... startindex:%d fTotalUnzipBytes:%lld fUnzipBufferSize:%lld fNseek:%d",
-              startindex, fTotalUnzipBytes, fUnzipBufferSize, fNseek );
+              startindex, fTotalUnzipBytes.load(), fUnzipBufferSize, fNseek );
       return 1;
    }
 
@@ -1246,7 +1531,7 @@ void  TTreeCacheUnzip::Print(Option_t* option) const {
 
    printf("******TreeCacheUnzip statistics for file: %s ******\n",fFile->GetName());
    printf("Max allowed mem for pending buffers: %lld\n", fUnzipBufferSize);
-   printf("Number of blocks unzipped by threads: %d\n", fNUnzip);
+   printf("Number of blocks unzipped by threads: %d\n", fNUnzip.load());
    printf("Number of hits: %d\n", fNFound);
    printf("Number of stalls: %d\n", fNStalls);
    printf("Number of misses: %d\n", fNMissed);
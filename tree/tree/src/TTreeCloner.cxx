@@ -21,6 +21,7 @@ Class implementing or helping  the various TTree cloning method
 #include "TBranchElement.h"
 #include "TStreamerInfo.h"
 #include "TBranchRef.h"
+#include "TCompressionDictionaries.h"
 #include "TError.h"
 #include "TProcessID.h"
 #include "TMath.h"
@@ -34,9 +35,14 @@ Class implementing or helping  the various TTree cloning method
 #include "TLeafO.h"
 #include "TLeafC.h"
 #include "TFileCacheRead.h"
+#include "TROOT.h"
 
 #include <algorithm>
 
+#ifdef R__USE_IMT
+#include "tbb/task_group.h"
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 Bool_t TTreeCloner::CompareSeek::operator()(UInt_t i1, UInt_t i2)
@@ -111,6 +117,7 @@ TTreeCloner::TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t option
    fFromBranches( from ? from->GetListOfLeaves()->GetEntries()+1 : 0),
    fToBranches( to ? to->GetListOfLeaves()->GetEntries()+1 : 0),
    fMaxBaskets(CollectBranches()),
+   fNBaskets(0),
    fBasketBranchNum(new UInt_t[fMaxBaskets]),
    fBasketNum(new UInt_t[fMaxBaskets]),
    fBasketSeek(new Long64_t[fMaxBaskets]),
@@ -119,6 +126,9 @@ TTreeCloner::TTreeCloner(TTree *from, TTree *to, Option_t *method, UInt_t option
    fPidOffset(0),
    fCloneMethod(TTreeCloner::kDefault),
    fToStartEntries(0),
+   fFirstEntry(0),
+   fLastEntry(-1),
+   fRangeStarted(kFALSE),
    fCacheSize(0LL),
    fFileCache(nullptr),
    fPrevCache(nullptr)
@@ -200,6 +210,7 @@ Bool_t TTreeCloner::Exec()
    ImportClusterRanges();
    CopyStreamerInfos();
    CopyProcessIds();
+   CopyCompressionDictionaries();
    CloseOutWriteBaskets();
    CollectBaskets();
    SortBaskets();
@@ -210,6 +221,88 @@ Bool_t TTreeCloner::Exec()
    return kTRUE;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the entries [first, last) of the input tree are made of
+/// whole baskets in all the copied branches, none of them still in memory,
+/// i.e. if they can be copied by ExecRange.
+
+Bool_t TTreeCloner::IsRangeAligned(Long64_t first, Long64_t last) const
+{
+   if (first < 0 || last <= first) {
+      return kFALSE;
+   }
+   for(Int_t i=0; i<fFromBranches.GetEntries(); ++i) {
+      TBranch *from = (TBranch*)fFromBranches.UncheckedAt(i);
+      Int_t nbaskets = from->GetWriteBasket();
+      if (nbaskets == 0) {
+         // Only a branch without data (e.g. a non-terminal 'object' branch) can have no basket on file.
+         TBasket *basket = from->GetListOfBaskets()->GetEntries() ? from->GetBasket(0) : 0;
+         if (basket && basket->GetNevBuf()) {
+            return kFALSE;
+         }
+         continue;
+      }
+      // fBasketEntry[nbaskets] is the first entry of the write basket.
+      const Long64_t *entries = from->GetBasketEntry();
+      if (last > entries[nbaskets]
+          || !std::binary_search(entries, entries+nbaskets+1, first)
+          || !std::binary_search(entries, entries+nbaskets+1, last)) {
+         return kFALSE;
+      }
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Copy the baskets of the entries [first, last) of the input tree at the
+/// end of the output tree, without unzipping or unstreaming them.
+///
+/// The range must be aligned on the basket boundaries (see IsRangeAligned),
+/// which is the case of the clusters of the trees written with the default
+/// AutoFlush. ExecRange can be called several times, with entries appended
+/// in between with TTree::Fill, to copy the clusters of a selection in
+/// which all the entries are selected.  The number of entries of the output
+/// tree is updated.  Returns false, and copies nothing, if the cloner is
+/// invalid or if the range is not aligned.
+
+Bool_t TTreeCloner::ExecRange(Long64_t first, Long64_t last)
+{
+   if (!IsValid() || !IsRangeAligned(first, last)) {
+      return kFALSE;
+   }
+   if (!fRangeStarted) {
+      CopyStreamerInfos();
+      CopyProcessIds();
+      CopyCompressionDictionaries();
+      fRangeStarted = kTRUE;
+   }
+   Long64_t toEntries = fToTree->GetEntries();
+   fToStartEntries = toEntries - first;
+   fFirstEntry = first;
+   fLastEntry = last;
+
+   CloseOutWriteBaskets();
+   CollectBaskets();
+   SortBaskets();
+   WriteBaskets();
+
+   for(Int_t i=0; i<fToBranches.GetEntries(); ++i) {
+      TBranch *from = (TBranch*)fFromBranches.UncheckedAt( i );
+      TBranch *to   = (TBranch*)fToBranches.UncheckedAt( i );
+      if (from->GetWriteBasket()) {
+         to->AddLastBasket(toEntries + last - first);
+      } else if (from->GetEntries()) {
+         to->SetEntries(to->GetEntries() + last - first);
+      }
+   }
+   fToTree->SetEntries(toEntries + last - first);
+
+   fToStartEntries = fToTree->GetEntries();
+   fFirstEntry = 0;
+   fLastEntry = -1;
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// TTreeCloner destructor
 
@@ -463,17 +556,24 @@ void TTreeCloner::CollectBaskets()
 {
    UInt_t len = fFromBranches.GetEntries();
 
-   for(UInt_t i=0,bi=0; i<len; ++i) {
+   UInt_t bi = 0;
+   for(UInt_t i=0; i<len; ++i) {
       TBranch *from = (TBranch*)fFromBranches.UncheckedAt(i);
-      for(Int_t b=0; b<from->GetWriteBasket(); ++b,++bi) {
+      for(Int_t b=0; b<from->GetWriteBasket(); ++b) {
+         if (fLastEntry >= 0 && (from->GetBasketEntry()[b] < fFirstEntry || from->GetBasketEntry()[b] >= fLastEntry)) {
+            // Not in the range copied by ExecRange.
+            continue;
+         }
          fBasketBranchNum[bi] = i;
          fBasketNum[bi] = b;
          fBasketSeek[bi] = from->GetBasketSeek(b);
          //fprintf(stderr,"For %s %d %lld\n",from->GetName(),bi,fBasketSeek[bi]);
          fBasketEntry[bi] = from->GetBasketEntry()[b];
          fBasketIndex[bi] = bi;
+         ++bi;
       }
    }
+   fNBaskets = bi;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -518,6 +618,17 @@ void TTreeCloner::CopyStreamerInfos()
    delete l;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Make sure that the Zstd dictionaries of the small baskets, copied
+/// without being decompressed, are present in the output file
+
+void TTreeCloner::CopyCompressionDictionaries()
+{
+   TFile *fromFile = fFromTree->GetDirectory()->GetFile();
+   TFile *toFile = fToTree->GetDirectory()->GetFile();
+   TCompressionDictionaries::Copy(fromFile, toFile);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Transfer the basket from the input file to the output file
 
@@ -677,14 +788,14 @@ void TTreeCloner::SortBaskets()
          // nothing to do, it is already sorted.
          break;
       case kSortBasketsByEntry: {
-         for(UInt_t i = 0; i < fMaxBaskets; ++i) { fBasketIndex[i] = i; }
-         std::sort(fBasketIndex, fBasketIndex+fMaxBaskets, CompareEntry( this) );
+         for(UInt_t i = 0; i < fNBaskets; ++i) { fBasketIndex[i] = i; }
+         std::sort(fBasketIndex, fBasketIndex+fNBaskets, CompareEntry( this) );
          break;
       }
       case kSortBasketsByOffset:
       default: {
-         for(UInt_t i = 0; i < fMaxBaskets; ++i) { fBasketIndex[i] = i; }
-         std::sort(fBasketIndex, fBasketIndex+fMaxBaskets, CompareSeek( this) );
+         for(UInt_t i = 0; i < fNBaskets; ++i) { fBasketIndex[i] = i; }
+         std::sort(fBasketIndex, fBasketIndex+fNBaskets, CompareSeek( this) );
          break;
       }
    }
@@ -701,7 +812,7 @@ UInt_t TTreeCloner::FillCache(UInt_t from)
    // Reset the cache
    fFileCache->Prefetch(0, 0);
    Long64_t size = 0;
-   for (UInt_t j = from; j < fMaxBaskets; ++j) {
+   for (UInt_t j = from; j < fNBaskets; ++j) {
       TBranch *frombr = (TBranch *) fFromBranches.UncheckedAt(fBasketBranchNum[fBasketIndex[j]]);
 
 
@@ -716,20 +827,73 @@ UInt_t TTreeCloner::FillCache(UInt_t from)
          fFileCache->Prefetch(pos,len);
       }
    }
-   return fMaxBaskets;
+   return fNBaskets;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Transfer the basket from the input file to the output file
+///
+/// With the option kRecompress, the baskets whose input and output branches
+/// have different compression settings are uncompressed and compressed again
+/// with the output settings, without being unstreamed: the baskets (and hence
+/// the clusters) are unchanged. The baskets are then loaded by groups which
+/// are recompressed concurrently (when implicit multi-threading is enabled)
+/// and written in order.
 
 void TTreeCloner::WriteBaskets()
 {
-   TBasket *basket = new TBasket();
-   for(UInt_t j = 0, notCached = 0; j<fMaxBaskets; ++j) {
+   const UInt_t kMaxPending = (fOptions & kRecompress) ? 64 : 1;
+
+   std::vector<TBasket*> baskets;   // Loaded baskets, waiting to be written.
+   std::vector<UInt_t> pending;     // Their position j in fBasketIndex.
+   std::vector<Bool_t> recompress;  // Whether they must be recompressed.
+   for (UInt_t p = 0; p < kMaxPending; ++p) baskets.push_back(new TBasket());
+
+   auto flushPending = [&]() {
+      UInt_t npending = pending.size();
+#ifdef R__USE_IMT
+      if (ROOT::IsImplicitMTEnabled() && npending > 1) {
+         tbb::task_group g;
+         for (UInt_t p = 0; p < npending; ++p) {
+            if (!recompress[p]) continue;
+            TBasket *basket = baskets[p];
+            TBranch *to = (TBranch*)fToBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[pending[p]] ] );
+            Int_t cxlevel = to->GetCompressionLevel();
+            Int_t cxAlgorithm = to->GetCompressionAlgorithm();
+            g.run([basket, cxlevel, cxAlgorithm]() {
+               // In case of failure the basket is copied as is.
+               basket->RecompressBuffers(cxlevel, cxAlgorithm);
+            });
+         }
+         g.wait();
+      } else
+#endif
+      {
+         for (UInt_t p = 0; p < npending; ++p) {
+            if (!recompress[p]) continue;
+            TBranch *to = (TBranch*)fToBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[pending[p]] ] );
+            baskets[p]->RecompressBuffers(to->GetCompressionLevel(), to->GetCompressionAlgorithm());
+         }
+      }
+      for (UInt_t p = 0; p < npending; ++p) {
+         UInt_t j = pending[p];
+         TBranch *from = (TBranch*)fFromBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
+         TBranch *to   = (TBranch*)fToBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
+         Int_t index = fBasketNum[ fBasketIndex[j] ];
+
+         TBasket *basket = baskets[p];
+         basket->IncrementPidOffset(fPidOffset);
+         basket->CopyTo(to->GetFile(0));
+         to->AddBasket(*basket,kTRUE,fToStartEntries + from->GetBasketEntry()[index]);
+      }
+      pending.clear();
+      recompress.clear();
+   };
+
+   for(UInt_t j = 0, notCached = 0; j<fNBaskets; ++j) {
       TBranch *from = (TBranch*)fFromBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
       TBranch *to   = (TBranch*)fToBranches.UncheckedAt( fBasketBranchNum[ fBasketIndex[j] ] );
 
-      TFile *tofile = to->GetFile(0);
       TFile *fromfile = from->GetFile(0);
 
       Int_t index = fBasketNum[ fBasketIndex[j] ];
@@ -739,16 +903,20 @@ void TTreeCloner::WriteBaskets()
          if (fFileCache && j >= notCached) {
             notCached = FillCache(notCached);
          }
+         TBasket *basket = baskets[pending.size()];
          if (from->GetBasketBytes()[index] == 0) {
             from->GetBasketBytes()[index] = basket->ReadBasketBytes(pos, fromfile);
          }
          Int_t len = from->GetBasketBytes()[index];
 
-         basket->LoadBasketBuffers(pos,len,fromfile,fFromTree);
-         basket->IncrementPidOffset(fPidOffset);
-         basket->CopyTo(tofile);
-         to->AddBasket(*basket,kTRUE,fToStartEntries + from->GetBasketEntry()[index]);
+         Bool_t loaded = basket->LoadBasketBuffers(pos,len,fromfile,fFromTree) == 0;
+         pending.push_back(j);
+         recompress.push_back(loaded && (fOptions & kRecompress)
+                              && fromfile->GetVersion() > 30401 // Old files could store compressed baskets as uncompressed.
+                              && from->GetCompressionSettings() != to->GetCompressionSettings());
+         if (pending.size() == kMaxPending) flushPending();
       } else {
+         flushPending();
          TBasket *frombasket = from->GetBasket( index );
          if (frombasket && frombasket->GetNevBuf()>0) {
             TBasket *tobasket = (TBasket*)frombasket->Clone();
@@ -758,5 +926,6 @@ void TTreeCloner::WriteBaskets()
          }
       }
    }
-   delete basket;
+   flushPending();
+   for (auto basket : baskets) delete basket;
 }
@@ -38,6 +38,10 @@ Implement TTree for a SQL backend
 
 ClassImp(TTreeSQL)
 
+namespace {
+   const Int_t kMaxInsertLength = 500000; // Maximum length of the INSERT queries of several rows
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Constructor with an explicit TSQLServer
 
@@ -46,7 +50,9 @@ TTreeSQL::TTreeSQL(TSQLServer *server, TString DB, const TString& table) :
    fTable(table.Data()),
    fResult(0), fRow(0),
    fServer(server),
-   fBranchChecked(kFALSE)
+   fBranchChecked(kFALSE),
+   fNPendingRows(0),
+   fBatchSize(100)
 {
    fCurrentEntry = -1;
    fQuery = TString("Select * from " + fTable);
@@ -61,6 +67,14 @@ TTreeSQL::TTreeSQL(TSQLServer *server, TString DB, const TString& table) :
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor, the rows still kept by Fill are sent to the database.
+
+TTreeSQL::~TTreeSQL()
+{
+   FlushRows();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Not implemented yet
 
@@ -559,6 +573,11 @@ void TTreeSQL::Init()
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Copy the information from the user object to the TTree
+///
+/// The values of the row are kept and sent to the database together with
+/// those of the next rows, in one INSERT query of up to GetBatchSize() rows
+/// (see SetBatchSize). Return 1 if the row is kept, the number of rows sent
+/// to the database if the query was executed and -1 in case of error.
 
 Int_t TTreeSQL::Fill()
 {
@@ -597,15 +616,50 @@ Int_t TTreeSQL::Fill()
    if (fInsertQuery[fInsertQuery.Length()-1]!='(') {
       fInsertQuery.Remove(fInsertQuery.Length()-1);
       fInsertQuery += ")";
-      TSQLResult *res = fServer?fServer->Query(fInsertQuery):0;
 
-      if (res) {
-         return res->GetRowCount();
-      }
+      // Keep the values of the row, "(v1,v2,...)", for the next INSERT query.
+      Ssiz_t start = fInsertQuery.Index(" VALUES (") + 8;
+      if (fNPendingRows > 0) fPendingRows += ",";
+      fPendingRows.Append(fInsertQuery.Data() + start, fInsertQuery.Length() - start);
+      ++fNPendingRows;
+
+      if (fNPendingRows < fBatchSize && fPendingRows.Length() < kMaxInsertLength) return 1;
+      return FlushRows();
    }
    return -1;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Send to the database the rows kept by Fill, with one INSERT query.
+/// Return the number of rows sent, -1 in case of error.
+
+Int_t TTreeSQL::FlushRows()
+{
+   if (fNPendingRows == 0 || fServer == 0) return 0;
+
+   TString query = "INSERT INTO " + fTable + " VALUES " + fPendingRows;
+   Int_t nrows = fNPendingRows;
+   fPendingRows.Clear();
+   fNPendingRows = 0;
+
+   if (!fServer->Exec(query.Data())) {
+      Error("FlushRows", "Failed to insert %d rows into %s", nrows, fTable.Data());
+      return -1;
+   }
+   return nrows;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the maximum number of rows kept by Fill before they are sent to
+/// the database (100 by default). 1 sends each row when it is filled.
+
+void TTreeSQL::SetBatchSize(Int_t rows)
+{
+   if (rows < 1) rows = 1;
+   fBatchSize = rows;
+   if (fNPendingRows >= fBatchSize) FlushRows();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Return a vector of columns index corresponding to the
 /// current SQL table and the branch given as argument
@@ -680,6 +734,7 @@ Long64_t  TTreeSQL::GetEntries() const
    if (!CheckTable(fTable.Data())) return 0;
 
    TTreeSQL* thisvar = const_cast<TTreeSQL*>(this);
+   thisvar->FlushRows();
 
    // What if the user already started to call GetEntry
    // What about the initial value of fEntries is it really 0?
@@ -738,6 +793,12 @@ Long64_t TTreeSQL::PrepEntry(Long64_t entry)
    if (entry < 0 || entry >= fEntries || fServer==0) return 0;
    fReadEntry = entry;
 
+   // The rows still kept by Fill must be in the table to be read.
+   if (fNPendingRows > 0) {
+      FlushRows();
+      delete fResult; fResult = 0;
+   }
+
    if(entry == fCurrentEntry) return entry;
 
    if(entry < fCurrentEntry || fResult==0){
@@ -785,6 +846,7 @@ Long64_t TTreeSQL::PrepEntry(Long64_t entry)
 void TTreeSQL::Refresh()
 {
    // Note : something to be done?
+   FlushRows();
    GetEntries(); // Re-load the number of entries
    fCurrentEntry = -1;
    delete fResult; fResult = 0;
@@ -0,0 +1,611 @@
+// @(#)root/treeplayer:$Id$
+// Author: ROOT I/O team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TDataFrame
+#define ROOT_TDataFrame
+
+#ifndef ROOT_TH1
+#include "TH1.h"
+#endif
+
+#ifndef ROOT_TTree
+#include "TTree.h"
+#endif
+
+#ifndef ROOT_TTreeReader
+#include "TTreeReader.h"
+#endif
+
+#ifndef ROOT_TTreeReaderValue
+#include "TTreeReaderValue.h"
+#endif
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+class TFile;
+
+namespace ROOT {
+
+namespace Experimental {
+class TDataFrame;
+class TDataFrameInterface;
+}
+
+namespace Internal {
+namespace TDF {
+
+/// Compile time sequence of indices, used to expand the tuples of column values.
+template <int... S>
+struct TStaticSeq {};
+template <int N, int... S>
+struct TGenStaticSeq : TGenStaticSeq<N - 1, N - 1, S...> {};
+template <int... S>
+struct TGenStaticSeq<0, S...> { typedef TStaticSeq<S...> Type_t; };
+
+/// Types of the arguments (without references and qualifiers) and of the
+/// result of a function, a function object or a lambda.
+template <typename F>
+struct TFunctionTraits : TFunctionTraits<decltype(&F::operator())> {};
+template <typename C, typename R, typename... A>
+struct TFunctionTraits<R (C::*)(A...) const> {
+   typedef std::tuple<typename std::decay<A>::type...> Args_t;
+   typedef typename std::decay<R>::type Ret_t;
+};
+template <typename C, typename R, typename... A>
+struct TFunctionTraits<R (C::*)(A...)> {
+   typedef std::tuple<typename std::decay<A>::type...> Args_t;
+   typedef typename std::decay<R>::type Ret_t;
+};
+template <typename R, typename... A>
+struct TFunctionTraits<R (*)(A...)> {
+   typedef std::tuple<typename std::decay<A>::type...> Args_t;
+   typedef typename std::decay<R>::type Ret_t;
+};
+
+class TLoopManager;
+
+////////////////////////////////////////////////////////////////////////////////
+/// Interface of the filters of the computation graph. A filter checks its
+/// condition only if the previous filters of its branch of the graph pass.
+class TFilterBase {
+public:
+   virtual ~TFilterBase() {}
+   virtual bool CheckFilters(unsigned slot, Long64_t entry) = 0;
+   virtual void InitSlot(TTreeReader &reader, unsigned slot) = 0;
+   virtual void ResetSlot(unsigned slot) = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Interface of the columns defined with TDataFrameInterface::Define, whose
+/// value is computed once per entry when it is first needed.
+class TCustomColumnBase {
+protected:
+   std::string fName; ///< Name of the column
+public:
+   TCustomColumnBase(std::string_view name) : fName(name) {}
+   virtual ~TCustomColumnBase() {}
+   const std::string &GetName() const { return fName; }
+   virtual const std::type_info &GetTypeId() const = 0;
+   virtual void *GetValuePtr(unsigned slot, Long64_t entry) = 0;
+   virtual void InitSlot(TTreeReader &reader, unsigned slot) = 0;
+   virtual void ResetSlot(unsigned slot) = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Interface of the actions (histograms, counters, ...) filled by the event loop.
+class TActionBase {
+public:
+   virtual ~TActionBase() {}
+   virtual void Run(unsigned slot, Long64_t entry) = 0;
+   virtual void InitSlot(TTreeReader &reader, unsigned slot) = 0;
+   virtual void ResetSlot(unsigned slot) = 0;
+   virtual void Finalize() = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// The root of the computation graph: it owns the filters, the defined
+/// columns and the actions, and runs the event loop when the result of one
+/// of the actions is accessed. With implicit multi-threading enabled the
+/// event loop is run by a ROOT::TTreeProcessor, each cluster of the tree
+/// being processed in a "slot" with its own readers and partial results.
+class TLoopManager {
+private:
+   TTree *fTree;                                               ///< Tree (or chain) to process
+   std::unique_ptr<TFile> fFile;                               ///< File of fTree, if opened by the data frame
+   std::vector<std::string> fDefaultColumns;                   ///< Columns used when an action does not give any
+   std::vector<std::shared_ptr<TFilterBase>> fFilters;         ///< All the filters of the graph
+   std::vector<std::shared_ptr<TCustomColumnBase>> fCustomColumns; ///< All the defined columns
+   std::vector<std::shared_ptr<TActionBase>> fActions;         ///< Actions booked for the next event loop
+   std::vector<std::shared_ptr<bool>> fReadiness;              ///< Flags telling the results of fActions are ready
+   unsigned fNSlots;                                           ///< Number of processing slots
+
+   void InitSlot(TTreeReader &reader, unsigned slot);
+   void ResetSlot(unsigned slot);
+
+   TLoopManager(const TLoopManager &);            // Not implemented
+   TLoopManager &operator=(const TLoopManager &); // Not implemented
+
+public:
+   TLoopManager(TTree *tree, TFile *file, const std::vector<std::string> &defaultColumns);
+   ~TLoopManager();
+
+   void Book(const std::shared_ptr<TActionBase> &action, const std::shared_ptr<bool> &ready);
+   void Book(const std::shared_ptr<TFilterBase> &filter) { fFilters.push_back(filter); }
+   void Book(const std::shared_ptr<TCustomColumnBase> &column);
+   TCustomColumnBase *GetCustomColumn(const std::string &name) const;
+   unsigned GetNSlots() const { return fNSlots; }
+   TTree *GetTree() const { return fTree; }
+   std::vector<std::string> PickColumns(unsigned n, const std::vector<std::string> &columns) const;
+   void Run(bool sequential = false);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Value of a column for the current entry of a slot: either read from the
+/// tree with a TTreeReaderValue, or computed by a defined column.
+template <typename T>
+class TColumnValue {
+private:
+   std::unique_ptr<TTreeReaderValue<T>> fReaderValue; ///< Reader of the branch, if the column is a branch
+   TCustomColumnBase *fCustomColumn;                   ///< Defined column, if the column is one
+   unsigned fSlot;                                     ///< Slot this value belongs to
+
+public:
+   TColumnValue() : fCustomColumn(nullptr), fSlot(0) {}
+
+   void Init(TTreeReader &reader, const TLoopManager &manager, const std::string &name, unsigned slot)
+   {
+      fSlot = slot;
+      fCustomColumn = manager.GetCustomColumn(name);
+      if (fCustomColumn) {
+         if (fCustomColumn->GetTypeId() != typeid(T))
+            throw std::runtime_error("TDataFrame: the column \"" + name + "\" is read with a type different from its definition");
+      } else {
+         fReaderValue.reset(new TTreeReaderValue<T>(reader, name.c_str()));
+      }
+   }
+
+   void Reset()
+   {
+      fReaderValue.reset();
+      fCustomColumn = nullptr;
+   }
+
+   T &Get(Long64_t entry)
+   {
+      if (fCustomColumn) return *static_cast<T *>(fCustomColumn->GetValuePtr(fSlot, entry));
+      return **fReaderValue;
+   }
+};
+
+/// Initialize the column values of a slot.
+template <typename... T, int... S>
+void InitColumnValues(std::tuple<TColumnValue<T>...> &values, TTreeReader &reader, const TLoopManager &manager,
+                      const std::vector<std::string> &columns, unsigned slot, TStaticSeq<S...>)
+{
+   int expander[] = {(std::get<S>(values).Init(reader, manager, columns[S], slot), 0)..., 0};
+   (void)expander;
+}
+
+/// Release the readers of the column values of a slot.
+template <typename... T, int... S>
+void ResetColumnValues(std::tuple<TColumnValue<T>...> &values, TStaticSeq<S...>)
+{
+   int expander[] = {(std::get<S>(values).Reset(), 0)..., 0};
+   (void)expander;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// A filter calling a function (returning a boolean) of some columns.
+template <typename F, typename Args = typename TFunctionTraits<F>::Args_t>
+class TFilter;
+
+template <typename F, typename... Args>
+class TFilter<F, std::tuple<Args...>> final : public TFilterBase {
+private:
+   typedef typename TGenStaticSeq<sizeof...(Args)>::Type_t Seq_t;
+
+   F fFilter;                                             ///< Condition
+   std::vector<std::string> fColumns;                     ///< Columns passed to fFilter
+   const TLoopManager &fManager;                          ///< Owner of the graph
+   std::shared_ptr<TFilterBase> fPrev;                    ///< Previous filter, null if none
+   std::vector<std::tuple<TColumnValue<Args>...>> fValues; ///< Column values per slot
+   std::vector<Long64_t> fLastCheckedEntry;               ///< Entry checked last, per slot
+   std::vector<char> fLastResult;                         ///< Result for fLastCheckedEntry, per slot
+
+   template <int... S>
+   bool CheckFilter(unsigned slot, Long64_t entry, TStaticSeq<S...>)
+   {
+      return fFilter(std::get<S>(fValues[slot]).Get(entry)...);
+   }
+
+public:
+   TFilter(F filter, const std::vector<std::string> &columns, const TLoopManager &manager,
+           const std::shared_ptr<TFilterBase> &prev)
+      : fFilter(filter), fColumns(columns), fManager(manager), fPrev(prev), fValues(manager.GetNSlots()),
+        fLastCheckedEntry(manager.GetNSlots(), -1), fLastResult(manager.GetNSlots(), 0) {}
+
+   bool CheckFilters(unsigned slot, Long64_t entry)
+   {
+      if (entry != fLastCheckedEntry[slot]) {
+         fLastResult[slot] = (!fPrev || fPrev->CheckFilters(slot, entry)) && CheckFilter(slot, entry, Seq_t());
+         fLastCheckedEntry[slot] = entry;
+      }
+      return fLastResult[slot];
+   }
+
+   void InitSlot(TTreeReader &reader, unsigned slot)
+   {
+      InitColumnValues(fValues[slot], reader, fManager, fColumns, slot, Seq_t());
+      fLastCheckedEntry[slot] = -1;
+   }
+
+   void ResetSlot(unsigned slot) { ResetColumnValues(fValues[slot], Seq_t()); }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// A column computed by a function of other columns. Its type, the type
+/// returned by the function, must be default constructible and assignable.
+template <typename F, typename Args = typename TFunctionTraits<F>::Args_t>
+class TCustomColumn;
+
+template <typename F, typename... Args>
+class TCustomColumn<F, std::tuple<Args...>> final : public TCustomColumnBase {
+private:
+   typedef typename TGenStaticSeq<sizeof...(Args)>::Type_t Seq_t;
+   typedef typename TFunctionTraits<F>::Ret_t Ret_t;
+
+   F fExpression;                                         ///< Function computing the value
+   std::vector<std::string> fColumns;                     ///< Columns passed to fExpression
+   const TLoopManager &fManager;                          ///< Owner of the graph
+   std::vector<std::tuple<TColumnValue<Args>...>> fValues; ///< Column values per slot
+   std::vector<std::unique_ptr<Ret_t>> fLastResult;       ///< Value for fLastCheckedEntry, per slot
+   std::vector<Long64_t> fLastCheckedEntry;               ///< Entry computed last, per slot
+
+   template <int... S>
+   void Compute(unsigned slot, Long64_t entry, TStaticSeq<S...>)
+   {
+      *fLastResult[slot] = fExpression(std::get<S>(fValues[slot]).Get(entry)...);
+   }
+
+public:
+   TCustomColumn(std::string_view name, F expression, const std::vector<std::string> &columns,
+                 const TLoopManager &manager)
+      : TCustomColumnBase(name), fExpression(expression), fColumns(columns), fManager(manager),
+        fValues(manager.GetNSlots()), fLastResult(manager.GetNSlots()), fLastCheckedEntry(manager.GetNSlots(), -1) {}
+
+   const std::type_info &GetTypeId() const { return typeid(Ret_t); }
+
+   void *GetValuePtr(unsigned slot, Long64_t entry)
+   {
+      if (entry != fLastCheckedEntry[slot]) {
+         Compute(slot, entry, Seq_t());
+         fLastCheckedEntry[slot] = entry;
+      }
+      return fLastResult[slot].get();
+   }
+
+   void InitSlot(TTreeReader &reader, unsigned slot)
+   {
+      InitColumnValues(fValues[slot], reader, fManager, fColumns, slot, Seq_t());
+      if (!fLastResult[slot]) fLastResult[slot].reset(new Ret_t());
+      fLastCheckedEntry[slot] = -1;
+   }
+
+   void ResetSlot(unsigned slot) { ResetColumnValues(fValues[slot], Seq_t()); }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// An action passing the values of some columns, for the entries accepted by
+/// the previous filter, to the Exec method of Helper. Helper also provides
+/// InitSlot(slot) and Finalize().
+template <typename Helper, typename Args>
+class TAction;
+
+template <typename Helper, typename... Args>
+class TAction<Helper, std::tuple<Args...>> final : public TActionBase {
+private:
+   typedef typename TGenStaticSeq<sizeof...(Args)>::Type_t Seq_t;
+
+   Helper fHelper;                                        ///< Fills the result
+   std::vector<std::string> fColumns;                     ///< Columns passed to fHelper
+   const TLoopManager &fManager;                          ///< Owner of the graph
+   std::shared_ptr<TFilterBase> fPrev;                    ///< Previous filter, null if none
+   std::vector<std::tuple<TColumnValue<Args>...>> fValues; ///< Column values per slot
+
+   template <int... S>
+   void Exec(unsigned slot, Long64_t entry, TStaticSeq<S...>)
+   {
+      (void)entry; // unused when there are no columns
+      fHelper.Exec(slot, std::get<S>(fValues[slot]).Get(entry)...);
+   }
+
+public:
+   TAction(Helper &&helper, const std::vector<std::string> &columns, const TLoopManager &manager,
+           const std::shared_ptr<TFilterBase> &prev)
+      : fHelper(std::move(helper)), fColumns(columns), fManager(manager), fPrev(prev), fValues(manager.GetNSlots()) {}
+
+   void Run(unsigned slot, Long64_t entry)
+   {
+      if (!fPrev || fPrev->CheckFilters(slot, entry)) Exec(slot, entry, Seq_t());
+   }
+
+   void InitSlot(TTreeReader &reader, unsigned slot)
+   {
+      InitColumnValues(fValues[slot], reader, fManager, fColumns, slot, Seq_t());
+      fHelper.InitSlot(slot);
+   }
+
+   void ResetSlot(unsigned slot) { ResetColumnValues(fValues[slot], Seq_t()); }
+
+   void Finalize() { fHelper.Finalize(); }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Count the entries, per slot, and sum the counts at the end.
+class TCountHelper {
+private:
+   std::shared_ptr<ULong64_t> fResult;
+   std::vector<ULong64_t> fCounts;
+
+public:
+   TCountHelper(const std::shared_ptr<ULong64_t> &result, unsigned nSlots) : fResult(result), fCounts(nSlots, 0) {}
+   void InitSlot(unsigned) {}
+   void Exec(unsigned slot) { ++fCounts[slot]; }
+   void Finalize();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill a histogram, one copy per slot merged at the end. If the model has
+/// no axis limits (xmin >= xmax), the values are kept per slot and the limits
+/// are computed from all of them at the end.
+class TFillHelper {
+private:
+   std::shared_ptr<TH1> fResult;
+   std::vector<std::unique_ptr<TH1>> fPartials; ///< Histograms filled by each slot
+   std::vector<std::vector<Double_t>> fValues;  ///< Values of each slot, without axis limits
+   std::vector<std::vector<Double_t>> fWeights; ///< Weights of fValues
+   bool fBuffered;                              ///< True if the model has no axis limits
+
+   void Fill(unsigned slot, Double_t v, Double_t w)
+   {
+      if (fBuffered) {
+         fValues[slot].push_back(v);
+         fWeights[slot].push_back(w);
+      } else {
+         fPartials[slot]->Fill(v, w);
+      }
+   }
+
+public:
+   TFillHelper(const std::shared_ptr<TH1> &result, unsigned nSlots);
+   void InitSlot(unsigned slot);
+   template <typename T>
+   void Exec(unsigned slot, const T &v) { Fill(slot, v, 1.); }
+   template <typename T, typename W>
+   void Exec(unsigned slot, const T &v, const W &w) { Fill(slot, v, w); }
+   void Finalize();
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the values of some columns in a new tree. The event loop of a
+/// snapshot is always sequential.
+template <typename... T>
+class TSnapshotHelper {
+private:
+   typedef typename TGenStaticSeq<sizeof...(T)>::Type_t Seq_t;
+
+   TTree *fTree;                        ///< Output tree
+   std::unique_ptr<std::tuple<T...>> fBuffer; ///< Values of the current entry, a branch per element
+
+   template <int... S>
+   void CreateBranches(const std::vector<std::string> &columns, TStaticSeq<S...>)
+   {
+      int expander[] = {(fTree->Branch(columns[S].c_str(), &std::get<S>(*fBuffer)), 0)..., 0};
+      (void)expander;
+   }
+
+public:
+   TSnapshotHelper(TTree *tree, const std::vector<std::string> &columns) : fTree(tree), fBuffer(new std::tuple<T...>())
+   {
+      CreateBranches(columns, Seq_t());
+   }
+   void InitSlot(unsigned) {}
+   void Exec(unsigned, const T &... values)
+   {
+      *fBuffer = std::make_tuple(values...);
+      fTree->Fill();
+   }
+   void Finalize() {}
+};
+
+/// Recreate the output file of a snapshot and create its tree.
+TFile *OpenSnapshotFile(std::string_view filename, std::string_view treename, TTree *&tree);
+/// Write the tree of a snapshot, close and delete its file.
+void CloseSnapshotFile(TFile *file, TTree *tree);
+
+} // End of namespace TDF
+} // End of namespace Internal
+
+namespace Experimental {
+
+////////////////////////////////////////////////////////////////////////////////
+/// The result of an action of a TDataFrame. Accessing it runs the event loop
+/// of the data frame if needed, together with all the actions booked so far.
+template <typename T>
+class TResultProxy {
+private:
+   std::shared_ptr<T> fObj;                               ///< The result, filled by the event loop
+   std::shared_ptr<bool> fReady;                          ///< True once the event loop ran
+   std::shared_ptr<ROOT::Internal::TDF::TLoopManager> fManager; ///< Runs the event loop
+
+public:
+   TResultProxy(const std::shared_ptr<T> &obj, const std::shared_ptr<bool> &ready,
+                const std::shared_ptr<ROOT::Internal::TDF::TLoopManager> &manager)
+      : fObj(obj), fReady(ready), fManager(manager) {}
+
+   /// Return a pointer to the result, running the event loop if needed.
+   T *GetPtr()
+   {
+      if (!*fReady) fManager->Run();
+      return fObj.get();
+   }
+   T &operator*() { return *GetPtr(); }
+   T *operator->() { return GetPtr(); }
+   bool IsReady() const { return *fReady; }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// The interface of the nodes of the computation graph of a TDataFrame: the
+/// data frame itself and its filters. The transformations (Filter, Define)
+/// return a new node; the actions (Count, Histo1D) book a result which is
+/// filled the first time a result is accessed, in a single event loop for
+/// all the actions booked so far. Snapshot runs the event loop immediately.
+///
+/// The columns are given by name; the types of the columns are the types of
+/// the arguments of the functions, or the template arguments of the actions.
+/// When no column name is given the default columns of the data frame are
+/// used.
+class TDataFrameInterface {
+protected:
+   std::shared_ptr<ROOT::Internal::TDF::TLoopManager> fManager; ///< Root of the graph
+   std::shared_ptr<ROOT::Internal::TDF::TFilterBase> fFilter;   ///< Node of this interface, null for the data frame
+
+   TDataFrameInterface(const std::shared_ptr<ROOT::Internal::TDF::TLoopManager> &manager,
+                       const std::shared_ptr<ROOT::Internal::TDF::TFilterBase> &filter)
+      : fManager(manager), fFilter(filter) {}
+
+   template <typename Args, typename Helper>
+   void BookAction(Helper &&helper, const std::vector<std::string> &columns, const std::shared_ptr<bool> &ready)
+   {
+      typedef ROOT::Internal::TDF::TAction<Helper, Args> Action_t;
+      fManager->Book(std::make_shared<Action_t>(std::move(helper), columns, *fManager, fFilter), ready);
+   }
+
+   TResultProxy<TH1D> BookHisto(const TH1D &model,
+                                std::function<void(const std::shared_ptr<TH1> &, const std::shared_ptr<bool> &)> book);
+
+public:
+   ////////////////////////////////////////////////////////////////////////////
+   /// Select the entries for which f returns true. f takes the values of the
+   /// columns as arguments.
+   template <typename F>
+   TDataFrameInterface Filter(F f, const std::vector<std::string> &columns = {})
+   {
+      typedef typename ROOT::Internal::TDF::TFunctionTraits<F>::Args_t Args_t;
+      auto names = fManager->PickColumns(std::tuple_size<Args_t>::value, columns);
+      std::shared_ptr<ROOT::Internal::TDF::TFilterBase> filter =
+         std::make_shared<ROOT::Internal::TDF::TFilter<F>>(f, names, *fManager, fFilter);
+      fManager->Book(filter);
+      return TDataFrameInterface(fManager, filter);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   /// Define a new column, computed by expression from the values of columns.
+   /// The column can be used by all the nodes of the graph.
+   template <typename F>
+   TDataFrameInterface Define(std::string_view name, F expression, const std::vector<std::string> &columns = {})
+   {
+      typedef typename ROOT::Internal::TDF::TFunctionTraits<F>::Args_t Args_t;
+      auto names = fManager->PickColumns(std::tuple_size<Args_t>::value, columns);
+      fManager->Book(std::make_shared<ROOT::Internal::TDF::TCustomColumn<F>>(name, expression, names, *fManager));
+      return *this;
+   }
+
+   TResultProxy<ULong64_t> Count();
+
+   ////////////////////////////////////////////////////////////////////////////
+   /// Fill a histogram with the values of column, of type T. The histogram
+   /// has 128 bins, its limits are computed from the values.
+   template <typename T = Double_t>
+   TResultProxy<TH1D> Histo1D(std::string_view column = "")
+   {
+      return Histo1D<T>(TH1D("", "", 128, 0., 0.), column);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   /// Fill a copy of model with the values of column, of type T. If the axis
+   /// of model has no limits they are computed from the values.
+   template <typename T = Double_t>
+   TResultProxy<TH1D> Histo1D(const TH1D &model, std::string_view column = "")
+   {
+      std::vector<std::string> columns;
+      if (!column.empty()) columns.push_back(std::string(column));
+      columns = fManager->PickColumns(1, columns);
+      return BookHisto(model, [this, &columns](const std::shared_ptr<TH1> &h, const std::shared_ptr<bool> &ready) {
+         BookAction<std::tuple<T>>(ROOT::Internal::TDF::TFillHelper(h, fManager->GetNSlots()), columns, ready);
+      });
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   /// Fill a copy of model with the values of column, of type T, weighted by
+   /// the values of weight, of type W.
+   template <typename T = Double_t, typename W = Double_t>
+   TResultProxy<TH1D> Histo1D(const TH1D &model, std::string_view column, std::string_view weight)
+   {
+      std::vector<std::string> columns = {std::string(column), std::string(weight)};
+      return BookHisto(model, [this, &columns](const std::shared_ptr<TH1> &h, const std::shared_ptr<bool> &ready) {
+         BookAction<std::tuple<T, W>>(ROOT::Internal::TDF::TFillHelper(h, fManager->GetNSlots()), columns, ready);
+      });
+   }
+
+   template <typename... T>
+   TDataFrame Snapshot(std::string_view treename, std::string_view filename, const std::vector<std::string> &columns);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// A "data frame": a functional interface to the entries of a TTree or of a
+/// TChain, see TDataFrameInterface.
+/// ~~~{.cpp}
+/// ROOT::EnableImplicitMT();
+/// ROOT::Experimental::TDataFrame d("events", "file.root");
+/// auto sel = d.Filter([](int n) { return n > 2; }, {"ntracks"});
+/// auto hpt = sel.Histo1D<float>("pt");
+/// auto nsel = sel.Count();
+/// hpt->Draw(); // runs one (multi-threaded) event loop filling hpt and nsel
+/// ~~~
+class TDataFrame : public TDataFrameInterface {
+public:
+   TDataFrame(std::string_view treename, std::string_view filename, const std::vector<std::string> &defaultColumns = {});
+   TDataFrame(TTree &tree, const std::vector<std::string> &defaultColumns = {});
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the values of columns, of types T..., for the selected entries, in
+/// the tree treename of the file filename (which is recreated) and return a
+/// data frame reading them. The event loop runs immediately and sequentially,
+/// together with the actions booked so far.
+template <typename... T>
+TDataFrame TDataFrameInterface::Snapshot(std::string_view treename, std::string_view filename,
+                                         const std::vector<std::string> &columns)
+{
+   auto names = fManager->PickColumns(sizeof...(T), columns);
+   TTree *tree = nullptr;
+   TFile *file = ROOT::Internal::TDF::OpenSnapshotFile(filename, treename, tree);
+   auto ready = std::make_shared<bool>(false);
+   BookAction<std::tuple<T...>>(ROOT::Internal::TDF::TSnapshotHelper<T...>(tree, names), names, ready);
+   fManager->Run(true);
+   ROOT::Internal::TDF::CloseSnapshotFile(file, tree);
+   return TDataFrame(treename, filename, names);
+}
+
+} // End of namespace Experimental
+
+} // End of namespace ROOT
+
+#endif // defined TDataFrame
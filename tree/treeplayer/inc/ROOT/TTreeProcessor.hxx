@@ -38,56 +38,77 @@
 
 #include <string.h>
 #include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 
 
 /** \class TTreeView
-    \brief A helper class that encapsulates a file and a tree.
+    \brief A helper class that encapsulates the files and the trees to process.
 
-A helper class that encapsulates a TFile and a TTree, along with their names.
-It is used together with TTProcessor and ROOT::TThreadedObject, so that
-in the TTProcessor::Process method each thread can work on its own
-<TFile,TTree> pair.
+A helper class that holds the names of the files to process and the name of
+their tree, along with the TFile and TTree objects opened so far. It is used
+together with TTreeProcessor and ROOT::TThreadedObject, so that in the
+TTreeProcessor::Process method each thread can work on its own <TFile,TTree>
+pairs.
+
+The files are opened lazily, the first time a thread needs them, and are kept
+open afterwards: a thread processing several clusters of the same file opens
+it only once.
 
 A copy constructor is defined for TTreeView to work with ROOT::TThreadedObject.
 The latter makes a copy of a model object every time a new thread accesses
-the threaded object.
+the threaded object; the copy does not open any file.
 */
 
 namespace ROOT {
    namespace Internal {
       class TTreeView {
       private:
-         std::string_view fFileName;   ///< Name of the file
-         std::string_view fTreeName;   ///< Name of the tree
-         std::unique_ptr<TFile> fFile; ///<! File object of this view.
-         std::unique_ptr<TTree> fTree; ///<! Tree object of this view.
+         std::vector<std::string> fFileNames;        ///< Names of the files
+         std::string fTreeName;                      ///< Name of the tree, empty to take the first tree of each file
+         std::vector<std::unique_ptr<TFile>> fFiles; ///<! Files opened by this view, null if not opened yet
+         std::vector<std::unique_ptr<TTree>> fTrees; ///<! Trees of fFiles
 
          ////////////////////////////////////////////////////////////////////////////////
-         /// Initialize the file and the tree for this view, first looking for a tree in
-         /// the file if necessary. 
-         void Init()
+         /// Open the i-th file and get its tree, first looking for a tree in
+         /// the file if necessary.
+         void Init(unsigned i)
          {
-            fFile.reset(TFile::Open(fFileName.data()));
+            fFiles[i].reset(TFile::Open(fFileNames[i].c_str()));
+            if (!fFiles[i] || fFiles[i]->IsZombie()) {
+               ::Error("TTreeView::Init", "Cannot open file %s", fFileNames[i].c_str());
+               return;
+            }
 
             // If the tree name is empty, look for a tree in the file
-            if (fTreeName.empty()) {
-               TIter next(fFile->GetListOfKeys());
+            std::string treeName = fTreeName;
+            if (treeName.empty()) {
+               TIter next(fFiles[i]->GetListOfKeys());
                while (TKey *key = (TKey*)next()) {
                   const char *className = key->GetClassName();
                   if (strcmp(className, "TTree") == 0) {
-                     fTreeName = key->GetName();
+                     treeName = key->GetName();
                      break;
                   }
                }
-               if (fTreeName.empty())
-                  ::Error("TreeView constructor", "Cannot find any tree in file %s", fFileName.data());
+               if (treeName.empty())
+                  ::Error("TTreeView::Init", "Cannot find any tree in file %s", fFileNames[i].c_str());
             }
 
             // We cannot use here the template method (TFile::GetObject) because the header will finish
             // in the PCH and the specialization will be available. PyROOT will not be able to specialize
             // the method for types other that TTree.
-            TTree *tp = (TTree*)fFile->Get(fTreeName.data());
-            fTree.reset(tp);
+            TTree *tp = (TTree*)fFiles[i]->Get(treeName.c_str());
+            fTrees[i].reset(tp);
+         }
+
+         ////////////////////////////////////////////////////////////////////////////////
+         /// Get the tree of the i-th file, opening the file if needed.
+         TTree *GetTree(unsigned i)
+         {
+            if (!fFiles[i]) Init(i);
+            return fTrees[i].get();
          }
 
       public:
@@ -97,47 +118,65 @@ namespace ROOT {
          /// \param[in] treename Name of the tree to process. If not provided,
          ///                     the implementation will automatically search for a
          ///                     tree in the file.
-         TTreeView(std::string_view fn, std::string_view tn) : fFileName(fn), fTreeName(tn)
-         {
-            Init();
-         }
+         TTreeView(std::string_view fn, std::string_view tn)
+            : fFileNames(1, std::string(fn)), fTreeName(tn), fFiles(1), fTrees(1) {}
+
+         //////////////////////////////////////////////////////////////////////////
+         /// Constructor for several files.
+         /// \param[in] filenames Names of the files containing the tree to process.
+         /// \param[in] treename Name of the tree to process. If not provided,
+         ///                     the implementation will automatically search for a
+         ///                     tree in each file.
+         TTreeView(const std::vector<std::string> &fns, std::string_view tn)
+            : fFileNames(fns), fTreeName(tn), fFiles(fns.size()), fTrees(fns.size()) {}
 
          //////////////////////////////////////////////////////////////////////////
          /// Copy constructor.
          /// \param[in] Object to copy.
-         TTreeView(const TTreeView& view) : fFileName(view.fFileName), fTreeName(view.fTreeName)
+         TTreeView(const TTreeView& view)
+            : fFileNames(view.fFileNames), fTreeName(view.fTreeName),
+              fFiles(view.fFileNames.size()), fTrees(view.fFileNames.size()) {}
+
+         //////////////////////////////////////////////////////////////////////////
+         /// Get the number of files of this view.
+         unsigned GetNFiles() const
          {
-            Init();
+            return fFileNames.size();
          }
 
          //////////////////////////////////////////////////////////////////////////
-         /// Get the cluster iterator for the tree of this view, starting from
-         /// entry zero.
-         TTree::TClusterIterator GetClusterIterator()
+         /// Get the cluster iterator for the tree of the i-th file, starting from
+         /// the cluster containing firstEntry.
+         TTree::TClusterIterator GetClusterIterator(unsigned i, Long64_t firstEntry)
          {
-            return fTree->GetClusterIterator(0);
+            return GetTree(i)->GetClusterIterator(firstEntry);
          }
 
          //////////////////////////////////////////////////////////////////////////
-         /// Get a TTreeReader for the tree of this view.
-         std::unique_ptr<TTreeReader> GetTreeReader() const
+         /// Get a TTreeReader for the tree of the i-th file.
+         std::unique_ptr<TTreeReader> GetTreeReader(unsigned i)
          {
-            return std::unique_ptr<TTreeReader>(new TTreeReader(fTree.get()));
+            return std::unique_ptr<TTreeReader>(new TTreeReader(GetTree(i)));
          }
 
          //////////////////////////////////////////////////////////////////////////
-         /// Get the number of entries of the tree of this view.
-         Long64_t GetEntries() const
+         /// Get the number of entries of the tree of the i-th file, 0 if the
+         /// file or the tree cannot be opened.
+         Long64_t GetEntries(unsigned i)
          {
-            return fTree->GetEntries();
+            TTree *tree = GetTree(i);
+            return tree ? tree->GetEntries() : 0;
          }
       };
+
+      std::vector<std::string> GetTreeFileNames(TTree &tree);
+      std::string GetTreeName(TTree &tree);
    } // End of namespace Internal
 
 
    class TTreeProcessor {
    private:
-      ROOT::TThreadedObject<ROOT::Internal::TTreeView> treeView; ///<! Threaded object with <file,tree> per thread
+      ROOT::TThreadedObject<ROOT::Internal::TTreeView> treeView; ///<! Threaded object with <file,tree> pairs per thread
 
    public:
       ////////////////////////////////////////////////////////////////////////
@@ -147,11 +186,28 @@ namespace ROOT {
       ///                     the implementation will automatically search for a
       ///                     tree in the file.
       TTreeProcessor(std::string_view filename, std::string_view treename = "") : treeView(filename, treename) {}
- 
+
+      ////////////////////////////////////////////////////////////////////////
+      /// Constructor for a tree split in several files.
+      /// \param[in] filenames Names of the files containing the tree to process.
+      /// \param[in] treename Name of the tree to process. If not provided,
+      ///                     the implementation will automatically search for a
+      ///                     tree in each file.
+      TTreeProcessor(const std::vector<std::string> &filenames, std::string_view treename = "")
+         : treeView(filenames, treename) {}
+
+      ////////////////////////////////////////////////////////////////////////
+      /// Constructor processing the files of a TChain, or the file of a TTree.
+      /// The threads reopen the files: the tree must be entirely written.
+      /// \param[in] tree TChain or TTree to process.
+      TTreeProcessor(TTree &tree)
+         : treeView(ROOT::Internal::GetTreeFileNames(tree), ROOT::Internal::GetTreeName(tree)) {}
+
       void Process(std::function<void(TTreeReader&)> func);
- 
+      void Process(std::function<void(TTreeReader&)> func, Long64_t firstEntry, Long64_t lastEntry);
+
    };
-      
+
 } // End of namespace ROOT
 
 #endif // defined TTreeProcessor
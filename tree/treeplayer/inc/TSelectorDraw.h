@@ -29,6 +29,7 @@ class TTreeFormula;
 class TTreeFormulaManager;
 class TH1;
 class TEntryListArray;
+class TList;
 
 class TSelectorDraw : public TSelector {
 
@@ -67,6 +68,7 @@ protected:
    virtual void      ClearFormula();
    virtual Bool_t    CompileVariables(const char *varexp="", const char *selection="");
    virtual void      InitArrays(Int_t newsize);
+   virtual void      InitLoop();
 
 private:
    TSelectorDraw(const TSelectorDraw&);             // not implemented
@@ -77,6 +79,7 @@ public:
    virtual ~TSelectorDraw();
 
    virtual void      Begin(TTree *tree);
+   virtual Bool_t    CanFillConcurrently() const;
    virtual Int_t     GetAction() const {return fAction;}
    virtual Bool_t    GetCleanElist() const {return fCleanElist;}
    virtual Int_t     GetDimension() const {return fDimension;}
@@ -107,6 +110,8 @@ public:
    // See TSelectorDraw::GetVal
    virtual Double_t *GetV4() const   {return GetVal(3);}
    virtual Double_t *GetW() const    {return fW;}
+   virtual Bool_t    InitWorker(const TSelectorDraw &master, TTree *tree);
+   virtual void      MergeWorkers(TList *workers);
    virtual Bool_t    Notify();
    virtual Bool_t    Process(Long64_t /*entry*/) { return kFALSE; }
    virtual void      ProcessFill(Long64_t entry);
@@ -0,0 +1,109 @@
+// @(#)root/treeplayer:$Id$
+// Author: ROOT I/O team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+#ifndef ROOT_TTreeCompactIndex
+#define ROOT_TTreeCompactIndex
+
+
+//////////////////////////////////////////////////////////////////////////
+//                                                                      //
+// TTreeCompactIndex                                                    //
+//                                                                      //
+// A Tree Index with majorname and minorname, stored as delta-encoded   //
+// blocks which are read from the file only when needed.               //
+//                                                                      //
+//////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ROOT_TVirtualIndex
+#include "TVirtualIndex.h"
+#endif
+#ifndef ROOT_TUUID
+#include "TUUID.h"
+#endif
+
+#include <vector>
+
+class TArrayC;
+class TTreeFormula;
+
+class TTreeCompactIndex : public TVirtualIndex {
+
+protected:
+   TString        fMajorName;           // Index major name
+   TString        fMinorName;           // Index minor name
+   Long64_t       fN;                   // Number of entries
+   Int_t          fBlockSize;           // Number of entries per block
+   Int_t          fNBlocks;             // Number of blocks
+   Long64_t      *fBlockMajor;          //[fNBlocks] Major value of the first entry of each block
+   Long64_t      *fBlockMinor;          //[fNBlocks] Minor value of the first entry of each block
+   Long64_t       fLastMajor;           // Major value of the last entry of the index
+   Long64_t       fLastMinor;           // Minor value of the last entry of the index
+   TString        fBlockDir;            // Directory (relative to the file) holding the blocks
+   TString        fBlockKeyName;        // Prefix of the name of the keys holding the blocks
+   Short_t       *fBlockCycles;         //[fNBlocks] Cycle of the key holding each block
+   mutable std::vector<TArrayC*> fBlocks; //! Encoded blocks, 0 if not loaded yet
+   mutable Int_t  fCacheBlock;          //! Block currently decoded in the cache
+   mutable std::vector<Long64_t> fCacheMajor; //! Decoded major values of fCacheBlock
+   mutable std::vector<Long64_t> fCacheMinor; //! Decoded minor values of fCacheBlock
+   mutable std::vector<Long64_t> fCacheEntry; //! Decoded entry numbers of fCacheBlock
+   std::vector<Long64_t> fPendingMajor; //! Values appended with delaySort, not yet encoded
+   std::vector<Long64_t> fPendingMinor; //! Values appended with delaySort, not yet encoded
+   std::vector<Long64_t> fPendingEntry; //! Entries appended with delaySort, not yet encoded
+   TUUID          fBlockFileUUID;       //! UUID of the file the blocks are stored in
+   TTreeFormula  *fMajorFormula;        //! Pointer to major TreeFormula
+   TTreeFormula  *fMinorFormula;        //! Pointer to minor TreeFormula
+   TTreeFormula  *fMajorFormulaParent;  //! Pointer to major TreeFormula in Parent tree (if any)
+   TTreeFormula  *fMinorFormulaParent;  //! Pointer to minor TreeFormula in Parent tree (if any)
+
+   void           Build(Long64_t n, const Long64_t *major, const Long64_t *minor, const Long64_t *entry);
+   void           ClearBlocks();
+   Bool_t         DecodeAll(std::vector<Long64_t> &major, std::vector<Long64_t> &minor,
+                            std::vector<Long64_t> &entry, Long64_t offset) const;
+   Bool_t         DecodeBlock(Int_t block) const;
+   Int_t          FindBlock(Long64_t major, Long64_t minor) const;
+   Long64_t       FindValues(Long64_t major, Long64_t minor) const;
+   Bool_t         LoadBlock(Int_t block) const;
+   void           WriteBlocks(TDirectory *dir);
+
+private:
+   TTreeCompactIndex(const TTreeCompactIndex&);            // Not implemented.
+   TTreeCompactIndex &operator=(const TTreeCompactIndex&); // Not implemented.
+
+public:
+   TTreeCompactIndex();
+   TTreeCompactIndex(const TTree *T, const char *majorname, const char *minorname, Int_t blocksize = 4096);
+   virtual               ~TTreeCompactIndex();
+   virtual void           Append(const TVirtualIndex *,Bool_t delaySort = kFALSE);
+   Int_t                  GetBlockSize()    const {return fBlockSize;}
+   virtual Long64_t       GetEntryNumberFriend(const TTree *parent);
+   virtual Long64_t       GetEntryNumberWithIndex(Long64_t major, Long64_t minor) const;
+   virtual Long64_t       GetEntryNumberWithBestIndex(Long64_t major, Long64_t minor) const;
+   const char            *GetMajorName()    const {return fMajorName.Data();}
+   const char            *GetMinorName()    const {return fMinorName.Data();}
+   Long64_t               GetMinIndexValue()      const {return fNBlocks ? fBlockMajor[0] : 0;}
+   Long64_t               GetMinIndexValueMinor() const {return fNBlocks ? fBlockMinor[0] : 0;}
+   Long64_t               GetMaxIndexValue()      const {return fLastMajor;}
+   Long64_t               GetMaxIndexValueMinor() const {return fLastMinor;}
+   virtual Long64_t       GetN()            const {return fN;}
+   Int_t                  GetNBlocks()      const {return fNBlocks;}
+   virtual TTreeFormula  *GetMajorFormula();
+   virtual TTreeFormula  *GetMinorFormula();
+   virtual TTreeFormula  *GetMajorFormulaParent(const TTree *parent);
+   virtual TTreeFormula  *GetMinorFormulaParent(const TTree *parent);
+   virtual void           Print(Option_t *option="") const;
+   virtual void           UpdateFormulaLeaves(const TTree *parent);
+   virtual void           SetTree(const TTree *T);
+
+   ClassDef(TTreeCompactIndex,1);  //A compact, lazily loaded Tree Index with majorname and minorname.
+};
+
+#endif
@@ -126,6 +126,7 @@ protected:
    std::vector<std::string>  fAliasesUsed;    //! List of aliases used during the parsing of the expression.
 
    LongDouble_t*        fConstLD;   //! local version of fConsts able to store bigger numbers
+   void                *fJitFunction; //! native function compiled by JitCompile, if any
 
    TTreeFormula(const char *name, const char *formula, TTree *tree, const std::vector<std::string>& aliases);
    void Init(const char *name, const char *formula);
@@ -158,6 +159,9 @@ protected:
 
    void              Convert(UInt_t fromVersion);
 
+   Double_t          EvalJit(Int_t instance);
+   Bool_t            JitTranslate(TString &code);
+
 private:
    // Not implemented yet
    TTreeFormula(const TTreeFormula&);
@@ -174,7 +178,7 @@ public:
    virtual TClass*     EvalClass() const;
 
    template<typename T> T EvalInstance(Int_t i=0, const char *stringStack[]=0);
-   virtual Double_t       EvalInstance(Int_t i=0, const char *stringStack[]=0) {return EvalInstance<Double_t>(i, stringStack); }
+   virtual Double_t       EvalInstance(Int_t i=0, const char *stringStack[]=0) {return (fJitFunction && !stringStack) ? EvalJit(i) : EvalInstance<Double_t>(i, stringStack); }
    virtual Long64_t       EvalInstance64(Int_t i=0, const char *stringStack[]=0) {return EvalInstance<Long64_t>(i, stringStack); }
    virtual LongDouble_t   EvalInstanceLD(Int_t i=0, const char *stringStack[]=0) {return EvalInstance<LongDouble_t>(i, stringStack); }
 
@@ -194,7 +198,9 @@ public:
    //the mutable keyword.
    //NOTE: Also modify the code in PrintValue which current goes around this limitation :(
    virtual Bool_t      IsInteger(Bool_t fast=kTRUE) const;
+           Bool_t      IsJitCompiled() const { return fJitFunction != 0; }
            Bool_t      IsQuickLoad() const { return fQuickLoad; }
+   virtual Bool_t      JitCompile();
    virtual Bool_t      IsString() const;
    virtual Bool_t      Notify() { UpdateFormulaLeaves(); return kTRUE; }
    virtual char       *PrintValue(Int_t mode=0) const;
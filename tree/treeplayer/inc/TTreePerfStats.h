@@ -37,6 +37,13 @@ class TPaveText;
 class TGraphErrors;
 class TGaxis;
 class TText;
+
+namespace ROOT {
+namespace Internal {
+class TTreePerfStatsProfile;
+}
+}
+
 class TTreePerfStats : public TVirtualPerfStats {
 
 protected:
@@ -44,6 +51,8 @@ protected:
    Int_t         fNleaves;       //Number of leaves in the tree
    Int_t         fReadCalls;     //Number of read calls
    Int_t         fReadaheadSize; //Readahead cache size
+   Int_t         fBasketResizes; //Number of basket size changes of the adaptive basket sizing
+   Long64_t      fBasketGrowth;  //Sum of the basket size changes (new minus old size) in bytes
    Long64_t      fBytesRead;     //Number of bytes read
    Long64_t      fBytesReadExtra;//Number of bytes (overhead) of the readahead cache
    Double_t      fRealNorm;      //Real time scale factor for fGraphTime
@@ -62,6 +71,12 @@ protected:
    TStopwatch   *fWatch;         //TStopwatch pointer
    TGaxis       *fRealTimeAxis;  //pointer to TGaxis object showing real-time
    TText        *fHostInfoText;  //Graphics Text object with the fHostInfo data
+   ROOT::Internal::TTreePerfStatsProfile *fProfile; //!Per-branch and per-thread counters
+
+   Bool_t           IsMonitored(TObject *branch) const;
+   void             PrintBranches(Bool_t perThread) const;
+   Bool_t           SaveAsJSON(const char *filename) const;
+   Bool_t           SaveAsTrace(const char *filename) const;
 
 public:
    TTreePerfStats();
@@ -72,6 +87,8 @@ public:
    virtual void     Draw(Option_t *option="");
    virtual void     ExecuteEvent(Int_t event, Int_t px, Int_t py);
    virtual void     Finish();
+   virtual Long64_t GetBasketGrowth() const {return fBasketGrowth;}
+   virtual Int_t    GetBasketResizes() const {return fBasketResizes;}
    virtual Long64_t GetBytesRead() const {return fBytesRead;}
    virtual Long64_t GetBytesReadExtra() const {return fBytesReadExtra;}
    virtual Double_t GetCpuTime()   const {return fCpuTime;}
@@ -99,10 +116,16 @@ public:
    virtual void     FileOpenEvent(TFile *, const char *, Double_t) {}
    virtual void     FileReadEvent(TFile *file, Int_t len, Double_t start);
    virtual void     UnzipEvent(TObject *tree, Long64_t pos, Double_t start, Int_t complen, Int_t objlen);
+   virtual void     BasketReadEvent(TObject *branch, Int_t len, Double_t start, Bool_t cachemiss);
+   virtual void     BasketUnzipEvent(TObject *branch, Double_t start, Int_t complen, Int_t objlen);
+   virtual void     EntryReadEvent(TObject *branch, Int_t nbytes, Double_t start);
+   virtual void     BasketSizeEvent(TObject *tree, TObject *branch, Long64_t entry, Int_t oldsize, Int_t newsize, Double_t compress);
    virtual void     RateEvent(Double_t , Double_t , Long64_t , Long64_t) {}
 
    virtual void     SaveAs(const char *filename="",Option_t *option="") const;
    virtual void     SavePrimitive(std::ostream &out, Option_t *option = "");
+   virtual void     SetBasketGrowth(Long64_t nbytes) {fBasketGrowth = nbytes;}
+   virtual void     SetBasketResizes(Int_t nresizes) {fBasketResizes = nresizes;}
    virtual void     SetBytesRead(Long64_t nbytes) {fBytesRead = nbytes;}
    virtual void     SetBytesReadExtra(Long64_t nbytes) {fBytesReadExtra = nbytes;}
    virtual void     SetCompress(Double_t cx) {fCompress = cx;}
@@ -112,6 +135,7 @@ public:
    virtual void     SetGraphIO(TGraphErrors *gr) {fGraphIO = gr;}
    virtual void     SetGraphTime(TGraphErrors *gr) {fGraphTime = gr;}
    virtual void     SetHostInfo(const char *info) {fHostInfo = info;}
+           void     SetMaxTraceEvents(Long64_t n);
    virtual void     SetName(const char *name) {fName = name;}
    virtual void     SetNleaves(Int_t nleaves) {fNleaves = nleaves;}
    virtual void     SetReadaheadSize(Int_t nbytes) {fReadaheadSize = nbytes;}
@@ -121,7 +145,7 @@ public:
    virtual void     SetTreeCacheSize(Int_t nbytes) {fTreeCacheSize = nbytes;}
    virtual void     SetUnzipTime(Double_t uztime) {fUnzipTime = uztime;}
 
-   ClassDef(TTreePerfStats,1)  // TTree I/O performance measurement
+   ClassDef(TTreePerfStats,2)  // TTree I/O performance measurement
 };
 
 #endif
@@ -39,6 +39,7 @@
 
 
 class TVirtualIndex;
+class TTreeFormula;
 
 class TTreePlayer : public TVirtualTreePlayer {
 
@@ -65,6 +66,7 @@ protected:
    void           TakeAction(Int_t nfill, Int_t &npoints, Int_t &action, TObject *obj, Option_t *option);
    void           TakeEstimate(Int_t nfill, Int_t &npoints, Int_t action, TObject *obj, Option_t *option);
    void           DeleteSelectorFromFile();
+   void           CopyClusters(TTree *tree, TTreeFormula *select, Option_t *option, Long64_t nentries, Long64_t firstentry);
 
 public:
    TTreePlayer();
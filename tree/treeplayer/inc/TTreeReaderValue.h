@@ -37,6 +37,7 @@
 class TBranch;
 class TBranchElement;
 class TLeaf;
+class TTree;
 class TTreeReader;
 
 namespace ROOT {
@@ -97,6 +98,8 @@ namespace Internal {
       virtual const char* GetDerivedTypeName() const = 0;
 
       Detail::TBranchProxy* GetProxy() const { return fProxy; }
+      void* GetRawAddress();
+      TBranch* GetRawBranch(TTree* tree) const;
 
       void MarkTreeReaderUnavailable() { fTreeReader = 0; fSetupStatus = kSetupTreeDestructed; }
 
@@ -113,6 +116,12 @@ namespace Internal {
       ESetupStatus fSetupStatus; // setup status of this data access
       EReadStatus  fReadStatus; // read status of this data access
       std::vector<Long64_t> fStaticClassOffsets;
+      Bool_t       fRawDisabled; // the value cannot be decoded from the baskets, see GetRawAddress()
+      TTree*       fRawTree; // tree of fRawBranch
+      Int_t        fRawTreeNumber; // tree number of fRawTree in the chain
+      TBranch*     fRawBranch; // branch whose baskets hold the value
+      Long64_t     fRawEntry; // entry decoded in fRawValue
+      Long64_t     fRawValue; // storage of the value decoded from the baskets
 
       // FIXME: re-introduce once we have ClassDefInline!
       //ClassDef(TTreeReaderValueBase, 0);//Base class for accessors to data via TTreeReader
@@ -134,6 +143,12 @@ public:
                            TDictionary::GetDictionary(typeid(NonConstT_t))) {}
 
    T* Get() {
+      // Single values of fundamental type are decoded from the baskets
+      // when possible, without going through the branch proxy.
+      if (std::is_arithmetic<T>::value && !fRawDisabled) {
+         if (void *address = GetRawAddress())
+            return (T*)address;
+      }
       if (!fProxy){
          Error("Get()", "Value reader not properly initialized, did you remember to call TTreeReader.Set(Next)Entry()?");
          return 0;
@@ -24,6 +24,7 @@ and kept inside this chain index.
 #include "TChain.h"
 #include "TTreeFormula.h"
 #include "TTreeIndex.h"
+#include "TTreeCompactIndex.h"
 #include "TFile.h"
 #include "TError.h"
 
@@ -39,6 +40,31 @@ void TChainIndex::TChainIndexEntry::SetMinMaxFrom(const TTreeIndex *index )
    fMaxIndexValMinor = index->GetIndexValuesMinor()[index->GetN() - 1];
 }
 
+void TChainIndex::TChainIndexEntry::SetMinMaxFrom(const TTreeCompactIndex *index )
+{
+   fMinIndexValue    = index->GetMinIndexValue();
+   fMinIndexValMinor = index->GetMinIndexValueMinor();
+   fMaxIndexValue    = index->GetMaxIndexValue();
+   fMaxIndexValMinor = index->GetMaxIndexValueMinor();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the minimum and maximum from a TTreeIndex or a TTreeCompactIndex.
+/// Return kFALSE for any other kind of index.
+
+Bool_t TChainIndex::TChainIndexEntry::SetMinMaxFrom(const TVirtualIndex *index )
+{
+   if (const TTreeIndex *ti_index = dynamic_cast<const TTreeIndex*>(index)) {
+      SetMinMaxFrom(ti_index);
+      return kTRUE;
+   }
+   if (const TTreeCompactIndex *tc_index = dynamic_cast<const TTreeCompactIndex*>(index)) {
+      SetMinMaxFrom(tc_index);
+      return kTRUE;
+   }
+   return kFALSE;
+}
+
 ClassImp(TChainIndex)
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -109,14 +135,12 @@ TChainIndex::TChainIndex(const TTree *T, const char *majorname, const char *mino
          return;
       }
 
-      TTreeIndex *ti_index = dynamic_cast<TTreeIndex*>(index);
-      if (ti_index == 0) {
-         Error("TChainIndex", "The underlying TTree must have a TTreeIndex but has a %s.",
+      if (!entry.SetMinMaxFrom(index)) {
+         Error("TChainIndex", "The underlying TTree must have a TTreeIndex or a TTreeCompactIndex but has a %s.",
                index->IsA()->GetName());
          return;
       }
 
-      entry.SetMinMaxFrom(ti_index);
       fEntries.push_back(entry);
    }
 
@@ -137,15 +161,13 @@ TChainIndex::TChainIndex(const TTree *T, const char *majorname, const char *mino
 void TChainIndex::Append(const TVirtualIndex *index, Bool_t delaySort )
 {
    if (index) {
-      const TTreeIndex *ti_index = dynamic_cast<const TTreeIndex*>(index);
-      if (ti_index == 0) {
-         Error("Append", "The given index is not a TTreeIndex but a %s",
-               index->IsA()->GetName());
-      }
-
       TChainIndexEntry entry;
       entry.fTreeIndex = 0;
-      entry.SetMinMaxFrom(ti_index);
+      if (!entry.SetMinMaxFrom(index)) {
+         Error("Append", "The given index is not a TTreeIndex or a TTreeCompactIndex but a %s",
+               index->IsA()->GetName());
+         return;
+      }
       fEntries.push_back(entry);
    }
 
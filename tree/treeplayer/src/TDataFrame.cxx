@@ -0,0 +1,350 @@
+// @(#)root/treeplayer:$Id$
+// Author: ROOT I/O team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class ROOT::Experimental::TDataFrame
+    \brief A lazy, declarative interface to the entries of a TTree.
+
+A TDataFrame lets the user describe the analysis of a tree as a graph of
+transformations (Filter, Define) and actions (Count, Histo1D, Snapshot)
+instead of writing the event loop:
+~~~{.cpp}
+ROOT::Experimental::TDataFrame d("events", "file.root", {"pt"});
+auto hpt = d.Filter([](int n) { return n > 2; }, {"ntracks"}).Histo1D();
+hpt->Draw();
+~~~
+Nothing is read when the graph is built. The first time the result of an
+action is accessed, the entries are read once and all the actions booked
+so far are filled. When implicit multi-threading is enabled the event loop
+is run by a ROOT::TTreeProcessor: each cluster of the tree is processed by
+a task with its own readers and its own partial results (a copy of each
+histogram, a counter, ...), which are merged at the end of the loop.
+
+The columns are branches of the tree or columns defined with Define, whose
+values are computed at most once per entry, when first needed.
+*/
+
+#include "RConfigure.h"
+#include "ROOT/TDataFrame.hxx"
+
+#include "TChain.h"
+#include "TDirectory.h"
+#include "TFile.h"
+#include "THLimitsFinder.h"
+#include "TList.h"
+#include "TROOT.h"
+
+#include <algorithm>
+
+#ifdef R__USE_IMT
+#include "ROOT/TThreadedObject.hxx"
+#include "ROOT/TTreeProcessor.hxx"
+#endif
+
+namespace ROOT {
+namespace Internal {
+namespace TDF {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the manager of the graph of tree. If file is not null, the
+/// manager owns it (and the tree in it).
+
+TLoopManager::TLoopManager(TTree *tree, TFile *file, const std::vector<std::string> &defaultColumns)
+   : fTree(tree), fFile(file), fDefaultColumns(defaultColumns), fNSlots(1)
+{
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled()) fNSlots = ROOT::TThreadedObject<int>::fgMaxSlots;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor. The actions, which may refer to the filters, go first.
+
+TLoopManager::~TLoopManager()
+{
+   fActions.clear();
+   fFilters.clear();
+   fCustomColumns.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Book an action for the next event loop; ready is set to true once it ran.
+
+void TLoopManager::Book(const std::shared_ptr<TActionBase> &action, const std::shared_ptr<bool> &ready)
+{
+   fActions.push_back(action);
+   fReadiness.push_back(ready);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add a defined column. Its name must not be used by another defined column.
+
+void TLoopManager::Book(const std::shared_ptr<TCustomColumnBase> &column)
+{
+   if (GetCustomColumn(column->GetName()))
+      throw std::runtime_error("TDataFrame: the column \"" + column->GetName() + "\" is already defined");
+   fCustomColumns.push_back(column);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the defined column called name, null if there is none.
+
+TCustomColumnBase *TLoopManager::GetCustomColumn(const std::string &name) const
+{
+   for (auto &column : fCustomColumns)
+      if (column->GetName() == name) return column.get();
+   return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the names of the n columns read by a node: columns if it is not
+/// empty, the first n default columns otherwise.
+
+std::vector<std::string> TLoopManager::PickColumns(unsigned n, const std::vector<std::string> &columns) const
+{
+   if (!columns.empty()) {
+      if (columns.size() != n)
+         throw std::runtime_error("TDataFrame: the number of columns does not match the number of arguments");
+      return columns;
+   }
+   if (fDefaultColumns.size() < n)
+      throw std::runtime_error("TDataFrame: no column names given and not enough default columns");
+   return std::vector<std::string>(fDefaultColumns.begin(), fDefaultColumns.begin() + n);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Prepare the nodes of the graph to read the entries of reader in slot.
+
+void TLoopManager::InitSlot(TTreeReader &reader, unsigned slot)
+{
+   for (auto &column : fCustomColumns) column->InitSlot(reader, slot);
+   for (auto &filter : fFilters) filter->InitSlot(reader, slot);
+   for (auto &action : fActions) action->InitSlot(reader, slot);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Release the readers of slot, before its TTreeReader goes away.
+
+void TLoopManager::ResetSlot(unsigned slot)
+{
+   for (auto &action : fActions) action->ResetSlot(slot);
+   for (auto &filter : fFilters) filter->ResetSlot(slot);
+   for (auto &column : fCustomColumns) column->ResetSlot(slot);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Run the event loop, filling all the booked actions. The loop is run in
+/// parallel, cluster by cluster, if implicit multi-threading is enabled and
+/// sequential is false.
+
+void TLoopManager::Run(bool sequential)
+{
+   if (fActions.empty()) return;
+
+   auto runRange = [this](TTreeReader &reader, unsigned slot) {
+      InitSlot(reader, slot);
+      while (reader.Next()) {
+         Long64_t entry = reader.GetCurrentEntry();
+         for (auto &action : fActions) action->Run(slot, entry);
+      }
+      ResetSlot(slot);
+   };
+
+#ifdef R__USE_IMT
+   if (!sequential && ROOT::IsImplicitMTEnabled() && fNSlots > 1) {
+      // A task may start another one while waiting (e.g. for the parallel
+      // reading of the branches): the slots are taken from a stack rather
+      // than mapped to the threads.
+      std::vector<unsigned> freeSlots;
+      for (unsigned i = fNSlots; i > 0; --i) freeSlots.push_back(i - 1);
+      std::mutex slotMutex;
+
+      ROOT::TTreeProcessor processor(*fTree);
+      processor.Process([&](TTreeReader &reader) {
+         unsigned slot;
+         {
+            std::lock_guard<std::mutex> lock(slotMutex);
+            if (freeSlots.empty())
+               throw std::runtime_error("TDataFrame: more concurrent tasks than processing slots");
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+         }
+         runRange(reader, slot);
+         std::lock_guard<std::mutex> lock(slotMutex);
+         freeSlots.push_back(slot);
+      });
+   } else
+#endif
+   {
+      (void)sequential;
+      TTreeReader reader(fTree);
+      runRange(reader, 0);
+   }
+
+   for (auto &action : fActions) action->Finalize();
+   for (auto &ready : fReadiness) *ready = true;
+   fActions.clear();
+   fReadiness.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Store the sum of the counts of the slots.
+
+void TCountHelper::Finalize()
+{
+   *fResult = 0;
+   for (auto count : fCounts) *fResult += count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill result (already a reset copy of the model) with nSlots partial
+/// results.
+
+TFillHelper::TFillHelper(const std::shared_ptr<TH1> &result, unsigned nSlots)
+   : fResult(result), fPartials(nSlots), fValues(nSlots), fWeights(nSlots),
+     fBuffered(result->GetXaxis()->GetXmax() <= result->GetXaxis()->GetXmin()) {}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Create the partial histogram of slot, the first time it is used. Slot 0
+/// fills the result itself.
+
+void TFillHelper::InitSlot(unsigned slot)
+{
+   if (fBuffered || slot == 0 || fPartials[slot]) return;
+   TDirectory::TContext ctxt(0);
+   fPartials[slot].reset(static_cast<TH1 *>(fResult->Clone()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Merge the partial histograms, or compute the axis limits if the model
+/// has none and fill the result with the values of all the slots.
+
+void TFillHelper::Finalize()
+{
+   if (!fBuffered) {
+      TList partials;
+      for (unsigned i = 1; i < fPartials.size(); ++i)
+         if (fPartials[i]) partials.Add(fPartials[i].get());
+      if (partials.GetSize()) fResult->Merge(&partials);
+      fPartials.clear();
+      return;
+   }
+
+   Double_t xmin = 0, xmax = 0;
+   bool first = true;
+   for (auto &values : fValues) {
+      for (auto v : values) {
+         if (first || v < xmin) xmin = v;
+         if (first || v > xmax) xmax = v;
+         first = false;
+      }
+   }
+   if (!first) THLimitsFinder::GetLimitsFinder()->FindGoodLimits(fResult.get(), xmin, xmax);
+   for (unsigned i = 0; i < fValues.size(); ++i)
+      for (unsigned j = 0; j < fValues[i].size(); ++j) fResult->Fill(fValues[i][j], fWeights[i][j]);
+   fValues.clear();
+   fWeights.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Recreate filename and create in it the tree treename of a snapshot.
+
+TFile *OpenSnapshotFile(std::string_view filename, std::string_view treename, TTree *&tree)
+{
+   TDirectory::TContext ctxt(0);
+   std::string name(treename);
+   TFile *file = TFile::Open(std::string(filename).c_str(), "RECREATE");
+   if (!file || file->IsZombie()) {
+      delete file;
+      throw std::runtime_error("TDataFrame: cannot create the file \"" + std::string(filename) + "\"");
+   }
+   file->cd();
+   tree = new TTree(name.c_str(), name.c_str());
+   return file;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write the tree of a snapshot, close and delete its file (which deletes
+/// the tree).
+
+void CloseSnapshotFile(TFile *file, TTree *tree)
+{
+   {
+      TDirectory::TContext ctxt(file);
+      tree->Write();
+   }
+   file->Close();
+   delete file;
+}
+
+} // End of namespace TDF
+} // End of namespace Internal
+
+namespace Experimental {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Count the entries passing the filters of this node.
+
+TResultProxy<ULong64_t> TDataFrameInterface::Count()
+{
+   auto result = std::make_shared<ULong64_t>(0);
+   auto ready = std::make_shared<bool>(false);
+   BookAction<std::tuple<>>(ROOT::Internal::TDF::TCountHelper(result, fManager->GetNSlots()), {}, ready);
+   return TResultProxy<ULong64_t>(result, ready, fManager);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Book, with book, the filling of a reset copy of model.
+
+TResultProxy<TH1D> TDataFrameInterface::BookHisto(const TH1D &model,
+                                                 std::function<void(const std::shared_ptr<TH1> &,
+                                                                    const std::shared_ptr<bool> &)> book)
+{
+   std::shared_ptr<TH1D> h;
+   {
+      TDirectory::TContext ctxt(0);
+      h.reset(static_cast<TH1D *>(model.Clone()));
+   }
+   h->Reset();
+   auto ready = std::make_shared<bool>(false);
+   book(h, ready);
+   return TResultProxy<TH1D>(h, ready, fManager);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process the tree treename of the file filename. The actions and the
+/// filters which do not name their columns read the first defaultColumns.
+
+TDataFrame::TDataFrame(std::string_view treename, std::string_view filename,
+                       const std::vector<std::string> &defaultColumns)
+   : TDataFrameInterface(nullptr, nullptr)
+{
+   TDirectory::TContext ctxt(0);
+   std::string fname(filename), tname(treename);
+   TFile *file = TFile::Open(fname.c_str());
+   TTree *tree = nullptr;
+   if (file && !file->IsZombie()) file->GetObject(tname.c_str(), tree);
+   if (!tree) {
+      delete file;
+      throw std::runtime_error("TDataFrame: cannot read the tree \"" + tname + "\" of the file \"" + fname + "\"");
+   }
+   fManager = std::make_shared<ROOT::Internal::TDF::TLoopManager>(tree, file, defaultColumns);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process tree, which must outlive the data frame and its results.
+
+TDataFrame::TDataFrame(TTree &tree, const std::vector<std::string> &defaultColumns)
+   : TDataFrameInterface(std::make_shared<ROOT::Internal::TDF::TLoopManager>(&tree, nullptr, defaultColumns), nullptr)
+{
+}
+
+} // End of namespace Experimental
+} // End of namespace ROOT
@@ -39,6 +39,7 @@ A specialized TSelector for TTree::Draw.
 ClassImp(TSelectorDraw)
 
 const Int_t kCustomHistogram = BIT(17);
+const Int_t kIsWorker = BIT(18); // fObject is a copy owned by this selector, see InitWorker
 
 ////////////////////////////////////////////////////////////////////////////////
 /// Default selector constructor.
@@ -85,6 +86,7 @@ TSelectorDraw::TSelectorDraw()
 TSelectorDraw::~TSelectorDraw()
 {
    ClearFormula();
+   if (TestBit(kIsWorker)) delete fObject;
    delete [] fVar;
    if (fVal) {
       for (Int_t i = 0; i < fValSize; ++i)
@@ -134,6 +136,7 @@ void TSelectorDraw::Begin(TTree *tree)
    Bool_t optpara = kFALSE;
    Bool_t optcandle = kFALSE;
    Bool_t opt5d = kFALSE;
+   Bool_t optjit = kFALSE;
    if (opt.Contains("same")) {
       optSame = kTRUE;
       opt.ReplaceAll("same", "");
@@ -159,6 +162,10 @@ void TSelectorDraw::Begin(TTree *tree)
       opt5d = kTRUE;
       opt.ReplaceAll("gl5d", "");
    }
+   if (opt.Contains("jit")) {
+      optjit = kTRUE;
+      opt.ReplaceAll("jit", "");
+   }
    TCut realSelection(selection);
    //input list - only TEntryList
    TEntryList *inElist = fTree->GetEntryList();
@@ -480,6 +487,13 @@ void TSelectorDraw::Begin(TTree *tree)
       delete [] varexp;
       return;
    }
+   if (optjit) {
+      // Compile the formulas which can be, the others are still interpreted.
+      if (fSelect) fSelect->JitCompile();
+      for (i = 0; i < fDimension; ++i) {
+         if (fVar[i]) fVar[i]->JitCompile();
+      }
+   }
    if (fDimension > 4 && !(optpara || optcandle || opt5d || opt.Contains("goff"))) {
       Abort("Too many variables. Use the option \"para\", \"gl5d\" or \"candle\" to display more than 4 variables.");
       delete [] varexp;
@@ -891,6 +905,102 @@ void TSelectorDraw::Begin(TTree *tree)
    }
    if (varexp) delete [] varexp;
    if (hnamealloc) delete [] hnamealloc;
+   InitLoop();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the objects filled by this selector can be filled from
+/// several threads, each with its own copy of the object, and be merged
+/// afterwards (see InitWorker and MergeWorkers).
+///
+/// This is the case for the histograms and profiles filled from expressions
+/// returning numbers, not for the graphs, the polymarkers and the event lists.
+/// As long as GetAction() is negative the histogram limits are still being
+/// estimated and the histogram must be filled sequentially.
+
+Bool_t TSelectorDraw::CanFillConcurrently() const
+{
+   if (!fObject || !fObject->InheritsFrom(TH1::Class())) return kFALSE;
+   if (fObjEval || fTreeElist || fDimension < 1 || fDimension > 3) return kFALSE;
+   if (fTree && fTree->GetUpdate()) return kFALSE;
+   switch (TMath::Abs(fAction)) {
+      case 1: case 2: case 4: case 23: break;
+      case 3: if (fObject->TestBit(kCanDelete)) return kFALSE; break;
+      default: return kFALSE;
+   }
+   for (Int_t i = 0; i < fDimension; ++i) {
+      if (!fVar[i] || fVar[i]->IsString()) return kFALSE;
+   }
+   if (fSelect && fSelect->IsString()) return kFALSE;
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set up this selector to fill, from the entries of tree (typically another
+/// copy of the tree of master), a private copy of the histogram filled by
+/// master with the same expressions and selection. master must be able to
+/// fill concurrently (see CanFillConcurrently). The copies are added to the
+/// histogram of master by MergeWorkers.
+/// Return kFALSE if the expressions cannot be compiled for tree.
+
+Bool_t TSelectorDraw::InitWorker(const TSelectorDraw &master, TTree *tree)
+{
+   fTree = tree;
+   TString varexp;
+   for (Int_t i = 0; i < master.fDimension; ++i) {
+      if (i) varexp.Append(':');
+      varexp.Append(master.fVar[i]->GetTitle());
+   }
+   if (!CompileVariables(varexp, master.fSelect ? master.fSelect->GetTitle() : "")) return kFALSE;
+   if (fDimension != master.fDimension) return kFALSE;
+   for (Int_t i = 0; i < fDimension; ++i) {
+      if (master.fVar[i]->IsJitCompiled()) fVar[i]->JitCompile();
+   }
+   if (fSelect && master.fSelect->IsJitCompiled()) fSelect->JitCompile();
+
+   if (TestBit(kIsWorker)) delete fObject;
+   {
+      // The copy belongs to this thread and must not be added to a directory.
+      TDirectory::TContext ctxt(0);
+      fObject = master.fObject->Clone();
+   }
+   ((TH1*)fObject)->Reset();
+   SetBit(kIsWorker);
+   fAction = master.fAction;
+   fSelectedRows = 0;
+   fDraw = 0;
+   InitLoop();
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Add to the histogram filled by this selector the copies filled by
+/// the selectors in the list workers (see InitWorker), as well as their
+/// number of selected rows.
+
+void TSelectorDraw::MergeWorkers(TList *workers)
+{
+   TList objects;
+   TIter next(workers);
+   while (TSelectorDraw *worker = (TSelectorDraw*)next()) {
+      if (worker->fNfill) {
+         worker->TakeAction();
+         worker->fNfill = 0;
+      }
+      if (!worker->fSelectedRows) continue;
+      fSelectedRows += worker->fSelectedRows;
+      objects.Add(worker->fObject);
+   }
+   if (objects.GetSize()) ((TH1*)fObject)->Merge(&objects);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Initialize the buffers and the flags used in the entry loop, once the
+/// variables are compiled and the action is known.
+
+void TSelectorDraw::InitLoop()
+{
+   Int_t i;
    for (i = 0; i < fValSize; ++i)
       fVarMultiple[i] = kFALSE;
    fSelectMultiple = kFALSE;
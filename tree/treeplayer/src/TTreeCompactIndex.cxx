@@ -0,0 +1,808 @@
+// @(#)root/treeplayer:$Id$
+// Author: ROOT I/O team   October 2016
+
+/*************************************************************************
+ * Copyright (C) 1995-2016, Rene Brun and Fons Rademakers.               *
+ * All rights reserved.                                                  *
+ *                                                                       *
+ * For the licensing terms see $ROOTSYS/LICENSE.                         *
+ * For the list of contributors see $ROOTSYS/README/CREDITS.             *
+ *************************************************************************/
+
+/** \class TTreeCompactIndex
+A compact Tree Index with majorname and minorname.
+
+It provides the same lookups as TTreeIndex, but instead of keeping the
+sorted pairs (major,minor) and the entry numbers as three full Long64_t
+arrays, the sorted table is cut in blocks of fBlockSize entries. Each
+block is delta-encoded with variable length integers, which typically
+needs a few bytes per entry instead of 24. Only the first pair of each
+block is kept in the index object itself; a lookup finds the block by
+binary search on these pairs, decodes it and searches inside it.
+
+When the index is written with its tree into a file, each block is
+written as its own key (named after the tree) next to the tree. When
+the tree is read back, the blocks are read from the file only when a
+lookup needs them. When streamed to a non-file buffer (e.g. a TMessage),
+the blocks are streamed inline.
+
+The index is built with:
+~~~{.cpp}
+    tree->SetTreeIndex(new TTreeCompactIndex(tree, "Run", "Event"));
+~~~
+When implicit multi-threading is enabled, the sort of the index values
+and the encoding of the blocks are done in parallel.
+
+Lookups decode a block in a cache owned by the index, so like the other
+index classes TTreeCompactIndex must not be used concurrently from
+several threads.
+*/
+
+#include "TTreeCompactIndex.h"
+#include "TTreeIndex.h"
+#include "TTreeFormula.h"
+#include "TTree.h"
+#include "TFile.h"
+#include "TKey.h"
+#include "TArrayC.h"
+#include "TROOT.h"
+#include "RConfigure.h"
+
+#include <algorithm>
+
+#ifdef R__USE_IMT
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_sort.h"
+#endif
+
+ClassImp(TTreeCompactIndex)
+
+namespace {
+
+   // Sorts entry indices by (major,minor), like IndexSortComparator in TTreeIndex.cxx.
+   struct CompactIndexSortComparator {
+      CompactIndexSortComparator(const Long64_t *major, const Long64_t *minor)
+         : fValMajor(major), fValMinor(minor) {}
+
+      bool operator()(Long64_t i1, Long64_t i2) const {
+         if (fValMajor[i1] == fValMajor[i2])
+            return fValMinor[i1] < fValMinor[i2];
+         return fValMajor[i1] < fValMajor[i2];
+      }
+
+      const Long64_t *fValMajor, *fValMinor;
+   };
+
+   inline ULong64_t ZigZag(Long64_t value) {
+      return (((ULong64_t)value) << 1) ^ (ULong64_t)(value >> 63);
+   }
+
+   inline Long64_t UnZigZag(ULong64_t value) {
+      return (Long64_t)(value >> 1) ^ -(Long64_t)(value & 1);
+   }
+
+   inline void PutVarint(std::vector<char> &out, ULong64_t value) {
+      while (value >= 0x80) {
+         out.push_back((char)(value | 0x80));
+         value >>= 7;
+      }
+      out.push_back((char)value);
+   }
+
+   inline ULong64_t GetVarint(const char *&in, const char *end) {
+      ULong64_t value = 0;
+      Int_t shift = 0;
+      while (in < end && shift < 64) {
+         UChar_t c = (UChar_t)*in++;
+         value |= ((ULong64_t)(c & 0x7f)) << shift;
+         if (!(c & 0x80)) break;
+         shift += 7;
+      }
+      return value;
+   }
+
+   // Encode the 'n' sorted triplets of a block.
+   // The first triplet is stored as is, the next ones relative to the
+   // previous one: the major difference, then either the minor difference
+   // (same major) or the minor value, and the entry number difference.
+   TArrayC *EncodeBlock(Long64_t n, const Long64_t *major, const Long64_t *minor, const Long64_t *entry)
+   {
+      std::vector<char> out;
+      out.reserve(3 * n + 32);
+      PutVarint(out, ZigZag(major[0]));
+      PutVarint(out, ZigZag(minor[0]));
+      PutVarint(out, ZigZag(entry[0]));
+      for (Long64_t i = 1; i < n; ++i) {
+         ULong64_t dmajor = (ULong64_t)major[i] - (ULong64_t)major[i-1];
+         PutVarint(out, dmajor);
+         if (dmajor == 0) PutVarint(out, (ULong64_t)minor[i] - (ULong64_t)minor[i-1]);
+         else             PutVarint(out, ZigZag(minor[i]));
+         PutVarint(out, ZigZag(entry[i] - entry[i-1]));
+      }
+      return new TArrayC((Int_t)out.size(), &out[0]);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Default constructor for TTreeCompactIndex
+
+TTreeCompactIndex::TTreeCompactIndex(): TVirtualIndex()
+{
+   fTree               = 0;
+   fN                  = 0;
+   fBlockSize          = 0;
+   fNBlocks            = 0;
+   fBlockMajor         = 0;
+   fBlockMinor         = 0;
+   fLastMajor          = 0;
+   fLastMinor          = 0;
+   fBlockCycles        = 0;
+   fCacheBlock         = -1;
+   fMajorFormula       = 0;
+   fMinorFormula       = 0;
+   fMajorFormulaParent = 0;
+   fMinorFormulaParent = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Normal constructor for TTreeCompactIndex
+///
+/// Build an index table using the leaves of Tree T with major & minor names,
+/// see TTreeIndex::TTreeIndex for the meaning of the parameters.
+/// The sorted table is stored in blocks of 'blocksize' entries.
+///
+/// Example:
+/// ~~~{.cpp}
+///  tree.SetTreeIndex(new TTreeCompactIndex(&tree,"Run","Event"));
+///  tree.GetEntryWithIndex(1234,56789); // reads entry corresponding to
+///                                      // Run=1234 and Event=56789
+/// ~~~
+
+TTreeCompactIndex::TTreeCompactIndex(const TTree *T, const char *majorname, const char *minorname, Int_t blocksize)
+           : TVirtualIndex()
+{
+   fTree               = (TTree*)T;
+   fN                  = 0;
+   fBlockSize          = blocksize > 0 ? blocksize : 4096;
+   fNBlocks            = 0;
+   fBlockMajor         = 0;
+   fBlockMinor         = 0;
+   fLastMajor          = 0;
+   fLastMinor          = 0;
+   fBlockCycles        = 0;
+   fCacheBlock         = -1;
+   fMajorFormula       = 0;
+   fMinorFormula       = 0;
+   fMajorFormulaParent = 0;
+   fMinorFormulaParent = 0;
+   fMajorName          = majorname;
+   fMinorName          = minorname;
+   if (!T) return;
+   Long64_t n = T->GetEntries();
+   if (n <= 0) {
+      MakeZombie();
+      Error("TreeCompactIndex","Cannot build a TreeCompactIndex with a Tree having no entries");
+      return;
+   }
+
+   GetMajorFormula();
+   GetMinorFormula();
+   if (!fMajorFormula || !fMinorFormula) {
+      MakeZombie();
+      Error("TreeCompactIndex","Cannot build the index with major=%s, minor=%s",fMajorName.Data(), fMinorName.Data());
+      return;
+   }
+   if ((fMajorFormula->GetNdim() != 1) || (fMinorFormula->GetNdim() != 1)) {
+      MakeZombie();
+      Error("TreeCompactIndex","Cannot build the index with major=%s, minor=%s",fMajorName.Data(), fMinorName.Data());
+      return;
+   }
+
+   // The formulas are evaluated serially since they read through the tree.
+   std::vector<Long64_t> tmp_major(n), tmp_minor(n), tmp_entry(n);
+   Long64_t i;
+   Long64_t oldEntry = fTree->GetReadEntry();
+   Int_t current = -1;
+   for (i=0;i<n;i++) {
+      Long64_t centry = fTree->LoadTree(i);
+      if (centry < 0) break;
+      if (fTree->GetTreeNumber() != current) {
+         current = fTree->GetTreeNumber();
+         fMajorFormula->UpdateFormulaLeaves();
+         fMinorFormula->UpdateFormulaLeaves();
+      }
+      tmp_major[i] = (Long64_t) fMajorFormula->EvalInstance<LongDouble_t>();
+      tmp_minor[i] = (Long64_t) fMinorFormula->EvalInstance<LongDouble_t>();
+      tmp_entry[i] = i;
+   }
+   fTree->LoadTree(oldEntry);
+
+   Build(n, &tmp_major[0], &tmp_minor[0], &tmp_entry[0]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Destructor.
+
+TTreeCompactIndex::~TTreeCompactIndex()
+{
+   if (fTree && fTree->GetTreeIndex() == this) fTree->SetTreeIndex(0);
+   ClearBlocks();
+   delete fMajorFormula;        fMajorFormula  = 0;
+   delete fMinorFormula;        fMinorFormula  = 0;
+   delete fMajorFormulaParent;  fMajorFormulaParent = 0;
+   delete fMinorFormulaParent;  fMinorFormulaParent = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Append 'add' to this index.  Entry 0 in add will become entry n+1 in this.
+/// 'add' can be a TTreeCompactIndex or a TTreeIndex.
+/// If delaySort is true, do not sort the value, then you must call
+/// Append(0,kFALSE);
+
+void TTreeCompactIndex::Append(const TVirtualIndex *add, Bool_t delaySort )
+{
+   if (add && add->GetN()) {
+      // Decode the current content, it is encoded again once sorted.
+      if (fPendingEntry.empty() && fN) {
+         if (!DecodeAll(fPendingMajor, fPendingMinor, fPendingEntry, 0)) {
+            Error("Append","Cannot read the blocks of the index");
+            return;
+         }
+      }
+
+      Long64_t oldn = fN;
+      const TTreeCompactIndex *tc_add = dynamic_cast<const TTreeCompactIndex*>(add);
+      const TTreeIndex *ti_add = dynamic_cast<const TTreeIndex*>(add);
+      if (tc_add) {
+         if (!tc_add->DecodeAll(fPendingMajor, fPendingMinor, fPendingEntry, oldn)) {
+            Error("Append","Cannot read the blocks of the index to append");
+            return;
+         }
+      } else if (ti_add) {
+         Long64_t *addIndex = ti_add->GetIndex();
+         Long64_t *addValues = ti_add->GetIndexValues();
+         Long64_t *addValues2 = ti_add->GetIndexValuesMinor();
+         for (Long64_t i = 0; i < ti_add->GetN(); i++) {
+            fPendingMajor.push_back(addValues[i]);
+            fPendingMinor.push_back(addValues2[i]);
+            fPendingEntry.push_back(addIndex[i] + oldn);
+         }
+      } else {
+         Error("Append","Can only Append a TTreeCompactIndex or a TTreeIndex to a TTreeCompactIndex but got a %s",
+               add->IsA()->GetName());
+         return;
+      }
+      fN = fPendingEntry.size();
+   }
+
+   if (!delaySort && !fPendingEntry.empty()) {
+      std::vector<Long64_t> major, minor, entry;
+      major.swap(fPendingMajor);
+      minor.swap(fPendingMinor);
+      entry.swap(fPendingEntry);
+      Build(entry.size(), &major[0], &minor[0], &entry[0]);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Sort the 'n' triplets (major,minor,entry) and encode them in blocks,
+/// replacing the current content of the index.
+
+void TTreeCompactIndex::Build(Long64_t n, const Long64_t *major, const Long64_t *minor, const Long64_t *entry)
+{
+   ClearBlocks();
+   if (fBlockSize <= 0) fBlockSize = 4096;
+   fN = n;
+   if (n <= 0) return;
+
+   std::vector<Long64_t> order(n);
+   for (Long64_t i = 0; i < n; i++) order[i] = i;
+   CompactIndexSortComparator comp(major, minor);
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled()) {
+      tbb::parallel_sort(order.begin(), order.end(), comp);
+   } else
+#endif
+   {
+      std::sort(order.begin(), order.end(), comp);
+   }
+
+   std::vector<Long64_t> smajor(n), sminor(n), sentry(n);
+   for (Long64_t i = 0; i < n; i++) {
+      smajor[i] = major[order[i]];
+      sminor[i] = minor[order[i]];
+      sentry[i] = entry[order[i]];
+   }
+   std::vector<Long64_t>().swap(order);
+
+   fNBlocks = (Int_t)((n + fBlockSize - 1) / fBlockSize);
+   fBlockMajor = new Long64_t[fNBlocks];
+   fBlockMinor = new Long64_t[fNBlocks];
+   fBlocks.assign(fNBlocks, (TArrayC*)0);
+   for (Int_t b = 0; b < fNBlocks; b++) {
+      fBlockMajor[b] = smajor[(Long64_t)b * fBlockSize];
+      fBlockMinor[b] = sminor[(Long64_t)b * fBlockSize];
+   }
+   fLastMajor = smajor[n-1];
+   fLastMinor = sminor[n-1];
+
+   auto encode = [&](Int_t b) {
+      Long64_t first = (Long64_t)b * fBlockSize;
+      Long64_t count = std::min((Long64_t)fBlockSize, n - first);
+      fBlocks[b] = EncodeBlock(count, &smajor[first], &sminor[first], &sentry[first]);
+   };
+#ifdef R__USE_IMT
+   if (ROOT::IsImplicitMTEnabled()) {
+      tbb::parallel_for(0, fNBlocks, encode);
+   } else
+#endif
+   {
+      for (Int_t b = 0; b < fNBlocks; b++) encode(b);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Delete the blocks and the block table, and forget where they were stored.
+
+void TTreeCompactIndex::ClearBlocks()
+{
+   for (size_t b = 0; b < fBlocks.size(); b++) delete fBlocks[b];
+   fBlocks.clear();
+   delete [] fBlockMajor;  fBlockMajor = 0;
+   delete [] fBlockMinor;  fBlockMinor = 0;
+   delete [] fBlockCycles; fBlockCycles = 0;
+   fNBlocks = 0;
+   fLastMajor = fLastMinor = 0;
+   fBlockDir = "";
+   fBlockKeyName = "";
+   fBlockFileUUID = TUUID("00000000-0000-0000-0000-000000000000");
+   fCacheBlock = -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Append the content of the whole index to major, minor and entry,
+/// adding 'offset' to the entry numbers. Return kFALSE if a block
+/// could not be read.
+
+Bool_t TTreeCompactIndex::DecodeAll(std::vector<Long64_t> &major, std::vector<Long64_t> &minor,
+                                    std::vector<Long64_t> &entry, Long64_t offset) const
+{
+   major.reserve(major.size() + fN);
+   minor.reserve(minor.size() + fN);
+   entry.reserve(entry.size() + fN);
+   for (Int_t b = 0; b < fNBlocks; b++) {
+      if (!DecodeBlock(b)) return kFALSE;
+      major.insert(major.end(), fCacheMajor.begin(), fCacheMajor.end());
+      minor.insert(minor.end(), fCacheMinor.begin(), fCacheMinor.end());
+      for (size_t i = 0; i < fCacheEntry.size(); i++) entry.push_back(fCacheEntry[i] + offset);
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Decode 'block' into the cache, reading it from the file if needed.
+
+Bool_t TTreeCompactIndex::DecodeBlock(Int_t block) const
+{
+   if (block == fCacheBlock) return kTRUE;
+   if (!LoadBlock(block)) return kFALSE;
+
+   Long64_t count = std::min((Long64_t)fBlockSize, fN - (Long64_t)block * fBlockSize);
+   fCacheMajor.resize(count);
+   fCacheMinor.resize(count);
+   fCacheEntry.resize(count);
+
+   const char *in  = fBlocks[block]->GetArray();
+   const char *end = in + fBlocks[block]->GetSize();
+   fCacheMajor[0] = UnZigZag(GetVarint(in, end));
+   fCacheMinor[0] = UnZigZag(GetVarint(in, end));
+   fCacheEntry[0] = UnZigZag(GetVarint(in, end));
+   for (Long64_t i = 1; i < count; ++i) {
+      ULong64_t dmajor = GetVarint(in, end);
+      fCacheMajor[i] = (Long64_t)((ULong64_t)fCacheMajor[i-1] + dmajor);
+      if (dmajor == 0) fCacheMinor[i] = (Long64_t)((ULong64_t)fCacheMinor[i-1] + GetVarint(in, end));
+      else             fCacheMinor[i] = UnZigZag(GetVarint(in, end));
+      fCacheEntry[i] = fCacheEntry[i-1] + UnZigZag(GetVarint(in, end));
+   }
+   fCacheBlock = block;
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the last block whose first pair is lower or equal to major|minor,
+/// or -1 if major|minor is lower than the first entry in the index.
+
+Int_t TTreeCompactIndex::FindBlock(Long64_t major, Long64_t minor) const
+{
+   Int_t pos = 0, count = fNBlocks, step, mid;
+   // find upper bound using bisection
+   while( count > 0 ) {
+      step = count / 2;
+      mid = pos + step;
+      // check if *mid <= major|minor
+      if( fBlockMajor[mid] < major
+          || ( fBlockMajor[mid] == major && fBlockMinor[mid] <= minor ) ) {
+         pos = mid+1;
+         count -= step + 1;
+      } else
+         count = step;
+   }
+   return pos - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// find position where major|minor values are in the decoded block,
+/// use lower_bound STD algorithm.
+
+Long64_t TTreeCompactIndex::FindValues(Long64_t major, Long64_t minor) const
+{
+   Long64_t mid, step, pos = 0, count = fCacheMajor.size();
+   // find lower bound using bisection
+   while( count > 0 ) {
+      step = count / 2;
+      mid = pos + step;
+      // check if *mid < major|minor
+      if( fCacheMajor[mid] < major
+          || ( fCacheMajor[mid] == major &&  fCacheMinor[mid] < minor ) ) {
+         pos = mid+1;
+         count -= step + 1;
+      } else
+         count = step;
+   }
+   return pos;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Make sure the encoded 'block' is in memory, reading it from the file
+/// holding the tree if needed.
+
+Bool_t TTreeCompactIndex::LoadBlock(Int_t block) const
+{
+   if (block < 0 || block >= fNBlocks) return kFALSE;
+   if ((Int_t)fBlocks.size() != fNBlocks) fBlocks.assign(fNBlocks, (TArrayC*)0);
+   if (fBlocks[block]) return kTRUE;
+
+   TFile *file = fTree ? fTree->GetCurrentFile() : 0;
+   TDirectory *dir = file ? file->GetDirectory(fBlockDir) : 0;
+   TString name = TString::Format("%s%d", fBlockKeyName.Data(), block);
+   TKey *key = dir && fBlockCycles ? dir->GetKey(name, fBlockCycles[block]) : 0;
+   if (key) fBlocks[block] = (TArrayC*)key->ReadObjectAny(TArrayC::Class());
+   if (!fBlocks[block]) {
+      Error("LoadBlock","Cannot read the block %s of the index of tree %s",
+            name.Data(), fTree ? fTree->GetName() : "");
+      return kFALSE;
+   }
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Write all the blocks as keys in 'dir'. The blocks not in memory yet are
+/// first read from the file they are currently stored in.
+
+void TTreeCompactIndex::WriteBlocks(TDirectory *dir)
+{
+   for (Int_t b = 0; b < fNBlocks; b++) {
+      if (!LoadBlock(b)) return;
+   }
+   TString keyname = TString::Format("%s_index_", fTree ? fTree->GetName() : GetName());
+   Short_t *cycles = new Short_t[fNBlocks];
+   for (Int_t b = 0; b < fNBlocks; b++) {
+      TString name = TString::Format("%s%d", keyname.Data(), b);
+      if (dir->WriteObjectAny(fBlocks[b], TArrayC::Class(), name) <= 0) {
+         Error("WriteBlocks","Cannot write the block %s of the index",name.Data());
+         delete [] cycles;
+         return;
+      }
+      TKey *key = dir->GetKey(name);
+      cycles[b] = key ? key->GetCycle() : 1;
+   }
+   delete [] fBlockCycles;
+   fBlockCycles  = cycles;
+   fBlockKeyName = keyname;
+   fBlockDir     = dir->GetPath();
+   Ssiz_t colon  = fBlockDir.Index(":/");
+   if (colon != kNPOS) fBlockDir.Remove(0, colon + 2);
+   fBlockFileUUID = dir->GetFile()->GetUUID();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Returns the entry number in this (friend) Tree corresponding to entry in
+/// the master Tree 'parent'.
+/// See TTreeIndex::GetEntryNumberFriend.
+
+Long64_t TTreeCompactIndex::GetEntryNumberFriend(const TTree *parent)
+{
+   if (!parent) return -3;
+   GetMajorFormulaParent(parent);
+   GetMinorFormulaParent(parent);
+   if (!fMajorFormulaParent || !fMinorFormulaParent) return -1;
+   if (!fMajorFormulaParent->GetNdim() || !fMinorFormulaParent->GetNdim()) {
+      // The Tree Index in the friend has a pair majorname,minorname
+      // not available in the parent Tree T.
+      // if the friend Tree has less entries than the parent, this is an error
+      Long64_t pentry = parent->GetReadEntry();
+      if (pentry >= fTree->GetEntries()) return -2;
+      // otherwise we ignore the Tree Index and return the entry number
+      // in the parent Tree.
+      return pentry;
+   }
+
+   // majorname, minorname exist in the parent Tree
+   // we find the current values pair majorv,minorv in the parent Tree
+   Double_t majord = fMajorFormulaParent->EvalInstance();
+   Double_t minord = fMinorFormulaParent->EvalInstance();
+   Long64_t majorv = (Long64_t)majord;
+   Long64_t minorv = (Long64_t)minord;
+   // we check if this pair exist in the index.
+   // if yes, we return the corresponding entry number
+   // if not the function returns -1
+   return fTree->GetEntryNumberWithIndex(majorv,minorv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return entry number corresponding to major and minor number.
+/// If an entry corresponding to major and minor is not found, the function
+/// returns the entry of the major,minor pair immediatly lower than the
+/// requested value, ie it will return -1 if the pair is lower than
+/// the first entry in the index.
+/// Only the block which may hold the pair is read and decoded.
+///
+/// See also GetEntryNumberWithIndex
+
+Long64_t TTreeCompactIndex::GetEntryNumberWithBestIndex(Long64_t major, Long64_t minor) const
+{
+   if (fN == 0) return -1;
+
+   Int_t block = FindBlock(major, minor);
+   if (block < 0 || !DecodeBlock(block)) return -1;
+
+   // The first pair of the block is lower or equal to major|minor,
+   // so pos is 0 only if that pair matches.
+   Long64_t pos = FindValues(major, minor);
+   if( pos < (Long64_t)fCacheMajor.size() && fCacheMajor[pos] == major && fCacheMinor[pos] == minor )
+      return fCacheEntry[pos];
+   return fCacheEntry[pos-1];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return entry number corresponding to major and minor number, or -1
+/// if the pair is not in the index.
+/// Only the block which may hold the pair is read and decoded.
+///
+/// See also GetEntryNumberWithBestIndex
+
+Long64_t TTreeCompactIndex::GetEntryNumberWithIndex(Long64_t major, Long64_t minor) const
+{
+   if (fN == 0) return -1;
+
+   Int_t block = FindBlock(major, minor);
+   if (block < 0 || !DecodeBlock(block)) return -1;
+
+   Long64_t pos = FindValues(major, minor);
+   if( pos < (Long64_t)fCacheMajor.size() && fCacheMajor[pos] == major && fCacheMinor[pos] == minor )
+      return fCacheEntry[pos];
+   return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a pointer to the TreeFormula corresponding to the majorname.
+
+TTreeFormula *TTreeCompactIndex::GetMajorFormula()
+{
+   if (!fMajorFormula) {
+      fMajorFormula = new TTreeFormula("Major",fMajorName.Data(),fTree);
+      fMajorFormula->SetQuickLoad(kTRUE);
+   }
+   return fMajorFormula;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a pointer to the TreeFormula corresponding to the minorname.
+
+TTreeFormula *TTreeCompactIndex::GetMinorFormula()
+{
+   if (!fMinorFormula) {
+      fMinorFormula = new TTreeFormula("Minor",fMinorName.Data(),fTree);
+      fMinorFormula->SetQuickLoad(kTRUE);
+   }
+   return fMinorFormula;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a pointer to the TreeFormula corresponding to the majorname in parent tree.
+
+TTreeFormula *TTreeCompactIndex::GetMajorFormulaParent(const TTree *parent)
+{
+   if (!fMajorFormulaParent) {
+      // Prevent TTreeFormula from finding any of the branches in our TTree even if it
+      // is a friend of the parent TTree.
+      TTree::TFriendLock friendlock(fTree, TTree::kFindLeaf | TTree::kFindBranch | TTree::kGetBranch | TTree::kGetLeaf);
+      fMajorFormulaParent = new TTreeFormula("MajorP",fMajorName.Data(),const_cast<TTree*>(parent));
+      fMajorFormulaParent->SetQuickLoad(kTRUE);
+   }
+   if (fMajorFormulaParent->GetTree() != parent) {
+      fMajorFormulaParent->SetTree(const_cast<TTree*>(parent));
+      fMajorFormulaParent->UpdateFormulaLeaves();
+   }
+   return fMajorFormulaParent;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return a pointer to the TreeFormula corresponding to the minorname in parent tree.
+
+TTreeFormula *TTreeCompactIndex::GetMinorFormulaParent(const TTree *parent)
+{
+   if (!fMinorFormulaParent) {
+      // Prevent TTreeFormula from finding any of the branches in our TTree even if it
+      // is a friend of the parent TTree.
+      TTree::TFriendLock friendlock(fTree, TTree::kFindLeaf | TTree::kFindBranch | TTree::kGetBranch | TTree::kGetLeaf);
+      fMinorFormulaParent = new TTreeFormula("MinorP",fMinorName.Data(),const_cast<TTree*>(parent));
+      fMinorFormulaParent->SetQuickLoad(kTRUE);
+   }
+   if (fMinorFormulaParent->GetTree() != parent) {
+      fMinorFormulaParent->SetTree(const_cast<TTree*>(parent));
+      fMinorFormulaParent->UpdateFormulaLeaves();
+   }
+   return fMinorFormulaParent;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Print the number of entries and blocks of the index and the table with:
+/// serial number, majorname, minorname, entry number.
+/// -  if option = "10" print only the first 10 entries
+/// -  if option = "100" print only the first 100 entries
+/// -  if option = "1000" print only the first 1000 entries
+/// -  if option = "all" print all the entries
+
+void TTreeCompactIndex::Print(Option_t * option) const
+{
+   TString opt = option;
+   Long64_t n = 0;
+   if (opt.Contains("10"))   n = 10;
+   if (opt.Contains("100"))  n = 100;
+   if (opt.Contains("1000")) n = 1000;
+   if (opt.Contains("all"))  n = fN;
+   if (n > fN) n = fN;
+
+   Printf("\n*****************************************************************");
+   Printf("*    Compact index of Tree: %s/%s",fTree ? fTree->GetName() : "",fTree ? fTree->GetTitle() : "");
+   Printf("*    %lld entries in %d blocks of %d entries",fN,fNBlocks,fBlockSize);
+   Printf("*****************************************************************");
+   if (!n) return;
+   Printf("%8s : %16s : %16s : %16s","serial",fMajorName.Data(),fMinorName.Data(),"entry number");
+   Printf("*****************************************************************");
+   for (Long64_t i=0;i<n;i++) {
+      Int_t block = (Int_t)(i / fBlockSize);
+      if (!DecodeBlock(block)) return;
+      Long64_t pos = i - (Long64_t)block * fBlockSize;
+      Printf("%8lld :         %8lld :         %8lld :         %8lld",
+             i, fCacheMajor[pos], fCacheMinor[pos], fCacheEntry[pos]);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Stream an object of class TTreeCompactIndex.
+/// When writing to a file, the blocks are written as separate keys of the
+/// directory holding the tree (unless they are already in that file) and
+/// only the table of the first pair of each block is streamed; otherwise
+/// the blocks are streamed inline.
+
+void TTreeCompactIndex::Streamer(TBuffer &R__b)
+{
+   UInt_t R__s, R__c;
+   if (R__b.IsReading()) {
+      Version_t R__v = R__b.ReadVersion(&R__s, &R__c); if (R__v) { }
+      ClearBlocks();
+      TVirtualIndex::Streamer(R__b);
+      fMajorName.Streamer(R__b);
+      fMinorName.Streamer(R__b);
+      R__b >> fN;
+      R__b >> fBlockSize;
+      R__b >> fNBlocks;
+      R__b >> fLastMajor;
+      R__b >> fLastMinor;
+      fBlockMajor = new Long64_t[fNBlocks];
+      fBlockMinor = new Long64_t[fNBlocks];
+      R__b.ReadFastArray(fBlockMajor,fNBlocks);
+      R__b.ReadFastArray(fBlockMinor,fNBlocks);
+      fBlocks.assign(fNBlocks, (TArrayC*)0);
+      Bool_t isInline;
+      R__b >> isInline;
+      if (isInline) {
+         for (Int_t b = 0; b < fNBlocks; b++) {
+            Int_t nbytes;
+            R__b >> nbytes;
+            fBlocks[b] = new TArrayC(nbytes);
+            R__b.ReadFastArray(fBlocks[b]->GetArray(), nbytes);
+         }
+      } else {
+         fBlockDir.Streamer(R__b);
+         fBlockKeyName.Streamer(R__b);
+         fBlockCycles = new Short_t[fNBlocks];
+         R__b.ReadFastArray(fBlockCycles,fNBlocks);
+         TFile *file = dynamic_cast<TFile*>(R__b.GetParent());
+         if (file) fBlockFileUUID = file->GetUUID();
+      }
+      R__b.CheckByteCount(R__s, R__c, TTreeCompactIndex::IsA());
+   } else {
+      if (!fPendingEntry.empty()) Append(0, kFALSE);
+
+      // Find where to store the blocks: next to the tree if the buffer is
+      // going to a file, inline otherwise.
+      TFile *file = dynamic_cast<TFile*>(R__b.GetParent());
+      TDirectory *dir = 0;
+      if (file && file->IsWritable() && fNBlocks) {
+         if (fTree && fTree->GetDirectory() && fTree->GetDirectory()->GetFile() == file) dir = fTree->GetDirectory();
+         else if (gDirectory && gDirectory->GetFile() == file) dir = gDirectory;
+         else dir = file;
+      }
+      if (dir && !(fBlockCycles && fBlockFileUUID == file->GetUUID())) {
+         WriteBlocks(dir);
+      }
+      Bool_t isInline = !(dir && fBlockCycles && fBlockFileUUID == file->GetUUID());
+      if (isInline) {
+         for (Int_t b = 0; b < fNBlocks; b++) {
+            if (!LoadBlock(b)) {
+               Error("Streamer","Cannot write the index of tree %s, a block could not be read",
+                     fTree ? fTree->GetName() : "");
+               isInline = kFALSE;
+               break;
+            }
+         }
+      }
+
+      R__c = R__b.WriteVersion(TTreeCompactIndex::IsA(), kTRUE);
+      TVirtualIndex::Streamer(R__b);
+      fMajorName.Streamer(R__b);
+      fMinorName.Streamer(R__b);
+      R__b << fN;
+      R__b << fBlockSize;
+      R__b << fNBlocks;
+      R__b << fLastMajor;
+      R__b << fLastMinor;
+      R__b.WriteFastArray(fBlockMajor, fNBlocks);
+      R__b.WriteFastArray(fBlockMinor, fNBlocks);
+      R__b << isInline;
+      if (isInline) {
+         for (Int_t b = 0; b < fNBlocks; b++) {
+            R__b << fBlocks[b]->GetSize();
+            R__b.WriteFastArray(fBlocks[b]->GetArray(), fBlocks[b]->GetSize());
+         }
+      } else {
+         fBlockDir.Streamer(R__b);
+         fBlockKeyName.Streamer(R__b);
+         if (fBlockCycles) {
+            R__b.WriteFastArray(fBlockCycles, fNBlocks);
+         } else {
+            for (Int_t b = 0; b < fNBlocks; b++) R__b << (Short_t)0;
+         }
+      }
+      R__b.SetByteCount(R__c, kTRUE);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Called by TChain::LoadTree when the parent chain changes it's tree.
+
+void TTreeCompactIndex::UpdateFormulaLeaves(const TTree *parent)
+{
+   if (fMajorFormula)       { fMajorFormula->UpdateFormulaLeaves();}
+   if (fMinorFormula)       { fMinorFormula->UpdateFormulaLeaves();}
+   if (fMajorFormulaParent) {
+      if (parent) fMajorFormulaParent->SetTree(const_cast<TTree*>(parent));
+      fMajorFormulaParent->UpdateFormulaLeaves();
+   }
+   if (fMinorFormulaParent) {
+      if (parent) fMinorFormulaParent->SetTree(const_cast<TTree*>(parent));
+      fMinorFormulaParent->UpdateFormulaLeaves();
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// this function is called by TChain::LoadTree and TTreePlayer::UpdateFormulaLeaves
+/// when a new Tree is loaded.
+
+void TTreeCompactIndex::SetTree(const TTree *T)
+{
+   fTree = (TTree*)T;
+}
@@ -52,6 +52,9 @@
 #include <stdlib.h>
 #include <typeinfo>
 #include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
 
 const Int_t kMaxLen     = 1024;
 
@@ -123,7 +126,7 @@ public:
 ////////////////////////////////////////////////////////////////////////////////
 
 TTreeFormula::TTreeFormula(): ROOT::v5::TFormula(), fQuickLoad(kFALSE), fNeedLoading(kTRUE),
-   fDidBooleanOptimization(kFALSE), fDimensionSetup(0)
+   fDidBooleanOptimization(kFALSE), fDimensionSetup(0), fJitFunction(0)
 
 {
    // Tree Formula default constructor
@@ -157,7 +160,7 @@ TTreeFormula::TTreeFormula(): ROOT::v5::TFormula(), fQuickLoad(kFALSE), fNeedLoa
 
 TTreeFormula::TTreeFormula(const char *name,const char *expression, TTree *tree)
    :ROOT::v5::TFormula(), fTree(tree), fQuickLoad(kFALSE), fNeedLoading(kTRUE),
-    fDidBooleanOptimization(kFALSE), fDimensionSetup(0)
+    fDidBooleanOptimization(kFALSE), fDimensionSetup(0), fJitFunction(0)
 {
    Init(name,expression);
 }
@@ -168,7 +171,7 @@ TTreeFormula::TTreeFormula(const char *name,const char *expression, TTree *tree)
 TTreeFormula::TTreeFormula(const char *name,const char *expression, TTree *tree,
                            const std::vector<std::string>& aliases)
    :ROOT::v5::TFormula(), fTree(tree), fQuickLoad(kFALSE), fNeedLoading(kTRUE),
-    fDidBooleanOptimization(kFALSE), fDimensionSetup(0), fAliasesUsed(aliases)
+    fDidBooleanOptimization(kFALSE), fDimensionSetup(0), fAliasesUsed(aliases), fJitFunction(0)
 {
    Init(name,expression);
 }
@@ -5103,6 +5106,11 @@ void TTreeFormula::UpdateFormulaLeaves()
             break;
       }
    }
+   if (fJitFunction) {
+      // The leaves (and their types) may have changed with the tree.
+      fJitFunction = 0;
+      JitCompile();
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -5696,3 +5704,234 @@ Bool_t TTreeFormula::SwitchToFormLeafInfo(Int_t code)
    }
    return kTRUE;
 }
+
+namespace {
+   // Declarations shared by all the functions compiled by TTreeFormula::JitCompile.
+   // They reproduce the protections of TTreeFormula::EvalInstance (e.g. x/0 is 0).
+   const char *gJitPrelude =
+      "#include <cmath>\n"
+      "#include <algorithm>\n"
+      "namespace ROOT { namespace Internal { namespace TTreeFormulaJit {\n"
+      "inline double Div(double a, double b) { return b == 0 ? 0 : a / b; }\n"
+      "inline double Mod(double a, double b) { return (double)((long long)a % (long long)b); }\n"
+      "inline double Tan(double x) { return std::cos(x) == 0 ? 0 : std::tan(x); }\n"
+      "inline double ACos(double x) { return std::fabs(x) > 1 ? 0 : std::acos(x); }\n"
+      "inline double ASin(double x) { return std::fabs(x) > 1 ? 0 : std::asin(x); }\n"
+      "inline double TanH(double x) { return std::cosh(x) == 0 ? 0 : std::tanh(x); }\n"
+      "inline double ACosH(double x) { return x < 1 ? 0 : std::acosh(x); }\n"
+      "inline double ATanH(double x) { return std::fabs(x) > 1 ? 0 : std::atanh(x); }\n"
+      "inline double Sqrt(double x) { return std::sqrt(std::fabs(x)); }\n"
+      "inline double Log(double x) { return x > 0 ? std::log(x) : 0; }\n"
+      "inline double Log10(double x) { return x > 0 ? std::log10(x) : 0; }\n"
+      "inline double Exp(double x) { return x < -700 ? 0 : std::exp(x > 700 ? 700 : x); }\n"
+      "inline double Sign(double x) { return x < 0 ? -1 : 1; }\n"
+      "inline double Int(double x) { return (double)(long long)x; }\n"
+      "inline double Bit(double x) { return (double)(unsigned long long)x; }\n"
+      "}}}\n";
+
+   typedef Double_t (*TTreeFormulaJitFunc_t)(void **);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Translate the operations of the formula into a C++ expression computing
+/// the same value from the addresses of the leaves (`v[code]`).
+/// Return kFALSE if the formula uses an operation, a variable or a leaf that
+/// the translation does not support (arrays, strings, aliases, data members,
+/// function calls, special variables like Entry$, ...).
+
+Bool_t TTreeFormula::JitTranslate(TString &code)
+{
+   if (fNoper < 1 || fNcodes < 1 || fMultiplicity != 0 || fAxis || fHasCast) return kFALSE;
+   if (TestBit(kIsCharacter) || TestBit(kMissingLeaf)) return kFALSE;
+
+   std::vector<TString> stack;
+   for (Int_t i=0; i<fNoper ; ++i) {
+      const Int_t oper = GetOper()[i];
+      const Int_t action = oper >> kTFOperShift;
+      const Int_t param = oper & kTFOperMask;
+
+      const char *unary = 0;
+      const char *binary = 0;
+      const char *infix = 0;
+      switch (action) {
+         case kEnd:         i = fNoper; continue;
+         case kBoolOptimize: continue; // && and || short-circuit in C++ too.
+
+         case kConstant: {
+            Double_t value = fConst[param];
+            if (!TMath::Finite(value)) return kFALSE;
+            stack.push_back(TString::Format("%.17g", value));
+            continue;
+         }
+         case kpi: stack.push_back(TString::Format("%.17g", TMath::Pi())); continue;
+
+         case kDefinedVariable: {
+            if (param >= fNcodes || fCodes[param] < 0 || fLookupType[param] != kDirect) return kFALSE;
+            if (fNdimensions[param] || IsLeafString(param)) return kFALSE;
+            TLeaf *leaf = (TLeaf*)fLeaves.UncheckedAt(param);
+            if (!leaf || leaf->GetLeafCount() || leaf->GetLenStatic() != 1) return kFALSE;
+            TString cl = leaf->IsA()->GetName();
+            if (cl != "TLeafB" && cl != "TLeafS" && cl != "TLeafI" && cl != "TLeafL" &&
+                cl != "TLeafF" && cl != "TLeafD" && cl != "TLeafO") return kFALSE;
+            stack.push_back(TString::Format("(double)(*(%s*)v[%d])", leaf->GetTypeName(), param));
+            continue;
+         }
+
+         case kAdd:         infix = "+"; break;
+         case kSubstract:   infix = "-"; break;
+         case kMultiply:    infix = "*"; break;
+         case kEqual:       infix = "=="; break;
+         case kNotEqual:    infix = "!="; break;
+         case kLess:        infix = "<"; break;
+         case kGreater:     infix = ">"; break;
+         case kLessThan:    infix = "<="; break;
+         case kGreaterThan: infix = ">="; break;
+         case kAnd:         infix = "&&"; break;
+         case kOr:          infix = "||"; break;
+         case kBitAnd:      infix = "&"; break;
+         case kBitOr:       infix = "|"; break;
+         case kLeftShift:   infix = "<<"; break;
+         case kRightShift:  infix = ">>"; break;
+
+         case kDivide: binary = "Div"; break;
+         case kModulo: binary = "Mod"; break;
+         case katan2:  binary = "std::atan2"; break;
+         case kfmod:   binary = "std::fmod"; break;
+         case kpow:    binary = "std::pow"; break;
+         case kmin:    binary = "std::min"; break;
+         case kmax:    binary = "std::max"; break;
+
+         case kcos:    unary = "std::cos"; break;
+         case ksin:    unary = "std::sin"; break;
+         case ktan:    unary = "Tan"; break;
+         case kacos:   unary = "ACos"; break;
+         case kasin:   unary = "ASin"; break;
+         case katan:   unary = "std::atan"; break;
+         case kcosh:   unary = "std::cosh"; break;
+         case ksinh:   unary = "std::sinh"; break;
+         case ktanh:   unary = "TanH"; break;
+         case kacosh:  unary = "ACosH"; break;
+         case kasinh:  unary = "std::asinh"; break;
+         case katanh:  unary = "ATanH"; break;
+         case ksqrt:   unary = "Sqrt"; break;
+         case klog:    unary = "Log"; break;
+         case kexp:    unary = "Exp"; break;
+         case klog10:  unary = "Log10"; break;
+         case kabs:    unary = "std::fabs"; break;
+         case ksign:   unary = "Sign"; break;
+         case kint:    unary = "Int"; break;
+
+         case ksq: {
+            if (stack.empty()) return kFALSE;
+            stack.back() = TString::Format("((%s)*(%s))", stack.back().Data(), stack.back().Data());
+            continue;
+         }
+         case kSignInv: {
+            if (stack.empty()) return kFALSE;
+            stack.back() = TString::Format("(-(%s))", stack.back().Data());
+            continue;
+         }
+         case kNot: {
+            if (stack.empty()) return kFALSE;
+            stack.back() = TString::Format("(double)((%s)==0)", stack.back().Data());
+            continue;
+         }
+         default: return kFALSE;
+      }
+
+      if (unary) {
+         if (stack.empty()) return kFALSE;
+         stack.back() = TString::Format("%s(%s)", unary, stack.back().Data());
+         continue;
+      }
+      if (stack.size() < 2) return kFALSE;
+      TString right = stack.back();
+      stack.pop_back();
+      TString &left = stack.back();
+      if (binary) {
+         left = TString::Format("%s(%s,%s)", binary, left.Data(), right.Data());
+      } else if (action == kAnd || action == kOr) {
+         left = TString::Format("(double)((%s)!=0 %s (%s)!=0)", left.Data(), infix, right.Data());
+      } else if (action >= kBitAnd && action <= kRightShift) {
+         left = TString::Format("Bit((unsigned long long)(%s) %s (unsigned long long)(%s))", left.Data(), infix, right.Data());
+      } else if (action >= kEqual && action <= kGreaterThan) {
+         left = TString::Format("(double)((%s) %s (%s))", left.Data(), infix, right.Data());
+      } else {
+         left = TString::Format("((%s) %s (%s))", left.Data(), infix, right.Data());
+      }
+   }
+   if (stack.size() != 1) return kFALSE;
+   code = stack.back();
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Compile the formula into a native function, used from then on by
+/// EvalInstance(Int_t) instead of interpreting the operations for each entry.
+/// The compiled functions are cached (and shared by all formulas) per
+/// translated expression, so compiling the same expression again is cheap.
+///
+/// Only the formulas made of arithmetic, logical and mathematical operations
+/// on constants and on scalar leaves of basic types can be compiled; for any
+/// other formula the function returns kFALSE and the formula keeps being
+/// interpreted. TTree::Draw uses it with the option "jit".
+
+Bool_t TTreeFormula::JitCompile()
+{
+   fJitFunction = 0;
+   TString body;
+   if (!JitTranslate(body) || !gInterpreter) return kFALSE;
+
+   static std::map<std::string, void*> gJitCache;
+   static Bool_t gJitPreludeDeclared = kFALSE;
+
+   R__LOCKGUARD2(gInterpreterMutex);
+   std::map<std::string, void*>::iterator iter = gJitCache.find(body.Data());
+   if (iter != gJitCache.end()) {
+      fJitFunction = iter->second;
+      return fJitFunction != 0;
+   }
+
+   void *func = 0;
+   if (!gJitPreludeDeclared) gJitPreludeDeclared = gInterpreter->Declare(gJitPrelude);
+   if (gJitPreludeDeclared) {
+      TString name = TString::Format("F%d", (Int_t)gJitCache.size());
+      TString code = TString::Format("namespace ROOT { namespace Internal { namespace TTreeFormulaJit {\n"
+                                     "double %s(void **v) { return %s; }\n}}}\n", name.Data(), body.Data());
+      if (gInterpreter->Declare(code)) {
+         func = (void*)gInterpreter->Calc(TString::Format("(long)&ROOT::Internal::TTreeFormulaJit::%s", name.Data()));
+      }
+   }
+   if (!func) Warning("JitCompile", "Could not compile %s, it will be interpreted.", GetTitle());
+   gJitCache[body.Data()] = func;
+   fJitFunction = func;
+   return fJitFunction != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Evaluate the formula with the function compiled by JitCompile. The
+/// branches are loaded as in EvalInstance.
+
+Double_t TTreeFormula::EvalJit(Int_t instance)
+{
+   if (TestBit(kMissingLeaf)) return 0;
+   if (instance != 0) return EvalInstance<Double_t>(instance);
+
+   void *values[kMAXCODES];
+   for (Int_t code = 0; code < fNcodes; ++code) {
+      TBranch *branch = (TBranch*)fBranches.UncheckedAt(code);
+      TLeaf *leaf = (TLeaf*)fLeaves.UncheckedAt(code);
+      if (branch) {
+         Long64_t treeEntry = branch->GetTree()->GetReadEntry();
+         R__LoadBranch(branch,treeEntry,fQuickLoad);
+      } else {
+         // The branch is shared with another formula which may not have been read.
+         branch = leaf->GetBranch();
+         Long64_t treeEntry = branch->GetTree()->GetReadEntry();
+         if (branch->GetReadEntry() != treeEntry) branch->GetEntry( treeEntry );
+      }
+      values[code] = leaf->GetValuePointer();
+   }
+   fNeedLoading = kFALSE;
+   return ((TTreeFormulaJitFunc_t)fJitFunction)(values);
+}
@@ -66,6 +66,22 @@ The Draw or Print functions print the following information:
  -  ReadUZCP  = Unipped MBytes per CP second
  -  ReadRT    = Zipped MBytes per RT second
  -  ReadCP    = Zipped MBytes per CP second
+ -  Resizes   = Number of basket size changes and their sum in KBytes, when
+                the tree is written with adaptive basket sizing (see
+                TTree::SetAdaptiveBaskets)
+
+
+Print("branches") adds, for each branch, the number of baskets read and
+read directly from the file (cache misses), the compressed, uncompressed
+and deserialized bytes, the share of bytes read but not deserialized, and
+the time spent reading, unzipping and deserializing; Print("threads") gives
+the same counters for each thread (see ROOT::EnableImplicitMT). The counters
+can be exported in JSON, and the timeline of the basket reads and unzips in
+the Chrome trace event format:
+~~~{.cpp}
+   ps->SaveAs("ioperf.json");
+   ps->SaveAs("ioperf-trace.json", "trace");
+~~~
 
  ### NOTE 1 :
 The ReadTotal value indicates the effective number of zipped bytes
@@ -95,6 +111,138 @@ The Physical disk speed is DiskIO + DiskIO*ReadExtra/100.
 #include "TTimeStamp.h"
 #include "TDatime.h"
 #include "TMath.h"
+#include "TBranch.h"
+
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ROOT {
+namespace Internal {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Per-branch and per-thread I/O counters of a TTreePerfStats, and the
+/// timeline of the basket reads and unzips exported as a Chrome trace.
+/// The events can come from several threads at the same time (implicit
+/// multi-threading): the counters are only updated under fMutex, the time
+/// being measured before taking it.
+
+class TTreePerfStatsProfile {
+public:
+   struct TCounters {
+      Long64_t fReadCalls = 0;     ///< Number of baskets read
+      Long64_t fCacheMisses = 0;   ///< Number of baskets read directly from the file
+      Long64_t fBytesRead = 0;     ///< Compressed bytes of the baskets read
+      Long64_t fUnzipCalls = 0;    ///< Number of baskets unzipped
+      Long64_t fBytesUnzipped = 0; ///< Uncompressed bytes of the baskets unzipped
+      Long64_t fEntriesRead = 0;   ///< Number of entries deserialized
+      Long64_t fBytesUsed = 0;     ///< Uncompressed bytes deserialized
+      Double_t fReadTime = 0;      ///< Time spent reading the baskets
+      Double_t fUnzipTime = 0;     ///< Time spent unzipping the baskets
+      Double_t fStreamTime = 0;    ///< Time spent deserializing the entries
+
+      void Add(const TCounters &c)
+      {
+         fReadCalls += c.fReadCalls; fCacheMisses += c.fCacheMisses; fBytesRead += c.fBytesRead;
+         fUnzipCalls += c.fUnzipCalls; fBytesUnzipped += c.fBytesUnzipped;
+         fEntriesRead += c.fEntriesRead; fBytesUsed += c.fBytesUsed;
+         fReadTime += c.fReadTime; fUnzipTime += c.fUnzipTime; fStreamTime += c.fStreamTime;
+      }
+
+      /// Share of the bytes of the baskets which were not deserialized.
+      Double_t UnusedFraction() const
+      {
+         Long64_t total = fUnzipCalls ? fBytesUnzipped : fBytesRead;
+         if (total <= 0 || fBytesUsed >= total) return 0;
+         return 1. - Double_t(fBytesUsed) / total;
+      }
+   };
+
+   struct TEvent {
+      Int_t    fBranch;   ///< Index of the branch in fBranchNames
+      Int_t    fThread;   ///< Index of the thread
+      Char_t   fKind;     ///< 'r' for a read, 'u' for an unzip
+      Int_t    fBytes;    ///< Bytes read or uncompressed
+      Double_t fStart;    ///< Start time
+      Double_t fDuration; ///< Duration in seconds
+   };
+
+   std::mutex fMutex;
+   Double_t fOrigin;                                        ///< Time of the creation of the profile
+   std::map<std::thread::id, Int_t> fThreads;               ///< Index of the threads, in order of appearance
+   std::map<const TObject*, Int_t> fBranches;               ///< Index of the branches, in order of appearance
+   std::vector<std::string> fBranchNames;                   ///< Names of the branches
+   std::map<std::pair<Int_t, Int_t>, TCounters> fCounters;  ///< Counters per (branch, thread)
+   std::vector<TEvent> fEvents;                             ///< Timeline of the basket reads and unzips
+   Long64_t fMaxEvents;                                     ///< Maximum size of fEvents
+
+   TTreePerfStatsProfile() : fOrigin(TTimeStamp()), fMaxEvents(1000000) {}
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Return the counters of branch for the calling thread; fMutex must be held.
+
+   TCounters &GetCounters(TObject *branch, Int_t &ibranch, Int_t &ithread)
+   {
+      auto b = fBranches.find(branch);
+      if (b == fBranches.end()) {
+         b = fBranches.insert(std::make_pair(branch, (Int_t)fBranchNames.size())).first;
+         fBranchNames.push_back(branch->GetName());
+      }
+      auto t = fThreads.find(std::this_thread::get_id());
+      if (t == fThreads.end()) {
+         t = fThreads.insert(std::make_pair(std::this_thread::get_id(), (Int_t)fThreads.size())).first;
+      }
+      ibranch = b->second;
+      ithread = t->second;
+      return fCounters[std::make_pair(ibranch, ithread)];
+   }
+
+   void AddEvent(Int_t ibranch, Int_t ithread, Char_t kind, Int_t bytes, Double_t start, Double_t duration)
+   {
+      if ((Long64_t)fEvents.size() >= fMaxEvents) return;
+      fEvents.push_back(TEvent{ibranch, ithread, kind, bytes, start, duration});
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Return the counters of each branch summed over the threads.
+
+   std::vector<TCounters> GetBranchTotals() const
+   {
+      std::vector<TCounters> totals(fBranchNames.size());
+      for (auto &c : fCounters) totals[c.first.first].Add(c.second);
+      return totals;
+   }
+};
+
+} // End of namespace Internal
+} // End of namespace ROOT
+
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return s quoted as a JSON string.
+
+std::string JSONString(const std::string &s)
+{
+   std::string out = "\"";
+   for (char c : s) {
+      if (c == '"' || c == '\\') {
+         out += '\\';
+         out += c;
+      } else if ((unsigned char)c < 0x20) {
+         out += TString::Format("\\u%04x", (unsigned int)c).Data();
+      } else {
+         out += c;
+      }
+   }
+   out += '"';
+   return out;
+}
+
+} // anonymous namespace
 
 ClassImp(TTreePerfStats)
 
@@ -115,6 +263,8 @@ TTreePerfStats::TTreePerfStats() : TVirtualPerfStats()
    fTreeCacheSize = 0;
    fReadCalls     = 0;
    fReadaheadSize = 0;
+   fBasketResizes = 0;
+   fBasketGrowth  = 0;
    fBytesRead     = 0;
    fBytesReadExtra= 0;
    fRealNorm      = 0;
@@ -125,6 +275,7 @@ TTreePerfStats::TTreePerfStats() : TVirtualPerfStats()
    fCompress      = 0;
    fRealTimeAxis  = 0;
    fHostInfoText  = 0;
+   fProfile       = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -151,6 +302,8 @@ TTreePerfStats::TTreePerfStats(const char *name, TTree *T) : TVirtualPerfStats()
    fTreeCacheSize = 0;
    fReadCalls     = 0;
    fReadaheadSize = 0;
+   fBasketResizes = 0;
+   fBasketGrowth  = 0;
    fBytesRead     = 0;
    fBytesReadExtra= 0;
    fRealNorm      = 0;
@@ -171,6 +324,7 @@ TTreePerfStats::TTreePerfStats(const char *name, TTree *T) : TVirtualPerfStats()
    TDatime dt;
    fHostInfo += TString::Format(" %s",dt.AsString());
    fHostInfoText   = 0;
+   fProfile        = new ROOT::Internal::TTreePerfStatsProfile;
 
    gPerfStats = this;
 }
@@ -188,6 +342,7 @@ TTreePerfStats::~TTreePerfStats()
    delete fWatch;
    delete fRealTimeAxis;
    delete fHostInfoText;
+   delete fProfile;
 
    if (gPerfStats == this) {
       gPerfStats = 0;
@@ -311,6 +466,100 @@ void TTreePerfStats::UnzipEvent(TObject * tree, Long64_t /* pos */, Double_t sta
    }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Record a change of the basket size of a branch of the monitored tree,
+/// decided at entry by the adaptive basket sizing (see TTree::AdaptBaskets).
+
+void TTreePerfStats::BasketSizeEvent(TObject *tree, TObject *branch, Long64_t entry, Int_t oldsize, Int_t newsize, Double_t compress)
+{
+   if (tree != this->fTree) return;
+   ++fBasketResizes;
+   fBasketGrowth += newsize - oldsize;
+   if (gDebug > 0) {
+      printf("TTreePerfStats: entry %lld, basket size of %s changed from %d to %d bytes (compression %.2f)\n",
+             entry, branch->GetName(), oldsize, newsize, compress);
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the events of branch are to be recorded, i.e. if this
+/// object is the perf stats of the tree of branch.
+
+Bool_t TTreePerfStats::IsMonitored(TObject *branch) const
+{
+   if (!fProfile || !branch) return kFALSE;
+   TTree *tree = ((TBranch*)branch)->GetTree();
+   return tree && tree->GetPerfStats() == this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the read of a basket of branch.
+/// -  len is the length of the compressed basket
+/// -  start is the TimeStamp before the read
+/// -  cachemiss is true if the basket was read directly from the file
+///    rather than from the TTreeCache
+
+void TTreePerfStats::BasketReadEvent(TObject *branch, Int_t len, Double_t start, Bool_t cachemiss)
+{
+   if (!IsMonitored(branch)) return;
+   Double_t dtime = Double_t(TTimeStamp()) - start;
+   std::lock_guard<std::mutex> lock(fProfile->fMutex);
+   Int_t ibranch, ithread;
+   ROOT::Internal::TTreePerfStatsProfile::TCounters &c = fProfile->GetCounters(branch, ibranch, ithread);
+   ++c.fReadCalls;
+   if (cachemiss) ++c.fCacheMisses;
+   c.fBytesRead += len;
+   c.fReadTime += dtime;
+   fProfile->AddEvent(ibranch, ithread, 'r', len, start, dtime);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the unzip of a basket of branch.
+/// -  start is the TimeStamp before unzip
+/// -  complen is the length of the compressed buffer
+/// -  objlen is the length of the de-compressed buffer
+
+void TTreePerfStats::BasketUnzipEvent(TObject *branch, Double_t start, Int_t /* complen */, Int_t objlen)
+{
+   if (!IsMonitored(branch)) return;
+   Double_t dtime = Double_t(TTimeStamp()) - start;
+   std::lock_guard<std::mutex> lock(fProfile->fMutex);
+   Int_t ibranch, ithread;
+   ROOT::Internal::TTreePerfStatsProfile::TCounters &c = fProfile->GetCounters(branch, ibranch, ithread);
+   ++c.fUnzipCalls;
+   c.fBytesUnzipped += objlen;
+   c.fUnzipTime += dtime;
+   fProfile->AddEvent(ibranch, ithread, 'u', objlen, start, dtime);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Record the deserialization of an entry of branch.
+/// -  nbytes is the number of bytes of the entry in the basket
+/// -  start is the TimeStamp before the deserialization
+
+void TTreePerfStats::EntryReadEvent(TObject *branch, Int_t nbytes, Double_t start)
+{
+   if (!IsMonitored(branch)) return;
+   Double_t dtime = Double_t(TTimeStamp()) - start;
+   std::lock_guard<std::mutex> lock(fProfile->fMutex);
+   Int_t ibranch, ithread;
+   ROOT::Internal::TTreePerfStatsProfile::TCounters &c = fProfile->GetCounters(branch, ibranch, ithread);
+   ++c.fEntriesRead;
+   c.fBytesUsed += nbytes;
+   c.fStreamTime += dtime;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Set the maximum number of basket reads and unzips kept for the Chrome
+/// trace export (1000000 by default); the following ones are only counted.
+
+void TTreePerfStats::SetMaxTraceEvents(Long64_t n)
+{
+   if (!fProfile) return;
+   std::lock_guard<std::mutex> lock(fProfile->fMutex);
+   fProfile->fMaxEvents = n < 0 ? 0 : n;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// When the run is finished this function must be called
 /// to save the current parameters in the file and Tree in this object
@@ -457,18 +706,159 @@ void TTreePerfStats::Print(Option_t * option) const
       printf("ReadStrCP = %7.3f MBytes/s\n",1e-6*fCompress*fBytesRead/(fCpuTime-fUnzipTime));
       printf("ReadZipCP = %7.3f MBytes/s\n",1e-6*fCompress*fBytesRead/fUnzipTime);
    }
+   if (fBasketResizes) {
+      printf("Resizes   = %d baskets, %+.3f KBytes\n",fBasketResizes,0.001*fBasketGrowth);
+   }
+   if (opts.Contains("threads")) {
+      PrintBranches(kTRUE);
+   } else if (opts.Contains("branches")) {
+      PrintBranches(kFALSE);
+   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/// Save this object to filename
+/// Print the I/O counters of each branch, summed over the threads or, if
+/// perThread is true, for each thread.
 
-void TTreePerfStats::SaveAs(const char *filename, Option_t * /*option*/) const
+void TTreePerfStats::PrintBranches(Bool_t perThread) const
+{
+   if (!fProfile) return;
+   std::lock_guard<std::mutex> lock(fProfile->fMutex);
+   printf("%-30s %6s %9s %9s %10s %10s %10s %7s %9s %9s %9s\n", "Branch", perThread ? "Thread" : "",
+          "ReadCalls", "CacheMiss", "ReadMB", "UnzipMB", "UsedMB", "Unused%", "ReadTime", "UnzipTime", "StrmTime");
+   auto print = [](const char *name, const char *thread, const ROOT::Internal::TTreePerfStatsProfile::TCounters &c) {
+      printf("%-30s %6s %9lld %9lld %10.3f %10.3f %10.3f %7.2f %9.3f %9.3f %9.3f\n", name, thread,
+             c.fReadCalls, c.fCacheMisses, 1e-6*c.fBytesRead, 1e-6*c.fBytesUnzipped, 1e-6*c.fBytesUsed,
+             100.*c.UnusedFraction(), c.fReadTime, c.fUnzipTime, c.fStreamTime);
+   };
+   if (perThread) {
+      for (auto &c : fProfile->fCounters) {
+         print(fProfile->fBranchNames[c.first.first].c_str(), TString::Format("%d", c.first.second), c.second);
+      }
+   } else {
+      std::vector<ROOT::Internal::TTreePerfStatsProfile::TCounters> totals = fProfile->GetBranchTotals();
+      for (size_t i = 0; i < totals.size(); ++i) {
+         print(fProfile->fBranchNames[i].c_str(), "", totals[i]);
+      }
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Save this object to filename.
+///
+/// If filename ends with ".json", the counters of the tree and of each
+/// branch and thread are saved in JSON; with option "trace", the timeline
+/// of the basket reads and unzips is saved instead, in the Chrome trace
+/// event format.
+
+void TTreePerfStats::SaveAs(const char *filename, Option_t *option) const
 {
    TTreePerfStats *ps = (TTreePerfStats*)this;
    ps->Finish();
+   TString fname(filename);
+   TString opt(option);
+   opt.ToLower();
+   if (fname.EndsWith(".json")) {
+      if (opt.Contains("trace")) SaveAsTrace(filename);
+      else SaveAsJSON(filename);
+      return;
+   }
    ps->TObject::SaveAs(filename);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Save the counters of the tree and of each branch and thread in filename,
+/// in JSON.
+
+Bool_t TTreePerfStats::SaveAsJSON(const char *filename) const
+{
+   std::ofstream out(filename);
+   if (!out) {
+      Error("SaveAs", "Cannot open %s", filename);
+      return kFALSE;
+   }
+   Long64_t basketBytes = 0;
+   out << "{\n";
+   out << "  \"name\": " << JSONString(fName.Data()) << ",\n";
+   out << "  \"host\": " << JSONString(fHostInfo.Data()) << ",\n";
+   if (fTree) out << "  \"tree\": " << JSONString(fTree->GetName()) << ",\n";
+   if (fFile) out << "  \"file\": " << JSONString(fFile->GetName()) << ",\n";
+   if (fProfile) {
+      std::lock_guard<std::mutex> lock(fProfile->fMutex);
+      std::vector<ROOT::Internal::TTreePerfStatsProfile::TCounters> totals = fProfile->GetBranchTotals();
+      auto counters = [&out](const ROOT::Internal::TTreePerfStatsProfile::TCounters &c) {
+         out << "\"readCalls\": " << c.fReadCalls << ", \"cacheMisses\": " << c.fCacheMisses
+             << ", \"bytesRead\": " << c.fBytesRead << ", \"unzipCalls\": " << c.fUnzipCalls
+             << ", \"bytesUnzipped\": " << c.fBytesUnzipped << ", \"entriesRead\": " << c.fEntriesRead
+             << ", \"bytesUsed\": " << c.fBytesUsed << ", \"unusedFraction\": " << c.UnusedFraction()
+             << ", \"readTime\": " << c.fReadTime << ", \"unzipTime\": " << c.fUnzipTime
+             << ", \"streamTime\": " << c.fStreamTime;
+      };
+      out << "  \"threads\": " << fProfile->fThreads.size() << ",\n";
+      out << "  \"branches\": [";
+      for (size_t i = 0; i < totals.size(); ++i) {
+         basketBytes += totals[i].fBytesRead;
+         out << (i ? ",\n" : "\n") << "    {\"name\": " << JSONString(fProfile->fBranchNames[i]) << ", ";
+         counters(totals[i]);
+         out << ",\n     \"perThread\": [";
+         Bool_t first = kTRUE;
+         for (auto &c : fProfile->fCounters) {
+            if (c.first.first != (Int_t)i) continue;
+            out << (first ? "" : ", ") << "{\"thread\": " << c.first.second << ", ";
+            counters(c.second);
+            out << "}";
+            first = kFALSE;
+         }
+         out << "]}";
+      }
+      out << "\n  ],\n";
+   }
+   out << "  \"summary\": {\"readCalls\": " << fReadCalls << ", \"bytesRead\": " << fBytesRead
+       << ", \"bytesReadExtra\": " << fBytesReadExtra
+       << ", \"bytesReadUnused\": " << (fBytesRead > basketBytes && basketBytes ? fBytesRead - basketBytes : 0)
+       << ", \"realTime\": " << fRealTime << ", \"cpuTime\": " << fCpuTime
+       << ", \"diskTime\": " << fDiskTime << ", \"unzipTime\": " << fUnzipTime
+       << ", \"compress\": " << fCompress << ", \"treeCacheSize\": " << fTreeCacheSize << "}\n";
+   out << "}\n";
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Save the timeline of the basket reads and unzips in filename, in the
+/// Chrome trace event format (to be loaded in chrome://tracing), with one
+/// track per thread.
+
+Bool_t TTreePerfStats::SaveAsTrace(const char *filename) const
+{
+   if (!fProfile) {
+      Error("SaveAs", "No profile recorded by %s", GetName());
+      return kFALSE;
+   }
+   std::ofstream out(filename);
+   if (!out) {
+      Error("SaveAs", "Cannot open %s", filename);
+      return kFALSE;
+   }
+   std::lock_guard<std::mutex> lock(fProfile->fMutex);
+   out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+   Bool_t first = kTRUE;
+   for (size_t i = 0; i < fProfile->fThreads.size(); ++i) {
+      out << (first ? "\n" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << i
+          << ", \"args\": {\"name\": \"thread " << i << "\"}}";
+      first = kFALSE;
+   }
+   for (auto &e : fProfile->fEvents) {
+      out << (first ? "\n" : ",\n") << "{\"name\": " << JSONString(fProfile->fBranchNames[e.fBranch])
+          << ", \"cat\": \"" << (e.fKind == 'r' ? "read" : "unzip") << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << e.fThread
+          << ", \"ts\": " << Long64_t(1e6 * (e.fStart - fProfile->fOrigin))
+          << ", \"dur\": " << Long64_t(1e6 * e.fDuration)
+          << ", \"args\": {\"bytes\": " << e.fBytes << "}}";
+      first = kFALSE;
+   }
+   out << "\n]}\n";
+   return kTRUE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Save primitive as a C++ statement(s) on output stream out
 
@@ -488,6 +878,8 @@ void TTreePerfStats::SavePrimitive(std::ostream &out, Option_t *option /*= ""*/)
    out<<"   ps->SetNleaves("<<fNleaves<<");"<<std::endl;
    out<<"   ps->SetReadCalls("<<fReadCalls<<");"<<std::endl;
    out<<"   ps->SetReadaheadSize("<<fReadaheadSize<<");"<<std::endl;
+   out<<"   ps->SetBasketResizes("<<fBasketResizes<<");"<<std::endl;
+   out<<"   ps->SetBasketGrowth("<<fBasketGrowth<<");"<<std::endl;
    out<<"   ps->SetBytesRead("<<fBytesRead<<");"<<std::endl;
    out<<"   ps->SetBytesReadExtra("<<fBytesReadExtra<<");"<<std::endl;
    out<<"   ps->SetRealNorm("<<fRealNorm<<");"<<std::endl;
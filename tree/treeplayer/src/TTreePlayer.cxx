@@ -18,6 +18,7 @@ extra libraries (Histogram, display, etc).
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <vector>
 
 #include "Riostream.h"
 #include "TTreePlayer.h"
@@ -75,6 +76,7 @@ extra libraries (Histogram, display, etc).
 #include "TRefArrayProxy.h"
 #include "TVirtualMonitoring.h"
 #include "TTreeCache.h"
+#include "TTreeCloner.h"
 #include "TStyle.h"
 
 #include "HFitInterface.h"
@@ -83,6 +85,14 @@ extra libraries (Histogram, display, etc).
 #include "Fit/UnBinData.h"
 #include "Math/MinimizerOptions.h"
 
+#include "RConfigure.h"
+#ifdef R__USE_IMT
+#include "ROOT/TThreadedObject.hxx"
+#include "ROOT/TTreeProcessor.hxx"
+#include <functional>
+#include <memory>
+#endif
+
 
 
 R__EXTERN Foption_t Foption;
@@ -91,6 +101,122 @@ TVirtualFitter *tFitter=0;
 
 ClassImp(TTreePlayer)
 
+#ifdef R__USE_IMT
+namespace {
+
+////////////////////////////////////////////////////////////////////////////////
+/// Thread private state of the concurrent entry loops of TTreePlayer: the
+/// selector processing the entries read by this thread, created by fMaker
+/// for the copy of the tree used by this thread. The copy constructor is
+/// used by ROOT::TThreadedObject to create the state of each thread.
+
+class TSelectorWorker {
+public:
+   typedef std::function<TSelector *(TTree *)> Maker_t;
+
+private:
+   Maker_t                    fMaker;       ///< Creates the selector for the tree of this thread
+   Bool_t                     fInitialized; ///< True once fMaker was called
+   std::unique_ptr<TSelector> fSelector;    ///< Selector processing the entries of this thread
+
+public:
+   TSelectorWorker(Maker_t maker) : fMaker(maker), fInitialized(kFALSE) {}
+   TSelectorWorker(const TSelectorWorker &worker) : fMaker(worker.fMaker), fInitialized(kFALSE) {}
+
+   TSelector *GetSelector() const { return fSelector.get(); }
+
+   /// Process the entries of the range of reader, as TTreePlayer::Process does.
+   void Process(TTreeReader &reader)
+   {
+      if (!fInitialized) {
+         fInitialized = kTRUE;
+         fSelector.reset(fMaker(reader.GetTree()));
+      }
+      if (!fSelector) return;
+      Bool_t useCutFill = fSelector->Version() == 0;
+      while (reader.Next()) {
+         Long64_t entry = reader.GetCurrentEntry();
+         if (useCutFill) {
+            if (fSelector->ProcessCut(entry))
+               fSelector->ProcessFill(entry);
+         } else {
+            fSelector->Process(entry);
+         }
+      }
+   }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return true if the entries of tree can be processed concurrently, each
+/// thread reading its own copy of the tree from the file: implicit
+/// multi-threading must be enabled and tree must be a TTree (not a TChain)
+/// read from a file, without friends, entry list or event list.
+
+Bool_t CanProcessConcurrently(TTree *tree)
+{
+   if (!ROOT::IsImplicitMTEnabled()) return kFALSE;
+   if (tree->InheritsFrom(TChain::Class())) return kFALSE;
+   if (tree->GetEventList() || tree->GetEntryList()) return kFALSE;
+   if (tree->GetListOfFriends() && tree->GetListOfFriends()->GetSize()) return kFALSE;
+   TDirectory *dir = tree->GetDirectory();
+   TFile *file = dir ? dir->GetFile() : 0;
+   // The threads reopen the file, thus the tree must be entirely written in it.
+   if (!file || file->IsWritable() || file->InheritsFrom("TMemFile")) return kFALSE;
+   return kTRUE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Process concurrently the entries [first, last) of tree with the selectors
+/// created by maker, one per thread, each for its own copy of the tree. Then
+/// call merge with the list of the selectors, which are deleted afterwards.
+
+void ProcessConcurrently(TTree *tree, TSelectorWorker::Maker_t maker, Long64_t first, Long64_t last,
+                         std::function<void(TList&)> merge)
+{
+   // The copies of the tree get the settings of tree which are not in the file.
+   TSelectorWorker::Maker_t makeForCopy = [tree, maker](TTree *copy) -> TSelector* {
+      TIter next(tree->GetListOfAliases());
+      while (TNamed *alias = (TNamed*)next()) copy->SetAlias(alias->GetName(), alias->GetTitle());
+      copy->SetWeight(tree->GetWeight());
+      copy->SetEstimate(TMath::Min(tree->GetEstimate(), (Long64_t)1000000));
+      return maker(copy);
+   };
+
+   ROOT::TTreeProcessor processor(*tree);
+   ROOT::TThreadedObject<TSelectorWorker> workers(makeForCopy);
+   processor.Process([&workers](TTreeReader &reader) { workers->Process(reader); }, first, last);
+
+   TList selectors;
+   for (unsigned i = 0; i < ROOT::TThreadedObject<TSelectorWorker>::fgMaxSlots; ++i) {
+      auto worker = workers.GetAtSlotUnchecked(i);
+      if (worker && worker->GetSelector()) selectors.Add(worker->GetSelector());
+   }
+   merge(selectors);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Fill concurrently, from the entries [first, last) of tree, the histogram
+/// of selector (see TSelectorDraw::CanFillConcurrently). Each thread fills
+/// its own copy of the histogram, the copies are then merged into it.
+
+void DrawConcurrently(TTree *tree, TSelectorDraw *selector, Long64_t first, Long64_t last)
+{
+   auto maker = [selector](TTree *copy) -> TSelector* {
+      TSelectorDraw *worker = new TSelectorDraw();
+      if (!worker->InitWorker(*selector, copy)) {
+         ::Error("TTreePlayer::DrawSelect", "Cannot compile the expressions for the tree of a thread.");
+         delete worker;
+         return 0;
+      }
+      worker->Notify();
+      return worker;
+   };
+   ProcessConcurrently(tree, maker, first, last, [selector](TList &workers) { selector->MergeWorkers(&workers); });
+}
+
+} // anonymous namespace
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Default Tree constructor.
 
@@ -153,10 +279,18 @@ TVirtualIndex *TTreePlayer::BuildIndex(const TTree *T, const char *majorname, co
 /// selected entries.
 ///
 /// -  selection is a standard selection expression (see TTreePlayer::Draw)
-/// -  option is reserved for possible future use
+/// -  option can contain "fast" (see below)
 /// -  nentries is the number of entries to process (default is all)
 /// -  first is the first entry to process (default is 0)
 ///
+/// With the option "fast", the selection is evaluated on all the entries of
+/// a cluster before any of them is copied. The clusters in which all the
+/// entries are selected are then copied without unzipping or unstreaming
+/// their baskets, as TTree::CopyEntries does with "fast" (see TTreeCloner),
+/// provided their baskets are aligned on the cluster boundaries; the other
+/// clusters are copied entry by entry. The option can also contain one of
+/// the sorting orders of the baskets described in TTree::CloneTree.
+///
 /// IMPORTANT: The copied tree stays connected with this tree until this tree
 /// is deleted.  In particular, any changes in branch addresses
 /// in this tree are forwarded to the clone trees.  Any changes
@@ -178,7 +312,7 @@ TVirtualIndex *TTreePlayer::BuildIndex(const TTree *T, const char *majorname, co
 ///   T2->Write();
 /// ~~~
 
-TTree *TTreePlayer::CopyTree(const char *selection, Option_t *, Long64_t nentries,
+TTree *TTreePlayer::CopyTree(const char *selection, Option_t *option, Long64_t nentries,
                              Long64_t firstentry)
 {
 
@@ -213,6 +347,14 @@ TTree *TTreePlayer::CopyTree(const char *selection, Option_t *, Long64_t nentrie
       fFormulaList->Add(select);
    }
 
+   TString opt = option;
+   opt.ToLower();
+   if (opt.Contains("fast")) {
+      CopyClusters(tree, select, option, nentries, firstentry);
+      fFormulaList->Clear();
+      return tree;
+   }
+
    //loop on the specified entries
    Int_t tnumber = -1;
    for (entry=firstentry;entry<firstentry+nentries;entry++) {
@@ -239,6 +381,72 @@ TTree *TTreePlayer::CopyTree(const char *selection, Option_t *, Long64_t nentrie
    return tree;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// Implementation of CopyTree with the option "fast": copy the selected
+/// entries of [firstentry, firstentry+nentries) one cluster at a time,
+/// without unzipping the clusters in which all the entries are selected.
+
+void TTreePlayer::CopyClusters(TTree *tree, TTreeFormula *select, Option_t *option, Long64_t nentries,
+                               Long64_t firstentry)
+{
+   std::vector<Long64_t> selected;
+   TTreeCloner *cloner = 0;
+   Int_t tnumber = -1;
+   Long64_t entry = firstentry;
+   while (entry < firstentry+nentries) {
+      Long64_t entryNumber = fTree->GetEntryNumber(entry);
+      if (entryNumber < 0) break;
+      Long64_t localEntry = fTree->LoadTree(entryNumber);
+      if (localEntry < 0) break;
+      if (tnumber != fTree->GetTreeNumber()) {
+         tnumber = fTree->GetTreeNumber();
+         if (select) select->UpdateFormulaLeaves();
+         delete cloner;
+         cloner = new TTreeCloner(fTree->GetTree(), tree, option,
+                                  TTreeCloner::kNoWarnings | TTreeCloner::kNoFileCache);
+      }
+      TTree::TClusterIterator clusters = fTree->GetTree()->GetClusterIterator(localEntry);
+      Long64_t clusterStart = clusters();
+      Long64_t clusterEnd = clusters.GetNextEntry();
+      if (clusterEnd <= localEntry) clusterEnd = localEntry + 1;
+      Long64_t treeOffset = entryNumber - localEntry;
+
+      // Evaluate the selection on the entries to process in this cluster.
+      selected.clear();
+      Long64_t ncandidates = 0;
+      for (; entry < firstentry+nentries; ++entry) {
+         entryNumber = fTree->GetEntryNumber(entry);
+         if (entryNumber < 0) break;
+         localEntry = entryNumber - treeOffset;
+         if (localEntry < clusterStart || localEntry >= clusterEnd) break;
+         ++ncandidates;
+         if (select) {
+            fTree->LoadTree(entryNumber);
+            Int_t ndata = select->GetNdata();
+            Bool_t keep = kFALSE;
+            for(Int_t current = 0; current<ndata && !keep; current++) {
+               keep |= (select->EvalInstance(current) != 0);
+            }
+            if (!keep) continue;
+         }
+         selected.push_back(entryNumber);
+      }
+      if (selected.empty()) continue;
+
+      Bool_t whole = ncandidates == clusterEnd - clusterStart
+                     && (Long64_t)selected.size() == ncandidates
+                     && selected.front() == treeOffset + clusterStart
+                     && selected.back() == treeOffset + clusterEnd - 1;
+      if (whole && cloner->ExecRange(clusterStart, clusterEnd)) continue;
+
+      for (Long64_t e : selected) {
+         fTree->GetEntry(e);
+         tree->Fill();
+      }
+   }
+   delete cloner;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Delete any selector created by this object.
 /// The selector has been created using TSelector::GetSelector(file)
@@ -588,6 +796,30 @@ Int_t TTreePlayer::Fit(const char *formula ,const char *varexp, const char *sele
 
 Long64_t TTreePlayer::GetEntries(const char *selection)
 {
+#ifdef R__USE_IMT
+   // With implicit multi-threading each thread counts the selected entries
+   // of its own copy of the tree. An invalid selection is reported below.
+   Bool_t concurrent = CanProcessConcurrently(fTree) && fTree->GetEntries() > 0;
+   if (concurrent && selection && strlen(selection)) {
+      TTreeFormula select("Selection", selection, fTree);
+      concurrent = select.GetNdim() > 0;
+   }
+   if (concurrent) {
+      TString sel = selection;
+      auto maker = [sel](TTree *copy) -> TSelector* {
+         TSelectorEntries *worker = new TSelectorEntries(sel.Data());
+         worker->SlaveBegin(copy);
+         worker->Notify();
+         return worker;
+      };
+      Long64_t selected = 0;
+      ProcessConcurrently(fTree, maker, 0, fTree->GetEntries(), [&selected](TList &workers) {
+         TIter next(&workers);
+         while (TSelectorEntries *worker = (TSelectorEntries*)next()) selected += worker->GetSelectedRows();
+      });
+      return selected;
+   }
+#endif
    TSelectorEntries s(selection);
    fTree->Process(&s);
    fTree->SetNotify(0);
@@ -2279,7 +2511,26 @@ Long64_t TTreePlayer::Process(TSelector *selector,Option_t *option, Long64_t nen
       fSelectorUpdate = selector;
       UpdateFormulaLeaves();
 
+#ifdef R__USE_IMT
+      // With implicit multi-threading, TTree::Draw fills the rest of its histogram
+      // concurrently as soon as the histogram limits are known, starting at a cluster.
+      Long64_t nextCluster = -1;
+      if (selector == fSelector && fSelector->CanFillConcurrently() && CanProcessConcurrently(fTree))
+         nextCluster = firstentry;
+#endif
+
       for (entry=firstentry;entry<firstentry+nentries;entry++) {
+#ifdef R__USE_IMT
+         if (entry == nextCluster) {
+            TTree::TClusterIterator clusterIter = fTree->GetClusterIterator(entry);
+            clusterIter();
+            nextCluster = clusterIter.GetNextEntry();
+            if (fSelector->GetAction() > 0 && nextCluster < firstentry+nentries) {
+               DrawConcurrently(fTree, fSelector, entry, firstentry+nentries);
+               break;
+            }
+         }
+#endif
          entryNumber = fTree->GetEntryNumber(entry);
          if (entryNumber < 0) break;
          if (timer && timer->ProcessEvents()) break;
@@ -21,14 +21,97 @@ The implementation of TTreeProcessor parallelizes the processing of the subrange
 each corresponding to a cluster in the TTree. This is possible thanks to the use
 of a ROOT::TThreadedObject, so that each thread works with its own TFile and TTree
 objects.
+
+The tree can be split in several files, e.g. the files of a TChain. The clusters
+of all the files are scheduled in the same task group, so that the idle threads
+steal clusters from the busy ones whatever the size of the files; each thread
+keeps the files it opened until the end of the processing.
 */
 
 #include "TROOT.h"
+#include "TChain.h"
+#include "TChainElement.h"
 #include "ROOT/TTreeProcessor.hxx"
 
 #include "tbb/task.h"
 #include "tbb/task_group.h"
 
+namespace {
+
+//////////////////////////////////////////////////////////////////////////////
+/// Schedule in g one task per cluster of the entries [firstEntry, lastEntry)
+/// of the tree of the i-th file of treeView.
+void ProcessFile(ROOT::TThreadedObject<ROOT::Internal::TTreeView> &treeView, std::function<void(TTreeReader&)> &func,
+                 tbb::task_group &g, unsigned i, Long64_t firstEntry, Long64_t lastEntry)
+{
+   Long64_t entries = treeView->GetEntries(i);
+   if (lastEntry > entries) lastEntry = entries;
+   if (firstEntry >= lastEntry) return;
+
+   auto clusterIter = treeView->GetClusterIterator(i, firstEntry);
+   Long64_t start = 0, end = 0;
+
+   // Iterate over the clusters and generate a task for each of them
+   while ((start = clusterIter()) < lastEntry) {
+      end = clusterIter.GetNextEntry();
+      if (start < firstEntry) start = firstEntry;
+      if (end > lastEntry) end = lastEntry;
+
+      g.run([&treeView, &func, i, start, end]() {
+         auto tr = treeView->GetTreeReader(i);
+         tr->SetEntriesRange(start, end);
+         func(*tr);
+      });
+   }
+}
+
+} // anonymous namespace
+
+namespace ROOT {
+namespace Internal {
+
+//////////////////////////////////////////////////////////////////////////////
+/// Return the names of the files of tree: the files of the chain if tree is
+/// a TChain, the file of the tree otherwise.
+std::vector<std::string> GetTreeFileNames(TTree &tree)
+{
+   std::vector<std::string> filenames;
+   if (TChain *chain = dynamic_cast<TChain*>(&tree)) {
+      TIter next(chain->GetListOfFiles());
+      while (TChainElement *element = (TChainElement*)next())
+         filenames.push_back(element->GetTitle());
+   } else if (TFile *file = tree.GetCurrentFile()) {
+      filenames.push_back(file->GetName());
+   } else {
+      ::Error("TTreeProcessor", "The tree %s is not attached to a file", tree.GetName());
+   }
+   return filenames;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// Return the name of tree in its files, including its directory.
+std::string GetTreeName(TTree &tree)
+{
+   if (TChain *chain = dynamic_cast<TChain*>(&tree)) {
+      // The elements hold the name of the tree (and of its directory) in the files.
+      TChainElement *element = (TChainElement*)chain->GetListOfFiles()->First();
+      return element ? element->GetName() : chain->GetName();
+   }
+   std::string name;
+   if (TDirectory *dir = tree.GetDirectory()) {
+      TString path = dir->GetPath();
+      Ssiz_t pos = path.Index(":/");
+      if (pos != kNPOS && pos + 2 < path.Length()) {
+         name = path.Data() + pos + 2;
+         name += '/';
+      }
+   }
+   return name + tree.GetName();
+}
+
+} // End of namespace Internal
+} // End of namespace ROOT
+
 using namespace ROOT;
 
 //////////////////////////////////////////////////////////////////////////////
@@ -49,25 +132,46 @@ using namespace ROOT;
 /// 
 /// \param[in] func User-defined function that processes a subrange of entries
 void TTreeProcessor::Process(std::function<void(TTreeReader&)> func)
+{
+   Process(func, 0, TTree::kMaxEntries);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+/// Process in parallel the entries in the range [firstEntry, lastEntry),
+/// numbered across the files as in a TChain. The subranges are the clusters
+/// of the trees, the first and the last ones being cut at the boundaries of
+/// the range. One task per file enumerates its clusters, each of them
+/// becoming a task of the same group.
+///
+/// \param[in] func User-defined function that processes a subrange of entries
+/// \param[in] firstEntry First entry to process
+/// \param[in] lastEntry Entry following the last entry to process
+void TTreeProcessor::Process(std::function<void(TTreeReader&)> func, Long64_t firstEntry, Long64_t lastEntry)
 {
    // Enable this IMT use case (activate its locks)
    Internal::TParTreeProcessingRAII ptpRAII;
 
-   auto clusterIter = treeView->GetClusterIterator();
-   Long64_t start = 0, end = 0;
+   if (firstEntry < 0) firstEntry = 0;
+   const unsigned nFiles = treeView->GetNFiles();
 
    // Create task group - assume number of threads has been initialized via ROOT::EnableImplicitMT
    tbb::task_group g;
 
-   // Iterate over the clusters and generate a task for each of them
-   while ((start = clusterIter()) < treeView->GetEntries()) {
-      end = clusterIter.GetNextEntry();
-
-      g.run([this, &func, start, end]() {
-         auto tr = treeView->GetTreeReader();
-         tr->SetEntriesRange(start, end);
-         func(*tr);
-      });
+   Long64_t offset = 0;
+   for (unsigned i = 0; i < nFiles && offset < lastEntry; ++i) {
+      if (firstEntry == 0 && lastEntry == TTree::kMaxEntries) {
+         // No need to know the entries of the files before processing them.
+         g.run([this, &func, &g, i]() { ProcessFile(treeView, func, g, i, 0, TTree::kMaxEntries); });
+         continue;
+      }
+      // The entries of the previous files give the part of the range in this file.
+      Long64_t entries = treeView->GetEntries(i);
+      if (offset + entries > firstEntry) {
+         Long64_t first = firstEntry > offset ? firstEntry - offset : 0;
+         Long64_t last = lastEntry - offset;
+         g.run([this, &func, &g, i, first, last]() { ProcessFile(treeView, func, g, i, first, last); });
+      }
+      offset += entries;
    }
 
    g.wait();
@@ -24,6 +24,10 @@
 #include "TTreeReader.h"
 #include "TGenCollectionProxy.h"
 #include "TRegexp.h"
+#include "TVirtualStreamerInfo.h"
+
+#include <memory>
+#include <vector>
 
 // pin vtable
 ROOT::Internal::TVirtualCollectionReader::~TVirtualCollectionReader() {}
@@ -311,6 +315,285 @@ namespace {
          return *sizeReader;
       }
    };
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Return true if the arrays of fundamental type type can be decoded from
+   /// the baskets by ReadBasicTypeArray().
+
+   Bool_t IsBasicTypeDecodable(EDataType type) {
+      switch (type) {
+         case kBool_t: case kChar_t: case kUChar_t: case kShort_t: case kUShort_t: case kInt_t:
+         case kUInt_t: case kLong64_t: case kULong64_t: case kFloat_t: case kDouble_t:
+            return kTRUE;
+         default:
+            return kFALSE;
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Decode n elements of fundamental type type from buf into data, in host
+   /// byte order. Returns false if the type cannot be decoded.
+
+   Bool_t ReadBasicTypeArray(TBuffer &buf, EDataType type, char *data, Int_t n) {
+      switch (type) {
+         case kBool_t:     buf.ReadFastArray((Bool_t*)data, n); break;
+         case kChar_t:     buf.ReadFastArray((Char_t*)data, n); break;
+         case kUChar_t:    buf.ReadFastArray((UChar_t*)data, n); break;
+         case kShort_t:    buf.ReadFastArray((Short_t*)data, n); break;
+         case kUShort_t:   buf.ReadFastArray((UShort_t*)data, n); break;
+         case kInt_t:      buf.ReadFastArray((Int_t*)data, n); break;
+         case kUInt_t:     buf.ReadFastArray((UInt_t*)data, n); break;
+         case kLong64_t:   buf.ReadFastArray((Long64_t*)data, n); break;
+         case kULong64_t:  buf.ReadFastArray((ULong64_t*)data, n); break;
+         case kFloat_t:    buf.ReadFastArray((Float_t*)data, n); break;
+         case kDouble_t:   buf.ReadFastArray((Double_t*)data, n); break;
+         default:
+            return kFALSE;
+      }
+      return kTRUE;
+   }
+
+   // Reader interface for std::vector of fundamental types, decoding the
+   // content of the baskets directly into a buffer reused from entry to
+   // entry, instead of streaming each entry into a std::vector.
+   class TVectorBasketReader : public TVirtualCollectionReader {
+   private:
+      TTreeReader *fTreeReader;     // Reader of the tree
+      TString      fBranchName;     // Name of the branch in the tree
+      EDataType    fType;           // Type of the elements
+      Int_t        fTypeSize;       // Size of the elements
+      std::unique_ptr<TVirtualCollectionReader> fFallback; // Reader of the entries that cannot be decoded
+      Bool_t       fUseFallback;    // True if the entries cannot be decoded
+      TTree       *fTree;           // Tree of fBranch
+      Int_t        fTreeNumber;     // Tree number of fTree in the chain
+      TBranch     *fBranch;         // Branch of the current tree
+      Long64_t     fEntry;          // Entry decoded in fData
+      size_t       fSize;           // Number of elements of fEntry
+      std::vector<char> fData;      // Elements of fEntry, in host byte order
+
+      ////////////////////////////////////////////////////////////////////////////////
+      /// Decode the current entry of the branch into fData. Returns false on
+      /// error, or if the entry does not have the layout of a std::vector of
+      /// fundamental types, in which case the fallback reader is used from now on.
+
+      Bool_t Load() {
+         TTree *chainOrTree = fTreeReader->GetTree();
+         if (chainOrTree->GetTree() != fTree || chainOrTree->GetTreeNumber() != fTreeNumber) {
+            fTree = chainOrTree->GetTree();
+            fTreeNumber = chainOrTree->GetTreeNumber();
+            fBranch = fTree ? fTree->GetBranch(fBranchName) : 0;
+            fEntry = -1;
+         }
+         if (!fBranch) {
+            fReadStatus = TTreeReaderValueBase::kReadError;
+            Error("TVectorBasketReader::Load()", "Cannot find the branch %s.", fBranchName.Data());
+            return kFALSE;
+         }
+         Long64_t entry = fBranch->GetTree()->GetReadEntry();
+         if (entry == fEntry) return kTRUE;
+
+         Int_t nbytes = 0;
+         TBuffer *buf = fBranch->GetRawEntry(entry, nbytes);
+         if (!buf) {
+            fReadStatus = TTreeReaderValueBase::kReadError;
+            Error("TVectorBasketReader::Load()", "Read error in the branch %s.", fBranchName.Data());
+            return kFALSE;
+         }
+         // An entry is an optional byte count and version, followed by the
+         // number of elements and the elements.
+         const UInt_t kByteCountMask = 0x40000000; // see TBufferFile
+         Int_t start = buf->Length();
+         Int_t header = 0;
+         if (nbytes >= 4) {
+            UInt_t word;
+            *buf >> word;
+            if (word & kByteCountMask) header = sizeof(UInt_t) + sizeof(Version_t);
+         }
+         Int_t n = -1;
+         if (nbytes >= header + (Int_t)sizeof(Int_t)) {
+            buf->SetBufferOffset(start + header);
+            *buf >> n;
+         }
+         if (n < 0 || header + sizeof(Int_t) + Long64_t(n) * fTypeSize != nbytes) {
+            fUseFallback = kTRUE;
+            return kFALSE;
+         }
+         if (fData.size() < size_t(n) * fTypeSize) fData.resize(size_t(n) * fTypeSize);
+         if (!ReadBasicTypeArray(*buf, fType, fData.data(), n)) {
+            fUseFallback = kTRUE;
+            return kFALSE;
+         }
+         fEntry = entry;
+         fSize = n;
+         fReadStatus = TTreeReaderValueBase::kReadSuccess;
+         return kTRUE;
+      }
+
+   public:
+      TVectorBasketReader(TTreeReader *treeReader, const char *branchName, EDataType type, TVirtualCollectionReader *fallback) :
+         fTreeReader(treeReader), fBranchName(branchName), fType(type), fTypeSize(TDataType::GetDataType(type)->Size()),
+         fFallback(fallback), fUseFallback(kFALSE), fTree(0), fTreeNumber(-1), fBranch(0), fEntry(-1), fSize(0) {}
+
+      ////////////////////////////////////////////////////////////////////////////////
+      /// Return the type of the elements of the std::vector of fundamental
+      /// types stored in branch, if it is the type dict and the entries can be
+      /// decoded by this reader; kOther_t otherwise.
+
+      static EDataType GetVectorType(TBranchElement *branch, TDictionary *dict) {
+         if (!dict || dict->IsA() != TDataType::Class()) return kOther_t;
+         if (branch->GetType() != 0 || branch->GetListOfBranches()->GetEntriesFast()) return kOther_t;
+         EDataType type = (EDataType)((TDataType*)dict)->GetType();
+         if (!IsBasicTypeDecodable(type)) return kOther_t;
+         if (branch->GetID() >= 0) {
+            TStreamerElement *element = (TStreamerElement*)branch->GetInfo()->GetElements()->At(branch->GetID());
+            if (!element || element->IsA() != TStreamerSTL::Class()) return kOther_t;
+            TStreamerSTL *stl = (TStreamerSTL*)element;
+            if (stl->GetSTLtype() != ROOT::kSTLvector || stl->GetCtype() != type) return kOther_t;
+            if (element->GetType() != TVirtualStreamerInfo::kSTL || element->GetNewType() != element->GetType()) return kOther_t;
+            if (element->GetArrayLength() > 1) return kOther_t;
+            return type;
+         }
+         TVirtualCollectionProxy *proxy = branch->GetClass() ? branch->GetClass()->GetCollectionProxy() : 0;
+         if (!proxy || proxy->GetCollectionType() != ROOT::kSTLvector) return kOther_t;
+         if (proxy->GetValueClass() || proxy->GetType() != type) return kOther_t;
+         return type;
+      }
+
+      virtual size_t GetSize(ROOT::Detail::TBranchProxy* proxy) {
+         if (!fUseFallback && Load()) return fSize;
+         if (!fUseFallback) return 0;
+         size_t size = fFallback->GetSize(proxy);
+         fReadStatus = fFallback->fReadStatus;
+         return size;
+      }
+
+      virtual void* At(ROOT::Detail::TBranchProxy* proxy, size_t idx) {
+         if (!fUseFallback && Load()) return fData.data() + idx * fTypeSize;
+         if (!fUseFallback) return 0;
+         void *address = fFallback->At(proxy, idx);
+         fReadStatus = fFallback->fReadStatus;
+         return address;
+      }
+   };
+   // Reader interface for the data members of fundamental type of the split
+   // TClonesArray branches, e.g. "tracks.fPx": the column of the member is
+   // decoded directly from the baskets of its branch, and the number of
+   // elements from the baskets of the TClonesArray branch, so that neither
+   // the TClonesArray nor its objects are read.
+   class TClonesMemberBasketReader : public TVirtualCollectionReader {
+   private:
+      TTreeReader *fTreeReader;     // Reader of the tree
+      TString      fBranchName;     // Name of the member branch in the tree
+      TString      fCountName;      // Name of the TClonesArray branch
+      EDataType    fType;           // Type of the member
+      Int_t        fTypeSize;       // Size of the member
+      std::unique_ptr<TVirtualCollectionReader> fFallback; // Reader of the entries that cannot be decoded
+      Bool_t       fUseFallback;    // True if the entries cannot be decoded
+      TTree       *fTree;           // Tree of fBranch
+      Int_t        fTreeNumber;     // Tree number of fTree in the chain
+      TBranch     *fBranch;         // Member branch of the current tree
+      TBranch     *fCountBranch;    // TClonesArray branch of the current tree
+      Long64_t     fEntry;          // Entry decoded in fData
+      size_t       fSize;           // Number of elements of fEntry
+      std::vector<char> fData;      // Members of fEntry, in host byte order
+
+      ////////////////////////////////////////////////////////////////////////////////
+      /// Decode the current entry of the branch into fData. Returns false on
+      /// error, or if the entry does not have the expected layout, in which
+      /// case the fallback reader is used from now on.
+
+      Bool_t Load() {
+         TTree *chainOrTree = fTreeReader->GetTree();
+         if (chainOrTree->GetTree() != fTree || chainOrTree->GetTreeNumber() != fTreeNumber) {
+            fTree = chainOrTree->GetTree();
+            fTreeNumber = chainOrTree->GetTreeNumber();
+            fBranch = fTree ? fTree->GetBranch(fBranchName) : 0;
+            fCountBranch = fTree ? fTree->GetBranch(fCountName) : 0;
+            fEntry = -1;
+         }
+         if (!fBranch || !fCountBranch) {
+            fReadStatus = TTreeReaderValueBase::kReadError;
+            Error("TClonesMemberBasketReader::Load()", "Cannot find the branch %s.",
+                  fBranch ? fCountName.Data() : fBranchName.Data());
+            return kFALSE;
+         }
+         Long64_t entry = fBranch->GetTree()->GetReadEntry();
+         if (entry == fEntry) return kTRUE;
+
+         // The entry of the TClonesArray branch is the number of elements,
+         // the entry of the member branch the members of all the elements.
+         Int_t nbytes = 0;
+         TBuffer *buf = fCountBranch->GetRawEntry(entry, nbytes);
+         if (!buf) {
+            fReadStatus = TTreeReaderValueBase::kReadError;
+            Error("TClonesMemberBasketReader::Load()", "Read error in the branch %s.", fCountName.Data());
+            return kFALSE;
+         }
+         Int_t n = -1;
+         if (nbytes == (Int_t)sizeof(Int_t)) *buf >> n;
+         if (n < 0) {
+            fUseFallback = kTRUE;
+            return kFALSE;
+         }
+         buf = fBranch->GetRawEntry(entry, nbytes);
+         if (!buf && n) {
+            fReadStatus = TTreeReaderValueBase::kReadError;
+            Error("TClonesMemberBasketReader::Load()", "Read error in the branch %s.", fBranchName.Data());
+            return kFALSE;
+         }
+         if (Long64_t(n) * fTypeSize != nbytes) {
+            fUseFallback = kTRUE;
+            return kFALSE;
+         }
+         if (fData.size() < size_t(n) * fTypeSize) fData.resize(size_t(n) * fTypeSize);
+         if (n && !ReadBasicTypeArray(*buf, fType, fData.data(), n)) {
+            fUseFallback = kTRUE;
+            return kFALSE;
+         }
+         fEntry = entry;
+         fSize = n;
+         fReadStatus = TTreeReaderValueBase::kReadSuccess;
+         return kTRUE;
+      }
+
+   public:
+      TClonesMemberBasketReader(TTreeReader *treeReader, const char *branchName, const char *countName, EDataType type, TVirtualCollectionReader *fallback) :
+         fTreeReader(treeReader), fBranchName(branchName), fCountName(countName), fType(type),
+         fTypeSize(TDataType::GetDataType(type)->Size()), fFallback(fallback), fUseFallback(kFALSE),
+         fTree(0), fTreeNumber(-1), fBranch(0), fCountBranch(0), fEntry(-1), fSize(0) {}
+
+      ////////////////////////////////////////////////////////////////////////////////
+      /// Return the type of the member stored in the split TClonesArray member
+      /// branch, if it is the type dict and the entries can be decoded by this
+      /// reader; kOther_t otherwise.
+
+      static EDataType GetMemberType(TBranchElement *branch, TStreamerElement *element, TDictionary *dict) {
+         if (!dict || dict->IsA() != TDataType::Class()) return kOther_t;
+         if (branch->GetType() != TBranchElement::kClonesMemberNode || !branch->GetBranchCount()) return kOther_t;
+         EDataType type = (EDataType)((TDataType*)dict)->GetType();
+         if (!IsBasicTypeDecodable(type)) return kOther_t;
+         // Written as is, without conversion from the type on file.
+         if (element->GetType() != type || element->GetNewType() != element->GetType()) return kOther_t;
+         if (element->GetArrayLength() > 1) return kOther_t;
+         return type;
+      }
+
+      virtual size_t GetSize(ROOT::Detail::TBranchProxy* proxy) {
+         if (!fUseFallback && Load()) return fSize;
+         if (!fUseFallback) return 0;
+         size_t size = fFallback->GetSize(proxy);
+         fReadStatus = fFallback->fReadStatus;
+         return size;
+      }
+
+      virtual void* At(ROOT::Detail::TBranchProxy* proxy, size_t idx) {
+         if (!fUseFallback && Load()) return fData.data() + idx * fTypeSize;
+         if (!fUseFallback) return 0;
+         void *address = fFallback->At(proxy, idx);
+         fReadStatus = fFallback->fReadStatus;
+         return address;
+      }
+   };
 }
 
 /** \class TTreeReaderArray
@@ -525,7 +808,11 @@ void ROOT::Internal::TTreeReaderArrayBase::CreateProxy()
          if (fSetupStatus == kSetupInternalError)
             fSetupStatus = kSetupMatch;
          if (element->IsA() == TStreamerSTL::Class()){
-            fImpl = new TSTLReader();
+            EDataType vectorType = TVectorBasketReader::GetVectorType(branchElement, fDict);
+            if (vectorType != kOther_t)
+               fImpl = new TVectorBasketReader(fTreeReader, fBranchName, vectorType, new TSTLReader());
+            else
+               fImpl = new TSTLReader();
          }
          else if (element->IsA() == TStreamerObject::Class()){
             //fImpl = new TObjectArrayReader(); // BArray[12]
@@ -545,7 +832,12 @@ void ROOT::Internal::TTreeReaderArrayBase::CreateProxy()
                fImpl = new TBasicTypeArrayReader();
             }
             else if (branchElement->GetType() == TBranchElement::kClonesMemberNode){
-               fImpl = new TBasicTypeClonesReader(element->GetOffset());
+               EDataType memberType = TClonesMemberBasketReader::GetMemberType(branchElement, element, fDict);
+               if (memberType != kOther_t)
+                  fImpl = new TClonesMemberBasketReader(fTreeReader, fBranchName, branchElement->GetBranchCount()->GetName(),
+                                                        memberType, new TBasicTypeClonesReader(element->GetOffset()));
+               else
+                  fImpl = new TBasicTypeClonesReader(element->GetOffset());
             }
             else {
                fImpl = new TArrayFixedSizeReader(element->GetArrayLength());
@@ -567,7 +859,12 @@ void ROOT::Internal::TTreeReaderArrayBase::CreateProxy()
       }
       else { // We are at root node?
          if (branchElement->GetClass()->GetCollectionProxy()){
-            fImpl = new TCollectionLessSTLReader(branchElement->GetClass()->GetCollectionProxy());
+            TVirtualCollectionReader *collectionReader = new TCollectionLessSTLReader(branchElement->GetClass()->GetCollectionProxy());
+            EDataType vectorType = TVectorBasketReader::GetVectorType(branchElement, fDict);
+            if (vectorType != kOther_t)
+               fImpl = new TVectorBasketReader(fTreeReader, fBranchName, vectorType, collectionReader);
+            else
+               fImpl = collectionReader;
          }
       }
    } else if (branch->IsA() == TBranch::Class()) {
@@ -18,6 +18,7 @@
 #include "TBranchSTL.h"
 #include "TBranchProxyDirector.h"
 #include "TClassEdit.h"
+#include "TDataType.h"
 #include "TLeaf.h"
 #include "TTreeProxyGenerator.h"
 #include "TTreeReaderValue.h"
@@ -47,7 +48,13 @@ ROOT::Internal::TTreeReaderValueBase::TTreeReaderValueBase(TTreeReader* reader /
    fLeaf(NULL),
    fLastTreeNumber(-1),
    fSetupStatus(kSetupNotSetup),
-   fReadStatus(kReadNothingYet)
+   fReadStatus(kReadNothingYet),
+   fRawDisabled(kFALSE),
+   fRawTree(0),
+   fRawTreeNumber(-1),
+   fRawBranch(0),
+   fRawEntry(-1),
+   fRawValue(0)
 {
    if (fTreeReader) fTreeReader->RegisterValueReader(this);
 }
@@ -65,7 +72,13 @@ ROOT::Internal::TTreeReaderValueBase::TTreeReaderValueBase(const TTreeReaderValu
    fLastTreeNumber(rhs.fLastTreeNumber),
    fSetupStatus(rhs.fSetupStatus),
    fReadStatus(rhs.fReadStatus),
-   fStaticClassOffsets(rhs.fStaticClassOffsets)
+   fStaticClassOffsets(rhs.fStaticClassOffsets),
+   fRawDisabled(rhs.fRawDisabled),
+   fRawTree(0),
+   fRawTreeNumber(-1),
+   fRawBranch(0),
+   fRawEntry(-1),
+   fRawValue(0)
 {
    if (fTreeReader) fTreeReader->RegisterValueReader(this);
 }
@@ -92,6 +105,11 @@ ROOT::Internal::TTreeReaderValueBase::operator=(const TTreeReaderValueBase& rhs)
       fSetupStatus = rhs.fSetupStatus;
       fReadStatus = rhs.fReadStatus;
       fStaticClassOffsets = rhs.fStaticClassOffsets;
+      fRawDisabled = rhs.fRawDisabled;
+      fRawTree = 0;
+      fRawTreeNumber = -1;
+      fRawBranch = 0;
+      fRawEntry = -1;
    }
    return *this;
 }
@@ -119,6 +137,95 @@ ROOT::Internal::TTreeReaderValueBase::ProxyRead() {
    return fReadStatus;
 }
 
+namespace {
+   ////////////////////////////////////////////////////////////////////////////////
+   /// Decode from buf a value of type T, if the entry holds nbytes bytes.
+
+   template <typename T>
+   Bool_t DecodeValue(TBuffer &buf, Int_t nbytes, void *value) {
+      if (nbytes != sizeof(T)) return kFALSE;
+      buf >> *(T*)value;
+      return kTRUE;
+   }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the address of the value of the current entry decoded directly
+/// from the basket of its branch, or 0 if the value is not a single value
+/// of fundamental type in a branch of its own (eg. "x/F"), in which case
+/// it is read through the branch proxy. This spares the proxy bookkeeping
+/// and the copy of the leaf into the branch address at each entry.
+
+void* ROOT::Internal::TTreeReaderValueBase::GetRawAddress() {
+   if (fRawDisabled) return 0;
+   if (!fProxy || fSetupStatus < 0 || !fTreeReader) return 0;
+
+   TTree *chainOrTree = fTreeReader->GetTree();
+   if (!chainOrTree) return 0;
+   if (chainOrTree->GetTree() != fRawTree || chainOrTree->GetTreeNumber() != fRawTreeNumber) {
+      fRawTree = chainOrTree->GetTree();
+      fRawTreeNumber = chainOrTree->GetTreeNumber();
+      fRawBranch = GetRawBranch(fRawTree);
+      fRawEntry = -1;
+      if (!fRawBranch) {
+         // Read through the proxy from now on, also for the next trees.
+         fRawDisabled = kTRUE;
+         return 0;
+      }
+   }
+
+   Long64_t entry = fRawBranch->GetTree()->GetReadEntry();
+   if (entry == fRawEntry) return &fRawValue;
+
+   Int_t nbytes = 0;
+   TBuffer *buf = fRawBranch->GetRawEntry(entry, nbytes);
+   if (!buf) {
+      fReadStatus = kReadError;
+      return 0;
+   }
+   Bool_t decoded = kFALSE;
+   switch (((TDataType*)fDict)->GetType()) {
+      case kBool_t:    decoded = DecodeValue<Bool_t>(*buf, nbytes, &fRawValue); break;
+      case kChar_t:    decoded = DecodeValue<Char_t>(*buf, nbytes, &fRawValue); break;
+      case kUChar_t:   decoded = DecodeValue<UChar_t>(*buf, nbytes, &fRawValue); break;
+      case kShort_t:   decoded = DecodeValue<Short_t>(*buf, nbytes, &fRawValue); break;
+      case kUShort_t:  decoded = DecodeValue<UShort_t>(*buf, nbytes, &fRawValue); break;
+      case kInt_t:     decoded = DecodeValue<Int_t>(*buf, nbytes, &fRawValue); break;
+      case kUInt_t:    decoded = DecodeValue<UInt_t>(*buf, nbytes, &fRawValue); break;
+      case kLong64_t:  decoded = DecodeValue<Long64_t>(*buf, nbytes, &fRawValue); break;
+      case kULong64_t: decoded = DecodeValue<ULong64_t>(*buf, nbytes, &fRawValue); break;
+      case kFloat_t:   decoded = DecodeValue<Float_t>(*buf, nbytes, &fRawValue); break;
+      case kDouble_t:  decoded = DecodeValue<Double_t>(*buf, nbytes, &fRawValue); break;
+      default: break;
+   }
+   if (!decoded) {
+      // Unexpected layout: read through the proxy from now on.
+      fRawDisabled = kTRUE;
+      return 0;
+   }
+   fRawEntry = entry;
+   fReadStatus = kReadSuccess;
+   return &fRawValue;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// Return the branch of tree whose baskets hold our value as a single value
+/// of the fundamental type of the reader, or 0 if there is none.
+
+TBranch* ROOT::Internal::TTreeReaderValueBase::GetRawBranch(TTree* tree) const {
+   if (!tree || fLeafName.Length() > 0 || !fStaticClassOffsets.empty()) return 0;
+   if (!fDict || fDict->IsA() != TDataType::Class()) return 0;
+   TBranch *branch = tree->GetBranch(fBranchName);
+   if (!branch || branch->IsA() != TBranch::Class()) return 0;
+   if (branch->GetListOfLeaves()->GetEntriesFast() != 1) return 0;
+   TLeaf *leaf = (TLeaf*)branch->GetListOfLeaves()->UncheckedAt(0);
+   if (leaf->GetLeafCount() || leaf->GetLenStatic() != 1 || leaf->GetLen() != 1) return 0;
+   TDictionary *leafDict = TDictionary::GetDictionary(leaf->GetTypeName());
+   if (!leafDict || leafDict->IsA() != TDataType::Class()) return 0;
+   if (((TDataType*)leafDict)->GetType() != ((TDataType*)fDict)->GetType()) return 0;
+   return branch;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 /// Stringify the template argument.
 std::string ROOT::Internal::TTreeReaderValueBase::GetElementTypeName(const std::type_info& ti) {